@@ -0,0 +1,195 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FileSystem.hpp"
+#include "ThreadPool.hpp"
+#include "Timer.hpp"
+#include "GLTFLoader.hpp"
+#include "args.hxx"
+
+using namespace Diligent;
+
+namespace
+{
+
+struct BakerCreateInfo
+{
+    std::vector<std::string> InputFilePaths;
+    std::string              OutputDir;
+    Uint32                   ThreadCount = 0;
+
+    GLTF::ModelCreateInfo ModelCI;
+};
+
+enum class ParseStatus
+{
+    Success,
+    SuccessHelp,
+    Failed,
+};
+
+ParseStatus ParseCommandLine(int argc, char* argv[], BakerCreateInfo& CreateInfo)
+{
+    args::ArgumentParser Parser{"Asset baker"};
+    args::HelpFlag       Help{Parser, "help", "Show command line help", {'h', "help"}};
+
+    args::ValueFlagList<std::string> ArgumentInputs{Parser, "path", "Input glTF files", {'i', "input"}, {}};
+    args::ValueFlag<std::string>     ArgumentOutputDir{Parser, "dir", "Output directory", {'o', "output_dir"}, "."};
+    args::ValueFlag<Uint32>          ArgumentThreadCount{Parser, "count", "Count of threads", {'t', "thread"}, 0};
+
+    args::Group GroupGeometry{Parser, "Geometry:", args::Group::Validators::DontCare};
+    args::Flag  ArgumentOptimizeVertexCache{GroupGeometry, "optimize_vertex_cache", "Reorder the triangles for the post-transform vertex cache", {"optimize_vertex_cache"}};
+    args::Flag  ArgumentQuantize{GroupGeometry, "quantize", "Use the quantized vertex layout (GLTF::QuantizedVertexAttributes)", {"quantize"}};
+    args::Flag  ArgumentMeshlets{GroupGeometry, "meshlets", "Generate meshlets", {"meshlets"}};
+
+    args::ValueFlag<Uint32> ArgumentLODs{GroupGeometry, "count", "The number of simplified LODs to generate", {"lods"}, 0};
+    args::ValueFlag<float>  ArgumentAnimationRate{GroupGeometry, "fps", "Resample the animations at the given rate", {"animation_rate"}, 0};
+
+    args::Group GroupTextures{Parser, "Textures:", args::Group::Validators::DontCare};
+    args::Flag  ArgumentCompressTextures{GroupTextures, "compress_textures", "Compress the textures to BC formats", {"compress_textures"}};
+
+    try
+    {
+        Parser.ParseCLI(argc, argv);
+    }
+    catch (const args::Help&)
+    {
+        LOG_INFO_MESSAGE(Parser.Help());
+        return ParseStatus::SuccessHelp;
+    }
+    catch (const args::Error& e)
+    {
+        LOG_ERROR_MESSAGE(e.what());
+        LOG_INFO_MESSAGE(Parser.Help());
+        return ParseStatus::Failed;
+    }
+
+    if (!ArgumentInputs)
+    {
+        LOG_ERROR_MESSAGE("At least one input file is required");
+        LOG_INFO_MESSAGE(Parser.Help());
+        return ParseStatus::Failed;
+    }
+
+    CreateInfo.InputFilePaths = args::get(ArgumentInputs);
+    CreateInfo.OutputDir      = args::get(ArgumentOutputDir);
+    CreateInfo.ThreadCount    = args::get(ArgumentThreadCount);
+
+    auto& ModelCI               = CreateInfo.ModelCI;
+    ModelCI.OptimizeVertexCache = args::get(ArgumentOptimizeVertexCache);
+    ModelCI.GenerateMeshlets    = args::get(ArgumentMeshlets);
+    ModelCI.NumLODs             = args::get(ArgumentLODs);
+    ModelCI.AnimationSampleRate = args::get(ArgumentAnimationRate);
+    ModelCI.TextureCompressMode = ArgumentCompressTextures ? GLTF::TEXTURE_COMPRESS_MODE_BC : GLTF::TEXTURE_COMPRESS_MODE_NONE;
+    if (ArgumentQuantize)
+    {
+        ModelCI.VertexAttributes    = GLTF::QuantizedVertexAttributes.data();
+        ModelCI.NumVertexAttributes = static_cast<Uint32>(GLTF::QuantizedVertexAttributes.size());
+    }
+
+    return ParseStatus::Success;
+}
+
+std::string GetOutputFilePath(const std::string& OutputDir, const std::string& InputFilePath)
+{
+    std::string FileName;
+    FileSystem::GetPathComponents(InputFilePath, nullptr, &FileName);
+
+    const auto ExtPos = FileName.rfind('.');
+    if (ExtPos != std::string::npos)
+        FileName.erase(ExtPos);
+
+    return OutputDir + FileSystem::SlashSymbol + FileName + '.' + GLTF::BakedModelFileExtension;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    BakerCreateInfo CreateInfo;
+    switch (ParseCommandLine(argc, argv, CreateInfo))
+    {
+        case ParseStatus::Success:
+            break;
+        case ParseStatus::SuccessHelp:
+            return EXIT_SUCCESS;
+        case ParseStatus::Failed:
+            LOG_FATAL_ERROR("Failed to parse command line");
+            return EXIT_FAILURE;
+        default:
+            UNEXPECTED("Unexpected parse status");
+            break;
+    }
+
+    if (!FileSystem::PathExists(CreateInfo.OutputDir.c_str()) && !FileSystem::CreateDirectory(CreateInfo.OutputDir.c_str()))
+    {
+        LOG_FATAL_ERROR("Failed to create output directory '", CreateInfo.OutputDir, "'");
+        return EXIT_FAILURE;
+    }
+
+    // Every model decodes and compresses its images in parallel using the thread pool
+    const Uint32 ThreadCount = CreateInfo.ThreadCount > 0 ? CreateInfo.ThreadCount : std::thread::hardware_concurrency();
+
+    ThreadPoolCreateInfo ThreadPoolCI{ThreadCount};
+    auto                 pThreadPool = CreateThreadPool(ThreadPoolCI);
+
+    Uint32 NumFailed = 0;
+    for (const auto& InputFilePath : CreateInfo.InputFilePaths)
+    {
+        const auto OutputFilePath = GetOutputFilePath(CreateInfo.OutputDir, InputFilePath);
+
+        auto ModelCI          = CreateInfo.ModelCI;
+        ModelCI.FileName      = InputFilePath.c_str();
+        ModelCI.BakedFileName = OutputFilePath.c_str();
+        ModelCI.pThreadPool   = pThreadPool;
+
+        Timer BakeTimer;
+        try
+        {
+            GLTF::Model::Bake(ModelCI);
+            LOG_INFO_MESSAGE("Baked '", InputFilePath, "' into '", OutputFilePath, "' in ", BakeTimer.GetElapsedTime() * 1000.0, " ms.");
+        }
+        catch (...)
+        {
+            LOG_ERROR_MESSAGE("Failed to bake '", InputFilePath, "'");
+            ++NumFailed;
+        }
+    }
+
+    if (NumFailed > 0)
+    {
+        LOG_FATAL_ERROR("Failed to bake ", NumFailed, " of ", CreateInfo.InputFilePaths.size(), " models");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
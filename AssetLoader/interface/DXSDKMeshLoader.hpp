@@ -30,6 +30,7 @@
 #include <vector>
 
 #include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+#include "../../../DiligentCore/Primitives/interface/DataBlob.h"
 #include "../../../DiligentCore/Graphics/GraphicsEngine/interface/RenderDevice.h"
 #include "../../../DiligentCore/Graphics/GraphicsEngine/interface/DeviceContext.h"
 #include "../../../DiligentCore/Graphics/GraphicsEngine/interface/Buffer.h"
@@ -37,10 +38,16 @@
 #include "../../../DiligentCore/Graphics/GraphicsEngine/interface/TextureView.h"
 #include "../../../DiligentCore/Common/interface/BasicMath.hpp"
 #include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
+#include "GLTFResourceManager.hpp"
 
 namespace Diligent
 {
 
+namespace GLTF
+{
+struct ResourceCacheUseInfo;
+}
+
 //--------------------------------------------------------------------------------------
 // Hard Defines for the various structures
 //--------------------------------------------------------------------------------------
@@ -76,6 +83,14 @@ enum DXSDKMESH_INDEX_TYPE
     IT_32BIT,
 };
 
+enum DXSDKMESH_MATERIAL_TEXTURE
+{
+    DXSDKMESH_MATERIAL_TEXTURE_DIFFUSE = 0,
+    DXSDKMESH_MATERIAL_TEXTURE_NORMAL,
+    DXSDKMESH_MATERIAL_TEXTURE_SPECULAR,
+    DXSDKMESH_MATERIAL_TEXTURE_COUNT
+};
+
 enum FRAME_TRANSFORM_TYPE
 {
     FTT_RELATIVE = 0,
@@ -324,15 +339,60 @@ struct SDKANIMATION_FRAME_DATA
 };
 
 
+struct IThreadPool;
+
 // This class reads the DXSDKMesh file formats
 class DXSDKMesh
 {
 public:
     virtual ~DXSDKMesh();
 
-    bool Create(const Char* szFileName);
-    bool Create(Uint8* pData, Uint32 DataUint8s);
-    void LoadGPUResources(const Char* ResourceDirectory, IRenderDevice* pDevice, IDeviceContext* pDeviceCtx);
+    /// Loads the mesh from a file.
+
+    /// The file is memory-mapped with a private (copy-on-write) mapping where the platform supports it,
+    /// so that only the pages that are accessed are loaded, and only the header pages that are patched
+    /// are copied. Otherwise, the file is read into a single blob. In both cases, no copy of the data is made.
+    /// If pThreadPool is not null, mesh bounding boxes are computed in parallel (see ComputeBoundingBoxes).
+    bool Create(const Char* szFileName, IThreadPool* pThreadPool = nullptr);
+
+    /// Loads the mesh from a copy of the data.
+    bool Create(Uint8* pData, Uint32 DataUint8s, IThreadPool* pThreadPool = nullptr);
+
+    /// Loads the mesh from the blob without copying the data.
+
+    /// The mesh keeps a reference to the blob, and the offsets in the blob are replaced with pointers in place,
+    /// so the blob must not be shared with other users of its contents.
+    bool Create(IDataBlob* pData, IThreadPool* pThreadPool = nullptr);
+
+    /// Creates the textures, vertex buffers and index buffers of the mesh.
+
+    /// Material textures that reference the same file are loaded once. If pThreadPool is not null,
+    /// the textures are decoded and their mip levels are generated in parallel on the pool.
+    /// GPU objects are always created on the calling thread, so the function must not be called
+    /// from a worker thread of pThreadPool.
+    void LoadGPUResources(const Char* ResourceDirectory, IRenderDevice* pDevice, IDeviceContext* pDeviceCtx, IThreadPool* pThreadPool = nullptr);
+
+    /// Loads the geometry and the textures of the mesh into the resource manager.
+
+    /// Vertex and index data are suballocated from the resource manager buffers selected by CacheInfo,
+    /// and material textures are allocated in its atlases, so that the mesh can be drawn together with
+    /// GLTF models that use the same resource manager. In this mode, no per-mesh buffers or textures
+    /// are created: GetMeshVertexBuffer(), GetMeshIndexBuffer() and the material texture pointers return
+    /// null. Use GetBaseVertex() and GetFirstIndexLocation() with the resource manager buffers instead,
+    /// and GetMaterialTextureAllocation() to access the atlas regions.
+    /// Every vertex buffer of the file must have the same stride as the other allocations in its
+    /// resource manager buffer.
+    ///
+    /// pDeviceCtx may be a transfer (copy) queue context, in which case the uploads do not compete with
+    /// rendering. The resource manager buffers and atlases must then be created with the immediate context
+    /// mask that includes the transfer context. The application signals a fence from the transfer context
+    /// (IDeviceContext::EnqueueSignal() followed by IDeviceContext::Flush()) and makes the graphics queue wait
+    /// for it (IDeviceContext::DeviceWaitForFence()) before the mesh is drawn.
+    void LoadGPUResources(const Char*                       ResourceDirectory,
+                          IRenderDevice*                    pDevice,
+                          IDeviceContext*                   pDeviceCtx,
+                          const GLTF::ResourceCacheUseInfo& CacheInfo,
+                          IThreadPool*                      pThreadPool = nullptr);
     void Destroy();
 
     //Helpers
@@ -393,20 +453,70 @@ public:
 
     const DXSDKMESH_VERTEX_ELEMENT* VBElements(Uint32 iVB) const { return m_pVertexBufferArray[0].Decl; }
 
+    /// Returns the index of the first vertex of the mesh vertex buffer in the resource manager buffer,
+    /// or 0 if the mesh was not loaded into a resource manager.
+
+    /// Subsets are drawn with the base vertex GetBaseVertex(iMesh) + Subset.VertexStart.
+    Uint32 GetBaseVertex(Uint32 iMesh, Uint32 iVB = 0) const
+    {
+        const auto VBIdx = m_pMeshArray[iMesh].VertexBuffers[iVB];
+        if (VBIdx >= m_VertexAllocations.size() || !m_VertexAllocations[VBIdx])
+            return 0;
+
+        const auto Stride = GetVertexStride(VBIdx);
+        VERIFY((m_VertexAllocations[VBIdx]->GetOffset() % Stride) == 0,
+               "Allocation offset is not multiple of the vertex stride (", Stride, ")");
+        return static_cast<Uint32>(m_VertexAllocations[VBIdx]->GetOffset() / Stride);
+    }
+
+    /// Returns the location of the first index of the mesh index buffer in the resource manager buffer,
+    /// or 0 if the mesh was not loaded into a resource manager.
+
+    /// Subsets are drawn starting at the index GetFirstIndexLocation(iMesh) + Subset.IndexStart.
+    Uint32 GetFirstIndexLocation(Uint32 iMesh) const
+    {
+        const auto IBIdx = m_pMeshArray[iMesh].IndexBuffer;
+        if (IBIdx >= m_IndexAllocations.size() || !m_IndexAllocations[IBIdx])
+            return 0;
+
+        const Uint32 IndexSize = m_pIndexBufferArray[IBIdx].IndexType == IT_16BIT ? 2 : 4;
+        VERIFY((m_IndexAllocations[IBIdx]->GetOffset() % IndexSize) == 0,
+               "Allocation offset is not multiple of the index size (", IndexSize, ")");
+        return static_cast<Uint32>(m_IndexAllocations[IBIdx]->GetOffset() / IndexSize);
+    }
+
+    /// Returns the atlas region of the material texture, or null if the texture was not loaded into a resource manager.
+    ITextureAtlasSuballocation* GetMaterialTextureAllocation(Uint32 iMaterial, DXSDKMESH_MATERIAL_TEXTURE Texture) const
+    {
+        const size_t Idx = size_t{iMaterial} * DXSDKMESH_MATERIAL_TEXTURE_COUNT + Texture;
+        return Idx < m_TextureAllocations.size() ? m_TextureAllocations[Idx].RawPtr() : nullptr;
+    }
+
     //Uint32                          GetNumFrames();
     //DXSDKMESH_FRAME*                GetFrame( Uint32 iFrame );
     //DXSDKMESH_FRAME*                FindFrame( char* pszName );
 
 protected:
-    bool CreateFromFile(const char* szFileName);
+    bool CreateFromFile(const char* szFileName, IThreadPool* pThreadPool);
+
+    bool CreateFromMemory(Uint8*       pData,
+                          Uint32       DataUint8s,
+                          IThreadPool* pThreadPool);
 
-    bool CreateFromMemory(Uint8* pData,
-                          Uint32 DataUint8s);
+    bool CreateFromBlob(IDataBlob* pData, IThreadPool* pThreadPool);
 
-    void ComputeBoundingBoxes();
+    // Computes the bounding box of every mesh from the vertex range referenced by each of its subsets.
+    // Subsets are processed in parallel when pThreadPool is not null and the meshes are large enough.
+    void ComputeBoundingBoxes(IThreadPool* pThreadPool);
+
+    void LoadGPUResourcesImpl(const Char*                       ResourceDirectory,
+                              IRenderDevice*                    pDevice,
+                              IDeviceContext*                   pDeviceCtx,
+                              const GLTF::ResourceCacheUseInfo* pCacheInfo,
+                              IThreadPool*                      pThreadPool);
 
     //These are the pointers to the two chunks of data loaded in from the mesh file
-    std::vector<Uint8> m_StaticMeshData;
+    RefCntAutoPtr<IDataBlob> m_pStaticMeshData;
     //Uint8*  m_pAnimationData    = nullptr;
     std::vector<Uint8*> m_ppVertices;
     std::vector<Uint8*> m_ppIndices;
@@ -414,6 +524,11 @@ protected:
     std::vector<RefCntAutoPtr<IBuffer>> m_VertexBuffers;
     std::vector<RefCntAutoPtr<IBuffer>> m_IndexBuffers;
 
+    // Allocations in the resource manager (see LoadGPUResources overload that takes ResourceCacheUseInfo)
+    std::vector<RefCntAutoPtr<IBufferSuballocation>>       m_VertexAllocations;
+    std::vector<RefCntAutoPtr<IBufferSuballocation>>       m_IndexAllocations;
+    std::vector<RefCntAutoPtr<ITextureAtlasSuballocation>> m_TextureAllocations; // [NumMaterials * DXSDKMESH_MATERIAL_TEXTURE_COUNT]
+
     //General mesh info
     DXSDKMESH_HEADER*               m_pMeshHeader        = nullptr;
     DXSDKMESH_VERTEX_BUFFER_HEADER* m_pVertexBufferArray = nullptr;
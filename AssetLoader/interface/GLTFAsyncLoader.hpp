@@ -0,0 +1,166 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <atomic>
+
+#include "../../../DiligentCore/Common/interface/ObjectBase.hpp"
+#include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
+#include "GLTFLoader.hpp"
+
+namespace Diligent
+{
+
+struct IThreadPool;
+struct IAsyncTask;
+
+namespace GLTF
+{
+
+/// Asynchronous GLTF model loader.
+///
+/// The loader parses the file, converts vertex data and decodes textures in a worker
+/// thread of the thread pool, while GPU resources are created and initialized in
+/// the render thread by the Update() method. Geometry becomes available for rendering
+/// before all textures are loaded: textures that are not ready yet are returned
+/// as null by Model::GetTexture().
+///
+/// Typical usage:
+///
+///     auto pLoader = AsyncModelLoader::Create(pDevice, pThreadPool, ModelCI);
+///     ...
+///     // Every frame
+///     pLoader->Update(pContext);
+///     if (pLoader->IsGeometryReady())
+///         RenderModel(*pLoader->GetModel());
+class AsyncModelLoader final : public ObjectBase<IObject>
+{
+public:
+    using TBase = ObjectBase<IObject>;
+
+    /// Creates the loader and starts loading the model.
+
+    /// \param [in] pDevice     - Render device.
+    /// \param [in] pThreadPool - Thread pool to run the loading task in.
+    /// \param [in] CI          - Model create information. All pointers except for
+    ///                           the file name must remain valid until loading is finished.
+    ///                           CI.pThreadPool is ignored.
+    static RefCntAutoPtr<AsyncModelLoader> Create(IRenderDevice*         pDevice,
+                                                  IThreadPool*           pThreadPool,
+                                                  const ModelCreateInfo& CI);
+
+    ~AsyncModelLoader();
+
+    /// Returns the current loading stage.
+    MODEL_LOAD_STAGE GetStage() const
+    {
+        return m_pProgress->Stage.load();
+    }
+
+    /// Returns the loading progress.
+    const ModelLoadProgress& GetProgress() const
+    {
+        return *m_pProgress;
+    }
+
+    /// Requests the loading to be cancelled.
+    void Cancel()
+    {
+        m_pProgress->CancelRequested.store(true);
+    }
+
+    /// Returns true if loading is complete, failed or has been cancelled.
+    bool IsFinished() const
+    {
+        const auto Stage = GetStage();
+        return Stage == MODEL_LOAD_STAGE_COMPLETE || Stage == MODEL_LOAD_STAGE_CANCELLED || Stage == MODEL_LOAD_STAGE_FAILED;
+    }
+
+    /// Returns true if the model geometry has been uploaded to the GPU and can be rendered.
+    bool IsGeometryReady() const
+    {
+        return m_GeometryUploaded;
+    }
+
+    /// Returns the model once its geometry is ready, and null otherwise.
+    Model* GetModel() const
+    {
+        return m_GeometryUploaded ? m_pModel.get() : nullptr;
+    }
+
+    /// Creates and initializes GPU resources that have been prepared by the worker thread.
+
+    /// \param [in] pContext      - Immediate device context.
+    /// \param [in] MaxUploadSize - The maximum number of bytes to upload to the GPU by this call
+    ///                             (see Model::PrepareGPUResources).
+    /// \return     true if loading is finished, and false otherwise.
+    ///
+    /// \remarks    The method must be called from the render thread, typically once per frame,
+    ///             until it returns true.
+    bool Update(IDeviceContext* pContext, Uint64 MaxUploadSize = ~Uint64{0});
+
+private:
+    template <typename AllocatorType, typename ObjectType>
+    friend class Diligent::MakeNewRCObj;
+
+    AsyncModelLoader(IReferenceCounters*    pRefCounters,
+                     IRenderDevice*         pDevice,
+                     IThreadPool*           pThreadPool,
+                     const ModelCreateInfo& CI);
+
+    void LoadModel();
+
+private:
+    RefCntAutoPtr<IRenderDevice> m_pDevice;
+
+    const std::string m_FileName;
+    ModelCreateInfo   m_CI;
+
+    ModelLoadProgress  m_Progress;
+    ModelLoadProgress* m_pProgress = nullptr;
+
+    std::unique_ptr<Model> m_pModel;
+
+    RefCntAutoPtr<IAsyncTask> m_pTask;
+
+    // Set by the worker thread when geometry has been loaded.
+    std::atomic_bool m_GeometryLoaded{false};
+    // Set by the worker thread when all textures have been prepared.
+    std::atomic_bool m_TexturesPrepared{false};
+    // Set by the worker thread when it is done with the model.
+    std::atomic_bool m_WorkerFinished{false};
+
+    // Only accessed by the render thread.
+    bool m_GeometryUploaded = false;
+};
+
+} // namespace GLTF
+
+} // namespace Diligent
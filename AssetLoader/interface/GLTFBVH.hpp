@@ -0,0 +1,292 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cfloat>
+
+#include "../../../DiligentCore/Platforms/Basic/interface/DebugUtilities.hpp"
+#include "../../../DiligentCore/Common/interface/BasicMath.hpp"
+#include "../../../DiligentCore/Common/interface/AdvancedMath.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// Bounding volume hierarchy over a set of axis-aligned boxes.
+///
+/// \remarks   The hierarchy is built top-down using the surface area heuristic evaluated
+///            over a fixed number of centroid bins. Children of an inner node are stored next
+///            to each other, and always after their parent, so that the bounds can be refit
+///            bottom-up in a single reverse pass over the nodes.
+class BoundingVolumeHierarchy
+{
+public:
+    struct Node
+    {
+        float3 Min;
+
+        /// For an inner node, the index of the first child; the second child immediately follows it.
+        /// For a leaf, the index of the first item in the item array.
+        Uint32 FirstChildOrItem = 0;
+
+        float3 Max;
+
+        /// The number of items in the leaf, or zero for an inner node.
+        Uint32 NumItems = 0;
+
+        bool IsLeaf() const
+        {
+            return NumItems != 0;
+        }
+    };
+    static_assert(sizeof(Node) == 32, "Node is expected to be 32 bytes");
+
+    /// Builds the hierarchy over the boxes.
+
+    /// \param [in] pBoxes      - Array of NumBoxes boxes. Item i of the hierarchy refers to pBoxes[i].
+    /// \param [in] NumBoxes    - The number of boxes.
+    /// \param [in] MaxLeafSize - The maximum number of items in a leaf.
+    void Build(const BoundBox* pBoxes, Uint32 NumBoxes, Uint32 MaxLeafSize = 4);
+
+    /// Recomputes the node bounds from the updated boxes without changing the topology.
+
+    /// \param [in] pBoxes - Array of boxes with the same number of elements as the one
+    ///                      the hierarchy was built for.
+    ///
+    /// \remarks   Refitting is much cheaper than rebuilding, but the quality of the hierarchy
+    ///            degrades as the boxes move away from their original positions.
+    void Refit(const BoundBox* pBoxes);
+
+    void Clear();
+
+    bool IsEmpty() const
+    {
+        return m_Nodes.empty();
+    }
+
+    Uint32 GetNumItems() const
+    {
+        return static_cast<Uint32>(m_Items.size());
+    }
+
+    const std::vector<Node>& GetNodes() const
+    {
+        return m_Nodes;
+    }
+
+    /// Item indices referenced by the leaves.
+    const std::vector<Uint32>& GetItems() const
+    {
+        return m_Items;
+    }
+
+    /// Visits the items whose boxes are intersected by the ray.
+
+    /// \param [in]      Origin    - Ray origin.
+    /// \param [in]      Direction - Ray direction. Need not be normalized.
+    /// \param [in, out] MaxT      - The maximum ray parameter. The handler may reduce it when it finds
+    ///                              a hit, which prunes the nodes that are farther away.
+    /// \param [in]      Handler   - Callable with the signature void(Uint32 Item, float& MaxT).
+    ///
+    /// \remarks   The nearer child is visited first, so that the closest hit is typically
+    ///            found early and MaxT culls the rest of the traversal.
+    template <typename HandlerType>
+    void RayCast(const float3& Origin, const float3& Direction, float& MaxT, HandlerType&& Handler) const;
+
+    /// Visits the items whose boxes overlap the query box.
+
+    /// \param [in] Box     - Query box.
+    /// \param [in] Handler - Callable with the signature void(Uint32 Item).
+    template <typename HandlerType>
+    void QueryBox(const BoundBox& Box, HandlerType&& Handler) const;
+
+    /// Returns the distance along the ray to the box entry point, or +FLT_MAX if the ray misses
+    /// the box within [0, MaxT].
+    static float IntersectBox(const float3& Origin, const float3& InvDirection, float MaxT, const float3& Min, const float3& Max)
+    {
+        const float3 t0 = (Min - Origin) * InvDirection;
+        const float3 t1 = (Max - Origin) * InvDirection;
+
+        const float tEnter = std::max(std::max(std::min(t0.x, t1.x), std::min(t0.y, t1.y)), std::max(std::min(t0.z, t1.z), 0.f));
+        const float tExit  = std::min(std::min(std::max(t0.x, t1.x), std::max(t0.y, t1.y)), std::min(std::max(t0.z, t1.z), MaxT));
+        return tEnter <= tExit ? tEnter : +FLT_MAX;
+    }
+
+private:
+    // The maximum depth of the traversal stack. The hierarchy depth is limited
+    // accordingly when it is built.
+    static constexpr Uint32 MaxDepth = 64;
+
+    std::vector<Node>   m_Nodes;
+    std::vector<Uint32> m_Items;
+};
+
+template <typename HandlerType>
+void BoundingVolumeHierarchy::RayCast(const float3& Origin, const float3& Direction, float& MaxT, HandlerType&& Handler) const
+{
+    if (m_Nodes.empty())
+        return;
+
+    const float3 InvDir{
+        1.f / Direction.x,
+        1.f / Direction.y,
+        1.f / Direction.z,
+    };
+
+    if (IntersectBox(Origin, InvDir, MaxT, m_Nodes[0].Min, m_Nodes[0].Max) == +FLT_MAX)
+        return;
+
+    Uint32 Stack[MaxDepth];
+    Uint32 StackSize = 0;
+    Uint32 NodeIdx   = 0;
+    while (true)
+    {
+        const auto& N = m_Nodes[NodeIdx];
+        if (N.IsLeaf())
+        {
+            for (Uint32 i = 0; i < N.NumItems; ++i)
+                Handler(m_Items[N.FirstChildOrItem + i], MaxT);
+        }
+        else
+        {
+            const auto& Child0 = m_Nodes[N.FirstChildOrItem];
+            const auto& Child1 = m_Nodes[N.FirstChildOrItem + 1];
+
+            const float t0 = IntersectBox(Origin, InvDir, MaxT, Child0.Min, Child0.Max);
+            const float t1 = IntersectBox(Origin, InvDir, MaxT, Child1.Min, Child1.Max);
+            if (t0 != +FLT_MAX || t1 != +FLT_MAX)
+            {
+                Uint32 Near = N.FirstChildOrItem;
+                Uint32 Far  = N.FirstChildOrItem + 1;
+                if (t1 < t0)
+                    std::swap(Near, Far);
+
+                NodeIdx = Near;
+                if (t0 != +FLT_MAX && t1 != +FLT_MAX)
+                {
+                    VERIFY_EXPR(StackSize < MaxDepth);
+                    Stack[StackSize++] = Far;
+                }
+                continue;
+            }
+        }
+
+        // Pop the next node that is still closer than the nearest hit found so far
+        NodeIdx = ~0u;
+        while (StackSize > 0)
+        {
+            const auto& Candidate = m_Nodes[Stack[--StackSize]];
+            if (IntersectBox(Origin, InvDir, MaxT, Candidate.Min, Candidate.Max) != +FLT_MAX)
+            {
+                NodeIdx = Stack[StackSize];
+                break;
+            }
+        }
+        if (NodeIdx == ~0u)
+            break;
+    }
+}
+
+template <typename HandlerType>
+void BoundingVolumeHierarchy::QueryBox(const BoundBox& Box, HandlerType&& Handler) const
+{
+    if (m_Nodes.empty())
+        return;
+
+    Uint32 Stack[MaxDepth];
+    Uint32 StackSize = 0;
+
+    Stack[StackSize++] = 0;
+    while (StackSize > 0)
+    {
+        const auto& N = m_Nodes[Stack[--StackSize]];
+        if (N.Min.x > Box.Max.x || N.Min.y > Box.Max.y || N.Min.z > Box.Max.z ||
+            N.Max.x < Box.Min.x || N.Max.y < Box.Min.y || N.Max.z < Box.Min.z)
+            continue;
+
+        if (N.IsLeaf())
+        {
+            for (Uint32 i = 0; i < N.NumItems; ++i)
+                Handler(m_Items[N.FirstChildOrItem + i]);
+        }
+        else
+        {
+            VERIFY_EXPR(StackSize + 2 <= MaxDepth);
+            Stack[StackSize++] = N.FirstChildOrItem + 1;
+            Stack[StackSize++] = N.FirstChildOrItem;
+        }
+    }
+}
+
+
+/// Triangles of a mesh organized in a bounding volume hierarchy, see ModelCreateInfo::BuildCPUBVH.
+struct MeshBVH
+{
+    struct Triangle
+    {
+        /// Indices of the triangle vertices in the Positions array.
+        Uint32 Vertices[3] = {};
+
+        /// Index of the primitive in Mesh::Primitives and of the triangle in the primitive.
+        Uint32 PrimitiveIndex = 0;
+        Uint32 TriangleIndex  = 0;
+    };
+
+    /// Mesh-space positions of the vertices referenced by the triangles.
+    std::vector<float3> Positions;
+
+    std::vector<Triangle> Triangles;
+
+    /// Hierarchy whose items are the indices in the Triangles array.
+    BoundingVolumeHierarchy BVH;
+
+    /// Builds the hierarchy over the triangles.
+    void Build(Uint32 MaxLeafSize = 4);
+
+    /// Finds the closest triangle hit by the ray in the mesh space.
+
+    /// \param [in]      Origin       - Ray origin.
+    /// \param [in]      Direction    - Ray direction. Need not be normalized.
+    /// \param [in, out] MaxT         - The maximum ray parameter. Updated with the parameter of the hit.
+    /// \param [out]     Triangle     - Index of the hit triangle in the Triangles array.
+    /// \param [out]     Barycentrics - Barycentric coordinates of the hit point relative to the
+    ///                                 second and third vertices of the triangle.
+    ///
+    /// \return    true if a triangle closer than MaxT was hit, and false otherwise.
+    ///
+    /// \remarks   Both faces of the triangles are hit.
+    bool RayCast(const float3& Origin, const float3& Direction, float& MaxT, Uint32& Triangle, float2& Barycentrics) const;
+};
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "GLTFLoader.hpp"
+
+namespace Diligent
+{
+
+struct IThreadPool;
+
+namespace GLTF
+{
+
+/// Statistics of a batch of models loaded by LoadModels().
+struct ModelBatchLoadStats
+{
+    /// The number of models that have been loaded and that failed to load or were cancelled.
+    Uint32 NumLoadedModels = 0;
+    Uint32 NumFailedModels = 0;
+
+    /// The number of images that were not decoded because another model
+    /// of the batch uses the same image file.
+    Uint32 NumSharedImages = 0;
+
+    /// The number of file reads that were served from the data already read by another model.
+    Uint32 NumSharedFileReads = 0;
+};
+
+/// Loads several models at once.
+
+/// \param [in]  pDevice     - Render device.
+/// \param [in]  pContext    - Optional immediate device context. If not null, GPU resources of all
+///                            models are initialized, and the context is flushed once at the end.
+/// \param [in]  pThreadPool - Thread pool to load the models in.
+/// \param [in]  pCIs        - Array of NumModels model create infos. ModelCreateInfo::pThreadPool is
+///                            ignored, as the models are loaded in parallel with each other instead.
+/// \param [in]  NumModels   - The number of models to load.
+/// \param [out] pStats      - Optional statistics of the batch.
+///
+/// \return     The array of NumModels models. Models that failed to load or were cancelled
+///             (see ModelCreateInfo::pLoadProgress) are null.
+///
+/// \remarks    Files are parsed and geometry is converted concurrently. Then images referenced
+///             by several models are deduplicated before any of them is decoded: only the first
+///             model that references the image file decodes it, and the other models share the
+///             resulting texture through the texture cache or the resource manager. Models that use
+///             neither share a cache that is local to the batch. Images are then decoded, again
+///             in parallel, and textures are created in the order of the models.
+///
+///             Files that are read by the default file reader are read by dedicated I/O threads that
+///             keep many reads in flight (see AsyncFileReader). The model files are all requested up front,
+///             and every model is parsed as soon as its file has been read. Files shared by several
+///             models, such as buffers and images, are only read from disk once. The shared data is released once all
+///             models have been parsed. Models with a custom ModelCreateInfo::ReadWholeFileCallback
+///             read their files themselves.
+///
+///             Baked model files are loaded as usual, but baking (ModelCreateInfo::BakedFileName)
+///             is not supported, and the file name is ignored.
+///
+///             The method blocks until all models have been loaded and must not be called from
+///             a thread of pThreadPool.
+std::vector<std::unique_ptr<Model>> LoadModels(IRenderDevice*         pDevice,
+                                               IDeviceContext*        pContext,
+                                               IThreadPool*           pThreadPool,
+                                               const ModelCreateInfo* pCIs,
+                                               Uint32                 NumModels,
+                                               ModelBatchLoadStats*   pStats = nullptr);
+
+} // namespace GLTF
+
+} // namespace Diligent
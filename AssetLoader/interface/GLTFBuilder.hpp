@@ -26,14 +26,17 @@
 
 #pragma once
 
+#include <cfloat>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <algorithm>
 #include <string>
+#include <chrono>
 
 #include "GLTFLoader.hpp"
 #include "GraphicsAccessories.hpp"
+#include "ThreadPool.hpp"
 
 namespace Diligent
 {
@@ -45,6 +48,56 @@ struct Model;
 struct ModelCreateInfo;
 struct Node;
 
+/// Measures the wall time of a model loading stage zone and calls
+/// the profiler zone callback, see ModelLoadStats.
+class ScopedLoadStage
+{
+public:
+    ScopedLoadStage(ModelLoadStats* pStats, MODEL_LOAD_PROFILE_STAGE Stage) :
+        m_pStats{pStats},
+        m_Stage{Stage}
+    {
+        if (m_pStats == nullptr)
+            return;
+
+        if (m_pStats->ZoneCallback)
+            m_pStats->ZoneCallback(m_Stage, true);
+        m_StartTime = std::chrono::high_resolution_clock::now();
+    }
+
+    ~ScopedLoadStage()
+    {
+        if (m_pStats == nullptr)
+            return;
+
+        const auto EndTime = std::chrono::high_resolution_clock::now();
+        m_pStats->Stages[m_Stage].Time += std::chrono::duration<double>(EndTime - m_StartTime).count();
+        if (m_pStats->ZoneCallback)
+            m_pStats->ZoneCallback(m_Stage, false);
+    }
+
+    void AddItems(Uint64 NumItems, Uint64 NumBytes)
+    {
+        if (m_pStats == nullptr)
+            return;
+
+        auto& Stats = m_pStats->Stages[m_Stage];
+        Stats.NumItems += NumItems;
+        Stats.NumBytes += NumBytes;
+    }
+
+    // clang-format off
+    ScopedLoadStage           (const ScopedLoadStage&) = delete;
+    ScopedLoadStage& operator=(const ScopedLoadStage&) = delete;
+    // clang-format on
+
+private:
+    ModelLoadStats* const          m_pStats;
+    const MODEL_LOAD_PROFILE_STAGE m_Stage;
+
+    std::chrono::high_resolution_clock::time_point m_StartTime;
+};
+
 class ModelBuilder
 {
 public:
@@ -61,6 +114,31 @@ public:
 
     static TEXTURE_ADDRESS_MODE GetAddressMode(int32_t GltfWrapMode);
 
+    // Converts the integer value of a normalized accessor (see KHR_mesh_quantization)
+    // to the [0, 1] range for unsigned types and to the [-1, 1] range for signed types.
+    static float NormalizeGltfValue(float Value, VALUE_TYPE SrcType);
+
+    // Reads the accessor component as float. Normalized components are converted by NormalizeGltfValue().
+    static float ReadGltfValue(const void* pSrc, VALUE_TYPE SrcType, bool Normalized);
+
+    // Returns the index in Model::Meshes of the mesh that has been loaded from the GLTF mesh,
+    // or -1 if the mesh has not been loaded. Must be called after Execute().
+    int GetLoadedMeshIndex(int GltfMeshIndex) const;
+
+    // Moves the converted index, vertex and meshlet data out of the builder.
+    // Must be called after Execute().
+    void ReleaseConvertedData(std::vector<Uint8>&              IndexData,
+                              std::vector<std::vector<Uint8>>& VertexData,
+                              std::vector<Uint32>&             MeshletData);
+
+    // Creates GPU buffers from the previously converted data, e.g. loaded from a baked model file.
+    // Model meshlets must be initialized before the method is called.
+    void InitBuffers(std::vector<Uint8>              IndexData,
+                     std::vector<std::vector<Uint8>> VertexData,
+                     std::vector<Uint32>             MeshletData,
+                     IRenderDevice*                  pDevice,
+                     IDeviceContext*                 pContext);
+
 private:
     struct ConvertedBufferViewKey
     {
@@ -95,17 +173,81 @@ private:
     Mesh* LoadMesh(const GltfModelType& GltfModel,
                    int                  GltfMeshIndex);
 
+    // Loads the instance transforms defined by the EXT_mesh_gpu_instancing extension.
+    template <typename GltfModelType, typename GltfNodeType>
+    void LoadInstances(const GltfModelType& GltfModel,
+                       const GltfNodeType&  GltfNode,
+                       Node&                NewNode);
+
     template <typename GltfModelType>
     Camera* LoadCamera(const GltfModelType& GltfModel,
                        int                  GltfCameraIndex);
 
+    // Sparse deltas of a single morph target of the mesh that is being loaded.
+    struct MeshMorphTarget
+    {
+        std::vector<MorphTargetDelta> Deltas;
+
+        // Component-wise range of the position deltas, including zero.
+        float3 PosDeltaMin;
+        float3 PosDeltaMax;
+    };
+
+    // Delta of a single morph target attribute, relative to the primitive's first vertex.
+    struct MorphAttribDelta
+    {
+        Uint32 Vertex;
+        float3 Value;
+    };
+
+    // Reads the POSITION and NORMAL deltas of the primitive morph targets.
+    template <typename GltfModelType, typename GltfPrimitiveType>
+    void LoadMorphTargets(const GltfModelType&          GltfModel,
+                          const GltfPrimitiveType&      GltfPrimitive,
+                          Uint32                        VertexStart,
+                          Uint32                        VertexCount,
+                          std::vector<MeshMorphTarget>& Targets);
+
+    // Merges the position and normal deltas sorted by the vertex index and appends
+    // the deltas of the vertices that are displaced by the target.
+    static void AppendMorphTargetDeltas(const std::vector<MorphAttribDelta>& PosDeltas,
+                                        const std::vector<MorphAttribDelta>& NormalDeltas,
+                                        Uint32                               VertexStart,
+                                        MeshMorphTarget&                     Target);
+
+    // Moves the deltas to Model::MorphTargetDeltas, initializes the mesh
+    // morph targets and expands the mesh bounding box by the deltas.
+    void AddMeshMorphTargets(Mesh& DstMesh, std::vector<MeshMorphTarget>& Targets);
+
     void InitBuffers(IRenderDevice* pDevice, IDeviceContext* pContext);
 
+    // Pre-transforms the primitives of static nodes into the model space and merges
+    // them by material into the mesh of the node allocated for the flattened geometry.
+    void FlattenStaticNodes(int FlattenedNodeId);
+
+    // Reorders triangles of every primitive for post-transform vertex cache efficiency
+    // and then reorders vertices for pre-transform fetch locality.
+    void OptimizeVertexCache();
+
+    // Generates simplified levels of detail for every indexed primitive.
+    void GenerateLODs();
+
+    // Splits every indexed primitive into meshlets and computes their bounds.
+    void GenerateMeshlets();
+
+    // Copies the triangles of every mesh to Model::MeshBVHs and builds their hierarchies.
+    void BuildMeshBVHs();
+
+    // Reads the position of the given vertex from the converted vertex data.
+    // BB is the bounding box of the primitive the vertex belongs to.
+    float3 ReadVertexPosition(const VertexAttributeDesc& PosAttrib, Uint32 Vertex, const BoundBox& BB) const;
+
     template <typename GltfModelType>
     bool LoadAnimationAndSkin(const GltfModelType& GltfModel);
 
     static void WriteGltfData(const void*                  pSrc,
                               VALUE_TYPE                   SrcType,
+                              bool                         SrcNormalized,
                               Uint32                       NumSrcComponents,
                               Uint32                       SrcElemStride,
                               std::vector<Uint8>::iterator dst_it,
@@ -114,23 +256,59 @@ private:
                               Uint32                       DstElementStride,
                               Uint32                       NumElements);
 
+    // Writes vertex data using the attribute encoding (see VERTEX_ATTRIBUTE_ENCODING).
+    // BBMin and BBMax define the primitive's bounding box used by VERTEX_ATTRIBUTE_ENCODING_BOUNDING_BOX.
+    static void WriteEncodedGltfData(const void*                  pSrc,
+                                     VALUE_TYPE                   SrcType,
+                                     bool                         SrcNormalized,
+                                     Uint32                       NumSrcComponents,
+                                     Uint32                       SrcElemStride,
+                                     std::vector<Uint8>::iterator dst_it,
+                                     const VertexAttributeDesc&   DstAttrib,
+                                     Uint32                       DstElementStride,
+                                     Uint32                       NumElements,
+                                     const float3&                BBMin,
+                                     const float3&                BBMax);
+
+    // Allocates the space for VertexCount vertices at the end of every vertex buffer
+    // and writes the offsets of the allocated ranges to Data.
+    void AllocateVertexData(ConvertedBufferViewData& Data,
+                            Uint32                   VertexCount);
+
+    // Converts the vertex data into the ranges previously allocated by AllocateVertexData().
     template <typename GltfModelType>
-    void ConvertVertexData(const GltfModelType&          GltfModel,
-                           const ConvertedBufferViewKey& Key,
-                           ConvertedBufferViewData&      Data,
-                           Uint32                        VertexCount);
-
-    template <typename SrcType, typename DstType>
-    inline static void WriteIndexData(const void*                  pSrc,
-                                      size_t                       SrcStride,
-                                      std::vector<Uint8>::iterator dst_it,
-                                      Uint32                       NumElements,
-                                      Uint32                       BaseVertex);
+    void ConvertVertexData(const GltfModelType&           GltfModel,
+                           const ConvertedBufferViewKey&  Key,
+                           const ConvertedBufferViewData& Data,
+                           Uint32                         VertexCount,
+                           const float3&                  PosMin,
+                           const float3&                  PosMax);
+
+    // Converts the indices to the 16- or 32-bit destination type and adds the base vertex.
+    // Tightly packed indices are converted with SIMD instructions where they are available.
+    static void WriteIndexData(const void* pSrc,
+                               VALUE_TYPE  SrcType,
+                               size_t      SrcStride,
+                               Uint8*      pDst,
+                               Uint32      DstIndexSize,
+                               Uint32      NumElements,
+                               Uint32      BaseVertex);
+
+    // Converts the indices into the previously allocated range of m_IndexData that starts at FirstIndex.
+    template <typename GltfModelType>
+    void ConvertIndexData(const GltfModelType& GltfModel,
+                          int                  AccessorId,
+                          Uint32               BaseVertex,
+                          Uint32               FirstIndex);
+
+    // Selects the index type if it is not specified by ModelCreateInfo::IndexType.
+    void SelectIndexType();
 
+    // Converts the vertex and index data of all primitives loaded by LoadMesh().
+    // Every primitive is converted into its own range, so when the thread pool is
+    // provided, the primitives are converted in parallel.
     template <typename GltfModelType>
-    Uint32 ConvertIndexData(const GltfModelType& GltfModel,
-                            int                  AccessorId,
-                            Uint32               BaseVertex);
+    void ConvertPrimitiveData(const GltfModelType& GltfModel);
 
     template <typename GltfModelType>
     void LoadSkins(const GltfModelType& GltfModel);
@@ -138,9 +316,16 @@ private:
     template <typename GltfModelType>
     void LoadAnimations(const GltfModelType& GltfModel);
 
+    // Returns the accessor data. The data pointer is null if the accessor
+    // does not have a buffer view, which is allowed for sparse accessors.
     template <typename GltfModelType>
     auto GetGltfDataInfo(const GltfModelType& GltfModel, int AccessorId);
 
+    // Calls Handler(Uint32 Index, const void* pValue) for every element of the sparse accessor,
+    // where pValue points to the tightly packed element value. Does nothing if the accessor is not sparse.
+    template <typename GltfModelType, typename HandlerType>
+    void ProcessSparseElements(const GltfModelType& GltfModel, int AccessorId, HandlerType&& Handler);
+
     Node* NodeFromGltfIndex(int GltfIndex) const
     {
         auto it = m_NodeIndexRemapping.find(GltfIndex);
@@ -170,7 +355,48 @@ private:
     std::vector<Uint8>              m_IndexData;
     std::vector<std::vector<Uint8>> m_VertexData;
 
+    // Index and vertex ranges of all loaded primitives.
+    struct PrimitiveRange
+    {
+        Uint32 FirstIndex;
+        Uint32 IndexCount;
+        Uint32 VertexStart;
+        Uint32 VertexCount;
+
+        // Index of the mesh in Model::Meshes and of the primitive in Mesh::Primitives.
+        Uint32 MeshId;
+        Uint32 PrimitiveId;
+    };
+    std::vector<PrimitiveRange> m_PrimitiveRanges;
+
+    // Meshlet vertex indices and packed triangles.
+    std::vector<Uint32> m_MeshletData;
+
     ConvertedBufferViewMap m_ConvertedBuffers;
+
+    // Vertex and index data that has been allocated by LoadMesh(), but not converted yet.
+    // The pointers reference the elements of m_ConvertedBuffers, which are never moved.
+    struct PendingVertexData
+    {
+        const ConvertedBufferViewKey*  pKey;
+        const ConvertedBufferViewData* pData;
+        Uint32                         VertexCount;
+        float3                         PosMin;
+        float3                         PosMax;
+    };
+    std::vector<PendingVertexData> m_PendingVertexData;
+
+    struct PendingIndexData
+    {
+        int    AccessorId;
+        Uint32 BaseVertex;
+        Uint32 IndexCount;
+        Uint32 FirstIndex;
+    };
+    std::vector<PendingIndexData> m_PendingIndexData;
+
+    // The total number of indices of the primitives loaded by LoadMesh()
+    Uint32 m_NumIndices = 0;
 };
 
 
@@ -235,13 +461,17 @@ Mesh* ModelBuilder::LoadMesh(const GltfModelType& GltfModel,
 
     const size_t PrimitiveCount = GltfMesh.GetPrimitiveCount();
     NewMesh.Primitives.reserve(PrimitiveCount);
+
+    std::vector<MeshMorphTarget> MorphTargets;
+    // Vertex ranges whose morph targets have been loaded
+    std::unordered_set<Uint32> MorphedVertexRanges;
+
     for (size_t prim = 0; prim < PrimitiveCount; ++prim)
     {
         const auto& GltfPrimitive = GltfMesh.GetPrimitive(prim);
 
-        const auto DstIndexSize = m_Model.Buffers.back().ElementStride;
-
-        uint32_t IndexStart  = static_cast<uint32_t>(m_IndexData.size()) / DstIndexSize;
+        // The index data is allocated by ConvertPrimitiveData() once the index type is known
+        uint32_t IndexStart  = m_NumIndices;
         uint32_t VertexStart = 0;
         uint32_t IndexCount  = 0;
         uint32_t VertexCount = 0;
@@ -261,6 +491,13 @@ Mesh* ModelBuilder::LoadMesh(const GltfModelType& GltfModel,
                 Key.AccessorIds[i] = pAttribId != nullptr ? *pAttribId : -1;
             }
 
+            // Primitives that share the vertex attributes, but not the morph targets, must not share the vertex data
+            for (size_t t = 0; t < GltfPrimitive.GetTargetCount(); ++t)
+            {
+                Key.AccessorIds.push_back(GltfPrimitive.GetTargetAttributeId(t, "POSITION"));
+                Key.AccessorIds.push_back(GltfPrimitive.GetTargetAttributeId(t, "NORMAL"));
+            }
+
             {
                 auto* pPosAttribId = GltfPrimitive.GetAttribute("POSITION");
                 VERIFY(pPosAttribId != nullptr, "Position attribute is required");
@@ -272,21 +509,33 @@ Mesh* ModelBuilder::LoadMesh(const GltfModelType& GltfModel,
                 VertexCount = static_cast<uint32_t>(PosAccessor.GetCount());
             }
 
-            auto& Data = m_ConvertedBuffers[Key];
+            auto& Converted = *m_ConvertedBuffers.emplace(std::move(Key), ConvertedBufferViewData{}).first;
+            auto& Data      = Converted.second;
             if (Data.Offsets.empty())
             {
-                ConvertVertexData(GltfModel, Key, Data, VertexCount);
+                // The data is converted by ConvertPrimitiveData() once the ranges of all primitives are known
+                AllocateVertexData(Data, VertexCount);
+                m_PendingVertexData.push_back({&Converted.first, &Data, VertexCount, PosMin, PosMax});
             }
 
             VertexStart = StaticCast<uint32_t>(Data.Offsets[0] / m_Model.Buffers[0].ElementStride);
         }
 
+        if (GltfPrimitive.GetTargetCount() > 0 && MorphedVertexRanges.insert(VertexStart).second)
+        {
+            LoadMorphTargets(GltfModel, GltfPrimitive, VertexStart, VertexCount, MorphTargets);
+        }
+
         // Indices
         if (GltfPrimitive.GetIndicesId() >= 0)
         {
-            IndexCount = ConvertIndexData(GltfModel, GltfPrimitive.GetIndicesId(), VertexStart);
+            IndexCount = static_cast<uint32_t>(GltfModel.GetAccessor(GltfPrimitive.GetIndicesId()).GetCount());
+            m_PendingIndexData.push_back({GltfPrimitive.GetIndicesId(), VertexStart, IndexCount, IndexStart});
+            m_NumIndices += IndexCount;
         }
 
+        m_PrimitiveRanges.push_back({IndexStart, IndexCount, VertexStart, VertexCount, static_cast<Uint32>(LoadedMeshId), static_cast<Uint32>(prim)});
+
         NewMesh.Primitives.emplace_back(
             IndexStart,
             IndexCount,
@@ -295,6 +544,7 @@ Mesh* ModelBuilder::LoadMesh(const GltfModelType& GltfModel,
             PosMin,
             PosMax //
         );
+        NewMesh.Primitives.back().FirstVertex = VertexStart;
 
         if (m_CI.PrimitiveLoadCallback)
             m_CI.PrimitiveLoadCallback(&GltfPrimitive.Get(), NewMesh.Primitives.back());
@@ -312,6 +562,9 @@ Mesh* ModelBuilder::LoadMesh(const GltfModelType& GltfModel,
         }
     }
 
+    if (!MorphTargets.empty())
+        AddMeshMorphTargets(NewMesh, MorphTargets);
+
     if (m_CI.MeshLoadCallback)
         m_CI.MeshLoadCallback(&GltfMesh.Get(), NewMesh);
 
@@ -428,47 +681,277 @@ Node* ModelBuilder::LoadNode(const GltfModelType& GltfModel,
     NewNode.pMesh   = LoadMesh(GltfModel, GltfNode.GetMeshId());
     NewNode.pCamera = LoadCamera(GltfModel, GltfNode.GetCameraId());
 
+    if (NewNode.pMesh != nullptr && !NewNode.pMesh->MorphTargets.empty())
+    {
+        // Every node has its own weights, so that nodes that share the mesh can be animated independently.
+        // Weights that are not defined by the node are defined by the mesh.
+        const auto& NodeWeights = GltfNode.GetWeights();
+        const auto& MeshWeights = GltfModel.GetMesh(GltfNode.GetMeshId()).GetWeights();
+        const auto& Weights     = !NodeWeights.empty() ? NodeWeights : MeshWeights;
+
+        NewNode.MorphWeightsOffset = static_cast<int>(m_Model.DefaultMorphWeights.size());
+        for (size_t i = 0; i < NewNode.pMesh->MorphTargets.size(); ++i)
+            m_Model.DefaultMorphWeights.push_back(i < Weights.size() ? static_cast<float>(Weights[i]) : 0.f);
+    }
+
+    if (NewNode.pMesh != nullptr)
+        LoadInstances(GltfModel, GltfNode, NewNode);
+
     return &NewNode;
 }
 
+template <typename GltfModelType, typename GltfNodeType>
+void ModelBuilder::LoadInstances(const GltfModelType& GltfModel,
+                                 const GltfNodeType&  GltfNode,
+                                 Node&                NewNode)
+{
+    const int TranslationId = GltfNode.GetInstancingAttributeId("TRANSLATION");
+    const int RotationId    = GltfNode.GetInstancingAttributeId("ROTATION");
+    const int ScaleId       = GltfNode.GetInstancingAttributeId("SCALE");
+    if (TranslationId < 0 && RotationId < 0 && ScaleId < 0)
+        return;
+
+    size_t NumInstances = ~size_t{0};
+    for (auto AccessorId : {TranslationId, RotationId, ScaleId})
+    {
+        if (AccessorId >= 0)
+            NumInstances = std::min(NumInstances, static_cast<size_t>(GltfModel.GetAccessor(AccessorId).GetCount()));
+    }
+
+    // Reads the attribute values as floats. Integer attributes are allowed by KHR_mesh_quantization.
+    const auto ReadAttribute = [&](int AccessorId, Uint32 NumComponents) {
+        std::vector<float> Values;
+        if (AccessorId < 0)
+            return Values;
+
+        const auto Info     = GetGltfDataInfo(GltfModel, AccessorId);
+        const auto CompType = Info.Accessor.GetComponentType();
+        const auto CompSize = GetValueSize(CompType);
+        if (static_cast<Uint32>(Info.Accessor.GetNumComponents()) != NumComponents)
+        {
+            LOG_WARNING_MESSAGE("Instance attribute of node '", NewNode.Name, "' has unexpected number of components and is ignored");
+            return Values;
+        }
+
+        Values.resize(NumInstances * NumComponents);
+        for (size_t i = 0; i < NumInstances; ++i)
+        {
+            const auto* pSrc = static_cast<const Uint8*>(Info.pData) + i * Info.ByteStride;
+            for (Uint32 c = 0; c < NumComponents; ++c)
+                Values[i * NumComponents + c] = ReadGltfValue(pSrc + CompSize * c, CompType, Info.Accessor.IsNormalized());
+        }
+        return Values;
+    };
+    const auto Translations = ReadAttribute(TranslationId, 3);
+    const auto Rotations    = ReadAttribute(RotationId, 4);
+    const auto Scales       = ReadAttribute(ScaleId, 3);
+
+    NewNode.FirstInstance = static_cast<Uint32>(m_Model.InstanceMatrices.size());
+    NewNode.NumInstances  = static_cast<Uint32>(NumInstances);
+    m_Model.InstanceMatrices.reserve(m_Model.InstanceMatrices.size() + NumInstances);
+    for (size_t i = 0; i < NumInstances; ++i)
+    {
+        // InstanceMatrix = S * R * T
+        float4x4 InstanceMatrix = float4x4::Identity();
+        if (!Scales.empty())
+            InstanceMatrix = float4x4::Scale(float3::MakeVector(&Scales[i * 3]));
+        if (!Rotations.empty())
+        {
+            QuaternionF Rotation;
+            Rotation.q     = float4::MakeVector(&Rotations[i * 4]);
+            InstanceMatrix = InstanceMatrix * Rotation.ToMatrix();
+        }
+        if (!Translations.empty())
+            InstanceMatrix = InstanceMatrix * float4x4::Translation(float3::MakeVector(&Translations[i * 3]));
+
+        m_Model.InstanceMatrices.push_back(InstanceMatrix);
+    }
+
+    if (NumInstances > 0 && NewNode.pMesh->IsValidBB())
+    {
+        NewNode.InstancesBB.Min = float3{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+        NewNode.InstancesBB.Max = float3{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        for (size_t i = 0; i < NumInstances; ++i)
+        {
+            const auto InstanceBB   = NewNode.pMesh->BB.Transform(m_Model.InstanceMatrices[NewNode.FirstInstance + i]);
+            NewNode.InstancesBB.Min = std::min(NewNode.InstancesBB.Min, InstanceBB.Min);
+            NewNode.InstancesBB.Max = std::max(NewNode.InstancesBB.Max, InstanceBB.Max);
+        }
+    }
+}
+
+template <typename GltfModelType, typename GltfPrimitiveType>
+void ModelBuilder::LoadMorphTargets(const GltfModelType&          GltfModel,
+                                    const GltfPrimitiveType&      GltfPrimitive,
+                                    Uint32                        VertexStart,
+                                    Uint32                        VertexCount,
+                                    std::vector<MeshMorphTarget>& Targets)
+{
+    // Reads the deltas as floats. Integer deltas are allowed by KHR_mesh_quantization.
+    // Deltas of sparse accessors without a buffer view are not expanded, so that the
+    // memory and the time are proportional to the number of displaced vertices.
+    const auto ReadDeltas = [&](int AccessorId, std::vector<MorphAttribDelta>& Deltas) {
+        Deltas.clear();
+        if (AccessorId < 0)
+            return;
+
+        const auto Info     = GetGltfDataInfo(GltfModel, AccessorId);
+        const auto CompType = Info.Accessor.GetComponentType();
+        const auto CompSize = GetValueSize(CompType);
+        if (Info.Accessor.GetNumComponents() != 3 || static_cast<Uint32>(Info.Count) != VertexCount)
+        {
+            LOG_WARNING_MESSAGE("Morph target accessor ", AccessorId, " does not match the primitive vertices and is ignored");
+            return;
+        }
+
+        const auto ReadValue = [&](const void* pSrc) {
+            float3 Value;
+            for (Uint32 c = 0; c < 3; ++c)
+                Value[c] = ReadGltfValue(static_cast<const Uint8*>(pSrc) + CompSize * c, CompType, Info.Accessor.IsNormalized());
+            return Value;
+        };
+
+        if (Info.pData != nullptr)
+        {
+            Deltas.resize(VertexCount);
+            for (Uint32 v = 0; v < VertexCount; ++v)
+                Deltas[v] = {v, ReadValue(static_cast<const Uint8*>(Info.pData) + size_t{v} * Info.ByteStride)};
+
+            // Sparse elements replace the values of the buffer view
+            ProcessSparseElements(GltfModel, AccessorId, [&](Uint32 Index, const void* pValue) {
+                if (Index < VertexCount)
+                    Deltas[Index].Value = ReadValue(pValue);
+            });
+        }
+        else
+        {
+            ProcessSparseElements(GltfModel, AccessorId, [&](Uint32 Index, const void* pValue) {
+                if (Index < VertexCount)
+                    Deltas.push_back({Index, ReadValue(pValue)});
+            });
+
+            // Sparse indices must be strictly increasing, but malformed files may violate this
+            const auto VertexLess = [](const MorphAttribDelta& lhs, const MorphAttribDelta& rhs) {
+                return lhs.Vertex < rhs.Vertex;
+            };
+            if (!std::is_sorted(Deltas.begin(), Deltas.end(), VertexLess))
+                std::stable_sort(Deltas.begin(), Deltas.end(), VertexLess);
+        }
+    };
+
+    const auto TargetCount = GltfPrimitive.GetTargetCount();
+    if (Targets.size() < TargetCount)
+        Targets.resize(TargetCount);
+
+    std::vector<MorphAttribDelta> PosDeltas;
+    std::vector<MorphAttribDelta> NormalDeltas;
+    for (size_t t = 0; t < TargetCount; ++t)
+    {
+        ReadDeltas(GltfPrimitive.GetTargetAttributeId(t, "POSITION"), PosDeltas);
+        ReadDeltas(GltfPrimitive.GetTargetAttributeId(t, "NORMAL"), NormalDeltas);
+        AppendMorphTargetDeltas(PosDeltas, NormalDeltas, VertexStart, Targets[t]);
+    }
+}
+
 template <typename GltfModelType>
 auto ModelBuilder::GetGltfDataInfo(const GltfModelType& GltfModel, int AccessorId)
 {
-    const auto  GltfAccessor  = GltfModel.GetAccessor(AccessorId);
-    const auto  GltfView      = GltfModel.GetBufferView(GltfAccessor.GetBufferViewId());
-    const auto  GltfBuffer    = GltfModel.GetBuffer(GltfView.GetBufferId());
-    const auto* pSrcData      = GltfBuffer.GetData(GltfAccessor.GetByteOffset() + GltfView.GetByteOffset());
-    const auto  SrcCount      = GltfAccessor.GetCount();
-    const auto  SrcByteStride = GltfAccessor.GetByteStride(GltfView);
+    const auto GltfAccessor = GltfModel.GetAccessor(AccessorId);
+    const auto SrcCount     = GltfAccessor.GetCount();
+
+    // Sparse accessors may not have a buffer view, in which case the
+    // elements that are not defined by the sparse storage are zeros.
+    const void* pSrcData      = nullptr;
+    int         SrcByteStride = static_cast<int>(GetValueSize(GltfAccessor.GetComponentType()) * GltfAccessor.GetNumComponents());
+    if (GltfAccessor.GetBufferViewId() >= 0)
+    {
+        const auto GltfView   = GltfModel.GetBufferView(GltfAccessor.GetBufferViewId());
+        const auto GltfBuffer = GltfModel.GetBuffer(GltfView.GetBufferId());
+
+        pSrcData      = GltfBuffer.GetData(GltfAccessor.GetByteOffset() + GltfView.GetByteOffset());
+        SrcByteStride = GltfAccessor.GetByteStride(GltfView);
+    }
 
     struct GltfDataInfo
     {
         decltype(GltfAccessor) Accessor;
 
-        const void* const             pData;
-        const decltype(SrcCount)      Count;
-        const decltype(SrcByteStride) ByteStride;
+        const void* const        pData;
+        const decltype(SrcCount) Count;
+        const int                ByteStride;
     };
 
     return GltfDataInfo{GltfAccessor, pSrcData, SrcCount, SrcByteStride};
 }
 
-template <typename GltfModelType>
-void ModelBuilder::ConvertVertexData(const GltfModelType&          GltfModel,
-                                     const ConvertedBufferViewKey& Key,
-                                     ConvertedBufferViewData&      Data,
-                                     Uint32                        VertexCount)
+template <typename GltfModelType, typename HandlerType>
+void ModelBuilder::ProcessSparseElements(const GltfModelType& GltfModel, int AccessorId, HandlerType&& Handler)
+{
+    const auto GltfAccessor = GltfModel.GetAccessor(AccessorId);
+    if (!GltfAccessor.IsSparse())
+        return;
+
+    const auto IndicesView = GltfModel.GetBufferView(GltfAccessor.GetSparseIndicesViewId());
+    const auto ValuesView  = GltfModel.GetBufferView(GltfAccessor.GetSparseValuesViewId());
+
+    const auto* pIndices = static_cast<const Uint8*>(GltfModel.GetBuffer(IndicesView.GetBufferId()).GetData(IndicesView.GetByteOffset() + GltfAccessor.GetSparseIndicesByteOffset()));
+    const auto* pValues  = static_cast<const Uint8*>(GltfModel.GetBuffer(ValuesView.GetBufferId()).GetData(ValuesView.GetByteOffset() + GltfAccessor.GetSparseValuesByteOffset()));
+
+    // Sparse indices and values are tightly packed
+    const auto IndexType = GltfAccessor.GetSparseIndexType();
+    const auto IndexSize = GetValueSize(IndexType);
+    const auto ValueSize = size_t{GetValueSize(GltfAccessor.GetComponentType())} * GltfAccessor.GetNumComponents();
+
+    const auto Count = static_cast<size_t>(GltfAccessor.GetSparseCount());
+    for (size_t i = 0; i < Count; ++i)
+    {
+        const auto* pIndex = pIndices + i * IndexSize;
+
+        Uint32 Index = 0;
+        switch (IndexType)
+        {
+            // clang-format off
+            case VT_UINT8:  Index = *pIndex; break;
+            case VT_UINT16: Index = *reinterpret_cast<const Uint16*>(pIndex); break;
+            case VT_UINT32: Index = *reinterpret_cast<const Uint32*>(pIndex); break;
+            // clang-format on
+            default:
+                LOG_WARNING_MESSAGE("Unexpected sparse index type of accessor ", AccessorId, ". Sparse elements are ignored");
+                return;
+        }
+
+        Handler(Index, pValues + i * ValueSize);
+    }
+}
+
+inline void ModelBuilder::AllocateVertexData(ConvertedBufferViewData& Data,
+                                             Uint32                   VertexCount)
 {
     VERIFY_EXPR(Data.Offsets.empty());
     Data.Offsets.resize(m_VertexData.size());
     for (size_t i = 0; i < Data.Offsets.size(); ++i)
     {
         Data.Offsets[i] = m_VertexData[i].size();
+        // Buffers whose attributes have all been excluded by the vertex attribute mask are left empty
+        if (m_Model.Buffers[i].ElementStride == 0)
+            continue;
         VERIFY((Data.Offsets[i] % m_Model.Buffers[i].ElementStride) == 0, "Current offset is not a multiple of the element stride");
         m_VertexData[i].resize(m_VertexData[i].size() + size_t{VertexCount} * m_Model.Buffers[i].ElementStride);
     }
+}
 
-    VERIFY_EXPR(Key.AccessorIds.size() == m_Model.GetNumVertexAttributes());
+template <typename GltfModelType>
+void ModelBuilder::ConvertVertexData(const GltfModelType&           GltfModel,
+                                     const ConvertedBufferViewKey&  Key,
+                                     const ConvertedBufferViewData& Data,
+                                     Uint32                         VertexCount,
+                                     const float3&                  PosMin,
+                                     const float3&                  PosMax)
+{
+    VERIFY_EXPR(Data.Offsets.size() == m_VertexData.size());
+
+    // The key may also contain the morph target accessors
+    VERIFY_EXPR(Key.AccessorIds.size() >= m_Model.GetNumVertexAttributes());
     for (size_t i = 0; i < m_Model.GetNumVertexAttributes(); ++i)
     {
         const auto AccessorId = Key.AccessorIds[i];
@@ -480,38 +963,49 @@ void ModelBuilder::ConvertVertexData(const GltfModelType&          GltfModel,
 
         const auto GltfVerts     = GetGltfDataInfo(GltfModel, AccessorId);
         const auto ValueType     = GltfVerts.Accessor.GetComponentType();
+        const bool Normalized    = GltfVerts.Accessor.IsNormalized();
         const auto NumComponents = GltfVerts.Accessor.GetNumComponents();
-        const auto SrcStride     = GltfVerts.ByteStride;
+        const auto SrcStride     = static_cast<Uint32>(GltfVerts.ByteStride);
         VERIFY_EXPR(SrcStride > 0);
 
         auto dst_it = m_VertexData[Attrib.BufferId].begin() + Data.Offsets[Attrib.BufferId] + Attrib.RelativeOffset;
 
-        VERIFY_EXPR(static_cast<Uint32>(GltfVerts.Count) == VertexCount);
-        WriteGltfData(GltfVerts.pData, ValueType, NumComponents, SrcStride, dst_it, Attrib.ValueType, Attrib.NumComponents, VertexStride, VertexCount);
-    }
-}
+        const auto WriteElements = [&](const void* pSrc, Uint32 SrcElemStride, std::vector<Uint8>::iterator elem_it, Uint32 NumElements) {
+            if (Attrib.Encoding == VERTEX_ATTRIBUTE_ENCODING_NONE && Attrib.ValueType != VT_FLOAT16)
+                WriteGltfData(pSrc, ValueType, Normalized, NumComponents, SrcElemStride, elem_it, Attrib.ValueType, Attrib.NumComponents, VertexStride, NumElements);
+            else
+                WriteEncodedGltfData(pSrc, ValueType, Normalized, NumComponents, SrcElemStride, elem_it, Attrib, VertexStride, NumElements, PosMin, PosMax);
+        };
 
-template <typename SrcType, typename DstType>
-inline void ModelBuilder::WriteIndexData(const void*                  pSrc,
-                                         size_t                       SrcStride,
-                                         std::vector<Uint8>::iterator dst_it,
-                                         Uint32                       NumElements,
-                                         Uint32                       BaseVertex)
-{
-    for (size_t i = 0; i < NumElements; ++i)
-    {
-        const auto& SrcInd = *reinterpret_cast<const SrcType*>(static_cast<const Uint8*>(pSrc) + i * SrcStride);
-        auto&       DstInd = reinterpret_cast<DstType&>(*dst_it);
+        VERIFY_EXPR(static_cast<Uint32>(GltfVerts.Count) == VertexCount);
+        if (GltfVerts.pData != nullptr)
+        {
+            WriteElements(GltfVerts.pData, SrcStride, dst_it, VertexCount);
+        }
+        else if (Attrib.Encoding != VERTEX_ATTRIBUTE_ENCODING_NONE)
+        {
+            // The base values of a sparse accessor without a buffer view are zeros. The vertex
+            // data is zero-initialized, so only the encoded zeros need to be written.
+            static constexpr Uint8 Zeros[16] = {};
+            VERIFY_EXPR(SrcStride <= sizeof(Zeros));
+            WriteElements(Zeros, 0, dst_it, VertexCount);
+        }
 
-        DstInd = static_cast<DstType>(SrcInd + BaseVertex);
-        dst_it += sizeof(DstType);
+        // Only the elements that differ from the base values are written for sparse accessors.
+        // The base values are converted once, and primitives that use the same accessors
+        // share the converted data through the ConvertedBufferViewKey cache.
+        ProcessSparseElements(GltfModel, AccessorId, [&](Uint32 Index, const void* pValue) {
+            if (Index < VertexCount)
+                WriteElements(pValue, SrcStride, dst_it + size_t{Index} * VertexStride, 1);
+        });
     }
 }
 
 template <typename GltfModelType>
-Uint32 ModelBuilder::ConvertIndexData(const GltfModelType& GltfModel,
-                                      int                  AccessorId,
-                                      Uint32               BaseVertex)
+void ModelBuilder::ConvertIndexData(const GltfModelType& GltfModel,
+                                    int                  AccessorId,
+                                    Uint32               BaseVertex,
+                                    Uint32               FirstIndex)
 {
     VERIFY_EXPR(AccessorId >= 0);
 
@@ -519,49 +1013,127 @@ Uint32 ModelBuilder::ConvertIndexData(const GltfModelType& GltfModel,
     const auto IndexSize   = m_Model.Buffers.back().ElementStride;
     const auto IndexCount  = static_cast<uint32_t>(GltfIndices.Count);
 
-    auto IndexDataStart = m_IndexData.size();
-    VERIFY((IndexDataStart % IndexSize) == 0, "Current offset is not a multiple of index size");
-    m_IndexData.resize(IndexDataStart + size_t{IndexCount} * size_t{IndexSize});
-    auto index_it = m_IndexData.begin() + IndexDataStart;
+    VERIFY_EXPR((size_t{FirstIndex} + IndexCount) * IndexSize <= m_IndexData.size());
+    if (IndexCount == 0)
+        return;
+    auto* const pDstIndices = &m_IndexData[size_t{FirstIndex} * IndexSize];
 
     const auto ComponentType = GltfIndices.Accessor.GetComponentType();
     const auto SrcStride     = static_cast<size_t>(GltfIndices.ByteStride);
     VERIFY(SrcStride >= GetValueSize(ComponentType), "Byte stride (", SrcStride, ") is too small.");
     VERIFY_EXPR(IndexSize == 4 || IndexSize == 2);
-    switch (ComponentType)
+
+    if (BaseVertex == 0 && SrcStride == IndexSize && ComponentType == (IndexSize == 4 ? VT_UINT32 : VT_UINT16))
     {
-        case VT_UINT32:
-            if (IndexSize == 4)
-                WriteIndexData<Uint32, Uint32>(GltfIndices.pData, SrcStride, index_it, IndexCount, BaseVertex);
-            else
-                WriteIndexData<Uint32, Uint16>(GltfIndices.pData, SrcStride, index_it, IndexCount, BaseVertex);
-            break;
+        // Source indices already have the required layout - copy them without conversion
+        memcpy(pDstIndices, GltfIndices.pData, size_t{IndexCount} * size_t{IndexSize});
+        return;
+    }
 
-        case VT_UINT16:
-            if (IndexSize == 4)
-                WriteIndexData<Uint16, Uint32>(GltfIndices.pData, SrcStride, index_it, IndexCount, BaseVertex);
-            else
-                WriteIndexData<Uint16, Uint16>(GltfIndices.pData, SrcStride, index_it, IndexCount, BaseVertex);
-            break;
+    WriteIndexData(GltfIndices.pData, ComponentType, SrcStride, pDstIndices, IndexSize, IndexCount, BaseVertex);
+}
 
-        case VT_UINT8:
-            if (IndexSize == 4)
-                WriteIndexData<Uint8, Uint32>(GltfIndices.pData, SrcStride, index_it, IndexCount, BaseVertex);
-            else
-                WriteIndexData<Uint8, Uint16>(GltfIndices.pData, SrcStride, index_it, IndexCount, BaseVertex);
-            break;
+template <typename GltfModelType>
+void ModelBuilder::ConvertPrimitiveData(const GltfModelType& GltfModel)
+{
+    // Calls Convert(i) for every item. The items are split into tasks with approximately
+    // the same number of elements, so that large primitives do not serialize the conversion.
+    const auto ConvertItems = [this](size_t NumItems, auto&& GetNumElements, auto&& Convert) {
+        Uint64 TotalElements = 0;
+        for (size_t i = 0; i < NumItems; ++i)
+            TotalElements += GetNumElements(i);
+
+        // Do not pay the task overhead for small models
+        constexpr Uint64 MinElementsPerTask = 64 << 10;
+
+        const size_t NumTasks = m_CI.pThreadPool != nullptr ?
+            static_cast<size_t>(std::min<Uint64>(TotalElements / MinElementsPerTask, NumItems)) :
+            0;
+        if (NumTasks > 1)
+        {
+            const Uint64 ElementsPerTask = (TotalElements + NumTasks - 1) / NumTasks;
+
+            std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+            Tasks.reserve(NumTasks);
+            size_t RangeStart    = 0;
+            Uint64 RangeElements = 0;
+            for (size_t i = 0; i < NumItems; ++i)
+            {
+                RangeElements += GetNumElements(i);
+                if (RangeElements >= ElementsPerTask || i + 1 == NumItems)
+                {
+                    const auto RangeEnd = i + 1;
+                    Tasks.emplace_back(
+                        EnqueueAsyncWork(m_CI.pThreadPool,
+                                         [&Convert, RangeStart, RangeEnd](Uint32 ThreadId) {
+                                             for (size_t item = RangeStart; item < RangeEnd; ++item)
+                                                 Convert(item);
+                                         }));
+                    RangeStart    = RangeEnd;
+                    RangeElements = 0;
+                }
+            }
+
+            for (auto& pTask : Tasks)
+                pTask->WaitForCompletion();
+        }
+        else
+        {
+            for (size_t i = 0; i < NumItems; ++i)
+                Convert(i);
+        }
+        return TotalElements;
+    };
+
+    {
+        ScopedLoadStage Stage{m_CI.pLoadStats, MODEL_LOAD_PROFILE_STAGE_VERTEX_DATA};
+
+        const auto NumVertices = ConvertItems(
+            m_PendingVertexData.size(),
+            [this](size_t i) { return Uint64{m_PendingVertexData[i].VertexCount}; },
+            [this, &GltfModel](size_t i) {
+                const auto& Pending = m_PendingVertexData[i];
+                ConvertVertexData(GltfModel, *Pending.pKey, *Pending.pData, Pending.VertexCount, Pending.PosMin, Pending.PosMax);
+            });
+
+        Uint64 VertexSize = 0;
+        for (size_t i = 0; i < m_VertexData.size(); ++i)
+            VertexSize += m_Model.Buffers[i].ElementStride;
+        Stage.AddItems(NumVertices, NumVertices * VertexSize);
+    }
 
-        default:
-            UNEXPECTED("Index component type ", GetValueTypeString(ComponentType), " is not supported!");
-            return 0;
+    {
+        ScopedLoadStage Stage{m_CI.pLoadStats, MODEL_LOAD_PROFILE_STAGE_INDEX_DATA};
+
+        SelectIndexType();
+        VERIFY(m_IndexData.empty(), "Index data is expected to be allocated by this function only");
+        m_IndexData.resize(size_t{m_NumIndices} * m_Model.Buffers.back().ElementStride);
+
+        const auto NumIndices = ConvertItems(
+            m_PendingIndexData.size(),
+            [this](size_t i) { return Uint64{m_PendingIndexData[i].IndexCount}; },
+            [this, &GltfModel](size_t i) {
+                const auto& Pending = m_PendingIndexData[i];
+                ConvertIndexData(GltfModel, Pending.AccessorId, Pending.BaseVertex, Pending.FirstIndex);
+            });
+        Stage.AddItems(NumIndices, NumIndices * m_Model.Buffers.back().ElementStride);
     }
 
-    return IndexCount;
+    m_PendingVertexData.clear();
+    m_PendingIndexData.clear();
 }
 
 template <typename GltfModelType>
 void ModelBuilder::LoadSkins(const GltfModelType& GltfModel)
 {
+    // Skins that are not used by the loaded nodes are left empty when loading the scene subset
+    std::vector<bool> UsedSkins(GltfModel.GetSkinCount(), !m_CI.LoadSceneSubset);
+    for (const auto& it : m_NodeIdToSkinId)
+    {
+        if (it.second >= 0 && static_cast<size_t>(it.second) < UsedSkins.size())
+            UsedSkins[it.second] = true;
+    }
+
     m_Model.Skins.resize(GltfModel.GetSkinCount());
     for (size_t i = 0; i < GltfModel.GetSkinCount(); ++i)
     {
@@ -569,6 +1141,8 @@ void ModelBuilder::LoadSkins(const GltfModelType& GltfModel)
         auto&       NewSkin  = m_Model.Skins[i];
 
         NewSkin.Name = GltfSkin.GetName();
+        if (!UsedSkins[i])
+            continue;
 
         // Find skeleton root node
         if (GltfSkin.GetSkeletonId() >= 0)
@@ -599,12 +1173,26 @@ void ModelBuilder::LoadSkins(const GltfModelType& GltfModel)
 template <typename GltfModelType>
 void ModelBuilder::LoadAnimations(const GltfModelType& GltfModel)
 {
+    // Returns true if any channel of the animation targets a loaded node
+    const auto TargetsLoadedNodes = [this](const auto& GltfAnim) {
+        for (size_t chnl = 0; chnl < GltfAnim.GetChannelCount(); ++chnl)
+        {
+            if (NodeFromGltfIndex(GltfAnim.GetChannel(chnl).GetTargetNodeId()) != nullptr)
+                return true;
+        }
+        return false;
+    };
+
     const auto AnimationCount = GltfModel.GetAnimationCount();
-    m_Model.Animations.resize(AnimationCount);
+    m_Model.Animations.reserve(AnimationCount);
     for (size_t anim = 0; anim < AnimationCount; ++anim)
     {
         const auto& GltfAnim = GltfModel.GetAnimation(anim);
-        auto&       Anim     = m_Model.Animations[anim];
+        if (m_CI.LoadSceneSubset && !TargetsLoadedNodes(GltfAnim))
+            continue;
+
+        m_Model.Animations.emplace_back();
+        auto& Anim = m_Model.Animations.back();
 
         Anim.Name = GltfAnim.GetName();
         if (Anim.Name.empty())
@@ -648,29 +1236,39 @@ void ModelBuilder::LoadAnimations(const GltfModelType& GltfModel)
             // Read sampler output T/R/S values
             {
                 const auto GltfOutputs = GetGltfDataInfo(GltfModel, GltfSam.GetOutputId());
-                VERIFY(GltfOutputs.Accessor.GetComponentType() == VT_FLOAT32, "Float32 data is expected.");
-                VERIFY(GltfOutputs.ByteStride >= static_cast<int>(GltfOutputs.Accessor.GetNumComponents() * sizeof(float)), "Byte stide is too small.");
+                const auto ValueType   = GltfOutputs.Accessor.GetComponentType();
+                const bool Normalized  = GltfOutputs.Accessor.IsNormalized();
+                const auto CompSize    = GetValueSize(ValueType);
+                VERIFY(GltfOutputs.ByteStride >= static_cast<int>(GltfOutputs.Accessor.GetNumComponents() * CompSize), "Byte stide is too small.");
 
+                // Outputs may be quantized, see KHR_mesh_quantization
                 AnimSampler.OutputsVec4.reserve(GltfOutputs.Count);
                 const auto NumComponents = GltfOutputs.Accessor.GetNumComponents();
                 switch (NumComponents)
                 {
                     case 3:
+                    case 4:
                     {
                         for (size_t i = 0; i < GltfOutputs.Count; ++i)
                         {
-                            const auto& SrcVec3 = *reinterpret_cast<const float3*>(static_cast<const Uint8*>(GltfOutputs.pData) + GltfOutputs.ByteStride * i);
-                            AnimSampler.OutputsVec4.push_back(float4{SrcVec3, 0.0f});
+                            const auto* pSrcElem = static_cast<const Uint8*>(GltfOutputs.pData) + GltfOutputs.ByteStride * i;
+
+                            float4 Value;
+                            for (int c = 0; c < NumComponents; ++c)
+                                Value[c] = ReadGltfValue(pSrcElem + CompSize * c, ValueType, Normalized);
+                            AnimSampler.OutputsVec4.push_back(Value);
                         }
                         break;
                     }
 
-                    case 4:
+                    case 1:
                     {
+                        // Morph target weights
+                        AnimSampler.OutputWeights.reserve(GltfOutputs.Count);
                         for (size_t i = 0; i < GltfOutputs.Count; ++i)
                         {
-                            const auto& SrcVec4 = *reinterpret_cast<const float4*>(static_cast<const Uint8*>(GltfOutputs.pData) + GltfOutputs.ByteStride * i);
-                            AnimSampler.OutputsVec4.push_back(SrcVec4);
+                            const auto* pSrcElem = static_cast<const Uint8*>(GltfOutputs.pData) + GltfOutputs.ByteStride * i;
+                            AnimSampler.OutputWeights.push_back(ReadGltfValue(pSrcElem, ValueType, Normalized));
                         }
                         break;
                     }
@@ -691,11 +1289,6 @@ void ModelBuilder::LoadAnimations(const GltfModelType& GltfModel)
             const auto& GltfChannel = GltfAnim.GetChannel(chnl);
 
             const auto PathType = GltfChannel.GetPathType();
-            if (PathType == AnimationChannel::PATH_TYPE::WEIGHTS)
-            {
-                LOG_WARNING_MESSAGE("Weights are not yet supported, skipping channel");
-                continue;
-            }
 
             const auto SamplerIndex = GltfChannel.GetSamplerId();
             if (SamplerIndex < 0)
@@ -709,6 +1302,24 @@ void ModelBuilder::LoadAnimations(const GltfModelType& GltfModel)
             if (pNode == nullptr)
                 continue;
 
+            if (PathType == AnimationChannel::PATH_TYPE::WEIGHTS)
+            {
+                if (pNode->MorphWeightsOffset < 0 || static_cast<size_t>(SamplerIndex) >= Anim.Samplers.size())
+                {
+                    LOG_WARNING_MESSAGE("Node '", pNode->Name, "' has no morph targets, skipping weights channel");
+                    continue;
+                }
+
+                const auto& Sampler      = Anim.Samplers[SamplerIndex];
+                const auto  NumWeights   = pNode->pMesh->MorphTargets.size();
+                const auto  ValsPerInput = Sampler.Interpolation == AnimationSampler::INTERPOLATION_TYPE::CUBICSPLINE ? 3 : 1;
+                if (Sampler.OutputWeights.size() < Sampler.Inputs.size() * NumWeights * ValsPerInput)
+                {
+                    LOG_WARNING_MESSAGE("Weights sampler of node '", pNode->Name, "' does not have enough outputs, skipping channel");
+                    continue;
+                }
+            }
+
             Anim.Channels.emplace_back(PathType, pNode, SamplerIndex);
         }
     }
@@ -730,11 +1341,16 @@ bool ModelBuilder::LoadAnimationAndSkin(const GltfModelType& GltfModel)
         }
     }
 
-    if (!UsesAnimation)
+    // Morph target weights may be animated without skinning
+    if (!UsesAnimation && m_Model.DefaultMorphWeights.empty())
         return false;
 
-    LoadAnimations(GltfModel);
-    LoadSkins(GltfModel);
+    {
+        ScopedLoadStage Stage{m_CI.pLoadStats, MODEL_LOAD_PROFILE_STAGE_ANIMATIONS};
+        LoadAnimations(GltfModel);
+        LoadSkins(GltfModel);
+        Stage.AddItems(m_Model.Animations.size() + m_Model.Skins.size(), 0);
+    }
 
     // Assign skins
     for (int i = 0; i < static_cast<int>(m_Model.LinearNodes.size()); ++i)
@@ -768,6 +1384,17 @@ void ModelBuilder::Execute(const GltfModelType&    GltfModel,
     for (auto GltfNodeId : NodeIds)
         AllocateNode(GltfModel, GltfNodeId);
 
+    // Nodes and meshes must not be added once their pointers are taken, so the node
+    // that will hold the flattened geometry and its mesh are allocated up front.
+    int FlattenedNodeId = -1;
+    if (m_CI.FlattenStaticNodes)
+    {
+        FlattenedNodeId = static_cast<int>(m_Model.LinearNodes.size());
+        m_Model.LinearNodes.emplace_back(FlattenedNodeId);
+        m_Model.Meshes.emplace_back();
+        m_NodeIdToSkinId[FlattenedNodeId] = -1;
+    }
+
     m_Model.LinearNodes.shrink_to_fit();
     m_Model.Meshes.shrink_to_fit();
     m_Model.Cameras.shrink_to_fit();
@@ -776,8 +1403,42 @@ void ModelBuilder::Execute(const GltfModelType&    GltfModel,
     for (auto GltfNodeId : NodeIds)
         m_Model.RootNodes.push_back(LoadNode(GltfModel, nullptr, GltfNodeId));
 
+    ConvertPrimitiveData(GltfModel);
+
+    m_Model.InitNodeTransformOrder();
+
     LoadAnimationAndSkin(GltfModel);
 
+    if (FlattenedNodeId >= 0)
+    {
+        ScopedLoadStage Stage{m_CI.pLoadStats, MODEL_LOAD_PROFILE_STAGE_GEOMETRY_PROCESSING};
+        FlattenStaticNodes(FlattenedNodeId);
+        Stage.AddItems(m_Model.FlattenedRanges.size(), 0);
+    }
+
+    if (m_CI.OptimizeVertexCache || m_CI.NumLODs > 0 || m_CI.GenerateMeshlets)
+    {
+        ScopedLoadStage Stage{m_CI.pLoadStats, MODEL_LOAD_PROFILE_STAGE_GEOMETRY_PROCESSING};
+
+        if (m_CI.OptimizeVertexCache)
+            OptimizeVertexCache();
+
+        if (m_CI.NumLODs > 0)
+            GenerateLODs();
+
+        if (m_CI.GenerateMeshlets)
+            GenerateMeshlets();
+
+        Stage.AddItems(m_PrimitiveRanges.size(), 0);
+    }
+
+    if (m_CI.BuildCPUBVH)
+    {
+        ScopedLoadStage Stage{m_CI.pLoadStats, MODEL_LOAD_PROFILE_STAGE_GEOMETRY_PROCESSING};
+        BuildMeshBVHs();
+        Stage.AddItems(m_Model.MeshBVHs.size(), 0);
+    }
+
     InitBuffers(pDevice, pContext);
 
     if (pContext != nullptr)
@@ -0,0 +1,220 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/RenderDevice.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/DeviceContext.h"
+#include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
+#include "GLTFLoader.hpp"
+#include "GLTFModelInstance.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// Builds indirect draw lists for the primitives of multiple models.
+///
+/// Models that share a ResourceManager use the same vertex and index buffers, so
+/// all their primitives can be rendered by a small number of indirect draw calls.
+/// The builder collects primitives of all added model instances and groups them into
+/// batches that share the vertex and index buffers, the index type, the alpha mode
+/// and the double-sidedness of the material, so that every batch can be rendered with
+/// one pipeline state and one multi-draw indirect call.
+///
+/// Every draw command has a single instance, and its FirstInstanceLocation is set to the
+/// global draw index. The shader reads the draw index from the per-instance vertex attribute
+/// bound to the draw index buffer (see GetDrawIndexBuffer()), and uses it to fetch the
+/// DrawData from the draw data buffer. DrawData::MaterialIndex in turn addresses the
+/// material buffer that contains Material::ShaderAttribs of all added models.
+///
+/// Typical usage:
+///
+///     DrawList.Reset();
+///     for (auto& Inst : Instances)
+///         DrawList.AddModel(*Inst.pModel, Inst.Transforms);
+///     DrawList.Commit(pDevice, pContext);
+///     for (const auto& Batch : DrawList.GetBatches())
+///     {
+///         // Set pipeline state for Batch.AlphaMode and Batch.DoubleSided,
+///         // bind vertex buffers, Batch.pIndexBuffer and the draw index buffer.
+///         pContext->DrawIndexedIndirect(DrawList.GetDrawAttribs(Batch));
+///     }
+class DrawListBuilder
+{
+public:
+    /// Indexed indirect draw arguments in the layout expected by IDeviceContext::DrawIndexedIndirect().
+    struct DrawIndexedArgs
+    {
+        Uint32 NumIndices            = 0;
+        Uint32 NumInstances          = 1;
+        Uint32 FirstIndexLocation    = 0;
+        Uint32 BaseVertex            = 0;
+        Uint32 FirstInstanceLocation = 0;
+    };
+    static_assert(sizeof(DrawIndexedArgs) == 20, "Draw arguments must be tightly packed");
+
+    /// Per-draw data in the draw data buffer.
+    struct DrawData
+    {
+        /// Global node transform.
+        float4x4 NodeMatrix;
+
+        /// Index of the material in the material buffer.
+        Uint32 MaterialIndex = 0;
+
+        /// Index of the model instance in the order of AddModel() calls.
+        Uint32 InstanceIndex = 0;
+
+        Uint32 Padding0 = 0;
+        Uint32 Padding1 = 0;
+    };
+    static_assert(sizeof(DrawData) % 16 == 0, "Draw data size must be a multiple of 16 bytes");
+
+    /// Per-draw bounds in the draw bounds buffer, used by GPU culling (see OcclusionCulling).
+    struct DrawBounds
+    {
+        /// Primitive bounding box in the node space.
+        float3 BBMin;
+
+        /// Index of the first draw command of the batch the command belongs to.
+        Uint32 BatchFirstDraw = 0;
+
+        float3 BBMax;
+
+        Uint32 Padding = 0;
+    };
+    static_assert(sizeof(DrawBounds) == 32, "Draw bounds must be tightly packed");
+
+    /// A range of draw commands that can be rendered with a single indirect call.
+    struct Batch
+    {
+        static constexpr Uint32 MaxVertexBuffers = ResourceCacheUseInfo::MaxBuffers;
+
+        IBuffer* pIndexBuffer = nullptr;
+        IBuffer* pVertexBuffers[MaxVertexBuffers] = {};
+
+        Uint32     NumVertexBuffers = 0;
+        VALUE_TYPE IndexType        = VT_UINT32;
+
+        Material::ALPHA_MODE AlphaMode   = Material::ALPHA_MODE_OPAQUE;
+        bool                 DoubleSided = false;
+
+        /// Index of the first draw command in the draw arguments buffer and the number of commands.
+        Uint32 FirstDraw = 0;
+        Uint32 NumDraws  = 0;
+    };
+
+    /// Removes all model instances from the list.
+    void Reset();
+
+    /// Adds primitives of the model instance to the list.
+
+    /// \param [in] GLTFModel  - Model to add. Model GPU data must be initialized,
+    ///                          otherwise the model is skipped.
+    /// \param [in] Transforms - Model instance transforms, see Model::ComputeTransforms().
+    ///
+    /// \remarks    Non-indexed primitives are not added. The model and the transforms
+    ///             are referenced until Commit() is called.
+    ///             Materials of the model are added to the material buffer once,
+    ///             no matter how many instances of the model are added.
+    ///             Skinning is not handled: skinned primitives use the node matrix.
+    void AddModel(const Model& GLTFModel, const ModelTransforms& Transforms);
+
+    /// Adds primitives of the model instance to the list, see AddModel().
+
+    /// \remarks    Instances without material overrides share the materials of the model.
+    ///             Every instance that overrides materials adds its own copy of the model
+    ///             materials to the material buffer. The instance is referenced until Commit() is called.
+    void AddInstance(const ModelInstance& Instance);
+
+    /// Builds the batches and uploads the draw arguments, draw data and materials to the GPU.
+
+    /// \remarks    The buffers are created or grown as necessary and are transitioned
+    ///             to the states required for rendering.
+    void Commit(IRenderDevice* pDevice, IDeviceContext* pContext);
+
+    const std::vector<Batch>& GetBatches() const { return m_Batches; }
+
+    /// Returns the draw attributes to render the batch with IDeviceContext::DrawIndexedIndirect().
+    DrawIndexedIndirectAttribs GetDrawAttribs(const Batch& B) const;
+
+    /// Buffer with DrawIndexedArgs for all draw commands.
+
+    /// \remarks   The buffer is created in BUFFER_MODE_RAW mode with the BIND_SHADER_RESOURCE
+    ///            flag, so that compute shaders can read it as a byte address buffer.
+    IBuffer* GetDrawArgsBuffer() const { return m_pDrawArgsBuffer; }
+
+    /// Structured buffer with DrawBounds for all draw commands.
+    IBuffer* GetDrawBoundsBuffer() const { return m_pDrawBoundsBuffer; }
+
+    /// Structured buffer with DrawData for all draw commands.
+    IBuffer* GetDrawDataBuffer() const { return m_pDrawDataBuffer; }
+
+    /// Structured buffer with Material::ShaderAttribs of all added models.
+    IBuffer* GetMaterialBuffer() const { return m_pMaterialBuffer; }
+
+    /// Vertex buffer with Uint32 draw indices to bind as a per-instance vertex attribute.
+    IBuffer* GetDrawIndexBuffer() const { return m_pDrawIndexBuffer; }
+
+    size_t GetDrawCount() const { return m_DrawArgs.size(); }
+
+private:
+    struct InstanceInfo
+    {
+        const Model*           pModel      = nullptr;
+        const ModelTransforms* pTransforms = nullptr;
+        Uint32                 MaterialOffset;
+
+        // Instance with material overrides, or null if the model materials are used
+        const ModelInstance* pOverrides = nullptr;
+    };
+    std::vector<InstanceInfo> m_Instances;
+
+    std::unordered_map<const Model*, Uint32> m_MaterialOffsets;
+    std::vector<Material::ShaderAttribs>     m_Materials;
+
+    std::vector<Batch>           m_Batches;
+    std::vector<DrawIndexedArgs> m_DrawArgs;
+    std::vector<DrawData>        m_DrawData;
+    std::vector<DrawBounds>      m_DrawBounds;
+
+    RefCntAutoPtr<IBuffer> m_pDrawArgsBuffer;
+    RefCntAutoPtr<IBuffer> m_pDrawDataBuffer;
+    RefCntAutoPtr<IBuffer> m_pDrawBoundsBuffer;
+    RefCntAutoPtr<IBuffer> m_pMaterialBuffer;
+    RefCntAutoPtr<IBuffer> m_pDrawIndexBuffer;
+};
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -36,6 +36,7 @@
 #include <functional>
 #include <string>
 #include <limits>
+#include <memory>
 
 #include "../../../DiligentCore/Graphics/GraphicsEngine/interface/RenderDevice.h"
 #include "../../../DiligentCore/Graphics/GraphicsEngine/interface/DeviceContext.h"
@@ -44,6 +45,7 @@
 #include "../../../DiligentCore/Common/interface/AdvancedMath.hpp"
 #include "../../../DiligentCore/Common/interface/STDAllocator.hpp"
 #include "GLTFResourceManager.hpp"
+#include "GLTFBVH.hpp"
 
 namespace tinygltf
 {
@@ -60,6 +62,7 @@ namespace Diligent
 {
 
 enum IMAGE_FILE_FORMAT : Uint8;
+struct IThreadPool;
 
 namespace GLTF
 {
@@ -74,12 +77,32 @@ struct ResourceCacheUseInfo
     /// A pointer to the resource manager.
     ResourceManager* pResourceMgr = nullptr;
 
+    static constexpr Uint8 InvalidBufferIdx = 0xFF;
+
     /// Index to provide to the pResourceMgr->AllocateBufferSpace() function when allocating space for the index buffer.
     Uint8 IndexBufferIdx = 0;
 
+    /// Index to provide to the pResourceMgr->AllocateBufferSpace() function when allocating space for
+    /// 16-bit indices, see ModelCreateInfo::IndexType.
+
+    /// \remarks   Keeping 16- and 32-bit indices in separate buffers allows binding each index buffer
+    ///            with a single index type. If the value is InvalidBufferIdx (default), 16-bit indices
+    ///            are allocated in the IndexBufferIdx buffer as well.
+    Uint8 Index16BufferIdx = InvalidBufferIdx;
+
     /// Indices to provide to the pResourceMgr->AllocateBufferSpace() function when allocating space for each vertex buffer.
     Uint8 VertexBufferIdx[MaxBuffers] = {};
 
+    /// Whether to share vertex and index buffer allocations between models.
+
+    /// \remarks   When this flag is set, the converted data of every vertex and index buffer
+    ///            is hashed and the resource manager is searched for a live allocation with
+    ///            identical contents (e.g. created for the same mesh data referenced by another
+    ///            glTF file). If one is found, the model references it instead of allocating and
+    ///            uploading a new copy. All primitive offsets are relative to the model's buffer
+    ///            allocation, so the data is shared when the complete buffer matches.
+    bool ShareBufferData = false;
+
     /// Base color texture format.
     TEXTURE_FORMAT BaseColorFormat = TEX_FORMAT_RGBA8_UNORM;
 
@@ -97,6 +120,14 @@ struct ResourceCacheUseInfo
 
     /// Emissive texture format.
     TEXTURE_FORMAT EmissiveFormat = TEX_FORMAT_RGBA8_UNORM;
+
+    /// Returns the index of the buffer that holds the indices of the given type.
+    Uint8 GetIndexBufferIdx(VALUE_TYPE IndexType) const
+    {
+        return IndexType == VT_UINT16 && Index16BufferIdx != InvalidBufferIdx ?
+            Index16BufferIdx :
+            IndexBufferIdx;
+    }
 };
 
 
@@ -205,22 +236,107 @@ struct Material
     static_assert(sizeof(ShaderAttribs) % 16 == 0, "ShaderAttribs struct must be 16-byte aligned");
     ShaderAttribs Attribs;
 
+    /// Material name, see Model::FindMaterial().
+    std::string Name;
+
     bool DoubleSided = false;
 
     // Texture indices in Model.Textures array, for each attribute
     std::array<int, NumTextureAttributes> TextureIds = {};
+
+    /// 64-bit key that orders primitives to minimize state changes, see Model::SortPrimitives().
+
+    /// \remarks   The key is computed by the model when textures are committed. From the most
+    ///            to the least significant bits, it contains:
+    ///            - Alpha mode (2 bits): opaque, then masked, then blended materials
+    ///            - Pipeline variant (7 bits): double-sidedness, PBR workflow, and the mask
+    ///              of texture attributes the material uses
+    ///            - Texture set (23 bits): hash of the textures or atlases the material references
+    ///            - Depth (32 bits): always zero in the material key, filled by Model::SortPrimitives()
+    Uint64 SortKey = 0;
+
+    static constexpr Uint32 SortKeyDepthBits      = 32;
+    static constexpr Uint32 SortKeyTextureSetBits = 23;
+    static constexpr Uint32 SortKeyPipelineBits   = 7;
 };
 
 
+/// Meshlet (cluster of triangles) GPU data.
+///
+/// \remarks   Meshlet vertex indices and triangles are stored in the meshlet data buffer.
+///            Vertex indices are absolute indices in the vertex buffers. Every triangle is
+///            packed into a single 32-bit value with 8 bits per local vertex index.
+struct Meshlet
+{
+    /// Offset of the first vertex index in the meshlet data buffer.
+    Uint32 VertexOffset = 0;
+
+    /// Offset of the first packed triangle in the meshlet data buffer.
+    Uint32 TriangleOffset = 0;
+
+    /// The number of vertices in the meshlet.
+    Uint32 VertexCount = 0;
+
+    /// The number of triangles in the meshlet.
+    Uint32 TriangleCount = 0;
+
+    /// Bounding sphere: xyz - center, w - radius.
+    float4 BoundingSphere;
+
+    /// Normal cone: xyz - axis, w - cutoff.
+    /// The meshlet is back-facing for the camera at position P if
+    /// dot(C - P, axis) >= cutoff * length(C - P) + radius, where C is the
+    /// sphere center. Cutoff equal to 1 means that the cone is degenerate.
+    float4 NormalCone;
+};
+static_assert(sizeof(Meshlet) == 48, "Meshlet structure is expected to be tightly packed");
+
 struct Primitive
 {
     const Uint32 FirstIndex;
     const Uint32 IndexCount;
     const Uint32 VertexCount;
-    const Uint32 MaterialId;
+
+    /// Index of the material in Model::Materials. Changes when a material
+    /// variant is selected, see Model::SetMaterialVariant().
+    Uint32 MaterialId;
 
     const BoundBox BB;
 
+    /// Material of the primitive when no material variant is selected.
+    Uint32 DefaultMaterialId;
+
+    /// Materials of the primitive for every variant in Model::MaterialVariants, as defined by
+    /// the KHR_materials_variants extension. Variants that the primitive does not map use
+    /// DefaultMaterialId. Empty if the primitive has no variant mappings.
+    std::vector<Uint32> VariantMaterialIds;
+
+    /// Index of the first vertex of the primitive, relative to the model's base vertex.
+    /// Indices of the primitive are already offset by this value.
+    Uint32 FirstVertex = 0;
+
+    /// Index of the first meshlet in Model::Meshlets and the number of meshlets.
+    /// Only set when meshlets are generated (see ModelCreateInfo::GenerateMeshlets).
+    Uint32 FirstMeshlet = 0;
+    Uint32 MeshletCount = 0;
+
+    /// Simplified level of detail.
+    struct LOD
+    {
+        /// The first index and the number of indices in the index buffer.
+        Uint32 FirstIndex = 0;
+        Uint32 IndexCount = 0;
+
+        /// Approximate object-space geometric error of this level, compared to the original mesh.
+        /// Screen-space error in pixels can be estimated as
+        ///     Error * ViewportHeight / (2 * Distance * tan(FovY / 2)).
+        float Error = 0;
+    };
+
+    /// Simplified levels of detail in the order of decreasing triangle count, not including
+    /// the original mesh. Only set when LODs are generated (see ModelCreateInfo::NumLODs).
+    std::vector<LOD> LODs;
+
     Primitive(Uint32        _FirstIndex,
               Uint32        _IndexCount,
               Uint32        _VertexCount,
@@ -231,7 +347,8 @@ struct Primitive
         IndexCount{_IndexCount},
         VertexCount{_VertexCount},
         MaterialId{_MaterialId},
-        BB{_BBMin, _BBMax}
+        BB{_BBMin, _BBMax},
+        DefaultMaterialId{_MaterialId}
     {
     }
 
@@ -243,12 +360,52 @@ struct Primitive
     }
 };
 
+/// Source of a range of triangles in a flattened primitive, see ModelCreateInfo::FlattenStaticNodes.
+struct FlattenedPrimitiveRange
+{
+    /// The first index in the index buffer and the number of indices of the range.
+    Uint32 FirstIndex = 0;
+    Uint32 IndexCount = 0;
+
+    /// Index of the source node in Model::LinearNodes.
+    Uint32 NodeIndex = 0;
+
+    /// Index of the source mesh in Model::Meshes and of the primitive in Mesh::Primitives.
+    Uint32 MeshIndex      = 0;
+    Uint32 PrimitiveIndex = 0;
+};
+
+/// Sparse morph target delta of a single vertex, see Model::MorphTargetDeltas.
+struct MorphTargetDelta
+{
+    /// Index of the vertex, relative to the model's base vertex.
+    Uint32 Vertex = 0;
+
+    /// Position and normal deltas as half-precision floats.
+    Uint16 Position[3] = {};
+    Uint16 Normal[3]   = {};
+};
+static_assert(sizeof(MorphTargetDelta) == 16, "MorphTargetDelta structure is expected to be tightly packed");
+
 struct Mesh
 {
     std::string            Name;
     std::vector<Primitive> Primitives;
     BoundBox               BB;
 
+    /// Morph target of the mesh: the range of deltas in Model::MorphTargetDeltas.
+    ///
+    /// \remarks   The i-th target combines the i-th targets of all primitives. Deltas are
+    ///            sorted by the vertex index, and vertices that are not displaced by the
+    ///            target are not stored. The mesh bounding box includes the deltas of all
+    ///            targets applied with weights in [0, 1] range.
+    struct MorphTarget
+    {
+        Uint32 FirstDelta = 0;
+        Uint32 NumDeltas  = 0;
+    };
+    std::vector<MorphTarget> MorphTargets;
+
     // There may be no primitives in the mesh, in which
     // case the bounding box will be invalid.
     bool IsValidBB() const
@@ -321,6 +478,18 @@ struct Node
     float3      Scale  = float3{1, 1, 1};
     float4x4    Matrix = float4x4::Identity();
 
+    // Instances of the node mesh defined by the EXT_mesh_gpu_instancing extension:
+    // the range of instance matrices in Model::InstanceMatrices and the bounding box
+    // of all instances in the node space. NumInstances is zero if the node is not instanced.
+    Uint32   FirstInstance = 0;
+    Uint32   NumInstances  = 0;
+    BoundBox InstancesBB;
+
+    // Offset of the morph target weights of the node in ModelTransforms::MorphWeights,
+    // or -1 if the node's mesh has no morph targets. The number of weights is
+    // equal to the number of the mesh morph targets.
+    int MorphWeightsOffset = -1;
+
     explicit Node(int _Index) :
         Index{_Index}
     {}
@@ -360,26 +529,104 @@ struct AnimationSampler
     };
     const INTERPOLATION_TYPE Interpolation;
 
-    std::vector<float>  Inputs;
+    std::vector<float> Inputs;
+
+    /// Output values, one for each input. For CUBICSPLINE samplers, every key frame
+    /// stores the in-tangent, the value and the out-tangent in this order.
     std::vector<float4> OutputsVec4;
 
+    /// Output values of the morph target weights samplers: for each output,
+    /// the weights of all morph targets of the animated node's mesh.
+    std::vector<float> OutputWeights;
+
     explicit AnimationSampler(INTERPOLATION_TYPE _Interpolation) :
         Interpolation{_Interpolation}
     {}
 };
 
+/// Animation resampled at a fixed rate and quantized, see Model::BakeAnimations().
+struct BakedAnimation
+{
+    /// The number of quantized values stored for every track in each frame.
+    static constexpr Uint32 ValuesPerTrack = 3;
+
+    struct Track
+    {
+        /// Index of the animated node in Model.LinearNodes.
+        Uint32 NodeIndex = 0;
+
+        /// Animated property. Weights are not baked and are always evaluated from the samplers.
+        AnimationChannel::PATH_TYPE PathType = AnimationChannel::PATH_TYPE::TRANSLATION;
+
+        /// Whether the values must not be interpolated between frames (STEP interpolation).
+        bool Step = false;
+
+        /// Dequantization range of translation and scale tracks:
+        ///     Value = Min + Range * Q / 65535.
+        float3 Min;
+        float3 Range;
+    };
+    std::vector<Track> Tracks;
+
+    /// The number of frames per second and the number of frames.
+    /// The first frame is at Animation::Start, and the last one is at Animation::End.
+    float  SampleRate = 0;
+    Uint32 NumSamples = 0;
+
+    /// Quantized values, NumSamples frames of Tracks.size() * ValuesPerTrack values each.
+    /// Rotations use the smallest-three encoding: the three smallest quaternion components
+    /// are stored with 15 bits each, and the index of the largest one is stored in the top
+    /// bits of the first two values. Translations and scales are normalized to the track range.
+    std::vector<Uint16> Data;
+
+    bool IsValid() const
+    {
+        return NumSamples > 0;
+    }
+
+    size_t GetFrameStride() const
+    {
+        return Tracks.size() * ValuesPerTrack;
+    }
+};
+
 struct Animation
 {
     std::string                   Name;
     std::vector<AnimationSampler> Samplers;
     std::vector<AnimationChannel> Channels;
 
+    /// Resampled animation data. When valid, it is used instead of the samplers.
+    BakedAnimation Baked;
+
     float Start = +(std::numeric_limits<float>::max)();
     float End   = -(std::numeric_limits<float>::max)();
 };
 
 
 
+/// Vertex attribute encoding
+enum VERTEX_ATTRIBUTE_ENCODING : Uint8
+{
+    /// Source components are converted to the attribute value type as is.
+    VERTEX_ATTRIBUTE_ENCODING_NONE = 0,
+
+    /// Source components in [0, 1] range (for unsigned types) or [-1, 1] range
+    /// (for signed types) are converted to normalized integers.
+    VERTEX_ATTRIBUTE_ENCODING_NORMALIZED,
+
+    /// Unit vector is encoded into two signed normalized components using
+    /// octahedral mapping. The attribute must have two components of type
+    /// VT_INT8 or VT_INT16.
+    VERTEX_ATTRIBUTE_ENCODING_OCTAHEDRAL,
+
+    /// Source components are normalized to the primitive's bounding box and converted
+    /// to unsigned normalized integers. The original value is reconstructed in the
+    /// shader as BB.Min + Value * (BB.Max - BB.Min), see Primitive::BB.
+    /// Only valid for the "POSITION" attribute.
+    VERTEX_ATTRIBUTE_ENCODING_BOUNDING_BOX
+};
+
 /// Vertex attribute description.
 struct VertexAttributeDesc
 {
@@ -400,18 +647,23 @@ struct VertexAttributeDesc
     /// be computed automatically by placing the attribute right after the previous one.
     Uint32 RelativeOffset = ~0U;
 
+    /// Attribute encoding, see Diligent::GLTF::VERTEX_ATTRIBUTE_ENCODING.
+    VERTEX_ATTRIBUTE_ENCODING Encoding = VERTEX_ATTRIBUTE_ENCODING_NONE;
+
     constexpr VertexAttributeDesc() noexcept {}
 
-    constexpr VertexAttributeDesc(const char* _Name,
-                                  Uint8       _BufferId,
-                                  VALUE_TYPE  _ValueType,
-                                  Uint8       _NumComponents,
-                                  Uint32      _RelativeOffset = VertexAttributeDesc{}.RelativeOffset) noexcept :
+    constexpr VertexAttributeDesc(const char*               _Name,
+                                  Uint8                     _BufferId,
+                                  VALUE_TYPE                _ValueType,
+                                  Uint8                     _NumComponents,
+                                  Uint32                    _RelativeOffset = VertexAttributeDesc{}.RelativeOffset,
+                                  VERTEX_ATTRIBUTE_ENCODING _Encoding       = VertexAttributeDesc{}.Encoding) noexcept :
         Name{_Name},
         BufferId{_BufferId},
         ValueType{_ValueType},
         NumComponents{_NumComponents},
-        RelativeOffset{_RelativeOffset}
+        RelativeOffset{_RelativeOffset},
+        Encoding{_Encoding}
     {}
 };
 
@@ -429,6 +681,27 @@ static constexpr std::array<VertexAttributeDesc, 6> DefaultVertexAttributes =
         VertexAttributeDesc{"JOINTS_0",  1, VT_FLOAT32, 4},
         VertexAttributeDesc{"WEIGHTS_0", 1, VT_FLOAT32, 4},
     };
+
+/// Quantized vertex attributes.
+///
+/// Positions are stored as 16-bit unsigned normalized values relative to the primitive's
+/// bounding box, normals are octahedral-encoded into two 16-bit signed normalized values,
+/// texture coordinates are stored as 16-bit floats, joint indices as 8-bit unsigned integers
+/// and weights as 8-bit unsigned normalized values. Compared to the default attributes,
+/// this reduces the basic attributes from 40 to 20 bytes and skin attributes from 32 to 8 bytes
+/// per vertex.
+static constexpr std::array<VertexAttributeDesc, 6> QuantizedVertexAttributes =
+    {
+        // Basic attributes
+        VertexAttributeDesc{"POSITION",   0, VT_UINT16,  4, ~0U, VERTEX_ATTRIBUTE_ENCODING_BOUNDING_BOX},
+        VertexAttributeDesc{"NORMAL",     0, VT_INT16,   2, ~0U, VERTEX_ATTRIBUTE_ENCODING_OCTAHEDRAL},
+        VertexAttributeDesc{"TEXCOORD_0", 0, VT_FLOAT16, 2},
+        VertexAttributeDesc{"TEXCOORD_1", 0, VT_FLOAT16, 2},
+
+        // Skin attributes
+        VertexAttributeDesc{"JOINTS_0",  1, VT_UINT8, 4},
+        VertexAttributeDesc{"WEIGHTS_0", 1, VT_UINT8, 4, ~0U, VERTEX_ATTRIBUTE_ENCODING_NORMALIZED},
+    };
 // clang-format on
 
 InputLayoutDescX VertexAttributesToInputLayout(const VertexAttributeDesc* pAttributes, size_t NumAttributes);
@@ -439,8 +712,215 @@ struct TextureCacheType
     std::mutex TexturesMtx;
 
     std::unordered_map<std::string, RefCntWeakPtr<ITexture>> Textures;
+
+    /// Finds a live texture in the cache and updates the statistics.
+    RefCntAutoPtr<ITexture> Find(const std::string& CacheId);
+
+    /// Adds the texture to the cache. If the retention budget is not zero,
+    /// the texture is also retained, see CacheRetentionList.
+    void Add(const std::string& CacheId, ITexture* pTexture);
+
+    /// Sets the memory budget, in bytes, for the textures retained by the cache after
+    /// all models that use them have been destroyed. Zero (default) disables retention.
+    void SetRetentionBudget(Uint64 Budget);
+
+    TextureCacheStats GetStats();
+
+    /// Returns the shared sampler with the given description, see SamplerCache.
+    RefCntAutoPtr<ISampler> GetSampler(IRenderDevice* pDevice, const SamplerDesc& Desc)
+    {
+        return Samplers.GetSampler(pDevice, Desc);
+    }
+
+private:
+    SamplerCache                 Samplers;
+    CacheRetentionList<ITexture> RetainedTextures;
+    Uint64                       RetentionBudget = 0;
+    size_t                       PruneThreshold  = 64;
+    TextureCacheStats            Stats;
 };
 
+/// Model loading stage
+enum MODEL_LOAD_STAGE : Uint8
+{
+    /// Loading has not started yet.
+    MODEL_LOAD_STAGE_NOT_STARTED = 0,
+
+    /// The GLTF file is being parsed.
+    MODEL_LOAD_STAGE_PARSE,
+
+    /// Materials, nodes and meshes are being loaded and vertex data is being converted.
+    MODEL_LOAD_STAGE_VERTEX_CONVERSION,
+
+    /// Images are being decoded and texture data is being prepared.
+    MODEL_LOAD_STAGE_TEXTURE_DECODE,
+
+    /// Resources are being uploaded to the GPU.
+    MODEL_LOAD_STAGE_GPU_UPLOAD,
+
+    /// The model has been loaded.
+    MODEL_LOAD_STAGE_COMPLETE,
+
+    /// Loading has been cancelled.
+    MODEL_LOAD_STAGE_CANCELLED,
+
+    /// Loading has failed.
+    MODEL_LOAD_STAGE_FAILED
+};
+
+/// Model loading progress.
+///
+/// \remarks   The structure is updated by the loader and may be read from any thread.
+struct ModelLoadProgress
+{
+    /// Current loading stage.
+    std::atomic<MODEL_LOAD_STAGE> Stage{MODEL_LOAD_STAGE_NOT_STARTED};
+
+    /// The number of items processed in the current stage.
+    std::atomic<Uint32> NumItemsProcessed{0};
+
+    /// The total number of items in the current stage.
+    std::atomic<Uint32> NumItems{0};
+
+    /// When set to true by the application, the loader stops at the next
+    /// check point and throws an exception.
+    std::atomic_bool CancelRequested{false};
+};
+
+/// Model loading profiling stage, see ModelLoadStats.
+enum MODEL_LOAD_PROFILE_STAGE : Uint8
+{
+    /// Reading the file and parsing JSON. When images are not decoded in parallel,
+    /// this stage also includes image decoding.
+    MODEL_LOAD_PROFILE_STAGE_PARSE = 0,
+
+    /// Decoding buffer views compressed with the EXT_meshopt_compression extension
+    /// and primitives compressed with the KHR_draco_mesh_compression extension.
+    MODEL_LOAD_PROFILE_STAGE_GEOMETRY_DECOMPRESSION,
+
+    /// Vertex data conversion (ModelBuilder::ConvertVertexData).
+    MODEL_LOAD_PROFILE_STAGE_VERTEX_DATA,
+
+    /// Index data conversion (ModelBuilder::ConvertIndexData).
+    MODEL_LOAD_PROFILE_STAGE_INDEX_DATA,
+
+    /// Loading animations and skins.
+    MODEL_LOAD_PROFILE_STAGE_ANIMATIONS,
+
+    /// Vertex cache optimization, LOD and meshlet generation.
+    MODEL_LOAD_PROFILE_STAGE_GEOMETRY_PROCESSING,
+
+    /// Creating vertex and index buffers (ModelBuilder::InitBuffers).
+    MODEL_LOAD_PROFILE_STAGE_INIT_BUFFERS,
+
+    /// Deferred image decoding.
+    MODEL_LOAD_PROFILE_STAGE_IMAGE_DECODE,
+
+    /// Alpha cutoff processing and mip level generation.
+    MODEL_LOAD_PROFILE_STAGE_TEXTURE_PREPARE,
+
+    /// Creating textures and atlas allocations.
+    MODEL_LOAD_PROFILE_STAGE_TEXTURE_COMMIT,
+
+    MODEL_LOAD_PROFILE_STAGE_COUNT
+};
+
+/// Model loading statistics.
+///
+/// \remarks   Statistics are accumulated, so the same structure may be used to
+///            collect the totals for multiple models loaded one after another.
+///            The structure must not be shared by models loaded in parallel.
+struct ModelLoadStats
+{
+    struct StageStats
+    {
+        /// Wall time spent in the stage, in seconds.
+        double Time = 0;
+
+        /// The number of bytes produced by the stage, e.g. converted vertex
+        /// data, decoded pixels or GPU memory allocated for resources.
+        Uint64 NumBytes = 0;
+
+        /// The number of items processed by the stage, e.g. vertices,
+        /// indices, images, or the number of created GPU resources.
+        Uint64 NumItems = 0;
+    };
+    std::array<StageStats, MODEL_LOAD_PROFILE_STAGE_COUNT> Stages;
+
+    using ZoneCallbackType = std::function<void(MODEL_LOAD_PROFILE_STAGE Stage, bool IsBegin)>;
+    /// Optional callback that is called at the beginning and at the end of every stage zone,
+    /// e.g. to forward zones to an external profiler. Zones are not nested, but a single stage
+    /// may consist of multiple zones (e.g. vertex data is converted for every primitive).
+    /// The callback is called in the thread that executes the stage.
+    ZoneCallbackType ZoneCallback = nullptr;
+
+    static const char* GetStageName(MODEL_LOAD_PROFILE_STAGE Stage);
+};
+
+/// Memory used by a model, in bytes, see Model::GetMemoryStats().
+///
+/// \remarks   GPU sizes are computed from the resource descriptions and do not include
+///            alignment or padding added by the driver. Buffer suballocations and texture
+///            atlas regions only count the space allocated for the model, not the whole
+///            buffer or atlas. Resources shared with other models through the texture cache
+///            or the resource manager are counted by every model that uses them.
+struct ModelMemoryStats
+{
+    /// Vertex data: standalone vertex buffers or vertex buffer suballocations.
+    Uint64 VertexBufferSize = 0;
+
+    /// Index data: the standalone index buffer or the index buffer suballocation.
+    Uint64 IndexBufferSize = 0;
+
+    /// Meshlet, instance and morph target buffers.
+    Uint64 AuxBufferSize = 0;
+
+    /// Standalone textures, including all mip levels.
+    Uint64 TextureSize = 0;
+
+    /// Texture atlas regions, including all mip levels.
+    Uint64 AtlasRegionSize = 0;
+
+    /// CPU data that waits to be uploaded to the GPU, see Model::GetCPUDataSize().
+    Uint64 PendingUploadSize = 0;
+
+    /// Nodes, meshes, primitives, skins and cameras.
+    Uint64 SceneDataSize = 0;
+
+    /// Animation samplers, channels and baked animations.
+    Uint64 AnimationDataSize = 0;
+
+    /// Materials, samplers, vertex and texture attribute descriptions.
+    Uint64 MaterialDataSize = 0;
+
+    /// CPU copies of geometry: meshlets, instance matrices, morph target deltas and bounding volume hierarchies.
+    Uint64 GeometryDataSize = 0;
+
+    Uint64 GetGPUSize() const
+    {
+        return VertexBufferSize + IndexBufferSize + AuxBufferSize + TextureSize + AtlasRegionSize;
+    }
+
+    Uint64 GetCPUSize() const
+    {
+        return PendingUploadSize + SceneDataSize + AnimationDataSize + MaterialDataSize + GeometryDataSize;
+    }
+};
+
+/// Block compression applied to textures at load time, see ModelCreateInfo::TextureCompressMode.
+enum TEXTURE_COMPRESS_MODE : Uint8
+{
+    /// Textures are uploaded in the format they were decoded to.
+    TEXTURE_COMPRESS_MODE_NONE = 0,
+
+    /// RGBA textures are compressed to BC3, or to BC1 if they are opaque,
+    /// two-channel textures are compressed to BC5, and one-channel textures - to BC4.
+    TEXTURE_COMPRESS_MODE_BC
+};
+
+/// Extension of the baked model files, see ModelCreateInfo::BakedFileName.
+static constexpr char BakedModelFileExtension[] = "dgltf";
+
 /// Model create information
 struct ModelCreateInfo
 {
@@ -478,7 +958,22 @@ struct ModelCreateInfo
     /// Optional callback function that will be called by the loader to read the whole file.
     ReadWholeFileCallbackType ReadWholeFileCallback = nullptr;
 
+    using ReadFileRangeCallbackType = std::function<bool(const char* FilePath, size_t Offset, size_t Size, std::vector<unsigned char>& Data, std::string& Error)>;
+    /// Optional callback function that will be called by the loader to read Size bytes at Offset of the file.
+
+    /// \remarks    When the callback is set, external .bin buffers are not read as a whole.
+    ///             Instead, only the byte ranges of the buffer views referenced by the loaded
+    ///             meshes, skins, animations and images are read. Close ranges are merged into
+    ///             a single read. Buffers embedded into .glb files and data URIs are not affected.
+    ReadFileRangeCallbackType ReadFileRangeCallback = nullptr;
+
     /// Index data type.
+
+    /// \remarks   If VT_UNDEFINED is specified, the type is selected for every model: 16-bit indices
+    ///            are used if all vertices of the model can be addressed by them, and 32-bit indices
+    ///            otherwise. Indices are relative to the model's base vertex (see Model::GetBaseVertex()),
+    ///            so the number of vertices in the shared vertex buffers does not matter.
+    ///            Use Model::GetIndexType() to get the selected type.
     VALUE_TYPE IndexType = VT_UINT32;
 
     /// Index buffer bind flags
@@ -509,6 +1004,189 @@ struct ModelCreateInfo
     /// Index of the scene to load. If -1, default scene will be loaded.
     Int32 SceneId = -1;
 
+    /// Whether to load only the objects that are reachable from the nodes of the loaded scene.
+    ///
+    /// \remarks   When enabled, materials, textures and skins that are not used by the scene
+    ///            are not loaded, and their entries in Model::Materials, Model::Textures and
+    ///            Model::Skins are left empty so that the indices still match the glTF file.
+    ///            Images that are not used by the scene are never decoded, and Draco-compressed
+    ///            meshes that are not used are not decompressed.
+    ///            Animations that do not target any node of the scene are skipped entirely,
+    ///            so animation indices refer to the loaded animations only.
+    ///            Materials of all KHR_materials_variants variants of the used meshes are loaded.
+    bool LoadSceneSubset = false;
+
+    /// Bit mask of the vertex attributes to load. Bit i corresponds to the i-th element
+    /// of VertexAttributes (or DefaultVertexAttributes if VertexAttributes is null).
+    ///
+    /// \remarks   Attributes whose bits are not set are removed from the model vertex layout
+    ///            and are neither converted nor uploaded. Vertex buffers that are left without
+    ///            attributes are not created. This allows loading e.g. only positions for
+    ///            depth-only or collision passes using the same attribute array.
+    ///            The POSITION attribute must not be excluded. Attributes with indices 32 and
+    ///            above are always loaded.
+    Uint32 VertexAttributeMask = ~0u;
+
+    /// Bit mask of the texture attributes to load. Bit i corresponds to the i-th element
+    /// of TextureAttributes (or DefaultTextureAttributes if TextureAttributes is null).
+    ///
+    /// \remarks   Texture slots whose bits are not set are not assigned to the materials,
+    ///            and textures that are not used by any other slot are neither decoded nor
+    ///            created. Their entries in Model::Textures are left empty.
+    Uint32 TextureAttributeMask = ~0u;
+
+    /// Whether to merge the geometry of static nodes into a few large primitives.
+    ///
+    /// \remarks   Nodes that are not animated (neither directly nor through their parents),
+    ///            are not skinned, morphed or instanced, and whose primitives are all indexed
+    ///            triangle lists are pre-transformed into the model space by their rest-pose
+    ///            matrices. Their primitives are merged into one primitive per material in the
+    ///            mesh of a new root node, and the source nodes no longer reference their meshes.
+    ///            Model::FlattenedRanges maps the triangles of the merged primitives back to the
+    ///            source nodes and primitives, e.g. for picking.
+    ///
+    ///            The merged primitives are culled as a whole. Global matrices of the flattened
+    ///            nodes are not updated by ComputeTransforms() unless their subtrees contain other
+    ///            objects. The source meshes keep their data, as they may be used by other nodes.
+    ///
+    ///            Positions, normals and tangents must be 32-bit floats without encoding.
+    ///            If the model uses 16-bit indices that can't address the merged vertices,
+    ///            the index type is changed to 32 bits when it is selected automatically
+    ///            (see IndexType), and the nodes are not flattened otherwise.
+    bool FlattenStaticNodes = false;
+
+    /// Whether to optimize the index and vertex data for the GPU vertex cache.
+    ///
+    /// \remarks   When enabled, triangles of each primitive are reordered to improve
+    ///            post-transform vertex cache utilization, and vertices are then
+    ///            reordered in the order of their first use to improve fetch locality.
+    ///            Average cache miss ratio (ACMR) before and after the optimization
+    ///            is written to the log.
+    bool OptimizeVertexCache = false;
+
+    /// Whether to split every indexed primitive into meshlets.
+    ///
+    /// \remarks   Meshlets are stored in Model::Meshlets and are also uploaded to the
+    ///            meshlet buffer (see Model::GetMeshletBuffer), while meshlet vertex indices
+    ///            and triangles are stored in the meshlet data buffer (see Model::GetMeshletDataBuffer).
+    bool GenerateMeshlets = false;
+
+    /// The maximum number of vertices in a meshlet. Must not exceed 256.
+    Uint32 MaxMeshletVertices = 64;
+
+    /// The maximum number of triangles in a meshlet.
+    Uint32 MaxMeshletTriangles = 124;
+
+    /// The number of simplified levels of detail to generate for every indexed primitive.
+    ///
+    /// \remarks   LOD indices are stored in the same index buffer as the original indices
+    ///            and reference the same vertices (see Primitive::LODs).
+    Uint32 NumLODs = 0;
+
+    /// The ratio between the triangle counts of two consecutive levels of detail.
+    float LODReductionFactor = 0.5f;
+
+    /// Whether to keep a CPU copy of the mesh triangles organized in bounding volume hierarchies.
+    ///
+    /// \remarks   The hierarchies are stored in Model::MeshBVHs and are used by Model::RayCast().
+    ///            Triangles of all indexed and non-indexed triangle-list primitives are included.
+    ///            Positions must not be 16-bit floats.
+    bool BuildCPUBVH = false;
+
+    /// The maximum number of triangles in a leaf of the mesh hierarchies, see BuildCPUBVH.
+    Uint32 BVHMaxLeafSize = 4;
+
+    /// Optional thread pool to use for parallel texture and geometry decoding and processing.
+    ///
+    /// \remarks   When thread pool is provided, images are decoded, their alpha
+    ///            channel is processed and mip levels are generated in parallel.
+    ///            Textures are added to the model in the original order, so the
+    ///            result is identical to serial loading. Compressed buffer views
+    ///            and Draco primitives are also decoded in parallel.
+    IThreadPool* pThreadPool = nullptr;
+
+    /// Optional allocator for the vertex and texture attribute tables of the model
+    /// and for the mip data of DDS and KTX textures.
+    ///
+    /// \remarks   If null, the default raw memory allocator is used. The allocator must
+    ///            outlive the model and must be thread-safe if pThreadPool is not null.
+    IMemoryAllocator* pAllocator = nullptr;
+
+    /// Optional progress structure that will be updated by the loader.
+    ///
+    /// \remarks   If CancelRequested is set while the model is being loaded,
+    ///            the loader throws an exception.
+    ModelLoadProgress* pLoadProgress = nullptr;
+
+    /// Optional statistics structure that the loader adds per-stage timings to, see ModelLoadStats.
+    ModelLoadStats* pLoadStats = nullptr;
+
+    /// Optional path of the baked model file to write.
+    ///
+    /// \remarks   A baked model file contains nodes, meshes, materials, animations, converted
+    ///            vertex and index data in the GPU-ready layout as well as decoded textures with
+    ///            all mip levels. When FileName has the BakedModelFileExtension extension, the model
+    ///            is loaded from the baked file without parsing the GLTF or decoding any images.
+    ///
+    ///            The baked file must be loaded with the same vertex and texture attributes it
+    ///            was baked with. Mesh, primitive and material callbacks are not called when loading
+    ///            a baked model, but the modifications made by these callbacks when the model was baked
+    ///            are preserved. Textures that were found in the texture cache or the resource manager
+    ///            while the model was baked are not stored in the file.
+    ///
+    ///            Baking is only performed by the Model constructor and Model::Bake(), and is ignored
+    ///            by AsyncModelLoader.
+    const char* BakedFileName = nullptr;
+
+    /// The number of the most detailed mip levels of atlas textures that are not uploaded
+    /// when the model is loaded.
+
+    /// \remarks   This member is only used when the resource manager is used. When it is not zero,
+    ///            every decoded texture first gets a smaller atlas allocation that only contains the
+    ///            low-resolution mip tail, which reduces the time to the first frame and the atlas
+    ///            memory used by textures that are never seen up close. Full-resolution mip levels
+    ///            are kept in CPU memory and are uploaded by Model::StreamTextures().
+    ///
+    ///            Streamed textures are not added to the resource manager cache and are not shared
+    ///            with other models. DDS and KTX textures are always loaded completely.
+    Uint32 NumStreamedTextureMips = 0;
+
+    /// Block compression to apply to the decoded textures.
+
+    /// \remarks   Textures are compressed on the CPU after the mip levels have been generated,
+    ///            in parallel when the thread pool is used. When the model is baked, compressed
+    ///            levels are stored in the baked file, so the compression only runs once.
+    ///            The application is responsible for checking that the device supports
+    ///            the compressed formats.
+    ///
+    ///            When the resource manager is used, compressed textures are allocated in the atlases
+    ///            of the compressed formats. A texture is left uncompressed if the atlas allocation
+    ///            alignment is too small to keep every mip level aligned to 4x4 blocks, or if its
+    ///            mip levels are streamed (see NumStreamedTextureMips). Without the resource manager,
+    ///            only textures whose dimensions are multiples of 4 are compressed, and their mip
+    ///            levels are generated on the CPU. DDS and KTX textures are never recompressed.
+    TEXTURE_COMPRESS_MODE TextureCompressMode = TEXTURE_COMPRESS_MODE_NONE;
+
+    /// The maximum texture width and height, or zero for no limit.
+
+    /// \remarks   Larger images are reduced before their mip levels are generated: JPEG images are
+    ///            decoded at 1/2, 1/4 or 1/8 scale where possible, and the decoded images are then halved
+    ///            until they fit. DDS and KTX textures skip their larger mip levels without reading them,
+    ///            see TextureLoadInfo::MaxDimension. Baked models store the reduced textures.
+    Uint32 MaxTextureDimension = 0;
+
+    /// The number of frames per second to resample the animations at, see Model::BakeAnimations().
+    /// Zero (default) keeps the original key frames.
+    float AnimationSampleRate = 0;
+
+    /// Mask of the immediate contexts that use the textures created by the model, see TextureDesc::ImmediateContextMask.
+
+    /// \remarks   To upload the model on a transfer queue (see Model::PrepareGPUResources), the mask must contain the
+    ///            bits of both the transfer context and the contexts that render the model. Vertex and index buffers
+    ///            are initialized when they are created and are not affected. Buffers and atlases of the resource
+    ///            manager are created by the manager and must be given the mask by the application.
+    Uint64 ImmediateContextMask = 1;
+
     ModelCreateInfo() = default;
 
     explicit ModelCreateInfo(const char*                _FileName,
@@ -547,6 +1225,10 @@ struct ModelTransforms
     };
     std::vector<SkinTransforms> Skins;
 
+    // Morph target weights of all nodes whose meshes have morph targets, see Node::MorphWeightsOffset.
+    // The weights are reset to Model::DefaultMorphWeights and then animated.
+    std::vector<float> MorphWeights;
+
     // Node animation transforms.
     // This is an intermediate data to compute transform matrices.
     struct AnimationTransforms
@@ -556,6 +1238,206 @@ struct ModelTransforms
         QuaternionF Rotation;
     };
     std::vector<AnimationTransforms> NodeAnimations;
+
+    // Keyframe search cursors.
+    // For each sampler of the last evaluated animation, the index of the keyframe
+    // found during the previous update. Since the animation time typically changes
+    // only slightly between frames, the cursor makes the keyframe lookup O(1) in
+    // most cases.
+    Int32               CursorAnimationIndex = -1;
+    std::vector<Uint32> SamplerKeyFrameCursors;
+
+    // Scratch data used by Model::ComputeBlendedTransforms(). The vectors are
+    // only resized when the model or the number of layers changes.
+    struct BlendScratch
+    {
+        // Pose of the layer being evaluated and the reference pose of an additive layer.
+        std::vector<AnimationTransforms> LayerPose;
+        std::vector<AnimationTransforms> ReferencePose;
+
+        // Morph target weights of the layer pose and the reference pose.
+        std::vector<float> LayerMorphWeights;
+        std::vector<float> ReferenceMorphWeights;
+
+        // Keyframe search cursors of each layer, see SamplerKeyFrameCursors.
+        struct LayerCursors
+        {
+            Int32               AnimationIndex = -1;
+            std::vector<Uint32> SamplerKeyFrameCursors;
+        };
+        std::vector<LayerCursors> Layers;
+    };
+    BlendScratch Blend;
+
+    // State of the incremental update performed by Model::ComputeTransforms().
+    struct IncrementalUpdateState
+    {
+        // The animation that the matrices were last computed for by ComputeTransforms(),
+        // -1 for the rest pose, or -2 if all matrices must be recomputed.
+        Int32 AnimationIndex = -2;
+
+        // Root transform that the global matrices were computed with.
+        float4x4 RootTransform;
+
+        // For each node, non-zero if its global matrix changed during the last update.
+        std::vector<Uint8> NodeChanged;
+    };
+    IncrementalUpdateState Incremental;
+
+    // State of the animation level of detail, see Model::ComputeTransforms() with AnimationLOD.
+    struct AnimationLODState
+    {
+        // The animation and the settings that the poses were evaluated for, or -1 if the poses are not valid.
+        Int32  AnimationIndex = -1;
+        Uint32 MaxNodeDepth   = 0;
+        float  UpdatePeriod   = 0;
+
+        // Poses and morph target weights evaluated at the start and the end of the current update period.
+        float                            Time0 = 0;
+        float                            Time1 = 0;
+        std::vector<AnimationTransforms> Pose0;
+        std::vector<AnimationTransforms> Pose1;
+        std::vector<float>               MorphWeights0;
+        std::vector<float>               MorphWeights1;
+    };
+    AnimationLODState AnimLOD;
+
+    // World-space bounds of the nodes that have meshes, see Model::UpdateNodeBounds().
+    // Box centers and half-extents are kept in the structure-of-arrays layout so that
+    // the frustum test can process several boxes at a time.
+    struct NodeBoundsCache
+    {
+        // Indices of the nodes in Model.LinearNodes, for each box.
+        std::vector<Uint32> NodeIds;
+
+        std::vector<float> CenterX;
+        std::vector<float> CenterY;
+        std::vector<float> CenterZ;
+        std::vector<float> ExtentX;
+        std::vector<float> ExtentY;
+        std::vector<float> ExtentZ;
+
+        // Global node matrices that the bounds were computed for. Bounds of the
+        // nodes whose matrices have not changed are not recomputed.
+        std::vector<float4x4> Matrices;
+    };
+    NodeBoundsCache NodeBounds;
+
+    // Hierarchy over the node bounds, see Model::UpdateNodeBVH().
+    // Items are the indices of the boxes in NodeBounds.
+    BoundingVolumeHierarchy NodeBVH;
+};
+
+/// The closest intersection of a ray with the model, see Model::RayCast().
+struct RayHit
+{
+    /// Distance along the ray, in units of the ray direction length.
+    float Distance = 0;
+
+    /// Index of the node in Model.LinearNodes.
+    Uint32 NodeIndex = 0;
+
+    /// Index of the mesh in Model.Meshes and of the primitive in Mesh::Primitives.
+    Uint32 MeshIndex      = 0;
+    Uint32 PrimitiveIndex = 0;
+
+    /// Index of the triangle in the primitive.
+    Uint32 TriangleIndex = 0;
+
+    /// Index of the node instance, or 0 if the node is not instanced.
+    Uint32 InstanceIndex = 0;
+
+    /// Barycentric coordinates of the hit point relative to the second
+    /// and the third vertex of the triangle.
+    float2 Barycentrics;
+};
+
+/// Primitive that passed the visibility test, see Model::CullPrimitives().
+struct VisiblePrimitive
+{
+    /// Index of the node in Model.LinearNodes.
+    Uint32 NodeIndex = 0;
+
+    /// Index of the primitive in the node's mesh.
+    Uint32 PrimitiveIndex = 0;
+};
+
+/// Primitive with its sort key, see Model::SortPrimitives().
+struct SortedPrimitive
+{
+    /// Material sort key combined with the view depth of the primitive.
+    Uint64 SortKey = 0;
+
+    /// Index of the node in Model.LinearNodes.
+    Uint32 NodeIndex = 0;
+
+    /// Index of the primitive in the node's mesh.
+    Uint32 PrimitiveIndex = 0;
+};
+
+/// Animation state of a single model instance, see Model::ComputeTransformsBatch().
+struct ModelAnimationState
+{
+    /// Root transform of the instance.
+    float4x4 RootTransform = float4x4::Identity();
+
+    /// Index of the animation to apply, or -1 if the instance is not animated.
+    Int32 AnimationIndex = -1;
+
+    /// Animation time.
+    float Time = 0;
+};
+
+/// Animation level of detail, see Model::ComputeTransforms().
+///
+/// The application typically selects the level from the screen size of the instance, so that
+/// the animation of distant instances costs a fraction of the full-detail update.
+struct AnimationLOD
+{
+    /// Animation time between two evaluations of the animation channels, in seconds.
+    ///
+    /// The animation is evaluated at the start and the end of every period, and the poses
+    /// in between are interpolated. Zero evaluates the animation at every update.
+    float UpdatePeriod = 0;
+
+    /// The maximum depth in the node hierarchy of the nodes whose channels are evaluated,
+    /// where root nodes have zero depth. Deeper nodes, typically fingers and other leaf joints,
+    /// keep the rest pose.
+    Uint32 MaxNodeDepth = ~0u;
+
+    /// Whether to update the joint matrices of the skins. The matrices of instances that
+    /// are too small on screen for the skinning to be noticeable may be left as they are.
+    /// Matrices that have never been computed are always computed.
+    bool UpdateJointMatrices = true;
+};
+
+/// Animation layer blend mode, see AnimationLayer.
+enum ANIMATION_BLEND_MODE : Uint8
+{
+    /// The layer pose is mixed with the poses of the other blended layers,
+    /// proportionally to the layer weights.
+    ANIMATION_BLEND_MODE_BLEND = 0,
+
+    /// The difference between the layer pose and its reference pose (the first frame
+    /// of the animation) is scaled by the layer weight and applied on top of the blended
+    /// pose. Additive layers are applied in order after all blended layers.
+    ANIMATION_BLEND_MODE_ADDITIVE
+};
+
+/// Weighted animation clip, see Model::ComputeBlendedTransforms().
+struct AnimationLayer
+{
+    /// Index of the animation in Model.Animations.
+    Uint32 AnimationIndex = 0;
+
+    /// Animation time.
+    float Time = 0;
+
+    /// Layer weight. Weights of the blended layers do not need to sum up to one.
+    float Weight = 1;
+
+    /// Blend mode.
+    ANIMATION_BLEND_MODE BlendMode = ANIMATION_BLEND_MODE_BLEND;
 };
 
 struct Model
@@ -591,8 +1473,40 @@ struct Model
     std::vector<Animation>   Animations;
     std::vector<std::string> Extensions;
 
+    /// Names of the material variants defined by the KHR_materials_variants extension, see SetMaterialVariant().
+    std::vector<std::string> MaterialVariants;
+
     std::vector<RefCntAutoPtr<ISampler>> TextureSamplers;
 
+    /// Meshlets of all primitives, see ModelCreateInfo::GenerateMeshlets.
+    std::vector<Meshlet> Meshlets;
+
+    /// Local matrices of the mesh instances defined by the EXT_mesh_gpu_instancing extension.
+
+    /// Instances of a node occupy the range [Node::FirstInstance, Node::FirstInstance + Node::NumInstances).
+    /// The world matrix of an instance is InstanceMatrices[i] * NodeGlobalMatrix, so the matrices
+    /// never need to be recomputed, and all instances of a primitive can be rendered by a single
+    /// instanced draw call that uses the instance buffer (see GetInstanceBuffer()).
+    std::vector<float4x4> InstanceMatrices;
+
+    /// Morph target deltas of all meshes, see Mesh::MorphTargets.
+    ///
+    /// \remarks   Deltas are stored in a structured buffer (see GetMorphTargetBuffer()), and
+    ///            ComputeSkinning applies the targets whose weights are not zero.
+    std::vector<MorphTargetDelta> MorphTargetDeltas;
+
+    /// Default morph target weights of all nodes, see Node::MorphWeightsOffset.
+    /// The weights are defined by the node or, if the node does not define them, by its mesh.
+    std::vector<float> DefaultMorphWeights;
+
+    /// Sources of the triangles of the flattened primitives sorted by the first index,
+    /// see ModelCreateInfo::FlattenStaticNodes.
+    std::vector<FlattenedPrimitiveRange> FlattenedRanges;
+
+    /// CPU copies of the mesh triangles organized in bounding volume hierarchies,
+    /// one per element of Meshes. Empty unless ModelCreateInfo::BuildCPUBVH is set.
+    std::vector<MeshBVH> MeshBVHs;
+
     // The number of nodes that have skin.
     int SkinTransformsCount = 0;
 
@@ -606,13 +1520,128 @@ struct Model
 
     ~Model();
 
+    /// Bakes the model into CI.BakedFileName without creating any GPU resources.
+
+    /// \remarks   The model is parsed, its geometry is converted and its textures are decoded and
+    ///            compressed (see ModelCreateInfo::TextureCompressMode) as when it is loaded, and
+    ///            the result is written to the baked model file. No render device is required, which
+    ///            allows baking models in offline tools. The thread pool of CI, if any, is used to decode
+    ///            the images in parallel. The resource manager can't be used, and textures found in
+    ///            the texture cache are not stored in the file.
+    ///
+    ///            The method throws an exception if the model can't be loaded or the file can't be written.
+    static void Bake(const ModelCreateInfo& CI);
+
     void PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx);
 
+    /// Initializes GPU resources within the given upload budget.
+
+    /// \param [in] pDevice       - Render device.
+    /// \param [in] pCtx          - Device context. This may be a transfer queue context, see remarks.
+    /// \param [in] MaxUploadSize - The maximum number of bytes to upload by this call.
+    ///                             At least one resource is always initialized
+    ///                             to guarantee forward progress.
+    /// \param [in] pFence        - Optional fence that pCtx signals with FenceValue once the uploads
+    ///                             recorded by this call have completed. The context is flushed.
+    /// \param [in] FenceValue    - The value to signal the fence with.
+    /// \return     The number of resources that still need to be initialized.
+    ///
+    /// \remarks    The method is intended to spread resource initialization over
+    ///             multiple frames. It should be called until it returns zero,
+    ///             at which point IsGPUDataInitialized() starts returning true.
+    ///
+    ///             When pCtx is the context of a transfer (copy) queue, uploads do not compete with
+    ///             rendering on the graphics queue. The model must have been created with
+    ///             ModelCreateInfo::ImmediateContextMask that includes the transfer context. Uploaded
+    ///             resources are left in RESOURCE_STATE_COMMON, which releases them to other queues,
+    ///             and the graphics context must wait for pFence (see IDeviceContext::DeviceWaitForFence)
+    ///             before rendering the model. Textures whose mip levels are generated on the GPU can't
+    ///             be processed by a transfer queue: they are counted in the return value and are
+    ///             initialized by the next call with a graphics context.
+    Uint32 PrepareGPUResources(IRenderDevice*  pDevice,
+                               IDeviceContext* pCtx,
+                               Uint64          MaxUploadSize,
+                               IFence*         pFence     = nullptr,
+                               Uint64          FenceValue = 0);
+
     bool IsGPUDataInitialized() const
     {
         return GPUDataInitialized.load();
     }
 
+    /// Returns the size, in bytes, of the CPU-side texture and buffer data held by the model:
+    /// the data that waits to be uploaded by PrepareGPUResources() and the full-resolution data
+    /// of the streamed textures, see StreamTextures().
+    ///
+    /// \remarks   The data is released as soon as it has been uploaded to the GPU.
+    Uint64 GetCPUDataSize() const;
+
+    /// Returns the CPU and GPU memory used by the model, broken down by category.
+
+    /// \remarks   The method may be called at any time after the model has been loaded, e.g. by a streaming
+    ///            system that keeps the memory of the loaded models within a budget. It does not
+    ///            account for the data that is only held while the model is being loaded.
+    ModelMemoryStats GetMemoryStats() const;
+
+    /// Moves buffer and texture atlas allocations of the model to reduce fragmentation
+    /// of the resource manager.
+
+    /// \param [in] pDevice     - Render device.
+    /// \param [in] pCtx        - Device context to record copy commands in.
+    /// \param [in] MaxCopySize - The maximum number of bytes to copy by this call.
+    /// \return     The number of bytes copied. Zero indicates that no allocation could be moved.
+    ///
+    /// \remarks    The method is intended to be called every frame for the models that share
+    ///             a resource manager, with the per-frame copy budget split between them.
+    ///             For every allocation, new space is allocated from the same buffer suballocator
+    ///             or texture atlas. The allocation is moved only if the new space is located
+    ///             closer to the beginning of the buffer or in a lower atlas slice; the data is
+    ///             copied on the GPU and the old space is released. Texture atlas allocations
+    ///             are only moved between slices since source and destination regions of a copy
+    ///             can't be located in the same subresource. Allocations that are shared with other
+    ///             models or have not been initialized yet are not moved.
+    ///
+    ///             When an allocation is moved, the model's relocation version is incremented and
+    ///             material texture addressing attributes are updated. Renderers that cache offsets
+    ///             returned by GetBaseVertex(), GetFirstIndexLocation() or material attributes should
+    ///             refresh them when GetRelocationVersion() changes. Buffer and texture objects themselves
+    ///             are not changed.
+    Uint64 Defragment(IRenderDevice* pDevice, IDeviceContext* pCtx, Uint64 MaxCopySize);
+
+    /// Uploads full-resolution mip levels of the textures that were loaded with only the mip tail
+    /// resident, see ModelCreateInfo::NumStreamedTextureMips.
+
+    /// \param [in] pDevice       - Render device.
+    /// \param [in] pCtx          - Device context.
+    /// \param [in] MaxUploadSize - The maximum number of bytes to upload by this call.
+    ///                             At least one texture is always streamed in.
+    /// \param [in] pTextureIds   - Optional array of texture indices to stream in, e.g. the textures
+    ///                             requested by the screen-space feedback. If null, textures are
+    ///                             streamed in the order of their indices.
+    /// \param [in] NumTextureIds - The number of elements in pTextureIds.
+    /// \return     The number of textures that are still not fully resident.
+    ///
+    /// \remarks    When a texture is streamed in, it is moved to a new atlas allocation and
+    ///             material texture addressing attributes are updated. The relocation version
+    ///             is incremented, see GetRelocationVersion().
+    Uint32 StreamTextures(IRenderDevice* pDevice,
+                          IDeviceContext* pCtx,
+                          Uint64          MaxUploadSize,
+                          const Uint32*   pTextureIds   = nullptr,
+                          Uint32          NumTextureIds = 0);
+
+    /// Returns true if all mip levels of the texture are resident.
+    bool IsTextureFullyResident(Uint32 Index) const
+    {
+        return Index >= StreamedTextures.size() || !StreamedTextures[Index].pInitData;
+    }
+
+    /// Returns the version that is incremented every time Defragment() or StreamTextures() move model allocations.
+    Uint32 GetRelocationVersion() const
+    {
+        return RelocationVersion;
+    }
+
     IBuffer* GetVertexBuffer(Uint32 Index, IRenderDevice* pDevice = nullptr, IDeviceContext* pCtx = nullptr) const
     {
         VERIFY_EXPR(size_t{Index} + 1 < Buffers.size());
@@ -627,6 +1656,10 @@ struct Model
 
     ITexture* GetTexture(Uint32 Index, IRenderDevice* pDevice = nullptr, IDeviceContext* pCtx = nullptr) const
     {
+        // When the model is loaded asynchronously, textures may not be available yet
+        if (Index >= Textures.size())
+            return nullptr;
+
         auto& TexInfo = Textures[Index];
 
         if (TexInfo.pTexture)
@@ -667,6 +1700,14 @@ struct Model
             0;
     }
 
+    /// Returns the type of the indices in the index buffer.
+    VALUE_TYPE GetIndexType() const
+    {
+        VERIFY_EXPR(!Buffers.empty());
+        VERIFY_EXPR(Buffers.back().ElementStride == 2 || Buffers.back().ElementStride == 4);
+        return Buffers.back().ElementStride == 2 ? VT_UINT16 : VT_UINT32;
+    }
+
     struct ImageData
     {
         int Width         = 0;
@@ -716,13 +1757,189 @@ struct Model
 
     bool CompatibleWithTransforms(const ModelTransforms& Transforms) const;
 
+    /// Computes node transforms.
+
+    /// \param [in, out] Transforms     - Transforms to compute.
+    /// \param [in]      RootTransform  - Root transform.
+    /// \param [in]      AnimationIndex - Index of the animation to apply, or -1 to use the rest pose.
+    /// \param [in]      Time           - Animation time.
+    ///
+    /// \remarks   When the transforms were previously computed with the same animation index,
+    ///            the update is incremental: only the local matrices of the animated nodes are
+    ///            recomputed, global matrices are only recomputed for the subtrees whose local
+    ///            or parent matrices changed, and joint matrices are only rebuilt for the skins
+    ///            whose joints changed. Transforms.Incremental.NodeChanged identifies the nodes
+    ///            whose global matrices changed.
+    ///
+    ///            Set Transforms.Incremental.AnimationIndex to -2 to force a full update, e.g.
+    ///            after the node properties have been modified.
     void ComputeTransforms(ModelTransforms& Transforms,
                            const float4x4&  RootTransform  = float4x4::Identity(),
                            Int32            AnimationIndex = -1,
                            float            Time           = 0) const;
 
+    /// Computes node transforms with the animation level of detail.
+
+    /// \param [in, out] Transforms     - Transforms to compute.
+    /// \param [in]      RootTransform  - Root transform.
+    /// \param [in]      AnimationIndex - Index of the animation to apply, or -1 to use the rest pose.
+    /// \param [in]      Time           - Animation time.
+    /// \param [in]      LOD            - Animation level of detail.
+    ///
+    /// \remarks   The poses evaluated at the ends of the current update period are kept in
+    ///            Transforms.AnimLOD, so between the evaluations only the pose interpolation and
+    ///            the node matrices are computed. The poses are re-evaluated when the time leaves
+    ///            the period (e.g. when the animation loops) or when the animation, LOD.UpdatePeriod
+    ///            or LOD.MaxNodeDepth change.
+    void ComputeTransforms(ModelTransforms&    Transforms,
+                           const float4x4&     RootTransform,
+                           Int32               AnimationIndex,
+                           float               Time,
+                           const AnimationLOD& LOD) const;
+
+    /// Computes transforms for multiple instances of the model.
+
+    /// \param [out] pTransforms         - Array of NumInstances transforms to compute.
+    /// \param [in]  pStates             - Array of NumInstances animation states.
+    /// \param [in]  NumInstances        - The number of instances.
+    /// \param [in]  pThreadPool         - Optional thread pool to split the batch across.
+    /// \param [in]  MinInstancesPerTask - The minimum number of instances processed by a single thread pool task.
+    ///
+    /// \remarks   The result is identical to calling ComputeTransforms() for every instance.
+    ///            Instances that play the same animation are evaluated together, so that
+    ///            animation channel and sampler data is traversed once for all of them.
+    ///
+    ///            When pThreadPool is not null, the method blocks until all tasks are complete.
+    void ComputeTransformsBatch(ModelTransforms*           pTransforms,
+                                const ModelAnimationState* pStates,
+                                Uint32                     NumInstances,
+                                IThreadPool*               pThreadPool         = nullptr,
+                                Uint32                     MinInstancesPerTask = 16) const;
+
+    /// Resamples the animations at a fixed rate and stores them in the compact quantized form.
+
+    /// \param [in] SampleRate       - The number of frames per second.
+    /// \param [in] ReleaseKeyFrames - Whether to release the original sampler key frames.
+    ///
+    /// \remarks   Baked animations are evaluated by directly indexing the two frames around
+    ///            the requested time, so no key frame search is needed and all tracks are read
+    ///            with a single sequential pass. Rotations are interpolated with normalized
+    ///            linear interpolation between the frames.
+    ///
+    ///            Resampling at a rate lower than that of the source key frames loses detail.
+    ///            Cubic spline samplers are evaluated with the spline at every frame and are
+    ///            linearly interpolated between frames.
+    void BakeAnimations(float SampleRate, bool ReleaseKeyFrames = true);
+
+    /// Computes transforms by blending multiple animation clips.
+
+    /// \param [in, out] Transforms    - Transforms to compute.
+    /// \param [in]      pLayers       - Array of NumLayers animation layers.
+    /// \param [in]      NumLayers     - The number of layers.
+    /// \param [in]      RootTransform - Root transform.
+    ///
+    /// \remarks   Translations and scales of the blended layers are averaged, and rotations are
+    ///            blended with normalized linear interpolation. If there are no blended layers with
+    ///            a positive weight, the rest pose of the nodes is used as the base pose.
+    ///
+    ///            All layers are evaluated into the scratch data kept in Transforms.Blend, so once
+    ///            the scratch has been sized for the model and the number of layers, the method
+    ///            does not allocate memory.
+    void ComputeBlendedTransforms(ModelTransforms&      Transforms,
+                                  const AnimationLayer* pLayers,
+                                  Uint32                NumLayers,
+                                  const float4x4&       RootTransform = float4x4::Identity()) const;
+
     BoundBox ComputeBoundingBox(const ModelTransforms& Transforms) const;
 
+    /// Updates world-space bounds of the nodes in Transforms.NodeBounds.
+
+    /// \param [in, out] Transforms - Transforms computed by ComputeTransforms() or ComputeTransformsBatch().
+    ///
+    /// \remarks   Bounds are only recomputed for the nodes whose global matrices have changed
+    ///            since the last update, and for the skinned nodes.
+    ///
+    ///            Bounds of a skinned node are the union of the mesh bind-pose box transformed
+    ///            by every joint. Since skinned vertices are convex combinations of the vertices
+    ///            transformed by individual joints, the result is conservative for any pose.
+    ///            If Transforms.Skins is empty (no animation is applied), the static mesh box is used.
+    void UpdateNodeBounds(ModelTransforms& Transforms) const;
+
+    /// Returns the world-space bounds of the node computed by UpdateNodeBounds(),
+    /// or an invalid box if the node has no mesh.
+    BoundBox GetNodeBounds(const ModelTransforms& Transforms, Uint32 NodeIndex) const;
+
+    /// Builds or refits the hierarchy over the node bounds in Transforms.NodeBVH.
+
+    /// \param [in, out] Transforms - Transforms with the bounds updated by UpdateNodeBounds().
+    /// \param [in]      Rebuild    - Whether to rebuild the hierarchy even if it can be refit.
+    ///
+    /// \remarks   The hierarchy is built when it is empty or the set of the nodes has changed,
+    ///            and is refit to the current bounds otherwise. Refitting is cheap, but the quality
+    ///            of the hierarchy degrades when the nodes move far from the positions it was built
+    ///            for, in which case the application may request a rebuild.
+    void UpdateNodeBVH(ModelTransforms& Transforms, bool Rebuild = false) const;
+
+    /// Finds the closest intersection of a ray with the model triangles.
+
+    /// \param [in]  Transforms  - Model transforms. If the node hierarchy was updated by UpdateNodeBVH(),
+    ///                            it is used to find the nodes hit by the ray. Otherwise, all nodes are tested.
+    /// \param [in]  Origin      - World-space ray origin.
+    /// \param [in]  Direction   - World-space ray direction. Need not be normalized.
+    /// \param [in]  MaxDistance - The maximum distance along the ray, in units of the direction length.
+    /// \param [out] Hit         - The closest hit.
+    ///
+    /// \return    true if a triangle was hit, and false otherwise.
+    ///
+    /// \remarks   Requires the mesh hierarchies, see ModelCreateInfo::BuildCPUBVH. Both faces of the
+    ///            triangles are hit. Skinned nodes are not tested, and morph targets are ignored.
+    ///            Hits on flattened primitives are reported for the source node, mesh, primitive
+    ///            and triangle (see ModelCreateInfo::FlattenStaticNodes).
+    bool RayCast(const ModelTransforms& Transforms,
+                 const float3&          Origin,
+                 const float3&          Direction,
+                 float                  MaxDistance,
+                 RayHit&                Hit) const;
+
+    /// Tests the node bounds against the view frustum and collects the visible primitives.
+
+    /// \param [in]  Transforms        - Transforms with the bounds updated by UpdateNodeBounds().
+    /// \param [in]  Frustum           - View frustum, for example extracted from the view-projection
+    ///                                  matrix by ExtractViewFrustumPlanesFromMatrix(). Plane normals
+    ///                                  must point inside the frustum; they need not be normalized.
+    /// \param [out] VisiblePrimitives - Visible primitives in the order of the nodes.
+    ///                                  The vector is cleared before the test.
+    ///
+    /// \remarks   Nodes are tested four at a time. Primitives of a visible non-skinned node
+    ///            that has more than one primitive are additionally tested individually.
+    ///
+    /// \return    The number of visible nodes.
+    Uint32 CullPrimitives(const ModelTransforms&         Transforms,
+                          const ViewFrustum&             Frustum,
+                          std::vector<VisiblePrimitive>& VisiblePrimitives) const;
+
+    /// Orders primitives by their material sort keys and view depth.
+
+    /// \param [in]  Transforms       - Model transforms. If node bounds were updated by UpdateNodeBounds(),
+    ///                                 they are used to compute the depth, otherwise the mesh bounding
+    ///                                 box is transformed by the node global matrix.
+    /// \param [in]  CameraPos        - World-space camera position.
+    /// \param [in]  pPrimitives      - Primitives to sort, e.g. the output of CullPrimitives().
+    ///                                 If null, all primitives of the model are sorted.
+    /// \param [in]  NumPrimitives    - The number of elements in pPrimitives.
+    /// \param [out] SortedPrimitives - Sorted primitives. The vector is cleared first.
+    ///
+    /// \remarks   Primitives are grouped by alpha mode, then by pipeline variant and texture set
+    ///            (see Material::SortKey). Within a group, opaque and masked primitives are sorted
+    ///            front-to-back to reduce overdraw, while blended primitives are sorted back-to-front
+    ///            for correct blending. The depth is the distance from the camera to the center of the
+    ///            primitive's world-space bounding box.
+    void SortPrimitives(const ModelTransforms&        Transforms,
+                        const float3&                 CameraPos,
+                        const VisiblePrimitive*       pPrimitives,
+                        Uint32                        NumPrimitives,
+                        std::vector<SortedPrimitive>& SortedPrimitives) const;
+
     size_t GetTextureCount() const
     {
         return Textures.size();
@@ -733,24 +1950,201 @@ struct Model
         return !Buffers.empty() ? Buffers.size() - 1 : 0;
     }
 
+    /// Returns the structured buffer that contains Meshlets, or null if meshlets were not generated.
+    IBuffer* GetMeshletBuffer() const
+    {
+        return pMeshletBuffer;
+    }
+
+    /// Returns the Uint32 buffer that contains meshlet vertex indices and packed triangles.
+    IBuffer* GetMeshletDataBuffer() const
+    {
+        return pMeshletDataBuffer;
+    }
+
+    /// Returns the buffer that contains InstanceMatrices, or null if the model has no instanced nodes.
+
+    /// The buffer can be bound as a per-instance vertex buffer or as a structured buffer.
+    /// Use Node::FirstInstance as the first instance location of the draw call.
+    IBuffer* GetInstanceBuffer() const
+    {
+        return pInstanceBuffer;
+    }
+
+    /// Returns the structured buffer that contains MorphTargetDeltas, or null if the model has no morph targets.
+    IBuffer* GetMorphTargetBuffer() const
+    {
+        return pMorphTargetBuffer;
+    }
+
     void InitMaterialTextureAddressingAttribs(Material& Mat, Uint32 TextureIndex);
 
+    /// Recomputes Material::SortKey for all materials.
+
+    /// \remarks   The keys are updated automatically when textures are committed. The method
+    ///            only needs to be called if materials are modified after the model is loaded.
+    void UpdateMaterialSortKeys();
+
+    /// Computes the hash of an object name for the Find*() methods.
+
+    /// \remarks   The hash of a name that is looked up frequently may be computed once,
+    ///            e.g. at compile time, and then passed to FindNode(), FindMesh(),
+    ///            FindAnimation() or FindMaterial().
+    static constexpr Uint64 ComputeNameHash(const char* Name)
+    {
+        // FNV-1a
+        Uint64 Hash = 14695981039346656037ull;
+        for (; Name != nullptr && *Name != '\0'; ++Name)
+            Hash = (Hash ^ static_cast<Uint8>(*Name)) * 1099511628211ull;
+        return Hash;
+    }
+
+    /// Returns the index of the node with the given name in LinearNodes, or -1 if there is no such node.
+    /// If several nodes have the same name, the one with the smallest index is returned.
+    int FindNode(const char* Name) const
+    {
+        return FindNode(Name, ComputeNameHash(Name));
+    }
+
+    /// Same as FindNode(const char*), but uses the precomputed hash of the name, see ComputeNameHash().
+    int FindNode(const char* Name, Uint64 NameHash) const;
+
+    /// Returns the index of the mesh with the given name in Meshes, or -1 if there is no such mesh.
+    int FindMesh(const char* Name) const
+    {
+        return FindMesh(Name, ComputeNameHash(Name));
+    }
+
+    /// Same as FindMesh(const char*), but uses the precomputed hash of the name, see ComputeNameHash().
+    int FindMesh(const char* Name, Uint64 NameHash) const;
+
+    /// Returns the index of the animation with the given name in Animations, or -1 if there is no such animation.
+    int FindAnimation(const char* Name) const
+    {
+        return FindAnimation(Name, ComputeNameHash(Name));
+    }
+
+    /// Same as FindAnimation(const char*), but uses the precomputed hash of the name, see ComputeNameHash().
+    int FindAnimation(const char* Name, Uint64 NameHash) const;
+
+    /// Returns the index of the material with the given name in Materials, or -1 if there is no such material.
+    int FindMaterial(const char* Name) const
+    {
+        return FindMaterial(Name, ComputeNameHash(Name));
+    }
+
+    /// Same as FindMaterial(const char*), but uses the precomputed hash of the name, see ComputeNameHash().
+    int FindMaterial(const char* Name, Uint64 NameHash) const;
+
+    /// Returns the index of the material variant with the given name in MaterialVariants, or -1 if there is no such variant.
+    int FindMaterialVariant(const char* Name) const;
+
+    /// Selects the material variant, see MaterialVariants.
+
+    /// \param [in] Variant - Index of the variant in MaterialVariants, or -1 to restore the default materials.
+    ///
+    /// \remarks   The materials and textures of all variants are loaded with the model, so the method
+    ///            only updates Primitive::MaterialId of the primitives that have variant mappings.
+    ///            Draw lists (see DrawListBuilder) that contain the model must be committed again.
+    ///            Primitives of the flattened mesh (see ModelCreateInfo::FlattenStaticNodes) have
+    ///            no variant mappings.
+    void SetMaterialVariant(int Variant);
+
+    /// Returns the index of the selected material variant, or -1 if the default materials are used.
+    int GetMaterialVariant() const
+    {
+        return m_MaterialVariant;
+    }
+
+    /// Returns the source of the flattened primitive index, or null if the index does not belong
+    /// to a flattened primitive, see ModelCreateInfo::FlattenStaticNodes.
+
+    /// \remarks   Triangle t of a flattened primitive P starts at index P.FirstIndex + t * 3.
+    const FlattenedPrimitiveRange* FindFlattenedRange(Uint32 Index) const;
+
+    /// Rebuilds the name indices used by the Find*() methods.
+
+    /// \remarks   The indices are built when the model is loaded. The method only needs
+    ///            to be called if objects are added or renamed after that.
+    void UpdateNameIndices();
+
 private:
     friend ModelBuilder;
+    friend class AsyncModelLoader;
+    friend class ModelBatchLoader;
 
     void LoadFromFile(IRenderDevice*         pDevice,
                       IDeviceContext*        pContext,
                       const ModelCreateInfo& CI);
 
-    void LoadTextures(IRenderDevice*         pDevice,
-                      const tinygltf::Model& gltf_model,
-                      const std::string&     BaseDir,
-                      TextureCacheType*      pTextureCache,
-                      ResourceManager*       pResourceMgr);
-
-    void LoadTextureSamplers(IRenderDevice* pDevice, const tinygltf::Model& gltf_model);
-    void LoadMaterials(const tinygltf::Model& gltf_model, const ModelCreateInfo::MaterialLoadCallbackType& MaterialLoadCallback);
+    // Model loading is split into the following steps that are executed in order:
+    // - BeginLoading      - parses the GLTF file.
+    // - LoadGeometry      - loads materials, samplers, nodes and meshes.
+    // - PrepareTextures   - decodes images and prepares texture initialization data.
+    // - CommitTextures    - creates textures that have been prepared. May be called
+    //                       repeatedly while PrepareTextures is running in another thread.
+    // - EndLoading        - releases the intermediate loading state.
+    //
+    // When the model is baked, WriteBakedModel is called after PrepareTextures.
+    void   BeginLoading(const ModelCreateInfo& CI, bool DeferImageDecoding);
+    void   LoadGeometry(IRenderDevice* pDevice, const ModelCreateInfo& CI);
+    void   PrepareTextures(IThreadPool* pThreadPool);
+    void   PrepareTexture(Uint32 TextureIndex, bool PrepareInitData);
+    Uint32 GetNumPreparedTextures() const;
+    void   CommitTextures(IRenderDevice* pDevice, Uint32 NumTextures);
+    void   EndLoading();
+
+    // Returns the cache ids of the images whose decoding has been deferred, for every image
+    // of the GLTF model. Ids of the other images and of the images without a URI are empty.
+    // Must be called between LoadGeometry and PrepareTextures.
+    void GetPendingImageCacheIds(std::vector<std::string>& CacheIds) const;
+    // Releases the encoded data of the image so that PrepareTextures does not decode it.
+    // The textures that use the image must then be found in the texture cache or the resource
+    // manager by CommitTextures.
+    void ReleasePendingImage(Uint32 ImageIndex);
+
+    // Baked model support, see ModelCreateInfo::BakedFileName.
+    // LoadBakedGeometry and LoadBakedTextures replace LoadGeometry and PrepareTextures
+    // when the model is loaded from the baked file.
+    void LoadBakedGeometry(IRenderDevice* pDevice, const ModelCreateInfo& CI);
+    void LoadBakedTextures();
+    void WriteBakedModel() const;
+
+    // Initializes GPU resources that have not been initialized yet, uploading at most
+    // MaxUploadSize bytes. Returns the number of resources that still need to be initialized.
+    Uint32 InitializePendingGPUData(IRenderDevice* pDevice, IDeviceContext* pCtx, Uint64 MaxUploadSize);
+
+    // If pAllocation is not null, the texture uses this atlas allocation, whose user data must be the init data.
+    Uint32 AddTexture(IRenderDevice*              pDevice,
+                      TextureCacheType*           pTextureCache,
+                      ResourceManager*            pResourceMgr,
+                      const ImageData&            Image,
+                      int                         GltfSamplerId,
+                      const std::string&          CacheId,
+                      IObject*                    pPreparedInitData,
+                      ITextureAtlasSuballocation* pAllocation);
+
+    // Samplers are shared with other models through the resource manager or the texture cache, if either is used.
+    void LoadTextureSamplers(IRenderDevice* pDevice, TextureCacheType* pTextureCache, ResourceManager* pResourceMgr, const tinygltf::Model& gltf_model);
+    // If pUsedMaterials is not null, only the materials it marks are loaded.
+    void LoadMaterials(const tinygltf::Model& gltf_model, const ModelCreateInfo::MaterialLoadCallbackType& MaterialLoadCallback, const std::vector<bool>* pUsedMaterials);
     void UpdateAnimation(Uint32 index, float time, ModelTransforms& Transforms) const;
+    void UpdateAnimation(Uint32 index, ModelTransforms* const* ppTransforms, const float* pTimes, Uint32 NumInstances) const;
+
+    void ComputeTransformsRange(ModelTransforms* pTransforms, const ModelAnimationState* pStates, Uint32 NumInstances) const;
+    // If UpdateJoints is false, only the joint matrices that have never been computed are updated.
+    void ComputeGlobalTransforms(ModelTransforms& Transforms, const float4x4& RootTransform, bool UpdateJoints = true) const;
+
+    // Incrementally updates the transforms computed by the previous call of ComputeTransforms().
+    // Returns false if a full update is required.
+    bool UpdateTransformsIncremental(ModelTransforms& Transforms, const float4x4& RootTransform, Int32 AnimationIndex, float Time) const;
+
+    // Updates joint matrices of the skins. If pNodeChanged is not null, only the skins whose
+    // node or joint global matrices changed are updated.
+    void UpdateJointMatrices(ModelTransforms& Transforms, const Uint8* pNodeChanged) const;
+
+    // Initializes NodeTransformOrder from the node hierarchy.
+    void InitNodeTransformOrder();
 
     // Returns the alpha cutoff value for the given texture.
     // TextureIdx is the texture index in the GLTF file and also the Textures array.
@@ -775,9 +2169,67 @@ private:
         return nullptr;
     }
 
+    // Flattened node hierarchy in the order in which global transforms are computed.
+    // Parents always precede their children.
+    struct NodeTransformOrderEntry
+    {
+        // Index in LinearNodes array.
+        Int32 NodeIndex;
+
+        // Index of the parent node in LinearNodes array, or -1 for root nodes.
+        Int32 ParentIndex;
+    };
+    std::vector<NodeTransformOrderEntry> NodeTransformOrder;
+
+    // Depth of each node in the hierarchy, saturated at 255. Indexed like LinearNodes.
+    std::vector<Uint8> NodeDepths;
+
     std::atomic_bool GPUDataInitialized{false};
 
+    Uint32 RelocationVersion = 0;
+
+    // Full-resolution data of the textures that only have the mip tail resident,
+    // see ModelCreateInfo::NumStreamedTextureMips. Indexed like Textures.
+    struct StreamedTextureInfo
+    {
+        RefCntAutoPtr<IObject> pInitData;
+
+        Uint32 Width  = 0;
+        Uint32 Height = 0;
+    };
+    std::vector<StreamedTextureInfo> StreamedTextures;
+
+    Uint32 NumStreamedTextureMips = 0;
+
+    TEXTURE_COMPRESS_MODE TextureCompressMode = TEXTURE_COMPRESS_MODE_NONE;
+
+    Uint32 MaxTextureDimension = 0;
+
+    // Allocator for DDS and KTX texture data, see ModelCreateInfo::pAllocator.
+    IMemoryAllocator* m_pAllocator = nullptr;
+
+    // See ModelCreateInfo::ImmediateContextMask.
+    Uint64 m_ImmediateContextMask = 1;
+
+    // The resource manager that the buffer data is uploaded through, see ResourceCacheUseInfo.
+    RefCntAutoPtr<ResourceManager> m_pResourceMgr;
+
+    // Name hashes and object indices sorted by the hash, then by the index, see UpdateNameIndices().
+    using NameIndexType = std::vector<std::pair<Uint64, Uint32>>;
+    NameIndexType m_NodeNameIndex;
+    NameIndexType m_MeshNameIndex;
+    NameIndexType m_AnimationNameIndex;
+    NameIndexType m_MaterialNameIndex;
+
+    // The selected material variant, see SetMaterialVariant().
+    int m_MaterialVariant = -1;
+
+    // Intermediate data used while the model is being loaded.
+    struct LoadingState;
+    std::unique_ptr<LoadingState> m_pLoadingState;
+
     std::unique_ptr<void, STDDeleter<void, IMemoryAllocator>> pAttributesData;
+    size_t                                                    AttributesDataSize = 0;
 
     const VertexAttributeDesc*  VertexAttributes;
     const TextureAttributeDesc* TextureAttributes;
@@ -791,9 +2243,18 @@ private:
         RefCntAutoPtr<IBufferSuballocation> pSuballocation;
 
         Uint32 ElementStride = 0;
+
+        // The number of bytes of the pending data that have been uploaded through
+        // the staging buffer of the resource manager, see ResourceManager::UploadBufferData().
+        Uint64 UploadedSize = 0;
     };
     std::vector<BufferInfo> Buffers;
 
+    RefCntAutoPtr<IBuffer> pMeshletBuffer;
+    RefCntAutoPtr<IBuffer> pMeshletDataBuffer;
+    RefCntAutoPtr<IBuffer> pInstanceBuffer;
+    RefCntAutoPtr<IBuffer> pMorphTargetBuffer;
+
     struct TextureInfo
     {
         RefCntAutoPtr<ITexture>                   pTexture;
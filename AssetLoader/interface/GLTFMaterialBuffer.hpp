@@ -0,0 +1,132 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/RenderDevice.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/DeviceContext.h"
+#include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
+#include "GLTFLoader.hpp"
+#include "GLTFResourceManager.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// Packs material attributes of multiple models into a single structured buffer.
+///
+/// Material::ShaderAttribs of every added model are stored contiguously in a buffer
+/// allocated from the resource manager, so that shaders can fetch material data by index
+/// instead of reading it from a constant buffer that is updated before every draw call.
+/// The index of a primitive's material in the buffer is
+///
+///     MatBuffer.GetFirstMaterialIndex(Model) + Primitive.MaterialId
+///
+/// Indices are stable: they do not change when other models are added or removed, or
+/// when the resource manager grows the buffer. Since the buffer object may be recreated
+/// when it grows, shader resource bindings should be updated when the buffer version
+/// reported by ResourceManager::GetBufferVersion() changes.
+///
+/// Typical usage:
+///
+///     const auto FirstMaterial = MatBuffer.AddModel(Model);
+///     MatBuffer.Commit(pDevice, pContext);
+///     // Bind MatBuffer.GetBuffer(pDevice, pContext) to the shader and pass FirstMaterial
+///     // + Primitive.MaterialId with the per-draw data.
+///
+/// The class is not thread-safe.
+class MaterialBuffer
+{
+public:
+    struct CreateInfo
+    {
+        /// Resource manager to allocate material data from.
+        ResourceManager* pResourceMgr = nullptr;
+
+        /// Index of the resource manager buffer for material data. The buffer must be created
+        /// with the BIND_SHADER_RESOURCE flag in the BUFFER_MODE_STRUCTURED mode with the element
+        /// stride equal to sizeof(Material::ShaderAttribs), and should not be used for other data.
+        Uint32 BufferIndex = 0;
+    };
+
+    explicit MaterialBuffer(const CreateInfo& CI);
+
+    static constexpr Uint32 InvalidIndex = ~0u;
+
+    /// Adds materials of the model to the buffer.
+
+    /// \param [in] GLTFModel - Model to add. The model must be removed with RemoveModel()
+    ///                         before it is destroyed.
+    ///
+    /// \return     The index of the model's first material in the buffer, or InvalidIndex
+    ///             if the space could not be allocated. If the model has already been added,
+    ///             its existing index is returned.
+    ///
+    /// \remarks    Material data is uploaded to the GPU by Commit().
+    Uint32 AddModel(const Model& GLTFModel);
+
+    /// Releases the space occupied by the model's materials.
+    void RemoveModel(const Model& GLTFModel);
+
+    /// Schedules materials of the model to be uploaded again by Commit(),
+    /// e.g. after the application has modified material attributes.
+    void InvalidateModel(const Model& GLTFModel);
+
+    /// Returns the index of the model's first material in the buffer, or InvalidIndex
+    /// if the model has not been added.
+    Uint32 GetFirstMaterialIndex(const Model& GLTFModel) const;
+
+    /// Uploads materials of the models that have been added or invalidated since the last call.
+    void Commit(IRenderDevice* pDevice, IDeviceContext* pContext);
+
+    /// Returns the structured buffer that contains materials of all models.
+    IBuffer* GetBuffer(IRenderDevice* pDevice, IDeviceContext* pContext);
+
+private:
+    RefCntAutoPtr<ResourceManager> m_pResourceMgr;
+    const Uint32                   m_BufferIndex;
+
+    struct ModelEntry
+    {
+        RefCntAutoPtr<IBufferSuballocation> pAllocation;
+
+        Uint32 FirstMaterial = 0;
+        bool   IsDirty       = true;
+    };
+    std::unordered_map<const Model*, ModelEntry> m_Models;
+
+    std::vector<Material::ShaderAttribs> m_UploadData;
+};
+
+} // namespace GLTF
+
+} // namespace Diligent
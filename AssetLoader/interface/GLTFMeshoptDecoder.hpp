@@ -0,0 +1,86 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// Filter applied to the attributes decoded by DecodeMeshoptVertexBuffer(), see EXT_meshopt_compression.
+enum MESHOPT_FILTER : Uint8
+{
+    MESHOPT_FILTER_NONE = 0,
+
+    /// Octahedral encoding of unit vectors, 4 or 8 bytes per element.
+    MESHOPT_FILTER_OCTAHEDRAL,
+
+    /// Quaternions with the largest component dropped, 8 bytes per element.
+    MESHOPT_FILTER_QUATERNION,
+
+    /// Floats with a shared exponent, 4 bytes per component.
+    MESHOPT_FILTER_EXPONENTIAL
+};
+
+/// Decodes a vertex buffer compressed with the meshoptimizer vertex codec (version 0).
+
+/// \param [out] pDst       - Destination buffer, must be at least Count * Stride bytes large.
+/// \param [in]  Count      - The number of vertices.
+/// \param [in]  Stride     - Vertex size in bytes. Must be a multiple of 4 not greater than 256.
+/// \param [in]  pSrc       - Compressed data.
+/// \param [in]  SrcSize    - Compressed data size in bytes.
+/// \return     true if the data was decoded successfully, and false if it is malformed.
+bool DecodeMeshoptVertexBuffer(void* pDst, size_t Count, size_t Stride, const Uint8* pSrc, size_t SrcSize);
+
+/// Decodes a triangle list index buffer compressed with the meshoptimizer index codec (versions 0 and 1).
+
+/// \param [out] pDst       - Destination buffer, must be at least Count * IndexSize bytes large.
+/// \param [in]  Count      - The number of indices, must be a multiple of 3.
+/// \param [in]  IndexSize  - Index size in bytes, 2 or 4.
+/// \param [in]  pSrc       - Compressed data.
+/// \param [in]  SrcSize    - Compressed data size in bytes.
+/// \return     true if the data was decoded successfully, and false if it is malformed.
+bool DecodeMeshoptIndexBuffer(void* pDst, size_t Count, size_t IndexSize, const Uint8* pSrc, size_t SrcSize);
+
+/// Decodes an index sequence compressed with the meshoptimizer index sequence codec.
+
+/// The parameters are the same as for DecodeMeshoptIndexBuffer(), except that Count
+/// does not need to be a multiple of 3.
+bool DecodeMeshoptIndexSequence(void* pDst, size_t Count, size_t IndexSize, const Uint8* pSrc, size_t SrcSize);
+
+/// Applies the filter to the decoded vertex data in place.
+
+/// \return     false if the stride is not compatible with the filter.
+bool ApplyMeshoptFilter(MESHOPT_FILTER Filter, void* pData, size_t Count, size_t Stride);
+
+} // namespace GLTF
+
+} // namespace Diligent
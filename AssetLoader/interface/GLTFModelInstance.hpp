@@ -0,0 +1,119 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "GLTFLoader.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// Lightweight instance of a shared model.
+///
+/// The model holds the data that is shared by all of its instances and is not modified
+/// after loading: vertex and index buffers, textures, materials, nodes, skins and animations.
+/// The instance references the model and only keeps the per-instance state: the root transform,
+/// the animation state, the computed transforms and material overrides. Creating an instance
+/// does not allocate GPU resources, and the transforms are only allocated by the first call
+/// to UpdateTransforms().
+///
+/// Typical usage:
+///
+///     auto pModel = std::make_shared<GLTF::Model>(pDevice, pContext, ModelCI);
+///     std::vector<GLTF::ModelInstance> Instances(NumInstances, GLTF::ModelInstance{pModel});
+///     Instances[0].OverrideMaterial(0).Attribs.BaseColorFactor = float4{1, 0, 0, 1};
+///     ...
+///     DrawList.Reset();
+///     for (auto& Inst : Instances)
+///     {
+///         Inst.SetAnimation(0, Time);
+///         Inst.UpdateTransforms();
+///         DrawList.AddInstance(Inst);
+///     }
+///
+/// The class is not thread-safe, but different instances of the same model may be updated concurrently.
+class ModelInstance
+{
+public:
+    explicit ModelInstance(std::shared_ptr<const Model> pModel);
+
+    const Model& GetModel() const { return *m_pModel; }
+
+    const std::shared_ptr<const Model>& GetModelPtr() const { return m_pModel; }
+
+    void SetRootTransform(const float4x4& RootTransform) { m_AnimationState.RootTransform = RootTransform; }
+
+    /// Sets the animation to apply by the next UpdateTransforms() call.
+
+    /// \param [in] AnimationIndex - Index of the animation in Model.Animations, or -1 for the rest pose.
+    /// \param [in] Time           - Animation time.
+    void SetAnimation(Int32 AnimationIndex, float Time);
+
+    const ModelAnimationState& GetAnimationState() const { return m_AnimationState; }
+
+    /// Computes the transforms for the current root transform and animation state, see Model::ComputeTransforms().
+    void UpdateTransforms();
+
+    const ModelTransforms& GetTransforms() const { return m_Transforms; }
+
+    /// Returns the transforms, e.g. to update the node bounds with Model::UpdateNodeBounds().
+    ModelTransforms& GetTransforms() { return m_Transforms; }
+
+    /// Returns the material of the instance: the override, if the material is overridden,
+    /// or the model material otherwise.
+    const Material& GetMaterial(Uint32 MaterialId) const;
+
+    /// Returns the override of the material that may be modified by the application.
+
+    /// \remarks    The override is initialized with the model material when it is first requested.
+    ///             Texture ids of the override must reference textures of the model.
+    Material& OverrideMaterial(Uint32 MaterialId);
+
+    /// Removes the override of the material, so that the model material is used again.
+    void RemoveMaterialOverride(Uint32 MaterialId);
+
+    bool HasMaterialOverrides() const { return !m_MaterialOverrides.empty(); }
+
+private:
+    std::shared_ptr<const Model> m_pModel;
+
+    ModelAnimationState m_AnimationState;
+    ModelTransforms     m_Transforms;
+
+    // Overridden materials, indexed by the material id in Model.Materials
+    std::unordered_map<Uint32, Material> m_MaterialOverrides;
+};
+
+} // namespace GLTF
+
+} // namespace Diligent
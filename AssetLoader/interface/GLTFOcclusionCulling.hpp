@@ -0,0 +1,155 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/RenderDevice.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/DeviceContext.h"
+#include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
+#include "../../../DiligentCore/Common/interface/BasicMath.hpp"
+#include "GLTFDrawList.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// Culls the draw commands of a draw list on the GPU against the view frustum and a Hi-Z depth pyramid.
+///
+/// At the end of every frame, BuildHiZ() reduces the depth buffer into a pyramid where every texel of
+/// a mip level stores the farthest depth of the texels of the finer level it covers. In the next frame,
+/// Cull() projects the node-space bounding box of every draw command (see DrawListBuilder::DrawBounds)
+/// and rejects it if it is outside of the view frustum, or if the box is behind the depth stored in the
+/// pyramid level where the projected box covers at most 2x2 texels. Visible draw commands are written
+/// to the culled draw arguments buffer, so the draw list is rendered without CPU readbacks.
+///
+/// Occlusion is tested with the view-projection matrix the pyramid was built with, so a box is culled
+/// only if it was hidden in the previous frame. Objects that become disoccluded appear one frame late.
+///
+/// When the device supports indirect draw counter buffers, visible draw commands of every batch are
+/// compacted to the front of the batch range in an unspecified order, and the number of visible commands
+/// is written to the counter buffer. Otherwise, culled commands keep their slots and have zero instances.
+///
+/// The shaders read and write the indirect arguments as byte address buffers, which requires
+/// the Direct3D11, Direct3D12, Vulkan or Metal backend.
+///
+/// Typical usage:
+///
+///     DrawList.Commit(pDevice, pContext);
+///     Culling.Cull(pContext, DrawList, ViewProj);
+///     for (const auto& Batch : DrawList.GetBatches())
+///         pContext->DrawIndexedIndirect(Culling.GetDrawAttribs(Batch));
+///     // ...
+///     Culling.BuildHiZ(pContext, pDepthBuffer->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE), ViewProj);
+class OcclusionCulling
+{
+public:
+    struct CreateInfo
+    {
+        IRenderDevice* pDevice = nullptr;
+
+        /// Whether the depth buffer uses reversed depth, where the far plane is at zero.
+        bool ReverseDepth = false;
+    };
+
+    explicit OcclusionCulling(const CreateInfo& CI);
+
+    /// Builds the Hi-Z pyramid from the depth buffer.
+
+    /// \param [in] pCtx      - Device context.
+    /// \param [in] pDepthSRV - Shader resource view of the depth buffer. The view must have a single
+    ///                         mip level and be readable as Texture2D<float>, e.g. the default view
+    ///                         of a D32_FLOAT texture created with the BIND_SHADER_RESOURCE flag.
+    /// \param [in] ViewProj  - View-projection matrix the depth buffer was rendered with.
+    ///
+    /// \remarks    The pyramid is recreated when the depth buffer size changes.
+    ///             The depth buffer is transitioned to the shader resource state.
+    void BuildHiZ(IDeviceContext* pCtx, ITextureView* pDepthSRV, const float4x4& ViewProj);
+
+    /// Discards the pyramid, e.g. when the camera cuts to another view. Until the pyramid
+    /// is built again, Cull() only performs frustum culling.
+    void InvalidateHiZ() { m_HiZValid = false; }
+
+    /// Culls the draw commands of the committed draw list.
+
+    /// \param [in] pCtx     - Device context.
+    /// \param [in] DrawList - Draw list. DrawListBuilder::Commit() must have been called.
+    /// \param [in] ViewProj - View-projection matrix of the current frame, used for frustum culling.
+    void Cull(IDeviceContext* pCtx, const DrawListBuilder& DrawList, const float4x4& ViewProj);
+
+    /// Returns the draw attributes to render the batch of the draw list with the culled draw commands.
+    DrawIndexedIndirectAttribs GetDrawAttribs(const DrawListBuilder::Batch& B) const;
+
+    /// Returns true if the visible draw commands are compacted and counted, see OcclusionCulling.
+    bool IsCompacting() const { return m_Compact; }
+
+    /// Buffer with the culled DrawListBuilder::DrawIndexedArgs.
+    IBuffer* GetCulledDrawArgsBuffer() const { return m_pCulledArgsBuffer; }
+
+    /// Buffer with the number of visible draw commands of every batch, or null if the commands are not compacted.
+
+    /// The counter of a batch is stored at the index of its first draw command, see GetDrawAttribs().
+    IBuffer* GetDrawCountsBuffer() const { return m_pDrawCountsBuffer; }
+
+    /// Shader resource view of the Hi-Z pyramid with all mip levels.
+    ITextureView* GetHiZSRV() const { return m_pHiZSRV; }
+
+private:
+    void CreateHiZ(Uint32 Width, Uint32 Height);
+
+    RefCntAutoPtr<IRenderDevice> m_pDevice;
+
+    const bool m_ReverseDepth;
+    bool       m_Compact = false;
+
+    RefCntAutoPtr<IPipelineState>         m_pHiZPSO;
+    RefCntAutoPtr<IShaderResourceBinding> m_pHiZSRB;
+    RefCntAutoPtr<IBuffer>                m_pHiZConstants;
+
+    RefCntAutoPtr<IPipelineState>         m_pCullPSO;
+    RefCntAutoPtr<IShaderResourceBinding> m_pCullSRB;
+    RefCntAutoPtr<IBuffer>                m_pCullConstants;
+
+    // Hi-Z pyramid, the views of its individual mip levels and the view of all levels
+    RefCntAutoPtr<ITexture>                  m_pHiZ;
+    std::vector<RefCntAutoPtr<ITextureView>> m_HiZMipSRVs;
+    std::vector<RefCntAutoPtr<ITextureView>> m_HiZMipUAVs;
+    RefCntAutoPtr<ITextureView>              m_pHiZSRV;
+    float4x4                                 m_HiZViewProj;
+    bool                                     m_HiZValid = false;
+
+    RefCntAutoPtr<IBuffer> m_pCulledArgsBuffer;
+    RefCntAutoPtr<IBuffer> m_pDrawCountsBuffer;
+    std::vector<Uint32>    m_ZeroCounts;
+};
+
+} // namespace GLTF
+
+} // namespace Diligent
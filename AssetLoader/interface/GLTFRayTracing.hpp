@@ -0,0 +1,219 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/RenderDevice.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/DeviceContext.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/BottomLevelAS.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/TopLevelAS.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/Fence.h"
+#include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
+#include "GLTFLoader.hpp"
+#include "GLTFSkinning.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// Builds ray tracing acceleration structures for model instances.
+///
+/// Bottom-level acceleration structures (BLASes) are built once per model, one per mesh
+/// with one geometry per indexed primitive, and are shared by all instances of the model.
+/// All BLASes of a model are built in one pass that sub-allocates a single scratch buffer,
+/// which is reused by subsequent builds. When compaction is enabled, compacted sizes are
+/// read back asynchronously, and the BLASes are replaced with compacted copies by a later
+/// call to CompactBLASes() once the GPU has finished the build.
+///
+/// Every instance has its own top-level acceleration structure (TLAS) with one instance per
+/// node with a mesh (or one per GPU instance of the node, see Node::NumInstances). The TLAS
+/// is built from ModelTransforms::NodeGlobalMatrices when the instance is updated for the first
+/// time, and is refit afterwards. It is rebuilt when the BLASes it references are compacted.
+///
+/// Nodes skinned or morphed by ComputeSkinning use per-instance BLASes that are built from the
+/// skinned vertices once and are refit on every update.
+///
+/// The model must store positions as three VT_FLOAT32 components without encoding, and its
+/// vertex and index buffers (or the resource manager buffers) must be created with the
+/// BIND_RAY_TRACING flag. The skinning output buffer must be created with this flag as well.
+///
+/// Typical usage:
+///
+///     Model.ComputeTransforms(Transforms, RootTransform, AnimationIndex, Time);
+///     Skinning.Skin(pContext, Model, Transforms, SkinnedInstance);
+///     RTBuilder.CompactBLASes(pContext);
+///     RTBuilder.UpdateInstance(pContext, Model, Transforms, RTInstance, &Skinning, &SkinnedInstance);
+///     // Bind RTInstance.pTLAS to the ray tracing shaders
+///
+/// The class is not thread-safe.
+class RayTracingBuilder
+{
+public:
+    struct CreateInfo
+    {
+        IRenderDevice* pDevice = nullptr;
+
+        /// Whether to compact the static BLASes, see CompactBLASes().
+        bool CompactBLAS = true;
+    };
+
+    explicit RayTracingBuilder(const CreateInfo& CI);
+    ~RayTracingBuilder();
+
+    /// Acceleration structures of a model instance.
+    struct InstanceData
+    {
+        /// The model that the instance was initialized for.
+        const Model* pModel = nullptr;
+
+        /// Top-level acceleration structure of the instance.
+        RefCntAutoPtr<ITopLevelAS> pTLAS;
+
+        /// BLASes of the skinned nodes, for each node in ComputeSkinning::InstanceData::Nodes.
+        std::vector<RefCntAutoPtr<IBottomLevelAS>> SkinnedBLASes;
+
+        /// Buffer with the TLAS instance data.
+        RefCntAutoPtr<IBuffer> pInstanceBuffer;
+
+        /// Version of the model BLASes that the TLAS was built with.
+        Uint32 BLASVersion = 0;
+    };
+
+    /// Builds the BLASes of the model meshes.
+
+    /// \remarks    The method is called by UpdateInstance() for models that have not been added.
+    ///             Model GPU data must be initialized, otherwise the model is skipped.
+    ///             The model must be removed with RemoveModel() before it is destroyed.
+    void AddModel(IDeviceContext* pCtx, const Model& GLTFModel);
+
+    /// Releases the BLASes of the model.
+    void RemoveModel(const Model& GLTFModel);
+
+    /// Replaces the BLASes whose compacted sizes have been read back with compacted copies.
+
+    /// \remarks    Should be called once per frame before the instances are updated.
+    void CompactBLASes(IDeviceContext* pCtx);
+
+    /// Builds or refits the TLAS of the model instance.
+
+    /// \param [in]      pCtx             - Device context.
+    /// \param [in]      GLTFModel        - The model.
+    /// \param [in]      Transforms       - Model transforms, see Model::ComputeTransforms().
+    /// \param [in, out] Instance         - Instance data.
+    /// \param [in]      pSkinning        - Optional compute skinning that produced pSkinnedInstance.
+    /// \param [in]      pSkinnedInstance - Optional skinned instance data. When provided, skinned nodes use
+    ///                                     per-instance BLASes built from the skinned vertices.
+    ///
+    /// \return     true if the TLAS was built or refit, and false otherwise, e.g. if the model
+    ///             GPU data is not initialized or the model layout is not supported.
+    bool UpdateInstance(IDeviceContext*                      pCtx,
+                        const Model&                         GLTFModel,
+                        const ModelTransforms&               Transforms,
+                        InstanceData&                        Instance,
+                        ComputeSkinning*                     pSkinning        = nullptr,
+                        const ComputeSkinning::InstanceData* pSkinnedInstance = nullptr);
+
+    /// Returns the BLAS of the mesh, or null if the model has not been added or the mesh has no indexed primitives.
+    IBottomLevelAS* GetMeshBLAS(const Model& GLTFModel, Uint32 MeshIndex) const;
+
+    /// Returns true if the model uses the vertex layout supported by the builder.
+    static bool IsModelSupported(const Model& GLTFModel);
+
+private:
+    struct ModelEntry
+    {
+        // BLAS of each mesh in Model.Meshes, null for meshes without indexed primitives
+        std::vector<RefCntAutoPtr<IBottomLevelAS>> MeshBLASes;
+
+        // Incremented when the BLASes are replaced with compacted copies
+        Uint32 Version = 1;
+
+        // Compacted sizes of the BLASes are written to this buffer by the GPU,
+        // and can be read once the fence reaches CompactionFenceValue.
+        RefCntAutoPtr<IBuffer> pCompactedSizes;
+        Uint64                 CompactionFenceValue = 0;
+    };
+
+    // Triangle geometries of the primitives of a mesh
+    struct MeshGeometries
+    {
+        std::vector<BLASTriangleDesc>      Descs;
+        std::vector<BLASBuildTriangleData> Data;
+    };
+
+    // Adds the geometries of the indexed primitives of the mesh with positions in pVertexBuffer
+    void InitGeometries(IDeviceContext* pCtx,
+                        const Model&    GLTFModel,
+                        const Mesh&     M,
+                        IBuffer*        pVertexBuffer,
+                        Uint64          VertexOffset,
+                        Uint32          VertexStride,
+                        MeshGeometries& Geometries);
+
+    RefCntAutoPtr<IBottomLevelAS> CreateBLAS(const char* Name, const MeshGeometries& Geometries, RAYTRACING_BUILD_AS_FLAGS Flags);
+
+    void BuildBLAS(IDeviceContext* pCtx, IBottomLevelAS* pBLAS, const MeshGeometries& Geometries, Uint64 ScratchOffset, bool Update);
+
+    // Returns the scratch buffer of at least the given size
+    IBuffer* GetScratchBuffer(Uint64 Size);
+
+    Uint64 AlignScratchSize(Uint64 Size) const;
+
+    // Makes sure that at least Count names with the given prefix are available.
+    // Name pointers are only valid until the next call.
+    const std::vector<std::string>& GetNames(std::vector<std::string>& Names, const char* Prefix, size_t Count);
+
+    // Makes sure that geometry names are available for the primitives of every mesh of the model
+    void ReserveGeometryNames(const Model& GLTFModel);
+
+    RefCntAutoPtr<IRenderDevice> m_pDevice;
+    const bool                   m_CompactBLAS;
+    Uint32                       m_ScratchAlignment = 1;
+
+    std::unordered_map<const Model*, ModelEntry> m_Models;
+
+    RefCntAutoPtr<IBuffer> m_pScratchBuffer;
+    RefCntAutoPtr<IFence>  m_pFence;
+    Uint64                 m_FenceValue = 0;
+
+    // Geometry and TLAS instance names, and scratch data reused between the updates
+    std::vector<std::string>           m_GeometryNames;
+    std::vector<std::string>           m_InstanceNames;
+    std::vector<MeshGeometries>        m_Geometries;
+    std::vector<IBottomLevelAS*>       m_NodeBLASes;
+    std::vector<TLASBuildInstanceData> m_TLASInstances;
+};
+
+} // namespace GLTF
+
+} // namespace Diligent
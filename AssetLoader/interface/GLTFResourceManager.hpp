@@ -29,13 +29,20 @@
 
 #include <mutex>
 #include <vector>
+#include <array>
+#include <list>
+#include <string>
 #include <unordered_map>
 #include <atomic>
+#include <algorithm>
+#include <memory>
 
 #include "../../../DiligentCore/Graphics/GraphicsEngine/interface/RenderDevice.h"
 #include "../../../DiligentCore/Graphics/GraphicsEngine/interface/DeviceContext.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/Sampler.h"
 #include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
 #include "../../../DiligentCore/Common/interface/ObjectBase.hpp"
+#include "../../../DiligentCore/Common/interface/HashUtils.hpp"
 #include "../../../DiligentCore/Graphics/GraphicsTools/interface/BufferSuballocator.h"
 #include "../../../DiligentCore/Graphics/GraphicsTools/interface/DynamicTextureAtlas.h"
 
@@ -43,9 +50,147 @@
 namespace Diligent
 {
 
+class RingBuffer;
+
 namespace GLTF
 {
 
+/// Texture cache statistics.
+struct TextureCacheStats
+{
+    /// The number of lookups that found a live texture.
+    Uint64 NumHits = 0;
+
+    /// The number of lookups that did not find a live texture.
+    Uint64 NumMisses = 0;
+
+    /// The number of retained textures released to fit into the retention budget.
+    Uint64 NumEvictions = 0;
+
+    /// The number of textures currently retained by the cache.
+    Uint32 NumRetained = 0;
+
+    /// The estimated total size of the retained textures, in bytes.
+    Uint64 RetainedSize = 0;
+};
+
+/// Keeps strong references to recently used cache objects within the memory budget.
+
+/// Cache maps only hold weak references, so without retention an object is released as soon as
+/// the last model that uses it is destroyed, and has to be loaded again by the next model.
+/// Retained objects are kept alive until they are evicted in least-recently-used order.
+/// The class is not thread-safe.
+template <typename ObjectType>
+class CacheRetentionList
+{
+public:
+    /// Marks the object as most recently used, if it is retained.
+    void Touch(const std::string& Id)
+    {
+        auto it = m_Map.find(Id);
+        if (it != m_Map.end())
+            m_List.splice(m_List.begin(), m_List, it->second);
+    }
+
+    /// Retains the object and evicts the least recently used objects to fit into the budget.
+    void Retain(const std::string& Id, ObjectType* pObject, Uint64 Size, Uint64 Budget)
+    {
+        if (Budget == 0 || Size > Budget || m_Map.find(Id) != m_Map.end())
+            return;
+
+        m_List.emplace_front(Entry{Id, RefCntAutoPtr<ObjectType>{pObject}, Size});
+        m_Map.emplace(Id, m_List.begin());
+        m_Size += Size;
+        Trim(Budget);
+    }
+
+    /// Evicts the least recently used objects until the total size fits into the budget.
+    void Trim(Uint64 Budget)
+    {
+        while (m_Size > Budget && !m_List.empty())
+        {
+            const auto& LRU = m_List.back();
+            m_Size -= LRU.Size;
+            m_Map.erase(LRU.Id);
+            m_List.pop_back();
+            ++m_NumEvictions;
+        }
+    }
+
+    Uint64 GetSize() const { return m_Size; }
+    Uint32 GetCount() const { return static_cast<Uint32>(m_List.size()); }
+    Uint64 GetNumEvictions() const { return m_NumEvictions; }
+
+private:
+    struct Entry
+    {
+        std::string               Id;
+        RefCntAutoPtr<ObjectType> pObject;
+        Uint64                    Size;
+    };
+    std::list<Entry>                                                      m_List;
+    std::unordered_map<std::string, typename std::list<Entry>::iterator> m_Map;
+
+    Uint64 m_Size         = 0;
+    Uint64 m_NumEvictions = 0;
+};
+
+/// Removes expired weak references from the cache map when it has doubled in size since the last cleanup.
+template <typename MapType>
+void PruneExpiredCacheEntries(MapType& Map, size_t& PruneThreshold)
+{
+    if (Map.size() < PruneThreshold)
+        return;
+
+    for (auto it = Map.begin(); it != Map.end();)
+    {
+        if (!it->second.IsValid())
+            it = Map.erase(it);
+        else
+            ++it;
+    }
+    PruneThreshold = std::max(Map.size() * 2, size_t{64});
+}
+
+/// Shares sampler objects with identical descriptions.
+
+/// Every glTF model defines its own samplers, but only a handful of distinct descriptions are
+/// used in practice. Sharing them avoids creating thousands of identical sampler objects, each
+/// of which takes a descriptor heap slot in Direct3D12 and Vulkan. The cache only holds weak
+/// references, so samplers are released when the last model that uses them is destroyed.
+/// The class is thread-safe.
+class SamplerCache
+{
+public:
+    /// Returns the sampler with the given description, creating it if necessary.
+    /// The sampler name is ignored when looking up the cache.
+    RefCntAutoPtr<ISampler> GetSampler(IRenderDevice* pDevice, const SamplerDesc& Desc);
+
+private:
+    std::mutex                                                m_Mtx;
+    std::unordered_map<SamplerDesc, RefCntWeakPtr<ISampler>> m_Samplers;
+    size_t                                                    m_PruneThreshold = 64;
+};
+
+/// Texture space allocation request, see ResourceManager::AllocateTextureSpace().
+struct TextureSpaceRequest
+{
+    /// Texture format.
+    TEXTURE_FORMAT Fmt = TEX_FORMAT_UNKNOWN;
+
+    /// Texture width.
+    Uint32 Width = 0;
+
+    /// Texture height.
+    Uint32 Height = 0;
+
+    /// Optional cache id, see ResourceManager::AllocateTextureSpace().
+    const char* CacheId = nullptr;
+
+    /// User data to set in the new allocation.
+    IObject* pUserData = nullptr;
+};
+
 /// GLTF resource manager
 class ResourceManager final : public ObjectBase<IObject>
 {
@@ -61,19 +206,41 @@ public:
         Uint32 NumTexAtlases        = 0;
 
         DynamicTextureAtlasCreateInfo DefaultAtlasDesc;
+
+        /// Memory budget, in bytes, for the cached texture allocations that are retained
+        /// after all models that use them have been destroyed, see CacheRetentionList.
+        /// Zero disables retention.
+        Uint64 TextureRetentionBudget = 0;
+
+        /// Size, in bytes, of the staging buffer that is shared by all buffer uploads,
+        /// see UploadBufferData(). Zero disables the staging buffer.
+        Uint64 StagingBufferSize = 0;
+
+        /// Immediate context mask of the staging buffer. It must include all contexts
+        /// that upload the data, see UploadBufferData().
+        Uint64 StagingImmediateContextMask = 1;
     };
 
     static RefCntAutoPtr<ResourceManager> Create(IRenderDevice*    pDevice,
                                                  const CreateInfo& CI);
 
-    RefCntAutoPtr<IBufferSuballocation> AllocateBufferSpace(Uint32 BufferIndex,
-                                                            Uint32 Size,
-                                                            Uint32 Alignment)
-    {
-        RefCntAutoPtr<IBufferSuballocation> pSuballoc;
-        m_BufferSuballocators[BufferIndex]->Allocate(Size, Alignment, &pSuballoc);
-        return pSuballoc;
-    }
+    /// Allocates space in the buffer suballocator with the given index.
+
+    /// \param [in] BufferIndex - Buffer suballocator index.
+    /// \param [in] Size        - Allocation size.
+    /// \param [in] Alignment   - Allocation alignment.
+    /// \param [in] CacheId     - Optional cache id. If the allocation with the same id is
+    ///                           alive, it is returned instead of creating a new one.
+    ///                           New allocations are added to the cache.
+    /// \param [in] pUserData   - User data to set in the new allocation.
+    RefCntAutoPtr<IBufferSuballocation> AllocateBufferSpace(Uint32      BufferIndex,
+                                                            Uint32      Size,
+                                                            Uint32      Alignment,
+                                                            const char* CacheId   = nullptr,
+                                                            IObject*    pUserData = nullptr);
+
+    /// Finds the buffer allocation with the given cache id, see AllocateBufferSpace().
+    RefCntAutoPtr<IBufferSuballocation> FindBufferAllocation(const char* CacheId);
 
     RefCntAutoPtr<ITextureAtlasSuballocation> AllocateTextureSpace(TEXTURE_FORMAT Fmt,
                                                                    Uint32         Width,
@@ -81,15 +248,75 @@ public:
                                                                    const char*    CacheId   = nullptr,
                                                                    IObject*       pUserData = nullptr);
 
+    /// Allocates texture space for a batch of requests.
+
+    /// \param [in]  pRequests    - Array of NumRequests allocation requests.
+    /// \param [in]  NumRequests  - The number of requests.
+    /// \param [out] pAllocations - Array of NumRequests elements where the allocations
+    ///                             will be written, in the order of the requests.
+    ///
+    /// \remarks   The result is the same as calling AllocateTextureSpace() for every request, but the cache
+    ///            is looked up and updated with one lock each, and missing atlases are created under a single
+    ///            lock. New allocations are made from the largest to the smallest request, which packs the
+    ///            atlases better than allocating the textures in the order they are listed. Requests with
+    ///            the same cache id share one allocation.
+    void AllocateTextureSpace(const TextureSpaceRequest*                 pRequests,
+                              Uint32                                     NumRequests,
+                              RefCntAutoPtr<ITextureAtlasSuballocation>* pAllocations);
+
     RefCntAutoPtr<ITextureAtlasSuballocation> FindAllocation(const char* CacheId);
 
-    Uint32 GetTextureVersion()
+    /// Sets the texture retention budget, see CreateInfo::TextureRetentionBudget.
+    /// Retained allocations are evicted immediately if they don't fit into the new budget.
+    void SetTextureRetentionBudget(Uint64 Budget);
+
+    /// Returns texture allocation cache statistics.
+    TextureCacheStats GetTextureCacheStats();
+
+    /// Returns the shared sampler with the given description, see SamplerCache.
+    RefCntAutoPtr<ISampler> GetSampler(IRenderDevice* pDevice, const SamplerDesc& Desc)
+    {
+        return m_Samplers.GetSampler(pDevice, Desc);
+    }
+
+    /// Uploads the data to the buffer through the shared staging buffer.
+
+    /// \param [in] pCtx       - Device context that records the copy commands.
+    /// \param [in] pDstBuffer - Destination buffer.
+    /// \param [in] DstOffset  - Offset in the destination buffer.
+    /// \param [in] pData      - Data to upload.
+    /// \param [in] Size       - Data size, in bytes.
+    /// \return     The number of bytes at the start of the data that have been uploaded.
+    ///
+    /// \remarks    The staging buffer is used as a ring: its space is reused once the GPU has executed
+    ///             the copies, which is tracked by the fence that FinishStagingUploads() signals. The data is
+    ///             split into as many slices as the free space allows, so the returned size is less than Size
+    ///             when the GPU has not released enough space yet. The rest of the data should then be uploaded
+    ///             by a later call, e.g. in the next frame. Peak staging memory is thus bounded by
+    ///             CreateInfo::StagingBufferSize regardless of the data size, and no staging memory
+    ///             is allocated by steady-state uploads.
+    ///
+    ///             If the staging buffer is disabled, the data is uploaded with IDeviceContext::UpdateBuffer().
+    ///             All uploads must be recorded by the same immediate context.
+    Uint64 UploadBufferData(IDeviceContext* pCtx,
+                            IBuffer*        pDstBuffer,
+                            Uint64          DstOffset,
+                            const void*     pData,
+                            Uint64          Size);
+
+    /// Signals the fence that releases the staging space used by the copies recorded since the previous call.
+
+    /// \remarks    The method should be called by the context that recorded the uploads after every batch
+    ///             of UploadBufferData() calls, e.g. once per frame.
+    void FinishStagingUploads(IDeviceContext* pCtx);
+
+    Uint32 GetTextureVersion() const
     {
         Uint32 Version = 0;
 
-        std::lock_guard<std::mutex> Lock{m_AtlasesMtx};
-        for (auto atlas_it : m_Atlases)
-            Version += atlas_it.second->GetVersion();
+        const auto NumAtlases = m_NumAtlases.load(std::memory_order_acquire);
+        for (Uint32 i = 0; i < NumAtlases; ++i)
+            Version += m_AtlasList[i].load(std::memory_order_relaxed)->GetVersion();
 
         return Version;
     }
@@ -106,15 +333,8 @@ public:
 
     ITexture* GetTexture(TEXTURE_FORMAT Fmt, IRenderDevice* pDevice, IDeviceContext* pContext)
     {
-        decltype(m_Atlases)::iterator cache_it; // NB: can't initialize it without locking the mutex
-        {
-            std::lock_guard<std::mutex> Lock{m_AtlasesMtx};
-            cache_it = m_Atlases.find(Fmt);
-            if (cache_it == m_Atlases.end())
-                return nullptr;
-        }
-
-        return cache_it->second->GetTexture(pDevice, pContext);
+        auto* pAtlas = GetAtlas(Fmt);
+        return pAtlas != nullptr ? pAtlas->GetTexture(pDevice, pContext) : nullptr;
     }
 
     BufferSuballocatorUsageStats GetBufferUsageStats(Uint32 Index)
@@ -127,13 +347,8 @@ public:
     // NB: can't return reference here!
     TextureDesc GetAtlasDesc(TEXTURE_FORMAT Fmt)
     {
-        {
-            std::lock_guard<std::mutex> Lock{m_AtlasesMtx};
-
-            auto cache_it = m_Atlases.find(Fmt);
-            if (cache_it != m_Atlases.end())
-                return cache_it->second->GetAtlasDesc();
-        }
+        if (auto* pAtlas = GetAtlas(Fmt))
+            return pAtlas->GetAtlasDesc();
 
         // Atlas is not present in the map - use default description
         TextureDesc Desc = m_DefaultAtlasDesc.Desc;
@@ -143,13 +358,8 @@ public:
 
     Uint32 GetAllocationAlignment(TEXTURE_FORMAT Fmt, Uint32 Width, Uint32 Height)
     {
-        {
-            std::lock_guard<std::mutex> Lock{m_AtlasesMtx};
-
-            auto cache_it = m_Atlases.find(Fmt);
-            if (cache_it != m_Atlases.end())
-                return cache_it->second->GetAllocationAlignment(Width, Height);
-        }
+        if (auto* pAtlas = GetAtlas(Fmt))
+            return pAtlas->GetAllocationAlignment(Width, Height);
 
         // Atlas is not present in the map - use default description
         return ComputeTextureAtlasSuballocationAlignment(Width, Height, m_DefaultAtlasDesc.MinAlignment);
@@ -158,26 +368,23 @@ public:
     DynamicTextureAtlasUsageStats GetAtlasUsageStats(TEXTURE_FORMAT Fmt = TEX_FORMAT_UNKNOWN)
     {
         DynamicTextureAtlasUsageStats Stats;
+        if (Fmt != TEX_FORMAT_UNKNOWN)
         {
-            std::lock_guard<std::mutex> Lock{m_AtlasesMtx};
-            if (Fmt != TEX_FORMAT_UNKNOWN)
-            {
-                auto cache_it = m_Atlases.find(Fmt);
-                if (cache_it != m_Atlases.end())
-                    cache_it->second->GetUsageStats(Stats);
-            }
-            else
+            if (auto* pAtlas = GetAtlas(Fmt))
+                pAtlas->GetUsageStats(Stats);
+        }
+        else
+        {
+            const auto NumAtlases = m_NumAtlases.load(std::memory_order_acquire);
+            for (Uint32 i = 0; i < NumAtlases; ++i)
             {
-                for (auto it : m_Atlases)
-                {
-                    DynamicTextureAtlasUsageStats AtlasStats;
-                    it.second->GetUsageStats(AtlasStats);
-                    Stats.Size += AtlasStats.Size;
-                    Stats.TotalArea += AtlasStats.TotalArea;
-                    Stats.AllocatedArea += AtlasStats.AllocatedArea;
-                    Stats.UsedArea += AtlasStats.UsedArea;
-                    Stats.AllocationCount += AtlasStats.AllocationCount;
-                }
+                DynamicTextureAtlasUsageStats AtlasStats;
+                m_AtlasList[i].load(std::memory_order_relaxed)->GetUsageStats(AtlasStats);
+                Stats.Size += AtlasStats.Size;
+                Stats.TotalArea += AtlasStats.TotalArea;
+                Stats.AllocatedArea += AtlasStats.AllocatedArea;
+                Stats.UsedArea += AtlasStats.UsedArea;
+                Stats.AllocationCount += AtlasStats.AllocationCount;
             }
         }
 
@@ -188,22 +395,72 @@ private:
     template <typename AllocatorType, typename ObjectType>
     friend class Diligent::MakeNewRCObj;
 
+    // Returns the atlas for the given format without locking the mutex, or null if there is no atlas.
+    IDynamicTextureAtlas* GetAtlas(TEXTURE_FORMAT Fmt) const
+    {
+        return Fmt < TEX_FORMAT_NUM_FORMATS ?
+            m_AtlasPtrs[Fmt].load(std::memory_order_acquire) :
+            nullptr;
+    }
+
+    // Adds the atlas to the lock-free lookup tables. Must be called while m_AtlasesMtx is locked.
+    void RegisterAtlas(TEXTURE_FORMAT Fmt, IDynamicTextureAtlas* pAtlas);
+
+    // Returns the atlas for the given format, creating it from the default description if necessary.
+    // Must be called while m_AtlasesMtx is locked.
+    IDynamicTextureAtlas* CreateAtlasLocked(TEXTURE_FORMAT Fmt);
+
+    // The following methods must be called while m_TexAllocationsMtx is locked.
+    RefCntAutoPtr<ITextureAtlasSuballocation> FindAllocationLocked(const char* CacheId);
+    void                                      AddAllocationToCacheLocked(const char* CacheId, ITextureAtlasSuballocation* pAllocation, Uint32 Width, Uint32 Height);
+
     ResourceManager(IReferenceCounters* pRefCounters,
                     IRenderDevice*      pDevice,
                     const CreateInfo&   CI);
 
+    ~ResourceManager();
+
     std::vector<RefCntAutoPtr<IBufferSuballocator>> m_BufferSuballocators;
 
     DynamicTextureAtlasCreateInfo m_DefaultAtlasDesc;
     const std::string             m_DefaultAtlasName;
 
+    // The map owns the atlases and is only accessed by the threads that create them.
+    // Atlases are never removed, so the render thread looks them up in the format-indexed
+    // array of raw pointers that are published after the atlas has been added to the map.
     using AtlasesHashMapType = std::unordered_map<TEXTURE_FORMAT, RefCntAutoPtr<IDynamicTextureAtlas>, std::hash<Uint32>>;
     std::mutex         m_AtlasesMtx;
     AtlasesHashMapType m_Atlases;
 
+    std::array<std::atomic<IDynamicTextureAtlas*>, TEX_FORMAT_NUM_FORMATS> m_AtlasPtrs{};
+
+    // Atlases in the order of creation, used to iterate over all atlases.
+    std::array<std::atomic<IDynamicTextureAtlas*>, TEX_FORMAT_NUM_FORMATS> m_AtlasList{};
+    std::atomic<Uint32>                                                     m_NumAtlases{0};
+
     using TexAllocationsHashMapType = std::unordered_map<std::string, RefCntWeakPtr<ITextureAtlasSuballocation>>;
-    std::mutex                m_TexAllocationsMtx;
-    TexAllocationsHashMapType m_TexAllocations;
+    std::mutex                                     m_TexAllocationsMtx;
+    TexAllocationsHashMapType                      m_TexAllocations;
+    size_t                                         m_TexAllocationsPruneThreshold = 64;
+    CacheRetentionList<ITextureAtlasSuballocation> m_RetainedTexAllocations;
+    Uint64                                         m_TextureRetentionBudget = 0;
+    TextureCacheStats                              m_TexCacheStats;
+
+    using BuffAllocationsHashMapType = std::unordered_map<std::string, RefCntWeakPtr<IBufferSuballocation>>;
+    std::mutex                 m_BuffAllocationsMtx;
+    BuffAllocationsHashMapType m_BuffAllocations;
+    size_t                     m_BuffAllocationsPruneThreshold = 64;
+
+    SamplerCache m_Samplers;
+
+    // Staging ring buffer, see UploadBufferData(). Space is released when m_pStagingFence
+    // reaches the value that was signaled after the copies.
+    std::mutex                  m_StagingMtx;
+    RefCntAutoPtr<IBuffer>      m_pStagingBuffer;
+    RefCntAutoPtr<IFence>       m_pStagingFence;
+    std::unique_ptr<RingBuffer> m_pStagingRing;
+    Uint64                      m_StagingFenceValue     = 0;
+    bool                        m_HasPendingStagingData = false;
 };
 
 } // namespace GLTF
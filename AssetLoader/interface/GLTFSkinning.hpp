@@ -0,0 +1,278 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/RenderDevice.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/DeviceContext.h"
+#include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
+#include "GLTFLoader.hpp"
+#include "GLTFResourceManager.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// Joint matrix in the compact affine format.
+///
+/// Joint matrices are affine, so the last column of float4x4 is always (0, 0, 0, 1) and
+/// does not need to be stored or uploaded. The rows of the compact matrix are the first three
+/// columns of the float4x4 matrix, which takes 48 bytes instead of 64. In a shader, a position
+/// is transformed as float3(dot(Row0, float4(Pos, 1.0)), dot(Row1, float4(Pos, 1.0)), dot(Row2, float4(Pos, 1.0))).
+struct JointMatrix3x4
+{
+    float4 Row0;
+    float4 Row1;
+    float4 Row2;
+};
+static_assert(sizeof(JointMatrix3x4) == sizeof(float) * 12, "Unexpected JointMatrix3x4 size");
+
+/// Converts joint matrices to the compact affine format.
+void PackJointMatrices(const float4x4* pSrc, size_t Count, JointMatrix3x4* pDst);
+
+
+/// Skins and morphs model vertices with a compute shader.
+///
+/// Once per frame, the helper applies the morph targets of all morphed nodes of a model
+/// instance with the weights in ModelTransforms::MorphWeights, transforms positions and
+/// normals of all skinned nodes by the joint matrices in ModelTransforms::Skins, and writes
+/// the results to a buffer allocated from the resource manager. Only the morph targets
+/// whose weights are not zero are applied. Skinned vertices have the
+/// Model::VertexBasicAttribs layout, so all render passes (e.g. shadow and main passes) can
+/// render skinned primitives with the same pipeline as static ones by binding the output
+/// buffer in place of the basic attributes vertex buffer, and no longer need to skin
+/// in the vertex shader.
+///
+/// The model must use the default vertex layout (see DefaultVertexAttributes), and its
+/// vertex buffers must be created with the BIND_SHADER_RESOURCE flag, so that they can be
+/// read as structured buffers.
+///
+/// Typical usage:
+///
+///     Model.ComputeTransforms(Transforms, RootTransform, AnimationIndex, Time);
+///     Skinning.Skin(pContext, Model, Transforms, Instance);
+///     for (const auto& Node : Instance.Nodes)
+///     {
+///         // Bind Skinning.GetOutputBuffer() as vertex buffer 0 and draw the primitives
+///         // of LinearNodes[Node.NodeIndex] with BaseVertex = Node.BaseVertex.
+///     }
+class ComputeSkinning
+{
+public:
+    struct CreateInfo
+    {
+        IRenderDevice* pDevice = nullptr;
+
+        /// Resource manager to allocate skinned vertices from.
+        ResourceManager* pResourceMgr = nullptr;
+
+        /// Index of the resource manager buffer for skinned vertices. The buffer must be
+        /// created with the BIND_VERTEX_BUFFER and BIND_UNORDERED_ACCESS flags in the
+        /// BUFFER_MODE_STRUCTURED mode with the element stride equal to sizeof(Model::VertexBasicAttribs),
+        /// and should not be used for other data.
+        Uint32 OutputBufferIndex = 0;
+    };
+
+    explicit ComputeSkinning(const CreateInfo& CI);
+
+    /// Skinned vertices of a single node.
+    struct NodeOutput
+    {
+        /// Index of the node in Model.LinearNodes.
+        Uint32 NodeIndex = 0;
+
+        /// The first vertex of the node's mesh, relative to the model's base vertex,
+        /// and the number of vertices in the mesh.
+        Uint32 FirstVertex = 0;
+        Uint32 NumVertices = 0;
+
+        /// Base vertex to draw the node's primitives with from the output buffer.
+        ///
+        /// \remarks   Primitive indices are relative to the model's base vertex, so the value
+        ///            is computed modulo 2^32 and may represent a negative offset, which is supported
+        ///            by all backends.
+        Uint32 BaseVertex = 0;
+    };
+
+    /// Skinning state of a model instance.
+    struct InstanceData
+    {
+        /// The model that the instance was initialized for.
+        const Model* pModel = nullptr;
+
+        /// Allocation in the output buffer.
+        RefCntAutoPtr<IBufferSuballocation> pAllocation;
+
+        /// Skinned nodes.
+        std::vector<NodeOutput> Nodes;
+    };
+
+    /// Skins the model instance.
+
+    /// \param [in]      pCtx       - Device context.
+    /// \param [in]      GLTFModel  - The model.
+    /// \param [in]      Transforms - Model transforms computed with an animation.
+    /// \param [in, out] Instance   - Instance data. The output space is allocated when
+    ///                               the instance is skinned for the first time.
+    ///
+    /// \return     true if the vertices were skinned, and false otherwise, e.g. if the model
+    ///             has no skinned or morphed nodes, uses a layout that is not supported, or the
+    ///             transforms have neither joint matrices nor non-zero morph target weights.
+    bool Skin(IDeviceContext*        pCtx,
+              const Model&           GLTFModel,
+              const ModelTransforms& Transforms,
+              InstanceData&          Instance);
+
+    /// Returns the buffer that contains skinned vertices of all instances.
+    IBuffer* GetOutputBuffer(IDeviceContext* pCtx);
+
+    /// Returns true if the model uses the vertex layout supported by the compute skinning.
+    static bool IsModelSupported(const Model& GLTFModel);
+
+private:
+    bool InitInstance(const Model& GLTFModel, InstanceData& Instance);
+
+    RefCntAutoPtr<IRenderDevice>   m_pDevice;
+    RefCntAutoPtr<ResourceManager> m_pResourceMgr;
+    const Uint32                   m_OutputBufferIndex;
+
+    RefCntAutoPtr<IPipelineState>         m_pPSO;
+    RefCntAutoPtr<IShaderResourceBinding> m_pSRB;
+    RefCntAutoPtr<IBuffer>                m_pConstantsBuffer;
+    RefCntAutoPtr<IBuffer>                m_pJointsBuffer;
+    RefCntAutoPtr<IBuffer>                m_pMorphTargetsBuffer;
+
+    // Morph target with a non-zero weight, matches the shader structure
+    struct ActiveMorphTarget
+    {
+        Uint32 FirstDelta;
+        Uint32 NumDeltas;
+        float  Weight;
+        Uint32 Padding;
+    };
+
+    // Joints and active morph targets of a node in m_JointMatrices and m_ActiveMorphTargets
+    struct NodeRange
+    {
+        Uint32 FirstJoint       = 0;
+        Uint32 NumJoints        = 0;
+        Uint32 FirstMorphTarget = 0;
+        Uint32 NumMorphTargets  = 0;
+    };
+
+    // Joint matrices and active morph targets of all nodes of the instance being skinned
+    std::vector<JointMatrix3x4>    m_JointMatrices;
+    std::vector<ActiveMorphTarget> m_ActiveMorphTargets;
+    std::vector<NodeRange>         m_NodeRanges;
+};
+
+
+/// Writes joint matrices of all skins of several model instances into one structured buffer.
+///
+/// Instead of uploading the joint matrices of every skin separately, the skins of all instances
+/// are added to the palette, and Commit() writes them to a single dynamic structured buffer with one
+/// map per frame. Shaders read the matrices of a skin starting from its first joint in the buffer.
+///
+/// Typical usage:
+///
+///     Palette.Reset();
+///     for (auto& Inst : Instances)
+///         Inst.FirstSkin = Palette.AddInstance(Inst.Transforms);
+///     Palette.Commit(pContext);
+///     // Bind Palette.GetBuffer() and draw every skinned node with
+///     // FirstJoint = Palette.GetSkinFirstJoint(Inst.FirstSkin + Node.SkinTransformsIndex)
+class JointPalette
+{
+public:
+    struct CreateInfo
+    {
+        IRenderDevice* pDevice = nullptr;
+
+        /// Whether to store the matrices in the compact JointMatrix3x4 format instead of float4x4.
+        bool Compact = true;
+
+        /// Initial buffer capacity, in joints. The buffer grows as needed.
+        Uint32 InitialJointCount = 1024;
+    };
+
+    explicit JointPalette(const CreateInfo& CI);
+
+    /// Removes all instances added since the last commit.
+    void Reset();
+
+    /// Adds all skins of the model instance to the palette.
+
+    /// \param [in] Transforms - Transforms of the instance. The object must be alive
+    ///                          and its joint matrices must not change until Commit() is called.
+    ///
+    /// \return     The index of the first skin of the instance. Skin i of the instance
+    ///             (see Node::SkinTransformsIndex) has the index FirstSkin + i.
+    Uint32 AddInstance(const ModelTransforms& Transforms);
+
+    /// Writes the joint matrices of all added instances to the buffer.
+
+    /// \return     true if the matrices were written, and false if the buffer could not be created.
+    ///
+    /// \remarks    The buffer is mapped with the MAP_FLAG_DISCARD flag, so the palette
+    ///             must be committed at most once per frame.
+    bool Commit(IDeviceContext* pCtx);
+
+    /// Returns the index of the first joint of the skin in the buffer.
+    Uint32 GetSkinFirstJoint(Uint32 SkinIndex) const
+    {
+        VERIFY_EXPR(SkinIndex < m_SkinFirstJoints.size());
+        return m_SkinFirstJoints[SkinIndex];
+    }
+
+    /// Returns the total number of joints of all added instances.
+    Uint32 GetJointCount() const { return m_NumJoints; }
+
+    /// Returns the size of one joint matrix in the buffer.
+    Uint32 GetJointStride() const { return m_Compact ? sizeof(JointMatrix3x4) : sizeof(float4x4); }
+
+    /// Returns the structured buffer that contains the joint matrices.
+    IBuffer* GetBuffer() const { return m_pBuffer; }
+
+private:
+    RefCntAutoPtr<IRenderDevice> m_pDevice;
+    RefCntAutoPtr<IBuffer>       m_pBuffer;
+    const bool                   m_Compact;
+    Uint32                       m_Capacity;
+
+    // Joint matrices of all added skins and their first joints in the buffer
+    std::vector<const std::vector<float4x4>*> m_Skins;
+    std::vector<Uint32>                       m_SkinFirstJoints;
+    Uint32                                    m_NumJoints = 0;
+};
+
+} // namespace GLTF
+
+} // namespace Diligent
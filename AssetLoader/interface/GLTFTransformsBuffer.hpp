@@ -0,0 +1,139 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include "GLTFLoader.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+/// Triple-buffered model transforms that are computed by one thread and read by another.
+///
+/// The update thread computes the transforms into the write buffer returned by GetWriteTransforms()
+/// and calls Publish(). The render thread calls Acquire() to get the most recently published
+/// transforms, which it may read until the next Acquire() call. The buffers are handed over by
+/// swapping their indices with a single atomic exchange, so neither side ever waits for the other,
+/// and no data is copied.
+///
+/// Each buffer keeps its vectors between the frames, so once all three buffers have been computed,
+/// the handoff performs no allocations. Every buffer also keeps its own incremental update state
+/// (see Model::ComputeTransforms()): the state stays consistent with the matrices in the buffer,
+/// so the incremental update remains correct, but ModelTransforms::Incremental.NodeChanged identifies
+/// the nodes that changed since the buffer was last computed, which is typically three frames ago.
+///
+/// Typical usage:
+///
+///     // Update thread
+///     pModel->ComputeTransforms(Buffer.GetWriteTransforms(), RootTransform, AnimationIndex, Time);
+///     Buffer.Publish();
+///
+///     // Render thread
+///     if (const auto* pTransforms = Buffer.Acquire())
+///         DrawModel(*pTransforms);
+///
+/// Only one thread may write and only one thread may read the buffer at the same time.
+class ModelTransformsBuffer
+{
+public:
+    ModelTransformsBuffer() = default;
+
+    // clang-format off
+    ModelTransformsBuffer           (const ModelTransformsBuffer&)  = delete;
+    ModelTransformsBuffer           (      ModelTransformsBuffer&&) = delete;
+    ModelTransformsBuffer& operator=(const ModelTransformsBuffer&)  = delete;
+    ModelTransformsBuffer& operator=(      ModelTransformsBuffer&&) = delete;
+    // clang-format on
+
+    /// Returns the transforms that the writer computes. The same object is returned until Publish() is called.
+    ModelTransforms& GetWriteTransforms()
+    {
+        return m_Buffers[m_WriteIdx];
+    }
+
+    /// Makes the write transforms available to the reader and switches the writer to another buffer.
+
+    /// \remarks   If the reader has not acquired the previously published transforms, they are
+    ///            replaced, and the writer gets their buffer.
+    void Publish()
+    {
+        const auto PrevShared = m_SharedIdx.exchange(m_WriteIdx | NewDataFlag, std::memory_order_acq_rel);
+        m_WriteIdx            = PrevShared & IndexMask;
+    }
+
+    /// Returns the most recently published transforms, or null if nothing has been published yet.
+
+    /// \remarks   The returned transforms are owned by the reader until the next call to Acquire().
+    const ModelTransforms* Acquire()
+    {
+        if ((m_SharedIdx.load(std::memory_order_relaxed) & NewDataFlag) != 0)
+        {
+            const auto PrevShared = m_SharedIdx.exchange(m_ReadIdx, std::memory_order_acq_rel);
+            m_ReadIdx             = PrevShared & IndexMask;
+            m_HasReadData         = true;
+        }
+        return GetReadTransforms();
+    }
+
+    /// Returns the transforms returned by the last call to Acquire() without checking for new data.
+    const ModelTransforms* GetReadTransforms() const
+    {
+        return m_HasReadData ? &m_Buffers[m_ReadIdx] : nullptr;
+    }
+
+    /// Returns true if the writer has published the transforms that the reader has not acquired yet.
+    bool HasNewData() const
+    {
+        return (m_SharedIdx.load(std::memory_order_relaxed) & NewDataFlag) != 0;
+    }
+
+private:
+    static constexpr Uint32 IndexMask   = 0x3;
+    static constexpr Uint32 NewDataFlag = 0x4;
+
+    std::array<ModelTransforms, 3> m_Buffers;
+
+    // Owned by the writer
+    Uint32 m_WriteIdx = 0;
+
+    // Owned by the reader
+    Uint32 m_ReadIdx     = 1;
+    bool   m_HasReadData = false;
+
+    // The buffer that is passed between the threads, and whether it contains data that has not been acquired
+    std::atomic<Uint32> m_SharedIdx{2};
+};
+
+} // namespace GLTF
+
+} // namespace Diligent
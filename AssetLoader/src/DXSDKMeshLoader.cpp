@@ -26,91 +26,256 @@
  */
 
 #include <string>
-#include <sstream>
 #include <cfloat>
+#include <algorithm>
+#include <vector>
+#include <unordered_set>
 
 #include "DXSDKMeshLoader.hpp"
+#include "GLTFLoader.hpp"
 #include "DataBlobImpl.hpp"
 #include "RefCntAutoPtr.hpp"
 #include "FileWrapper.hpp"
+#include "MappedFileDataBlob.hpp"
 #include "TextureUtilities.h"
+#include "TextureLoader.h"
 #include "GraphicsAccessories.hpp"
+#include "ThreadPool.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#    include <xmmintrin.h>
+#    define DXSDKMESH_USE_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#    include <arm_neon.h>
+#    define DXSDKMESH_USE_NEON 1
+#endif
 
 namespace Diligent
 {
 
 
 //--------------------------------------------------------------------------------------
-bool DXSDKMesh::CreateFromFile(const char* szFileName)
+bool DXSDKMesh::CreateFromFile(const char* szFileName, IThreadPool* pThreadPool)
 {
-    FileWrapper File;
-    File.Open(FileOpenAttribs{szFileName});
-    if (!File)
+    // Pointer fixup only touches the headers, so the mapped buffer data is never copied
+    RefCntAutoPtr<IDataBlob> pFileData = MappedFileDataBlob::Create(szFileName);
+    if (!pFileData)
     {
-        LOG_ERROR("Failed to open SDK Mesh file ", szFileName);
-        return false;
-    }
+        FileWrapper File;
+        File.Open(FileOpenAttribs{szFileName});
+        if (!File)
+        {
+            LOG_ERROR("Failed to open SDK Mesh file ", szFileName);
+            return false;
+        }
 
-    auto pFileData = DataBlobImpl::Create();
-    File->Read(pFileData);
+        pFileData = DataBlobImpl::Create();
+        File->Read(pFileData);
 
-    File.Close();
+        File.Close();
+    }
+
+    return CreateFromBlob(pFileData, pThreadPool);
+}
 
-    auto res = CreateFromMemory(reinterpret_cast<Uint8*>(pFileData->GetDataPtr()),
-                                static_cast<Uint32>(pFileData->GetSize()));
+namespace
+{
 
-    return res;
+template <typename IndexType>
+void GetIndexRange(const IndexType* Indices, Uint32 NumIndices, Uint32& MinIndex, Uint32& MaxIndex)
+{
+    IndexType Min = Indices[0];
+    IndexType Max = Indices[0];
+    for (Uint32 i = 1; i < NumIndices; ++i)
+    {
+        Min = std::min(Min, Indices[i]);
+        Max = std::max(Max, Indices[i]);
+    }
+    MinIndex = Min;
+    MaxIndex = Max;
 }
 
-void DXSDKMesh::ComputeBoundingBoxes()
+// Accumulates the bounds of the positions of the vertices in the range [FirstVertex, LastVertex].
+// Every vertex is visited once, no matter how many times it is referenced by the indices.
+void AccumulateBounds(const Uint8* pPositions, Uint32 Stride, Uint32 FirstVertex, Uint32 LastVertex, float3& Min, float3& Max)
 {
-    for (Uint32 i = 0; i < m_pMeshHeader->NumMeshes; i++)
+#if DXSDKMESH_USE_SSE
+    __m128 vMin = _mm_setr_ps(Min.x, Min.y, Min.z, 0);
+    __m128 vMax = _mm_setr_ps(Max.x, Max.y, Max.z, 0);
+    for (Uint32 v = FirstVertex; v <= LastVertex; ++v)
     {
-        auto& Mesh = m_pMeshArray[i];
+        // Load exactly 12 bytes to not read past the end of the last vertex
+        const float* pPos = reinterpret_cast<const float*>(pPositions + size_t{v} * Stride);
+        const __m128 Pos  = _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(pPos)), _mm_load_ss(pPos + 2));
+        vMin = _mm_min_ps(vMin, Pos);
+        vMax = _mm_max_ps(vMax, Pos);
+    }
+    float MinData[4], MaxData[4];
+    _mm_storeu_ps(MinData, vMin);
+    _mm_storeu_ps(MaxData, vMax);
+    Min = float3{MinData[0], MinData[1], MinData[2]};
+    Max = float3{MaxData[0], MaxData[1], MaxData[2]};
+#elif DXSDKMESH_USE_NEON
+    float32x4_t vMin = {Min.x, Min.y, Min.z, 0};
+    float32x4_t vMax = {Max.x, Max.y, Max.z, 0};
+    for (Uint32 v = FirstVertex; v <= LastVertex; ++v)
+    {
+        const float*      pPos = reinterpret_cast<const float*>(pPositions + size_t{v} * Stride);
+        const float32x4_t Pos  = vcombine_f32(vld1_f32(pPos), vld1_lane_f32(pPos + 2, vdup_n_f32(0), 0));
+        vMin = vminq_f32(vMin, Pos);
+        vMax = vmaxq_f32(vMax, Pos);
+    }
+    Min = float3{vgetq_lane_f32(vMin, 0), vgetq_lane_f32(vMin, 1), vgetq_lane_f32(vMin, 2)};
+    Max = float3{vgetq_lane_f32(vMax, 0), vgetq_lane_f32(vMax, 1), vgetq_lane_f32(vMax, 2)};
+#else
+    for (Uint32 v = FirstVertex; v <= LastVertex; ++v)
+    {
+        const float3& Pos = *reinterpret_cast<const float3*>(pPositions + size_t{v} * Stride);
+        Min               = std::min(Min, Pos);
+        Max               = std::max(Max, Pos);
+    }
+#endif
+}
+
+} // namespace
 
+void DXSDKMesh::ComputeBoundingBoxes(IThreadPool* pThreadPool)
+{
+    struct SubsetBoundsInfo
+    {
+        Uint32 MeshIdx;
+        Uint32 SubsetIdx;
         float3 Min{+FLT_MAX, +FLT_MAX, +FLT_MAX};
         float3 Max{-FLT_MAX, -FLT_MAX, -FLT_MAX};
-
-        const auto& VertexData = m_pVertexBufferArray[Mesh.VertexBuffers[0]];
-        auto*       PosDecl    = VertexData.Decl;
-        while (PosDecl->Stream != 0xFF && PosDecl->Usage != DXSDKMESH_VERTEX_SEMANTIC_POSITION)
-            ++PosDecl;
-        VERIFY(PosDecl->Stream != 0xFF, "Position semantic not found in this buffer");
-        VERIFY(PosDecl->Type == DXSDKMESH_VERTEX_DATA_TYPE_FLOAT3, "Vertex is expected to be a 3-component float vector");
-
-        auto        IndexType = GetIndexType(i);
-        const auto* Vertices  = GetRawVerticesAt(Mesh.VertexBuffers[0]);
-        const auto* Indices   = GetRawIndicesAt(Mesh.IndexBuffer);
-        auto        Stride    = GetVertexStride(Mesh.VertexBuffers[0]);
+    };
+    std::vector<SubsetBoundsInfo> Subsets;
+    Uint64                        TotalIndices = 0;
+    for (Uint32 i = 0; i < m_pMeshHeader->NumMeshes; i++)
+    {
+        const auto& Mesh = m_pMeshArray[i];
         for (Uint32 subsetIdx = 0; subsetIdx < Mesh.NumSubsets; ++subsetIdx)
         {
-            auto& Subset = m_pSubsetArray[Mesh.pSubsets[subsetIdx]];
+            const auto& Subset = m_pSubsetArray[Mesh.pSubsets[subsetIdx]];
+            if (Subset.IndexCount == 0)
+                continue;
+            Subsets.push_back({i, subsetIdx});
+            TotalIndices += Subset.IndexCount;
+        }
+    }
 
-            for (Uint32 v = 0; v < Subset.IndexCount; ++v)
+    auto ProcessSubsets = [this](SubsetBoundsInfo* pSubsets, size_t Count) {
+        for (size_t s = 0; s < Count; ++s)
+        {
+            auto&       Info = pSubsets[s];
+            const auto& Mesh = m_pMeshArray[Info.MeshIdx];
+
+            const auto& VertexData = m_pVertexBufferArray[Mesh.VertexBuffers[0]];
+            auto*       PosDecl    = VertexData.Decl;
+            while (PosDecl->Stream != 0xFF && PosDecl->Usage != DXSDKMESH_VERTEX_SEMANTIC_POSITION)
+                ++PosDecl;
+            VERIFY(PosDecl->Stream != 0xFF, "Position semantic not found in this buffer");
+            VERIFY(PosDecl->Type == DXSDKMESH_VERTEX_DATA_TYPE_FLOAT3, "Vertex is expected to be a 3-component float vector");
+
+            const auto& Subset   = m_pSubsetArray[Mesh.pSubsets[Info.SubsetIdx]];
+            const auto* Indices  = GetRawIndicesAt(Mesh.IndexBuffer);
+            Uint32      MinIndex = 0;
+            Uint32      MaxIndex = 0;
+            if (GetIndexType(Info.MeshIdx) == IT_16BIT)
+                GetIndexRange(reinterpret_cast<const Uint16*>(Indices) + Subset.IndexStart, static_cast<Uint32>(Subset.IndexCount), MinIndex, MaxIndex);
+            else
+                GetIndexRange(reinterpret_cast<const Uint32*>(Indices) + Subset.IndexStart, static_cast<Uint32>(Subset.IndexCount), MinIndex, MaxIndex);
+
+            const auto* Vertices = GetRawVerticesAt(Mesh.VertexBuffers[0]);
+            AccumulateBounds(Vertices + PosDecl->Offset, GetVertexStride(Mesh.VertexBuffers[0]), MinIndex, MaxIndex, Info.Min, Info.Max);
+        }
+    };
+
+    // Do not pay the task overhead for small meshes
+    constexpr Uint64 MinIndicesPerTask = 64 << 10;
+
+    const size_t NumTasks = pThreadPool != nullptr ?
+        static_cast<size_t>(std::min<Uint64>(TotalIndices / MinIndicesPerTask, Subsets.size())) :
+        0;
+    if (NumTasks > 1)
+    {
+        // Split the subsets into ranges with approximately the same number of indices
+        const Uint64 IndicesPerTask = (TotalIndices + NumTasks - 1) / NumTasks;
+
+        std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+        Tasks.reserve(NumTasks);
+        size_t RangeStart   = 0;
+        Uint64 RangeIndices = 0;
+        for (size_t s = 0; s < Subsets.size(); ++s)
+        {
+            const auto& Info = Subsets[s];
+            RangeIndices += m_pSubsetArray[m_pMeshArray[Info.MeshIdx].pSubsets[Info.SubsetIdx]].IndexCount;
+            if (RangeIndices >= IndicesPerTask || s + 1 == Subsets.size())
             {
-                const Uint32 Index = IndexType == IT_16BIT ?
-                    reinterpret_cast<const Uint16*>(Indices)[Subset.IndexStart + v] :
-                    reinterpret_cast<const Uint32*>(Indices)[Subset.IndexStart + v];
-
-                const float3& Vertex =
-                    reinterpret_cast<const float3&>(Vertices[Index * Stride + PosDecl->Offset]);
-                Min = std::min(Min, Vertex);
-                Max = std::max(Max, Vertex);
+                auto* pRange = &Subsets[RangeStart];
+                auto  Count  = s + 1 - RangeStart;
+                Tasks.emplace_back(
+                    EnqueueAsyncWork(pThreadPool,
+                                     [&ProcessSubsets, pRange, Count](Uint32 ThreadId) {
+                                         ProcessSubsets(pRange, Count);
+                                     }));
+                RangeStart   = s + 1;
+                RangeIndices = 0;
             }
         }
-        Mesh.BoundingBoxCenter  = (Max + Min) * 0.5;
-        Mesh.BoundingBoxExtents = (Max - Min);
+
+        for (auto& pTask : Tasks)
+            pTask->WaitForCompletion();
+    }
+    else if (!Subsets.empty())
+    {
+        ProcessSubsets(Subsets.data(), Subsets.size());
     }
+
+    std::vector<float3> MeshMin(m_pMeshHeader->NumMeshes, float3{+FLT_MAX, +FLT_MAX, +FLT_MAX});
+    std::vector<float3> MeshMax(m_pMeshHeader->NumMeshes, float3{-FLT_MAX, -FLT_MAX, -FLT_MAX});
+    for (const auto& Info : Subsets)
+    {
+        MeshMin[Info.MeshIdx] = std::min(MeshMin[Info.MeshIdx], Info.Min);
+        MeshMax[Info.MeshIdx] = std::max(MeshMax[Info.MeshIdx], Info.Max);
+    }
+
+    for (Uint32 i = 0; i < m_pMeshHeader->NumMeshes; i++)
+    {
+        auto& Mesh              = m_pMeshArray[i];
+        Mesh.BoundingBoxCenter  = (MeshMax[i] + MeshMin[i]) * 0.5;
+        Mesh.BoundingBoxExtents = (MeshMax[i] - MeshMin[i]);
+    }
+}
+
+bool DXSDKMesh::CreateFromMemory(Uint8*       pData,
+                                 Uint32       DataUint8s,
+                                 IThreadPool* pThreadPool)
+{
+    // The caller owns the data, so the pointers are fixed up in a copy
+    return CreateFromBlob(DataBlobImpl::Create(DataUint8s, pData), pThreadPool);
 }
 
-bool DXSDKMesh::CreateFromMemory(Uint8* pData,
-                                 Uint32 DataUint8s)
+bool DXSDKMesh::CreateFromBlob(IDataBlob* pData, IThreadPool* pThreadPool)
 {
-    m_StaticMeshData.resize(DataUint8s);
-    memcpy(m_StaticMeshData.data(), pData, DataUint8s);
+    VERIFY_EXPR(pData != nullptr);
+
+    if (pData->GetSize() < sizeof(DXSDKMESH_HEADER))
+    {
+        LOG_ERROR("SDK mesh data is too small");
+        return false;
+    }
+
+    const auto& Header = *reinterpret_cast<const DXSDKMESH_HEADER*>(pData->GetConstDataPtr());
+    if (Header.HeaderSize + Header.NonBufferDataSize + Header.BufferDataSize > pData->GetSize())
+    {
+        LOG_ERROR("SDK mesh data is truncated");
+        return false;
+    }
+
+    m_pStaticMeshData = pData;
 
     // Pointer fixup
-    auto* pStaticMeshData = m_StaticMeshData.data();
+    auto* pStaticMeshData = reinterpret_cast<Uint8*>(m_pStaticMeshData->GetDataPtr());
     // clang-format off
     m_pMeshHeader        = reinterpret_cast<DXSDKMESH_HEADER*>              (pStaticMeshData);
     m_pVertexBufferArray = reinterpret_cast<DXSDKMESH_VERTEX_BUFFER_HEADER*>(pStaticMeshData + m_pMeshHeader->VertexStreamHeadersOffset);
@@ -147,7 +312,7 @@ bool DXSDKMesh::CreateFromMemory(Uint8* pData,
     }
 
     // Setup buffer data pointer
-    Uint8* pBufferData = m_StaticMeshData.data() + m_pMeshHeader->HeaderSize + m_pMeshHeader->NonBufferDataSize;
+    Uint8* pBufferData = pStaticMeshData + m_pMeshHeader->HeaderSize + m_pMeshHeader->NonBufferDataSize;
 
     // Get the start of the buffer data
     Uint64 BufferDataStart = m_pMeshHeader->HeaderSize + m_pMeshHeader->NonBufferDataSize;
@@ -166,106 +331,363 @@ bool DXSDKMesh::CreateFromMemory(Uint8* pData,
         m_ppIndices[i] = reinterpret_cast<Uint8*>(pBufferData + (m_pIndexBufferArray[i].DataOffset - BufferDataStart));
     }
 
-    ComputeBoundingBoxes();
+    ComputeBoundingBoxes(pThreadPool);
 
     return true;
 }
 
-static void LoadTexture(IRenderDevice*                    pDevice,
-                        const Char*                       ResourceDirectory,
-                        const Char*                       Name,
-                        bool                              IsSRGB,
-                        ITexture**                        ppTexture,
-                        ITextureView**                    ppSRV,
-                        std::vector<StateTransitionDesc>& Barriers)
+void DXSDKMesh::LoadGPUResources(const Char* ResourceDirectory, IRenderDevice* pDevice, IDeviceContext* pDeviceCtx, IThreadPool* pThreadPool)
+{
+    LoadGPUResourcesImpl(ResourceDirectory, pDevice, pDeviceCtx, nullptr, pThreadPool);
+}
+
+void DXSDKMesh::LoadGPUResources(const Char*                       ResourceDirectory,
+                                 IRenderDevice*                    pDevice,
+                                 IDeviceContext*                   pDeviceCtx,
+                                 const GLTF::ResourceCacheUseInfo& CacheInfo,
+                                 IThreadPool*                      pThreadPool)
 {
-    std::string FullPath = ResourceDirectory;
-    if (!FullPath.empty() && !FileSystem::IsSlash(FullPath.back()))
-        FullPath.push_back(FileSystem::SlashSymbol);
-    FullPath.append(Name);
-    if (FileSystem::FileExists(FullPath.c_str()))
+    DEV_CHECK_ERR(CacheInfo.pResourceMgr != nullptr, "Resource manager must not be null");
+    LoadGPUResourcesImpl(ResourceDirectory, pDevice, pDeviceCtx, &CacheInfo, pThreadPool);
+}
+
+namespace
+{
+
+// Uploads the mip levels of the texture loader into the atlas region.
+void InitAtlasRegion(ITextureLoader* pLoader, ITextureAtlasSuballocation* pAllocation, IRenderDevice* pDevice, IDeviceContext* pCtx)
+{
+    auto* pTexture = pAllocation->GetAtlas()->GetTexture(pDevice, pCtx);
+    if (pTexture == nullptr)
+        return;
+
+    const auto& SrcDesc    = pLoader->GetTextureDesc();
+    const auto& DstDesc    = pTexture->GetDesc();
+    const auto& FmtAttribs = GetTextureFormatAttribs(DstDesc.Format);
+    const auto& Origin     = pAllocation->GetOrigin();
+
+    auto NumMips = std::min(SrcDesc.MipLevels, DstDesc.MipLevels);
+    if (FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED)
     {
-        TextureLoadInfo LoadInfo;
-        LoadInfo.IsSRGB = IsSRGB;
-        CreateTextureFromFile(FullPath.c_str(), LoadInfo, pDevice, ppTexture);
-        if (*ppTexture != nullptr)
-        {
-            *ppSRV = (*ppTexture)->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
-            (*ppSRV)->AddRef();
-        }
-        else
+        // Do not upload mip levels that are smaller than the block size
+        for (; NumMips > 0; --NumMips)
         {
-            LOG_ERROR("Failed to load texture ", Name);
+            const auto MipProps = GetMipLevelProperties(SrcDesc, NumMips - 1);
+            if (MipProps.LogicalWidth >= FmtAttribs.BlockWidth &&
+                MipProps.LogicalHeight >= FmtAttribs.BlockHeight)
+                break;
         }
-        Barriers.emplace_back(*ppTexture, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, STATE_TRANSITION_FLAG_UPDATE_STATE);
+    }
+
+    for (Uint32 mip = 0; mip < NumMips; ++mip)
+    {
+        const auto MipProps = GetMipLevelProperties(SrcDesc, mip);
+
+        Box UpdateBox;
+        UpdateBox.MinX = Origin.x >> mip;
+        UpdateBox.MaxX = UpdateBox.MinX + MipProps.StorageWidth;
+        UpdateBox.MinY = Origin.y >> mip;
+        UpdateBox.MaxY = UpdateBox.MinY + MipProps.StorageHeight;
+        pCtx->UpdateTexture(pTexture, mip, pAllocation->GetSlice(), UpdateBox, pLoader->GetSubresourceData(mip, 0),
+                            RESOURCE_STATE_TRANSITION_MODE_NONE, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
     }
 }
 
-void DXSDKMesh::LoadGPUResources(const Char* ResourceDirectory, IRenderDevice* pDevice, IDeviceContext* pDeviceCtx)
+} // namespace
+
+void DXSDKMesh::LoadGPUResourcesImpl(const Char*                       ResourceDirectory,
+                                     IRenderDevice*                    pDevice,
+                                     IDeviceContext*                   pDeviceCtx,
+                                     const GLTF::ResourceCacheUseInfo* pCacheInfo,
+                                     IThreadPool*                      pThreadPool)
 {
+    auto* const pResourceMgr = pCacheInfo != nullptr ? pCacheInfo->pResourceMgr : nullptr;
+
     std::vector<StateTransitionDesc> Barriers;
+
+    // Collect the textures of all materials so that they are decoded in one batch
+    std::vector<std::string>     TexPaths;
+    std::vector<TextureLoadInfo> TexLoadInfos;
+    std::vector<Uint32>          TexSlots; // Material index * DXSDKMESH_MATERIAL_TEXTURE_COUNT + texture
+
+    const auto AddTexture = [&](Uint32 MaterialIdx, DXSDKMESH_MATERIAL_TEXTURE Texture, const Char* Name, bool IsSRGB, TEXTURE_FORMAT AtlasFormat) {
+        if (Name[0] == 0)
+            return;
+
+        std::string FullPath = ResourceDirectory;
+        if (!FullPath.empty() && !FileSystem::IsSlash(FullPath.back()))
+            FullPath.push_back(FileSystem::SlashSymbol);
+        FullPath.append(Name);
+        if (!FileSystem::FileExists(FullPath.c_str()))
+            return;
+
+        TextureLoadInfo LoadInfo;
+        LoadInfo.IsSRGB = IsSRGB;
+        if (pResourceMgr != nullptr)
+        {
+            // Convert the texture to the format of the atlas shared with GLTF models
+            LoadInfo.Format = AtlasFormat;
+        }
+        TexPaths.emplace_back(std::move(FullPath));
+        TexLoadInfos.emplace_back(LoadInfo);
+        TexSlots.emplace_back(MaterialIdx * DXSDKMESH_MATERIAL_TEXTURE_COUNT + Texture);
+    };
+
     for (Uint32 i = 0; i < m_pMeshHeader->NumMaterials; i++)
     {
-        auto& Mat = m_pMaterialArray[i];
-        if (Mat.DiffuseTexture[0] != 0)
+        const auto& Mat = m_pMaterialArray[i];
+        // clang-format off
+        AddTexture(i, DXSDKMESH_MATERIAL_TEXTURE_DIFFUSE,  Mat.DiffuseTexture,  true,  pCacheInfo != nullptr ? pCacheInfo->BaseColorFormat    : TEX_FORMAT_UNKNOWN);
+        AddTexture(i, DXSDKMESH_MATERIAL_TEXTURE_NORMAL,   Mat.NormalTexture,   false, pCacheInfo != nullptr ? pCacheInfo->NormalFormat       : TEX_FORMAT_UNKNOWN);
+        AddTexture(i, DXSDKMESH_MATERIAL_TEXTURE_SPECULAR, Mat.SpecularTexture, false, pCacheInfo != nullptr ? pCacheInfo->PhysicalDescFormat : TEX_FORMAT_UNKNOWN);
+        // clang-format on
+    }
+
+    if (pResourceMgr != nullptr)
+    {
+        m_TextureAllocations.clear();
+        m_TextureAllocations.resize(size_t{m_pMeshHeader->NumMaterials} * DXSDKMESH_MATERIAL_TEXTURE_COUNT);
+
+        // Textures that are already in the atlas (e.g. loaded by another mesh) are neither decoded nor uploaded again
+        size_t NumToLoad = 0;
+        for (size_t i = 0; i < TexPaths.size(); ++i)
         {
-            LoadTexture(pDevice, ResourceDirectory, Mat.DiffuseTexture, true, &Mat.pDiffuseTexture, &Mat.pDiffuseRV, Barriers);
+            const auto CacheId = FileSystem::SimplifyPath(TexPaths[i].c_str());
+            if (auto pAllocation = pResourceMgr->FindAllocation(CacheId.c_str()))
+            {
+                m_TextureAllocations[TexSlots[i]] = std::move(pAllocation);
+                continue;
+            }
+            if (NumToLoad != i)
+            {
+                TexPaths[NumToLoad]     = std::move(TexPaths[i]);
+                TexLoadInfos[NumToLoad] = TexLoadInfos[i];
+                TexSlots[NumToLoad]     = TexSlots[i];
+            }
+            ++NumToLoad;
         }
+        TexPaths.resize(NumToLoad);
+        TexLoadInfos.resize(NumToLoad);
+        TexSlots.resize(NumToLoad);
+    }
 
-        if (Mat.NormalTexture[0] != 0)
+    if (!TexPaths.empty())
+    {
+        std::vector<const Char*> TexPathPtrs(TexPaths.size());
+        for (size_t i = 0; i < TexPaths.size(); ++i)
+            TexPathPtrs[i] = TexPaths[i].c_str();
+
+        // Repeated files are decoded once, and files are decoded and mipped in parallel
+        // on the thread pool. GPU objects are created on this thread.
+        std::vector<ITextureLoader*> Loaders(TexPaths.size());
+        std::vector<ITexture*>       Textures(TexPaths.size());
+
+        CreateTexturesFromFilesAttribs Attribs;
+        Attribs.NumTextures = static_cast<Uint32>(TexPaths.size());
+        Attribs.ppFilePaths = TexPathPtrs.data();
+        Attribs.pLoadInfos  = TexLoadInfos.data();
+        Attribs.pThreadPool = pThreadPool;
+        if (pResourceMgr != nullptr)
         {
-            LoadTexture(pDevice, ResourceDirectory, Mat.NormalTexture, false, &Mat.pNormalTexture, &Mat.pNormalRV, Barriers);
+            Attribs.ppLoaders = Loaders.data();
         }
+        else
+        {
+            Attribs.pDevice    = pDevice;
+            Attribs.ppTextures = Textures.data();
+        }
+        CreateTexturesFromFiles(Attribs);
+
+        if (pResourceMgr != nullptr)
+        {
+            // Take over the references returned by CreateTexturesFromFiles
+            std::vector<RefCntAutoPtr<ITextureLoader>> TexLoaders(TexPaths.size());
+            std::vector<std::string>                   CacheIds(TexPaths.size());
+            std::vector<GLTF::TextureSpaceRequest>     Requests;
+            std::vector<size_t>                        RequestTexIds;
+            for (size_t i = 0; i < TexPaths.size(); ++i)
+            {
+                TexLoaders[i].Attach(Loaders[i]);
+                if (!TexLoaders[i])
+                {
+                    LOG_ERROR("Failed to load texture ", TexPaths[i]);
+                    continue;
+                }
+
+                const auto& TexDesc = TexLoaders[i]->GetTextureDesc();
+                CacheIds[i]         = FileSystem::SimplifyPath(TexPaths[i].c_str());
+
+                GLTF::TextureSpaceRequest Request;
+                Request.Fmt     = TexDesc.Format;
+                Request.Width   = TexDesc.Width;
+                Request.Height  = TexDesc.Height;
+                Request.CacheId = CacheIds[i].c_str();
+                Requests.emplace_back(Request);
+                RequestTexIds.emplace_back(i);
+            }
+
+            // Allocate all regions at once so that the atlas is packed from the largest texture to the smallest
+            std::vector<RefCntAutoPtr<ITextureAtlasSuballocation>> Allocations(Requests.size());
+            pResourceMgr->AllocateTextureSpace(Requests.data(), static_cast<Uint32>(Requests.size()), Allocations.data());
 
-        if (Mat.SpecularTexture[0] != 0)
+            // Entries with the same file share the loader and the allocation, so the region is uploaded once
+            std::unordered_set<ITextureAtlasSuballocation*> InitializedRegions;
+            for (size_t r = 0; r < Requests.size(); ++r)
+            {
+                const auto i      = RequestTexIds[r];
+                auto&      pAlloc = Allocations[r];
+                if (!pAlloc)
+                {
+                    LOG_ERROR("Failed to allocate atlas space for texture ", TexPaths[i]);
+                    continue;
+                }
+                if (InitializedRegions.insert(pAlloc).second)
+                    InitAtlasRegion(TexLoaders[i], pAlloc, pDevice, pDeviceCtx);
+                m_TextureAllocations[TexSlots[i]] = std::move(pAlloc);
+            }
+        }
+        else
         {
-            LoadTexture(pDevice, ResourceDirectory, Mat.SpecularTexture, false, &Mat.pSpecularTexture, &Mat.pSpecularRV, Barriers);
+            std::unordered_set<ITexture*> InitializedTextures;
+            for (size_t i = 0; i < TexPaths.size(); ++i)
+            {
+                const auto MaterialIdx = TexSlots[i] / DXSDKMESH_MATERIAL_TEXTURE_COUNT;
+                const auto Texture     = static_cast<DXSDKMESH_MATERIAL_TEXTURE>(TexSlots[i] % DXSDKMESH_MATERIAL_TEXTURE_COUNT);
+
+                auto* pTexture = Textures[i];
+                if (pTexture == nullptr)
+                {
+                    LOG_ERROR("Failed to load texture ", TexPaths[i]);
+                    continue;
+                }
+
+                auto& Mat = m_pMaterialArray[MaterialIdx];
+
+                ITexture**     ppDstTexture = nullptr;
+                ITextureView** ppDstSRV     = nullptr;
+                switch (Texture)
+                {
+                    // clang-format off
+                    case DXSDKMESH_MATERIAL_TEXTURE_DIFFUSE:  ppDstTexture = &Mat.pDiffuseTexture;  ppDstSRV = &Mat.pDiffuseRV;  break;
+                    case DXSDKMESH_MATERIAL_TEXTURE_NORMAL:   ppDstTexture = &Mat.pNormalTexture;   ppDstSRV = &Mat.pNormalRV;   break;
+                    case DXSDKMESH_MATERIAL_TEXTURE_SPECULAR: ppDstTexture = &Mat.pSpecularTexture; ppDstSRV = &Mat.pSpecularRV; break;
+                    // clang-format on
+                    default:
+                        UNEXPECTED("Unexpected material texture");
+                        pTexture->Release();
+                        continue;
+                }
+
+                // The material takes over the reference returned by CreateTexturesFromFiles
+                *ppDstTexture = pTexture;
+                *ppDstSRV     = pTexture->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+                (*ppDstSRV)->AddRef();
+
+                if (InitializedTextures.insert(pTexture).second)
+                    Barriers.emplace_back(pTexture, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, STATE_TRANSITION_FLAG_UPDATE_STATE);
+            }
         }
     }
 
+    m_VertexBuffers.clear();
+    m_IndexBuffers.clear();
+    m_VertexAllocations.clear();
+    m_IndexAllocations.clear();
     m_VertexBuffers.resize(m_pMeshHeader->NumVertexBuffers);
-    for (Uint32 i = 0; i < m_pMeshHeader->NumVertexBuffers; i++)
+    m_IndexBuffers.resize(m_pMeshHeader->NumIndexBuffers);
+
+    if (pResourceMgr != nullptr)
     {
-        const auto& VBArr = m_pVertexBufferArray[i];
+        // Vertex buffers are placed into the resource manager buffer that corresponds to the
+        // stream slot they are bound to, the same way as GLTF models use VertexBufferIdx.
+        std::vector<Uint32> VBSlots(m_pMeshHeader->NumVertexBuffers, 0);
+        for (Uint32 i = 0; i < m_pMeshHeader->NumMeshes; i++)
+        {
+            const auto& Mesh = m_pMeshArray[i];
+            for (Uint32 Slot = 0; Slot < std::min(Uint32{Mesh.NumVertexBuffers}, Uint32{GLTF::ResourceCacheUseInfo::MaxBuffers}); ++Slot)
+                VBSlots[Mesh.VertexBuffers[Slot]] = Slot;
+        }
 
-        std::stringstream ss;
-        ss << "DXSDK Mesh vertex buffer #" << i;
-        std::string VBName = ss.str();
-        BufferDesc  VBDesc;
-        VBDesc.Name      = VBName.c_str();
-        VBDesc.Usage     = USAGE_IMMUTABLE;
-        VBDesc.Size      = VBArr.NumVertices * VBArr.StrideUint8s;
-        VBDesc.BindFlags = BIND_VERTEX_BUFFER;
+        const auto AllocateAndUpload = [&](Uint32 BufferIdx, const Uint8* pData, Uint64 Size) {
+            auto pAllocation = pResourceMgr->AllocateBufferSpace(BufferIdx, static_cast<Uint32>(Size), 1);
+            if (pAllocation)
+            {
+                auto* pBuffer = pAllocation->GetAllocator()->GetBuffer(pDevice, pDeviceCtx);
+                // The data that does not fit into the free space of the staging buffer is uploaded directly
+                const auto Offset   = pAllocation->GetOffset();
+                const auto Uploaded = pResourceMgr->UploadBufferData(pDeviceCtx, pBuffer, Offset, pData, Size);
+                if (Uploaded < Size)
+                    pDeviceCtx->UpdateBuffer(pBuffer, Offset + Uploaded, static_cast<Uint32>(Size - Uploaded), pData + Uploaded, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+            }
+            return pAllocation;
+        };
 
-        BufferData InitData{GetRawVerticesAt(i), static_cast<Uint32>(VBArr.SizeUint8s)};
-        pDevice->CreateBuffer(VBDesc, &InitData, &m_VertexBuffers[i]);
+        m_VertexAllocations.resize(m_pMeshHeader->NumVertexBuffers);
+        for (Uint32 i = 0; i < m_pMeshHeader->NumVertexBuffers; i++)
+        {
+            m_VertexAllocations[i] = AllocateAndUpload(pCacheInfo->VertexBufferIdx[VBSlots[i]], GetRawVerticesAt(i), m_pVertexBufferArray[i].SizeUint8s);
+            if (!m_VertexAllocations[i])
+                LOG_ERROR("Failed to allocate space for DXSDK Mesh vertex buffer #", i);
+        }
 
-        Barriers.emplace_back(m_VertexBuffers[i], RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_VERTEX_BUFFER, STATE_TRANSITION_FLAG_UPDATE_STATE);
-    }
+        m_IndexAllocations.resize(m_pMeshHeader->NumIndexBuffers);
+        for (Uint32 i = 0; i < m_pMeshHeader->NumIndexBuffers; i++)
+        {
+            m_IndexAllocations[i] = AllocateAndUpload(pCacheInfo->IndexBufferIdx, GetRawIndicesAt(i), m_pIndexBufferArray[i].SizeUint8s);
+            if (!m_IndexAllocations[i])
+                LOG_ERROR("Failed to allocate space for DXSDK Mesh index buffer #", i);
+        }
 
-    // Create IBs
-    m_IndexBuffers.resize(m_pMeshHeader->NumIndexBuffers);
-    for (Uint32 i = 0; i < m_pMeshHeader->NumIndexBuffers; i++)
+        pResourceMgr->FinishStagingUploads(pDeviceCtx);
+    }
+    else
     {
-        const auto& IBArr = m_pIndexBufferArray[i];
+        // Create all VBs and IBs in one pass and transition them together with the textures
+        Barriers.reserve(Barriers.size() + m_VertexBuffers.size() + m_IndexBuffers.size());
 
-        std::stringstream ss;
-        ss << "DXSDK Mesh index buffer #" << i;
-        std::string IBName = ss.str();
+        std::string BufferName;
+        for (Uint32 i = 0; i < m_pMeshHeader->NumVertexBuffers; i++)
+        {
+            const auto& VBArr = m_pVertexBufferArray[i];
 
-        BufferDesc IBDesc;
-        IBDesc.Name      = IBName.c_str();
-        IBDesc.Usage     = USAGE_IMMUTABLE;
-        IBDesc.Size      = IBArr.NumIndices * (IBArr.IndexType == IT_16BIT ? 2 : 4);
-        IBDesc.BindFlags = BIND_INDEX_BUFFER;
+            BufferName = "DXSDK Mesh vertex buffer #" + std::to_string(i);
+            BufferDesc VBDesc;
+            VBDesc.Name      = BufferName.c_str();
+            VBDesc.Usage     = USAGE_IMMUTABLE;
+            VBDesc.Size      = VBArr.NumVertices * VBArr.StrideUint8s;
+            VBDesc.BindFlags = BIND_VERTEX_BUFFER;
 
-        BufferData InitData{GetRawIndicesAt(i), static_cast<Uint32>(IBArr.SizeUint8s)};
-        pDevice->CreateBuffer(IBDesc, &InitData, &m_IndexBuffers[i]);
+            BufferData InitData{GetRawVerticesAt(i), static_cast<Uint32>(VBArr.SizeUint8s)};
+            pDevice->CreateBuffer(VBDesc, &InitData, &m_VertexBuffers[i]);
+
+            Barriers.emplace_back(m_VertexBuffers[i], RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_VERTEX_BUFFER, STATE_TRANSITION_FLAG_UPDATE_STATE);
+        }
+
+        for (Uint32 i = 0; i < m_pMeshHeader->NumIndexBuffers; i++)
+        {
+            const auto& IBArr = m_pIndexBufferArray[i];
 
-        Barriers.emplace_back(m_IndexBuffers[i], RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_INDEX_BUFFER, STATE_TRANSITION_FLAG_UPDATE_STATE);
+            BufferName = "DXSDK Mesh index buffer #" + std::to_string(i);
+            BufferDesc IBDesc;
+            IBDesc.Name      = BufferName.c_str();
+            IBDesc.Usage     = USAGE_IMMUTABLE;
+            IBDesc.Size      = IBArr.NumIndices * (IBArr.IndexType == IT_16BIT ? 2 : 4);
+            IBDesc.BindFlags = BIND_INDEX_BUFFER;
+
+            BufferData InitData{GetRawIndicesAt(i), static_cast<Uint32>(IBArr.SizeUint8s)};
+            pDevice->CreateBuffer(IBDesc, &InitData, &m_IndexBuffers[i]);
+
+            Barriers.emplace_back(m_IndexBuffers[i], RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_INDEX_BUFFER, STATE_TRANSITION_FLAG_UPDATE_STATE);
+        }
     }
 
-    pDeviceCtx->TransitionResourceStates(static_cast<Uint32>(Barriers.size()), Barriers.data());
+    // Buffers and textures that are not suballocated are initialized when they are created, so a transfer
+    // queue context only records the uploads to the resource manager. Immutable resources are not shared with
+    // the transfer queue and are transitioned by the graphics queue when they are first used.
+    const auto QueueType         = pDeviceCtx->GetDesc().QueueType;
+    const bool IsTransferContext = QueueType != COMMAND_QUEUE_TYPE_UNKNOWN && (QueueType & COMMAND_QUEUE_TYPE_GRAPHICS) != COMMAND_QUEUE_TYPE_GRAPHICS;
+    if (!Barriers.empty() && !IsTransferContext)
+        pDeviceCtx->TransitionResourceStates(static_cast<Uint32>(Barriers.size()), Barriers.data());
 }
 
 //--------------------------------------------------------------------------------------
@@ -275,21 +697,27 @@ DXSDKMesh::~DXSDKMesh()
 }
 
 //--------------------------------------------------------------------------------------
-bool DXSDKMesh::Create(const Char* szFileName)
+bool DXSDKMesh::Create(const Char* szFileName, IThreadPool* pThreadPool)
+{
+    return CreateFromFile(szFileName, pThreadPool);
+}
+
+//--------------------------------------------------------------------------------------
+bool DXSDKMesh::Create(Uint8* pData, Uint32 DataUint8s, IThreadPool* pThreadPool)
 {
-    return CreateFromFile(szFileName);
+    return CreateFromMemory(pData, DataUint8s, pThreadPool);
 }
 
 //--------------------------------------------------------------------------------------
-bool DXSDKMesh::Create(Uint8* pData, Uint32 DataUint8s)
+bool DXSDKMesh::Create(IDataBlob* pData, IThreadPool* pThreadPool)
 {
-    return CreateFromMemory(pData, DataUint8s);
+    return CreateFromBlob(pData, pThreadPool);
 }
 
 //--------------------------------------------------------------------------------------
 void DXSDKMesh::Destroy()
 {
-    for (Uint32 i = 0; i < m_pMeshHeader->NumMaterials; i++)
+    for (Uint32 i = 0; m_pMeshHeader != nullptr && i < m_pMeshHeader->NumMaterials; i++)
     {
         auto& Mat = m_pMaterialArray[i];
         if (Mat.pDiffuseTexture)
@@ -313,8 +741,11 @@ void DXSDKMesh::Destroy()
 
     m_VertexBuffers.clear();
     m_IndexBuffers.clear();
+    m_VertexAllocations.clear();
+    m_IndexAllocations.clear();
+    m_TextureAllocations.clear();
 
-    m_StaticMeshData.clear();
+    m_pStaticMeshData.Release();
 
     //delete[] m_pAdjacencyIndexBufferArray; m_pAdjacencyIndexBufferArray = nullptr;
 
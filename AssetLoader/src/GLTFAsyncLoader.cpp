@@ -0,0 +1,153 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFAsyncLoader.hpp"
+#include "ThreadPool.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+RefCntAutoPtr<AsyncModelLoader> AsyncModelLoader::Create(IRenderDevice*         pDevice,
+                                                         IThreadPool*           pThreadPool,
+                                                         const ModelCreateInfo& CI)
+{
+    return RefCntAutoPtr<AsyncModelLoader>{MakeNewRCObj<AsyncModelLoader>()(pDevice, pThreadPool, CI)};
+}
+
+AsyncModelLoader::AsyncModelLoader(IReferenceCounters*    pRefCounters,
+                                   IRenderDevice*         pDevice,
+                                   IThreadPool*           pThreadPool,
+                                   const ModelCreateInfo& CI) :
+    TBase{pRefCounters},
+    m_pDevice{pDevice},
+    m_FileName{CI.FileName != nullptr ? CI.FileName : ""},
+    m_CI{CI}
+{
+    DEV_CHECK_ERR(pDevice != nullptr, "Render device must not be null");
+    DEV_CHECK_ERR(pThreadPool != nullptr, "Thread pool must not be null");
+
+    m_CI.FileName    = m_FileName.c_str();
+    m_CI.pThreadPool = nullptr;
+    if (m_CI.BakedFileName != nullptr)
+    {
+        LOG_WARNING_MESSAGE("Asynchronous model loader does not support baking. BakedFileName is ignored.");
+        m_CI.BakedFileName = nullptr;
+    }
+    if (m_CI.pLoadProgress == nullptr)
+        m_CI.pLoadProgress = &m_Progress;
+    m_pProgress = m_CI.pLoadProgress;
+
+    m_pModel = std::make_unique<Model>(m_CI);
+
+    // Note that the worker thread does not wait for any other tasks in the pool,
+    // so the loader can't deadlock even if the pool has a single thread.
+    m_pTask = EnqueueAsyncWork(pThreadPool, [this](Uint32 ThreadId) {
+        LoadModel();
+    });
+}
+
+AsyncModelLoader::~AsyncModelLoader()
+{
+    Cancel();
+    if (m_pTask)
+        m_pTask->WaitForCompletion();
+}
+
+void AsyncModelLoader::LoadModel()
+{
+    try
+    {
+        m_pModel->BeginLoading(m_CI, /*DeferImageDecoding = */ true);
+        m_pModel->LoadGeometry(m_pDevice, m_CI);
+        m_GeometryLoaded.store(true);
+
+        m_pModel->PrepareTextures(nullptr);
+        m_TexturesPrepared.store(true);
+    }
+    catch (...)
+    {
+        m_pProgress->Stage.store(m_pProgress->CancelRequested.load() ? MODEL_LOAD_STAGE_CANCELLED : MODEL_LOAD_STAGE_FAILED);
+    }
+    m_WorkerFinished.store(true);
+}
+
+bool AsyncModelLoader::Update(IDeviceContext* pContext, Uint64 MaxUploadSize)
+{
+    if (!m_WorkerFinished.load() && !m_GeometryLoaded.load())
+        return false;
+
+    if (m_pModel->IsGPUDataInitialized())
+        return true;
+
+    const auto Stage = GetStage();
+    if (Stage == MODEL_LOAD_STAGE_CANCELLED || Stage == MODEL_LOAD_STAGE_FAILED)
+    {
+        // Do not release the loading state while the worker may still be using it
+        if (m_WorkerFinished.load())
+            m_pModel->EndLoading();
+        return m_WorkerFinished.load();
+    }
+
+    if (!m_GeometryUploaded)
+    {
+        // Upload geometry before any texture is committed so that
+        // the model can be rendered as soon as possible.
+        m_GeometryUploaded = m_pModel->InitializePendingGPUData(m_pDevice, pContext, MaxUploadSize) == 0;
+        return false;
+    }
+
+    // Read the flag before the number of prepared textures to make sure
+    // that all textures are committed when the flag is set.
+    const bool TexturesPrepared = m_TexturesPrepared.load();
+
+    m_pModel->CommitTextures(m_pDevice, m_pModel->GetNumPreparedTextures());
+
+    const auto NumPendingResources = m_pModel->InitializePendingGPUData(m_pDevice, pContext, MaxUploadSize);
+
+    if (!TexturesPrepared || !m_WorkerFinished.load())
+        return false;
+
+    if (NumPendingResources > 0)
+    {
+        // All textures have been prepared, only GPU upload remains
+        m_pProgress->Stage.store(MODEL_LOAD_STAGE_GPU_UPLOAD);
+        return false;
+    }
+
+    m_pModel->EndLoading();
+    m_pModel->GPUDataInitialized.store(true);
+    m_pProgress->Stage.store(MODEL_LOAD_STAGE_COMPLETE);
+
+    return true;
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -0,0 +1,301 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFBVH.hpp"
+
+#include <numeric>
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+namespace
+{
+
+// The number of bins used to evaluate the surface area heuristic along each axis
+static constexpr Uint32 NumSAHBins = 16;
+
+// The cost of traversing an inner node relative to the cost of testing an item
+static constexpr float TraversalCost = 1.f;
+
+float SurfaceArea(const float3& Min, const float3& Max)
+{
+    const float3 d = Max - Min;
+    return 2.f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+struct SAHBin
+{
+    float3 Min{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+    float3 Max{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    Uint32 Count = 0;
+
+    void Grow(const float3& BoxMin, const float3& BoxMax)
+    {
+        Min = std::min(Min, BoxMin);
+        Max = std::max(Max, BoxMax);
+    }
+};
+
+} // namespace
+
+void BoundingVolumeHierarchy::Clear()
+{
+    m_Nodes.clear();
+    m_Items.clear();
+}
+
+void BoundingVolumeHierarchy::Build(const BoundBox* pBoxes, Uint32 NumBoxes, Uint32 MaxLeafSize)
+{
+    Clear();
+    if (NumBoxes == 0)
+        return;
+
+    MaxLeafSize = std::max(MaxLeafSize, Uint32{1});
+
+    std::vector<float3> Centroids(NumBoxes);
+    for (Uint32 i = 0; i < NumBoxes; ++i)
+        Centroids[i] = (pBoxes[i].Min + pBoxes[i].Max) * 0.5f;
+
+    m_Items.resize(NumBoxes);
+    std::iota(m_Items.begin(), m_Items.end(), Uint32{0});
+
+    // A binary tree with N leaves has at most 2N - 1 nodes
+    m_Nodes.reserve(size_t{NumBoxes} * 2 - 1);
+    m_Nodes.emplace_back();
+
+    struct BuildTask
+    {
+        Uint32 NodeIdx;
+        Uint32 FirstItem;
+        Uint32 NumItems;
+        Uint32 Depth;
+    };
+    std::vector<BuildTask> Tasks;
+    Tasks.push_back({0, 0, NumBoxes, 0});
+    while (!Tasks.empty())
+    {
+        const auto Task = Tasks.back();
+        Tasks.pop_back();
+
+        auto* const pFirst = m_Items.data() + Task.FirstItem;
+        auto* const pLast  = pFirst + Task.NumItems;
+
+        float3 Min{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+        float3 Max{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        float3 CentroidMin = Min;
+        float3 CentroidMax = Max;
+        for (const auto* pItem = pFirst; pItem != pLast; ++pItem)
+        {
+            Min         = std::min(Min, pBoxes[*pItem].Min);
+            Max         = std::max(Max, pBoxes[*pItem].Max);
+            CentroidMin = std::min(CentroidMin, Centroids[*pItem]);
+            CentroidMax = std::max(CentroidMax, Centroids[*pItem]);
+        }
+        m_Nodes[Task.NodeIdx].Min = Min;
+        m_Nodes[Task.NodeIdx].Max = Max;
+
+        // The traversal stack holds at most one node per level
+        const bool CanSplit = Task.NumItems > 1 && Task.Depth + 1 < MaxDepth;
+
+        // Find the split with the lowest surface area heuristic cost
+        int    BestAxis  = -1;
+        Uint32 BestSplit = 0;
+        float  BestCost  = +FLT_MAX;
+        if (CanSplit)
+        {
+            const float InvParentArea = 1.f / std::max(SurfaceArea(Min, Max), FLT_MIN);
+            for (int Axis = 0; Axis < 3; ++Axis)
+            {
+                const float Extent = CentroidMax[Axis] - CentroidMin[Axis];
+                if (Extent <= 0)
+                    continue;
+
+                const float Scale = NumSAHBins / Extent;
+
+                SAHBin Bins[NumSAHBins];
+                for (const auto* pItem = pFirst; pItem != pLast; ++pItem)
+                {
+                    const auto Bin = std::min(static_cast<Uint32>((Centroids[*pItem][Axis] - CentroidMin[Axis]) * Scale), NumSAHBins - 1);
+                    Bins[Bin].Grow(pBoxes[*pItem].Min, pBoxes[*pItem].Max);
+                    ++Bins[Bin].Count;
+                }
+
+                // Areas and counts of the right sides of the splits after every bin
+                float  RightArea[NumSAHBins - 1];
+                Uint32 RightCount[NumSAHBins - 1];
+                SAHBin Right;
+                for (Uint32 b = NumSAHBins - 1; b > 0; --b)
+                {
+                    Right.Grow(Bins[b].Min, Bins[b].Max);
+                    Right.Count += Bins[b].Count;
+                    RightArea[b - 1]  = Right.Count > 0 ? SurfaceArea(Right.Min, Right.Max) : 0.f;
+                    RightCount[b - 1] = Right.Count;
+                }
+
+                SAHBin Left;
+                for (Uint32 b = 0; b < NumSAHBins - 1; ++b)
+                {
+                    Left.Grow(Bins[b].Min, Bins[b].Max);
+                    Left.Count += Bins[b].Count;
+                    if (Left.Count == 0 || RightCount[b] == 0)
+                        continue;
+
+                    const float Cost = TraversalCost + (SurfaceArea(Left.Min, Left.Max) * Left.Count + RightArea[b] * RightCount[b]) * InvParentArea;
+                    if (Cost < BestCost)
+                    {
+                        BestAxis  = Axis;
+                        BestSplit = b;
+                        BestCost  = Cost;
+                    }
+                }
+            }
+        }
+
+        // Keep the items in a leaf if splitting is not expected to pay off
+        if (!CanSplit || (Task.NumItems <= MaxLeafSize && BestCost >= static_cast<float>(Task.NumItems)))
+        {
+            m_Nodes[Task.NodeIdx].FirstChildOrItem = Task.FirstItem;
+            m_Nodes[Task.NodeIdx].NumItems         = Task.NumItems;
+            continue;
+        }
+
+        Uint32* pMid = nullptr;
+        if (BestAxis >= 0)
+        {
+            const float Scale = NumSAHBins / (CentroidMax[BestAxis] - CentroidMin[BestAxis]);
+
+            pMid = std::partition(pFirst, pLast, [&](Uint32 Item) {
+                const auto Bin = std::min(static_cast<Uint32>((Centroids[Item][BestAxis] - CentroidMin[BestAxis]) * Scale), NumSAHBins - 1);
+                return Bin <= BestSplit;
+            });
+        }
+        else
+        {
+            // All centroids coincide: split the items in half
+            pMid = pFirst + Task.NumItems / 2;
+        }
+        VERIFY_EXPR(pMid != pFirst && pMid != pLast);
+
+        const auto NumLeftItems = static_cast<Uint32>(pMid - pFirst);
+        const auto FirstChild   = static_cast<Uint32>(m_Nodes.size());
+        m_Nodes.emplace_back();
+        m_Nodes.emplace_back();
+        m_Nodes[Task.NodeIdx].FirstChildOrItem = FirstChild;
+        m_Nodes[Task.NodeIdx].NumItems         = 0;
+
+        Tasks.push_back({FirstChild, Task.FirstItem, NumLeftItems, Task.Depth + 1});
+        Tasks.push_back({FirstChild + 1, Task.FirstItem + NumLeftItems, Task.NumItems - NumLeftItems, Task.Depth + 1});
+    }
+}
+
+void BoundingVolumeHierarchy::Refit(const BoundBox* pBoxes)
+{
+    // Children are always stored after their parents
+    for (size_t i = m_Nodes.size(); i-- > 0;)
+    {
+        auto& N = m_Nodes[i];
+        if (N.IsLeaf())
+        {
+            N.Min = float3{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+            N.Max = float3{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+            for (Uint32 j = 0; j < N.NumItems; ++j)
+            {
+                const auto& Box = pBoxes[m_Items[N.FirstChildOrItem + j]];
+                N.Min           = std::min(N.Min, Box.Min);
+                N.Max           = std::max(N.Max, Box.Max);
+            }
+        }
+        else
+        {
+            const auto& Child0 = m_Nodes[N.FirstChildOrItem];
+            const auto& Child1 = m_Nodes[N.FirstChildOrItem + 1];
+            N.Min              = std::min(Child0.Min, Child1.Min);
+            N.Max              = std::max(Child0.Max, Child1.Max);
+        }
+    }
+}
+
+void MeshBVH::Build(Uint32 MaxLeafSize)
+{
+    std::vector<BoundBox> TriangleBoxes(Triangles.size());
+    for (size_t i = 0; i < Triangles.size(); ++i)
+    {
+        const auto& Tri = Triangles[i];
+        const auto& V0  = Positions[Tri.Vertices[0]];
+        const auto& V1  = Positions[Tri.Vertices[1]];
+        const auto& V2  = Positions[Tri.Vertices[2]];
+
+        TriangleBoxes[i].Min = std::min(std::min(V0, V1), V2);
+        TriangleBoxes[i].Max = std::max(std::max(V0, V1), V2);
+    }
+    BVH.Build(TriangleBoxes.data(), static_cast<Uint32>(TriangleBoxes.size()), MaxLeafSize);
+}
+
+bool MeshBVH::RayCast(const float3& Origin, const float3& Direction, float& MaxT, Uint32& HitTriangle, float2& Barycentrics) const
+{
+    bool Hit = false;
+    BVH.RayCast(Origin, Direction, MaxT, [&](Uint32 TriIdx, float& t) {
+        const auto& Tri = Triangles[TriIdx];
+        const auto& V0  = Positions[Tri.Vertices[0]];
+
+        // Moller-Trumbore ray-triangle intersection
+        const float3 E1  = Positions[Tri.Vertices[1]] - V0;
+        const float3 E2  = Positions[Tri.Vertices[2]] - V0;
+        const float3 P   = cross(Direction, E2);
+        const float  Det = dot(E1, P);
+        if (Det == 0)
+            return;
+
+        const float  InvDet = 1.f / Det;
+        const float3 S      = Origin - V0;
+        const float  u      = dot(S, P) * InvDet;
+        if (u < 0 || u > 1)
+            return;
+
+        const float3 Q = cross(S, E1);
+        const float  v = dot(Direction, Q) * InvDet;
+        if (v < 0 || u + v > 1)
+            return;
+
+        const float Dist = dot(E2, Q) * InvDet;
+        if (Dist < 0 || Dist >= t)
+            return;
+
+        t            = Dist;
+        HitTriangle  = TriIdx;
+        Barycentrics = float2{u, v};
+        Hit          = true;
+    });
+    return Hit;
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
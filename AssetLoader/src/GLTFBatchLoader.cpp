@@ -0,0 +1,436 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFBatchLoader.hpp"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "AsyncFileReader.hpp"
+#include "FileSystem.hpp"
+#include "ThreadPool.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+// Has access to the loading steps of the models, see Model::BeginLoading().
+class ModelBatchLoader
+{
+public:
+    ModelBatchLoader(IRenderDevice*         pDevice,
+                     IThreadPool*           pThreadPool,
+                     const ModelCreateInfo* pCIs,
+                     Uint32                 NumModels);
+
+    std::vector<std::unique_ptr<Model>> Load(IDeviceContext* pContext, ModelBatchLoadStats& Stats);
+
+private:
+    // Runs Func for every model that has not failed and waits for all of them.
+    // The models are marked as failed if Func throws.
+    template <typename FuncType>
+    void RunParallel(FuncType&& Func);
+
+    // Reads the model files asynchronously and starts parsing every model as soon as its file has been read
+    void ParseModels();
+
+    void SetFailed(size_t ModelIdx);
+
+    // Releases the encoded data of the images that are also used by the models
+    // that precede the model in the batch.
+    void DeduplicateImages(ModelBatchLoadStats& Stats);
+
+    bool ReadSharedFile(const char* FilePath, std::vector<unsigned char>& Data, std::string& Error);
+
+private:
+    RefCntAutoPtr<IRenderDevice> m_pDevice;
+    IThreadPool* const           m_pThreadPool;
+
+    std::vector<ModelCreateInfo>        m_CIs;
+    std::vector<std::unique_ptr<Model>> m_Models;
+    std::unique_ptr<bool[]>             m_Failed;
+    std::unique_ptr<bool[]>             m_UsesCustomReader;
+
+    // Texture cache shared by the models that use neither a texture cache nor a resource manager
+    TextureCacheType m_TextureCache;
+
+    struct SharedFile
+    {
+        std::mutex                 Mtx;
+        bool                       Loaded     = false;
+        bool                       Prefetched = false; // The data has been read by ParseModels() and not yet used
+        std::vector<unsigned char> Data;
+        std::string                Error;
+    };
+    std::shared_ptr<SharedFile> GetSharedFile(const char* FilePath);
+
+    std::mutex                                                   m_SharedFilesMtx;
+    std::unordered_map<std::string, std::shared_ptr<SharedFile>> m_SharedFiles;
+    std::atomic<Uint32>                                          m_NumSharedFileReads{0};
+
+    // Files read by the default file reader go through the I/O threads, which keeps many reads in flight
+    AsyncFileReader m_FileReader;
+};
+
+ModelBatchLoader::ModelBatchLoader(IRenderDevice*         pDevice,
+                                   IThreadPool*           pThreadPool,
+                                   const ModelCreateInfo* pCIs,
+                                   Uint32                 NumModels) :
+    m_pDevice{pDevice},
+    m_pThreadPool{pThreadPool},
+    m_CIs{pCIs, pCIs + NumModels},
+    m_Failed{new bool[NumModels]{}},
+    m_UsesCustomReader{new bool[NumModels]{}}
+{
+    m_Models.reserve(NumModels);
+    for (auto& CI : m_CIs)
+    {
+        // Models are loaded in parallel with each other, and the tasks must not wait for other tasks in the pool
+        CI.pThreadPool = nullptr;
+        if (CI.BakedFileName != nullptr)
+        {
+            LOG_WARNING_MESSAGE("Batch model loading does not support baking. BakedFileName is ignored.");
+            CI.BakedFileName = nullptr;
+        }
+
+        const bool UsesResourceMgr = CI.pCacheInfo != nullptr && CI.pCacheInfo->pResourceMgr != nullptr;
+        if (CI.pTextureCache == nullptr && !UsesResourceMgr)
+            CI.pTextureCache = &m_TextureCache;
+
+        m_UsesCustomReader[m_Models.size()] = CI.ReadWholeFileCallback != nullptr;
+        if (!CI.ReadWholeFileCallback)
+        {
+            CI.ReadWholeFileCallback = [this](const char* FilePath, std::vector<unsigned char>& Data, std::string& Error) {
+                return ReadSharedFile(FilePath, Data, Error);
+            };
+        }
+
+        m_Models.emplace_back(std::make_unique<Model>(CI));
+    }
+}
+
+std::shared_ptr<ModelBatchLoader::SharedFile> ModelBatchLoader::GetSharedFile(const char* FilePath)
+{
+    std::lock_guard<std::mutex> Lock{m_SharedFilesMtx};
+
+    auto& pEntry = m_SharedFiles[FileSystem::SimplifyPath(FilePath)];
+    if (!pEntry)
+        pEntry = std::make_shared<SharedFile>();
+    return pEntry;
+}
+
+bool ModelBatchLoader::ReadSharedFile(const char* FilePath, std::vector<unsigned char>& Data, std::string& Error)
+{
+    auto pFile = GetSharedFile(FilePath);
+
+    // The first thread that requests the file reads it, while the others wait for the data
+    std::lock_guard<std::mutex> Lock{pFile->Mtx};
+    if (pFile->Prefetched)
+    {
+        pFile->Prefetched = false;
+    }
+    else if (pFile->Loaded)
+    {
+        m_NumSharedFileReads.fetch_add(1);
+    }
+    else
+    {
+        pFile->Loaded = true;
+        if (m_FileReader.ReadWholeFile(FilePath, pFile->Data, pFile->Error) && pFile->Data.empty())
+            pFile->Error = FormatString("File is empty: ", FilePath, "\n");
+    }
+
+    if (!pFile->Error.empty())
+    {
+        Error += pFile->Error;
+        return false;
+    }
+
+    Data = pFile->Data;
+    return true;
+}
+
+void ModelBatchLoader::SetFailed(size_t ModelIdx)
+{
+    m_Failed[ModelIdx] = true;
+    if (auto* pProgress = m_CIs[ModelIdx].pLoadProgress)
+        pProgress->Stage.store(pProgress->CancelRequested.load() ? MODEL_LOAD_STAGE_CANCELLED : MODEL_LOAD_STAGE_FAILED);
+}
+
+template <typename FuncType>
+void ModelBatchLoader::RunParallel(FuncType&& Func)
+{
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    Tasks.reserve(m_Models.size());
+    for (size_t i = 0; i < m_Models.size(); ++i)
+    {
+        if (m_Failed[i])
+            continue;
+
+        // Every model is only accessed by one task, and the failed flags of different models do not alias
+        Tasks.emplace_back(EnqueueAsyncWork(m_pThreadPool, [this, &Func, i](Uint32 ThreadId) {
+            try
+            {
+                Func(*m_Models[i], m_CIs[i]);
+            }
+            catch (...)
+            {
+                SetFailed(i);
+            }
+        }));
+    }
+
+    for (auto& pTask : Tasks)
+        pTask->WaitForCompletion();
+}
+
+void ModelBatchLoader::ParseModels()
+{
+    std::mutex                             TasksMtx;
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+
+    auto EnqueueParseTask = [&](size_t ModelIdx) {
+        auto pTask = EnqueueAsyncWork(m_pThreadPool, [this, ModelIdx](Uint32 ThreadId) {
+            try
+            {
+                auto&       M  = *m_Models[ModelIdx];
+                const auto& CI = m_CIs[ModelIdx];
+                M.BeginLoading(CI, /*DeferImageDecoding = */ true);
+                M.LoadGeometry(m_pDevice, CI);
+            }
+            catch (...)
+            {
+                SetFailed(ModelIdx);
+            }
+        });
+
+        std::lock_guard<std::mutex> Lock{TasksMtx};
+        Tasks.emplace_back(std::move(pTask));
+    };
+
+    // Models that reference the same file are parsed once the file has been read
+    std::unordered_map<std::string, std::vector<size_t>> PendingFiles;
+    for (size_t i = 0; i < m_Models.size(); ++i)
+    {
+        const auto& CI = m_CIs[i];
+        if (m_Failed[i] || m_UsesCustomReader[i] || CI.FileName == nullptr || *CI.FileName == '\0')
+        {
+            // Errors are reported by Model::BeginLoading()
+            if (!m_Failed[i])
+                EnqueueParseTask(i);
+            continue;
+        }
+        PendingFiles[FileSystem::SimplifyPath(CI.FileName)].push_back(i);
+    }
+
+    // PendingFiles is not modified while the reads are in flight
+    for (const auto& it : PendingFiles)
+    {
+        const auto& ModelIds = it.second;
+        auto        pFile    = GetSharedFile(m_CIs[ModelIds.front()].FileName);
+        m_FileReader.Read(m_CIs[ModelIds.front()].FileName,
+                          [&EnqueueParseTask, &ModelIds, pFile](const char* FilePath, std::vector<unsigned char>& Data, const std::string& Error) {
+                              {
+                                  // If the lock is taken, the file is being read by another model that references it
+                                  // as a buffer or image. Waiting for it could block the I/O thread that the other model
+                                  // waits for, so the data is discarded instead.
+                                  std::unique_lock<std::mutex> Lock{pFile->Mtx, std::try_to_lock};
+                                  if (Lock && !pFile->Loaded)
+                                  {
+                                      pFile->Loaded     = true;
+                                      pFile->Prefetched = true;
+                                      pFile->Data       = std::move(Data);
+                                      pFile->Error      = Error;
+                                      if (Error.empty() && pFile->Data.empty())
+                                          pFile->Error = FormatString("File is empty: ", FilePath, "\n");
+                                  }
+                              }
+
+                              for (auto ModelIdx : ModelIds)
+                                  EnqueueParseTask(ModelIdx);
+                          });
+    }
+
+    // All parse tasks have been enqueued once the reader is idle
+    m_FileReader.WaitForIdle();
+    for (auto& pTask : Tasks)
+        pTask->WaitForCompletion();
+}
+
+void ModelBatchLoader::DeduplicateImages(ModelBatchLoadStats& Stats)
+{
+    // Images are only shared between the models that use the same texture cache or resource manager.
+    // For every cache, maps the image cache id to the index of the model that decodes the image.
+    std::unordered_map<const void*, std::unordered_map<std::string, size_t>> ImageOwners;
+
+    std::vector<std::string> CacheIds;
+    for (size_t i = 0; i < m_Models.size(); ++i)
+    {
+        if (m_Failed[i])
+            continue;
+
+        const auto& CI     = m_CIs[i];
+        const void* pCache = CI.pCacheInfo != nullptr && CI.pCacheInfo->pResourceMgr != nullptr ?
+            static_cast<const void*>(CI.pCacheInfo->pResourceMgr) :
+            static_cast<const void*>(CI.pTextureCache);
+
+        auto& Owners = ImageOwners[pCache];
+        m_Models[i]->GetPendingImageCacheIds(CacheIds);
+        for (Uint32 ImageIdx = 0; ImageIdx < CacheIds.size(); ++ImageIdx)
+        {
+            const auto& CacheId = CacheIds[ImageIdx];
+            if (CacheId.empty())
+                continue;
+
+            const auto it = Owners.emplace(CacheId, i).first;
+            if (it->second != i)
+            {
+                // The texture will be found in the cache when the model is committed
+                m_Models[i]->ReleasePendingImage(ImageIdx);
+                ++Stats.NumSharedImages;
+            }
+        }
+    }
+}
+
+std::vector<std::unique_ptr<Model>> ModelBatchLoader::Load(IDeviceContext* pContext, ModelBatchLoadStats& Stats)
+{
+    // Parse the files and convert the geometry
+    ParseModels();
+
+    {
+        std::lock_guard<std::mutex> Lock{m_SharedFilesMtx};
+        m_SharedFiles.clear();
+    }
+    Stats.NumSharedFileReads = m_NumSharedFileReads.load();
+
+    DeduplicateImages(Stats);
+
+    // Decode the images and prepare texture data
+    RunParallel([](Model& M, const ModelCreateInfo& CI) {
+        M.PrepareTextures(nullptr);
+    });
+
+    // Create the textures in the order of the models, so that the models that decode
+    // shared images add their textures to the cache before the other models look them up.
+    for (size_t i = 0; i < m_Models.size(); ++i)
+    {
+        auto& M = *m_Models[i];
+        if (!m_Failed[i])
+        {
+            try
+            {
+                M.CommitTextures(m_pDevice, M.GetNumPreparedTextures());
+            }
+            catch (...)
+            {
+                SetFailed(i);
+            }
+        }
+        M.EndLoading();
+    }
+
+    if (pContext != nullptr)
+    {
+        // Record the uploads of all models and submit them at once
+        std::unordered_set<ResourceManager*> ResourceMgrs;
+        for (size_t i = 0; i < m_Models.size(); ++i)
+        {
+            if (m_Failed[i])
+                continue;
+
+            auto& M = *m_Models[i];
+            if (auto* pProgress = m_CIs[i].pLoadProgress)
+            {
+                pProgress->NumItems.store(1);
+                pProgress->NumItemsProcessed.store(0);
+                pProgress->Stage.store(MODEL_LOAD_STAGE_GPU_UPLOAD);
+            }
+
+            if (M.InitializePendingGPUData(m_pDevice, pContext, ~Uint64{0}) == 0)
+                M.GPUDataInitialized.store(true);
+            if (M.m_pResourceMgr)
+                ResourceMgrs.insert(M.m_pResourceMgr.RawPtr());
+        }
+
+        for (auto* pResourceMgr : ResourceMgrs)
+            pResourceMgr->FinishStagingUploads(pContext);
+
+        pContext->Flush();
+    }
+
+    for (size_t i = 0; i < m_Models.size(); ++i)
+    {
+        if (m_Failed[i])
+        {
+            m_Models[i].reset();
+            ++Stats.NumFailedModels;
+            continue;
+        }
+
+        if (auto* pProgress = m_CIs[i].pLoadProgress)
+        {
+            pProgress->NumItems.store(0);
+            pProgress->NumItemsProcessed.store(0);
+            pProgress->Stage.store(MODEL_LOAD_STAGE_COMPLETE);
+        }
+        ++Stats.NumLoadedModels;
+    }
+
+    return std::move(m_Models);
+}
+
+std::vector<std::unique_ptr<Model>> LoadModels(IRenderDevice*         pDevice,
+                                               IDeviceContext*        pContext,
+                                               IThreadPool*           pThreadPool,
+                                               const ModelCreateInfo* pCIs,
+                                               Uint32                 NumModels,
+                                               ModelBatchLoadStats*   pStats)
+{
+    DEV_CHECK_ERR(pDevice != nullptr, "Render device must not be null");
+    DEV_CHECK_ERR(pThreadPool != nullptr, "Thread pool must not be null");
+    DEV_CHECK_ERR(pCIs != nullptr || NumModels == 0, "Model create infos must not be null");
+
+    ModelBatchLoadStats Stats;
+
+    std::vector<std::unique_ptr<Model>> Models;
+    if (NumModels > 0)
+        Models = ModelBatchLoader{pDevice, pThreadPool, pCIs, NumModels}.Load(pContext, Stats);
+
+    if (pStats != nullptr)
+        *pStats = Stats;
+
+    return Models;
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
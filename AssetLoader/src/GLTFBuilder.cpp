@@ -25,9 +25,30 @@
  */
 
 #include "GLTFBuilder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <type_traits>
+
 #include "GLTFLoader.hpp"
 #include "GraphicsAccessories.hpp"
-#include "DataBlobImpl.hpp"
+#include "DataBlob.h"
+#include "ObjectBase.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define GLTF_BUILDER_USE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#    include <arm_neon.h>
+#    define GLTF_BUILDER_USE_NEON 1
+#endif
 
 namespace Diligent
 {
@@ -64,6 +85,24 @@ size_t ModelBuilder::ConvertedBufferViewKey::Hasher::operator()(const ConvertedB
 }
 
 
+// The number of components is a compile-time constant, so that the compiler
+// can unroll the inner loop and vectorize the conversion.
+template <typename SrcType, typename DstType, Uint32 NumComponents>
+inline void WriteGltfComponents(const Uint8* pSrc,
+                                Uint32       SrcElemStride,
+                                Uint8*       pDst,
+                                Uint32       DstElementStride,
+                                Uint32       NumElements)
+{
+    for (size_t elem = 0; elem < NumElements; ++elem)
+    {
+        const auto* pSrcCmp = reinterpret_cast<const SrcType*>(pSrc + size_t{SrcElemStride} * elem);
+        auto*       pDstCmp = reinterpret_cast<DstType*>(pDst + size_t{DstElementStride} * elem);
+        for (Uint32 cmp = 0; cmp < NumComponents; ++cmp)
+            pDstCmp[cmp] = static_cast<DstType>(pSrcCmp[cmp]);
+    }
+}
+
 template <typename SrcType, typename DstType>
 inline void WriteGltfData(const void*                  pSrc,
                           Uint32                       NumComponents,
@@ -72,20 +111,31 @@ inline void WriteGltfData(const void*                  pSrc,
                           Uint32                       DstElementStride,
                           Uint32                       NumElements)
 {
-    for (size_t elem = 0; elem < NumElements; ++elem)
+    const auto* pSrcBytes = static_cast<const Uint8*>(pSrc);
+    auto* const pDstBytes = &*dst_it;
+    switch (NumComponents)
     {
-        const auto* pSrcCmp = reinterpret_cast<const SrcType*>(static_cast<const Uint8*>(pSrc) + SrcElemStride * elem);
+        // clang-format off
+        case 1: WriteGltfComponents<SrcType, DstType, 1>(pSrcBytes, SrcElemStride, pDstBytes, DstElementStride, NumElements); break;
+        case 2: WriteGltfComponents<SrcType, DstType, 2>(pSrcBytes, SrcElemStride, pDstBytes, DstElementStride, NumElements); break;
+        case 3: WriteGltfComponents<SrcType, DstType, 3>(pSrcBytes, SrcElemStride, pDstBytes, DstElementStride, NumElements); break;
+        case 4: WriteGltfComponents<SrcType, DstType, 4>(pSrcBytes, SrcElemStride, pDstBytes, DstElementStride, NumElements); break;
+        // clang-format on
 
-        auto comp_it = dst_it + DstElementStride * elem;
-        for (Uint32 cmp = 0; cmp < NumComponents; ++cmp, comp_it += sizeof(DstType))
-        {
-            reinterpret_cast<DstType&>(*comp_it) = static_cast<DstType>(pSrcCmp[cmp]);
-        }
+        default:
+            for (size_t elem = 0; elem < NumElements; ++elem)
+            {
+                const auto* pSrcCmp = reinterpret_cast<const SrcType*>(pSrcBytes + size_t{SrcElemStride} * elem);
+                auto*       pDstCmp = reinterpret_cast<DstType*>(pDstBytes + size_t{DstElementStride} * elem);
+                for (Uint32 cmp = 0; cmp < NumComponents; ++cmp)
+                    pDstCmp[cmp] = static_cast<DstType>(pSrcCmp[cmp]);
+            }
     }
 }
 
 void ModelBuilder::WriteGltfData(const void*                  pSrc,
                                  VALUE_TYPE                   SrcType,
+                                 bool                         SrcNormalized,
                                  Uint32                       NumSrcComponents,
                                  Uint32                       SrcElemStride,
                                  std::vector<Uint8>::iterator dst_it,
@@ -95,6 +145,44 @@ void ModelBuilder::WriteGltfData(const void*                  pSrc,
                                  Uint32                       NumElements)
 {
     const auto NumComponentsToCopy = std::min(NumSrcComponents, NumDstComponents);
+    if (NumElements == 0)
+        return;
+
+    if (SrcType == DstType)
+    {
+        // Source data already has the required type - copy the components without conversion
+        const auto  ElementSize = size_t{GetValueSize(SrcType)} * NumComponentsToCopy;
+        const auto* pSrcBytes   = static_cast<const Uint8*>(pSrc);
+        auto* const pDstBytes   = &*dst_it;
+        if (ElementSize == SrcElemStride && ElementSize == DstElementStride)
+        {
+            // Tightly packed data
+            memcpy(pDstBytes, pSrcBytes, ElementSize * NumElements);
+        }
+        else
+        {
+            for (size_t elem = 0; elem < NumElements; ++elem)
+                memcpy(pDstBytes + size_t{DstElementStride} * elem, pSrcBytes + size_t{SrcElemStride} * elem, ElementSize);
+        }
+        return;
+    }
+
+    if (SrcNormalized && DstType == VT_FLOAT32)
+    {
+        // Quantized source data (KHR_mesh_quantization) must be converted to the [0, 1] or [-1, 1] range
+        const auto SrcComponentSize = GetValueSize(SrcType);
+        for (size_t elem = 0; elem < NumElements; ++elem)
+        {
+            const auto* pSrcElem = static_cast<const Uint8*>(pSrc) + size_t{SrcElemStride} * elem;
+            auto*       pDstElem = &*(dst_it + size_t{DstElementStride} * elem);
+            for (Uint32 cmp = 0; cmp < NumComponentsToCopy; ++cmp)
+            {
+                const auto Value = ReadGltfValue(pSrcElem + SrcComponentSize * cmp, SrcType, true);
+                memcpy(pDstElem + sizeof(float) * cmp, &Value, sizeof(float));
+            }
+        }
+        return;
+    }
 
 #define INNER_CASE(SrcType, DstType)                                                          \
     case DstType:                                                                             \
@@ -140,59 +228,2144 @@ void ModelBuilder::WriteGltfData(const void*                  pSrc,
 }
 
 
-void ModelBuilder::InitBuffers(IRenderDevice* pDevice, IDeviceContext* pContext)
+namespace
 {
-    auto& Buffers = m_Model.Buffers;
-    for (Uint32 BuffId = 0; BuffId < Buffers.size(); ++BuffId)
+
+// Converts the first indices of a tightly packed array with SIMD instructions
+// and returns the number of converted indices. The rest are converted by WriteIndices().
+template <typename SrcType, typename DstType>
+Uint32 WriteIndicesSIMD(const SrcType*, DstType*, Uint32, Uint32)
+{
+    return 0;
+}
+
+#if GLTF_BUILDER_USE_SSE2
+
+template <>
+Uint32 WriteIndicesSIMD<Uint8, Uint32>(const Uint8* pSrc, Uint32* pDst, Uint32 NumElements, Uint32 BaseVertex)
+{
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i Base = _mm_set1_epi32(static_cast<int>(BaseVertex));
+
+    Uint32 i = 0;
+    for (; i + 16 <= NumElements; i += 16)
     {
-        const auto IsIndexBuff = (BuffId == Buffers.size() - 1);
+        const __m128i Src8   = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+        const __m128i Src16L = _mm_unpacklo_epi8(Src8, Zero);
+        const __m128i Src16H = _mm_unpackhi_epi8(Src8, Zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i + 0), _mm_add_epi32(_mm_unpacklo_epi16(Src16L, Zero), Base));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i + 4), _mm_add_epi32(_mm_unpackhi_epi16(Src16L, Zero), Base));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i + 8), _mm_add_epi32(_mm_unpacklo_epi16(Src16H, Zero), Base));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i + 12), _mm_add_epi32(_mm_unpackhi_epi16(Src16H, Zero), Base));
+    }
+    return i;
+}
 
-        const auto& Data = IsIndexBuff ? m_IndexData : m_VertexData[BuffId];
-        if (Data.empty())
-            continue;
+template <>
+Uint32 WriteIndicesSIMD<Uint8, Uint16>(const Uint8* pSrc, Uint16* pDst, Uint32 NumElements, Uint32 BaseVertex)
+{
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i Base = _mm_set1_epi16(static_cast<short>(BaseVertex));
 
-        std::string Name = IsIndexBuff ?
-            "GLTF index buffer" :
-            std::string{"GLTF vertex buffer "} + std::to_string(BuffId);
-        const auto ElementStride = Buffers[BuffId].ElementStride;
-        VERIFY_EXPR(ElementStride > 0);
-        VERIFY_EXPR(Data.size() % ElementStride == 0);
+    Uint32 i = 0;
+    for (; i + 16 <= NumElements; i += 16)
+    {
+        const __m128i Src8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i + 0), _mm_add_epi16(_mm_unpacklo_epi8(Src8, Zero), Base));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i + 8), _mm_add_epi16(_mm_unpackhi_epi8(Src8, Zero), Base));
+    }
+    return i;
+}
 
-        VERIFY(!Buffers[BuffId].pSuballocation && !Buffers[BuffId].pBuffer, "This buffer has already been initialized");
+template <>
+Uint32 WriteIndicesSIMD<Uint16, Uint32>(const Uint16* pSrc, Uint32* pDst, Uint32 NumElements, Uint32 BaseVertex)
+{
+    const __m128i Zero = _mm_setzero_si128();
+    const __m128i Base = _mm_set1_epi32(static_cast<int>(BaseVertex));
 
-        const auto BufferSize = StaticCast<Uint32>(Data.size());
-        if (auto* const pResourceMgr = m_CI.pCacheInfo != nullptr ? m_CI.pCacheInfo->pResourceMgr : nullptr)
+    Uint32 i = 0;
+    for (; i + 8 <= NumElements; i += 8)
+    {
+        const __m128i Src16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i + 0), _mm_add_epi32(_mm_unpacklo_epi16(Src16, Zero), Base));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i + 4), _mm_add_epi32(_mm_unpackhi_epi16(Src16, Zero), Base));
+    }
+    return i;
+}
+
+template <>
+Uint32 WriteIndicesSIMD<Uint16, Uint16>(const Uint16* pSrc, Uint16* pDst, Uint32 NumElements, Uint32 BaseVertex)
+{
+    const __m128i Base = _mm_set1_epi16(static_cast<short>(BaseVertex));
+
+    Uint32 i = 0;
+    for (; i + 8 <= NumElements; i += 8)
+    {
+        const __m128i Src16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), _mm_add_epi16(Src16, Base));
+    }
+    return i;
+}
+
+template <>
+Uint32 WriteIndicesSIMD<Uint32, Uint32>(const Uint32* pSrc, Uint32* pDst, Uint32 NumElements, Uint32 BaseVertex)
+{
+    const __m128i Base = _mm_set1_epi32(static_cast<int>(BaseVertex));
+
+    Uint32 i = 0;
+    for (; i + 4 <= NumElements; i += 4)
+    {
+        const __m128i Src32 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), _mm_add_epi32(Src32, Base));
+    }
+    return i;
+}
+
+#elif GLTF_BUILDER_USE_NEON
+
+template <>
+Uint32 WriteIndicesSIMD<Uint8, Uint32>(const Uint8* pSrc, Uint32* pDst, Uint32 NumElements, Uint32 BaseVertex)
+{
+    const uint32x4_t Base = vdupq_n_u32(BaseVertex);
+
+    Uint32 i = 0;
+    for (; i + 16 <= NumElements; i += 16)
+    {
+        const uint8x16_t Src8   = vld1q_u8(pSrc + i);
+        const uint16x8_t Src16L = vmovl_u8(vget_low_u8(Src8));
+        const uint16x8_t Src16H = vmovl_u8(vget_high_u8(Src8));
+        vst1q_u32(pDst + i + 0, vaddq_u32(vmovl_u16(vget_low_u16(Src16L)), Base));
+        vst1q_u32(pDst + i + 4, vaddq_u32(vmovl_u16(vget_high_u16(Src16L)), Base));
+        vst1q_u32(pDst + i + 8, vaddq_u32(vmovl_u16(vget_low_u16(Src16H)), Base));
+        vst1q_u32(pDst + i + 12, vaddq_u32(vmovl_u16(vget_high_u16(Src16H)), Base));
+    }
+    return i;
+}
+
+template <>
+Uint32 WriteIndicesSIMD<Uint8, Uint16>(const Uint8* pSrc, Uint16* pDst, Uint32 NumElements, Uint32 BaseVertex)
+{
+    const uint16x8_t Base = vdupq_n_u16(static_cast<Uint16>(BaseVertex));
+
+    Uint32 i = 0;
+    for (; i + 16 <= NumElements; i += 16)
+    {
+        const uint8x16_t Src8 = vld1q_u8(pSrc + i);
+        vst1q_u16(pDst + i + 0, vaddq_u16(vmovl_u8(vget_low_u8(Src8)), Base));
+        vst1q_u16(pDst + i + 8, vaddq_u16(vmovl_u8(vget_high_u8(Src8)), Base));
+    }
+    return i;
+}
+
+template <>
+Uint32 WriteIndicesSIMD<Uint16, Uint32>(const Uint16* pSrc, Uint32* pDst, Uint32 NumElements, Uint32 BaseVertex)
+{
+    const uint32x4_t Base = vdupq_n_u32(BaseVertex);
+
+    Uint32 i = 0;
+    for (; i + 8 <= NumElements; i += 8)
+    {
+        const uint16x8_t Src16 = vld1q_u16(pSrc + i);
+        vst1q_u32(pDst + i + 0, vaddq_u32(vmovl_u16(vget_low_u16(Src16)), Base));
+        vst1q_u32(pDst + i + 4, vaddq_u32(vmovl_u16(vget_high_u16(Src16)), Base));
+    }
+    return i;
+}
+
+template <>
+Uint32 WriteIndicesSIMD<Uint16, Uint16>(const Uint16* pSrc, Uint16* pDst, Uint32 NumElements, Uint32 BaseVertex)
+{
+    const uint16x8_t Base = vdupq_n_u16(static_cast<Uint16>(BaseVertex));
+
+    Uint32 i = 0;
+    for (; i + 8 <= NumElements; i += 8)
+        vst1q_u16(pDst + i, vaddq_u16(vld1q_u16(pSrc + i), Base));
+    return i;
+}
+
+template <>
+Uint32 WriteIndicesSIMD<Uint32, Uint32>(const Uint32* pSrc, Uint32* pDst, Uint32 NumElements, Uint32 BaseVertex)
+{
+    const uint32x4_t Base = vdupq_n_u32(BaseVertex);
+
+    Uint32 i = 0;
+    for (; i + 4 <= NumElements; i += 4)
+        vst1q_u32(pDst + i, vaddq_u32(vld1q_u32(pSrc + i), Base));
+    return i;
+}
+
+#endif
+
+template <typename SrcType, typename DstType>
+void WriteIndices(const Uint8* pSrc, size_t SrcStride, Uint8* pDst, Uint32 NumElements, Uint32 BaseVertex)
+{
+    auto* const pDstIndices = reinterpret_cast<DstType*>(pDst);
+
+    Uint32 i = 0;
+    if (SrcStride == sizeof(SrcType))
+    {
+        // Tightly packed indices
+        i = WriteIndicesSIMD<SrcType, DstType>(reinterpret_cast<const SrcType*>(pSrc), pDstIndices, NumElements, BaseVertex);
+    }
+
+    for (; i < NumElements; ++i)
+    {
+        const auto SrcInd = *reinterpret_cast<const SrcType*>(pSrc + i * SrcStride);
+        pDstIndices[i]    = static_cast<DstType>(SrcInd + BaseVertex);
+    }
+}
+
+} // namespace
+
+void ModelBuilder::SelectIndexType()
+{
+    auto& IndexStride = m_Model.Buffers.back().ElementStride;
+    if (IndexStride != 0)
+        return;
+
+    // Indices are relative to the model's first vertex (see Model::GetBaseVertex()), so 16-bit indices
+    // are sufficient when the model has fewer vertices than the largest 16-bit index. That index is
+    // not used, so that it may never be interpreted as the primitive restart value.
+    Uint32 NumVertices = 0;
+    for (size_t i = 0; i < m_VertexData.size(); ++i)
+    {
+        if (m_Model.Buffers[i].ElementStride != 0)
         {
-            Uint32 CacheBufferIndex = IsIndexBuff ?
-                m_CI.pCacheInfo->IndexBufferIdx :
-                m_CI.pCacheInfo->VertexBufferIdx[BuffId];
+            NumVertices = StaticCast<Uint32>(m_VertexData[i].size() / m_Model.Buffers[i].ElementStride);
+            break;
+        }
+    }
+    IndexStride = NumVertices <= 0xFFFFu ? 2 : 4;
+}
+
+void ModelBuilder::WriteIndexData(const void* pSrc,
+                                  VALUE_TYPE  SrcType,
+                                  size_t      SrcStride,
+                                  Uint8*      pDst,
+                                  Uint32      DstIndexSize,
+                                  Uint32      NumElements,
+                                  Uint32      BaseVertex)
+{
+    VERIFY_EXPR(DstIndexSize == 4 || DstIndexSize == 2);
+    const auto* pSrcBytes = static_cast<const Uint8*>(pSrc);
+    switch (SrcType)
+    {
+        case VT_UINT32:
+            if (DstIndexSize == 4)
+                WriteIndices<Uint32, Uint32>(pSrcBytes, SrcStride, pDst, NumElements, BaseVertex);
+            else
+                WriteIndices<Uint32, Uint16>(pSrcBytes, SrcStride, pDst, NumElements, BaseVertex);
+            break;
+
+        case VT_UINT16:
+            if (DstIndexSize == 4)
+                WriteIndices<Uint16, Uint32>(pSrcBytes, SrcStride, pDst, NumElements, BaseVertex);
+            else
+                WriteIndices<Uint16, Uint16>(pSrcBytes, SrcStride, pDst, NumElements, BaseVertex);
+            break;
 
-            Buffers[BuffId].pSuballocation = pResourceMgr->AllocateBufferSpace(CacheBufferIndex, BufferSize, 1);
+        case VT_UINT8:
+            if (DstIndexSize == 4)
+                WriteIndices<Uint8, Uint32>(pSrcBytes, SrcStride, pDst, NumElements, BaseVertex);
+            else
+                WriteIndices<Uint8, Uint16>(pSrcBytes, SrcStride, pDst, NumElements, BaseVertex);
+            break;
 
-            auto pBuffInitData = DataBlobImpl::Create(BufferSize);
-            memcpy(pBuffInitData->GetDataPtr(), Data.data(), BufferSize);
-            Buffers[BuffId].pSuballocation->SetUserData(pBuffInitData);
+        default:
+            UNEXPECTED("Index component type ", GetValueTypeString(SrcType), " is not supported!");
+    }
+}
+
+
+namespace
+{
+
+float ReadGltfComponent(const Uint8* pSrc, VALUE_TYPE SrcType)
+{
+    switch (SrcType)
+    {
+        // clang-format off
+        case VT_INT8:    return static_cast<float>(*reinterpret_cast<const Int8*  >(pSrc));
+        case VT_INT16:   return static_cast<float>(*reinterpret_cast<const Int16* >(pSrc));
+        case VT_INT32:   return static_cast<float>(*reinterpret_cast<const Int32* >(pSrc));
+        case VT_UINT8:   return static_cast<float>(*reinterpret_cast<const Uint8* >(pSrc));
+        case VT_UINT16:  return static_cast<float>(*reinterpret_cast<const Uint16*>(pSrc));
+        case VT_UINT32:  return static_cast<float>(*reinterpret_cast<const Uint32*>(pSrc));
+        case VT_FLOAT32: return *reinterpret_cast<const float*>(pSrc);
+        // clang-format on
+        default:
+            UNEXPECTED("Unexpected source type");
+            return 0;
+    }
+}
+
+// Converts 32-bit float to 16-bit float with round-to-nearest.
+Uint16 FloatToHalf(float Value)
+{
+    Uint32 Bits = 0;
+    memcpy(&Bits, &Value, sizeof(Bits));
+
+    const Uint32 Sign     = (Bits >> 16) & 0x8000u;
+    const Uint32 FloatExp = (Bits >> 23) & 0xFFu;
+    Uint32       Mantissa = Bits & 0x7FFFFFu;
+
+    if (FloatExp == 0xFF)
+    {
+        // Inf or NaN
+        return static_cast<Uint16>(Sign | 0x7C00u | (Mantissa != 0 ? 0x200u : 0u));
+    }
+
+    const Int32 HalfExp = static_cast<Int32>(FloatExp) - 127 + 15;
+    if (HalfExp >= 31)
+    {
+        // Overflow
+        return static_cast<Uint16>(Sign | 0x7C00u);
+    }
+
+    if (HalfExp <= 0)
+    {
+        // Denormalized half or zero
+        if (HalfExp < -10)
+            return static_cast<Uint16>(Sign);
+
+        Mantissa |= 0x800000u;
+        const Uint32 Shift        = static_cast<Uint32>(14 - HalfExp);
+        Uint32       HalfMantissa = Mantissa >> Shift;
+        if ((Mantissa >> (Shift - 1)) & 1u)
+            ++HalfMantissa;
+        return static_cast<Uint16>(Sign | HalfMantissa);
+    }
+
+    Uint32 Half = Sign | (static_cast<Uint32>(HalfExp) << 10) | (Mantissa >> 13);
+    // Note that rounding may carry into the exponent, which produces the correct result
+    if (Mantissa & 0x1000u)
+        ++Half;
+    return static_cast<Uint16>(Half);
+}
+
+template <typename DstType>
+void WriteNormalizedValue(float Value, Uint8* pDst)
+{
+    constexpr float MaxValue = static_cast<float>(std::numeric_limits<DstType>::max());
+    constexpr float MinValue = std::is_signed<DstType>::value ? -1.f : 0.f;
+
+    const auto Dst = static_cast<DstType>(std::round(clamp(Value, MinValue, 1.f) * MaxValue));
+    memcpy(pDst, &Dst, sizeof(Dst));
+}
+
+void WriteNormalizedComponent(float Value, VALUE_TYPE DstType, Uint8* pDst)
+{
+    switch (DstType)
+    {
+        // clang-format off
+        case VT_INT8:   WriteNormalizedValue<Int8  >(Value, pDst); break;
+        case VT_INT16:  WriteNormalizedValue<Int16 >(Value, pDst); break;
+        case VT_UINT8:  WriteNormalizedValue<Uint8 >(Value, pDst); break;
+        case VT_UINT16: WriteNormalizedValue<Uint16>(Value, pDst); break;
+        // clang-format on
+        default:
+            UNEXPECTED("Normalized values must be 8- or 16-bit integers");
+    }
+}
+
+// Maps the unit vector to the octahedron and projects it onto the z = 0 plane.
+float2 EncodeOctahedral(float3 Dir)
+{
+    const auto L1Norm = std::abs(Dir.x) + std::abs(Dir.y) + std::abs(Dir.z);
+    if (L1Norm == 0)
+        return float2{0, 0};
+
+    Dir /= L1Norm;
+    if (Dir.z >= 0)
+        return float2{Dir.x, Dir.y};
+
+    // Fold the lower hemisphere over the diagonals
+    return float2{
+        (1.f - std::abs(Dir.y)) * (Dir.x >= 0 ? 1.f : -1.f),
+        (1.f - std::abs(Dir.x)) * (Dir.y >= 0 ? 1.f : -1.f),
+    };
+}
+
+} // namespace
+
+void ModelBuilder::WriteEncodedGltfData(const void*                  pSrc,
+                                        VALUE_TYPE                   SrcType,
+                                        bool                         SrcNormalized,
+                                        Uint32                       NumSrcComponents,
+                                        Uint32                       SrcElemStride,
+                                        std::vector<Uint8>::iterator dst_it,
+                                        const VertexAttributeDesc&   DstAttrib,
+                                        Uint32                       DstElementStride,
+                                        Uint32                       NumElements,
+                                        const float3&                BBMin,
+                                        const float3&                BBMax)
+{
+    const auto DstComponentSize = GetValueSize(DstAttrib.ValueType);
+    const auto BBSize           = BBMax - BBMin;
+
+    float SrcComponents[4] = {};
+    float DstComponents[4] = {};
+
+    const auto NumSrcComponentsToRead = std::min(NumSrcComponents, Uint32{4});
+    const auto NumDstComponents       = std::min(Uint32{DstAttrib.NumComponents}, Uint32{4});
+    for (size_t elem = 0; elem < NumElements; ++elem)
+    {
+        const auto* pSrcElem = static_cast<const Uint8*>(pSrc) + size_t{SrcElemStride} * elem;
+        for (Uint32 cmp = 0; cmp < NumSrcComponentsToRead; ++cmp)
+            SrcComponents[cmp] = ReadGltfValue(pSrcElem + GetValueSize(SrcType) * cmp, SrcType, SrcNormalized);
+
+        switch (DstAttrib.Encoding)
+        {
+            case VERTEX_ATTRIBUTE_ENCODING_NONE:
+            case VERTEX_ATTRIBUTE_ENCODING_NORMALIZED:
+                for (Uint32 cmp = 0; cmp < 4; ++cmp)
+                    DstComponents[cmp] = SrcComponents[cmp];
+                break;
+
+            case VERTEX_ATTRIBUTE_ENCODING_OCTAHEDRAL:
+            {
+                const auto Oct   = EncodeOctahedral(float3{SrcComponents[0], SrcComponents[1], SrcComponents[2]});
+                DstComponents[0] = Oct.x;
+                DstComponents[1] = Oct.y;
+                break;
+            }
+
+            case VERTEX_ATTRIBUTE_ENCODING_BOUNDING_BOX:
+                for (Uint32 cmp = 0; cmp < 3; ++cmp)
+                    DstComponents[cmp] = BBSize[cmp] > 0 ? (SrcComponents[cmp] - BBMin[cmp]) / BBSize[cmp] : 0;
+                break;
+
+            default:
+                UNEXPECTED("Unexpected vertex attribute encoding");
         }
-        else
+
+        auto* pDstElem = &*(dst_it + size_t{DstElementStride} * elem);
+        for (Uint32 cmp = 0; cmp < NumDstComponents; ++cmp)
         {
-            BufferDesc BuffDesc;
-            BuffDesc.Name      = Name.c_str();
-            BuffDesc.Size      = BufferSize;
-            BuffDesc.BindFlags = IsIndexBuff ? m_CI.IndBufferBindFlags : m_CI.VertBufferBindFlags[BuffId];
-            if (BuffDesc.BindFlags == BIND_NONE)
-                BuffDesc.BindFlags = IsIndexBuff ? BIND_INDEX_BUFFER : BIND_VERTEX_BUFFER;
-            BuffDesc.Usage = USAGE_IMMUTABLE;
-            if (BuffDesc.BindFlags & (BIND_SHADER_RESOURCE | BIND_UNORDERED_ACCESS))
+            auto* pDstCmp = pDstElem + DstComponentSize * cmp;
+            if (DstAttrib.Encoding == VERTEX_ATTRIBUTE_ENCODING_NONE)
             {
-                BuffDesc.Mode = IsIndexBuff ?
-                    BUFFER_MODE_FORMATTED :
-                    BUFFER_MODE_STRUCTURED;
+                VERIFY(DstAttrib.ValueType == VT_FLOAT16, "Only half-precision floats are expected to be written without encoding");
+                const auto Half = FloatToHalf(cmp < NumSrcComponentsToRead ? DstComponents[cmp] : 0.f);
+                memcpy(pDstCmp, &Half, sizeof(Half));
+            }
+            else
+            {
+                WriteNormalizedComponent(DstComponents[cmp], DstAttrib.ValueType, pDstCmp);
+            }
+        }
+    }
+}
 
-                BuffDesc.ElementByteStride = ElementStride;
+
+namespace
+{
+
+float GetNormalizedValueScale(VALUE_TYPE ValueType)
+{
+    switch (ValueType)
+    {
+        // clang-format off
+        case VT_INT8:   return 1.f / static_cast<float>(std::numeric_limits<Int8  >::max());
+        case VT_INT16:  return 1.f / static_cast<float>(std::numeric_limits<Int16 >::max());
+        case VT_UINT8:  return 1.f / static_cast<float>(std::numeric_limits<Uint8 >::max());
+        case VT_UINT16: return 1.f / static_cast<float>(std::numeric_limits<Uint16>::max());
+        // clang-format on
+        default:
+            return 1.f;
+    }
+}
+
+void ComputeMeshletBounds(const float3* pPositions, Uint32 NumVertices, const Uint32* pTriangles, Uint32 NumTriangles, Meshlet& Dst)
+{
+    VERIFY_EXPR(NumVertices > 0);
+
+    // Bounding sphere around the bounding box center
+    float3 Min = pPositions[0];
+    float3 Max = pPositions[0];
+    for (Uint32 v = 1; v < NumVertices; ++v)
+    {
+        Min = std::min(Min, pPositions[v]);
+        Max = std::max(Max, pPositions[v]);
+    }
+    const auto Center = (Min + Max) * 0.5f;
+
+    float RadiusSq = 0;
+    for (Uint32 v = 0; v < NumVertices; ++v)
+        RadiusSq = std::max(RadiusSq, dot(pPositions[v] - Center, pPositions[v] - Center));
+
+    Dst.BoundingSphere = float4{Center, std::sqrt(RadiusSq)};
+
+    // Normal cone
+    const auto GetTriangleNormal = [&](Uint32 Tri, float3& Normal) {
+        const auto PackedTri = pTriangles[Tri];
+
+        const auto& P0 = pPositions[(PackedTri >> 0u) & 0xFFu];
+        const auto& P1 = pPositions[(PackedTri >> 8u) & 0xFFu];
+        const auto& P2 = pPositions[(PackedTri >> 16u) & 0xFFu];
+
+        Normal = cross(P1 - P0, P2 - P0);
+
+        const auto Len = length(Normal);
+        if (Len == 0)
+            return false;
+        Normal /= Len;
+        return true;
+    };
+
+    float3 Axis;
+    for (Uint32 t = 0; t < NumTriangles; ++t)
+    {
+        float3 Normal;
+        if (GetTriangleNormal(t, Normal))
+            Axis += Normal;
+    }
+
+    const auto AxisLen = length(Axis);
+
+    float MinDot = 1;
+    if (AxisLen > 0)
+    {
+        Axis /= AxisLen;
+        for (Uint32 t = 0; t < NumTriangles; ++t)
+        {
+            float3 Normal;
+            if (GetTriangleNormal(t, Normal))
+                MinDot = std::min(MinDot, dot(Axis, Normal));
+        }
+    }
+
+    if (AxisLen == 0 || MinDot <= 0.1f)
+    {
+        // The cone is too wide to be useful for culling
+        Dst.NormalCone = float4{0, 0, 0, 1};
+    }
+    else
+    {
+        Dst.NormalCone = float4{Axis, std::sqrt(1.f - MinDot * MinDot)};
+    }
+}
+
+} // namespace
+
+float ModelBuilder::NormalizeGltfValue(float Value, VALUE_TYPE SrcType)
+{
+    // Signed types map both the minimum value and the one next to it to -1
+    return std::max(Value * GetNormalizedValueScale(SrcType), -1.f);
+}
+
+float ModelBuilder::ReadGltfValue(const void* pSrc, VALUE_TYPE SrcType, bool Normalized)
+{
+    const auto Value = ReadGltfComponent(static_cast<const Uint8*>(pSrc), SrcType);
+    return Normalized ? NormalizeGltfValue(Value, SrcType) : Value;
+}
+
+void ModelBuilder::AppendMorphTargetDeltas(const std::vector<MorphAttribDelta>& PosDeltas,
+                                           const std::vector<MorphAttribDelta>& NormalDeltas,
+                                           Uint32                               VertexStart,
+                                           MeshMorphTarget&                     Target)
+{
+    auto pos_it    = PosDeltas.begin();
+    auto normal_it = NormalDeltas.begin();
+    while (pos_it != PosDeltas.end() || normal_it != NormalDeltas.end())
+    {
+        // Process the smallest vertex index of the two lists
+        const bool HasPos    = pos_it != PosDeltas.end() && (normal_it == NormalDeltas.end() || pos_it->Vertex <= normal_it->Vertex);
+        const bool HasNormal = normal_it != NormalDeltas.end() && (pos_it == PosDeltas.end() || normal_it->Vertex <= pos_it->Vertex);
+
+        MorphTargetDelta Delta;
+        Delta.Vertex = VertexStart + (HasPos ? pos_it->Vertex : normal_it->Vertex);
+
+        bool IsZero = true;
+        for (Uint32 c = 0; c < 3; ++c)
+        {
+            if (HasPos)
+            {
+                const auto PosDelta   = pos_it->Value[c];
+                Delta.Position[c]     = FloatToHalf(PosDelta);
+                Target.PosDeltaMin[c] = std::min(Target.PosDeltaMin[c], PosDelta);
+                Target.PosDeltaMax[c] = std::max(Target.PosDeltaMax[c], PosDelta);
             }
+            if (HasNormal)
+                Delta.Normal[c] = FloatToHalf(normal_it->Value[c]);
 
-            BufferData BuffData{Data.data(), BuffDesc.Size};
-            pDevice->CreateBuffer(BuffDesc, &BuffData, &Buffers[BuffId].pBuffer);
+            // Deltas that are too small to be represented are dropped, ignoring the sign of zero
+            IsZero = IsZero && (Delta.Position[c] & 0x7FFFu) == 0 && (Delta.Normal[c] & 0x7FFFu) == 0;
+        }
+
+        if (!IsZero)
+            Target.Deltas.push_back(Delta);
+
+        if (HasPos)
+            ++pos_it;
+        if (HasNormal)
+            ++normal_it;
+    }
+}
+
+void ModelBuilder::AddMeshMorphTargets(Mesh& DstMesh, std::vector<MeshMorphTarget>& Targets)
+{
+    float3 BBMinDelta;
+    float3 BBMaxDelta;
+
+    auto& ModelDeltas = m_Model.MorphTargetDeltas;
+    DstMesh.MorphTargets.resize(Targets.size());
+    for (size_t t = 0; t < Targets.size(); ++t)
+    {
+        auto& Deltas = Targets[t].Deltas;
+        std::sort(Deltas.begin(), Deltas.end(), [](const MorphTargetDelta& lhs, const MorphTargetDelta& rhs) {
+            return lhs.Vertex < rhs.Vertex;
+        });
+
+        auto& DstTarget      = DstMesh.MorphTargets[t];
+        DstTarget.FirstDelta = StaticCast<Uint32>(ModelDeltas.size());
+        DstTarget.NumDeltas  = StaticCast<Uint32>(Deltas.size());
+        ModelDeltas.insert(ModelDeltas.end(), Deltas.begin(), Deltas.end());
+
+        // Every target may be applied with the weight in [0, 1] range
+        BBMinDelta += Targets[t].PosDeltaMin;
+        BBMaxDelta += Targets[t].PosDeltaMax;
+    }
+
+    if (!DstMesh.Primitives.empty())
+    {
+        DstMesh.BB.Min += BBMinDelta;
+        DstMesh.BB.Max += BBMaxDelta;
+    }
+}
+
+float3 ModelBuilder::ReadVertexPosition(const VertexAttributeDesc& PosAttrib, Uint32 Vertex, const BoundBox& BB) const
+{
+    const auto  Stride = m_Model.Buffers[PosAttrib.BufferId].ElementStride;
+    const auto* pData  = &m_VertexData[PosAttrib.BufferId][size_t{Vertex} * Stride + PosAttrib.RelativeOffset];
+
+    const auto CompSize = GetValueSize(PosAttrib.ValueType);
+    const auto Scale    = PosAttrib.Encoding != VERTEX_ATTRIBUTE_ENCODING_NONE ? GetNormalizedValueScale(PosAttrib.ValueType) : 1.f;
+
+    float3 Pos;
+    for (Uint32 c = 0; c < std::min(Uint32{PosAttrib.NumComponents}, Uint32{3}); ++c)
+    {
+        Pos[c] = ReadGltfComponent(pData + CompSize * c, PosAttrib.ValueType) * Scale;
+        if (PosAttrib.Encoding == VERTEX_ATTRIBUTE_ENCODING_BOUNDING_BOX)
+            Pos[c] = BB.Min[c] + Pos[c] * (BB.Max[c] - BB.Min[c]);
+    }
+    return Pos;
+}
+
+void ModelBuilder::BuildMeshBVHs()
+{
+    const VertexAttributeDesc* pPosAttrib = nullptr;
+    for (Uint32 i = 0; i < m_Model.GetNumVertexAttributes(); ++i)
+    {
+        if (strcmp(m_Model.VertexAttributes[i].Name, "POSITION") == 0)
+            pPosAttrib = &m_Model.VertexAttributes[i];
+    }
+    if (pPosAttrib == nullptr || pPosAttrib->ValueType == VT_FLOAT16 || m_VertexData[pPosAttrib->BufferId].empty())
+    {
+        LOG_WARNING_MESSAGE("Mesh hierarchies can't be built: the model has no vertex positions or positions use unsupported format");
+        return;
+    }
+
+    const auto IndexSize = !m_IndexData.empty() ? m_Model.Buffers.back().ElementStride : 4;
+    VERIFY_EXPR(IndexSize == 4 || IndexSize == 2);
+    const auto ReadIndex = [&](size_t Idx) -> Uint32 {
+        return IndexSize == 4 ?
+            reinterpret_cast<const Uint32*>(m_IndexData.data())[Idx] :
+            reinterpret_cast<const Uint16*>(m_IndexData.data())[Idx];
+    };
+
+    m_Model.MeshBVHs.clear();
+    m_Model.MeshBVHs.resize(m_Model.Meshes.size());
+
+    // Offsets of the vertex ranges in the positions of the current mesh.
+    // Primitives of a mesh may share the same vertices.
+    std::unordered_map<Uint32, Uint32> VertexRangeOffsets;
+    for (size_t MeshIdx = 0; MeshIdx < m_Model.Meshes.size(); ++MeshIdx)
+    {
+        const auto& M   = m_Model.Meshes[MeshIdx];
+        auto&       Dst = m_Model.MeshBVHs[MeshIdx];
+        VertexRangeOffsets.clear();
+        for (Uint32 PrimIdx = 0; PrimIdx < M.Primitives.size(); ++PrimIdx)
+        {
+            const auto& Prim = M.Primitives[PrimIdx];
+            if (Prim.VertexCount == 0 || (Prim.HasIndices() && Prim.IndexCount % 3 != 0))
+                continue;
+
+            const auto it = VertexRangeOffsets.emplace(Prim.FirstVertex, static_cast<Uint32>(Dst.Positions.size()));
+            if (it.second)
+            {
+                for (Uint32 v = 0; v < Prim.VertexCount; ++v)
+                    Dst.Positions.push_back(ReadVertexPosition(*pPosAttrib, Prim.FirstVertex + v, Prim.BB));
+            }
+            const auto BaseVertex = it.first->second;
+            const auto NumVerts   = static_cast<Uint32>(Dst.Positions.size()) - BaseVertex;
+
+            const auto NumTriangles = Prim.HasIndices() ? Prim.IndexCount / 3 : Prim.VertexCount / 3;
+            for (Uint32 t = 0; t < NumTriangles; ++t)
+            {
+                MeshBVH::Triangle Tri;
+                for (Uint32 c = 0; c < 3; ++c)
+                {
+                    const auto Vert = Prim.HasIndices() ?
+                        ReadIndex(size_t{Prim.FirstIndex} + t * 3 + c) - Prim.FirstVertex :
+                        t * 3 + c;
+                    VERIFY(Vert < NumVerts, "Index is out of range");
+                    Tri.Vertices[c] = BaseVertex + std::min(Vert, NumVerts - 1);
+                }
+                Tri.PrimitiveIndex = PrimIdx;
+                Tri.TriangleIndex  = t;
+                Dst.Triangles.push_back(Tri);
+            }
+        }
+
+        Dst.Positions.shrink_to_fit();
+        Dst.Triangles.shrink_to_fit();
+        Dst.Build(m_CI.BVHMaxLeafSize);
+    }
+}
+
+void ModelBuilder::GenerateMeshlets()
+{
+    const VertexAttributeDesc* pPosAttrib = nullptr;
+    for (Uint32 i = 0; i < m_Model.GetNumVertexAttributes(); ++i)
+    {
+        if (strcmp(m_Model.VertexAttributes[i].Name, "POSITION") == 0)
+            pPosAttrib = &m_Model.VertexAttributes[i];
+    }
+    if (pPosAttrib == nullptr || pPosAttrib->ValueType == VT_FLOAT16)
+    {
+        LOG_WARNING_MESSAGE("Meshlets can't be generated: the model has no vertex positions or positions use unsupported format");
+        return;
+    }
+
+    DEV_CHECK_ERR(m_CI.MaxMeshletVertices >= 3 && m_CI.MaxMeshletVertices <= 256, "The maximum number of meshlet vertices (", m_CI.MaxMeshletVertices, ") must be in [3, 256] range");
+    DEV_CHECK_ERR(m_CI.MaxMeshletTriangles >= 1, "The maximum number of meshlet triangles must not be zero");
+    const auto MaxVertices  = clamp(m_CI.MaxMeshletVertices, Uint32{3}, Uint32{256});
+    const auto MaxTriangles = std::max(m_CI.MaxMeshletTriangles, Uint32{1});
+
+    const auto IndexSize = m_Model.Buffers.back().ElementStride;
+    const auto ReadIndex = [&](size_t Idx) -> Uint32 {
+        return IndexSize == 4 ?
+            reinterpret_cast<const Uint32*>(m_IndexData.data())[Idx] :
+            reinterpret_cast<const Uint16*>(m_IndexData.data())[Idx];
+    };
+
+    static constexpr Uint32 InvalidIndex = ~0u;
+
+    std::vector<Uint32> LocalIndices;
+    std::vector<Uint32> MeshletVertices;
+    std::vector<Uint32> MeshletTriangles;
+    std::vector<float3> MeshletPositions;
+    for (const auto& Range : m_PrimitiveRanges)
+    {
+        if (Range.IndexCount == 0 || Range.IndexCount % 3 != 0)
+            continue;
+
+        auto& Prim = m_Model.Meshes[Range.MeshId].Primitives[Range.PrimitiveId];
+
+        Prim.FirstMeshlet = static_cast<Uint32>(m_Model.Meshlets.size());
+
+        LocalIndices.assign(Range.VertexCount, InvalidIndex);
+
+        const auto FlushMeshlet = [&]() {
+            if (MeshletTriangles.empty())
+                return;
+
+            Meshlet NewMeshlet;
+            NewMeshlet.VertexCount   = static_cast<Uint32>(MeshletVertices.size());
+            NewMeshlet.TriangleCount = static_cast<Uint32>(MeshletTriangles.size());
+
+            MeshletPositions.resize(MeshletVertices.size());
+            for (size_t v = 0; v < MeshletVertices.size(); ++v)
+                MeshletPositions[v] = ReadVertexPosition(*pPosAttrib, Range.VertexStart + MeshletVertices[v], Prim.BB);
+            ComputeMeshletBounds(MeshletPositions.data(), NewMeshlet.VertexCount, MeshletTriangles.data(), NewMeshlet.TriangleCount, NewMeshlet);
+
+            NewMeshlet.VertexOffset = static_cast<Uint32>(m_MeshletData.size());
+            for (auto Vert : MeshletVertices)
+            {
+                m_MeshletData.push_back(Range.VertexStart + Vert);
+                LocalIndices[Vert] = InvalidIndex;
+            }
+            NewMeshlet.TriangleOffset = static_cast<Uint32>(m_MeshletData.size());
+            m_MeshletData.insert(m_MeshletData.end(), MeshletTriangles.begin(), MeshletTriangles.end());
+
+            m_Model.Meshlets.push_back(NewMeshlet);
+            MeshletVertices.clear();
+            MeshletTriangles.clear();
+        };
+
+        for (Uint32 i = 0; i < Range.IndexCount; i += 3)
+        {
+            Uint32 Verts[3];
+            Uint32 NumNewVerts = 0;
+            for (Uint32 v = 0; v < 3; ++v)
+            {
+                Verts[v] = std::min(ReadIndex(size_t{Range.FirstIndex} + i + v) - Range.VertexStart, Range.VertexCount - 1);
+                // Note that the same vertex may be referenced more than once by a degenerate triangle
+                if (LocalIndices[Verts[v]] == InvalidIndex && (v < 1 || Verts[v] != Verts[0]) && (v < 2 || Verts[v] != Verts[1]))
+                    ++NumNewVerts;
+            }
+
+            if (MeshletVertices.size() + NumNewVerts > MaxVertices || MeshletTriangles.size() + 1 > MaxTriangles)
+                FlushMeshlet();
+
+            Uint32 PackedTri = 0;
+            for (Uint32 v = 0; v < 3; ++v)
+            {
+                auto& LocalIdx = LocalIndices[Verts[v]];
+                if (LocalIdx == InvalidIndex)
+                {
+                    LocalIdx = static_cast<Uint32>(MeshletVertices.size());
+                    MeshletVertices.push_back(Verts[v]);
+                }
+                PackedTri |= LocalIdx << (v * 8u);
+            }
+            MeshletTriangles.push_back(PackedTri);
+        }
+        FlushMeshlet();
+
+        Prim.MeshletCount = static_cast<Uint32>(m_Model.Meshlets.size()) - Prim.FirstMeshlet;
+    }
+}
+
+namespace
+{
+
+// Builds the resource manager cache id for the converted buffer data.
+// The id contains two independent 64-bit hashes of the data, which makes
+// accidental collisions between different buffers of the same size negligible.
+std::string GetBufferDataCacheId(Uint32 CacheBufferIndex, const std::vector<Uint8>& Data)
+{
+    const auto Mix = [](Uint64 h) {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    };
+
+    Uint64 Hash0 = 0x9E3779B97F4A7C15ull ^ Data.size();
+    Uint64 Hash1 = 0x2545F4914F6CDD1Dull + Data.size();
+
+    const auto NumWords = Data.size() / sizeof(Uint64);
+    for (size_t i = 0; i < NumWords; ++i)
+    {
+        Uint64 Word = 0;
+        memcpy(&Word, Data.data() + i * sizeof(Uint64), sizeof(Word));
+        Hash0 = (Hash0 ^ Mix(Word)) * 0x100000001B3ull;
+        Hash1 = ((Hash1 << 31) | (Hash1 >> 33)) + (Word ^ 0xA0761D6478BD642Full) * 0xE7037ED1A0B428DBull;
+    }
+
+    Uint64 Tail = 0;
+    memcpy(&Tail, Data.data() + NumWords * sizeof(Uint64), Data.size() - NumWords * sizeof(Uint64));
+    Hash0 = Mix(Hash0 ^ Mix(Tail));
+    Hash1 = Mix(Hash1 + Tail);
+
+    std::stringstream ss;
+    ss << "GLTF buffer " << CacheBufferIndex << ':' << Data.size() << ':'
+       << std::hex << std::setfill('0') << std::setw(16) << Hash0 << std::setw(16) << Hash1;
+    return ss.str();
+}
+
+// Data blob that takes ownership of a converted data vector, so that the data
+// does not need to be copied into the initialization data of a suballocation.
+class VectorDataBlob final : public ObjectBase<IDataBlob>
+{
+public:
+    using TBase = ObjectBase<IDataBlob>;
+
+    VectorDataBlob(IReferenceCounters* pRefCounters, std::vector<Uint8>&& Data) :
+        TBase{pRefCounters},
+        m_Data{std::move(Data)}
+    {}
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_DataBlob, TBase)
+
+    virtual void DILIGENT_CALL_TYPE Resize(size_t NewSize) override final
+    {
+        m_Data.resize(NewSize);
+    }
+
+    virtual size_t DILIGENT_CALL_TYPE GetSize() const override final
+    {
+        return m_Data.size();
+    }
+
+    virtual void* DILIGENT_CALL_TYPE GetDataPtr() override final
+    {
+        return m_Data.data();
+    }
+
+    virtual const void* DILIGENT_CALL_TYPE GetConstDataPtr() const override final
+    {
+        return m_Data.data();
+    }
+
+private:
+    std::vector<Uint8> m_Data;
+};
+
+} // namespace
+
+void ModelBuilder::InitBuffers(IRenderDevice* pDevice, IDeviceContext* pContext)
+{
+    ScopedLoadStage Stage{m_CI.pLoadStats, MODEL_LOAD_PROFILE_STAGE_INIT_BUFFERS};
+
+    auto& Buffers = m_Model.Buffers;
+    for (Uint32 BuffId = 0; BuffId < Buffers.size(); ++BuffId)
+    {
+        const auto IsIndexBuff = (BuffId == Buffers.size() - 1);
+
+        auto& Data = IsIndexBuff ? m_IndexData : m_VertexData[BuffId];
+        if (Data.empty())
+            continue;
+
+        std::string Name = IsIndexBuff ?
+            "GLTF index buffer" :
+            std::string{"GLTF vertex buffer "} + std::to_string(BuffId);
+        const auto ElementStride = Buffers[BuffId].ElementStride;
+        VERIFY_EXPR(ElementStride > 0);
+        VERIFY_EXPR(Data.size() % ElementStride == 0);
+
+        VERIFY(!Buffers[BuffId].pSuballocation && !Buffers[BuffId].pBuffer, "This buffer has already been initialized");
+
+        const auto BufferSize = StaticCast<Uint32>(Data.size());
+        Stage.AddItems(1, BufferSize);
+        if (auto* const pResourceMgr = m_CI.pCacheInfo != nullptr ? m_CI.pCacheInfo->pResourceMgr : nullptr)
+        {
+            Uint32 CacheBufferIndex = IsIndexBuff ?
+                m_CI.pCacheInfo->GetIndexBufferIdx(m_Model.GetIndexType()) :
+                m_CI.pCacheInfo->VertexBufferIdx[BuffId];
+
+            std::string CacheId;
+            if (m_CI.pCacheInfo->ShareBufferData)
+            {
+                CacheId = GetBufferDataCacheId(CacheBufferIndex, Data);
+                // If another model has uploaded identical data, reuse its allocation.
+                // The pending initialization data, if any, is shared as well.
+                Buffers[BuffId].pSuballocation = pResourceMgr->FindBufferAllocation(CacheId.c_str());
+            }
+
+            if (!Buffers[BuffId].pSuballocation)
+            {
+                RefCntAutoPtr<IDataBlob> pBuffInitData;
+                if (m_CI.BakedFileName == nullptr)
+                {
+                    // Move the data into the blob instead of copying it. The vector is left empty.
+                    pBuffInitData = MakeNewRCObj<VectorDataBlob>()(std::move(Data));
+                }
+                else
+                {
+                    // The data is needed to bake the model, so it has to be copied.
+                    pBuffInitData = MakeNewRCObj<VectorDataBlob>()(std::vector<Uint8>{Data});
+                }
+                Buffers[BuffId].pSuballocation = pResourceMgr->AllocateBufferSpace(CacheBufferIndex, BufferSize, IsIndexBuff ? ElementStride : 1, CacheId.c_str(), pBuffInitData);
+            }
+        }
+        else if (pDevice != nullptr)
+        {
+            BufferDesc BuffDesc;
+            BuffDesc.Name      = Name.c_str();
+            BuffDesc.Size      = BufferSize;
+            BuffDesc.BindFlags = IsIndexBuff ? m_CI.IndBufferBindFlags : m_CI.VertBufferBindFlags[BuffId];
+            if (BuffDesc.BindFlags == BIND_NONE)
+                BuffDesc.BindFlags = IsIndexBuff ? BIND_INDEX_BUFFER : BIND_VERTEX_BUFFER;
+            BuffDesc.Usage = USAGE_IMMUTABLE;
+            if (BuffDesc.BindFlags & (BIND_SHADER_RESOURCE | BIND_UNORDERED_ACCESS))
+            {
+                BuffDesc.Mode = IsIndexBuff ?
+                    BUFFER_MODE_FORMATTED :
+                    BUFFER_MODE_STRUCTURED;
+
+                BuffDesc.ElementByteStride = ElementStride;
+            }
+
+            BufferData BuffData{Data.data(), BuffDesc.Size};
+            pDevice->CreateBuffer(BuffDesc, &BuffData, &Buffers[BuffId].pBuffer);
+        }
+
+        if (m_CI.BakedFileName == nullptr)
+        {
+            // The data has been copied or moved - release it right away to reduce the peak memory
+            // usage when loading large models. The data is needed to bake the model otherwise.
+            std::vector<Uint8>{}.swap(Data);
+        }
+    }
+
+    if (!m_Model.InstanceMatrices.empty())
+    {
+        if (pDevice != nullptr)
+        {
+            BufferDesc BuffDesc;
+            BuffDesc.Name              = "GLTF instance buffer";
+            BuffDesc.Size              = m_Model.InstanceMatrices.size() * sizeof(float4x4);
+            BuffDesc.BindFlags         = BIND_VERTEX_BUFFER | BIND_SHADER_RESOURCE;
+            BuffDesc.Usage             = USAGE_IMMUTABLE;
+            BuffDesc.Mode              = BUFFER_MODE_STRUCTURED;
+            BuffDesc.ElementByteStride = sizeof(float4x4);
+
+            BufferData BuffData{m_Model.InstanceMatrices.data(), BuffDesc.Size};
+            pDevice->CreateBuffer(BuffDesc, &BuffData, &m_Model.pInstanceBuffer);
+            Stage.AddItems(1, BuffDesc.Size);
+        }
+        else if (m_CI.BakedFileName == nullptr) // Baked models are written without a device, see Model::Bake()
+        {
+            LOG_WARNING_MESSAGE("Instance buffer can't be created as render device is null");
+        }
+    }
+
+    if (!m_Model.MorphTargetDeltas.empty())
+    {
+        if (pDevice != nullptr)
+        {
+            BufferDesc BuffDesc;
+            BuffDesc.Name              = "GLTF morph target buffer";
+            BuffDesc.Size              = m_Model.MorphTargetDeltas.size() * sizeof(MorphTargetDelta);
+            BuffDesc.BindFlags         = BIND_SHADER_RESOURCE;
+            BuffDesc.Usage             = USAGE_IMMUTABLE;
+            BuffDesc.Mode              = BUFFER_MODE_STRUCTURED;
+            BuffDesc.ElementByteStride = sizeof(MorphTargetDelta);
+
+            BufferData BuffData{m_Model.MorphTargetDeltas.data(), BuffDesc.Size};
+            pDevice->CreateBuffer(BuffDesc, &BuffData, &m_Model.pMorphTargetBuffer);
+            Stage.AddItems(1, BuffDesc.Size);
+        }
+        else if (m_CI.BakedFileName == nullptr)
+        {
+            LOG_WARNING_MESSAGE("Morph target buffer can't be created as render device is null");
+        }
+    }
+
+    if (!m_Model.Meshlets.empty())
+    {
+        if (pDevice == nullptr)
+        {
+            if (m_CI.BakedFileName == nullptr)
+                LOG_WARNING_MESSAGE("Meshlet buffers can't be created as render device is null");
+            return;
+        }
+
+        const auto CreateMeshletBuffer = [pDevice](const char* Name, const void* pData, size_t Size, Uint32 ElementStride, IBuffer** ppBuffer) {
+            BufferDesc BuffDesc;
+            BuffDesc.Name              = Name;
+            BuffDesc.Size              = Size;
+            BuffDesc.BindFlags         = BIND_SHADER_RESOURCE;
+            BuffDesc.Usage             = USAGE_IMMUTABLE;
+            BuffDesc.Mode              = BUFFER_MODE_STRUCTURED;
+            BuffDesc.ElementByteStride = ElementStride;
+
+            BufferData BuffData{pData, BuffDesc.Size};
+            pDevice->CreateBuffer(BuffDesc, &BuffData, ppBuffer);
+        };
+
+        const auto& Meshlets = m_Model.Meshlets;
+        CreateMeshletBuffer("GLTF meshlet buffer", Meshlets.data(), Meshlets.size() * sizeof(Meshlet), sizeof(Meshlet), &m_Model.pMeshletBuffer);
+        CreateMeshletBuffer("GLTF meshlet data buffer", m_MeshletData.data(), m_MeshletData.size() * sizeof(Uint32), sizeof(Uint32), &m_Model.pMeshletDataBuffer);
+        Stage.AddItems(2, Meshlets.size() * sizeof(Meshlet) + m_MeshletData.size() * sizeof(Uint32));
+    }
+}
+
+int ModelBuilder::GetLoadedMeshIndex(int GltfMeshIndex) const
+{
+    auto it = m_MeshIndexRemapping.find(GltfMeshIndex);
+    return it != m_MeshIndexRemapping.end() && m_LoadedMeshes.find(it->second) != m_LoadedMeshes.end() ? it->second : -1;
+}
+
+void ModelBuilder::ReleaseConvertedData(std::vector<Uint8>&              IndexData,
+                                        std::vector<std::vector<Uint8>>& VertexData,
+                                        std::vector<Uint32>&             MeshletData)
+{
+    IndexData   = std::move(m_IndexData);
+    VertexData  = std::move(m_VertexData);
+    MeshletData = std::move(m_MeshletData);
+}
+
+void ModelBuilder::InitBuffers(std::vector<Uint8>              IndexData,
+                               std::vector<std::vector<Uint8>> VertexData,
+                               std::vector<Uint32>             MeshletData,
+                               IRenderDevice*                  pDevice,
+                               IDeviceContext*                 pContext)
+{
+    DEV_CHECK_ERR(VertexData.size() == m_VertexData.size(), "The number of vertex buffers (", VertexData.size(),
+                  ") does not match the model vertex layout (", m_VertexData.size(), ")");
+
+    m_IndexData   = std::move(IndexData);
+    m_VertexData  = std::move(VertexData);
+    m_MeshletData = std::move(MeshletData);
+
+    // Hierarchies are not stored in baked files since they are quick to rebuild
+    if (m_CI.BuildCPUBVH)
+    {
+        ScopedLoadStage Stage{m_CI.pLoadStats, MODEL_LOAD_PROFILE_STAGE_GEOMETRY_PROCESSING};
+        BuildMeshBVHs();
+        Stage.AddItems(m_Model.MeshBVHs.size(), 0);
+    }
+
+    InitBuffers(pDevice, pContext);
+
+    if (pContext != nullptr)
+    {
+        m_Model.PrepareGPUResources(pDevice, pContext);
+    }
+}
+
+namespace
+{
+
+// Vertex cache optimization based on Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+// (https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html).
+class VertexCacheOptimizer
+{
+public:
+    static constexpr Uint32 CacheSize = 32;
+
+    VertexCacheOptimizer(const Uint32* pIndices, Uint32 IndexCount, Uint32 VertexCount) :
+        m_pIndices{pIndices},
+        m_NumTriangles{IndexCount / 3},
+        m_Vertices(VertexCount),
+        m_TriangleScores(m_NumTriangles, 0.f),
+        m_TriangleAdded(m_NumTriangles, false)
+    {
+        VERIFY_EXPR(IndexCount % 3 == 0);
+
+        // Build vertex-triangle adjacency
+        for (Uint32 i = 0; i < IndexCount; ++i)
+            ++m_Vertices[pIndices[i]].NumActiveTriangles;
+
+        Uint32 Offset = 0;
+        for (auto& Vert : m_Vertices)
+        {
+            Vert.FirstTriangle = Offset;
+            Offset += Vert.NumActiveTriangles;
+            Vert.NumActiveTriangles = 0;
+        }
+
+        m_VertexTriangles.resize(IndexCount);
+        for (Uint32 tri = 0; tri < m_NumTriangles; ++tri)
+        {
+            for (Uint32 v = 0; v < 3; ++v)
+            {
+                auto& Vert = m_Vertices[pIndices[tri * 3 + v]];
+                m_VertexTriangles[Vert.FirstTriangle + Vert.NumActiveTriangles++] = tri;
+            }
+        }
+
+        for (auto& Vert : m_Vertices)
+            Vert.Score = ComputeVertexScore(Vert);
+
+        for (Uint32 tri = 0; tri < m_NumTriangles; ++tri)
+            m_TriangleScores[tri] = ComputeTriangleScore(tri);
+    }
+
+    void Optimize(Uint32* pDstIndices)
+    {
+        std::array<Uint32, CacheSize + 3> Cache{};
+        std::array<Uint32, CacheSize + 3> NewCache{};
+
+        Uint32 CacheCount    = 0;
+        Uint32 NextTriToScan = 0;
+        Uint32 NumTrisAdded  = 0;
+        Int32  BestTriangle  = FindNextTriangle(NextTriToScan);
+        while (BestTriangle >= 0)
+        {
+            const auto Tri = static_cast<Uint32>(BestTriangle);
+
+            m_TriangleAdded[Tri] = true;
+            for (Uint32 v = 0; v < 3; ++v)
+            {
+                const auto VertIdx = m_pIndices[Tri * 3 + v];
+                *(pDstIndices++)   = VertIdx;
+
+                // Remove the triangle from the vertex adjacency list
+                auto& Vert        = m_Vertices[VertIdx];
+                auto* pTriangles  = &m_VertexTriangles[Vert.FirstTriangle];
+                auto* pTriEnd     = pTriangles + Vert.NumActiveTriangles;
+                auto* pTriToErase = std::find(pTriangles, pTriEnd, Tri);
+                VERIFY_EXPR(pTriToErase != pTriEnd);
+                *pTriToErase = *(pTriEnd - 1);
+                --Vert.NumActiveTriangles;
+            }
+            ++NumTrisAdded;
+
+            // Move the triangle vertices to the front of the LRU cache
+            Uint32 NewCacheCount = 0;
+            for (Uint32 v = 0; v < 3; ++v)
+                NewCache[NewCacheCount++] = m_pIndices[Tri * 3 + v];
+            for (Uint32 i = 0; i < CacheCount; ++i)
+            {
+                const auto VertIdx = Cache[i];
+                if (VertIdx != m_pIndices[Tri * 3 + 0] && VertIdx != m_pIndices[Tri * 3 + 1] && VertIdx != m_pIndices[Tri * 3 + 2])
+                    NewCache[NewCacheCount++] = VertIdx;
+            }
+            std::swap(Cache, NewCache);
+            CacheCount = NewCacheCount;
+
+            // Update vertex scores and find the best triangle adjacent to the cache
+            for (Uint32 i = 0; i < CacheCount; ++i)
+            {
+                auto& Vert         = m_Vertices[Cache[i]];
+                Vert.CachePosition = i < CacheSize ? static_cast<Int32>(i) : -1;
+                Vert.Score         = ComputeVertexScore(Vert);
+            }
+
+            BestTriangle    = -1;
+            float BestScore = -1;
+            for (Uint32 i = 0; i < CacheCount; ++i)
+            {
+                const auto& Vert = m_Vertices[Cache[i]];
+                for (Uint32 t = 0; t < Vert.NumActiveTriangles; ++t)
+                {
+                    const auto AdjTri = m_VertexTriangles[Vert.FirstTriangle + t];
+
+                    m_TriangleScores[AdjTri] = ComputeTriangleScore(AdjTri);
+                    if (m_TriangleScores[AdjTri] > BestScore)
+                    {
+                        BestScore    = m_TriangleScores[AdjTri];
+                        BestTriangle = static_cast<Int32>(AdjTri);
+                    }
+                }
+            }
+
+            // Vertices that have been pushed out of the cache
+            CacheCount = std::min(CacheCount, Uint32{CacheSize});
+
+            if (BestTriangle < 0 && NumTrisAdded < m_NumTriangles)
+                BestTriangle = FindNextTriangle(NextTriToScan);
+        }
+        VERIFY_EXPR(NumTrisAdded == m_NumTriangles);
+    }
+
+private:
+    struct VertexInfo
+    {
+        Uint32 FirstTriangle      = 0;
+        Uint32 NumActiveTriangles = 0;
+        Int32  CachePosition      = -1;
+        float  Score              = 0;
+    };
+
+    static float ComputeVertexScore(const VertexInfo& Vert)
+    {
+        if (Vert.NumActiveTriangles == 0)
+        {
+            // No triangles use this vertex
+            return -1;
+        }
+
+        static constexpr float CacheDecayPower   = 1.5f;
+        static constexpr float LastTriScore      = 0.75f;
+        static constexpr float ValenceBoostScale = 2.0f;
+        static constexpr float ValenceBoostPower = 0.5f;
+
+        float Score = 0;
+        if (Vert.CachePosition >= 0)
+        {
+            if (Vert.CachePosition < 3)
+            {
+                // This vertex was used in the last triangle, so it has a fixed score,
+                // whichever of the three it's in.
+                Score = LastTriScore;
+            }
+            else
+            {
+                // Points for being high in the cache
+                constexpr float Scaler = 1.0f / (CacheSize - 3);
+                Score                  = std::pow(1.0f - static_cast<float>(Vert.CachePosition - 3) * Scaler, CacheDecayPower);
+            }
+        }
+
+        // Bonus points for having a low number of triangles left to use the vertex
+        Score += ValenceBoostScale * std::pow(static_cast<float>(Vert.NumActiveTriangles), -ValenceBoostPower);
+
+        return Score;
+    }
+
+    float ComputeTriangleScore(Uint32 Tri) const
+    {
+        return m_Vertices[m_pIndices[Tri * 3 + 0]].Score +
+            m_Vertices[m_pIndices[Tri * 3 + 1]].Score +
+            m_Vertices[m_pIndices[Tri * 3 + 2]].Score;
+    }
+
+    // Finds the next triangle that has not been added yet when no triangle is adjacent to the cache.
+    Int32 FindNextTriangle(Uint32& NextTriToScan) const
+    {
+        for (; NextTriToScan < m_NumTriangles; ++NextTriToScan)
+        {
+            if (!m_TriangleAdded[NextTriToScan])
+                return static_cast<Int32>(NextTriToScan);
+        }
+        return -1;
+    }
+
+private:
+    const Uint32* const m_pIndices;
+    const Uint32        m_NumTriangles;
+
+    std::vector<VertexInfo> m_Vertices;
+    std::vector<Uint32>     m_VertexTriangles;
+    std::vector<float>      m_TriangleScores;
+    std::vector<bool>       m_TriangleAdded;
+};
+
+// Returns the number of vertex transforms for the given index list assuming FIFO cache of the specified size.
+Uint32 CountVertexCacheMisses(const Uint32* pIndices, Uint32 IndexCount, Uint32 VertexCount, Uint32 CacheSize = 16)
+{
+    // Timestamp of the moment when the vertex was added to the cache
+    std::vector<Uint32> CacheTimestamps(VertexCount, 0);
+
+    Uint32 Timestamp = CacheSize + 1;
+    Uint32 NumMisses = 0;
+    for (Uint32 i = 0; i < IndexCount; ++i)
+    {
+        const auto VertIdx = pIndices[i];
+        if (Timestamp - CacheTimestamps[VertIdx] > CacheSize)
+        {
+            CacheTimestamps[VertIdx] = Timestamp++;
+            ++NumMisses;
+        }
+    }
+    return NumMisses;
+}
+
+} // namespace
+
+void ModelBuilder::FlattenStaticNodes(int FlattenedNodeId)
+{
+    auto& FlatNode = m_Model.LinearNodes[FlattenedNodeId];
+    auto& FlatMesh = m_Model.Meshes.back();
+    FlatNode.Name  = "Flattened static nodes";
+    m_Model.RootNodes.push_back(&FlatNode);
+
+    const VertexAttributeDesc* pPosAttrib     = nullptr;
+    const VertexAttributeDesc* pNormalAttrib  = nullptr;
+    const VertexAttributeDesc* pTangentAttrib = nullptr;
+    for (Uint32 i = 0; i < m_Model.GetNumVertexAttributes(); ++i)
+    {
+        const auto& Attrib = m_Model.VertexAttributes[i];
+        if (strcmp(Attrib.Name, "POSITION") == 0)
+            pPosAttrib = &Attrib;
+        else if (strcmp(Attrib.Name, "NORMAL") == 0)
+            pNormalAttrib = &Attrib;
+        else if (strcmp(Attrib.Name, "TANGENT") == 0)
+            pTangentAttrib = &Attrib;
+    }
+    for (const auto* pAttrib : {pPosAttrib, pNormalAttrib, pTangentAttrib})
+    {
+        if (pAttrib != nullptr && (pAttrib->ValueType != VT_FLOAT32 || pAttrib->NumComponents < 3 || pAttrib->Encoding != VERTEX_ATTRIBUTE_ENCODING_NONE))
+        {
+            LOG_WARNING_MESSAGE("Static nodes can't be flattened: ", pAttrib->Name, " attribute must use 3 or more 32-bit float components without encoding");
+            return;
+        }
+    }
+    if (pPosAttrib == nullptr)
+        return;
+
+    // Rest-pose transforms. NodeTransformOrder has been initialized.
+    ModelTransforms Transforms;
+    m_Model.ComputeTransforms(Transforms);
+
+    // Nodes that are animated themselves or through their parents
+    const auto        NumNodes = m_Model.LinearNodes.size();
+    std::vector<bool> IsAnimated(NumNodes, false);
+    for (const auto& Anim : m_Model.Animations)
+    {
+        for (const auto& Channel : Anim.Channels)
+        {
+            if (Channel.PathType != AnimationChannel::PATH_TYPE::WEIGHTS)
+                IsAnimated[Channel.pNode->Index] = true;
+        }
+    }
+    for (const auto& Entry : m_Model.NodeTransformOrder)
+    {
+        if (Entry.ParentIndex >= 0 && IsAnimated[Entry.ParentIndex])
+            IsAnimated[Entry.NodeIndex] = true;
+    }
+
+    // Ranges of the primitives of every mesh in m_PrimitiveRanges
+    std::vector<std::vector<Uint32>> MeshPrimRanges(m_Model.Meshes.size());
+    for (Uint32 i = 0; i < m_PrimitiveRanges.size(); ++i)
+    {
+        const auto& Range = m_PrimitiveRanges[i];
+        auto&       Prims = MeshPrimRanges[Range.MeshId];
+        if (Prims.size() <= Range.PrimitiveId)
+            Prims.resize(Range.PrimitiveId + 1, ~0u);
+        Prims[Range.PrimitiveId] = i;
+    }
+
+    // Source primitives grouped by material
+    struct SourcePrimitive
+    {
+        Uint32 NodeIndex;
+        Uint32 RangeIdx;
+    };
+    std::map<Uint32, std::vector<SourcePrimitive>> MaterialGroups;
+
+    std::vector<Uint32> FlattenedNodes;
+    for (const auto& Entry : m_Model.NodeTransformOrder)
+    {
+        const auto& N = m_Model.LinearNodes[Entry.NodeIndex];
+        if (N.pMesh == nullptr || N.pSkin != nullptr || N.MorphWeightsOffset >= 0 || N.NumInstances > 0 ||
+            IsAnimated[N.Index] || N.Index == FlattenedNodeId || !N.pMesh->MorphTargets.empty())
+            continue;
+
+        const auto  MeshId = static_cast<size_t>(N.pMesh - m_Model.Meshes.data());
+        const auto& Prims  = MeshPrimRanges[MeshId];
+        if (Prims.size() != N.pMesh->Primitives.size())
+            continue;
+
+        bool CanFlatten = true;
+        for (const auto RangeIdx : Prims)
+        {
+            if (RangeIdx == ~0u || m_PrimitiveRanges[RangeIdx].IndexCount == 0 || m_PrimitiveRanges[RangeIdx].IndexCount % 3 != 0)
+            {
+                CanFlatten = false;
+                break;
+            }
+        }
+        if (!CanFlatten)
+            continue;
+
+        for (const auto RangeIdx : Prims)
+        {
+            const auto& Range = m_PrimitiveRanges[RangeIdx];
+            MaterialGroups[N.pMesh->Primitives[Range.PrimitiveId].MaterialId].push_back({static_cast<Uint32>(N.Index), RangeIdx});
+        }
+        FlattenedNodes.push_back(static_cast<Uint32>(N.Index));
+    }
+    if (FlattenedNodes.empty())
+        return;
+
+    size_t VertexBuffId = 0;
+    while (VertexBuffId < m_VertexData.size() && (m_Model.Buffers[VertexBuffId].ElementStride == 0 || m_VertexData[VertexBuffId].empty()))
+        ++VertexBuffId;
+    if (VertexBuffId == m_VertexData.size())
+        return;
+
+    // Vertices of a node primitive are copied once for every material group that uses them
+    std::map<std::pair<Uint32, Uint32>, Uint32> GroupVertexStarts;
+
+    Uint32 NumVertices    = StaticCast<Uint32>(m_VertexData[VertexBuffId].size() / m_Model.Buffers[VertexBuffId].ElementStride);
+    Uint32 NumNewVertices = 0;
+    Uint32 NumNewIndices  = 0;
+    for (const auto& Group : MaterialGroups)
+    {
+        GroupVertexStarts.clear();
+        for (const auto& Src : Group.second)
+        {
+            const auto& Range = m_PrimitiveRanges[Src.RangeIdx];
+            if (GroupVertexStarts.emplace(std::make_pair(Src.NodeIndex, Range.VertexStart), 0).second)
+                NumNewVertices += Range.VertexCount;
+            NumNewIndices += Range.IndexCount;
+        }
+    }
+
+    auto& IndexSize = m_Model.Buffers.back().ElementStride;
+    if (IndexSize == 2 && size_t{NumVertices} + NumNewVertices > 0xFFFFu)
+    {
+        if (m_CI.IndexType != VT_UNDEFINED)
+        {
+            LOG_WARNING_MESSAGE("Static nodes can't be flattened: the merged vertices can't be addressed by 16-bit indices");
+            return;
+        }
+
+        // The index type was selected automatically and can still be changed
+        std::vector<Uint8> WideIndices(m_IndexData.size() * 2);
+        for (size_t i = 0; i < m_IndexData.size() / 2; ++i)
+            reinterpret_cast<Uint32*>(WideIndices.data())[i] = reinterpret_cast<const Uint16*>(m_IndexData.data())[i];
+        m_IndexData.swap(WideIndices);
+        IndexSize = 4;
+    }
+
+    const auto ReadIndex = [&](size_t Idx) -> Uint32 {
+        return IndexSize == 4 ?
+            reinterpret_cast<const Uint32*>(m_IndexData.data())[Idx] :
+            reinterpret_cast<const Uint16*>(m_IndexData.data())[Idx];
+    };
+    const auto WriteIndex = [&](size_t Idx, Uint32 Value) {
+        if (IndexSize == 4)
+            reinterpret_cast<Uint32*>(m_IndexData.data())[Idx] = Value;
+        else
+            reinterpret_cast<Uint16*>(m_IndexData.data())[Idx] = static_cast<Uint16>(Value);
+    };
+
+    for (size_t BuffId = 0; BuffId < m_VertexData.size(); ++BuffId)
+    {
+        if (!m_VertexData[BuffId].empty())
+            m_VertexData[BuffId].reserve(m_VertexData[BuffId].size() + size_t{NumNewVertices} * m_Model.Buffers[BuffId].ElementStride);
+    }
+    Uint32 NumIndices = StaticCast<Uint32>(m_IndexData.size() / IndexSize);
+    m_IndexData.resize(m_IndexData.size() + size_t{NumNewIndices} * IndexSize);
+
+    const auto ReadFloat3 = [](const Uint8* pData) {
+        float3 Value;
+        memcpy(&Value, pData, sizeof(Value));
+        return Value;
+    };
+    const auto WriteFloat3 = [](Uint8* pData, const float3& Value) {
+        memcpy(pData, &Value, sizeof(Value));
+    };
+
+    const auto FlatMeshId = static_cast<Uint32>(m_Model.Meshes.size() - 1);
+    for (const auto& Group : MaterialGroups)
+    {
+        const auto FirstIndex  = NumIndices;
+        const auto VertexStart = NumVertices;
+
+        float3 BBMin{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+        float3 BBMax{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+        GroupVertexStarts.clear();
+        for (const auto& Src : Group.second)
+        {
+            const auto& Range   = m_PrimitiveRanges[Src.RangeIdx];
+            const auto& NodeMat = Transforms.NodeGlobalMatrices[Src.NodeIndex];
+            // Mirroring transforms flip the triangle winding
+            const bool FlipWinding = NodeMat.Determinant() < 0;
+
+            auto it = GroupVertexStarts.emplace(std::make_pair(Src.NodeIndex, Range.VertexStart), NumVertices);
+            if (it.second)
+            {
+                // Copy the vertices and transform them into the model space
+                const auto NormalMat = NodeMat.Inverse().Transpose();
+                for (size_t BuffId = 0; BuffId < m_VertexData.size(); ++BuffId)
+                {
+                    auto& Data = m_VertexData[BuffId];
+                    if (Data.empty())
+                        continue;
+
+                    const auto Stride = size_t{m_Model.Buffers[BuffId].ElementStride};
+                    const auto Offset = Data.size();
+                    Data.resize(Offset + Range.VertexCount * Stride);
+                    memcpy(&Data[Offset], &Data[Range.VertexStart * Stride], Range.VertexCount * Stride);
+                }
+
+                for (Uint32 v = 0; v < Range.VertexCount; ++v)
+                {
+                    const auto Vert = size_t{NumVertices} + v;
+
+                    auto*      pPos = &m_VertexData[pPosAttrib->BufferId][Vert * m_Model.Buffers[pPosAttrib->BufferId].ElementStride + pPosAttrib->RelativeOffset];
+                    const auto Pos4 = float4{ReadFloat3(pPos), 1} * NodeMat;
+                    const auto Pos  = float3{Pos4.x, Pos4.y, Pos4.z};
+                    WriteFloat3(pPos, Pos);
+                    BBMin = std::min(BBMin, Pos);
+                    BBMax = std::max(BBMax, Pos);
+
+                    if (pNormalAttrib != nullptr)
+                    {
+                        auto* pNormal = &m_VertexData[pNormalAttrib->BufferId][Vert * m_Model.Buffers[pNormalAttrib->BufferId].ElementStride + pNormalAttrib->RelativeOffset];
+                        const auto Normal = float4{ReadFloat3(pNormal), 0} * NormalMat;
+                        WriteFloat3(pNormal, normalize(float3{Normal.x, Normal.y, Normal.z}));
+                    }
+
+                    if (pTangentAttrib != nullptr)
+                    {
+                        auto* pTangent = &m_VertexData[pTangentAttrib->BufferId][Vert * m_Model.Buffers[pTangentAttrib->BufferId].ElementStride + pTangentAttrib->RelativeOffset];
+                        const auto Tangent = float4{ReadFloat3(pTangent), 0} * NodeMat;
+                        WriteFloat3(pTangent, normalize(float3{Tangent.x, Tangent.y, Tangent.z}));
+                        if (FlipWinding && pTangentAttrib->NumComponents >= 4)
+                        {
+                            // The bitangent sign is stored in the w component
+                            float w;
+                            memcpy(&w, pTangent + sizeof(float3), sizeof(w));
+                            w = -w;
+                            memcpy(pTangent + sizeof(float3), &w, sizeof(w));
+                        }
+                    }
+                }
+                NumVertices += Range.VertexCount;
+            }
+            else
+            {
+                // The vertices have already been copied by another primitive of the node
+                const auto& Prim = m_Model.Meshes[Range.MeshId].Primitives[Range.PrimitiveId];
+                const auto  BB   = Prim.BB.Transform(NodeMat);
+                BBMin            = std::min(BBMin, BB.Min);
+                BBMax            = std::max(BBMax, BB.Max);
+            }
+
+            const auto NewVertexStart = it.first->second;
+            for (Uint32 i = 0; i < Range.IndexCount; i += 3)
+            {
+                const auto Src0 = size_t{Range.FirstIndex} + i;
+                Uint32     Tri[3];
+                for (Uint32 c = 0; c < 3; ++c)
+                    Tri[c] = std::min(ReadIndex(Src0 + c) - Range.VertexStart, Range.VertexCount - 1) + NewVertexStart;
+                if (FlipWinding)
+                    std::swap(Tri[1], Tri[2]);
+                for (Uint32 c = 0; c < 3; ++c)
+                    WriteIndex(size_t{NumIndices} + i + c, Tri[c]);
+            }
+
+            FlattenedPrimitiveRange FlatRange;
+            FlatRange.FirstIndex     = NumIndices;
+            FlatRange.IndexCount     = Range.IndexCount;
+            FlatRange.NodeIndex      = Src.NodeIndex;
+            FlatRange.MeshIndex      = Range.MeshId;
+            FlatRange.PrimitiveIndex = Range.PrimitiveId;
+            m_Model.FlattenedRanges.push_back(FlatRange);
+
+            NumIndices += Range.IndexCount;
+        }
+
+        const auto PrimId = static_cast<Uint32>(FlatMesh.Primitives.size());
+        FlatMesh.Primitives.emplace_back(FirstIndex, NumIndices - FirstIndex, NumVertices - VertexStart, Group.first, BBMin, BBMax);
+        FlatMesh.Primitives.back().FirstVertex = VertexStart;
+        m_PrimitiveRanges.push_back({FirstIndex, NumIndices - FirstIndex, VertexStart, NumVertices - VertexStart, FlatMeshId, PrimId});
+    }
+    VERIFY_EXPR(NumIndices * IndexSize == m_IndexData.size());
+
+    FlatMesh.Name = FlatNode.Name;
+    FlatMesh.BB   = FlatMesh.Primitives[0].BB;
+    for (const auto& Prim : FlatMesh.Primitives)
+    {
+        FlatMesh.BB.Min = std::min(FlatMesh.BB.Min, Prim.BB.Min);
+        FlatMesh.BB.Max = std::max(FlatMesh.BB.Max, Prim.BB.Max);
+    }
+    FlatNode.pMesh = &FlatMesh;
+
+    for (const auto NodeIdx : FlattenedNodes)
+        m_Model.LinearNodes[NodeIdx].pMesh = nullptr;
+
+    // Exclude the flattened nodes from the transform update
+    m_Model.InitNodeTransformOrder();
+
+    LOG_INFO_MESSAGE("Flattened ", FlattenedNodes.size(), " static nodes into ", FlatMesh.Primitives.size(), " primitives");
+}
+
+void ModelBuilder::OptimizeVertexCache()
+{
+    const auto IndexSize = m_Model.Buffers.back().ElementStride;
+    VERIFY_EXPR(IndexSize == 4 || IndexSize == 2);
+
+    const auto ReadIndex = [&](size_t Idx) -> Uint32 {
+        return IndexSize == 4 ?
+            reinterpret_cast<const Uint32*>(m_IndexData.data())[Idx] :
+            reinterpret_cast<const Uint16*>(m_IndexData.data())[Idx];
+    };
+    const auto WriteIndex = [&](size_t Idx, Uint32 Value) {
+        if (IndexSize == 4)
+            reinterpret_cast<Uint32*>(m_IndexData.data())[Idx] = Value;
+        else
+            reinterpret_cast<Uint16*>(m_IndexData.data())[Idx] = static_cast<Uint16>(Value);
+    };
+
+    // Primitives that share the same vertex data must be processed together
+    // since vertex reordering affects all of them.
+    std::unordered_map<Uint32, std::vector<const PrimitiveRange*>> VertexRangeToPrimitives;
+    for (const auto& Range : m_PrimitiveRanges)
+        VertexRangeToPrimitives[Range.VertexStart].push_back(&Range);
+
+    Uint32 TotalTriangles  = 0;
+    Uint32 MissesBefore    = 0;
+    Uint32 MissesAfter     = 0;
+    Uint32 NumSkippedPrims = 0;
+
+    std::vector<Uint32> Indices;
+    std::vector<Uint32> SegmentIndices;
+    std::vector<Uint32> OptimizedIndices;
+    std::vector<Uint32> VertexRemap;
+    std::vector<Uint8>  VertexDataCopy;
+
+    // Morph target deltas reference vertices by index and must be remapped as well
+    std::vector<Uint32> MorphVertexRemap;
+    if (!m_Model.MorphTargetDeltas.empty())
+    {
+        MorphVertexRemap.resize(m_VertexData[0].size() / m_Model.Buffers[0].ElementStride);
+        std::iota(MorphVertexRemap.begin(), MorphVertexRemap.end(), Uint32{0});
+    }
+
+    for (const auto& it : VertexRangeToPrimitives)
+    {
+        const auto& Prims = it.second;
+
+        const auto VertexStart = it.first;
+        const auto VertexCount = Prims[0]->VertexCount;
+
+        bool CanReorderVertices = true;
+        for (const auto* pRange : Prims)
+        {
+            VERIFY_EXPR(pRange->VertexCount == VertexCount);
+            if (pRange->IndexCount == 0 || pRange->IndexCount % 3 != 0)
+            {
+                // Non-indexed primitives reference vertices directly
+                CanReorderVertices = false;
+                ++NumSkippedPrims;
+                continue;
+            }
+
+            // Optimize triangle order
+            Indices.resize(pRange->IndexCount);
+            for (Uint32 i = 0; i < pRange->IndexCount; ++i)
+            {
+                const auto VertIdx = ReadIndex(size_t{pRange->FirstIndex} + i) - VertexStart;
+                VERIFY(VertIdx < VertexCount, "Index is out of range");
+                Indices[i] = std::min(VertIdx, VertexCount - 1);
+            }
+
+            // Triangles of flattened primitives are only reordered within their source
+            // ranges so that Model::FlattenedRanges remain valid.
+            OptimizedIndices.resize(pRange->IndexCount);
+            for (Uint32 First = 0; First < pRange->IndexCount;)
+            {
+                Uint32 Count = pRange->IndexCount - First;
+                if (const auto* pFlatRange = m_Model.FindFlattenedRange(pRange->FirstIndex + First))
+                    Count = std::min(Count, pFlatRange->FirstIndex + pFlatRange->IndexCount - (pRange->FirstIndex + First));
+
+                // Vertices of a source range are contiguous, so the optimizer only needs to track that range
+                const auto MinMaxVert = std::minmax_element(Indices.begin() + First, Indices.begin() + First + Count);
+                const auto MinVert    = *MinMaxVert.first;
+                SegmentIndices.resize(Count);
+                for (Uint32 i = 0; i < Count; ++i)
+                    SegmentIndices[i] = Indices[First + i] - MinVert;
+                VertexCacheOptimizer{SegmentIndices.data(), Count, *MinMaxVert.second - MinVert + 1}.Optimize(OptimizedIndices.data() + First);
+                for (Uint32 i = 0; i < Count; ++i)
+                    OptimizedIndices[First + i] += MinVert;
+                First += Count;
+            }
+
+            TotalTriangles += pRange->IndexCount / 3;
+            MissesBefore += CountVertexCacheMisses(Indices.data(), pRange->IndexCount, VertexCount);
+            MissesAfter += CountVertexCacheMisses(OptimizedIndices.data(), pRange->IndexCount, VertexCount);
+
+            for (Uint32 i = 0; i < pRange->IndexCount; ++i)
+                WriteIndex(size_t{pRange->FirstIndex} + i, OptimizedIndices[i] + VertexStart);
+        }
+
+        if (!CanReorderVertices)
+            continue;
+
+        // Reorder vertices in the order of their first use
+        static constexpr Uint32 InvalidIndex = ~0u;
+        VertexRemap.assign(VertexCount, InvalidIndex);
+
+        Uint32 NumRemappedVerts = 0;
+        for (const auto* pRange : Prims)
+        {
+            for (Uint32 i = 0; i < pRange->IndexCount; ++i)
+            {
+                const auto VertIdx = ReadIndex(size_t{pRange->FirstIndex} + i) - VertexStart;
+                if (VertexRemap[VertIdx] == InvalidIndex)
+                    VertexRemap[VertIdx] = NumRemappedVerts++;
+            }
+        }
+        // Keep unreferenced vertices at the end
+        for (auto& NewIdx : VertexRemap)
+        {
+            if (NewIdx == InvalidIndex)
+                NewIdx = NumRemappedVerts++;
+        }
+        VERIFY_EXPR(NumRemappedVerts == VertexCount);
+
+        for (size_t BuffId = 0; BuffId < m_VertexData.size(); ++BuffId)
+        {
+            const auto Stride = m_Model.Buffers[BuffId].ElementStride;
+            if (m_VertexData[BuffId].empty())
+                continue;
+
+            auto* pData = &m_VertexData[BuffId][size_t{VertexStart} * Stride];
+            VertexDataCopy.assign(pData, pData + size_t{VertexCount} * Stride);
+            for (Uint32 v = 0; v < VertexCount; ++v)
+                memcpy(pData + size_t{VertexRemap[v]} * Stride, &VertexDataCopy[size_t{v} * Stride], Stride);
+        }
+
+        for (const auto* pRange : Prims)
+        {
+            for (Uint32 i = 0; i < pRange->IndexCount; ++i)
+            {
+                const auto Idx = size_t{pRange->FirstIndex} + i;
+                WriteIndex(Idx, VertexRemap[ReadIndex(Idx) - VertexStart] + VertexStart);
+            }
+        }
+
+        if (!MorphVertexRemap.empty())
+        {
+            for (Uint32 v = 0; v < VertexCount; ++v)
+                MorphVertexRemap[size_t{VertexStart} + v] = VertexStart + VertexRemap[v];
+        }
+    }
+
+    if (!MorphVertexRemap.empty())
+    {
+        auto& Deltas = m_Model.MorphTargetDeltas;
+        for (auto& Delta : Deltas)
+            Delta.Vertex = MorphVertexRemap[Delta.Vertex];
+
+        // Keep the deltas of every target sorted by the vertex index
+        for (const auto& M : m_Model.Meshes)
+        {
+            for (const auto& Target : M.MorphTargets)
+            {
+                std::sort(Deltas.begin() + Target.FirstDelta, Deltas.begin() + Target.FirstDelta + Target.NumDeltas,
+                          [](const MorphTargetDelta& lhs, const MorphTargetDelta& rhs) {
+                              return lhs.Vertex < rhs.Vertex;
+                          });
+            }
+        }
+    }
+
+    if (TotalTriangles > 0)
+    {
+        LOG_INFO_MESSAGE("Optimized vertex cache for ", TotalTriangles, " triangles. ACMR: ",
+                         static_cast<float>(MissesBefore) / static_cast<float>(TotalTriangles), " -> ",
+                         static_cast<float>(MissesAfter) / static_cast<float>(TotalTriangles),
+                         (NumSkippedPrims > 0 ? ". Non-indexed primitives skipped: " : ""),
+                         (NumSkippedPrims > 0 ? std::to_string(NumSkippedPrims) : ""));
+    }
+}
+
+namespace
+{
+
+// Symmetric 4x4 quadric matrix used to estimate the squared distance to a set of planes.
+struct Quadric
+{
+    double a00 = 0, a01 = 0, a02 = 0, a03 = 0;
+    double a11 = 0, a12 = 0, a13 = 0;
+    double a22 = 0, a23 = 0;
+    double a33 = 0;
+
+    static Quadric FromPlane(double a, double b, double c, double d)
+    {
+        Quadric Q;
+        Q.a00 = a * a;
+        Q.a01 = a * b;
+        Q.a02 = a * c;
+        Q.a03 = a * d;
+        Q.a11 = b * b;
+        Q.a12 = b * c;
+        Q.a13 = b * d;
+        Q.a22 = c * c;
+        Q.a23 = c * d;
+        Q.a33 = d * d;
+        return Q;
+    }
+
+    Quadric& operator+=(const Quadric& Q)
+    {
+        a00 += Q.a00;
+        a01 += Q.a01;
+        a02 += Q.a02;
+        a03 += Q.a03;
+        a11 += Q.a11;
+        a12 += Q.a12;
+        a13 += Q.a13;
+        a22 += Q.a22;
+        a23 += Q.a23;
+        a33 += Q.a33;
+        return *this;
+    }
+
+    double Evaluate(const float3& v) const
+    {
+        const double x = v.x, y = v.y, z = v.z;
+        return a00 * x * x + 2 * a01 * x * y + 2 * a02 * x * z + 2 * a03 * x +
+            a11 * y * y + 2 * a12 * y * z + 2 * a13 * y +
+            a22 * z * z + 2 * a23 * z +
+            a33;
+    }
+};
+
+// Simplifies the triangle list by collapsing edges in the order of increasing quadric error
+// (Garland & Heckbert, "Surface Simplification Using Quadric Error Metrics").
+// Vertices on mesh boundaries and on attribute seams (vertices that share the same position)
+// are never moved, so that the simplified mesh has no cracks.
+// Returns the approximate geometric error of the simplified mesh.
+float SimplifyMesh(const float3* pPositions, Uint32 VertexCount, std::vector<Uint32>& Indices, Uint32 TargetIndexCount)
+{
+    VERIFY_EXPR(Indices.size() % 3 == 0);
+
+    const auto MakeEdgeKey = [](Uint32 v0, Uint32 v1) {
+        return (Uint64{std::min(v0, v1)} << 32u) | Uint64{std::max(v0, v1)};
+    };
+
+    // Lock boundary and seam vertices
+    std::vector<bool> Locked(VertexCount, false);
+    {
+        std::unordered_map<Uint64, Uint32> EdgeCounts;
+        for (size_t i = 0; i < Indices.size(); i += 3)
+        {
+            for (size_t e = 0; e < 3; ++e)
+                ++EdgeCounts[MakeEdgeKey(Indices[i + e], Indices[i + (e + 1) % 3])];
+        }
+        for (const auto& it : EdgeCounts)
+        {
+            if (it.second == 1)
+            {
+                Locked[static_cast<Uint32>(it.first >> 32u)]        = true;
+                Locked[static_cast<Uint32>(it.first & 0xFFFFFFFFu)] = true;
+            }
+        }
+
+        std::vector<Uint32> SortedVerts(VertexCount);
+        for (Uint32 v = 0; v < VertexCount; ++v)
+            SortedVerts[v] = v;
+        const auto PosLess = [pPositions](Uint32 v0, Uint32 v1) {
+            const auto& p0 = pPositions[v0];
+            const auto& p1 = pPositions[v1];
+            return p0.x != p1.x ? p0.x < p1.x : (p0.y != p1.y ? p0.y < p1.y : p0.z < p1.z);
+        };
+        std::sort(SortedVerts.begin(), SortedVerts.end(), PosLess);
+        for (Uint32 i = 1; i < VertexCount; ++i)
+        {
+            if (!PosLess(SortedVerts[i - 1], SortedVerts[i]))
+            {
+                Locked[SortedVerts[i - 1]] = true;
+                Locked[SortedVerts[i]]     = true;
+            }
+        }
+    }
+
+    std::vector<Quadric> Quadrics(VertexCount);
+    for (size_t i = 0; i < Indices.size(); i += 3)
+    {
+        const auto& p0 = pPositions[Indices[i + 0]];
+        const auto& p1 = pPositions[Indices[i + 1]];
+        const auto& p2 = pPositions[Indices[i + 2]];
+
+        auto       Normal = cross(p1 - p0, p2 - p0);
+        const auto Len    = length(Normal);
+        if (Len == 0)
+            continue;
+        Normal /= Len;
+
+        const auto Q = Quadric::FromPlane(Normal.x, Normal.y, Normal.z, -dot(Normal, p0));
+        for (size_t v = 0; v < 3; ++v)
+            Quadrics[Indices[i + v]] += Q;
+    }
+
+    struct Collapse
+    {
+        Uint32 Src;
+        Uint32 Dst;
+        double Error;
+    };
+
+    double MaxError = 0;
+
+    std::vector<Uint64>   Edges;
+    std::vector<Collapse> Collapses;
+    std::vector<Uint32>   Remap(VertexCount);
+    std::vector<bool>     Touched(VertexCount);
+    std::vector<Uint32>   VertTriOffsets(VertexCount + 1);
+    std::vector<Uint32>   VertTriangles;
+
+    static constexpr Uint32 MaxPasses = 32;
+    for (Uint32 Pass = 0; Pass < MaxPasses && Indices.size() > TargetIndexCount; ++Pass)
+    {
+        // Collect unique edges
+        Edges.clear();
+        for (size_t i = 0; i < Indices.size(); i += 3)
+        {
+            for (size_t e = 0; e < 3; ++e)
+                Edges.push_back(MakeEdgeKey(Indices[i + e], Indices[i + (e + 1) % 3]));
+        }
+        std::sort(Edges.begin(), Edges.end());
+        Edges.erase(std::unique(Edges.begin(), Edges.end()), Edges.end());
+
+        // Compute collapse costs
+        Collapses.clear();
+        for (auto Edge : Edges)
+        {
+            const auto v0 = static_cast<Uint32>(Edge >> 32u);
+            const auto v1 = static_cast<Uint32>(Edge & 0xFFFFFFFFu);
+
+            auto Q = Quadrics[v0];
+            Q += Quadrics[v1];
+
+            const auto Error0 = !Locked[v0] ? Q.Evaluate(pPositions[v1]) : DBL_MAX;
+            const auto Error1 = !Locked[v1] ? Q.Evaluate(pPositions[v0]) : DBL_MAX;
+            if (Error0 == DBL_MAX && Error1 == DBL_MAX)
+                continue;
+
+            Collapses.push_back(Error0 <= Error1 ?
+                                    Collapse{v0, v1, Error0} :
+                                    Collapse{v1, v0, Error1});
+        }
+        if (Collapses.empty())
+            break;
+
+        std::sort(Collapses.begin(), Collapses.end(), [](const Collapse& lhs, const Collapse& rhs) {
+            return lhs.Error < rhs.Error;
+        });
+
+        // Build vertex-triangle adjacency
+        std::fill(VertTriOffsets.begin(), VertTriOffsets.end(), 0);
+        for (auto Idx : Indices)
+            ++VertTriOffsets[Idx + 1];
+        for (Uint32 v = 0; v < VertexCount; ++v)
+            VertTriOffsets[v + 1] += VertTriOffsets[v];
+        VertTriangles.resize(Indices.size());
+        {
+            auto Offsets = VertTriOffsets;
+            for (size_t i = 0; i < Indices.size(); ++i)
+                VertTriangles[Offsets[Indices[i]]++] = static_cast<Uint32>(i / 3);
+        }
+
+        for (Uint32 v = 0; v < VertexCount; ++v)
+            Remap[v] = v;
+        std::fill(Touched.begin(), Touched.end(), false);
+
+        const auto TargetTriangles  = size_t{TargetIndexCount} / 3;
+        size_t     NumTriangles     = Indices.size() / 3;
+        size_t     NumCollapsesDone = 0;
+        for (const auto& C : Collapses)
+        {
+            if (NumTriangles <= TargetTriangles)
+                break;
+
+            if (Touched[C.Src] || Touched[C.Dst])
+                continue;
+
+            // Reject the collapse if it flips any triangle
+            bool   Flips               = false;
+            size_t NumRemovedTriangles = 0;
+            for (auto t = VertTriOffsets[C.Src]; t < VertTriOffsets[C.Src + 1] && !Flips; ++t)
+            {
+                const auto* pTri = &Indices[size_t{VertTriangles[t]} * 3];
+                if (pTri[0] == C.Dst || pTri[1] == C.Dst || pTri[2] == C.Dst)
+                {
+                    ++NumRemovedTriangles;
+                    continue;
+                }
+
+                float3 p[3], new_p[3];
+                for (size_t v = 0; v < 3; ++v)
+                {
+                    p[v]     = pPositions[pTri[v]];
+                    new_p[v] = pPositions[pTri[v] == C.Src ? C.Dst : pTri[v]];
+                }
+                const auto n0 = cross(p[1] - p[0], p[2] - p[0]);
+                const auto n1 = cross(new_p[1] - new_p[0], new_p[2] - new_p[0]);
+                Flips         = dot(n0, n1) <= 0;
+            }
+            if (Flips)
+                continue;
+
+            Remap[C.Src] = C.Dst;
+            Quadrics[C.Dst] += Quadrics[C.Src];
+            MaxError = std::max(MaxError, C.Error);
+
+            // Do not allow neighbors to collapse in the same pass as adjacency information is now stale
+            for (auto t = VertTriOffsets[C.Src]; t < VertTriOffsets[C.Src + 1]; ++t)
+            {
+                const auto* pTri = &Indices[size_t{VertTriangles[t]} * 3];
+                for (size_t v = 0; v < 3; ++v)
+                    Touched[pTri[v]] = true;
+            }
+
+            NumTriangles -= NumRemovedTriangles;
+            ++NumCollapsesDone;
+        }
+
+        if (NumCollapsesDone == 0)
+            break;
+
+        // Apply remapping and remove degenerate triangles
+        size_t NumIndices = 0;
+        for (size_t i = 0; i < Indices.size(); i += 3)
+        {
+            const auto v0 = Remap[Indices[i + 0]];
+            const auto v1 = Remap[Indices[i + 1]];
+            const auto v2 = Remap[Indices[i + 2]];
+            if (v0 == v1 || v1 == v2 || v2 == v0)
+                continue;
+
+            Indices[NumIndices++] = v0;
+            Indices[NumIndices++] = v1;
+            Indices[NumIndices++] = v2;
+        }
+        Indices.resize(NumIndices);
+    }
+
+    return static_cast<float>(std::sqrt(MaxError));
+}
+
+} // namespace
+
+void ModelBuilder::GenerateLODs()
+{
+    const VertexAttributeDesc* pPosAttrib = nullptr;
+    for (Uint32 i = 0; i < m_Model.GetNumVertexAttributes(); ++i)
+    {
+        if (strcmp(m_Model.VertexAttributes[i].Name, "POSITION") == 0)
+            pPosAttrib = &m_Model.VertexAttributes[i];
+    }
+    if (pPosAttrib == nullptr || pPosAttrib->ValueType == VT_FLOAT16)
+    {
+        LOG_WARNING_MESSAGE("LODs can't be generated: the model has no vertex positions or positions use unsupported format");
+        return;
+    }
+
+    DEV_CHECK_ERR(m_CI.LODReductionFactor > 0 && m_CI.LODReductionFactor < 1, "LOD reduction factor (", m_CI.LODReductionFactor, ") must be in (0, 1) range");
+    const auto ReductionFactor = clamp(m_CI.LODReductionFactor, 0.01f, 0.99f);
+
+    const auto IndexSize = m_Model.Buffers.back().ElementStride;
+    VERIFY_EXPR(IndexSize == 4 || IndexSize == 2);
+
+    std::vector<float3> Positions;
+    std::vector<Uint32> Indices;
+    std::vector<Uint32> OptimizedIndices;
+    for (const auto& Range : m_PrimitiveRanges)
+    {
+        if (Range.IndexCount == 0 || Range.IndexCount % 3 != 0)
+            continue;
+
+        auto& Prim = m_Model.Meshes[Range.MeshId].Primitives[Range.PrimitiveId];
+
+        Positions.resize(Range.VertexCount);
+        for (Uint32 v = 0; v < Range.VertexCount; ++v)
+            Positions[v] = ReadVertexPosition(*pPosAttrib, Range.VertexStart + v, Prim.BB);
+
+        Indices.resize(Range.IndexCount);
+        for (Uint32 i = 0; i < Range.IndexCount; ++i)
+        {
+            const auto Idx  = size_t{Range.FirstIndex} + i;
+            const auto Vert = IndexSize == 4 ?
+                reinterpret_cast<const Uint32*>(m_IndexData.data())[Idx] :
+                reinterpret_cast<const Uint16*>(m_IndexData.data())[Idx];
+            Indices[i] = std::min(Vert - Range.VertexStart, Range.VertexCount - 1);
+        }
+
+        float Error = 0;
+        for (Uint32 lod = 0; lod < m_CI.NumLODs; ++lod)
+        {
+            // Every level is simplified from the previous one
+            const auto PrevIndexCount   = static_cast<Uint32>(Indices.size());
+            const auto TargetIndexCount = static_cast<Uint32>(static_cast<float>(PrevIndexCount / 3) * ReductionFactor) * 3;
+
+            Error = std::max(Error, SimplifyMesh(Positions.data(), Range.VertexCount, Indices, TargetIndexCount));
+            if (Indices.empty() || Indices.size() == PrevIndexCount)
+            {
+                // The mesh can't be simplified any further
+                break;
+            }
+
+            const auto* pLODIndices = Indices.data();
+            if (m_CI.OptimizeVertexCache)
+            {
+                OptimizedIndices.resize(Indices.size());
+                VertexCacheOptimizer{Indices.data(), static_cast<Uint32>(Indices.size()), Range.VertexCount}.Optimize(OptimizedIndices.data());
+                pLODIndices = OptimizedIndices.data();
+            }
+
+            Primitive::LOD LOD;
+            LOD.FirstIndex = static_cast<Uint32>(m_IndexData.size() / IndexSize);
+            LOD.IndexCount = static_cast<Uint32>(Indices.size());
+            LOD.Error      = Error;
+
+            m_IndexData.resize(m_IndexData.size() + Indices.size() * IndexSize);
+            for (Uint32 i = 0; i < LOD.IndexCount; ++i)
+            {
+                const auto Vert = pLODIndices[i] + Range.VertexStart;
+                if (IndexSize == 4)
+                    reinterpret_cast<Uint32*>(m_IndexData.data())[LOD.FirstIndex + i] = Vert;
+                else
+                    reinterpret_cast<Uint16*>(m_IndexData.data())[LOD.FirstIndex + i] = static_cast<Uint16>(Vert);
+            }
+
+            Prim.LODs.push_back(LOD);
         }
     }
 }
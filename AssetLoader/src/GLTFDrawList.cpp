@@ -0,0 +1,297 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFDrawList.hpp"
+
+#include <algorithm>
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+void DrawListBuilder::Reset()
+{
+    m_Instances.clear();
+    m_MaterialOffsets.clear();
+    m_Materials.clear();
+    m_Batches.clear();
+    m_DrawArgs.clear();
+    m_DrawData.clear();
+    m_DrawBounds.clear();
+}
+
+void DrawListBuilder::AddModel(const Model& GLTFModel, const ModelTransforms& Transforms)
+{
+    if (!GLTFModel.IsGPUDataInitialized())
+        return;
+
+    DEV_CHECK_ERR(GLTFModel.CompatibleWithTransforms(Transforms), "Transforms are not compatible with the model");
+    DEV_CHECK_ERR(GLTFModel.GetVertexBufferCount() <= Batch::MaxVertexBuffers, "Too many vertex buffers");
+
+    auto mtl_it = m_MaterialOffsets.find(&GLTFModel);
+    if (mtl_it == m_MaterialOffsets.end())
+    {
+        mtl_it = m_MaterialOffsets.emplace(&GLTFModel, static_cast<Uint32>(m_Materials.size())).first;
+        for (const auto& Mat : GLTFModel.Materials)
+            m_Materials.push_back(Mat.Attribs);
+    }
+
+    InstanceInfo Inst;
+    Inst.pModel         = &GLTFModel;
+    Inst.pTransforms    = &Transforms;
+    Inst.MaterialOffset = mtl_it->second;
+    m_Instances.push_back(Inst);
+}
+
+void DrawListBuilder::AddInstance(const ModelInstance& Instance)
+{
+    const auto& GLTFModel = Instance.GetModel();
+    if (!Instance.HasMaterialOverrides())
+    {
+        AddModel(GLTFModel, Instance.GetTransforms());
+        return;
+    }
+
+    if (!GLTFModel.IsGPUDataInitialized())
+        return;
+
+    DEV_CHECK_ERR(GLTFModel.CompatibleWithTransforms(Instance.GetTransforms()), "Transforms are not compatible with the model");
+    DEV_CHECK_ERR(GLTFModel.GetVertexBufferCount() <= Batch::MaxVertexBuffers, "Too many vertex buffers");
+
+    InstanceInfo Inst;
+    Inst.pModel         = &GLTFModel;
+    Inst.pTransforms    = &Instance.GetTransforms();
+    Inst.MaterialOffset = static_cast<Uint32>(m_Materials.size());
+    Inst.pOverrides     = &Instance;
+    for (Uint32 i = 0; i < GLTFModel.Materials.size(); ++i)
+        m_Materials.push_back(Instance.GetMaterial(i).Attribs);
+    m_Instances.push_back(Inst);
+}
+
+void DrawListBuilder::Commit(IRenderDevice* pDevice, IDeviceContext* pContext)
+{
+    DEV_CHECK_ERR(pDevice != nullptr && pContext != nullptr, "Device and context must not be null");
+
+    m_Batches.clear();
+    m_DrawArgs.clear();
+    m_DrawData.clear();
+    m_DrawBounds.clear();
+
+    // Batch index of every draw command in the order of primitives
+    std::vector<Uint32> DrawBatchIds;
+    for (Uint32 InstIdx = 0; InstIdx < m_Instances.size(); ++InstIdx)
+    {
+        const auto& Inst  = m_Instances[InstIdx];
+        const auto& GLTFModel = *Inst.pModel;
+
+        Batch Key;
+        Key.pIndexBuffer     = GLTFModel.GetIndexBuffer(pDevice, pContext);
+        Key.IndexType        = GLTFModel.GetIndexType();
+        Key.NumVertexBuffers = static_cast<Uint32>(GLTFModel.GetVertexBufferCount());
+        for (Uint32 i = 0; i < Key.NumVertexBuffers; ++i)
+            Key.pVertexBuffers[i] = GLTFModel.GetVertexBuffer(i, pDevice, pContext);
+
+        const auto FirstIndexLocation = GLTFModel.GetFirstIndexLocation();
+        const auto BaseVertex         = GLTFModel.GetBaseVertex();
+        for (Uint32 i = 1; i < Key.NumVertexBuffers; ++i)
+        {
+            // Indirect draw arguments only have one base vertex for all vertex buffers
+            DEV_CHECK_ERR(Key.pVertexBuffers[i] == nullptr || GLTFModel.GetBaseVertex(i) == BaseVertex,
+                          "Base vertex of vertex buffer ", i, " does not match the base vertex of buffer 0. "
+                          "Such models can't be rendered with indirect draw lists.");
+        }
+
+        for (const auto& N : GLTFModel.LinearNodes)
+        {
+            if (N.pMesh == nullptr)
+                continue;
+
+            for (const auto& Prim : N.pMesh->Primitives)
+            {
+                if (!Prim.HasIndices())
+                    continue;
+
+                const auto& Mat = Inst.pOverrides != nullptr ?
+                    Inst.pOverrides->GetMaterial(Prim.MaterialId) :
+                    GLTFModel.Materials[Prim.MaterialId];
+
+                Key.AlphaMode   = static_cast<Material::ALPHA_MODE>(Mat.Attribs.AlphaMode);
+                Key.DoubleSided = Mat.DoubleSided;
+
+                auto batch_it = std::find_if(m_Batches.begin(), m_Batches.end(), [&Key](const Batch& B) {
+                    // clang-format off
+                    return B.pIndexBuffer     == Key.pIndexBuffer     &&
+                           B.IndexType        == Key.IndexType        &&
+                           B.NumVertexBuffers == Key.NumVertexBuffers &&
+                           B.AlphaMode        == Key.AlphaMode        &&
+                           B.DoubleSided      == Key.DoubleSided      &&
+                           std::equal(B.pVertexBuffers, B.pVertexBuffers + B.NumVertexBuffers, Key.pVertexBuffers);
+                    // clang-format on
+                });
+                if (batch_it == m_Batches.end())
+                    batch_it = m_Batches.insert(m_Batches.end(), Key);
+                ++batch_it->NumDraws;
+                DrawBatchIds.push_back(static_cast<Uint32>(batch_it - m_Batches.begin()));
+
+                DrawIndexedArgs Args;
+                Args.NumIndices         = Prim.IndexCount;
+                Args.FirstIndexLocation = FirstIndexLocation + Prim.FirstIndex;
+                Args.BaseVertex         = BaseVertex;
+                m_DrawArgs.push_back(Args);
+
+                DrawData Data;
+                Data.NodeMatrix    = Inst.pTransforms->NodeGlobalMatrices[N.Index];
+                Data.MaterialIndex = Inst.MaterialOffset + Prim.MaterialId;
+                Data.InstanceIndex = InstIdx;
+                m_DrawData.push_back(Data);
+
+                DrawBounds Bounds;
+                Bounds.BBMin = Prim.BB.Min;
+                Bounds.BBMax = Prim.BB.Max;
+                m_DrawBounds.push_back(Bounds);
+            }
+        }
+    }
+
+    // Place draw commands of every batch contiguously, preserving their relative order
+    Uint32 NumDraws = 0;
+    for (auto& B : m_Batches)
+    {
+        B.FirstDraw = NumDraws;
+        NumDraws += B.NumDraws;
+    }
+    VERIFY_EXPR(NumDraws == m_DrawArgs.size());
+
+    {
+        std::vector<Uint32> BatchCursors(m_Batches.size());
+        for (size_t i = 0; i < m_Batches.size(); ++i)
+            BatchCursors[i] = m_Batches[i].FirstDraw;
+
+        std::vector<DrawIndexedArgs> SortedArgs(NumDraws);
+        std::vector<DrawData>        SortedData(NumDraws);
+        std::vector<DrawBounds>      SortedBounds(NumDraws);
+        for (size_t i = 0; i < DrawBatchIds.size(); ++i)
+        {
+            const auto BatchIdx = DrawBatchIds[i];
+            const auto DrawIdx  = BatchCursors[BatchIdx]++;
+
+            SortedArgs[DrawIdx]                       = m_DrawArgs[i];
+            SortedArgs[DrawIdx].FirstInstanceLocation = DrawIdx;
+            SortedData[DrawIdx]                       = m_DrawData[i];
+            SortedBounds[DrawIdx]                     = m_DrawBounds[i];
+            SortedBounds[DrawIdx].BatchFirstDraw      = m_Batches[BatchIdx].FirstDraw;
+        }
+        m_DrawArgs.swap(SortedArgs);
+        m_DrawData.swap(SortedData);
+        m_DrawBounds.swap(SortedBounds);
+    }
+
+    m_Instances.clear();
+
+    if (NumDraws == 0)
+        return;
+
+    const auto UpdateBuffer = [pDevice, pContext](RefCntAutoPtr<IBuffer>& pBuffer, const char* Name, BIND_FLAGS BindFlags, Uint32 ElementStride, const void* pData, Uint64 Size) {
+        if (!pBuffer || pBuffer->GetDesc().Size < Size)
+        {
+            BufferDesc BuffDesc;
+            BuffDesc.Name      = Name;
+            BuffDesc.Size      = pBuffer ? std::max(Size, pBuffer->GetDesc().Size * 2) : Size;
+            BuffDesc.BindFlags = BindFlags;
+            BuffDesc.Usage     = USAGE_DEFAULT;
+            if (BindFlags & BIND_INDIRECT_DRAW_ARGS)
+            {
+                // Indirect argument buffers can't be structured in D3D11, so they are read as raw buffers
+                BuffDesc.Mode              = BUFFER_MODE_RAW;
+                BuffDesc.ElementByteStride = sizeof(Uint32);
+            }
+            else if (BindFlags & BIND_SHADER_RESOURCE)
+            {
+                BuffDesc.Mode              = BUFFER_MODE_STRUCTURED;
+                BuffDesc.ElementByteStride = ElementStride;
+            }
+            pBuffer.Release();
+            pDevice->CreateBuffer(BuffDesc, nullptr, &pBuffer);
+            if (!pBuffer)
+            {
+                LOG_ERROR_MESSAGE("Failed to create ", Name);
+                return;
+            }
+        }
+        pContext->UpdateBuffer(pBuffer, 0, Size, pData, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    };
+
+    UpdateBuffer(m_pDrawArgsBuffer, "GLTF draw list arguments", BIND_INDIRECT_DRAW_ARGS | BIND_SHADER_RESOURCE, sizeof(DrawIndexedArgs),
+                 m_DrawArgs.data(), m_DrawArgs.size() * sizeof(DrawIndexedArgs));
+    UpdateBuffer(m_pDrawDataBuffer, "GLTF draw list data", BIND_SHADER_RESOURCE, sizeof(DrawData),
+                 m_DrawData.data(), m_DrawData.size() * sizeof(DrawData));
+    UpdateBuffer(m_pDrawBoundsBuffer, "GLTF draw list bounds", BIND_SHADER_RESOURCE, sizeof(DrawBounds),
+                 m_DrawBounds.data(), m_DrawBounds.size() * sizeof(DrawBounds));
+    if (!m_Materials.empty())
+    {
+        UpdateBuffer(m_pMaterialBuffer, "GLTF draw list materials", BIND_SHADER_RESOURCE, sizeof(Material::ShaderAttribs),
+                     m_Materials.data(), m_Materials.size() * sizeof(Material::ShaderAttribs));
+    }
+
+    // Draw indices never change, so the buffer only needs to be updated when it grows
+    if (!m_pDrawIndexBuffer || m_pDrawIndexBuffer->GetDesc().Size < Uint64{NumDraws} * sizeof(Uint32))
+    {
+        const Uint32 Capacity = std::max(NumDraws, m_pDrawIndexBuffer ? static_cast<Uint32>(m_pDrawIndexBuffer->GetDesc().Size / sizeof(Uint32)) * 2 : 0u);
+
+        std::vector<Uint32> DrawIndices(Capacity);
+        for (Uint32 i = 0; i < Capacity; ++i)
+            DrawIndices[i] = i;
+
+        BufferDesc BuffDesc;
+        BuffDesc.Name      = "GLTF draw list indices";
+        BuffDesc.Size      = Uint64{Capacity} * sizeof(Uint32);
+        BuffDesc.BindFlags = BIND_VERTEX_BUFFER;
+        BuffDesc.Usage     = USAGE_IMMUTABLE;
+
+        BufferData BuffData{DrawIndices.data(), BuffDesc.Size};
+        m_pDrawIndexBuffer.Release();
+        pDevice->CreateBuffer(BuffDesc, &BuffData, &m_pDrawIndexBuffer);
+    }
+}
+
+DrawIndexedIndirectAttribs DrawListBuilder::GetDrawAttribs(const Batch& B) const
+{
+    DrawIndexedIndirectAttribs Attribs;
+    Attribs.IndexType                        = B.IndexType;
+    Attribs.pAttribsBuffer                   = m_pDrawArgsBuffer;
+    Attribs.DrawArgsOffset                   = Uint64{B.FirstDraw} * sizeof(DrawIndexedArgs);
+    Attribs.DrawCount                        = B.NumDraws;
+    Attribs.DrawArgsStride                   = sizeof(DrawIndexedArgs);
+    Attribs.AttribsBufferStateTransitionMode = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+    return Attribs;
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
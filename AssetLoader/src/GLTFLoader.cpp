@@ -29,6 +29,8 @@
 #include <memory>
 #include <cmath>
 #include <limits>
+#include <algorithm>
+#include <unordered_set>
 
 #include "GLTFLoader.hpp"
 #include "MapHelper.hpp"
@@ -39,16 +41,31 @@
 #include "FileWrapper.hpp"
 #include "GraphicsAccessories.hpp"
 #include "TextureLoader.h"
+#include "JPEGCodec.h"
 #include "TextureUtilities.h"
+#include "BCTools.h"
 #include "GraphicsUtilities.h"
 #include "Align.hpp"
 #include "GLTFBuilder.hpp"
+#include "GLTFMeshoptDecoder.hpp"
 #include "FixedLinearAllocator.hpp"
 #include "DefaultRawMemoryAllocator.hpp"
+#include "ThreadPool.hpp"
+#include "HashUtils.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#    include <xmmintrin.h>
+#    define GLTF_LOADER_USE_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#    include <arm_neon.h>
+#    define GLTF_LOADER_USE_NEON 1
+#endif
 
 #define TINYGLTF_IMPLEMENTATION
 #define TINYGLTF_NO_STB_IMAGE
 #define TINYGLTF_NO_STB_IMAGE_WRITE
+// Draco primitives are decoded in parallel by DecodeDracoPrimitives() rather than while parsing
+#define TINYGLTF_DEFER_DRACO_DECODE
 
 #if defined(_MSC_VER) && defined(TINYGLTF_ENABLE_DRACO)
 #    pragma warning(disable : 4127) // warning C4127: conditional expression is constant
@@ -61,6 +78,86 @@ namespace Diligent
 namespace GLTF
 {
 
+namespace
+{
+
+// Returns the size of all mip levels and array slices of the texture.
+Uint64 GetTextureDataSize(const TextureDesc& TexDesc)
+{
+    Uint64 TexSize = 0;
+    for (Uint32 mip = 0; mip < TexDesc.MipLevels; ++mip)
+        TexSize += GetMipLevelProperties(TexDesc, mip).MipSize;
+    return TexSize * (TexDesc.Type == RESOURCE_DIM_TEX_3D ? 1 : TexDesc.ArraySize);
+}
+
+template <typename T>
+Uint64 GetVectorDataSize(const std::vector<T>& Vec)
+{
+    return Uint64{Vec.capacity()} * sizeof(T);
+}
+
+} // namespace
+
+RefCntAutoPtr<ITexture> TextureCacheType::Find(const std::string& CacheId)
+{
+    RefCntAutoPtr<ITexture> pTexture;
+
+    std::lock_guard<std::mutex> Lock{TexturesMtx};
+
+    auto it = Textures.find(CacheId);
+    if (it != Textures.end())
+    {
+        pTexture = it->second.Lock();
+        if (!pTexture)
+        {
+            // Texture is stale - remove it from the cache
+            Textures.erase(it);
+        }
+    }
+
+    if (pTexture)
+    {
+        ++Stats.NumHits;
+        RetainedTextures.Touch(CacheId);
+    }
+    else
+    {
+        ++Stats.NumMisses;
+    }
+
+    return pTexture;
+}
+
+void TextureCacheType::Add(const std::string& CacheId, ITexture* pTexture)
+{
+    VERIFY_EXPR(pTexture != nullptr);
+
+    const auto TexSize = GetTextureDataSize(pTexture->GetDesc());
+
+    std::lock_guard<std::mutex> Lock{TexturesMtx};
+    PruneExpiredCacheEntries(Textures, PruneThreshold);
+    if (Textures.emplace(CacheId, pTexture).second)
+        RetainedTextures.Retain(CacheId, pTexture, TexSize, RetentionBudget);
+}
+
+void TextureCacheType::SetRetentionBudget(Uint64 Budget)
+{
+    std::lock_guard<std::mutex> Lock{TexturesMtx};
+    RetentionBudget = Budget;
+    RetainedTextures.Trim(Budget);
+}
+
+TextureCacheStats TextureCacheType::GetStats()
+{
+    std::lock_guard<std::mutex> Lock{TexturesMtx};
+
+    auto CurrStats         = Stats;
+    CurrStats.NumEvictions = RetainedTextures.GetNumEvictions();
+    CurrStats.NumRetained  = RetainedTextures.GetCount();
+    CurrStats.RetainedSize = RetainedTextures.GetSize();
+    return CurrStats;
+}
+
 InputLayoutDescX VertexAttributesToInputLayout(const VertexAttributeDesc* pAttributes, size_t NumAttributes)
 {
     VERIFY_EXPR(pAttributes != nullptr || NumAttributes == 0);
@@ -68,7 +165,9 @@ InputLayoutDescX VertexAttributesToInputLayout(const VertexAttributeDesc* pAttri
     for (Uint32 i = 0; i < NumAttributes; ++i)
     {
         const auto& Attrib = pAttributes[i];
-        InputLayout.Add(i, Attrib.BufferId, Attrib.NumComponents, Attrib.ValueType, false, Attrib.RelativeOffset);
+        // All encoded attributes are stored as normalized values, except for half-precision floats
+        const auto IsNormalized = Attrib.Encoding != VERTEX_ATTRIBUTE_ENCODING_NONE;
+        InputLayout.Add(i, Attrib.BufferId, Attrib.NumComponents, Attrib.ValueType, IsNormalized, Attrib.RelativeOffset);
     }
     return InputLayout;
 }
@@ -111,7 +210,19 @@ struct TinyGltfNodeWrapper
     auto        GetMeshId()      const { return Node.mesh; }
     auto        GetCameraId()    const { return Node.camera; }
     auto        GetSkinId()      const { return Node.skin; }
+    const auto& GetWeights()     const { return Node.weights; }
     // clang-format on
+
+    // Returns the accessor id of the EXT_mesh_gpu_instancing attribute, or -1 if the node does not have it.
+    int GetInstancingAttributeId(const char* Name) const
+    {
+        auto ext_it = Node.extensions.find("EXT_mesh_gpu_instancing");
+        if (ext_it == Node.extensions.end() || !ext_it->second.Has("attributes"))
+            return -1;
+
+        const auto& Attribs = ext_it->second.Get("attributes");
+        return Attribs.Has(Name) ? Attribs.Get(Name).GetNumberAsInt() : -1;
+    }
 };
 
 struct TinyGltfPrimitiveWrapper
@@ -130,6 +241,16 @@ struct TinyGltfPrimitiveWrapper
 
     auto GetIndicesId() const { return Primitive.indices; }
     auto GetMaterialId() const { return Primitive.material; }
+
+    auto GetTargetCount() const { return Primitive.targets.size(); }
+
+    // Returns the accessor id of the morph target attribute, or -1 if the target does not have it.
+    int GetTargetAttributeId(size_t Target, const char* Name) const
+    {
+        const auto& Attribs   = Primitive.targets[Target];
+        auto        attrib_it = Attribs.find(Name);
+        return attrib_it != Attribs.end() ? attrib_it->second : -1;
+    }
 };
 
 struct TinyGltfMeshWrapper
@@ -138,6 +259,7 @@ struct TinyGltfMeshWrapper
 
     const auto& Get() const { return Mesh; }
     const auto& GetName() const { return Mesh.name; }
+    const auto& GetWeights() const { return Mesh.weights; }
 
     auto GetPrimitiveCount() const { return Mesh.primitives.size(); }
     auto GetPrimitive(size_t Idx) const { return TinyGltfPrimitiveWrapper{Mesh.primitives[Idx]}; };
@@ -149,21 +271,26 @@ struct TinyGltfAccessorWrapper
     const tinygltf::Accessor& Accessor;
 
     auto GetCount() const { return Accessor.count; }
-    auto GetMinValues() const
-    {
-        return float3{
-            static_cast<float>(Accessor.minValues[0]),
-            static_cast<float>(Accessor.minValues[1]),
-            static_cast<float>(Accessor.minValues[2]),
-        };
-    }
-    auto GetMaxValues() const
+    auto IsNormalized() const { return Accessor.normalized; }
+
+    // Bounds of normalized accessors (see KHR_mesh_quantization) are stored as integers
+    // and are converted to the normalized range, the same way as the accessor data.
+    auto GetMinValues() const { return GetBoundValues(Accessor.minValues); }
+    auto GetMaxValues() const { return GetBoundValues(Accessor.maxValues); }
+
+    float3 GetBoundValues(const std::vector<double>& Values) const
     {
-        return float3{
-            static_cast<float>(Accessor.maxValues[0]),
-            static_cast<float>(Accessor.maxValues[1]),
-            static_cast<float>(Accessor.maxValues[2]),
+        float3 Bound{
+            static_cast<float>(Values[0]),
+            static_cast<float>(Values[1]),
+            static_cast<float>(Values[2]),
         };
+        if (Accessor.normalized)
+        {
+            for (int c = 0; c < 3; ++c)
+                Bound[c] = ModelBuilder::NormalizeGltfValue(Bound[c], GetComponentType());
+        }
+        return Bound;
     }
 
     // clang-format off
@@ -171,6 +298,16 @@ struct TinyGltfAccessorWrapper
     auto GetByteOffset()    const { return Accessor.byteOffset; }
     auto GetComponentType() const { return TinyGltfComponentTypeToValueType(Accessor.componentType); }
     auto GetNumComponents() const { return tinygltf::GetNumComponentsInType(Accessor.type); }
+
+    // Sparse storage: indices and values of the elements that differ from the buffer view
+    // data, or from zeros if the accessor has no buffer view.
+    auto IsSparse()                   const { return Accessor.sparse.isSparse; }
+    auto GetSparseCount()             const { return Accessor.sparse.count; }
+    auto GetSparseIndicesViewId()     const { return Accessor.sparse.indices.bufferView; }
+    auto GetSparseIndicesByteOffset() const { return Accessor.sparse.indices.byteOffset; }
+    auto GetSparseIndexType()         const { return TinyGltfComponentTypeToValueType(Accessor.sparse.indices.componentType); }
+    auto GetSparseValuesViewId()      const { return Accessor.sparse.values.bufferView; }
+    auto GetSparseValuesByteOffset()  const { return Accessor.sparse.values.byteOffset; }
     // clang-format on
     auto GetByteStride(const TinyGltfBufferViewWrapper& View) const;
 };
@@ -383,6 +520,25 @@ struct TextureInitData : public ObjectBase<IObject>
             }
         }
     }
+
+    // Returns the number of bytes that will be uploaded to the GPU.
+    Uint64 GetUploadSize() const
+    {
+        Uint64 Size = 0;
+        if (pStagingTex)
+        {
+            const auto& StagingDesc = pStagingTex->GetDesc();
+            for (Uint32 mip = 0; mip < StagingDesc.MipLevels; ++mip)
+                Size += GetMipLevelProperties(StagingDesc, mip).MipSize;
+        }
+        else
+        {
+            const auto& FmtAttribs = GetTextureFormatAttribs(Format);
+            for (const auto& Level : Levels)
+                Size += Level.SubResData.Stride * ((Level.Height + FmtAttribs.BlockHeight - 1) / Uint32{FmtAttribs.BlockHeight});
+        }
+        return Size;
+    }
 };
 
 
@@ -406,11 +562,188 @@ TEXTURE_FORMAT GetModelImageDataTextureFormat(const Model::ImageData& Image)
     }
 }
 
+// Returns the block-compressed format to compress the decoded image to,
+// or TEX_FORMAT_UNKNOWN if the image should not be compressed.
+TEXTURE_FORMAT GetGLTFTextureCompressedFormat(const Model::ImageData& Image,
+                                              TEXTURE_COMPRESS_MODE   Mode,
+                                              ResourceManager*        pResourceMgr,
+                                              bool                    StreamMips)
+{
+    if (Mode == TEXTURE_COMPRESS_MODE_NONE ||
+        Image.Width <= 0 || Image.Height <= 0 || Image.pData == nullptr ||
+        Image.ComponentSize != 1 || Image.TexFormat != TEX_FORMAT_UNKNOWN)
+        return TEX_FORMAT_UNKNOWN;
+
+    VERIFY(Mode == TEXTURE_COMPRESS_MODE_BC, "Unexpected texture compress mode");
+
+    const auto Width  = static_cast<Uint32>(Image.Width);
+    const auto Height = static_cast<Uint32>(Image.Height);
+
+    TEXTURE_FORMAT Format = TEX_FORMAT_UNKNOWN;
+    switch (Image.NumComponents)
+    {
+        case 1: Format = TEX_FORMAT_BC4_UNORM; break;
+        case 2: Format = TEX_FORMAT_BC5_UNORM; break;
+        case 3: Format = TEX_FORMAT_BC1_UNORM; break;
+
+        case 4:
+        {
+            // BC1 is half the size of BC3, so use it for opaque textures
+            Format = TEX_FORMAT_BC1_UNORM;
+
+            const auto*  pPixels   = static_cast<const Uint8*>(Image.pData);
+            const size_t NumPixels = size_t{Width} * size_t{Height};
+            VERIFY_EXPR(Image.DataSize >= NumPixels * 4);
+            for (size_t i = 0; i < NumPixels; ++i)
+            {
+                if (pPixels[i * 4 + 3] != 255)
+                {
+                    Format = TEX_FORMAT_BC3_UNORM;
+                    break;
+                }
+            }
+            break;
+        }
+
+        default:
+            return TEX_FORMAT_UNKNOWN;
+    }
+
+    if (pResourceMgr != nullptr)
+    {
+        // Streamed mip tails are generated from the uncompressed levels
+        if (StreamMips)
+            return TEX_FORMAT_UNKNOWN;
+
+        // The allocation origin and size must stay aligned to the block size in every mip level,
+        // otherwise blocks of the coarse levels would overlap neighboring allocations.
+        const auto MipLevels = std::max(pResourceMgr->GetAtlasDesc(Format).MipLevels, 1u);
+        const auto Alignment = pResourceMgr->GetAllocationAlignment(Format, Width, Height);
+        if ((Alignment >> (MipLevels - 1)) < 4)
+            return TEX_FORMAT_UNKNOWN;
+    }
+    else
+    {
+        // Some backends require the dimensions of the top level to be multiples of the block size
+        if ((Width % 4) != 0 || (Height % 4) != 0)
+            return TEX_FORMAT_UNKNOWN;
+    }
+
+    return Format;
+}
+
+// Compresses all levels of the 8-bit uncompressed texture data to the block-compressed format.
+RefCntAutoPtr<TextureInitData> CompressTextureInitData(const TextureInitData& SrcData, TEXTURE_FORMAT DstFormat)
+{
+    const auto& SrcFmtAttribs = GetTextureFormatAttribs(SrcData.Format);
+    const auto& DstFmtAttribs = GetTextureFormatAttribs(DstFormat);
+    VERIFY_EXPR(SrcFmtAttribs.ComponentType != COMPONENT_TYPE_COMPRESSED && SrcFmtAttribs.ComponentSize == 1);
+    VERIFY_EXPR(DstFmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED && DstFmtAttribs.BlockWidth == 4 && DstFmtAttribs.BlockHeight == 4);
+
+    const Uint32 NumComponents = SrcFmtAttribs.NumComponents;
+    const Uint32 BlockSize     = DstFmtAttribs.ComponentSize;
+    VERIFY((DstFormat != TEX_FORMAT_BC1_UNORM && DstFormat != TEX_FORMAT_BC3_UNORM) || NumComponents == 4,
+           "BC1 and BC3 compression requires RGBA source data");
+
+    RefCntAutoPtr<TextureInitData> pDstData{MakeNewRCObj<TextureInitData>()(DstFormat)};
+    pDstData->Levels.resize(SrcData.Levels.size());
+
+    Uint8 SrcBlock[16 * 4];
+    for (size_t mip = 0; mip < SrcData.Levels.size(); ++mip)
+    {
+        const auto& SrcLevel = SrcData.Levels[mip];
+        auto&       DstLevel = pDstData->Levels[mip];
+
+        // Level size is not aligned to the block size, see PrepareGPUResources()
+        DstLevel.Width  = SrcLevel.Width;
+        DstLevel.Height = SrcLevel.Height;
+
+        const Uint32 NumBlocksX = (SrcLevel.Width + 3) / 4;
+        const Uint32 NumBlocksY = (SrcLevel.Height + 3) / 4;
+
+        DstLevel.SubResData.Stride = Uint64{NumBlocksX} * Uint64{BlockSize};
+        DstLevel.Data.resize(static_cast<size_t>(DstLevel.SubResData.Stride * NumBlocksY));
+        DstLevel.SubResData.pData = DstLevel.Data.data();
+
+        const auto* pSrcPixels = SrcLevel.Data.data();
+        const auto  SrcStride  = static_cast<size_t>(SrcLevel.SubResData.Stride);
+        for (Uint32 by = 0; by < NumBlocksY; ++by)
+        {
+            auto* pDstBlock = &DstLevel.Data[static_cast<size_t>(DstLevel.SubResData.Stride * by)];
+            for (Uint32 bx = 0; bx < NumBlocksX; ++bx, pDstBlock += BlockSize)
+            {
+                // Replicate the edge pixels into the blocks that extend past the level boundary
+                for (Uint32 y = 0; y < 4; ++y)
+                {
+                    const auto  SrcY      = std::min(by * 4 + y, SrcLevel.Height - 1);
+                    const auto* pSrcRow   = pSrcPixels + SrcY * SrcStride;
+                    auto*       pDstTexel = &SrcBlock[y * 4 * NumComponents];
+                    for (Uint32 x = 0; x < 4; ++x, pDstTexel += NumComponents)
+                    {
+                        const auto SrcX = std::min(bx * 4 + x, SrcLevel.Width - 1);
+                        memcpy(pDstTexel, pSrcRow + SrcX * NumComponents, NumComponents);
+                    }
+                }
+
+                switch (DstFormat)
+                {
+                    case TEX_FORMAT_BC1_UNORM: CompressBC1Block(SrcBlock, pDstBlock); break;
+                    case TEX_FORMAT_BC3_UNORM: CompressBC3Block(SrcBlock, pDstBlock); break;
+                    case TEX_FORMAT_BC4_UNORM: CompressBC4Block(SrcBlock, pDstBlock, NumComponents); break;
+                    case TEX_FORMAT_BC5_UNORM: CompressBC5Block(SrcBlock, pDstBlock, NumComponents); break;
+                    default:
+                        UNEXPECTED("Unsupported compressed format");
+                }
+            }
+        }
+    }
+
+    return pDstData;
+}
+
+// Decompresses the top-left Width x Height region of the block-compressed level.
+// Returns the number of components in the decompressed pixels, or 0 if the format is not supported.
+Uint32 DecompressTextureLevel(const TextureInitData::LevelData& Level,
+                              TEXTURE_FORMAT                    Format,
+                              Uint32                            Width,
+                              Uint32                            Height,
+                              std::vector<Uint8>&               Pixels)
+{
+    Uint32 NumComponents = 0;
+    switch (Format)
+    {
+        case TEX_FORMAT_BC1_UNORM:
+        case TEX_FORMAT_BC3_UNORM: NumComponents = 4; break;
+        case TEX_FORMAT_BC4_UNORM: NumComponents = 1; break;
+        case TEX_FORMAT_BC5_UNORM: NumComponents = 2; break;
+        default:
+            return 0;
+    }
+
+    VERIFY_EXPR(Level.Width >= Width && Level.Height >= Height);
+    VERIFY_EXPR(GetTextureFormatAttribs(GetBCDecompressedFormat(Format)).NumComponents == NumComponents);
+
+    Pixels.resize(size_t{Width} * size_t{Height} * NumComponents);
+
+    DecompressBCTextureAttribs DecompressAttribs;
+    DecompressAttribs.Format     = Format;
+    DecompressAttribs.Width      = Width;
+    DecompressAttribs.Height     = Height;
+    DecompressAttribs.pSrcBlocks = Level.Data.data();
+    DecompressAttribs.SrcStride  = StaticCast<Uint32>(Level.SubResData.Stride);
+    DecompressAttribs.pDstPixels = Pixels.data();
+    DecompressAttribs.DstStride  = Width * NumComponents;
+    DecompressBCTexture(DecompressAttribs);
+
+    return NumComponents;
+}
+
 RefCntAutoPtr<TextureInitData> PrepareGLTFTextureInitData(
     const Model::ImageData& _Image,
     float                   AlphaCutoff,
     Uint32                  NumMipLevels,
-    int                     SizeAlignment = -1)
+    int                     SizeAlignment    = -1,
+    TEXTURE_FORMAT          CompressedFormat = TEX_FORMAT_UNKNOWN)
 {
     VERIFY_EXPR(_Image.pData != nullptr);
     VERIFY_EXPR(_Image.Width > 0 && _Image.Height > 0 && _Image.NumComponents > 0);
@@ -481,21 +814,26 @@ RefCntAutoPtr<TextureInitData> PrepareGLTFTextureInitData(
         VERIFY_EXPR(AlphaCutoff > 0 && AlphaCutoff <= 1);
         AlphaCutoff *= 255.f;
 
+        // The new value only depends on the old one, so it is computed once for every possible
+        // value, which gives exactly the same results as evaluating the formula for every pixel.
+        std::array<Uint8, 256> AlphaRemap;
+        for (Uint32 a = 0; a < AlphaRemap.size(); ++a)
+        {
+            const auto OldAlpha = static_cast<Uint8>(a);
+            AlphaRemap[a]       = std::max(OldAlpha, static_cast<Uint8>(std::min(1.f / 3.f * OldAlpha + 2.f / 3.f * AlphaCutoff, 255.f)));
+        }
+
         // Due to depressing performance of iterators in debug MSVC we have to use raw pointers here
+        const auto RowSize = size_t{4} * static_cast<size_t>(Image.Width);
         for (int row = 0; row < Image.Height; ++row)
         {
-            const auto* src = pSrcData + row * SrcStride;
-            auto*       dst = &Level0.Data[static_cast<size_t>(row * Level0Stride)];
-            for (int i = 0; i < Image.Width; ++i)
-            {
-                dst[0] = src[0];
-                dst[1] = src[1];
-                dst[2] = src[2];
-                dst[3] = std::max(src[3], static_cast<Uint8>(std::min(1.f / 3.f * src[3] + 2.f / 3.f * AlphaCutoff, 255.f)));
+            const auto* src = pSrcData + size_t{SrcStride} * row;
+            auto*       dst = &Level0.Data[static_cast<size_t>(Level0Stride * row)];
 
-                src += 4;
-                dst += 4;
-            }
+            // Copy the row as a whole and then only touch the alpha channel
+            memcpy(dst, src, RowSize);
+            for (size_t i = 3; i < RowSize; i += 4)
+                dst[i] = AlphaRemap[src[i]];
         }
     }
     else if (Image.NumComponents == static_cast<int>(FmtAttribs.NumComponents))
@@ -515,14 +853,175 @@ RefCntAutoPtr<TextureInitData> PrepareGLTFTextureInitData(
 
     UpdateInfo->GenerateMipLevels(1);
 
+    if (CompressedFormat != TEX_FORMAT_UNKNOWN)
+        UpdateInfo = CompressTextureInitData(*UpdateInfo, CompressedFormat);
+
     return UpdateInfo;
 }
 
+// Decodes the image and writes tightly-packed RGBA pixels to gltf_image.
+bool DecodeGltfImage(const unsigned char* image_data,
+                     size_t               size,
+                     IMAGE_FILE_FORMAT    Format,
+                     int                  gltf_image_idx,
+                     int                  req_width,
+                     int                  req_height,
+                     Uint32               MaxDimension,
+                     tinygltf::Image&     gltf_image,
+                     std::string*         error)
+{
+    auto pImageData = DataBlobImpl::Create(size);
+    memcpy(pImageData->GetDataPtr(), image_data, size);
+    ImageLoadInfo LoadInfo;
+    LoadInfo.Format = Format;
+    if (Format == IMAGE_FILE_FORMAT_JPEG && MaxDimension != 0 && req_width <= 0 && req_height <= 0)
+    {
+        // Let the decoder reduce the image by up to 8 times with the scaled IDCT
+        ImageDesc JpegDesc;
+        if (DecodeJpegIntoMemory(pImageData, nullptr, 0, 0, &JpegDesc) == DECODE_JPEG_RESULT_OK)
+        {
+            Uint32 ScaleDenom = 1;
+            while (ScaleDenom < 8 && std::max(JpegDesc.Width, JpegDesc.Height) / ScaleDenom > MaxDimension)
+                ScaleDenom *= 2;
+            LoadInfo.ScaleDenom = ScaleDenom;
+        }
+    }
+    RefCntAutoPtr<Image> pImage;
+    Image::CreateFromDataBlob(pImageData, LoadInfo, &pImage);
+    if (!pImage)
+    {
+        if (error != nullptr)
+        {
+            *error += FormatString("Failed to load image[", gltf_image_idx, "] name = '", gltf_image.name, "'");
+        }
+        return false;
+    }
+    const auto& ImgDesc = pImage->GetDesc();
+
+    if (req_width > 0)
+    {
+        if (static_cast<Uint32>(req_width) != ImgDesc.Width)
+        {
+            if (error != nullptr)
+            {
+                (*error) += FormatString("Image width mismatch for image[",
+                                         gltf_image_idx, "] name = '", gltf_image.name,
+                                         "': requested width: ",
+                                         req_width, ", actual width: ",
+                                         ImgDesc.Width);
+            }
+            return false;
+        }
+    }
+
+    if (req_height > 0)
+    {
+        if (static_cast<Uint32>(req_height) != ImgDesc.Height)
+        {
+            if (error != nullptr)
+            {
+                (*error) += FormatString("Image height mismatch for image[",
+                                         gltf_image_idx, "] name = '", gltf_image.name,
+                                         "': requested height: ",
+                                         req_height, ", actual height: ",
+                                         ImgDesc.Height);
+            }
+            return false;
+        }
+    }
+
+    gltf_image.width      = ImgDesc.Width;
+    gltf_image.height     = ImgDesc.Height;
+    gltf_image.component  = 4;
+    gltf_image.bits       = GetValueSize(ImgDesc.ComponentType) * 8;
+    gltf_image.pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+    size_t DstRowSize     = static_cast<size_t>(gltf_image.width) * gltf_image.component * (gltf_image.bits / 8);
+    gltf_image.image.resize(static_cast<size_t>(gltf_image.height) * DstRowSize);
+    auto*        pPixelsBlob = pImage->GetData();
+    const Uint8* pSrcPixels  = static_cast<const Uint8*>(pPixelsBlob->GetDataPtr());
+    if (ImgDesc.NumComponents == 3)
+    {
+        for (size_t row = 0; row < ImgDesc.Height; ++row)
+        {
+            for (size_t col = 0; col < ImgDesc.Width; ++col)
+            {
+                Uint8*       DstPixel = gltf_image.image.data() + DstRowSize * row + col * gltf_image.component;
+                const Uint8* SrcPixel = pSrcPixels + ImgDesc.RowStride * row + col * ImgDesc.NumComponents;
+
+                DstPixel[0] = SrcPixel[0];
+                DstPixel[1] = SrcPixel[1];
+                DstPixel[2] = SrcPixel[2];
+                DstPixel[3] = 255;
+            }
+        }
+    }
+    else if (gltf_image.component == 4)
+    {
+        for (size_t row = 0; row < ImgDesc.Height; ++row)
+        {
+            memcpy(gltf_image.image.data() + DstRowSize * row, pSrcPixels + ImgDesc.RowStride * row, DstRowSize);
+        }
+    }
+    else
+    {
+        if (error != nullptr)
+        {
+            *error += FormatString("Unexpected number of image components (", ImgDesc.NumComponents, ")");
+        }
+        return false;
+    }
+
+    // Halve the image until it fits, before the mip levels are generated from it
+    if (MaxDimension != 0 && (gltf_image.bits == 8 || gltf_image.bits == 16))
+    {
+        const auto TexFormat = gltf_image.bits == 8 ? TEX_FORMAT_RGBA8_UNORM : TEX_FORMAT_RGBA16_UNORM;
+        const auto PixelSize = static_cast<size_t>(gltf_image.component) * (gltf_image.bits / 8);
+
+        std::vector<unsigned char> CoarseData;
+        while (static_cast<Uint32>(std::max(gltf_image.width, gltf_image.height)) > MaxDimension)
+        {
+            const auto FineWidth    = static_cast<Uint32>(gltf_image.width);
+            const auto FineHeight   = static_cast<Uint32>(gltf_image.height);
+            const auto CoarseWidth  = std::max(FineWidth / 2u, 1u);
+            const auto CoarseHeight = std::max(FineHeight / 2u, 1u);
+            CoarseData.resize(CoarseWidth * PixelSize * CoarseHeight);
+            ComputeMipLevel({TexFormat, FineWidth, FineHeight,
+                             gltf_image.image.data(), FineWidth * PixelSize,
+                             CoarseData.data(), CoarseWidth * PixelSize});
+
+            gltf_image.image.swap(CoarseData);
+            gltf_image.width  = static_cast<int>(CoarseWidth);
+            gltf_image.height = static_cast<int>(CoarseHeight);
+        }
+        gltf_image.image.shrink_to_fit();
+    }
+
+    return true;
+}
+
+// Returns the sampler shared through the resource manager or the texture cache, if either is used
+RefCntAutoPtr<ISampler> GetSharedSampler(IRenderDevice*     pDevice,
+                                         TextureCacheType*  pTextureCache,
+                                         ResourceManager*   pResourceMgr,
+                                         const SamplerDesc& SamDesc)
+{
+    if (pDevice == nullptr)
+        return {};
+    if (pResourceMgr != nullptr)
+        return pResourceMgr->GetSampler(pDevice, SamDesc);
+    if (pTextureCache != nullptr)
+        return pTextureCache->GetSampler(pDevice, SamDesc);
+
+    RefCntAutoPtr<ISampler> pSampler;
+    pDevice->CreateSampler(SamDesc, &pSampler);
+    return pSampler;
+}
+
 } // namespace
 
 Model::Model(const ModelCreateInfo& CI)
 {
-    DEV_CHECK_ERR(CI.IndexType == VT_UINT16 || CI.IndexType == VT_UINT32, "Invalid index type");
+    DEV_CHECK_ERR(CI.IndexType == VT_UINT16 || CI.IndexType == VT_UINT32 || CI.IndexType == VT_UNDEFINED, "Invalid index type");
     DEV_CHECK_ERR(CI.NumVertexAttributes == 0 || CI.VertexAttributes != nullptr, "VertexAttributes must not be null when NumVertexAttributes > 0");
     DEV_CHECK_ERR(CI.NumTextureAttributes == 0 || CI.TextureAttributes != nullptr, "TextureAttributes must not be null when NumTextureAttributes > 0");
 
@@ -531,7 +1030,40 @@ Model::Model(const ModelCreateInfo& CI)
     NumVertexAttributes         = CI.VertexAttributes != nullptr ? CI.NumVertexAttributes : static_cast<Uint32>(DefaultVertexAttributes.size());
     NumTextureAttributes        = CI.TextureAttributes != nullptr ? CI.NumTextureAttributes : static_cast<Uint32>(DefaultTextureAttributes.size());
 
-    auto&                RawAllocator = DefaultRawMemoryAllocator::GetAllocator();
+    // Remove the attributes that are excluded by the masks from the layout
+    std::vector<VertexAttributeDesc> MaskedVertAttribs;
+    if (CI.VertexAttributeMask != ~0u)
+    {
+        for (Uint32 i = 0; i < NumVertexAttributes; ++i)
+        {
+            if (i >= 32 || (CI.VertexAttributeMask & (1u << i)) != 0)
+                MaskedVertAttribs.push_back(pSrcVertAttribs[i]);
+        }
+        DEV_CHECK_ERR(std::any_of(MaskedVertAttribs.begin(), MaskedVertAttribs.end(),
+                                  [](const VertexAttributeDesc& Attrib) { return SafeStrEqual(Attrib.Name, "POSITION"); }),
+                      "POSITION attribute must not be excluded by the vertex attribute mask");
+        pSrcVertAttribs     = MaskedVertAttribs.data();
+        NumVertexAttributes = static_cast<Uint32>(MaskedVertAttribs.size());
+    }
+
+    std::vector<TextureAttributeDesc> MaskedTexAttribs;
+    if (CI.TextureAttributeMask != ~0u)
+    {
+        for (Uint32 i = 0; i < NumTextureAttributes; ++i)
+        {
+            if (i >= 32 || (CI.TextureAttributeMask & (1u << i)) != 0)
+                MaskedTexAttribs.push_back(pSrcTexAttribs[i]);
+        }
+        pSrcTexAttribs       = MaskedTexAttribs.data();
+        NumTextureAttributes = static_cast<Uint32>(MaskedTexAttribs.size());
+    }
+
+    m_pAllocator           = CI.pAllocator;
+    m_ImmediateContextMask = CI.ImmediateContextMask;
+    if (CI.pCacheInfo != nullptr)
+        m_pResourceMgr = CI.pCacheInfo->pResourceMgr;
+
+    IMemoryAllocator&    RawAllocator = CI.pAllocator != nullptr ? *CI.pAllocator : DefaultRawMemoryAllocator::GetAllocator();
     FixedLinearAllocator Allocator{RawAllocator};
     Allocator.AddSpace<VertexAttributeDesc>(NumVertexAttributes);
     Allocator.AddSpace<TextureAttributeDesc>(NumTextureAttributes);
@@ -544,6 +1076,12 @@ Model::Model(const ModelCreateInfo& CI)
         DEV_CHECK_ERR(Attrib.Name != nullptr, "Vertex attribute name must not be null");
         DEV_CHECK_ERR(Attrib.ValueType != VT_UNDEFINED, "Undefined vertex attribute value type");
         DEV_CHECK_ERR(Attrib.NumComponents != 0, "The number of components must not be null");
+        DEV_CHECK_ERR(Attrib.Encoding == VERTEX_ATTRIBUTE_ENCODING_NONE || (Attrib.ValueType == VT_INT8 || Attrib.ValueType == VT_INT16 || Attrib.ValueType == VT_UINT8 || Attrib.ValueType == VT_UINT16),
+                      "Encoded vertex attribute '", Attrib.Name, "' must use 8- or 16-bit integer value type");
+        DEV_CHECK_ERR(Attrib.Encoding != VERTEX_ATTRIBUTE_ENCODING_OCTAHEDRAL || (Attrib.NumComponents == 2 && (Attrib.ValueType == VT_INT8 || Attrib.ValueType == VT_INT16)),
+                      "Octahedral-encoded vertex attribute '", Attrib.Name, "' must have two VT_INT8 or VT_INT16 components");
+        DEV_CHECK_ERR(Attrib.Encoding != VERTEX_ATTRIBUTE_ENCODING_BOUNDING_BOX || strcmp(Attrib.Name, "POSITION") == 0,
+                      "Bounding box encoding is only supported for the POSITION attribute");
 
         MaxBufferId = std::max<Uint32>(MaxBufferId, Attrib.BufferId);
 
@@ -589,7 +1127,7 @@ Model::Model(const ModelCreateInfo& CI)
     }
 
 #ifdef DILIGENT_DEBUG
-    if (CI.VertexAttributes == nullptr)
+    if (CI.VertexAttributes == nullptr && CI.VertexAttributeMask == ~0u)
     {
         VERIFY_EXPR(Buffers.size() == 3);
         VERIFY_EXPR(Buffers[0].ElementStride == sizeof(VertexBasicAttribs));
@@ -597,11 +1135,13 @@ Model::Model(const ModelCreateInfo& CI)
     }
 #endif
 
-    Buffers.back().ElementStride = CI.IndexType == VT_UINT32 ? 4 : 2;
+    // The index type is selected by the model builder if it is not specified
+    Buffers.back().ElementStride = CI.IndexType == VT_UINT32 ? 4 : (CI.IndexType == VT_UINT16 ? 2 : 0);
 
-    pAttributesData   = decltype(pAttributesData){Allocator.ReleaseOwnership(), RawAllocator};
-    VertexAttributes  = pDstVertAttribs;
-    TextureAttributes = pDstTexAttribs;
+    AttributesDataSize = Allocator.GetReservedSize();
+    pAttributesData    = decltype(pAttributesData){Allocator.ReleaseOwnership(), RawAllocator};
+    VertexAttributes   = pDstVertAttribs;
+    TextureAttributes  = pDstTexAttribs;
 }
 
 Model::Model(IRenderDevice*         pDevice,
@@ -632,52 +1172,157 @@ int Model::GetTextureAttibuteIndex(const char* Name) const
     return -1;
 }
 
-float Model::GetTextureAlphaCutoffValue(int TextureIndex) const
+namespace
 {
-    const auto BaseTexAttribIdx = GetTextureAttibuteIndex(BaseColorTextureName);
-    if (BaseTexAttribIdx < 0)
-        return 0;
 
-    float AlphaCutoff = -1.f;
-    for (const auto& Mat : Materials)
+template <typename ObjectsType>
+void BuildNameIndex(const ObjectsType& Objects, std::vector<std::pair<Uint64, Uint32>>& NameIndex)
+{
+    NameIndex.clear();
+    NameIndex.reserve(Objects.size());
+    for (size_t i = 0; i < Objects.size(); ++i)
     {
-        if (Mat.TextureIds[BaseTexAttribIdx] != TextureIndex)
-        {
-            // The material does not use this texture as base color.
-            continue;
-        }
-
-        if (Mat.Attribs.AlphaMode == Material::ALPHA_MODE_OPAQUE)
-        {
-            // The material is opaque, so alpha remapping mode does not matter.
-            continue;
-        }
-
-        VERIFY_EXPR(Mat.Attribs.AlphaMode == Material::ALPHA_MODE_BLEND || Mat.Attribs.AlphaMode == Material::ALPHA_MODE_MASK);
-        const float NewAlphaCutoff = Mat.Attribs.AlphaMode == Material::ALPHA_MODE_MASK ? Mat.Attribs.AlphaCutoff : 0;
-        if (AlphaCutoff < 0)
-        {
-            AlphaCutoff = NewAlphaCutoff;
-        }
-        else if (AlphaCutoff != NewAlphaCutoff)
-        {
-            if (AlphaCutoff == 0 || NewAlphaCutoff == 0)
-            {
-                LOG_WARNING_MESSAGE("Texture ", TextureIndex,
-                                    " is used in an alpha-cut material with threshold ", std::max(AlphaCutoff, NewAlphaCutoff),
-                                    " as well as in an alpha-blend material."
-                                    " Alpha remapping to improve mipmap generation will be disabled.");
-                return 0;
-            }
-            else
-            {
-                LOG_WARNING_MESSAGE("Texture ", TextureIndex,
-                                    " is used in alpha-cut materials with different cutoff thresholds (", AlphaCutoff, " and ", NewAlphaCutoff,
-                                    "). Alpha remapping to improve mipmap generation will use ",
-                                    std::min(AlphaCutoff, NewAlphaCutoff), '.');
-                AlphaCutoff = std::min(AlphaCutoff, NewAlphaCutoff);
-            }
-        }
+        if (!Objects[i].Name.empty())
+            NameIndex.emplace_back(Model::ComputeNameHash(Objects[i].Name.c_str()), static_cast<Uint32>(i));
+    }
+    std::sort(NameIndex.begin(), NameIndex.end());
+}
+
+template <typename ObjectsType>
+int FindInNameIndex(const ObjectsType& Objects, const std::vector<std::pair<Uint64, Uint32>>& NameIndex, const char* Name, Uint64 NameHash)
+{
+    if (Name == nullptr || *Name == '\0')
+        return -1;
+
+    VERIFY(NameHash == Model::ComputeNameHash(Name), "Name hash does not match the name. Use Model::ComputeNameHash() to compute it.");
+
+    // Objects with the same hash are sorted by their indices
+    for (auto it = std::lower_bound(NameIndex.begin(), NameIndex.end(), std::make_pair(NameHash, Uint32{0}));
+         it != NameIndex.end() && it->first == NameHash; ++it)
+    {
+        if (it->second < Objects.size() && Objects[it->second].Name == Name)
+            return static_cast<int>(it->second);
+    }
+    return -1;
+}
+
+} // namespace
+
+void Model::UpdateNameIndices()
+{
+    BuildNameIndex(LinearNodes, m_NodeNameIndex);
+    BuildNameIndex(Meshes, m_MeshNameIndex);
+    BuildNameIndex(Animations, m_AnimationNameIndex);
+    BuildNameIndex(Materials, m_MaterialNameIndex);
+}
+
+int Model::FindNode(const char* Name, Uint64 NameHash) const
+{
+    return FindInNameIndex(LinearNodes, m_NodeNameIndex, Name, NameHash);
+}
+
+int Model::FindMesh(const char* Name, Uint64 NameHash) const
+{
+    return FindInNameIndex(Meshes, m_MeshNameIndex, Name, NameHash);
+}
+
+int Model::FindAnimation(const char* Name, Uint64 NameHash) const
+{
+    return FindInNameIndex(Animations, m_AnimationNameIndex, Name, NameHash);
+}
+
+int Model::FindMaterial(const char* Name, Uint64 NameHash) const
+{
+    return FindInNameIndex(Materials, m_MaterialNameIndex, Name, NameHash);
+}
+
+int Model::FindMaterialVariant(const char* Name) const
+{
+    if (Name == nullptr)
+        return -1;
+
+    auto it = std::find(MaterialVariants.begin(), MaterialVariants.end(), Name);
+    return it != MaterialVariants.end() ? static_cast<int>(it - MaterialVariants.begin()) : -1;
+}
+
+void Model::SetMaterialVariant(int Variant)
+{
+    DEV_CHECK_ERR(Variant >= -1 && Variant < static_cast<int>(MaterialVariants.size()),
+                  "Material variant (", Variant, ") is out of range [-1, ", MaterialVariants.size(), ")");
+    if (Variant >= static_cast<int>(MaterialVariants.size()))
+        Variant = -1;
+
+    m_MaterialVariant = Variant;
+    for (auto& M : Meshes)
+    {
+        for (auto& Prim : M.Primitives)
+        {
+            Prim.MaterialId = (Variant >= 0 && !Prim.VariantMaterialIds.empty()) ?
+                Prim.VariantMaterialIds[Variant] :
+                Prim.DefaultMaterialId;
+        }
+    }
+}
+
+const FlattenedPrimitiveRange* Model::FindFlattenedRange(Uint32 Index) const
+{
+    auto it = std::upper_bound(FlattenedRanges.begin(), FlattenedRanges.end(), Index,
+                               [](Uint32 Idx, const FlattenedPrimitiveRange& Range) {
+                                   return Idx < Range.FirstIndex;
+                               });
+    if (it == FlattenedRanges.begin())
+        return nullptr;
+
+    --it;
+    return Index < it->FirstIndex + it->IndexCount ? &*it : nullptr;
+}
+
+float Model::GetTextureAlphaCutoffValue(int TextureIndex) const
+{
+    const auto BaseTexAttribIdx = GetTextureAttibuteIndex(BaseColorTextureName);
+    if (BaseTexAttribIdx < 0)
+        return 0;
+
+    float AlphaCutoff = -1.f;
+    for (const auto& Mat : Materials)
+    {
+        if (Mat.TextureIds[BaseTexAttribIdx] != TextureIndex)
+        {
+            // The material does not use this texture as base color.
+            continue;
+        }
+
+        if (Mat.Attribs.AlphaMode == Material::ALPHA_MODE_OPAQUE)
+        {
+            // The material is opaque, so alpha remapping mode does not matter.
+            continue;
+        }
+
+        VERIFY_EXPR(Mat.Attribs.AlphaMode == Material::ALPHA_MODE_BLEND || Mat.Attribs.AlphaMode == Material::ALPHA_MODE_MASK);
+        const float NewAlphaCutoff = Mat.Attribs.AlphaMode == Material::ALPHA_MODE_MASK ? Mat.Attribs.AlphaCutoff : 0;
+        if (AlphaCutoff < 0)
+        {
+            AlphaCutoff = NewAlphaCutoff;
+        }
+        else if (AlphaCutoff != NewAlphaCutoff)
+        {
+            if (AlphaCutoff == 0 || NewAlphaCutoff == 0)
+            {
+                LOG_WARNING_MESSAGE("Texture ", TextureIndex,
+                                    " is used in an alpha-cut material with threshold ", std::max(AlphaCutoff, NewAlphaCutoff),
+                                    " as well as in an alpha-blend material."
+                                    " Alpha remapping to improve mipmap generation will be disabled.");
+                return 0;
+            }
+            else
+            {
+                LOG_WARNING_MESSAGE("Texture ", TextureIndex,
+                                    " is used in alpha-cut materials with different cutoff thresholds (", AlphaCutoff, " and ", NewAlphaCutoff,
+                                    "). Alpha remapping to improve mipmap generation will use ",
+                                    std::min(AlphaCutoff, NewAlphaCutoff), '.');
+                AlphaCutoff = std::min(AlphaCutoff, NewAlphaCutoff);
+            }
+        }
     }
 
     return std::max(AlphaCutoff, 0.f);
@@ -689,11 +1334,28 @@ Uint32 Model::AddTexture(IRenderDevice*     pDevice,
                          const ImageData&   Image,
                          int                GltfSamplerId,
                          const std::string& CacheId)
+{
+    return AddTexture(pDevice, pTextureCache, pResourceMgr, Image, GltfSamplerId, CacheId, nullptr, nullptr);
+}
+
+Uint32 Model::AddTexture(IRenderDevice*              pDevice,
+                         TextureCacheType*           pTextureCache,
+                         ResourceManager*            pResourceMgr,
+                         const ImageData&            Image,
+                         int                         GltfSamplerId,
+                         const std::string&          CacheId,
+                         IObject*                    pPreparedInitData,
+                         ITextureAtlasSuballocation* pAllocation)
 {
     const auto NewTexId = static_cast<int>(Textures.size());
 
     TextureInfo TexInfo;
-    if (!CacheId.empty())
+    if (pAllocation != nullptr)
+    {
+        // The space has been allocated together with other textures by CommitTextures()
+        TexInfo.pAtlasSuballocation = pAllocation;
+    }
+    else if (!CacheId.empty())
     {
         if (pResourceMgr != nullptr)
         {
@@ -708,28 +1370,7 @@ Uint32 Model::AddTexture(IRenderDevice*     pDevice,
         }
         else if (pTextureCache != nullptr)
         {
-            std::lock_guard<std::mutex> Lock{pTextureCache->TexturesMtx};
-
-            auto it = pTextureCache->Textures.find(CacheId);
-            if (it != pTextureCache->Textures.end())
-            {
-                TexInfo.pTexture = it->second.Lock();
-                if (!TexInfo.pTexture)
-                {
-                    // Image width and height (or pixel_type for dds/ktx) are initialized by LoadImageData()
-                    // if the texture is found in the cache.
-                    if ((Image.Width > 0 && Image.Height > 0) ||
-                        (Image.FileFormat == IMAGE_FILE_FORMAT_DDS || Image.FileFormat == IMAGE_FILE_FORMAT_KTX))
-                    {
-                        UNEXPECTED("Stale textures should not be found in the texture cache because we hold strong references. "
-                                   "This must be an unexpected effect of loading resources from multiple threads or a bug.");
-                    }
-                    else
-                    {
-                        pTextureCache->Textures.erase(it);
-                    }
-                }
-            }
+            TexInfo.pTexture = pTextureCache->Find(CacheId);
         }
     }
 
@@ -739,43 +1380,104 @@ Uint32 Model::AddTexture(IRenderDevice*     pDevice,
         if (GltfSamplerId == -1)
         {
             // No sampler specified, use default one
-            pDevice->CreateSampler(Sam_LinearWrap, &pSampler);
+            pSampler = GetSharedSampler(pDevice, pTextureCache, pResourceMgr, Sam_LinearWrap);
         }
         else
         {
             pSampler = TextureSamplers[GltfSamplerId];
         }
 
-        // Check if the texture is used in an alpha-cut material
-        const float AlphaCutoff = GetTextureAlphaCutoffValue(NewTexId);
+        // Check if the texture is used in an alpha-cut material.
+        // Prepared init data has already been processed with the alpha cutoff value.
+        const float AlphaCutoff = pPreparedInitData == nullptr ? GetTextureAlphaCutoffValue(NewTexId) : 0;
 
         if (Image.Width > 0 && Image.Height > 0)
         {
             if (pResourceMgr != nullptr)
             {
-                const auto TexFormat = GetModelImageDataTextureFormat(Image);
+                // Prepared init data has already been compressed if necessary
+                const auto CompressedFormat = pPreparedInitData == nullptr ?
+                    GetGLTFTextureCompressedFormat(Image, TextureCompressMode, pResourceMgr, NumStreamedTextureMips > 0) :
+                    TEX_FORMAT_UNKNOWN;
+
+                const auto TexFormat = pPreparedInitData != nullptr ?
+                    ClassPtrCast<TextureInitData>(pPreparedInitData)->Format :
+                    (CompressedFormat != TEX_FORMAT_UNKNOWN ? CompressedFormat : GetModelImageDataTextureFormat(Image));
                 // No reference
                 const TextureDesc AtlasDesc = pResourceMgr->GetAtlasDesc(TexFormat);
 
                 // Load all mip levels.
                 const auto AllocationAlignment = pResourceMgr->GetAllocationAlignment(TexFormat, Image.Width, Image.Height);
-                auto       pInitData           = PrepareGLTFTextureInitData(Image, AlphaCutoff, AtlasDesc.MipLevels, AllocationAlignment);
+                auto       pInitData           = pPreparedInitData != nullptr ?
+                    RefCntAutoPtr<TextureInitData>{ClassPtrCast<TextureInitData>(pPreparedInitData)} :
+                    PrepareGLTFTextureInitData(Image, AlphaCutoff, AtlasDesc.MipLevels, AllocationAlignment, CompressedFormat);
                 VERIFY_EXPR(pInitData->Format == TexFormat);
+                VERIFY_EXPR(pInitData->Levels.size() == AtlasDesc.MipLevels);
+
+                // Do not stream mip levels that would make the tail smaller than the block size
+                const auto& FmtAttribs   = GetTextureFormatAttribs(TexFormat);
+                Uint32      NumTailSkips = 0;
+                while (NumTailSkips < NumStreamedTextureMips &&
+                       (static_cast<Uint32>(Image.Width) >> (NumTailSkips + 1)) >= FmtAttribs.BlockWidth &&
+                       (static_cast<Uint32>(Image.Height) >> (NumTailSkips + 1)) >= FmtAttribs.BlockHeight)
+                {
+                    ++NumTailSkips;
+                }
 
-                // pInitData will be atomically set in the allocation before any other thread may be able to
-                // access it.
-                // Note that it is possible that more than one thread prepares pInitData for the same allocation.
-                // It it also possible that multiple instances of the same allocation are created before the first
-                // is added to the cache. This is all OK though.
-                TexInfo.pAtlasSuballocation =
-                    pResourceMgr->AllocateTextureSpace(TexFormat, Image.Width, Image.Height, CacheId.c_str(), pInitData);
+                if (NumTailSkips > 0)
+                {
+                    // Allocate space for the mip tail only. Mip level m of the tail allocation
+                    // contains level NumTailSkips + m of the full texture.
+                    auto& Levels = pInitData->Levels;
+                    Levels.resize(size_t{AtlasDesc.MipLevels} + NumTailSkips);
+                    pInitData->GenerateMipLevels(AtlasDesc.MipLevels);
+
+                    RefCntAutoPtr<TextureInitData> pTailInitData{MakeNewRCObj<TextureInitData>()(TexFormat)};
+                    pTailInitData->Levels.assign(Levels.begin() + NumTailSkips, Levels.end());
+                    for (auto& Level : pTailInitData->Levels)
+                        Level.SubResData.pData = Level.Data.data();
+                    Levels.resize(AtlasDesc.MipLevels);
+
+                    const auto TailWidth  = static_cast<Uint32>(Image.Width) >> NumTailSkips;
+                    const auto TailHeight = static_cast<Uint32>(Image.Height) >> NumTailSkips;
+                    // Streamed textures are not cached as the allocation is replaced by StreamTextures()
+                    TexInfo.pAtlasSuballocation = pResourceMgr->AllocateTextureSpace(TexFormat, TailWidth, TailHeight, nullptr, pTailInitData);
+
+                    if (StreamedTextures.size() <= static_cast<size_t>(NewTexId))
+                        StreamedTextures.resize(static_cast<size_t>(NewTexId) + 1);
+                    auto& StreamedTex     = StreamedTextures[NewTexId];
+                    StreamedTex.pInitData = pInitData;
+                    StreamedTex.Width     = static_cast<Uint32>(Image.Width);
+                    StreamedTex.Height    = static_cast<Uint32>(Image.Height);
+                }
+                else
+                {
+                    // pInitData will be atomically set in the allocation before any other thread may be able to
+                    // access it.
+                    // Note that it is possible that more than one thread prepares pInitData for the same allocation.
+                    // It it also possible that multiple instances of the same allocation are created before the first
+                    // is added to the cache. This is all OK though.
+                    TexInfo.pAtlasSuballocation =
+                        pResourceMgr->AllocateTextureSpace(TexFormat, Image.Width, Image.Height, CacheId.c_str(), pInitData);
+                    VERIFY_EXPR(TexInfo.pAtlasSuballocation->GetAlignment() == AllocationAlignment);
+                }
                 VERIFY_EXPR(TexInfo.pAtlasSuballocation->GetAtlas()->GetAtlasDesc().MipLevels == AtlasDesc.MipLevels);
-                VERIFY_EXPR(TexInfo.pAtlasSuballocation->GetAlignment() == AllocationAlignment);
             }
             else
             {
                 // Load only the lowest mip level; other mip levels will be generated on the GPU.
-                auto pTexInitData = PrepareGLTFTextureInitData(Image, AlphaCutoff, 1);
+                // Mip levels of compressed textures can't be generated on the GPU and are prepared on the CPU.
+                const auto CompressedFormat = pPreparedInitData == nullptr ?
+                    GetGLTFTextureCompressedFormat(Image, TextureCompressMode, nullptr, false) :
+                    TEX_FORMAT_UNKNOWN;
+
+                auto pTexInitData = pPreparedInitData != nullptr ?
+                    RefCntAutoPtr<TextureInitData>{ClassPtrCast<TextureInitData>(pPreparedInitData)} :
+                    PrepareGLTFTextureInitData(Image, AlphaCutoff,
+                                               CompressedFormat != TEX_FORMAT_UNKNOWN ? ComputeMipLevelsCount(Image.Width, Image.Height) : 1,
+                                               -1, CompressedFormat);
+
+                const bool IsCompressed = GetTextureFormatAttribs(pTexInitData->Format).ComponentType == COMPONENT_TYPE_COMPRESSED;
 
                 TextureDesc TexDesc;
                 TexDesc.Name      = "GLTF Texture";
@@ -785,8 +1487,10 @@ Uint32 Model::AddTexture(IRenderDevice*     pDevice,
                 TexDesc.Width     = Image.Width;
                 TexDesc.Height    = Image.Height;
                 TexDesc.Format    = pTexInitData->Format;
-                TexDesc.MipLevels = 0;
-                TexDesc.MiscFlags = MISC_TEXTURE_FLAG_GENERATE_MIPS;
+                TexDesc.MipLevels = IsCompressed ? static_cast<Uint32>(pTexInitData->Levels.size()) : 0;
+                TexDesc.MiscFlags = IsCompressed ? MISC_TEXTURE_FLAG_NONE : MISC_TEXTURE_FLAG_GENERATE_MIPS;
+
+                TexDesc.ImmediateContextMask = m_ImmediateContextMask;
 
                 pDevice->CreateTexture(TexDesc, nullptr, &TexInfo.pTexture);
                 TexInfo.pTexture->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE)->SetSampler(pSampler);
@@ -802,7 +1506,10 @@ Uint32 Model::AddTexture(IRenderDevice*     pDevice,
             RefCntAutoPtr<ITextureLoader> pTexLoader;
 
             TextureLoadInfo LoadInfo;
-            LoadInfo.Name = "GLTF texture";
+            LoadInfo.Name                 = "GLTF texture";
+            LoadInfo.pAllocator           = m_pAllocator;
+            LoadInfo.ImmediateContextMask = m_ImmediateContextMask;
+            LoadInfo.MaxDimension         = MaxTextureDimension;
             if (pResourceMgr != nullptr)
             {
                 LoadInfo.Usage          = USAGE_STAGING;
@@ -849,6 +1556,8 @@ Uint32 Model::AddTexture(IRenderDevice*     pDevice,
             TexDesc.Usage     = USAGE_DEFAULT;
             TexDesc.BindFlags = BIND_SHADER_RESOURCE;
 
+            TexDesc.ImmediateContextMask = m_ImmediateContextMask;
+
             RefCntAutoPtr<TextureInitData> pTexInitData{MakeNewRCObj<TextureInitData>()(TexDesc.Format)};
 
             pTexInitData->Levels.resize(1);
@@ -868,8 +1577,7 @@ Uint32 Model::AddTexture(IRenderDevice*     pDevice,
 
         if (TexInfo.pTexture && pTextureCache != nullptr)
         {
-            std::lock_guard<std::mutex> Lock{pTextureCache->TexturesMtx};
-            pTextureCache->Textures.emplace(CacheId, TexInfo.pTexture);
+            pTextureCache->Add(CacheId, TexInfo.pTexture);
         }
     }
 
@@ -898,56 +1606,236 @@ void Model::InitMaterialTextureAddressingAttribs(Material& Mat, Uint32 TextureIn
     }
 }
 
-void Model::LoadTextures(IRenderDevice*         pDevice,
-                         const tinygltf::Model& gltf_model,
-                         const std::string&     BaseDir,
-                         TextureCacheType*      pTextureCache,
-                         ResourceManager*       pResourceMgr)
+void Model::PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx)
+{
+    PrepareGPUResources(pDevice, pCtx, ~Uint64{0});
+}
+
+Uint32 Model::PrepareGPUResources(IRenderDevice*  pDevice,
+                                  IDeviceContext* pCtx,
+                                  Uint64          MaxUploadSize,
+                                  IFence*         pFence,
+                                  Uint64          FenceValue)
 {
-    Textures.reserve(gltf_model.textures.size());
-    for (const tinygltf::Texture& gltf_tex : gltf_model.textures)
+    Uint32 NumPendingResources = 0;
+    if (!GPUDataInitialized.load())
     {
-        const auto& gltf_image = gltf_model.images[gltf_tex.source];
-        const auto  CacheId    = !gltf_image.uri.empty() ? FileSystem::SimplifyPath((BaseDir + gltf_image.uri).c_str()) : "";
+        NumPendingResources = InitializePendingGPUData(pDevice, pCtx, MaxUploadSize);
+        if (NumPendingResources == 0)
+            GPUDataInitialized.store(true);
 
-        ImageData Image;
-        Image.Width         = gltf_image.width;
-        Image.Height        = gltf_image.height;
-        Image.NumComponents = gltf_image.component;
-        Image.ComponentSize = gltf_image.bits / 8;
-        Image.FileFormat    = (gltf_image.width < 0 && gltf_image.height < 0) ? static_cast<IMAGE_FILE_FORMAT>(gltf_image.pixel_type) : IMAGE_FILE_FORMAT_UNKNOWN;
-        Image.pData         = gltf_image.image.data();
-        Image.DataSize      = gltf_image.image.size();
+        if (m_pResourceMgr)
+            m_pResourceMgr->FinishStagingUploads(pCtx);
+    }
 
-        AddTexture(pDevice, pTextureCache, pResourceMgr, Image, gltf_tex.sampler, CacheId);
+    if (pFence != nullptr)
+    {
+        // Signal the fence even if there was nothing to upload so that the application never waits forever
+        pCtx->EnqueueSignal(pFence, FenceValue);
+        pCtx->Flush();
     }
+
+    return NumPendingResources;
 }
 
-void Model::PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx)
+Uint64 Model::GetCPUDataSize() const
 {
-    if (GPUDataInitialized.load())
-        return;
+    Uint64 Size = 0;
+    for (const auto& TexInfo : Textures)
+    {
+        IObject* pTexUserData = nullptr;
+        if (TexInfo.pAtlasSuballocation)
+            pTexUserData = TexInfo.pAtlasSuballocation->GetUserData();
+        else if (TexInfo.pTexture)
+            pTexUserData = TexInfo.pTexture->GetUserData();
+        if (pTexUserData != nullptr)
+            Size += ClassPtrCast<TextureInitData>(pTexUserData)->GetUploadSize();
+    }
+
+    for (const auto& StreamedTex : StreamedTextures)
+    {
+        if (StreamedTex.pInitData)
+            Size += ClassPtrCast<const TextureInitData>(StreamedTex.pInitData.RawPtr())->GetUploadSize();
+    }
+
+    for (const auto& BuffInfo : Buffers)
+    {
+        IObject* pBuffUserData = nullptr;
+        if (BuffInfo.pSuballocation)
+            pBuffUserData = BuffInfo.pSuballocation->GetUserData();
+        else if (BuffInfo.pBuffer)
+            pBuffUserData = BuffInfo.pBuffer->GetUserData();
+
+        RefCntAutoPtr<IDataBlob> pInitData{pBuffUserData, IID_DataBlob};
+        if (pInitData)
+            Size += pInitData->GetSize();
+    }
+
+    return Size;
+}
+
+ModelMemoryStats Model::GetMemoryStats() const
+{
+    ModelMemoryStats Stats;
+
+    for (size_t i = 0; i < Buffers.size(); ++i)
+    {
+        const auto& BuffInfo = Buffers[i];
+
+        Uint64 Size = 0;
+        if (BuffInfo.pSuballocation)
+            Size = BuffInfo.pSuballocation->GetSize();
+        else if (BuffInfo.pBuffer)
+            Size = BuffInfo.pBuffer->GetDesc().Size;
+
+        // The last buffer is the index buffer
+        (i + 1 < Buffers.size() ? Stats.VertexBufferSize : Stats.IndexBufferSize) += Size;
+    }
+
+    for (const auto* pBuffer : {pMeshletBuffer.RawPtr(), pMeshletDataBuffer.RawPtr(), pInstanceBuffer.RawPtr(), pMorphTargetBuffer.RawPtr()})
+    {
+        if (pBuffer != nullptr)
+            Stats.AuxBufferSize += pBuffer->GetDesc().Size;
+    }
+
+    for (const auto& TexInfo : Textures)
+    {
+        if (TexInfo.pTexture)
+        {
+            Stats.TextureSize += GetTextureDataSize(TexInfo.pTexture->GetDesc());
+        }
+        else if (TexInfo.pAtlasSuballocation)
+        {
+            const auto* pAtlas = TexInfo.pAtlasSuballocation->GetAtlas();
+            if (pAtlas == nullptr)
+                continue;
+
+            // The region uses the format and the mip levels of the atlas
+            TextureDesc RegionDesc = pAtlas->GetAtlasDesc();
+            const auto  RegionSize = TexInfo.pAtlasSuballocation->GetSize();
+            RegionDesc.Type        = RESOURCE_DIM_TEX_2D;
+            RegionDesc.Width       = RegionSize.x;
+            RegionDesc.Height      = RegionSize.y;
+            RegionDesc.ArraySize   = 1;
+            Stats.AtlasRegionSize += GetTextureDataSize(RegionDesc);
+        }
+    }
 
+    Stats.PendingUploadSize = GetCPUDataSize();
+
+    Stats.SceneDataSize += GetVectorDataSize(RootNodes) + GetVectorDataSize(LinearNodes);
+    for (const auto& N : LinearNodes)
+        Stats.SceneDataSize += N.Name.capacity() + GetVectorDataSize(N.Children);
+    Stats.SceneDataSize += GetVectorDataSize(NodeTransformOrder) + GetVectorDataSize(NodeDepths);
+    Stats.SceneDataSize += GetVectorDataSize(Meshes);
+    for (const auto& M : Meshes)
+    {
+        Stats.SceneDataSize += M.Name.capacity() + GetVectorDataSize(M.Primitives) + GetVectorDataSize(M.MorphTargets);
+        for (const auto& Prim : M.Primitives)
+            Stats.SceneDataSize += GetVectorDataSize(Prim.LODs);
+    }
+    Stats.SceneDataSize += GetVectorDataSize(Skins);
+    for (const auto& S : Skins)
+        Stats.SceneDataSize += S.Name.capacity() + GetVectorDataSize(S.InverseBindMatrices) + GetVectorDataSize(S.Joints);
+    Stats.SceneDataSize += GetVectorDataSize(Cameras);
+    for (const auto& Cam : Cameras)
+        Stats.SceneDataSize += Cam.Name.capacity();
+    Stats.SceneDataSize += GetVectorDataSize(DefaultMorphWeights) + GetVectorDataSize(FlattenedRanges);
+    for (const auto* pNameIndex : {&m_NodeNameIndex, &m_MeshNameIndex, &m_AnimationNameIndex, &m_MaterialNameIndex})
+        Stats.SceneDataSize += GetVectorDataSize(*pNameIndex);
+
+    Stats.AnimationDataSize += GetVectorDataSize(Animations);
+    for (const auto& Anim : Animations)
+    {
+        Stats.AnimationDataSize += Anim.Name.capacity() + GetVectorDataSize(Anim.Samplers) + GetVectorDataSize(Anim.Channels);
+        for (const auto& Sam : Anim.Samplers)
+            Stats.AnimationDataSize += GetVectorDataSize(Sam.Inputs) + GetVectorDataSize(Sam.OutputsVec4) + GetVectorDataSize(Sam.OutputWeights);
+        Stats.AnimationDataSize += GetVectorDataSize(Anim.Baked.Tracks) + GetVectorDataSize(Anim.Baked.Data);
+    }
+
+    Stats.MaterialDataSize += GetVectorDataSize(Materials) + GetVectorDataSize(TextureSamplers) + AttributesDataSize;
+    Stats.MaterialDataSize += GetVectorDataSize(Textures) + GetVectorDataSize(StreamedTextures);
+
+    Stats.GeometryDataSize += GetVectorDataSize(Meshlets) + GetVectorDataSize(InstanceMatrices) + GetVectorDataSize(MorphTargetDeltas);
+    Stats.GeometryDataSize += GetVectorDataSize(MeshBVHs);
+    for (const auto& BVH : MeshBVHs)
+    {
+        Stats.GeometryDataSize += GetVectorDataSize(BVH.Positions) + GetVectorDataSize(BVH.Triangles);
+        Stats.GeometryDataSize += GetVectorDataSize(BVH.BVH.GetNodes()) + GetVectorDataSize(BVH.BVH.GetItems());
+    }
+
+    return Stats;
+}
+
+Uint32 Model::InitializePendingGPUData(IRenderDevice* pDevice, IDeviceContext* pCtx, Uint64 MaxUploadSize)
+{
     std::vector<StateTransitionDesc> Barriers;
 
+    // A transfer queue can only copy data. Resources it uploads are transitioned to the common state,
+    // which releases them to the graphics queue, and GPU mip generation is left to a graphics context.
+    const auto QueueType         = pCtx->GetDesc().QueueType;
+    const bool IsTransferContext = QueueType != COMMAND_QUEUE_TYPE_UNKNOWN && (QueueType & COMMAND_QUEUE_TYPE_GRAPHICS) != COMMAND_QUEUE_TYPE_GRAPHICS;
+
+    // Textures that require a graphics context to generate their mip levels
+    Uint32 NumGraphicsOnlyResources = 0;
+
+    // The number of resources and bytes uploaded by this call, and the number of resources
+    // that did not fit into the budget and will be initialized by the next call.
+    Uint32 NumUploadedResources = 0;
+    Uint64 UploadSize           = 0;
+    Uint32 NumPendingResources  = 0;
+
+    // Returns true if the resource with the given upload size fits into the budget.
+    // At least one resource is always initialized to guarantee forward progress.
+    const auto FitsIntoBudget = [&](Uint64 Size) {
+        if (NumUploadedResources > 0 && (UploadSize + Size > MaxUploadSize || NumPendingResources > 0))
+        {
+            ++NumPendingResources;
+            return false;
+        }
+        ++NumUploadedResources;
+        UploadSize += Size;
+        return true;
+    };
+
     for (Uint32 i = 0; i < Textures.size(); ++i)
     {
         auto&     DstTexInfo = Textures[i];
         ITexture* pTexture   = nullptr;
 
-        RefCntAutoPtr<TextureInitData> pInitData;
+        IObject* pTexUserData = nullptr;
+        if (DstTexInfo.pAtlasSuballocation)
+            pTexUserData = DstTexInfo.pAtlasSuballocation->GetUserData();
+        else if (DstTexInfo.pTexture)
+            pTexUserData = DstTexInfo.pTexture->GetUserData();
+
+        if (pTexUserData == nullptr)
+        {
+            // Texture has already been initialized by this or another model
+            if (DstTexInfo.pAtlasSuballocation)
+                DstTexInfo.pAtlasSuballocation->GetAtlas()->GetTexture(pDevice, pCtx);
+            continue;
+        }
+
+        RefCntAutoPtr<TextureInitData> pInitData{ClassPtrCast<TextureInitData>(pTexUserData)};
+        if (IsTransferContext && DstTexInfo.pTexture && pInitData->Levels.size() == 1 && DstTexInfo.pTexture->GetDesc().MipLevels > 1)
+        {
+            ++NumGraphicsOnlyResources;
+            continue;
+        }
+        if (!FitsIntoBudget(pInitData->GetUploadSize()))
+            continue;
+
         if (DstTexInfo.pAtlasSuballocation)
         {
-            pTexture  = DstTexInfo.pAtlasSuballocation->GetAtlas()->GetTexture(pDevice, pCtx);
-            pInitData = ClassPtrCast<TextureInitData>(DstTexInfo.pAtlasSuballocation->GetUserData());
+            pTexture = DstTexInfo.pAtlasSuballocation->GetAtlas()->GetTexture(pDevice, pCtx);
             // User data is only set when the allocation is created, so no other
             // thread can call SetUserData() in parallel.
             DstTexInfo.pAtlasSuballocation->SetUserData(nullptr);
         }
-        else if (DstTexInfo.pTexture)
+        else
         {
-            pTexture  = DstTexInfo.pTexture;
-            pInitData = ClassPtrCast<TextureInitData>(pTexture->GetUserData());
+            pTexture = DstTexInfo.pTexture;
             // User data is only set when the texture is created, so no other
             // thread can call SetUserData() in parallel.
             pTexture->SetUserData(nullptr);
@@ -956,12 +1844,6 @@ void Model::PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx)
         if (!pTexture)
             continue;
 
-        if (pInitData == nullptr)
-        {
-            // Shared texture has already been initialized by another model
-            continue;
-        }
-
         const auto& Levels      = pInitData->Levels;
         auto&       pStagingTex = pInitData->pStagingTex;
         const auto  DstSlice    = DstTexInfo.pAtlasSuballocation ? DstTexInfo.pAtlasSuballocation->GetSlice() : 0;
@@ -1036,7 +1918,14 @@ void Model::PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx)
             // Texture is already initialized
         }
 
-        if (DstTexInfo.pTexture)
+        if (IsTransferContext)
+        {
+            // Textures that were initialized when they were created are not used by the transfer queue
+            // and are transitioned by the graphics queue when they are first used.
+            if (DstTexInfo.pTexture && (!Levels.empty() || pStagingTex))
+                Barriers.emplace_back(StateTransitionDesc{pTexture, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_COMMON, STATE_TRANSITION_FLAG_UPDATE_STATE});
+        }
+        else if (DstTexInfo.pTexture)
         {
             // Note that we may need to transition a texture even if it has been fully initialized,
             // as is the case with KTX/DDS textures.
@@ -1054,15 +1943,38 @@ void Model::PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx)
         RefCntAutoPtr<IDataBlob> pInitData;
         if (BuffInfo.pSuballocation)
         {
-            pBuffer   = BuffInfo.pSuballocation->GetAllocator()->GetBuffer(pDevice, pCtx);
-            Offset    = BuffInfo.pSuballocation->GetOffset();
             pInitData = RefCntAutoPtr<IDataBlob>{BuffInfo.pSuballocation->GetUserData(), IID_DataBlob};
+            if (pInitData && !FitsIntoBudget(pInitData->GetSize() - BuffInfo.UploadedSize))
+                continue;
+
+            pBuffer = BuffInfo.pSuballocation->GetAllocator()->GetBuffer(pDevice, pCtx);
+            Offset  = BuffInfo.pSuballocation->GetOffset();
+
+            if (pInitData && m_pResourceMgr)
+            {
+                // The data goes through the staging buffer of the resource manager. The part that does not fit
+                // into the free staging space is uploaded by the next call once the GPU has released the space.
+                const auto* pData = static_cast<const Uint8*>(pInitData->GetConstDataPtr());
+                BuffInfo.UploadedSize += m_pResourceMgr->UploadBufferData(pCtx, pBuffer, Offset + BuffInfo.UploadedSize,
+                                                                          pData + BuffInfo.UploadedSize, pInitData->GetSize() - BuffInfo.UploadedSize);
+                if (BuffInfo.UploadedSize < pInitData->GetSize())
+                {
+                    ++NumPendingResources;
+                    continue;
+                }
+                BuffInfo.UploadedSize = 0;
+                BuffInfo.pSuballocation->SetUserData(nullptr);
+                continue;
+            }
             BuffInfo.pSuballocation->SetUserData(nullptr);
         }
         else if (BuffInfo.pBuffer)
         {
-            pBuffer   = BuffInfo.pBuffer;
-            pInitData = RefCntAutoPtr<IDataBlob>{pBuffer->GetUserData(), IID_DataBlob};
+            pInitData = RefCntAutoPtr<IDataBlob>{BuffInfo.pBuffer->GetUserData(), IID_DataBlob};
+            if (pInitData && !FitsIntoBudget(pInitData->GetSize()))
+                continue;
+
+            pBuffer = BuffInfo.pBuffer;
             pBuffer->SetUserData(nullptr);
         }
         else
@@ -1076,7 +1988,8 @@ void Model::PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx)
             if (BuffInfo.pBuffer != nullptr)
             {
                 VERIFY_EXPR(BuffInfo.pBuffer == pBuffer);
-                Barriers.emplace_back(StateTransitionDesc{pBuffer, RESOURCE_STATE_UNKNOWN, BuffId == Buffers.size() - 1 ? RESOURCE_STATE_INDEX_BUFFER : RESOURCE_STATE_VERTEX_BUFFER, STATE_TRANSITION_FLAG_UPDATE_STATE});
+                const auto NewState = IsTransferContext ? RESOURCE_STATE_COMMON : (BuffId == Buffers.size() - 1 ? RESOURCE_STATE_INDEX_BUFFER : RESOURCE_STATE_VERTEX_BUFFER);
+                Barriers.emplace_back(StateTransitionDesc{pBuffer, RESOURCE_STATE_UNKNOWN, NewState, STATE_TRANSITION_FLAG_UPDATE_STATE});
             }
         }
     }
@@ -1084,67 +1997,288 @@ void Model::PrepareGPUResources(IRenderDevice* pDevice, IDeviceContext* pCtx)
     if (!Barriers.empty())
         pCtx->TransitionResourceStates(static_cast<Uint32>(Barriers.size()), Barriers.data());
 
-    GPUDataInitialized.store(true);
+    return NumPendingResources + NumGraphicsOnlyResources;
 }
 
-void Model::LoadTextureSamplers(IRenderDevice* pDevice, const tinygltf::Model& gltf_model)
+Uint32 Model::StreamTextures(IRenderDevice*  pDevice,
+                             IDeviceContext* pCtx,
+                             Uint64          MaxUploadSize,
+                             const Uint32*   pTextureIds,
+                             Uint32          NumTextureIds)
 {
-    for (const tinygltf::Sampler& smpl : gltf_model.samplers)
+    DEV_CHECK_ERR(pDevice != nullptr && pCtx != nullptr, "Render device and device context must not be null");
+
+    Uint32 NumPendingTextures = 0;
+    for (const auto& StreamedTex : StreamedTextures)
     {
-        SamplerDesc SamDesc;
-        SamDesc.MagFilter = ModelBuilder::GetFilterType(smpl.magFilter).first;
-        auto MinMipFilter = ModelBuilder::GetFilterType(smpl.minFilter);
-        SamDesc.MinFilter = MinMipFilter.first;
-        SamDesc.MipFilter = MinMipFilter.second;
-        SamDesc.AddressU  = ModelBuilder::GetAddressMode(smpl.wrapS);
-        SamDesc.AddressV  = ModelBuilder::GetAddressMode(smpl.wrapT);
-        SamDesc.AddressW  = SamDesc.AddressV;
-        RefCntAutoPtr<ISampler> pSampler;
-        pDevice->CreateSampler(SamDesc, &pSampler);
-        TextureSamplers.push_back(std::move(pSampler));
+        if (StreamedTex.pInitData)
+            ++NumPendingTextures;
     }
-}
 
+    if (NumPendingTextures == 0 || !GPUDataInitialized.load())
+        return NumPendingTextures;
 
-void Model::LoadMaterials(const tinygltf::Model& gltf_model, const ModelCreateInfo::MaterialLoadCallbackType& MaterialLoadCallback)
-{
-    Materials.reserve(gltf_model.materials.size());
-    for (const tinygltf::Material& gltf_mat : gltf_model.materials)
+    Uint64 UploadSize = 0;
+    bool   Moved      = false;
+
+    const auto NumTexturesToCheck = pTextureIds != nullptr ? NumTextureIds : static_cast<Uint32>(StreamedTextures.size());
+    for (Uint32 i = 0; i < NumTexturesToCheck; ++i)
     {
-        Material Mat;
+        const auto TexIdx = pTextureIds != nullptr ? pTextureIds[i] : i;
+        if (TexIdx >= StreamedTextures.size() || !StreamedTextures[TexIdx].pInitData)
+            continue;
 
-        auto FindTexture = [&Mat](const TextureAttributeDesc& Attrib, const auto& Mapping) {
-            auto tex_it = Mapping.find(Attrib.Name);
-            if (tex_it == Mapping.end())
-                return false;
+        auto&       StreamedTex = StreamedTextures[TexIdx];
+        const auto* pInitData   = ClassPtrCast<TextureInitData>(StreamedTex.pInitData.RawPtr());
 
-            VERIFY_EXPR(Attrib.Index < Material::NumTextureAttributes);
-            Mat.TextureIds[Attrib.Index]             = tex_it->second.TextureIndex();
-            (&Mat.Attribs.UVSelector0)[Attrib.Index] = static_cast<float>(tex_it->second.TextureTexCoord());
+        Uint64 TexUploadSize = 0;
+        for (const auto& Level : pInitData->Levels)
+            TexUploadSize += Level.Data.size();
+        if (UploadSize > 0 && UploadSize + TexUploadSize > MaxUploadSize)
+            break;
 
-            return true;
-        };
+        auto& TexInfo = Textures[TexIdx];
+        VERIFY_EXPR(TexInfo.pAtlasSuballocation);
+        auto* pAtlas = TexInfo.pAtlasSuballocation->GetAtlas();
 
-        for (size_t i = 0; i < NumTextureAttributes; ++i)
+        RefCntAutoPtr<ITextureAtlasSuballocation> pAllocation;
+        pAtlas->Allocate(StreamedTex.Width, StreamedTex.Height, &pAllocation);
+        if (!pAllocation)
         {
-            const auto& Attrib = GetTextureAttribute(i);
-            // Search in values
-            auto TexFound = FindTexture(Attrib, gltf_mat.values);
-
-            // Search in additional values
-            if (!TexFound)
-                TexFound = FindTexture(Attrib, gltf_mat.additionalValues);
+            LOG_ERROR_MESSAGE("Failed to allocate space for texture ", TexIdx, " in the atlas");
+            break;
         }
 
-        auto ReadFactor = [](float& Factor, const tinygltf::ParameterMap& Params, const char* Name) //
+        // Allocation may resize the atlas, so get the texture after allocating the new space
+        auto* pTexture = pAtlas->GetTexture(pDevice, pCtx);
+
+        const auto& Origin = pAllocation->GetOrigin();
+        VERIFY_EXPR(pInitData->Levels.size() == pTexture->GetDesc().MipLevels);
+        for (Uint32 mip = 0; mip < pInitData->Levels.size(); ++mip)
         {
-            auto it = Params.find(Name);
-            if (it != Params.end())
-            {
-                Factor = static_cast<float>(it->second.Factor());
-            }
-        };
-        ReadFactor(Mat.Attribs.RoughnessFactor, gltf_mat.values, "roughnessFactor");
+            const auto& Level = pInitData->Levels[mip];
+
+            Box UpdateBox;
+            UpdateBox.MinX = Origin.x >> mip;
+            UpdateBox.MaxX = UpdateBox.MinX + Level.Width;
+            UpdateBox.MinY = Origin.y >> mip;
+            UpdateBox.MaxY = UpdateBox.MinY + Level.Height;
+            pCtx->UpdateTexture(pTexture, mip, pAllocation->GetSlice(), UpdateBox, Level.SubResData, RESOURCE_STATE_TRANSITION_MODE_NONE, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        }
+
+        // The mip tail allocation is released
+        TexInfo.pAtlasSuballocation = std::move(pAllocation);
+        for (auto& Mat : Materials)
+            InitMaterialTextureAddressingAttribs(Mat, TexIdx);
+
+        StreamedTex.pInitData.Release();
+        UploadSize += TexUploadSize;
+        --NumPendingTextures;
+        Moved = true;
+    }
+
+    if (Moved)
+        ++RelocationVersion;
+
+    return NumPendingTextures;
+}
+
+Uint64 Model::Defragment(IRenderDevice* pDevice, IDeviceContext* pCtx, Uint64 MaxCopySize)
+{
+    DEV_CHECK_ERR(pDevice != nullptr && pCtx != nullptr, "Render device and device context must not be null");
+
+    if (!GPUDataInitialized.load())
+        return 0;
+
+    // Allocations referenced by other models or by pending initialization data can't be moved
+    const auto IsMovable = [](IObject* pAllocation) {
+        return pAllocation->GetUserData() == nullptr &&
+            pAllocation->GetReferenceCounters()->GetNumStrongRefs() == 1;
+    };
+
+    Uint64 CopySize = 0;
+    bool   Moved    = false;
+
+    for (auto& BuffInfo : Buffers)
+    {
+        if (!BuffInfo.pSuballocation || !IsMovable(BuffInfo.pSuballocation))
+            continue;
+
+        const auto Size = BuffInfo.pSuballocation->GetSize();
+        if (CopySize + Size > MaxCopySize)
+            continue;
+
+        auto* pAllocator = BuffInfo.pSuballocation->GetAllocator();
+
+        RefCntAutoPtr<IBufferSuballocation> pNewAllocation;
+        pAllocator->Allocate(Size, 1, &pNewAllocation);
+        if (!pNewAllocation ||
+            pNewAllocation->GetOffset() >= BuffInfo.pSuballocation->GetOffset() ||
+            (pNewAllocation->GetOffset() % BuffInfo.ElementStride) != 0)
+            continue; // The new allocation is released
+
+        // Allocation may resize the buffer, so get it after allocating the new space.
+        // Source and destination regions do not overlap since the old allocation is alive.
+        auto* pBuffer = pAllocator->GetBuffer(pDevice, pCtx);
+        pCtx->CopyBuffer(pBuffer, BuffInfo.pSuballocation->GetOffset(), RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                         pBuffer, pNewAllocation->GetOffset(), Size, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+        BuffInfo.pSuballocation = std::move(pNewAllocation);
+        CopySize += Size;
+        Moved = true;
+    }
+
+    for (Uint32 TexIdx = 0; TexIdx < Textures.size(); ++TexIdx)
+    {
+        auto& pSuballocation = Textures[TexIdx].pAtlasSuballocation;
+        if (!pSuballocation || pSuballocation->GetSlice() == 0 || !IsMovable(pSuballocation))
+            continue;
+
+        auto* pAtlas = pSuballocation->GetAtlas();
+        VERIFY(pAtlas != nullptr, "Texture altas can't be null");
+
+        const auto& AtlasDesc  = pAtlas->GetAtlasDesc();
+        const auto& FmtAttribs = GetTextureFormatAttribs(AtlasDesc.Format);
+        const auto  Size       = pSuballocation->GetSize();
+
+        Uint64 AllocSize = 0;
+        for (Uint32 mip = 0; mip < AtlasDesc.MipLevels; ++mip)
+        {
+            const auto MipW = std::max(Size.x >> mip, 1u);
+            const auto MipH = std::max(Size.y >> mip, 1u);
+            if (FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED)
+                AllocSize += Uint64{(MipW + FmtAttribs.BlockWidth - 1u) / FmtAttribs.BlockWidth} * Uint64{(MipH + FmtAttribs.BlockHeight - 1u) / FmtAttribs.BlockHeight} * FmtAttribs.ComponentSize;
+            else
+                AllocSize += Uint64{MipW} * Uint64{MipH} * FmtAttribs.ComponentSize * FmtAttribs.NumComponents;
+        }
+        if (CopySize + AllocSize > MaxCopySize)
+            continue;
+
+        RefCntAutoPtr<ITextureAtlasSuballocation> pNewAllocation;
+        pAtlas->Allocate(Size.x, Size.y, &pNewAllocation);
+        if (!pNewAllocation || pNewAllocation->GetSlice() >= pSuballocation->GetSlice())
+            continue;
+
+        auto* pTexture = pAtlas->GetTexture(pDevice, pCtx);
+
+        const auto& SrcOrigin = pSuballocation->GetOrigin();
+        const auto& DstOrigin = pNewAllocation->GetOrigin();
+        for (Uint32 mip = 0; mip < AtlasDesc.MipLevels; ++mip)
+        {
+            const auto MipProps = GetMipLevelProperties(AtlasDesc, mip);
+
+            Box SrcBox;
+            SrcBox.MinX = SrcOrigin.x >> mip;
+            SrcBox.MinY = SrcOrigin.y >> mip;
+            SrcBox.MaxX = std::min(SrcBox.MinX + std::max(Size.x >> mip, 1u), MipProps.LogicalWidth);
+            SrcBox.MaxY = std::min(SrcBox.MinY + std::max(Size.y >> mip, 1u), MipProps.LogicalHeight);
+            if (FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED)
+            {
+                // Do not copy mip levels where the region is not aligned to the block size
+                if ((SrcBox.MinX % FmtAttribs.BlockWidth) != 0 || (SrcBox.MinY % FmtAttribs.BlockHeight) != 0 ||
+                    ((DstOrigin.x >> mip) % FmtAttribs.BlockWidth) != 0 || ((DstOrigin.y >> mip) % FmtAttribs.BlockHeight) != 0)
+                    break;
+                SrcBox.MaxX = std::min(AlignUp(SrcBox.MaxX, Uint32{FmtAttribs.BlockWidth}), MipProps.StorageWidth);
+                SrcBox.MaxY = std::min(AlignUp(SrcBox.MaxY, Uint32{FmtAttribs.BlockHeight}), MipProps.StorageHeight);
+            }
+
+            CopyTextureAttribs CopyAttribs{pTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, pTexture, RESOURCE_STATE_TRANSITION_MODE_TRANSITION};
+            CopyAttribs.pSrcBox     = &SrcBox;
+            CopyAttribs.SrcMipLevel = mip;
+            CopyAttribs.SrcSlice    = pSuballocation->GetSlice();
+            CopyAttribs.DstMipLevel = mip;
+            CopyAttribs.DstSlice    = pNewAllocation->GetSlice();
+            CopyAttribs.DstX        = DstOrigin.x >> mip;
+            CopyAttribs.DstY        = DstOrigin.y >> mip;
+            pCtx->CopyTexture(CopyAttribs);
+        }
+
+        pSuballocation = std::move(pNewAllocation);
+        for (auto& Mat : Materials)
+            InitMaterialTextureAddressingAttribs(Mat, TexIdx);
+
+        CopySize += AllocSize;
+        Moved = true;
+    }
+
+    if (Moved)
+        ++RelocationVersion;
+
+    return CopySize;
+}
+
+void Model::LoadTextureSamplers(IRenderDevice*         pDevice,
+                                TextureCacheType*      pTextureCache,
+                                ResourceManager*       pResourceMgr,
+                                const tinygltf::Model& gltf_model)
+{
+    for (const tinygltf::Sampler& smpl : gltf_model.samplers)
+    {
+        SamplerDesc SamDesc;
+        SamDesc.MagFilter = ModelBuilder::GetFilterType(smpl.magFilter).first;
+        auto MinMipFilter = ModelBuilder::GetFilterType(smpl.minFilter);
+        SamDesc.MinFilter = MinMipFilter.first;
+        SamDesc.MipFilter = MinMipFilter.second;
+        SamDesc.AddressU  = ModelBuilder::GetAddressMode(smpl.wrapS);
+        SamDesc.AddressV  = ModelBuilder::GetAddressMode(smpl.wrapT);
+        SamDesc.AddressW  = SamDesc.AddressV;
+        TextureSamplers.push_back(GetSharedSampler(pDevice, pTextureCache, pResourceMgr, SamDesc));
+        if (m_pLoadingState)
+            m_pLoadingState->SamplerDescs.push_back(SamDesc);
+    }
+}
+
+
+void Model::LoadMaterials(const tinygltf::Model&                          gltf_model,
+                          const ModelCreateInfo::MaterialLoadCallbackType& MaterialLoadCallback,
+                          const std::vector<bool>*                         pUsedMaterials)
+{
+    Materials.reserve(gltf_model.materials.size());
+    for (size_t mat_idx = 0; mat_idx < gltf_model.materials.size(); ++mat_idx)
+    {
+        const tinygltf::Material& gltf_mat = gltf_model.materials[mat_idx];
+
+        Material Mat;
+        Mat.Name = gltf_mat.name;
+        if (pUsedMaterials != nullptr && !(*pUsedMaterials)[mat_idx])
+        {
+            // Keep the entry so that material indices match the glTF file
+            Materials.push_back(Mat);
+            continue;
+        }
+
+        auto FindTexture = [&Mat](const TextureAttributeDesc& Attrib, const auto& Mapping) {
+            auto tex_it = Mapping.find(Attrib.Name);
+            if (tex_it == Mapping.end())
+                return false;
+
+            VERIFY_EXPR(Attrib.Index < Material::NumTextureAttributes);
+            Mat.TextureIds[Attrib.Index]             = tex_it->second.TextureIndex();
+            (&Mat.Attribs.UVSelector0)[Attrib.Index] = static_cast<float>(tex_it->second.TextureTexCoord());
+
+            return true;
+        };
+
+        for (size_t i = 0; i < NumTextureAttributes; ++i)
+        {
+            const auto& Attrib = GetTextureAttribute(i);
+            // Search in values
+            auto TexFound = FindTexture(Attrib, gltf_mat.values);
+
+            // Search in additional values
+            if (!TexFound)
+                TexFound = FindTexture(Attrib, gltf_mat.additionalValues);
+        }
+
+        auto ReadFactor = [](float& Factor, const tinygltf::ParameterMap& Params, const char* Name) //
+        {
+            auto it = Params.find(Name);
+            if (it != Params.end())
+            {
+                Factor = static_cast<float>(it->second.Factor());
+            }
+        };
+        ReadFactor(Mat.Attribs.RoughnessFactor, gltf_mat.values, "roughnessFactor");
         ReadFactor(Mat.Attribs.MetallicFactor, gltf_mat.values, "metallicFactor");
 
         auto ReadColorFactor = [](float4& Factor, const tinygltf::ParameterMap& Params, const char* Name) //
@@ -1278,6 +2412,13 @@ struct LoaderData
 
     ModelCreateInfo::FileExistsCallbackType    FileExists    = nullptr;
     ModelCreateInfo::ReadWholeFileCallbackType ReadWholeFile = nullptr;
+    ModelCreateInfo::ReadFileRangeCallbackType ReadFileRange = nullptr;
+
+    // When true, image decoding is deferred to Model::PrepareTextures()
+    bool DeferDecoding = false;
+
+    // See ModelCreateInfo::MaxTextureDimension
+    Uint32 MaxTextureDimension = 0;
 };
 
 
@@ -1320,43 +2461,29 @@ bool LoadImageData(tinygltf::Image*     gltf_image,
         }
         else if (pLoaderData->pTextureCache != nullptr)
         {
-            auto& TexCache = *pLoaderData->pTextureCache;
-
-            std::lock_guard<std::mutex> Lock{TexCache.TexturesMtx};
-
-            auto it = TexCache.Textures.find(CacheId);
-            if (it != TexCache.Textures.end())
+            if (auto pTexture = pLoaderData->pTextureCache->Find(CacheId))
             {
-                if (auto pTexture = it->second.Lock())
-                {
-                    const auto& TexDesc    = pTexture->GetDesc();
-                    const auto& FmtAttribs = GetTextureFormatAttribs(TexDesc.Format);
+                const auto& TexDesc    = pTexture->GetDesc();
+                const auto& FmtAttribs = GetTextureFormatAttribs(TexDesc.Format);
 
-                    gltf_image->width      = TexDesc.Width;
-                    gltf_image->height     = TexDesc.Height;
-                    gltf_image->component  = FmtAttribs.NumComponents;
-                    gltf_image->bits       = FmtAttribs.ComponentSize * 8;
-                    gltf_image->pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
+                gltf_image->width      = TexDesc.Width;
+                gltf_image->height     = TexDesc.Height;
+                gltf_image->component  = FmtAttribs.NumComponents;
+                gltf_image->bits       = FmtAttribs.ComponentSize * 8;
+                gltf_image->pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
 
-                    // Keep strong reference to ensure the texture is alive (second time, but that's fine).
-                    pLoaderData->TexturesHold.emplace_back(std::move(pTexture));
+                // Keep strong reference to ensure the texture is alive (second time, but that's fine).
+                pLoaderData->TexturesHold.emplace_back(std::move(pTexture));
 
-                    return true;
-                }
-                else
-                {
-                    // Texture is stale - remove it from the cache
-                    TexCache.Textures.erase(it);
-                }
+                return true;
             }
         }
     }
 
     VERIFY(size != 1, "The texture was previously cached, but was not found in the cache now");
 
-    ImageLoadInfo LoadInfo;
-    LoadInfo.Format = Image::GetFileFormat(image_data, size);
-    if (LoadInfo.Format == IMAGE_FILE_FORMAT_UNKNOWN)
+    const auto ImgFileFormat = Image::GetFileFormat(image_data, size);
+    if (ImgFileFormat == IMAGE_FILE_FORMAT_UNKNOWN)
     {
         if (error != nullptr)
         {
@@ -1365,102 +2492,23 @@ bool LoadImageData(tinygltf::Image*     gltf_image,
         return false;
     }
 
-    if (LoadInfo.Format == IMAGE_FILE_FORMAT_DDS || LoadInfo.Format == IMAGE_FILE_FORMAT_KTX)
+    if (ImgFileFormat == IMAGE_FILE_FORMAT_DDS || ImgFileFormat == IMAGE_FILE_FORMAT_KTX ||
+        (pLoaderData != nullptr && pLoaderData->DeferDecoding))
     {
-        // Store binary data directly
+        // Store binary data directly.
+        // When decoding is deferred, the image will be decoded by Model::PrepareTextures().
         gltf_image->image.resize(size);
         memcpy(gltf_image->image.data(), image_data, size);
         // Use pixel_type field to indicate the file format
-        gltf_image->pixel_type = LoadInfo.Format;
-    }
-    else
-    {
-        auto pImageData = DataBlobImpl::Create(size);
-        memcpy(pImageData->GetDataPtr(), image_data, size);
-        RefCntAutoPtr<Image> pImage;
-        Image::CreateFromDataBlob(pImageData, LoadInfo, &pImage);
-        if (!pImage)
-        {
-            if (error != nullptr)
-            {
-                *error += FormatString("Failed to load image[", gltf_image_idx, "] name = '", gltf_image->name, "'");
-            }
-            return false;
-        }
-        const auto& ImgDesc = pImage->GetDesc();
-
-        if (req_width > 0)
-        {
-            if (static_cast<Uint32>(req_width) != ImgDesc.Width)
-            {
-                if (error != nullptr)
-                {
-                    (*error) += FormatString("Image width mismatch for image[",
-                                             gltf_image_idx, "] name = '", gltf_image->name,
-                                             "': requested width: ",
-                                             req_width, ", actual width: ",
-                                             ImgDesc.Width);
-                }
-                return false;
-            }
-        }
-
-        if (req_height > 0)
-        {
-            if (static_cast<Uint32>(req_height) != ImgDesc.Height)
-            {
-                if (error != nullptr)
-                {
-                    (*error) += FormatString("Image height mismatch for image[",
-                                             gltf_image_idx, "] name = '", gltf_image->name,
-                                             "': requested height: ",
-                                             req_height, ", actual height: ",
-                                             ImgDesc.Height);
-                }
-                return false;
-            }
-        }
-
-        gltf_image->width      = ImgDesc.Width;
-        gltf_image->height     = ImgDesc.Height;
-        gltf_image->component  = 4;
-        gltf_image->bits       = GetValueSize(ImgDesc.ComponentType) * 8;
-        gltf_image->pixel_type = TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE;
-        size_t DstRowSize      = static_cast<size_t>(gltf_image->width) * gltf_image->component * (gltf_image->bits / 8);
-        gltf_image->image.resize(static_cast<size_t>(gltf_image->height) * DstRowSize);
-        auto*        pPixelsBlob = pImage->GetData();
-        const Uint8* pSrcPixels  = static_cast<const Uint8*>(pPixelsBlob->GetDataPtr());
-        if (ImgDesc.NumComponents == 3)
-        {
-            for (size_t row = 0; row < ImgDesc.Height; ++row)
-            {
-                for (size_t col = 0; col < ImgDesc.Width; ++col)
-                {
-                    Uint8*       DstPixel = gltf_image->image.data() + DstRowSize * row + col * gltf_image->component;
-                    const Uint8* SrcPixel = pSrcPixels + ImgDesc.RowStride * row + col * ImgDesc.NumComponents;
-
-                    DstPixel[0] = SrcPixel[0];
-                    DstPixel[1] = SrcPixel[1];
-                    DstPixel[2] = SrcPixel[2];
-                    DstPixel[3] = 255;
-                }
-            }
-        }
-        else if (gltf_image->component == 4)
-        {
-            for (size_t row = 0; row < ImgDesc.Height; ++row)
-            {
-                memcpy(gltf_image->image.data() + DstRowSize * row, pSrcPixels + ImgDesc.RowStride * row, DstRowSize);
-            }
-        }
-        else
-        {
-            *error += FormatString("Unexpected number of image components (", ImgDesc.NumComponents, ")");
-            return false;
-        }
+        gltf_image->pixel_type = ImgFileFormat;
+        // Negative width and height indicate that the image data is not decoded
+        gltf_image->width  = -1;
+        gltf_image->height = -1;
+        return true;
     }
 
-    return true;
+    const auto MaxDimension = pLoaderData != nullptr ? pLoaderData->MaxTextureDimension : 0u;
+    return DecodeGltfImage(image_data, size, ImgFileFormat, gltf_image_idx, req_width, req_height, MaxDimension, *gltf_image, error);
 }
 
 bool FileExists(const std::string& abs_filename, void* user_data)
@@ -1477,10 +2525,7 @@ bool FileExists(const std::string& abs_filename, void* user_data)
         }
         else if (pLoaderData->pTextureCache != nullptr)
         {
-            std::lock_guard<std::mutex> Lock{pLoaderData->pTextureCache->TexturesMtx};
-
-            auto it = pLoaderData->pTextureCache->Textures.find(CacheId.c_str());
-            if (it != pLoaderData->pTextureCache->Textures.end())
+            if (pLoaderData->pTextureCache->Find(CacheId) != nullptr)
                 return true;
         }
 
@@ -1516,19 +2561,13 @@ bool ReadWholeFile(std::vector<unsigned char>* out,
         }
         else if (pLoaderData->pTextureCache != nullptr)
         {
-            std::lock_guard<std::mutex> Lock{pLoaderData->pTextureCache->TexturesMtx};
-
-            auto it = pLoaderData->pTextureCache->Textures.find(CacheId.c_str());
-            if (it != pLoaderData->pTextureCache->Textures.end())
+            if (auto pTexture = pLoaderData->pTextureCache->Find(CacheId))
             {
-                if (auto pTexture = it->second.Lock())
-                {
-                    // Keep strong reference to ensure the texture is alive.
-                    pLoaderData->TexturesHold.emplace_back(std::move(pTexture));
-                    // Tiny GLTF checks the size of 'out', it can't be empty
-                    out->resize(1);
-                    return true;
-                }
+                // Keep strong reference to ensure the texture is alive.
+                pLoaderData->TexturesHold.emplace_back(std::move(pTexture));
+                // Tiny GLTF checks the size of 'out', it can't be empty
+                out->resize(1);
+                return true;
             }
         }
 
@@ -1562,344 +2601,4179 @@ bool ReadWholeFile(std::vector<unsigned char>* out,
     return true;
 }
 
+bool ReadFileRange(std::vector<unsigned char>* out,
+                   std::string*                err,
+                   const std::string&          filepath,
+                   size_t                      offset,
+                   size_t                      size,
+                   void*                       user_data)
+{
+    VERIFY_EXPR(out != nullptr);
+    VERIFY_EXPR(err != nullptr);
+
+    auto* pLoaderData = static_cast<LoaderData*>(user_data);
+    if (pLoaderData == nullptr || !pLoaderData->ReadFileRange)
+    {
+        UNEXPECTED("Read file range callback is not set");
+        return false;
+    }
+
+    return pLoaderData->ReadFileRange(filepath.c_str(), offset, size, *out, *err);
+}
+
 } // namespace
 
 } // namespace Callbacks
 
-void Model::LoadFromFile(IRenderDevice*         pDevice,
-                         IDeviceContext*        pContext,
-                         const ModelCreateInfo& CI)
+struct Model::LoadingState
 {
-    if (CI.FileName == nullptr || *CI.FileName == 0)
-        LOG_ERROR_AND_THROW("File path must not be empty");
+    LoadingState(TextureCacheType* pTextureCache, ResourceManager* pResourceMgr) :
+        LoaderData{pTextureCache, pResourceMgr, {}, ""}
+    {}
 
-    auto* const pTextureCache = CI.pTextureCache;
-    auto* const pResourceMgr  = CI.pCacheInfo != nullptr ? CI.pCacheInfo->pResourceMgr : nullptr;
-    if (CI.pTextureCache != nullptr && pResourceMgr != nullptr)
-        LOG_WARNING_MESSAGE("Texture cache is ignored when resource manager is used");
+    Callbacks::LoaderData LoaderData;
 
-    Callbacks::LoaderData LoaderData{pTextureCache, pResourceMgr, {}, ""};
+    tinygltf::Model gltf_model;
 
-    const std::string filename{CI.FileName};
-    if (filename.find_last_of("/\\") != std::string::npos)
-        LoaderData.BaseDir = filename.substr(0, filename.find_last_of("/\\"));
-    LoaderData.BaseDir += '/';
+    ModelLoadProgress* pProgress = nullptr;
+    ModelLoadStats*    pStats    = nullptr;
 
-    LoaderData.FileExists    = CI.FileExistsCallback;
-    LoaderData.ReadWholeFile = CI.ReadWholeFileCallback;
+    // Images decoded by PrepareTextures(), for each image in gltf_model.images.
+    std::vector<tinygltf::Image> DecodedImages;
 
-    tinygltf::TinyGLTF gltf_context;
-    gltf_context.SetImageLoader(Callbacks::LoadImageData, &LoaderData);
-    tinygltf::FsCallbacks fsCallbacks = {};
-    fsCallbacks.ExpandFilePath        = tinygltf::ExpandFilePath;
-    fsCallbacks.FileExists            = Callbacks::FileExists;
-    fsCallbacks.ReadWholeFile         = Callbacks::ReadWholeFile;
-    fsCallbacks.WriteWholeFile        = tinygltf::WriteWholeFile;
-    fsCallbacks.user_data             = &LoaderData;
-    gltf_context.SetFsCallbacks(fsCallbacks);
+    // The index of the last texture that references the image, for each image in gltf_model.images.
+    // Image data is released when this texture is committed.
+    std::vector<Uint32> ImageLastTextures;
 
-    bool   binary = false;
-    size_t extpos = filename.rfind('.', filename.length());
-    if (extpos != std::string::npos)
-    {
-        binary = (filename.substr(extpos + 1, filename.length() - extpos) == "glb");
-    }
+    // Image data, cache id and prepared init data, for each texture in gltf_model.textures.
+    std::vector<ImageData>                      Images;
+    std::vector<std::string>                    CacheIds;
+    std::vector<RefCntAutoPtr<TextureInitData>> InitData;
 
-    std::string     error;
-    std::string     warning;
-    tinygltf::Model gltf_model;
+    // Texture sampler index, for each texture.
+    std::vector<int> SamplerIds;
 
-    bool fileLoaded = false;
-    if (binary)
-        fileLoaded = gltf_context.LoadBinaryFromFile(&gltf_model, &error, &warning, filename.c_str());
-    else
-        fileLoaded = gltf_context.LoadASCIIFromFile(&gltf_model, &error, &warning, filename.c_str());
-    if (!fileLoaded)
-    {
-        LOG_ERROR_AND_THROW("Failed to load gltf file ", filename, ": ", error);
-    }
-    if (!warning.empty())
-    {
-        LOG_WARNING_MESSAGE("Loaded gltf file ", filename, " with the following warning:", warning);
-    }
+    // Description of every texture sampler. The model is baked from the descriptions,
+    // as samplers are not created when the model is baked without a render device.
+    std::vector<SamplerDesc> SamplerDescs;
 
-    // Load materials first as the LoadTextures() function needs them to determine the alpha-cut value.
-    LoadMaterials(gltf_model, CI.MaterialLoadCallback);
-    LoadTextureSamplers(pDevice, gltf_model);
-    LoadTextures(pDevice, gltf_model, LoaderData.BaseDir, pTextureCache, pResourceMgr);
+    // Textures that are not used by the loaded scene, see ModelCreateInfo::LoadSceneSubset.
+    // Empty if all textures are loaded.
+    std::vector<bool> SkippedTextures;
 
-    std::vector<int> NodeIds;
-    if (!gltf_model.scenes.empty())
-    {
-        auto SceneId = CI.SceneId;
-        if (SceneId >= static_cast<int>(gltf_model.scenes.size()))
-        {
-            LOG_ERROR_MESSAGE("Scene id ", SceneId, " is invalid: GLTF model only contains ", gltf_model.scenes.size(), " scenes. Loading default scene.");
-            SceneId = -1;
-        }
-        if (SceneId < 0)
-        {
-            SceneId = gltf_model.defaultScene >= 0 ? gltf_model.defaultScene : 0;
-        }
-        NodeIds = gltf_model.scenes[SceneId].nodes;
-    }
-    else
+    bool IsTextureSkipped(Uint32 TextureIndex) const
     {
-        NodeIds.resize(gltf_model.nodes.size());
-        // Load all nodes if there is no scene
-        for (int node_idx = 0; node_idx < static_cast<int>(gltf_model.nodes.size()); ++node_idx)
-            NodeIds[node_idx] = node_idx;
+        return !SkippedTextures.empty() && SkippedTextures[TextureIndex];
     }
 
-    ModelBuilder Builder{CI, *this};
-    Builder.Execute(TinyGltfModelWrapper{gltf_model}, NodeIds, pDevice, pContext);
+    // The number of textures that have been prepared by PrepareTextures()
+    // and are ready to be added to the model by CommitTextures().
+    std::atomic<Uint32> NumPreparedTextures{0};
 
-    Extensions = gltf_model.extensionsUsed;
-}
+    // Contents of the baked model file when the model is loaded from it.
+    std::vector<Uint8> BakedData;
 
-BoundBox Model::ComputeBoundingBox(const ModelTransforms& Transforms) const
-{
-    BoundBox ModelAABB;
+    // Offset of the texture section in BakedData.
+    size_t BakedTexturesOffset = 0;
 
-    if (CompatibleWithTransforms(Transforms))
-    {
-        ModelAABB.Min = float3{+FLT_MAX, +FLT_MAX, +FLT_MAX};
-        ModelAABB.Max = float3{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    // The file to bake the model into, see ModelCreateInfo::BakedFileName.
+    std::string BakedFileName;
 
-        for (size_t i = 0; i < LinearNodes.size(); ++i)
+    // Converted index, vertex and meshlet data kept for baking.
+    std::vector<Uint8>              IndexData;
+    std::vector<std::vector<Uint8>> VertexData;
+    std::vector<Uint32>             MeshletData;
+};
+
+namespace
+{
+
+void SetLoadStage(ModelLoadProgress* pProgress, MODEL_LOAD_STAGE Stage, Uint32 NumItems)
+{
+    if (pProgress == nullptr)
+        return;
+
+    pProgress->NumItems.store(NumItems);
+    pProgress->NumItemsProcessed.store(0);
+    pProgress->Stage.store(Stage);
+}
+
+void CheckLoadCancelled(const ModelLoadProgress* pProgress)
+{
+    if (pProgress != nullptr && pProgress->CancelRequested.load())
+        LOG_ERROR_AND_THROW("Model loading has been cancelled");
+}
+
+// Returns the index of the texture image in gltf_model.images.
+// Textures that use the KHR_texture_basisu extension reference the KTX2 image in the extension.
+// The core source, if present, is a fallback image in a widely supported format, and is preferred
+// as Basis Universal images can't be transcoded.
+// Returns -1 if the texture does not reference a valid image.
+int FindGltfTextureSource(const tinygltf::Model& gltf_model, Uint32 TextureIndex)
+{
+    const auto& gltf_tex = gltf_model.textures[TextureIndex];
+
+    int Source = gltf_tex.source;
+    if (Source < 0)
+    {
+        auto ext_it = gltf_tex.extensions.find("KHR_texture_basisu");
+        if (ext_it != gltf_tex.extensions.end() && ext_it->second.Has("source"))
+        {
+            const auto& ExtSource = ext_it->second.Get("source");
+            if (ExtSource.IsInt())
+                Source = ExtSource.Get<int>();
+        }
+    }
+
+    return (Source >= 0 && static_cast<size_t>(Source) < gltf_model.images.size()) ? Source : -1;
+}
+
+int GetGltfTextureSource(const tinygltf::Model& gltf_model, Uint32 TextureIndex)
+{
+    const auto Source = FindGltfTextureSource(gltf_model, TextureIndex);
+    if (Source < 0)
+        LOG_ERROR_AND_THROW("Texture ", TextureIndex, " references invalid image ", gltf_model.textures[TextureIndex].source);
+
+    return Source;
+}
+
+// Calls Handler(MaterialId, VariantId) for every variant of every mapping of the KHR_materials_variants extension of the primitive.
+template <typename HandlerType>
+void ProcessMaterialVariantMappings(const tinygltf::Primitive& gltf_primitive, HandlerType&& Handler)
+{
+    auto ext_it = gltf_primitive.extensions.find("KHR_materials_variants");
+    if (ext_it == gltf_primitive.extensions.end() || !ext_it->second.Has("mappings"))
+        return;
+
+    const auto& Mappings = ext_it->second.Get("mappings");
+    for (size_t i = 0; i < Mappings.ArrayLen(); ++i)
+    {
+        const auto& Mapping = Mappings.Get(static_cast<int>(i));
+        if (!Mapping.Has("material") || !Mapping.Has("variants"))
+            continue;
+
+        const auto  MaterialId = Mapping.Get("material").GetNumberAsInt();
+        const auto& Variants   = Mapping.Get("variants");
+        for (size_t v = 0; v < Variants.ArrayLen(); ++v)
+            Handler(MaterialId, Variants.Get(static_cast<int>(v)).GetNumberAsInt());
+    }
+}
+
+// Marks the meshes and materials that are used by the nodes in the hierarchies of NodeIds.
+// Materials of all variants of the used primitives are marked as well.
+void FindSceneMeshesAndMaterials(const tinygltf::Model& gltf_model,
+                                 const std::vector<int>& NodeIds,
+                                 std::vector<bool>&      UsedMeshes,
+                                 std::vector<bool>&      UsedMaterials)
+{
+    UsedMeshes.assign(gltf_model.meshes.size(), false);
+    UsedMaterials.assign(gltf_model.materials.size(), false);
+
+    std::vector<bool> VisitedNodes(gltf_model.nodes.size(), false);
+    std::vector<int>  NodeStack{NodeIds};
+    while (!NodeStack.empty())
+    {
+        const auto NodeId = NodeStack.back();
+        NodeStack.pop_back();
+        if (NodeId < 0 || static_cast<size_t>(NodeId) >= gltf_model.nodes.size() || VisitedNodes[NodeId])
+            continue;
+        VisitedNodes[NodeId] = true;
+
+        const auto& gltf_node = gltf_model.nodes[NodeId];
+        NodeStack.insert(NodeStack.end(), gltf_node.children.begin(), gltf_node.children.end());
+
+        const auto MeshId = gltf_node.mesh;
+        if (MeshId < 0 || static_cast<size_t>(MeshId) >= gltf_model.meshes.size() || UsedMeshes[MeshId])
+            continue;
+        UsedMeshes[MeshId] = true;
+
+        for (const auto& gltf_primitive : gltf_model.meshes[MeshId].primitives)
+        {
+            if (gltf_primitive.material >= 0 && static_cast<size_t>(gltf_primitive.material) < UsedMaterials.size())
+                UsedMaterials[gltf_primitive.material] = true;
+
+            ProcessMaterialVariantMappings(gltf_primitive, [&UsedMaterials](int MaterialId, int /*VariantId*/) {
+                if (MaterialId >= 0 && static_cast<size_t>(MaterialId) < UsedMaterials.size())
+                    UsedMaterials[MaterialId] = true;
+            });
+        }
+    }
+}
+
+// Reads the external buffers that tinygltf deferred because ModelCreateInfo::ReadFileRangeCallback is set.
+// Only the buffer views referenced by the used meshes, skins, animations and instancing attributes are read.
+// Ranges that are close to each other are merged into a single read. The ranges of each buffer are packed
+// into a compact buffer and the views are redirected to it, so that the rest of the loader reads the data
+// as if the whole buffer was loaded. If pUsedMeshes is not null, only the meshes it marks are considered.
+void ReadDeferredBuffers(tinygltf::Model&                                  gltf_model,
+                         const std::vector<bool>*                          pUsedMeshes,
+                         const ModelCreateInfo::ReadFileRangeCallbackType& ReadFileRange,
+                         ModelLoadStats*                                   pStats)
+{
+    const auto IsDeferredBuffer = [&gltf_model](int BufferId) {
+        return BufferId >= 0 && static_cast<size_t>(BufferId) < gltf_model.buffers.size() && !gltf_model.buffers[BufferId].deferred_path.empty();
+    };
+
+    bool HasDeferredBuffers = false;
+    for (int BufferId = 0; BufferId < static_cast<int>(gltf_model.buffers.size()); ++BufferId)
+        HasDeferredBuffers = HasDeferredBuffers || IsDeferredBuffer(BufferId);
+    if (!HasDeferredBuffers)
+        return;
+
+    VERIFY(ReadFileRange, "Buffers can only be deferred when the read file range callback is set");
+
+    ScopedLoadStage Stage{pStats, MODEL_LOAD_PROFILE_STAGE_PARSE};
+
+    std::vector<bool> UsedViews(gltf_model.bufferViews.size(), false);
+
+    const auto MarkView = [&UsedViews](int ViewId) {
+        if (ViewId >= 0 && static_cast<size_t>(ViewId) < UsedViews.size())
+            UsedViews[ViewId] = true;
+    };
+    const auto MarkAccessor = [&gltf_model, &MarkView](int AccessorId) {
+        if (AccessorId < 0 || static_cast<size_t>(AccessorId) >= gltf_model.accessors.size())
+            return;
+
+        const auto& gltf_accessor = gltf_model.accessors[AccessorId];
+        MarkView(gltf_accessor.bufferView);
+        if (gltf_accessor.sparse.isSparse)
+        {
+            MarkView(gltf_accessor.sparse.indices.bufferView);
+            MarkView(gltf_accessor.sparse.values.bufferView);
+        }
+    };
+
+    for (size_t mesh_idx = 0; mesh_idx < gltf_model.meshes.size(); ++mesh_idx)
+    {
+        if (pUsedMeshes != nullptr && !(*pUsedMeshes)[mesh_idx])
+            continue;
+
+        for (const auto& gltf_primitive : gltf_model.meshes[mesh_idx].primitives)
+        {
+            MarkAccessor(gltf_primitive.indices);
+            for (const auto& Attrib : gltf_primitive.attributes)
+                MarkAccessor(Attrib.second);
+            for (const auto& Target : gltf_primitive.targets)
+            {
+                for (const auto& Attrib : Target)
+                    MarkAccessor(Attrib.second);
+            }
+
+            auto ext_it = gltf_primitive.extensions.find("KHR_draco_mesh_compression");
+            if (ext_it != gltf_primitive.extensions.end() && ext_it->second.Has("bufferView") && ext_it->second.Get("bufferView").IsInt())
+                MarkView(ext_it->second.Get("bufferView").Get<int>());
+        }
+    }
+
+    for (const auto& gltf_node : gltf_model.nodes)
+    {
+        auto ext_it = gltf_node.extensions.find("EXT_mesh_gpu_instancing");
+        if (ext_it == gltf_node.extensions.end() || !ext_it->second.Has("attributes"))
+            continue;
+
+        const auto& Attribs = ext_it->second.Get("attributes");
+        for (const auto& Name : Attribs.Keys())
+            MarkAccessor(Attribs.Get(Name).GetNumberAsInt());
+    }
+
+    for (const auto& gltf_skin : gltf_model.skins)
+        MarkAccessor(gltf_skin.inverseBindMatrices);
+
+    for (const auto& gltf_anim : gltf_model.animations)
+    {
+        for (const auto& gltf_sampler : gltf_anim.samplers)
+        {
+            MarkAccessor(gltf_sampler.input);
+            MarkAccessor(gltf_sampler.output);
+        }
+    }
+
+    struct ByteRange
+    {
+        size_t Offset;
+        size_t Size;
+    };
+
+    struct PackedBuffer
+    {
+        // Merged source ranges sorted by offset and their offsets in the packed buffer
+        std::vector<ByteRange> Ranges;
+        std::vector<size_t>    PackedOffsets;
+
+        size_t GetPackedOffset(size_t Offset) const
+        {
+            auto it = std::upper_bound(Ranges.begin(), Ranges.end(), Offset,
+                                       [](size_t Off, const ByteRange& Range) { return Off < Range.Offset; });
+            VERIFY_EXPR(it != Ranges.begin());
+            const size_t Idx = static_cast<size_t>(it - Ranges.begin()) - 1;
+            return PackedOffsets[Idx] + (Offset - Ranges[Idx].Offset);
+        }
+    };
+    std::vector<PackedBuffer> PackedBuffers(gltf_model.buffers.size());
+
+    const auto AddRange = [&](int BufferId, size_t Offset, size_t Size, int ViewId) {
+        if (!IsDeferredBuffer(BufferId))
+            return;
+
+        const auto& gltf_buffer = gltf_model.buffers[BufferId];
+        if (Offset + Size > gltf_buffer.deferred_size)
+            LOG_ERROR_AND_THROW("Buffer view ", ViewId, " exceeds the size of buffer ", BufferId, " (", gltf_buffer.deferred_size, " bytes)");
+
+        // Keep the data alignment in the packed buffer
+        constexpr size_t RangeAlignment = 16;
+        PackedBuffers[BufferId].Ranges.push_back({AlignDown(Offset, RangeAlignment), Size + Offset % RangeAlignment});
+    };
+
+    for (size_t ViewId = 0; ViewId < gltf_model.bufferViews.size(); ++ViewId)
+    {
+        auto& gltf_view = gltf_model.bufferViews[ViewId];
+
+        auto ext_it = gltf_view.extensions.find("EXT_meshopt_compression");
+        if (ext_it != gltf_view.extensions.end())
+        {
+            const auto& Ext         = ext_it->second;
+            const int   SrcBufferId = Ext.Has("buffer") && Ext.Get("buffer").IsNumber() ? Ext.Get("buffer").GetNumberAsInt() : -1;
+            if (IsDeferredBuffer(SrcBufferId))
+            {
+                if (UsedViews[ViewId])
+                {
+                    const size_t SrcOffset = Ext.Has("byteOffset") && Ext.Get("byteOffset").IsNumber() ? static_cast<size_t>(Ext.Get("byteOffset").GetNumberAsInt()) : 0;
+                    const size_t SrcSize   = Ext.Has("byteLength") && Ext.Get("byteLength").IsNumber() ? static_cast<size_t>(Ext.Get("byteLength").GetNumberAsInt()) : 0;
+                    AddRange(SrcBufferId, SrcOffset, SrcSize, static_cast<int>(ViewId));
+                }
+                else
+                {
+                    // The compressed data of the unused view is not read, so the view must not be decoded
+                    gltf_view.extensions.erase(ext_it);
+                }
+            }
+        }
+
+        if (UsedViews[ViewId])
+            AddRange(gltf_view.buffer, gltf_view.byteOffset, gltf_view.byteLength, static_cast<int>(ViewId));
+    }
+
+    // Ranges that are closer than this are read at once
+    constexpr size_t MaxRangeGap = size_t{64} << 10;
+
+    Uint64                     NumBytesRead = 0;
+    std::vector<unsigned char> RangeData;
+    for (size_t BufferId = 0; BufferId < gltf_model.buffers.size(); ++BufferId)
+    {
+        auto& gltf_buffer = gltf_model.buffers[BufferId];
+        if (gltf_buffer.deferred_path.empty())
+            continue;
+
+        auto& Packed = PackedBuffers[BufferId];
+        auto& Ranges = Packed.Ranges;
+        std::sort(Ranges.begin(), Ranges.end(), [](const ByteRange& R0, const ByteRange& R1) { return R0.Offset < R1.Offset; });
+
+        size_t NumMergedRanges = 0;
+        for (const auto& Range : Ranges)
+        {
+            if (NumMergedRanges > 0 && Range.Offset <= Ranges[NumMergedRanges - 1].Offset + Ranges[NumMergedRanges - 1].Size + MaxRangeGap)
+            {
+                auto& Merged = Ranges[NumMergedRanges - 1];
+                Merged.Size  = std::max(Merged.Size, Range.Offset + Range.Size - Merged.Offset);
+            }
+            else
+            {
+                Ranges[NumMergedRanges++] = Range;
+            }
+        }
+        Ranges.resize(NumMergedRanges);
+
+        size_t PackedSize = 0;
+        Packed.PackedOffsets.resize(Ranges.size());
+        for (size_t i = 0; i < Ranges.size(); ++i)
+        {
+            Packed.PackedOffsets[i] = PackedSize;
+            PackedSize += AlignUp(Ranges[i].Size, size_t{16});
+        }
+
+        std::vector<unsigned char> Data(PackedSize);
+        for (size_t i = 0; i < Ranges.size(); ++i)
+        {
+            const auto& Range = Ranges[i];
+
+            std::string Error;
+            RangeData.clear();
+            if (!ReadFileRange(gltf_buffer.deferred_path.c_str(), Range.Offset, Range.Size, RangeData, Error) || RangeData.size() != Range.Size)
+                LOG_ERROR_AND_THROW("Failed to read ", Range.Size, " bytes at offset ", Range.Offset, " of file ", gltf_buffer.deferred_path, ": ", Error);
+
+            memcpy(&Data[Packed.PackedOffsets[i]], RangeData.data(), Range.Size);
+            NumBytesRead += Range.Size;
+        }
+
+        gltf_buffer.data = std::move(Data);
+        gltf_buffer.deferred_path.clear();
+        gltf_buffer.deferred_size = 0;
+    }
+
+    // Redirect the used views to the packed buffers
+    for (size_t ViewId = 0; ViewId < gltf_model.bufferViews.size(); ++ViewId)
+    {
+        if (!UsedViews[ViewId])
+            continue;
+
+        auto& gltf_view = gltf_model.bufferViews[ViewId];
+        if (gltf_view.buffer >= 0 && static_cast<size_t>(gltf_view.buffer) < PackedBuffers.size() && !PackedBuffers[gltf_view.buffer].Ranges.empty())
+            gltf_view.byteOffset = PackedBuffers[gltf_view.buffer].GetPackedOffset(gltf_view.byteOffset);
+
+        auto ext_it = gltf_view.extensions.find("EXT_meshopt_compression");
+        if (ext_it == gltf_view.extensions.end())
+            continue;
+
+        auto&     Ext         = ext_it->second;
+        const int SrcBufferId = Ext.Has("buffer") && Ext.Get("buffer").IsNumber() ? Ext.Get("buffer").GetNumberAsInt() : -1;
+        if (SrcBufferId >= 0 && static_cast<size_t>(SrcBufferId) < PackedBuffers.size() && !PackedBuffers[SrcBufferId].Ranges.empty())
+        {
+            const size_t SrcOffset = Ext.Has("byteOffset") && Ext.Get("byteOffset").IsNumber() ? static_cast<size_t>(Ext.Get("byteOffset").GetNumberAsInt()) : 0;
+
+            Ext.Get<tinygltf::Value::Object>()["byteOffset"] = tinygltf::Value{static_cast<int>(PackedBuffers[SrcBufferId].GetPackedOffset(SrcOffset))};
+        }
+    }
+
+    Stage.AddItems(0, NumBytesRead);
+}
+
+// Decodes the buffer views compressed with the EXT_meshopt_compression extension
+// into their fallback buffers. Buffer views are decoded in parallel when the thread pool is provided.
+void DecodeMeshoptBufferViews(tinygltf::Model& gltf_model, IThreadPool* pThreadPool, ModelLoadStats* pStats)
+{
+    struct CompressedView
+    {
+        int            ViewId;
+        const Uint8*   pSrc;
+        size_t         SrcSize;
+        Uint8*         pDst;
+        size_t         Count;
+        size_t         Stride;
+        std::string    Mode;
+        MESHOPT_FILTER Filter;
+    };
+    std::vector<CompressedView> Views;
+
+    for (size_t ViewId = 0; ViewId < gltf_model.bufferViews.size(); ++ViewId)
+    {
+        const auto& gltf_view = gltf_model.bufferViews[ViewId];
+
+        auto ext_it = gltf_view.extensions.find("EXT_meshopt_compression");
+        if (ext_it == gltf_view.extensions.end())
+            continue;
+
+        const auto& Ext = ext_it->second;
+
+        const auto GetInt = [&Ext](const char* Name, int DefaultValue) {
+            return Ext.Has(Name) && Ext.Get(Name).IsNumber() ? Ext.Get(Name).GetNumberAsInt() : DefaultValue;
+        };
+        const auto GetString = [&Ext](const char* Name, const char* DefaultValue) {
+            return Ext.Has(Name) && Ext.Get(Name).IsString() ? Ext.Get(Name).Get<std::string>() : std::string{DefaultValue};
+        };
+
+        CompressedView View;
+        View.ViewId = static_cast<int>(ViewId);
+        View.Count  = static_cast<size_t>(GetInt("count", 0));
+        View.Stride = static_cast<size_t>(GetInt("byteStride", 0));
+        View.Mode   = GetString("mode", "");
+
+        const auto Filter = GetString("filter", "NONE");
+        if (Filter == "NONE")
+            View.Filter = MESHOPT_FILTER_NONE;
+        else if (Filter == "OCTAHEDRAL")
+            View.Filter = MESHOPT_FILTER_OCTAHEDRAL;
+        else if (Filter == "QUATERNION")
+            View.Filter = MESHOPT_FILTER_QUATERNION;
+        else if (Filter == "EXPONENTIAL")
+            View.Filter = MESHOPT_FILTER_EXPONENTIAL;
+        else
+            LOG_ERROR_AND_THROW("Buffer view ", ViewId, " uses unknown meshopt filter '", Filter, "'");
+
+        const int    SrcBufferId = GetInt("buffer", -1);
+        const size_t SrcOffset   = static_cast<size_t>(GetInt("byteOffset", 0));
+        View.SrcSize             = static_cast<size_t>(GetInt("byteLength", 0));
+        if (SrcBufferId < 0 || static_cast<size_t>(SrcBufferId) >= gltf_model.buffers.size() ||
+            SrcOffset + View.SrcSize > gltf_model.buffers[SrcBufferId].data.size())
+            LOG_ERROR_AND_THROW("Buffer view ", ViewId, " references invalid meshopt compressed data");
+
+        if (gltf_view.buffer < 0 || static_cast<size_t>(gltf_view.buffer) >= gltf_model.buffers.size())
+            LOG_ERROR_AND_THROW("Buffer view ", ViewId, " references invalid buffer ", gltf_view.buffer);
+
+        auto& DstBuffer = gltf_model.buffers[gltf_view.buffer];
+        if (gltf_view.byteOffset + View.Count * View.Stride > DstBuffer.data.size())
+            LOG_ERROR_AND_THROW("Decompressed data of buffer view ", ViewId, " does not fit into the fallback buffer");
+
+        View.pSrc = gltf_model.buffers[SrcBufferId].data.data() + SrcOffset;
+        View.pDst = DstBuffer.data.data() + gltf_view.byteOffset;
+        Views.push_back(std::move(View));
+    }
+
+    if (Views.empty())
+        return;
+
+    ScopedLoadStage Stage{pStats, MODEL_LOAD_PROFILE_STAGE_GEOMETRY_DECOMPRESSION};
+
+    std::vector<Uint8> Decoded(Views.size());
+
+    const auto DecodeView = [&Views, &Decoded](size_t i) {
+        const auto& View = Views[i];
+
+        bool Res = false;
+        if (View.Mode == "ATTRIBUTES")
+        {
+            Res = DecodeMeshoptVertexBuffer(View.pDst, View.Count, View.Stride, View.pSrc, View.SrcSize) &&
+                ApplyMeshoptFilter(View.Filter, View.pDst, View.Count, View.Stride);
+        }
+        else if (View.Mode == "TRIANGLES")
+        {
+            Res = DecodeMeshoptIndexBuffer(View.pDst, View.Count, View.Stride, View.pSrc, View.SrcSize);
+        }
+        else if (View.Mode == "INDICES")
+        {
+            Res = DecodeMeshoptIndexSequence(View.pDst, View.Count, View.Stride, View.pSrc, View.SrcSize);
+        }
+        Decoded[i] = Res ? 1 : 0;
+    };
+
+    if (pThreadPool != nullptr && Views.size() > 1)
+    {
+        std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+        for (size_t i = 0; i < Views.size(); ++i)
+        {
+            Tasks.emplace_back(EnqueueAsyncWork(pThreadPool, [&DecodeView, i](Uint32 ThreadId) {
+                DecodeView(i);
+            }));
+        }
+        for (auto& pTask : Tasks)
+            pTask->WaitForCompletion();
+    }
+    else
+    {
+        for (size_t i = 0; i < Views.size(); ++i)
+            DecodeView(i);
+    }
+
+    for (size_t i = 0; i < Views.size(); ++i)
+    {
+        if (!Decoded[i])
+            LOG_ERROR_AND_THROW("Failed to decode meshopt compressed buffer view ", Views[i].ViewId);
+        Stage.AddItems(1, Views[i].Count * Views[i].Stride);
+    }
+}
+
+#if defined(TINYGLTF_ENABLE_DRACO)
+
+// Decodes the primitives compressed with the KHR_draco_mesh_compression extension.
+// Primitives are decoded in parallel when the thread pool is provided. The decoded indices and
+// attributes are then placed into new buffers, and the primitive accessors are redirected to them,
+// so that the model builder processes the primitives as if they were never compressed.
+// If pUsedMeshes is not null, only the meshes it marks are decoded.
+void DecodeDracoPrimitives(tinygltf::Model& gltf_model, const std::vector<bool>* pUsedMeshes, IThreadPool* pThreadPool, ModelLoadStats* pStats)
+{
+    struct CompressedPrimitive
+    {
+        int ViewId    = -1;
+        int IndicesId = -1;
+
+        // Accessor id and Draco attribute unique id
+        std::vector<std::pair<int, int>> Attributes;
+
+        std::vector<Uint8>              Indices;
+        std::vector<std::vector<Uint8>> AttribData;
+        Uint32                          NumFaces  = 0;
+        Uint32                          NumPoints = 0;
+        bool                            Decoded   = false;
+    };
+    std::vector<CompressedPrimitive> Primitives;
+
+    // Primitives that share the compressed buffer view also share the accessors
+    std::unordered_set<int> CompressedViews;
+    for (size_t mesh_idx = 0; mesh_idx < gltf_model.meshes.size(); ++mesh_idx)
+    {
+        if (pUsedMeshes != nullptr && !(*pUsedMeshes)[mesh_idx])
+            continue;
+
+        const auto& gltf_mesh = gltf_model.meshes[mesh_idx];
+        for (const auto& gltf_primitive : gltf_mesh.primitives)
+        {
+            auto ext_it = gltf_primitive.extensions.find("KHR_draco_mesh_compression");
+            if (ext_it == gltf_primitive.extensions.end())
+                continue;
+
+            const auto& Ext = ext_it->second;
+            if (!Ext.Has("bufferView") || !Ext.Get("bufferView").IsInt() || !Ext.Has("attributes") || !Ext.Get("attributes").IsObject())
+                LOG_ERROR_AND_THROW("Mesh '", gltf_mesh.name, "' contains invalid KHR_draco_mesh_compression extension");
+
+            CompressedPrimitive Prim;
+            Prim.ViewId    = Ext.Get("bufferView").Get<int>();
+            Prim.IndicesId = gltf_primitive.indices;
+            if (Prim.ViewId < 0 || static_cast<size_t>(Prim.ViewId) >= gltf_model.bufferViews.size())
+                LOG_ERROR_AND_THROW("Mesh '", gltf_mesh.name, "' references invalid Draco buffer view ", Prim.ViewId);
+            if (!CompressedViews.insert(Prim.ViewId).second)
+                continue;
+
+            const auto& gltf_view = gltf_model.bufferViews[Prim.ViewId];
+            if (gltf_view.buffer < 0 || static_cast<size_t>(gltf_view.buffer) >= gltf_model.buffers.size() ||
+                gltf_view.byteOffset + gltf_view.byteLength > gltf_model.buffers[gltf_view.buffer].data.size())
+                LOG_ERROR_AND_THROW("Draco buffer view ", Prim.ViewId, " references invalid data");
+            if (Prim.IndicesId >= static_cast<int>(gltf_model.accessors.size()))
+                LOG_ERROR_AND_THROW("Mesh '", gltf_mesh.name, "' references invalid index accessor ", Prim.IndicesId);
+
+            for (const auto& Attrib : Ext.Get("attributes").Get<tinygltf::Value::Object>())
+            {
+                auto attrib_it = gltf_primitive.attributes.find(Attrib.first);
+                if (!Attrib.second.IsInt() || attrib_it == gltf_primitive.attributes.end() ||
+                    attrib_it->second < 0 || static_cast<size_t>(attrib_it->second) >= gltf_model.accessors.size())
+                    LOG_ERROR_AND_THROW("Mesh '", gltf_mesh.name, "' contains invalid Draco attribute ", Attrib.first);
+
+                Prim.Attributes.emplace_back(attrib_it->second, Attrib.second.Get<int>());
+            }
+            Primitives.push_back(std::move(Prim));
+        }
+    }
+
+    if (Primitives.empty())
+        return;
+
+    ScopedLoadStage Stage{pStats, MODEL_LOAD_PROFILE_STAGE_GEOMETRY_DECOMPRESSION};
+
+    // The model is only read while the primitives are decoded
+    const auto DecodePrimitive = [&gltf_model](CompressedPrimitive& Prim) {
+        const auto& gltf_view = gltf_model.bufferViews[Prim.ViewId];
+
+        draco::DecoderBuffer DecoderBuffer;
+        DecoderBuffer.Init(reinterpret_cast<const char*>(gltf_model.buffers[gltf_view.buffer].data.data() + gltf_view.byteOffset), gltf_view.byteLength);
+
+        draco::Decoder Decoder;
+        auto           DecodeResult = Decoder.DecodeMeshFromBuffer(&DecoderBuffer);
+        if (!DecodeResult.ok())
+            return;
+
+        const auto& pMesh = DecodeResult.value();
+        Prim.NumFaces     = pMesh->num_faces();
+        Prim.NumPoints    = pMesh->num_points();
+
+        if (Prim.IndicesId >= 0 && Prim.NumFaces > 0)
+        {
+            const size_t IndexSize = tinygltf::GetComponentSizeInBytes(gltf_model.accessors[Prim.IndicesId].componentType);
+            if (IndexSize != 1 && IndexSize != 2 && IndexSize != 4)
+                return;
+            Prim.Indices.resize(size_t{Prim.NumFaces} * 3 * IndexSize);
+            tinygltf::DecodeIndexBuffer(pMesh.get(), IndexSize, Prim.Indices);
+        }
+
+        Prim.AttribData.resize(Prim.Attributes.size());
+        for (size_t i = 0; i < Prim.Attributes.size(); ++i)
+        {
+            const auto& Accessor   = gltf_model.accessors[Prim.Attributes[i].first];
+            const auto* pAttribute = pMesh->GetAttributeByUniqueId(Prim.Attributes[i].second);
+            if (pAttribute == nullptr || pAttribute->num_components() != tinygltf::GetNumComponentsInType(Accessor.type))
+                return;
+
+            auto& Data = Prim.AttribData[i];
+            Data.resize(size_t{Prim.NumPoints} * pAttribute->num_components() * tinygltf::GetComponentSizeInBytes(Accessor.componentType));
+            if (!tinygltf::GetAttributeForAllPoints(Accessor.componentType, pMesh.get(), pAttribute, Data))
+                return;
+        }
+
+        Prim.Decoded = true;
+    };
+
+    if (pThreadPool != nullptr && Primitives.size() > 1)
+    {
+        std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+        for (auto& Prim : Primitives)
+        {
+            Tasks.emplace_back(EnqueueAsyncWork(pThreadPool, [&DecodePrimitive, &Prim](Uint32 ThreadId) {
+                DecodePrimitive(Prim);
+            }));
+        }
+        for (auto& pTask : Tasks)
+            pTask->WaitForCompletion();
+    }
+    else
+    {
+        for (auto& Prim : Primitives)
+            DecodePrimitive(Prim);
+    }
+
+    // Redirects the accessor to the new tightly packed buffer
+    const auto AddDecodedData = [&gltf_model](std::vector<Uint8>&& Data, int AccessorId, Uint32 Count) {
+        tinygltf::BufferView gltf_view;
+        gltf_view.buffer     = static_cast<int>(gltf_model.buffers.size());
+        gltf_view.byteLength = Data.size();
+
+        gltf_model.buffers.emplace_back();
+        gltf_model.buffers.back().data = std::move(Data);
+        gltf_model.bufferViews.push_back(std::move(gltf_view));
+
+        auto& Accessor      = gltf_model.accessors[AccessorId];
+        Accessor.bufferView = static_cast<int>(gltf_model.bufferViews.size() - 1);
+        Accessor.byteOffset = 0;
+        Accessor.count      = Count;
+    };
+
+    for (auto& Prim : Primitives)
+    {
+        if (!Prim.Decoded)
+            LOG_ERROR_AND_THROW("Failed to decode Draco compressed buffer view ", Prim.ViewId);
+
+        size_t DecodedSize = Prim.Indices.size();
+        if (Prim.IndicesId >= 0)
+            AddDecodedData(std::move(Prim.Indices), Prim.IndicesId, Prim.NumFaces * 3);
+        for (size_t i = 0; i < Prim.Attributes.size(); ++i)
+        {
+            DecodedSize += Prim.AttribData[i].size();
+            AddDecodedData(std::move(Prim.AttribData[i]), Prim.Attributes[i].first, Prim.NumPoints);
+        }
+        Stage.AddItems(1, DecodedSize);
+    }
+}
+
+#else
+
+void DecodeDracoPrimitives(tinygltf::Model& gltf_model, const std::vector<bool>* pUsedMeshes, IThreadPool* /*pThreadPool*/, ModelLoadStats* /*pStats*/)
+{
+    for (size_t mesh_idx = 0; mesh_idx < gltf_model.meshes.size(); ++mesh_idx)
+    {
+        if (pUsedMeshes != nullptr && !(*pUsedMeshes)[mesh_idx])
+            continue;
+
+        const auto& gltf_mesh = gltf_model.meshes[mesh_idx];
+        for (const auto& gltf_primitive : gltf_mesh.primitives)
+        {
+            if (gltf_primitive.extensions.find("KHR_draco_mesh_compression") != gltf_primitive.extensions.end())
+                LOG_ERROR_AND_THROW("Mesh '", gltf_mesh.name, "' is compressed with Draco, but Draco support is disabled. Enable it with the DILIGENT_ENABLE_DRACO CMake option.");
+        }
+    }
+}
+
+#endif
+
+// Reads the names of the material variants and the variant mappings of the loaded primitives,
+// see KHR_materials_variants.
+void LoadMaterialVariants(const tinygltf::Model&       gltf_model,
+                          const ModelBuilder&          Builder,
+                          const std::vector<Material>& Materials,
+                          std::vector<Mesh>&           Meshes,
+                          std::vector<std::string>&    MaterialVariants)
+{
+    auto ext_it = gltf_model.extensions.find("KHR_materials_variants");
+    if (ext_it == gltf_model.extensions.end() || !ext_it->second.Has("variants"))
+        return;
+
+    const auto& Variants = ext_it->second.Get("variants");
+    MaterialVariants.resize(Variants.ArrayLen());
+    for (size_t i = 0; i < MaterialVariants.size(); ++i)
+    {
+        const auto& Variant = Variants.Get(static_cast<int>(i));
+        if (Variant.Has("name") && Variant.Get("name").IsString())
+            MaterialVariants[i] = Variant.Get("name").Get<std::string>();
+    }
+
+    for (size_t gltf_mesh_idx = 0; gltf_mesh_idx < gltf_model.meshes.size(); ++gltf_mesh_idx)
+    {
+        const auto MeshId = Builder.GetLoadedMeshIndex(static_cast<int>(gltf_mesh_idx));
+        if (MeshId < 0)
+            continue;
+
+        const auto& gltf_mesh  = gltf_model.meshes[gltf_mesh_idx];
+        auto&       Primitives = Meshes[MeshId].Primitives;
+        VERIFY_EXPR(Primitives.size() == gltf_mesh.primitives.size());
+        for (size_t prim_idx = 0; prim_idx < std::min(Primitives.size(), gltf_mesh.primitives.size()); ++prim_idx)
+        {
+            auto& Prim = Primitives[prim_idx];
+            ProcessMaterialVariantMappings(gltf_mesh.primitives[prim_idx], [&](int MaterialId, int VariantId) {
+                if (MaterialId < 0 || static_cast<size_t>(MaterialId) >= Materials.size() ||
+                    VariantId < 0 || static_cast<size_t>(VariantId) >= MaterialVariants.size())
+                {
+                    LOG_WARNING_MESSAGE("Mesh '", gltf_mesh.name, "' contains invalid KHR_materials_variants mapping: material ", MaterialId, ", variant ", VariantId);
+                    return;
+                }
+
+                if (Prim.VariantMaterialIds.empty())
+                    Prim.VariantMaterialIds.assign(MaterialVariants.size(), Prim.DefaultMaterialId);
+                Prim.VariantMaterialIds[VariantId] = static_cast<Uint32>(MaterialId);
+            });
+        }
+    }
+}
+
+} // namespace
+
+const char* ModelLoadStats::GetStageName(MODEL_LOAD_PROFILE_STAGE Stage)
+{
+    static_assert(MODEL_LOAD_PROFILE_STAGE_COUNT == 10, "Please handle the new stage below");
+    switch (Stage)
+    {
+        // clang-format off
+        case MODEL_LOAD_PROFILE_STAGE_PARSE:                  return "Parse";
+        case MODEL_LOAD_PROFILE_STAGE_GEOMETRY_DECOMPRESSION: return "Geometry decompression";
+        case MODEL_LOAD_PROFILE_STAGE_VERTEX_DATA:            return "Vertex data";
+        case MODEL_LOAD_PROFILE_STAGE_INDEX_DATA:             return "Index data";
+        case MODEL_LOAD_PROFILE_STAGE_ANIMATIONS:             return "Animations";
+        case MODEL_LOAD_PROFILE_STAGE_GEOMETRY_PROCESSING:    return "Geometry processing";
+        case MODEL_LOAD_PROFILE_STAGE_INIT_BUFFERS:           return "Init buffers";
+        case MODEL_LOAD_PROFILE_STAGE_IMAGE_DECODE:           return "Image decode";
+        case MODEL_LOAD_PROFILE_STAGE_TEXTURE_PREPARE:        return "Texture prepare";
+        case MODEL_LOAD_PROFILE_STAGE_TEXTURE_COMMIT:         return "Texture commit";
+        // clang-format on
+        default:
+            UNEXPECTED("Unexpected model load profile stage");
+            return "Unknown";
+    }
+}
+
+void Model::LoadFromFile(IRenderDevice*         pDevice,
+                         IDeviceContext*        pContext,
+                         const ModelCreateInfo& CI)
+{
+    try
+    {
+        // When thread pool is used, images are decoded in parallel by PrepareTextures().
+        // When the model is baked, all texture data must be prepared by PrepareTextures().
+        BeginLoading(CI, CI.pThreadPool != nullptr || CI.BakedFileName != nullptr);
+        LoadGeometry(pDevice, CI);
+        PrepareTextures(CI.pThreadPool);
+        if (!m_pLoadingState->BakedFileName.empty())
+            WriteBakedModel();
+        CommitTextures(pDevice, static_cast<Uint32>(m_pLoadingState->Images.size()));
+        EndLoading();
+
+        if (pContext != nullptr)
+        {
+            SetLoadStage(CI.pLoadProgress, MODEL_LOAD_STAGE_GPU_UPLOAD, 1);
+            PrepareGPUResources(pDevice, pContext);
+        }
+    }
+    catch (...)
+    {
+        EndLoading();
+        if (CI.pLoadProgress != nullptr)
+            CI.pLoadProgress->Stage.store(CI.pLoadProgress->CancelRequested.load() ? MODEL_LOAD_STAGE_CANCELLED : MODEL_LOAD_STAGE_FAILED);
+        throw;
+    }
+
+    SetLoadStage(CI.pLoadProgress, MODEL_LOAD_STAGE_COMPLETE, 0);
+}
+
+void Model::Bake(const ModelCreateInfo& CI)
+{
+    DEV_CHECK_ERR(CI.BakedFileName != nullptr && *CI.BakedFileName != '\0', "Baked file name must not be empty");
+    if (CI.pCacheInfo != nullptr && CI.pCacheInfo->pResourceMgr != nullptr)
+        LOG_ERROR_AND_THROW("Models can't be baked with the resource manager");
+
+    Model M{CI};
+    try
+    {
+        // All texture data must be prepared by PrepareTextures() to be written to the file
+        M.BeginLoading(CI, /*DeferImageDecoding = */ true);
+        if (M.m_pLoadingState->BakedFileName.empty())
+            LOG_ERROR_AND_THROW("Model ", CI.FileName, " is already baked");
+
+        M.LoadGeometry(nullptr, CI);
+        M.PrepareTextures(CI.pThreadPool);
+        M.WriteBakedModel();
+        M.EndLoading();
+    }
+    catch (...)
+    {
+        M.EndLoading();
+        if (CI.pLoadProgress != nullptr)
+            CI.pLoadProgress->Stage.store(CI.pLoadProgress->CancelRequested.load() ? MODEL_LOAD_STAGE_CANCELLED : MODEL_LOAD_STAGE_FAILED);
+        throw;
+    }
+
+    SetLoadStage(CI.pLoadProgress, MODEL_LOAD_STAGE_COMPLETE, 0);
+}
+
+void Model::BeginLoading(const ModelCreateInfo& CI, bool DeferImageDecoding)
+{
+    VERIFY(!m_pLoadingState, "The model is already being loaded");
+
+    if (CI.FileName == nullptr || *CI.FileName == 0)
+        LOG_ERROR_AND_THROW("File path must not be empty");
+
+    auto* const pTextureCache = CI.pTextureCache;
+    auto* const pResourceMgr  = CI.pCacheInfo != nullptr ? CI.pCacheInfo->pResourceMgr : nullptr;
+    if (CI.pTextureCache != nullptr && pResourceMgr != nullptr)
+        LOG_WARNING_MESSAGE("Texture cache is ignored when resource manager is used");
+
+    m_pLoadingState = std::make_unique<LoadingState>(pTextureCache, pResourceMgr);
+    auto& State     = *m_pLoadingState;
+
+    NumStreamedTextureMips = pResourceMgr != nullptr ? CI.NumStreamedTextureMips : 0;
+    TextureCompressMode    = CI.TextureCompressMode;
+    MaxTextureDimension    = CI.MaxTextureDimension;
+
+    State.pProgress = CI.pLoadProgress;
+    State.pStats    = CI.pLoadStats;
+    CheckLoadCancelled(State.pProgress);
+    SetLoadStage(State.pProgress, MODEL_LOAD_STAGE_PARSE, 1);
+
+    auto& LoaderData = State.LoaderData;
+
+    const std::string filename{CI.FileName};
+    if (filename.find_last_of("/\\") != std::string::npos)
+        LoaderData.BaseDir = filename.substr(0, filename.find_last_of("/\\"));
+    LoaderData.BaseDir += '/';
+
+    LoaderData.FileExists    = CI.FileExistsCallback;
+    LoaderData.ReadWholeFile = CI.ReadWholeFileCallback;
+    LoaderData.ReadFileRange = CI.ReadFileRangeCallback;
+
+    LoaderData.MaxTextureDimension = CI.MaxTextureDimension;
+    // When only a subset of textures is loaded, images are decoded after it is known which of them are used
+    LoaderData.DeferDecoding = DeferImageDecoding || CI.LoadSceneSubset || CI.TextureAttributeMask != ~0u;
+
+    const auto ExtPos = filename.rfind('.');
+    if (ExtPos != std::string::npos && filename.compare(ExtPos + 1, std::string::npos, BakedModelFileExtension) == 0)
+    {
+        ScopedLoadStage Stage{State.pStats, MODEL_LOAD_PROFILE_STAGE_PARSE};
+
+        std::string error;
+        if (!Callbacks::ReadWholeFile(&State.BakedData, &error, filename, &LoaderData))
+            LOG_ERROR_AND_THROW("Failed to read baked model file ", filename, ": ", error);
+        if (State.BakedData.empty())
+            LOG_ERROR_AND_THROW("Baked model file ", filename, " is empty");
+        Stage.AddItems(1, State.BakedData.size());
+        if (CI.BakedFileName != nullptr)
+            LOG_WARNING_MESSAGE("Model ", filename, " is already baked. BakedFileName is ignored.");
+        return;
+    }
+
+    if (CI.BakedFileName != nullptr)
+        State.BakedFileName = CI.BakedFileName;
+
+    tinygltf::TinyGLTF gltf_context;
+    gltf_context.SetImageLoader(Callbacks::LoadImageData, &LoaderData);
+    tinygltf::FsCallbacks fsCallbacks = {};
+    fsCallbacks.ExpandFilePath        = tinygltf::ExpandFilePath;
+    fsCallbacks.FileExists            = Callbacks::FileExists;
+    fsCallbacks.ReadWholeFile         = Callbacks::ReadWholeFile;
+    fsCallbacks.WriteWholeFile        = tinygltf::WriteWholeFile;
+    fsCallbacks.user_data             = &LoaderData;
+    if (CI.ReadFileRangeCallback)
+        fsCallbacks.ReadFileRange = Callbacks::ReadFileRange;
+    gltf_context.SetFsCallbacks(fsCallbacks);
+
+    bool   binary = false;
+    size_t extpos = filename.rfind('.', filename.length());
+    if (extpos != std::string::npos)
+    {
+        binary = (filename.substr(extpos + 1, filename.length() - extpos) == "glb");
+    }
+
+    std::string error;
+    std::string warning;
+
+    auto& gltf_model = State.gltf_model;
+
+    {
+        ScopedLoadStage Stage{State.pStats, MODEL_LOAD_PROFILE_STAGE_PARSE};
+
+        bool fileLoaded = false;
+        if (binary)
+            fileLoaded = gltf_context.LoadBinaryFromFile(&gltf_model, &error, &warning, filename.c_str());
+        else
+            fileLoaded = gltf_context.LoadASCIIFromFile(&gltf_model, &error, &warning, filename.c_str());
+        if (!fileLoaded)
+        {
+            LOG_ERROR_AND_THROW("Failed to load gltf file ", filename, ": ", error);
+        }
+
+        Uint64 NumBytes = 0;
+        for (const auto& gltf_buffer : gltf_model.buffers)
+            NumBytes += gltf_buffer.data.size();
+        Stage.AddItems(1, NumBytes);
+    }
+    if (!warning.empty())
+    {
+        LOG_WARNING_MESSAGE("Loaded gltf file ", filename, " with the following warning:", warning);
+    }
+}
+
+void Model::LoadGeometry(IRenderDevice* pDevice, const ModelCreateInfo& CI)
+{
+    VERIFY_EXPR(m_pLoadingState);
+    auto&       State      = *m_pLoadingState;
+    const auto& gltf_model = State.gltf_model;
+
+    CheckLoadCancelled(State.pProgress);
+    SetLoadStage(State.pProgress, MODEL_LOAD_STAGE_VERTEX_CONVERSION, 1);
+
+    if (!State.BakedData.empty())
+    {
+        LoadBakedGeometry(pDevice, CI);
+        if (CI.AnimationSampleRate > 0)
+            BakeAnimations(CI.AnimationSampleRate);
+        UpdateNameIndices();
+        if (State.pProgress != nullptr)
+            State.pProgress->NumItemsProcessed.store(1);
+        return;
+    }
+
+    std::vector<int> NodeIds;
+    if (!gltf_model.scenes.empty())
+    {
+        auto SceneId = CI.SceneId;
+        if (SceneId >= static_cast<int>(gltf_model.scenes.size()))
+        {
+            LOG_ERROR_MESSAGE("Scene id ", SceneId, " is invalid: GLTF model only contains ", gltf_model.scenes.size(), " scenes. Loading default scene.");
+            SceneId = -1;
+        }
+        if (SceneId < 0)
+        {
+            SceneId = gltf_model.defaultScene >= 0 ? gltf_model.defaultScene : 0;
+        }
+        NodeIds = gltf_model.scenes[SceneId].nodes;
+    }
+    else
+    {
+        NodeIds.resize(gltf_model.nodes.size());
+        // Load all nodes if there is no scene
+        for (int node_idx = 0; node_idx < static_cast<int>(gltf_model.nodes.size()); ++node_idx)
+            NodeIds[node_idx] = node_idx;
+    }
+
+    std::vector<bool> UsedMeshes;
+    std::vector<bool> UsedMaterials;
+    if (CI.LoadSceneSubset)
+        FindSceneMeshesAndMaterials(gltf_model, NodeIds, UsedMeshes, UsedMaterials);
+
+    // Load materials first as the PrepareTextures() function needs them to determine the alpha-cut value.
+    LoadMaterials(gltf_model, CI.MaterialLoadCallback, CI.LoadSceneSubset ? &UsedMaterials : nullptr);
+    LoadTextureSamplers(pDevice, State.LoaderData.pTextureCache, State.LoaderData.pResourceMgr, gltf_model);
+
+    // Read the ranges of the deferred external buffers that are referenced by the loaded data
+    ReadDeferredBuffers(State.gltf_model, CI.LoadSceneSubset ? &UsedMeshes : nullptr, State.LoaderData.ReadFileRange, State.pStats);
+
+    // Decode compressed geometry before the builder reads it
+    DecodeMeshoptBufferViews(State.gltf_model, CI.pThreadPool, State.pStats);
+    DecodeDracoPrimitives(State.gltf_model, CI.LoadSceneSubset ? &UsedMeshes : nullptr, CI.pThreadPool, State.pStats);
+
+    ModelBuilder Builder{CI, *this};
+    Builder.Execute(TinyGltfModelWrapper{gltf_model}, NodeIds, pDevice, nullptr);
+    LoadMaterialVariants(gltf_model, Builder, Materials, Meshes, MaterialVariants);
+    if (!State.BakedFileName.empty())
+        Builder.ReleaseConvertedData(State.IndexData, State.VertexData, State.MeshletData);
+
+    // All vertex and index data has been converted, and images stored in buffer views
+    // have been extracted by the image loader, so the source buffers are no longer needed.
+    for (auto& gltf_buffer : State.gltf_model.buffers)
+        std::vector<unsigned char>{}.swap(gltf_buffer.data);
+
+    Extensions = gltf_model.extensionsUsed;
+
+    // Initialize per-texture data before any texture is prepared so that the arrays are
+    // never resized while CommitTextures() may be reading them from another thread.
+    const auto NumTextures = gltf_model.textures.size();
+    State.Images.resize(NumTextures);
+    State.CacheIds.resize(NumTextures);
+    State.InitData.resize(NumTextures);
+    State.DecodedImages.resize(gltf_model.images.size());
+    State.SamplerIds.resize(NumTextures);
+    for (size_t i = 0; i < NumTextures; ++i)
+        State.SamplerIds[i] = gltf_model.textures[i].sampler;
+
+    // Textures are only referenced by the material slots that are in the texture attribute layout
+    const bool SkipUnusedTextures = CI.LoadSceneSubset || CI.TextureAttributeMask != ~0u;
+    if (SkipUnusedTextures)
+    {
+        // Skip the textures that are not used by the loaded materials
+        State.SkippedTextures.assign(NumTextures, true);
+        for (size_t mat_idx = 0; mat_idx < Materials.size(); ++mat_idx)
+        {
+            if (!UsedMaterials.empty() && !UsedMaterials[mat_idx])
+                continue;
+
+            for (const auto TexId : Materials[mat_idx].TextureIds)
+            {
+                if (TexId >= 0 && static_cast<size_t>(TexId) < NumTextures)
+                    State.SkippedTextures[TexId] = false;
+            }
+        }
+    }
+
+    State.ImageLastTextures.assign(gltf_model.images.size(), ~Uint32{0});
+    for (Uint32 i = 0; i < NumTextures; ++i)
+    {
+        const auto ImageIdx = FindGltfTextureSource(gltf_model, i);
+        if (ImageIdx >= 0 && !State.IsTextureSkipped(i))
+            State.ImageLastTextures[ImageIdx] = i;
+    }
+
+    if (SkipUnusedTextures)
+    {
+        // Images that are only referenced by skipped textures are never decoded
+        for (size_t i = 0; i < gltf_model.images.size(); ++i)
+        {
+            if (State.ImageLastTextures[i] == ~Uint32{0})
+                std::vector<unsigned char>{}.swap(State.gltf_model.images[i].image);
+        }
+    }
+
+    if (CI.AnimationSampleRate > 0)
+    {
+        // Original key frames are written to the baked model file
+        BakeAnimations(CI.AnimationSampleRate, State.BakedFileName.empty());
+    }
+
+    UpdateNameIndices();
+
+    if (State.pProgress != nullptr)
+        State.pProgress->NumItemsProcessed.store(1);
+}
+
+void Model::PrepareTexture(Uint32 TextureIndex, bool PrepareInitData)
+{
+    auto&       State      = *m_pLoadingState;
+    const auto& gltf_model = State.gltf_model;
+    const auto  ImageIdx   = GetGltfTextureSource(gltf_model, TextureIndex);
+
+    auto gltf_image = &gltf_model.images[ImageIdx];
+
+    State.CacheIds[TextureIndex] = !gltf_image->uri.empty() ? FileSystem::SimplifyPath((State.LoaderData.BaseDir + gltf_image->uri).c_str()) : "";
+    if (!State.DecodedImages[ImageIdx].image.empty())
+        gltf_image = &State.DecodedImages[ImageIdx];
+
+    auto& Image         = State.Images[TextureIndex];
+    Image.Width         = gltf_image->width;
+    Image.Height        = gltf_image->height;
+    Image.NumComponents = gltf_image->component;
+    Image.ComponentSize = gltf_image->bits / 8;
+    Image.FileFormat    = (gltf_image->width < 0 && gltf_image->height < 0) ? static_cast<IMAGE_FILE_FORMAT>(gltf_image->pixel_type) : IMAGE_FILE_FORMAT_UNKNOWN;
+    Image.pData         = gltf_image->image.data();
+    Image.DataSize      = gltf_image->image.size();
+
+    if (!PrepareInitData || Image.Width <= 0 || Image.Height <= 0 || Image.DataSize == 0)
+        return;
+
+    // Process alpha cutoff and generate mip levels
+    const float AlphaCutoff      = GetTextureAlphaCutoffValue(static_cast<int>(TextureIndex));
+    auto* const pResourceMgr     = State.LoaderData.pResourceMgr;
+    const auto  CompressedFormat = GetGLTFTextureCompressedFormat(Image, TextureCompressMode, pResourceMgr, NumStreamedTextureMips > 0);
+    if (pResourceMgr != nullptr)
+    {
+        const auto TexFormat = CompressedFormat != TEX_FORMAT_UNKNOWN ? CompressedFormat : GetModelImageDataTextureFormat(Image);
+        const auto MipLevels = pResourceMgr->GetAtlasDesc(TexFormat).MipLevels;
+        const auto Alignment = pResourceMgr->GetAllocationAlignment(TexFormat, Image.Width, Image.Height);
+
+        State.InitData[TextureIndex] = PrepareGLTFTextureInitData(Image, AlphaCutoff, MipLevels, Alignment, CompressedFormat);
+    }
+    else
+    {
+        // Mip levels of compressed textures can't be generated on the GPU
+        const auto MipLevels = CompressedFormat != TEX_FORMAT_UNKNOWN ? ComputeMipLevelsCount(Image.Width, Image.Height) : 1;
+
+        State.InitData[TextureIndex] = PrepareGLTFTextureInitData(Image, AlphaCutoff, MipLevels, -1, CompressedFormat);
+    }
+}
+
+void Model::PrepareTextures(IThreadPool* pThreadPool)
+{
+    VERIFY_EXPR(m_pLoadingState);
+    auto&       State      = *m_pLoadingState;
+    const auto& gltf_model = State.gltf_model;
+
+    CheckLoadCancelled(State.pProgress);
+
+    if (!State.BakedData.empty())
+    {
+        LoadBakedTextures();
+        return;
+    }
+
+    SetLoadStage(State.pProgress, MODEL_LOAD_STAGE_TEXTURE_DECODE, static_cast<Uint32>(gltf_model.textures.size()));
+
+    // Returns true if the image has been deferred for decoding by the tinygltf image loader callback.
+    const auto IsImageEncoded = [](const tinygltf::Image& gltf_image) {
+        const auto FileFormat = static_cast<IMAGE_FILE_FORMAT>(gltf_image.pixel_type);
+        return (gltf_image.width < 0 && gltf_image.height < 0 && !gltf_image.image.empty() &&
+                FileFormat != IMAGE_FILE_FORMAT_DDS && FileFormat != IMAGE_FILE_FORMAT_KTX);
+    };
+
+    const auto DecodeImage = [this, &State, &gltf_model](size_t ImageIdx) {
+        const auto& gltf_image   = gltf_model.images[ImageIdx];
+        auto&       DecodedImage = State.DecodedImages[ImageIdx];
+        DecodedImage.name        = gltf_image.name;
+
+        std::string Error;
+        if (!DecodeGltfImage(gltf_image.image.data(), gltf_image.image.size(), static_cast<IMAGE_FILE_FORMAT>(gltf_image.pixel_type),
+                             static_cast<int>(ImageIdx), 0, 0, MaxTextureDimension, DecodedImage, &Error))
+        {
+            LOG_ERROR_MESSAGE(Error);
+            DecodedImage.image.clear();
+        }
+
+        // Encoded data is not needed anymore
+        std::vector<unsigned char>{}.swap(State.gltf_model.images[ImageIdx].image);
+    };
+
+    const auto NumTextures = static_cast<Uint32>(gltf_model.textures.size());
+    if (pThreadPool != nullptr)
+    {
+        {
+            ScopedLoadStage Stage{State.pStats, MODEL_LOAD_PROFILE_STAGE_IMAGE_DECODE};
+
+            // Decode all images in parallel
+            std::vector<size_t>                    ImageIds;
+            std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+            for (size_t i = 0; i < gltf_model.images.size(); ++i)
+            {
+                if (!IsImageEncoded(gltf_model.images[i]))
+                {
+                    // The image is either already decoded, found in the cache, or is loaded by the texture loader
+                    continue;
+                }
+
+                ImageIds.push_back(i);
+                Tasks.emplace_back(EnqueueAsyncWork(pThreadPool, [&DecodeImage, &State, i](Uint32 ThreadId) {
+                    if (State.pProgress == nullptr || !State.pProgress->CancelRequested.load())
+                        DecodeImage(i);
+                }));
+            }
+
+            for (auto& pTask : Tasks)
+                pTask->WaitForCompletion();
+
+            // Stats are only updated by this thread after all tasks have finished
+            for (size_t ImageIdx : ImageIds)
+                Stage.AddItems(1, State.DecodedImages[ImageIdx].image.size());
+        }
+        CheckLoadCancelled(State.pProgress);
+
+        {
+            ScopedLoadStage Stage{State.pStats, MODEL_LOAD_PROFILE_STAGE_TEXTURE_PREPARE};
+
+            // Process alpha cutoff and generate mip levels in parallel
+            std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+            for (Uint32 i = 0; i < NumTextures; ++i)
+            {
+                Tasks.emplace_back(EnqueueAsyncWork(pThreadPool, [this, &State, i](Uint32 ThreadId) {
+                    if ((State.pProgress == nullptr || !State.pProgress->CancelRequested.load()) && !State.IsTextureSkipped(i))
+                        PrepareTexture(i, true);
+                    if (State.pProgress != nullptr)
+                        State.pProgress->NumItemsProcessed.fetch_add(1);
+                }));
+            }
+
+            for (auto& pTask : Tasks)
+                pTask->WaitForCompletion();
+
+            for (const auto& Image : State.Images)
+                Stage.AddItems(1, Image.DataSize);
+        }
+        CheckLoadCancelled(State.pProgress);
+
+        State.NumPreparedTextures.store(NumTextures);
+    }
+    else
+    {
+        for (Uint32 i = 0; i < NumTextures; ++i)
+        {
+            CheckLoadCancelled(State.pProgress);
+
+            if (State.IsTextureSkipped(i))
+            {
+                if (State.pProgress != nullptr)
+                    State.pProgress->NumItemsProcessed.fetch_add(1);
+                State.NumPreparedTextures.store(i + 1);
+                continue;
+            }
+
+            const auto ImageIdx = GetGltfTextureSource(gltf_model, i);
+            if (IsImageEncoded(gltf_model.images[ImageIdx]) && State.DecodedImages[ImageIdx].image.empty())
+            {
+                ScopedLoadStage Stage{State.pStats, MODEL_LOAD_PROFILE_STAGE_IMAGE_DECODE};
+                DecodeImage(static_cast<size_t>(ImageIdx));
+                Stage.AddItems(1, State.DecodedImages[ImageIdx].image.size());
+            }
+
+            {
+                ScopedLoadStage Stage{State.pStats, MODEL_LOAD_PROFILE_STAGE_TEXTURE_PREPARE};
+                // When images are decoded by the tinygltf callback, init data is prepared by AddTexture()
+                PrepareTexture(i, State.LoaderData.DeferDecoding);
+                Stage.AddItems(1, State.Images[i].DataSize);
+            }
+
+            if (State.pProgress != nullptr)
+                State.pProgress->NumItemsProcessed.fetch_add(1);
+
+            // Publish the texture to CommitTextures()
+            State.NumPreparedTextures.store(i + 1);
+        }
+    }
+}
+
+void Model::GetPendingImageCacheIds(std::vector<std::string>& CacheIds) const
+{
+    VERIFY_EXPR(m_pLoadingState);
+    const auto& State      = *m_pLoadingState;
+    const auto& gltf_model = State.gltf_model;
+
+    CacheIds.clear();
+    CacheIds.resize(gltf_model.images.size());
+    if (!State.BakedData.empty())
+        return;
+
+    for (size_t i = 0; i < gltf_model.images.size(); ++i)
+    {
+        // Images found in the cache by the image loader callback have known size and no data
+        const auto& gltf_image = gltf_model.images[i];
+        if (gltf_image.uri.empty() || gltf_image.image.empty() || gltf_image.width >= 0 || gltf_image.height >= 0)
+            continue;
+
+        CacheIds[i] = FileSystem::SimplifyPath((State.LoaderData.BaseDir + gltf_image.uri).c_str());
+    }
+}
+
+void Model::ReleasePendingImage(Uint32 ImageIndex)
+{
+    VERIFY_EXPR(m_pLoadingState);
+    auto& gltf_model = m_pLoadingState->gltf_model;
+    VERIFY_EXPR(ImageIndex < gltf_model.images.size());
+    std::vector<unsigned char>{}.swap(gltf_model.images[ImageIndex].image);
+}
+
+Uint32 Model::GetNumPreparedTextures() const
+{
+    return m_pLoadingState ? m_pLoadingState->NumPreparedTextures.load() : 0;
+}
+
+void Model::CommitTextures(IRenderDevice* pDevice, Uint32 NumTextures)
+{
+    VERIFY_EXPR(m_pLoadingState);
+    auto& State = *m_pLoadingState;
+    VERIFY(NumTextures <= State.NumPreparedTextures.load(), "Only prepared textures can be committed");
+
+    ScopedLoadStage Stage{State.pStats, MODEL_LOAD_PROFILE_STAGE_TEXTURE_COMMIT};
+
+    const auto FirstTexture = static_cast<Uint32>(Textures.size());
+
+    // Atlas space for the textures whose init data has been prepared is allocated in one batch,
+    // which takes the resource manager locks once and packs the atlases from the largest texture
+    // to the smallest. Streamed textures only allocate their mip tail and are handled by AddTexture().
+    std::vector<RefCntAutoPtr<ITextureAtlasSuballocation>> Allocations;
+    if (State.LoaderData.pResourceMgr != nullptr && NumStreamedTextureMips == 0 && NumTextures > FirstTexture)
+    {
+        std::vector<TextureSpaceRequest> Requests;
+        std::vector<Uint32>              RequestTexIds;
+        for (auto i = FirstTexture; i < NumTextures; ++i)
+        {
+            const auto& Image = State.Images[i];
+            if (State.IsTextureSkipped(i) || !State.InitData[i] || Image.Width <= 0 || Image.Height <= 0)
+                continue;
+
+            TextureSpaceRequest Request;
+            Request.Fmt       = State.InitData[i]->Format;
+            Request.Width     = static_cast<Uint32>(Image.Width);
+            Request.Height    = static_cast<Uint32>(Image.Height);
+            Request.CacheId   = State.CacheIds[i].c_str();
+            Request.pUserData = State.InitData[i];
+            Requests.emplace_back(Request);
+            RequestTexIds.emplace_back(i);
+        }
+
+        std::vector<RefCntAutoPtr<ITextureAtlasSuballocation>> RequestAllocations(Requests.size());
+        State.LoaderData.pResourceMgr->AllocateTextureSpace(Requests.data(), static_cast<Uint32>(Requests.size()), RequestAllocations.data());
+
+        Allocations.resize(NumTextures - FirstTexture);
+        for (size_t r = 0; r < Requests.size(); ++r)
+            Allocations[RequestTexIds[r] - FirstTexture] = std::move(RequestAllocations[r]);
+    }
+
+    // Add textures in the original order
+    Textures.reserve(State.Images.size());
+    for (auto i = FirstTexture; i < NumTextures; ++i)
+    {
+        if (State.IsTextureSkipped(i))
+        {
+            // Keep the entry so that texture indices match the glTF file
+            Textures.emplace_back();
+            continue;
+        }
+
+        Stage.AddItems(1, State.Images[i].DataSize);
+        AddTexture(pDevice, State.LoaderData.pTextureCache, State.LoaderData.pResourceMgr,
+                   State.Images[i], State.SamplerIds[i], State.CacheIds[i], State.InitData[i],
+                   !Allocations.empty() ? Allocations[i - FirstTexture].RawPtr() : nullptr);
+        // Release the init data reference as it is now owned by the texture or allocation
+        State.InitData[i].Release();
+
+        // Release the source image after the last texture that references it has been committed
+        // so that the decoded pixels and the texture init data are not kept alive together.
+        const auto ImageIdx = !State.ImageLastTextures.empty() ? FindGltfTextureSource(State.gltf_model, i) : -1;
+        if (ImageIdx >= 0 && State.ImageLastTextures[ImageIdx] == i)
+        {
+            std::vector<unsigned char>{}.swap(State.DecodedImages[ImageIdx].image);
+            std::vector<unsigned char>{}.swap(State.gltf_model.images[ImageIdx].image);
+        }
+        State.Images[i].pData    = nullptr;
+        State.Images[i].DataSize = 0;
+    }
+
+    // Texture sets of the materials may have changed
+    UpdateMaterialSortKeys();
+}
+
+void Model::EndLoading()
+{
+    m_pLoadingState.reset();
+}
+
+namespace
+{
+
+// "DGBM"
+static constexpr Uint32 BakedModelMagic = 0x4D424744;
+
+// Baked model file version. Must be incremented whenever the file layout changes.
+static constexpr Uint32 BakedModelVersion = 7;
+
+enum BAKED_TEXTURE_DATA : Uint8
+{
+    // Texture data is not stored in the file, e.g. because the texture was found in the cache.
+    BAKED_TEXTURE_DATA_NONE = 0,
+
+    // Prepared texture levels.
+    BAKED_TEXTURE_DATA_LEVELS,
+
+    // Raw DDS or KTX file data.
+    BAKED_TEXTURE_DATA_FILE
+};
+
+class BakedModelWriter
+{
+public:
+    template <typename T>
+    void Write(const T& Value)
+    {
+        WriteBytes(&Value, sizeof(Value));
+    }
+
+    void WriteBytes(const void* pData, size_t Size)
+    {
+        if (Size == 0)
+            return;
+        const auto* pBytes = static_cast<const Uint8*>(pData);
+        m_Data.insert(m_Data.end(), pBytes, pBytes + Size);
+    }
+
+    void WriteString(const std::string& Str)
+    {
+        Write(static_cast<Uint32>(Str.size()));
+        WriteBytes(Str.data(), Str.size());
+    }
+
+    template <typename T>
+    void WriteArray(const std::vector<T>& Vec)
+    {
+        Write(static_cast<Uint64>(Vec.size()));
+        WriteBytes(Vec.data(), Vec.size() * sizeof(T));
+    }
+
+    const std::vector<Uint8>& GetData() const
+    {
+        return m_Data;
+    }
+
+private:
+    std::vector<Uint8> m_Data;
+};
+
+class BakedModelReader
+{
+public:
+    BakedModelReader(const std::vector<Uint8>& Data, size_t Offset = 0) :
+        m_Data{Data},
+        m_Offset{Offset}
+    {
+        VERIFY_EXPR(m_Offset <= m_Data.size());
+    }
+
+    const Uint8* ReadBytes(size_t Size)
+    {
+        if (Size > m_Data.size() - m_Offset)
+            LOG_ERROR_AND_THROW("Unexpected end of the baked model data");
+
+        const auto* pData = m_Data.data() + m_Offset;
+        m_Offset += Size;
+        return pData;
+    }
+
+    template <typename T>
+    T Read()
+    {
+        T Value;
+        memcpy(&Value, ReadBytes(sizeof(T)), sizeof(T));
+        return Value;
+    }
+
+    bool ReadBool()
+    {
+        return Read<Uint8>() != 0;
+    }
+
+    std::string ReadString()
+    {
+        const auto  Size  = Read<Uint32>();
+        const auto* pData = ReadBytes(Size);
+        return std::string{reinterpret_cast<const char*>(pData), Size};
+    }
+
+    template <typename T>
+    std::vector<T> ReadArray()
+    {
+        const auto Size = Read<Uint64>();
+        if (Size > (m_Data.size() - m_Offset) / sizeof(T))
+            LOG_ERROR_AND_THROW("Unexpected end of the baked model data");
+
+        std::vector<T> Vec(static_cast<size_t>(Size));
+        if (!Vec.empty())
+            memcpy(Vec.data(), ReadBytes(Vec.size() * sizeof(T)), Vec.size() * sizeof(T));
+        return Vec;
+    }
+
+    // Reads the number of objects. Every object takes at least one byte, so the
+    // count can't exceed the remaining data size.
+    Uint32 ReadCount()
+    {
+        const auto Count = Read<Uint32>();
+        if (Count > m_Data.size() - m_Offset)
+            LOG_ERROR_AND_THROW("Invalid object count (", Count, ") in the baked model data");
+        return Count;
+    }
+
+    // Reads the index of the object that is either -1 or less than Count.
+    int ReadIndex(size_t Count)
+    {
+        const auto Idx = Read<Int32>();
+        if (Idx < -1 || Idx >= static_cast<Int32>(Count))
+            LOG_ERROR_AND_THROW("Invalid object index (", Idx, ") in the baked model data");
+        return Idx;
+    }
+
+    size_t GetOffset() const
+    {
+        return m_Offset;
+    }
+
+private:
+    const std::vector<Uint8>& m_Data;
+    size_t                    m_Offset = 0;
+};
+
+} // namespace
+
+void Model::WriteBakedModel() const
+{
+    VERIFY_EXPR(m_pLoadingState);
+    const auto& State = *m_pLoadingState;
+
+    BakedModelWriter Writer;
+    Writer.Write(BakedModelMagic);
+    Writer.Write(BakedModelVersion);
+
+    // Vertex and texture layout
+    Writer.Write(NumVertexAttributes);
+    for (Uint32 i = 0; i < NumVertexAttributes; ++i)
+    {
+        const auto& Attrib = VertexAttributes[i];
+        Writer.WriteString(Attrib.Name);
+        Writer.Write(Attrib.BufferId);
+        Writer.Write(Attrib.ValueType);
+        Writer.Write(Attrib.NumComponents);
+        Writer.Write(Attrib.RelativeOffset);
+        Writer.Write(Attrib.Encoding);
+    }
+    Writer.Write(NumTextureAttributes);
+    for (Uint32 i = 0; i < NumTextureAttributes; ++i)
+    {
+        const auto& Attrib = TextureAttributes[i];
+        Writer.WriteString(Attrib.Name);
+        Writer.Write(Attrib.Index);
+    }
+    Writer.Write(Buffers.back().ElementStride);
+
+    Writer.Write(static_cast<Uint32>(Extensions.size()));
+    for (const auto& Ext : Extensions)
+        Writer.WriteString(Ext);
+
+    VERIFY_EXPR(State.SamplerDescs.size() == TextureSamplers.size());
+    Writer.Write(static_cast<Uint32>(State.SamplerDescs.size()));
+    for (const auto& SamDesc : State.SamplerDescs)
+    {
+        Writer.Write(SamDesc.MinFilter);
+        Writer.Write(SamDesc.MagFilter);
+        Writer.Write(SamDesc.MipFilter);
+        Writer.Write(SamDesc.AddressU);
+        Writer.Write(SamDesc.AddressV);
+        Writer.Write(SamDesc.AddressW);
+    }
+
+    Writer.Write(static_cast<Uint32>(Materials.size()));
+    for (const auto& Mat : Materials)
+    {
+        Writer.Write(Mat.Attribs);
+        Writer.WriteString(Mat.Name);
+        Writer.Write(static_cast<Uint8>(Mat.DoubleSided ? 1 : 0));
+        Writer.Write(Mat.TextureIds);
+    }
+
+    Writer.Write(static_cast<Uint32>(MaterialVariants.size()));
+    for (const auto& Variant : MaterialVariants)
+        Writer.WriteString(Variant);
+
+    Writer.Write(static_cast<Uint32>(Cameras.size()));
+    for (const auto& Cam : Cameras)
+    {
+        Writer.WriteString(Cam.Name);
+        Writer.Write(Cam.Type);
+        Writer.Write(Cam.Perspective);
+    }
+
+    Writer.Write(static_cast<Uint32>(Meshes.size()));
+    for (const auto& M : Meshes)
+    {
+        Writer.WriteString(M.Name);
+        Writer.Write(M.BB);
+        Writer.Write(static_cast<Uint32>(M.Primitives.size()));
+        for (const auto& Prim : M.Primitives)
+        {
+            Writer.Write(Prim.FirstIndex);
+            Writer.Write(Prim.IndexCount);
+            Writer.Write(Prim.VertexCount);
+            Writer.Write(Prim.DefaultMaterialId);
+            Writer.Write(Prim.BB);
+            Writer.Write(Prim.FirstMeshlet);
+            Writer.Write(Prim.MeshletCount);
+            Writer.Write(Prim.FirstVertex);
+            Writer.WriteArray(Prim.LODs);
+            Writer.WriteArray(Prim.VariantMaterialIds);
+        }
+        Writer.WriteArray(M.MorphTargets);
+    }
+
+    // Objects are referenced by their indices
+    const auto GetNodeId = [](const Node* pNode) {
+        return pNode != nullptr ? Int32{pNode->Index} : -1;
+    };
+    const auto GetObjectId = [](const auto* pObject, const auto& Objects) {
+        return pObject != nullptr ? static_cast<Int32>(pObject - Objects.data()) : -1;
+    };
+
+    Writer.Write(static_cast<Uint32>(LinearNodes.size()));
+    for (const auto& N : LinearNodes)
+    {
+        Writer.Write(Int32{N.SkinTransformsIndex});
+        Writer.WriteString(N.Name);
+        Writer.Write(GetNodeId(N.Parent));
+        Writer.Write(static_cast<Uint32>(N.Children.size()));
+        for (const auto* pChild : N.Children)
+            Writer.Write(GetNodeId(pChild));
+        Writer.Write(GetObjectId(N.pMesh, Meshes));
+        Writer.Write(GetObjectId(N.pCamera, Cameras));
+        Writer.Write(GetObjectId(N.pSkin, Skins));
+        Writer.Write(N.Translation);
+        Writer.Write(N.Rotation);
+        Writer.Write(N.Scale);
+        Writer.Write(N.Matrix);
+        Writer.Write(N.FirstInstance);
+        Writer.Write(N.NumInstances);
+        Writer.Write(N.InstancesBB);
+        Writer.Write(Int32{N.MorphWeightsOffset});
+    }
+
+    Writer.Write(static_cast<Uint32>(Skins.size()));
+    for (const auto& S : Skins)
+    {
+        Writer.WriteString(S.Name);
+        Writer.Write(GetNodeId(S.pSkeletonRoot));
+        Writer.WriteArray(S.InverseBindMatrices);
+        Writer.Write(static_cast<Uint32>(S.Joints.size()));
+        for (const auto* pJoint : S.Joints)
+            Writer.Write(GetNodeId(pJoint));
+    }
+    Writer.Write(Int32{SkinTransformsCount});
+
+    Writer.Write(static_cast<Uint32>(RootNodes.size()));
+    for (const auto* pRoot : RootNodes)
+        Writer.Write(GetNodeId(pRoot));
+
+    Writer.Write(static_cast<Uint32>(Animations.size()));
+    for (const auto& Anim : Animations)
+    {
+        Writer.WriteString(Anim.Name);
+        Writer.Write(Anim.Start);
+        Writer.Write(Anim.End);
+        Writer.Write(static_cast<Uint32>(Anim.Samplers.size()));
+        for (const auto& Sam : Anim.Samplers)
+        {
+            Writer.Write(Sam.Interpolation);
+            Writer.WriteArray(Sam.Inputs);
+            Writer.WriteArray(Sam.OutputsVec4);
+            Writer.WriteArray(Sam.OutputWeights);
+        }
+        Writer.Write(static_cast<Uint32>(Anim.Channels.size()));
+        for (const auto& Channel : Anim.Channels)
+        {
+            Writer.Write(Channel.PathType);
+            Writer.Write(GetNodeId(Channel.pNode));
+            Writer.Write(Channel.SamplerIndex);
+        }
+    }
+
+    Writer.WriteArray(Meshlets);
+    Writer.WriteArray(InstanceMatrices);
+    Writer.WriteArray(MorphTargetDeltas);
+    Writer.WriteArray(DefaultMorphWeights);
+    Writer.WriteArray(FlattenedRanges);
+
+    // GPU-ready buffer data
+    Writer.WriteArray(State.IndexData);
+    Writer.Write(static_cast<Uint32>(State.VertexData.size()));
+    for (const auto& VertData : State.VertexData)
+        Writer.WriteArray(VertData);
+    Writer.WriteArray(State.MeshletData);
+
+    const auto NumTextures = static_cast<Uint32>(State.Images.size());
+    Writer.Write(NumTextures);
+    for (Uint32 i = 0; i < NumTextures; ++i)
+    {
+        const auto& Image     = State.Images[i];
+        const auto* pInitData = State.InitData[i].RawPtr();
+
+        Writer.WriteString(State.CacheIds[i]);
+        Writer.Write(Int32{State.SamplerIds[i]});
+        if (pInitData != nullptr && !pInitData->Levels.empty())
+        {
+            Writer.Write(BAKED_TEXTURE_DATA_LEVELS);
+            Writer.Write(Int32{Image.Width});
+            Writer.Write(Int32{Image.Height});
+            Writer.Write(Int32{Image.NumComponents});
+            Writer.Write(Int32{Image.ComponentSize});
+            Writer.Write(pInitData->Format);
+            Writer.Write(static_cast<Uint32>(pInitData->Levels.size()));
+            for (const auto& Level : pInitData->Levels)
+            {
+                Writer.Write(Level.Width);
+                Writer.Write(Level.Height);
+                Writer.Write(Uint64{Level.SubResData.Stride});
+                Writer.WriteArray(Level.Data);
+            }
+        }
+        else if ((Image.FileFormat == IMAGE_FILE_FORMAT_DDS || Image.FileFormat == IMAGE_FILE_FORMAT_KTX) && Image.DataSize > 0)
+        {
+            Writer.Write(BAKED_TEXTURE_DATA_FILE);
+            Writer.Write(Image.FileFormat);
+            Writer.Write(Uint64{Image.DataSize});
+            Writer.WriteBytes(Image.pData, Image.DataSize);
+        }
+        else
+        {
+            Writer.Write(BAKED_TEXTURE_DATA_NONE);
+            if (!State.IsTextureSkipped(i))
+            {
+                LOG_WARNING_MESSAGE("Data of texture ", i, (!State.CacheIds[i].empty() ? " (" + State.CacheIds[i] + ")" : std::string{}),
+                                    " is not available and will not be stored in the baked model file ", State.BakedFileName);
+            }
+        }
+    }
+
+    FileWrapper File{State.BakedFileName.c_str(), EFileAccessMode::Overwrite};
+    if (!File)
+    {
+        LOG_ERROR_MESSAGE("Failed to open baked model file '", State.BakedFileName, "' for writing.");
+        return;
+    }
+
+    const auto& Data = Writer.GetData();
+    if (!File->Write(Data.data(), Data.size()))
+    {
+        LOG_ERROR_MESSAGE("Failed to write baked model file '", State.BakedFileName, "'.");
+        return;
+    }
+
+    LOG_INFO_MESSAGE("Baked model file '", State.BakedFileName, "' has been written (", Data.size(), " bytes)");
+}
+
+void Model::LoadBakedGeometry(IRenderDevice* pDevice, const ModelCreateInfo& CI)
+{
+    VERIFY_EXPR(m_pLoadingState);
+    auto& State = *m_pLoadingState;
+
+    BakedModelReader Reader{State.BakedData};
+    if (Reader.Read<Uint32>() != BakedModelMagic)
+        LOG_ERROR_AND_THROW(CI.FileName, " is not a baked model file");
+
+    const auto Version = Reader.Read<Uint32>();
+    if (Version != BakedModelVersion)
+    {
+        LOG_ERROR_AND_THROW("Baked model file ", CI.FileName, " has version ", Version, " while version ", BakedModelVersion,
+                            " is expected. The model must be baked again.");
+    }
+
+    const auto CheckLayout = [&CI](bool Compatible) {
+        if (!Compatible)
+            LOG_ERROR_AND_THROW("Baked model file ", CI.FileName, " was baked with different vertex or texture attributes");
+    };
+    CheckLayout(Reader.Read<Uint32>() == NumVertexAttributes);
+    for (Uint32 i = 0; i < NumVertexAttributes; ++i)
+    {
+        const auto& Attrib = VertexAttributes[i];
+        CheckLayout(Reader.ReadString() == Attrib.Name);
+        CheckLayout(Reader.Read<decltype(Attrib.BufferId)>() == Attrib.BufferId);
+        CheckLayout(Reader.Read<decltype(Attrib.ValueType)>() == Attrib.ValueType);
+        CheckLayout(Reader.Read<decltype(Attrib.NumComponents)>() == Attrib.NumComponents);
+        CheckLayout(Reader.Read<decltype(Attrib.RelativeOffset)>() == Attrib.RelativeOffset);
+        CheckLayout(Reader.Read<decltype(Attrib.Encoding)>() == Attrib.Encoding);
+    }
+    CheckLayout(Reader.Read<Uint32>() == NumTextureAttributes);
+    for (Uint32 i = 0; i < NumTextureAttributes; ++i)
+    {
+        const auto& Attrib = TextureAttributes[i];
+        CheckLayout(Reader.ReadString() == Attrib.Name);
+        CheckLayout(Reader.Read<decltype(Attrib.Index)>() == Attrib.Index);
+    }
+    {
+        const auto IndexStride = Reader.Read<Uint32>();
+        if (Buffers.back().ElementStride == 0)
+        {
+            // The index type was selected automatically when the model was baked
+            CheckLayout(IndexStride == 2 || IndexStride == 4);
+            Buffers.back().ElementStride = IndexStride;
+        }
+        else
+        {
+            CheckLayout(IndexStride == Buffers.back().ElementStride);
+        }
+    }
+
+    Extensions.resize(Reader.ReadCount());
+    for (auto& Ext : Extensions)
+        Ext = Reader.ReadString();
+
+    const auto NumSamplers = Reader.ReadCount();
+    TextureSamplers.reserve(NumSamplers);
+    for (Uint32 i = 0; i < NumSamplers; ++i)
+    {
+        SamplerDesc SamDesc;
+        SamDesc.MinFilter = Reader.Read<decltype(SamDesc.MinFilter)>();
+        SamDesc.MagFilter = Reader.Read<decltype(SamDesc.MagFilter)>();
+        SamDesc.MipFilter = Reader.Read<decltype(SamDesc.MipFilter)>();
+        SamDesc.AddressU  = Reader.Read<decltype(SamDesc.AddressU)>();
+        SamDesc.AddressV  = Reader.Read<decltype(SamDesc.AddressV)>();
+        SamDesc.AddressW  = Reader.Read<decltype(SamDesc.AddressW)>();
+        TextureSamplers.push_back(GetSharedSampler(pDevice, State.LoaderData.pTextureCache, State.LoaderData.pResourceMgr, SamDesc));
+    }
+
+    Materials.resize(Reader.ReadCount());
+    for (auto& Mat : Materials)
+    {
+        Mat.Attribs     = Reader.Read<Material::ShaderAttribs>();
+        Mat.Name        = Reader.ReadString();
+        Mat.DoubleSided = Reader.ReadBool();
+        Mat.TextureIds  = Reader.Read<decltype(Mat.TextureIds)>();
+    }
+
+    MaterialVariants.resize(Reader.ReadCount());
+    for (auto& Variant : MaterialVariants)
+        Variant = Reader.ReadString();
+
+    Cameras.resize(Reader.ReadCount());
+    for (auto& Cam : Cameras)
+    {
+        Cam.Name        = Reader.ReadString();
+        Cam.Type        = Reader.Read<Camera::Projection>();
+        Cam.Perspective = Reader.Read<Camera::PerspectiveAttribs>();
+    }
+
+    Meshes.resize(Reader.ReadCount());
+    for (auto& M : Meshes)
+    {
+        M.Name = Reader.ReadString();
+        M.BB   = Reader.Read<BoundBox>();
+
+        const auto NumPrimitives = Reader.ReadCount();
+        M.Primitives.reserve(NumPrimitives);
+        for (Uint32 i = 0; i < NumPrimitives; ++i)
+        {
+            const auto FirstIndex  = Reader.Read<Uint32>();
+            const auto IndexCount  = Reader.Read<Uint32>();
+            const auto VertexCount = Reader.Read<Uint32>();
+            const auto MaterialId  = Reader.Read<Uint32>();
+            const auto BB          = Reader.Read<BoundBox>();
+            M.Primitives.emplace_back(FirstIndex, IndexCount, VertexCount, MaterialId, BB.Min, BB.Max);
+
+            auto& Prim        = M.Primitives.back();
+            Prim.FirstMeshlet = Reader.Read<Uint32>();
+            Prim.MeshletCount = Reader.Read<Uint32>();
+            Prim.FirstVertex  = Reader.Read<Uint32>();
+            Prim.LODs         = Reader.ReadArray<Primitive::LOD>();
+
+            Prim.VariantMaterialIds = Reader.ReadArray<Uint32>();
+            if (!Prim.VariantMaterialIds.empty() && Prim.VariantMaterialIds.size() != MaterialVariants.size())
+                LOG_ERROR_AND_THROW("Invalid number of material variants (", Prim.VariantMaterialIds.size(), ") in the baked model data");
+            for (const auto VariantMaterialId : Prim.VariantMaterialIds)
+            {
+                if (VariantMaterialId >= Materials.size())
+                    LOG_ERROR_AND_THROW("Invalid material index (", VariantMaterialId, ") in the baked model data");
+            }
+        }
+        M.MorphTargets = Reader.ReadArray<Mesh::MorphTarget>();
+    }
+
+    // Allocate all nodes first so that they can be referenced by index
+    const auto NumNodes = Reader.ReadCount();
+    LinearNodes.reserve(NumNodes);
+    for (Uint32 i = 0; i < NumNodes; ++i)
+        LinearNodes.emplace_back(static_cast<int>(i));
+
+    const auto ReadNode = [&]() {
+        const auto NodeId = Reader.ReadIndex(NumNodes);
+        return NodeId >= 0 ? &LinearNodes[NodeId] : nullptr;
+    };
+    const auto ReadObject = [&Reader](const auto& Objects) {
+        const auto Idx = Reader.ReadIndex(Objects.size());
+        return Idx >= 0 ? &Objects[Idx] : nullptr;
+    };
+
+    std::vector<int> NodeSkinIds(NumNodes);
+    for (auto& N : LinearNodes)
+    {
+        N.SkinTransformsIndex = Reader.Read<Int32>();
+        N.Name                = Reader.ReadString();
+        N.Parent              = ReadNode();
+
+        const auto NumChildren = Reader.ReadCount();
+        N.Children.reserve(NumChildren);
+        for (Uint32 i = 0; i < NumChildren; ++i)
+            N.Children.push_back(ReadNode());
+
+        N.pMesh   = ReadObject(Meshes);
+        N.pCamera = ReadObject(Cameras);
+
+        NodeSkinIds[N.Index] = Reader.Read<Int32>();
+
+        N.Translation   = Reader.Read<float3>();
+        N.Rotation      = Reader.Read<QuaternionF>();
+        N.Scale         = Reader.Read<float3>();
+        N.Matrix        = Reader.Read<float4x4>();
+        N.FirstInstance = Reader.Read<Uint32>();
+        N.NumInstances  = Reader.Read<Uint32>();
+        N.InstancesBB   = Reader.Read<BoundBox>();
+
+        N.MorphWeightsOffset = Reader.Read<Int32>();
+    }
+
+    // Make sure that the node hierarchy is a forest
+    for (const auto& N : LinearNodes)
+    {
+        for (const auto* pChild : N.Children)
+        {
+            if (pChild == nullptr || pChild->Parent != &N)
+                LOG_ERROR_AND_THROW("Node hierarchy in baked model file ", CI.FileName, " is invalid");
+        }
+    }
+
+    Skins.resize(Reader.ReadCount());
+    for (auto& S : Skins)
+    {
+        S.Name                = Reader.ReadString();
+        S.pSkeletonRoot       = ReadNode();
+        S.InverseBindMatrices = Reader.ReadArray<float4x4>();
+
+        const auto NumJoints = Reader.ReadCount();
+        S.Joints.reserve(NumJoints);
+        for (Uint32 i = 0; i < NumJoints; ++i)
+            S.Joints.push_back(ReadNode());
+    }
+    for (auto& N : LinearNodes)
+    {
+        const auto SkinId = NodeSkinIds[N.Index];
+        if (SkinId < -1 || SkinId >= static_cast<int>(Skins.size()))
+            LOG_ERROR_AND_THROW("Invalid skin index (", SkinId, ") in baked model file ", CI.FileName);
+        N.pSkin = SkinId >= 0 ? &Skins[SkinId] : nullptr;
+    }
+    SkinTransformsCount = Reader.Read<Int32>();
+
+    const auto NumRootNodes = Reader.ReadCount();
+    RootNodes.reserve(NumRootNodes);
+    for (Uint32 i = 0; i < NumRootNodes; ++i)
+    {
+        auto* pRoot = ReadNode();
+        if (pRoot == nullptr || pRoot->Parent != nullptr)
+            LOG_ERROR_AND_THROW("Node hierarchy in baked model file ", CI.FileName, " is invalid");
+        RootNodes.push_back(pRoot);
+    }
+
+    Animations.resize(Reader.ReadCount());
+    for (auto& Anim : Animations)
+    {
+        Anim.Name  = Reader.ReadString();
+        Anim.Start = Reader.Read<float>();
+        Anim.End   = Reader.Read<float>();
+
+        const auto NumAnimSamplers = Reader.ReadCount();
+        Anim.Samplers.reserve(NumAnimSamplers);
+        for (Uint32 i = 0; i < NumAnimSamplers; ++i)
+        {
+            Anim.Samplers.emplace_back(Reader.Read<AnimationSampler::INTERPOLATION_TYPE>());
+            auto& Sam         = Anim.Samplers.back();
+            Sam.Inputs        = Reader.ReadArray<float>();
+            Sam.OutputsVec4   = Reader.ReadArray<float4>();
+            Sam.OutputWeights = Reader.ReadArray<float>();
+        }
+
+        const auto NumChannels = Reader.ReadCount();
+        Anim.Channels.reserve(NumChannels);
+        for (Uint32 i = 0; i < NumChannels; ++i)
+        {
+            const auto PathType     = Reader.Read<AnimationChannel::PATH_TYPE>();
+            auto*      pNode        = ReadNode();
+            const auto SamplerIndex = Reader.Read<Uint32>();
+            if (pNode == nullptr || SamplerIndex >= Anim.Samplers.size())
+                LOG_ERROR_AND_THROW("Invalid animation channel in baked model file ", CI.FileName);
+            Anim.Channels.emplace_back(PathType, pNode, SamplerIndex);
+        }
+    }
+
+    Meshlets = Reader.ReadArray<Meshlet>();
+
+    InstanceMatrices = Reader.ReadArray<float4x4>();
+    for (const auto& N : LinearNodes)
+    {
+        if (size_t{N.FirstInstance} + N.NumInstances > InstanceMatrices.size())
+            LOG_ERROR_AND_THROW("Invalid instance range of node ", N.Index, " in baked model file ", CI.FileName);
+    }
+
+    MorphTargetDeltas   = Reader.ReadArray<MorphTargetDelta>();
+    DefaultMorphWeights = Reader.ReadArray<float>();
+    for (const auto& M : Meshes)
+    {
+        for (const auto& Target : M.MorphTargets)
+        {
+            if (size_t{Target.FirstDelta} + Target.NumDeltas > MorphTargetDeltas.size())
+                LOG_ERROR_AND_THROW("Invalid morph target range of mesh '", M.Name, "' in baked model file ", CI.FileName);
+        }
+    }
+    for (const auto& N : LinearNodes)
+    {
+        if (N.MorphWeightsOffset < 0 && N.MorphWeightsOffset != -1)
+            LOG_ERROR_AND_THROW("Invalid morph weights offset of node ", N.Index, " in baked model file ", CI.FileName);
+        if (N.MorphWeightsOffset >= 0 &&
+            (N.pMesh == nullptr || size_t{static_cast<Uint32>(N.MorphWeightsOffset)} + N.pMesh->MorphTargets.size() > DefaultMorphWeights.size()))
+            LOG_ERROR_AND_THROW("Invalid morph weights range of node ", N.Index, " in baked model file ", CI.FileName);
+    }
+
+    FlattenedRanges = Reader.ReadArray<FlattenedPrimitiveRange>();
+    for (const auto& Range : FlattenedRanges)
+    {
+        if (Range.NodeIndex >= LinearNodes.size() ||
+            Range.MeshIndex >= Meshes.size() ||
+            Range.PrimitiveIndex >= Meshes[Range.MeshIndex].Primitives.size())
+            LOG_ERROR_AND_THROW("Invalid flattened primitive range in baked model file ", CI.FileName);
+    }
+
+    auto IndexData = Reader.ReadArray<Uint8>();
+
+    std::vector<std::vector<Uint8>> VertexData(Reader.ReadCount());
+    for (auto& VertData : VertexData)
+        VertData = Reader.ReadArray<Uint8>();
+    CheckLayout(VertexData.size() + 1 == Buffers.size());
+
+    auto MeshletData = Reader.ReadArray<Uint32>();
+
+    InitNodeTransformOrder();
+
+    ModelBuilder Builder{CI, *this};
+    Builder.InitBuffers(std::move(IndexData), std::move(VertexData), std::move(MeshletData), pDevice, nullptr);
+
+    // Initialize per-texture data here for the same reason as in LoadGeometry().
+    const auto NumTextures = Reader.ReadCount();
+    State.Images.resize(NumTextures);
+    State.CacheIds.resize(NumTextures);
+    State.InitData.resize(NumTextures);
+    State.SamplerIds.resize(NumTextures);
+
+    State.BakedTexturesOffset = Reader.GetOffset();
+}
+
+void Model::LoadBakedTextures()
+{
+    VERIFY_EXPR(m_pLoadingState);
+    auto& State = *m_pLoadingState;
+
+    const auto NumTextures = static_cast<Uint32>(State.Images.size());
+    SetLoadStage(State.pProgress, MODEL_LOAD_STAGE_TEXTURE_DECODE, NumTextures);
+
+    BakedModelReader Reader{State.BakedData, State.BakedTexturesOffset};
+    for (Uint32 i = 0; i < NumTextures; ++i)
+    {
+        CheckLoadCancelled(State.pProgress);
+
+        State.CacheIds[i]   = Reader.ReadString();
+        State.SamplerIds[i] = Reader.ReadIndex(TextureSamplers.size());
+
+        auto&      Image    = State.Images[i];
+        const auto DataType = Reader.Read<BAKED_TEXTURE_DATA>();
+        if (DataType == BAKED_TEXTURE_DATA_LEVELS)
+        {
+            Image.Width         = Reader.Read<Int32>();
+            Image.Height        = Reader.Read<Int32>();
+            Image.NumComponents = Reader.Read<Int32>();
+            Image.ComponentSize = Reader.Read<Int32>();
+            Image.TexFormat     = Reader.Read<TEXTURE_FORMAT>();
+
+            const auto& FmtAttribs   = GetTextureFormatAttribs(Image.TexFormat);
+            const bool  IsCompressed = FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED;
+            if (Image.Width <= 0 || Image.Height <= 0 || Image.NumComponents <= 0 || Image.ComponentSize <= 0 ||
+                Image.TexFormat == TEX_FORMAT_UNKNOWN || FmtAttribs.BlockWidth == 0 || FmtAttribs.BlockHeight == 0)
+                LOG_ERROR_AND_THROW("Invalid texture ", i, " in the baked model data");
+
+            RefCntAutoPtr<TextureInitData> pInitData{MakeNewRCObj<TextureInitData>()(Image.TexFormat)};
+            pInitData->Levels.resize(Reader.ReadCount());
+            for (auto& Level : pInitData->Levels)
+            {
+                Level.Width             = Reader.Read<Uint32>();
+                Level.Height            = Reader.Read<Uint32>();
+                Level.SubResData.Stride = Reader.Read<Uint64>();
+                Level.Data              = Reader.ReadArray<Uint8>();
+                Level.SubResData.pData  = Level.Data.data();
+
+                const Uint64 NumRows = (Uint64{Level.Height} + FmtAttribs.BlockHeight - 1) / FmtAttribs.BlockHeight;
+                const Uint64 RowSize = IsCompressed ?
+                    (Uint64{Level.Width} + FmtAttribs.BlockWidth - 1) / FmtAttribs.BlockWidth * FmtAttribs.ComponentSize :
+                    Uint64{Level.Width} * FmtAttribs.ComponentSize * FmtAttribs.NumComponents;
+                if (Level.SubResData.Stride < RowSize || Level.SubResData.Stride * NumRows > Level.Data.size())
+                    LOG_ERROR_AND_THROW("Invalid level data of texture ", i, " in the baked model data");
+            }
+            if (pInitData->Levels.empty())
+                LOG_ERROR_AND_THROW("Texture ", i, " in the baked model data has no levels");
+
+            // Check that the prepared levels match the current texture atlas configuration.
+            // Without the resource manager, compressed textures contain the full mip chain.
+            auto* const pResourceMgr  = State.LoaderData.pResourceMgr;
+            const auto  MipLevels     = pResourceMgr != nullptr ? pResourceMgr->GetAtlasDesc(Image.TexFormat).MipLevels :
+                                                                  (IsCompressed ? ComputeMipLevelsCount(Image.Width, Image.Height) : 1u);
+            const auto  SizeAlignment = pResourceMgr != nullptr ? static_cast<int>(pResourceMgr->GetAllocationAlignment(Image.TexFormat, Image.Width, Image.Height)) : -1;
+            const auto  Level0Width   = SizeAlignment > 0 ? AlignUpNonPw2(Image.Width, SizeAlignment) : Image.Width;
+            const auto  Level0Height  = SizeAlignment > 0 ? AlignUpNonPw2(Image.Height, SizeAlignment) : Image.Height;
+
+            const auto& Level0 = pInitData->Levels[0];
+            if (pInitData->Levels.size() != MipLevels ||
+                Level0.Width != static_cast<Uint32>(Level0Width) ||
+                Level0.Height != static_cast<Uint32>(Level0Height))
+            {
+                if (Level0.Width < static_cast<Uint32>(Image.Width) || Level0.Height < static_cast<Uint32>(Image.Height))
+                    LOG_ERROR_AND_THROW("Invalid level data of texture ", i, " in the baked model data");
+
+                // The model was baked with a different atlas configuration. Recreate the levels
+                // from the original image region of the top level.
+                std::vector<Uint8> Pixels;
+                ImageData          SrcImage = Image;
+                if (IsCompressed)
+                {
+                    SrcImage.NumComponents = static_cast<int>(DecompressTextureLevel(Level0, Image.TexFormat, Image.Width, Image.Height, Pixels));
+                    SrcImage.ComponentSize = 1;
+                    if (SrcImage.NumComponents == 0)
+                        LOG_ERROR_AND_THROW("Compressed format ", GetTextureFormatAttribs(Image.TexFormat).Name, " of texture ", i, " in the baked model data is not supported");
+                }
+                else
+                {
+                    const auto RowSize = size_t{FmtAttribs.ComponentSize} * size_t{FmtAttribs.NumComponents} * static_cast<size_t>(Image.Width);
+
+                    Pixels.resize(RowSize * static_cast<size_t>(Image.Height));
+                    for (size_t row = 0; row < static_cast<size_t>(Image.Height); ++row)
+                        memcpy(&Pixels[row * RowSize], &Level0.Data[static_cast<size_t>(row * Level0.SubResData.Stride)], RowSize);
+
+                    SrcImage.NumComponents = FmtAttribs.NumComponents;
+                    SrcImage.ComponentSize = FmtAttribs.ComponentSize;
+                }
+                SrcImage.TexFormat = TEX_FORMAT_UNKNOWN;
+                SrcImage.pData     = Pixels.data();
+                SrcImage.DataSize  = Pixels.size();
+
+                // Keep the texture compressed if it still can be with the current configuration
+                const auto CompressedFormat = IsCompressed ?
+                    GetGLTFTextureCompressedFormat(SrcImage, TEXTURE_COMPRESS_MODE_BC, pResourceMgr, NumStreamedTextureMips > 0) :
+                    TEX_FORMAT_UNKNOWN;
+                const auto TexFormat = CompressedFormat != TEX_FORMAT_UNKNOWN ? CompressedFormat : GetModelImageDataTextureFormat(SrcImage);
+
+                const auto NewMipLevels = pResourceMgr != nullptr ? pResourceMgr->GetAtlasDesc(TexFormat).MipLevels :
+                                                                    (CompressedFormat != TEX_FORMAT_UNKNOWN ? ComputeMipLevelsCount(Image.Width, Image.Height) : 1u);
+                const auto NewAlignment = pResourceMgr != nullptr ? static_cast<int>(pResourceMgr->GetAllocationAlignment(TexFormat, Image.Width, Image.Height)) : -1;
+
+                // Alpha channel has already been remapped
+                pInitData = PrepareGLTFTextureInitData(SrcImage, 0, NewMipLevels, NewAlignment, CompressedFormat);
+                Image.TexFormat = pInitData->Format;
+            }
+
+            State.InitData[i] = std::move(pInitData);
+        }
+        else if (DataType == BAKED_TEXTURE_DATA_FILE)
+        {
+            Image.Width      = -1;
+            Image.Height     = -1;
+            Image.FileFormat = Reader.Read<IMAGE_FILE_FORMAT>();
+            Image.DataSize   = static_cast<size_t>(Reader.Read<Uint64>());
+            Image.pData      = Reader.ReadBytes(Image.DataSize);
+        }
+        else if (DataType != BAKED_TEXTURE_DATA_NONE)
+        {
+            LOG_ERROR_AND_THROW("Unknown data type of texture ", i, " in the baked model data");
+        }
+
+        if (State.pProgress != nullptr)
+            State.pProgress->NumItemsProcessed.fetch_add(1);
+
+        // Publish the texture to CommitTextures()
+        State.NumPreparedTextures.store(i + 1);
+    }
+}
+
+BoundBox Model::ComputeBoundingBox(const ModelTransforms& Transforms) const
+{
+    BoundBox ModelAABB;
+
+    if (CompatibleWithTransforms(Transforms))
+    {
+        ModelAABB.Min = float3{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+        ModelAABB.Max = float3{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+        for (size_t i = 0; i < LinearNodes.size(); ++i)
+        {
+            const auto& N = LinearNodes[i];
+            VERIFY_EXPR(N.Index == static_cast<int>(i));
+            if (N.pMesh != nullptr && N.pMesh->IsValidBB())
+            {
+                const auto& GlobalMatrix = Transforms.NodeGlobalMatrices[i];
+                const auto& MeshBB       = N.NumInstances > 0 ? N.InstancesBB : N.pMesh->BB;
+                const auto  NodeAABB     = MeshBB.Transform(GlobalMatrix);
+
+                ModelAABB.Min = std::min(ModelAABB.Min, NodeAABB.Min);
+                ModelAABB.Max = std::max(ModelAABB.Max, NodeAABB.Max);
+            }
+        }
+    }
+    else
+    {
+        UNEXPECTED("Incompatible transforms. Please use the ComputeTransforms() method first.");
+    }
+
+    return ModelAABB;
+}
+
+namespace
+{
+
+static_assert(sizeof(float4x4) == sizeof(float) * 16, "float4x4 is expected to be tightly packed");
+
+// Returns A * B.
+inline float4x4 MultiplyMatrices(const float4x4& A, const float4x4& B)
+{
+    float4x4 R;
+
+    const float* a = reinterpret_cast<const float*>(&A);
+    const float* b = reinterpret_cast<const float*>(&B);
+    float*       r = reinterpret_cast<float*>(&R);
+
+    // Every row of the result is a linear combination of the rows of B:
+    //      R[i] = A[i][0] * B[0] + A[i][1] * B[1] + A[i][2] * B[2] + A[i][3] * B[3]
+#if GLTF_LOADER_USE_SSE
+    const __m128 b0 = _mm_loadu_ps(b + 0);
+    const __m128 b1 = _mm_loadu_ps(b + 4);
+    const __m128 b2 = _mm_loadu_ps(b + 8);
+    const __m128 b3 = _mm_loadu_ps(b + 12);
+    for (int i = 0; i < 4; ++i)
+    {
+        const float* ai = a + i * 4;
+
+        __m128 ri = _mm_mul_ps(_mm_set1_ps(ai[0]), b0);
+        ri        = _mm_add_ps(ri, _mm_mul_ps(_mm_set1_ps(ai[1]), b1));
+        ri        = _mm_add_ps(ri, _mm_mul_ps(_mm_set1_ps(ai[2]), b2));
+        ri        = _mm_add_ps(ri, _mm_mul_ps(_mm_set1_ps(ai[3]), b3));
+        _mm_storeu_ps(r + i * 4, ri);
+    }
+#elif GLTF_LOADER_USE_NEON
+    const float32x4_t b0 = vld1q_f32(b + 0);
+    const float32x4_t b1 = vld1q_f32(b + 4);
+    const float32x4_t b2 = vld1q_f32(b + 8);
+    const float32x4_t b3 = vld1q_f32(b + 12);
+    for (int i = 0; i < 4; ++i)
+    {
+        const float* ai = a + i * 4;
+
+        float32x4_t ri = vmulq_n_f32(b0, ai[0]);
+        ri             = vmlaq_n_f32(ri, b1, ai[1]);
+        ri             = vmlaq_n_f32(ri, b2, ai[2]);
+        ri             = vmlaq_n_f32(ri, b3, ai[3]);
+        vst1q_f32(r + i * 4, ri);
+    }
+#else
+    for (int i = 0; i < 4; ++i)
+    {
+        const float* ai = a + i * 4;
+        for (int j = 0; j < 4; ++j)
+            r[i * 4 + j] = ai[0] * b[j] + ai[1] * b[4 + j] + ai[2] * b[8 + j] + ai[3] * b[12 + j];
+    }
+#endif
+
+    return R;
+}
+
+} // namespace
+
+static void UpdateNodeGlobalTransform(const Node& node, const float4x4& ParentMatrix, ModelTransforms& Transforms)
+{
+    const auto& LocalMat  = Transforms.NodeLocalMatrices[node.Index];
+    auto&       GlobalMat = Transforms.NodeGlobalMatrices[node.Index];
+    GlobalMat             = LocalMat * ParentMatrix;
+    for (auto* pChild : node.Children)
+    {
+        UpdateNodeGlobalTransform(*pChild, GlobalMat, Transforms);
+    }
+}
+
+inline float4x4 ComputeNodeLocalMatrix(const float3&      Scale,
+                                       const QuaternionF& Rotation,
+                                       const float3&      Translation,
+                                       const float4x4&    Matrix)
+{
+    // Translation, rotation, and scale properties and local space transformation are
+    // mutually exclusive in GLTF.
+
+    // LocalMatrix = S * R * T * M
+    float4x4 LocalMatrix = Matrix;
+
+    if (Translation != float3{})
+        LocalMatrix = float4x4::Translation(Translation) * LocalMatrix;
+
+    if (Rotation != QuaternionF{})
+        LocalMatrix = Rotation.ToMatrix() * LocalMatrix;
+
+    if (Scale != float3{1, 1, 1})
+        LocalMatrix = float4x4::Scale(Scale) * LocalMatrix;
+
+    return LocalMatrix;
+}
+
+inline float4x4 ComputeNodeLocalMatrix(const Node& N)
+{
+    return ComputeNodeLocalMatrix(N.Scale, N.Rotation, N.Translation, N.Matrix);
+}
+
+namespace
+{
+
+// Finds the keyframe index i such that Inputs[i] <= Time <= Inputs[i + 1].
+// Cursor contains the keyframe index found during the previous search and is
+// updated with the new index. Returns false if Time is outside of the keyframe range.
+bool FindAnimationKeyFrame(const std::vector<float>& Inputs, float Time, Uint32& Cursor)
+{
+    if (Inputs.size() < 2 || Time < Inputs.front() || Time > Inputs.back())
+        return false;
+
+    const auto LastKey = static_cast<Uint32>(Inputs.size() - 2);
+    if (Cursor > LastKey)
+        Cursor = LastKey;
+
+    // Check the previous keyframe and the one that follows it first as this
+    // is by far the most common case during normal playback.
+    if (Time >= Inputs[Cursor])
+    {
+        if (Time <= Inputs[Cursor + 1])
+            return true;
+
+        if (Cursor + 1 <= LastKey && Time <= Inputs[Cursor + 2])
+        {
+            ++Cursor;
+            return true;
+        }
+    }
+
+    // Binary search: find the first key that is greater than Time
+    auto it = std::upper_bound(Inputs.begin(), Inputs.end(), Time);
+    // Time <= Inputs.back(), so the search may only fail when Time == Inputs.back()
+    const auto Key = it != Inputs.begin() ? static_cast<Uint32>(std::distance(Inputs.begin(), it) - 1) : 0u;
+
+    Cursor = std::min(Key, LastKey);
+    return true;
+}
+
+// Hermite basis functions at the normalized time u of the spline segment with the duration td.
+struct HermiteBasis
+{
+    float h00, h10, h01, h11;
+
+    HermiteBasis(float u, float td)
+    {
+        const float u2 = u * u;
+        const float u3 = u2 * u;
+
+        h00 = 2 * u3 - 3 * u2 + 1;
+        h10 = (u3 - 2 * u2 + u) * td;
+        h01 = -2 * u3 + 3 * u2;
+        h11 = (u3 - u2) * td;
+    }
+
+    // Evaluates the segment from the value v0 with the out-tangent b0 to the value v1 with the in-tangent a1.
+    template <typename T>
+    T Evaluate(const T& v0, const T& b0, const T& a1, const T& v1) const
+    {
+        return v0 * h00 + b0 * h10 + v1 * h01 + a1 * h11;
+    }
+};
+
+// Evaluates the cubic Hermite spline segment between key frames i and i + 1 at the normalized time u.
+// For each key frame k, glTF stores the in-tangent, the value and the out-tangent in this order, so the
+// segment data (value i, out-tangent i, in-tangent i + 1, value i + 1) is contiguous in memory.
+inline float4 EvaluateCubicSpline(const AnimationSampler& sampler, size_t i, float u)
+{
+    const float4* pSegment = &sampler.OutputsVec4[i * 3 + 1];
+
+    const float4& v0 = pSegment[0];
+    const float4& b0 = pSegment[1];
+    const float4& a1 = pSegment[2];
+    const float4& v1 = pSegment[3];
+
+    const HermiteBasis H{u, sampler.Inputs[i + 1] - sampler.Inputs[i]};
+    return H.Evaluate(v0, b0, a1, v1);
+}
+
+void ApplyAnimationChannel(const AnimationChannel&               channel,
+                           const AnimationSampler&               sampler,
+                           float                                 time,
+                           Uint32&                               KeyFrameCursor,
+                           ModelTransforms::AnimationTransforms& NodeAnim)
+{
+    const bool IsCubicSpline = sampler.Interpolation == AnimationSampler::INTERPOLATION_TYPE::CUBICSPLINE;
+    if (IsCubicSpline && sampler.OutputsVec4.size() < sampler.Inputs.size() * 3)
+        return;
+
+    if (!FindAnimationKeyFrame(sampler.Inputs, time, KeyFrameCursor))
+        return;
+
+    const size_t i = KeyFrameCursor;
+
+    // STEP: The animated values remain constant to the output of the first keyframe, until the next keyframe.
+    //       The number of output elements **MUST** equal the number of input elements.
+    float u = 0;
+
+    // LINEAR: The animated values are linearly interpolated between keyframes.
+    //         The number of output elements **MUST** equal the number of input elements.
+    //
+    // CUBICSPLINE: The animation's interpolation is computed using a cubic spline with specified tangents.
+    //              The number of output elements **MUST** equal three times the number of input elements.
+    //              For each input element, the output stores three elements, an in-tangent, a spline vertex,
+    //              and an out-tangent. There **MUST** be at least two keyframes when using this interpolation.
+    if (sampler.Interpolation != AnimationSampler::INTERPOLATION_TYPE::STEP)
+        u = (time - sampler.Inputs[i]) / (sampler.Inputs[i + 1] - sampler.Inputs[i]);
+
+    switch (channel.PathType)
+    {
+        case AnimationChannel::PATH_TYPE::TRANSLATION:
+        {
+            if (IsCubicSpline)
+            {
+                NodeAnim.Translation = EvaluateCubicSpline(sampler, i, u);
+                break;
+            }
+            const float3 f3Start = sampler.OutputsVec4[i];
+            const float3 f3End   = sampler.OutputsVec4[i + 1];
+            NodeAnim.Translation = lerp(f3Start, f3End, u);
+            break;
+        }
+
+        case AnimationChannel::PATH_TYPE::SCALE:
+        {
+            if (IsCubicSpline)
+            {
+                NodeAnim.Scale = EvaluateCubicSpline(sampler, i, u);
+                break;
+            }
+            const float3 f3Start = sampler.OutputsVec4[i];
+            const float3 f3End   = sampler.OutputsVec4[i + 1];
+            NodeAnim.Scale       = lerp(f3Start, f3End, u);
+            break;
+        }
+
+        case AnimationChannel::PATH_TYPE::ROTATION:
+        {
+            if (IsCubicSpline)
+            {
+                // The spline result is not a unit quaternion and must be normalized
+                NodeAnim.Rotation.q = normalize(EvaluateCubicSpline(sampler, i, u));
+                break;
+            }
+
+            QuaternionF q1;
+            q1.q.x = sampler.OutputsVec4[i].x;
+            q1.q.y = sampler.OutputsVec4[i].y;
+            q1.q.z = sampler.OutputsVec4[i].z;
+            q1.q.w = sampler.OutputsVec4[i].w;
+
+            QuaternionF q2;
+            q2.q.x = sampler.OutputsVec4[i + 1].x;
+            q2.q.y = sampler.OutputsVec4[i + 1].y;
+            q2.q.z = sampler.OutputsVec4[i + 1].z;
+            q2.q.w = sampler.OutputsVec4[i + 1].w;
+
+            NodeAnim.Rotation = normalize(slerp(q1, q2, u));
+            break;
+        }
+
+        case AnimationChannel::PATH_TYPE::WEIGHTS:
+        {
+            UNEXPECTED("Weights must be evaluated by ApplyMorphWeightsChannel");
+            break;
+        }
+    }
+}
+
+// Evaluates the morph target weights channel. pWeights points to the NumWeights weights of the animated node.
+void ApplyMorphWeightsChannel(const AnimationSampler& sampler,
+                              float                   time,
+                              Uint32&                 KeyFrameCursor,
+                              float*                  pWeights,
+                              size_t                  NumWeights)
+{
+    // For each key frame, the outputs contain the weights of all morph targets (or, for
+    // the cubic spline, the in-tangents, the values and the out-tangents of all weights).
+    const bool   IsCubicSpline = sampler.Interpolation == AnimationSampler::INTERPOLATION_TYPE::CUBICSPLINE;
+    const size_t KeyStride     = NumWeights * (IsCubicSpline ? 3 : 1);
+    if (sampler.OutputWeights.size() < sampler.Inputs.size() * KeyStride)
+        return;
+
+    if (!FindAnimationKeyFrame(sampler.Inputs, time, KeyFrameCursor))
+        return;
+
+    const size_t i = KeyFrameCursor;
+
+    float u = 0;
+    if (sampler.Interpolation != AnimationSampler::INTERPOLATION_TYPE::STEP)
+        u = (time - sampler.Inputs[i]) / (sampler.Inputs[i + 1] - sampler.Inputs[i]);
+
+    const float* pKey0 = &sampler.OutputWeights[i * KeyStride];
+    const float* pKey1 = pKey0 + KeyStride;
+    if (IsCubicSpline)
+    {
+        const HermiteBasis H{u, sampler.Inputs[i + 1] - sampler.Inputs[i]};
+        for (size_t w = 0; w < NumWeights; ++w)
+            pWeights[w] = H.Evaluate(pKey0[NumWeights + w], pKey0[NumWeights * 2 + w], pKey1[w], pKey1[NumWeights + w]);
+    }
+    else
+    {
+        for (size_t w = 0; w < NumWeights; ++w)
+            pWeights[w] = pKey0[w] + (pKey1[w] - pKey0[w]) * u;
+    }
+}
+
+// Evaluates the morph target weights channels of the animation into Weights (see Node::MorphWeightsOffset).
+// If pCursors is null, key frames are searched from the beginning.
+void EvaluateMorphWeights(const Animation& animation, float time, Uint32* pCursors, std::vector<float>& Weights)
+{
+    if (Weights.empty())
+        return;
+
+    time = clamp(time, animation.Start, animation.End);
+    for (const auto& channel : animation.Channels)
+    {
+        if (channel.PathType != AnimationChannel::PATH_TYPE::WEIGHTS)
+            continue;
+
+        const auto& N = *channel.pNode;
+        if (N.MorphWeightsOffset < 0 || N.pMesh == nullptr)
+            continue;
+
+        const auto NumWeights = N.pMesh->MorphTargets.size();
+        if (static_cast<size_t>(N.MorphWeightsOffset) + NumWeights > Weights.size())
+            continue;
+
+        Uint32  Cursor  = 0;
+        Uint32& rCursor = pCursors != nullptr ? pCursors[channel.SamplerIndex] : Cursor;
+        ApplyMorphWeightsChannel(animation.Samplers[channel.SamplerIndex], time, rCursor, &Weights[N.MorphWeightsOffset], NumWeights);
+    }
+}
+
+} // namespace
+
+void Model::ComputeTransforms(ModelTransforms& Transforms,
+                              const float4x4&  RootTransform,
+                              Int32            AnimationIndex,
+                              float            Time) const
+{
+    if (UpdateTransformsIncremental(Transforms, RootTransform, AnimationIndex, Time))
+        return;
+
+    Transforms.NodeGlobalMatrices.resize(LinearNodes.size());
+    Transforms.NodeLocalMatrices.resize(LinearNodes.size());
+
+    // Update node animation
+    if (AnimationIndex >= 0)
+    {
+        Transforms.Skins.resize(SkinTransformsCount);
+        UpdateAnimation(AnimationIndex, Time, Transforms);
+    }
+    else
+    {
+        Transforms.Skins.clear();
+        Transforms.MorphWeights = DefaultMorphWeights;
+        for (size_t i = 0; i < LinearNodes.size(); ++i)
+            Transforms.NodeLocalMatrices[i] = ComputeNodeLocalMatrix(LinearNodes[i]);
+    }
+
+    ComputeGlobalTransforms(Transforms, RootTransform);
+
+    auto& Incremental = Transforms.Incremental;
+    // Only valid animations can be updated incrementally
+    Incremental.AnimationIndex = AnimationIndex < static_cast<Int32>(Animations.size()) ? std::max(AnimationIndex, -1) : -2;
+    Incremental.RootTransform  = RootTransform;
+    Incremental.NodeChanged.assign(LinearNodes.size(), 1);
+}
+
+void Model::ComputeTransformsBatch(ModelTransforms*           pTransforms,
+                                   const ModelAnimationState* pStates,
+                                   Uint32                     NumInstances,
+                                   IThreadPool*               pThreadPool,
+                                   Uint32                     MinInstancesPerTask) const
+{
+    if (NumInstances == 0)
+        return;
+
+    DEV_CHECK_ERR(pTransforms != nullptr, "pTransforms must not be null");
+    DEV_CHECK_ERR(pStates != nullptr, "pStates must not be null");
+
+    MinInstancesPerTask = std::max(MinInstancesPerTask, 1u);
+    if (pThreadPool == nullptr || NumInstances <= MinInstancesPerTask)
+    {
+        ComputeTransformsRange(pTransforms, pStates, NumInstances);
+        return;
+    }
+
+    const Uint32 NumTasks         = (NumInstances + MinInstancesPerTask - 1) / MinInstancesPerTask;
+    const Uint32 InstancesPerTask = (NumInstances + NumTasks - 1) / NumTasks;
+
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    Tasks.reserve(NumTasks - 1);
+    // Process the first range in this thread
+    for (Uint32 FirstInstance = InstancesPerTask; FirstInstance < NumInstances; FirstInstance += InstancesPerTask)
+    {
+        const auto Count = std::min(InstancesPerTask, NumInstances - FirstInstance);
+        Tasks.emplace_back(
+            EnqueueAsyncWork(pThreadPool,
+                             [this, pTransforms, pStates, FirstInstance, Count](Uint32 ThreadId) {
+                                 ComputeTransformsRange(pTransforms + FirstInstance, pStates + FirstInstance, Count);
+                             }));
+    }
+
+    ComputeTransformsRange(pTransforms, pStates, std::min(InstancesPerTask, NumInstances));
+
+    for (auto& pTask : Tasks)
+        pTask->WaitForCompletion();
+}
+
+void Model::ComputeTransformsRange(ModelTransforms*           pTransforms,
+                                   const ModelAnimationState* pStates,
+                                   Uint32                     NumInstances) const
+{
+    // Group instances by animation so that channel and sampler data of each
+    // animation is traversed once for the entire group.
+    std::vector<Uint32> SortedInstances(NumInstances);
+    for (Uint32 i = 0; i < NumInstances; ++i)
+        SortedInstances[i] = i;
+    std::stable_sort(SortedInstances.begin(), SortedInstances.end(),
+                     [pStates](Uint32 i0, Uint32 i1) {
+                         return pStates[i0].AnimationIndex < pStates[i1].AnimationIndex;
+                     });
+
+    std::vector<ModelTransforms*> GroupTransforms;
+    std::vector<float>            GroupTimes;
+    GroupTransforms.reserve(NumInstances);
+    GroupTimes.reserve(NumInstances);
+
+    const ModelTransforms* pStaticTransforms = nullptr;
+    for (size_t GroupStart = 0; GroupStart < SortedInstances.size();)
+    {
+        const auto AnimationIndex = pStates[SortedInstances[GroupStart]].AnimationIndex;
+
+        size_t GroupEnd = GroupStart;
+        GroupTransforms.clear();
+        GroupTimes.clear();
+        for (; GroupEnd < SortedInstances.size() && pStates[SortedInstances[GroupEnd]].AnimationIndex == AnimationIndex; ++GroupEnd)
+        {
+            const auto InstId     = SortedInstances[GroupEnd];
+            auto&      Transforms = pTransforms[InstId];
+
+            Transforms.NodeGlobalMatrices.resize(LinearNodes.size());
+            Transforms.NodeLocalMatrices.resize(LinearNodes.size());
+            if (AnimationIndex >= 0)
+            {
+                Transforms.Skins.resize(SkinTransformsCount);
+                GroupTransforms.push_back(&Transforms);
+                GroupTimes.push_back(pStates[InstId].Time);
+            }
+            else
+            {
+                Transforms.Skins.clear();
+                Transforms.MorphWeights = DefaultMorphWeights;
+                if (pStaticTransforms == nullptr)
+                {
+                    for (size_t i = 0; i < LinearNodes.size(); ++i)
+                        Transforms.NodeLocalMatrices[i] = ComputeNodeLocalMatrix(LinearNodes[i]);
+                    pStaticTransforms = &Transforms;
+                }
+                else
+                {
+                    // Local matrices of non-animated instances are identical
+                    Transforms.NodeLocalMatrices = pStaticTransforms->NodeLocalMatrices;
+                }
+            }
+        }
+
+        if (AnimationIndex >= 0)
+        {
+            UpdateAnimation(static_cast<Uint32>(AnimationIndex), GroupTransforms.data(), GroupTimes.data(), static_cast<Uint32>(GroupTransforms.size()));
+        }
+
+        GroupStart = GroupEnd;
+    }
+
+    for (Uint32 i = 0; i < NumInstances; ++i)
+        ComputeGlobalTransforms(pTransforms[i], pStates[i].RootTransform);
+}
+
+void Model::InitNodeTransformOrder()
+{
+    NodeTransformOrder.clear();
+    NodeTransformOrder.reserve(LinearNodes.size());
+
+    // Replicate the order of the recursive traversal from the root nodes
+    std::vector<std::pair<const Node*, Int32>> Stack;
+    for (auto it = RootNodes.rbegin(); it != RootNodes.rend(); ++it)
+        Stack.emplace_back(*it, -1);
+
+    while (!Stack.empty())
+    {
+        const auto* pNode  = Stack.back().first;
+        const auto  Parent = Stack.back().second;
+        Stack.pop_back();
+
+        NodeTransformOrder.push_back({pNode->Index, Parent});
+        for (auto it = pNode->Children.rbegin(); it != pNode->Children.rend(); ++it)
+            Stack.emplace_back(*it, pNode->Index);
+    }
+
+    if (!FlattenedRanges.empty())
+    {
+        // The geometry of the flattened nodes is already in the model space, so their
+        // global matrices are only needed if their subtrees contain other objects.
+        std::vector<bool> IsFlattened(LinearNodes.size(), false);
+        for (const auto& Range : FlattenedRanges)
+            IsFlattened[Range.NodeIndex] = true;
+
+        std::vector<bool> IsRequired(LinearNodes.size(), false);
+        for (const auto& S : Skins)
+        {
+            if (S.pSkeletonRoot != nullptr)
+                IsRequired[S.pSkeletonRoot->Index] = true;
+            for (const auto* pJoint : S.Joints)
+            {
+                if (pJoint != nullptr)
+                    IsRequired[pJoint->Index] = true;
+            }
+        }
+        for (const auto& A : Animations)
+        {
+            for (const auto& Channel : A.Channels)
+                IsRequired[Channel.pNode->Index] = true;
+        }
+
+        // Children follow their parents, so the requirement is propagated up in a single reverse pass
+        for (auto it = NodeTransformOrder.rbegin(); it != NodeTransformOrder.rend(); ++it)
+        {
+            const auto& N = LinearNodes[it->NodeIndex];
+            if (!IsFlattened[N.Index] || N.pMesh != nullptr || N.pCamera != nullptr)
+                IsRequired[N.Index] = true;
+            if (IsRequired[N.Index] && it->ParentIndex >= 0)
+                IsRequired[it->ParentIndex] = true;
+        }
+
+        NodeTransformOrder.erase(std::remove_if(NodeTransformOrder.begin(), NodeTransformOrder.end(),
+                                                [&IsRequired](const NodeTransformOrderEntry& Entry) {
+                                                    return !IsRequired[Entry.NodeIndex];
+                                                }),
+                                 NodeTransformOrder.end());
+    }
+
+    NodeDepths.assign(LinearNodes.size(), 0);
+    for (const auto& Entry : NodeTransformOrder)
+    {
+        if (Entry.ParentIndex >= 0)
+            NodeDepths[Entry.NodeIndex] = static_cast<Uint8>(std::min(NodeDepths[Entry.ParentIndex] + 1, 255));
+    }
+}
+
+void Model::ComputeGlobalTransforms(ModelTransforms& Transforms, const float4x4& RootTransform, bool UpdateJoints) const
+{
+    // Compute global transforms
+    if (!NodeTransformOrder.empty() || RootNodes.empty())
+    {
+        // Parents always precede their children, so global transforms can be computed in a single linear pass
+        for (const auto& Entry : NodeTransformOrder)
+        {
+            const auto& ParentMatrix = Entry.ParentIndex >= 0 ? Transforms.NodeGlobalMatrices[Entry.ParentIndex] : RootTransform;
+
+            Transforms.NodeGlobalMatrices[Entry.NodeIndex] = MultiplyMatrices(Transforms.NodeLocalMatrices[Entry.NodeIndex], ParentMatrix);
+        }
+    }
+    else
+    {
+        // The model was not created by the model builder
+        for (auto* pRoot : RootNodes)
+            UpdateNodeGlobalTransform(*pRoot, RootTransform, Transforms);
+    }
+
+    if (UpdateJoints)
+    {
+        UpdateJointMatrices(Transforms, nullptr);
+    }
+    else
+    {
+        // Skins whose matrices have not been computed are always updated
+        auto& NodeChanged = Transforms.Incremental.NodeChanged;
+        NodeChanged.assign(LinearNodes.size(), 0);
+        UpdateJointMatrices(Transforms, NodeChanged.data());
+    }
+
+    // Matrices were not computed by ComputeTransforms()
+    Transforms.Incremental.AnimationIndex = -2;
+}
+
+void Model::UpdateJointMatrices(ModelTransforms& Transforms, const Uint8* pNodeChanged) const
+{
+    // Update join matrices
+    if (!Transforms.Skins.empty())
+    {
+        for (auto& node : LinearNodes)
+        {
+            auto* pMesh = node.pMesh;
+            auto* pSkin = node.pSkin;
+            if (pMesh == nullptr || pSkin == nullptr)
+                continue;
+
+            if (pNodeChanged != nullptr && !pNodeChanged[node.Index])
+            {
+                bool JointsChanged = false;
+                for (const auto* pJoint : pSkin->Joints)
+                {
+                    if (pNodeChanged[pJoint->Index])
+                    {
+                        JointsChanged = true;
+                        break;
+                    }
+                }
+                if (!JointsChanged && Transforms.Skins[node.SkinTransformsIndex].JointMatrices.size() == pSkin->Joints.size())
+                    continue;
+            }
+
+            const auto& NodeGlobalMat = Transforms.NodeGlobalMatrices[node.Index];
+            VERIFY(node.SkinTransformsIndex < SkinTransformsCount,
+                   "Skin transform index (", node.SkinTransformsIndex, ") exceeds the skin transform count in this mesh (", SkinTransformsCount,
+                   "). This appears to be a bug.");
+            auto& JointMatrices = Transforms.Skins[node.SkinTransformsIndex].JointMatrices;
+            if (JointMatrices.size() != pSkin->Joints.size())
+                JointMatrices.resize(pSkin->Joints.size());
+
+            const auto InverseTransform = NodeGlobalMat.Inverse();
+            for (size_t i = 0; i < pSkin->Joints.size(); i++)
+            {
+                const auto* JointNode          = pSkin->Joints[i];
+                const auto& JointNodeGlobalMat = Transforms.NodeGlobalMatrices[JointNode->Index];
+                JointMatrices[i] =
+                    MultiplyMatrices(MultiplyMatrices(pSkin->InverseBindMatrices[i], JointNodeGlobalMat), InverseTransform);
+            }
+        }
+    }
+}
+
+bool Model::CompatibleWithTransforms(const ModelTransforms& Transforms) const
+{
+    return (Transforms.NodeLocalMatrices.size() == LinearNodes.size() &&
+            Transforms.NodeGlobalMatrices.size() == LinearNodes.size());
+}
+
+namespace
+{
+
+// The number of boxes processed by a single iteration of the frustum test.
+static constexpr size_t BoundsBatchSize = 4;
+
+inline bool HasValidMeshBounds(const Node& N)
+{
+    return N.pMesh != nullptr && N.pMesh->IsValidBB();
+}
+
+// Returns the node-space bounds of the node mesh, including all of its instances.
+inline const BoundBox& GetNodeMeshBounds(const Node& N)
+{
+    return N.NumInstances > 0 ? N.InstancesBB : N.pMesh->BB;
+}
+
+// Frustum planes in the structure-of-arrays layout.
+struct FrustumPlanesSoA
+{
+    static constexpr Uint32 NumPlanes = ViewFrustum::NUM_PLANES;
+
+    float Nx[NumPlanes];
+    float Ny[NumPlanes];
+    float Nz[NumPlanes];
+    float AbsNx[NumPlanes];
+    float AbsNy[NumPlanes];
+    float AbsNz[NumPlanes];
+    float D[NumPlanes];
+
+    explicit FrustumPlanesSoA(const ViewFrustum& Frustum)
+    {
+        for (Uint32 p = 0; p < NumPlanes; ++p)
+        {
+            const auto& Plane = Frustum.GetPlane(static_cast<ViewFrustum::PLANE_IDX>(p));
+
+            Nx[p]    = Plane.Normal.x;
+            Ny[p]    = Plane.Normal.y;
+            Nz[p]    = Plane.Normal.z;
+            AbsNx[p] = std::abs(Plane.Normal.x);
+            AbsNy[p] = std::abs(Plane.Normal.y);
+            AbsNz[p] = std::abs(Plane.Normal.z);
+            D[p]     = Plane.Distance;
+        }
+    }
+
+    // The box is outside of the frustum if it is entirely in the negative half-space of any plane.
+    bool IsBoxVisible(const BoundBox& Box) const
+    {
+        const float3 Center = (Box.Max + Box.Min) * 0.5f;
+        const float3 Extent = (Box.Max - Box.Min) * 0.5f;
+        for (Uint32 p = 0; p < NumPlanes; ++p)
+        {
+            const float Dist = Nx[p] * Center.x + Ny[p] * Center.y + Nz[p] * Center.z + D[p] +
+                AbsNx[p] * Extent.x + AbsNy[p] * Extent.y + AbsNz[p] * Extent.z;
+            if (Dist < 0)
+                return false;
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+void Model::UpdateNodeBounds(ModelTransforms& Transforms) const
+{
+    if (!CompatibleWithTransforms(Transforms))
+    {
+        UNEXPECTED("Incompatible transforms. Please use the ComputeTransforms() method first.");
+        return;
+    }
+
+    auto& Cache = Transforms.NodeBounds;
+
+    // Check if the cache was built for this model
+    bool   ResetCache = false;
+    size_t NumBoxes   = 0;
+    for (size_t i = 0; i < LinearNodes.size(); ++i)
+    {
+        if (!HasValidMeshBounds(LinearNodes[i]))
+            continue;
+        if (NumBoxes >= Cache.NodeIds.size() || Cache.NodeIds[NumBoxes] != i)
+            ResetCache = true;
+        ++NumBoxes;
+    }
+    if (NumBoxes != Cache.NodeIds.size() || Cache.Matrices.size() != NumBoxes)
+        ResetCache = true;
+
+    if (ResetCache)
+    {
+        Cache.NodeIds.clear();
+        Cache.NodeIds.reserve(NumBoxes);
+        for (size_t i = 0; i < LinearNodes.size(); ++i)
+        {
+            if (HasValidMeshBounds(LinearNodes[i]))
+                Cache.NodeIds.push_back(static_cast<Uint32>(i));
+        }
+
+        // Pad the arrays so that the frustum test does not need to handle the remainder
+        const auto PaddedSize = AlignUp(NumBoxes, BoundsBatchSize);
+        for (auto* pArray : {&Cache.CenterX, &Cache.CenterY, &Cache.CenterZ, &Cache.ExtentX, &Cache.ExtentY, &Cache.ExtentZ})
+            pArray->assign(PaddedSize, 0.f);
+        Cache.Matrices.resize(NumBoxes);
+    }
+
+    const bool HasSkins = !Transforms.Skins.empty();
+    for (size_t Slot = 0; Slot < NumBoxes; ++Slot)
+    {
+        const auto  NodeIndex    = Cache.NodeIds[Slot];
+        const auto& N            = LinearNodes[NodeIndex];
+        const auto& GlobalMatrix = Transforms.NodeGlobalMatrices[NodeIndex];
+
+        // Bounds of skinned nodes depend on joint transforms and are always updated
+        if (!ResetCache && N.pSkin == nullptr && Cache.Matrices[Slot] == GlobalMatrix)
+            continue;
+
+        BoundBox WorldBB;
+        if (N.pSkin != nullptr && HasSkins && !N.pSkin->Joints.empty())
+        {
+            const auto& Joints = N.pSkin->Joints;
+            const auto& IBMs   = N.pSkin->InverseBindMatrices;
+
+            WorldBB.Min = float3{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+            WorldBB.Max = float3{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+            for (size_t j = 0; j < Joints.size(); ++j)
+            {
+                const auto& JointGlobalMatrix = Transforms.NodeGlobalMatrices[Joints[j]->Index];
+
+                // Joint matrices are applied in the node space before the node's global matrix,
+                // so the vertex world transform is InverseBindMatrix * JointGlobalMatrix.
+                const auto JointBB = N.pMesh->BB.Transform(j < IBMs.size() ? MultiplyMatrices(IBMs[j], JointGlobalMatrix) : JointGlobalMatrix);
+
+                WorldBB.Min = std::min(WorldBB.Min, JointBB.Min);
+                WorldBB.Max = std::max(WorldBB.Max, JointBB.Max);
+            }
+        }
+        else
+        {
+            WorldBB = GetNodeMeshBounds(N).Transform(GlobalMatrix);
+        }
+
+        const float3 Center = (WorldBB.Max + WorldBB.Min) * 0.5f;
+        const float3 Extent = (WorldBB.Max - WorldBB.Min) * 0.5f;
+
+        Cache.CenterX[Slot]  = Center.x;
+        Cache.CenterY[Slot]  = Center.y;
+        Cache.CenterZ[Slot]  = Center.z;
+        Cache.ExtentX[Slot]  = Extent.x;
+        Cache.ExtentY[Slot]  = Extent.y;
+        Cache.ExtentZ[Slot]  = Extent.z;
+        Cache.Matrices[Slot] = GlobalMatrix;
+    }
+}
+
+BoundBox Model::GetNodeBounds(const ModelTransforms& Transforms, Uint32 NodeIndex) const
+{
+    const auto& Cache = Transforms.NodeBounds;
+
+    // Node ids are sorted
+    const auto it = std::lower_bound(Cache.NodeIds.begin(), Cache.NodeIds.end(), NodeIndex);
+    if (it == Cache.NodeIds.end() || *it != NodeIndex)
+        return BoundBox{float3{+FLT_MAX, +FLT_MAX, +FLT_MAX}, float3{-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+
+    const auto Slot = static_cast<size_t>(it - Cache.NodeIds.begin());
+
+    const float3 Center{Cache.CenterX[Slot], Cache.CenterY[Slot], Cache.CenterZ[Slot]};
+    const float3 Extent{Cache.ExtentX[Slot], Cache.ExtentY[Slot], Cache.ExtentZ[Slot]};
+    return BoundBox{Center - Extent, Center + Extent};
+}
+
+void Model::UpdateNodeBVH(ModelTransforms& Transforms, bool Rebuild) const
+{
+    const auto&  Cache    = Transforms.NodeBounds;
+    const Uint32 NumBoxes = static_cast<Uint32>(Cache.NodeIds.size());
+    if (NumBoxes == 0)
+    {
+        Transforms.NodeBVH.Clear();
+        return;
+    }
+
+    if (!CompatibleWithTransforms(Transforms) || Cache.CenterX.size() < NumBoxes)
+    {
+        UNEXPECTED("Node bounds are not up to date. Please use the UpdateNodeBounds() method first.");
+        return;
+    }
+
+    std::vector<BoundBox> Boxes(NumBoxes);
+    for (Uint32 Slot = 0; Slot < NumBoxes; ++Slot)
+    {
+        const float3 Center{Cache.CenterX[Slot], Cache.CenterY[Slot], Cache.CenterZ[Slot]};
+        const float3 Extent{Cache.ExtentX[Slot], Cache.ExtentY[Slot], Cache.ExtentZ[Slot]};
+        Boxes[Slot] = BoundBox{Center - Extent, Center + Extent};
+    }
+
+    auto& BVH = Transforms.NodeBVH;
+    if (Rebuild || BVH.GetNumItems() != NumBoxes)
+        BVH.Build(Boxes.data(), NumBoxes, 1);
+    else
+        BVH.Refit(Boxes.data());
+}
+
+bool Model::RayCast(const ModelTransforms& Transforms,
+                    const float3&          Origin,
+                    const float3&          Direction,
+                    float                  MaxDistance,
+                    RayHit&                Hit) const
+{
+    if (MeshBVHs.size() != Meshes.size())
+    {
+        UNEXPECTED("Mesh hierarchies are not available. Please set ModelCreateInfo::BuildCPUBVH when loading the model.");
+        return false;
+    }
+    if (!CompatibleWithTransforms(Transforms))
+    {
+        UNEXPECTED("Incompatible transforms. Please use the ComputeTransforms() method first.");
+        return false;
+    }
+
+    bool Found = false;
+
+    const auto TestNode = [&](Uint32 NodeIndex, float& MaxT) {
+        const auto& N = LinearNodes[NodeIndex];
+        // Skinned vertices are not available on the CPU
+        if (N.pMesh == nullptr || N.pSkin != nullptr)
+            return;
+
+        const auto  MeshIndex    = static_cast<Uint32>(N.pMesh - Meshes.data());
+        const auto& MeshTris     = MeshBVHs[MeshIndex];
+        const auto& GlobalMatrix = Transforms.NodeGlobalMatrices[NodeIndex];
+        for (Uint32 Inst = 0; Inst < std::max(N.NumInstances, Uint32{1}); ++Inst)
+        {
+            // The ray is transformed into the mesh space without normalizing the direction,
+            // so that the ray parameter is the same in both spaces.
+            const auto WorldMatrix = N.NumInstances > 0 ?
+                MultiplyMatrices(InstanceMatrices[N.FirstInstance + Inst], GlobalMatrix) :
+                GlobalMatrix;
+            const auto InvWorldMatrix = WorldMatrix.Inverse();
+            const auto LocalOrigin    = float4{Origin, 1} * InvWorldMatrix;
+            const auto LocalDir       = float4{Direction, 0} * InvWorldMatrix;
+
+            Uint32 TriIdx = 0;
+            float2 Barycentrics;
+            if (!MeshTris.RayCast(float3{LocalOrigin.x, LocalOrigin.y, LocalOrigin.z}, float3{LocalDir.x, LocalDir.y, LocalDir.z}, MaxT, TriIdx, Barycentrics))
+                continue;
+
+            const auto& Tri = MeshTris.Triangles[TriIdx];
+
+            Hit.Distance       = MaxT;
+            Hit.NodeIndex      = NodeIndex;
+            Hit.MeshIndex      = MeshIndex;
+            Hit.PrimitiveIndex = Tri.PrimitiveIndex;
+            Hit.TriangleIndex  = Tri.TriangleIndex;
+            Hit.InstanceIndex  = Inst;
+            Hit.Barycentrics   = Barycentrics;
+            Found              = true;
+        }
+    };
+
+    float MaxT = MaxDistance;
+
+    const auto& Cache = Transforms.NodeBounds;
+    if (!Transforms.NodeBVH.IsEmpty() && Transforms.NodeBVH.GetNumItems() == Cache.NodeIds.size())
+    {
+        Transforms.NodeBVH.RayCast(Origin, Direction, MaxT, [&](Uint32 Slot, float& t) {
+            TestNode(Cache.NodeIds[Slot], t);
+        });
+    }
+    else
+    {
+        for (Uint32 NodeIndex = 0; NodeIndex < LinearNodes.size(); ++NodeIndex)
+            TestNode(NodeIndex, MaxT);
+    }
+
+    if (!Found)
+        return false;
+
+    // Report hits on the flattened geometry for the source primitives
+    if (!FlattenedRanges.empty())
+    {
+        const auto& Prim = Meshes[Hit.MeshIndex].Primitives[Hit.PrimitiveIndex];
+        if (Prim.HasIndices())
+        {
+            const Uint32 Index = Prim.FirstIndex + Hit.TriangleIndex * 3;
+            if (const auto* pRange = FindFlattenedRange(Index))
+            {
+                Hit.NodeIndex      = pRange->NodeIndex;
+                Hit.MeshIndex      = pRange->MeshIndex;
+                Hit.PrimitiveIndex = pRange->PrimitiveIndex;
+                Hit.TriangleIndex  = (Index - pRange->FirstIndex) / 3;
+            }
+        }
+    }
+
+    return true;
+}
+
+Uint32 Model::CullPrimitives(const ModelTransforms&         Transforms,
+                             const ViewFrustum&             Frustum,
+                             std::vector<VisiblePrimitive>& VisiblePrimitives) const
+{
+    VisiblePrimitives.clear();
+
+    const auto&  Cache    = Transforms.NodeBounds;
+    const size_t NumBoxes = Cache.NodeIds.size();
+    if (NumBoxes == 0)
+        return 0;
+
+    if (!CompatibleWithTransforms(Transforms) || Cache.CenterX.size() < AlignUp(NumBoxes, BoundsBatchSize))
+    {
+        UNEXPECTED("Node bounds are not up to date. Please use the UpdateNodeBounds() method first.");
+        return 0;
+    }
+
+    const FrustumPlanesSoA Planes{Frustum};
+
+    const float* pCX = Cache.CenterX.data();
+    const float* pCY = Cache.CenterY.data();
+    const float* pCZ = Cache.CenterZ.data();
+    const float* pEX = Cache.ExtentX.data();
+    const float* pEY = Cache.ExtentY.data();
+    const float* pEZ = Cache.ExtentZ.data();
+
+    const bool HasSkins        = !Transforms.Skins.empty();
+    Uint32     NumVisibleNodes = 0;
+    for (size_t i = 0; i < NumBoxes; i += BoundsBatchSize)
+    {
+        // Process the batch of boxes against one plane at a time. The inner loop has
+        // no dependencies between the lanes, which lets the compiler vectorize it.
+        float MinDist[BoundsBatchSize];
+        for (size_t l = 0; l < BoundsBatchSize; ++l)
+            MinDist[l] = +FLT_MAX;
+
+        for (Uint32 p = 0; p < FrustumPlanesSoA::NumPlanes; ++p)
+        {
+            for (size_t l = 0; l < BoundsBatchSize; ++l)
+            {
+                const size_t b    = i + l;
+                const float  Dist = Planes.Nx[p] * pCX[b] + Planes.Ny[p] * pCY[b] + Planes.Nz[p] * pCZ[b] + Planes.D[p] +
+                    Planes.AbsNx[p] * pEX[b] + Planes.AbsNy[p] * pEY[b] + Planes.AbsNz[p] * pEZ[b];
+                MinDist[l] = std::min(MinDist[l], Dist);
+            }
+        }
+
+        for (size_t l = 0; l < BoundsBatchSize && i + l < NumBoxes; ++l)
+        {
+            if (MinDist[l] < 0)
+                continue;
+
+            ++NumVisibleNodes;
+
+            const auto  NodeIndex  = Cache.NodeIds[i + l];
+            const auto& N          = LinearNodes[NodeIndex];
+            const auto& Primitives = N.pMesh->Primitives;
+
+            // Primitive bounds are not available for skinned, morphed and instanced nodes
+            const bool TestPrimitives = Primitives.size() > 1 && (N.pSkin == nullptr || !HasSkins) && N.NumInstances == 0 && N.pMesh->MorphTargets.empty();
+            for (size_t prim = 0; prim < Primitives.size(); ++prim)
+            {
+                if (TestPrimitives && !Planes.IsBoxVisible(Primitives[prim].BB.Transform(Transforms.NodeGlobalMatrices[NodeIndex])))
+                    continue;
+
+                VisiblePrimitives.push_back({NodeIndex, static_cast<Uint32>(prim)});
+            }
+        }
+    }
+
+    return NumVisibleNodes;
+}
+
+void Model::UpdateMaterialSortKeys()
+{
+    static_assert(Material::SortKeyDepthBits + Material::SortKeyTextureSetBits + Material::SortKeyPipelineBits + 2 == 64, "Sort key bits must add up to 64");
+    static_assert(Material::NumTextureAttributes + 2 <= Material::SortKeyPipelineBits, "Not enough bits for the pipeline variant");
+    static_assert(Material::ALPHA_MODE_NUM_MODES <= 4, "Not enough bits for the alpha mode");
+
+    constexpr Uint32 TextureSetShift = Material::SortKeyDepthBits;
+    constexpr Uint32 PipelineShift   = TextureSetShift + Material::SortKeyTextureSetBits;
+    constexpr Uint32 AlphaModeShift  = PipelineShift + Material::SortKeyPipelineBits;
+    constexpr Uint64 TextureSetMask  = (Uint64{1} << Material::SortKeyTextureSetBits) - 1;
+
+    for (auto& Mat : Materials)
+    {
+        Uint32 PipelineBits = 0;
+        size_t TexSetHash   = 0;
+        for (Uint32 i = 0; i < Material::NumTextureAttributes; ++i)
+        {
+            const auto TexId = Mat.TextureIds[i];
+            if (TexId < 0)
+                continue;
+
+            PipelineBits |= 1u << i;
+
+            // Textures in the same atlas are bound through the same resource. The texture
+            // may not be committed yet, in which case the key is updated when it is.
+            const void* pTexIdentity = nullptr;
+            if (static_cast<size_t>(TexId) < Textures.size())
+            {
+                const auto& TexInfo = Textures[TexId];
+                if (TexInfo.pAtlasSuballocation)
+                    pTexIdentity = TexInfo.pAtlasSuballocation.RawPtr<ITextureAtlasSuballocation>()->GetAtlas();
+                else
+                    pTexIdentity = TexInfo.pTexture.RawPtr<ITexture>();
+            }
+            HashCombine(TexSetHash, i, pTexIdentity);
+        }
+        if (Mat.Attribs.Workflow == Material::PBR_WORKFLOW_SPEC_GLOSS)
+            PipelineBits |= 1u << Material::NumTextureAttributes;
+        if (Mat.DoubleSided)
+            PipelineBits |= 1u << (Material::NumTextureAttributes + 1);
+
+        const auto AlphaMode = static_cast<Uint64>(std::min(std::max(Mat.Attribs.AlphaMode, 0), static_cast<int>(Material::ALPHA_MODE_BLEND)));
+
+        // Fold the hash so that all of its bits affect the texture set id
+        const auto TexSetId = (static_cast<Uint64>(TexSetHash) ^ (static_cast<Uint64>(TexSetHash) >> Material::SortKeyTextureSetBits)) & TextureSetMask;
+
+        Mat.SortKey =
+            (AlphaMode << AlphaModeShift) |
+            (Uint64{PipelineBits} << PipelineShift) |
+            (TexSetId << TextureSetShift);
+    }
+}
+
+void Model::SortPrimitives(const ModelTransforms&        Transforms,
+                           const float3&                 CameraPos,
+                           const VisiblePrimitive*       pPrimitives,
+                           Uint32                        NumPrimitives,
+                           std::vector<SortedPrimitive>& SortedPrimitives) const
+{
+    SortedPrimitives.clear();
+
+    if (!CompatibleWithTransforms(Transforms))
+    {
+        UNEXPECTED("Incompatible transforms. Please use the ComputeTransforms() method first.");
+        return;
+    }
+
+    const auto AddPrimitive = [&](Uint32 NodeIndex, Uint32 PrimIndex) {
+        const auto& N = LinearNodes[NodeIndex];
+        VERIFY_EXPR(N.pMesh != nullptr && PrimIndex < N.pMesh->Primitives.size());
+        const auto& Prim = N.pMesh->Primitives[PrimIndex];
+
+        // Primitive bounds do not account for skinning and instancing, so use the node bounds when they are available
+        BoundBox WorldBB;
+        if ((N.pSkin != nullptr && !Transforms.Skins.empty()) || N.NumInstances > 0)
+            WorldBB = GetNodeBounds(Transforms, NodeIndex);
+        if (WorldBB.Max.x < WorldBB.Min.x)
+            WorldBB = Prim.BB.Transform(Transforms.NodeGlobalMatrices[NodeIndex]);
+
+        const float Dist = length((WorldBB.Min + WorldBB.Max) * 0.5f - CameraPos);
+
+        // The bit pattern of a non-negative float increases monotonically with its value
+        Uint32 DepthBits = 0;
+        if (Dist > 0)
+            memcpy(&DepthBits, &Dist, sizeof(DepthBits));
+
+        const auto& Mat = Materials[Prim.MaterialId];
+        if (Mat.Attribs.AlphaMode == Material::ALPHA_MODE_BLEND)
+        {
+            // Back-to-front
+            DepthBits = ~DepthBits;
+        }
+
+        SortedPrimitive SortedPrim;
+        SortedPrim.SortKey        = Mat.SortKey | DepthBits;
+        SortedPrim.NodeIndex      = NodeIndex;
+        SortedPrim.PrimitiveIndex = PrimIndex;
+        SortedPrimitives.push_back(SortedPrim);
+    };
+
+    if (pPrimitives != nullptr)
+    {
+        SortedPrimitives.reserve(NumPrimitives);
+        for (Uint32 i = 0; i < NumPrimitives; ++i)
+            AddPrimitive(pPrimitives[i].NodeIndex, pPrimitives[i].PrimitiveIndex);
+    }
+    else
+    {
+        for (const auto& N : LinearNodes)
+        {
+            if (N.pMesh == nullptr)
+                continue;
+            for (size_t prim = 0; prim < N.pMesh->Primitives.size(); ++prim)
+                AddPrimitive(static_cast<Uint32>(N.Index), static_cast<Uint32>(prim));
+        }
+    }
+
+    // Break ties by node and primitive index to keep the order stable between frames
+    std::sort(SortedPrimitives.begin(), SortedPrimitives.end(), [](const SortedPrimitive& P0, const SortedPrimitive& P1) {
+        if (P0.SortKey != P1.SortKey)
+            return P0.SortKey < P1.SortKey;
+        if (P0.NodeIndex != P1.NodeIndex)
+            return P0.NodeIndex < P1.NodeIndex;
+        return P0.PrimitiveIndex < P1.PrimitiveIndex;
+    });
+}
+
+void Model::UpdateAnimation(Uint32 index, float time, ModelTransforms& Transforms) const
+{
+    ModelTransforms* pTransforms = &Transforms;
+    UpdateAnimation(index, &pTransforms, &time, 1);
+}
+
+namespace
+{
+
+static constexpr float BakedRotationScale = 1.41421356f; // sqrt(2)
+static constexpr float BakedMaxValue15    = 32767.f;
+static constexpr float BakedMaxValue16    = 65535.f;
+
+// Encodes the quaternion with the smallest-three encoding.
+inline void EncodeBakedRotation(const QuaternionF& Rotation, Uint16* pDst)
+{
+    const float q[] = {Rotation.q.x, Rotation.q.y, Rotation.q.z, Rotation.q.w};
+
+    Uint32 Largest = 0;
+    for (Uint32 c = 1; c < 4; ++c)
+    {
+        if (std::abs(q[c]) > std::abs(q[Largest]))
+            Largest = c;
+    }
+    // q and -q represent the same rotation, so the largest component can always be made positive
+    const float Sign = q[Largest] < 0 ? -1.f : 1.f;
+
+    for (Uint32 c = 0, i = 0; c < 4; ++c)
+    {
+        if (c == Largest)
+            continue;
+        // The remaining components are in [-1/sqrt(2), 1/sqrt(2)] range
+        const float Val = clamp(q[c] * Sign * BakedRotationScale * 0.5f + 0.5f, 0.f, 1.f);
+        pDst[i++]       = static_cast<Uint16>(Val * BakedMaxValue15 + 0.5f);
+    }
+    pDst[0] |= static_cast<Uint16>((Largest & 1u) << 15u);
+    pDst[1] |= static_cast<Uint16>((Largest >> 1u) << 15u);
+}
+
+inline float4 DecodeBakedRotation(const Uint16* pSrc)
+{
+    const Uint32 Largest = (pSrc[0] >> 15u) | ((pSrc[1] >> 15u) << 1u);
+
+    float  q[4];
+    float  SqrSum = 0;
+    Uint32 i      = 0;
+    for (Uint32 c = 0; c < 4; ++c)
+    {
+        if (c == Largest)
+            continue;
+        const float Val = static_cast<float>(pSrc[i++] & 0x7FFFu) / BakedMaxValue15;
+        q[c]            = (Val * 2.f - 1.f) / BakedRotationScale;
+        SqrSum += q[c] * q[c];
+    }
+    q[Largest] = std::sqrt(std::max(1.f - SqrSum, 0.f));
+
+    return float4{q[0], q[1], q[2], q[3]};
+}
+
+inline void EncodeBakedVector(const float3& Value, const BakedAnimation::Track& Track, Uint16* pDst)
+{
+    for (Uint32 c = 0; c < 3; ++c)
+    {
+        const float Val = Track.Range[c] > 0 ? clamp((Value[c] - Track.Min[c]) / Track.Range[c], 0.f, 1.f) : 0.f;
+        pDst[c]         = static_cast<Uint16>(Val * BakedMaxValue16 + 0.5f);
+    }
+}
+
+inline float3 DecodeBakedVector(const Uint16* pSrc, const BakedAnimation::Track& Track)
+{
+    return float3{
+        Track.Min.x + Track.Range.x * (static_cast<float>(pSrc[0]) / BakedMaxValue16),
+        Track.Min.y + Track.Range.y * (static_cast<float>(pSrc[1]) / BakedMaxValue16),
+        Track.Min.z + Track.Range.z * (static_cast<float>(pSrc[2]) / BakedMaxValue16),
+    };
+}
+
+// Evaluates all tracks of the baked animation at the given time. If pNodeDepths is not null,
+// the tracks of the nodes deeper than MaxNodeDepth are skipped.
+void ApplyBakedAnimation(const Animation&                                   animation,
+                         float                                              time,
+                         std::vector<ModelTransforms::AnimationTransforms>& NodeAnimations,
+                         const Uint8*                                       pNodeDepths  = nullptr,
+                         Uint32                                             MaxNodeDepth = ~0u)
+{
+    const auto& Baked = animation.Baked;
+    VERIFY_EXPR(Baked.IsValid());
+
+    const float  Frame  = std::max(time - animation.Start, 0.f) * Baked.SampleRate;
+    const Uint32 Frame0 = std::min(static_cast<Uint32>(Frame), Baked.NumSamples - 1);
+    const Uint32 Frame1 = std::min(Frame0 + 1, Baked.NumSamples - 1);
+    const float  u      = std::min(Frame - static_cast<float>(Frame0), 1.f);
+
+    const auto     FrameStride = Baked.GetFrameStride();
+    const Uint16*  pFrame0     = Baked.Data.data() + Frame0 * FrameStride;
+    const Uint16*  pFrame1     = Baked.Data.data() + Frame1 * FrameStride;
+    constexpr auto Stride      = BakedAnimation::ValuesPerTrack;
+    for (size_t t = 0; t < Baked.Tracks.size(); ++t, pFrame0 += Stride, pFrame1 += Stride)
+    {
+        const auto& Track = Baked.Tracks[t];
+        if (pNodeDepths != nullptr && pNodeDepths[Track.NodeIndex] > MaxNodeDepth)
+            continue;
+
+        auto&       NodeAnim = NodeAnimations[Track.NodeIndex];
+        const float w        = Track.Step ? 0.f : u;
+        switch (Track.PathType)
+        {
+            case AnimationChannel::PATH_TYPE::TRANSLATION:
+                NodeAnim.Translation = lerp(DecodeBakedVector(pFrame0, Track), DecodeBakedVector(pFrame1, Track), w);
+                break;
+
+            case AnimationChannel::PATH_TYPE::SCALE:
+                NodeAnim.Scale = lerp(DecodeBakedVector(pFrame0, Track), DecodeBakedVector(pFrame1, Track), w);
+                break;
+
+            case AnimationChannel::PATH_TYPE::ROTATION:
+            {
+                const auto q0 = DecodeBakedRotation(pFrame0);
+                auto       q1 = DecodeBakedRotation(pFrame1);
+                // Take the shortest path
+                if (dot(q0, q1) < 0)
+                    q1 = -q1;
+
+                const auto q = normalize(lerp(q0, q1, w));
+
+                NodeAnim.Rotation.q = q;
+                break;
+            }
+
+            default:
+                UNEXPECTED("Unexpected baked track type");
+        }
+    }
+}
+
+} // namespace
+
+void Model::UpdateAnimation(Uint32 index, ModelTransforms* const* ppTransforms, const float* pTimes, Uint32 NumInstances) const
+{
+    if (index >= Animations.size())
+    {
+        LOG_WARNING_MESSAGE("No animation with index ", index);
+        return;
+    }
+    const auto& animation = Animations[index];
+
+    for (Uint32 inst = 0; inst < NumInstances; ++inst)
+    {
+        auto& Transforms = *ppTransforms[inst];
+
+        if (Transforms.NodeAnimations.size() != LinearNodes.size())
+            Transforms.NodeAnimations.resize(LinearNodes.size());
+        VERIFY_EXPR(Transforms.NodeAnimations.size() == Transforms.NodeLocalMatrices.size());
+
+        if (Transforms.CursorAnimationIndex != static_cast<Int32>(index) ||
+            Transforms.SamplerKeyFrameCursors.size() != animation.Samplers.size())
+        {
+            // Reset cursors when switching to a different animation
+            Transforms.CursorAnimationIndex = static_cast<Int32>(index);
+            Transforms.SamplerKeyFrameCursors.assign(animation.Samplers.size(), 0);
+        }
+
+        for (size_t i = 0; i < LinearNodes.size(); ++i)
+        {
+            const auto& N = LinearNodes[i];
+            auto&       A = Transforms.NodeAnimations[i];
+
+            // NB: not each component has to be animated (e.g. 'Fox' test model)
+            A.Translation = N.Translation;
+            A.Rotation    = N.Rotation;
+            A.Scale       = N.Scale;
+        }
+
+        Transforms.MorphWeights = DefaultMorphWeights;
+    }
+
+    if (animation.Baked.IsValid())
+    {
+        for (Uint32 inst = 0; inst < NumInstances; ++inst)
+        {
+            auto&       Transforms = *ppTransforms[inst];
+            const float time       = clamp(pTimes[inst], animation.Start, animation.End);
+            ApplyBakedAnimation(animation, time, Transforms.NodeAnimations);
+        }
+    }
+    else
+    {
+        // Evaluate each channel for all instances before moving to the next one
+        for (auto& channel : animation.Channels)
+        {
+            const auto& sampler = animation.Samplers[channel.SamplerIndex];
+            if (channel.PathType == AnimationChannel::PATH_TYPE::WEIGHTS || sampler.Inputs.size() > sampler.OutputsVec4.size())
+            {
+                continue;
+            }
+
+            for (Uint32 inst = 0; inst < NumInstances; ++inst)
+            {
+                auto&       Transforms = *ppTransforms[inst];
+                const float time       = clamp(pTimes[inst], animation.Start, animation.End);
+                ApplyAnimationChannel(channel, sampler, time,
+                                      Transforms.SamplerKeyFrameCursors[channel.SamplerIndex],
+                                      Transforms.NodeAnimations[channel.pNode->Index]);
+            }
+        }
+    }
+
+    for (Uint32 inst = 0; inst < NumInstances; ++inst)
+    {
+        auto& Transforms = *ppTransforms[inst];
+        for (size_t i = 0; i < LinearNodes.size(); ++i)
+        {
+            const auto& N = LinearNodes[i];
+            const auto& A = Transforms.NodeAnimations[i];
+
+            Transforms.NodeLocalMatrices[i] = ComputeNodeLocalMatrix(A.Scale, A.Rotation, A.Translation, N.Matrix);
+        }
+
+        // Morph target weights are never baked
+        EvaluateMorphWeights(animation, pTimes[inst], Transforms.SamplerKeyFrameCursors.data(), Transforms.MorphWeights);
+    }
+}
+
+void Model::BakeAnimations(float SampleRate, bool ReleaseKeyFrames)
+{
+    DEV_CHECK_ERR(SampleRate > 0, "Sample rate must be positive");
+    if (!(SampleRate > 0))
+        return;
+
+    // Limit the number of frames to protect against malformed time ranges
+    static constexpr Uint32 MaxSamples = 1u << 20u;
+
+    std::vector<Uint32>                               KeyFrameCursors;
+    std::vector<ModelTransforms::AnimationTransforms> TrackValues;
+    for (auto& animation : Animations)
+    {
+        auto& Baked = animation.Baked;
+        Baked       = {};
+
+        for (const auto& channel : animation.Channels)
+        {
+            const auto& sampler = animation.Samplers[channel.SamplerIndex];
+            if (channel.PathType == AnimationChannel::PATH_TYPE::WEIGHTS || sampler.Inputs.size() > sampler.OutputsVec4.size())
+                continue;
+
+            BakedAnimation::Track Track;
+            Track.NodeIndex = static_cast<Uint32>(channel.pNode->Index);
+            Track.PathType  = channel.PathType;
+            Track.Step      = sampler.Interpolation == AnimationSampler::INTERPOLATION_TYPE::STEP;
+            Baked.Tracks.push_back(Track);
+        }
+        if (Baked.Tracks.empty())
+            continue;
+
+        const double Duration  = animation.End > animation.Start ? static_cast<double>(animation.End) - animation.Start : 0.0;
+        const auto   NumFrames = static_cast<Uint32>(std::min(std::ceil(Duration * SampleRate), double{MaxSamples - 1})) + 1u;
+        // Adjust the rate so that the last frame is exactly at the end of the animation
+        Baked.SampleRate = NumFrames > 1 ? static_cast<float>((NumFrames - 1) / Duration) : 0.f;
+        Baked.NumSamples = NumFrames;
+
+        // Evaluate the channels at every frame
+        const size_t NumTracks = Baked.Tracks.size();
+        TrackValues.resize(size_t{NumFrames} * NumTracks);
+        KeyFrameCursors.assign(animation.Samplers.size(), 0);
+        for (Uint32 f = 0; f < NumFrames; ++f)
         {
-            const auto& N = LinearNodes[i];
-            VERIFY_EXPR(N.Index == static_cast<int>(i));
-            if (N.pMesh != nullptr && N.pMesh->IsValidBB())
+            const float time = f + 1 < NumFrames ?
+                static_cast<float>(animation.Start + f / static_cast<double>(Baked.SampleRate)) :
+                (NumFrames > 1 ? animation.End : animation.Start);
+
+            size_t t = 0;
+            for (const auto& channel : animation.Channels)
             {
-                const auto& GlobalMatrix = Transforms.NodeGlobalMatrices[i];
-                const auto  NodeAABB     = N.pMesh->BB.Transform(GlobalMatrix);
+                const auto& sampler = animation.Samplers[channel.SamplerIndex];
+                if (channel.PathType == AnimationChannel::PATH_TYPE::WEIGHTS || sampler.Inputs.size() > sampler.OutputsVec4.size())
+                    continue;
+
+                const auto& N     = *channel.pNode;
+                auto&       Value = TrackValues[f * NumTracks + t];
+                Value.Translation = N.Translation;
+                Value.Rotation    = N.Rotation;
+                Value.Scale       = N.Scale;
+                ApplyAnimationChannel(channel, sampler, time, KeyFrameCursors[channel.SamplerIndex], Value);
+                ++t;
+            }
+            VERIFY_EXPR(t == NumTracks);
+        }
 
-                ModelAABB.Min = std::min(ModelAABB.Min, NodeAABB.Min);
-                ModelAABB.Max = std::max(ModelAABB.Max, NodeAABB.Max);
+        // Compute the quantization ranges
+        for (size_t t = 0; t < NumTracks; ++t)
+        {
+            auto& Track = Baked.Tracks[t];
+            if (Track.PathType == AnimationChannel::PATH_TYPE::ROTATION)
+                continue;
+
+            float3 Min{+FLT_MAX, +FLT_MAX, +FLT_MAX};
+            float3 Max{-FLT_MAX, -FLT_MAX, -FLT_MAX};
+            for (Uint32 f = 0; f < NumFrames; ++f)
+            {
+                const auto& Value = TrackValues[f * NumTracks + t];
+                const auto& Vec   = Track.PathType == AnimationChannel::PATH_TYPE::TRANSLATION ? Value.Translation : Value.Scale;
+
+                Min = std::min(Min, Vec);
+                Max = std::max(Max, Vec);
+            }
+            Track.Min   = Min;
+            Track.Range = Max - Min;
+        }
+
+        // Quantize the values
+        Baked.Data.resize(size_t{NumFrames} * Baked.GetFrameStride());
+        Uint16* pDst = Baked.Data.data();
+        for (Uint32 f = 0; f < NumFrames; ++f)
+        {
+            for (size_t t = 0; t < NumTracks; ++t, pDst += BakedAnimation::ValuesPerTrack)
+            {
+                const auto& Track = Baked.Tracks[t];
+                const auto& Value = TrackValues[f * NumTracks + t];
+                switch (Track.PathType)
+                {
+                    case AnimationChannel::PATH_TYPE::TRANSLATION:
+                        EncodeBakedVector(Value.Translation, Track, pDst);
+                        break;
+
+                    case AnimationChannel::PATH_TYPE::SCALE:
+                        EncodeBakedVector(Value.Scale, Track, pDst);
+                        break;
+
+                    case AnimationChannel::PATH_TYPE::ROTATION:
+                        EncodeBakedRotation(normalize(Value.Rotation), pDst);
+                        break;
+
+                    default:
+                        UNEXPECTED("Unexpected baked track type");
+                }
+            }
+        }
+
+        if (ReleaseKeyFrames)
+        {
+            for (auto& sampler : animation.Samplers)
+            {
+                // Morph target weights samplers are still needed
+                if (!sampler.OutputWeights.empty())
+                    continue;
+                std::vector<float>{}.swap(sampler.Inputs);
+                std::vector<float4>{}.swap(sampler.OutputsVec4);
             }
         }
     }
-    else
+}
+
+namespace
+{
+
+// Initializes the pose with the node rest transforms.
+void InitRestPose(const std::vector<Node>& LinearNodes, std::vector<ModelTransforms::AnimationTransforms>& Pose)
+{
+    for (size_t i = 0; i < LinearNodes.size(); ++i)
     {
-        UNEXPECTED("Incompatible transforms. Please use the ComputeTransforms() method first.");
-    }
+        const auto& N = LinearNodes[i];
+        auto&       A = Pose[i];
 
-    return ModelAABB;
+        A.Translation = N.Translation;
+        A.Rotation    = N.Rotation;
+        A.Scale       = N.Scale;
+    }
 }
 
-static void UpdateNodeGlobalTransform(const Node& node, const float4x4& ParentMatrix, ModelTransforms& Transforms)
+// Evaluates the animation channels into the pose and the morph target weights.
+// If pCursors is null, key frames are searched from the beginning.
+void EvaluateAnimation(const Animation&                                   animation,
+                       float                                              time,
+                       Uint32*                                            pCursors,
+                       std::vector<ModelTransforms::AnimationTransforms>& Pose,
+                       std::vector<float>&                                MorphWeights,
+                       const Uint8*                                       pNodeDepths  = nullptr,
+                       Uint32                                             MaxNodeDepth = ~0u)
 {
-    const auto& LocalMat  = Transforms.NodeLocalMatrices[node.Index];
-    auto&       GlobalMat = Transforms.NodeGlobalMatrices[node.Index];
-    GlobalMat             = LocalMat * ParentMatrix;
-    for (auto* pChild : node.Children)
+    time = clamp(time, animation.Start, animation.End);
+    EvaluateMorphWeights(animation, time, pCursors, MorphWeights);
+    if (animation.Baked.IsValid())
     {
-        UpdateNodeGlobalTransform(*pChild, GlobalMat, Transforms);
+        ApplyBakedAnimation(animation, time, Pose, pNodeDepths, MaxNodeDepth);
+        return;
+    }
+
+    for (const auto& channel : animation.Channels)
+    {
+        const auto& sampler = animation.Samplers[channel.SamplerIndex];
+        if (channel.PathType == AnimationChannel::PATH_TYPE::WEIGHTS || sampler.Inputs.size() > sampler.OutputsVec4.size())
+            continue;
+        if (pNodeDepths != nullptr && pNodeDepths[channel.pNode->Index] > MaxNodeDepth)
+            continue;
+
+        Uint32  Cursor  = 0;
+        Uint32& rCursor = pCursors != nullptr ? pCursors[channel.SamplerIndex] : Cursor;
+        ApplyAnimationChannel(channel, sampler, time, rCursor, Pose[channel.pNode->Index]);
     }
 }
 
-inline float4x4 ComputeNodeLocalMatrix(const float3&      Scale,
-                                       const QuaternionF& Rotation,
-                                       const float3&      Translation,
-                                       const float4x4&    Matrix)
+// Returns the Hamilton product a * b of the quaternions stored as (x, y, z, w).
+inline float4 MultiplyQuaternions(const float4& a, const float4& b)
 {
-    // Translation, rotation, and scale properties and local space transformation are
-    // mutually exclusive in GLTF.
+    return float4{
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+    };
+}
 
-    // LocalMatrix = S * R * T * M
-    float4x4 LocalMatrix = Matrix;
+} // namespace
 
-    if (Translation != float3{})
-        LocalMatrix = float4x4::Translation(Translation) * LocalMatrix;
+void Model::ComputeBlendedTransforms(ModelTransforms&      Transforms,
+                                     const AnimationLayer* pLayers,
+                                     Uint32                NumLayers,
+                                     const float4x4&       RootTransform) const
+{
+    DEV_CHECK_ERR(pLayers != nullptr || NumLayers == 0, "pLayers must not be null");
+
+    const auto NumNodes = LinearNodes.size();
+    Transforms.NodeGlobalMatrices.resize(NumNodes);
+    Transforms.NodeLocalMatrices.resize(NumNodes);
+    Transforms.NodeAnimations.resize(NumNodes);
+    Transforms.Skins.resize(SkinTransformsCount);
+
+    auto& Scratch = Transforms.Blend;
+    Scratch.LayerPose.resize(NumNodes);
+    Scratch.ReferencePose.resize(NumNodes);
+    if (Scratch.Layers.size() < NumLayers)
+        Scratch.Layers.resize(NumLayers);
+
+    // Returns key frame cursors of the layer, or null if the animation index is invalid
+    auto GetLayerCursors = [&](Uint32 LayerIdx) -> ModelTransforms::BlendScratch::LayerCursors* {
+        const auto& Layer = pLayers[LayerIdx];
+        if (Layer.AnimationIndex >= Animations.size())
+        {
+            LOG_WARNING_MESSAGE("No animation with index ", Layer.AnimationIndex);
+            return nullptr;
+        }
 
-    if (Rotation != QuaternionF{})
-        LocalMatrix = Rotation.ToMatrix() * LocalMatrix;
+        auto&       Cursors   = Scratch.Layers[LayerIdx];
+        const auto& animation = Animations[Layer.AnimationIndex];
+        if (Cursors.AnimationIndex != static_cast<Int32>(Layer.AnimationIndex) ||
+            Cursors.SamplerKeyFrameCursors.size() != animation.Samplers.size())
+        {
+            Cursors.AnimationIndex = static_cast<Int32>(Layer.AnimationIndex);
+            Cursors.SamplerKeyFrameCursors.assign(animation.Samplers.size(), 0);
+        }
+        return &Cursors;
+    };
 
-    if (Scale != float3{1, 1, 1})
-        LocalMatrix = float4x4::Scale(Scale) * LocalMatrix;
+    auto& Result        = Transforms.NodeAnimations;
+    auto& ResultWeights = Transforms.MorphWeights;
+    ResultWeights.resize(DefaultMorphWeights.size());
 
-    return LocalMatrix;
-}
+    // Blend layers
+    float TotalWeight = 0;
+    for (Uint32 l = 0; l < NumLayers; ++l)
+    {
+        const auto& Layer = pLayers[l];
+        if (Layer.BlendMode != ANIMATION_BLEND_MODE_BLEND || !(Layer.Weight > 0))
+            continue;
 
-inline float4x4 ComputeNodeLocalMatrix(const Node& N)
-{
-    return ComputeNodeLocalMatrix(N.Scale, N.Rotation, N.Translation, N.Matrix);
-}
+        auto* pCursors = GetLayerCursors(l);
+        if (pCursors == nullptr)
+            continue;
 
-void Model::ComputeTransforms(ModelTransforms& Transforms,
-                              const float4x4&  RootTransform,
-                              Int32            AnimationIndex,
-                              float            Time) const
-{
-    Transforms.NodeGlobalMatrices.resize(LinearNodes.size());
-    Transforms.NodeLocalMatrices.resize(LinearNodes.size());
+        auto& Pose        = Scratch.LayerPose;
+        auto& PoseWeights = Scratch.LayerMorphWeights;
+        InitRestPose(LinearNodes, Pose);
+        PoseWeights = DefaultMorphWeights;
+        EvaluateAnimation(Animations[Layer.AnimationIndex], Layer.Time, pCursors->SamplerKeyFrameCursors.data(), Pose, PoseWeights);
 
-    // Update node animation
-    if (AnimationIndex >= 0)
+        if (TotalWeight == 0)
+        {
+            for (size_t i = 0; i < NumNodes; ++i)
+            {
+                Result[i].Translation = Pose[i].Translation * Layer.Weight;
+                Result[i].Scale       = Pose[i].Scale * Layer.Weight;
+                Result[i].Rotation.q  = Pose[i].Rotation.q * Layer.Weight;
+            }
+            for (size_t w = 0; w < PoseWeights.size(); ++w)
+                ResultWeights[w] = PoseWeights[w] * Layer.Weight;
+        }
+        else
+        {
+            for (size_t i = 0; i < NumNodes; ++i)
+            {
+                Result[i].Translation += Pose[i].Translation * Layer.Weight;
+                Result[i].Scale += Pose[i].Scale * Layer.Weight;
+                // Accumulate the rotation in the same hemisphere as the current result
+                const float Sign = dot(Result[i].Rotation.q, Pose[i].Rotation.q) < 0 ? -1.f : 1.f;
+                Result[i].Rotation.q += Pose[i].Rotation.q * (Layer.Weight * Sign);
+            }
+            for (size_t w = 0; w < PoseWeights.size(); ++w)
+                ResultWeights[w] += PoseWeights[w] * Layer.Weight;
+        }
+        TotalWeight += Layer.Weight;
+    }
+
+    if (TotalWeight > 0)
     {
-        Transforms.Skins.resize(SkinTransformsCount);
-        UpdateAnimation(AnimationIndex, Time, Transforms);
+        const float InvWeight = 1.f / TotalWeight;
+        for (auto& A : Result)
+        {
+            A.Translation *= InvWeight;
+            A.Scale *= InvWeight;
+            A.Rotation.q = normalize(A.Rotation.q);
+        }
+        for (auto& w : ResultWeights)
+            w *= InvWeight;
     }
     else
     {
-        Transforms.Skins.clear();
-        for (size_t i = 0; i < LinearNodes.size(); ++i)
-            Transforms.NodeLocalMatrices[i] = ComputeNodeLocalMatrix(LinearNodes[i]);
+        InitRestPose(LinearNodes, Result);
+        ResultWeights = DefaultMorphWeights;
     }
 
-    // Compute global transforms
-    for (auto* pRoot : RootNodes)
-        UpdateNodeGlobalTransform(*pRoot, RootTransform, Transforms);
-
-    // Update join matrices
-    if (!Transforms.Skins.empty())
+    // Additive layers
+    for (Uint32 l = 0; l < NumLayers; ++l)
     {
-        for (auto& node : LinearNodes)
+        const auto& Layer = pLayers[l];
+        if (Layer.BlendMode != ANIMATION_BLEND_MODE_ADDITIVE || Layer.Weight == 0)
+            continue;
+
+        auto* pCursors = GetLayerCursors(l);
+        if (pCursors == nullptr)
+            continue;
+
+        const auto& animation = Animations[Layer.AnimationIndex];
+
+        auto& Pose        = Scratch.LayerPose;
+        auto& Ref         = Scratch.ReferencePose;
+        auto& PoseWeights = Scratch.LayerMorphWeights;
+        auto& RefWeights  = Scratch.ReferenceMorphWeights;
+        InitRestPose(LinearNodes, Pose);
+        InitRestPose(LinearNodes, Ref);
+        PoseWeights = DefaultMorphWeights;
+        RefWeights  = DefaultMorphWeights;
+        EvaluateAnimation(animation, Layer.Time, pCursors->SamplerKeyFrameCursors.data(), Pose, PoseWeights);
+        EvaluateAnimation(animation, animation.Start, nullptr, Ref, RefWeights);
+
+        const float w = Layer.Weight;
+        for (size_t i = 0; i < ResultWeights.size(); ++i)
+            ResultWeights[i] += (PoseWeights[i] - RefWeights[i]) * w;
+        for (size_t i = 0; i < NumNodes; ++i)
         {
-            auto* pMesh = node.pMesh;
-            auto* pSkin = node.pSkin;
-            if (pMesh == nullptr || pSkin == nullptr)
-                continue;
+            auto& A = Result[i];
 
-            const auto& NodeGlobalMat = Transforms.NodeGlobalMatrices[node.Index];
-            VERIFY(node.SkinTransformsIndex < SkinTransformsCount,
-                   "Skin transform index (", node.SkinTransformsIndex, ") exceeds the skin transform count in this mesh (", SkinTransformsCount,
-                   "). This appears to be a bug.");
-            auto& JointMatrices = Transforms.Skins[node.SkinTransformsIndex].JointMatrices;
-            if (JointMatrices.size() != pSkin->Joints.size())
-                JointMatrices.resize(pSkin->Joints.size());
+            A.Translation += (Pose[i].Translation - Ref[i].Translation) * w;
 
-            const auto InverseTransform = NodeGlobalMat.Inverse();
-            for (size_t i = 0; i < pSkin->Joints.size(); i++)
+            for (Uint32 c = 0; c < 3; ++c)
             {
-                const auto* JointNode          = pSkin->Joints[i];
-                const auto& JointNodeGlobalMat = Transforms.NodeGlobalMatrices[JointNode->Index];
-                JointMatrices[i] =
-                    pSkin->InverseBindMatrices[i] * JointNodeGlobalMat * InverseTransform;
+                const float RefScale = Ref[i].Scale[c];
+                if (RefScale != 0)
+                    A.Scale[c] *= 1.f + (Pose[i].Scale[c] / RefScale - 1.f) * w;
             }
+
+            // Delta = inverse(Ref) * Pose, applied in the node's local space: Result = Result * Delta
+            const float4 RefInv{-Ref[i].Rotation.q.x, -Ref[i].Rotation.q.y, -Ref[i].Rotation.q.z, Ref[i].Rotation.q.w};
+
+            float4 Delta = MultiplyQuaternions(RefInv, Pose[i].Rotation.q);
+            if (Delta.w < 0)
+                Delta = -Delta;
+            Delta = normalize(lerp(float4{0, 0, 0, 1}, Delta, w));
+
+            A.Rotation.q = normalize(MultiplyQuaternions(A.Rotation.q, Delta));
         }
     }
+
+    for (size_t i = 0; i < NumNodes; ++i)
+    {
+        const auto& N = LinearNodes[i];
+        const auto& A = Result[i];
+
+        Transforms.NodeLocalMatrices[i] = ComputeNodeLocalMatrix(A.Scale, A.Rotation, A.Translation, N.Matrix);
+    }
+
+    ComputeGlobalTransforms(Transforms, RootTransform);
 }
 
-bool Model::CompatibleWithTransforms(const ModelTransforms& Transforms) const
+bool Model::UpdateTransformsIncremental(ModelTransforms& Transforms, const float4x4& RootTransform, Int32 AnimationIndex, float Time) const
 {
-    return (Transforms.NodeLocalMatrices.size() == LinearNodes.size() &&
-            Transforms.NodeGlobalMatrices.size() == LinearNodes.size());
+    auto&      Incremental = Transforms.Incremental;
+    const auto NumNodes    = LinearNodes.size();
+    if (Incremental.AnimationIndex == -2 ||
+        Incremental.AnimationIndex != std::max(AnimationIndex, -1) ||
+        Incremental.NodeChanged.size() != NumNodes ||
+        !CompatibleWithTransforms(Transforms) ||
+        (NodeTransformOrder.empty() && !RootNodes.empty()))
+        return false;
+
+    const bool IsAnimated = AnimationIndex >= 0;
+    if (IsAnimated && (Transforms.Skins.size() != SkinTransformsCount || Transforms.NodeAnimations.size() != NumNodes))
+        return false;
+
+    const bool RootChanged = !(Incremental.RootTransform == RootTransform);
+
+    auto& NodeChanged = Incremental.NodeChanged;
+    std::fill(NodeChanged.begin(), NodeChanged.end(), Uint8{0});
+
+    if (IsAnimated)
+    {
+        const auto& animation = Animations[AnimationIndex];
+
+        if (Transforms.CursorAnimationIndex != AnimationIndex ||
+            Transforms.SamplerKeyFrameCursors.size() != animation.Samplers.size())
+        {
+            Transforms.CursorAnimationIndex = AnimationIndex;
+            Transforms.SamplerKeyFrameCursors.assign(animation.Samplers.size(), 0);
+        }
+
+        // Reset the animated nodes to the rest pose. Other nodes keep the rest pose
+        // from the previous update.
+        for (const auto& channel : animation.Channels)
+        {
+            const auto& N = *channel.pNode;
+            auto&       A = Transforms.NodeAnimations[N.Index];
+
+            A.Translation        = N.Translation;
+            A.Rotation           = N.Rotation;
+            A.Scale              = N.Scale;
+            NodeChanged[N.Index] = 1;
+        }
+
+        // Weights do not affect the node matrices
+        Transforms.MorphWeights = DefaultMorphWeights;
+        EvaluateAnimation(animation, Time, Transforms.SamplerKeyFrameCursors.data(), Transforms.NodeAnimations, Transforms.MorphWeights);
+
+        for (size_t i = 0; i < NumNodes; ++i)
+        {
+            if (!NodeChanged[i])
+                continue;
+
+            const auto& N        = LinearNodes[i];
+            const auto& A        = Transforms.NodeAnimations[i];
+            const auto  LocalMat = ComputeNodeLocalMatrix(A.Scale, A.Rotation, A.Translation, N.Matrix);
+            if (LocalMat == Transforms.NodeLocalMatrices[i])
+            {
+                NodeChanged[i] = 0;
+                continue;
+            }
+            Transforms.NodeLocalMatrices[i] = LocalMat;
+        }
+    }
+
+    // Parents always precede their children, so a changed parent is propagated in a single pass
+    for (const auto& Entry : NodeTransformOrder)
+    {
+        const bool ParentChanged = Entry.ParentIndex >= 0 ? NodeChanged[Entry.ParentIndex] != 0 : RootChanged;
+        if (!ParentChanged && !NodeChanged[Entry.NodeIndex])
+            continue;
+
+        const auto& ParentMatrix = Entry.ParentIndex >= 0 ? Transforms.NodeGlobalMatrices[Entry.ParentIndex] : RootTransform;
+
+        Transforms.NodeGlobalMatrices[Entry.NodeIndex] = MultiplyMatrices(Transforms.NodeLocalMatrices[Entry.NodeIndex], ParentMatrix);
+        NodeChanged[Entry.NodeIndex]                   = 1;
+    }
+
+    if (IsAnimated)
+        UpdateJointMatrices(Transforms, NodeChanged.data());
+
+    Incremental.RootTransform = RootTransform;
+    return true;
 }
 
-void Model::UpdateAnimation(Uint32 index, float time, ModelTransforms& Transforms) const
+void Model::ComputeTransforms(ModelTransforms&    Transforms,
+                              const float4x4&     RootTransform,
+                              Int32               AnimationIndex,
+                              float               Time,
+                              const AnimationLOD& LOD) const
 {
-    if (index >= Animations.size())
+    if (AnimationIndex < 0 || static_cast<size_t>(AnimationIndex) >= Animations.size())
     {
-        LOG_WARNING_MESSAGE("No animation with index ", index);
+        Transforms.AnimLOD.AnimationIndex = -1;
+        ComputeTransforms(Transforms, RootTransform, AnimationIndex, Time);
         return;
     }
-    const auto& animation = Animations[index];
-
-    time = clamp(time, animation.Start, animation.End);
 
-    if (Transforms.NodeAnimations.size() != LinearNodes.size())
-        Transforms.NodeAnimations.resize(LinearNodes.size());
-    VERIFY_EXPR(Transforms.NodeAnimations.size() == Transforms.NodeLocalMatrices.size());
+    const auto& animation = Animations[AnimationIndex];
+    const auto  NumNodes  = LinearNodes.size();
+    Transforms.NodeGlobalMatrices.resize(NumNodes);
+    Transforms.NodeLocalMatrices.resize(NumNodes);
+    Transforms.NodeAnimations.resize(NumNodes);
+    Transforms.Skins.resize(SkinTransformsCount);
 
-    for (size_t i = 0; i < LinearNodes.size(); ++i)
+    if (Transforms.CursorAnimationIndex != AnimationIndex ||
+        Transforms.SamplerKeyFrameCursors.size() != animation.Samplers.size())
     {
-        const auto& N = LinearNodes[i];
-        auto&       A = Transforms.NodeAnimations[i];
-
-        // NB: not each component has to be animated (e.g. 'Fox' test model)
-        A.Translation = N.Translation;
-        A.Rotation    = N.Rotation;
-        A.Scale       = N.Scale;
+        Transforms.CursorAnimationIndex = AnimationIndex;
+        Transforms.SamplerKeyFrameCursors.assign(animation.Samplers.size(), 0);
     }
 
-    for (auto& channel : animation.Channels)
+    // Node depths are not available if the model was not created by the model builder
+    const Uint8* pNodeDepths = NodeDepths.size() == NumNodes ? NodeDepths.data() : nullptr;
+
+    auto EvaluatePose = [&](float PoseTime, std::vector<ModelTransforms::AnimationTransforms>& Pose, std::vector<float>& Weights) {
+        InitRestPose(LinearNodes, Pose);
+        Weights = DefaultMorphWeights;
+        EvaluateAnimation(animation, PoseTime, Transforms.SamplerKeyFrameCursors.data(), Pose, Weights, pNodeDepths, LOD.MaxNodeDepth);
+    };
+
+    auto&       State  = Transforms.AnimLOD;
+    const float Period = std::max(LOD.UpdatePeriod, 0.f);
+    Time               = clamp(Time, animation.Start, animation.End);
+
+    const bool IsValid = (State.AnimationIndex == AnimationIndex &&
+                          State.MaxNodeDepth == LOD.MaxNodeDepth &&
+                          State.UpdatePeriod == Period &&
+                          State.Pose0.size() == NumNodes);
+    if (!IsValid || Time < State.Time0 || Time > State.Time1)
     {
-        const auto& sampler = animation.Samplers[channel.SamplerIndex];
-        if (sampler.Inputs.size() > sampler.OutputsVec4.size())
+        if (IsValid && State.Time1 > State.Time0 && Time > State.Time1 && Time <= State.Time1 + Period)
         {
-            continue;
+            // Move to the next period, the end pose of the current period becomes the start pose
+            std::swap(State.Pose0, State.Pose1);
+            std::swap(State.MorphWeights0, State.MorphWeights1);
+            State.Time0 = State.Time1;
         }
-
-        auto& NodeAnim = Transforms.NodeAnimations[channel.pNode->Index];
-        // TODO: use binary search
-        for (size_t i = 0; i < sampler.Inputs.size() - 1; i++)
+        else
         {
-            if ((time >= sampler.Inputs[i]) &&
-                (time <= sampler.Inputs[i + 1]))
-            {
-                // STEP: The animated values remain constant to the output of the first keyframe, until the next keyframe.
-                //       The number of output elements **MUST** equal the number of input elements.
-                float u = 0;
-
-                // LINEAR: The animated values are linearly interpolated between keyframes.
-                //         The number of output elements **MUST** equal the number of input elements.
-                if (sampler.Interpolation == AnimationSampler::INTERPOLATION_TYPE::LINEAR)
-                    u = (time - sampler.Inputs[i]) / (sampler.Inputs[i + 1] - sampler.Inputs[i]);
-
-                // CUBICSPLINE: The animation's interpolation is computed using a cubic spline with specified tangents.
-                //              The number of output elements **MUST** equal three times the number of input elements.
-                //              For each input element, the output stores three elements, an in-tangent, a spline vertex,
-                //              and an out-tangent. There **MUST** be at least two keyframes when using this interpolation.
-                //if (sampler.Interpolation == AnimationSampler::INTERPOLATION_TYPE::CUBICSPLINE)
-                // Not supported
+            State.Time0 = Time;
+            EvaluatePose(State.Time0, State.Pose0, State.MorphWeights0);
+        }
 
-                switch (channel.PathType)
-                {
-                    case AnimationChannel::PATH_TYPE::TRANSLATION:
-                    {
-                        const float3 f3Start = sampler.OutputsVec4[i];
-                        const float3 f3End   = sampler.OutputsVec4[i + 1];
-                        NodeAnim.Translation = lerp(f3Start, f3End, u);
-                        break;
-                    }
+        State.Time1 = std::min(State.Time0 + Period, animation.End);
+        if (State.Time1 > State.Time0)
+            EvaluatePose(State.Time1, State.Pose1, State.MorphWeights1);
 
-                    case AnimationChannel::PATH_TYPE::SCALE:
-                    {
-                        const float3 f3Start = sampler.OutputsVec4[i];
-                        const float3 f3End   = sampler.OutputsVec4[i + 1];
-                        NodeAnim.Scale       = lerp(f3Start, f3End, u);
-                        break;
-                    }
+        State.AnimationIndex = AnimationIndex;
+        State.MaxNodeDepth   = LOD.MaxNodeDepth;
+        State.UpdatePeriod   = Period;
+    }
 
-                    case AnimationChannel::PATH_TYPE::ROTATION:
-                    {
-                        QuaternionF q1;
-                        q1.q.x = sampler.OutputsVec4[i].x;
-                        q1.q.y = sampler.OutputsVec4[i].y;
-                        q1.q.z = sampler.OutputsVec4[i].z;
-                        q1.q.w = sampler.OutputsVec4[i].w;
-
-                        QuaternionF q2;
-                        q2.q.x = sampler.OutputsVec4[i + 1].x;
-                        q2.q.y = sampler.OutputsVec4[i + 1].y;
-                        q2.q.z = sampler.OutputsVec4[i + 1].z;
-                        q2.q.w = sampler.OutputsVec4[i + 1].w;
-
-                        NodeAnim.Rotation = normalize(slerp(q1, q2, u));
-                        break;
-                    }
+    auto& Pose = Transforms.NodeAnimations;
+    if (State.Time1 > State.Time0)
+    {
+        const float u = (Time - State.Time0) / (State.Time1 - State.Time0);
+        for (size_t i = 0; i < NumNodes; ++i)
+        {
+            const auto& A0 = State.Pose0[i];
+            const auto& A1 = State.Pose1[i];
 
-                    case AnimationChannel::PATH_TYPE::WEIGHTS:
-                    {
-                        UNEXPECTED("Weights are not currently supported");
-                        break;
-                    }
-                }
+            Pose[i].Translation = lerp(A0.Translation, A1.Translation, u);
+            Pose[i].Scale       = lerp(A0.Scale, A1.Scale, u);
 
-                break;
-            }
+            // Take the shortest path
+            const float Sign   = dot(A0.Rotation.q, A1.Rotation.q) < 0 ? -1.f : 1.f;
+            Pose[i].Rotation.q = normalize(lerp(A0.Rotation.q, A1.Rotation.q * Sign, u));
         }
+
+        Transforms.MorphWeights.resize(State.MorphWeights0.size());
+        for (size_t w = 0; w < State.MorphWeights0.size(); ++w)
+            Transforms.MorphWeights[w] = lerp(State.MorphWeights0[w], State.MorphWeights1[w], u);
+    }
+    else
+    {
+        Pose                    = State.Pose0;
+        Transforms.MorphWeights = State.MorphWeights0;
     }
 
-    for (size_t i = 0; i < LinearNodes.size(); ++i)
+    for (size_t i = 0; i < NumNodes; ++i)
     {
-        const auto& N = LinearNodes[i];
-        const auto& A = Transforms.NodeAnimations[i];
+        const auto& A = Pose[i];
 
-        Transforms.NodeLocalMatrices[i] = ComputeNodeLocalMatrix(A.Scale, A.Rotation, A.Translation, N.Matrix);
+        Transforms.NodeLocalMatrices[i] = ComputeNodeLocalMatrix(A.Scale, A.Rotation, A.Translation, LinearNodes[i].Matrix);
     }
+
+    ComputeGlobalTransforms(Transforms, RootTransform, LOD.UpdateJointMatrices);
+
+    // The incremental update of ComputeTransforms() does not know about the LOD poses
+    Transforms.Incremental.NodeChanged.assign(NumNodes, 1);
 }
 
 } // namespace GLTF
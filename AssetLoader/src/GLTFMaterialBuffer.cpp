@@ -0,0 +1,145 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFMaterialBuffer.hpp"
+
+#include <algorithm>
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+MaterialBuffer::MaterialBuffer(const CreateInfo& CI) :
+    m_pResourceMgr{CI.pResourceMgr},
+    m_BufferIndex{CI.BufferIndex}
+{
+    if (!m_pResourceMgr)
+        LOG_ERROR_AND_THROW("Resource manager must not be null");
+}
+
+Uint32 MaterialBuffer::AddModel(const Model& GLTFModel)
+{
+    auto it = m_Models.find(&GLTFModel);
+    if (it != m_Models.end())
+        return it->second.FirstMaterial;
+
+    constexpr Uint32 MaterialStride = sizeof(Material::ShaderAttribs);
+
+    ModelEntry Entry;
+    if (!GLTFModel.Materials.empty())
+    {
+        const auto NumMaterials = static_cast<Uint32>(GLTFModel.Materials.size());
+
+        Entry.pAllocation = m_pResourceMgr->AllocateBufferSpace(m_BufferIndex, NumMaterials * MaterialStride, 1);
+        if (!Entry.pAllocation)
+        {
+            LOG_ERROR_MESSAGE("Failed to allocate space for ", NumMaterials, " materials");
+            return InvalidIndex;
+        }
+
+        const auto Offset = Entry.pAllocation->GetOffset();
+        if (Offset % MaterialStride != 0)
+        {
+            LOG_ERROR_MESSAGE("Material allocation offset (", Offset, ") is not a multiple of the material size (", MaterialStride,
+                              "). The material buffer must only be used for material data.");
+            return InvalidIndex;
+        }
+        Entry.FirstMaterial = static_cast<Uint32>(Offset / MaterialStride);
+    }
+
+    const auto FirstMaterial = Entry.FirstMaterial;
+    m_Models.emplace(&GLTFModel, std::move(Entry));
+    return FirstMaterial;
+}
+
+void MaterialBuffer::RemoveModel(const Model& GLTFModel)
+{
+    m_Models.erase(&GLTFModel);
+}
+
+void MaterialBuffer::InvalidateModel(const Model& GLTFModel)
+{
+    auto it = m_Models.find(&GLTFModel);
+    if (it != m_Models.end())
+        it->second.IsDirty = true;
+    else
+        UNEXPECTED("The model has not been added to the material buffer");
+}
+
+Uint32 MaterialBuffer::GetFirstMaterialIndex(const Model& GLTFModel) const
+{
+    auto it = m_Models.find(&GLTFModel);
+    return it != m_Models.end() ? it->second.FirstMaterial : InvalidIndex;
+}
+
+void MaterialBuffer::Commit(IRenderDevice* pDevice, IDeviceContext* pContext)
+{
+    DEV_CHECK_ERR(pDevice != nullptr && pContext != nullptr, "Device and context must not be null");
+
+    IBuffer* pBuffer = nullptr;
+    for (auto& it : m_Models)
+    {
+        auto& Entry = it.second;
+        if (!Entry.IsDirty)
+            continue;
+        Entry.IsDirty = false;
+
+        const auto& Materials = it.first->Materials;
+        if (!Entry.pAllocation || Materials.empty())
+            continue;
+
+        if (pBuffer == nullptr)
+        {
+            // Grows the buffer if new space has been allocated since the last call
+            pBuffer = GetBuffer(pDevice, pContext);
+            if (pBuffer == nullptr)
+                return;
+        }
+
+        // Material attributes are interleaved with other material data, so copy them
+        // to a contiguous array to upload all materials of the model at once.
+        m_UploadData.clear();
+        for (const auto& Mat : Materials)
+            m_UploadData.push_back(Mat.Attribs);
+
+        const auto Size = m_UploadData.size() * sizeof(Material::ShaderAttribs);
+        VERIFY(Size <= Entry.pAllocation->GetSize(), "The number of model materials has changed since the model was added");
+        pContext->UpdateBuffer(pBuffer, Entry.pAllocation->GetOffset(), std::min(Size, size_t{Entry.pAllocation->GetSize()}),
+                               m_UploadData.data(), RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    }
+}
+
+IBuffer* MaterialBuffer::GetBuffer(IRenderDevice* pDevice, IDeviceContext* pContext)
+{
+    return m_pResourceMgr->GetBuffer(m_BufferIndex, pDevice, pContext);
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
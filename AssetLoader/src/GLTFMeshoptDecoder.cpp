@@ -0,0 +1,535 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFMeshoptDecoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+namespace
+{
+
+// Vertex codec constants, see meshoptimizer's vertexcodec.cpp
+static constexpr Uint8  VertexHeader          = 0xA0;
+static constexpr size_t VertexBlockSizeBytes  = 8192;
+static constexpr size_t VertexBlockMaxSize    = 256;
+static constexpr size_t ByteGroupSize         = 16;
+static constexpr size_t ByteGroupDecodeLimit  = 24;
+static constexpr size_t VertexTailMaxSize     = 32;
+static constexpr Uint8  IndexHeader           = 0xE0;
+static constexpr Uint8  SequenceHeader        = 0xD0;
+static constexpr size_t IndexCodeAuxTableSize = 16;
+static constexpr size_t SequenceTailSize      = 4;
+
+inline Uint8 Unzigzag8(Uint8 v)
+{
+    return static_cast<Uint8>(-(v & 1) ^ (v >> 1));
+}
+
+size_t GetVertexBlockSize(size_t VertexSize)
+{
+    size_t BlockSize = VertexBlockSizeBytes / VertexSize;
+    BlockSize &= ~(ByteGroupSize - 1);
+    return BlockSize < VertexBlockMaxSize ? BlockSize : VertexBlockMaxSize;
+}
+
+// Decodes a group of 16 values packed with 0, 2, 4 or 8 bits. Packed values equal to
+// the largest value of the bit width are escapes that are followed by a raw byte.
+const Uint8* DecodeBytesGroup(const Uint8* pData, Uint8* pDst, int BitsLog2)
+{
+    switch (BitsLog2)
+    {
+        case 0:
+            memset(pDst, 0, ByteGroupSize);
+            return pData;
+
+        case 1:
+        case 2:
+        {
+            const Uint32 Bits     = BitsLog2 == 1 ? 2 : 4;
+            const Uint32 Escape   = (1u << Bits) - 1u;
+            const Uint8* pPacked  = pData;
+            const Uint8* pEscapes = pData + ByteGroupSize * Bits / 8;
+            for (size_t i = 0; i < ByteGroupSize; ++i)
+            {
+                const Uint32 Shift = 8 - Bits - static_cast<Uint32>(i * Bits) % 8;
+                const Uint32 Value = (pPacked[i * Bits / 8] >> Shift) & Escape;
+                pDst[i]            = Value == Escape ? *pEscapes++ : static_cast<Uint8>(Value);
+            }
+            return pEscapes;
+        }
+
+        case 3:
+            memcpy(pDst, pData, ByteGroupSize);
+            return pData + ByteGroupSize;
+
+        default:
+            return nullptr;
+    }
+}
+
+const Uint8* DecodeBytes(const Uint8* pData, const Uint8* pDataEnd, Uint8* pDst, size_t Size)
+{
+    // Every group uses two bits of the header
+    const Uint8* pHeader    = pData;
+    const size_t HeaderSize = (Size / ByteGroupSize + 3) / 4;
+    if (static_cast<size_t>(pDataEnd - pData) < HeaderSize)
+        return nullptr;
+    pData += HeaderSize;
+
+    for (size_t i = 0; i < Size; i += ByteGroupSize)
+    {
+        // The tail guarantees that a group never reads past the end of the buffer
+        if (static_cast<size_t>(pDataEnd - pData) < ByteGroupDecodeLimit)
+            return nullptr;
+
+        const size_t GroupIdx = i / ByteGroupSize;
+        const int    BitsLog2 = (pHeader[GroupIdx / 4] >> ((GroupIdx % 4) * 2)) & 3;
+
+        pData = DecodeBytesGroup(pData, pDst + i, BitsLog2);
+    }
+    return pData;
+}
+
+const Uint8* DecodeVertexBlock(const Uint8* pData,
+                               const Uint8* pDataEnd,
+                               Uint8*       pDst,
+                               size_t       VertexCount,
+                               size_t       VertexSize,
+                               Uint8        LastVertex[])
+{
+    Uint8 Deltas[VertexBlockMaxSize];
+
+    const size_t AlignedCount = (VertexCount + ByteGroupSize - 1) & ~(ByteGroupSize - 1);
+
+    // Every byte of the vertex is stored as a separate stream of zigzag-encoded deltas
+    for (size_t k = 0; k < VertexSize; ++k)
+    {
+        pData = DecodeBytes(pData, pDataEnd, Deltas, AlignedCount);
+        if (pData == nullptr)
+            return nullptr;
+
+        Uint8 Prev = LastVertex[k];
+        for (size_t i = 0; i < VertexCount; ++i)
+        {
+            Prev                     = static_cast<Uint8>(Unzigzag8(Deltas[i]) + Prev);
+            pDst[i * VertexSize + k] = Prev;
+        }
+    }
+
+    memcpy(LastVertex, pDst + (VertexCount - 1) * VertexSize, VertexSize);
+    return pData;
+}
+
+inline Uint32 DecodeVByte(const Uint8*& pData)
+{
+    const Uint8 Lead = *pData++;
+    if (Lead < 128)
+        return Lead;
+
+    // Values are stored in little-endian groups of 7 bits
+    Uint32 Result = Lead & 127u;
+    Uint32 Shift  = 7;
+    for (int i = 0; i < 4; ++i)
+    {
+        const Uint8 Group = *pData++;
+        Result |= static_cast<Uint32>(Group & 127u) << Shift;
+        Shift += 7;
+        if (Group < 128)
+            break;
+    }
+    return Result;
+}
+
+inline Uint32 DecodeIndex(const Uint8*& pData, Uint32 Last)
+{
+    const Uint32 v = DecodeVByte(pData);
+    const Uint32 d = (v >> 1) ^ (0u - (v & 1u));
+    return Last + d;
+}
+
+inline void WriteIndex(void* pDst, size_t Idx, size_t IndexSize, Uint32 Value)
+{
+    if (IndexSize == 2)
+        static_cast<Uint16*>(pDst)[Idx] = static_cast<Uint16>(Value);
+    else
+        static_cast<Uint32*>(pDst)[Idx] = Value;
+}
+
+struct IndexFifos
+{
+    Uint32 Edges[16][2];
+    Uint32 Vertices[16];
+    Uint32 EdgeOffset   = 0;
+    Uint32 VertexOffset = 0;
+
+    IndexFifos()
+    {
+        memset(Edges, 0xFF, sizeof(Edges));
+        memset(Vertices, 0xFF, sizeof(Vertices));
+    }
+
+    // The fifo updates must exactly match the encoder, otherwise the data is not decoded correctly
+    void PushEdge(Uint32 a, Uint32 b)
+    {
+        Edges[EdgeOffset][0] = a;
+        Edges[EdgeOffset][1] = b;
+        EdgeOffset           = (EdgeOffset + 1) & 15;
+    }
+
+    void PushVertex(Uint32 v, bool Cond = true)
+    {
+        Vertices[VertexOffset] = v;
+        VertexOffset           = (VertexOffset + (Cond ? 1 : 0)) & 15;
+    }
+};
+
+template <typename T>
+void DecodeFilterOct(T* pData, size_t Count)
+{
+    const float Max = static_cast<float>((1 << (sizeof(T) * 8 - 1)) - 1);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        // The third component stores 1.0 in the same bit width, which is used to reconstruct z
+        float x = static_cast<float>(pData[i * 4 + 0]);
+        float y = static_cast<float>(pData[i * 4 + 1]);
+        float z = static_cast<float>(pData[i * 4 + 2]) - std::abs(x) - std::abs(y);
+
+        // Fix up the octahedral coordinates of the lower hemisphere
+        const float t = z >= 0.f ? 0.f : z;
+        x += x >= 0.f ? t : -t;
+        y += y >= 0.f ? t : -t;
+
+        const float l = std::sqrt(x * x + y * y + z * z);
+        const float s = l > 0.f ? Max / l : 0.f;
+
+        pData[i * 4 + 0] = static_cast<T>(static_cast<int>(x * s + (x >= 0.f ? 0.5f : -0.5f)));
+        pData[i * 4 + 1] = static_cast<T>(static_cast<int>(y * s + (y >= 0.f ? 0.5f : -0.5f)));
+        pData[i * 4 + 2] = static_cast<T>(static_cast<int>(z * s + (z >= 0.f ? 0.5f : -0.5f)));
+    }
+}
+
+void DecodeFilterQuat(Int16* pData, size_t Count)
+{
+    const float Scale = 1.f / std::sqrt(2.f);
+    for (size_t i = 0; i < Count; ++i)
+    {
+        // The low two bits of the fourth component store the index of the dropped component,
+        // and the remaining bits store the quantization scale.
+        const int   sf = pData[i * 4 + 3] | 3;
+        const float ss = Scale / static_cast<float>(sf);
+
+        const float x = static_cast<float>(pData[i * 4 + 0]) * ss;
+        const float y = static_cast<float>(pData[i * 4 + 1]) * ss;
+        const float z = static_cast<float>(pData[i * 4 + 2]) * ss;
+
+        // The dropped component is the largest one, so it is always positive
+        const float ww = 1.f - x * x - y * y - z * z;
+        const float w  = std::sqrt(ww >= 0.f ? ww : 0.f);
+
+        const auto ToInt16 = [](float v) {
+            return static_cast<Int16>(static_cast<int>(v * 32767.f + (v >= 0.f ? 0.5f : -0.5f)));
+        };
+
+        const int qc = pData[i * 4 + 3] & 3;
+
+        pData[i * 4 + ((qc + 1) & 3)] = ToInt16(x);
+        pData[i * 4 + ((qc + 2) & 3)] = ToInt16(y);
+        pData[i * 4 + ((qc + 3) & 3)] = ToInt16(z);
+        pData[i * 4 + ((qc + 0) & 3)] = ToInt16(w);
+    }
+}
+
+void DecodeFilterExp(Uint32* pData, size_t Count)
+{
+    for (size_t i = 0; i < Count; ++i)
+    {
+        // 24-bit signed mantissa and 8-bit signed exponent
+        const Uint32 v = pData[i];
+        const Int32  m = static_cast<Int32>(v << 8) >> 8;
+        const Int32  e = static_cast<Int32>(v) >> 24;
+
+        // ldexp(m, e) computed by constructing 2^e directly
+        const Uint32 ScaleBits = static_cast<Uint32>(e + 127) << 23;
+
+        float Scale;
+        memcpy(&Scale, &ScaleBits, sizeof(Scale));
+        const float Value = Scale * static_cast<float>(m);
+        memcpy(&pData[i], &Value, sizeof(Value));
+    }
+}
+
+} // namespace
+
+bool DecodeMeshoptVertexBuffer(void* pDst, size_t Count, size_t Stride, const Uint8* pSrc, size_t SrcSize)
+{
+    if (Stride == 0 || Stride > 256 || Stride % 4 != 0)
+        return false;
+
+    if (SrcSize < 1 || pSrc[0] != VertexHeader)
+        return false;
+
+    const Uint8* pData    = pSrc + 1;
+    const Uint8* pDataEnd = pSrc + SrcSize;
+
+    // The first vertex is stored at the end of the buffer, padded to the tail size
+    const size_t TailSize = Stride < VertexTailMaxSize ? VertexTailMaxSize : Stride;
+    if (static_cast<size_t>(pDataEnd - pData) < TailSize)
+        return false;
+
+    Uint8 LastVertex[256];
+    memcpy(LastVertex, pDataEnd - Stride, Stride);
+
+    const size_t BlockSize = GetVertexBlockSize(Stride);
+    for (size_t VertexOffset = 0; VertexOffset < Count; VertexOffset += BlockSize)
+    {
+        const size_t NumVertices = std::min(BlockSize, Count - VertexOffset);
+
+        pData = DecodeVertexBlock(pData, pDataEnd, static_cast<Uint8*>(pDst) + VertexOffset * Stride, NumVertices, Stride, LastVertex);
+        if (pData == nullptr)
+            return false;
+    }
+
+    return static_cast<size_t>(pDataEnd - pData) == TailSize;
+}
+
+bool DecodeMeshoptIndexBuffer(void* pDst, size_t Count, size_t IndexSize, const Uint8* pSrc, size_t SrcSize)
+{
+    if (Count % 3 != 0 || (IndexSize != 2 && IndexSize != 4))
+        return false;
+
+    // Header, one code byte per triangle and the auxiliary code table
+    if (SrcSize < 1 + Count / 3 + IndexCodeAuxTableSize)
+        return false;
+
+    if ((pSrc[0] & 0xF0) != IndexHeader)
+        return false;
+
+    const int Version = pSrc[0] & 0x0F;
+    if (Version > 1)
+        return false;
+
+    const Uint8* pCode        = pSrc + 1;
+    const Uint8* pData        = pCode + Count / 3;
+    const Uint8* pDataSafeEnd = pSrc + SrcSize - IndexCodeAuxTableSize;
+    const Uint8* pCodeAux     = pDataSafeEnd;
+
+    // Version 1 uses codes 13 and 14 for the vertices adjacent to the last free index
+    const int FecMax = Version >= 1 ? 13 : 15;
+
+    IndexFifos Fifos;
+
+    Uint32 Next = 0;
+    Uint32 Last = 0;
+    for (size_t i = 0; i < Count; i += 3)
+    {
+        // A triangle never reads more than 16 bytes, which is the size of the code table at the end
+        if (pData > pDataSafeEnd)
+            return false;
+
+        const Uint8 CodeTri = *pCode++;
+
+        Uint32 a = 0, b = 0, c = 0;
+        if (CodeTri < 0xF0)
+        {
+            // The triangle shares an edge with one of the recent triangles
+            const int  fe = CodeTri >> 4;
+            const auto Ei = (Fifos.EdgeOffset - 1 - fe) & 15;
+
+            a = Fifos.Edges[Ei][0];
+            b = Fifos.Edges[Ei][1];
+
+            const int fec = CodeTri & 15;
+            if (fec < FecMax)
+            {
+                // The third vertex is either new or is in the vertex fifo
+                c = fec == 0 ? Next : Fifos.Vertices[(Fifos.VertexOffset - 1 - fec) & 15];
+                if (fec == 0)
+                    ++Next;
+
+                Fifos.PushVertex(c, fec == 0);
+            }
+            else
+            {
+                // Free indices are delta-encoded relative to the last free index.
+                // Codes 13 and 14 encode the deltas -1 and +1.
+                c = fec != 15 ? Last + static_cast<Uint32>(fec - (fec ^ 3)) : DecodeIndex(pData, Last);
+
+                Last = c;
+                Fifos.PushVertex(c);
+            }
+
+            Fifos.PushEdge(c, b);
+            Fifos.PushEdge(a, c);
+        }
+        else if (CodeTri < 0xFE)
+        {
+            // The triangle starts with a new vertex, and the other vertices are encoded by the table.
+            // Note that the table can't contain 15.
+            const Uint8 CodeAux = pCodeAux[CodeTri & 15];
+            const int   feb     = CodeAux >> 4;
+            const int   fec     = CodeAux & 15;
+
+            a = Next++;
+
+            b = feb == 0 ? Next : Fifos.Vertices[(Fifos.VertexOffset - feb) & 15];
+            if (feb == 0)
+                ++Next;
+
+            c = fec == 0 ? Next : Fifos.Vertices[(Fifos.VertexOffset - fec) & 15];
+            if (fec == 0)
+                ++Next;
+
+            Fifos.PushVertex(a);
+            Fifos.PushVertex(b, feb == 0);
+            Fifos.PushVertex(c, fec == 0);
+
+            Fifos.PushEdge(b, a);
+            Fifos.PushEdge(c, b);
+            Fifos.PushEdge(a, c);
+        }
+        else
+        {
+            // The auxiliary code is stored in the data stream
+            const Uint8 CodeAux = *pData++;
+
+            const int fea = CodeTri == 0xFE ? 0 : 15;
+            const int feb = CodeAux >> 4;
+            const int fec = CodeAux & 15;
+
+            // A zero auxiliary code that is not in the table resets the counter of new vertices
+            if (CodeAux == 0)
+                Next = 0;
+
+            // Next is incremented for all three vertices before free indices are decoded to match the encoder
+            a = fea == 0 ? Next++ : 0;
+            b = feb == 0 ? Next++ : Fifos.Vertices[(Fifos.VertexOffset - feb) & 15];
+            c = fec == 0 ? Next++ : Fifos.Vertices[(Fifos.VertexOffset - fec) & 15];
+
+            if (fea == 15)
+                Last = a = DecodeIndex(pData, Last);
+            if (feb == 15)
+                Last = b = DecodeIndex(pData, Last);
+            if (fec == 15)
+                Last = c = DecodeIndex(pData, Last);
+
+            Fifos.PushVertex(a);
+            Fifos.PushVertex(b, feb == 0 || feb == 15);
+            Fifos.PushVertex(c, fec == 0 || fec == 15);
+
+            Fifos.PushEdge(b, a);
+            Fifos.PushEdge(c, b);
+            Fifos.PushEdge(a, c);
+        }
+
+        WriteIndex(pDst, i + 0, IndexSize, a);
+        WriteIndex(pDst, i + 1, IndexSize, b);
+        WriteIndex(pDst, i + 2, IndexSize, c);
+    }
+
+    return pData == pDataSafeEnd;
+}
+
+bool DecodeMeshoptIndexSequence(void* pDst, size_t Count, size_t IndexSize, const Uint8* pSrc, size_t SrcSize)
+{
+    if (IndexSize != 2 && IndexSize != 4)
+        return false;
+
+    // Header, at least one byte per index and the tail
+    if (SrcSize < 1 + Count + SequenceTailSize)
+        return false;
+
+    if ((pSrc[0] & 0xF0) != SequenceHeader || (pSrc[0] & 0x0F) != 0)
+        return false;
+
+    const Uint8* pData        = pSrc + 1;
+    const Uint8* pDataSafeEnd = pSrc + SrcSize - SequenceTailSize;
+
+    // Two baselines allow efficient encoding of interleaved sequences, e.g. triangle strips
+    Uint32 Last[2] = {};
+    for (size_t i = 0; i < Count; ++i)
+    {
+        if (pData >= pDataSafeEnd)
+            return false;
+
+        Uint32 v = DecodeVByte(pData);
+
+        const Uint32 Baseline = v & 1u;
+        v >>= 1;
+
+        const Uint32 d = (v >> 1) ^ (0u - (v & 1u));
+        Last[Baseline] += d;
+
+        WriteIndex(pDst, i, IndexSize, Last[Baseline]);
+    }
+
+    return pData == pDataSafeEnd;
+}
+
+bool ApplyMeshoptFilter(MESHOPT_FILTER Filter, void* pData, size_t Count, size_t Stride)
+{
+    switch (Filter)
+    {
+        case MESHOPT_FILTER_NONE:
+            return true;
+
+        case MESHOPT_FILTER_OCTAHEDRAL:
+            if (Stride == 4)
+                DecodeFilterOct(static_cast<Int8*>(pData), Count);
+            else if (Stride == 8)
+                DecodeFilterOct(static_cast<Int16*>(pData), Count);
+            else
+                return false;
+            return true;
+
+        case MESHOPT_FILTER_QUATERNION:
+            if (Stride != 8)
+                return false;
+            DecodeFilterQuat(static_cast<Int16*>(pData), Count);
+            return true;
+
+        case MESHOPT_FILTER_EXPONENTIAL:
+            if (Stride % 4 != 0)
+                return false;
+            DecodeFilterExp(static_cast<Uint32*>(pData), Count * Stride / 4);
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFModelInstance.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+ModelInstance::ModelInstance(std::shared_ptr<const Model> pModel) :
+    m_pModel{std::move(pModel)}
+{
+    DEV_CHECK_ERR(m_pModel, "Model must not be null");
+}
+
+void ModelInstance::SetAnimation(Int32 AnimationIndex, float Time)
+{
+    DEV_CHECK_ERR(AnimationIndex < static_cast<Int32>(m_pModel->Animations.size()), "Animation index (", AnimationIndex,
+                  ") is out of range (", m_pModel->Animations.size(), ")");
+
+    m_AnimationState.AnimationIndex = AnimationIndex;
+    m_AnimationState.Time           = Time;
+}
+
+void ModelInstance::UpdateTransforms()
+{
+    m_pModel->ComputeTransforms(m_Transforms, m_AnimationState.RootTransform, m_AnimationState.AnimationIndex, m_AnimationState.Time);
+}
+
+const Material& ModelInstance::GetMaterial(Uint32 MaterialId) const
+{
+    VERIFY_EXPR(MaterialId < m_pModel->Materials.size());
+
+    auto it = m_MaterialOverrides.find(MaterialId);
+    return it != m_MaterialOverrides.end() ? it->second : m_pModel->Materials[MaterialId];
+}
+
+Material& ModelInstance::OverrideMaterial(Uint32 MaterialId)
+{
+    DEV_CHECK_ERR(MaterialId < m_pModel->Materials.size(), "Material id (", MaterialId, ") is out of range (", m_pModel->Materials.size(), ")");
+
+    auto it = m_MaterialOverrides.find(MaterialId);
+    if (it == m_MaterialOverrides.end())
+        it = m_MaterialOverrides.emplace(MaterialId, m_pModel->Materials[MaterialId]).first;
+    return it->second;
+}
+
+void ModelInstance::RemoveMaterialOverride(Uint32 MaterialId)
+{
+    m_MaterialOverrides.erase(MaterialId);
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
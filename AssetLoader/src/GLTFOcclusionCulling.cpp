@@ -0,0 +1,591 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFOcclusionCulling.hpp"
+
+#include <algorithm>
+
+#include "MapHelper.hpp"
+#include "GraphicsAccessories.hpp"
+#include "ShaderMacroHelper.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+namespace
+{
+
+// Must match the numthreads attributes in the shaders
+static constexpr Uint32 HiZThreadGroupSize     = 8;
+static constexpr Uint32 CullingThreadGroupSize = 64;
+
+// Every texel of the destination level stores the farthest depth of the source texels it covers.
+// When the source size is odd, the last destination texel also covers the last source texel.
+static constexpr char HiZDownsampleCS[] = R"(
+cbuffer cbHiZAttribs
+{
+    uint2 g_SrcSize;
+    uint2 g_DstSize;
+
+    uint g_ReverseDepth;
+    uint g_Padding0;
+    uint g_Padding1;
+    uint g_Padding2;
+};
+
+Texture2D<float>   g_SrcDepth;
+RWTexture2D<float> g_DstDepth;
+
+[numthreads(8, 8, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    if (DTid.x >= g_DstSize.x || DTid.y >= g_DstSize.y)
+        return;
+
+    // The first level has the size of the depth buffer and is copied from it
+    uint2 Step  = uint2(g_SrcSize.x > g_DstSize.x ? 2u : 1u, g_SrcSize.y > g_DstSize.y ? 2u : 1u);
+    uint2 Begin = DTid.xy * Step;
+    uint2 End   = min(Begin + Step, g_SrcSize);
+    if (DTid.x == g_DstSize.x - 1u)
+        End.x = g_SrcSize.x;
+    if (DTid.y == g_DstSize.y - 1u)
+        End.y = g_SrcSize.y;
+
+    float Depth = g_ReverseDepth != 0u ? 1.0 : 0.0;
+    for (uint y = Begin.y; y < End.y; ++y)
+    {
+        for (uint x = Begin.x; x < End.x; ++x)
+        {
+            float SrcDepth = g_SrcDepth.Load(int3(x, y, 0));
+            Depth = g_ReverseDepth != 0u ? min(Depth, SrcDepth) : max(Depth, SrcDepth);
+        }
+    }
+    g_DstDepth[DTid.xy] = Depth;
+}
+)";
+
+// Matrices are stored as rows and multiply row vectors, as in float4x4.
+static constexpr char CullingCS[] = R"(
+cbuffer cbCullingAttribs
+{
+    float4 g_ViewProj[4];
+    float4 g_HiZViewProj[4];
+
+    float2 g_HiZSize;
+    uint   g_HiZMipCount;
+    uint   g_NumDraws;
+
+    float g_NDCMinZ;
+    float g_ZtoDepthScale;
+    float g_YtoVScale;
+    uint  g_Flags;
+};
+
+#define CULL_FLAG_OCCLUSION     1u
+#define CULL_FLAG_REVERSE_DEPTH 2u
+
+// DrawListBuilder::DrawData
+struct DrawData
+{
+    float4 NodeRow0;
+    float4 NodeRow1;
+    float4 NodeRow2;
+    float4 NodeRow3;
+
+    uint MaterialIndex;
+    uint InstanceIndex;
+    uint Padding0;
+    uint Padding1;
+};
+
+// DrawListBuilder::DrawBounds
+struct DrawBounds
+{
+    float3 BBMin;
+    uint   BatchFirstDraw;
+    float3 BBMax;
+    uint   Padding;
+};
+
+StructuredBuffer<DrawData>   g_DrawData;
+StructuredBuffer<DrawBounds> g_DrawBounds;
+ByteAddressBuffer            g_SrcDrawArgs;
+RWByteAddressBuffer          g_DstDrawArgs;
+Texture2D<float>             g_HiZ;
+#if COMPACT_DRAWS
+RWByteAddressBuffer g_DrawCounts;
+#endif
+
+float4 TransformPoint(float4 Pos, float4 Row0, float4 Row1, float4 Row2, float4 Row3)
+{
+    return Pos.x * Row0 + Pos.y * Row1 + Pos.z * Row2 + Pos.w * Row3;
+}
+
+// Returns true if the box is behind the depth stored in the Hi-Z pyramid
+bool IsOccluded(float4 WorldCorners[8])
+{
+    float3 NDCMin = float3(+1e+30, +1e+30, +1e+30);
+    float3 NDCMax = float3(-1e+30, -1e+30, -1e+30);
+    for (int i = 0; i < 8; ++i)
+    {
+        float4 Clip = TransformPoint(WorldCorners[i], g_HiZViewProj[0], g_HiZViewProj[1], g_HiZViewProj[2], g_HiZViewProj[3]);
+        // The box crosses the near plane
+        if (Clip.w <= 0.0)
+            return false;
+
+        float3 NDC = Clip.xyz / Clip.w;
+        NDCMin = min(NDCMin, NDC);
+        NDCMax = max(NDCMax, NDC);
+    }
+    NDCMin.xy = clamp(NDCMin.xy, float2(-1.0, -1.0), float2(1.0, 1.0));
+    NDCMax.xy = clamp(NDCMax.xy, float2(-1.0, -1.0), float2(1.0, 1.0));
+
+    float2 UV0   = float2(NDCMin.x * 0.5 + 0.5, 0.5 + NDCMin.y * g_YtoVScale);
+    float2 UV1   = float2(NDCMax.x * 0.5 + 0.5, 0.5 + NDCMax.y * g_YtoVScale);
+    float2 UVMin = min(UV0, UV1);
+    float2 UVMax = max(UV0, UV1);
+
+    bool  ReverseDepth = (g_Flags & CULL_FLAG_REVERSE_DEPTH) != 0u;
+    float ClosestDepth = ((ReverseDepth ? NDCMax.z : NDCMin.z) - g_NDCMinZ) * g_ZtoDepthScale;
+
+    // Select the level where the box covers at most 2x2 texels
+    float2 TexelMin = UVMin * g_HiZSize;
+    float2 TexelMax = UVMax * g_HiZSize;
+    float2 Extent   = TexelMax - TexelMin;
+    uint   Mip      = min(uint(ceil(log2(max(max(Extent.x, Extent.y), 1.0)))), g_HiZMipCount - 1u);
+
+    uint2 MipSize = max(uint2(g_HiZSize) >> Mip, uint2(1u, 1u));
+    uint2 C0      = min(uint2(TexelMin) >> Mip, MipSize - 1u);
+    uint2 C1      = min(uint2(TexelMax) >> Mip, MipSize - 1u);
+
+    float D00 = g_HiZ.Load(int3(C0.x, C0.y, Mip));
+    float D10 = g_HiZ.Load(int3(C1.x, C0.y, Mip));
+    float D01 = g_HiZ.Load(int3(C0.x, C1.y, Mip));
+    float D11 = g_HiZ.Load(int3(C1.x, C1.y, Mip));
+    if (ReverseDepth)
+        return ClosestDepth < min(min(D00, D10), min(D01, D11));
+    else
+        return ClosestDepth > max(max(D00, D10), max(D01, D11));
+}
+
+[numthreads(64, 1, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    uint DrawIdx = DTid.x;
+    if (DrawIdx >= g_NumDraws)
+        return;
+
+    DrawData   Data   = g_DrawData[DrawIdx];
+    DrawBounds Bounds = g_DrawBounds[DrawIdx];
+
+    // The box is outside of the frustum if all its corners are outside of the same plane
+    float4 WorldCorners[8];
+    uint   CommonOutcode = 0x3Fu;
+    for (int i = 0; i < 8; ++i)
+    {
+        float3 Corner = float3((i & 1) != 0 ? Bounds.BBMax.x : Bounds.BBMin.x,
+                               (i & 2) != 0 ? Bounds.BBMax.y : Bounds.BBMin.y,
+                               (i & 4) != 0 ? Bounds.BBMax.z : Bounds.BBMin.z);
+        WorldCorners[i] = TransformPoint(float4(Corner, 1.0), Data.NodeRow0, Data.NodeRow1, Data.NodeRow2, Data.NodeRow3);
+
+        float4 Clip = TransformPoint(WorldCorners[i], g_ViewProj[0], g_ViewProj[1], g_ViewProj[2], g_ViewProj[3]);
+        uint Outcode = 0u;
+        Outcode |= Clip.x < -Clip.w ? 1u : 0u;
+        Outcode |= Clip.x > +Clip.w ? 2u : 0u;
+        Outcode |= Clip.y < -Clip.w ? 4u : 0u;
+        Outcode |= Clip.y > +Clip.w ? 8u : 0u;
+        Outcode |= Clip.z < g_NDCMinZ * Clip.w ? 16u : 0u;
+        Outcode |= Clip.z > Clip.w ? 32u : 0u;
+        CommonOutcode &= Outcode;
+    }
+
+    bool Visible = CommonOutcode == 0u;
+    if (Visible && (g_Flags & CULL_FLAG_OCCLUSION) != 0u)
+        Visible = !IsOccluded(WorldCorners);
+
+    // DrawListBuilder::DrawIndexedArgs: NumIndices, NumInstances, FirstIndexLocation, BaseVertex, FirstInstanceLocation
+    uint  SrcOffset     = DrawIdx * 20u;
+    uint4 Args          = g_SrcDrawArgs.Load4(SrcOffset);
+    uint  FirstInstance = g_SrcDrawArgs.Load(SrcOffset + 16u);
+#if COMPACT_DRAWS
+    if (!Visible)
+        return;
+
+    uint Slot;
+    g_DrawCounts.InterlockedAdd(Bounds.BatchFirstDraw * 4u, 1u, Slot);
+    uint DstOffset = (Bounds.BatchFirstDraw + Slot) * 20u;
+#else
+    if (!Visible)
+        Args.y = 0u;
+    uint DstOffset = SrcOffset;
+#endif
+    g_DstDrawArgs.Store4(DstOffset, Args);
+    g_DstDrawArgs.Store(DstOffset + 16u, FirstInstance);
+}
+)";
+
+struct HiZAttribs
+{
+    Uint32 SrcWidth;
+    Uint32 SrcHeight;
+    Uint32 DstWidth;
+    Uint32 DstHeight;
+
+    Uint32 ReverseDepth;
+    Uint32 Padding0;
+    Uint32 Padding1;
+    Uint32 Padding2;
+};
+static_assert(sizeof(HiZAttribs) % 16 == 0, "Constant buffer size must be a multiple of 16 bytes");
+
+enum CULL_FLAGS : Uint32
+{
+    CULL_FLAG_NONE          = 0,
+    CULL_FLAG_OCCLUSION     = 1u << 0,
+    CULL_FLAG_REVERSE_DEPTH = 1u << 1
+};
+
+struct CullingAttribs
+{
+    float4x4 ViewProj;
+    float4x4 HiZViewProj;
+
+    float2 HiZSize;
+    Uint32 HiZMipCount;
+    Uint32 NumDraws;
+
+    float  NDCMinZ;
+    float  ZtoDepthScale;
+    float  YtoVScale;
+    Uint32 Flags;
+};
+static_assert(sizeof(CullingAttribs) % 16 == 0, "Constant buffer size must be a multiple of 16 bytes");
+
+RefCntAutoPtr<IPipelineState> CreateComputePSO(IRenderDevice* pDevice, const char* Name, const char* Source, const ShaderMacro* Macros, const char* ConstantsName)
+{
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_HLSL;
+    ShaderCI.Desc           = {Name, SHADER_TYPE_COMPUTE, true};
+    ShaderCI.EntryPoint     = "main";
+    ShaderCI.Source         = Source;
+    ShaderCI.Macros         = Macros;
+
+    RefCntAutoPtr<IShader> pCS;
+    pDevice->CreateShader(ShaderCI, &pCS);
+    if (!pCS)
+        LOG_ERROR_AND_THROW("Failed to create ", Name, " shader");
+
+    ComputePipelineStateCreateInfo PSOCreateInfo;
+    PSOCreateInfo.PSODesc.Name         = Name;
+    PSOCreateInfo.PSODesc.PipelineType = PIPELINE_TYPE_COMPUTE;
+    PSOCreateInfo.pCS                  = pCS;
+
+    PSOCreateInfo.PSODesc.ResourceLayout.DefaultVariableType = SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC;
+
+    ShaderResourceVariableDesc Variables[] =
+        {
+            {SHADER_TYPE_COMPUTE, ConstantsName, SHADER_RESOURCE_VARIABLE_TYPE_STATIC} //
+        };
+    PSOCreateInfo.PSODesc.ResourceLayout.Variables    = Variables;
+    PSOCreateInfo.PSODesc.ResourceLayout.NumVariables = _countof(Variables);
+
+    RefCntAutoPtr<IPipelineState> pPSO;
+    pDevice->CreateComputePipelineState(PSOCreateInfo, &pPSO);
+    if (!pPSO)
+        LOG_ERROR_AND_THROW("Failed to create ", Name, " PSO");
+    return pPSO;
+}
+
+RefCntAutoPtr<IBuffer> CreateConstantBuffer(IRenderDevice* pDevice, const char* Name, Uint64 Size)
+{
+    BufferDesc BuffDesc;
+    BuffDesc.Name           = Name;
+    BuffDesc.Size           = Size;
+    BuffDesc.Usage          = USAGE_DYNAMIC;
+    BuffDesc.BindFlags      = BIND_UNIFORM_BUFFER;
+    BuffDesc.CPUAccessFlags = CPU_ACCESS_WRITE;
+
+    RefCntAutoPtr<IBuffer> pBuffer;
+    pDevice->CreateBuffer(BuffDesc, nullptr, &pBuffer);
+    if (!pBuffer)
+        LOG_ERROR_AND_THROW("Failed to create ", Name, " buffer");
+    return pBuffer;
+}
+
+// Creates the raw buffer that is written by the culling shader and read by indirect draws,
+// or grows it to fit the size.
+bool PrepareIndirectBuffer(IRenderDevice* pDevice, const char* Name, Uint64 Size, RefCntAutoPtr<IBuffer>& pBuffer)
+{
+    if (pBuffer && pBuffer->GetDesc().Size >= Size)
+        return true;
+
+    BufferDesc BuffDesc;
+    BuffDesc.Name              = Name;
+    BuffDesc.Size              = pBuffer ? std::max(Size, pBuffer->GetDesc().Size * 2) : Size;
+    BuffDesc.Usage             = USAGE_DEFAULT;
+    BuffDesc.BindFlags         = BIND_UNORDERED_ACCESS | BIND_INDIRECT_DRAW_ARGS;
+    BuffDesc.Mode              = BUFFER_MODE_RAW;
+    BuffDesc.ElementByteStride = sizeof(Uint32);
+
+    pBuffer.Release();
+    pDevice->CreateBuffer(BuffDesc, nullptr, &pBuffer);
+    if (!pBuffer)
+    {
+        LOG_ERROR_MESSAGE("Failed to create ", Name, " buffer");
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+OcclusionCulling::OcclusionCulling(const CreateInfo& CI) :
+    m_pDevice{CI.pDevice},
+    m_ReverseDepth{CI.ReverseDepth}
+{
+    if (CI.pDevice == nullptr)
+        LOG_ERROR_AND_THROW("Render device must not be null");
+
+    m_Compact = (m_pDevice->GetAdapterInfo().DrawCommand.CapFlags & DRAW_COMMAND_CAP_FLAG_DRAW_INDIRECT_COUNTER_BUFFER) != 0;
+
+    m_pHiZPSO       = CreateComputePSO(m_pDevice, "GLTF Hi-Z downsample", HiZDownsampleCS, nullptr, "cbHiZAttribs");
+    m_pHiZConstants = CreateConstantBuffer(m_pDevice, "GLTF Hi-Z attribs", sizeof(HiZAttribs));
+    m_pHiZPSO->GetStaticVariableByName(SHADER_TYPE_COMPUTE, "cbHiZAttribs")->Set(m_pHiZConstants);
+    m_pHiZPSO->CreateShaderResourceBinding(&m_pHiZSRB, true);
+
+    ShaderMacroHelper Macros;
+    Macros.AddShaderMacro("COMPACT_DRAWS", m_Compact ? 1 : 0);
+    m_pCullPSO       = CreateComputePSO(m_pDevice, "GLTF occlusion culling", CullingCS, Macros, "cbCullingAttribs");
+    m_pCullConstants = CreateConstantBuffer(m_pDevice, "GLTF occlusion culling attribs", sizeof(CullingAttribs));
+    m_pCullPSO->GetStaticVariableByName(SHADER_TYPE_COMPUTE, "cbCullingAttribs")->Set(m_pCullConstants);
+    m_pCullPSO->CreateShaderResourceBinding(&m_pCullSRB, true);
+
+    // The culling shader always needs a pyramid to bind, even before the first one is built
+    CreateHiZ(1, 1);
+}
+
+void OcclusionCulling::CreateHiZ(Uint32 Width, Uint32 Height)
+{
+    m_pHiZ.Release();
+    m_pHiZSRV.Release();
+    m_HiZMipSRVs.clear();
+    m_HiZMipUAVs.clear();
+    m_HiZValid = false;
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "GLTF Hi-Z pyramid";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Width     = Width;
+    TexDesc.Height    = Height;
+    TexDesc.MipLevels = ComputeMipLevelsCount(Width, Height);
+    TexDesc.Format    = TEX_FORMAT_R32_FLOAT;
+    TexDesc.BindFlags = BIND_SHADER_RESOURCE | BIND_UNORDERED_ACCESS;
+    TexDesc.Usage     = USAGE_DEFAULT;
+    m_pDevice->CreateTexture(TexDesc, nullptr, &m_pHiZ);
+    if (!m_pHiZ)
+    {
+        LOG_ERROR_MESSAGE("Failed to create ", Width, "x", Height, " Hi-Z pyramid");
+        return;
+    }
+    m_pHiZSRV = m_pHiZ->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+
+    m_HiZMipSRVs.resize(TexDesc.MipLevels);
+    m_HiZMipUAVs.resize(TexDesc.MipLevels);
+    for (Uint32 Mip = 0; Mip < TexDesc.MipLevels; ++Mip)
+    {
+        TextureViewDesc ViewDesc;
+        ViewDesc.Name            = "GLTF Hi-Z mip level view";
+        ViewDesc.TextureDim      = RESOURCE_DIM_TEX_2D;
+        ViewDesc.MostDetailedMip = Mip;
+        ViewDesc.NumMipLevels    = 1;
+
+        ViewDesc.ViewType = TEXTURE_VIEW_SHADER_RESOURCE;
+        m_pHiZ->CreateView(ViewDesc, &m_HiZMipSRVs[Mip]);
+
+        ViewDesc.ViewType = TEXTURE_VIEW_UNORDERED_ACCESS;
+        m_pHiZ->CreateView(ViewDesc, &m_HiZMipUAVs[Mip]);
+    }
+}
+
+void OcclusionCulling::BuildHiZ(IDeviceContext* pCtx, ITextureView* pDepthSRV, const float4x4& ViewProj)
+{
+    DEV_CHECK_ERR(pCtx != nullptr, "Device context must not be null");
+    DEV_CHECK_ERR(pDepthSRV != nullptr, "Depth buffer view must not be null");
+
+    auto*       pDepthTex = pDepthSRV->GetTexture();
+    const auto& DepthDesc = pDepthTex->GetDesc();
+    const auto  DepthMip  = pDepthSRV->GetDesc().MostDetailedMip;
+    const auto  Width     = std::max(DepthDesc.Width >> DepthMip, 1u);
+    const auto  Height    = std::max(DepthDesc.Height >> DepthMip, 1u);
+    if (!m_pHiZ || m_pHiZ->GetDesc().Width != Width || m_pHiZ->GetDesc().Height != Height)
+    {
+        CreateHiZ(Width, Height);
+        if (!m_pHiZ)
+            return;
+    }
+
+    StateTransitionDesc Barriers[] =
+        {
+            {pDepthTex, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, STATE_TRANSITION_FLAG_UPDATE_STATE},
+            {m_pHiZ, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_UNORDERED_ACCESS, STATE_TRANSITION_FLAG_UPDATE_STATE},
+        };
+    pCtx->TransitionResourceStates(_countof(Barriers), Barriers);
+
+    // Every level is written after the previous one has been transitioned to the shader resource
+    // state, so the states of the individual levels are managed here rather than by the engine.
+    StateTransitionDesc MipBarrier;
+    MipBarrier.pResource      = m_pHiZ;
+    MipBarrier.MipLevelsCount = 1;
+    MipBarrier.OldState       = RESOURCE_STATE_UNORDERED_ACCESS;
+    MipBarrier.NewState       = RESOURCE_STATE_SHADER_RESOURCE;
+
+    pCtx->SetPipelineState(m_pHiZPSO);
+    const auto MipLevels = m_pHiZ->GetDesc().MipLevels;
+    for (Uint32 Mip = 0; Mip < MipLevels; ++Mip)
+    {
+        if (Mip > 0)
+        {
+            MipBarrier.FirstMipLevel = Mip - 1;
+            pCtx->TransitionResourceStates(1, &MipBarrier);
+        }
+
+        const auto DstWidth  = std::max(Width >> Mip, 1u);
+        const auto DstHeight = std::max(Height >> Mip, 1u);
+        {
+            MapHelper<HiZAttribs> Attribs{pCtx, m_pHiZConstants, MAP_WRITE, MAP_FLAG_DISCARD};
+            Attribs->SrcWidth     = Mip > 0 ? std::max(Width >> (Mip - 1), 1u) : Width;
+            Attribs->SrcHeight    = Mip > 0 ? std::max(Height >> (Mip - 1), 1u) : Height;
+            Attribs->DstWidth     = DstWidth;
+            Attribs->DstHeight    = DstHeight;
+            Attribs->ReverseDepth = m_ReverseDepth ? 1 : 0;
+            Attribs->Padding0     = 0;
+            Attribs->Padding1     = 0;
+            Attribs->Padding2     = 0;
+        }
+
+        m_pHiZSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_SrcDepth")->Set(Mip > 0 ? m_HiZMipSRVs[Mip - 1].RawPtr() : pDepthSRV);
+        m_pHiZSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_DstDepth")->Set(m_HiZMipUAVs[Mip]);
+        pCtx->CommitShaderResources(m_pHiZSRB, RESOURCE_STATE_TRANSITION_MODE_NONE);
+
+        DispatchComputeAttribs DispatchAttribs{(DstWidth + HiZThreadGroupSize - 1) / HiZThreadGroupSize,
+                                               (DstHeight + HiZThreadGroupSize - 1) / HiZThreadGroupSize,
+                                               1};
+        pCtx->DispatchCompute(DispatchAttribs);
+    }
+    MipBarrier.FirstMipLevel = MipLevels - 1;
+    pCtx->TransitionResourceStates(1, &MipBarrier);
+    m_pHiZ->SetState(RESOURCE_STATE_SHADER_RESOURCE);
+
+    m_HiZViewProj = ViewProj;
+    m_HiZValid    = true;
+}
+
+void OcclusionCulling::Cull(IDeviceContext* pCtx, const DrawListBuilder& DrawList, const float4x4& ViewProj)
+{
+    DEV_CHECK_ERR(pCtx != nullptr, "Device context must not be null");
+
+    const auto NumDraws = static_cast<Uint32>(DrawList.GetDrawCount());
+    if (NumDraws == 0)
+        return;
+
+    auto* pDrawArgs   = DrawList.GetDrawArgsBuffer();
+    auto* pDrawData   = DrawList.GetDrawDataBuffer();
+    auto* pDrawBounds = DrawList.GetDrawBoundsBuffer();
+    if (pDrawArgs == nullptr || pDrawData == nullptr || pDrawBounds == nullptr || !m_pHiZ)
+        return;
+
+    const Uint64 ArgsSize = Uint64{NumDraws} * sizeof(DrawListBuilder::DrawIndexedArgs);
+    if (!PrepareIndirectBuffer(m_pDevice, "GLTF culled draw arguments", ArgsSize, m_pCulledArgsBuffer))
+        return;
+
+    if (m_Compact)
+    {
+        // The counter of every batch is stored at the index of its first draw command
+        const Uint64 CountsSize = Uint64{NumDraws} * sizeof(Uint32);
+        if (!PrepareIndirectBuffer(m_pDevice, "GLTF culled draw counts", CountsSize, m_pDrawCountsBuffer))
+            return;
+
+        m_ZeroCounts.resize(NumDraws);
+        pCtx->UpdateBuffer(m_pDrawCountsBuffer, 0, CountsSize, m_ZeroCounts.data(), RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    }
+
+    {
+        const auto& HiZDesc = m_pHiZ->GetDesc();
+        const auto  NDC     = m_pDevice->GetDeviceInfo().GetNDCAttribs();
+
+        MapHelper<CullingAttribs> Attribs{pCtx, m_pCullConstants, MAP_WRITE, MAP_FLAG_DISCARD};
+        Attribs->ViewProj      = ViewProj;
+        Attribs->HiZViewProj   = m_HiZViewProj;
+        Attribs->HiZSize       = float2{static_cast<float>(HiZDesc.Width), static_cast<float>(HiZDesc.Height)};
+        Attribs->HiZMipCount   = HiZDesc.MipLevels;
+        Attribs->NumDraws      = NumDraws;
+        Attribs->NDCMinZ       = NDC.MinZ;
+        Attribs->ZtoDepthScale = NDC.ZtoDepthScale;
+        Attribs->YtoVScale     = NDC.YtoVScale;
+        Attribs->Flags         = (m_HiZValid ? CULL_FLAG_OCCLUSION : CULL_FLAG_NONE) |
+            (m_ReverseDepth ? CULL_FLAG_REVERSE_DEPTH : CULL_FLAG_NONE);
+    }
+
+    m_pCullSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_DrawData")->Set(pDrawData->GetDefaultView(BUFFER_VIEW_SHADER_RESOURCE));
+    m_pCullSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_DrawBounds")->Set(pDrawBounds->GetDefaultView(BUFFER_VIEW_SHADER_RESOURCE));
+    m_pCullSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_SrcDrawArgs")->Set(pDrawArgs->GetDefaultView(BUFFER_VIEW_SHADER_RESOURCE));
+    m_pCullSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_DstDrawArgs")->Set(m_pCulledArgsBuffer->GetDefaultView(BUFFER_VIEW_UNORDERED_ACCESS));
+    m_pCullSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_HiZ")->Set(m_pHiZSRV);
+    if (m_Compact)
+        m_pCullSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_DrawCounts")->Set(m_pDrawCountsBuffer->GetDefaultView(BUFFER_VIEW_UNORDERED_ACCESS));
+
+    pCtx->SetPipelineState(m_pCullPSO);
+    pCtx->CommitShaderResources(m_pCullSRB, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+    DispatchComputeAttribs DispatchAttribs{(NumDraws + CullingThreadGroupSize - 1) / CullingThreadGroupSize, 1, 1};
+    pCtx->DispatchCompute(DispatchAttribs);
+}
+
+DrawIndexedIndirectAttribs OcclusionCulling::GetDrawAttribs(const DrawListBuilder::Batch& B) const
+{
+    DrawIndexedIndirectAttribs Attribs;
+    Attribs.IndexType                        = B.IndexType;
+    Attribs.pAttribsBuffer                   = m_pCulledArgsBuffer;
+    Attribs.DrawArgsOffset                   = Uint64{B.FirstDraw} * sizeof(DrawListBuilder::DrawIndexedArgs);
+    Attribs.DrawCount                        = B.NumDraws;
+    Attribs.DrawArgsStride                   = sizeof(DrawListBuilder::DrawIndexedArgs);
+    Attribs.AttribsBufferStateTransitionMode = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+    if (m_Compact)
+    {
+        Attribs.pCounterBuffer                   = m_pDrawCountsBuffer;
+        Attribs.CounterOffset                    = Uint64{B.FirstDraw} * sizeof(Uint32);
+        Attribs.CounterBufferStateTransitionMode = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+    }
+    return Attribs;
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
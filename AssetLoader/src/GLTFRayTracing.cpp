@@ -0,0 +1,571 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFRayTracing.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "MapHelper.hpp"
+#include "Align.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+namespace
+{
+
+const VertexAttributeDesc* FindPositionAttribute(const Model& GLTFModel)
+{
+    for (Uint32 i = 0; i < GLTFModel.GetNumVertexAttributes(); ++i)
+    {
+        const auto& Attrib = GLTFModel.GetVertexAttribute(i);
+        if (std::strcmp(Attrib.Name, "POSITION") == 0)
+            return &Attrib;
+    }
+    return nullptr;
+}
+
+// Converts the matrix that transforms row vectors to the 3x4 matrix that transforms column vectors
+InstanceMatrix ToInstanceMatrix(const float4x4& Matrix)
+{
+    InstanceMatrix InstMatrix;
+    for (int r = 0; r < 3; ++r)
+    {
+        for (int c = 0; c < 4; ++c)
+            InstMatrix.data[r][c] = Matrix[c][r];
+    }
+    return InstMatrix;
+}
+
+} // namespace
+
+RayTracingBuilder::RayTracingBuilder(const CreateInfo& CI) :
+    m_pDevice{CI.pDevice},
+    m_CompactBLAS{CI.CompactBLAS}
+{
+    if (!m_pDevice)
+        LOG_ERROR_AND_THROW("Render device must not be null");
+
+    if (!m_pDevice->GetDeviceInfo().Features.RayTracing)
+        LOG_ERROR_AND_THROW("Ray tracing is not supported by the device");
+
+    m_ScratchAlignment = std::max(m_pDevice->GetAdapterInfo().RayTracing.ScratchBufferAlignment, Uint32{1});
+
+    if (m_CompactBLAS)
+    {
+        FenceDesc Desc;
+        Desc.Name = "GLTF BLAS compaction fence";
+        m_pDevice->CreateFence(Desc, &m_pFence);
+        if (!m_pFence)
+            LOG_ERROR_AND_THROW("Failed to create BLAS compaction fence");
+    }
+}
+
+RayTracingBuilder::~RayTracingBuilder()
+{
+}
+
+bool RayTracingBuilder::IsModelSupported(const Model& GLTFModel)
+{
+    const auto* pPosAttrib = FindPositionAttribute(GLTFModel);
+    return (pPosAttrib != nullptr &&
+            pPosAttrib->ValueType == VT_FLOAT32 &&
+            pPosAttrib->NumComponents == 3 &&
+            pPosAttrib->Encoding == VERTEX_ATTRIBUTE_ENCODING_NONE);
+}
+
+const std::vector<std::string>& RayTracingBuilder::GetNames(std::vector<std::string>& Names, const char* Prefix, size_t Count)
+{
+    while (Names.size() < Count)
+        Names.emplace_back(Prefix + std::to_string(Names.size()));
+    return Names;
+}
+
+void RayTracingBuilder::ReserveGeometryNames(const Model& GLTFModel)
+{
+    size_t MaxPrimitives = 0;
+    for (const auto& M : GLTFModel.Meshes)
+        MaxPrimitives = std::max(MaxPrimitives, M.Primitives.size());
+    GetNames(m_GeometryNames, "Primitive ", MaxPrimitives);
+}
+
+Uint64 RayTracingBuilder::AlignScratchSize(Uint64 Size) const
+{
+    return AlignUp(Size, Uint64{m_ScratchAlignment});
+}
+
+IBuffer* RayTracingBuilder::GetScratchBuffer(Uint64 Size)
+{
+    if (!m_pScratchBuffer || m_pScratchBuffer->GetDesc().Size < Size)
+    {
+        BufferDesc BuffDesc;
+        BuffDesc.Name      = "GLTF acceleration structure scratch buffer";
+        BuffDesc.Size      = m_pScratchBuffer ? std::max(Size, m_pScratchBuffer->GetDesc().Size * 2) : Size;
+        BuffDesc.BindFlags = BIND_RAY_TRACING;
+        BuffDesc.Usage     = USAGE_DEFAULT;
+
+        m_pScratchBuffer.Release();
+        m_pDevice->CreateBuffer(BuffDesc, nullptr, &m_pScratchBuffer);
+        if (!m_pScratchBuffer)
+            LOG_ERROR_MESSAGE("Failed to create acceleration structure scratch buffer");
+    }
+    return m_pScratchBuffer;
+}
+
+void RayTracingBuilder::InitGeometries(IDeviceContext* pCtx,
+                                       const Model&    GLTFModel,
+                                       const Mesh&     M,
+                                       IBuffer*        pVertexBuffer,
+                                       Uint64          VertexOffset,
+                                       Uint32          VertexStride,
+                                       MeshGeometries& Geometries)
+{
+    Geometries.Descs.clear();
+    Geometries.Data.clear();
+
+    // Names are reserved by ReserveGeometryNames() before any geometry is initialized,
+    // so that the pointers remain valid until the BLASes are built.
+    VERIFY(m_GeometryNames.size() >= M.Primitives.size(), "Geometry names have not been reserved");
+    const auto& Names      = m_GeometryNames;
+    auto* const pIndBuffer = GLTFModel.GetIndexBuffer(m_pDevice, pCtx);
+    const auto  IndexType  = GLTFModel.GetIndexType();
+    const auto  IndexSize  = GetValueSize(IndexType);
+    for (size_t i = 0; i < M.Primitives.size(); ++i)
+    {
+        const auto& Prim = M.Primitives[i];
+        if (!Prim.HasIndices() || Prim.IndexCount < 3)
+            continue;
+
+        // Primitive indices are relative to the model's base vertex
+        const auto VertexCount = Prim.FirstVertex + Prim.VertexCount;
+
+        BLASTriangleDesc Desc;
+        Desc.GeometryName         = Names[i].c_str();
+        Desc.MaxVertexCount       = VertexCount;
+        Desc.VertexValueType      = VT_FLOAT32;
+        Desc.VertexComponentCount = 3;
+        Desc.MaxPrimitiveCount    = Prim.IndexCount / 3;
+        Desc.IndexType            = IndexType;
+        Geometries.Descs.push_back(Desc);
+
+        const auto& Mat = GLTFModel.Materials[Prim.MaterialId];
+
+        BLASBuildTriangleData Data;
+        Data.GeometryName         = Desc.GeometryName;
+        Data.pVertexBuffer        = pVertexBuffer;
+        Data.VertexOffset         = VertexOffset;
+        Data.VertexStride         = VertexStride;
+        Data.VertexCount          = VertexCount;
+        Data.VertexValueType      = Desc.VertexValueType;
+        Data.VertexComponentCount = Desc.VertexComponentCount;
+        Data.PrimitiveCount       = Desc.MaxPrimitiveCount;
+        Data.pIndexBuffer         = pIndBuffer;
+        Data.IndexOffset          = (Uint64{GLTFModel.GetFirstIndexLocation()} + Prim.FirstIndex) * IndexSize;
+        Data.IndexType            = IndexType;
+        Data.Flags                = Mat.Attribs.AlphaMode == Material::ALPHA_MODE_OPAQUE ? RAYTRACING_GEOMETRY_FLAG_OPAQUE : RAYTRACING_GEOMETRY_FLAG_NONE;
+        Geometries.Data.push_back(Data);
+    }
+}
+
+RefCntAutoPtr<IBottomLevelAS> RayTracingBuilder::CreateBLAS(const char* Name, const MeshGeometries& Geometries, RAYTRACING_BUILD_AS_FLAGS Flags)
+{
+    BottomLevelASDesc Desc;
+    Desc.Name          = Name;
+    Desc.Flags         = Flags;
+    Desc.pTriangles    = Geometries.Descs.data();
+    Desc.TriangleCount = static_cast<Uint32>(Geometries.Descs.size());
+
+    RefCntAutoPtr<IBottomLevelAS> pBLAS;
+    m_pDevice->CreateBLAS(Desc, &pBLAS);
+    if (!pBLAS)
+        LOG_ERROR_MESSAGE("Failed to create ", Name);
+    return pBLAS;
+}
+
+void RayTracingBuilder::BuildBLAS(IDeviceContext* pCtx, IBottomLevelAS* pBLAS, const MeshGeometries& Geometries, Uint64 ScratchOffset, bool Update)
+{
+    BuildBLASAttribs Attribs;
+    Attribs.pBLAS                       = pBLAS;
+    Attribs.BLASTransitionMode          = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+    Attribs.GeometryTransitionMode      = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+    Attribs.pTriangleData               = Geometries.Data.data();
+    Attribs.TriangleDataCount           = static_cast<Uint32>(Geometries.Data.size());
+    Attribs.pScratchBuffer              = m_pScratchBuffer;
+    Attribs.ScratchBufferOffset         = ScratchOffset;
+    Attribs.ScratchBufferTransitionMode = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+    Attribs.Update                      = Update;
+    pCtx->BuildBLAS(Attribs);
+}
+
+void RayTracingBuilder::AddModel(IDeviceContext* pCtx, const Model& GLTFModel)
+{
+    DEV_CHECK_ERR(pCtx != nullptr, "Device context must not be null");
+    if (m_Models.find(&GLTFModel) != m_Models.end() || !GLTFModel.IsGPUDataInitialized())
+        return;
+
+    if (!IsModelSupported(GLTFModel))
+    {
+        LOG_WARNING_MESSAGE("Ray tracing requires three VT_FLOAT32 position components without encoding");
+        return;
+    }
+
+    const auto* pPosAttrib   = FindPositionAttribute(GLTFModel);
+    const auto  BufferId     = pPosAttrib->BufferId;
+    const auto  VertexStride = static_cast<Uint32>(GLTFModel.Buffers[BufferId].ElementStride);
+    const auto  VertexOffset = Uint64{GLTFModel.GetBaseVertex(BufferId)} * VertexStride + pPosAttrib->RelativeOffset;
+    auto* const pVertBuffer  = GLTFModel.GetVertexBuffer(BufferId, m_pDevice, pCtx);
+
+    auto& Entry = m_Models[&GLTFModel];
+    Entry.MeshBLASes.resize(GLTFModel.Meshes.size());
+
+    ReserveGeometryNames(GLTFModel);
+
+    // Create all BLASes first so that the scratch space for all builds can be allocated at once
+    const auto BuildFlags = RAYTRACING_BUILD_AS_PREFER_FAST_TRACE | (m_CompactBLAS ? RAYTRACING_BUILD_AS_ALLOW_COMPACTION : RAYTRACING_BUILD_AS_NONE);
+
+    m_Geometries.resize(std::max(m_Geometries.size(), GLTFModel.Meshes.size()));
+    std::vector<Uint64> ScratchOffsets(GLTFModel.Meshes.size());
+    Uint64              ScratchSize = 0;
+    for (size_t i = 0; i < GLTFModel.Meshes.size(); ++i)
+    {
+        auto& Geometries = m_Geometries[i];
+        InitGeometries(pCtx, GLTFModel, GLTFModel.Meshes[i], pVertBuffer, VertexOffset, VertexStride, Geometries);
+        if (Geometries.Descs.empty())
+            continue;
+
+        Entry.MeshBLASes[i] = CreateBLAS("GLTF mesh BLAS", Geometries, BuildFlags);
+        if (!Entry.MeshBLASes[i])
+            continue;
+
+        ScratchOffsets[i] = ScratchSize;
+        ScratchSize += AlignScratchSize(Entry.MeshBLASes[i]->GetScratchBufferSizes().Build);
+    }
+
+    if (ScratchSize == 0 || GetScratchBuffer(ScratchSize) == nullptr)
+        return;
+
+    // Every build uses its own scratch region, so the builds may run in parallel on the GPU
+    for (size_t i = 0; i < Entry.MeshBLASes.size(); ++i)
+    {
+        if (Entry.MeshBLASes[i])
+            BuildBLAS(pCtx, Entry.MeshBLASes[i], m_Geometries[i], ScratchOffsets[i], false);
+    }
+
+    if (m_CompactBLAS)
+    {
+        BufferDesc BuffDesc;
+        BuffDesc.Name           = "GLTF BLAS compacted sizes";
+        BuffDesc.Size           = sizeof(Uint64) * Entry.MeshBLASes.size();
+        BuffDesc.Usage          = USAGE_STAGING;
+        BuffDesc.CPUAccessFlags = CPU_ACCESS_READ;
+        m_pDevice->CreateBuffer(BuffDesc, nullptr, &Entry.pCompactedSizes);
+        if (!Entry.pCompactedSizes)
+        {
+            LOG_ERROR_MESSAGE("Failed to create BLAS compacted size buffer");
+            return;
+        }
+
+        for (size_t i = 0; i < Entry.MeshBLASes.size(); ++i)
+        {
+            if (!Entry.MeshBLASes[i])
+                continue;
+
+            WriteBLASCompactedSizeAttribs Attribs;
+            Attribs.pBLAS                = Entry.MeshBLASes[i];
+            Attribs.pDestBuffer          = Entry.pCompactedSizes;
+            Attribs.DestBufferOffset     = sizeof(Uint64) * i;
+            Attribs.BLASTransitionMode   = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+            Attribs.BufferTransitionMode = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+            pCtx->WriteBLASCompactedSize(Attribs);
+        }
+
+        Entry.CompactionFenceValue = ++m_FenceValue;
+        pCtx->EnqueueSignal(m_pFence, m_FenceValue);
+    }
+}
+
+void RayTracingBuilder::RemoveModel(const Model& GLTFModel)
+{
+    m_Models.erase(&GLTFModel);
+}
+
+IBottomLevelAS* RayTracingBuilder::GetMeshBLAS(const Model& GLTFModel, Uint32 MeshIndex) const
+{
+    auto it = m_Models.find(&GLTFModel);
+    if (it == m_Models.end() || MeshIndex >= it->second.MeshBLASes.size())
+        return nullptr;
+
+    return it->second.MeshBLASes[MeshIndex];
+}
+
+void RayTracingBuilder::CompactBLASes(IDeviceContext* pCtx)
+{
+    if (!m_CompactBLAS)
+        return;
+
+    const auto CompletedValue = m_pFence->GetCompletedValue();
+    for (auto& it : m_Models)
+    {
+        auto& Entry = it.second;
+        if (!Entry.pCompactedSizes || Entry.CompactionFenceValue > CompletedValue)
+            continue;
+
+        {
+            MapHelper<Uint64> CompactedSizes{pCtx, Entry.pCompactedSizes, MAP_READ, MAP_FLAG_DO_NOT_WAIT};
+            if (!CompactedSizes)
+                continue;
+
+            for (size_t i = 0; i < Entry.MeshBLASes.size(); ++i)
+            {
+                auto& pBLAS = Entry.MeshBLASes[i];
+                if (!pBLAS || CompactedSizes[i] == 0)
+                    continue;
+
+                BottomLevelASDesc Desc;
+                Desc.Name          = "GLTF compacted mesh BLAS";
+                Desc.CompactedSize = CompactedSizes[i];
+
+                RefCntAutoPtr<IBottomLevelAS> pCompactedBLAS;
+                m_pDevice->CreateBLAS(Desc, &pCompactedBLAS);
+                if (!pCompactedBLAS)
+                    continue;
+
+                CopyBLASAttribs Attribs;
+                Attribs.pSrc              = pBLAS;
+                Attribs.pDst              = pCompactedBLAS;
+                Attribs.Mode              = COPY_AS_MODE_COMPACT;
+                Attribs.SrcTransitionMode = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+                Attribs.DstTransitionMode = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+                pCtx->CopyBLAS(Attribs);
+
+                pBLAS = std::move(pCompactedBLAS);
+            }
+        }
+
+        Entry.pCompactedSizes.Release();
+        // TLASes that reference the original BLASes must be rebuilt
+        ++Entry.Version;
+    }
+}
+
+bool RayTracingBuilder::UpdateInstance(IDeviceContext*                      pCtx,
+                                       const Model&                         GLTFModel,
+                                       const ModelTransforms&               Transforms,
+                                       InstanceData&                        Instance,
+                                       ComputeSkinning*                     pSkinning,
+                                       const ComputeSkinning::InstanceData* pSkinnedInstance)
+{
+    DEV_CHECK_ERR(pCtx != nullptr, "Device context must not be null");
+    DEV_CHECK_ERR(GLTFModel.CompatibleWithTransforms(Transforms), "Transforms are not compatible with the model");
+
+    if (!GLTFModel.IsGPUDataInitialized() || !IsModelSupported(GLTFModel))
+        return false;
+
+    if (Instance.pModel != &GLTFModel)
+    {
+        Instance        = {};
+        Instance.pModel = &GLTFModel;
+    }
+
+    AddModel(pCtx, GLTFModel);
+    auto model_it = m_Models.find(&GLTFModel);
+    if (model_it == m_Models.end())
+        return false;
+    const auto& Entry = model_it->second;
+
+    // The BLAS of every node: the mesh BLAS, or the per-instance BLAS if the node is skinned
+    m_NodeBLASes.assign(GLTFModel.LinearNodes.size(), nullptr);
+    for (const auto& N : GLTFModel.LinearNodes)
+    {
+        if (N.pMesh != nullptr)
+            m_NodeBLASes[N.Index] = Entry.MeshBLASes[N.pMesh - GLTFModel.Meshes.data()];
+    }
+
+    bool BLASesCreated = false;
+    if (pSkinning != nullptr && pSkinnedInstance != nullptr && pSkinnedInstance->pModel == &GLTFModel && pSkinnedInstance->pAllocation)
+    {
+        const auto& SkinnedNodes = pSkinnedInstance->Nodes;
+        auto* const pVertBuffer  = pSkinning->GetOutputBuffer(pCtx);
+        const auto  VertexStride = static_cast<Uint32>(sizeof(Model::VertexBasicAttribs));
+
+        ReserveGeometryNames(GLTFModel);
+
+        // The BLAS is built the first time and is refit afterwards
+        std::vector<bool> RefitBLAS(SkinnedNodes.size());
+
+        Instance.SkinnedBLASes.resize(SkinnedNodes.size());
+        m_Geometries.resize(std::max(m_Geometries.size(), SkinnedNodes.size()));
+        std::vector<Uint64> ScratchOffsets(SkinnedNodes.size());
+        Uint64              ScratchSize = 0;
+        for (size_t i = 0; i < SkinnedNodes.size(); ++i)
+        {
+            const auto& SkinnedNode = SkinnedNodes[i];
+            const auto& N           = GLTFModel.LinearNodes[SkinnedNode.NodeIndex];
+
+            auto& Geometries = m_Geometries[i];
+            Geometries.Descs.clear();
+            Geometries.Data.clear();
+
+            // Geometry offsets can't be negative, so nodes whose output base vertex wraps
+            // around keep using the static mesh BLAS.
+            if (static_cast<Int32>(SkinnedNode.BaseVertex) < 0)
+                continue;
+
+            InitGeometries(pCtx, GLTFModel, *N.pMesh, pVertBuffer, Uint64{SkinnedNode.BaseVertex} * VertexStride, VertexStride, Geometries);
+            if (Geometries.Descs.empty())
+                continue;
+
+            auto& pBLAS = Instance.SkinnedBLASes[i];
+            if (pBLAS)
+            {
+                RefitBLAS[i] = true;
+            }
+            else
+            {
+                pBLAS = CreateBLAS("GLTF skinned BLAS", Geometries, RAYTRACING_BUILD_AS_ALLOW_UPDATE | RAYTRACING_BUILD_AS_PREFER_FAST_BUILD);
+                if (!pBLAS)
+                    continue;
+                BLASesCreated = true;
+            }
+
+            ScratchOffsets[i] = ScratchSize;
+            const auto& Sizes = pBLAS->GetScratchBufferSizes();
+            ScratchSize += AlignScratchSize(RefitBLAS[i] ? Sizes.Update : Sizes.Build);
+        }
+
+        if (ScratchSize > 0 && GetScratchBuffer(ScratchSize) != nullptr)
+        {
+            for (size_t i = 0; i < SkinnedNodes.size(); ++i)
+            {
+                auto& pBLAS = Instance.SkinnedBLASes[i];
+                if (!pBLAS || m_Geometries[i].Descs.empty())
+                    continue;
+
+                // Skinned vertices change every frame, while the topology does not, so the BLAS is refit
+                BuildBLAS(pCtx, pBLAS, m_Geometries[i], ScratchOffsets[i], RefitBLAS[i]);
+                m_NodeBLASes[SkinnedNodes[i].NodeIndex] = pBLAS;
+            }
+        }
+    }
+
+    // TLAS instances: one per node, or one per GPU instance of the node
+    Uint32 NumInstances = 0;
+    for (const auto& N : GLTFModel.LinearNodes)
+    {
+        if (m_NodeBLASes[N.Index] != nullptr)
+            NumInstances += std::max(N.NumInstances, 1u);
+    }
+    if (NumInstances == 0)
+        return false;
+
+    const auto& Names = GetNames(m_InstanceNames, "Instance ", NumInstances);
+    m_TLASInstances.resize(NumInstances);
+    Uint32 InstIdx = 0;
+    for (const auto& N : GLTFModel.LinearNodes)
+    {
+        auto* const pBLAS = m_NodeBLASes[N.Index];
+        if (pBLAS == nullptr)
+            continue;
+
+        const auto& NodeMatrix = Transforms.NodeGlobalMatrices[N.Index];
+        for (Uint32 i = 0; i < std::max(N.NumInstances, 1u); ++i, ++InstIdx)
+        {
+            auto& Inst        = m_TLASInstances[InstIdx];
+            Inst.InstanceName = Names[InstIdx].c_str();
+            Inst.pBLAS        = pBLAS;
+            Inst.Transform    = ToInstanceMatrix(N.NumInstances > 0 ? GLTFModel.InstanceMatrices[N.FirstInstance + i] * NodeMatrix : NodeMatrix);
+            Inst.CustomId     = static_cast<Uint32>(N.Index);
+            Inst.Mask         = 0xFF;
+        }
+    }
+    VERIFY_EXPR(InstIdx == NumInstances);
+
+    // The TLAS can only be refit if it references the same BLASes
+    bool Update = (Instance.pTLAS &&
+                   !BLASesCreated &&
+                   Instance.BLASVersion == Entry.Version &&
+                   Instance.pTLAS->GetDesc().MaxInstanceCount == NumInstances);
+    if (!Instance.pTLAS || Instance.pTLAS->GetDesc().MaxInstanceCount != NumInstances)
+    {
+        Instance.pTLAS.Release();
+        Instance.pInstanceBuffer.Release();
+
+        TopLevelASDesc Desc;
+        Desc.Name             = "GLTF TLAS";
+        Desc.MaxInstanceCount = NumInstances;
+        Desc.Flags            = RAYTRACING_BUILD_AS_ALLOW_UPDATE | RAYTRACING_BUILD_AS_PREFER_FAST_TRACE;
+        m_pDevice->CreateTLAS(Desc, &Instance.pTLAS);
+        if (!Instance.pTLAS)
+        {
+            LOG_ERROR_MESSAGE("Failed to create TLAS");
+            return false;
+        }
+
+        BufferDesc BuffDesc;
+        BuffDesc.Name      = "GLTF TLAS instance buffer";
+        BuffDesc.Size      = Uint64{TLAS_INSTANCE_DATA_SIZE} * NumInstances;
+        BuffDesc.BindFlags = BIND_RAY_TRACING;
+        BuffDesc.Usage     = USAGE_DEFAULT;
+        m_pDevice->CreateBuffer(BuffDesc, nullptr, &Instance.pInstanceBuffer);
+        if (!Instance.pInstanceBuffer)
+        {
+            LOG_ERROR_MESSAGE("Failed to create TLAS instance buffer");
+            Instance.pTLAS.Release();
+            return false;
+        }
+        Update = false;
+    }
+
+    const auto& ScratchSizes = Instance.pTLAS->GetScratchBufferSizes();
+    if (GetScratchBuffer(Update ? ScratchSizes.Update : ScratchSizes.Build) == nullptr)
+        return false;
+
+    BuildTLASAttribs Attribs;
+    Attribs.pTLAS                        = Instance.pTLAS;
+    Attribs.pInstances                   = m_TLASInstances.data();
+    Attribs.InstanceCount                = NumInstances;
+    Attribs.pInstanceBuffer              = Instance.pInstanceBuffer;
+    Attribs.InstanceBufferTransitionMode = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+    Attribs.TLASTransitionMode           = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+    Attribs.BLASTransitionMode           = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+    Attribs.pScratchBuffer               = m_pScratchBuffer;
+    Attribs.ScratchBufferTransitionMode  = RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+    Attribs.Update                       = Update;
+    pCtx->BuildTLAS(Attribs);
+
+    Instance.BLASVersion = Entry.Version;
+
+    return true;
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -26,9 +26,13 @@
  */
 
 #include "GLTFResourceManager.hpp"
+
+#include <cstring>
+
 #include "DefaultRawMemoryAllocator.hpp"
 #include "Align.hpp"
 #include "GraphicsAccessories.hpp"
+#include "RingBuffer.hpp"
 
 namespace Diligent
 {
@@ -36,6 +40,39 @@ namespace Diligent
 namespace GLTF
 {
 
+RefCntAutoPtr<ISampler> SamplerCache::GetSampler(IRenderDevice* pDevice, const SamplerDesc& Desc)
+{
+    // The key must not reference the name string, which is not owned by the cache
+    SamplerDesc Key{Desc};
+    Key.Name = nullptr;
+
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+
+    auto it = m_Samplers.find(Key);
+    if (it != m_Samplers.end())
+    {
+        if (auto pSampler = it->second.Lock())
+            return pSampler;
+    }
+
+    RefCntAutoPtr<ISampler> pSampler;
+    pDevice->CreateSampler(Desc, &pSampler);
+    if (!pSampler)
+        return {};
+
+    if (it != m_Samplers.end())
+    {
+        it->second = RefCntWeakPtr<ISampler>{pSampler};
+    }
+    else
+    {
+        PruneExpiredCacheEntries(m_Samplers, m_PruneThreshold);
+        m_Samplers.emplace(Key, RefCntWeakPtr<ISampler>{pSampler});
+    }
+
+    return pSampler;
+}
+
 RefCntAutoPtr<ResourceManager> ResourceManager::Create(IRenderDevice*    pDevice,
                                                        const CreateInfo& CI)
 {
@@ -47,7 +84,8 @@ ResourceManager::ResourceManager(IReferenceCounters* pRefCounters,
                                  const CreateInfo&   CI) :
     TBase{pRefCounters},
     m_DefaultAtlasDesc{CI.DefaultAtlasDesc},
-    m_DefaultAtlasName{CI.DefaultAtlasDesc.Desc.Name != nullptr ? CI.DefaultAtlasDesc.Desc.Name : "GLTF texture atlas"}
+    m_DefaultAtlasName{CI.DefaultAtlasDesc.Desc.Name != nullptr ? CI.DefaultAtlasDesc.Desc.Name : "GLTF texture atlas"},
+    m_TextureRetentionBudget{CI.TextureRetentionBudget}
 {
     if (m_DefaultAtlasDesc.Desc.Type != RESOURCE_DIM_TEX_2D &&
         m_DefaultAtlasDesc.Desc.Type != RESOURCE_DIM_TEX_2D_ARRAY &&
@@ -71,15 +109,95 @@ ResourceManager::ResourceManager(IReferenceCounters* pRefCounters,
         CreateBufferSuballocator(pDevice, CI.BuffSuballocators[i], &m_BufferSuballocators[i]);
     }
 
+    if (CI.StagingBufferSize > 0)
+    {
+        BufferDesc StagingDesc;
+        StagingDesc.Name                 = "GLTF staging buffer";
+        StagingDesc.Size                 = CI.StagingBufferSize;
+        StagingDesc.Usage                = USAGE_STAGING;
+        StagingDesc.CPUAccessFlags       = CPU_ACCESS_WRITE;
+        StagingDesc.ImmediateContextMask = CI.StagingImmediateContextMask;
+        pDevice->CreateBuffer(StagingDesc, nullptr, &m_pStagingBuffer);
+
+        FenceDesc StagingFenceDesc;
+        StagingFenceDesc.Name = "GLTF staging fence";
+        pDevice->CreateFence(StagingFenceDesc, &m_pStagingFence);
+
+        if (m_pStagingBuffer && m_pStagingFence)
+        {
+            m_pStagingRing.reset(new RingBuffer{static_cast<RingBuffer::OffsetType>(CI.StagingBufferSize), DefaultRawMemoryAllocator::GetAllocator()});
+        }
+        else
+        {
+            LOG_ERROR_MESSAGE("Failed to create the staging buffer. Buffer data will be uploaded with UpdateBuffer().");
+            m_pStagingBuffer.Release();
+            m_pStagingFence.Release();
+        }
+    }
+
+    std::lock_guard<std::mutex> Lock{m_AtlasesMtx};
     m_Atlases.reserve(CI.NumTexAtlases);
     for (Uint32 i = 0; i < CI.NumTexAtlases; ++i)
     {
+        const auto Fmt = CI.TexAtlases[i].Desc.Format;
+        if (m_Atlases.find(Fmt) != m_Atlases.end())
+        {
+            LOG_WARNING_MESSAGE("More than one texture atlas is provided for format ", GetTextureFormatAttribs(Fmt).Name, ". Only the first one will be used.");
+            continue;
+        }
+
         RefCntAutoPtr<IDynamicTextureAtlas> pAtlas;
         CreateDynamicTextureAtlas(pDevice, CI.TexAtlases[i], &pAtlas);
-        m_Atlases.emplace(CI.TexAtlases[i].Desc.Format, std::move(pAtlas));
+        if (!pAtlas)
+            continue;
+
+        RegisterAtlas(Fmt, pAtlas);
+        m_Atlases.emplace(Fmt, std::move(pAtlas));
     }
 }
 
+ResourceManager::~ResourceManager()
+{
+}
+
+void ResourceManager::RegisterAtlas(TEXTURE_FORMAT Fmt, IDynamicTextureAtlas* pAtlas)
+{
+    VERIFY_EXPR(Fmt < TEX_FORMAT_NUM_FORMATS && pAtlas != nullptr);
+    VERIFY(m_AtlasPtrs[Fmt].load() == nullptr, "Atlas for this format has already been registered");
+
+    const auto NumAtlases = m_NumAtlases.load(std::memory_order_relaxed);
+    VERIFY_EXPR(NumAtlases < m_AtlasList.size());
+    m_AtlasList[NumAtlases].store(pAtlas, std::memory_order_relaxed);
+    // Release stores make the atlas object visible to the threads that acquire the pointers
+    m_NumAtlases.store(NumAtlases + 1, std::memory_order_release);
+    m_AtlasPtrs[Fmt].store(pAtlas, std::memory_order_release);
+}
+
+RefCntAutoPtr<ITextureAtlasSuballocation> ResourceManager::FindAllocationLocked(const char* CacheId)
+{
+    RefCntAutoPtr<ITextureAtlasSuballocation> pAllocation;
+
+    auto it = m_TexAllocations.find(CacheId);
+    if (it != m_TexAllocations.end())
+    {
+        pAllocation = it->second.Lock();
+        if (!pAllocation)
+            m_TexAllocations.erase(it);
+    }
+
+    if (pAllocation)
+    {
+        ++m_TexCacheStats.NumHits;
+        m_RetainedTexAllocations.Touch(it->first);
+    }
+    else
+    {
+        ++m_TexCacheStats.NumMisses;
+    }
+
+    return pAllocation;
+}
+
 RefCntAutoPtr<ITextureAtlasSuballocation> ResourceManager::FindAllocation(const char* CacheId)
 {
     RefCntAutoPtr<ITextureAtlasSuballocation> pAllocation;
@@ -87,19 +205,80 @@ RefCntAutoPtr<ITextureAtlasSuballocation> ResourceManager::FindAllocation(const
     if (CacheId != nullptr && *CacheId != 0)
     {
         std::lock_guard<std::mutex> Lock{m_TexAllocationsMtx};
-
-        auto it = m_TexAllocations.find(CacheId);
-        if (it != m_TexAllocations.end())
-        {
-            pAllocation = it->second.Lock();
-            if (!pAllocation)
-                m_TexAllocations.erase(it);
-        }
+        pAllocation = FindAllocationLocked(CacheId);
     }
 
     return pAllocation;
 }
 
+void ResourceManager::SetTextureRetentionBudget(Uint64 Budget)
+{
+    std::lock_guard<std::mutex> Lock{m_TexAllocationsMtx};
+    m_TextureRetentionBudget = Budget;
+    m_RetainedTexAllocations.Trim(Budget);
+}
+
+TextureCacheStats ResourceManager::GetTextureCacheStats()
+{
+    std::lock_guard<std::mutex> Lock{m_TexAllocationsMtx};
+
+    auto Stats         = m_TexCacheStats;
+    Stats.NumEvictions = m_RetainedTexAllocations.GetNumEvictions();
+    Stats.NumRetained  = m_RetainedTexAllocations.GetCount();
+    Stats.RetainedSize = m_RetainedTexAllocations.GetSize();
+    return Stats;
+}
+
+IDynamicTextureAtlas* ResourceManager::CreateAtlasLocked(TEXTURE_FORMAT Fmt)
+{
+    auto cache_it = m_Atlases.find(Fmt);
+    if (cache_it == m_Atlases.end())
+    {
+        // clang-format off
+        DEV_CHECK_ERR(m_DefaultAtlasDesc.Desc.Width  > 0 &&
+                      m_DefaultAtlasDesc.Desc.Height > 0 &&
+                      m_DefaultAtlasDesc.Desc.Type   != RESOURCE_DIM_UNDEFINED,
+                      "Default texture description is not initialized");
+        // clang-format on
+
+        auto AtalsCreateInfo        = m_DefaultAtlasDesc;
+        AtalsCreateInfo.Desc.Format = Fmt;
+
+        RefCntAutoPtr<IDynamicTextureAtlas> pNewAtlas;
+        CreateDynamicTextureAtlas(nullptr, AtalsCreateInfo, &pNewAtlas);
+        DEV_CHECK_ERR(pNewAtlas, "Failed to create new texture atlas");
+
+        RegisterAtlas(Fmt, pNewAtlas);
+        cache_it = m_Atlases.emplace(Fmt, std::move(pNewAtlas)).first;
+    }
+    return cache_it->second;
+}
+
+void ResourceManager::AddAllocationToCacheLocked(const char* CacheId, ITextureAtlasSuballocation* pAllocation, Uint32 Width, Uint32 Height)
+{
+    // Estimate the allocation size for the retention budget
+    const auto  AtlasDesc  = pAllocation->GetAtlas()->GetAtlasDesc();
+    const auto& FmtAttribs = GetTextureFormatAttribs(AtlasDesc.Format);
+
+    Uint64 AllocSize = 0;
+    for (Uint32 mip = 0; mip < std::max(AtlasDesc.MipLevels, 1u); ++mip)
+    {
+        const auto MipW = std::max(Width >> mip, 1u);
+        const auto MipH = std::max(Height >> mip, 1u);
+        if (FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED)
+            AllocSize += Uint64{(MipW + FmtAttribs.BlockWidth - 1u) / FmtAttribs.BlockWidth} * Uint64{(MipH + FmtAttribs.BlockHeight - 1u) / FmtAttribs.BlockHeight} * FmtAttribs.ComponentSize;
+        else
+            AllocSize += Uint64{MipW} * Uint64{MipH} * FmtAttribs.ComponentSize * FmtAttribs.NumComponents;
+    }
+
+    PruneExpiredCacheEntries(m_TexAllocations, m_TexAllocationsPruneThreshold);
+    // Note that the same allocation may potentially be created by more
+    // than one thread if it has not been found in the cache originally
+    auto it = m_TexAllocations.emplace(CacheId, pAllocation);
+    if (it.second)
+        m_RetainedTexAllocations.Retain(CacheId, pAllocation, AllocSize, m_TextureRetentionBudget);
+}
+
 RefCntAutoPtr<ITextureAtlasSuballocation> ResourceManager::AllocateTextureSpace(
     TEXTURE_FORMAT Fmt,
     Uint32         Width,
@@ -115,45 +294,244 @@ RefCntAutoPtr<ITextureAtlasSuballocation> ResourceManager::AllocateTextureSpace(
 
     if (!pAllocation)
     {
-        decltype(m_Atlases)::iterator cache_it; // NB: can't initialize it without locking the mutex
+        auto* pAtlas = GetAtlas(Fmt);
+        if (pAtlas == nullptr)
         {
             std::lock_guard<std::mutex> Lock{m_AtlasesMtx};
-            cache_it = m_Atlases.find(Fmt);
-            if (cache_it == m_Atlases.end())
-            {
-                // clang-format off
-                DEV_CHECK_ERR(m_DefaultAtlasDesc.Desc.Width  > 0 &&
-                              m_DefaultAtlasDesc.Desc.Height > 0 &&
-                              m_DefaultAtlasDesc.Desc.Type   != RESOURCE_DIM_UNDEFINED,
-                              "Default texture description is not initialized");
-                // clang-format on
+            pAtlas = CreateAtlasLocked(Fmt);
+        }
+        // Allocate outside of mutex
+        pAtlas->Allocate(Width, Height, &pAllocation);
+        pAllocation->SetUserData(pUserData);
+    }
 
-                auto AtalsCreateInfo        = m_DefaultAtlasDesc;
-                AtalsCreateInfo.Desc.Format = Fmt;
+    if (CacheId != nullptr && *CacheId != 0 && pAllocation)
+    {
+        std::lock_guard<std::mutex> Lock{m_TexAllocationsMtx};
+        AddAllocationToCacheLocked(CacheId, pAllocation, Width, Height);
+    }
 
-                RefCntAutoPtr<IDynamicTextureAtlas> pAtlas;
-                CreateDynamicTextureAtlas(nullptr, AtalsCreateInfo, &pAtlas);
-                DEV_CHECK_ERR(pAtlas, "Failed to create new texture atlas");
+    return pAllocation;
+}
 
-                cache_it = m_Atlases.emplace(Fmt, std::move(pAtlas)).first;
+void ResourceManager::AllocateTextureSpace(const TextureSpaceRequest*                 pRequests,
+                                           Uint32                                     NumRequests,
+                                           RefCntAutoPtr<ITextureAtlasSuballocation>* pAllocations)
+{
+    DEV_CHECK_ERR(NumRequests == 0 || (pRequests != nullptr && pAllocations != nullptr), "Requests and allocations must not be null");
+
+    const auto HasCacheId = [pRequests](Uint32 i) {
+        return pRequests[i].CacheId != nullptr && *pRequests[i].CacheId != 0;
+    };
+
+    // Requests that are not found in the cache. Requests with the same cache id share the allocation
+    // of the first one, which is kept in the map.
+    std::vector<Uint32>                     NewRequests;
+    std::unordered_map<std::string, Uint32> FirstRequestIds;
+    std::vector<std::pair<Uint32, Uint32>>  SharedRequests; // {Request, Request whose allocation it shares}
+    NewRequests.reserve(NumRequests);
+    {
+        std::lock_guard<std::mutex> Lock{m_TexAllocationsMtx};
+        for (Uint32 i = 0; i < NumRequests; ++i)
+        {
+            pAllocations[i].Release();
+            if (HasCacheId(i))
+            {
+                auto it = FirstRequestIds.emplace(pRequests[i].CacheId, i);
+                if (!it.second)
+                {
+                    SharedRequests.emplace_back(i, it.first->second);
+                    continue;
+                }
+                pAllocations[i] = FindAllocationLocked(pRequests[i].CacheId);
             }
+            if (!pAllocations[i])
+                NewRequests.push_back(i);
         }
-        // Allocate outside of mutex
-        cache_it->second->Allocate(Width, Height, &pAllocation);
-        pAllocation->SetUserData(pUserData);
     }
 
+    // Create missing atlases under a single lock
+    std::array<IDynamicTextureAtlas*, TEX_FORMAT_NUM_FORMATS> Atlases{};
+    bool                                                      HasMissingAtlases = false;
+    for (auto i : NewRequests)
+    {
+        const auto Fmt = pRequests[i].Fmt;
+        DEV_CHECK_ERR(Fmt < TEX_FORMAT_NUM_FORMATS, "Invalid texture format");
+        Atlases[Fmt] = GetAtlas(Fmt);
+        HasMissingAtlases |= (Atlases[Fmt] == nullptr);
+    }
+    if (HasMissingAtlases)
+    {
+        std::lock_guard<std::mutex> Lock{m_AtlasesMtx};
+        for (auto i : NewRequests)
+        {
+            auto& pAtlas = Atlases[pRequests[i].Fmt];
+            if (pAtlas == nullptr)
+                pAtlas = CreateAtlasLocked(pRequests[i].Fmt);
+        }
+    }
+
+    // Allocate from the largest to the smallest request, which packs the atlas much
+    // better than the arbitrary order in which the textures are listed.
+    std::stable_sort(NewRequests.begin(), NewRequests.end(), [pRequests](Uint32 i0, Uint32 i1) {
+        const auto& R0 = pRequests[i0];
+        const auto& R1 = pRequests[i1];
+        const auto  S0 = std::max(R0.Width, R0.Height);
+        const auto  S1 = std::max(R1.Width, R1.Height);
+        if (S0 != S1)
+            return S0 > S1;
+        return Uint64{R0.Width} * R0.Height > Uint64{R1.Width} * R1.Height;
+    });
+    for (auto i : NewRequests)
+    {
+        const auto& Req = pRequests[i];
+        Atlases[Req.Fmt]->Allocate(Req.Width, Req.Height, &pAllocations[i]);
+        if (pAllocations[i])
+            pAllocations[i]->SetUserData(Req.pUserData);
+    }
+
+    for (const auto& Shared : SharedRequests)
+        pAllocations[Shared.first] = pAllocations[Shared.second];
+
+    std::lock_guard<std::mutex> Lock{m_TexAllocationsMtx};
+    for (auto i : NewRequests)
+    {
+        if (HasCacheId(i) && pAllocations[i])
+            AddAllocationToCacheLocked(pRequests[i].CacheId, pAllocations[i], pRequests[i].Width, pRequests[i].Height);
+    }
+}
+
+RefCntAutoPtr<IBufferSuballocation> ResourceManager::FindBufferAllocation(const char* CacheId)
+{
+    RefCntAutoPtr<IBufferSuballocation> pAllocation;
+
     if (CacheId != nullptr && *CacheId != 0)
     {
-        std::lock_guard<std::mutex> Lock{m_TexAllocationsMtx};
-        // Note that the same allocation may potentially be created by more
-        // than one thread if it has not been found in the cache originally
-        m_TexAllocations.emplace(CacheId, pAllocation);
+        std::lock_guard<std::mutex> Lock{m_BuffAllocationsMtx};
+
+        auto it = m_BuffAllocations.find(CacheId);
+        if (it != m_BuffAllocations.end())
+        {
+            pAllocation = it->second.Lock();
+            if (!pAllocation)
+                m_BuffAllocations.erase(it);
+        }
     }
 
     return pAllocation;
 }
 
+RefCntAutoPtr<IBufferSuballocation> ResourceManager::AllocateBufferSpace(Uint32      BufferIndex,
+                                                                         Uint32      Size,
+                                                                         Uint32      Alignment,
+                                                                         const char* CacheId,
+                                                                         IObject*    pUserData)
+{
+    RefCntAutoPtr<IBufferSuballocation> pAllocation;
+    if (CacheId != nullptr && *CacheId != 0)
+    {
+        pAllocation = FindBufferAllocation(CacheId);
+        if (pAllocation)
+        {
+            VERIFY(pAllocation->GetSize() == Size, "The size of the cached allocation does not match the requested size. This may be the result of a cache id collision.");
+            return pAllocation;
+        }
+    }
+
+    m_BufferSuballocators[BufferIndex]->Allocate(Size, Alignment, &pAllocation);
+    if (!pAllocation)
+        return pAllocation;
+
+    pAllocation->SetUserData(pUserData);
+
+    if (CacheId != nullptr && *CacheId != 0)
+    {
+        std::lock_guard<std::mutex> Lock{m_BuffAllocationsMtx};
+        PruneExpiredCacheEntries(m_BuffAllocations, m_BuffAllocationsPruneThreshold);
+        // Similar to textures, the same allocation may potentially be created by
+        // more than one thread. Only the first one is added to the cache.
+        m_BuffAllocations.emplace(CacheId, pAllocation);
+    }
+
+    return pAllocation;
+}
+
+Uint64 ResourceManager::UploadBufferData(IDeviceContext* pCtx,
+                                         IBuffer*        pDstBuffer,
+                                         Uint64          DstOffset,
+                                         const void*     pData,
+                                         Uint64          Size)
+{
+    DEV_CHECK_ERR(pCtx != nullptr && pDstBuffer != nullptr, "Context and destination buffer must not be null");
+
+    if (!m_pStagingRing)
+    {
+        pCtx->UpdateBuffer(pDstBuffer, DstOffset, Size, pData, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        return Size;
+    }
+
+    // Slices smaller than this are not worth a separate copy command
+    constexpr Uint64 MinSliceSize     = 4096;
+    constexpr Uint64 StagingAlignment = 16;
+
+    std::lock_guard<std::mutex> Lock{m_StagingMtx};
+
+    m_pStagingRing->ReleaseCompletedFrames(m_pStagingFence->GetCompletedValue());
+
+    const auto* pSrcData     = static_cast<const Uint8*>(pData);
+    Uint64      UploadedSize = 0;
+    void*       pMappedData  = nullptr;
+    while (UploadedSize < Size)
+    {
+        // The free space may be split into two parts by the end of the ring,
+        // so smaller slices are tried if the largest one does not fit.
+        const auto FreeSize  = Uint64{m_pStagingRing->GetMaxSize() - m_pStagingRing->GetUsedSize()};
+        auto       SliceSize = std::min(Size - UploadedSize, FreeSize);
+        auto       SrcOffset = RingBuffer::InvalidOffset;
+        while (SliceSize > 0)
+        {
+            SrcOffset = m_pStagingRing->Allocate(static_cast<RingBuffer::OffsetType>(SliceSize), StagingAlignment);
+            if (SrcOffset != RingBuffer::InvalidOffset || SliceSize <= MinSliceSize)
+                break;
+            SliceSize /= 2;
+        }
+        if (SrcOffset == RingBuffer::InvalidOffset)
+            break;
+
+        if (pMappedData == nullptr)
+        {
+            pCtx->MapBuffer(m_pStagingBuffer, MAP_WRITE, MAP_FLAG_NONE, pMappedData);
+            if (pMappedData == nullptr)
+            {
+                LOG_ERROR_MESSAGE("Failed to map the staging buffer");
+                break;
+            }
+        }
+        memcpy(static_cast<Uint8*>(pMappedData) + SrcOffset, pSrcData + UploadedSize, static_cast<size_t>(SliceSize));
+        pCtx->CopyBuffer(m_pStagingBuffer, SrcOffset, RESOURCE_STATE_TRANSITION_MODE_TRANSITION,
+                         pDstBuffer, DstOffset + UploadedSize, SliceSize, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+        UploadedSize += SliceSize;
+        m_HasPendingStagingData = true;
+    }
+
+    if (pMappedData != nullptr)
+        pCtx->UnmapBuffer(m_pStagingBuffer, MAP_WRITE);
+
+    return UploadedSize;
+}
+
+void ResourceManager::FinishStagingUploads(IDeviceContext* pCtx)
+{
+    std::lock_guard<std::mutex> Lock{m_StagingMtx};
+    if (!m_pStagingRing || !m_HasPendingStagingData)
+        return;
+
+    pCtx->EnqueueSignal(m_pStagingFence, ++m_StagingFenceValue);
+    m_pStagingRing->FinishCurrentFrame(m_StagingFenceValue);
+    m_HasPendingStagingData = false;
+}
+
 } // namespace GLTF
 
 } // namespace Diligent
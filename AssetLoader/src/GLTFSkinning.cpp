@@ -0,0 +1,628 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "GLTFSkinning.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "MapHelper.hpp"
+
+namespace Diligent
+{
+
+namespace GLTF
+{
+
+namespace
+{
+
+// Must match the numthreads attribute in the shader
+static constexpr Uint32 SkinningThreadGroupSize = 64;
+
+// Attributes are declared as scalars so that the structure layout
+// matches Model::VertexBasicAttribs in all backends.
+static constexpr char SkinningCS[] = R"(
+struct BasicAttribs
+{
+    float PosX;
+    float PosY;
+    float PosZ;
+    float NormalX;
+    float NormalY;
+    float NormalZ;
+    float UV0X;
+    float UV0Y;
+    float UV1X;
+    float UV1Y;
+};
+
+struct SkinAttribs
+{
+    float4 Joints;
+    float4 Weights;
+};
+
+// Compact affine joint matrix, see JointMatrix3x4
+struct JointMatrix
+{
+    float4 Row0;
+    float4 Row1;
+    float4 Row2;
+};
+
+// Packed MorphTargetDelta: the vertex index followed by
+// three position and three normal half-precision deltas.
+struct MorphDelta
+{
+    uint Vertex;
+    uint PosXY;
+    uint PosZNormalX;
+    uint NormalYZ;
+};
+
+// Morph target with a non-zero weight
+struct ActiveMorphTarget
+{
+    uint  FirstDelta;
+    uint  NumDeltas;
+    float Weight;
+    uint  Padding;
+};
+
+cbuffer cbSkinningAttribs
+{
+    uint g_SrcBasicFirstVertex;
+    uint g_SrcSkinFirstVertex;
+    uint g_DstFirstVertex;
+    uint g_NumVertices;
+
+    uint g_FirstJoint;
+    uint g_NumJoints;
+    uint g_MeshFirstVertex;
+    uint g_FirstMorphTarget;
+
+    uint g_NumMorphTargets;
+    uint g_Padding0;
+    uint g_Padding1;
+    uint g_Padding2;
+};
+
+StructuredBuffer<BasicAttribs>      g_SrcBasicAttribs;
+StructuredBuffer<SkinAttribs>       g_SrcSkinAttribs;
+StructuredBuffer<JointMatrix>       g_JointMatrices;
+StructuredBuffer<MorphDelta>        g_MorphDeltas;
+StructuredBuffer<ActiveMorphTarget> g_MorphTargets;
+RWStructuredBuffer<BasicAttribs>    g_DstBasicAttribs;
+
+// Deltas of the target are sorted by the vertex index. Returns the index of the vertex
+// delta, or -1 if the vertex is not displaced by the target.
+int FindMorphDelta(ActiveMorphTarget Target, uint Vertex)
+{
+    uint First = Target.FirstDelta;
+    uint Count = Target.NumDeltas;
+    while (Count > 0u)
+    {
+        uint Step = Count / 2u;
+        if (g_MorphDeltas[First + Step].Vertex < Vertex)
+        {
+            First += Step + 1u;
+            Count -= Step + 1u;
+        }
+        else
+        {
+            Count = Step;
+        }
+    }
+    return (First < Target.FirstDelta + Target.NumDeltas && g_MorphDeltas[First].Vertex == Vertex) ? int(First) : -1;
+}
+
+[numthreads(64, 1, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    uint Vert = DTid.x;
+    if (Vert >= g_NumVertices)
+        return;
+
+    BasicAttribs Src  = g_SrcBasicAttribs[g_SrcBasicFirstVertex + Vert];
+    SkinAttribs  Skin = g_SrcSkinAttribs[g_SrcSkinFirstVertex + Vert];
+
+    float3 Pos    = float3(Src.PosX, Src.PosY, Src.PosZ);
+    float3 Normal = float3(Src.NormalX, Src.NormalY, Src.NormalZ);
+
+    // Morph targets are applied before skinning
+    for (uint t = 0u; t < g_NumMorphTargets; ++t)
+    {
+        ActiveMorphTarget Target = g_MorphTargets[g_FirstMorphTarget + t];
+
+        int DeltaIdx = FindMorphDelta(Target, g_MeshFirstVertex + Vert);
+        if (DeltaIdx < 0)
+            continue;
+
+        MorphDelta Delta = g_MorphDeltas[DeltaIdx];
+        Pos    += Target.Weight * float3(f16tof32(Delta.PosXY), f16tof32(Delta.PosXY >> 16u), f16tof32(Delta.PosZNormalX));
+        Normal += Target.Weight * float3(f16tof32(Delta.PosZNormalX >> 16u), f16tof32(Delta.NormalYZ), f16tof32(Delta.NormalYZ >> 16u));
+    }
+
+    float3 SkinnedPos    = float3(0.0, 0.0, 0.0);
+    float3 SkinnedNormal = float3(0.0, 0.0, 0.0);
+    float  WeightSum     = 0.0;
+    for (int i = 0; i < 4 && g_NumJoints > 0u; ++i)
+    {
+        float Weight = Skin.Weights[i];
+        if (Weight == 0.0)
+            continue;
+
+        uint        Joint = min(uint(Skin.Joints[i]), g_NumJoints - 1u);
+        JointMatrix M     = g_JointMatrices[g_FirstJoint + Joint];
+
+        SkinnedPos    += Weight * float3(dot(M.Row0, float4(Pos, 1.0)), dot(M.Row1, float4(Pos, 1.0)), dot(M.Row2, float4(Pos, 1.0)));
+        SkinnedNormal += Weight * float3(dot(M.Row0.xyz, Normal), dot(M.Row1.xyz, Normal), dot(M.Row2.xyz, Normal));
+        WeightSum     += Weight;
+    }
+
+    if (WeightSum == 0.0)
+    {
+        SkinnedPos    = Pos;
+        SkinnedNormal = Normal;
+    }
+
+    float NormalLen = length(SkinnedNormal);
+    if (NormalLen > 0.0)
+        SkinnedNormal /= NormalLen;
+
+    BasicAttribs Dst = Src;
+    Dst.PosX    = SkinnedPos.x;
+    Dst.PosY    = SkinnedPos.y;
+    Dst.PosZ    = SkinnedPos.z;
+    Dst.NormalX = SkinnedNormal.x;
+    Dst.NormalY = SkinnedNormal.y;
+    Dst.NormalZ = SkinnedNormal.z;
+    g_DstBasicAttribs[g_DstFirstVertex + Vert] = Dst;
+}
+)";
+
+struct SkinningAttribs
+{
+    Uint32 SrcBasicFirstVertex;
+    Uint32 SrcSkinFirstVertex;
+    Uint32 DstFirstVertex;
+    Uint32 NumVertices;
+
+    Uint32 FirstJoint;
+    Uint32 NumJoints;
+    Uint32 MeshFirstVertex;
+    Uint32 FirstMorphTarget;
+
+    Uint32 NumMorphTargets;
+    Uint32 Padding0;
+    Uint32 Padding1;
+    Uint32 Padding2;
+};
+static_assert(sizeof(SkinningAttribs) % 16 == 0, "Constant buffer size must be a multiple of 16 bytes");
+
+// Creates the structured buffer or grows it to fit the data and uploads the data.
+bool UpdateStructuredBuffer(IRenderDevice*          pDevice,
+                            IDeviceContext*         pCtx,
+                            const char*             Name,
+                            const void*             pData,
+                            Uint64                  Size,
+                            Uint32                  ElementStride,
+                            RefCntAutoPtr<IBuffer>& pBuffer)
+{
+    if (!pBuffer || pBuffer->GetDesc().Size < Size)
+    {
+        pBuffer.Release();
+
+        BufferDesc BuffDesc;
+        BuffDesc.Name              = Name;
+        BuffDesc.Size              = std::max(Size, Uint64{4096});
+        BuffDesc.Usage             = USAGE_DEFAULT;
+        BuffDesc.BindFlags         = BIND_SHADER_RESOURCE;
+        BuffDesc.Mode              = BUFFER_MODE_STRUCTURED;
+        BuffDesc.ElementByteStride = ElementStride;
+        pDevice->CreateBuffer(BuffDesc, nullptr, &pBuffer);
+        if (!pBuffer)
+        {
+            LOG_ERROR_MESSAGE("Failed to create ", Name, " buffer");
+            return false;
+        }
+    }
+    if (Size > 0)
+        pCtx->UpdateBuffer(pBuffer, 0, Size, pData, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    return true;
+}
+
+} // namespace
+
+void PackJointMatrices(const float4x4* pSrc, size_t Count, JointMatrix3x4* pDst)
+{
+    for (size_t i = 0; i < Count; ++i)
+    {
+        const auto& M = pSrc[i];
+        auto&       D = pDst[i];
+        D.Row0        = float4{M.m[0][0], M.m[1][0], M.m[2][0], M.m[3][0]};
+        D.Row1        = float4{M.m[0][1], M.m[1][1], M.m[2][1], M.m[3][1]};
+        D.Row2        = float4{M.m[0][2], M.m[1][2], M.m[2][2], M.m[3][2]};
+    }
+}
+
+ComputeSkinning::ComputeSkinning(const CreateInfo& CI) :
+    m_pDevice{CI.pDevice},
+    m_pResourceMgr{CI.pResourceMgr},
+    m_OutputBufferIndex{CI.OutputBufferIndex}
+{
+    if (CI.pDevice == nullptr)
+        LOG_ERROR_AND_THROW("Render device must not be null");
+    if (CI.pResourceMgr == nullptr)
+        LOG_ERROR_AND_THROW("Resource manager must not be null");
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_HLSL;
+    ShaderCI.Desc           = {"GLTF compute skinning CS", SHADER_TYPE_COMPUTE, true};
+    ShaderCI.EntryPoint     = "main";
+    ShaderCI.Source         = SkinningCS;
+
+    RefCntAutoPtr<IShader> pCS;
+    m_pDevice->CreateShader(ShaderCI, &pCS);
+    if (!pCS)
+        LOG_ERROR_AND_THROW("Failed to create compute skinning shader");
+
+    ComputePipelineStateCreateInfo PSOCreateInfo;
+    PSOCreateInfo.PSODesc.Name         = "GLTF compute skinning PSO";
+    PSOCreateInfo.PSODesc.PipelineType = PIPELINE_TYPE_COMPUTE;
+    PSOCreateInfo.pCS                  = pCS;
+
+    // Input and output buffers change between models and instances
+    PSOCreateInfo.PSODesc.ResourceLayout.DefaultVariableType = SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC;
+
+    ShaderResourceVariableDesc Variables[] =
+        {
+            {SHADER_TYPE_COMPUTE, "cbSkinningAttribs", SHADER_RESOURCE_VARIABLE_TYPE_STATIC} //
+        };
+    PSOCreateInfo.PSODesc.ResourceLayout.Variables    = Variables;
+    PSOCreateInfo.PSODesc.ResourceLayout.NumVariables = _countof(Variables);
+
+    m_pDevice->CreateComputePipelineState(PSOCreateInfo, &m_pPSO);
+    if (!m_pPSO)
+        LOG_ERROR_AND_THROW("Failed to create compute skinning PSO");
+
+    {
+        BufferDesc BuffDesc;
+        BuffDesc.Name           = "GLTF compute skinning attribs";
+        BuffDesc.Size           = sizeof(SkinningAttribs);
+        BuffDesc.Usage          = USAGE_DYNAMIC;
+        BuffDesc.BindFlags      = BIND_UNIFORM_BUFFER;
+        BuffDesc.CPUAccessFlags = CPU_ACCESS_WRITE;
+        m_pDevice->CreateBuffer(BuffDesc, nullptr, &m_pConstantsBuffer);
+        if (!m_pConstantsBuffer)
+            LOG_ERROR_AND_THROW("Failed to create compute skinning constant buffer");
+    }
+    m_pPSO->GetStaticVariableByName(SHADER_TYPE_COMPUTE, "cbSkinningAttribs")->Set(m_pConstantsBuffer);
+    m_pPSO->CreateShaderResourceBinding(&m_pSRB, true);
+}
+
+bool ComputeSkinning::IsModelSupported(const Model& GLTFModel)
+{
+    if (GLTFModel.GetNumVertexAttributes() != DefaultVertexAttributes.size())
+        return false;
+
+    for (Uint32 i = 0; i < GLTFModel.GetNumVertexAttributes(); ++i)
+    {
+        const auto& Attrib  = GLTFModel.GetVertexAttribute(i);
+        const auto& Default = DefaultVertexAttributes[i];
+        if (std::strcmp(Attrib.Name, Default.Name) != 0 ||
+            Attrib.BufferId != Default.BufferId ||
+            Attrib.ValueType != Default.ValueType ||
+            Attrib.NumComponents != Default.NumComponents ||
+            Attrib.RelativeOffset != Default.RelativeOffset ||
+            Attrib.Encoding != Default.Encoding)
+            return false;
+    }
+
+    return GLTFModel.GetVertexBufferCount() > Model::VERTEX_BUFFER_ID_SKIN_ATTRIBS;
+}
+
+bool ComputeSkinning::InitInstance(const Model& GLTFModel, InstanceData& Instance)
+{
+    Instance        = {};
+    Instance.pModel = &GLTFModel;
+
+    if (!IsModelSupported(GLTFModel))
+    {
+        LOG_WARNING_MESSAGE("Compute skinning requires the default vertex layout");
+        return false;
+    }
+
+    Uint32 TotalVertices = 0;
+    for (const auto& N : GLTFModel.LinearNodes)
+    {
+        if (N.pMesh == nullptr || N.pMesh->Primitives.empty())
+            continue;
+        if ((N.pSkin == nullptr || N.SkinTransformsIndex < 0) && N.MorphWeightsOffset < 0)
+            continue;
+
+        Uint32 FirstVertex = ~0u;
+        Uint32 EndVertex   = 0;
+        for (const auto& Prim : N.pMesh->Primitives)
+        {
+            FirstVertex = std::min(FirstVertex, Prim.FirstVertex);
+            EndVertex   = std::max(EndVertex, Prim.FirstVertex + Prim.VertexCount);
+        }
+        if (EndVertex <= FirstVertex)
+            continue;
+
+        NodeOutput Output;
+        Output.NodeIndex   = static_cast<Uint32>(N.Index);
+        Output.FirstVertex = FirstVertex;
+        Output.NumVertices = EndVertex - FirstVertex;
+        Output.BaseVertex  = TotalVertices; // Relative to the allocation for now
+        Instance.Nodes.push_back(Output);
+
+        TotalVertices += Output.NumVertices;
+    }
+    if (Instance.Nodes.empty())
+        return false;
+
+    constexpr Uint32 VertexStride = sizeof(Model::VertexBasicAttribs);
+
+    Instance.pAllocation = m_pResourceMgr->AllocateBufferSpace(m_OutputBufferIndex, TotalVertices * VertexStride, 1);
+    if (!Instance.pAllocation)
+    {
+        LOG_ERROR_MESSAGE("Failed to allocate space for ", TotalVertices, " skinned vertices");
+        Instance.Nodes.clear();
+        return false;
+    }
+
+    const auto Offset = Instance.pAllocation->GetOffset();
+    if (Offset % VertexStride != 0)
+    {
+        LOG_ERROR_MESSAGE("Skinned vertex allocation offset (", Offset, ") is not a multiple of the vertex stride (", VertexStride,
+                          "). The output buffer must only be used for skinned vertices.");
+        Instance.pAllocation.Release();
+        Instance.Nodes.clear();
+        return false;
+    }
+
+    const auto AllocFirstVertex = static_cast<Uint32>(Offset / VertexStride);
+    for (auto& Output : Instance.Nodes)
+    {
+        // Primitive indices are relative to the model's base vertex, and the node's
+        // first vertex is written at AllocFirstVertex + Output.BaseVertex.
+        Output.BaseVertex = AllocFirstVertex + Output.BaseVertex - Output.FirstVertex;
+    }
+
+    return true;
+}
+
+bool ComputeSkinning::Skin(IDeviceContext*        pCtx,
+                           const Model&           GLTFModel,
+                           const ModelTransforms& Transforms,
+                           InstanceData&          Instance)
+{
+    DEV_CHECK_ERR(pCtx != nullptr, "Device context must not be null");
+
+    if (Instance.pModel != &GLTFModel)
+    {
+        if (!InitInstance(GLTFModel, Instance))
+            return false;
+    }
+    if (Instance.Nodes.empty() || !GLTFModel.CompatibleWithTransforms(Transforms))
+        return false;
+
+    // Gather joint matrices and active morph targets of all nodes
+    m_JointMatrices.clear();
+    m_ActiveMorphTargets.clear();
+    m_NodeRanges.resize(Instance.Nodes.size());
+    for (size_t i = 0; i < Instance.Nodes.size(); ++i)
+    {
+        const auto& N     = GLTFModel.LinearNodes[Instance.Nodes[i].NodeIndex];
+        auto&       Range = m_NodeRanges[i];
+
+        Range.FirstJoint = static_cast<Uint32>(m_JointMatrices.size());
+        if (N.pSkin != nullptr && N.SkinTransformsIndex >= 0 && static_cast<size_t>(N.SkinTransformsIndex) < Transforms.Skins.size())
+        {
+            const auto& JointMatrices = Transforms.Skins[N.SkinTransformsIndex].JointMatrices;
+            m_JointMatrices.resize(m_JointMatrices.size() + JointMatrices.size());
+            PackJointMatrices(JointMatrices.data(), JointMatrices.size(), m_JointMatrices.data() + Range.FirstJoint);
+        }
+        Range.NumJoints = static_cast<Uint32>(m_JointMatrices.size()) - Range.FirstJoint;
+
+        Range.FirstMorphTarget   = static_cast<Uint32>(m_ActiveMorphTargets.size());
+        const auto& MorphTargets = N.pMesh->MorphTargets;
+        if (N.MorphWeightsOffset >= 0 && static_cast<size_t>(N.MorphWeightsOffset) + MorphTargets.size() <= Transforms.MorphWeights.size())
+        {
+            for (size_t t = 0; t < MorphTargets.size(); ++t)
+            {
+                const auto Weight = Transforms.MorphWeights[N.MorphWeightsOffset + t];
+                if (Weight != 0 && MorphTargets[t].NumDeltas > 0)
+                    m_ActiveMorphTargets.push_back({MorphTargets[t].FirstDelta, MorphTargets[t].NumDeltas, Weight, 0});
+            }
+        }
+        Range.NumMorphTargets = static_cast<Uint32>(m_ActiveMorphTargets.size()) - Range.FirstMorphTarget;
+    }
+    if (m_JointMatrices.empty() && m_ActiveMorphTargets.empty())
+        return false;
+
+    if (!UpdateStructuredBuffer(m_pDevice, pCtx, "GLTF compute skinning joint matrices", m_JointMatrices.data(),
+                                m_JointMatrices.size() * sizeof(JointMatrix3x4), sizeof(JointMatrix3x4), m_pJointsBuffer))
+        return false;
+    if (!UpdateStructuredBuffer(m_pDevice, pCtx, "GLTF compute skinning morph targets", m_ActiveMorphTargets.data(),
+                                m_ActiveMorphTargets.size() * sizeof(ActiveMorphTarget), sizeof(ActiveMorphTarget), m_pMorphTargetsBuffer))
+        return false;
+
+    // Active targets are never read when the model has no deltas, so the buffer is bound in place of them
+    static_assert(sizeof(ActiveMorphTarget) == sizeof(MorphTargetDelta), "Active morph target size must match the delta size");
+    auto* pMorphDeltasBuffer = GLTFModel.GetMorphTargetBuffer();
+    if (pMorphDeltasBuffer == nullptr)
+        pMorphDeltasBuffer = m_pMorphTargetsBuffer;
+
+    auto* pSrcBasicBuffer = GLTFModel.GetVertexBuffer(Model::VERTEX_BUFFER_ID_BASIC_ATTRIBS, m_pDevice, pCtx);
+    auto* pSrcSkinBuffer  = GLTFModel.GetVertexBuffer(Model::VERTEX_BUFFER_ID_SKIN_ATTRIBS, m_pDevice, pCtx);
+    auto* pDstBuffer      = GetOutputBuffer(pCtx);
+    if (pSrcBasicBuffer == nullptr || pSrcSkinBuffer == nullptr || pDstBuffer == nullptr)
+        return false;
+
+    auto* pSrcBasicView = pSrcBasicBuffer->GetDefaultView(BUFFER_VIEW_SHADER_RESOURCE);
+    auto* pSrcSkinView  = pSrcSkinBuffer->GetDefaultView(BUFFER_VIEW_SHADER_RESOURCE);
+    auto* pDstView      = pDstBuffer->GetDefaultView(BUFFER_VIEW_UNORDERED_ACCESS);
+    if (pSrcBasicView == nullptr || pSrcSkinView == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Model vertex buffers must be created with the BIND_SHADER_RESOURCE flag to be used with compute skinning");
+        return false;
+    }
+    if (pDstView == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Skinned vertex buffer must be created with the BIND_UNORDERED_ACCESS flag");
+        return false;
+    }
+
+    m_pSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_SrcBasicAttribs")->Set(pSrcBasicView);
+    m_pSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_SrcSkinAttribs")->Set(pSrcSkinView);
+    m_pSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_JointMatrices")->Set(m_pJointsBuffer->GetDefaultView(BUFFER_VIEW_SHADER_RESOURCE));
+    m_pSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_MorphDeltas")->Set(pMorphDeltasBuffer->GetDefaultView(BUFFER_VIEW_SHADER_RESOURCE));
+    m_pSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_MorphTargets")->Set(m_pMorphTargetsBuffer->GetDefaultView(BUFFER_VIEW_SHADER_RESOURCE));
+    m_pSRB->GetVariableByName(SHADER_TYPE_COMPUTE, "g_DstBasicAttribs")->Set(pDstView);
+
+    pCtx->SetPipelineState(m_pPSO);
+    pCtx->CommitShaderResources(m_pSRB, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+    const auto SrcBasicBaseVertex = GLTFModel.GetBaseVertex(Model::VERTEX_BUFFER_ID_BASIC_ATTRIBS);
+    const auto SrcSkinBaseVertex  = GLTFModel.GetBaseVertex(Model::VERTEX_BUFFER_ID_SKIN_ATTRIBS);
+
+    // Every node is processed, since the output buffer is used in place of the source vertices
+    // for all of them. Nodes without joints and active morph targets are copied as is.
+    for (size_t i = 0; i < Instance.Nodes.size(); ++i)
+    {
+        const auto& Output = Instance.Nodes[i];
+        const auto& Range  = m_NodeRanges[i];
+        {
+            MapHelper<SkinningAttribs> Attribs{pCtx, m_pConstantsBuffer, MAP_WRITE, MAP_FLAG_DISCARD};
+            Attribs->SrcBasicFirstVertex = SrcBasicBaseVertex + Output.FirstVertex;
+            Attribs->SrcSkinFirstVertex  = SrcSkinBaseVertex + Output.FirstVertex;
+            Attribs->DstFirstVertex      = Output.BaseVertex + Output.FirstVertex;
+            Attribs->NumVertices         = Output.NumVertices;
+            Attribs->FirstJoint          = Range.FirstJoint;
+            Attribs->NumJoints           = Range.NumJoints;
+            Attribs->MeshFirstVertex     = Output.FirstVertex;
+            Attribs->FirstMorphTarget    = Range.FirstMorphTarget;
+            Attribs->NumMorphTargets     = Range.NumMorphTargets;
+            Attribs->Padding0            = 0;
+            Attribs->Padding1            = 0;
+            Attribs->Padding2            = 0;
+        }
+
+        DispatchComputeAttribs DispatchAttribs{(Output.NumVertices + SkinningThreadGroupSize - 1) / SkinningThreadGroupSize, 1, 1};
+        pCtx->DispatchCompute(DispatchAttribs);
+    }
+
+    return true;
+}
+
+IBuffer* ComputeSkinning::GetOutputBuffer(IDeviceContext* pCtx)
+{
+    return m_pResourceMgr->GetBuffer(m_OutputBufferIndex, m_pDevice, pCtx);
+}
+
+
+JointPalette::JointPalette(const CreateInfo& CI) :
+    m_pDevice{CI.pDevice},
+    m_Compact{CI.Compact},
+    m_Capacity{std::max(CI.InitialJointCount, 1u)}
+{
+    if (CI.pDevice == nullptr)
+        LOG_ERROR_AND_THROW("Render device must not be null");
+}
+
+void JointPalette::Reset()
+{
+    m_Skins.clear();
+    m_SkinFirstJoints.clear();
+    m_NumJoints = 0;
+}
+
+Uint32 JointPalette::AddInstance(const ModelTransforms& Transforms)
+{
+    const auto FirstSkin = static_cast<Uint32>(m_Skins.size());
+    for (const auto& Skin : Transforms.Skins)
+    {
+        m_Skins.push_back(&Skin.JointMatrices);
+        m_SkinFirstJoints.push_back(m_NumJoints);
+        m_NumJoints += static_cast<Uint32>(Skin.JointMatrices.size());
+    }
+    return FirstSkin;
+}
+
+bool JointPalette::Commit(IDeviceContext* pCtx)
+{
+    DEV_CHECK_ERR(pCtx != nullptr, "Device context must not be null");
+
+    if (!m_pBuffer || m_Capacity < m_NumJoints)
+    {
+        m_pBuffer.Release();
+        while (m_Capacity < m_NumJoints)
+            m_Capacity *= 2;
+
+        BufferDesc BuffDesc;
+        BuffDesc.Name              = "GLTF joint palette";
+        BuffDesc.Size              = Uint64{m_Capacity} * GetJointStride();
+        BuffDesc.Usage             = USAGE_DYNAMIC;
+        BuffDesc.BindFlags         = BIND_SHADER_RESOURCE;
+        BuffDesc.CPUAccessFlags    = CPU_ACCESS_WRITE;
+        BuffDesc.Mode              = BUFFER_MODE_STRUCTURED;
+        BuffDesc.ElementByteStride = GetJointStride();
+        m_pDevice->CreateBuffer(BuffDesc, nullptr, &m_pBuffer);
+        if (!m_pBuffer)
+        {
+            LOG_ERROR_MESSAGE("Failed to create joint palette buffer");
+            return false;
+        }
+    }
+
+    if (m_NumJoints == 0)
+        return true;
+
+    MapHelper<Uint8> pData{pCtx, m_pBuffer, MAP_WRITE, MAP_FLAG_DISCARD};
+    if (!pData)
+        return false;
+
+    for (size_t i = 0; i < m_Skins.size(); ++i)
+    {
+        const auto& JointMatrices = *m_Skins[i];
+        auto*       pDst          = pData + size_t{m_SkinFirstJoints[i]} * GetJointStride();
+        if (m_Compact)
+            PackJointMatrices(JointMatrices.data(), JointMatrices.size(), reinterpret_cast<JointMatrix3x4*>(pDst));
+        else if (!JointMatrices.empty())
+            std::memcpy(pDst, JointMatrices.data(), JointMatrices.size() * sizeof(float4x4));
+    }
+
+    return true;
+}
+
+} // namespace GLTF
+
+} // namespace Diligent
@@ -0,0 +1,125 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Persistent cache of OpenGL program binaries.
+
+/// Linking the programs of converted HLSL shaders is the most expensive part of the start-up
+/// on GL and GLES backends. The cache stores the binaries returned by glGetProgramBinary, keyed
+/// by the hash of the program sources, in a file, and restores them with glProgramBinary on later runs.
+/// All binaries are discarded when the driver (vendor, renderer or version string) changes.
+///
+/// \remarks The methods that take a program handle must be called on the thread where the GL context
+///          is current. The cache may be accessed from several threads that use shared contexts.
+class GLProgramBinaryCache
+{
+public:
+    /// Creates the cache and loads the binaries from the file, if it exists.
+
+    /// \param [in] FilePath - Path to the cache file.
+    ///
+    /// \remarks The driver identification is queried from the current GL context.
+    ///          If program binaries are not supported by the context, the cache is
+    ///          created empty and LoadProgram() always returns false.
+    explicit GLProgramBinaryCache(const Char* FilePath);
+
+    // clang-format off
+    GLProgramBinaryCache           (const GLProgramBinaryCache&)  = delete;
+    GLProgramBinaryCache           (      GLProgramBinaryCache&&) = delete;
+    GLProgramBinaryCache& operator=(const GLProgramBinaryCache&)  = delete;
+    GLProgramBinaryCache& operator=(      GLProgramBinaryCache&&) = delete;
+    // clang-format on
+
+    /// Returns true if the current GL context supports program binaries.
+    static bool IsSupported();
+
+    /// Returns the string that identifies the driver of the current GL context.
+    static std::string GetDriverId();
+
+    /// Computes the key of the program from the sources of its shaders.
+
+    /// \remarks The hash is stable between runs. Preprocessor definitions and any
+    ///          other state that affects compilation must be part of the sources.
+    static Uint64 ComputeSourceHash(const Char* const* ppSources, Uint32 NumSources);
+
+    /// Requests the driver to keep the binary of the program retrievable.
+
+    /// \remarks Must be called before the program is linked for the first time.
+    void PrepareProgram(Uint32 GLProgram) const;
+
+    /// Loads the cached binary into the program.
+
+    /// \return true if the binary was found and the program is linked successfully.
+    ///
+    /// \remarks If the driver rejects the binary, the entry is removed from the cache,
+    ///          and the application must compile and link the program from the sources.
+    bool LoadProgram(Uint32 GLProgram, Uint64 SourceHash);
+
+    /// Retrieves the binary of the linked program and adds it to the cache.
+
+    /// \return true if the binary was added.
+    bool StoreProgram(Uint32 GLProgram, Uint64 SourceHash);
+
+    /// Writes the cache to the file if any binary was added since it was loaded.
+
+    /// \return true if the file is up to date.
+    bool Save();
+
+    /// Returns the number of binaries in the cache.
+    size_t GetNumEntries() const;
+
+private:
+    struct Entry
+    {
+        Uint32             Format = 0;
+        std::vector<Uint8> Binary;
+    };
+
+    void Load();
+
+private:
+    const std::string m_FilePath;
+    const std::string m_DriverId;
+    const bool        m_IsSupported;
+
+    mutable std::mutex                m_Mtx;
+    std::unordered_map<Uint64, Entry> m_Entries;
+    bool                              m_IsDirty = false;
+};
+
+} // namespace Diligent
@@ -0,0 +1,342 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "GLProgramBinaryCache.hpp"
+
+#include <cstring>
+
+#if PLATFORM_WIN32 || PLATFORM_LINUX || PLATFORM_MACOS
+#    include "GL/glew.h"
+#elif PLATFORM_ANDROID
+#    include <GLES3/gl3.h>
+#elif PLATFORM_IOS || PLATFORM_TVOS
+#    include <OpenGLES/ES3/gl.h>
+#else
+#    error Unsupported platform
+#endif
+
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+#include "DataBlobImpl.hpp"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Increment this value whenever the file layout changes
+constexpr Uint32 CacheFileVersion = 1;
+
+constexpr Uint32 CacheFileMagic = 0x42504744; // 'DGPB'
+
+// Sequential reader of the cache file that fails instead of reading past the end
+class BlobReader
+{
+public:
+    explicit BlobReader(const IDataBlob& Data) :
+        m_pCurr{static_cast<const Uint8*>(Data.GetConstDataPtr())},
+        m_pEnd{m_pCurr + Data.GetSize()}
+    {}
+
+    bool Read(void* pDst, size_t Size)
+    {
+        if (static_cast<size_t>(m_pEnd - m_pCurr) < Size)
+            return false;
+        memcpy(pDst, m_pCurr, Size);
+        m_pCurr += Size;
+        return true;
+    }
+
+    template <typename T>
+    bool Read(T& Value)
+    {
+        return Read(&Value, sizeof(Value));
+    }
+
+    bool IsEnd() const
+    {
+        return m_pCurr == m_pEnd;
+    }
+
+private:
+    const Uint8* m_pCurr;
+    const Uint8* m_pEnd;
+};
+
+template <typename T>
+void Append(std::vector<Uint8>& Data, const T& Value)
+{
+    const auto* pBytes = reinterpret_cast<const Uint8*>(&Value);
+    Data.insert(Data.end(), pBytes, pBytes + sizeof(Value));
+}
+
+const char* GetGLString(GLenum Name)
+{
+    const auto* Str = reinterpret_cast<const char*>(glGetString(Name));
+    return Str != nullptr ? Str : "";
+}
+
+} // namespace
+
+GLProgramBinaryCache::GLProgramBinaryCache(const Char* FilePath) :
+    m_FilePath{FilePath != nullptr ? FilePath : ""},
+    m_DriverId{GetDriverId()},
+    m_IsSupported{IsSupported()}
+{
+    DEV_CHECK_ERR(!m_FilePath.empty(), "Cache file path must not be empty");
+
+    if (m_IsSupported)
+        Load();
+}
+
+bool GLProgramBinaryCache::IsSupported()
+{
+#if PLATFORM_WIN32 || PLATFORM_LINUX || PLATFORM_MACOS
+    // GL 4.1 or GL_ARB_get_program_binary
+    if (glGetProgramBinary == nullptr || glProgramBinary == nullptr)
+        return false;
+#endif
+
+    GLint NumFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &NumFormats);
+    return NumFormats > 0;
+}
+
+std::string GLProgramBinaryCache::GetDriverId()
+{
+    std::string DriverId{GetGLString(GL_VENDOR)};
+    DriverId += '|';
+    DriverId += GetGLString(GL_RENDERER);
+    DriverId += '|';
+    DriverId += GetGLString(GL_VERSION);
+    return DriverId;
+}
+
+Uint64 GLProgramBinaryCache::ComputeSourceHash(const Char* const* ppSources, Uint32 NumSources)
+{
+    // FNV-1a hash, which unlike std::hash is the same on every run and platform
+    Uint64 Hash = 0xCBF29CE484222325ull;
+
+    auto AddByte = [&Hash](Uint8 Byte) {
+        Hash ^= Byte;
+        Hash *= 0x100000001B3ull;
+    };
+
+    for (Uint32 i = 0; i < NumSources; ++i)
+    {
+        for (const auto* pChar = ppSources[i]; pChar != nullptr && *pChar != '\0'; ++pChar)
+            AddByte(static_cast<Uint8>(*pChar));
+        // Separate the sources so that moving text from one source to another changes the hash
+        AddByte(0);
+    }
+
+    return Hash;
+}
+
+void GLProgramBinaryCache::PrepareProgram(Uint32 GLProgram) const
+{
+    if (m_IsSupported)
+        glProgramParameteri(GLProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+bool GLProgramBinaryCache::LoadProgram(Uint32 GLProgram, Uint64 SourceHash)
+{
+    if (!m_IsSupported)
+        return false;
+
+    Entry CachedEntry;
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+
+        auto it = m_Entries.find(SourceHash);
+        if (it == m_Entries.end())
+            return false;
+        CachedEntry = it->second;
+    }
+
+    glProgramBinary(GLProgram, CachedEntry.Format, CachedEntry.Binary.data(), static_cast<GLsizei>(CachedEntry.Binary.size()));
+
+    GLint LinkStatus = GL_FALSE;
+    glGetProgramiv(GLProgram, GL_LINK_STATUS, &LinkStatus);
+    if (LinkStatus == GL_TRUE)
+        return true;
+
+    // Drivers may reject binaries of the same version, for example after the
+    // hardware configuration has changed. The program will be linked again.
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    m_Entries.erase(SourceHash);
+    m_IsDirty = true;
+
+    return false;
+}
+
+bool GLProgramBinaryCache::StoreProgram(Uint32 GLProgram, Uint64 SourceHash)
+{
+    if (!m_IsSupported)
+        return false;
+
+    GLint BinaryLength = 0;
+    glGetProgramiv(GLProgram, GL_PROGRAM_BINARY_LENGTH, &BinaryLength);
+    if (BinaryLength <= 0)
+        return false;
+
+    Entry NewEntry;
+    NewEntry.Binary.resize(static_cast<size_t>(BinaryLength));
+
+    GLenum  Format        = 0;
+    GLsizei LengthWritten = 0;
+    glGetProgramBinary(GLProgram, BinaryLength, &LengthWritten, &Format, NewEntry.Binary.data());
+    if (glGetError() != GL_NO_ERROR || LengthWritten <= 0)
+    {
+        LOG_WARNING_MESSAGE("Failed to retrieve the binary of GL program ", GLProgram);
+        return false;
+    }
+    NewEntry.Binary.resize(static_cast<size_t>(LengthWritten));
+    NewEntry.Format = Format;
+
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    m_Entries[SourceHash] = std::move(NewEntry);
+    m_IsDirty             = true;
+
+    return true;
+}
+
+void GLProgramBinaryCache::Load()
+{
+    // The cache file does not exist on the first run
+    if (!FileSystem::FileExists(m_FilePath.c_str()))
+        return;
+
+    FileWrapper File{m_FilePath.c_str(), EFileAccessMode::Read};
+    if (!File)
+    {
+        LOG_WARNING_MESSAGE("Failed to open GL program binary cache file '", m_FilePath, "'.");
+        return;
+    }
+
+    auto pData = DataBlobImpl::Create(0);
+    File->Read(pData);
+
+    BlobReader Reader{*pData};
+
+    Uint32 Magic = 0, Version = 0, DriverIdLen = 0;
+    if (!Reader.Read(Magic) || !Reader.Read(Version) || Magic != CacheFileMagic || Version != CacheFileVersion)
+    {
+        LOG_WARNING_MESSAGE("'", m_FilePath, "' is not a GL program binary cache file of the current version. The cache will be rebuilt.");
+        return;
+    }
+
+    std::string DriverId;
+    if (!Reader.Read(DriverIdLen))
+        return;
+    DriverId.resize(DriverIdLen);
+    if (!Reader.Read(&DriverId[0], DriverIdLen))
+        return;
+
+    if (DriverId != m_DriverId)
+    {
+        // Binaries are only valid for the driver that produced them
+        LOG_INFO_MESSAGE("GL driver has changed since the program binary cache was written. The cache will be rebuilt.");
+        m_IsDirty = true;
+        return;
+    }
+
+    Uint32 NumEntries = 0;
+    Reader.Read(NumEntries);
+
+    std::unordered_map<Uint64, Entry> Entries;
+    for (Uint32 i = 0; i < NumEntries; ++i)
+    {
+        Uint64 Hash       = 0;
+        Uint32 BinarySize = 0;
+        Entry  NewEntry;
+        if (!Reader.Read(Hash) || !Reader.Read(NewEntry.Format) || !Reader.Read(BinarySize))
+            break;
+
+        NewEntry.Binary.resize(BinarySize);
+        if (!Reader.Read(NewEntry.Binary.data(), BinarySize))
+            break;
+
+        Entries.emplace(Hash, std::move(NewEntry));
+    }
+
+    if (Entries.size() != NumEntries || !Reader.IsEnd())
+    {
+        // The file may have been written by a run that was interrupted. It will be overwritten by the next save.
+        LOG_WARNING_MESSAGE("GL program binary cache file '", m_FilePath, "' is corrupted. The cache will be rebuilt.");
+        m_IsDirty = true;
+        return;
+    }
+
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    m_Entries = std::move(Entries);
+}
+
+bool GLProgramBinaryCache::Save()
+{
+    std::vector<Uint8> Data;
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        if (!m_IsDirty)
+            return true;
+
+        Append(Data, CacheFileMagic);
+        Append(Data, CacheFileVersion);
+        Append(Data, static_cast<Uint32>(m_DriverId.size()));
+        Data.insert(Data.end(), m_DriverId.begin(), m_DriverId.end());
+        Append(Data, static_cast<Uint32>(m_Entries.size()));
+        for (const auto& it : m_Entries)
+        {
+            Append(Data, it.first);
+            Append(Data, it.second.Format);
+            Append(Data, static_cast<Uint32>(it.second.Binary.size()));
+            Data.insert(Data.end(), it.second.Binary.begin(), it.second.Binary.end());
+        }
+        m_IsDirty = false;
+    }
+
+    FileWrapper File{m_FilePath.c_str(), EFileAccessMode::Overwrite};
+    if (!File || !File->Write(Data.data(), Data.size()))
+    {
+        LOG_ERROR_MESSAGE("Failed to write GL program binary cache file '", m_FilePath, "'.");
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_IsDirty = true;
+        return false;
+    }
+
+    return true;
+}
+
+size_t GLProgramBinaryCache::GetNumEntries() const
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    return m_Entries.size();
+}
+
+} // namespace Diligent
@@ -0,0 +1,111 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "GLSLangValidator.hpp"
+
+#include "glslang/Public/ShaderLang.h"
+#include "glslang/Public/ResourceLimits.h"
+
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+EShLanguage ShaderTypeToGlslangStage(SHADER_TYPE ShaderType)
+{
+    switch (ShaderType)
+    {
+        // clang-format off
+        case SHADER_TYPE_VERTEX:   return EShLangVertex;
+        case SHADER_TYPE_HULL:     return EShLangTessControl;
+        case SHADER_TYPE_DOMAIN:   return EShLangTessEvaluation;
+        case SHADER_TYPE_GEOMETRY: return EShLangGeometry;
+        case SHADER_TYPE_PIXEL:    return EShLangFragment;
+        case SHADER_TYPE_COMPUTE:  return EShLangCompute;
+        // clang-format on
+        default:
+            UNEXPECTED("Unexpected shader type");
+            return EShLangVertex;
+    }
+}
+
+// The converter does not emit the version directive. The OpenGL backend prepends it together with
+// the macros below when it creates the shader, so the same context is provided for validation.
+constexpr char GLSLPreamble[] = "#define DESKTOP_GL 1\n";
+
+// The GLSL version the OpenGL backend targets on desktop
+constexpr int DefaultGLSLVersion = 430;
+
+} // namespace
+
+GLSLangValidator::GLSLangValidator()
+{
+    glslang::InitializeProcess();
+}
+
+GLSLangValidator::~GLSLangValidator()
+{
+    glslang::FinalizeProcess();
+}
+
+bool GLSLangValidator::Validate(const char* Source, size_t SourceLength, SHADER_TYPE ShaderType, std::string& Log) const
+{
+    const auto Stage = ShaderTypeToGlslangStage(ShaderType);
+
+    // Shader and program objects are only used by the calling thread, which makes validation thread-safe
+    glslang::TShader Shader{Stage};
+
+    const char* Sources[]       = {Source};
+    const int   SourceLengths[] = {static_cast<int>(SourceLength)};
+    Shader.setStringsWithLengths(Sources, SourceLengths, 1);
+    Shader.setPreamble(GLSLPreamble);
+    Shader.setEnvInput(glslang::EShSourceGlsl, Stage, glslang::EShClientOpenGL, 100);
+    Shader.setEnvClient(glslang::EShClientOpenGL, glslang::EShTargetOpenGL_450);
+    Shader.setEnvTarget(glslang::EShTargetNone, glslang::EShTargetSpv_1_0);
+
+    if (!Shader.parse(GetDefaultResources(), DefaultGLSLVersion, ECoreProfile, false, false, EShMsgDefault))
+    {
+        Log = Shader.getInfoLog();
+        return false;
+    }
+
+    // Linking a single stage catches errors such as a missing entry point
+    glslang::TProgram Program;
+    Program.addShader(&Shader);
+    if (!Program.link(EShMsgDefault))
+    {
+        Log = Program.getInfoLog();
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace Diligent
@@ -27,6 +27,20 @@
 
 #include "HLSL2GLSLConverterApp.h"
 
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <cstring>
+
+#include <sys/stat.h>
+
 #include "Errors.hpp"
 #include "HLSL2GLSLConverter.h"
 #include "RefCntAutoPtr.hpp"
@@ -34,24 +48,235 @@
 #include "EngineFactoryOpenGL.h"
 #include "RefCntAutoPtr.hpp"
 #include "DataBlobImpl.hpp"
+#include "DefaultShaderSourceStreamFactory.h"
+#include "MemoryFileStream.hpp"
+#include "ObjectBase.hpp"
 #include "FileWrapper.hpp"
+#include "FileSystem.hpp"
+#include "HashUtils.hpp"
+#include "ThreadPool.hpp"
 #include "args.hxx"
 
+#if HLSL2GLSL_CONVERTER_GLSLANG_SUPPORTED
+#    include "GLSLangValidator.hpp"
+#endif
+
 namespace Diligent
 {
 
-HLSL2GLSLConverterApp::HLSL2GLSLConverterApp()
+namespace
 {
-#if EXPLICITLY_LOAD_ENGINE_GL_DLL
-    // Declare function pointer
-    auto GetEngineFactoryOpenGL = LoadGraphicsEngineOpenGL();
-    if (GetEngineFactoryOpenGL == nullptr)
+
+const std::unordered_map<std::string, SHADER_TYPE>& GetShaderTypeMap()
+{
+    static const std::unordered_map<std::string, SHADER_TYPE> ShaderTypeMap //
+        {
+            {"vs", SHADER_TYPE_VERTEX},
+            {"gs", SHADER_TYPE_GEOMETRY},
+            {"ds", SHADER_TYPE_DOMAIN},
+            {"hs", SHADER_TYPE_HULL},
+            {"ps", SHADER_TYPE_PIXEL},
+            {"cs", SHADER_TYPE_COMPUTE} //
+        };
+    return ShaderTypeMap;
+}
+
+// Increment this value whenever the converter output changes in a way that invalidates cached files.
+constexpr Uint32 ConversionCacheVersion = 1;
+
+// Extracts the names of all files referenced by #include directives in the source.
+// Inactive preprocessor branches are not evaluated, so the result may contain
+// files that the converter never opens. This only makes the cache more conservative.
+std::vector<std::string> FindIncludeDirectives(const char* pSource, size_t Size)
+{
+    std::vector<std::string> Includes;
+
+    const auto* pEnd = pSource + Size;
+    for (const auto* pPos = pSource; pPos < pEnd;)
     {
-        LOG_ERROR_MESSAGE("Failed to load OpenGL engine implementation");
-        return -1;
+        const auto* pLineEnd = std::find(pPos, pEnd, '\n');
+
+        auto SkipSpaces = [&]() {
+            while (pPos < pLineEnd && (*pPos == ' ' || *pPos == '\t'))
+                ++pPos;
+        };
+
+        SkipSpaces();
+        if (pPos < pLineEnd && *pPos == '#')
+        {
+            ++pPos;
+            SkipSpaces();
+
+            static constexpr char   Directive[]  = "include";
+            static constexpr size_t DirectiveLen = sizeof(Directive) - 1;
+            if (static_cast<size_t>(pLineEnd - pPos) > DirectiveLen && std::equal(Directive, Directive + DirectiveLen, pPos))
+            {
+                pPos += DirectiveLen;
+                SkipSpaces();
+                if (pPos < pLineEnd && (*pPos == '"' || *pPos == '<'))
+                {
+                    const char  ClosingQuote = *pPos == '"' ? '"' : '>';
+                    const auto* pNameStart   = pPos + 1;
+                    const auto* pNameEnd     = std::find(pNameStart, pLineEnd, ClosingQuote);
+                    if (pNameEnd != pLineEnd && pNameEnd != pNameStart)
+                        Includes.emplace_back(pNameStart, pNameEnd);
+                }
+            }
+        }
+
+        pPos = pLineEnd + 1;
     }
+
+    return Includes;
+}
+
+// Escapes spaces in a path for a Makefile dependency list
+std::string EscapeDepfilePath(const std::string& Path)
+{
+    std::string Escaped;
+    Escaped.reserve(Path.size());
+    for (auto c : Path)
+    {
+        if (c == ' ' || c == '#')
+            Escaped.push_back('\\');
+        Escaped.push_back(c);
+    }
+    return Escaped;
+}
+
+} // namespace
+
+// Shader source stream factory that keeps the files read during a conversion run in memory.
+// Include files shared by many shaders of a batch are read and scanned for includes only once.
+// Entries are keyed by the file name and the modification time and size of the file it resolves to.
+class SourceFileCache final : public ObjectBase<IShaderSourceInputStreamFactory>
+{
+public:
+    using TBase         = ObjectBase<IShaderSourceInputStreamFactory>;
+    using ResolvePathFn = std::function<std::string(const std::string&)>;
+
+    struct FileData
+    {
+        RefCntAutoPtr<IDataBlob> pData;
+
+        // Files referenced by #include directives, see FindIncludeDirectives
+        std::vector<std::string> Includes;
+    };
+
+    SourceFileCache(IReferenceCounters*              pRefCounters,
+                    IShaderSourceInputStreamFactory* pFactory,
+                    ResolvePathFn                    ResolvePath) :
+        TBase{pRefCounters},
+        m_pFactory{pFactory},
+        m_ResolvePath{std::move(ResolvePath)}
+    {}
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_IShaderSourceInputStreamFactory, TBase)
+
+    virtual void DILIGENT_CALL_TYPE CreateInputStream(const Char* Name, IFileStream** ppStream) override final
+    {
+        CreateInputStream2(Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_NONE, ppStream);
+    }
+
+    virtual void DILIGENT_CALL_TYPE CreateInputStream2(const Char*                             Name,
+                                                       CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags,
+                                                       IFileStream**                           ppStream) override final
+    {
+        DEV_CHECK_ERR(ppStream != nullptr && *ppStream == nullptr, "ppStream must not be null and must point to a null pointer");
+
+        const auto File = GetFile(Name, Flags);
+        if (!File)
+            return;
+
+        auto pStream = MakeNewRCObj<MemoryFileStream>()(File->pData);
+        pStream->QueryInterface(IID_FileStream, reinterpret_cast<IObject**>(ppStream));
+    }
+
+    // Returns null if the file can't be opened
+    std::shared_ptr<const FileData> GetFile(const std::string& Name, CREATE_SHADER_SOURCE_INPUT_STREAM_FLAGS Flags = CREATE_SHADER_SOURCE_INPUT_STREAM_FLAG_SILENT)
+    {
+        Key FileKey{Name, GetFileStamp(m_ResolvePath(Name))};
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+
+            auto it = m_Files.find(FileKey);
+            if (it != m_Files.end())
+                return it->second;
+        }
+
+        // Several threads may read the same file at the same time. This is harmless, and the
+        // first result is kept. Files that failed to open are cached too, which avoids probing
+        // the search directories again for include paths that don't resolve.
+        std::shared_ptr<FileData> File;
+
+        RefCntAutoPtr<IFileStream> pFileStream;
+        m_pFactory->CreateInputStream2(Name.c_str(), Flags, &pFileStream);
+        if (pFileStream)
+        {
+            File        = std::make_shared<FileData>();
+            File->pData = DataBlobImpl::Create(0);
+            pFileStream->ReadBlob(File->pData);
+            File->Includes = FindIncludeDirectives(static_cast<const char*>(File->pData->GetConstDataPtr()), File->pData->GetSize());
+        }
+
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        return m_Files.emplace(std::move(FileKey), std::move(File)).first->second;
+    }
+
+private:
+    struct Key
+    {
+        std::string Name;
+        Uint64      Stamp = 0;
+
+        bool operator==(const Key& RHS) const
+        {
+            return Stamp == RHS.Stamp && Name == RHS.Name;
+        }
+
+        struct Hasher
+        {
+            size_t operator()(const Key& K) const
+            {
+                return ComputeHash(K.Name, K.Stamp);
+            }
+        };
+    };
+
+    // Combines the modification time and the size of the file; 0 if the file does not exist
+    static Uint64 GetFileStamp(const std::string& Path)
+    {
+        struct stat FileStat;
+        if (stat(Path.c_str(), &FileStat) != 0)
+            return 0;
+        return ComputeHash(static_cast<Uint64>(FileStat.st_mtime), static_cast<Uint64>(FileStat.st_size));
+    }
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> m_pFactory;
+    const ResolvePathFn                            m_ResolvePath;
+
+    std::mutex                                                            m_Mtx;
+    std::unordered_map<Key, std::shared_ptr<const FileData>, Key::Hasher> m_Files;
+};
+
+IEngineFactoryOpenGL* HLSL2GLSLConverterApp::GetFactoryGL()
+{
+    // The OpenGL engine is only needed to compile the converted shaders,
+    // so it is not loaded when the sources are only converted.
+    if (m_pFactoryGL == nullptr)
+    {
+#if EXPLICITLY_LOAD_ENGINE_GL_DLL
+        // Declare function pointer
+        auto GetEngineFactoryOpenGL = LoadGraphicsEngineOpenGL();
+        if (GetEngineFactoryOpenGL == nullptr)
+        {
+            LOG_ERROR_MESSAGE("Failed to load OpenGL engine implementation");
+            return nullptr;
+        }
 #endif
-    m_pFactoryGL = GetEngineFactoryOpenGL();
+        m_pFactoryGL = GetEngineFactoryOpenGL();
+    }
+    return m_pFactoryGL;
 }
 
 int HLSL2GLSLConverterApp::ParseCmdLine(int argc, char** argv)
@@ -65,15 +290,6 @@ int HLSL2GLSLConverterApp::ParseCmdLine(int argc, char** argv)
     args::ValueFlagList<std::string> SearDirsArg{Parser, "dirname", "Search directories to look for input file as well as all includes", {'d', "dirs"}, {}};
     args::ValueFlag<std::string>     EntryArg{Parser, "funcname", "Shader entry point", {'e', "entry"}, "main"};
 
-    std::unordered_map<std::string, SHADER_TYPE> ShaderTypeMap //
-        {
-            {"vs", SHADER_TYPE_VERTEX},
-            {"gs", SHADER_TYPE_GEOMETRY},
-            {"ds", SHADER_TYPE_DOMAIN},
-            {"hs", SHADER_TYPE_HULL},
-            {"ps", SHADER_TYPE_PIXEL},
-            {"cs", SHADER_TYPE_COMPUTE} //
-        };
     args::MapFlag<std::string, SHADER_TYPE> ShaderTypeArg{Parser, "shader_type", "Shader type. Allowed values:\n"
                                                                                  "  vs - vertex shader\n"
                                                                                  "  gs - geometry shader\n"
@@ -82,14 +298,34 @@ int HLSL2GLSLConverterApp::ParseCmdLine(int argc, char** argv)
                                                                                  "  ps - pixel shader\n"
                                                                                  "  cs - compute shader",
                                                           {'t', "type"},
-                                                          ShaderTypeMap,
+                                                          GetShaderTypeMap(),
                                                           SHADER_TYPE_UNKNOWN};
 
-    args::Flag CompileArg{Parser, "compile", "Compile converted GLSL shader", {'c', "compile"}};
+    args::Flag CompileArg{Parser, "compile", "Compile converted GLSL shader with the OpenGL driver", {'c', "compile"}};
+    args::Flag ValidateArg{Parser, "validate", "Validate converted GLSL shader with glslang. Validation does not require a device and runs in parallel in batch mode. "
+                                               "It may be combined with -c, in which case the driver compilation is the final check.",
+                           {"validate"}};
     args::Flag NoGlslDefArg{Parser, "noglsldef", "Do not include glsl definitions into the converted source", {"no-glsl-definitions"}};
     args::Flag NoLocationsArg{Parser, "nolocations", "Do not use shader input/output locations qualifiers. Shader stage interface linking will rely on exact name matching.", {"no-locations"}};
     args::Flag PrintArg{Parser, "print", "Print resulting converted file to console.", {'p', "print"}};
 
+    args::ValueFlag<std::string> BatchArg{Parser, "filename",
+                                          "Batch manifest file. Every line describes one conversion:\n"
+                                          "  <input file> <shader type> [<entry point> [<output file>]]\n"
+                                          "Empty lines and lines starting with '#' are ignored. The entry point defaults to the -e value.",
+                                          {'b', "batch"},
+                                          ""};
+    args::ValueFlag<std::string> CacheArg{Parser, "filename",
+                                          "Conversion cache file. Files whose source, includes and conversion options have not changed "
+                                          "since the output was written are not converted again.",
+                                          {"cache"},
+                                          ""};
+    args::Flag                   OffscreenArg{Parser, "offscreen", "Compile shaders (-c) in an offscreen EGL context that needs no window or display server (Linux only). "
+                                                           "This is the default when the DISPLAY environment variable is not set.",
+                                          {"offscreen"}};
+    args::Flag                   DepfilesArg{Parser, "depfiles", "Write a Makefile-style dependency file <output file>.d listing the source and its includes for every output file.", {"depfiles"}};
+    args::ValueFlag<Uint32>      ThreadsArg{Parser, "count", "The number of threads to convert batch files on. Default is the number of hardware threads.", {'j', "threads"}, 0};
+
     if (argc <= 1)
     {
         Parser.Help();
@@ -99,10 +335,21 @@ int HLSL2GLSLConverterApp::ParseCmdLine(int argc, char** argv)
     try
     {
         Parser.ParseCLI(argc, argv);
-        if (!InputArg)
-            throw args::Error{"Input file path is not specified"};
-        if (!ShaderTypeArg)
-            throw args::Error{"Shader type is not specified"};
+        if (!BatchArg)
+        {
+            if (!InputArg)
+                throw args::Error{"Input file path is not specified"};
+            if (!ShaderTypeArg)
+                throw args::Error{"Shader type is not specified"};
+        }
+        else if (InputArg)
+        {
+            throw args::Error{"Input file and batch manifest are mutually exclusive"};
+        }
+#if !HLSL2GLSL_CONVERTER_GLSLANG_SUPPORTED
+        if (ValidateArg)
+            throw args::Error{"glslang validation is not supported in this build"};
+#endif
     }
     catch (const args::Help&)
     {
@@ -116,8 +363,6 @@ int HLSL2GLSLConverterApp::ParseCmdLine(int argc, char** argv)
         return -1;
     }
 
-    m_InputPath  = InputArg.Get();
-    m_OutputPath = OutputArg.Get();
     for (const auto& Dir : SearDirsArg.Get())
     {
         if (!m_SearchDirectories.empty())
@@ -126,45 +371,99 @@ int HLSL2GLSLConverterApp::ParseCmdLine(int argc, char** argv)
     }
 
     m_EntryPoint            = EntryArg.Get();
-    m_ShaderType            = ShaderTypeArg.Get();
+    m_NumThreads            = ThreadsArg.Get();
+    m_CachePath             = CacheArg.Get();
+    m_WriteDepfiles         = DepfilesArg.Get();
+    m_UseOffscreenContext   = OffscreenArg.Get();
     m_CompileShader         = CompileArg.Get();
+    m_ValidateShader        = ValidateArg.Get();
     m_IncludeGLSLDefintions = !NoGlslDefArg.Get();
     m_UseInOutLocations     = !NoLocationsArg.Get();
     m_PrintConvertedSource  = PrintArg.Get();
 
+    if (BatchArg)
+        return ParseBatchManifest(BatchArg.Get());
+
+    ConversionJob Job;
+    Job.InputPath  = InputArg.Get();
+    Job.OutputPath = OutputArg.Get();
+    Job.EntryPoint = m_EntryPoint;
+    Job.ShaderType = ShaderTypeArg.Get();
+    m_Jobs.emplace_back(std::move(Job));
+
     return 0;
 }
 
-int HLSL2GLSLConverterApp::Convert(IRenderDevice* pDevice)
+int HLSL2GLSLConverterApp::ParseBatchManifest(const std::string& ManifestPath)
 {
-    if (m_InputPath.length() == 0)
+    std::ifstream Manifest{ManifestPath};
+    if (!Manifest)
     {
-        LOG_ERROR_MESSAGE("Input file path not specified; use -i command line option");
+        LOG_ERROR_MESSAGE("Failed to open batch manifest ", ManifestPath);
         return -1;
     }
 
-    if (m_ShaderType == SHADER_TYPE_UNKNOWN)
+    std::string Line;
+    for (size_t LineNum = 1; std::getline(Manifest, Line); ++LineNum)
     {
-        LOG_ERROR_MESSAGE("Shader type not specified; use -t [vs;ps;gs;ds;hs;cs] command line option");
-        return -1;
+        std::istringstream LineStream{Line};
+
+        ConversionJob Job;
+        std::string   ShaderType;
+        if (!(LineStream >> Job.InputPath) || Job.InputPath[0] == '#')
+            continue;
+
+        if (!(LineStream >> ShaderType))
+        {
+            LOG_ERROR_MESSAGE(ManifestPath, '(', LineNum, "): shader type is not specified");
+            return -1;
+        }
+
+        const auto& ShaderTypeMap = GetShaderTypeMap();
+        const auto  TypeIt        = ShaderTypeMap.find(ShaderType);
+        if (TypeIt == ShaderTypeMap.end())
+        {
+            LOG_ERROR_MESSAGE(ManifestPath, '(', LineNum, "): unknown shader type '", ShaderType, "'");
+            return -1;
+        }
+        Job.ShaderType = TypeIt->second;
+
+        if (!(LineStream >> Job.EntryPoint))
+            Job.EntryPoint = m_EntryPoint;
+        LineStream >> Job.OutputPath;
+
+        m_Jobs.emplace_back(std::move(Job));
     }
 
-    LOG_INFO_MESSAGE("Converting \'", m_InputPath, "\' to GLSL...");
+    if (m_Jobs.empty())
+    {
+        LOG_ERROR_MESSAGE("Batch manifest ", ManifestPath, " contains no files to convert");
+        return -1;
+    }
 
-    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderSourceFactory;
-    m_pFactoryGL->CreateDefaultShaderSourceStreamFactory(m_SearchDirectories.c_str(), &pShaderSourceFactory);
+    return 0;
+}
 
-    RefCntAutoPtr<IFileStream> pInputFileStream;
-    pShaderSourceFactory->CreateInputStream(m_InputPath.c_str(), &pInputFileStream);
-    if (!pInputFileStream)
+int HLSL2GLSLConverterApp::Convert(IRenderDevice* pDevice)
+{
+    if (m_Jobs.empty())
     {
+        LOG_ERROR_MESSAGE("Input file path not specified; use -i or -b command line option");
         return -1;
     }
-    auto pHLSLSourceBlob = DataBlobImpl::Create();
-    pInputFileStream->ReadBlob(pHLSLSourceBlob);
-    auto* HLSLSource = reinterpret_cast<char*>(pHLSLSourceBlob->GetDataPtr());
-    auto  SourceLen  = static_cast<Int32>(pHLSLSourceBlob->GetSize());
 
+    // Conversion runs entirely on the CPU and does not require the OpenGL engine
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pDefaultSourceFactory;
+    CreateDefaultShaderSourceStreamFactory(m_SearchDirectories.c_str(), &pDefaultSourceFactory);
+
+    // All files of the run are read through the cache, so that shared include files
+    // are loaded and scanned once rather than once per shader.
+    RefCntAutoPtr<SourceFileCache> pShaderSourceFactory{
+        MakeNewRCObj<SourceFileCache>()(pDefaultSourceFactory, [this](const std::string& Name) { return ResolveFilePath(Name); }) //
+    };
+
+    // The converter is immutable after creation, so a single instance is shared by all threads.
+    // Every file is converted through its own stream.
     RefCntAutoPtr<IHLSL2GLSLConverter> pConverter;
     CreateHLSL2GLSLConverter(&pConverter);
     if (!pConverter)
@@ -173,57 +472,364 @@ int HLSL2GLSLConverterApp::Convert(IRenderDevice* pDevice)
         return -1;
     }
 
-    RefCntAutoPtr<IHLSL2GLSLConversionStream> pStream;
-    pConverter->CreateStream(m_InputPath.c_str(), pShaderSourceFactory, HLSLSource, SourceLen, &pStream);
-    RefCntAutoPtr<IDataBlob> pGLSLSourceBlob;
-    pStream->Convert(m_EntryPoint.c_str(), m_ShaderType, m_IncludeGLSLDefintions, "_sampler", m_UseInOutLocations, &pGLSLSourceBlob);
-    if (!pGLSLSourceBlob) return -1;
+    if (!m_CachePath.empty())
+        LoadConversionCache();
 
-    LOG_INFO_MESSAGE("Done");
+#if HLSL2GLSL_CONVERTER_GLSLANG_SUPPORTED
+    std::unique_ptr<GLSLangValidator> pValidator;
+    if (m_ValidateShader)
+        pValidator.reset(new GLSLangValidator{});
+#endif
 
-    if (m_OutputPath.length() != 0)
-    {
-        FileWrapper pOutputFile(m_OutputPath.c_str(), EFileAccessMode::Overwrite);
-        if (pOutputFile != nullptr)
+    std::vector<RefCntAutoPtr<IDataBlob>> GLSLSources(m_Jobs.size());
+    // Source hashes of the converted files; zero if the file was not converted
+    std::vector<size_t> SourceHashes(m_Jobs.size());
+
+    const auto ProcessJob = [&](size_t i) {
+        const auto& Job = m_Jobs[i];
+
+        size_t                   Hash = 0;
+        std::vector<std::string> Dependencies;
+        if ((!m_CachePath.empty() || m_WriteDepfiles) && !Job.OutputPath.empty())
         {
-            if (!pOutputFile->Write(pGLSLSourceBlob->GetDataPtr(), pGLSLSourceBlob->GetSize()))
+            if (!ComputeSourceHash(Job, *pShaderSourceFactory, Hash, Dependencies))
+                Hash = 0;
+        }
+
+        if (Hash != 0 && !m_CachePath.empty() && FileSystem::FileExists(Job.OutputPath.c_str()))
+        {
+            const auto CacheIt = m_Cache.find(Job.OutputPath);
+            if (CacheIt != m_Cache.end() && CacheIt->second == Hash)
             {
-                LOG_ERROR_MESSAGE("Failed to write converted source to output file ", m_OutputPath);
-                return -1;
+                // The source is only needed to compile or print the shader
+                RefCntAutoPtr<IDataBlob> pGLSLSource;
+                if (pDevice != nullptr || m_PrintConvertedSource)
+                    pGLSLSource = LoadOutputFile(Job);
+                else
+                    pGLSLSource = DataBlobImpl::Create(0);
+
+                if (pGLSLSource)
+                {
+                    LOG_INFO_MESSAGE("\'", Job.OutputPath, "\' is up to date");
+                    GLSLSources[i] = std::move(pGLSLSource);
+                    if (m_WriteDepfiles)
+                        WriteDepfile(Job, Dependencies);
+                    return;
+                }
             }
         }
-        else
+
+        if (!ConvertFile(Job, pConverter, pShaderSourceFactory, &GLSLSources[i]))
+            return;
+
+#if HLSL2GLSL_CONVERTER_GLSLANG_SUPPORTED
+        if (pValidator)
         {
-            LOG_ERROR_MESSAGE("Failed to open output file ", m_OutputPath);
-            return -1;
+            // Validation is independent of the driver and runs on the worker threads
+            const auto* GLSLSource = static_cast<const char*>(GLSLSources[i]->GetConstDataPtr());
+            std::string Log;
+            if (!pValidator->Validate(GLSLSource, strnlen(GLSLSource, GLSLSources[i]->GetSize()), Job.ShaderType, Log))
+            {
+                LOG_ERROR_MESSAGE("Converted source \'", Job.InputPath, "\' failed validation:\n", Log);
+                GLSLSources[i].Release();
+                return;
+            }
+        }
+#endif
+
+        SourceHashes[i] = Hash;
+        if (m_WriteDepfiles && Hash != 0)
+            WriteDepfile(Job, Dependencies);
+    };
+
+    const auto NumThreads = std::min(m_NumThreads > 0 ? m_NumThreads : std::max(std::thread::hardware_concurrency(), 1u),
+                                     static_cast<Uint32>(m_Jobs.size()));
+    if (NumThreads > 1)
+    {
+        ThreadPoolCreateInfo ThreadPoolCI{NumThreads};
+        auto                 pThreadPool = CreateThreadPool(ThreadPoolCI);
+
+        std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+        Tasks.reserve(m_Jobs.size());
+        for (size_t i = 0; i < m_Jobs.size(); ++i)
+        {
+            Tasks.emplace_back(
+                EnqueueAsyncWork(pThreadPool,
+                                 [&ProcessJob, i](Uint32 ThreadId) {
+                                     ProcessJob(i);
+                                 }));
         }
+        for (auto& pTask : Tasks)
+            pTask->WaitForCompletion();
+    }
+    else
+    {
+        for (size_t i = 0; i < m_Jobs.size(); ++i)
+            ProcessJob(i);
     }
 
-    if (pDevice != nullptr)
+    size_t NumFailed = 0;
+    for (size_t i = 0; i < m_Jobs.size(); ++i)
     {
-        LOG_INFO_MESSAGE("Compiling entry point \'", m_EntryPoint, "\' in converted file \'", m_InputPath, '\'');
+        if (!GLSLSources[i])
+        {
+            ++NumFailed;
+            continue;
+        }
 
-        ShaderCreateInfo ShaderCI;
-        ShaderCI.EntryPoint     = m_EntryPoint.c_str();
-        ShaderCI.Desc           = {"Test shader", m_ShaderType, true};
-        ShaderCI.Source         = reinterpret_cast<const char*>(pGLSLSourceBlob->GetConstDataPtr());
-        ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_GLSL;
-        RefCntAutoPtr<IShader> pTestShader;
-        pDevice->CreateShader(ShaderCI, &pTestShader);
-        if (!pTestShader)
+        // GL objects can only be created on the thread that owns the context
+        if (pDevice != nullptr && !CompileFile(m_Jobs[i], pDevice, GLSLSources[i]))
         {
-            LOG_ERROR_MESSAGE("Failed to compile converted source \'", m_InputPath, '\'');
-            return -1;
+            ++NumFailed;
+            // Do not cache the output so that the file is converted and compiled again next time
+            SourceHashes[i] = 0;
+            m_Cache.erase(m_Jobs[i].OutputPath);
+        }
+
+        if (m_PrintConvertedSource)
+        {
+            LOG_INFO_MESSAGE("Converted GLSL (", m_Jobs[i].InputPath, "):\n", reinterpret_cast<const char*>(GLSLSources[i]->GetConstDataPtr()));
         }
-        LOG_INFO_MESSAGE("Done");
     }
 
-    if (m_PrintConvertedSource)
+    if (!m_CachePath.empty())
     {
-        LOG_INFO_MESSAGE("Converted GLSL:\n", reinterpret_cast<const char*>(pGLSLSourceBlob->GetConstDataPtr()));
+        for (size_t i = 0; i < m_Jobs.size(); ++i)
+        {
+            if (SourceHashes[i] != 0)
+                m_Cache[m_Jobs[i].OutputPath] = SourceHashes[i];
+        }
+        SaveConversionCache();
     }
 
-    return 0;
+    if (m_Jobs.size() > 1)
+    {
+        if (NumFailed == 0)
+            LOG_INFO_MESSAGE("Successfully processed ", m_Jobs.size(), " files");
+        else
+            LOG_ERROR_MESSAGE("Failed to process ", NumFailed, " of ", m_Jobs.size(), " files");
+    }
+
+    return NumFailed == 0 ? 0 : -1;
+}
+
+std::string HLSL2GLSLConverterApp::ResolveFilePath(const std::string& Name) const
+{
+    // Mirror the lookup order of the default shader source stream factory: search directories first
+    for (size_t Start = 0; Start < m_SearchDirectories.size();)
+    {
+        auto End = m_SearchDirectories.find(';', Start);
+        if (End == std::string::npos)
+            End = m_SearchDirectories.size();
+
+        if (End > Start)
+        {
+            auto Path = m_SearchDirectories.substr(Start, End - Start);
+            if (!FileSystem::IsSlash(Path.back()))
+                Path.push_back(FileSystem::SlashSymbol);
+            Path += Name;
+            if (FileSystem::FileExists(Path.c_str()))
+                return Path;
+        }
+        Start = End + 1;
+    }
+    return Name;
+}
+
+bool HLSL2GLSLConverterApp::ComputeSourceHash(const ConversionJob&      Job,
+                                              SourceFileCache&          SourceCache,
+                                              size_t&                   Hash,
+                                              std::vector<std::string>& Dependencies) const
+{
+    // Outputs that were not validated must be converted and validated when validation is requested
+    Hash = ComputeHash(ConversionCacheVersion, Job.ShaderType, m_IncludeGLSLDefintions, m_UseInOutLocations, m_ValidateShader);
+    HashCombine(Hash, Job.EntryPoint);
+
+    std::unordered_set<std::string> VisitedFiles;
+
+    // Hashes the file and all files it includes. Returns false if the file can't be opened.
+    std::function<bool(const std::string&)> HashFile = [&](const std::string& FilePath) {
+        const auto File = SourceCache.GetFile(FilePath);
+        if (!File)
+            return false;
+
+        const auto* pSource = static_cast<const char*>(File->pData->GetConstDataPtr());
+        HashCombine(Hash, std::string{pSource, pSource + File->pData->GetSize()});
+        Dependencies.emplace_back(ResolveFilePath(FilePath));
+
+        for (const auto& Include : File->Includes)
+        {
+            // Unresolved includes are either system headers or belong to inactive branches.
+            // Their names are still part of the hash.
+            HashCombine(Hash, Include);
+
+            // Try the name as is first, then relative to the including file
+            std::string IncludePath = Include;
+            if (VisitedFiles.count(IncludePath) != 0)
+                continue;
+            VisitedFiles.insert(IncludePath);
+            if (HashFile(IncludePath))
+                continue;
+
+            std::string Dir;
+            FileSystem::GetPathComponents(FilePath, &Dir, nullptr);
+            if (!Dir.empty())
+            {
+                IncludePath = Dir + FileSystem::SlashSymbol + Include;
+                if (VisitedFiles.insert(IncludePath).second)
+                    HashFile(IncludePath);
+            }
+        }
+        return true;
+    };
+
+    VisitedFiles.insert(Job.InputPath);
+    if (!HashFile(Job.InputPath))
+    {
+        LOG_ERROR_MESSAGE("Failed to open input file \'", Job.InputPath, '\'');
+        return false;
+    }
+    return true;
+}
+
+RefCntAutoPtr<IDataBlob> HLSL2GLSLConverterApp::LoadOutputFile(const ConversionJob& Job) const
+{
+    FileWrapper File{Job.OutputPath.c_str(), EFileAccessMode::Read};
+    if (!File)
+        return {}; // The file will be converted again
+
+    auto pFileData = DataBlobImpl::Create(0);
+    File->Read(pFileData);
+    // Converted sources are null-terminated
+    if (pFileData->GetSize() == 0 || static_cast<const char*>(pFileData->GetConstDataPtr())[pFileData->GetSize() - 1] != '\0')
+    {
+        pFileData->Resize(pFileData->GetSize() + 1);
+        static_cast<char*>(pFileData->GetDataPtr())[pFileData->GetSize() - 1] = '\0';
+    }
+    return RefCntAutoPtr<IDataBlob>{pFileData};
+}
+
+void HLSL2GLSLConverterApp::WriteDepfile(const ConversionJob& Job, const std::vector<std::string>& Dependencies) const
+{
+    std::stringstream Depfile;
+    Depfile << EscapeDepfilePath(Job.OutputPath) << ':';
+    for (const auto& Dependency : Dependencies)
+        Depfile << " \\\n  " << EscapeDepfilePath(Dependency);
+    Depfile << '\n';
+
+    const auto DepfilePath = Job.OutputPath + ".d";
+    const auto Contents    = Depfile.str();
+
+    FileWrapper File{DepfilePath.c_str(), EFileAccessMode::Overwrite};
+    if (!File || !File->Write(Contents.data(), Contents.size()))
+        LOG_ERROR_MESSAGE("Failed to write dependency file ", DepfilePath);
+}
+
+void HLSL2GLSLConverterApp::LoadConversionCache()
+{
+    std::ifstream Cache{m_CachePath};
+    if (!Cache)
+        return; // The cache is created on the first run
+
+    // Every line contains the source hash and the output path
+    std::string Line;
+    while (std::getline(Cache, Line))
+    {
+        const auto Space = Line.find(' ');
+        if (Space == std::string::npos || Space + 1 == Line.size())
+            continue;
+
+        std::istringstream HashStream{Line.substr(0, Space)};
+        size_t             Hash = 0;
+        if (HashStream >> std::hex >> Hash)
+            m_Cache[Line.substr(Space + 1)] = Hash;
+    }
+}
+
+void HLSL2GLSLConverterApp::SaveConversionCache() const
+{
+    std::ofstream Cache{m_CachePath, std::ios::trunc};
+    if (!Cache)
+    {
+        LOG_ERROR_MESSAGE("Failed to write conversion cache ", m_CachePath);
+        return;
+    }
+
+    for (const auto& Entry : m_Cache)
+        Cache << std::hex << Entry.second << ' ' << Entry.first << '\n';
+}
+
+bool HLSL2GLSLConverterApp::ConvertFile(const ConversionJob&             Job,
+                                        IHLSL2GLSLConverter*             pConverter,
+                                        IShaderSourceInputStreamFactory* pShaderSourceFactory,
+                                        IDataBlob**                      ppGLSLSource) const
+{
+    LOG_INFO_MESSAGE("Converting \'", Job.InputPath, "\' to GLSL...");
+
+    RefCntAutoPtr<IFileStream> pInputFileStream;
+    pShaderSourceFactory->CreateInputStream(Job.InputPath.c_str(), &pInputFileStream);
+    if (!pInputFileStream)
+    {
+        LOG_ERROR_MESSAGE("Failed to open input file \'", Job.InputPath, '\'');
+        return false;
+    }
+    auto pHLSLSourceBlob = DataBlobImpl::Create();
+    pInputFileStream->ReadBlob(pHLSLSourceBlob);
+    auto* HLSLSource = reinterpret_cast<char*>(pHLSLSourceBlob->GetDataPtr());
+    auto  SourceLen  = static_cast<Int32>(pHLSLSourceBlob->GetSize());
+
+    RefCntAutoPtr<IHLSL2GLSLConversionStream> pStream;
+    pConverter->CreateStream(Job.InputPath.c_str(), pShaderSourceFactory, HLSLSource, SourceLen, &pStream);
+    RefCntAutoPtr<IDataBlob> pGLSLSourceBlob;
+    pStream->Convert(Job.EntryPoint.c_str(), Job.ShaderType, m_IncludeGLSLDefintions, "_sampler", m_UseInOutLocations, &pGLSLSourceBlob);
+    if (!pGLSLSourceBlob)
+    {
+        LOG_ERROR_MESSAGE("Failed to convert \'", Job.InputPath, '\'');
+        return false;
+    }
+
+    if (Job.OutputPath.length() != 0)
+    {
+        FileWrapper pOutputFile(Job.OutputPath.c_str(), EFileAccessMode::Overwrite);
+        if (pOutputFile != nullptr)
+        {
+            if (!pOutputFile->Write(pGLSLSourceBlob->GetDataPtr(), pGLSLSourceBlob->GetSize()))
+            {
+                LOG_ERROR_MESSAGE("Failed to write converted source to output file ", Job.OutputPath);
+                return false;
+            }
+        }
+        else
+        {
+            LOG_ERROR_MESSAGE("Failed to open output file ", Job.OutputPath);
+            return false;
+        }
+    }
+
+    LOG_INFO_MESSAGE("Done converting \'", Job.InputPath, '\'');
+
+    *ppGLSLSource = pGLSLSourceBlob.Detach();
+    return true;
+}
+
+bool HLSL2GLSLConverterApp::CompileFile(const ConversionJob& Job, IRenderDevice* pDevice, IDataBlob* pGLSLSource) const
+{
+    LOG_INFO_MESSAGE("Compiling entry point \'", Job.EntryPoint, "\' in converted file \'", Job.InputPath, '\'');
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.EntryPoint     = Job.EntryPoint.c_str();
+    ShaderCI.Desc           = {"Test shader", Job.ShaderType, true};
+    ShaderCI.Source         = reinterpret_cast<const char*>(pGLSLSource->GetConstDataPtr());
+    ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_GLSL;
+    RefCntAutoPtr<IShader> pTestShader;
+    pDevice->CreateShader(ShaderCI, &pTestShader);
+    if (!pTestShader)
+    {
+        LOG_ERROR_MESSAGE("Failed to compile converted source \'", Job.InputPath, '\'');
+        return false;
+    }
+    LOG_INFO_MESSAGE("Done");
+    return true;
 }
 
 } // namespace Diligent
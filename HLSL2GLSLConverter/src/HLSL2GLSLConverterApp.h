@@ -28,20 +28,30 @@
 #pragma once
 
 #include <string>
+#include <vector>
+#include <unordered_map>
 
 #include "RenderDevice.h"
+#include "RefCntAutoPtr.hpp"
 
 namespace Diligent
 {
 
 struct IEngineFactoryOpenGL;
+struct IHLSL2GLSLConverter;
+struct IShaderSourceInputStreamFactory;
+struct IDataBlob;
+class SourceFileCache;
 
 class HLSL2GLSLConverterApp
 {
 public:
-    HLSL2GLSLConverterApp();
-
     int ParseCmdLine(int argc, char** argv);
+
+    /// Converts the input file or all files of the batch manifest.
+
+    /// Files are converted in parallel when there is more than one file. If pDevice is not null,
+    /// the converted sources are compiled on the calling thread, which must own the GL context.
     int Convert(IRenderDevice* pDevice);
 
     bool NeedsCompileShader() const
@@ -49,19 +59,65 @@ public:
         return m_CompileShader;
     }
 
-    IEngineFactoryOpenGL* GetFactoryGL() const
+    /// Returns true if the compile check should run in an offscreen context rather than in a window.
+    bool UseOffscreenContext() const
     {
-        return m_pFactoryGL;
+        return m_UseOffscreenContext;
     }
 
+    /// Loads the OpenGL engine on first use. Conversion alone does not require it.
+    IEngineFactoryOpenGL* GetFactoryGL();
+
 private:
-    std::string m_InputPath;
-    std::string m_OutputPath;
+    struct ConversionJob
+    {
+        std::string InputPath;
+        std::string OutputPath;
+        std::string EntryPoint = "main";
+        SHADER_TYPE ShaderType = SHADER_TYPE_UNKNOWN;
+    };
+
+    int ParseBatchManifest(const std::string& ManifestPath);
+
+    bool ConvertFile(const ConversionJob&             Job,
+                     IHLSL2GLSLConverter*             pConverter,
+                     IShaderSourceInputStreamFactory* pShaderSourceFactory,
+                     IDataBlob**                      ppGLSLSource) const;
+
+    bool CompileFile(const ConversionJob& Job, IRenderDevice* pDevice, IDataBlob* pGLSLSource) const;
+
+    // Hashes the source and all its includes together with the conversion options,
+    // and returns the paths of the files the output depends on.
+    bool ComputeSourceHash(const ConversionJob&      Job,
+                           SourceFileCache&          SourceCache,
+                           size_t&                   Hash,
+                           std::vector<std::string>& Dependencies) const;
+
+    std::string ResolveFilePath(const std::string& Name) const;
+
+    RefCntAutoPtr<IDataBlob> LoadOutputFile(const ConversionJob& Job) const;
+
+    void WriteDepfile(const ConversionJob& Job, const std::vector<std::string>& Dependencies) const;
+
+    void LoadConversionCache();
+    void SaveConversionCache() const;
+
+    std::vector<ConversionJob> m_Jobs;
+
     std::string m_SearchDirectories;
     std::string m_EntryPoint = "main";
-    SHADER_TYPE m_ShaderType = SHADER_TYPE_UNKNOWN;
+
+    // The number of conversion threads in batch mode; 0 means the number of hardware threads.
+    Uint32 m_NumThreads = 0;
+
+    // Source hashes of up-to-date output files, indexed by the output path
+    std::string                             m_CachePath;
+    std::unordered_map<std::string, size_t> m_Cache;
+    bool                                    m_WriteDepfiles = false;
 
     bool m_CompileShader         = false;
+    bool m_ValidateShader        = false;
+    bool m_UseOffscreenContext   = false;
     bool m_IncludeGLSLDefintions = true;
     bool m_UseInOutLocations     = true;
     bool m_PrintConvertedSource  = false;
@@ -69,4 +125,4 @@ private:
     IEngineFactoryOpenGL* m_pFactoryGL = nullptr;
 };
 
-} // namespace Diligent
\ No newline at end of file
+} // namespace Diligent
@@ -31,13 +31,121 @@
 #include "EngineFactoryOpenGL.h"
 #include "RefCntAutoPtr.hpp"
 
+#include <cstdlib>
+
 #include <GL/glx.h>
 #include <GL/gl.h>
 
+#if HLSL2GLSL_CONVERTER_EGL_SUPPORTED
+#    include <EGL/egl.h>
+#endif
+
 typedef GLXContext (*glXCreateContextAttribsARBProc)(Display*, GLXFBConfig, GLXContext, int, const int*);
 
 using namespace Diligent;
 
+#if HLSL2GLSL_CONVERTER_EGL_SUPPORTED
+namespace
+{
+
+// An OpenGL context with a tiny pbuffer surface that needs neither a window nor a display server
+class OffscreenEGLContext
+{
+public:
+    ~OffscreenEGLContext()
+    {
+        if (m_Display == EGL_NO_DISPLAY)
+            return;
+
+        eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (m_Context != EGL_NO_CONTEXT)
+            eglDestroyContext(m_Display, m_Context);
+        if (m_Surface != EGL_NO_SURFACE)
+            eglDestroySurface(m_Display, m_Surface);
+        eglTerminate(m_Display);
+    }
+
+    bool Create(int MajorVersion, int MinorVersion)
+    {
+        m_Display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (m_Display == EGL_NO_DISPLAY || !eglInitialize(m_Display, nullptr, nullptr))
+        {
+            LOG_ERROR_MESSAGE("Failed to initialize EGL display");
+            m_Display = EGL_NO_DISPLAY;
+            return false;
+        }
+
+        if (!eglBindAPI(EGL_OPENGL_API))
+        {
+            LOG_ERROR_MESSAGE("EGL does not support desktop OpenGL");
+            return false;
+        }
+
+        // clang-format off
+        const EGLint ConfigAttribs[] =
+        {
+            EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE,        8,
+            EGL_GREEN_SIZE,      8,
+            EGL_BLUE_SIZE,       8,
+            EGL_ALPHA_SIZE,      8,
+            EGL_DEPTH_SIZE,      24,
+            EGL_NONE
+        };
+        // clang-format on
+
+        EGLConfig Config    = nullptr;
+        EGLint    NumConfig = 0;
+        if (!eglChooseConfig(m_Display, ConfigAttribs, &Config, 1, &NumConfig) || NumConfig == 0)
+        {
+            LOG_ERROR_MESSAGE("Failed to find a suitable EGL config");
+            return false;
+        }
+
+        const EGLint SurfaceAttribs[] = {EGL_WIDTH, 16, EGL_HEIGHT, 16, EGL_NONE};
+        m_Surface                     = eglCreatePbufferSurface(m_Display, Config, SurfaceAttribs);
+        if (m_Surface == EGL_NO_SURFACE)
+        {
+            LOG_ERROR_MESSAGE("Failed to create EGL pbuffer surface");
+            return false;
+        }
+
+        // clang-format off
+        const EGLint ContextAttribs[] =
+        {
+            EGL_CONTEXT_MAJOR_VERSION,       MajorVersion,
+            EGL_CONTEXT_MINOR_VERSION,       MinorVersion,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        // clang-format on
+
+        m_Context = eglCreateContext(m_Display, Config, EGL_NO_CONTEXT, ContextAttribs);
+        if (m_Context == EGL_NO_CONTEXT)
+        {
+            LOG_ERROR_MESSAGE("Failed to create EGL context");
+            return false;
+        }
+
+        if (!eglMakeCurrent(m_Display, m_Surface, m_Surface, m_Context))
+        {
+            LOG_ERROR_MESSAGE("Failed to make EGL context current");
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    EGLDisplay m_Display = EGL_NO_DISPLAY;
+    EGLSurface m_Surface = EGL_NO_SURFACE;
+    EGLContext m_Context = EGL_NO_CONTEXT;
+};
+
+} // namespace
+#endif
+
 int main(int argc, char** argv)
 {
     HLSL2GLSLConverterApp Converter;
@@ -54,9 +162,39 @@ int main(int argc, char** argv)
 
     Display* display = nullptr;
     Window win = 0;
+
+#if HLSL2GLSL_CONVERTER_EGL_SUPPORTED
+    OffscreenEGLContext OffscreenContext;
+    if (Converter.NeedsCompileShader() && (Converter.UseOffscreenContext() || getenv("DISPLAY") == nullptr))
+    {
+        auto* pFactory = Converter.GetFactoryGL();
+        if (pFactory == nullptr || !OffscreenContext.Create(4, 3))
+            return -1;
+
+        EngineGLCreateInfo EngineCI;
+        pFactory->AttachToActiveGLContext(EngineCI, &pDevice, &pContext);
+        if (!pDevice)
+        {
+            LOG_ERROR_MESSAGE("Failed to create render device in the offscreen context");
+            return -1;
+        }
+    }
+    else
+#else
+    if (Converter.UseOffscreenContext())
+    {
+        LOG_ERROR_MESSAGE("Offscreen compilation requires EGL support, which is not available in this build");
+        return -1;
+    }
+#endif
     if (Converter.NeedsCompileShader())
     {
         display = XOpenDisplay(0);
+        if (display == nullptr)
+        {
+            LOG_ERROR_MESSAGE("Failed to open X display. Shader compilation requires a display server");
+            return -1;
+        }
 
         // clang-format off
         static int visual_attribs[] =
@@ -165,6 +303,8 @@ int main(int argc, char** argv)
         glXMakeCurrent(display, win, ctx);
         
         auto* pFactory = Converter.GetFactoryGL();
+        if (pFactory == nullptr)
+            return -1;
         EngineGLCreateInfo CreationAttribs;
         SwapChainDesc      SCDesc;
         CreationAttribs.Window.WindowId = win;
@@ -175,6 +315,11 @@ int main(int argc, char** argv)
 
     auto ret = Converter.Convert(pDevice);
 
+    // Release the device while its context is still current
+    pSwapChain.Release();
+    pContext.Release();
+    pDevice.Release();
+
     if (display != nullptr)
     {
         auto ctx = glXGetCurrentContext();
@@ -109,6 +109,8 @@ int main(int argc, char** argv)
         EngineCI.Window.hWnd = wnd;
 
         auto* pFactory = Converter.GetFactoryGL();
+        if (pFactory == nullptr)
+            return -1;
         pFactory->CreateDeviceAndSwapChainGL(
             EngineCI, &pDevice, &pContext, SCDesc, &pSwapChain);
         if (!pDevice)
@@ -28,11 +28,15 @@
 #pragma once
 
 #include <memory>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
 #include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
 #include "../../../DiligentCore/Common/interface/BasicMath.hpp"
 #include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
 #include "../../../DiligentCore/Graphics/GraphicsEngine/interface/GraphicsTypes.h"
 #include "imgui.h"
+#include "ImGuiImplDiligent.hpp"
 
 struct ImDrawData;
 
@@ -43,9 +47,13 @@ struct IRenderDevice;
 struct IDeviceContext;
 struct IBuffer;
 struct IPipelineState;
+struct ITexture;
 struct ITextureView;
 struct IShaderResourceBinding;
 struct IShaderResourceVariable;
+struct IDeviceObject;
+struct IFence;
+class RingBuffer;
 enum TEXTURE_FORMAT : Uint16;
 enum SURFACE_TRANSFORM : Uint32;
 
@@ -62,32 +70,141 @@ public:
                   Uint32            RenderSurfaceHeight,
                   SURFACE_TRANSFORM SurfacePreTransform);
     void EndFrame();
+
+    /// Records the commands that render the draw data into the context.
+
+    /// Draw data of several viewports may be recorded concurrently from different threads,
+    /// provided that each thread uses its own deferred context. The command lists must then
+    /// be executed by the immediate context. Immediate contexts must not be used concurrently.
+    /// Textures referenced by draw data recorded into deferred contexts must already be
+    /// transitioned to the shader resource state.
     void RenderDrawData(IDeviceContext* pCtx, ImDrawData* pDrawData);
+
+    /// Renders the draw data into a cached UI target and composites it over pRTV.
+
+    /// The draw data is hashed, and the cached target is only re-rendered when the hash changes.
+    /// Otherwise, neither vertices nor indices are uploaded, and the UI costs a single full-screen
+    /// blend. Draw data containing user callbacks is always re-rendered. The render targets are
+    /// left set to pRTV and pDSV. Must only be called with an immediate context.
+    void RenderDrawDataCached(IDeviceContext* pCtx, ImDrawData* pDrawData, ITextureView* pRTV, ITextureView* pDSV);
+
+    /// Forces the next RenderDrawDataCached call to re-render the UI, e.g. when the contents
+    /// of a texture referenced by the draw data have changed.
+    void InvalidateRenderCache();
+
     void InvalidateDeviceObjects();
     void CreateDeviceObjects();
+
+    /// Creates the font texture from the ImGui font atlas.
+
+    /// If the texture already exists and has the same size and format, only the rows of
+    /// the atlas that changed are uploaded by the next RenderDrawData call on an immediate context.
     void CreateFontsTexture();
 
+    /// Sets the font atlas mode and recreates the device objects if the mode changes.
+    void SetFontAtlasMode(IMGUI_FONT_ATLAS_MODE Mode);
+
+    /// Enables the compact vertex format and recreates the device objects if the format changes.
+    void SetCompactVertexFormat(bool UseCompactVertices);
+
+    /// Compact vertex format: 12 bytes instead of the 20 bytes of ImDrawVert.
+
+    /// Positions are snorm16 offsets from ImDrawData::DisplayPos in 1/CompactPosScale pixel steps,
+    /// which covers +-8191 pixels. Texture coordinates are unorm16 and are clamped to [0, 1].
+    struct CompactVertex
+    {
+        Int16  pos[2];
+        Uint16 uv[2];
+        ImU32  col;
+    };
+    static constexpr float CompactPosScale = 4;
+
 private:
+    // Resources that are written while the draw data is recorded. Every deferred context
+    // gets its own set, so that several contexts can record at the same time.
+    struct ContextResources
+    {
+        RefCntAutoPtr<IBuffer>                pVB;
+        RefCntAutoPtr<IBuffer>                pIB;
+        RefCntAutoPtr<IShaderResourceBinding> pSRB;
+        IShaderResourceVariable*              pTextureVar      = nullptr;
+        Uint32                                VertexBufferSize = 0;
+        Uint32                                IndexBufferSize  = 0;
+
+        // Bindless pipeline: per-vertex texture indices and the texture arrays they index.
+        // A new table is started every time MaxBindlessTextures distinct textures are exceeded.
+        RefCntAutoPtr<IBuffer>                    pTexIndexVB;
+        std::vector<std::vector<IDeviceObject*>>  TextureTables;
+        std::unordered_map<ITextureView*, Uint32> TextureSlots;
+        std::vector<Uint32>                       CmdTableIds;
+    };
+
     inline float4 TransformClipRect(const ImVec2& DisplaySize, const float4& rect) const;
 
+    ContextResources& GetContextResources(IDeviceContext* pCtx);
+
+    void UpdateTextureTables(IDeviceContext* pCtx, ContextResources& Res, ImDrawData* pDrawData, Uint32 VtxRingOffset);
+
+    void BuildSDFFontAtlas(std::vector<Uint8>& Data, int& Width, int& Height);
+
+    Uint64 ComputeDrawDataHash(ImDrawData* pDrawData, bool& Cacheable) const;
+
+    void CreateCompositePSO();
+
+    // The distance range, in texels, encoded by the signed distance field font atlas
+    static constexpr int SDFSpread = 4;
+
+    // The size of the texture array used by the bindless pipeline
+    static constexpr Uint32 MaxBindlessTextures = 64;
+
 private:
-    RefCntAutoPtr<IRenderDevice>          m_pDevice;
-    RefCntAutoPtr<IBuffer>                m_pVB;
-    RefCntAutoPtr<IBuffer>                m_pIB;
-    RefCntAutoPtr<IBuffer>                m_pVertexConstantBuffer;
-    RefCntAutoPtr<IPipelineState>         m_pPSO;
-    RefCntAutoPtr<ITextureView>           m_pFontSRV;
-    RefCntAutoPtr<IShaderResourceBinding> m_pSRB;
-    IShaderResourceVariable*              m_pTextureVar = nullptr;
+    RefCntAutoPtr<IRenderDevice>  m_pDevice;
+    RefCntAutoPtr<IBuffer>        m_pVertexConstantBuffer;
+    RefCntAutoPtr<IPipelineState> m_pPSO;
+    RefCntAutoPtr<IPipelineState> m_pSDFPSO; // Renders the SDF font atlas when not using the bindless pipeline
+    RefCntAutoPtr<ITextureView>   m_pFontSRV;
+
+    // CPU copy of the font atlas and the range of rows that are yet to be uploaded
+    std::vector<Uint8> m_FontAtlasData;
+    Uint32             m_FontUpdateFirstRow = 0;
+    Uint32             m_FontUpdateEndRow   = 0;
+
+    // Resources of the immediate contexts
+    ContextResources m_ImmediateResources;
+
+    std::mutex                                                  m_DeferredResourcesMtx;
+    std::unordered_map<const IDeviceContext*, ContextResources> m_DeferredResources;
+
+    // Ring-buffer streaming (immediate contexts only): every RenderDrawData call sub-allocates
+    // its vertices and indices from the same unified-memory buffers, and the regions are recycled
+    // once the fence shows that the GPU has finished with them. Buffer sizes are counted in elements.
+    std::unique_ptr<RingBuffer> m_pVtxRing;
+    std::unique_ptr<RingBuffer> m_pIdxRing;
+    RefCntAutoPtr<IFence>       m_pFence;
+    Uint64                      m_FenceValue = 0;
+
+    // Cached UI target that is composited over the back buffer while the draw data does not change
+    RefCntAutoPtr<IPipelineState>         m_pCompositePSO;
+    RefCntAutoPtr<IShaderResourceBinding> m_pCompositeSRB;
+    RefCntAutoPtr<ITexture>               m_pCachedUITex;
+    RefCntAutoPtr<ITexture>               m_pCachedUIDepth;
+    Uint64                                m_CachedUIHash  = 0;
+    bool                                  m_CachedUIValid = false;
 
     const TEXTURE_FORMAT m_BackBufferFmt;
     const TEXTURE_FORMAT m_DepthBufferFmt;
-    Uint32               m_VertexBufferSize    = 0;
-    Uint32               m_IndexBufferSize     = 0;
+    const Uint32         m_InitialVertexBufferSize;
+    const Uint32         m_InitialIndexBufferSize;
     Uint32               m_RenderSurfaceWidth  = 0;
     Uint32               m_RenderSurfaceHeight = 0;
     SURFACE_TRANSFORM    m_SurfacePreTransform = SURFACE_TRANSFORM_IDENTITY;
     bool                 m_BaseVertexSupported = false;
+    bool                 m_UseBindless         = false;
+    bool                 m_UseRingBuffers      = false;
+    bool                 m_UseCompactVertices  = false;
+
+    IMGUI_FONT_ATLAS_MODE m_FontAtlasMode      = IMGUI_FONT_ATLAS_MODE_ALPHA8;
+    IMGUI_FONT_ATLAS_MODE m_FontAtlasModeInUse = IMGUI_FONT_ATLAS_MODE_RGBA8;
 };
 
 } // namespace Diligent
@@ -29,15 +29,34 @@
 
 #include <memory>
 #include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+#include "ImGuiInputQueue.hpp"
+
+struct ImDrawData;
 
 namespace Diligent
 {
 
 struct IRenderDevice;
 struct IDeviceContext;
+struct ITextureView;
 enum TEXTURE_FORMAT : Uint16;
 enum SURFACE_TRANSFORM : Uint32;
 
+/// Font atlas texture modes
+enum IMGUI_FONT_ATLAS_MODE : Uint8
+{
+    /// RGBA8 atlas
+    IMGUI_FONT_ATLAS_MODE_RGBA8 = 0,
+
+    /// R8 alpha-only atlas, expanded to white RGB by the texture view swizzle.
+    /// Falls back to RGBA8 if texture component swizzle is not supported.
+    IMGUI_FONT_ATLAS_MODE_ALPHA8,
+
+    /// R8 signed distance field atlas. Glyphs are rasterized once at the size of the font
+    /// and remain sharp at any scale (e.g. ImGuiIO::FontGlobalScale).
+    IMGUI_FONT_ATLAS_MODE_SDF
+};
+
 class ImGuiDiligentRenderer;
 
 class ImGuiImplDiligent
@@ -76,14 +95,56 @@ public:
     virtual void EndFrame();
     virtual void Render(IDeviceContext* pCtx);
 
+    /// Renders the draw data of a viewport
+
+    /// \param [in] pCtx      - Device context to record the commands into.
+    /// \param [in] pDrawData - Draw data produced by ImGui::Render() for the viewport.
+    ///
+    /// \remarks   Several viewports may be rendered concurrently from worker threads if each
+    ///            thread uses its own deferred context. The resulting command lists must be
+    ///            executed by the immediate context.
+    void RenderDrawData(IDeviceContext* pCtx, ImDrawData* pDrawData);
+
+    /// Renders the UI through a cached render target
+
+    /// \param [in] pCtx - Immediate device context.
+    /// \param [in] pRTV - Render target the UI is composited over, typically the back buffer.
+    /// \param [in] pDSV - Depth-stencil view to bind together with pRTV, may be null.
+    ///
+    /// \remarks   The UI is only re-rasterized when its draw data changes. In idle frames the cached
+    ///            target is blended over pRTV without uploading any geometry. Call InvalidateRenderCache()
+    ///            when the contents of a texture displayed by the UI change.
+    void RenderCached(IDeviceContext* pCtx, ITextureView* pRTV, ITextureView* pDSV);
+
+    /// Forces the next RenderCached call to re-render the UI.
+    void InvalidateRenderCache();
+
     // Use if you want to reset your rendering device without losing ImGui state.
     void InvalidateDeviceObjects();
     void CreateDeviceObjects();
 
     void UpdateFontsTexture();
 
+    /// Sets the font atlas texture mode, see IMGUI_FONT_ATLAS_MODE.
+    void SetFontAtlasMode(IMGUI_FONT_ATLAS_MODE Mode);
+
+    /// Enables the compact 12-byte vertex format.
+
+    /// \remarks   Positions are quantized to a quarter of a pixel relative to the display origin, and
+    ///            texture coordinates are clamped to [0, 1]. This reduces the vertex bandwidth of dense
+    ///            widgets such as plots by 40%.
+    void SetCompactVertexFormat(bool UseCompactVertices);
+
+    /// Returns the queue that platform backends push input events into.
+
+    /// \remarks   The events are applied by NewFrame(), which may run on a different thread
+    ///            than the OS event loop. See ImGuiInputQueue.
+    ImGuiInputQueue& GetInputQueue() { return m_InputQueue; }
+
 protected:
     std::unique_ptr<ImGuiDiligentRenderer> m_pRenderer;
+
+    ImGuiInputQueue m_InputQueue;
 };
 
 } // namespace Diligent
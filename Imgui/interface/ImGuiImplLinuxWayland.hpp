@@ -0,0 +1,93 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <chrono>
+
+#include "ImGuiImplDiligent.hpp"
+
+namespace Diligent
+{
+
+/// ImGui platform backend for native Wayland windows.
+
+/// Wayland delivers input through per-object listeners rather than a generic event
+/// structure, so the application forwards the decoded events to the Handle* methods.
+/// Pointer coordinates are in surface-local logical units and are converted to
+/// framebuffer pixels using the content scale set by SetContentScale().
+class ImGuiImplLinuxWayland final : public ImGuiImplDiligent
+{
+public:
+    ImGuiImplLinuxWayland(IRenderDevice* pDevice,
+                          TEXTURE_FORMAT BackBufferFmt,
+                          TEXTURE_FORMAT DepthBufferFmt,
+                          Uint32         DisplayWidth,
+                          Uint32         DisplayHeight,
+                          Uint32         InitialVertexBufferSize = ImGuiImplDiligent::DefaultInitialVBSize,
+                          Uint32         InitialIndexBufferSize  = ImGuiImplDiligent::DefaultInitialIBSize);
+
+    // clang-format off
+    ImGuiImplLinuxWayland             (const ImGuiImplLinuxWayland&)  = delete;
+    ImGuiImplLinuxWayland             (      ImGuiImplLinuxWayland&&) = delete;
+    ImGuiImplLinuxWayland& operator = (const ImGuiImplLinuxWayland&)  = delete;
+    ImGuiImplLinuxWayland& operator = (      ImGuiImplLinuxWayland&&) = delete;
+    // clang-format on
+
+    /// Each handler returns true if ImGui wants to capture the input.
+
+    /// \param [in] X, Y - Pointer position in surface-local logical units.
+    bool HandlePointerMotion(double X, double Y);
+
+    /// \param [in] Button - Linux input event code (BTN_LEFT, BTN_RIGHT, BTN_MIDDLE).
+    bool HandlePointerButton(Uint32 Button, bool IsPressed);
+
+    /// \param [in] Vertical, Horizontal - Scroll amount in wheel steps, positive values scroll up and right.
+    bool HandlePointerAxis(float Vertical, float Horizontal);
+
+    /// \param [in] KeySym - XKB key symbol of the key.
+    bool HandleKey(Uint32 KeySym, bool IsPressed);
+
+    void HandleModifiers(bool Ctrl, bool Shift, bool Alt, bool Super);
+
+    /// \param [in] UTF8 - Text produced by a key press, as returned by xkb_state_key_get_utf8().
+    bool HandleText(const char* UTF8);
+
+    /// Sets the ratio between framebuffer pixels and surface-local units (e.g. 1.25 for 125% fractional scale).
+    void SetContentScale(float Scale);
+
+    virtual void NewFrame(Uint32            RenderSurfaceWidth,
+                          Uint32            RenderSurfaceHeight,
+                          SURFACE_TRANSFORM SurfacePreTransform) override final;
+
+private:
+    float m_ContentScale = 1;
+
+    std::chrono::time_point<std::chrono::high_resolution_clock> m_LastTimestamp = {};
+};
+
+} // namespace Diligent
@@ -54,6 +54,11 @@ public:
     // clang-format on
 
     virtual void NewFrame(Uint32 RenderSurfaceWidth, Uint32 RenderSurfaceHeight, SURFACE_TRANSFORM SurfacePreTransform) override final;
+
+private:
+    // Only accessed by the thread that runs the message loop
+    Uint32  m_MouseButtonsDown = 0;
+    wchar_t m_HighSurrogate    = 0;
 };
 
 } // namespace Diligent
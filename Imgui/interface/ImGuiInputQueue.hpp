@@ -0,0 +1,111 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+
+struct ImGuiIO;
+
+namespace Diligent
+{
+
+/// Lock-free single-producer/single-consumer queue of ImGui input events.
+
+/// Platform backends push events from the thread that runs the OS event loop, and
+/// ImGuiImplDiligent::NewFrame applies them in a batch on the thread that renders the UI.
+/// All Push* methods must be called from the same thread.
+///
+/// If a mouse button or a key changes its state more than once between two frames (e.g. a click
+/// that is shorter than a frame), the remaining events are left in the queue for the next frame,
+/// so that ImGui sees every transition.
+class ImGuiInputQueue
+{
+public:
+    /// The number of events the queue can hold. Events pushed to a full queue are dropped.
+    static constexpr Uint32 Capacity = 1024;
+
+    bool PushMousePos(float X, float Y);
+    bool PushMouseButton(Uint32 Button, bool IsDown);
+    bool PushMouseWheel(float Vertical, float Horizontal = 0);
+    bool PushKey(Uint32 Key, bool IsDown);
+    bool PushModifiers(bool Ctrl, bool Shift, bool Alt, bool Super);
+    bool PushChar(Uint32 Char);
+    bool PushDisplaySize(float Width, float Height);
+
+    /// Applies the queued events to the ImGui IO. Must be called before ImGui::NewFrame().
+    void Apply(ImGuiIO& IO);
+
+    /// Publishes the capture flags computed by ImGui::NewFrame() to the event thread.
+    void UpdateCaptureFlags(const ImGuiIO& IO);
+
+    /// Returns the capture flags of the last frame. Safe to call from the event thread.
+    bool WantCaptureMouse() const { return m_WantCaptureMouse.load(std::memory_order_relaxed); }
+    bool WantCaptureKeyboard() const { return m_WantCaptureKeyboard.load(std::memory_order_relaxed); }
+
+private:
+    enum EVENT_TYPE : Uint8
+    {
+        EVENT_TYPE_MOUSE_POS,
+        EVENT_TYPE_MOUSE_BUTTON,
+        EVENT_TYPE_MOUSE_WHEEL,
+        EVENT_TYPE_KEY,
+        EVENT_TYPE_MODIFIERS,
+        EVENT_TYPE_CHAR,
+        EVENT_TYPE_DISPLAY_SIZE
+    };
+
+    struct Event
+    {
+        EVENT_TYPE Type   = EVENT_TYPE_MOUSE_POS;
+        bool       IsDown = false;
+        Uint32     Index  = 0; // Button, key, character or modifier flags
+        float      X      = 0;
+        float      Y      = 0;
+    };
+
+    bool Push(const Event& Evt);
+
+    std::array<Event, Capacity> m_Events;
+
+    // Head is only written by the consumer, tail is only written by the producer
+    std::atomic<Uint32> m_Head{0};
+    std::atomic<Uint32> m_Tail{0};
+
+    // The last modifier state is applied every frame, as platform backends may poll
+    // modifiers on the render thread, where the OS state can be stale.
+    Uint32 m_ModifierFlags  = 0;
+    bool   m_ModifiersKnown = false;
+
+    std::atomic<bool> m_WantCaptureMouse{false};
+    std::atomic<bool> m_WantCaptureKeyboard{false};
+};
+
+} // namespace Diligent
@@ -0,0 +1,220 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+#include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
+#include "ImGuiUtils.hpp"
+
+namespace Diligent
+{
+
+struct IRenderDevice;
+struct IDeviceContext;
+struct IQuery;
+
+/// Performance overlay that collects GPU timestamps, pipeline statistics and CPU scope timings,
+/// and renders them as rolling plots and a per-frame timeline.
+
+/// Usage:
+///
+///     Profiler.BeginFrame(pCtx);
+///     {
+///         ImGuiProfiler::ScopedCPUTimer CPUScope{Profiler, "Update"};
+///         ...
+///     }
+///     {
+///         ImGuiProfiler::ScopedGPUTimer GPUScope{Profiler, pCtx, "Shadows"};
+///         ...
+///     }
+///     Profiler.EndFrame(pCtx);
+///     ...
+///     Profiler.Render();
+///
+/// GPU results are read back a few frames later without waiting for the GPU. If the GPU
+/// falls further behind than CreateInfo::FramesInFlight, GPU data for the frame is not collected.
+/// Scope names must remain valid until the frame is resolved; string literals are expected.
+class ImGuiProfiler
+{
+public:
+    struct CreateInfo
+    {
+        /// The number of values kept by the rolling plots.
+        Uint32 HistoryLength = 256;
+
+        /// The number of frames whose GPU queries may be pending at the same time.
+        Uint32 FramesInFlight = 4;
+
+        /// The maximum number of GPU scopes per frame.
+        Uint32 MaxGPUScopes = 32;
+
+        /// The height of the plots, in pixels.
+        float PlotHeight = 50;
+    };
+
+    ImGuiProfiler(IRenderDevice* pDevice, const CreateInfo& CI);
+    explicit ImGuiProfiler(IRenderDevice* pDevice);
+    ~ImGuiProfiler();
+
+    // clang-format off
+    ImGuiProfiler             (const ImGuiProfiler&) = delete;
+    ImGuiProfiler& operator = (const ImGuiProfiler&) = delete;
+    // clang-format on
+
+    void BeginFrame(IDeviceContext* pCtx);
+    void EndFrame(IDeviceContext* pCtx);
+
+    void BeginCPUScope(const char* Name);
+    void EndCPUScope();
+
+    void BeginGPUScope(IDeviceContext* pCtx, const char* Name);
+    void EndGPUScope(IDeviceContext* pCtx);
+
+    /// Renders the overlay into the current ImGui window.
+    void Render();
+
+    class ScopedCPUTimer
+    {
+    public:
+        ScopedCPUTimer(ImGuiProfiler& Profiler, const char* Name) :
+            m_Profiler{Profiler}
+        {
+            m_Profiler.BeginCPUScope(Name);
+        }
+        ~ScopedCPUTimer()
+        {
+            m_Profiler.EndCPUScope();
+        }
+
+    private:
+        ImGuiProfiler& m_Profiler;
+    };
+
+    class ScopedGPUTimer
+    {
+    public:
+        ScopedGPUTimer(ImGuiProfiler& Profiler, IDeviceContext* pCtx, const char* Name) :
+            m_Profiler{Profiler},
+            m_pCtx{pCtx}
+        {
+            m_Profiler.BeginGPUScope(m_pCtx, Name);
+        }
+        ~ScopedGPUTimer()
+        {
+            m_Profiler.EndGPUScope(m_pCtx);
+        }
+
+    private:
+        ImGuiProfiler&  m_Profiler;
+        IDeviceContext* m_pCtx;
+    };
+
+    struct PipelineStats
+    {
+        Uint64 InputVertices      = 0;
+        Uint64 InputPrimitives    = 0;
+        Uint64 ClippingPrimitives = 0;
+        Uint64 VSInvocations      = 0;
+        Uint64 PSInvocations      = 0;
+        Uint64 CSInvocations      = 0;
+    };
+
+private:
+    using Clock = std::chrono::high_resolution_clock;
+
+    static constexpr Uint32 InvalidQuery = ~0u;
+
+    struct ScopeTiming
+    {
+        const char* Name     = nullptr;
+        Uint32      Depth    = 0;
+        double      Start    = 0; // Milliseconds from the beginning of the frame
+        double      Duration = 0;
+    };
+
+    struct GPUScope
+    {
+        const char* Name       = nullptr;
+        Uint32      Depth      = 0;
+        Uint32      BeginQuery = InvalidQuery;
+        Uint32      EndQuery   = InvalidQuery;
+    };
+
+    struct GPUFrame
+    {
+        std::vector<RefCntAutoPtr<IQuery>> Timestamps;
+        RefCntAutoPtr<IQuery>              Statistics;
+
+        std::vector<GPUScope> Scopes;
+        Uint32                NumTimestamps = 0;
+        bool                  Pending       = false;
+    };
+
+    Uint32 AddTimestamp(IDeviceContext* pCtx, GPUFrame& Frame);
+    bool   ResolveGPUFrame(GPUFrame& Frame);
+    void   ResolvePendingGPUFrames();
+    void   AddScopeValue(const char* Name, double Value, std::map<std::string, ImGui::Plot>& Plots);
+    void   RenderTimeline(const char* Label, const std::vector<ScopeTiming>& Scopes, double FrameTime);
+
+private:
+    const CreateInfo m_CI;
+
+    RefCntAutoPtr<IRenderDevice> m_pDevice;
+
+    // GPU queries of the frames in flight. m_pCurrGPUFrame is null if the frame is not measured.
+    std::vector<GPUFrame> m_GPUFrames;
+    Uint64                m_FrameIndex    = 0;
+    Uint64                m_OldestPending = 0;
+    GPUFrame*             m_pCurrGPUFrame = nullptr;
+    std::vector<Uint32>   m_GPUScopeStack;
+    std::vector<Uint64>   m_TimestampScratch;
+
+    // CPU scopes of the current frame
+    Clock::time_point        m_FrameStart;
+    std::vector<ScopeTiming> m_CPUScopes;
+    std::vector<size_t>      m_CPUScopeStack;
+
+    // Latest complete frames
+    std::vector<ScopeTiming> m_LastCPUScopes;
+    std::vector<ScopeTiming> m_LastGPUScopes;
+    double                   m_LastCPUFrameTime = 0;
+    double                   m_LastGPUFrameTime = 0;
+    PipelineStats            m_LastStats;
+
+    ImGui::Plot                        m_CPUFramePlot;
+    ImGui::Plot                        m_GPUFramePlot;
+    std::map<std::string, ImGui::Plot> m_CPUScopePlots;
+    std::map<std::string, ImGui::Plot> m_GPUScopePlots;
+};
+
+} // namespace Diligent
@@ -0,0 +1,187 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+#include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
+#include "imgui.h"
+
+namespace Diligent
+{
+
+struct IRenderDevice;
+struct IDeviceContext;
+struct ITexture;
+struct IThreadPool;
+
+/// Thumbnail atlas for ImGui image widgets.
+
+/// Thumbnails are decoded from image files on worker threads at reduced size and are uploaded
+/// into a shared atlas texture. Until a thumbnail is ready, its UV coordinates point to a
+/// placeholder, so that the UI never waits for the files to load.
+///
+/// Usage:
+///
+///     Atlas.Update(pCtx); // Once per frame, before ImGui draw data is rendered
+///     ...
+///     Atlas.Image(FilePath, ImVec2{64, 64});
+///
+/// JPEG images are decoded at the smallest scale that is not below the thumbnail size.
+/// DDS and KTX files only read the mip level that is closest to the thumbnail size, which must be
+/// in an RGBA8 format. When the atlas is full, the least recently used thumbnails that were not
+/// drawn in the current frame are evicted.
+///
+/// \remarks All methods must be called from the same thread.
+class ImGuiThumbnailAtlas
+{
+public:
+    struct CreateInfo
+    {
+        /// The maximum width and height of a thumbnail, in pixels.
+        Uint32 ThumbnailSize = 128;
+
+        /// The width and height of the atlas texture, in pixels.
+        Uint32 AtlasSize = 2048;
+
+        /// The maximum number of thumbnails uploaded by one Update call.
+        Uint32 MaxUploadsPerFrame = 16;
+
+        /// An optional thread pool to decode the images on. If null, the atlas
+        /// creates its own pool with two threads.
+        IThreadPool* pThreadPool = nullptr;
+    };
+
+    struct Thumbnail
+    {
+        /// Atlas texture view; the same for all thumbnails.
+        ImTextureID TextureId = nullptr;
+
+        /// UV coordinates of the thumbnail, or of the placeholder if the thumbnail is not ready.
+        ImVec2 UV0;
+        ImVec2 UV1;
+
+        /// Thumbnail size in pixels, or the placeholder size if the thumbnail is not ready.
+        ImVec2 Size;
+
+        bool IsReady = false;
+    };
+
+    ImGuiThumbnailAtlas(IRenderDevice* pDevice, const CreateInfo& CI);
+    explicit ImGuiThumbnailAtlas(IRenderDevice* pDevice);
+    ~ImGuiThumbnailAtlas();
+
+    // clang-format off
+    ImGuiThumbnailAtlas             (const ImGuiThumbnailAtlas&) = delete;
+    ImGuiThumbnailAtlas& operator = (const ImGuiThumbnailAtlas&) = delete;
+    // clang-format on
+
+    /// Returns the thumbnail of the image file and starts loading it if it is not in the atlas.
+    Thumbnail GetThumbnail(const char* FilePath);
+
+    /// Draws the thumbnail with ImGui::Image, scaled to fit the given size while keeping its aspect ratio.
+
+    /// \return true if the thumbnail is ready.
+    bool Image(const char* FilePath, const ImVec2& MaxSize);
+
+    /// Uploads the thumbnails decoded since the last call into the atlas.
+
+    /// \remarks Must be called once per frame with an immediate context, before the ImGui draw data
+    ///          that references the atlas is rendered. The atlas is transitioned to the shader resource state.
+    void Update(IDeviceContext* pCtx);
+
+    /// Returns the maximum number of thumbnails that can be resident in the atlas.
+    Uint32 GetCapacity() const { return static_cast<Uint32>(m_NumSlots - 1); }
+
+private:
+    enum class EntryState
+    {
+        Loading,
+        Ready,
+        Failed
+    };
+
+    struct Entry
+    {
+        EntryState State  = EntryState::Loading;
+        Uint32     Slot   = 0; // Slot 0 is the placeholder
+        Uint32     Width  = 0;
+        Uint32     Height = 0;
+
+        // The frame when the thumbnail was last requested. Thumbnails requested in
+        // the current frame are referenced by the draw data and must not be evicted.
+        Uint64 LastUsedFrame = 0;
+
+        std::list<std::string>::iterator LRUIt;
+    };
+
+    struct DecodedThumbnail
+    {
+        std::string        FilePath;
+        std::vector<Uint8> Pixels; // RGBA8, tightly packed
+        Uint32             Width  = 0;
+        Uint32             Height = 0;
+    };
+
+    bool      AllocateSlot(Uint32& Slot);
+    void      EnqueueDecode(const std::string& FilePath);
+    Thumbnail GetSlotThumbnail(Uint32 Slot, Uint32 Width, Uint32 Height, bool IsReady) const;
+    void      UploadToSlot(IDeviceContext* pCtx, Uint32 Slot, const Uint8* pPixels, Uint32 Width, Uint32 Height);
+
+private:
+    const CreateInfo m_CI;
+    const Uint32     m_SlotsPerRow;
+    const Uint32     m_NumSlots;
+
+    RefCntAutoPtr<IRenderDevice> m_pDevice;
+    RefCntAutoPtr<ITexture>      m_pAtlas;
+    RefCntAutoPtr<IThreadPool>   m_pThreadPool;
+
+    std::unordered_map<std::string, Entry> m_Entries;
+
+    // File paths of the thumbnails that occupy atlas slots, from the most to the least recently used
+    std::list<std::string> m_LRU;
+    std::vector<Uint32>    m_FreeSlots;
+
+    Uint64 m_FrameIndex             = 1;
+    bool   m_PlaceholderInitialized = false;
+
+    // Thumbnails decoded by the worker threads and not yet uploaded
+    std::mutex                    m_DecodedMtx;
+    std::condition_variable       m_DecodedCV;
+    std::vector<DecodedThumbnail> m_Decoded;
+    Uint32                        m_NumPendingTasks = 0;
+};
+
+} // namespace Diligent
@@ -32,9 +32,14 @@
 #include <limits>
 #include <memory>
 #include <vector>
+#include <functional>
+#include <unordered_map>
 
 #include "../../../DiligentCore/Platforms/Basic/interface/DebugUtilities.hpp"
 
+struct ImDrawList;
+struct ImVec2;
+
 namespace ImGui
 {
 
@@ -161,4 +166,162 @@ private:
     size_t             m_FrameNum = 0;
 };
 
+
+/// Combo box that only submits the items visible in the popup.
+
+/// Unlike the array-based overloads, the item names are requested through GetItemName only for the
+/// visible items, so lists with hundreds of thousands of entries cost the same as short ones.
+bool Combo(const char* label, int* current_item, int items_count, const std::function<const char*(int)>& GetItemName, int popup_max_height_in_items = -1);
+
+
+/// Renders a list of rows with variable heights, submitting only the rows that are visible.
+
+/// Row heights are cached in a Fenwick tree: finding the first visible row and updating a height
+/// take O(log N), so a frame costs O(V log N) for V visible rows regardless of the total row count N.
+/// The heights of the rendered rows are measured and the cache is updated, so the heights passed
+/// to Resize() only need to be estimates. Every row is rendered with its index pushed to the ID stack.
+///
+///     if (ImGui::BeginChild("Assets"))
+///         List.Render([&](size_t Row) { ImGui::TextUnformatted(Names[Row].c_str()); });
+///     ImGui::EndChild();
+///
+/// When called between BeginTable() and EndTable(), the list calls TableNextRow() for every
+/// row and the callback only fills the columns.
+class VirtualList
+{
+public:
+    /// Resizes the list. The heights of existing rows are preserved, new rows get DefaultRowHeight.
+    /// If DefaultRowHeight is zero, GetTextLineHeightWithSpacing() is used.
+    void Resize(size_t NumRows, float DefaultRowHeight = 0);
+
+    size_t GetNumRows() const { return m_Heights.size(); }
+    float  GetRowHeight(size_t Row) const { return m_Heights[Row]; }
+    void   SetRowHeight(size_t Row, float Height);
+
+    /// Returns the distance from the top of the list to the top of the row.
+    float GetRowOffset(size_t Row) const;
+    float GetTotalHeight() const { return GetRowOffset(m_Heights.size()); }
+
+    /// Scrolls the list so that the row is visible during the next Render() call.
+    void ScrollToRow(size_t Row) { m_ScrollToRow = Row; }
+
+    void Render(const std::function<void(size_t Row)>& RenderRow);
+
+    /// The range [First, End) of the rows rendered by the last Render() call.
+    size_t GetFirstRenderedRow() const { return m_FirstRendered; }
+    size_t GetEndRenderedRow() const { return m_EndRendered; }
+
+private:
+    // Returns the index of the row that contains the offset
+    size_t FindRow(float Offset) const;
+
+    std::vector<float>  m_Heights;
+    std::vector<double> m_Tree; // Fenwick tree of m_Heights
+
+    static constexpr size_t InvalidRow = ~size_t{0};
+
+    size_t m_ScrollToRow   = InvalidRow;
+    size_t m_FirstRendered = 0;
+    size_t m_EndRendered   = 0;
+};
+
+
+/// Tree whose nodes are rendered through a VirtualList.
+
+/// The nodes are stored in depth-first order and described by their depths. Only the rows of
+/// the nodes whose ancestors are all expanded are laid out; the list of such nodes is rebuilt
+/// when a node is expanded or collapsed. The callback renders the node contents after the arrow.
+class VirtualTree
+{
+public:
+    /// Sets the nodes in depth-first order. A node has children if the next node is deeper.
+    void SetNodes(std::vector<int> Depths, float DefaultRowHeight = 0);
+
+    size_t GetNumNodes() const { return m_Depths.size(); }
+    bool   IsExpanded(size_t Node) const { return m_Expanded[Node]; }
+    void   SetExpanded(size_t Node, bool Expanded);
+
+    void Render(const std::function<void(size_t Node)>& RenderNode);
+
+private:
+    bool HasChildren(size_t Node) const { return Node + 1 < m_Depths.size() && m_Depths[Node + 1] > m_Depths[Node]; }
+
+    void UpdateVisibleNodes();
+
+    std::vector<int>    m_Depths;
+    std::vector<bool>   m_Expanded;
+    std::vector<size_t> m_VisibleNodes;
+    VirtualList         m_List;
+    float               m_DefaultRowHeight  = 0;
+    bool                m_VisibleNodesDirty = true;
+};
+
+
+/// Cache of the glyph quads of text runs.
+
+/// ImGui lays out every glyph of every visible text item each frame. The cache keeps the vertices
+/// of the runs it has rendered, keyed by the text, the font and the font size, and appends them to
+/// the draw list with a single copy, so that large static text such as logs and profiler views costs
+/// little more than the vertex copy. Runs that have not been used for MaxUnusedFrames are evicted by NewFrame().
+///
+///     Cache.NewFrame();
+///     ...
+///     List.Render([&](size_t Row) { ImGui::TextUnformatted(Cache, Lines[Row].c_str()); });
+///
+/// Glyphs of cached runs are not clipped on the CPU; the scissor rectangle clips them on the GPU.
+/// The cache must be cleared when the font atlas is rebuilt.
+class TextRunCache
+{
+public:
+    explicit TextRunCache(size_t MaxUnusedFrames = 60) :
+        m_MaxUnusedFrames{MaxUnusedFrames}
+    {}
+
+    /// Evicts the runs that have not been used recently. Must be called once per frame.
+    void NewFrame();
+
+    void Clear() { m_Runs.clear(); }
+
+    /// Adds the text in the current font to the draw list, the same way as ImDrawList::AddText.
+    void AddText(ImDrawList* pDrawList, const ImVec2& Pos, unsigned int Color, const char* TextBegin, const char* TextEnd = nullptr);
+
+    /// Returns the size of the text in the current font. The size of a cached run is not recomputed.
+    ImVec2 CalcTextSize(const char* TextBegin, const char* TextEnd = nullptr) const;
+
+    size_t GetNumRuns() const { return m_Runs.size(); }
+
+private:
+    struct Vertex
+    {
+        float x, y; // Position relative to the run origin
+        float u, v;
+    };
+
+    struct Run
+    {
+        std::string Text;
+        const void* pFont    = nullptr;
+        float       FontSize = 0;
+        float       Width    = 0;
+        float       Height   = 0;
+
+        std::vector<Vertex>       Vertices;
+        std::vector<unsigned int> Indices; // Relative to the first vertex of the run
+
+        size_t LastUsedFrame = 0;
+    };
+
+    const Run* FindRun(size_t Key, const char* TextBegin, const char* TextEnd) const;
+
+    static size_t GetKey(const char* TextBegin, const char* TextEnd);
+
+    std::unordered_map<size_t, Run> m_Runs;
+
+    const size_t m_MaxUnusedFrames;
+    size_t       m_FrameIndex = 0;
+};
+
+/// Same as ImGui::TextUnformatted, but the glyph quads are taken from the cache.
+void TextUnformatted(TextRunCache& Cache, const char* text, const char* text_end = nullptr);
+
 } // namespace ImGui
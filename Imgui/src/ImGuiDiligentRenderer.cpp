@@ -26,10 +26,22 @@
  */
 
 #include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
 #include "ImGuiDiligentRenderer.hpp"
 #include "RenderDevice.h"
 #include "DeviceContext.h"
 #include "MapHelper.hpp"
+#include "ShaderMacroHelper.hpp"
+#include "RingBuffer.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "ToolsTrace.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define IMGUI_RENDERER_USE_SSE2 1
+#endif
 
 namespace Diligent
 {
@@ -79,7 +91,91 @@ float4 main(in PSInput PSIn) : SV_Target
 }
 )";
 
+// Renders the signed distance field font atlas. The distance is stored in the red channel
+// with the glyph edge at 0.5; texels outside of the glyphs keep their coverage.
+static const char* SDFPixelShaderHLSL = R"(
+struct PSInput
+{
+    float4 pos : SV_POSITION;
+    float4 col : COLOR;
+    float2 uv  : TEXCOORD;
+};
+
+Texture2D    Texture;
+SamplerState Texture_sampler;
+
+float4 main(in PSInput PSIn) : SV_Target
+{
+    float Dist  = Texture.Sample(Texture_sampler, PSIn.uv).r;
+    float Width = max(fwidth(Dist) * 0.5, 1e-5);
+    return float4(PSIn.col.rgb, PSIn.col.a * smoothstep(0.5 - Width, 0.5 + Width, Dist));
+}
+)";
+
+
+
+// Marks the SDF font atlas in the per-vertex texture index of the bindless pipeline
+static constexpr Uint32 SDFTextureFlag = 0x80000000u;
+
+// Bindless variant: the texture is selected per vertex from a texture array, so that
+// consecutive draw commands that only differ by the texture can be merged into one draw.
+static const char* BindlessVertexShaderHLSL = R"(
+cbuffer Constants
+{
+    float4x4 ProjectionMatrix;
+}
+
+struct VSInput
+{
+    float2 pos : ATTRIB0;
+    float2 uv  : ATTRIB1;
+    float4 col : ATTRIB2;
+    uint   tex : ATTRIB3;
+};
+
+struct PSInput
+{
+    float4 pos : SV_POSITION;
+    float4 col : COLOR;
+    float2 uv  : TEXCOORD;
+    nointerpolation uint tex : TEX_INDEX;
+};
+
+void main(in VSInput VSIn, out PSInput PSIn)
+{
+    PSIn.pos = mul(ProjectionMatrix, float4(VSIn.pos.xy, 0.0, 1.0));
+    PSIn.col = VSIn.col;
+    PSIn.uv  = VSIn.uv;
+    PSIn.tex = VSIn.tex;
+}
+)";
+
+static const char* BindlessPixelShaderHLSL = R"(
+struct PSInput
+{
+    float4 pos : SV_POSITION;
+    float4 col : COLOR;
+    float2 uv  : TEXCOORD;
+    nointerpolation uint tex : TEX_INDEX;
+};
+
+Texture2D    Textures[MAX_TEXTURES];
+SamplerState Textures_sampler;
+
+// The high bit of the texture index marks the signed distance field font atlas
+#define SDF_TEXTURE_FLAG 0x80000000u
 
+float4 main(in PSInput PSIn) : SV_Target
+{
+    float4 Color = Textures[NonUniformResourceIndex(PSIn.tex & ~SDF_TEXTURE_FLAG)].Sample(Textures_sampler, PSIn.uv);
+    if ((PSIn.tex & SDF_TEXTURE_FLAG) != 0u)
+    {
+        float Width = max(fwidth(Color.r) * 0.5, 1e-5);
+        return float4(PSIn.col.rgb, PSIn.col.a * smoothstep(0.5 - Width, 0.5 + Width, Color.r));
+    }
+    return PSIn.col * Color;
+}
+)";
 
 static const char* VertexShaderGLSL = R"(
 #ifdef VULKAN
@@ -137,6 +233,30 @@ void main()
 }
 )";
 
+// Also compiled at run time on Vulkan, as there is no precompiled SPIR-V for it
+static const char* SDFPixelShaderGLSL = R"(
+#ifdef VULKAN
+#   define BINDING(X) layout(binding=X)
+#   define IN_LOCATION(X) layout(location=X) // Requires separable programs
+#else
+#   define BINDING(X)
+#   define IN_LOCATION(X)
+#endif
+BINDING(0) uniform sampler2D Texture;
+
+IN_LOCATION(0) in vec4 vsout_col;
+IN_LOCATION(1) in vec2 vsout_uv;
+
+layout(location = 0) out vec4 psout_col;
+
+void main()
+{
+    float Dist  = texture(Texture, vsout_uv).r;
+    float Width = max(fwidth(Dist) * 0.5, 1e-5);
+    psout_col = vec4(vsout_col.rgb, vsout_col.a * smoothstep(0.5 - Width, 0.5 + Width, Dist));
+}
+)";
+
 
 // clang-format off
 
@@ -258,24 +378,189 @@ fragment PSOut ps_main(VSOut in [[stage_in]],
     out.col = in.col * Texture.sample(Texture_sampler, in.uv);
     return out;
 }
+
+fragment PSOut ps_main_sdf(VSOut in [[stage_in]],
+                           texture2d<float> Texture [[texture(0)]],
+                           sampler Texture_sampler  [[sampler(0)]])
+{
+    PSOut out = {};
+    float Dist  = Texture.sample(Texture_sampler, in.uv).r;
+    float Width = max(fwidth(Dist) * 0.5, 1e-5);
+    out.col = float4(in.col.rgb, in.col.a * smoothstep(0.5 - Width, 0.5 + Width, Dist));
+    return out;
+}
+)";
+
+
+// Composites the cached UI render target over the back buffer. The target has the same size
+// as the back buffer, so texels are fetched by pixel coordinates and no sampling is required.
+static const char* CompositeVertexShaderHLSL = R"(
+void main(in uint VertId : SV_VertexID, out float4 Pos : SV_POSITION)
+{
+    float2 uv = float2((VertId << 1) & 2, VertId & 2);
+    Pos = float4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+static const char* CompositePixelShaderHLSL = R"(
+Texture2D CachedUI;
+
+float4 main(in float4 Pos : SV_POSITION) : SV_Target
+{
+    return CachedUI.Load(int3(Pos.xy, 0));
+}
+)";
+
+static const char* CompositeVertexShaderGLSL = R"(
+#ifdef VULKAN
+#   define VERTEX_ID gl_VertexIndex
+#else
+#   define VERTEX_ID gl_VertexID
+#endif
+
+#ifndef GL_ES
+out gl_PerVertex
+{
+    vec4 gl_Position;
+};
+#endif
+
+void main()
+{
+    vec2 uv = vec2((VERTEX_ID << 1) & 2, VERTEX_ID & 2);
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+static const char* CompositePixelShaderGLSL = R"(
+#ifdef VULKAN
+#   define BINDING(X) layout(binding=X)
+#else
+#   define BINDING(X)
+#endif
+BINDING(0) uniform sampler2D CachedUI;
+
+layout(location = 0) out vec4 psout_col;
+
+void main()
+{
+    psout_col = texelFetch(CachedUI, ivec2(gl_FragCoord.xy), 0);
+}
+)";
+
+static const char* CompositeShadersMSL = R"(
+#include <metal_stdlib>
+
+using namespace metal;
+
+struct VSOut
+{
+    float4 pos [[position]];
+};
+
+vertex VSOut vs_composite(uint VertId [[vertex_id]])
+{
+    VSOut out = {};
+    float2 uv = float2((VertId << 1) & 2, VertId & 2);
+    out.pos = float4(uv * 2.0 - 1.0, 0.0, 1.0);
+    return out;
+}
+
+fragment float4 ps_composite(VSOut in [[stage_in]],
+                             texture2d<float> CachedUI [[texture(0)]])
+{
+    return CachedUI.read(uint2(in.pos.xy));
+}
 )";
 
+// 64-bit FNV-1a variant that consumes eight bytes per step
+static Uint64 HashMemory(const void* pData, size_t Size, Uint64 Hash)
+{
+    constexpr Uint64 Prime = 0x100000001B3ull;
+
+    const auto* pBytes = static_cast<const Uint8*>(pData);
+    for (; Size >= sizeof(Uint64); Size -= sizeof(Uint64), pBytes += sizeof(Uint64))
+    {
+        Uint64 Word;
+        memcpy(&Word, pBytes, sizeof(Word));
+        Hash = (Hash ^ Word) * Prime;
+    }
+    for (; Size > 0; --Size, ++pBytes)
+        Hash = (Hash ^ *pBytes) * Prime;
+
+    return Hash;
+}
+
+// Converts ImGui vertices to the compact format. Positions are stored relative to Origin
+// in fixed point with CompactPosScale subpixel steps, texture coordinates are clamped to [0, 1].
+static void ConvertToCompactVertices(const ImDrawVert*                     pSrc,
+                                     ImGuiDiligentRenderer::CompactVertex* pDst,
+                                     int                                   Count,
+                                     const ImVec2&                         Origin)
+{
+    constexpr float PosScale = ImGuiDiligentRenderer::CompactPosScale;
+    static_assert(offsetof(ImDrawVert, uv) == offsetof(ImDrawVert, pos) + sizeof(ImVec2), "Position and UV are expected to be adjacent");
+
+#if IMGUI_RENDERER_USE_SSE2
+    const __m128  Offset = _mm_setr_ps(Origin.x, Origin.y, 0.f, 0.f);
+    const __m128  Scale  = _mm_setr_ps(PosScale, PosScale, 65535.f, 65535.f);
+    const __m128  Min    = _mm_setr_ps(-32767.f, -32767.f, 0.f, 0.f);
+    const __m128  Max    = _mm_setr_ps(32767.f, 32767.f, 65535.f, 65535.f);
+    const __m128i UVBias = _mm_setr_epi32(0, 0, 32768, 32768);
+    // Signed saturation would clamp UVs to 32767, so they are packed biased and the sign bit is flipped back
+    const __m128i UVFlip = _mm_setr_epi16(0, 0, -32768, -32768, 0, 0, 0, 0);
+    for (int i = 0; i < Count; ++i)
+    {
+        __m128  PosUV  = _mm_loadu_ps(&pSrc[i].pos.x);
+        __m128  Scaled = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(PosUV, Offset), Scale), Min), Max);
+        __m128i Ints   = _mm_sub_epi32(_mm_cvtps_epi32(Scaled), UVBias);
+        __m128i Packed = _mm_xor_si128(_mm_packs_epi32(Ints, Ints), UVFlip);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pDst[i].pos), Packed);
+        pDst[i].col = pSrc[i].col;
+    }
+#else
+    auto Quantize = [](float Val, float Min, float Max) //
+    {
+        return static_cast<Int32>(std::floor(std::max(std::min(Val, Max), Min) + 0.5f));
+    };
+    for (int i = 0; i < Count; ++i)
+    {
+        const auto& Src = pSrc[i];
+        auto&       Dst = pDst[i];
+        Dst.pos[0]      = static_cast<Int16>(Quantize((Src.pos.x - Origin.x) * PosScale, -32767.f, 32767.f));
+        Dst.pos[1]      = static_cast<Int16>(Quantize((Src.pos.y - Origin.y) * PosScale, -32767.f, 32767.f));
+        Dst.uv[0]       = static_cast<Uint16>(Quantize(Src.uv.x * 65535.f, 0.f, 65535.f));
+        Dst.uv[1]       = static_cast<Uint16>(Quantize(Src.uv.y * 65535.f, 0.f, 65535.f));
+        Dst.col         = Src.col;
+    }
+#endif
+}
+
 ImGuiDiligentRenderer::ImGuiDiligentRenderer(IRenderDevice* pDevice,
                                              TEXTURE_FORMAT BackBufferFmt,
                                              TEXTURE_FORMAT DepthBufferFmt,
                                              Uint32         InitialVertexBufferSize,
                                              Uint32         InitialIndexBufferSize) :
     // clang-format off
-    m_pDevice         {pDevice},
-    m_BackBufferFmt   {BackBufferFmt},
-    m_DepthBufferFmt  {DepthBufferFmt},
-    m_VertexBufferSize{InitialVertexBufferSize},
-    m_IndexBufferSize {InitialIndexBufferSize}
+    m_pDevice                {pDevice},
+    m_BackBufferFmt          {BackBufferFmt},
+    m_DepthBufferFmt         {DepthBufferFmt},
+    m_InitialVertexBufferSize{InitialVertexBufferSize},
+    m_InitialIndexBufferSize {InitialIndexBufferSize}
 // clang-format on
 {
     //Check support vertex offset
     m_BaseVertexSupported = pDevice->GetAdapterInfo().DrawCommand.CapFlags & DRAW_COMMAND_CAP_FLAG_BASE_VERTEX;
 
+    // Use the bindless pipeline where texture arrays can be indexed non-uniformly
+    const auto& DeviceInfo = pDevice->GetDeviceInfo();
+    m_UseBindless =
+        DeviceInfo.Features.BindlessResources != DEVICE_FEATURE_STATE_DISABLED &&
+        (DeviceInfo.Type == RENDER_DEVICE_TYPE_D3D12 || DeviceInfo.Type == RENDER_DEVICE_TYPE_VULKAN);
+
+    // Stream vertices through persistent buffers when the CPU can write GPU-visible memory directly
+    m_UseRingBuffers = (pDevice->GetAdapterInfo().Memory.UnifiedMemoryCPUAccess & CPU_ACCESS_WRITE) != 0;
+
     // Setup back-end capabilities flags
     IMGUI_CHECKVERSION();
     ImGuiIO& IO = ImGui::GetIO();
@@ -308,12 +593,31 @@ void ImGuiDiligentRenderer::EndFrame()
 
 void ImGuiDiligentRenderer::InvalidateDeviceObjects()
 {
-    m_pVB.Release();
-    m_pIB.Release();
+    m_ImmediateResources.pVB.Release();
+    m_ImmediateResources.pIB.Release();
+    m_ImmediateResources.pTexIndexVB.Release();
+    m_ImmediateResources.pSRB.Release();
+    m_ImmediateResources.pTextureVar = nullptr;
+    {
+        std::lock_guard<std::mutex> Lock{m_DeferredResourcesMtx};
+        m_DeferredResources.clear();
+    }
+    m_pVtxRing.reset();
+    m_pIdxRing.reset();
+    m_pFence.Release();
+    m_FenceValue = 0;
     m_pVertexConstantBuffer.Release();
     m_pPSO.Release();
+    m_pSDFPSO.Release();
     m_pFontSRV.Release();
-    m_pSRB.Release();
+    m_FontAtlasData.clear();
+    m_FontUpdateFirstRow = 0;
+    m_FontUpdateEndRow   = 0;
+    m_pCompositePSO.Release();
+    m_pCompositeSRB.Release();
+    m_pCachedUITex.Release();
+    m_pCachedUIDepth.Release();
+    m_CachedUIValid = false;
 }
 
 void ImGuiDiligentRenderer::CreateDeviceObjects()
@@ -325,33 +629,48 @@ void ImGuiDiligentRenderer::CreateDeviceObjects()
 
     const auto DeviceType = m_pDevice->GetDeviceInfo().Type;
 
+    ShaderMacroHelper Macros;
+    if (m_UseBindless)
+    {
+        ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_HLSL;
+        Macros.AddShaderMacro("MAX_TEXTURES", MaxBindlessTextures);
+        ShaderCI.Macros = Macros;
+    }
+
     RefCntAutoPtr<IShader> pVS;
     {
         ShaderCI.Desc = {"Imgui VS", SHADER_TYPE_VERTEX, true};
-        switch (DeviceType)
+        if (m_UseBindless)
         {
-            case RENDER_DEVICE_TYPE_VULKAN:
-                ShaderCI.ByteCode     = VertexShader_SPIRV;
-                ShaderCI.ByteCodeSize = sizeof(VertexShader_SPIRV);
-                break;
-
-            case RENDER_DEVICE_TYPE_D3D11:
-            case RENDER_DEVICE_TYPE_D3D12:
-                ShaderCI.Source = VertexShaderHLSL;
-                break;
-
-            case RENDER_DEVICE_TYPE_GL:
-            case RENDER_DEVICE_TYPE_GLES:
-                ShaderCI.Source = VertexShaderGLSL;
-                break;
-
-            case RENDER_DEVICE_TYPE_METAL:
-                ShaderCI.Source     = ShadersMSL;
-                ShaderCI.EntryPoint = "vs_main";
-                break;
-
-            default:
-                UNEXPECTED("Unknown render device type");
+            ShaderCI.Source = BindlessVertexShaderHLSL;
+        }
+        else
+        {
+            switch (DeviceType)
+            {
+                case RENDER_DEVICE_TYPE_VULKAN:
+                    ShaderCI.ByteCode     = VertexShader_SPIRV;
+                    ShaderCI.ByteCodeSize = sizeof(VertexShader_SPIRV);
+                    break;
+
+                case RENDER_DEVICE_TYPE_D3D11:
+                case RENDER_DEVICE_TYPE_D3D12:
+                    ShaderCI.Source = VertexShaderHLSL;
+                    break;
+
+                case RENDER_DEVICE_TYPE_GL:
+                case RENDER_DEVICE_TYPE_GLES:
+                    ShaderCI.Source = VertexShaderGLSL;
+                    break;
+
+                case RENDER_DEVICE_TYPE_METAL:
+                    ShaderCI.Source     = ShadersMSL;
+                    ShaderCI.EntryPoint = "vs_main";
+                    break;
+
+                default:
+                    UNEXPECTED("Unknown render device type");
+            }
         }
         m_pDevice->CreateShader(ShaderCI, &pVS);
     }
@@ -359,30 +678,37 @@ void ImGuiDiligentRenderer::CreateDeviceObjects()
     RefCntAutoPtr<IShader> pPS;
     {
         ShaderCI.Desc = {"Imgui PS", SHADER_TYPE_PIXEL, true};
-        switch (DeviceType)
+        if (m_UseBindless)
         {
-            case RENDER_DEVICE_TYPE_VULKAN:
-                ShaderCI.ByteCode     = FragmentShader_SPIRV;
-                ShaderCI.ByteCodeSize = sizeof(FragmentShader_SPIRV);
-                break;
-
-            case RENDER_DEVICE_TYPE_D3D11:
-            case RENDER_DEVICE_TYPE_D3D12:
-                ShaderCI.Source = PixelShaderHLSL;
-                break;
-
-            case RENDER_DEVICE_TYPE_GL:
-            case RENDER_DEVICE_TYPE_GLES:
-                ShaderCI.Source = PixelShaderGLSL;
-                break;
-
-            case RENDER_DEVICE_TYPE_METAL:
-                ShaderCI.Source     = ShadersMSL;
-                ShaderCI.EntryPoint = "ps_main";
-                break;
-
-            default:
-                UNEXPECTED("Unknown render device type");
+            ShaderCI.Source = BindlessPixelShaderHLSL;
+        }
+        else
+        {
+            switch (DeviceType)
+            {
+                case RENDER_DEVICE_TYPE_VULKAN:
+                    ShaderCI.ByteCode     = FragmentShader_SPIRV;
+                    ShaderCI.ByteCodeSize = sizeof(FragmentShader_SPIRV);
+                    break;
+
+                case RENDER_DEVICE_TYPE_D3D11:
+                case RENDER_DEVICE_TYPE_D3D12:
+                    ShaderCI.Source = PixelShaderHLSL;
+                    break;
+
+                case RENDER_DEVICE_TYPE_GL:
+                case RENDER_DEVICE_TYPE_GLES:
+                    ShaderCI.Source = PixelShaderGLSL;
+                    break;
+
+                case RENDER_DEVICE_TYPE_METAL:
+                    ShaderCI.Source     = ShadersMSL;
+                    ShaderCI.EntryPoint = "ps_main";
+                    break;
+
+                default:
+                    UNEXPECTED("Unknown render device type");
+            }
         }
         m_pDevice->CreateShader(ShaderCI, &pPS);
     }
@@ -404,28 +730,39 @@ void ImGuiDiligentRenderer::CreateDeviceObjects()
     GraphicsPipeline.RasterizerDesc.ScissorEnable = True;
     GraphicsPipeline.DepthStencilDesc.DepthEnable = False;
 
+    // Alpha accumulates coverage, so that the cached UI target holds premultiplied colors
     auto& RT0                 = GraphicsPipeline.BlendDesc.RenderTargets[0];
     RT0.BlendEnable           = True;
     RT0.SrcBlend              = BLEND_FACTOR_SRC_ALPHA;
     RT0.DestBlend             = BLEND_FACTOR_INV_SRC_ALPHA;
     RT0.BlendOp               = BLEND_OPERATION_ADD;
-    RT0.SrcBlendAlpha         = BLEND_FACTOR_INV_SRC_ALPHA;
-    RT0.DestBlendAlpha        = BLEND_FACTOR_ZERO;
+    RT0.SrcBlendAlpha         = BLEND_FACTOR_ONE;
+    RT0.DestBlendAlpha        = BLEND_FACTOR_INV_SRC_ALPHA;
     RT0.BlendOpAlpha          = BLEND_OPERATION_ADD;
     RT0.RenderTargetWriteMask = COLOR_MASK_ALL;
 
+    // The compact format is normalized, so the shaders are the same for both formats.
+    // Positions are decoded by the projection matrix.
     LayoutElement VSInputs[] //
         {
-            {0, 0, 2, VT_FLOAT32},    // pos
-            {1, 0, 2, VT_FLOAT32},    // uv
-            {2, 0, 4, VT_UINT8, True} // col
+            {0, 0, 2, VT_FLOAT32},      // pos
+            {1, 0, 2, VT_FLOAT32},      // uv
+            {2, 0, 4, VT_UINT8, True},  // col
+            {3, 1, 1, VT_UINT32, False} // texture index (bindless only)
         };
-    GraphicsPipeline.InputLayout.NumElements    = _countof(VSInputs);
+    if (m_UseCompactVertices)
+    {
+        VSInputs[0] = {0, 0, 2, VT_INT16, True};  // pos
+        VSInputs[1] = {1, 0, 2, VT_UINT16, True}; // uv
+    }
+    GraphicsPipeline.InputLayout.NumElements    = m_UseBindless ? 4 : 3;
     GraphicsPipeline.InputLayout.LayoutElements = VSInputs;
 
+    const char* TextureName = m_UseBindless ? "Textures" : "Texture";
+
     ShaderResourceVariableDesc Variables[] =
         {
-            {SHADER_TYPE_PIXEL, "Texture", SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC} //
+            {SHADER_TYPE_PIXEL, TextureName, SHADER_RESOURCE_VARIABLE_TYPE_DYNAMIC} //
         };
     PSOCreateInfo.PSODesc.ResourceLayout.Variables    = Variables;
     PSOCreateInfo.PSODesc.ResourceLayout.NumVariables = _countof(Variables);
@@ -436,13 +773,65 @@ void ImGuiDiligentRenderer::CreateDeviceObjects()
     SamLinearWrap.AddressW = TEXTURE_ADDRESS_WRAP;
     ImmutableSamplerDesc ImtblSamplers[] =
         {
-            {SHADER_TYPE_PIXEL, "Texture", SamLinearWrap} //
+            {SHADER_TYPE_PIXEL, TextureName, SamLinearWrap} //
         };
     PSOCreateInfo.PSODesc.ResourceLayout.ImmutableSamplers    = ImtblSamplers;
     PSOCreateInfo.PSODesc.ResourceLayout.NumImmutableSamplers = _countof(ImtblSamplers);
 
     m_pDevice->CreateGraphicsPipelineState(PSOCreateInfo, &m_pPSO);
 
+    // The bindless pixel shader handles the SDF font atlas itself. Otherwise, the atlas
+    // is rendered by a separate pipeline that only differs by the pixel shader.
+    m_FontAtlasModeInUse = m_FontAtlasMode;
+    if (m_FontAtlasModeInUse == IMGUI_FONT_ATLAS_MODE_SDF && !m_UseBindless)
+    {
+        ShaderCI.Desc           = {"Imgui SDF PS", SHADER_TYPE_PIXEL, true};
+        ShaderCI.ByteCode       = nullptr;
+        ShaderCI.ByteCodeSize   = 0;
+        ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_DEFAULT;
+        switch (DeviceType)
+        {
+            case RENDER_DEVICE_TYPE_D3D11:
+            case RENDER_DEVICE_TYPE_D3D12:
+                ShaderCI.Source = SDFPixelShaderHLSL;
+                break;
+
+            case RENDER_DEVICE_TYPE_VULKAN:
+            case RENDER_DEVICE_TYPE_GL:
+            case RENDER_DEVICE_TYPE_GLES:
+                ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_GLSL;
+                ShaderCI.Source         = SDFPixelShaderGLSL;
+                break;
+
+            case RENDER_DEVICE_TYPE_METAL:
+                ShaderCI.Source     = ShadersMSL;
+                ShaderCI.EntryPoint = "ps_main_sdf";
+                break;
+
+            default:
+                UNEXPECTED("Unknown render device type");
+        }
+
+        RefCntAutoPtr<IShader> pSDFPS;
+        m_pDevice->CreateShader(ShaderCI, &pSDFPS);
+        if (pSDFPS)
+        {
+            PSOCreateInfo.PSODesc.Name = "ImGUI SDF PSO";
+            PSOCreateInfo.pPS          = pSDFPS;
+            m_pDevice->CreateGraphicsPipelineState(PSOCreateInfo, &m_pSDFPSO);
+        }
+        if (!m_pSDFPSO)
+        {
+            LOG_WARNING_MESSAGE("Failed to create the SDF font pipeline. Falling back to the alpha-only font atlas.");
+            m_FontAtlasModeInUse = IMGUI_FONT_ATLAS_MODE_ALPHA8;
+        }
+    }
+    if (m_FontAtlasModeInUse == IMGUI_FONT_ATLAS_MODE_ALPHA8 &&
+        m_pDevice->GetDeviceInfo().Features.TextureComponentSwizzle == DEVICE_FEATURE_STATE_DISABLED)
+    {
+        m_FontAtlasModeInUse = IMGUI_FONT_ATLAS_MODE_RGBA8;
+    }
+
     {
         BufferDesc BuffDesc;
         BuffDesc.Size           = sizeof(float4x4);
@@ -452,45 +841,229 @@ void ImGuiDiligentRenderer::CreateDeviceObjects()
         m_pDevice->CreateBuffer(BuffDesc, nullptr, &m_pVertexConstantBuffer);
     }
     m_pPSO->GetStaticVariableByName(SHADER_TYPE_VERTEX, "Constants")->Set(m_pVertexConstantBuffer);
+    if (m_pSDFPSO)
+        m_pSDFPSO->GetStaticVariableByName(SHADER_TYPE_VERTEX, "Constants")->Set(m_pVertexConstantBuffer);
+
+    if (m_UseRingBuffers)
+    {
+        FenceDesc Desc;
+        Desc.Name = "Imgui ring buffer fence";
+        m_pDevice->CreateFence(Desc, &m_pFence);
+    }
 
     CreateFontsTexture();
 }
 
 void ImGuiDiligentRenderer::CreateFontsTexture()
 {
+    DILIGENT_TRACE_ZONE("ImGui::CreateFontsTexture");
+
     // Build texture atlas
     ImGuiIO& IO = ImGui::GetIO();
 
-    unsigned char* pData  = nullptr;
-    int            Width  = 0;
-    int            Weight = 0;
-    IO.Fonts->GetTexDataAsRGBA32(&pData, &Width, &Weight);
+    unsigned char*     pData  = nullptr;
+    int                Width  = 0;
+    int                Height = 0;
+    std::vector<Uint8> SDFData;
+
+    TEXTURE_FORMAT Format        = TEX_FORMAT_R8_UNORM;
+    Uint32         BytesPerTexel = 1;
+    switch (m_FontAtlasModeInUse)
+    {
+        case IMGUI_FONT_ATLAS_MODE_RGBA8:
+            IO.Fonts->GetTexDataAsRGBA32(&pData, &Width, &Height);
+            Format        = TEX_FORMAT_RGBA8_UNORM;
+            BytesPerTexel = 4;
+            break;
+
+        case IMGUI_FONT_ATLAS_MODE_ALPHA8:
+            IO.Fonts->GetTexDataAsAlpha8(&pData, &Width, &Height);
+            break;
+
+        case IMGUI_FONT_ATLAS_MODE_SDF:
+            BuildSDFFontAtlas(SDFData, Width, Height);
+            pData = SDFData.data();
+            break;
+
+        default:
+            UNEXPECTED("Unknown font atlas mode");
+    }
+
+    const auto RowSize  = size_t{BytesPerTexel} * static_cast<size_t>(Width);
+    const auto DataSize = RowSize * static_cast<size_t>(Height);
+
+    if (m_pFontSRV)
+    {
+        const auto& TexDesc = m_pFontSRV->GetTexture()->GetDesc();
+        if (TexDesc.Width == static_cast<Uint32>(Width) && TexDesc.Height == static_cast<Uint32>(Height) &&
+            TexDesc.Format == Format && m_FontAtlasData.size() == DataSize)
+        {
+            // Only upload the rows that changed
+            Uint32 FirstRow = 0;
+            Uint32 EndRow   = static_cast<Uint32>(Height);
+            while (FirstRow < EndRow && memcmp(&m_FontAtlasData[FirstRow * RowSize], pData + FirstRow * RowSize, RowSize) == 0)
+                ++FirstRow;
+            while (EndRow > FirstRow && memcmp(&m_FontAtlasData[(EndRow - 1) * RowSize], pData + (EndRow - 1) * RowSize, RowSize) == 0)
+                --EndRow;
+
+            if (FirstRow < EndRow)
+            {
+                memcpy(&m_FontAtlasData[FirstRow * RowSize], pData + FirstRow * RowSize, (EndRow - FirstRow) * RowSize);
+                if (m_FontUpdateFirstRow < m_FontUpdateEndRow)
+                {
+                    // Merge with the update that has not been uploaded yet
+                    FirstRow = std::min(FirstRow, m_FontUpdateFirstRow);
+                    EndRow   = std::max(EndRow, m_FontUpdateEndRow);
+                }
+                m_FontUpdateFirstRow = FirstRow;
+                m_FontUpdateEndRow   = EndRow;
+            }
+
+            IO.Fonts->TexID = (ImTextureID)m_pFontSRV;
+            return;
+        }
+    }
 
     TextureDesc FontTexDesc;
     FontTexDesc.Name      = "Imgui font texture";
     FontTexDesc.Type      = RESOURCE_DIM_TEX_2D;
     FontTexDesc.Width     = static_cast<Uint32>(Width);
-    FontTexDesc.Height    = static_cast<Uint32>(Weight);
-    FontTexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    FontTexDesc.Height    = static_cast<Uint32>(Height);
+    FontTexDesc.Format    = Format;
     FontTexDesc.BindFlags = BIND_SHADER_RESOURCE;
-    FontTexDesc.Usage     = USAGE_IMMUTABLE;
+    FontTexDesc.Usage     = USAGE_DEFAULT;
 
-    TextureSubResData Mip0Data[] = {{pData, 4 * Uint64{FontTexDesc.Width}}};
+    TextureSubResData Mip0Data[] = {{pData, RowSize}};
     TextureData       InitData(Mip0Data, _countof(Mip0Data));
 
     RefCntAutoPtr<ITexture> pFontTex;
     m_pDevice->CreateTexture(FontTexDesc, &InitData, &pFontTex);
-    m_pFontSRV = pFontTex->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+    if (m_FontAtlasModeInUse == IMGUI_FONT_ATLAS_MODE_ALPHA8)
+    {
+        // Expand the coverage to white RGB with coverage alpha
+        TextureViewDesc ViewDesc;
+        ViewDesc.Name      = "Imgui font texture view";
+        ViewDesc.ViewType  = TEXTURE_VIEW_SHADER_RESOURCE;
+        ViewDesc.Swizzle.R = TEXTURE_COMPONENT_SWIZZLE_ONE;
+        ViewDesc.Swizzle.G = TEXTURE_COMPONENT_SWIZZLE_ONE;
+        ViewDesc.Swizzle.B = TEXTURE_COMPONENT_SWIZZLE_ONE;
+        ViewDesc.Swizzle.A = TEXTURE_COMPONENT_SWIZZLE_R;
+        m_pFontSRV.Release();
+        pFontTex->CreateView(ViewDesc, &m_pFontSRV);
+    }
+    else
+    {
+        m_pFontSRV = pFontTex->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+    }
 
-    m_pSRB.Release();
-    m_pPSO->CreateShaderResourceBinding(&m_pSRB, true);
-    m_pTextureVar = m_pSRB->GetVariableByName(SHADER_TYPE_PIXEL, "Texture");
-    VERIFY_EXPR(m_pTextureVar != nullptr);
+    m_FontAtlasData.assign(pData, pData + DataSize);
+    m_FontUpdateFirstRow = 0;
+    m_FontUpdateEndRow   = 0;
 
     // Store our identifier
     IO.Fonts->TexID = (ImTextureID)m_pFontSRV;
 }
 
+void ImGuiDiligentRenderer::SetFontAtlasMode(IMGUI_FONT_ATLAS_MODE Mode)
+{
+    if (m_FontAtlasMode == Mode)
+        return;
+
+    m_FontAtlasMode = Mode;
+    if (m_pPSO)
+        CreateDeviceObjects();
+}
+
+void ImGuiDiligentRenderer::SetCompactVertexFormat(bool UseCompactVertices)
+{
+    if (m_UseCompactVertices == UseCompactVertices)
+        return;
+
+    m_UseCompactVertices = UseCompactVertices;
+    if (m_pPSO)
+        CreateDeviceObjects();
+}
+
+void ImGuiDiligentRenderer::BuildSDFFontAtlas(std::vector<Uint8>& Data, int& Width, int& Height)
+{
+    ImFontAtlas* pAtlas = ImGui::GetIO().Fonts;
+
+    // Glyphs are rasterized at one texel per pixel, with enough padding between them for the
+    // distance ramps. Baked anti-aliased lines rely on coverage and are not used.
+    if (pAtlas->ConfigData.empty())
+        pAtlas->AddFontDefault();
+    for (auto& Cfg : pAtlas->ConfigData)
+    {
+        Cfg.OversampleH = 1;
+        Cfg.OversampleV = 1;
+    }
+    pAtlas->TexGlyphPadding = 2 * SDFSpread;
+    pAtlas->Flags |= ImFontAtlasFlags_NoBakedLines;
+    pAtlas->ClearTexData();
+    pAtlas->Build();
+
+    unsigned char* pCoverage = nullptr;
+    pAtlas->GetTexDataAsAlpha8(&pCoverage, &Width, &Height);
+
+    // Texels outside of the glyphs (e.g. the white pixel) keep their coverage
+    Data.assign(pCoverage, pCoverage + static_cast<size_t>(Width) * static_cast<size_t>(Height));
+
+    auto IsInside = [&](int x, int y) {
+        return x >= 0 && y >= 0 && x < Width && y < Height && pCoverage[x + y * Width] >= 128;
+    };
+
+    for (ImFont* pFont : pAtlas->Fonts)
+    {
+        for (auto& Glyph : pFont->Glyphs)
+        {
+            if (!Glyph.Visible)
+                continue;
+
+            // Extend the glyph quad to cover the distance ramp around the glyph
+            const float SpreadU = static_cast<float>(SDFSpread) / static_cast<float>(Width);
+            const float SpreadV = static_cast<float>(SDFSpread) / static_cast<float>(Height);
+            Glyph.X0 -= SDFSpread;
+            Glyph.Y0 -= SDFSpread;
+            Glyph.X1 += SDFSpread;
+            Glyph.Y1 += SDFSpread;
+            Glyph.U0 -= SpreadU;
+            Glyph.V0 -= SpreadV;
+            Glyph.U1 += SpreadU;
+            Glyph.V1 += SpreadV;
+
+            const int x0 = std::max(static_cast<int>(Glyph.U0 * Width + 0.5f), 0);
+            const int y0 = std::max(static_cast<int>(Glyph.V0 * Height + 0.5f), 0);
+            const int x1 = std::min(static_cast<int>(Glyph.U1 * Width + 0.5f), Width);
+            const int y1 = std::min(static_cast<int>(Glyph.V1 * Height + 0.5f), Height);
+            for (int y = y0; y < y1; ++y)
+            {
+                for (int x = x0; x < x1; ++x)
+                {
+                    // Find the nearest texel on the other side of the edge
+                    const bool Inside   = IsInside(x, y);
+                    int        MinDist2 = (SDFSpread + 1) * (SDFSpread + 1);
+                    for (int dy = -SDFSpread; dy <= SDFSpread; ++dy)
+                    {
+                        for (int dx = -SDFSpread; dx <= SDFSpread; ++dx)
+                        {
+                            if (IsInside(x + dx, y + dy) != Inside)
+                                MinDist2 = std::min(MinDist2, dx * dx + dy * dy);
+                        }
+                    }
+
+                    // The edge lies half way between the texel centers
+                    float Dist = std::sqrt(static_cast<float>(MinDist2)) - 0.5f;
+                    if (!Inside)
+                        Dist = -Dist;
+                    const float Value = clamp(0.5f + Dist / static_cast<float>(2 * SDFSpread), 0.f, 1.f);
+
+                    Data[x + y * Width] = static_cast<Uint8>(Value * 255.f + 0.5f);
+                }
+            }
+        }
+    }
+}
+
 float4 ImGuiDiligentRenderer::TransformClipRect(const ImVec2& DisplaySize, const float4& rect) const
 {
     switch (m_SurfacePreTransform)
@@ -604,59 +1177,191 @@ float4 ImGuiDiligentRenderer::TransformClipRect(const ImVec2& DisplaySize, const
     }
 }
 
+ImGuiDiligentRenderer::ContextResources& ImGuiDiligentRenderer::GetContextResources(IDeviceContext* pCtx)
+{
+    ContextResources* pRes = &m_ImmediateResources;
+    if (pCtx->GetDesc().IsDeferred)
+    {
+        // References to the map elements remain valid when other elements are inserted
+        std::lock_guard<std::mutex> Lock{m_DeferredResourcesMtx};
+        pRes = &m_DeferredResources[pCtx];
+    }
+
+    auto& Res = *pRes;
+    if (Res.VertexBufferSize == 0)
+    {
+        Res.VertexBufferSize = m_InitialVertexBufferSize;
+        Res.IndexBufferSize  = m_InitialIndexBufferSize;
+    }
+    if (!Res.pSRB)
+    {
+        m_pPSO->CreateShaderResourceBinding(&Res.pSRB, true);
+        Res.pTextureVar = Res.pSRB->GetVariableByName(SHADER_TYPE_PIXEL, m_UseBindless ? "Textures" : "Texture");
+        VERIFY_EXPR(Res.pTextureVar != nullptr);
+    }
+    return Res;
+}
+
 void ImGuiDiligentRenderer::RenderDrawData(IDeviceContext* pCtx, ImDrawData* pDrawData)
 {
     // Avoid rendering when minimized
     if (pDrawData->DisplaySize.x <= 0.0f || pDrawData->DisplaySize.y <= 0.0f)
         return;
 
+    DILIGENT_TRACE_ZONE("ImGui::RenderDrawData");
+    DILIGENT_TRACE_COUNTER("ImGui::Vertices", pDrawData->TotalVtxCount);
+    DILIGENT_TRACE_COUNTER("ImGui::Indices", pDrawData->TotalIdxCount);
+
+    auto& Res = GetContextResources(pCtx);
+
+    // Fences can only be signaled by immediate contexts, so deferred contexts discard their buffers
+    const bool UseRingBuffers = m_UseRingBuffers && !pCtx->GetDesc().IsDeferred;
+
+    // Textures are shared between threads, and state transitions of shared resources are not
+    // thread-safe. Deferred contexts expect them to already be in the shader resource state.
+    const auto SRBTransitionMode = pCtx->GetDesc().IsDeferred ? RESOURCE_STATE_TRANSITION_MODE_VERIFY : RESOURCE_STATE_TRANSITION_MODE_TRANSITION;
+
+    if (!pCtx->GetDesc().IsDeferred && m_FontUpdateFirstRow < m_FontUpdateEndRow)
+    {
+        // Upload the font atlas rows changed by the last CreateFontsTexture call
+        auto*       pFontTex = m_pFontSRV->GetTexture();
+        const auto& TexDesc  = pFontTex->GetDesc();
+        const auto  RowSize  = m_FontAtlasData.size() / TexDesc.Height;
+
+        Box               UpdateBox{0, TexDesc.Width, m_FontUpdateFirstRow, m_FontUpdateEndRow};
+        TextureSubResData SubresData{&m_FontAtlasData[m_FontUpdateFirstRow * RowSize], RowSize};
+        pCtx->UpdateTexture(pFontTex, 0, 0, UpdateBox, SubresData, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+        m_FontUpdateFirstRow = 0;
+        m_FontUpdateEndRow   = 0;
+    }
+
+    // In ring-buffer mode, sub-allocate space for this draw data from the regions the GPU has released.
+    // If the ring is full, it is grown: the old buffer is released by the engine once the GPU is done with it.
+    Uint32 VtxRingOffset = 0;
+    Uint32 IdxRingOffset = 0;
+
+    auto AllocateFromRing = [](std::unique_ptr<RingBuffer>& pRing, int Size, Uint32& Offset) //
+    {
+        if (!pRing)
+            return false;
+        if (Size == 0)
+            return true;
+        auto RingOffset = pRing->Allocate(static_cast<RingBuffer::OffsetType>(Size), 1);
+        if (RingOffset == RingBuffer::InvalidOffset)
+            return false;
+        Offset = static_cast<Uint32>(RingOffset);
+        return true;
+    };
+
+    if (UseRingBuffers)
+    {
+        const auto CompletedFenceValue = m_pFence->GetCompletedValue();
+        if (m_pVtxRing)
+            m_pVtxRing->ReleaseCompletedFrames(CompletedFenceValue);
+        if (m_pIdxRing)
+            m_pIdxRing->ReleaseCompletedFrames(CompletedFenceValue);
+    }
+
+    const auto BufferUsage  = UseRingBuffers ? USAGE_UNIFIED : USAGE_DYNAMIC;
+    const auto VertexStride = m_UseCompactVertices ? Uint32{sizeof(CompactVertex)} : Uint32{sizeof(ImDrawVert)};
+
     // Create and grow vertex/index buffers if needed
-    if (!m_pVB || static_cast<int>(m_VertexBufferSize) < pDrawData->TotalVtxCount)
+    if (!Res.pVB ||
+        (UseRingBuffers ?
+             !AllocateFromRing(m_pVtxRing, pDrawData->TotalVtxCount, VtxRingOffset) :
+             static_cast<int>(Res.VertexBufferSize) < pDrawData->TotalVtxCount))
     {
-        m_pVB.Release();
-        while (static_cast<int>(m_VertexBufferSize) < pDrawData->TotalVtxCount)
-            m_VertexBufferSize *= 2;
+        // The ring may be full of data the GPU has not consumed yet
+        if (UseRingBuffers && Res.pVB)
+            Res.VertexBufferSize *= 2;
+
+        Res.pVB.Release();
+        Res.pTexIndexVB.Release();
+        while (static_cast<int>(Res.VertexBufferSize) < pDrawData->TotalVtxCount)
+            Res.VertexBufferSize *= 2;
 
         BufferDesc VBDesc;
         VBDesc.Name           = "Imgui vertex buffer";
         VBDesc.BindFlags      = BIND_VERTEX_BUFFER;
-        VBDesc.Size           = m_VertexBufferSize * sizeof(ImDrawVert);
-        VBDesc.Usage          = USAGE_DYNAMIC;
+        VBDesc.Size           = Uint64{Res.VertexBufferSize} * VertexStride;
+        VBDesc.Usage          = BufferUsage;
+        VBDesc.CPUAccessFlags = CPU_ACCESS_WRITE;
+        m_pDevice->CreateBuffer(VBDesc, nullptr, &Res.pVB);
+
+        if (UseRingBuffers)
+        {
+            m_pVtxRing.reset(new RingBuffer{Res.VertexBufferSize, DefaultRawMemoryAllocator::GetAllocator()});
+            const auto Allocated = AllocateFromRing(m_pVtxRing, pDrawData->TotalVtxCount, VtxRingOffset);
+            VERIFY(Allocated, "The new ring buffer must have space for the whole draw data");
+            (void)Allocated;
+        }
+    }
+
+    if (m_UseBindless && !Res.pTexIndexVB)
+    {
+        BufferDesc VBDesc;
+        VBDesc.Name           = "Imgui texture index buffer";
+        VBDesc.BindFlags      = BIND_VERTEX_BUFFER;
+        VBDesc.Size           = Res.VertexBufferSize * sizeof(Uint32);
+        VBDesc.Usage          = BufferUsage;
         VBDesc.CPUAccessFlags = CPU_ACCESS_WRITE;
-        m_pDevice->CreateBuffer(VBDesc, nullptr, &m_pVB);
+        m_pDevice->CreateBuffer(VBDesc, nullptr, &Res.pTexIndexVB);
     }
 
-    if (!m_pIB || static_cast<int>(m_IndexBufferSize) < pDrawData->TotalIdxCount)
+    if (!Res.pIB ||
+        (UseRingBuffers ?
+             !AllocateFromRing(m_pIdxRing, pDrawData->TotalIdxCount, IdxRingOffset) :
+             static_cast<int>(Res.IndexBufferSize) < pDrawData->TotalIdxCount))
     {
-        m_pIB.Release();
-        while (static_cast<int>(m_IndexBufferSize) < pDrawData->TotalIdxCount)
-            m_IndexBufferSize *= 2;
+        if (UseRingBuffers && Res.pIB)
+            Res.IndexBufferSize *= 2;
+
+        Res.pIB.Release();
+        while (static_cast<int>(Res.IndexBufferSize) < pDrawData->TotalIdxCount)
+            Res.IndexBufferSize *= 2;
 
         BufferDesc IBDesc;
         IBDesc.Name           = "Imgui index buffer";
         IBDesc.BindFlags      = BIND_INDEX_BUFFER;
-        IBDesc.Size           = m_IndexBufferSize * sizeof(ImDrawIdx);
-        IBDesc.Usage          = USAGE_DYNAMIC;
+        IBDesc.Size           = Res.IndexBufferSize * sizeof(ImDrawIdx);
+        IBDesc.Usage          = BufferUsage;
         IBDesc.CPUAccessFlags = CPU_ACCESS_WRITE;
-        m_pDevice->CreateBuffer(IBDesc, nullptr, &m_pIB);
+        m_pDevice->CreateBuffer(IBDesc, nullptr, &Res.pIB);
+
+        if (UseRingBuffers)
+        {
+            m_pIdxRing.reset(new RingBuffer{Res.IndexBufferSize, DefaultRawMemoryAllocator::GetAllocator()});
+            const auto Allocated = AllocateFromRing(m_pIdxRing, pDrawData->TotalIdxCount, IdxRingOffset);
+            VERIFY(Allocated, "The new ring buffer must have space for the whole draw data");
+            (void)Allocated;
+        }
     }
 
+    // Ring-buffer regions are never in use by the GPU when they are handed out
+    const auto MapFlags = UseRingBuffers ? MAP_FLAG_NO_OVERWRITE : MAP_FLAG_DISCARD;
     {
-        MapHelper<ImDrawVert> Verices(pCtx, m_pVB, MAP_WRITE, MAP_FLAG_DISCARD);
-        MapHelper<ImDrawIdx>  Indices(pCtx, m_pIB, MAP_WRITE, MAP_FLAG_DISCARD);
+        MapHelper<Uint8>     Verices(pCtx, Res.pVB, MAP_WRITE, MapFlags);
+        MapHelper<ImDrawIdx> Indices(pCtx, Res.pIB, MAP_WRITE, MapFlags);
 
-        ImDrawVert* pVtxDst = Verices;
-        ImDrawIdx*  pIdxDst = Indices;
+        Uint8*     pVtxDst = static_cast<Uint8*>(Verices) + size_t{VtxRingOffset} * VertexStride;
+        ImDrawIdx* pIdxDst = static_cast<ImDrawIdx*>(Indices) + IdxRingOffset;
         for (Int32 CmdListID = 0; CmdListID < pDrawData->CmdListsCount; CmdListID++)
         {
             const ImDrawList* pCmdList = pDrawData->CmdLists[CmdListID];
-            memcpy(pVtxDst, pCmdList->VtxBuffer.Data, pCmdList->VtxBuffer.Size * sizeof(ImDrawVert));
+            if (m_UseCompactVertices)
+                ConvertToCompactVertices(pCmdList->VtxBuffer.Data, reinterpret_cast<CompactVertex*>(pVtxDst), pCmdList->VtxBuffer.Size, pDrawData->DisplayPos);
+            else
+                memcpy(pVtxDst, pCmdList->VtxBuffer.Data, pCmdList->VtxBuffer.Size * sizeof(ImDrawVert));
             memcpy(pIdxDst, pCmdList->IdxBuffer.Data, pCmdList->IdxBuffer.Size * sizeof(ImDrawIdx));
-            pVtxDst += pCmdList->VtxBuffer.Size;
+            pVtxDst += size_t{VertexStride} * pCmdList->VtxBuffer.Size;
             pIdxDst += pCmdList->IdxBuffer.Size;
         }
     }
 
+    if (m_UseBindless)
+        UpdateTextureTables(pCtx, Res, pDrawData, VtxRingOffset);
+
     // Setup orthographic projection matrix into our constant buffer
     // Our visible imgui space lies from pDrawData->DisplayPos (top left) to pDrawData->DisplayPos+data_data->DisplaySize (bottom right).
     // DisplayPos is (0,0) for single viewport apps.
@@ -678,6 +1383,13 @@ void ImGuiDiligentRenderer::RenderDrawData(IDeviceContext* pCtx, ImDrawData* pDr
         };
         // clang-format on
 
+        if (m_UseCompactVertices)
+        {
+            // Compact positions are normalized fixed-point offsets from DisplayPos
+            constexpr float PosRange = 32767.f / CompactPosScale;
+            Projection = float4x4::Scale(PosRange, PosRange, 1.f) * float4x4::Translation(pDrawData->DisplayPos.x, pDrawData->DisplayPos.y, 0.f) * Projection;
+        }
+
         // Bake pre-transform into projection
         switch (m_SurfacePreTransform)
         {
@@ -722,9 +1434,9 @@ void ImGuiDiligentRenderer::RenderDrawData(IDeviceContext* pCtx, ImDrawData* pDr
     auto SetupRenderState = [&]() //
     {
         // Setup shader and vertex buffers
-        IBuffer* pVBs[] = {m_pVB};
-        pCtx->SetVertexBuffers(0, 1, pVBs, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, SET_VERTEX_BUFFERS_FLAG_RESET);
-        pCtx->SetIndexBuffer(m_pIB, 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        IBuffer* pVBs[] = {Res.pVB, Res.pTexIndexVB};
+        pCtx->SetVertexBuffers(0, m_UseBindless ? 2 : 1, pVBs, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, SET_VERTEX_BUFFERS_FLAG_RESET);
+        pCtx->SetIndexBuffer(Res.pIB, 0, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
         pCtx->SetPipelineState(m_pPSO);
 
         const float blend_factor[4] = {0.f, 0.f, 0.f, 0.f};
@@ -744,26 +1456,131 @@ void ImGuiDiligentRenderer::RenderDrawData(IDeviceContext* pCtx, ImDrawData* pDr
 
     SetupRenderState();
 
+    // The state last set in the context. Scissor rects and vertex buffer offsets that
+    // did not change are not set again.
+    bool   ScissorValid = false;
+    Rect   LastScissor;
+    Uint32 LastVBOffset = 0; // SetupRenderState binds the vertex buffers at offset 0
+
+    auto SetScissor = [&](const Rect& Scissor) //
+    {
+        if (ScissorValid && LastScissor == Scissor)
+            return;
+
+        pCtx->SetScissorRects(1,
+                              &Scissor,
+                              static_cast<Uint32>(m_RenderSurfaceWidth * pDrawData->FramebufferScale.x),
+                              static_cast<Uint32>(m_RenderSurfaceHeight * pDrawData->FramebufferScale.y));
+        LastScissor  = Scissor;
+        ScissorValid = true;
+    };
+
+    auto DrawIndexed = [&](Uint32 NumIndices, Uint32 FirstIndex, Uint32 VtxOffset) //
+    {
+        DrawIndexedAttribs DrawAttrs{NumIndices, sizeof(ImDrawIdx) == sizeof(Uint16) ? VT_UINT16 : VT_UINT32, DRAW_FLAG_VERIFY_STATES};
+        DrawAttrs.FirstIndexLocation = FirstIndex;
+        if (m_BaseVertexSupported)
+        {
+            DrawAttrs.BaseVertex = VtxOffset;
+        }
+        else if (VtxOffset != LastVBOffset)
+        {
+            IBuffer* pVBs[]       = {Res.pVB, Res.pTexIndexVB};
+            Uint64   VtxOffsets[] = {Uint64{VertexStride} * VtxOffset, sizeof(Uint32) * Uint64{VtxOffset}};
+            pCtx->SetVertexBuffers(0, m_UseBindless ? 2 : 1, pVBs, VtxOffsets, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, SET_VERTEX_BUFFERS_FLAG_NONE);
+            LastVBOffset = VtxOffset;
+        }
+        pCtx->DrawIndexed(DrawAttrs);
+    };
+
+    // Consecutive commands that share the scissor rect, the base vertex and the texture
+    // (or, with the bindless pipeline, the texture table) are merged into a single draw call.
+    struct PendingDraw
+    {
+        Rect          Scissor;
+        Uint32        FirstIndex   = 0;
+        Uint32        NumIndices   = 0;
+        Uint32        VtxOffset    = 0;
+        Uint32        TableId      = 0;
+        ITextureView* pTextureView = nullptr;
+    } Pending;
+
+    Uint32        CommittedTableId  = ~0u;
+    ITextureView* pCommittedTexture = nullptr;
+    bool          SDFPSOBound       = false; // SetupRenderState binds the regular pipeline
+
+    auto FlushPendingDraw = [&]() //
+    {
+        if (Pending.NumIndices == 0)
+            return;
+
+        SetScissor(Pending.Scissor);
+        if (m_UseBindless)
+        {
+            if (Pending.TableId != CommittedTableId)
+            {
+                const auto& Table = Res.TextureTables[Pending.TableId];
+                Res.pTextureVar->SetArray(Table.data(), 0, static_cast<Uint32>(Table.size()));
+                pCtx->CommitShaderResources(Res.pSRB, SRBTransitionMode);
+                CommittedTableId = Pending.TableId;
+            }
+        }
+        else
+        {
+            // The SRB is compatible with both pipelines, as they only differ by the pixel shader
+            const bool UseSDFPSO = m_pSDFPSO && Pending.pTextureView == m_pFontSRV;
+            if (UseSDFPSO != SDFPSOBound)
+            {
+                pCtx->SetPipelineState(UseSDFPSO ? m_pSDFPSO : m_pPSO);
+                SDFPSOBound       = UseSDFPSO;
+                pCommittedTexture = nullptr;
+            }
+
+            if (Pending.pTextureView != pCommittedTexture)
+            {
+                Res.pTextureVar->Set(Pending.pTextureView);
+                pCtx->CommitShaderResources(Res.pSRB, SRBTransitionMode);
+                pCommittedTexture = Pending.pTextureView;
+            }
+        }
+        DrawIndexed(Pending.NumIndices, Pending.FirstIndex, Pending.VtxOffset);
+        Pending.NumIndices = 0;
+    };
+
     // Render command lists
     // (Because we merged all buffers into a single one, we maintain our own offset into them)
-    Uint32 GlobalIdxOffset = 0;
-    Uint32 GlobalVtxOffset = 0;
+    Uint32 GlobalIdxOffset = IdxRingOffset;
+    Uint32 GlobalVtxOffset = VtxRingOffset;
+    Uint32 GlobalCmdId     = 0;
 
-    ITextureView* pLastTextureView = nullptr;
     for (Int32 CmdListID = 0; CmdListID < pDrawData->CmdListsCount; CmdListID++)
     {
         const ImDrawList* pCmdList = pDrawData->CmdLists[CmdListID];
-        for (Int32 CmdID = 0; CmdID < pCmdList->CmdBuffer.Size; CmdID++)
+        for (Int32 CmdID = 0; CmdID < pCmdList->CmdBuffer.Size; CmdID++, GlobalCmdId++)
         {
             const ImDrawCmd* pCmd = &pCmdList->CmdBuffer[CmdID];
             if (pCmd->UserCallback != NULL)
             {
+                FlushPendingDraw();
+
                 // User callback, registered via ImDrawList::AddCallback()
                 // (ImDrawCallback_ResetRenderState is a special callback value used by the user to request the renderer to reset render state.)
                 if (pCmd->UserCallback == ImDrawCallback_ResetRenderState)
+                {
                     SetupRenderState();
+                    LastVBOffset = 0;
+                }
                 else
+                {
                     pCmd->UserCallback(pCmdList, pCmd);
+                    LastVBOffset = ~0u;
+                }
+
+                // The callback may have changed any of the tracked state
+                ScissorValid      = false;
+                CommittedTableId  = ~0u;
+                pCommittedTexture = nullptr;
+                SDFPSOBound       = false;
             }
             else
             {
@@ -785,39 +1602,325 @@ void ImGuiDiligentRenderer::RenderDrawData(IDeviceContext* pCtx, ImDrawData* pDr
                         static_cast<Int32>(ClipRect.z),
                         static_cast<Int32>(ClipRect.w) //
                     };
-                pCtx->SetScissorRects(1,
-                                      &Scissor,
-                                      static_cast<Uint32>(m_RenderSurfaceWidth * pDrawData->FramebufferScale.x),
-                                      static_cast<Uint32>(m_RenderSurfaceHeight * pDrawData->FramebufferScale.y));
 
-                // Bind texture
                 auto* pTextureView = reinterpret_cast<ITextureView*>(pCmd->TextureId);
                 VERIFY_EXPR(pTextureView);
-                if (pTextureView != pLastTextureView)
-                {
-                    pLastTextureView = pTextureView;
-                    m_pTextureVar->Set(pTextureView);
-                    pCtx->CommitShaderResources(m_pSRB, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
-                }
 
-                DrawIndexedAttribs DrawAttrs{pCmd->ElemCount, sizeof(ImDrawIdx) == sizeof(Uint16) ? VT_UINT16 : VT_UINT32, DRAW_FLAG_VERIFY_STATES};
-                DrawAttrs.FirstIndexLocation = pCmd->IdxOffset + GlobalIdxOffset;
-                if (m_BaseVertexSupported)
+                const Uint32 FirstIndex = pCmd->IdxOffset + GlobalIdxOffset;
+                const Uint32 VtxOffset  = pCmd->VtxOffset + GlobalVtxOffset;
+                const Uint32 TableId    = m_UseBindless ? Res.CmdTableIds[GlobalCmdId] : 0;
+
+                const bool CanMerge =
+                    Pending.NumIndices != 0 &&
+                    Pending.Scissor == Scissor &&
+                    Pending.VtxOffset == VtxOffset &&
+                    Pending.FirstIndex + Pending.NumIndices == FirstIndex &&
+                    (m_UseBindless ? Pending.TableId == TableId : Pending.pTextureView == pTextureView);
+                if (CanMerge)
                 {
-                    DrawAttrs.BaseVertex = pCmd->VtxOffset + GlobalVtxOffset;
+                    Pending.NumIndices += pCmd->ElemCount;
                 }
                 else
                 {
-                    IBuffer* pVBs[]       = {m_pVB};
-                    Uint64   VtxOffsets[] = {sizeof(ImDrawVert) * (size_t{pCmd->VtxOffset} + size_t{GlobalVtxOffset})};
-                    pCtx->SetVertexBuffers(0, 1, pVBs, VtxOffsets, RESOURCE_STATE_TRANSITION_MODE_TRANSITION, SET_VERTEX_BUFFERS_FLAG_NONE);
+                    FlushPendingDraw();
+                    Pending.Scissor      = Scissor;
+                    Pending.FirstIndex   = FirstIndex;
+                    Pending.NumIndices   = pCmd->ElemCount;
+                    Pending.VtxOffset    = VtxOffset;
+                    Pending.TableId      = TableId;
+                    Pending.pTextureView = pTextureView;
                 }
-                pCtx->DrawIndexed(DrawAttrs);
             }
         }
         GlobalIdxOffset += pCmdList->IdxBuffer.Size;
         GlobalVtxOffset += pCmdList->VtxBuffer.Size;
     }
+    FlushPendingDraw();
+
+    if (UseRingBuffers)
+    {
+        // The regions allocated above can be reused once the GPU has passed this point
+        pCtx->EnqueueSignal(m_pFence, ++m_FenceValue);
+        m_pVtxRing->FinishCurrentFrame(m_FenceValue);
+        m_pIdxRing->FinishCurrentFrame(m_FenceValue);
+    }
+}
+
+Uint64 ImGuiDiligentRenderer::ComputeDrawDataHash(ImDrawData* pDrawData, bool& Cacheable) const
+{
+    Cacheable = m_FontUpdateFirstRow >= m_FontUpdateEndRow;
+
+    Uint64 Hash = 0xCBF29CE484222325ull;
+    // clang-format off
+    const Uint32 Surface[] = {m_RenderSurfaceWidth, m_RenderSurfaceHeight, static_cast<Uint32>(m_SurfacePreTransform)};
+    const float  Display[] = {pDrawData->DisplayPos.x, pDrawData->DisplayPos.y, pDrawData->DisplaySize.x, pDrawData->DisplaySize.y,
+                              pDrawData->FramebufferScale.x, pDrawData->FramebufferScale.y};
+    // clang-format on
+    Hash = HashMemory(Surface, sizeof(Surface), Hash);
+    Hash = HashMemory(Display, sizeof(Display), Hash);
+    Hash = HashMemory(&pDrawData->CmdListsCount, sizeof(pDrawData->CmdListsCount), Hash);
+
+    for (Int32 CmdListID = 0; CmdListID < pDrawData->CmdListsCount; CmdListID++)
+    {
+        const ImDrawList* pCmdList = pDrawData->CmdLists[CmdListID];
+
+        Hash = HashMemory(&pCmdList->VtxBuffer.Size, sizeof(pCmdList->VtxBuffer.Size), Hash);
+        Hash = HashMemory(pCmdList->VtxBuffer.Data, pCmdList->VtxBuffer.Size * sizeof(ImDrawVert), Hash);
+        Hash = HashMemory(&pCmdList->IdxBuffer.Size, sizeof(pCmdList->IdxBuffer.Size), Hash);
+        Hash = HashMemory(pCmdList->IdxBuffer.Data, pCmdList->IdxBuffer.Size * sizeof(ImDrawIdx), Hash);
+
+        for (Int32 CmdID = 0; CmdID < pCmdList->CmdBuffer.Size; CmdID++)
+        {
+            const ImDrawCmd& Cmd = pCmdList->CmdBuffer[CmdID];
+
+            // The effect of user callbacks is unknown, so the cache can't be used
+            if (Cmd.UserCallback != nullptr && Cmd.UserCallback != ImDrawCallback_ResetRenderState)
+                Cacheable = false;
+
+            Hash = HashMemory(&Cmd.ClipRect, sizeof(Cmd.ClipRect), Hash);
+            Hash = HashMemory(&Cmd.TextureId, sizeof(Cmd.TextureId), Hash);
+            Hash = HashMemory(&Cmd.VtxOffset, sizeof(Cmd.VtxOffset), Hash);
+            Hash = HashMemory(&Cmd.IdxOffset, sizeof(Cmd.IdxOffset), Hash);
+            Hash = HashMemory(&Cmd.ElemCount, sizeof(Cmd.ElemCount), Hash);
+        }
+    }
+
+    return Hash;
+}
+
+void ImGuiDiligentRenderer::RenderDrawDataCached(IDeviceContext* pCtx, ImDrawData* pDrawData, ITextureView* pRTV, ITextureView* pDSV)
+{
+    VERIFY(!pCtx->GetDesc().IsDeferred, "Cached UI rendering requires an immediate context");
+    VERIFY_EXPR(pRTV != nullptr);
+
+    // Avoid rendering when minimized
+    if (pDrawData->DisplaySize.x <= 0.0f || pDrawData->DisplaySize.y <= 0.0f)
+        return;
+
+    DILIGENT_TRACE_ZONE("ImGui::RenderDrawDataCached");
+
+    if (!m_pCompositePSO)
+        CreateCompositePSO();
+
+    const auto& RTDesc = pRTV->GetTexture()->GetDesc();
+    if (!m_pCachedUITex || m_pCachedUITex->GetDesc().Width != RTDesc.Width || m_pCachedUITex->GetDesc().Height != RTDesc.Height)
+    {
+        m_pCachedUITex.Release();
+        m_pCachedUIDepth.Release();
+        m_CachedUIValid = false;
+
+        TextureDesc TexDesc;
+        TexDesc.Name      = "Imgui cached UI";
+        TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+        TexDesc.Width     = RTDesc.Width;
+        TexDesc.Height    = RTDesc.Height;
+        TexDesc.Format    = m_BackBufferFmt;
+        TexDesc.BindFlags = BIND_RENDER_TARGET | BIND_SHADER_RESOURCE;
+        m_pDevice->CreateTexture(TexDesc, nullptr, &m_pCachedUITex);
+
+        // The UI pipeline is created with the depth buffer format, so the cached target needs one too
+        if (m_DepthBufferFmt != TEX_FORMAT_UNKNOWN)
+        {
+            TexDesc.Name      = "Imgui cached UI depth";
+            TexDesc.Format    = m_DepthBufferFmt;
+            TexDesc.BindFlags = BIND_DEPTH_STENCIL;
+            m_pDevice->CreateTexture(TexDesc, nullptr, &m_pCachedUIDepth);
+        }
+
+        m_pCompositeSRB.Release();
+        m_pCompositePSO->CreateShaderResourceBinding(&m_pCompositeSRB, true);
+        m_pCompositeSRB->GetVariableByName(SHADER_TYPE_PIXEL, "CachedUI")->Set(m_pCachedUITex->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE));
+    }
+
+    bool       Cacheable = false;
+    const auto Hash      = ComputeDrawDataHash(pDrawData, Cacheable);
+    if (!m_CachedUIValid || !Cacheable || Hash != m_CachedUIHash)
+    {
+        ITextureView* pCachedRTV = m_pCachedUITex->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+        ITextureView* pCachedDSV = m_pCachedUIDepth ? m_pCachedUIDepth->GetDefaultView(TEXTURE_VIEW_DEPTH_STENCIL) : nullptr;
+        pCtx->SetRenderTargets(1, &pCachedRTV, pCachedDSV, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+        const float ClearColor[] = {0, 0, 0, 0};
+        pCtx->ClearRenderTarget(pCachedRTV, ClearColor, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+        if (pCachedDSV != nullptr)
+            pCtx->ClearDepthStencil(pCachedDSV, CLEAR_DEPTH_FLAG, 1.f, 0, RESOURCE_STATE_TRANSITION_MODE_VERIFY);
+
+        RenderDrawData(pCtx, pDrawData);
+
+        m_CachedUIHash  = Hash;
+        m_CachedUIValid = Cacheable;
+    }
+
+    pCtx->SetRenderTargets(1, &pRTV, pDSV, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    pCtx->SetPipelineState(m_pCompositePSO);
+    pCtx->CommitShaderResources(m_pCompositeSRB, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+    pCtx->Draw({3, DRAW_FLAG_VERIFY_ALL});
+}
+
+void ImGuiDiligentRenderer::InvalidateRenderCache()
+{
+    m_CachedUIValid = false;
+}
+
+void ImGuiDiligentRenderer::CreateCompositePSO()
+{
+    const auto DeviceType = m_pDevice->GetDeviceInfo().Type;
+
+    ShaderCreateInfo ShaderCI;
+    ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_DEFAULT;
+
+    const char* VSSource = nullptr;
+    const char* PSSource = nullptr;
+    switch (DeviceType)
+    {
+        case RENDER_DEVICE_TYPE_D3D11:
+        case RENDER_DEVICE_TYPE_D3D12:
+            VSSource = CompositeVertexShaderHLSL;
+            PSSource = CompositePixelShaderHLSL;
+            break;
+
+        case RENDER_DEVICE_TYPE_VULKAN:
+        case RENDER_DEVICE_TYPE_GL:
+        case RENDER_DEVICE_TYPE_GLES:
+            ShaderCI.SourceLanguage = SHADER_SOURCE_LANGUAGE_GLSL;
+            VSSource                = CompositeVertexShaderGLSL;
+            PSSource                = CompositePixelShaderGLSL;
+            break;
+
+        case RENDER_DEVICE_TYPE_METAL:
+            VSSource = CompositeShadersMSL;
+            PSSource = CompositeShadersMSL;
+            break;
+
+        default:
+            UNEXPECTED("Unknown render device type");
+            return;
+    }
+
+    RefCntAutoPtr<IShader> pVS;
+    {
+        ShaderCI.Desc       = {"Imgui composite VS", SHADER_TYPE_VERTEX, true};
+        ShaderCI.Source     = VSSource;
+        ShaderCI.EntryPoint = DeviceType == RENDER_DEVICE_TYPE_METAL ? "vs_composite" : "main";
+        m_pDevice->CreateShader(ShaderCI, &pVS);
+    }
+
+    RefCntAutoPtr<IShader> pPS;
+    {
+        ShaderCI.Desc       = {"Imgui composite PS", SHADER_TYPE_PIXEL, true};
+        ShaderCI.Source     = PSSource;
+        ShaderCI.EntryPoint = DeviceType == RENDER_DEVICE_TYPE_METAL ? "ps_composite" : "main";
+        m_pDevice->CreateShader(ShaderCI, &pPS);
+    }
+
+    GraphicsPipelineStateCreateInfo PSOCreateInfo;
+
+    PSOCreateInfo.PSODesc.Name = "ImGUI composite PSO";
+    auto& GraphicsPipeline     = PSOCreateInfo.GraphicsPipeline;
+
+    GraphicsPipeline.NumRenderTargets  = 1;
+    GraphicsPipeline.RTVFormats[0]     = m_BackBufferFmt;
+    GraphicsPipeline.DSVFormat         = m_DepthBufferFmt;
+    GraphicsPipeline.PrimitiveTopology = PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    PSOCreateInfo.pVS = pVS;
+    PSOCreateInfo.pPS = pPS;
+
+    GraphicsPipeline.RasterizerDesc.CullMode      = CULL_MODE_NONE;
+    GraphicsPipeline.DepthStencilDesc.DepthEnable = False;
+
+    // The cached target contains premultiplied colors
+    auto& RT0                 = GraphicsPipeline.BlendDesc.RenderTargets[0];
+    RT0.BlendEnable           = True;
+    RT0.SrcBlend              = BLEND_FACTOR_ONE;
+    RT0.DestBlend             = BLEND_FACTOR_INV_SRC_ALPHA;
+    RT0.BlendOp               = BLEND_OPERATION_ADD;
+    RT0.SrcBlendAlpha         = BLEND_FACTOR_ONE;
+    RT0.DestBlendAlpha        = BLEND_FACTOR_INV_SRC_ALPHA;
+    RT0.BlendOpAlpha          = BLEND_OPERATION_ADD;
+    RT0.RenderTargetWriteMask = COLOR_MASK_ALL;
+
+    ShaderResourceVariableDesc Variables[] =
+        {
+            {SHADER_TYPE_PIXEL, "CachedUI", SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE} //
+        };
+    PSOCreateInfo.PSODesc.ResourceLayout.Variables    = Variables;
+    PSOCreateInfo.PSODesc.ResourceLayout.NumVariables = _countof(Variables);
+
+    // GLSL only has combined image samplers, even though the texels are fetched directly
+    ImmutableSamplerDesc ImtblSamplers[] =
+        {
+            {SHADER_TYPE_PIXEL, "CachedUI", SamplerDesc{}} //
+        };
+    if (ShaderCI.SourceLanguage == SHADER_SOURCE_LANGUAGE_GLSL)
+    {
+        PSOCreateInfo.PSODesc.ResourceLayout.ImmutableSamplers    = ImtblSamplers;
+        PSOCreateInfo.PSODesc.ResourceLayout.NumImmutableSamplers = _countof(ImtblSamplers);
+    }
+
+    m_pDevice->CreateGraphicsPipelineState(PSOCreateInfo, &m_pCompositePSO);
+}
+
+void ImGuiDiligentRenderer::UpdateTextureTables(IDeviceContext* pCtx, ContextResources& Res, ImDrawData* pDrawData, Uint32 VtxRingOffset)
+{
+    const bool UseRingBuffers = m_UseRingBuffers && !pCtx->GetDesc().IsDeferred;
+
+    Res.TextureTables.clear();
+    Res.TextureSlots.clear();
+    Res.CmdTableIds.clear();
+
+    MapHelper<Uint32> TexIndices(pCtx, Res.pTexIndexVB, MAP_WRITE, UseRingBuffers ? MAP_FLAG_NO_OVERWRITE : MAP_FLAG_DISCARD);
+
+    Uint32* pTexIndexDst = static_cast<Uint32*>(TexIndices) + VtxRingOffset;
+    for (Int32 CmdListID = 0; CmdListID < pDrawData->CmdListsCount; CmdListID++)
+    {
+        const ImDrawList* pCmdList = pDrawData->CmdLists[CmdListID];
+        for (Int32 CmdID = 0; CmdID < pCmdList->CmdBuffer.Size; CmdID++)
+        {
+            const ImDrawCmd* pCmd = &pCmdList->CmdBuffer[CmdID];
+            if (pCmd->UserCallback != NULL)
+            {
+                // Keep the table ids indexed by the global command index
+                Res.CmdTableIds.push_back(0);
+                continue;
+            }
+
+            auto* pTextureView = reinterpret_cast<ITextureView*>(pCmd->TextureId);
+            VERIFY_EXPR(pTextureView);
+
+            auto SlotIt = Res.TextureSlots.find(pTextureView);
+            if (SlotIt == Res.TextureSlots.end())
+            {
+                if (Res.TextureTables.empty() || Res.TextureTables.back().size() == MaxBindlessTextures)
+                {
+                    // Start a new table. Commands that use it will be drawn after a new SRB commit.
+                    Res.TextureTables.emplace_back();
+                    Res.TextureTables.back().reserve(MaxBindlessTextures);
+                    Res.TextureSlots.clear();
+                }
+                auto& Table = Res.TextureTables.back();
+                SlotIt      = Res.TextureSlots.emplace(pTextureView, static_cast<Uint32>(Table.size())).first;
+                Table.push_back(pTextureView);
+            }
+            Res.CmdTableIds.push_back(static_cast<Uint32>(Res.TextureTables.size() - 1));
+
+            const bool IsSDFFont = m_FontAtlasModeInUse == IMGUI_FONT_ATLAS_MODE_SDF && pTextureView == m_pFontSRV;
+
+            // ImGui starts a new command whenever the texture changes, so vertices are never
+            // shared between commands that use different textures.
+            // The high bit tells the pixel shader to render the SDF font atlas.
+            const Uint32     TexIndex = SlotIt->second | (IsSDFFont ? SDFTextureFlag : 0u);
+            const ImDrawIdx* pIndices = pCmdList->IdxBuffer.Data + pCmd->IdxOffset;
+            Uint32*          pDst     = pTexIndexDst + pCmd->VtxOffset;
+            for (Uint32 i = 0; i < pCmd->ElemCount; ++i)
+                pDst[pIndices[i]] = TexIndex;
+        }
+        pTexIndexDst += pCmdList->VtxBuffer.Size;
+    }
+
+    // All array elements must be initialized, so fill the unused slots with the font texture
+    for (auto& Table : Res.TextureTables)
+        Table.resize(MaxBindlessTextures, m_pFontSRV.RawPtr());
 }
 
 } // namespace Diligent
@@ -58,7 +58,11 @@ ImGuiImplDiligent::~ImGuiImplDiligent()
 void ImGuiImplDiligent::NewFrame(Uint32 RenderSurfaceWidth, Uint32 RenderSurfaceHeight, SURFACE_TRANSFORM SurfacePreTransform)
 {
     m_pRenderer->NewFrame(RenderSurfaceWidth, RenderSurfaceHeight, SurfacePreTransform);
+
+    ImGuiIO& io = ImGui::GetIO();
+    m_InputQueue.Apply(io);
     ImGui::NewFrame();
+    m_InputQueue.UpdateCaptureFlags(io);
 }
 
 void ImGuiImplDiligent::EndFrame()
@@ -73,6 +77,22 @@ void ImGuiImplDiligent::Render(IDeviceContext* pCtx)
     m_pRenderer->RenderDrawData(pCtx, ImGui::GetDrawData());
 }
 
+void ImGuiImplDiligent::RenderDrawData(IDeviceContext* pCtx, ImDrawData* pDrawData)
+{
+    m_pRenderer->RenderDrawData(pCtx, pDrawData);
+}
+
+void ImGuiImplDiligent::RenderCached(IDeviceContext* pCtx, ITextureView* pRTV, ITextureView* pDSV)
+{
+    ImGui::Render();
+    m_pRenderer->RenderDrawDataCached(pCtx, ImGui::GetDrawData(), pRTV, pDSV);
+}
+
+void ImGuiImplDiligent::InvalidateRenderCache()
+{
+    m_pRenderer->InvalidateRenderCache();
+}
+
 // Use if you want to reset your rendering device without losing ImGui state.
 void ImGuiImplDiligent::InvalidateDeviceObjects()
 {
@@ -89,4 +109,14 @@ void ImGuiImplDiligent::UpdateFontsTexture()
     m_pRenderer->CreateFontsTexture();
 }
 
+void ImGuiImplDiligent::SetFontAtlasMode(IMGUI_FONT_ATLAS_MODE Mode)
+{
+    m_pRenderer->SetFontAtlasMode(Mode);
+}
+
+void ImGuiImplDiligent::SetCompactVertexFormat(bool UseCompactVertices)
+{
+    m_pRenderer->SetCompactVertexFormat(UseCompactVertices);
+}
+
 } // namespace Diligent
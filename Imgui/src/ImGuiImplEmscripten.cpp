@@ -87,49 +87,46 @@ void ImGuiImplEmscripten::Render(IDeviceContext* pCtx)
     ImGuiImplDiligent::Render(pCtx);
 }
 
+// Events are pushed into the input queue and applied by the next NewFrame call, so the
+// handlers may be called on the browser main thread while the UI is rendered by a worker.
 bool ImGuiImplEmscripten::OnMouseEvent(int32_t EventType, const EmscriptenMouseEvent* Event)
 {
-    auto& io        = ImGui::GetIO();
-    io.MousePos     = ImVec2(Event->targetX, Event->targetY);
-    io.MouseDown[0] = Event->buttons & 1;
-    io.MouseDown[1] = Event->buttons & 2;
-    io.MouseDown[2] = Event->buttons & 4;
-    return io.WantCaptureMouse;
+    m_InputQueue.PushMousePos(static_cast<float>(Event->targetX), static_cast<float>(Event->targetY));
+    if (EventType == EMSCRIPTEN_EVENT_MOUSEDOWN || EventType == EMSCRIPTEN_EVENT_MOUSEUP)
+    {
+        // DOM buttons are left, middle, right; ImGui buttons are left, right, middle
+        static constexpr Uint32 ButtonMap[] = {0, 2, 1};
+        if (Event->button < 3)
+            m_InputQueue.PushMouseButton(ButtonMap[Event->button], EventType == EMSCRIPTEN_EVENT_MOUSEDOWN);
+    }
+    return m_InputQueue.WantCaptureMouse();
 }
 
 bool ImGuiImplEmscripten::OnWheelEvent(int32_t EventType, const EmscriptenWheelEvent* Event)
 {
-    auto& io = ImGui::GetIO();
-    io.MouseWheelH += -0.1f * Event->deltaX;
-    io.MouseWheel += -0.1f * Event->deltaY;
-    return io.WantCaptureMouse;
+    m_InputQueue.PushMouseWheel(-0.1f * static_cast<float>(Event->deltaY), -0.1f * static_cast<float>(Event->deltaX));
+    return m_InputQueue.WantCaptureMouse();
 }
 
 bool ImGuiImplEmscripten::OnKeyEvent(int32_t EventType, const EmscriptenKeyboardEvent* Event)
 {
-    auto& io    = ImGui::GetIO();
-    io.KeyCtrl  = Event->ctrlKey;
-    io.KeyShift = Event->shiftKey;
-    io.KeyAlt   = Event->altKey;
-    io.KeySuper = Event->metaKey;
+    m_InputQueue.PushModifiers(Event->ctrlKey, Event->shiftKey, Event->altKey, Event->metaKey);
 
     switch (EventType)
     {
         case EMSCRIPTEN_EVENT_KEYDOWN:
         case EMSCRIPTEN_EVENT_KEYUP:
-        {
-            bool IsPressed            = EventType == EMSCRIPTEN_EVENT_KEYDOWN;
-            io.KeysDown[Event->which] = IsPressed;
+            m_InputQueue.PushKey(static_cast<Uint32>(Event->which), EventType == EMSCRIPTEN_EVENT_KEYDOWN);
             break;
-        }
+
         case EMSCRIPTEN_EVENT_KEYPRESS:
-        {
-            io.AddInputCharactersUTF8(Event->key);
+            if (Event->charCode != 0)
+                m_InputQueue.PushChar(static_cast<Uint32>(Event->charCode));
             break;
-        }
+
         default:
             break;
     }
-    return io.WantCaptureKeyboard;
+    return m_InputQueue.WantCaptureKeyboard();
 }
 } // namespace Diligent
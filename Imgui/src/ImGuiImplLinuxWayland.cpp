@@ -0,0 +1,202 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "ImGuiImplLinuxWayland.hpp"
+
+#include "imgui.h"
+
+#include <xkbcommon/xkbcommon-keysyms.h>
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Linux input event codes, see linux/input-event-codes.h
+constexpr Uint32 LinuxBtnLeft   = 0x110;
+constexpr Uint32 LinuxBtnRight  = 0x111;
+constexpr Uint32 LinuxBtnMiddle = 0x112;
+
+// Maps a key symbol to the io.KeysDown[] index. Function and keypad keys (0xFFxx)
+// are folded into [0x100, 0x1FF], latin characters are mapped to their upper case.
+Uint32 KeySymToKeyIndex(Uint32 KeySym)
+{
+    if ((KeySym & 0xFFFFFF00u) == 0xFF00u)
+        return 0x100u | (KeySym & 0xFFu);
+    if (KeySym >= 'a' && KeySym <= 'z')
+        return KeySym - 'a' + 'A';
+    if (KeySym < 0x100u)
+        return KeySym;
+    return 0;
+}
+
+} // namespace
+
+ImGuiImplLinuxWayland::ImGuiImplLinuxWayland(IRenderDevice* pDevice,
+                                             TEXTURE_FORMAT BackBufferFmt,
+                                             TEXTURE_FORMAT DepthBufferFmt,
+                                             Uint32         DisplayWidth,
+                                             Uint32         DisplayHeight,
+                                             Uint32         InitialVertexBufferSize,
+                                             Uint32         InitialIndexBufferSize) :
+    ImGuiImplDiligent{pDevice, BackBufferFmt, DepthBufferFmt, InitialVertexBufferSize, InitialIndexBufferSize}
+{
+    auto& io       = ImGui::GetIO();
+    io.DisplaySize = ImVec2(DisplayWidth, DisplayHeight);
+
+    io.BackendPlatformName = "Diligent-ImGuiImplLinuxWayland";
+
+    // Keyboard mapping. ImGui will use those indices to peek into the io.KeysDown[] array that we will update during the application lifetime.
+    io.KeyMap[ImGuiKey_Tab]         = KeySymToKeyIndex(XKB_KEY_Tab);
+    io.KeyMap[ImGuiKey_LeftArrow]   = KeySymToKeyIndex(XKB_KEY_Left);
+    io.KeyMap[ImGuiKey_RightArrow]  = KeySymToKeyIndex(XKB_KEY_Right);
+    io.KeyMap[ImGuiKey_UpArrow]     = KeySymToKeyIndex(XKB_KEY_Up);
+    io.KeyMap[ImGuiKey_DownArrow]   = KeySymToKeyIndex(XKB_KEY_Down);
+    io.KeyMap[ImGuiKey_PageUp]      = KeySymToKeyIndex(XKB_KEY_Page_Up);
+    io.KeyMap[ImGuiKey_PageDown]    = KeySymToKeyIndex(XKB_KEY_Page_Down);
+    io.KeyMap[ImGuiKey_Home]        = KeySymToKeyIndex(XKB_KEY_Home);
+    io.KeyMap[ImGuiKey_End]         = KeySymToKeyIndex(XKB_KEY_End);
+    io.KeyMap[ImGuiKey_Insert]      = KeySymToKeyIndex(XKB_KEY_Insert);
+    io.KeyMap[ImGuiKey_Delete]      = KeySymToKeyIndex(XKB_KEY_Delete);
+    io.KeyMap[ImGuiKey_Backspace]   = KeySymToKeyIndex(XKB_KEY_BackSpace);
+    io.KeyMap[ImGuiKey_Space]       = KeySymToKeyIndex(XKB_KEY_space);
+    io.KeyMap[ImGuiKey_Enter]       = KeySymToKeyIndex(XKB_KEY_Return);
+    io.KeyMap[ImGuiKey_Escape]      = KeySymToKeyIndex(XKB_KEY_Escape);
+    io.KeyMap[ImGuiKey_KeyPadEnter] = KeySymToKeyIndex(XKB_KEY_KP_Enter);
+    io.KeyMap[ImGuiKey_A]           = 'A';
+    io.KeyMap[ImGuiKey_C]           = 'C';
+    io.KeyMap[ImGuiKey_V]           = 'V';
+    io.KeyMap[ImGuiKey_X]           = 'X';
+    io.KeyMap[ImGuiKey_Y]           = 'Y';
+    io.KeyMap[ImGuiKey_Z]           = 'Z';
+
+    m_LastTimestamp = std::chrono::high_resolution_clock::now();
+}
+
+void ImGuiImplLinuxWayland::NewFrame(Uint32            RenderSurfaceWidth,
+                                     Uint32            RenderSurfaceHeight,
+                                     SURFACE_TRANSFORM SurfacePreTransform)
+{
+    auto now        = std::chrono::high_resolution_clock::now();
+    auto elapsed_ns = now - m_LastTimestamp;
+    m_LastTimestamp = now;
+    auto& io        = ImGui::GetIO();
+    io.DeltaTime    = static_cast<float>(elapsed_ns.count() / 1e+9);
+
+    // The framebuffer size is known from the swap chain, so there is no separate display size event
+    m_InputQueue.PushDisplaySize(static_cast<float>(RenderSurfaceWidth), static_cast<float>(RenderSurfaceHeight));
+
+    ImGuiImplDiligent::NewFrame(RenderSurfaceWidth, RenderSurfaceHeight, SurfacePreTransform);
+}
+
+void ImGuiImplLinuxWayland::SetContentScale(float Scale)
+{
+    VERIFY_EXPR(Scale > 0);
+    m_ContentScale = Scale;
+}
+
+// Events are pushed into the input queue and applied by the next NewFrame call, so the
+// handlers may be called from a thread other than the one that renders the UI.
+bool ImGuiImplLinuxWayland::HandlePointerMotion(double X, double Y)
+{
+    m_InputQueue.PushMousePos(static_cast<float>(X * m_ContentScale), static_cast<float>(Y * m_ContentScale));
+    return m_InputQueue.WantCaptureMouse();
+}
+
+bool ImGuiImplLinuxWayland::HandlePointerButton(Uint32 Button, bool IsPressed)
+{
+    switch (Button)
+    {
+        case LinuxBtnLeft: m_InputQueue.PushMouseButton(0, IsPressed); break;
+        case LinuxBtnRight: m_InputQueue.PushMouseButton(1, IsPressed); break;
+        case LinuxBtnMiddle: m_InputQueue.PushMouseButton(2, IsPressed); break;
+    }
+    return m_InputQueue.WantCaptureMouse();
+}
+
+bool ImGuiImplLinuxWayland::HandlePointerAxis(float Vertical, float Horizontal)
+{
+    m_InputQueue.PushMouseWheel(Vertical, Horizontal);
+    return m_InputQueue.WantCaptureMouse();
+}
+
+bool ImGuiImplLinuxWayland::HandleKey(Uint32 KeySym, bool IsPressed)
+{
+    const auto KeyIndex = KeySymToKeyIndex(KeySym);
+    if (KeyIndex != 0)
+        m_InputQueue.PushKey(KeyIndex, IsPressed);
+    return m_InputQueue.WantCaptureKeyboard();
+}
+
+void ImGuiImplLinuxWayland::HandleModifiers(bool Ctrl, bool Shift, bool Alt, bool Super)
+{
+    m_InputQueue.PushModifiers(Ctrl, Shift, Alt, Super);
+}
+
+bool ImGuiImplLinuxWayland::HandleText(const char* UTF8)
+{
+    if (UTF8 == nullptr)
+        return false;
+
+    // Decode UTF-8 into code points
+    const auto* c = reinterpret_cast<const unsigned char*>(UTF8);
+    while (*c != 0)
+    {
+        int NumTail = 0;
+        if (*c < 0x80)
+            NumTail = 0;
+        else if ((*c & 0xE0) == 0xC0)
+            NumTail = 1;
+        else if ((*c & 0xF0) == 0xE0)
+            NumTail = 2;
+        else if ((*c & 0xF8) == 0xF0)
+            NumTail = 3;
+        else
+            return m_InputQueue.WantCaptureKeyboard(); // Invalid lead byte
+
+        // Mask out the length bits of the lead byte
+        Uint32 CodePoint = *c & (0x7Fu >> NumTail);
+        ++c;
+
+        for (; NumTail > 0; --NumTail, ++c)
+        {
+            if ((*c & 0xC0) != 0x80)
+                return m_InputQueue.WantCaptureKeyboard(); // Truncated sequence
+            CodePoint = (CodePoint << 6) | (*c & 0x3F);
+        }
+
+        // Control characters are delivered through HandleKey
+        if (CodePoint >= 0x20 && CodePoint != 0x7F)
+            m_InputQueue.PushChar(CodePoint);
+    }
+    return m_InputQueue.WantCaptureKeyboard();
+}
+
+} // namespace Diligent
@@ -108,18 +108,22 @@ void ImGuiImplLinuxX11::NewFrame(Uint32            RenderSurfaceWidth,
     auto& io        = ImGui::GetIO();
     io.DeltaTime    = static_cast<float>(elapsed_ns.count() / 1e+9);
 
+    // Queued events, including display size changes, are applied by ImGuiImplDiligent::NewFrame
+    ImGuiImplDiligent::NewFrame(RenderSurfaceWidth, RenderSurfaceHeight, SurfacePreTransform);
+
     VERIFY(io.DisplaySize.x == 0 || io.DisplaySize.x == static_cast<float>(RenderSurfaceWidth), "io.DisplaySize.x (",
            io.DisplaySize.x, " does not match RenderSurfaceWidth (", RenderSurfaceWidth, ")");
     VERIFY(io.DisplaySize.y == 0 || io.DisplaySize.y == static_cast<float>(RenderSurfaceHeight), "io.DisplaySize.y (",
            io.DisplaySize.y, " does not match RenderSurfaceHeight (", RenderSurfaceHeight, ")");
-
-    ImGuiImplDiligent::NewFrame(RenderSurfaceWidth, RenderSurfaceHeight, SurfacePreTransform);
 }
 
 
+// Events are pushed into the input queue and applied by the next NewFrame call, so this
+// method may be called from a thread other than the one that renders the UI.
 bool ImGuiImplLinuxX11::HandleXEvent(XEvent* event)
 {
-    auto& io = ImGui::GetIO();
+    // Key map is only written by the constructor
+    const auto& io = ImGui::GetIO();
     switch (event->type)
     {
         case ButtonPress:
@@ -129,26 +133,26 @@ bool ImGuiImplLinuxX11::HandleXEvent(XEvent* event)
             auto* xbe       = reinterpret_cast<XButtonEvent*>(event);
             switch (xbe->button)
             {
-                case Button1: io.MouseDown[0] = IsPressed; break; // Left
-                case Button2: io.MouseDown[2] = IsPressed; break; // Middle
-                case Button3: io.MouseDown[1] = IsPressed; break; // Right
-                case Button4: io.MouseWheel += 1; break;
-                case Button5: io.MouseWheel -= 1; break;
+                case Button1: m_InputQueue.PushMouseButton(0, IsPressed); break; // Left
+                case Button2: m_InputQueue.PushMouseButton(2, IsPressed); break; // Middle
+                case Button3: m_InputQueue.PushMouseButton(1, IsPressed); break; // Right
+                case Button4: m_InputQueue.PushMouseWheel(+1); break;
+                case Button5: m_InputQueue.PushMouseWheel(-1); break;
             }
-            return io.WantCaptureMouse;
+            return m_InputQueue.WantCaptureMouse();
         }
 
         case MotionNotify:
         {
             XMotionEvent* xme = (XMotionEvent*)event;
-            io.MousePos       = ImVec2(xme->x, xme->y);
-            return io.WantCaptureMouse;
+            m_InputQueue.PushMousePos(static_cast<float>(xme->x), static_cast<float>(xme->y));
+            return m_InputQueue.WantCaptureMouse();
         }
 
         case ConfigureNotify:
         {
             XConfigureEvent* xce = (XConfigureEvent*)event;
-            io.DisplaySize       = ImVec2(xce->width, xce->height);
+            m_InputQueue.PushDisplaySize(static_cast<float>(xce->width), static_cast<float>(xce->height));
             return false;
         }
 
@@ -156,9 +160,10 @@ bool ImGuiImplLinuxX11::HandleXEvent(XEvent* event)
         case KeyRelease:
         {
             bool IsPressed = event->type == KeyPress;
-            io.KeyCtrl     = (event->xkey.state & ControlMask) != 0;
-            io.KeyShift    = (event->xkey.state & ShiftMask) != 0;
-            io.KeyAlt      = (event->xkey.state & Mod1Mask) != 0;
+            m_InputQueue.PushModifiers((event->xkey.state & ControlMask) != 0,
+                                       (event->xkey.state & ShiftMask) != 0,
+                                       (event->xkey.state & Mod1Mask) != 0,
+                                       false);
 
             KeySym        keysym  = 0;
             constexpr int buff_sz = 80;
@@ -188,15 +193,15 @@ bool ImGuiImplLinuxX11::HandleXEvent(XEvent* event)
             }
 
             if (k != 0)
-                io.KeysDown[k] = IsPressed;
+                m_InputQueue.PushKey(k, IsPressed);
 
             if (k == 0 && IsPressed)
             {
                 for (int i = 0; i < num_char; ++i)
-                    io.AddInputCharacter(buffer[i]);
+                    m_InputQueue.PushChar(static_cast<Uint8>(buffer[i]));
             }
 
-            return io.WantCaptureKeyboard;
+            return m_InputQueue.WantCaptureKeyboard();
         }
 
         default:
@@ -99,12 +99,13 @@ void ImGuiImplLinuxXCB::NewFrame(Uint32            RenderSurfaceWidth,
     auto& io        = ImGui::GetIO();
     io.DeltaTime    = static_cast<float>(elapsed_ns.count() / 1e+9);
 
+    // Queued events, including display size changes, are applied by ImGuiImplDiligent::NewFrame
+    ImGuiImplDiligent::NewFrame(RenderSurfaceWidth, RenderSurfaceHeight, SurfacePreTransform);
+
     VERIFY(io.DisplaySize.x == 0 || io.DisplaySize.x == static_cast<float>(RenderSurfaceWidth), "io.DisplaySize.x (",
            io.DisplaySize.x, " does not match RenderSurfaceWidth (", RenderSurfaceWidth, ")");
     VERIFY(io.DisplaySize.y == 0 || io.DisplaySize.y == static_cast<float>(RenderSurfaceHeight), "io.DisplaySize.y (",
            io.DisplaySize.y, " does not match RenderSurfaceHeight (", RenderSurfaceHeight, ")");
-
-    ImGuiImplDiligent::NewFrame(RenderSurfaceWidth, RenderSurfaceHeight, SurfacePreTransform);
 }
 
 // ----------------------------------------------------------------------
@@ -113,11 +114,14 @@ void ImGuiImplLinuxXCB::HandleKeyEvent(xcb_key_release_event_t* event)
 {
     bool IsKeyPressed = (event->response_type & 0x7f) == XCB_KEY_PRESS;
 
-    auto& io = ImGui::GetIO();
+    // Key map is only written by the constructor
+    const auto& io = ImGui::GetIO();
 
-    io.KeyCtrl  = event->state & XCB_KEY_BUT_MASK_CONTROL;
-    io.KeyShift = event->state & XCB_KEY_BUT_MASK_SHIFT;
-    io.KeyAlt   = event->state & XCB_KEY_BUT_MASK_MOD_1;
+    const bool IsShiftDown = (event->state & XCB_KEY_BUT_MASK_SHIFT) != 0;
+    m_InputQueue.PushModifiers((event->state & XCB_KEY_BUT_MASK_CONTROL) != 0,
+                               IsShiftDown,
+                               (event->state & XCB_KEY_BUT_MASK_MOD_1) != 0,
+                               false);
 
     int k = 0;
     switch (event->detail)
@@ -185,7 +189,7 @@ void ImGuiImplLinuxXCB::HandleKeyEvent(xcb_key_release_event_t* event)
             default:
                 if (keysym > 12 && keysym < 127)
                 {
-                    if (io.KeyShift)
+                    if (IsShiftDown)
                     {
                         if (keysym >= 'a' && keysym <= 'z')
                             keysym += (int)'A' - (int)'a';
@@ -218,27 +222,28 @@ void ImGuiImplLinuxXCB::HandleKeyEvent(xcb_key_release_event_t* event)
                         }
                     }
 
-                    io.AddInputCharacter(keysym);
+                    m_InputQueue.PushChar(keysym);
                 }
         }
     }
 
     if (k != 0)
     {
-        io.KeysDown[k] = IsKeyPressed;
+        m_InputQueue.PushKey(k, IsKeyPressed);
     }
 }
 
+// Events are pushed into the input queue and applied by the next NewFrame call, so this
+// method may be called from a thread other than the one that renders the UI.
 bool ImGuiImplLinuxXCB::HandleXCBEvent(xcb_generic_event_t* event)
 {
-    auto& io = ImGui::GetIO();
     switch (event->response_type & 0x7f)
     {
         case XCB_MOTION_NOTIFY:
         {
             xcb_motion_notify_event_t* motion = (xcb_motion_notify_event_t*)event;
-            io.MousePos                       = ImVec2(motion->event_x, motion->event_y);
-            return io.WantCaptureMouse;
+            m_InputQueue.PushMousePos(motion->event_x, motion->event_y);
+            return m_InputQueue.WantCaptureMouse();
         }
         break;
 
@@ -247,14 +252,14 @@ bool ImGuiImplLinuxXCB::HandleXCBEvent(xcb_generic_event_t* event)
             xcb_button_press_event_t* press = (xcb_button_press_event_t*)event;
             switch (press->detail)
             {
-                case XCB_BUTTON_INDEX_1: io.MouseDown[0] = true; break; // left
-                case XCB_BUTTON_INDEX_2: io.MouseDown[2] = true; break; // middle
-                case XCB_BUTTON_INDEX_3: io.MouseDown[1] = true; break; // right
-                case XCB_BUTTON_INDEX_4: io.MouseWheel += 1; break;
-                case XCB_BUTTON_INDEX_5: io.MouseWheel -= 1; break;
+                case XCB_BUTTON_INDEX_1: m_InputQueue.PushMouseButton(0, true); break; // left
+                case XCB_BUTTON_INDEX_2: m_InputQueue.PushMouseButton(2, true); break; // middle
+                case XCB_BUTTON_INDEX_3: m_InputQueue.PushMouseButton(1, true); break; // right
+                case XCB_BUTTON_INDEX_4: m_InputQueue.PushMouseWheel(+1); break;
+                case XCB_BUTTON_INDEX_5: m_InputQueue.PushMouseWheel(-1); break;
             }
 
-            return io.WantCaptureMouse;
+            return m_InputQueue.WantCaptureMouse();
         }
         break;
 
@@ -263,12 +268,12 @@ bool ImGuiImplLinuxXCB::HandleXCBEvent(xcb_generic_event_t* event)
             xcb_button_release_event_t* press = (xcb_button_release_event_t*)event;
             switch (press->detail)
             {
-                case XCB_BUTTON_INDEX_1: io.MouseDown[0] = false; break; // left
-                case XCB_BUTTON_INDEX_2: io.MouseDown[2] = false; break; // middle
-                case XCB_BUTTON_INDEX_3: io.MouseDown[1] = false; break; // right
+                case XCB_BUTTON_INDEX_1: m_InputQueue.PushMouseButton(0, false); break; // left
+                case XCB_BUTTON_INDEX_2: m_InputQueue.PushMouseButton(2, false); break; // middle
+                case XCB_BUTTON_INDEX_3: m_InputQueue.PushMouseButton(1, false); break; // right
             }
 
-            return io.WantCaptureMouse;
+            return m_InputQueue.WantCaptureMouse();
         }
         break;
 
@@ -277,7 +282,7 @@ bool ImGuiImplLinuxXCB::HandleXCBEvent(xcb_generic_event_t* event)
         {
             xcb_key_press_event_t* keyEvent = (xcb_key_press_event_t*)event;
             HandleKeyEvent(keyEvent);
-            return io.WantCaptureKeyboard;
+            return m_InputQueue.WantCaptureKeyboard();
         }
         break;
 
@@ -285,7 +290,7 @@ bool ImGuiImplLinuxXCB::HandleXCBEvent(xcb_generic_event_t* event)
         {
             const xcb_configure_notify_event_t* cfgEvent = (const xcb_configure_notify_event_t*)event;
 
-            io.DisplaySize = ImVec2(cfgEvent->width, cfgEvent->height);
+            m_InputQueue.PushDisplaySize(cfgEvent->width, cfgEvent->height);
             return false;
         }
         break;
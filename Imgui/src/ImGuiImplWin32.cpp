@@ -27,6 +27,7 @@
 
 #include "WinHPreface.h"
 #include <Windows.h>
+#include <windowsx.h>
 #include "WinHPostface.h"
 
 #include "GraphicsTypes.h"
@@ -82,14 +83,14 @@ void ImGuiImplWin32::NewFrame(Uint32 RenderSurfaceWidth, Uint32 RenderSurfaceHei
 #    define WM_MOUSEHWHEEL 0x020E
 #endif
 
+// Input messages are pushed into the input queue and applied by the next NewFrame call, so the
+// message loop may run on a thread other than the one that renders the UI. Other messages are
+// forwarded to the Dear ImGui Win32 backend.
 LRESULT ImGuiImplWin32::Win32_ProcHandler(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 {
     if (ImGui::GetCurrentContext() == NULL)
         return 0;
 
-    auto res = ImGui_ImplWin32_WndProcHandler(hwnd, msg, wParam, lParam);
-
-    ImGuiIO& io = ImGui::GetIO();
     switch (msg)
     {
         case WM_LBUTTONDOWN:
@@ -104,21 +105,86 @@ LRESULT ImGuiImplWin32::Win32_ProcHandler(HWND hwnd, UINT msg, WPARAM wParam, LP
         case WM_RBUTTONUP:
         case WM_MBUTTONUP:
         case WM_XBUTTONUP:
+        {
+            Uint32 Button = 0;
+            // clang-format off
+            if (msg == WM_RBUTTONDOWN || msg == WM_RBUTTONDBLCLK || msg == WM_RBUTTONUP) Button = 1;
+            if (msg == WM_MBUTTONDOWN || msg == WM_MBUTTONDBLCLK || msg == WM_MBUTTONUP) Button = 2;
+            if (msg == WM_XBUTTONDOWN || msg == WM_XBUTTONDBLCLK || msg == WM_XBUTTONUP) Button = (GET_XBUTTON_WPARAM(wParam) == XBUTTON1) ? 3 : 4;
+            // clang-format on
+            const bool IsDown = msg != WM_LBUTTONUP && msg != WM_RBUTTONUP && msg != WM_MBUTTONUP && msg != WM_XBUTTONUP;
+
+            // Keep receiving mouse messages while a button is held outside of the window
+            if (IsDown)
+            {
+                if (m_MouseButtonsDown == 0 && ::GetCapture() == NULL)
+                    ::SetCapture(hwnd);
+                m_MouseButtonsDown |= 1u << Button;
+            }
+            else
+            {
+                m_MouseButtonsDown &= ~(1u << Button);
+                if (m_MouseButtonsDown == 0 && ::GetCapture() == hwnd)
+                    ::ReleaseCapture();
+            }
+
+            m_InputQueue.PushMouseButton(Button, IsDown);
+            return m_InputQueue.WantCaptureMouse() ? 1 : 0;
+        }
+
+        case WM_MOUSEMOVE:
+            m_InputQueue.PushMousePos(static_cast<float>(GET_X_LPARAM(lParam)), static_cast<float>(GET_Y_LPARAM(lParam)));
+            return 0;
+
         case WM_MOUSEWHEEL:
         case WM_MOUSEHWHEEL:
-            return io.WantCaptureMouse ? 1 : 0;
+        {
+            const float Delta = static_cast<float>(GET_WHEEL_DELTA_WPARAM(wParam)) / static_cast<float>(WHEEL_DELTA);
+            if (msg == WM_MOUSEWHEEL)
+                m_InputQueue.PushMouseWheel(Delta, 0);
+            else
+                m_InputQueue.PushMouseWheel(0, Delta);
+            return m_InputQueue.WantCaptureMouse() ? 1 : 0;
+        }
 
         case WM_KEYDOWN:
         case WM_SYSKEYDOWN:
         case WM_KEYUP:
         case WM_SYSKEYUP:
+        {
+            // Key states are per-thread, so they are read here rather than polled by the render thread
+            m_InputQueue.PushModifiers((::GetKeyState(VK_CONTROL) & 0x8000) != 0,
+                                       (::GetKeyState(VK_SHIFT) & 0x8000) != 0,
+                                       (::GetKeyState(VK_MENU) & 0x8000) != 0,
+                                       ((::GetKeyState(VK_LWIN) | ::GetKeyState(VK_RWIN)) & 0x8000) != 0);
+            if (wParam < 256)
+                m_InputQueue.PushKey(static_cast<Uint32>(wParam), msg == WM_KEYDOWN || msg == WM_SYSKEYDOWN);
+            return m_InputQueue.WantCaptureKeyboard() ? 1 : 0;
+        }
+
         case WM_CHAR:
-            return io.WantCaptureKeyboard ? 1 : 0;
-        case WM_SETCURSOR:
-            return res;
+        {
+            // Combine UTF-16 surrogate pairs
+            const auto Unit = static_cast<wchar_t>(wParam);
+            if (Unit >= 0xD800 && Unit < 0xDC00)
+            {
+                m_HighSurrogate = Unit;
+            }
+            else if (Unit >= 0xDC00 && Unit < 0xE000)
+            {
+                if (m_HighSurrogate != 0)
+                    m_InputQueue.PushChar(0x10000u + ((static_cast<Uint32>(m_HighSurrogate) - 0xD800u) << 10u) + (static_cast<Uint32>(Unit) - 0xDC00u));
+                m_HighSurrogate = 0;
+            }
+            else if (Unit > 0)
+            {
+                m_InputQueue.PushChar(Unit);
+            }
+            return m_InputQueue.WantCaptureKeyboard() ? 1 : 0;
+        }
     }
 
-    return res;
+    return ImGui_ImplWin32_WndProcHandler(hwnd, msg, wParam, lParam);
 }
 
 } // namespace Diligent
@@ -0,0 +1,201 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "ImGuiInputQueue.hpp"
+
+#include <bitset>
+
+#include "imgui.h"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+static_assert((ImGuiInputQueue::Capacity & (ImGuiInputQueue::Capacity - 1)) == 0, "Capacity must be a power of two");
+
+bool ImGuiInputQueue::Push(const Event& Evt)
+{
+    const auto Tail = m_Tail.load(std::memory_order_relaxed);
+    if (Tail - m_Head.load(std::memory_order_acquire) == Capacity)
+        return false;
+
+    m_Events[Tail % Capacity] = Evt;
+    m_Tail.store(Tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool ImGuiInputQueue::PushMousePos(float X, float Y)
+{
+    Event Evt;
+    Evt.Type = EVENT_TYPE_MOUSE_POS;
+    Evt.X    = X;
+    Evt.Y    = Y;
+    return Push(Evt);
+}
+
+bool ImGuiInputQueue::PushMouseButton(Uint32 Button, bool IsDown)
+{
+    VERIFY_EXPR(Button < IM_ARRAYSIZE(ImGuiIO::MouseDown));
+    Event Evt;
+    Evt.Type   = EVENT_TYPE_MOUSE_BUTTON;
+    Evt.Index  = Button;
+    Evt.IsDown = IsDown;
+    return Push(Evt);
+}
+
+bool ImGuiInputQueue::PushMouseWheel(float Vertical, float Horizontal)
+{
+    Event Evt;
+    Evt.Type = EVENT_TYPE_MOUSE_WHEEL;
+    Evt.X    = Horizontal;
+    Evt.Y    = Vertical;
+    return Push(Evt);
+}
+
+bool ImGuiInputQueue::PushKey(Uint32 Key, bool IsDown)
+{
+    VERIFY_EXPR(Key < IM_ARRAYSIZE(ImGuiIO::KeysDown));
+    Event Evt;
+    Evt.Type   = EVENT_TYPE_KEY;
+    Evt.Index  = Key;
+    Evt.IsDown = IsDown;
+    return Push(Evt);
+}
+
+bool ImGuiInputQueue::PushModifiers(bool Ctrl, bool Shift, bool Alt, bool Super)
+{
+    Event Evt;
+    Evt.Type  = EVENT_TYPE_MODIFIERS;
+    Evt.Index = (Ctrl ? 1u : 0u) | (Shift ? 2u : 0u) | (Alt ? 4u : 0u) | (Super ? 8u : 0u);
+    return Push(Evt);
+}
+
+bool ImGuiInputQueue::PushChar(Uint32 Char)
+{
+    Event Evt;
+    Evt.Type  = EVENT_TYPE_CHAR;
+    Evt.Index = Char;
+    return Push(Evt);
+}
+
+bool ImGuiInputQueue::PushDisplaySize(float Width, float Height)
+{
+    Event Evt;
+    Evt.Type = EVENT_TYPE_DISPLAY_SIZE;
+    Evt.X    = Width;
+    Evt.Y    = Height;
+    return Push(Evt);
+}
+
+void ImGuiInputQueue::Apply(ImGuiIO& IO)
+{
+    // Buttons and keys that already changed their state in this batch
+    std::bitset<IM_ARRAYSIZE(ImGuiIO::MouseDown)> ChangedButtons;
+    std::bitset<IM_ARRAYSIZE(ImGuiIO::KeysDown)>  ChangedKeys;
+
+    const auto Tail = m_Tail.load(std::memory_order_acquire);
+    auto       Head = m_Head.load(std::memory_order_relaxed);
+    for (; Head != Tail; ++Head)
+    {
+        const auto& Evt   = m_Events[Head % Capacity];
+        bool        Defer = false;
+        switch (Evt.Type)
+        {
+            case EVENT_TYPE_MOUSE_POS:
+                IO.MousePos = ImVec2{Evt.X, Evt.Y};
+                break;
+
+            case EVENT_TYPE_MOUSE_BUTTON:
+                if (IO.MouseDown[Evt.Index] != Evt.IsDown)
+                {
+                    if (ChangedButtons[Evt.Index])
+                    {
+                        Defer = true;
+                        break;
+                    }
+                    ChangedButtons[Evt.Index] = true;
+                    IO.MouseDown[Evt.Index]   = Evt.IsDown;
+                }
+                break;
+
+            case EVENT_TYPE_MOUSE_WHEEL:
+                IO.MouseWheel += Evt.Y;
+                IO.MouseWheelH += Evt.X;
+                break;
+
+            case EVENT_TYPE_KEY:
+                if (IO.KeysDown[Evt.Index] != Evt.IsDown)
+                {
+                    if (ChangedKeys[Evt.Index])
+                    {
+                        Defer = true;
+                        break;
+                    }
+                    ChangedKeys[Evt.Index] = true;
+                    IO.KeysDown[Evt.Index] = Evt.IsDown;
+                }
+                break;
+
+            case EVENT_TYPE_MODIFIERS:
+                m_ModifierFlags  = Evt.Index;
+                m_ModifiersKnown = true;
+                break;
+
+            case EVENT_TYPE_CHAR:
+                IO.AddInputCharacter(Evt.Index);
+                break;
+
+            case EVENT_TYPE_DISPLAY_SIZE:
+                IO.DisplaySize = ImVec2{Evt.X, Evt.Y};
+                break;
+
+            default:
+                UNEXPECTED("Unexpected event type");
+        }
+
+        // The second transition of a button or a key is left for the next frame
+        if (Defer)
+            break;
+    }
+    m_Head.store(Head, std::memory_order_release);
+
+    if (m_ModifiersKnown)
+    {
+        IO.KeyCtrl  = (m_ModifierFlags & 1u) != 0;
+        IO.KeyShift = (m_ModifierFlags & 2u) != 0;
+        IO.KeyAlt   = (m_ModifierFlags & 4u) != 0;
+        IO.KeySuper = (m_ModifierFlags & 8u) != 0;
+    }
+}
+
+void ImGuiInputQueue::UpdateCaptureFlags(const ImGuiIO& IO)
+{
+    m_WantCaptureMouse.store(IO.WantCaptureMouse, std::memory_order_relaxed);
+    m_WantCaptureKeyboard.store(IO.WantCaptureKeyboard, std::memory_order_relaxed);
+}
+
+} // namespace Diligent
@@ -0,0 +1,369 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "ImGuiProfiler.hpp"
+
+#include <algorithm>
+#include <tuple>
+
+#include "RenderDevice.h"
+#include "DeviceContext.h"
+#include "imgui.h"
+
+namespace Diligent
+{
+
+ImGuiProfiler::ImGuiProfiler(IRenderDevice* pDevice) :
+    ImGuiProfiler{pDevice, CreateInfo{}}
+{
+}
+
+ImGuiProfiler::ImGuiProfiler(IRenderDevice* pDevice, const CreateInfo& CI) :
+    // clang-format off
+    m_CI          {CI},
+    m_pDevice     {pDevice},
+    m_GPUFrames   (CI.FramesInFlight),
+    m_CPUFramePlot{"CPU frame, ms", CI.HistoryLength, CI.PlotHeight},
+    m_GPUFramePlot{"GPU frame, ms", CI.HistoryLength, CI.PlotHeight}
+// clang-format on
+{
+    const auto& Features = pDevice->GetDeviceInfo().Features;
+    for (auto& Frame : m_GPUFrames)
+    {
+        if (Features.TimestampQueries != DEVICE_FEATURE_STATE_DISABLED)
+        {
+            // Every scope needs two timestamps, and the frame itself needs two more
+            Frame.Timestamps.resize(2 * size_t{m_CI.MaxGPUScopes} + 2);
+            for (auto& pQuery : Frame.Timestamps)
+            {
+                QueryDesc Desc;
+                Desc.Name = "ImGui profiler timestamp";
+                Desc.Type = QUERY_TYPE_TIMESTAMP;
+                pDevice->CreateQuery(Desc, &pQuery);
+            }
+        }
+
+        if (Features.PipelineStatisticsQueries != DEVICE_FEATURE_STATE_DISABLED)
+        {
+            QueryDesc Desc;
+            Desc.Name = "ImGui profiler pipeline statistics";
+            Desc.Type = QUERY_TYPE_PIPELINE_STATISTICS;
+            pDevice->CreateQuery(Desc, &Frame.Statistics);
+        }
+    }
+}
+
+ImGuiProfiler::~ImGuiProfiler()
+{
+}
+
+void ImGuiProfiler::BeginFrame(IDeviceContext* pCtx)
+{
+    m_FrameStart = Clock::now();
+    m_CPUScopes.clear();
+    m_CPUScopeStack.clear();
+    m_GPUScopeStack.clear();
+
+    m_pCurrGPUFrame = nullptr;
+    if (m_GPUFrames.empty())
+        return;
+
+    // Do not wait for the GPU: if the queries of this slot have not been read back yet, skip the frame
+    auto& Frame = m_GPUFrames[m_FrameIndex % m_GPUFrames.size()];
+    if (Frame.Pending || (Frame.Timestamps.empty() && !Frame.Statistics))
+        return;
+
+    m_pCurrGPUFrame     = &Frame;
+    Frame.NumTimestamps = 0;
+    Frame.Scopes.clear();
+    AddTimestamp(pCtx, Frame);
+    if (Frame.Statistics)
+        pCtx->BeginQuery(Frame.Statistics);
+}
+
+void ImGuiProfiler::EndFrame(IDeviceContext* pCtx)
+{
+    VERIFY(m_CPUScopeStack.empty(), "Not all CPU scopes have been ended");
+    VERIFY(m_GPUScopeStack.empty(), "Not all GPU scopes have been ended");
+
+    m_LastCPUFrameTime = std::chrono::duration<double, std::milli>(Clock::now() - m_FrameStart).count();
+    m_CPUFramePlot.AddValue(static_cast<float>(m_LastCPUFrameTime));
+    m_LastCPUScopes.swap(m_CPUScopes);
+    for (const auto& Scope : m_LastCPUScopes)
+        AddScopeValue(Scope.Name, Scope.Duration, m_CPUScopePlots);
+
+    if (m_pCurrGPUFrame != nullptr)
+    {
+        AddTimestamp(pCtx, *m_pCurrGPUFrame);
+        if (m_pCurrGPUFrame->Statistics)
+            pCtx->EndQuery(m_pCurrGPUFrame->Statistics);
+        m_pCurrGPUFrame->Pending = true;
+        m_pCurrGPUFrame          = nullptr;
+    }
+    ++m_FrameIndex;
+
+    ResolvePendingGPUFrames();
+}
+
+void ImGuiProfiler::BeginCPUScope(const char* Name)
+{
+    ScopeTiming Scope;
+    Scope.Name  = Name;
+    Scope.Depth = static_cast<Uint32>(m_CPUScopeStack.size());
+    Scope.Start = std::chrono::duration<double, std::milli>(Clock::now() - m_FrameStart).count();
+    m_CPUScopeStack.push_back(m_CPUScopes.size());
+    m_CPUScopes.push_back(Scope);
+}
+
+void ImGuiProfiler::EndCPUScope()
+{
+    VERIFY(!m_CPUScopeStack.empty(), "There is no CPU scope to end");
+    if (m_CPUScopeStack.empty())
+        return;
+
+    auto& Scope    = m_CPUScopes[m_CPUScopeStack.back()];
+    Scope.Duration = std::chrono::duration<double, std::milli>(Clock::now() - m_FrameStart).count() - Scope.Start;
+    m_CPUScopeStack.pop_back();
+}
+
+void ImGuiProfiler::BeginGPUScope(IDeviceContext* pCtx, const char* Name)
+{
+    if (m_pCurrGPUFrame == nullptr || m_pCurrGPUFrame->Timestamps.empty() || m_pCurrGPUFrame->Scopes.size() >= m_CI.MaxGPUScopes)
+    {
+        // The scope is not measured, but must still be matched by EndGPUScope
+        m_GPUScopeStack.push_back(InvalidQuery);
+        return;
+    }
+
+    GPUScope Scope;
+    Scope.Name       = Name;
+    Scope.Depth      = static_cast<Uint32>(m_GPUScopeStack.size());
+    Scope.BeginQuery = AddTimestamp(pCtx, *m_pCurrGPUFrame);
+    m_GPUScopeStack.push_back(static_cast<Uint32>(m_pCurrGPUFrame->Scopes.size()));
+    m_pCurrGPUFrame->Scopes.push_back(Scope);
+}
+
+void ImGuiProfiler::EndGPUScope(IDeviceContext* pCtx)
+{
+    VERIFY(!m_GPUScopeStack.empty(), "There is no GPU scope to end");
+    if (m_GPUScopeStack.empty())
+        return;
+
+    const auto ScopeIdx = m_GPUScopeStack.back();
+    m_GPUScopeStack.pop_back();
+    if (ScopeIdx != InvalidQuery && m_pCurrGPUFrame != nullptr)
+        m_pCurrGPUFrame->Scopes[ScopeIdx].EndQuery = AddTimestamp(pCtx, *m_pCurrGPUFrame);
+}
+
+Uint32 ImGuiProfiler::AddTimestamp(IDeviceContext* pCtx, GPUFrame& Frame)
+{
+    if (Frame.NumTimestamps >= Frame.Timestamps.size())
+        return InvalidQuery;
+
+    pCtx->EndQuery(Frame.Timestamps[Frame.NumTimestamps]);
+    return Frame.NumTimestamps++;
+}
+
+void ImGuiProfiler::ResolvePendingGPUFrames()
+{
+    // Frames are resolved in the order they were submitted
+    while (m_OldestPending < m_FrameIndex)
+    {
+        auto& Frame = m_GPUFrames[m_OldestPending % m_GPUFrames.size()];
+        if (Frame.Pending)
+        {
+            if (!ResolveGPUFrame(Frame))
+                break;
+            Frame.Pending = false;
+        }
+        ++m_OldestPending;
+    }
+}
+
+bool ImGuiProfiler::ResolveGPUFrame(GPUFrame& Frame)
+{
+    // Queries are only invalidated once all of them are available, so that a partially
+    // available frame can be read again later.
+    m_TimestampScratch.resize(Frame.NumTimestamps);
+    Uint64 Frequency = 0;
+    for (Uint32 i = 0; i < Frame.NumTimestamps; ++i)
+    {
+        QueryDataTimestamp Data;
+        if (!Frame.Timestamps[i]->GetData(&Data, sizeof(Data), false))
+            return false;
+        m_TimestampScratch[i] = Data.Counter;
+        Frequency             = Data.Frequency;
+    }
+
+    QueryDataPipelineStatistics StatsData;
+    if (Frame.Statistics && !Frame.Statistics->GetData(&StatsData, sizeof(StatsData), false))
+        return false;
+
+    for (Uint32 i = 0; i < Frame.NumTimestamps; ++i)
+        Frame.Timestamps[i]->Invalidate();
+
+    if (Frame.NumTimestamps >= 2 && Frequency != 0)
+    {
+        const double ToMs       = 1000.0 / static_cast<double>(Frequency);
+        const Uint64 FrameBegin = m_TimestampScratch.front();
+
+        m_LastGPUFrameTime = static_cast<double>(m_TimestampScratch.back() - FrameBegin) * ToMs;
+        m_GPUFramePlot.AddValue(static_cast<float>(m_LastGPUFrameTime));
+
+        m_LastGPUScopes.clear();
+        for (const auto& Scope : Frame.Scopes)
+        {
+            if (Scope.BeginQuery == InvalidQuery || Scope.EndQuery == InvalidQuery)
+                continue;
+
+            ScopeTiming Timing;
+            Timing.Name     = Scope.Name;
+            Timing.Depth    = Scope.Depth;
+            Timing.Start    = static_cast<double>(m_TimestampScratch[Scope.BeginQuery] - FrameBegin) * ToMs;
+            Timing.Duration = static_cast<double>(m_TimestampScratch[Scope.EndQuery] - m_TimestampScratch[Scope.BeginQuery]) * ToMs;
+            m_LastGPUScopes.push_back(Timing);
+            AddScopeValue(Timing.Name, Timing.Duration, m_GPUScopePlots);
+        }
+    }
+
+    if (Frame.Statistics)
+    {
+        Frame.Statistics->Invalidate();
+
+        m_LastStats.InputVertices      = StatsData.InputVertices;
+        m_LastStats.InputPrimitives    = StatsData.InputPrimitives;
+        m_LastStats.ClippingPrimitives = StatsData.ClippingPrimitives;
+        m_LastStats.VSInvocations      = StatsData.VSInvocations;
+        m_LastStats.PSInvocations      = StatsData.PSInvocations;
+        m_LastStats.CSInvocations      = StatsData.CSInvocations;
+    }
+
+    return true;
+}
+
+void ImGuiProfiler::AddScopeValue(const char* Name, double Value, std::map<std::string, ImGui::Plot>& Plots)
+{
+    auto it = Plots.find(Name);
+    if (it == Plots.end())
+    {
+        it = Plots.emplace(std::piecewise_construct,
+                           std::forward_as_tuple(Name),
+                           std::forward_as_tuple(Name, size_t{m_CI.HistoryLength}, m_CI.PlotHeight))
+                 .first;
+    }
+    it->second.AddValue(static_cast<float>(Value));
+}
+
+void ImGuiProfiler::RenderTimeline(const char* Label, const std::vector<ScopeTiming>& Scopes, double FrameTime)
+{
+    if (Scopes.empty() || FrameTime <= 0)
+        return;
+
+    Uint32 NumRows = 1;
+    for (const auto& Scope : Scopes)
+        NumRows = std::max(NumRows, Scope.Depth + 1);
+
+    const float  RowHeight = ImGui::GetTextLineHeightWithSpacing();
+    const ImVec2 Origin    = ImGui::GetCursorScreenPos();
+    const float  Width     = std::max(ImGui::GetContentRegionAvail().x, 1.f);
+
+    ImGui::InvisibleButton(Label, ImVec2{Width, RowHeight * static_cast<float>(NumRows)});
+    const bool   IsHovered = ImGui::IsItemHovered();
+    const ImVec2 MousePos  = ImGui::GetIO().MousePos;
+
+    ImDrawList* pDrawList = ImGui::GetWindowDrawList();
+    for (const auto& Scope : Scopes)
+    {
+        const float x0 = Origin.x + Width * static_cast<float>(Scope.Start / FrameTime);
+        const float x1 = std::max(x0 + Width * static_cast<float>(Scope.Duration / FrameTime), x0 + 1.f);
+        const float y0 = Origin.y + RowHeight * static_cast<float>(Scope.Depth);
+        const float y1 = y0 + RowHeight - 1.f;
+
+        // Stable color per scope name
+        Uint32 Hash = 2166136261u;
+        for (const char* c = Scope.Name; *c != '\0'; ++c)
+            Hash = (Hash ^ static_cast<Uint8>(*c)) * 16777619u;
+        const ImU32 Color = ImColor::HSV(static_cast<float>(Hash % 360u) / 360.f, 0.5f, 0.8f);
+
+        pDrawList->AddRectFilled(ImVec2{x0, y0}, ImVec2{x1, y1}, Color);
+        if (ImGui::CalcTextSize(Scope.Name).x + 4.f < x1 - x0)
+            pDrawList->AddText(ImVec2{x0 + 2.f, y0}, IM_COL32_BLACK, Scope.Name);
+
+        if (IsHovered && MousePos.x >= x0 && MousePos.x < x1 && MousePos.y >= y0 && MousePos.y < y1)
+            ImGui::SetTooltip("%s: %.3f ms", Scope.Name, Scope.Duration);
+    }
+}
+
+void ImGuiProfiler::Render()
+{
+    const bool HasGPUTimings = !m_GPUFrames.empty() && !m_GPUFrames.front().Timestamps.empty();
+    const bool HasStats      = !m_GPUFrames.empty() && m_GPUFrames.front().Statistics;
+
+    if (HasGPUTimings)
+        ImGui::Text("CPU: %.2f ms   GPU: %.2f ms", m_LastCPUFrameTime, m_LastGPUFrameTime);
+    else
+        ImGui::Text("CPU: %.2f ms", m_LastCPUFrameTime);
+
+    m_CPUFramePlot.Render();
+    if (HasGPUTimings)
+        m_GPUFramePlot.Render();
+
+    if (ImGui::CollapsingHeader("Timeline", ImGuiTreeNodeFlags_DefaultOpen))
+    {
+        ImGui::TextUnformatted("CPU");
+        RenderTimeline("##CPUTimeline", m_LastCPUScopes, m_LastCPUFrameTime);
+        if (HasGPUTimings)
+        {
+            ImGui::TextUnformatted("GPU");
+            RenderTimeline("##GPUTimeline", m_LastGPUScopes, m_LastGPUFrameTime);
+        }
+    }
+
+    if (HasStats && ImGui::CollapsingHeader("Pipeline statistics"))
+    {
+        ImGui::Text("Input vertices:      %llu", static_cast<unsigned long long>(m_LastStats.InputVertices));
+        ImGui::Text("Input primitives:    %llu", static_cast<unsigned long long>(m_LastStats.InputPrimitives));
+        ImGui::Text("Clipped primitives:  %llu", static_cast<unsigned long long>(m_LastStats.ClippingPrimitives));
+        ImGui::Text("VS invocations:      %llu", static_cast<unsigned long long>(m_LastStats.VSInvocations));
+        ImGui::Text("PS invocations:      %llu", static_cast<unsigned long long>(m_LastStats.PSInvocations));
+        ImGui::Text("CS invocations:      %llu", static_cast<unsigned long long>(m_LastStats.CSInvocations));
+    }
+
+    if (!m_CPUScopePlots.empty() && ImGui::CollapsingHeader("CPU scopes"))
+    {
+        for (auto& it : m_CPUScopePlots)
+            it.second.Render();
+    }
+
+    if (!m_GPUScopePlots.empty() && ImGui::CollapsingHeader("GPU scopes"))
+    {
+        for (auto& it : m_GPUScopePlots)
+            it.second.Render();
+    }
+}
+
+} // namespace Diligent
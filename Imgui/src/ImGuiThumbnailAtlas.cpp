@@ -0,0 +1,432 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "ImGuiThumbnailAtlas.hpp"
+
+#include <algorithm>
+
+#include "RenderDevice.h"
+#include "DeviceContext.h"
+#include "ThreadPool.hpp"
+#include "DataBlobImpl.hpp"
+#include "FileWrapper.hpp"
+#include "DebugUtilities.hpp"
+#include "Image.h"
+#include "TextureLoader.h"
+
+namespace Diligent
+{
+
+namespace
+{
+
+constexpr Uint8 PlaceholderColor[4] = {64, 64, 64, 255};
+
+// Expands Src pixels to RGBA8
+void ExpandToRGBA8(const Uint8* pSrc, Uint32 SrcStride, Uint32 NumComponents, Uint32 Width, Uint32 Height, std::vector<Uint8>& Dst)
+{
+    Dst.resize(size_t{Width} * Height * 4);
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        const auto* pSrcRow = pSrc + size_t{y} * SrcStride;
+        auto*       pDstRow = &Dst[size_t{y} * Width * 4];
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            const auto* s = pSrcRow + x * NumComponents;
+            auto*       d = pDstRow + x * 4;
+            switch (NumComponents)
+            {
+                case 1: d[0] = d[1] = d[2] = s[0], d[3] = 255; break;
+                case 2: d[0] = d[1] = d[2] = s[0], d[3] = s[1]; break;
+                case 3: d[0] = s[0], d[1] = s[1], d[2] = s[2], d[3] = 255; break;
+                default: d[0] = s[0], d[1] = s[1], d[2] = s[2], d[3] = s[3]; break;
+            }
+        }
+    }
+}
+
+// Averages the source texels covered by every destination texel
+void DownscaleRGBA8(const Uint8* pSrc, Uint32 SrcStride, Uint32 SrcWidth, Uint32 SrcHeight, Uint32 DstWidth, Uint32 DstHeight, std::vector<Uint8>& Dst)
+{
+    Dst.resize(size_t{DstWidth} * DstHeight * 4);
+    for (Uint32 y = 0; y < DstHeight; ++y)
+    {
+        const auto y0 = y * SrcHeight / DstHeight;
+        const auto y1 = std::max((y + 1) * SrcHeight / DstHeight, y0 + 1);
+        for (Uint32 x = 0; x < DstWidth; ++x)
+        {
+            const auto x0 = x * SrcWidth / DstWidth;
+            const auto x1 = std::max((x + 1) * SrcWidth / DstWidth, x0 + 1);
+
+            Uint32 Sum[4] = {};
+            for (auto sy = y0; sy < y1; ++sy)
+            {
+                const auto* pRow = pSrc + size_t{sy} * SrcStride;
+                for (auto sx = x0; sx < x1; ++sx)
+                {
+                    for (Uint32 c = 0; c < 4; ++c)
+                        Sum[c] += pRow[sx * 4 + c];
+                }
+            }
+
+            const auto NumTexels = (y1 - y0) * (x1 - x0);
+            auto*      pDst      = &Dst[(size_t{y} * DstWidth + x) * 4];
+            for (Uint32 c = 0; c < 4; ++c)
+                pDst[c] = static_cast<Uint8>((Sum[c] + NumTexels / 2) / NumTexels);
+        }
+    }
+}
+
+// Fits the image into MaxSize x MaxSize and writes the RGBA8 pixels to Dst
+void FitRGBA8(const Uint8* pSrc, Uint32 SrcStride, Uint32 SrcWidth, Uint32 SrcHeight, Uint32 MaxSize, std::vector<Uint8>& Dst, Uint32& DstWidth, Uint32& DstHeight)
+{
+    const auto MaxDim = std::max(SrcWidth, SrcHeight);
+    if (MaxDim <= MaxSize)
+    {
+        DstWidth  = SrcWidth;
+        DstHeight = SrcHeight;
+    }
+    else
+    {
+        DstWidth  = std::max(static_cast<Uint32>(Uint64{SrcWidth} * MaxSize / MaxDim), 1u);
+        DstHeight = std::max(static_cast<Uint32>(Uint64{SrcHeight} * MaxSize / MaxDim), 1u);
+    }
+    DownscaleRGBA8(pSrc, SrcStride, SrcWidth, SrcHeight, DstWidth, DstHeight, Dst);
+}
+
+// Reads the mip level of a DDS or KTX file that is closest to the thumbnail size
+bool DecodeTextureFile(const char* FilePath, Uint32 MaxSize, std::vector<Uint8>& Pixels, Uint32& Width, Uint32& Height)
+{
+    TextureLoadInfo LoadInfo;
+    LoadInfo.GenerateMips = false;
+
+    RefCntAutoPtr<ITextureLoader> pLoader;
+    CreateTextureLoaderFromFile(FilePath, IMAGE_FILE_FORMAT_UNKNOWN, LoadInfo, &pLoader);
+    if (!pLoader)
+        return false;
+
+    const auto& Desc = pLoader->GetTextureDesc();
+    if (Desc.Format != TEX_FORMAT_RGBA8_UNORM && Desc.Format != TEX_FORMAT_RGBA8_UNORM_SRGB)
+    {
+        LOG_WARNING_MESSAGE("Thumbnails of '", FilePath, "' can't be created: only RGBA8 textures are supported");
+        return false;
+    }
+
+    // The smallest mip level that is not smaller than the thumbnail
+    Uint32 Mip = 0;
+    while (Mip + 1 < Desc.MipLevels && std::max(Desc.Width >> (Mip + 1), Desc.Height >> (Mip + 1)) >= MaxSize)
+        ++Mip;
+
+    const auto& SubRes = pLoader->GetSubresourceData(Mip, 0);
+    FitRGBA8(static_cast<const Uint8*>(SubRes.pData), static_cast<Uint32>(SubRes.Stride),
+             std::max(Desc.Width >> Mip, 1u), std::max(Desc.Height >> Mip, 1u),
+             MaxSize, Pixels, Width, Height);
+    return true;
+}
+
+bool DecodeThumbnail(const char* FilePath, Uint32 MaxSize, std::vector<Uint8>& Pixels, Uint32& Width, Uint32& Height)
+{
+    ImageProbeInfo ProbeInfo;
+    if (!ProbeImageFile(FilePath, ProbeInfo))
+        return false;
+
+    if (ProbeInfo.FileFormat == IMAGE_FILE_FORMAT_DDS || ProbeInfo.FileFormat == IMAGE_FILE_FORMAT_KTX)
+        return DecodeTextureFile(FilePath, MaxSize, Pixels, Width, Height);
+
+    if (ProbeInfo.ComponentType != VT_UINT8)
+    {
+        LOG_WARNING_MESSAGE("Thumbnails of '", FilePath, "' can't be created: only 8-bit images are supported");
+        return false;
+    }
+
+    FileWrapper File{FilePath, EFileAccessMode::Read};
+    if (!File)
+        return false;
+
+    auto pFileData = DataBlobImpl::Create(0);
+    File->Read(pFileData);
+
+    ImageLoadInfo LoadInfo;
+    LoadInfo.Format = ProbeInfo.FileFormat;
+    // JPEG images are decoded at the smallest scale that is not below the thumbnail size.
+    // Other formats ignore the scale.
+    const auto MaxDim = std::max(ProbeInfo.Width, ProbeInfo.Height);
+    for (LoadInfo.ScaleDenom = 8; LoadInfo.ScaleDenom > 1; LoadInfo.ScaleDenom /= 2)
+    {
+        if ((MaxDim + LoadInfo.ScaleDenom - 1) / LoadInfo.ScaleDenom >= MaxSize)
+            break;
+    }
+
+    RefCntAutoPtr<Image> pImage;
+    Image::CreateFromDataBlob(pFileData, LoadInfo, &pImage);
+    if (!pImage)
+        return false;
+
+    const auto& ImgDesc = pImage->GetDesc();
+    const auto* pSrc    = static_cast<const Uint8*>(pImage->GetData()->GetConstDataPtr());
+    if (ImgDesc.ComponentType != VT_UINT8 || ImgDesc.NumComponents == 0 || ImgDesc.NumComponents > 4)
+        return false;
+
+    std::vector<Uint8> RGBA;
+    Uint32             SrcStride = ImgDesc.RowStride;
+    if (ImgDesc.NumComponents != 4)
+    {
+        ExpandToRGBA8(pSrc, ImgDesc.RowStride, ImgDesc.NumComponents, ImgDesc.Width, ImgDesc.Height, RGBA);
+        pSrc      = RGBA.data();
+        SrcStride = ImgDesc.Width * 4;
+    }
+
+    FitRGBA8(pSrc, SrcStride, ImgDesc.Width, ImgDesc.Height, MaxSize, Pixels, Width, Height);
+    return true;
+}
+
+} // namespace
+
+ImGuiThumbnailAtlas::ImGuiThumbnailAtlas(IRenderDevice* pDevice, const CreateInfo& CI) :
+    m_CI{CI},
+    m_SlotsPerRow{std::max(CI.AtlasSize / std::max(CI.ThumbnailSize, 1u), 1u)},
+    m_NumSlots{m_SlotsPerRow * m_SlotsPerRow},
+    m_pDevice{pDevice},
+    m_pThreadPool{CI.pThreadPool}
+{
+    DEV_CHECK_ERR(pDevice != nullptr, "pDevice must not be null");
+    DEV_CHECK_ERR(m_NumSlots > 1, "The atlas must fit at least two thumbnails: one of them is the placeholder");
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "ImGui thumbnail atlas";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Width     = CI.AtlasSize;
+    TexDesc.Height    = CI.AtlasSize;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.Usage     = USAGE_DEFAULT;
+    TexDesc.BindFlags = BIND_SHADER_RESOURCE;
+    m_pDevice->CreateTexture(TexDesc, nullptr, &m_pAtlas);
+    VERIFY_EXPR(m_pAtlas);
+
+    if (!m_pThreadPool)
+    {
+        ThreadPoolCreateInfo ThreadPoolCI{2};
+        m_pThreadPool = CreateThreadPool(ThreadPoolCI);
+    }
+
+    // Slots are allocated from the back
+    m_FreeSlots.reserve(m_NumSlots - 1);
+    for (Uint32 Slot = m_NumSlots - 1; Slot > 0; --Slot)
+        m_FreeSlots.push_back(Slot);
+}
+
+ImGuiThumbnailAtlas::ImGuiThumbnailAtlas(IRenderDevice* pDevice) :
+    ImGuiThumbnailAtlas{pDevice, CreateInfo{}}
+{
+}
+
+ImGuiThumbnailAtlas::~ImGuiThumbnailAtlas()
+{
+    // The tasks reference the atlas
+    std::unique_lock<std::mutex> Lock{m_DecodedMtx};
+    m_DecodedCV.wait(Lock, [this]() { return m_NumPendingTasks == 0; });
+}
+
+ImGuiThumbnailAtlas::Thumbnail ImGuiThumbnailAtlas::GetSlotThumbnail(Uint32 Slot, Uint32 Width, Uint32 Height, bool IsReady) const
+{
+    const auto AtlasSize = static_cast<float>(m_CI.AtlasSize);
+    const auto x         = static_cast<float>((Slot % m_SlotsPerRow) * m_CI.ThumbnailSize);
+    const auto y         = static_cast<float>((Slot / m_SlotsPerRow) * m_CI.ThumbnailSize);
+
+    Thumbnail Thumb;
+    Thumb.TextureId = reinterpret_cast<ImTextureID>(m_pAtlas->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE));
+    Thumb.UV0       = ImVec2{x / AtlasSize, y / AtlasSize};
+    Thumb.UV1       = ImVec2{(x + static_cast<float>(Width)) / AtlasSize, (y + static_cast<float>(Height)) / AtlasSize};
+    Thumb.Size      = ImVec2{static_cast<float>(Width), static_cast<float>(Height)};
+    Thumb.IsReady   = IsReady;
+    return Thumb;
+}
+
+bool ImGuiThumbnailAtlas::AllocateSlot(Uint32& Slot)
+{
+    if (!m_FreeSlots.empty())
+    {
+        Slot = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+        return true;
+    }
+
+    for (auto it = m_LRU.rbegin(); it != m_LRU.rend(); ++it)
+    {
+        auto& Evicted = m_Entries.at(*it);
+        // The rest of the thumbnails have been requested in the current frame
+        if (Evicted.LastUsedFrame == m_FrameIndex)
+            break;
+        if (Evicted.State == EntryState::Loading)
+            continue;
+
+        Slot = Evicted.Slot;
+
+        const auto LRUIt = Evicted.LRUIt;
+        m_Entries.erase(*it);
+        m_LRU.erase(LRUIt);
+        return true;
+    }
+
+    return false;
+}
+
+void ImGuiThumbnailAtlas::EnqueueDecode(const std::string& FilePath)
+{
+    {
+        std::lock_guard<std::mutex> Lock{m_DecodedMtx};
+        ++m_NumPendingTasks;
+    }
+
+    const auto MaxSize = m_CI.ThumbnailSize;
+    EnqueueAsyncWork(m_pThreadPool,
+                     [this, FilePath, MaxSize](Uint32 ThreadId) {
+                         DecodedThumbnail Decoded;
+                         Decoded.FilePath = FilePath;
+                         if (!DecodeThumbnail(FilePath.c_str(), MaxSize, Decoded.Pixels, Decoded.Width, Decoded.Height))
+                             Decoded.Pixels.clear();
+
+                         std::lock_guard<std::mutex> Lock{m_DecodedMtx};
+                         m_Decoded.emplace_back(std::move(Decoded));
+                         --m_NumPendingTasks;
+                         m_DecodedCV.notify_all();
+                     });
+}
+
+ImGuiThumbnailAtlas::Thumbnail ImGuiThumbnailAtlas::GetThumbnail(const char* FilePath)
+{
+    const auto Placeholder = GetSlotThumbnail(0, m_CI.ThumbnailSize, m_CI.ThumbnailSize, false);
+
+    auto it = m_Entries.find(FilePath);
+    if (it == m_Entries.end())
+    {
+        Uint32 Slot = 0;
+        // All slots are used by the thumbnails of the current frame. Try again in the next one.
+        if (!AllocateSlot(Slot))
+            return Placeholder;
+
+        it = m_Entries.emplace(FilePath, Entry{}).first;
+
+        it->second.Slot  = Slot;
+        it->second.LRUIt = m_LRU.insert(m_LRU.begin(), it->first);
+        EnqueueDecode(it->first);
+    }
+
+    auto& ThumbEntry = it->second;
+    if (ThumbEntry.State == EntryState::Failed)
+        return Placeholder;
+
+    ThumbEntry.LastUsedFrame = m_FrameIndex;
+    m_LRU.splice(m_LRU.begin(), m_LRU, ThumbEntry.LRUIt);
+
+    return ThumbEntry.State == EntryState::Ready ?
+        GetSlotThumbnail(ThumbEntry.Slot, ThumbEntry.Width, ThumbEntry.Height, true) :
+        Placeholder;
+}
+
+bool ImGuiThumbnailAtlas::Image(const char* FilePath, const ImVec2& MaxSize)
+{
+    const auto Thumb = GetThumbnail(FilePath);
+
+    const auto Scale = std::min(MaxSize.x / std::max(Thumb.Size.x, 1.f), MaxSize.y / std::max(Thumb.Size.y, 1.f));
+    ImGui::Image(Thumb.TextureId, ImVec2{Thumb.Size.x * Scale, Thumb.Size.y * Scale}, Thumb.UV0, Thumb.UV1);
+
+    return Thumb.IsReady;
+}
+
+void ImGuiThumbnailAtlas::UploadToSlot(IDeviceContext* pCtx, Uint32 Slot, const Uint8* pPixels, Uint32 Width, Uint32 Height)
+{
+    const auto x = (Slot % m_SlotsPerRow) * m_CI.ThumbnailSize;
+    const auto y = (Slot / m_SlotsPerRow) * m_CI.ThumbnailSize;
+
+    Box UpdateBox{x, x + Width, y, y + Height};
+
+    TextureSubResData SubresData;
+    SubresData.pData  = pPixels;
+    SubresData.Stride = Uint64{Width} * 4;
+    pCtx->UpdateTexture(m_pAtlas, 0, 0, UpdateBox, SubresData, RESOURCE_STATE_TRANSITION_MODE_NONE, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+}
+
+void ImGuiThumbnailAtlas::Update(IDeviceContext* pCtx)
+{
+    DEV_CHECK_ERR(pCtx != nullptr, "pCtx must not be null");
+
+    bool Updated = false;
+    if (!m_PlaceholderInitialized)
+    {
+        std::vector<Uint8> Placeholder(size_t{m_CI.ThumbnailSize} * m_CI.ThumbnailSize * 4);
+        for (size_t i = 0; i < Placeholder.size(); i += 4)
+            std::copy(std::begin(PlaceholderColor), std::end(PlaceholderColor), &Placeholder[i]);
+        UploadToSlot(pCtx, 0, Placeholder.data(), m_CI.ThumbnailSize, m_CI.ThumbnailSize);
+        m_PlaceholderInitialized = true;
+        Updated                  = true;
+    }
+
+    std::vector<DecodedThumbnail> Decoded;
+    {
+        std::lock_guard<std::mutex> Lock{m_DecodedMtx};
+        const auto                  NumUploads = std::min(m_Decoded.size(), size_t{m_CI.MaxUploadsPerFrame});
+        Decoded.assign(std::make_move_iterator(m_Decoded.begin()), std::make_move_iterator(m_Decoded.begin() + NumUploads));
+        m_Decoded.erase(m_Decoded.begin(), m_Decoded.begin() + NumUploads);
+    }
+
+    for (auto& Thumb : Decoded)
+    {
+        auto it = m_Entries.find(Thumb.FilePath);
+        // Loading thumbnails are never evicted
+        VERIFY_EXPR(it != m_Entries.end() && it->second.State == EntryState::Loading);
+        if (it == m_Entries.end())
+            continue;
+
+        auto& ThumbEntry = it->second;
+        if (Thumb.Pixels.empty())
+        {
+            // Keep the entry so that the file is not decoded again, and release the slot
+            ThumbEntry.State = EntryState::Failed;
+            m_FreeSlots.push_back(ThumbEntry.Slot);
+            m_LRU.erase(ThumbEntry.LRUIt);
+            ThumbEntry.Slot = 0;
+            continue;
+        }
+
+        UploadToSlot(pCtx, ThumbEntry.Slot, Thumb.Pixels.data(), Thumb.Width, Thumb.Height);
+        ThumbEntry.State  = EntryState::Ready;
+        ThumbEntry.Width  = Thumb.Width;
+        ThumbEntry.Height = Thumb.Height;
+        Updated           = true;
+    }
+
+    if (Updated)
+    {
+        StateTransitionDesc Barrier{m_pAtlas, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_SHADER_RESOURCE, STATE_TRANSITION_FLAG_UPDATE_STATE};
+        pCtx->TransitionResourceStates(1, &Barrier);
+    }
+
+    ++m_FrameIndex;
+}
+
+} // namespace Diligent
@@ -30,6 +30,10 @@
 #include "imgui.h"
 #include "imgui_internal.h"
 
+#include <cmath>
+#include <cfloat>
+#include <cstring>
+
 namespace ImGui
 {
 
@@ -90,4 +94,428 @@ void Plot::Render()
                      ImVec2(static_cast<float>(m_Values.size()), m_Height));
 }
 
+bool Combo(const char* label, int* current_item, int items_count, const std::function<const char*(int)>& GetItemName, int popup_max_height_in_items)
+{
+    const char* preview_value = (*current_item >= 0 && *current_item < items_count) ? GetItemName(*current_item) : "";
+
+    if (popup_max_height_in_items != -1)
+    {
+        const auto& style = GetStyle();
+        SetNextWindowSizeConstraints(ImVec2(0, 0), ImVec2(FLT_MAX, GetTextLineHeightWithSpacing() * popup_max_height_in_items - style.ItemSpacing.y + style.WindowPadding.y * 2));
+    }
+
+    if (!BeginCombo(label, preview_value, ImGuiComboFlags_None))
+        return false;
+
+    // Bring the current item into view when the popup opens
+    if (IsWindowAppearing() && *current_item > 0)
+        SetScrollY(GetTextLineHeightWithSpacing() * *current_item);
+
+    bool value_changed = false;
+
+    ImGuiListClipper clipper;
+    clipper.Begin(items_count);
+    while (clipper.Step())
+    {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; ++i)
+        {
+            PushID(i);
+            const bool item_selected = i == *current_item;
+            if (Selectable(GetItemName(i), item_selected))
+            {
+                value_changed = true;
+                *current_item = i;
+            }
+            if (item_selected)
+                SetItemDefaultFocus();
+            PopID();
+        }
+    }
+
+    EndCombo();
+    return value_changed;
+}
+
+
+void VirtualList::Resize(size_t NumRows, float DefaultRowHeight)
+{
+    if (DefaultRowHeight <= 0)
+        DefaultRowHeight = GetTextLineHeightWithSpacing();
+    m_Heights.resize(NumRows, DefaultRowHeight);
+
+    // Build the tree in O(N)
+    m_Tree.assign(m_Heights.begin(), m_Heights.end());
+    for (size_t i = 0; i < m_Tree.size(); ++i)
+    {
+        const size_t Parent = i | (i + 1);
+        if (Parent < m_Tree.size())
+            m_Tree[Parent] += m_Tree[i];
+    }
+
+    m_FirstRendered = std::min(m_FirstRendered, NumRows);
+    m_EndRendered   = std::min(m_EndRendered, NumRows);
+}
+
+void VirtualList::SetRowHeight(size_t Row, float Height)
+{
+    VERIFY_EXPR(Row < m_Heights.size());
+
+    const double Delta = static_cast<double>(Height) - static_cast<double>(m_Heights[Row]);
+    m_Heights[Row]     = Height;
+    for (size_t i = Row; i < m_Tree.size(); i |= i + 1)
+        m_Tree[i] += Delta;
+}
+
+float VirtualList::GetRowOffset(size_t Row) const
+{
+    VERIFY_EXPR(Row <= m_Heights.size());
+
+    double Offset = 0;
+    for (size_t i = Row; i > 0; i &= i - 1)
+        Offset += m_Tree[i - 1];
+    return static_cast<float>(Offset);
+}
+
+size_t VirtualList::FindRow(float Offset) const
+{
+    const size_t NumRows = m_Heights.size();
+    VERIFY_EXPR(NumRows > 0);
+
+    size_t Step = 1;
+    while (Step * 2 <= NumRows)
+        Step *= 2;
+
+    // Descend the tree to find the number of rows that end at or above the offset
+    size_t Row       = 0;
+    double Remaining = Offset;
+    for (; Step > 0; Step /= 2)
+    {
+        if (Row + Step <= NumRows && m_Tree[Row + Step - 1] <= Remaining)
+        {
+            Row += Step;
+            Remaining -= m_Tree[Row - 1];
+        }
+    }
+    return std::min(Row, NumRows - 1);
+}
+
+void VirtualList::Render(const std::function<void(size_t Row)>& RenderRow)
+{
+    m_FirstRendered = 0;
+    m_EndRendered   = 0;
+    if (m_Heights.empty())
+        return;
+
+    ImGuiTable* pTable  = GetCurrentTable();
+    const bool  InTable = pTable != nullptr && pTable->InnerWindow == GetCurrentWindow();
+
+    // All positions are in the window content coordinates
+    const float StartY        = (InTable ? pTable->RowPosY2 : GetCursorScreenPos().y) - GetWindowPos().y + GetScrollY();
+    const float ScrollY       = GetScrollY();
+    const float VisibleHeight = GetWindowHeight();
+
+    if (m_ScrollToRow != InvalidRow)
+    {
+        const size_t Row    = std::min(m_ScrollToRow, m_Heights.size() - 1);
+        const float  RowTop = StartY + GetRowOffset(Row);
+        if (RowTop < ScrollY)
+            SetScrollY(RowTop);
+        else if (RowTop + m_Heights[Row] > ScrollY + VisibleHeight)
+            SetScrollY(RowTop + m_Heights[Row] - VisibleHeight);
+        m_ScrollToRow = InvalidRow;
+    }
+
+    const float VisibleTop    = std::max(ScrollY - StartY, 0.f);
+    const float VisibleBottom = ScrollY + VisibleHeight - StartY;
+    if (VisibleBottom > 0)
+    {
+        m_FirstRendered = FindRow(VisibleTop);
+        m_EndRendered   = std::min(FindRow(VisibleBottom) + 1, m_Heights.size());
+    }
+
+    auto UpdateRowHeight = [this](size_t Row, float Height) //
+    {
+        if (std::abs(Height - m_Heights[Row]) > 0.5f)
+            SetRowHeight(Row, Height);
+    };
+
+    if (!InTable)
+    {
+        SetCursorPosY(StartY + GetRowOffset(m_FirstRendered));
+        for (size_t Row = m_FirstRendered; Row < m_EndRendered; ++Row)
+        {
+            const float RowY = GetCursorPosY();
+            PushID(static_cast<int>(Row));
+            RenderRow(Row);
+            PopID();
+            UpdateRowHeight(Row, GetCursorPosY() - RowY);
+        }
+        // Reserve the space of the rows below the visible ones
+        SetCursorPosY(StartY + GetTotalHeight());
+    }
+    else
+    {
+        // Rows are measured when the next row starts
+        size_t PrevRow  = InvalidRow;
+        float  PrevRowY = 0;
+
+        const float TopSpace = GetRowOffset(m_FirstRendered);
+        if (TopSpace > 0)
+            TableNextRow(ImGuiTableRowFlags_None, TopSpace);
+
+        for (size_t Row = m_FirstRendered; Row < m_EndRendered; ++Row)
+        {
+            TableNextRow();
+            if (PrevRow != InvalidRow)
+                UpdateRowHeight(PrevRow, pTable->RowPosY1 - PrevRowY);
+            PrevRow  = Row;
+            PrevRowY = pTable->RowPosY1;
+
+            PushID(static_cast<int>(Row));
+            RenderRow(Row);
+            PopID();
+        }
+
+        const float BottomSpace = GetTotalHeight() - GetRowOffset(m_EndRendered);
+        if (BottomSpace > 0)
+        {
+            TableNextRow(ImGuiTableRowFlags_None, BottomSpace);
+            if (PrevRow != InvalidRow)
+                UpdateRowHeight(PrevRow, pTable->RowPosY1 - PrevRowY);
+        }
+    }
+}
+
+
+void VirtualTree::SetNodes(std::vector<int> Depths, float DefaultRowHeight)
+{
+    m_Depths = std::move(Depths);
+    m_Expanded.assign(m_Depths.size(), false);
+    m_DefaultRowHeight  = DefaultRowHeight;
+    m_VisibleNodesDirty = true;
+}
+
+void VirtualTree::SetExpanded(size_t Node, bool Expanded)
+{
+    if (m_Expanded[Node] != Expanded)
+    {
+        m_Expanded[Node]    = Expanded;
+        m_VisibleNodesDirty = true;
+    }
+}
+
+void VirtualTree::UpdateVisibleNodes()
+{
+    m_VisibleNodes.clear();
+    for (size_t Node = 0; Node < m_Depths.size();)
+    {
+        m_VisibleNodes.push_back(Node);
+
+        const auto Depth    = m_Depths[Node];
+        const bool Expanded = m_Expanded[Node];
+        ++Node;
+        if (!Expanded)
+        {
+            // Skip the subtree of the collapsed node
+            while (Node < m_Depths.size() && m_Depths[Node] > Depth)
+                ++Node;
+        }
+    }
+
+    // Rows now map to different nodes, so the measured heights are discarded
+    m_List.Resize(0);
+    m_List.Resize(m_VisibleNodes.size(), m_DefaultRowHeight);
+
+    m_VisibleNodesDirty = false;
+}
+
+void VirtualTree::Render(const std::function<void(size_t Node)>& RenderNode)
+{
+    if (m_VisibleNodesDirty)
+        UpdateVisibleNodes();
+
+    const float IndentSpacing = GetStyle().IndentSpacing;
+    m_List.Render([&](size_t Row) //
+                  {
+                      const size_t Node   = m_VisibleNodes[Row];
+                      const float  Indent = IndentSpacing * static_cast<float>(m_Depths[Node]);
+                      if (Indent > 0)
+                          ImGui::Indent(Indent);
+
+                      ImGuiTreeNodeFlags Flags = ImGuiTreeNodeFlags_NoTreePushOnOpen | ImGuiTreeNodeFlags_OpenOnArrow;
+                      if (!HasChildren(Node))
+                          Flags |= ImGuiTreeNodeFlags_Leaf;
+
+                      // The expanded state is owned by the tree, so that it is preserved for the nodes that are not rendered
+                      SetNextItemOpen(m_Expanded[Node], ImGuiCond_Always);
+                      const bool IsOpen = TreeNodeEx("##node", Flags);
+                      if (HasChildren(Node))
+                          SetExpanded(Node, IsOpen);
+
+                      SameLine();
+                      RenderNode(Node);
+
+                      if (Indent > 0)
+                          ImGui::Unindent(Indent);
+                  });
+}
+
+
+size_t TextRunCache::GetKey(const char* TextBegin, const char* TextEnd)
+{
+    // FNV-1a hash of the text, the font and the font size
+    size_t Hash = 2166136261u;
+
+    auto AddBytes = [&Hash](const void* pData, size_t Size) {
+        const auto* pBytes = static_cast<const unsigned char*>(pData);
+        for (size_t i = 0; i < Size; ++i)
+            Hash = (Hash ^ pBytes[i]) * 16777619u;
+    };
+
+    const ImFont* pFont    = GetFont();
+    const float   FontSize = GetFontSize();
+    AddBytes(TextBegin, static_cast<size_t>(TextEnd - TextBegin));
+    AddBytes(&pFont, sizeof(pFont));
+    AddBytes(&FontSize, sizeof(FontSize));
+    return Hash;
+}
+
+const TextRunCache::Run* TextRunCache::FindRun(size_t Key, const char* TextBegin, const char* TextEnd) const
+{
+    auto it = m_Runs.find(Key);
+    if (it == m_Runs.end())
+        return nullptr;
+
+    // Hash collisions are resolved by comparing the text
+    const auto& R = it->second;
+    if (R.pFont != GetFont() || R.FontSize != GetFontSize() ||
+        R.Text.size() != static_cast<size_t>(TextEnd - TextBegin) || memcmp(R.Text.data(), TextBegin, R.Text.size()) != 0)
+        return nullptr;
+
+    return &R;
+}
+
+void TextRunCache::NewFrame()
+{
+    ++m_FrameIndex;
+    for (auto it = m_Runs.begin(); it != m_Runs.end();)
+    {
+        if (m_FrameIndex - it->second.LastUsedFrame > m_MaxUnusedFrames)
+            it = m_Runs.erase(it);
+        else
+            ++it;
+    }
+}
+
+ImVec2 TextRunCache::CalcTextSize(const char* TextBegin, const char* TextEnd) const
+{
+    if (TextEnd == nullptr)
+        TextEnd = TextBegin + strlen(TextBegin);
+
+    if (const auto* pRun = FindRun(GetKey(TextBegin, TextEnd), TextBegin, TextEnd))
+        return ImVec2{pRun->Width, pRun->Height};
+
+    return ImGui::CalcTextSize(TextBegin, TextEnd);
+}
+
+void TextRunCache::AddText(ImDrawList* pDrawList, const ImVec2& Pos, unsigned int Color, const char* TextBegin, const char* TextEnd)
+{
+    if (TextEnd == nullptr)
+        TextEnd = TextBegin + strlen(TextBegin);
+    if (TextBegin == TextEnd || (Color & IM_COL32_A_MASK) == 0)
+        return;
+
+    // Glyph positions are rounded the same way by ImFont::RenderText
+    const ImVec2 Origin{IM_FLOOR(Pos.x), IM_FLOOR(Pos.y)};
+
+    const auto Key = GetKey(TextBegin, TextEnd);
+    if (const auto* pRun = FindRun(Key, TextBegin, TextEnd))
+    {
+        m_Runs[Key].LastUsedFrame = m_FrameIndex;
+
+        const int VtxCount = static_cast<int>(pRun->Vertices.size());
+        const int IdxCount = static_cast<int>(pRun->Indices.size());
+        if (VtxCount == 0)
+            return;
+
+        // PrimReserve may start a new draw command with a new vertex offset, so the base index is read after it
+        pDrawList->PrimReserve(IdxCount, VtxCount);
+
+        auto*      pVtx    = pDrawList->_VtxWritePtr;
+        auto*      pIdx    = pDrawList->_IdxWritePtr;
+        const auto BaseIdx = pDrawList->_VtxCurrentIdx;
+        for (int i = 0; i < VtxCount; ++i)
+        {
+            const auto& Src = pRun->Vertices[i];
+            pVtx[i].pos     = ImVec2{Origin.x + Src.x, Origin.y + Src.y};
+            pVtx[i].uv      = ImVec2{Src.u, Src.v};
+            pVtx[i].col     = Color;
+        }
+        for (int i = 0; i < IdxCount; ++i)
+            pIdx[i] = static_cast<ImDrawIdx>(BaseIdx + pRun->Indices[i]);
+
+        pDrawList->_VtxWritePtr += VtxCount;
+        pDrawList->_IdxWritePtr += IdxCount;
+        pDrawList->_VtxCurrentIdx += VtxCount;
+        return;
+    }
+
+    // Render the whole run without CPU clipping and capture the vertices it adds to the draw list
+    const auto VtxStart  = pDrawList->VtxBuffer.Size;
+    const auto IdxStart  = pDrawList->IdxBuffer.Size;
+    const auto BaseIdx   = pDrawList->_VtxCurrentIdx;
+    const auto VtxOffset = pDrawList->_CmdHeader.VtxOffset;
+
+    ImFont*     pFont    = GetFont();
+    const float FontSize = GetFontSize();
+    pFont->RenderText(pDrawList, FontSize, Origin, Color, ImVec4{-FLT_MAX, -FLT_MAX, FLT_MAX, FLT_MAX}, TextBegin, TextEnd, 0.0f, false);
+
+    // The run did not fit into the 16-bit index range of the current command and can't be replayed as one block
+    if (pDrawList->_CmdHeader.VtxOffset != VtxOffset)
+        return;
+
+    Run NewRun;
+    NewRun.Text.assign(TextBegin, TextEnd);
+    NewRun.pFont         = pFont;
+    NewRun.FontSize      = FontSize;
+    NewRun.LastUsedFrame = m_FrameIndex;
+
+    const auto Size = pFont->CalcTextSizeA(FontSize, FLT_MAX, 0.0f, TextBegin, TextEnd);
+    NewRun.Width    = Size.x;
+    NewRun.Height   = Size.y;
+
+    NewRun.Vertices.reserve(static_cast<size_t>(pDrawList->VtxBuffer.Size - VtxStart));
+    for (int i = VtxStart; i < pDrawList->VtxBuffer.Size; ++i)
+    {
+        const auto& Vtx = pDrawList->VtxBuffer[i];
+        NewRun.Vertices.push_back({Vtx.pos.x - Origin.x, Vtx.pos.y - Origin.y, Vtx.uv.x, Vtx.uv.y});
+    }
+    NewRun.Indices.reserve(static_cast<size_t>(pDrawList->IdxBuffer.Size - IdxStart));
+    for (int i = IdxStart; i < pDrawList->IdxBuffer.Size; ++i)
+        NewRun.Indices.push_back(pDrawList->IdxBuffer[i] - BaseIdx);
+
+    m_Runs[Key] = std::move(NewRun);
+}
+
+void TextUnformatted(TextRunCache& Cache, const char* text, const char* text_end)
+{
+    ImGuiWindow* window = GetCurrentWindow();
+    if (window->SkipItems)
+        return;
+
+    if (text_end == nullptr)
+        text_end = text + strlen(text);
+
+    // Mirrors the layout of ImGui::TextEx without wrapping
+    const ImVec2 text_pos{window->DC.CursorPos.x, window->DC.CursorPos.y + window->DC.CurrLineTextBaseOffset};
+    const ImVec2 text_size = Cache.CalcTextSize(text, text_end);
+
+    const ImRect bb{text_pos, ImVec2{text_pos.x + text_size.x, text_pos.y + text_size.y}};
+    ItemSize(text_size, 0.0f);
+    if (!ItemAdd(bb, 0))
+        return;
+
+    Cache.AddText(window->DrawList, text_pos, GetColorU32(ImGuiCol_Text), text, text_end);
+}
+
 } // namespace ImGui
@@ -29,6 +29,7 @@
 
 #include <android_native_app_glue.h>
 #include "AppBase.hpp"
+#include "ChoreographerFrameScheduler.hpp"
 
 #include "NDKHelper.h"
 
@@ -47,6 +48,8 @@ public:
     void           ProcessSensors(int32_t id);
     virtual void   DrawFrame();
     bool           IsReady();
+    int            GetPollTimeout();
+    bool           IsFrameDue();
     virtual void   TrimMemory()  = 0;
     virtual void   TermDisplay() = 0;
     static int32_t HandleInput(android_app* app, AInputEvent* event);
@@ -72,6 +75,13 @@ protected:
         //renderer_.Unload();
     }
 
+    /// Returns the time, in CLOCK_MONOTONIC nanoseconds, at which the current frame should be presented,
+    /// or zero if the frame is not scheduled on vsync, see ChoreographerFrameScheduler::GetDesiredPresentTime().
+    int64_t GetDesiredPresentTime() const
+    {
+        return frame_scheduler_ ? frame_scheduler_->GetDesiredPresentTime() : 0;
+    }
+
     ndk_helper::DoubletapDetector doubletap_detector_;
     ndk_helper::PinchDetector     pinch_detector_;
     ndk_helper::DragDetector      drag_detector_;
@@ -91,6 +101,9 @@ private:
     bool initialized_resources_ = false;
     bool has_focus_             = false;
 
+    // Null if AChoreographer is not available, in which case frames are drawn as fast as the looper is polled
+    std::unique_ptr<ChoreographerFrameScheduler> frame_scheduler_;
+
     ASensorManager*    sensor_manager_       = nullptr;
     const ASensor*     accelerometer_sensor_ = nullptr;
     ASensorEventQueue* sensor_event_queue_   = nullptr;
@@ -0,0 +1,128 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF ANY PROPRIETARY RIGHTS.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "BasicTypes.h"
+
+struct AChoreographer;
+
+namespace Diligent
+{
+
+/// Schedules the frames of the Android main loop on display vsync using AChoreographer.
+
+/// The scheduler follows the frame pacing model of the Android Frame Pacing library (Swappy):
+/// the frame is started at a vsync, and consecutive frames are separated by a whole number of
+/// refresh periods (the swap interval) that is chosen to match the target frame rate. E.g. a 60 fps
+/// target on a 120 Hz display draws every other vsync, which keeps the pacing stable and leaves
+/// thermal headroom. The vsync timestamp is used as the frame time, so the animation advances by
+/// exact multiples of the refresh period.
+///
+/// AChoreographer is only available starting with API level 24, so its entry points are loaded
+/// at run time. If they are not available, IsSupported() returns false. The scheduler must be
+/// created and used on a thread that has a looper, since the callbacks are dispatched by ALooper_pollAll().
+class ChoreographerFrameScheduler
+{
+public:
+    ChoreographerFrameScheduler();
+    ~ChoreographerFrameScheduler();
+
+    // clang-format off
+    ChoreographerFrameScheduler           (const ChoreographerFrameScheduler&)  = delete;
+    ChoreographerFrameScheduler           (      ChoreographerFrameScheduler&&) = delete;
+    ChoreographerFrameScheduler& operator=(const ChoreographerFrameScheduler&)  = delete;
+    ChoreographerFrameScheduler& operator=(      ChoreographerFrameScheduler&&) = delete;
+    // clang-format on
+
+    bool IsSupported() const { return m_pChoreographer != nullptr; }
+
+    /// Sets the target frame rate. Zero draws a frame at every vsync.
+    void SetTargetFrameRate(double FramesPerSecond);
+
+    /// Requests the frame callback for the next vsync, unless it has already been requested or a frame is due.
+    void RequestFrame();
+
+    /// Returns true if a vsync callback has arrived and the frame should be drawn.
+    bool IsFrameDue() const { return m_FrameDue; }
+
+    /// Starts a frame and returns the frame time and the time since the previous frame, in seconds.
+    /// If the frame is due, the time of its vsync is used, otherwise the current time.
+    void BeginFrame(double& CurrTime, double& ElapsedTime);
+
+    /// Returns the time, in CLOCK_MONOTONIC nanoseconds, at which the current frame should be presented,
+    /// i.e. the vsync that is one swap interval after the frame's vsync.
+
+    /// The value may be passed to eglPresentationTimeANDROID() or VK_GOOGLE_display_timing so that
+    /// the compositor does not display the frame early. Returns zero if there is no current frame.
+    int64_t GetDesiredPresentTime() const { return m_DesiredPresentTime; }
+
+    /// Returns the display refresh period, in nanoseconds.
+    int64_t GetRefreshPeriod() const { return m_RefreshPeriod; }
+
+private:
+    static void FrameCallback64(int64_t FrameTimeNanos, void* pData);
+    static void FrameCallback(long FrameTimeNanos, void* pData);
+    static void RefreshRateCallback(int64_t VsyncPeriodNanos, void* pData);
+
+    void OnVsync(int64_t FrameTimeNanos);
+    void PostFrameCallback();
+
+    Uint32 GetSwapInterval() const;
+
+    using GetInstanceProc                 = AChoreographer* (*)();
+    using FrameCallback64Type             = void (*)(int64_t, void*);
+    using FrameCallbackType               = void (*)(long, void*);
+    using RefreshRateCallbackType         = void (*)(int64_t, void*);
+    using PostFrameCallback64Proc         = void (*)(AChoreographer*, FrameCallback64Type, void*);
+    using PostFrameCallbackProc           = void (*)(AChoreographer*, FrameCallbackType, void*);
+    using RegisterRefreshRateCallbackProc = void (*)(AChoreographer*, RefreshRateCallbackType, void*);
+
+    void*           m_pLibAndroid    = nullptr;
+    AChoreographer* m_pChoreographer = nullptr;
+
+    PostFrameCallback64Proc         m_PostFrameCallback64           = nullptr;
+    PostFrameCallbackProc           m_PostFrameCallback             = nullptr;
+    RegisterRefreshRateCallbackProc m_UnregisterRefreshRateCallback = nullptr;
+
+    // Default to 60 Hz until the period is reported by the refresh rate callback or measured
+    int64_t m_RefreshPeriod         = 16666667;
+    bool    m_RefreshPeriodReported = false;
+
+    int64_t m_TargetFramePeriod  = 0;
+    int64_t m_LastVsyncTime      = 0;
+    int64_t m_LastFrameVsyncTime = 0;
+    int64_t m_FrameVsyncTime     = 0;
+    int64_t m_DesiredPresentTime = 0;
+    int64_t m_StartTime          = 0;
+    int64_t m_PrevFrameTime      = -1;
+
+    bool m_CallbackPending = false;
+    bool m_FrameDue        = false;
+};
+
+} // namespace Diligent
@@ -70,6 +70,8 @@ public:
         /// one frame, compares it with the golden image and exists.
         /// Zero exit code indicates that the frame is identical to the golden image.
         /// The non-zero code indicates the number of pixels that differ.
+        /// The golden image may be decoded while the frame renders with CreateImageFromFileAsync,
+        /// and compared with the captured frame by ComputeImageDifference (see TextureLoader).
         Compare,
 
         /// Compare the golden image as in Compare mode, and then update
@@ -77,6 +79,39 @@ public:
         CompareUpdate
     };
 
+    /// Main loop threading model
+    enum class ThreadingModel
+    {
+        /// OS events, Update(), Render() and Present() run serially on the main thread.
+        SingleThreaded = 0,
+
+        /// The main thread only pumps OS events. Update() runs on the update thread,
+        /// while Render() and Present() run on the render thread. The update thread may run
+        /// up to GetFramePipelineDepth() frames ahead of the render thread, so that the update
+        /// of frame N+1 overlaps the rendering of frame N.
+        ///
+        /// WindowResize() is called on the render thread between frames. Event handlers still
+        /// run on the main thread, and the application must synchronize the state they share
+        /// with Update().
+        Pipelined
+    };
+
+    /// Main loop behavior while the window is inactive (unfocused, minimized or occluded)
+    enum class IdlePolicy
+    {
+        /// Frames run at the full rate regardless of the window state.
+        None = 0,
+
+        /// While the window is inactive, frames run at GetIdleFrameRate(). While it is minimized
+        /// and the application has no pending work, the main loop blocks on the window system events.
+        Throttle,
+
+        /// While the window is inactive and the application has no pending work, the main loop blocks
+        /// on the window system events and runs one frame after they have been handled.
+        /// Otherwise, the main loop behaves as in Throttle mode.
+        WaitForEvents
+    };
+
     /// Command line processing result
     enum class CommandLineStatus
     {
@@ -104,6 +139,18 @@ public:
     virtual CommandLineStatus ProcessCommandLine(int argc, const char* const* argv) = 0;
 
 
+    /// Called by the framework after the command line has been processed, before the window and the device are created.
+
+    /// An application may start loading its assets on worker threads here: reading files, decoding
+    /// images, parsing models and render state notation files. The loading then overlaps window, device
+    /// and swap chain creation, and the application waits for it only when it creates the device objects.
+    /// The method must return quickly, and device objects can't be created until the device exists.
+    ///
+    /// \remarks The method is called by the Win32 and Linux main loops. The time spent in every start-up
+    ///          phase is logged when the first frame has been presented (see StartupTimer).
+    virtual void OnStartup() {}
+
+
     /// Returns the application tile.
 
     /// An application must override this method to define the application title.
@@ -155,6 +202,40 @@ public:
     }
 
 
+    /// Returns the number of windows the application renders to in addition to the main window.
+
+    /// Platform main loops that support multiple windows (currently, Win32) create the additional
+    /// windows after the main window and pass them to the platform-specific OnAdditionalWindowCreated
+    /// method, where the application creates a swap chain for each window with the same device.
+    /// All windows are driven by the same loop: Render() and Present() render and present every window,
+    /// see MultiWindowRenderer. Additional windows are not created by the pipelined threading model.
+    virtual Uint32 GetNumAdditionalWindows() const
+    {
+        return 0;
+    }
+
+    /// Returns the title of the additional window.
+    virtual const char* GetAdditionalWindowTitle(Uint32 WindowId) const
+    {
+        return GetAppTitle();
+    }
+
+    /// Called by the framework to request the desired initial size of the additional window.
+    virtual void GetDesiredAdditionalWindowSize(Uint32 WindowId, int& width, int& height)
+    {
+        GetDesiredInitialWindowSize(width, height);
+    }
+
+    /// Called when the additional window resizes.
+    virtual void AdditionalWindowResize(Uint32 WindowId, int width, int height) {}
+
+    /// Called before the additional window is destroyed when the user closes it.
+
+    /// The application must release the swap chain of the window. The main loop keeps running
+    /// until the main window is closed.
+    virtual void OnAdditionalWindowClosed(Uint32 WindowId) {}
+
+
     /// Returns the golden image mode, see Diligent::AppBase::GoldenImageMode.
     virtual GoldenImageMode GetGoldenImageMode() const
     {
@@ -162,6 +243,12 @@ public:
     }
 
 
+    /// Called before the first frame when the main loop runs in benchmark mode (see BenchmarkRunner).
+
+    /// An application should disable vertical synchronization and anything
+    /// else that depends on the wall clock or limits the frame rate.
+    virtual void OnBenchmarkMode() {}
+
     /// Returns the exit code.
 
     /// An application may override this method to
@@ -177,6 +264,88 @@ public:
         return false;
     }
 
+    /// Returns the frame rate the main loop is limited to. Zero means no limit.
+    virtual double GetTargetFrameRate() const
+    {
+        return 0;
+    }
+
+    /// Called by the main loop before the frame is updated.
+
+    /// An application that can query when the presentation engine is ready to accept
+    /// a new frame (e.g. through a frame latency waitable object or present wait)
+    /// should block here. Sampling the input right after this point reduces
+    /// the input-to-photon latency.
+    virtual void WaitForFrameLatency() {}
+
+    /// Returns the GPU time of the most recently resolved frame, in seconds, or a negative value if it is not available.
+
+    /// An application that measures its frames with timestamp queries should return the result here,
+    /// so that it is saved by the frame statistics recorder (see FrameStatsRecorder). Query results
+    /// are typically a few frames behind, and are recorded with the frame that reads them.
+    virtual double GetGPUFrameTime() const
+    {
+        return -1;
+    }
+
+    /// Returns the main loop threading model, see Diligent::AppBase::ThreadingModel.
+
+    /// The pipelined model requires a rendering backend whose immediate context
+    /// may be used from a thread other than the one that created the window, so
+    /// OpenGL applications must use the single-threaded model. The model is only
+    /// honored by the Win32 and Linux XCB main loops; other main loops are single-threaded.
+    virtual ThreadingModel GetThreadingModel() const
+    {
+        return ThreadingModel::SingleThreaded;
+    }
+
+    /// Returns how many frames the update thread may run ahead of the render thread (1 or 2).
+    virtual Uint32 GetFramePipelineDepth() const
+    {
+        return 1;
+    }
+
+    /// Called on the update thread after Update() has finished the frame.
+
+    /// In the pipelined threading model, up to GetFramePipelineDepth() + 1 frames may be in flight,
+    /// so an application keeps that many copies of the data produced by Update() and consumed
+    /// by Render(), and writes copy FrameIndex % (GetFramePipelineDepth() + 1).
+    /// \param [in] FrameIndex - Index of the frame, starting from zero.
+    virtual void OnFrameUpdated(Uint64 FrameIndex) {}
+
+    /// Called on the render thread before Render() with the index of the frame that is rendered.
+    virtual void OnBeginFrameRender(Uint64 FrameIndex) {}
+
+    /// Returns the main loop idle policy, see Diligent::AppBase::IdlePolicy.
+
+    /// The policy is only honored by the single-threaded main loops.
+    virtual IdlePolicy GetIdlePolicy() const
+    {
+        return IdlePolicy::None;
+    }
+
+    /// Returns the frame rate the main loop is throttled to while the window is inactive.
+
+    /// Zero stops the frames until the window becomes active or a window system event arrives.
+    virtual double GetIdleFrameRate() const
+    {
+        return 4;
+    }
+
+    /// Returns true if the application must keep rendering while the window is inactive,
+    /// e.g. because an animation is running or resources are being streamed.
+    virtual bool HasPendingWork() const
+    {
+        return false;
+    }
+
+    /// Returns true if the presentation engine reported that the window is occluded,
+    /// e.g. when IDXGISwapChain::Present() returned DXGI_STATUS_OCCLUDED.
+    virtual bool IsWindowOccluded() const
+    {
+        return false;
+    }
+
     /// Returns default hotkeys handling flags
     virtual HOT_KEY_FLAGS GetHotKeyFlags() const
     {
@@ -0,0 +1,187 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "AppBase.hpp"
+#include "FrameStatsRecorder.hpp"
+
+namespace Diligent
+{
+
+/// Runs an application for a fixed number of frames and reports the frame time statistics.
+
+/// Main loops create the runner from the command line:
+///
+///     --benchmark <N>            The number of measured frames.
+///     --benchmark_warmup <N>     The number of frames that are run before the measurement (10 by default).
+///     --benchmark_timestep <T>   The fixed time step, in seconds, passed to AppBase::Update() (1/60 by default).
+///
+/// Like the golden image mode, the benchmark runs in a window that is never shown, and the
+/// application is expected to disable vertical synchronization in AppBase::OnBenchmarkMode().
+/// At exit, a single line of JSON with the frame time statistics is written to the standard output:
+///
+///     {"benchmark":{"app":"...","frames":N,"min_ms":...,"avg_ms":...,"p50_ms":...,"p99_ms":...,"max_ms":...,"fps":...}}
+class BenchmarkRunner
+{
+public:
+    BenchmarkRunner(Uint32 NumFrames, Uint32 NumWarmupFrames, double TimeStep) :
+        m_NumFrames{NumFrames},
+        m_NumWarmupFrames{NumWarmupFrames},
+        m_TimeStep{TimeStep}
+    {}
+
+    /// Creates the runner if --benchmark is present in the command line, and returns null otherwise.
+    static std::unique_ptr<BenchmarkRunner> CreateFromCommandLine(int argc, const char* const* argv)
+    {
+        if (argc <= 0 || argv == nullptr)
+            return {};
+
+        CommandLineParser ArgsParser{argc, argv};
+
+        unsigned int NumFrames = 0;
+        if (!ArgsParser.Parse("benchmark", NumFrames, false) || NumFrames == 0)
+            return {};
+
+        unsigned int NumWarmupFrames = 10;
+        ArgsParser.Parse("benchmark_warmup", NumWarmupFrames, false);
+
+        double TimeStep = 1.0 / 60.0;
+        ArgsParser.Parse("benchmark_timestep", TimeStep, false);
+
+        return std::unique_ptr<BenchmarkRunner>{new BenchmarkRunner{NumFrames, NumWarmupFrames, TimeStep}};
+    }
+
+    /// Runs the benchmark and prints the summary.
+
+    /// PumpEvents is called before every frame to process the OS events and
+    /// must return false if the application has been requested to quit.
+    /// Returns false if the benchmark was interrupted.
+    template <typename PumpEventsType>
+    bool Run(AppBase& App, PumpEventsType&& PumpEvents, FrameStatsRecorder* pFrameStats = nullptr)
+    {
+        App.OnBenchmarkMode();
+
+        m_FrameTimes.clear();
+        m_FrameTimes.reserve(m_NumFrames);
+
+        const Uint32 TotalFrames = m_NumWarmupFrames + m_NumFrames;
+        for (Uint32 Frame = 0; Frame < TotalFrames; ++Frame)
+        {
+            if (!PumpEvents())
+            {
+                LOG_WARNING_MESSAGE("Benchmark was interrupted after ", Frame, " frames");
+                return false;
+            }
+
+            const auto FrameStart = Clock::now();
+            if (pFrameStats)
+                pFrameStats->BeginFrame();
+
+            {
+                FrameStatsRecorder::ScopedStage StageScope{pFrameStats, FrameStatsRecorder::Stage::Update};
+                App.Update(Frame * m_TimeStep, m_TimeStep);
+            }
+
+            {
+                FrameStatsRecorder::ScopedStage StageScope{pFrameStats, FrameStatsRecorder::Stage::Render};
+                App.Render();
+            }
+
+            {
+                FrameStatsRecorder::ScopedStage StageScope{pFrameStats, FrameStatsRecorder::Stage::Present};
+                App.Present();
+            }
+
+            if (pFrameStats)
+                pFrameStats->EndFrame(App.GetGPUFrameTime());
+
+            if (Frame >= m_NumWarmupFrames)
+                m_FrameTimes.push_back(std::chrono::duration<double>(Clock::now() - FrameStart).count());
+        }
+
+        std::cout << GetSummary(App.GetAppTitle()) << std::endl;
+        return true;
+    }
+
+    /// Returns the JSON summary of the measured frames.
+    std::string GetSummary(const char* AppTitle) const
+    {
+        std::vector<double> Sorted{m_FrameTimes};
+        std::sort(Sorted.begin(), Sorted.end());
+
+        auto Percentile = [&Sorted](double P) {
+            const auto Idx = static_cast<size_t>(P * static_cast<double>(Sorted.size() - 1) + 0.5);
+            return Sorted[Idx];
+        };
+
+        double Total = 0;
+        for (double Time : Sorted)
+            Total += Time;
+
+        std::stringstream SummarySS;
+        SummarySS << "{\"benchmark\":{\"app\":\"";
+        for (const char* c = AppTitle; c != nullptr && *c != '\0'; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+                SummarySS << '\\';
+            SummarySS << *c;
+        }
+        SummarySS << "\",\"frames\":" << Sorted.size();
+        if (!Sorted.empty())
+        {
+            const double Avg = Total / static_cast<double>(Sorted.size());
+            SummarySS << std::fixed << std::setprecision(4)
+                      << ",\"min_ms\":" << Sorted.front() * 1000
+                      << ",\"avg_ms\":" << Avg * 1000
+                      << ",\"p50_ms\":" << Percentile(0.5) * 1000
+                      << ",\"p99_ms\":" << Percentile(0.99) * 1000
+                      << ",\"max_ms\":" << Sorted.back() * 1000
+                      << ",\"fps\":" << 1.0 / Avg;
+        }
+        SummarySS << "}}";
+        return SummarySS.str();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    const Uint32        m_NumFrames;
+    const Uint32        m_NumWarmupFrames;
+    const double        m_TimeStep;
+    std::vector<double> m_FrameTimes;
+};
+
+} // namespace Diligent
@@ -35,6 +35,10 @@ namespace Diligent
 {
 
 /// Base class for Emscripten applications.
+
+/// When the project is built with DILIGENT_EMSCRIPTEN_WORKER_RENDERING, the canvas is transferred
+/// to a worker thread as an OffscreenCanvas. OnWindowCreated(), the event handlers, Update() and Render()
+/// are all called on that thread, and the events are delivered before the frame that follows them.
 class EmscriptenAppBase : public AppBase
 {
 public:
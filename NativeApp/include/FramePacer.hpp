@@ -0,0 +1,156 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Paces the frames of the native application main loops.
+
+/// The pacer limits the frame rate to the target set by SetTargetFrameRate() and
+/// smooths the frame time that is passed to AppBase::Update(). Waiting is done by
+/// sleeping until the expected sleep overshoot exceeds the remaining time, and
+/// then spinning until the deadline. The overshoot is estimated from the sleeps
+/// observed so far, so the wait is precise regardless of the OS timer resolution.
+class FramePacer
+{
+public:
+    FramePacer() :
+        m_StartTime{Clock::now()},
+        m_PrevTime{m_StartTime},
+        m_NextFrameTime{m_StartTime}
+    {}
+
+    /// Sets the target frame rate. Zero disables the limiter.
+    void SetTargetFrameRate(double FramesPerSecond)
+    {
+        const auto Interval = FramesPerSecond > 0 ? std::chrono::duration<double>{1.0 / FramesPerSecond} : std::chrono::duration<double>{0};
+        m_FrameInterval     = std::chrono::duration_cast<Clock::duration>(Interval);
+        m_NextFrameTime     = Clock::now();
+    }
+
+    /// Waits until the next frame is due. Returns immediately if the limiter is disabled.
+    void WaitForNextFrame()
+    {
+        if (m_FrameInterval == Clock::duration::zero())
+            return;
+
+        const auto Deadline = m_NextFrameTime + m_FrameInterval;
+        PreciseWaitUntil(Deadline);
+
+        // If we fell behind by more than a frame, do not try to catch up
+        const auto Now  = Clock::now();
+        m_NextFrameTime = Now - Deadline > m_FrameInterval ? Now : Deadline;
+    }
+
+    /// Starts a new frame and returns the time since the pacer was created and
+    /// the smoothed time since the previous frame, in seconds.
+    void BeginFrame(double& CurrTime, double& ElapsedTime)
+    {
+        const auto Now = Clock::now();
+        CurrTime       = std::chrono::duration<double>(Now - m_StartTime).count();
+
+        // Clamp the spikes caused by e.g. window dragging or breakpoints
+        const double Delta    = std::chrono::duration<double>(Now - m_PrevTime).count();
+        const double RawDelta = Delta < MaxFrameTime ? Delta : MaxFrameTime;
+        m_PrevTime            = Now;
+
+        m_RawFrameTime = RawDelta;
+        if (m_SmoothedFrameTime <= 0)
+            m_SmoothedFrameTime = RawDelta;
+        else
+            m_SmoothedFrameTime += (RawDelta - m_SmoothedFrameTime) * SmoothingFactor;
+
+        ElapsedTime = m_SmoothedFrameTime;
+    }
+
+    /// Returns the unfiltered duration of the last frame, in seconds.
+    double GetRawFrameTime() const
+    {
+        return m_RawFrameTime;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void PreciseWaitUntil(Clock::time_point Deadline)
+    {
+        for (auto Now = Clock::now(); Now < Deadline; Now = Clock::now())
+        {
+            const double Remaining = std::chrono::duration<double>(Deadline - Now).count();
+            if (Remaining <= m_SleepEstimate)
+                break;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+            // Running mean and variance of the sleep duration (Welford's algorithm)
+            const double Observed = std::chrono::duration<double>(Clock::now() - Now).count();
+            ++m_SleepCount;
+            const double Delta = Observed - m_SleepMean;
+            m_SleepMean += Delta / static_cast<double>(m_SleepCount);
+            m_SleepM2 += Delta * (Observed - m_SleepMean);
+            const double StdDev = m_SleepCount > 1 ? std::sqrt(m_SleepM2 / static_cast<double>(m_SleepCount - 1)) : 0;
+            m_SleepEstimate     = m_SleepMean + StdDev;
+
+            // Let the estimate adapt if the timer resolution changes
+            if (m_SleepCount > MaxSleepSamples)
+            {
+                m_SleepCount = 1;
+                m_SleepM2    = 0;
+            }
+        }
+
+        while (Clock::now() < Deadline)
+            std::this_thread::yield();
+    }
+
+    static constexpr double SmoothingFactor = 0.1;
+    static constexpr double MaxFrameTime    = 0.1;
+    static constexpr Uint64 MaxSleepSamples = 1000;
+
+    const Clock::time_point m_StartTime;
+    Clock::time_point       m_PrevTime;
+    Clock::time_point       m_NextFrameTime;
+    Clock::duration         m_FrameInterval{0};
+
+    double m_RawFrameTime      = 0;
+    double m_SmoothedFrameTime = 0;
+
+    double m_SleepEstimate = 0.005;
+    double m_SleepMean     = 0.005;
+    double m_SleepM2       = 0;
+    Uint64 m_SleepCount    = 1;
+};
+
+} // namespace Diligent
@@ -0,0 +1,200 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "AppBase.hpp"
+#include "FramePacer.hpp"
+#include "ToolsTrace.hpp"
+
+namespace Diligent
+{
+
+/// Runs the update and render stages of AppBase::ThreadingModel::Pipelined on dedicated threads.
+
+/// Platform main loops create the pipeline once the application is ready and keep pumping
+/// OS events on the main thread. The pipeline must be stopped before the window is destroyed.
+class FramePipeline
+{
+public:
+    explicit FramePipeline(AppBase& App) :
+        m_App{App},
+        m_Depth{std::min(std::max(App.GetFramePipelineDepth(), Uint32{1}), Uint32{2})}
+    {
+        m_UpdateThread = std::thread{&FramePipeline::UpdateThreadProc, this};
+        m_RenderThread = std::thread{&FramePipeline::RenderThreadProc, this};
+    }
+
+    ~FramePipeline()
+    {
+        Stop();
+    }
+
+    // clang-format off
+    FramePipeline           (const FramePipeline&)  = delete;
+    FramePipeline           (      FramePipeline&&) = delete;
+    FramePipeline& operator=(const FramePipeline&)  = delete;
+    FramePipeline& operator=(      FramePipeline&&) = delete;
+    // clang-format on
+
+    /// Requests the render thread to call AppBase::WindowResize() before the next frame.
+    void RequestResize(int Width, int Height)
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_ResizePending = true;
+        m_NewWidth      = Width;
+        m_NewHeight     = Height;
+    }
+
+    /// Waits for the frames in flight and joins the threads.
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+            m_Stop = true;
+        }
+        m_CV.notify_all();
+        if (m_UpdateThread.joinable())
+            m_UpdateThread.join();
+        if (m_RenderThread.joinable())
+            m_RenderThread.join();
+    }
+
+    /// Returns the time between the two last rendered frames, in seconds.
+    double GetFrameTime() const
+    {
+        return m_FrameTime.load(std::memory_order_relaxed);
+    }
+
+private:
+    using Clock = std::chrono::high_resolution_clock;
+
+    void UpdateThreadProc()
+    {
+        FramePacer Pacer;
+        Pacer.SetTargetFrameRate(m_App.GetTargetFrameRate());
+        for (Uint64 Frame = 0;; ++Frame)
+        {
+            {
+                // Do not run more than m_Depth frames ahead of the render thread
+                std::unique_lock<std::mutex> Lock{m_Mtx};
+                m_CV.wait(Lock, [&]() { return m_Stop || Frame - m_RenderedFrames <= m_Depth; });
+                if (m_Stop)
+                    break;
+            }
+
+            Pacer.WaitForNextFrame();
+            m_App.WaitForFrameLatency();
+
+            {
+                DILIGENT_TRACE_ZONE("NativeApp::Update");
+
+                double CurrTime    = 0;
+                double ElapsedTime = 0;
+                Pacer.BeginFrame(CurrTime, ElapsedTime);
+                m_App.Update(CurrTime, ElapsedTime);
+                m_App.OnFrameUpdated(Frame);
+            }
+
+            {
+                std::lock_guard<std::mutex> Lock{m_Mtx};
+                m_UpdatedFrames = Frame + 1;
+            }
+            m_CV.notify_all();
+        }
+    }
+
+    void RenderThreadProc()
+    {
+        auto PrevTime = Clock::now();
+        for (Uint64 Frame = 0;; ++Frame)
+        {
+            bool Resize = false;
+            int  Width  = 0;
+            int  Height = 0;
+            {
+                std::unique_lock<std::mutex> Lock{m_Mtx};
+                m_CV.wait(Lock, [&]() { return m_Stop || m_UpdatedFrames > Frame; });
+                if (m_Stop)
+                    break;
+
+                std::swap(Resize, m_ResizePending);
+                Width  = m_NewWidth;
+                Height = m_NewHeight;
+            }
+
+            if (Resize)
+                m_App.WindowResize(Width, Height);
+
+            m_App.OnBeginFrameRender(Frame);
+            {
+                DILIGENT_TRACE_ZONE("NativeApp::Render");
+                m_App.Render();
+            }
+            {
+                DILIGENT_TRACE_ZONE("NativeApp::Present");
+                m_App.Present();
+            }
+
+            const auto CurrTime = Clock::now();
+            m_FrameTime.store(std::chrono::duration<double>(CurrTime - PrevTime).count(), std::memory_order_relaxed);
+            PrevTime = CurrTime;
+
+            {
+                std::lock_guard<std::mutex> Lock{m_Mtx};
+                m_RenderedFrames = Frame + 1;
+            }
+            m_CV.notify_all();
+        }
+    }
+
+    AppBase&     m_App;
+    const Uint32 m_Depth;
+
+    std::mutex              m_Mtx;
+    std::condition_variable m_CV;
+    Uint64                  m_UpdatedFrames  = 0;
+    Uint64                  m_RenderedFrames = 0;
+    bool                    m_Stop           = false;
+    bool                    m_ResizePending  = false;
+    int                     m_NewWidth       = 0;
+    int                     m_NewHeight      = 0;
+
+    std::atomic<double> m_FrameTime{0};
+
+    std::thread m_UpdateThread;
+    std::thread m_RenderThread;
+};
+
+} // namespace Diligent
@@ -0,0 +1,310 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BasicTypes.h"
+#include "Errors.hpp"
+#include "CommandLineParser.hpp"
+#include "ToolsTrace.hpp"
+
+namespace Diligent
+{
+
+/// Records per-frame CPU stage timings and GPU frame times into a ring buffer
+/// and saves them as CSV or Chrome trace JSON.
+
+/// Main loops create the recorder from the command line:
+///
+///     --frame_stats <path>         Output file. Chrome trace JSON if the path ends with .json, CSV otherwise.
+///     --frame_stats_frames <N>     Exit after N frames have been recorded (0 - run until the app is closed).
+///     --frame_stats_capacity <N>   The number of most recent frames that are kept (16384 by default).
+///
+/// The recorder is not thread-safe and is only used by the single-threaded main loops.
+class FrameStatsRecorder
+{
+public:
+    enum class Stage : Uint32
+    {
+        Update = 0,
+        Render,
+        Present,
+        Count
+    };
+
+    struct FrameStats
+    {
+        Uint64 FrameIndex = 0;
+
+        // Seconds from the start of the capture
+        double StartTime = 0;
+
+        // Seconds between the start of this frame and the start of the previous one
+        double FrameTime = 0;
+
+        // Seconds from the frame start to the stage start, and stage durations in seconds
+        double StageStart[static_cast<size_t>(Stage::Count)]    = {};
+        double StageDuration[static_cast<size_t>(Stage::Count)] = {};
+
+        // GPU frame time in seconds reported by AppBase::GetGPUFrameTime(), or negative if not available
+        double GPUTime = -1;
+    };
+
+    FrameStatsRecorder(std::string OutputPath, Uint32 Capacity, Uint32 MaxFrames) :
+        m_OutputPath{std::move(OutputPath)},
+        m_MaxFrames{MaxFrames},
+        m_Frames(Capacity > 0 ? Capacity : 1),
+        m_StartTime{Clock::now()}
+    {}
+
+    /// Creates the recorder if --frame_stats is present in the command line, and returns null otherwise.
+    static std::unique_ptr<FrameStatsRecorder> CreateFromCommandLine(int argc, const char* const* argv)
+    {
+        if (argc <= 0 || argv == nullptr)
+            return {};
+
+        CommandLineParser ArgsParser{argc, argv};
+
+        std::string Path;
+        if (!ArgsParser.Parse("frame_stats", Path, false) || Path.empty())
+            return {};
+
+        unsigned int MaxFrames = 0;
+        ArgsParser.Parse("frame_stats_frames", MaxFrames, false);
+
+        unsigned int Capacity = 16384;
+        ArgsParser.Parse("frame_stats_capacity", Capacity, false);
+
+        return std::unique_ptr<FrameStatsRecorder>{new FrameStatsRecorder{std::move(Path), Capacity, MaxFrames}};
+    }
+
+    void BeginFrame()
+    {
+        const double Now = GetTime();
+
+        auto& Frame      = m_Frames[m_NumFrames % m_Frames.size()];
+        Frame            = FrameStats{};
+        Frame.FrameIndex = m_NumFrames;
+        Frame.StartTime  = Now;
+        Frame.FrameTime  = m_NumFrames > 0 ? Now - m_PrevFrameStart : 0;
+        m_PrevFrameStart = Now;
+    }
+
+    void BeginStage(Stage S)
+    {
+        auto& Frame = GetCurrentFrame();
+
+        Frame.StageStart[static_cast<size_t>(S)] = GetTime() - Frame.StartTime;
+    }
+
+    void EndStage(Stage S)
+    {
+        auto&        Frame = GetCurrentFrame();
+        const size_t Idx   = static_cast<size_t>(S);
+
+        Frame.StageDuration[Idx] = GetTime() - Frame.StartTime - Frame.StageStart[Idx];
+    }
+
+    /// Finishes the frame. GPUTime is the value returned by AppBase::GetGPUFrameTime().
+    void EndFrame(double GPUTime)
+    {
+        GetCurrentFrame().GPUTime = GPUTime;
+        ++m_NumFrames;
+    }
+
+    /// Returns true when the number of frames requested by --frame_stats_frames has been recorded.
+    bool IsCaptureComplete() const
+    {
+        return m_MaxFrames > 0 && m_NumFrames >= m_MaxFrames;
+    }
+
+    /// Writes the recorded frames to the output file.
+    bool Save() const
+    {
+        std::ofstream Stream{m_OutputPath};
+        if (!Stream)
+        {
+            LOG_ERROR_MESSAGE("Failed to open '", m_OutputPath, "' to write frame statistics");
+            return false;
+        }
+
+        const bool IsJson = m_OutputPath.size() >= 5 && m_OutputPath.compare(m_OutputPath.size() - 5, 5, ".json") == 0;
+        if (IsJson)
+            WriteChromeTrace(Stream);
+        else
+            WriteCSV(Stream);
+
+        if (!Stream)
+        {
+            LOG_ERROR_MESSAGE("Failed to write frame statistics to '", m_OutputPath, "'");
+            return false;
+        }
+
+        LOG_INFO_MESSAGE("Saved statistics of ", GetNumStoredFrames(), " frames to '", m_OutputPath, "'");
+        return true;
+    }
+
+    /// Writes the frames as CSV. All times are in milliseconds.
+    void WriteCSV(std::ostream& Stream) const
+    {
+        Stream << "frame,start_ms,frame_ms,update_ms,render_ms,present_ms,gpu_ms\n";
+        Stream << std::fixed << std::setprecision(4);
+        ForEachFrame([&](const FrameStats& Frame) {
+            Stream << Frame.FrameIndex << ','
+                   << Frame.StartTime * 1000 << ','
+                   << Frame.FrameTime * 1000;
+            for (double Duration : Frame.StageDuration)
+                Stream << ',' << Duration * 1000;
+            Stream << ',';
+            if (Frame.GPUTime >= 0)
+                Stream << Frame.GPUTime * 1000;
+            Stream << '\n';
+        });
+    }
+
+    /// Writes the frames in the Chrome trace event format (chrome://tracing, Perfetto).
+
+    /// CPU stages are complete events on thread 1. The GPU does not report when the frame
+    /// started executing, so GPU frames are placed at the start of the Render stage on thread 2.
+    void WriteChromeTrace(std::ostream& Stream) const
+    {
+        static constexpr const char* StageNames[] = {"Update", "Render", "Present"};
+        static_assert(sizeof(StageNames) / sizeof(StageNames[0]) == static_cast<size_t>(Stage::Count), "Please update the stage names");
+
+        Stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        Stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n";
+        Stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+        Stream << std::fixed << std::setprecision(3);
+
+        auto WriteEvent = [&](const char* Name, Uint32 Tid, double Start, double Duration, Uint64 FrameIndex) {
+            Stream << ",\n{\"name\":\"" << Name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << Tid
+                   << ",\"ts\":" << Start * 1e+6 << ",\"dur\":" << Duration * 1e+6
+                   << ",\"args\":{\"frame\":" << FrameIndex << "}}";
+        };
+        ForEachFrame([&](const FrameStats& Frame) {
+            for (size_t s = 0; s < static_cast<size_t>(Stage::Count); ++s)
+                WriteEvent(StageNames[s], 1, Frame.StartTime + Frame.StageStart[s], Frame.StageDuration[s], Frame.FrameIndex);
+
+            if (Frame.GPUTime >= 0)
+                WriteEvent("GPU Frame", 2, Frame.StartTime + Frame.StageStart[static_cast<size_t>(Stage::Render)], Frame.GPUTime, Frame.FrameIndex);
+        });
+        Stream << "\n]}\n";
+    }
+
+    /// Records the stage for the lifetime of the object. The recorder may be null.
+
+    /// When tools tracing is enabled, the stage is also reported as a trace zone,
+    /// even if the recorder is null.
+    class ScopedStage
+    {
+    public:
+        ScopedStage(FrameStatsRecorder* pRecorder, Stage S) :
+            m_pRecorder{pRecorder},
+            m_Stage{S}
+#if DILIGENT_TOOLS_TRACE
+            ,
+            m_TraceZone{GetTraceZoneName(S)}
+#endif
+        {
+            if (m_pRecorder != nullptr)
+                m_pRecorder->BeginStage(m_Stage);
+        }
+
+        ~ScopedStage()
+        {
+            if (m_pRecorder != nullptr)
+                m_pRecorder->EndStage(m_Stage);
+        }
+
+        // clang-format off
+        ScopedStage           (const ScopedStage&) = delete;
+        ScopedStage& operator=(const ScopedStage&) = delete;
+        // clang-format on
+
+    private:
+#if DILIGENT_TOOLS_TRACE
+        static const char* GetTraceZoneName(Stage S)
+        {
+            switch (S)
+            {
+                case Stage::Update: return "NativeApp::Update";
+                case Stage::Render: return "NativeApp::Render";
+                case Stage::Present: return "NativeApp::Present";
+                default: return "NativeApp::Unknown";
+            }
+        }
+#endif
+
+        FrameStatsRecorder* const m_pRecorder;
+        const Stage               m_Stage;
+#if DILIGENT_TOOLS_TRACE
+        ToolsTraceZone m_TraceZone;
+#endif
+    };
+
+    Uint64 GetNumStoredFrames() const
+    {
+        return std::min(m_NumFrames, static_cast<Uint64>(m_Frames.size()));
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    double GetTime() const
+    {
+        return std::chrono::duration<double>(Clock::now() - m_StartTime).count();
+    }
+
+    FrameStats& GetCurrentFrame()
+    {
+        return m_Frames[m_NumFrames % m_Frames.size()];
+    }
+
+    template <typename HandlerType>
+    void ForEachFrame(HandlerType&& Handler) const
+    {
+        for (Uint64 i = m_NumFrames - GetNumStoredFrames(); i < m_NumFrames; ++i)
+            Handler(m_Frames[i % m_Frames.size()]);
+    }
+
+    const std::string       m_OutputPath;
+    const Uint32            m_MaxFrames;
+    std::vector<FrameStats> m_Frames;
+    const Clock::time_point m_StartTime;
+    Uint64                  m_NumFrames      = 0;
+    double                  m_PrevFrameStart = 0;
+};
+
+} // namespace Diligent
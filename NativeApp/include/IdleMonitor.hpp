@@ -0,0 +1,142 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cmath>
+
+#include "AppBase.hpp"
+
+namespace Diligent
+{
+
+/// Decides whether the main loop runs a frame according to AppBase::GetIdlePolicy().
+
+/// The main loop reports the window state and the window system events, and calls
+/// ShouldRunFrame() before every frame. If it returns false, the main loop blocks on
+/// the window system events for at most GetEventWaitTimeout() milliseconds instead of
+/// running the frame.
+class IdleMonitor
+{
+public:
+    explicit IdleMonitor(const AppBase& App) :
+        m_App{App},
+        m_Policy{App.GetIdlePolicy()},
+        m_LastFrameTime{Clock::now()}
+    {}
+
+    void SetFocused(bool Focused) { m_Focused = Focused; }
+    void SetMinimized(bool Minimized) { m_Minimized = Minimized; }
+    void SetOccluded(bool Occluded) { m_Occluded = Occluded; }
+
+    /// Must be called when the main loop has handled window system events other than the presentation feedback.
+    void OnEventsReceived() { m_EventsReceived = true; }
+
+    /// Returns true if the window is focused, visible and not minimized.
+    bool IsWindowActive() const
+    {
+        return m_Focused && !m_Minimized && !m_Occluded && !m_App.IsWindowOccluded();
+    }
+
+    /// Returns true if the main loop should run the frame now.
+    bool ShouldRunFrame() const
+    {
+        switch (GetMode())
+        {
+            case Mode::Active:
+                return true;
+
+            case Mode::Throttled:
+                return Clock::now() >= GetNextThrottledFrameTime();
+
+            case Mode::Waiting:
+                return m_EventsReceived;
+
+            default:
+                return true;
+        }
+    }
+
+    /// Returns the time in milliseconds the main loop should wait for the window system events
+    /// when ShouldRunFrame() returned false. A negative value means no time limit.
+    int GetEventWaitTimeout() const
+    {
+        if (GetMode() != Mode::Throttled)
+            return -1;
+
+        const double Remaining = std::chrono::duration<double, std::milli>(GetNextThrottledFrameTime() - Clock::now()).count();
+        return Remaining > 0 ? static_cast<int>(std::ceil(Remaining)) : 0;
+    }
+
+    /// Must be called when the main loop starts a frame.
+    void OnFrameStarted()
+    {
+        m_LastFrameTime  = Clock::now();
+        m_EventsReceived = false;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Mode
+    {
+        Active,
+        Throttled,
+        Waiting
+    };
+
+    Mode GetMode() const
+    {
+        if (m_Policy == AppBase::IdlePolicy::None || IsWindowActive())
+            return Mode::Active;
+
+        // Rendering a minimized window is wasted unless the application has work to finish
+        const bool HasWork = m_App.HasPendingWork();
+        if (!HasWork && (m_Policy == AppBase::IdlePolicy::WaitForEvents || m_Minimized))
+            return Mode::Waiting;
+
+        return m_App.GetIdleFrameRate() > 0 ? Mode::Throttled : Mode::Waiting;
+    }
+
+    Clock::time_point GetNextThrottledFrameTime() const
+    {
+        const std::chrono::duration<double> Interval{1.0 / m_App.GetIdleFrameRate()};
+        return m_LastFrameTime + std::chrono::duration_cast<Clock::duration>(Interval);
+    }
+
+    const AppBase&            m_App;
+    const AppBase::IdlePolicy m_Policy;
+    Clock::time_point         m_LastFrameTime;
+
+    bool m_Focused        = true;
+    bool m_Minimized      = false;
+    bool m_Occluded       = false;
+    bool m_EventsReceived = false;
+};
+
+} // namespace Diligent
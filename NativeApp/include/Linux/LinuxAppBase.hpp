@@ -49,6 +49,11 @@
 
 #include "AppBase.hpp"
 
+#if WAYLAND_SUPPORTED
+struct wl_display;
+struct wl_surface;
+#endif
+
 namespace Diligent
 {
 
@@ -56,6 +61,14 @@ namespace Diligent
 class LinuxAppBase : public AppBase
 {
 public:
+    /// Pointer position reported by a motion event
+    struct PointerMotionSample
+    {
+        int    X    = 0;
+        int    Y    = 0;
+        Uint32 Time = 0; ///< X server time stamp, in milliseconds
+    };
+
     /// Called when GL context is initialized
 
     /// An application must override this method to perform required
@@ -72,6 +85,16 @@ public:
     /// \param [in] xev - XLib event
     virtual int HandleXEvent(XEvent* xev) { return 0; }
 
+    /// Receives all pointer motion events of the frame.
+
+    /// The main loop coalesces the motion events that arrive between two frames:
+    /// only the last event of every run of consecutive motion events is passed to
+    /// HandleXEvent(), HandleXCBEvent() or OnWaylandPointerMotion(), so that the per-frame cost of input handling
+    /// does not grow with the mouse polling rate. Applications that need every sample
+    /// (e.g. for drawing or gesture recognition) may override this method, which is called
+    /// once per frame, before the frame is updated, with the samples in arrival order.
+    virtual void OnPointerMotionBatch(const PointerMotionSample* pSamples, size_t NumSamples) {}
+
 #if VULKAN_SUPPORTED
     /// Called by the framework to initialize Vulkan.
 
@@ -87,6 +110,64 @@ public:
     /// \param [in] event - XCB event
     virtual void HandleXCBEvent(xcb_generic_event_t* event) {}
 #endif
+
+#if WAYLAND_SUPPORTED
+    /// Returns true if the application can run on the native Wayland backend.
+
+    /// On a Wayland session, the Vulkan main loop creates a native Wayland window
+    /// for applications that return true, and uses XCB (through Xwayland) otherwise.
+    /// The backend can be disabled with the --wayland false command line option.
+    virtual bool IsWaylandSupported() const { return false; }
+
+    /// Called by the framework to initialize Vulkan with a Wayland surface.
+
+    /// \param [in] display - Wayland display.
+    /// \param [in] surface - Wayland surface of the window.
+    /// 
+eturn     true if the initialization was successful and false otherwise
+    virtual bool InitVulkan(wl_display* display, wl_surface* surface) { return false; }
+
+    /// Presentation feedback of a frame, see the wp_presentation protocol.
+    struct PresentationFeedback
+    {
+        /// Index of the frame the feedback was requested for
+        Uint64 FrameIndex = 0;
+
+        /// False if the frame was never shown, e.g. because it was replaced by a newer one
+        bool Presented = false;
+
+        /// The time the frame turned into light, in nanoseconds of the compositor clock
+        Uint64 PresentationTime = 0;
+
+        /// Refresh period of the output, in nanoseconds, or zero if unknown
+        Uint32 RefreshPeriod = 0;
+
+        /// The buffer was scanned out directly, without a compositor copy
+        bool ZeroCopy = false;
+
+        /// The presentation was synchronized to the vertical retrace
+        bool VSync = false;
+    };
+
+    /// Called once the compositor reports when a frame has been shown.
+    virtual void OnPresentationFeedback(const PresentationFeedback& Feedback) {}
+
+    /// Called when the preferred scale of the surface changes.
+
+    /// The framebuffer size passed to WindowResize() is the logical window size multiplied
+    /// by the scale, so the application only needs the scale to size the UI.
+    /// \param [in] Scale - Ratio between framebuffer pixels and surface-local units, e.g. 1.25.
+    virtual void OnWaylandScaleChanged(float Scale) {}
+
+    /// Wayland input events. Pointer coordinates are in surface-local units,
+    /// buttons are Linux input event codes and keys are XKB key symbols.
+    virtual void OnWaylandPointerMotion(double X, double Y) {}
+    virtual void OnWaylandPointerButton(Uint32 Button, bool IsPressed) {}
+    virtual void OnWaylandPointerAxis(float Vertical, float Horizontal) {}
+    virtual void OnWaylandKey(Uint32 KeySym, bool IsPressed) {}
+    virtual void OnWaylandModifiers(bool Ctrl, bool Shift, bool Alt, bool Super) {}
+    virtual void OnWaylandText(const char* UTF8) {}
+#endif
 };
 
 } // namespace Diligent
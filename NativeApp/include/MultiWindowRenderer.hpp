@@ -0,0 +1,216 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Records the frames of several windows in parallel and presents them together.
+
+/// Every window registers a record callback that renders the window, typically into its own
+/// deferred context, and a present callback that presents its swap chain. RenderAll() runs the
+/// record callbacks on the worker threads and the calling thread, then calls the submit callback
+/// (e.g. to execute the command lists on the immediate context) and presents all windows.
+/// Windows must only be added and removed by the thread that calls RenderAll().
+class MultiWindowRenderer
+{
+public:
+    using RecordCallbackType  = std::function<void()>;
+    using PresentCallbackType = std::function<void()>;
+
+    /// Creates the renderer with the given number of worker threads.
+
+    /// By default, one worker thread is created per hardware thread, excluding the calling thread,
+    /// up to 7 threads.
+    explicit MultiWindowRenderer(Uint32 NumWorkerThreads = ~Uint32{0})
+    {
+        if (NumWorkerThreads == ~Uint32{0})
+        {
+            const auto NumCores = std::thread::hardware_concurrency();
+            NumWorkerThreads    = std::min(NumCores > 1 ? NumCores - 1 : 0u, 7u);
+        }
+        m_Workers.reserve(NumWorkerThreads);
+        for (Uint32 i = 0; i < NumWorkerThreads; ++i)
+            m_Workers.emplace_back(&MultiWindowRenderer::WorkerThreadProc, this);
+    }
+
+    ~MultiWindowRenderer()
+    {
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+            m_Stop = true;
+        }
+        m_WorkCV.notify_all();
+        for (auto& Worker : m_Workers)
+            Worker.join();
+    }
+
+    // clang-format off
+    MultiWindowRenderer           (const MultiWindowRenderer&)  = delete;
+    MultiWindowRenderer           (      MultiWindowRenderer&&) = delete;
+    MultiWindowRenderer& operator=(const MultiWindowRenderer&)  = delete;
+    MultiWindowRenderer& operator=(      MultiWindowRenderer&&) = delete;
+    // clang-format on
+
+    /// Adds the window or replaces the callbacks of the window with the same id.
+    void AddWindow(Uint32 WindowId, RecordCallbackType Record, PresentCallbackType Present)
+    {
+        auto It = FindWindow(WindowId);
+        if (It == m_Windows.end())
+            It = m_Windows.insert(It, WindowInfo{WindowId});
+        It->Record  = std::move(Record);
+        It->Present = std::move(Present);
+    }
+
+    /// Removes the window, e.g. when it has been closed.
+    void RemoveWindow(Uint32 WindowId)
+    {
+        auto It = FindWindow(WindowId);
+        if (It != m_Windows.end())
+            m_Windows.erase(It);
+    }
+
+    /// Records all windows in parallel, calls Submit on the calling thread and presents the windows
+    /// in the order they were added.
+    void RenderAll(const std::function<void()>& Submit = nullptr)
+    {
+        if (m_Workers.empty() || m_Windows.size() < 2)
+        {
+            for (auto& Wnd : m_Windows)
+            {
+                if (Wnd.Record)
+                    Wnd.Record();
+            }
+        }
+        else
+        {
+            {
+                std::lock_guard<std::mutex> Lock{m_Mtx};
+                m_NextWindow.store(0);
+                m_NumRecorded = 0;
+                ++m_Generation;
+            }
+            m_WorkCV.notify_all();
+
+            RecordWindows();
+
+            std::unique_lock<std::mutex> Lock{m_Mtx};
+            m_DoneCV.wait(Lock, [this]() { return m_NumRecorded == m_Windows.size(); });
+        }
+
+        if (Submit)
+            Submit();
+
+        for (auto& Wnd : m_Windows)
+        {
+            if (Wnd.Present)
+                Wnd.Present();
+        }
+    }
+
+    size_t GetNumWindows() const
+    {
+        return m_Windows.size();
+    }
+
+private:
+    struct WindowInfo
+    {
+        Uint32              Id = 0;
+        RecordCallbackType  Record;
+        PresentCallbackType Present;
+    };
+
+    std::vector<WindowInfo>::iterator FindWindow(Uint32 WindowId)
+    {
+        return std::find_if(m_Windows.begin(), m_Windows.end(), [WindowId](const WindowInfo& Wnd) { return Wnd.Id == WindowId; });
+    }
+
+    void RecordWindows()
+    {
+        for (;;)
+        {
+            const size_t Idx = m_NextWindow.fetch_add(1);
+            if (Idx >= m_Windows.size())
+                break;
+
+            auto& Wnd = m_Windows[Idx];
+            if (Wnd.Record)
+                Wnd.Record();
+
+            bool AllRecorded = false;
+            {
+                std::lock_guard<std::mutex> Lock{m_Mtx};
+                AllRecorded = ++m_NumRecorded == m_Windows.size();
+            }
+            if (AllRecorded)
+                m_DoneCV.notify_one();
+        }
+    }
+
+    void WorkerThreadProc()
+    {
+        Uint64 Generation = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> Lock{m_Mtx};
+                m_WorkCV.wait(Lock, [&]() { return m_Stop || m_Generation != Generation; });
+                if (m_Stop)
+                    break;
+                Generation = m_Generation;
+            }
+            RecordWindows();
+        }
+    }
+
+    std::vector<WindowInfo> m_Windows;
+
+    std::mutex              m_Mtx;
+    std::condition_variable m_WorkCV;
+    std::condition_variable m_DoneCV;
+    Uint64                  m_Generation  = 0;
+    size_t                  m_NumRecorded = 0;
+    bool                    m_Stop        = false;
+
+    std::atomic<size_t> m_NextWindow{0};
+
+    std::vector<std::thread> m_Workers;
+};
+
+} // namespace Diligent
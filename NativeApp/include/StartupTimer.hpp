@@ -0,0 +1,99 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+/// Measures the phases of the application start-up and logs the breakdown.
+
+/// The main loop ends a phase after every start-up step (command line processing, AppBase::OnStartup(),
+/// window creation, device and application initialization), and calls Finish() when the first frame
+/// has been presented, so that the log shows where the time to the first frame is spent.
+class StartupTimer
+{
+public:
+    StartupTimer() :
+        m_Start{Clock::now()},
+        m_PhaseStart{m_Start}
+    {}
+
+    /// Ends the current phase and starts the next one.
+    void EndPhase(const char* Name)
+    {
+        if (m_Finished)
+            return;
+
+        const auto Now = Clock::now();
+        m_Phases.push_back({Name, std::chrono::duration<double, std::milli>(Now - m_PhaseStart).count()});
+        m_PhaseStart = Now;
+    }
+
+    /// Ends the last phase and logs the breakdown. Subsequent calls have no effect.
+    void Finish(const char* LastPhaseName)
+    {
+        if (m_Finished)
+            return;
+
+        EndPhase(LastPhaseName);
+        m_Finished = true;
+
+        const double Total = std::chrono::duration<double, std::milli>(m_PhaseStart - m_Start).count();
+
+        std::stringstream ss;
+        ss << "Time to first frame: " << std::fixed << std::setprecision(1) << Total << " ms";
+        for (const auto& Phase : m_Phases)
+            ss << "\n    " << std::left << std::setw(32) << Phase.Name << std::right << std::setw(9) << Phase.Duration << " ms";
+        LOG_INFO_MESSAGE(ss.str());
+    }
+
+    bool IsFinished() const { return m_Finished; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Phase
+    {
+        const char* Name;
+        double      Duration; // Milliseconds
+    };
+
+    const Clock::time_point m_Start;
+    Clock::time_point       m_PhaseStart;
+    std::vector<Phase>      m_Phases;
+    bool                    m_Finished = false;
+};
+
+} // namespace Diligent
@@ -54,6 +54,25 @@ public:
                                  LONG WindowWidth,
                                  LONG WindowHeight) = 0;
 
+    /// Called by the framework after an additional window has been created.
+
+    /// \param [in] WindowId     - Index of the window, from 0 to GetNumAdditionalWindows() - 1.
+    /// \param [in] hWnd         - Window handle.
+    /// \param [in] WindowWidth  - Window width.
+    /// \param [in] WindowHeight - Window height.
+    ///
+    /// \return true if the operation succeeded, and false otherwise.
+    ///
+    /// \remarks The method is called after OnWindowCreated, so the application
+    ///          creates the swap chain of the window with the existing device.
+    virtual bool OnAdditionalWindowCreated(Uint32 WindowId,
+                                           HWND   hWnd,
+                                           LONG   WindowWidth,
+                                           LONG   WindowHeight)
+    {
+        return false;
+    }
+
     /// Handles Win32 message
 
     /// An application may override this method to implement its
@@ -80,13 +80,23 @@ void AndroidAppBase::DrawFrame()
         UpdateFPS(fFPS);
     }
 
-    static Diligent::Timer Timer;
+    double CurrTime    = 0;
+    double ElapsedTime = 0;
+    if (frame_scheduler_)
+    {
+        // Frame times are vsync timestamps, so the animation advances in whole refresh periods
+        frame_scheduler_->BeginFrame(CurrTime, ElapsedTime);
+    }
+    else
+    {
+        static Diligent::Timer Timer;
 
-    static double PrevTime    = Timer.GetElapsedTime();
-    auto          CurrTime    = Timer.GetElapsedTime();
-    auto          ElapsedTime = CurrTime - PrevTime;
+        static double PrevTime = Timer.GetElapsedTime();
+        CurrTime               = Timer.GetElapsedTime();
+        ElapsedTime            = CurrTime - PrevTime;
 
-    PrevTime = CurrTime;
+        PrevTime = CurrTime;
+    }
 
     Update(CurrTime, ElapsedTime);
 
@@ -237,6 +247,12 @@ void AndroidAppBase::SetState(android_app* state, const char* native_activity_cl
     app_ = state;
 
     native_activity_class_name_ = native_activity_class_name;
+
+    // The choreographer instance is bound to the looper of the calling thread
+    frame_scheduler_.reset(new ChoreographerFrameScheduler{});
+    if (!frame_scheduler_->IsSupported())
+        frame_scheduler_.reset();
+
     doubletap_detector_.SetConfiguration(app_->config);
     drag_detector_.SetConfiguration(app_->config);
     pinch_detector_.SetConfiguration(app_->config);
@@ -250,6 +266,26 @@ bool AndroidAppBase::IsReady()
     return false;
 }
 
+int AndroidAppBase::GetPollTimeout()
+{
+    // Block until an event arrives while there is nothing to draw
+    if (!IsReady())
+        return -1;
+
+    if (!frame_scheduler_)
+        return 0;
+
+    // Block until an event or the choreographer callback that makes the next frame due
+    frame_scheduler_->SetTargetFrameRate(GetTargetFrameRate());
+    frame_scheduler_->RequestFrame();
+    return frame_scheduler_->IsFrameDue() ? 0 : -1;
+}
+
+bool AndroidAppBase::IsFrameDue()
+{
+    return IsReady() && (!frame_scheduler_ || frame_scheduler_->IsFrameDue());
+}
+
 //void Engine::TransformPosition( ndk_helper::Vec2& vec )
 //{
 //    vec = ndk_helper::Vec2( 2.0f, 2.0f ) * vec
@@ -70,9 +70,10 @@ void android_main(android_app* state)
         android_poll_source* source;
 
         // If not animating, we will block forever waiting for events.
-        // If animating, we loop until all events are read, then continue
-        // to draw the next frame of animation.
-        while ((id = ALooper_pollAll(theApp->IsReady() ? 0 : -1, NULL, &events, (void**)&source)) >= 0)
+        // If animating, we loop until all events are read, then wait for the
+        // vsync callback of the next frame, unless frames are not scheduled on vsync.
+        // Unlike ALooper_pollAll, ALooper_pollOnce returns after the callbacks have run.
+        while ((id = ALooper_pollOnce(theApp->GetPollTimeout(), NULL, &events, (void**)&source)) >= 0)
         {
             // Process this event.
             if (source != NULL)
@@ -88,10 +89,10 @@ void android_main(android_app* state)
             }
         }
 
-        if (theApp->IsReady())
+        if (theApp->IsFrameDue())
         {
-            // Drawing is throttled to the screen update rate, so there
-            // is no need to do timing here.
+            // Frames are started on vsync by the choreographer. Otherwise drawing
+            // is throttled to the screen update rate by the swap chain.
             theApp->DrawFrame();
         }
     }
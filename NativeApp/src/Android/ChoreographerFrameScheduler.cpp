@@ -0,0 +1,200 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT OF ANY PROPRIETARY RIGHTS.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "ChoreographerFrameScheduler.hpp"
+
+#include <dlfcn.h>
+#include <time.h>
+
+#include "Errors.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+int64_t GetMonotonicTime()
+{
+    // Choreographer timestamps use the same clock as System.nanoTime()
+    timespec ts = {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+} // namespace
+
+ChoreographerFrameScheduler::ChoreographerFrameScheduler()
+{
+    m_pLibAndroid = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+    if (m_pLibAndroid == nullptr)
+        return;
+
+    auto GetInstance = reinterpret_cast<GetInstanceProc>(dlsym(m_pLibAndroid, "AChoreographer_getInstance"));
+
+    // AChoreographer_postFrameCallback is deprecated in API 29, as its timestamp overflows on 32-bit platforms
+    m_PostFrameCallback64 = reinterpret_cast<PostFrameCallback64Proc>(dlsym(m_pLibAndroid, "AChoreographer_postFrameCallback64"));
+    if (m_PostFrameCallback64 == nullptr)
+        m_PostFrameCallback = reinterpret_cast<PostFrameCallbackProc>(dlsym(m_pLibAndroid, "AChoreographer_postFrameCallback"));
+
+    if (GetInstance == nullptr || (m_PostFrameCallback64 == nullptr && m_PostFrameCallback == nullptr))
+    {
+        LOG_INFO_MESSAGE("AChoreographer is not available. Frames will not be scheduled on vsync.");
+        return;
+    }
+
+    m_pChoreographer = GetInstance();
+    if (m_pChoreographer == nullptr)
+    {
+        LOG_WARNING_MESSAGE("Failed to get the choreographer instance. The calling thread must have a looper.");
+        return;
+    }
+
+    // API 30+: the display may switch between refresh rates, e.g. 60, 90 and 120 Hz
+    auto RegisterRefreshRateCallback = reinterpret_cast<RegisterRefreshRateCallbackProc>(dlsym(m_pLibAndroid, "AChoreographer_registerRefreshRateCallback"));
+    if (RegisterRefreshRateCallback != nullptr)
+    {
+        m_UnregisterRefreshRateCallback = reinterpret_cast<RegisterRefreshRateCallbackProc>(dlsym(m_pLibAndroid, "AChoreographer_unregisterRefreshRateCallback"));
+        RegisterRefreshRateCallback(m_pChoreographer, RefreshRateCallback, this);
+    }
+
+    m_StartTime = GetMonotonicTime();
+}
+
+ChoreographerFrameScheduler::~ChoreographerFrameScheduler()
+{
+    // A pending frame callback can not be cancelled. The scheduler is destroyed
+    // when the main loop exits, after which the looper is no longer polled.
+    if (m_pChoreographer != nullptr && m_UnregisterRefreshRateCallback != nullptr)
+        m_UnregisterRefreshRateCallback(m_pChoreographer, RefreshRateCallback, this);
+
+    if (m_pLibAndroid != nullptr)
+        dlclose(m_pLibAndroid);
+}
+
+void ChoreographerFrameScheduler::SetTargetFrameRate(double FramesPerSecond)
+{
+    m_TargetFramePeriod = FramesPerSecond > 0 ? static_cast<int64_t>(1e9 / FramesPerSecond) : 0;
+}
+
+Uint32 ChoreographerFrameScheduler::GetSwapInterval() const
+{
+    if (m_TargetFramePeriod <= m_RefreshPeriod)
+        return 1;
+
+    // Round to the nearest whole number of refresh periods, e.g. a 30 fps target on a 90 Hz display gives 3
+    return static_cast<Uint32>((m_TargetFramePeriod + m_RefreshPeriod / 2) / m_RefreshPeriod);
+}
+
+void ChoreographerFrameScheduler::PostFrameCallback()
+{
+    if (m_PostFrameCallback64 != nullptr)
+        m_PostFrameCallback64(m_pChoreographer, FrameCallback64, this);
+    else
+        m_PostFrameCallback(m_pChoreographer, FrameCallback, this);
+    m_CallbackPending = true;
+}
+
+void ChoreographerFrameScheduler::RequestFrame()
+{
+    if (!IsSupported() || m_CallbackPending || m_FrameDue)
+        return;
+
+    // The previous callback did not immediately follow the one before it,
+    // so the next interval may span several refresh periods
+    m_LastVsyncTime = 0;
+    PostFrameCallback();
+}
+
+void ChoreographerFrameScheduler::OnVsync(int64_t FrameTimeNanos)
+{
+    m_CallbackPending = false;
+
+    // Without the refresh rate callback, measure the period between consecutive vsyncs.
+    // Intervals that span missed vsyncs are ignored.
+    if (!m_RefreshPeriodReported && m_LastVsyncTime != 0)
+    {
+        const int64_t Interval = FrameTimeNanos - m_LastVsyncTime;
+        if (Interval > 0 && Interval < m_RefreshPeriod + m_RefreshPeriod / 2)
+            m_RefreshPeriod += (Interval - m_RefreshPeriod) / 8;
+    }
+    m_LastVsyncTime = FrameTimeNanos;
+
+    // Half a period of tolerance lets a frame that was started late keep the cadence
+    const int64_t SwapPeriod = GetSwapInterval() * m_RefreshPeriod;
+    if (m_LastFrameVsyncTime == 0 || FrameTimeNanos - m_LastFrameVsyncTime >= SwapPeriod - m_RefreshPeriod / 2)
+    {
+        m_FrameDue           = true;
+        m_FrameVsyncTime     = FrameTimeNanos;
+        m_DesiredPresentTime = FrameTimeNanos + SwapPeriod;
+    }
+    else
+    {
+        PostFrameCallback();
+    }
+}
+
+void ChoreographerFrameScheduler::BeginFrame(double& CurrTime, double& ElapsedTime)
+{
+    int64_t FrameTime = 0;
+    if (m_FrameDue)
+    {
+        FrameTime            = m_FrameVsyncTime;
+        m_LastFrameVsyncTime = m_FrameVsyncTime;
+        m_FrameDue           = false;
+    }
+    else
+    {
+        FrameTime            = GetMonotonicTime();
+        m_DesiredPresentTime = 0;
+    }
+
+    CurrTime    = static_cast<double>(FrameTime - m_StartTime) * 1e-9;
+    ElapsedTime = m_PrevFrameTime >= 0 && FrameTime > m_PrevFrameTime ? static_cast<double>(FrameTime - m_PrevFrameTime) * 1e-9 : 0;
+
+    m_PrevFrameTime = FrameTime;
+}
+
+void ChoreographerFrameScheduler::FrameCallback64(int64_t FrameTimeNanos, void* pData)
+{
+    static_cast<ChoreographerFrameScheduler*>(pData)->OnVsync(FrameTimeNanos);
+}
+
+void ChoreographerFrameScheduler::FrameCallback(long FrameTimeNanos, void* pData)
+{
+    static_cast<ChoreographerFrameScheduler*>(pData)->OnVsync(FrameTimeNanos);
+}
+
+void ChoreographerFrameScheduler::RefreshRateCallback(int64_t VsyncPeriodNanos, void* pData)
+{
+    auto* pScheduler = static_cast<ChoreographerFrameScheduler*>(pData);
+    if (VsyncPeriodNanos > 0)
+    {
+        pScheduler->m_RefreshPeriod         = VsyncPeriodNanos;
+        pScheduler->m_RefreshPeriodReported = true;
+    }
+}
+
+} // namespace Diligent
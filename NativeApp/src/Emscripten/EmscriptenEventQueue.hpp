@@ -0,0 +1,107 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include <emscripten/html5.h>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Lock-free single-producer/single-consumer queue that forwards the browser input events
+/// from the main thread to the render thread when rendering to an OffscreenCanvas in a worker.
+
+/// The browser only delivers DOM events to the main thread. The event callbacks push copies
+/// of the events, and the render thread dispatches them to the application before every frame,
+/// so that the application handles its input on the same thread that updates and renders it.
+class EmscriptenEventQueue
+{
+public:
+    /// The number of events the queue can hold. Events pushed to a full queue are dropped.
+    static constexpr Uint32 Capacity = 256;
+
+    enum EVENT_TYPE : Uint8
+    {
+        EVENT_TYPE_MOUSE,
+        EVENT_TYPE_WHEEL,
+        EVENT_TYPE_KEY,
+        EVENT_TYPE_RESIZE
+    };
+
+    struct Event
+    {
+        EVENT_TYPE Type           = EVENT_TYPE_MOUSE;
+        int32_t    EmscriptenType = 0;
+        union
+        {
+            EmscriptenMouseEvent    Mouse;
+            EmscriptenWheelEvent    Wheel;
+            EmscriptenKeyboardEvent Key;
+            EmscriptenUiEvent       Ui;
+        };
+
+        Event() :
+            Mouse{}
+        {}
+    };
+
+    bool Push(const Event& Evt)
+    {
+        const auto Tail = m_Tail.load(std::memory_order_relaxed);
+        if (Tail - m_Head.load(std::memory_order_acquire) >= Capacity)
+            return false;
+
+        m_Events[Tail % Capacity] = Evt;
+        m_Tail.store(Tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Calls Handler for every queued event, in order. Must be called from the consumer thread.
+    template <typename HandlerType>
+    void Dispatch(HandlerType&& Handler)
+    {
+        const auto Tail = m_Tail.load(std::memory_order_acquire);
+        auto       Head = m_Head.load(std::memory_order_relaxed);
+        for (; Head != Tail; ++Head)
+            Handler(m_Events[Head % Capacity]);
+        m_Head.store(Head, std::memory_order_release);
+    }
+
+private:
+    std::array<Event, Capacity> m_Events;
+
+    // Head is only written by the consumer, tail is only written by the producer
+    std::atomic<Uint32> m_Head{0};
+    std::atomic<Uint32> m_Tail{0};
+};
+
+} // namespace Diligent
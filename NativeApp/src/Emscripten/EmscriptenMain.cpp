@@ -31,12 +31,51 @@
 #include "NativeAppBase.hpp"
 #include "Timer.hpp"
 
+#if DILIGENT_EMSCRIPTEN_WORKER_RENDERING
+#    include <pthread.h>
+#    include "EmscriptenEventQueue.hpp"
+#endif
+
 std::unique_ptr<Diligent::NativeAppBase> g_pTheApp  = nullptr;
 Diligent::Timer                          g_Timer    = {};
 double                                   g_PrevTime = 0.0;
 
+#if DILIGENT_EMSCRIPTEN_WORKER_RENDERING
+Diligent::EmscriptenEventQueue g_EventQueue;
+
+void DispatchQueuedEvents()
+{
+    using Diligent::EmscriptenEventQueue;
+    g_EventQueue.Dispatch([](const EmscriptenEventQueue::Event& Evt) {
+        switch (Evt.Type)
+        {
+            case EmscriptenEventQueue::EVENT_TYPE_MOUSE:
+                g_pTheApp->OnMouseEvent(Evt.EmscriptenType, &Evt.Mouse);
+                break;
+
+            case EmscriptenEventQueue::EVENT_TYPE_WHEEL:
+                g_pTheApp->OnWheelEvent(Evt.EmscriptenType, &Evt.Wheel);
+                break;
+
+            case EmscriptenEventQueue::EVENT_TYPE_KEY:
+                g_pTheApp->OnKeyEvent(Evt.EmscriptenType, &Evt.Key);
+                break;
+
+            case EmscriptenEventQueue::EVENT_TYPE_RESIZE:
+                if (g_pTheApp->IsReady())
+                    g_pTheApp->WindowResize(Evt.Ui.documentBodyClientWidth, Evt.Ui.documentBodyClientHeight);
+                break;
+        }
+    });
+}
+#endif
+
 void EventLoopCallback()
 {
+#if DILIGENT_EMSCRIPTEN_WORKER_RENDERING
+    DispatchQueuedEvents();
+#endif
+
     auto CurrTime    = g_Timer.GetElapsedTime();
     auto ElapsedTime = CurrTime - g_PrevTime;
     g_PrevTime       = CurrTime;
@@ -48,6 +87,73 @@ void EventLoopCallback()
     }
 }
 
+#if DILIGENT_EMSCRIPTEN_WORKER_RENDERING
+
+// The callbacks run on the main thread and forward the events to the render thread
+
+EM_BOOL EventResizeCallback(int32_t EventType, const EmscriptenUiEvent* Event, void* pUserData)
+{
+    Diligent::EmscriptenEventQueue::Event Evt;
+    Evt.Type           = Diligent::EmscriptenEventQueue::EVENT_TYPE_RESIZE;
+    Evt.EmscriptenType = EventType;
+    Evt.Ui             = *Event;
+    g_EventQueue.Push(Evt);
+    return true;
+}
+
+EM_BOOL EventMouseCallback(int32_t EventType, const EmscriptenMouseEvent* Event, void* pUserData)
+{
+    Diligent::EmscriptenEventQueue::Event Evt;
+    Evt.Type           = Diligent::EmscriptenEventQueue::EVENT_TYPE_MOUSE;
+    Evt.EmscriptenType = EventType;
+    Evt.Mouse          = *Event;
+    g_EventQueue.Push(Evt);
+    return true;
+}
+
+EM_BOOL EventWheelCallback(int32_t EventType, const EmscriptenWheelEvent* Event, void* pUserData)
+{
+    Diligent::EmscriptenEventQueue::Event Evt;
+    Evt.Type           = Diligent::EmscriptenEventQueue::EVENT_TYPE_WHEEL;
+    Evt.EmscriptenType = EventType;
+    Evt.Wheel          = *Event;
+    g_EventQueue.Push(Evt);
+    return true;
+}
+
+EM_BOOL EventKeyCallback(int32_t EventType, const EmscriptenKeyboardEvent* Event, void* pUserData)
+{
+    Diligent::EmscriptenEventQueue::Event Evt;
+    Evt.Type           = Diligent::EmscriptenEventQueue::EVENT_TYPE_KEY;
+    Evt.EmscriptenType = EventType;
+    Evt.Key            = *Event;
+    g_EventQueue.Push(Evt);
+    return true;
+}
+
+struct RenderThreadParams
+{
+    const char* CanvasID     = nullptr;
+    int32_t     CanvasWidth  = 0;
+    int32_t     CanvasHeight = 0;
+};
+
+void* RenderThreadMain(void* pArg)
+{
+    const auto* pParams = static_cast<const RenderThreadParams*>(pArg);
+
+    // The canvas has been transferred to this thread as an OffscreenCanvas
+    g_pTheApp->OnWindowCreated(pParams->CanvasID, pParams->CanvasWidth, pParams->CanvasHeight);
+    delete pParams;
+
+    // Frames are driven by requestAnimationFrame in the worker. The simulated infinite
+    // loop keeps the thread alive after this function unwinds.
+    emscripten_set_main_loop(EventLoopCallback, 0, true);
+    return nullptr;
+}
+
+#else
+
 EM_BOOL EventResizeCallback(int32_t EventType, const EmscriptenUiEvent* Event, void* pUserData)
 {
     if (g_pTheApp->IsReady())
@@ -73,6 +179,8 @@ EM_BOOL EventKeyCallback(int32_t EventType, const EmscriptenKeyboardEvent* Event
     return true;
 }
 
+#endif
+
 
 int main(int argc, char* argv[])
 {
@@ -92,8 +200,30 @@ int main(int argc, char* argv[])
     emscripten_set_keypress_callback(CanvasID, nullptr, true, EventKeyCallback);
     emscripten_set_resize_callback(CanvasID, nullptr, true, EventResizeCallback);
 
+#if DILIGENT_EMSCRIPTEN_WORKER_RENDERING
+    // Input stays on the main thread, while the application is initialized, updated
+    // and rendered on a worker that owns the canvas
+    pthread_attr_t Attr;
+    pthread_attr_init(&Attr);
+    emscripten_pthread_attr_settransferredcanvases(&Attr, CanvasID);
+
+    auto*     pParams = new RenderThreadParams{CanvasID, CanvasWidth, CanvasHeight};
+    pthread_t RenderThread;
+    if (pthread_create(&RenderThread, &Attr, RenderThreadMain, pParams) != 0)
+    {
+        emscripten_log(EM_LOG_ERROR, "Failed to create the render thread");
+        delete pParams;
+        pthread_attr_destroy(&Attr);
+        return 1;
+    }
+    pthread_attr_destroy(&Attr);
+
+    // The runtime must outlive main() to keep receiving the input events
+    emscripten_exit_with_live_runtime();
+#else
     g_pTheApp->OnWindowCreated(CanvasID, CanvasWidth, CanvasHeight);
     emscripten_set_main_loop(EventLoopCallback, 0, true);
 
     g_pTheApp.reset();
+#endif
 }
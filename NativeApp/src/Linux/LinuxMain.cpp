@@ -25,14 +25,27 @@
 
 #include <memory>
 #include <iomanip>
+#include <cstdlib>
 #include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <sstream>
+
+#include <poll.h>
 
 #include "PlatformDefinitions.h"
 #include "NativeAppBase.hpp"
 #include "StringTools.hpp"
-#include "Timer.hpp"
+#include "BenchmarkRunner.hpp"
+#include "FramePacer.hpp"
 #include "Errors.hpp"
 #include "CommandLineParser.hpp"
+#include "WindowTitleHelper.hpp"
+#include "FramePipeline.hpp"
+#include "FrameStatsRecorder.hpp"
+#include "IdleMonitor.hpp"
+#include "StartupTimer.hpp"
 
 
 #ifndef GLX_CONTEXT_MAJOR_VERSION_ARB
@@ -65,29 +78,6 @@ namespace
 
 static constexpr int None = 0;
 
-class WindowTitleHelper
-{
-public:
-    WindowTitleHelper(std::string _Title) :
-        Title{std::move(_Title)}
-    {}
-
-    std::string GetTitleWithFPS(double ElapsedTime)
-    {
-        double filterScale = 0.2;
-        FilteredFrameTime  = FilteredFrameTime * (1.0 - filterScale) + filterScale * ElapsedTime;
-        std::stringstream TitleWithFpsSS;
-        TitleWithFpsSS << Title;
-        TitleWithFpsSS << " - " << std::fixed << std::setprecision(1) << FilteredFrameTime * 1000;
-        TitleWithFpsSS << " ms (" << 1.0 / FilteredFrameTime << " fps)";
-        return TitleWithFpsSS.str();
-    }
-
-private:
-    const std::string Title;
-    double            FilteredFrameTime = 0.0;
-};
-
 } // namespace
 
 #if VULKAN_SUPPORTED
@@ -165,7 +155,9 @@ XCBInfo InitXCBConnectionAndWindow(const std::string& Title, int WindowWidth, in
         XCB_EVENT_MASK_STRUCTURE_NOTIFY |
         XCB_EVENT_MASK_POINTER_MOTION |
         XCB_EVENT_MASK_BUTTON_PRESS |
-        XCB_EVENT_MASK_BUTTON_RELEASE;
+        XCB_EVENT_MASK_BUTTON_RELEASE |
+        XCB_EVENT_MASK_FOCUS_CHANGE |
+        XCB_EVENT_MASK_VISIBILITY_CHANGE;
 
     xcb_create_window(info.connection, XCB_COPY_FROM_PARENT, info.window, screen->root, 0, 0, info.width, info.height, 0,
                       XCB_WINDOW_CLASS_INPUT_OUTPUT, screen->root_visual, value_mask, value_list);
@@ -216,6 +208,8 @@ void DestroyXCBConnectionAndWindow(XCBInfo& info)
 
 int xcb_main(int argc, const char* const* argv)
 {
+    StartupTimer Startup;
+
     std::unique_ptr<NativeAppBase> TheApp{CreateApplication()};
     if (argc > 0 && argv != nullptr)
     {
@@ -226,6 +220,13 @@ int xcb_main(int argc, const char* const* argv)
             return 1;
     }
 
+    auto pFrameStats = FrameStatsRecorder::CreateFromCommandLine(argc, argv);
+    Startup.EndPhase("Command line");
+
+    // Asset loading started by the application runs while the window and the device are created
+    TheApp->OnStartup();
+    Startup.EndPhase("OnStartup");
+
     int DesiredWidth  = 0;
     int DesiredHeight = 0;
     TheApp->GetDesiredInitialWindowSize(DesiredWidth, DesiredHeight);
@@ -234,8 +235,10 @@ int xcb_main(int argc, const char* const* argv)
 
     std::string Title   = TheApp->GetAppTitle();
     auto        xcbInfo = InitXCBConnectionAndWindow(Title, WindowWidth, WindowHeight);
+    Startup.EndPhase("Window creation");
     if (!TheApp->InitVulkan(xcbInfo.connection, xcbInfo.window))
         return 1;
+    Startup.EndPhase("Device and app initialization");
 
     xcb_flush(xcbInfo.connection);
 
@@ -255,18 +258,79 @@ int xcb_main(int argc, const char* const* argv)
         return TheApp->GetExitCode();
     }
 
-    Timer timer;
-    auto  PrevTime = timer.GetElapsedTime();
-    Title          = TheApp->GetAppTitle();
+    if (auto pBenchmark = BenchmarkRunner::CreateFromCommandLine(argc, argv))
+    {
+        auto PumpEvents = [&]() {
+            xcb_flush(xcbInfo.connection);
+
+            bool                 Quit  = false;
+            xcb_generic_event_t* event = nullptr;
+            while ((event = xcb_poll_for_event(xcbInfo.connection)) != nullptr)
+            {
+                TheApp->HandleXCBEvent(event);
+                const auto EventType = event->response_type & 0x7f;
+                if (EventType == XCB_DESTROY_NOTIFY ||
+                    (EventType == XCB_CLIENT_MESSAGE && (*(xcb_client_message_event_t*)event).data.data32[0] == (*xcbInfo.atom_wm_delete_window).atom))
+                {
+                    Quit = true;
+                }
+                free(event);
+            }
+            return !Quit;
+        };
+        const auto Completed = pBenchmark->Run(*TheApp, PumpEvents, pFrameStats.get());
+        if (pFrameStats)
+            pFrameStats->Save();
+        return Completed ? TheApp->GetExitCode() : 1;
+    }
+
+    FramePacer Pacer;
+    Pacer.SetTargetFrameRate(TheApp->GetTargetFrameRate());
+    Title = TheApp->GetAppTitle();
     WindowTitleHelper TitleHelper(Title);
 
+    std::unique_ptr<FramePipeline> pPipeline;
+    if (TheApp->GetThreadingModel() == AppBase::ThreadingModel::Pipelined)
+    {
+        if (pFrameStats)
+        {
+            LOG_WARNING_MESSAGE("Frame statistics are only recorded by the single-threaded main loop");
+            pFrameStats.reset();
+        }
+        pPipeline.reset(new FramePipeline{*TheApp});
+        Startup.Finish("Frame pipeline start");
+    }
+
+    IdleMonitor Idle{*TheApp};
+
+    std::vector<LinuxAppBase::PointerMotionSample> MotionBatch;
     while (true)
     {
-        xcb_generic_event_t* event = nullptr;
+        xcb_generic_event_t* event         = nullptr;
+        xcb_generic_event_t* PendingMotion = nullptr;
 
-        bool Quit = false;
+        bool Quit          = false;
+        bool ResizePending = false;
         while ((event = xcb_poll_for_event(xcbInfo.connection)) != nullptr)
         {
+            Idle.OnEventsReceived();
+            if ((event->response_type & 0x7f) == XCB_MOTION_NOTIFY)
+            {
+                // Only the last of consecutive motion events is handled
+                const auto* motionEvent = reinterpret_cast<const xcb_motion_notify_event_t*>(event);
+                MotionBatch.push_back({motionEvent->event_x, motionEvent->event_y, motionEvent->time});
+                free(PendingMotion);
+                PendingMotion = event;
+                continue;
+            }
+
+            if (PendingMotion != nullptr)
+            {
+                TheApp->HandleXCBEvent(PendingMotion);
+                free(PendingMotion);
+                PendingMotion = nullptr;
+            }
+
             TheApp->HandleXCBEvent(event);
             switch (event->response_type & 0x7f)
             {
@@ -295,17 +359,29 @@ int xcb_main(int argc, const char* const* argv)
                     Quit = true;
                     break;
 
+                case XCB_FOCUS_IN:
+                case XCB_FOCUS_OUT:
+                    Idle.SetFocused((event->response_type & 0x7f) == XCB_FOCUS_IN);
+                    break;
+
+                case XCB_MAP_NOTIFY:
+                case XCB_UNMAP_NOTIFY:
+                    Idle.SetMinimized((event->response_type & 0x7f) == XCB_UNMAP_NOTIFY);
+                    break;
+
+                case XCB_VISIBILITY_NOTIFY:
+                    Idle.SetOccluded(reinterpret_cast<const xcb_visibility_notify_event_t*>(event)->state == XCB_VISIBILITY_FULLY_OBSCURED);
+                    break;
+
                 case XCB_CONFIGURE_NOTIFY:
                 {
+                    // The window is resized once after all events have been processed
                     const auto* cfgEvent = reinterpret_cast<const xcb_configure_notify_event_t*>(event);
                     if ((cfgEvent->width != xcbInfo.width) || (cfgEvent->height != xcbInfo.height))
                     {
                         xcbInfo.width  = cfgEvent->width;
                         xcbInfo.height = cfgEvent->height;
-                        if ((xcbInfo.width > 0) && (xcbInfo.height > 0))
-                        {
-                            TheApp->WindowResize(xcbInfo.width, xcbInfo.height);
-                        }
+                        ResizePending  = true;
                     }
                 }
                 break;
@@ -316,26 +392,99 @@ int xcb_main(int argc, const char* const* argv)
             free(event);
         }
 
+        if (PendingMotion != nullptr)
+        {
+            TheApp->HandleXCBEvent(PendingMotion);
+            free(PendingMotion);
+            PendingMotion = nullptr;
+        }
+
+        if (!MotionBatch.empty())
+        {
+            TheApp->OnPointerMotionBatch(MotionBatch.data(), MotionBatch.size());
+            MotionBatch.clear();
+        }
+
+        if (ResizePending && (xcbInfo.width > 0) && (xcbInfo.height > 0))
+        {
+            if (pPipeline)
+                pPipeline->RequestResize(xcbInfo.width, xcbInfo.height);
+            else
+                TheApp->WindowResize(xcbInfo.width, xcbInfo.height);
+        }
+
         if (Quit)
             break;
 
-        // Render the scene
-        auto CurrTime    = timer.GetElapsedTime();
-        auto ElapsedTime = CurrTime - PrevTime;
-        PrevTime         = CurrTime;
+        if (!pPipeline && !Idle.ShouldRunFrame())
+        {
+            // The window is inactive: block until an event arrives or the next throttled frame is due
+            xcb_flush(xcbInfo.connection);
+            pollfd fd = {xcb_get_file_descriptor(xcbInfo.connection), POLLIN, 0};
+            poll(&fd, 1, Idle.GetEventWaitTimeout());
+            continue;
+        }
 
-        TheApp->Update(CurrTime, ElapsedTime);
+        double FrameTime = 0;
+        if (pPipeline)
+        {
+            // Update and render threads run the frames, the main thread only pumps the events
+            std::this_thread::sleep_for(std::chrono::milliseconds{4});
+            FrameTime = pPipeline->GetFrameTime();
+        }
+        else
+        {
+            Idle.OnFrameStarted();
+            Pacer.WaitForNextFrame();
+            TheApp->WaitForFrameLatency();
 
-        TheApp->Render();
+            // Render the scene
+            double CurrTime    = 0;
+            double ElapsedTime = 0;
+            Pacer.BeginFrame(CurrTime, ElapsedTime);
 
-        TheApp->Present();
+            if (pFrameStats)
+                pFrameStats->BeginFrame();
+
+            {
+                FrameStatsRecorder::ScopedStage StageScope{pFrameStats.get(), FrameStatsRecorder::Stage::Update};
+                TheApp->Update(CurrTime, ElapsedTime);
+            }
+
+            {
+                FrameStatsRecorder::ScopedStage StageScope{pFrameStats.get(), FrameStatsRecorder::Stage::Render};
+                TheApp->Render();
+            }
+
+            {
+                FrameStatsRecorder::ScopedStage StageScope{pFrameStats.get(), FrameStatsRecorder::Stage::Present};
+                TheApp->Present();
+            }
+            Startup.Finish("First frame");
+
+            if (pFrameStats)
+                pFrameStats->EndFrame(TheApp->GetGPUFrameTime());
+
+            FrameTime = Pacer.GetRawFrameTime();
+        }
 
-        auto TitleWithFPS = TitleHelper.GetTitleWithFPS(ElapsedTime);
-        xcb_change_property(xcbInfo.connection, XCB_PROP_MODE_REPLACE, xcbInfo.window, XCB_ATOM_WM_NAME, XCB_ATOM_STRING,
-                            8, TitleWithFPS.length(), TitleWithFPS.c_str());
+        if (TitleHelper.Update(FrameTime))
+        {
+            const auto& TitleWithFPS = TitleHelper.GetTitleWithFPS();
+            xcb_change_property(xcbInfo.connection, XCB_PROP_MODE_REPLACE, xcbInfo.window, XCB_ATOM_WM_NAME, XCB_ATOM_STRING,
+                                8, TitleWithFPS.length(), TitleWithFPS.c_str());
+        }
+        // Send all requests of the frame at once; this is a no-op if there are none
         xcb_flush(xcbInfo.connection);
+
+        if (pFrameStats && pFrameStats->IsCaptureComplete())
+            break;
     }
 
+    // The pipeline must finish the frames in flight before the swap chain is destroyed
+    pPipeline.reset();
+    if (pFrameStats)
+        pFrameStats->Save();
     TheApp.reset();
     DestroyXCBConnectionAndWindow(xcbInfo);
 
@@ -347,6 +496,8 @@ int xcb_main(int argc, const char* const* argv)
 
 int x_main(int argc, const char* const* argv)
 {
+    StartupTimer Startup;
+
     std::unique_ptr<NativeAppBase> TheApp{CreateApplication()};
     if (argc > 0 && argv != nullptr)
     {
@@ -357,6 +508,13 @@ int x_main(int argc, const char* const* argv)
             return 1;
     }
 
+    auto pFrameStats = FrameStatsRecorder::CreateFromCommandLine(argc, argv);
+    Startup.EndPhase("Command line");
+
+    // Asset loading started by the application runs while the window and the device are created
+    TheApp->OnStartup();
+    Startup.EndPhase("OnStartup");
+
     Display* display = XOpenDisplay(0);
 
     // clang-format off
@@ -408,7 +566,9 @@ int x_main(int argc, const char* const* argv)
         KeyReleaseMask |
         ButtonPressMask |
         ButtonReleaseMask |
-        PointerMotionMask;
+        PointerMotionMask |
+        FocusChangeMask |
+        VisibilityChangeMask;
 
     int DesiredWidth  = 0;
     int DesiredHeight = 0;
@@ -476,11 +636,13 @@ int x_main(int argc, const char* const* argv)
 
 
     glXMakeCurrent(display, win, ctx);
+    Startup.EndPhase("Window and GL context creation");
     if (!TheApp->OnGLContextCreated(display, win))
     {
         LOG_ERROR("Unable to initialize the application in OpenGL mode. Aborting");
         return 1;
     }
+    Startup.EndPhase("Device and app initialization");
 
     if (TheApp->GetGoldenImageMode() != NativeAppBase::GoldenImageMode::None)
     {
@@ -494,19 +656,59 @@ int x_main(int argc, const char* const* argv)
         return TheApp->GetExitCode();
     }
 
+    if (auto pBenchmark = BenchmarkRunner::CreateFromCommandLine(argc, argv))
+    {
+        auto PumpEvents = [&]() {
+            XEvent xev;
+            while (XCheckMaskEvent(display, 0xFFFFFFFF, &xev))
+                TheApp->HandleXEvent(&xev);
+            return true;
+        };
+        const auto Completed = pBenchmark->Run(*TheApp, PumpEvents, pFrameStats.get());
+        if (pFrameStats)
+            pFrameStats->Save();
+        return Completed ? TheApp->GetExitCode() : 1;
+    }
+
     std::string Title = TheApp->GetAppTitle();
 
-    Timer             timer;
-    auto              PrevTime = timer.GetElapsedTime();
+    // The GL context is current on the main thread only
+    if (TheApp->GetThreadingModel() != AppBase::ThreadingModel::SingleThreaded)
+        LOG_WARNING_MESSAGE("Pipelined threading model is not supported by the OpenGL main loop. Falling back to single-threaded loop.");
+
+    FramePacer Pacer;
+    Pacer.SetTargetFrameRate(TheApp->GetTargetFrameRate());
     WindowTitleHelper TitleHelper(Title);
+    IdleMonitor       Idle{*TheApp};
 
+    std::vector<LinuxAppBase::PointerMotionSample> MotionBatch;
     while (true)
     {
-        bool   EscPressed = false;
+        bool   EscPressed       = false;
+        bool   HasPendingMotion = false;
+        int    NewWidth         = 0;
+        int    NewHeight        = 0;
+        XEvent PendingMotion;
         XEvent xev;
         // Handle all events in the queue
         while (XCheckMaskEvent(display, 0xFFFFFFFF, &xev))
         {
+            Idle.OnEventsReceived();
+            if (xev.type == MotionNotify)
+            {
+                // Only the last of consecutive motion events is handled
+                MotionBatch.push_back({xev.xmotion.x, xev.xmotion.y, static_cast<Uint32>(xev.xmotion.time)});
+                PendingMotion    = xev;
+                HasPendingMotion = true;
+                continue;
+            }
+
+            if (HasPendingMotion)
+            {
+                TheApp->HandleXEvent(&PendingMotion);
+                HasPendingMotion = false;
+            }
+
             TheApp->HandleXEvent(&xev);
             switch (xev.type)
             {
@@ -517,36 +719,103 @@ int x_main(int argc, const char* const* argv)
                     int    num_char = XLookupString((XKeyEvent*)&xev, buffer, _countof(buffer), &keysym, 0);
                     (void)num_char;
                     EscPressed = (keysym == XK_Escape);
+                    break;
                 }
 
                 case ConfigureNotify:
                 {
+                    // The window is resized once after all events have been processed
                     XConfigureEvent& xce = reinterpret_cast<XConfigureEvent&>(xev);
                     if (xce.width != 0 && xce.height != 0)
-                        TheApp->WindowResize(xce.width, xce.height);
+                    {
+                        NewWidth  = xce.width;
+                        NewHeight = xce.height;
+                    }
                     break;
                 }
+
+                case FocusIn:
+                case FocusOut:
+                    Idle.SetFocused(xev.type == FocusIn);
+                    break;
+
+                case MapNotify:
+                case UnmapNotify:
+                    Idle.SetMinimized(xev.type == UnmapNotify);
+                    break;
+
+                case VisibilityNotify:
+                    Idle.SetOccluded(xev.xvisibility.state == VisibilityFullyObscured);
+                    break;
             }
         }
 
+        if (HasPendingMotion)
+            TheApp->HandleXEvent(&PendingMotion);
+
+        if (!MotionBatch.empty())
+        {
+            TheApp->OnPointerMotionBatch(MotionBatch.data(), MotionBatch.size());
+            MotionBatch.clear();
+        }
+
+        if (NewWidth != 0 && NewHeight != 0)
+            TheApp->WindowResize(NewWidth, NewHeight);
+
         if (EscPressed && (TheApp->GetHotKeyFlags() & HOT_KEY_FLAG_ALLOW_EXIT_ON_ESC))
             break;
 
+        if (!Idle.ShouldRunFrame())
+        {
+            // The window is inactive: block until an event arrives or the next throttled frame is due.
+            // All maskable events have been removed from the queue, so it is safe to wait on the socket.
+            XFlush(display);
+            pollfd fd = {ConnectionNumber(display), POLLIN, 0};
+            poll(&fd, 1, Idle.GetEventWaitTimeout());
+            continue;
+        }
+
+        Idle.OnFrameStarted();
+        Pacer.WaitForNextFrame();
+        TheApp->WaitForFrameLatency();
+
         // Render the scene
-        auto CurrTime    = timer.GetElapsedTime();
-        auto ElapsedTime = CurrTime - PrevTime;
-        PrevTime         = CurrTime;
+        double CurrTime    = 0;
+        double ElapsedTime = 0;
+        Pacer.BeginFrame(CurrTime, ElapsedTime);
 
-        TheApp->Update(CurrTime, ElapsedTime);
+        if (pFrameStats)
+            pFrameStats->BeginFrame();
 
-        TheApp->Render();
+        {
+            FrameStatsRecorder::ScopedStage StageScope{pFrameStats.get(), FrameStatsRecorder::Stage::Update};
+            TheApp->Update(CurrTime, ElapsedTime);
+        }
 
-        TheApp->Present();
+        {
+            FrameStatsRecorder::ScopedStage StageScope{pFrameStats.get(), FrameStatsRecorder::Stage::Render};
+            TheApp->Render();
+        }
+
+        {
+            FrameStatsRecorder::ScopedStage StageScope{pFrameStats.get(), FrameStatsRecorder::Stage::Present};
+            TheApp->Present();
+        }
+        Startup.Finish("First frame");
 
-        auto TitleWithFPS = TitleHelper.GetTitleWithFPS(ElapsedTime);
-        XStoreName(display, win, TitleWithFPS.c_str());
+        if (TitleHelper.Update(Pacer.GetRawFrameTime()))
+            XStoreName(display, win, TitleHelper.GetTitleWithFPS().c_str());
+
+        if (pFrameStats)
+        {
+            pFrameStats->EndFrame(TheApp->GetGPUFrameTime());
+            if (pFrameStats->IsCaptureComplete())
+                break;
+        }
     }
 
+    if (pFrameStats)
+        pFrameStats->Save();
     TheApp.reset();
 
     ctx = glXGetCurrentContext();
@@ -558,6 +827,11 @@ int x_main(int argc, const char* const* argv)
     return 0;
 }
 
+#if WAYLAND_SUPPORTED
+// Defined in WaylandMain.cpp. Sets Unsupported if the application does not implement the Wayland interface.
+int wayland_main(int argc, const char* const* argv, bool& Unsupported);
+#endif
+
 int main(int argc, char** argv)
 {
 #if VULKAN_SUPPORTED
@@ -590,6 +864,19 @@ int main(int argc, char** argv)
     if (UseVulkan)
     {
 #if VULKAN_SUPPORTED
+#    if WAYLAND_SUPPORTED
+        // Use the native Wayland backend when running in a Wayland session, unless --wayland 0 is given
+        bool UseWayland = true;
+        ArgParser.Parse("wayland", UseWayland);
+        if (UseWayland && getenv("WAYLAND_DISPLAY") != nullptr)
+        {
+            bool Unsupported = false;
+
+            const auto ExitCode = wayland_main(argc, argv, Unsupported);
+            if (!Unsupported)
+                return ExitCode;
+        }
+#    endif
         return xcb_main(argc, argv);
 #else
         LOG_WARNING_MESSAGE("Vulkan backend was not built. Please select another mode.");
@@ -0,0 +1,840 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <wayland-client.h>
+#include <wayland-cursor.h>
+#include <xkbcommon/xkbcommon.h>
+
+#include "xdg-shell-client-protocol.h"
+#include "presentation-time-client-protocol.h"
+#include "viewporter-client-protocol.h"
+#include "fractional-scale-v1-client-protocol.h"
+
+#include "NativeAppBase.hpp"
+#include "Errors.hpp"
+#include "CommandLineParser.hpp"
+#include "BenchmarkRunner.hpp"
+#include "FramePacer.hpp"
+#include "FrameStatsRecorder.hpp"
+#include "IdleMonitor.hpp"
+#include "StartupTimer.hpp"
+#include "WindowTitleHelper.hpp"
+
+using namespace Diligent;
+
+namespace
+{
+
+static constexpr int DefaultWindowWidth  = 1024;
+static constexpr int DefaultWindowHeight = 768;
+static constexpr int MinWindowWidth      = 320;
+static constexpr int MinWindowHeight     = 240;
+
+// Surface-local scroll distance of one mouse wheel step, as used by most compositors
+static constexpr double AxisUnitsPerWheelStep = 10;
+
+struct WaylandWindow
+{
+    NativeAppBase* pApp = nullptr;
+
+    wl_display*                     Display            = nullptr;
+    wl_registry*                    Registry           = nullptr;
+    wl_compositor*                  Compositor         = nullptr;
+    wl_shm*                         Shm                = nullptr;
+    wl_seat*                        Seat               = nullptr;
+    wl_pointer*                     Pointer            = nullptr;
+    wl_keyboard*                    Keyboard           = nullptr;
+    xdg_wm_base*                    WmBase             = nullptr;
+    wp_presentation*                Presentation       = nullptr;
+    wp_viewporter*                  Viewporter         = nullptr;
+    wp_fractional_scale_manager_v1* FractionalScaleMgr = nullptr;
+
+    wl_surface*             Surface         = nullptr;
+    xdg_surface*            XdgSurface      = nullptr;
+    xdg_toplevel*           Toplevel        = nullptr;
+    wp_viewport*            Viewport        = nullptr;
+    wp_fractional_scale_v1* FractionalScale = nullptr;
+
+    wl_cursor_theme* CursorTheme   = nullptr;
+    wl_surface*      CursorSurface = nullptr;
+
+    xkb_context* XkbContext = nullptr;
+    xkb_keymap*  XkbKeymap  = nullptr;
+    xkb_state*   XkbState   = nullptr;
+
+    // Window size in surface-local units and the ratio between framebuffer pixels and these units
+    int   Width  = 0;
+    int   Height = 0;
+    float Scale  = 1;
+
+    // Size requested by the last toplevel configure event; applied when the surface configure arrives
+    int  PendingWidth  = 0;
+    int  PendingHeight = 0;
+    bool Configured    = false;
+    bool ResizePending = false;
+    bool Quit          = false;
+
+    // xdg-shell does not report minimized windows, only whether the toplevel is activated
+    bool Activated = true;
+
+    // Set by the input and configure events, but not by the presentation feedback
+    bool InputReceived = false;
+
+    // Motion events are coalesced, see LinuxAppBase::OnPointerMotionBatch()
+    bool                                           HasPendingMotion = false;
+    double                                         PendingMotionX   = 0;
+    double                                         PendingMotionY   = 0;
+    std::vector<LinuxAppBase::PointerMotionSample> MotionBatch;
+
+    bool ZeroCopy = false;
+
+    int GetFramebufferWidth() const { return static_cast<int>(std::lround(Width * Scale)); }
+    int GetFramebufferHeight() const { return static_cast<int>(std::lround(Height * Scale)); }
+};
+
+struct PresentationFeedbackData
+{
+    WaylandWindow* pWnd       = nullptr;
+    Uint64         FrameIndex = 0;
+};
+
+void FlushPendingMotion(WaylandWindow& Wnd)
+{
+    if (Wnd.HasPendingMotion)
+    {
+        Wnd.pApp->OnWaylandPointerMotion(Wnd.PendingMotionX, Wnd.PendingMotionY);
+        Wnd.HasPendingMotion = false;
+    }
+}
+
+// xdg_wm_base
+
+void OnWmBasePing(void* data, xdg_wm_base* wm_base, uint32_t serial)
+{
+    xdg_wm_base_pong(wm_base, serial);
+}
+
+const xdg_wm_base_listener WmBaseListener = {OnWmBasePing};
+
+// xdg_surface and xdg_toplevel
+
+void OnXdgSurfaceConfigure(void* data, xdg_surface* surface, uint32_t serial)
+{
+    auto& Wnd = *static_cast<WaylandWindow*>(data);
+    xdg_surface_ack_configure(surface, serial);
+
+    if (Wnd.PendingWidth > 0 && Wnd.PendingHeight > 0 &&
+        (Wnd.PendingWidth != Wnd.Width || Wnd.PendingHeight != Wnd.Height))
+    {
+        Wnd.Width         = Wnd.PendingWidth;
+        Wnd.Height        = Wnd.PendingHeight;
+        Wnd.ResizePending = true;
+    }
+    Wnd.Configured = true;
+}
+
+const xdg_surface_listener XdgSurfaceListener = {OnXdgSurfaceConfigure};
+
+void OnToplevelConfigure(void* data, xdg_toplevel* toplevel, int32_t width, int32_t height, wl_array* states)
+{
+    // Zero size means that the client should choose the size
+    auto& Wnd         = *static_cast<WaylandWindow*>(data);
+    Wnd.PendingWidth  = width;
+    Wnd.PendingHeight = height;
+    Wnd.InputReceived = true;
+
+    bool Activated = false;
+    for (size_t i = 0; i < states->size / sizeof(uint32_t); ++i)
+    {
+        if (static_cast<const uint32_t*>(states->data)[i] == XDG_TOPLEVEL_STATE_ACTIVATED)
+            Activated = true;
+    }
+    Wnd.Activated = Activated;
+}
+
+void OnToplevelClose(void* data, xdg_toplevel* toplevel)
+{
+    static_cast<WaylandWindow*>(data)->Quit = true;
+}
+
+const xdg_toplevel_listener ToplevelListener = {OnToplevelConfigure, OnToplevelClose};
+
+// wp_fractional_scale_v1
+
+void OnPreferredScale(void* data, wp_fractional_scale_v1* fractional_scale, uint32_t scale)
+{
+    auto& Wnd = *static_cast<WaylandWindow*>(data);
+
+    // The scale is sent in 1/120 units
+    const float NewScale = static_cast<float>(scale) / 120.f;
+    if (NewScale != Wnd.Scale)
+    {
+        Wnd.Scale         = NewScale;
+        Wnd.ResizePending = true;
+        Wnd.pApp->OnWaylandScaleChanged(NewScale);
+    }
+}
+
+const wp_fractional_scale_v1_listener FractionalScaleListener = {OnPreferredScale};
+
+// wp_presentation_feedback
+
+void OnFeedbackSyncOutput(void* data, wp_presentation_feedback* feedback, wl_output* output)
+{
+}
+
+void OnFeedbackPresented(void*                     data,
+                         wp_presentation_feedback* feedback,
+                         uint32_t                  tv_sec_hi,
+                         uint32_t                  tv_sec_lo,
+                         uint32_t                  tv_nsec,
+                         uint32_t                  refresh,
+                         uint32_t                  seq_hi,
+                         uint32_t                  seq_lo,
+                         uint32_t                  flags)
+{
+    std::unique_ptr<PresentationFeedbackData> pData{static_cast<PresentationFeedbackData*>(data)};
+    auto&                                     Wnd = *pData->pWnd;
+
+    LinuxAppBase::PresentationFeedback Feedback;
+    Feedback.FrameIndex       = pData->FrameIndex;
+    Feedback.Presented        = true;
+    Feedback.PresentationTime = ((Uint64{tv_sec_hi} << 32) | tv_sec_lo) * 1000000000ull + tv_nsec;
+    Feedback.RefreshPeriod    = refresh;
+    Feedback.ZeroCopy         = (flags & WP_PRESENTATION_FEEDBACK_KIND_ZERO_COPY) != 0;
+    Feedback.VSync            = (flags & WP_PRESENTATION_FEEDBACK_KIND_VSYNC) != 0;
+
+    if (Feedback.ZeroCopy != Wnd.ZeroCopy)
+    {
+        Wnd.ZeroCopy = Feedback.ZeroCopy;
+        LOG_INFO_MESSAGE(Wnd.ZeroCopy ? "Frames are scanned out directly" : "Frames are composited");
+    }
+
+    Wnd.pApp->OnPresentationFeedback(Feedback);
+    wp_presentation_feedback_destroy(feedback);
+}
+
+void OnFeedbackDiscarded(void* data, wp_presentation_feedback* feedback)
+{
+    std::unique_ptr<PresentationFeedbackData> pData{static_cast<PresentationFeedbackData*>(data)};
+
+    LinuxAppBase::PresentationFeedback Feedback;
+    Feedback.FrameIndex = pData->FrameIndex;
+    pData->pWnd->pApp->OnPresentationFeedback(Feedback);
+    wp_presentation_feedback_destroy(feedback);
+}
+
+const wp_presentation_feedback_listener FeedbackListener = {OnFeedbackSyncOutput, OnFeedbackPresented, OnFeedbackDiscarded};
+
+// wl_pointer
+
+void OnPointerEnter(void* data, wl_pointer* pointer, uint32_t serial, wl_surface* surface, wl_fixed_t x, wl_fixed_t y)
+{
+    auto& Wnd = *static_cast<WaylandWindow*>(data);
+
+    // The cursor image is undefined until the client sets it
+    wl_cursor* Cursor = Wnd.CursorTheme != nullptr ? wl_cursor_theme_get_cursor(Wnd.CursorTheme, "left_ptr") : nullptr;
+    if (Cursor != nullptr && Cursor->image_count > 0 && Wnd.CursorSurface != nullptr)
+    {
+        wl_cursor_image* Image = Cursor->images[0];
+        wl_pointer_set_cursor(pointer, serial, Wnd.CursorSurface, Image->hotspot_x, Image->hotspot_y);
+        wl_surface_attach(Wnd.CursorSurface, wl_cursor_image_get_buffer(Image), 0, 0);
+        wl_surface_damage(Wnd.CursorSurface, 0, 0, Image->width, Image->height);
+        wl_surface_commit(Wnd.CursorSurface);
+    }
+
+    Wnd.HasPendingMotion = true;
+    Wnd.PendingMotionX   = wl_fixed_to_double(x);
+    Wnd.PendingMotionY   = wl_fixed_to_double(y);
+}
+
+void OnPointerLeave(void* data, wl_pointer* pointer, uint32_t serial, wl_surface* surface)
+{
+}
+
+void OnPointerMotion(void* data, wl_pointer* pointer, uint32_t time, wl_fixed_t x, wl_fixed_t y)
+{
+    auto& Wnd = *static_cast<WaylandWindow*>(data);
+
+    Wnd.HasPendingMotion = true;
+    Wnd.PendingMotionX   = wl_fixed_to_double(x);
+    Wnd.PendingMotionY   = wl_fixed_to_double(y);
+    Wnd.InputReceived    = true;
+    Wnd.MotionBatch.push_back({static_cast<int>(Wnd.PendingMotionX), static_cast<int>(Wnd.PendingMotionY), time});
+}
+
+void OnPointerButton(void* data, wl_pointer* pointer, uint32_t serial, uint32_t time, uint32_t button, uint32_t state)
+{
+    auto& Wnd = *static_cast<WaylandWindow*>(data);
+    FlushPendingMotion(Wnd);
+    Wnd.InputReceived = true;
+    Wnd.pApp->OnWaylandPointerButton(button, state == WL_POINTER_BUTTON_STATE_PRESSED);
+}
+
+void OnPointerAxis(void* data, wl_pointer* pointer, uint32_t time, uint32_t axis, wl_fixed_t value)
+{
+    auto& Wnd = *static_cast<WaylandWindow*>(data);
+    FlushPendingMotion(Wnd);
+    Wnd.InputReceived = true;
+
+    // Positive axis values scroll down and right, while positive wheel steps scroll up and left
+    const auto Steps = static_cast<float>(-wl_fixed_to_double(value) / AxisUnitsPerWheelStep);
+    if (axis == WL_POINTER_AXIS_VERTICAL_SCROLL)
+        Wnd.pApp->OnWaylandPointerAxis(Steps, 0);
+    else
+        Wnd.pApp->OnWaylandPointerAxis(0, Steps);
+}
+
+void OnPointerFrame(void* data, wl_pointer* pointer)
+{
+}
+
+void OnPointerAxisSource(void* data, wl_pointer* pointer, uint32_t axis_source)
+{
+}
+
+void OnPointerAxisStop(void* data, wl_pointer* pointer, uint32_t time, uint32_t axis)
+{
+}
+
+void OnPointerAxisDiscrete(void* data, wl_pointer* pointer, uint32_t axis, int32_t discrete)
+{
+}
+
+const wl_pointer_listener PointerListener = {
+    OnPointerEnter,
+    OnPointerLeave,
+    OnPointerMotion,
+    OnPointerButton,
+    OnPointerAxis,
+    OnPointerFrame,
+    OnPointerAxisSource,
+    OnPointerAxisStop,
+    OnPointerAxisDiscrete,
+};
+
+// wl_keyboard
+
+void OnKeyboardKeymap(void* data, wl_keyboard* keyboard, uint32_t format, int32_t fd, uint32_t size)
+{
+    auto& Wnd = *static_cast<WaylandWindow*>(data);
+    if (format != WL_KEYBOARD_KEYMAP_FORMAT_XKB_V1)
+    {
+        close(fd);
+        return;
+    }
+
+    void* pKeymapStr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (pKeymapStr == MAP_FAILED)
+    {
+        LOG_ERROR_MESSAGE("Failed to map the keymap");
+        return;
+    }
+
+    xkb_keymap* Keymap = xkb_keymap_new_from_string(Wnd.XkbContext, static_cast<const char*>(pKeymapStr), XKB_KEYMAP_FORMAT_TEXT_V1, XKB_KEYMAP_COMPILE_NO_FLAGS);
+    munmap(pKeymapStr, size);
+    if (Keymap == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Failed to compile the keymap");
+        return;
+    }
+
+    xkb_state_unref(Wnd.XkbState);
+    xkb_keymap_unref(Wnd.XkbKeymap);
+    Wnd.XkbKeymap = Keymap;
+    Wnd.XkbState  = xkb_state_new(Keymap);
+}
+
+void OnKeyboardEnter(void* data, wl_keyboard* keyboard, uint32_t serial, wl_surface* surface, wl_array* keys)
+{
+}
+
+void OnKeyboardLeave(void* data, wl_keyboard* keyboard, uint32_t serial, wl_surface* surface)
+{
+}
+
+void OnKeyboardKey(void* data, wl_keyboard* keyboard, uint32_t serial, uint32_t time, uint32_t key, uint32_t state)
+{
+    auto& Wnd = *static_cast<WaylandWindow*>(data);
+    if (Wnd.XkbState == nullptr)
+        return;
+
+    // Evdev key codes are offset by 8 from XKB key codes
+    const xkb_keycode_t KeyCode   = key + 8;
+    const xkb_keysym_t  KeySym    = xkb_state_key_get_one_sym(Wnd.XkbState, KeyCode);
+    const bool          IsPressed = state == WL_KEYBOARD_KEY_STATE_PRESSED;
+
+    Wnd.InputReceived = true;
+
+    Wnd.pApp->OnWaylandKey(KeySym, IsPressed);
+    if (IsPressed)
+    {
+        char Text[16] = {};
+        if (xkb_state_key_get_utf8(Wnd.XkbState, KeyCode, Text, sizeof(Text)) > 0)
+            Wnd.pApp->OnWaylandText(Text);
+    }
+    else if (KeySym == XKB_KEY_Escape && (Wnd.pApp->GetHotKeyFlags() & HOT_KEY_FLAG_ALLOW_EXIT_ON_ESC))
+    {
+        Wnd.Quit = true;
+    }
+}
+
+void OnKeyboardModifiers(void* data, wl_keyboard* keyboard, uint32_t serial, uint32_t mods_depressed, uint32_t mods_latched, uint32_t mods_locked, uint32_t group)
+{
+    auto& Wnd = *static_cast<WaylandWindow*>(data);
+    if (Wnd.XkbState == nullptr)
+        return;
+
+    xkb_state_update_mask(Wnd.XkbState, mods_depressed, mods_latched, mods_locked, 0, 0, group);
+
+    auto IsActive = [&Wnd](const char* Name) {
+        return xkb_state_mod_name_is_active(Wnd.XkbState, Name, XKB_STATE_MODS_EFFECTIVE) > 0;
+    };
+    Wnd.pApp->OnWaylandModifiers(IsActive(XKB_MOD_NAME_CTRL), IsActive(XKB_MOD_NAME_SHIFT), IsActive(XKB_MOD_NAME_ALT), IsActive(XKB_MOD_NAME_LOGO));
+}
+
+void OnKeyboardRepeatInfo(void* data, wl_keyboard* keyboard, int32_t rate, int32_t delay)
+{
+}
+
+const wl_keyboard_listener KeyboardListener = {
+    OnKeyboardKeymap,
+    OnKeyboardEnter,
+    OnKeyboardLeave,
+    OnKeyboardKey,
+    OnKeyboardModifiers,
+    OnKeyboardRepeatInfo,
+};
+
+// wl_seat
+
+void OnSeatCapabilities(void* data, wl_seat* seat, uint32_t caps)
+{
+    auto& Wnd = *static_cast<WaylandWindow*>(data);
+
+    const bool HasPointer = (caps & WL_SEAT_CAPABILITY_POINTER) != 0;
+    if (HasPointer && Wnd.Pointer == nullptr)
+    {
+        Wnd.Pointer = wl_seat_get_pointer(seat);
+        wl_pointer_add_listener(Wnd.Pointer, &PointerListener, &Wnd);
+    }
+    else if (!HasPointer && Wnd.Pointer != nullptr)
+    {
+        wl_pointer_release(Wnd.Pointer);
+        Wnd.Pointer = nullptr;
+    }
+
+    const bool HasKeyboard = (caps & WL_SEAT_CAPABILITY_KEYBOARD) != 0;
+    if (HasKeyboard && Wnd.Keyboard == nullptr)
+    {
+        Wnd.Keyboard = wl_seat_get_keyboard(seat);
+        wl_keyboard_add_listener(Wnd.Keyboard, &KeyboardListener, &Wnd);
+    }
+    else if (!HasKeyboard && Wnd.Keyboard != nullptr)
+    {
+        wl_keyboard_release(Wnd.Keyboard);
+        Wnd.Keyboard = nullptr;
+    }
+}
+
+void OnSeatName(void* data, wl_seat* seat, const char* name)
+{
+}
+
+const wl_seat_listener SeatListener = {OnSeatCapabilities, OnSeatName};
+
+// wl_registry
+
+void OnRegistryGlobal(void* data, wl_registry* registry, uint32_t name, const char* interface, uint32_t version)
+{
+    auto& Wnd = *static_cast<WaylandWindow*>(data);
+
+    auto Bind = [&](const wl_interface& Interface, uint32_t MaxVersion) {
+        return wl_registry_bind(registry, name, &Interface, std::min(version, MaxVersion));
+    };
+
+    if (strcmp(interface, wl_compositor_interface.name) == 0)
+    {
+        Wnd.Compositor = static_cast<wl_compositor*>(Bind(wl_compositor_interface, 4));
+    }
+    else if (strcmp(interface, wl_shm_interface.name) == 0)
+    {
+        Wnd.Shm = static_cast<wl_shm*>(Bind(wl_shm_interface, 1));
+    }
+    else if (strcmp(interface, wl_seat_interface.name) == 0 && Wnd.Seat == nullptr)
+    {
+        // Listeners are provided for the events up to version 5
+        Wnd.Seat = static_cast<wl_seat*>(Bind(wl_seat_interface, 5));
+        wl_seat_add_listener(Wnd.Seat, &SeatListener, &Wnd);
+    }
+    else if (strcmp(interface, xdg_wm_base_interface.name) == 0)
+    {
+        Wnd.WmBase = static_cast<xdg_wm_base*>(Bind(xdg_wm_base_interface, 1));
+        xdg_wm_base_add_listener(Wnd.WmBase, &WmBaseListener, &Wnd);
+    }
+    else if (strcmp(interface, wp_presentation_interface.name) == 0)
+    {
+        Wnd.Presentation = static_cast<wp_presentation*>(Bind(wp_presentation_interface, 1));
+    }
+    else if (strcmp(interface, wp_viewporter_interface.name) == 0)
+    {
+        Wnd.Viewporter = static_cast<wp_viewporter*>(Bind(wp_viewporter_interface, 1));
+    }
+    else if (strcmp(interface, wp_fractional_scale_manager_v1_interface.name) == 0)
+    {
+        Wnd.FractionalScaleMgr = static_cast<wp_fractional_scale_manager_v1*>(Bind(wp_fractional_scale_manager_v1_interface, 1));
+    }
+}
+
+void OnRegistryGlobalRemove(void* data, wl_registry* registry, uint32_t name)
+{
+}
+
+const wl_registry_listener RegistryListener = {OnRegistryGlobal, OnRegistryGlobalRemove};
+
+void DestroyWaylandWindow(WaylandWindow& Wnd)
+{
+    // clang-format off
+    if (Wnd.FractionalScale)    wp_fractional_scale_v1_destroy(Wnd.FractionalScale);
+    if (Wnd.Viewport)           wp_viewport_destroy(Wnd.Viewport);
+    if (Wnd.Toplevel)           xdg_toplevel_destroy(Wnd.Toplevel);
+    if (Wnd.XdgSurface)         xdg_surface_destroy(Wnd.XdgSurface);
+    if (Wnd.Surface)            wl_surface_destroy(Wnd.Surface);
+    if (Wnd.CursorSurface)      wl_surface_destroy(Wnd.CursorSurface);
+    if (Wnd.CursorTheme)        wl_cursor_theme_destroy(Wnd.CursorTheme);
+    if (Wnd.Pointer)            wl_pointer_release(Wnd.Pointer);
+    if (Wnd.Keyboard)           wl_keyboard_release(Wnd.Keyboard);
+    if (Wnd.Seat)               wl_seat_destroy(Wnd.Seat);
+    if (Wnd.FractionalScaleMgr) wp_fractional_scale_manager_v1_destroy(Wnd.FractionalScaleMgr);
+    if (Wnd.Viewporter)         wp_viewporter_destroy(Wnd.Viewporter);
+    if (Wnd.Presentation)       wp_presentation_destroy(Wnd.Presentation);
+    if (Wnd.WmBase)             xdg_wm_base_destroy(Wnd.WmBase);
+    if (Wnd.Shm)                wl_shm_destroy(Wnd.Shm);
+    if (Wnd.Compositor)         wl_compositor_destroy(Wnd.Compositor);
+    if (Wnd.Registry)           wl_registry_destroy(Wnd.Registry);
+    if (Wnd.Display)            wl_display_disconnect(Wnd.Display);
+    // clang-format on
+
+    xkb_state_unref(Wnd.XkbState);
+    xkb_keymap_unref(Wnd.XkbKeymap);
+    xkb_context_unref(Wnd.XkbContext);
+
+    Wnd = WaylandWindow{};
+}
+
+bool CreateWaylandWindow(WaylandWindow& Wnd, const char* Title, int Width, int Height, bool Fullscreen)
+{
+    Wnd.Display = wl_display_connect(nullptr);
+    if (Wnd.Display == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Failed to connect to the Wayland display");
+        return false;
+    }
+
+    Wnd.XkbContext = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+
+    Wnd.Registry = wl_display_get_registry(Wnd.Display);
+    wl_registry_add_listener(Wnd.Registry, &RegistryListener, &Wnd);
+    // The first round trip binds the globals, the second one receives the seat capabilities
+    wl_display_roundtrip(Wnd.Display);
+    wl_display_roundtrip(Wnd.Display);
+
+    if (Wnd.Compositor == nullptr || Wnd.WmBase == nullptr)
+    {
+        LOG_ERROR_MESSAGE("The Wayland compositor does not support xdg-shell");
+        return false;
+    }
+
+    Wnd.Surface = wl_compositor_create_surface(Wnd.Compositor);
+
+    // Fractional scaling renders at the exact framebuffer resolution and lets the viewport
+    // map it to the logical size. Without it, the surface is rendered at the logical size.
+    if (Wnd.FractionalScaleMgr != nullptr && Wnd.Viewporter != nullptr)
+    {
+        Wnd.Viewport        = wp_viewporter_get_viewport(Wnd.Viewporter, Wnd.Surface);
+        Wnd.FractionalScale = wp_fractional_scale_manager_v1_get_fractional_scale(Wnd.FractionalScaleMgr, Wnd.Surface);
+        wp_fractional_scale_v1_add_listener(Wnd.FractionalScale, &FractionalScaleListener, &Wnd);
+    }
+
+    if (Wnd.Shm != nullptr)
+    {
+        Wnd.CursorTheme   = wl_cursor_theme_load(nullptr, 24, Wnd.Shm);
+        Wnd.CursorSurface = wl_compositor_create_surface(Wnd.Compositor);
+    }
+
+    Wnd.XdgSurface = xdg_wm_base_get_xdg_surface(Wnd.WmBase, Wnd.Surface);
+    xdg_surface_add_listener(Wnd.XdgSurface, &XdgSurfaceListener, &Wnd);
+    Wnd.Toplevel = xdg_surface_get_toplevel(Wnd.XdgSurface);
+    xdg_toplevel_add_listener(Wnd.Toplevel, &ToplevelListener, &Wnd);
+    xdg_toplevel_set_title(Wnd.Toplevel, Title);
+    xdg_toplevel_set_app_id(Wnd.Toplevel, Title);
+    xdg_toplevel_set_min_size(Wnd.Toplevel, MinWindowWidth, MinWindowHeight);
+    if (Fullscreen)
+        xdg_toplevel_set_fullscreen(Wnd.Toplevel, nullptr);
+
+    Wnd.Width  = Width;
+    Wnd.Height = Height;
+
+    // The surface must not be attached to a buffer before the first configure event is acknowledged
+    wl_surface_commit(Wnd.Surface);
+    while (!Wnd.Configured)
+    {
+        if (wl_display_dispatch(Wnd.Display) < 0)
+        {
+            LOG_ERROR_MESSAGE("Wayland connection was lost");
+            return false;
+        }
+    }
+
+    if (Wnd.Viewport != nullptr)
+        wp_viewport_set_destination(Wnd.Viewport, Wnd.Width, Wnd.Height);
+
+    return true;
+}
+
+// Dispatches the pending events, waiting at most Timeout milliseconds for them to arrive (-1 - no limit).
+// All requests queued during the frame are sent with a single flush. Returns false if the window
+// was closed or the connection was lost.
+bool PumpWaylandEvents(WaylandWindow& Wnd, int Timeout = 0)
+{
+    while (wl_display_prepare_read(Wnd.Display) != 0)
+        wl_display_dispatch_pending(Wnd.Display);
+    wl_display_flush(Wnd.Display);
+
+    pollfd fd = {wl_display_get_fd(Wnd.Display), POLLIN, 0};
+    if (poll(&fd, 1, Timeout) > 0)
+        wl_display_read_events(Wnd.Display);
+    else
+        wl_display_cancel_read(Wnd.Display);
+
+    if (wl_display_dispatch_pending(Wnd.Display) < 0)
+    {
+        LOG_ERROR_MESSAGE("Wayland connection was lost");
+        return false;
+    }
+
+    FlushPendingMotion(Wnd);
+    if (!Wnd.MotionBatch.empty())
+    {
+        Wnd.pApp->OnPointerMotionBatch(Wnd.MotionBatch.data(), Wnd.MotionBatch.size());
+        Wnd.MotionBatch.clear();
+    }
+
+    if (Wnd.ResizePending)
+    {
+        if (Wnd.Viewport != nullptr)
+            wp_viewport_set_destination(Wnd.Viewport, Wnd.Width, Wnd.Height);
+        Wnd.pApp->WindowResize(Wnd.GetFramebufferWidth(), Wnd.GetFramebufferHeight());
+        Wnd.ResizePending = false;
+    }
+
+    return !Wnd.Quit;
+}
+
+// Requests the presentation feedback for the next surface commit, which is made by the swap chain
+void RequestPresentationFeedback(WaylandWindow& Wnd, Uint64 FrameIndex)
+{
+    if (Wnd.Presentation == nullptr)
+        return;
+
+    auto* pFeedback = wp_presentation_feedback(Wnd.Presentation, Wnd.Surface);
+    wp_presentation_feedback_add_listener(pFeedback, &FeedbackListener, new PresentationFeedbackData{&Wnd, FrameIndex});
+}
+
+} // namespace
+
+int wayland_main(int argc, const char* const* argv, bool& Unsupported)
+{
+    StartupTimer Startup;
+
+    std::unique_ptr<NativeAppBase> TheApp{CreateApplication()};
+
+    Unsupported = !TheApp->IsWaylandSupported();
+    if (Unsupported)
+        return 0;
+
+    if (argc > 0 && argv != nullptr)
+    {
+        auto CmdLineStatus = TheApp->ProcessCommandLine(argc, argv);
+        if (CmdLineStatus == AppBase::CommandLineStatus::Help)
+            return 0;
+        else if (CmdLineStatus == AppBase::CommandLineStatus::Error)
+            return 1;
+    }
+
+    auto pFrameStats = FrameStatsRecorder::CreateFromCommandLine(argc, argv);
+    Startup.EndPhase("Command line");
+
+    // Asset loading started by the application runs while the window and the device are created
+    TheApp->OnStartup();
+    Startup.EndPhase("OnStartup");
+
+    // Compositors only scan out full-screen surfaces directly
+    bool Fullscreen = false;
+    if (argc > 0 && argv != nullptr)
+    {
+        CommandLineParser ArgsParser{argc, argv};
+        ArgsParser.Parse("wayland_fullscreen", Fullscreen, false);
+    }
+
+    int DesiredWidth  = 0;
+    int DesiredHeight = 0;
+    TheApp->GetDesiredInitialWindowSize(DesiredWidth, DesiredHeight);
+
+    WaylandWindow Wnd;
+    Wnd.pApp = TheApp.get();
+
+    std::string Title = TheApp->GetAppTitle();
+    if (!CreateWaylandWindow(Wnd, Title.c_str(), DesiredWidth > 0 ? DesiredWidth : DefaultWindowWidth, DesiredHeight > 0 ? DesiredHeight : DefaultWindowHeight, Fullscreen))
+    {
+        DestroyWaylandWindow(Wnd);
+        return 1;
+    }
+    Startup.EndPhase("Window creation");
+
+    if (!TheApp->InitVulkan(Wnd.Display, Wnd.Surface))
+    {
+        TheApp.reset();
+        DestroyWaylandWindow(Wnd);
+        return 1;
+    }
+    Startup.EndPhase("Device and app initialization");
+    // Sync the swap chain with the configured size and scale
+    TheApp->WindowResize(Wnd.GetFramebufferWidth(), Wnd.GetFramebufferHeight());
+    Wnd.ResizePending = false;
+
+    int ExitCode = 0;
+    if (TheApp->GetGoldenImageMode() != NativeAppBase::GoldenImageMode::None)
+    {
+        TheApp->Update(0, 0);
+        TheApp->Render();
+
+        // Dear imgui windows that don't have initial size are not rendered in the first frame,
+        // see https://github.com/ocornut/imgui/issues/2949
+        TheApp->Update(0, 0);
+        TheApp->Render();
+        TheApp->Present();
+
+        ExitCode = TheApp->GetExitCode();
+    }
+    else if (auto pBenchmark = BenchmarkRunner::CreateFromCommandLine(argc, argv))
+    {
+        const auto Completed = pBenchmark->Run(
+            *TheApp, [&Wnd]() { return PumpWaylandEvents(Wnd); }, pFrameStats.get());
+        if (pFrameStats)
+            pFrameStats->Save();
+        ExitCode = Completed ? TheApp->GetExitCode() : 1;
+    }
+    else
+    {
+        if (TheApp->GetThreadingModel() != AppBase::ThreadingModel::SingleThreaded)
+            LOG_WARNING_MESSAGE("Pipelined threading model is not supported by the Wayland main loop. Falling back to single-threaded loop.");
+
+        FramePacer Pacer;
+        Pacer.SetTargetFrameRate(TheApp->GetTargetFrameRate());
+        WindowTitleHelper TitleHelper(TheApp->GetAppTitle());
+        IdleMonitor       Idle{*TheApp};
+
+        int    WaitTimeout = 0;
+        Uint64 FrameIndex  = 0;
+        while (PumpWaylandEvents(Wnd, WaitTimeout))
+        {
+            Idle.SetFocused(Wnd.Activated);
+            if (Wnd.InputReceived)
+            {
+                Idle.OnEventsReceived();
+                Wnd.InputReceived = false;
+            }
+
+            // While the window is inactive, the next pump blocks until an event arrives or the next throttled frame is due
+            WaitTimeout = 0;
+            if (!Idle.ShouldRunFrame())
+            {
+                WaitTimeout = Idle.GetEventWaitTimeout();
+                continue;
+            }
+
+            Idle.OnFrameStarted();
+            Pacer.WaitForNextFrame();
+            TheApp->WaitForFrameLatency();
+
+            double CurrTime    = 0;
+            double ElapsedTime = 0;
+            Pacer.BeginFrame(CurrTime, ElapsedTime);
+
+            if (pFrameStats)
+                pFrameStats->BeginFrame();
+
+            {
+                FrameStatsRecorder::ScopedStage StageScope{pFrameStats.get(), FrameStatsRecorder::Stage::Update};
+                TheApp->Update(CurrTime, ElapsedTime);
+            }
+
+            {
+                FrameStatsRecorder::ScopedStage StageScope{pFrameStats.get(), FrameStatsRecorder::Stage::Render};
+                TheApp->Render();
+            }
+
+            {
+                FrameStatsRecorder::ScopedStage StageScope{pFrameStats.get(), FrameStatsRecorder::Stage::Present};
+                RequestPresentationFeedback(Wnd, FrameIndex++);
+                TheApp->Present();
+            }
+            Startup.Finish("First frame");
+
+            if (TitleHelper.Update(Pacer.GetRawFrameTime()))
+                xdg_toplevel_set_title(Wnd.Toplevel, TitleHelper.GetTitleWithFPS().c_str());
+
+            if (pFrameStats)
+            {
+                pFrameStats->EndFrame(TheApp->GetGPUFrameTime());
+                if (pFrameStats->IsCaptureComplete())
+                    break;
+            }
+        }
+
+        if (pFrameStats)
+            pFrameStats->Save();
+    }
+
+    TheApp.reset();
+    DestroyWaylandWindow(Wnd);
+
+    return ExitCode;
+}
@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace Diligent
+{
+
+// Every title change is a request to the display server, so the title is only
+// rebuilt and sent a few times per second rather than every frame.
+class WindowTitleHelper
+{
+public:
+    WindowTitleHelper(std::string _Title) :
+        Title{std::move(_Title)},
+        LastUpdateTime{std::chrono::steady_clock::now()}
+    {}
+
+    // Accumulates the frame time and returns true if the title needs to be updated
+    bool Update(double ElapsedTime)
+    {
+        double filterScale = 0.2;
+        FilteredFrameTime  = FilteredFrameTime * (1.0 - filterScale) + filterScale * ElapsedTime;
+
+        const auto CurrTime = std::chrono::steady_clock::now();
+        if (CurrTime - LastUpdateTime < UpdateInterval)
+            return false;
+        LastUpdateTime = CurrTime;
+
+        TitleWithFpsSS.str({});
+        TitleWithFpsSS << Title;
+        TitleWithFpsSS << " - " << std::fixed << std::setprecision(1) << FilteredFrameTime * 1000;
+        TitleWithFpsSS << " ms (" << 1.0 / FilteredFrameTime << " fps)";
+        TitleWithFPS = TitleWithFpsSS.str();
+        return true;
+    }
+
+    const std::string& GetTitleWithFPS() const
+    {
+        return TitleWithFPS;
+    }
+
+private:
+    const std::chrono::milliseconds       UpdateInterval{500};
+    const std::string                     Title;
+    std::string                           TitleWithFPS;
+    std::stringstream                     TitleWithFpsSS;
+    std::chrono::steady_clock::time_point LastUpdateTime;
+    double                                FilteredFrameTime = 0.0;
+};
+
+} // namespace Diligent
@@ -25,6 +25,7 @@
  *  of the possibility of such damages.
  */
 
+#include <algorithm>
 #include <memory>
 #include <iomanip>
 #include <iostream>
@@ -38,11 +39,20 @@
 
 #include "NativeAppBase.hpp"
 #include "StringTools.hpp"
-#include "Timer.hpp"
+#include "BenchmarkRunner.hpp"
+#include "FramePacer.hpp"
+#include "FramePipeline.hpp"
+#include "FrameStatsRecorder.hpp"
+#include "IdleMonitor.hpp"
+#include "StartupTimer.hpp"
 
 using namespace Diligent;
 
 std::unique_ptr<NativeAppBase> g_pTheApp;
+std::unique_ptr<FramePipeline> g_pFramePipeline;
+std::unique_ptr<IdleMonitor>   g_pIdleMonitor;
+HWND                           g_MainWnd = NULL;
+std::vector<HWND>              g_AdditionalWindows; // Indexed by window id, closed windows are NULL
 
 LRESULT CALLBACK MessageProc(HWND, UINT, WPARAM, LPARAM);
 // Main
@@ -55,6 +65,8 @@ int WINAPI WinMain(_In_ HINSTANCE     hInstance,
     _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 #endif
 
+    StartupTimer Startup;
+
     g_pTheApp.reset(CreateApplication());
 
     const auto* CmdLine = GetCommandLineA();
@@ -70,6 +82,13 @@ int WINAPI WinMain(_In_ HINSTANCE     hInstance,
     else if (CmdLineStatus == AppBase::CommandLineStatus::Error)
         return -1;
 
+    auto pFrameStats = FrameStatsRecorder::CreateFromCommandLine(static_cast<int>(ArgsV.size()), ArgsV.data());
+    Startup.EndPhase("Command line");
+
+    // Asset loading started by the application runs while the window and the device are created
+    g_pTheApp->OnStartup();
+    Startup.EndPhase("OnStartup");
+
     const auto* AppTitle = g_pTheApp->GetAppTitle();
 
 #ifdef UNICODE
@@ -99,12 +118,51 @@ int WINAPI WinMain(_In_ HINSTANCE     hInstance,
         std::cerr << "Failed to create a window";
         return -1;
     }
+    Startup.EndPhase("Window creation");
 
     if (!g_pTheApp->OnWindowCreated(wnd, WindowWidth, WindowHeight))
     {
         std::cerr << "Failed to initialize application " << AppTitle;
         return -1;
     }
+    g_MainWnd = wnd;
+
+    const auto NumAdditionalWindows = g_pTheApp->GetNumAdditionalWindows();
+    if (NumAdditionalWindows > 0 && g_pTheApp->GetThreadingModel() == AppBase::ThreadingModel::Pipelined)
+    {
+        LOG_WARNING_MESSAGE("Additional windows are not supported by the pipelined threading model");
+    }
+    else
+    {
+        // Additional windows share the device created by OnWindowCreated
+        g_AdditionalWindows.resize(NumAdditionalWindows);
+        for (Uint32 WindowId = 0; WindowId < NumAdditionalWindows; ++WindowId)
+        {
+            int Width  = 0;
+            int Height = 0;
+            g_pTheApp->GetDesiredAdditionalWindowSize(WindowId, Width, Height);
+            LONG AddWndWidth  = Width > 0 ? Width : 1280;
+            LONG AddWndHeight = Height > 0 ? Height : 1024;
+            RECT AddWndRect   = {0, 0, AddWndWidth, AddWndHeight};
+            AdjustWindowRect(&AddWndRect, WS_OVERLAPPEDWINDOW, FALSE);
+            HWND AddWnd = CreateWindowA("SampleApp", g_pTheApp->GetAdditionalWindowTitle(WindowId),
+                                        WS_OVERLAPPEDWINDOW, CW_USEDEFAULT, CW_USEDEFAULT,
+                                        AddWndRect.right - AddWndRect.left, AddWndRect.bottom - AddWndRect.top, NULL, NULL, hInstance, NULL);
+            if (!AddWnd)
+            {
+                std::cerr << "Failed to create an additional window";
+                return -1;
+            }
+            g_AdditionalWindows[WindowId] = AddWnd;
+
+            if (!g_pTheApp->OnAdditionalWindowCreated(WindowId, AddWnd, AddWndWidth, AddWndHeight))
+            {
+                std::cerr << "Failed to initialize additional window " << WindowId << " of application " << AppTitle;
+                return -1;
+            }
+        }
+    }
+    Startup.EndPhase("Device and app initialization");
 
     auto GoldenImgMode = g_pTheApp->GetGoldenImageMode();
     if (GoldenImgMode != NativeAppBase::GoldenImageMode::None)
@@ -121,14 +179,43 @@ int WINAPI WinMain(_In_ HINSTANCE     hInstance,
         return ExitCode;
     }
 
+    if (auto pBenchmark = BenchmarkRunner::CreateFromCommandLine(static_cast<int>(ArgsV.size()), ArgsV.data()))
+    {
+        // As in the golden image mode, the window is never shown
+        auto PumpMessages = []() {
+            MSG msg = {0};
+            while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+            {
+                if (msg.message == WM_QUIT)
+                    return false;
+                TranslateMessage(&msg);
+                DispatchMessage(&msg);
+            }
+            return true;
+        };
+        const auto Completed = pBenchmark->Run(*g_pTheApp, PumpMessages, pFrameStats.get());
+        if (pFrameStats)
+            pFrameStats->Save();
+        auto ExitCode = Completed ? g_pTheApp->GetExitCode() : -1;
+        g_pTheApp.reset();
+        return ExitCode;
+    }
+
+    g_pIdleMonitor.reset(new IdleMonitor{*g_pTheApp});
+
     ShowWindow(wnd, nShowCmd);
     UpdateWindow(wnd);
+    for (auto AddWnd : g_AdditionalWindows)
+    {
+        ShowWindow(AddWnd, nShowCmd);
+        UpdateWindow(AddWnd);
+    }
 
     AppTitle = g_pTheApp->GetAppTitle();
 
-    Diligent::Timer Timer;
+    FramePacer Pacer;
+    Pacer.SetTargetFrameRate(g_pTheApp->GetTargetFrameRate());
 
-    auto   PrevTime          = Timer.GetElapsedTime();
     double filteredFrameTime = 0.0;
 
     // Main message loop
@@ -139,23 +226,77 @@ int WINAPI WinMain(_In_ HINSTANCE     hInstance,
         {
             TranslateMessage(&msg);
             DispatchMessage(&msg);
+            g_pIdleMonitor->OnEventsReceived();
+        }
+        else if (g_pFramePipeline)
+        {
+            // Update and render threads run the frames, the main thread only pumps the messages
+            MsgWaitForMultipleObjects(0, NULL, FALSE, 16, QS_ALLINPUT);
+
+            double filterScale = 0.2;
+            filteredFrameTime  = filteredFrameTime * (1.0 - filterScale) + filterScale * g_pFramePipeline->GetFrameTime();
+            std::stringstream fpsCounterSS;
+            fpsCounterSS << AppTitle << " - " << std::fixed << std::setprecision(1) << filteredFrameTime * 1000;
+            fpsCounterSS << " ms (" << 1.0 / filteredFrameTime << " fps)";
+            SetWindowTextA(wnd, fpsCounterSS.str().c_str());
         }
         else
         {
-            auto CurrTime    = Timer.GetElapsedTime();
-            auto ElapsedTime = CurrTime - PrevTime;
-            PrevTime         = CurrTime;
-
-            if (g_pTheApp->IsReady())
+            if (g_pTheApp->IsReady() && g_pTheApp->GetThreadingModel() == AppBase::ThreadingModel::Pipelined)
+            {
+                if (pFrameStats)
+                {
+                    LOG_WARNING_MESSAGE("Frame statistics are only recorded by the single-threaded main loop");
+                    pFrameStats.reset();
+                }
+                g_pFramePipeline.reset(new FramePipeline{*g_pTheApp});
+                Startup.Finish("Frame pipeline start");
+            }
+            else if (g_pTheApp->IsReady() && !g_pIdleMonitor->ShouldRunFrame())
+            {
+                // The window is inactive: block until a message arrives or the next throttled frame is due
+                const auto Timeout = g_pIdleMonitor->GetEventWaitTimeout();
+                MsgWaitForMultipleObjects(0, NULL, FALSE, Timeout < 0 ? INFINITE : static_cast<DWORD>(Timeout), QS_ALLINPUT);
+            }
+            else if (g_pTheApp->IsReady())
             {
-                g_pTheApp->Update(CurrTime, ElapsedTime);
+                g_pIdleMonitor->OnFrameStarted();
+                Pacer.WaitForNextFrame();
+                g_pTheApp->WaitForFrameLatency();
 
-                g_pTheApp->Render();
+                double CurrTime    = 0;
+                double ElapsedTime = 0;
+                Pacer.BeginFrame(CurrTime, ElapsedTime);
 
-                g_pTheApp->Present();
+                if (pFrameStats)
+                    pFrameStats->BeginFrame();
+
+                {
+                    FrameStatsRecorder::ScopedStage StageScope{pFrameStats.get(), FrameStatsRecorder::Stage::Update};
+                    g_pTheApp->Update(CurrTime, ElapsedTime);
+                }
+
+                {
+                    FrameStatsRecorder::ScopedStage StageScope{pFrameStats.get(), FrameStatsRecorder::Stage::Render};
+                    g_pTheApp->Render();
+                }
+
+                {
+                    FrameStatsRecorder::ScopedStage StageScope{pFrameStats.get(), FrameStatsRecorder::Stage::Present};
+                    g_pTheApp->Present();
+                }
+
+                Startup.Finish("First frame");
+
+                if (pFrameStats)
+                {
+                    pFrameStats->EndFrame(g_pTheApp->GetGPUFrameTime());
+                    if (pFrameStats->IsCaptureComplete())
+                        PostQuitMessage(0);
+                }
 
                 double filterScale = 0.2;
-                filteredFrameTime  = filteredFrameTime * (1.0 - filterScale) + filterScale * ElapsedTime;
+                filteredFrameTime  = filteredFrameTime * (1.0 - filterScale) + filterScale * Pacer.GetRawFrameTime();
                 std::stringstream fpsCounterSS;
                 fpsCounterSS << AppTitle << " - " << std::fixed << std::setprecision(1) << filteredFrameTime * 1000;
                 fpsCounterSS << " ms (" << 1.0 / filteredFrameTime << " fps)";
@@ -164,6 +305,10 @@ int WINAPI WinMain(_In_ HINSTANCE     hInstance,
         }
     }
 
+    g_pFramePipeline.reset();
+    g_pIdleMonitor.reset();
+    if (pFrameStats)
+        pFrameStats->Save();
     g_pTheApp.reset();
 
     return (int)msg.wParam;
@@ -172,6 +317,15 @@ int WINAPI WinMain(_In_ HINSTANCE     hInstance,
 // Called every time the NativeNativeAppBase receives a message
 LRESULT CALLBACK MessageProc(HWND wnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
+    if (g_pIdleMonitor)
+    {
+        // Track the window state before the application handles the message
+        if (message == WM_ACTIVATEAPP)
+            g_pIdleMonitor->SetFocused(wParam != FALSE);
+        else if (message == WM_SIZE && wnd == g_MainWnd)
+            g_pIdleMonitor->SetMinimized(wParam == SIZE_MINIMIZED);
+    }
+
     if (g_pTheApp)
     {
         auto res = g_pTheApp->HandleWin32Message(wnd, message, wParam, lParam);
@@ -179,6 +333,29 @@ LRESULT CALLBACK MessageProc(HWND wnd, UINT message, WPARAM wParam, LPARAM lPara
             return res;
     }
 
+    const auto AddWndIt = std::find(g_AdditionalWindows.begin(), g_AdditionalWindows.end(), wnd);
+    if (wnd != NULL && AddWndIt != g_AdditionalWindows.end())
+    {
+        const auto WindowId = static_cast<Uint32>(AddWndIt - g_AdditionalWindows.begin());
+        switch (message)
+        {
+            case WM_SIZE:
+                if (g_pTheApp)
+                    g_pTheApp->AdditionalWindowResize(WindowId, LOWORD(lParam), HIWORD(lParam));
+                return 0;
+
+            case WM_CLOSE:
+                // The application must release the swap chain before the window is destroyed
+                if (g_pTheApp)
+                    g_pTheApp->OnAdditionalWindowClosed(WindowId);
+                *AddWndIt = NULL;
+                return DefWindowProc(wnd, message, wParam, lParam);
+
+            default:
+                break;
+        }
+    }
+
     switch (message)
     {
         case WM_PAINT:
@@ -189,7 +366,11 @@ LRESULT CALLBACK MessageProc(HWND wnd, UINT message, WPARAM wParam, LPARAM lPara
             return 0;
         }
         case WM_SIZE: // Window size has been changed
-            if (g_pTheApp)
+            if (g_pFramePipeline)
+            {
+                g_pFramePipeline->RequestResize(LOWORD(lParam), HIWORD(lParam));
+            }
+            else if (g_pTheApp)
             {
                 g_pTheApp->WindowResize(LOWORD(lParam), HIWORD(lParam));
             }
@@ -200,8 +381,15 @@ LRESULT CALLBACK MessageProc(HWND wnd, UINT message, WPARAM wParam, LPARAM lPara
                 PostQuitMessage(0);
             return 0;
 
+        case WM_CLOSE:
+            // The render thread must not present to the window after it has been destroyed
+            g_pFramePipeline.reset();
+            return DefWindowProc(wnd, message, wParam, lParam);
+
         case WM_DESTROY:
-            PostQuitMessage(0);
+            // Closing an additional window does not quit the application
+            if (wnd == g_MainWnd)
+                PostQuitMessage(0);
             return 0;
 
         case WM_GETMINMAXINFO:
@@ -0,0 +1,61 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+// Hash that names the chunks of a content-addressed render state archive.
+// The value must be identical on all platforms and compilers, so std::hash can't be used.
+inline Uint64 ComputeArchiveChunkHash(const void* pData, size_t Size)
+{
+    // 64-bit FNV-1a
+    Uint64      Hash   = 0xcbf29ce484222325ull;
+    const auto* pBytes = static_cast<const Uint8*>(pData);
+    for (size_t i = 0; i < Size; ++i)
+    {
+        Hash ^= pBytes[i];
+        Hash *= 0x100000001b3ull;
+    }
+    return Hash;
+}
+
+// Returns the hash as 16 lowercase hexadecimal digits
+inline std::string ArchiveChunkHashToString(Uint64 Hash)
+{
+    char Str[17] = {};
+    std::snprintf(Str, sizeof(Str), "%08x%08x", static_cast<unsigned>(Hash >> 32u), static_cast<unsigned>(Hash & 0xFFFFFFFFu));
+    return Str;
+}
+
+} // namespace Diligent
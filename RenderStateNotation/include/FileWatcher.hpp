@@ -0,0 +1,90 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Watches directories for changes of render state notation and shader files.
+
+/// The directories are watched on a background thread using the native file system
+/// notifications where they are available (inotify on Linux and Android, ReadDirectoryChangesW
+/// on Windows). On other platforms, the background thread periodically checks the file
+/// modification times. The directories are not watched recursively.
+class FileWatcher
+{
+public:
+    /// \param [in] Directories   - Semicolon-separated list of directories to watch.
+    /// \param [in] DebounceTimeMs - The time, in milliseconds, that must pass after the last
+    ///                              detected change before the changes are reported.
+    ///                              Since editors often write a file in several steps, this
+    ///                              prevents reloading the states multiple times per save.
+    FileWatcher(const Char* Directories, Uint32 DebounceTimeMs);
+    ~FileWatcher();
+
+    // clang-format off
+    FileWatcher           (const FileWatcher&)  = delete;
+    FileWatcher           (      FileWatcher&&) = delete;
+    FileWatcher& operator=(const FileWatcher&)  = delete;
+    FileWatcher& operator=(      FileWatcher&&) = delete;
+    // clang-format on
+
+    /// Returns true if any of the watched files has changed since the last call, and no
+    /// further changes have been detected during the debounce time.
+
+    /// \remarks The method only checks a flag set by the background thread and does not access the disk.
+    bool ConsumeChanges();
+
+private:
+    void WatchThreadFunc();
+
+    void OnFileChanged(const char* FileName);
+
+    static bool IsWatchedFile(const char* FileName);
+
+    std::vector<std::string>        m_Directories;
+    const std::chrono::milliseconds m_DebounceTime;
+
+    std::mutex                            m_Mtx;
+    bool                                  m_HasChanges = false;
+    std::chrono::steady_clock::time_point m_LastChangeTime;
+
+    std::atomic_bool m_Stop{false};
+    std::thread      m_Thread;
+};
+
+} // namespace Diligent
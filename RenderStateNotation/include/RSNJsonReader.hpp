@@ -0,0 +1,177 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <string>
+#include <type_traits>
+
+#include "BasicTypes.h"
+#include "DynamicLinearAllocator.hpp"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+/// Pull parser that reads render state notation JSON text token by token.
+
+/// The generated ReadRSN() functions use the reader to deserialize the text directly into
+/// the reflected structures without building the nlohmann::json document. Keys and enum names
+/// are decoded into a reusable scratch string, and string values are copied straight into
+/// the linear allocator, so parsing does not allocate memory per value.
+///
+/// Objects are read as follows:
+///
+///     Reader.BeginObject();
+///     while (const char* Key = Reader.NextKey())
+///         ...read the value or call Reader.SkipValue()
+///
+/// Arrays are read with BeginArray() and NextElement() in the same way.
+/// All errors are reported by throwing an exception that contains the line and column.
+class RSNJsonReader
+{
+public:
+    RSNJsonReader(const char* pBegin, const char* pEnd) :
+        m_pBegin{pBegin},
+        m_pCur{pBegin},
+        m_pEnd{pEnd}
+    {}
+
+    // clang-format off
+    RSNJsonReader           (const RSNJsonReader&)  = delete;
+    RSNJsonReader           (      RSNJsonReader&&) = delete;
+    RSNJsonReader& operator=(const RSNJsonReader&)  = delete;
+    RSNJsonReader& operator=(      RSNJsonReader&&) = delete;
+    // clang-format on
+
+    bool IsObject() { return Peek() == '{'; }
+    bool IsArray() { return Peek() == '['; }
+    bool IsString() { return Peek() == '"'; }
+    bool IsNull() { return Peek() == 'n'; }
+
+    void BeginObject();
+
+    /// Returns the next key of the current object, or null when the object has ended.
+    /// The key is valid until the next call that reads a key or an unallocated string.
+    const char* NextKey();
+
+    void BeginArray();
+
+    /// Returns false when the current array has ended.
+    bool NextElement();
+
+    /// Returns the number of elements of the array that starts at the current position
+    /// without advancing the reader.
+    size_t CountArrayElements();
+
+    /// Reads a string value into the scratch buffer.
+    /// The string is valid until the next call that reads a key or an unallocated string.
+    const std::string& ReadString();
+
+    /// Reads a string value and copies it to the allocator.
+    const char* ReadString(DynamicLinearAllocator& Allocator);
+
+    bool ReadBool();
+
+    template <typename Type>
+    Type ReadNumber()
+    {
+        static_assert(std::is_arithmetic<Type>::value, "Arithmetic type is expected");
+        return ReadNumber<Type>(std::is_floating_point<Type>{});
+    }
+
+    /// Skips the value at the current position, including all nested values.
+    void SkipValue();
+
+    /// Checks that only whitespace follows the parsed value.
+    void Finish();
+
+    template <typename... ArgsType>
+    [[noreturn]] void Error(const ArgsType&... Args) const
+    {
+        Uint32 Line   = 1;
+        Uint32 Column = 1;
+        for (const char* pChar = m_pBegin; pChar < m_pCur; ++pChar)
+        {
+            if (*pChar == '\n')
+            {
+                ++Line;
+                Column = 1;
+            }
+            else
+            {
+                ++Column;
+            }
+        }
+        LOG_ERROR_AND_THROW("JSON parse error at line ", Line, ", column ", Column, ": ", Args...);
+    }
+
+private:
+    char Peek();
+    void Expect(char Symbol);
+    void ReadStringTo(std::string& Str);
+
+    // Copies the number token to a null-terminated buffer and returns its length
+    size_t ReadNumberToken(char (&Token)[64]);
+
+    template <typename Type>
+    Type ReadNumber(std::true_type /*IsFloatingPoint*/)
+    {
+        return static_cast<Type>(ReadDouble());
+    }
+
+    template <typename Type>
+    Type ReadNumber(std::false_type /*IsFloatingPoint*/)
+    {
+        return std::is_signed<Type>::value ?
+            static_cast<Type>(ReadSignedInteger()) :
+            static_cast<Type>(ReadUnsignedInteger());
+    }
+
+    double ReadDouble();
+    Int64  ReadSignedInteger();
+    Uint64 ReadUnsignedInteger();
+
+    const char* const m_pBegin;
+    const char*       m_pCur;
+    const char* const m_pEnd;
+
+    // Set by BeginObject() and BeginArray(), and reset by the first NextKey() or NextElement()
+    // that follows. Nested containers are fully read before the outer one continues, so a single
+    // flag is enough to tell the first element, which is not preceded by a comma.
+    bool m_IsFirstElement = false;
+
+    std::string m_Scratch;
+};
+
+template <>
+inline bool RSNJsonReader::ReadNumber<bool>()
+{
+    return ReadBool();
+}
+
+} // namespace Diligent
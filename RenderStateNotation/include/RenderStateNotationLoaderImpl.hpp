@@ -26,17 +26,79 @@
 
 #pragma once
 
+#include <array>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <thread>
 
 #include "RenderStateNotationLoader.h"
 #include "RefCntAutoPtr.hpp"
+#include "MemoryAllocator.h"
 #include "ObjectBase.hpp"
 #include "HashUtils.hpp"
 #include "RenderStateCache.hpp"
+#include "ThreadPool.hpp"
+#include "FileWatcher.hpp"
+#include "ShaderResourceBindingCache.hpp"
 
 namespace Diligent
 {
 
+/// Implementation of IPipelineStateLoadTask
+class PipelineStateLoadTaskImpl final : public ObjectBase<IPipelineStateLoadTask>
+{
+public:
+    using TBase = ObjectBase<IPipelineStateLoadTask>;
+
+public:
+    PipelineStateLoadTaskImpl(IReferenceCounters*          pRefCounters,
+                              const LoadPipelineStateInfo& LoadInfo);
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_PipelineStateLoadTask, TBase);
+
+    virtual bool DILIGENT_CALL_TYPE IsComplete() const override final
+    {
+        return m_IsComplete.load();
+    }
+
+    virtual IPipelineState* DILIGENT_CALL_TYPE GetPipelineState() override final
+    {
+        return m_IsComplete.load() ? m_pPSO.RawPtr() : nullptr;
+    }
+
+    virtual void DILIGENT_CALL_TYPE WaitForCompletion() override final;
+
+    /// Returns the copy of the load info the task was created with.
+    const LoadPipelineStateInfo& GetLoadInfo() const
+    {
+        return m_LoadInfo;
+    }
+
+    /// Adds the function to call when the task is complete, or calls it right away if the task is already complete.
+    void AddCallback(void (*OnPipelineLoaded)(IPipelineState*, void*), void* pUserData);
+
+    /// Sets the resulting pipeline state and calls the registered callbacks.
+    void Complete(IPipelineState* pPSO);
+
+private:
+    using CallbackType = std::pair<void (*)(IPipelineState*, void*), void*>;
+
+    const std::string     m_Name;
+    LoadPipelineStateInfo m_LoadInfo;
+
+    std::mutex                    m_Mtx;
+    std::condition_variable       m_CompleteCV;
+    std::atomic_bool              m_IsComplete{false};
+    RefCntAutoPtr<IPipelineState> m_pPSO;
+    std::vector<CallbackType>     m_Callbacks;
+};
+
 /// Implementation of IRenderStateNotationLoader
 class RenderStateNotationLoaderImpl final : public ObjectBase<IRenderStateNotationLoader>
 {
@@ -46,11 +108,16 @@ public:
 public:
     RenderStateNotationLoaderImpl(IReferenceCounters*                        pRefCounters,
                                   const RenderStateNotationLoaderCreateInfo& CreateInfo);
+    ~RenderStateNotationLoaderImpl();
 
     IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_RenderStateNotationLoader, TBase);
 
     virtual void DILIGENT_CALL_TYPE LoadPipelineState(const LoadPipelineStateInfo& LoadInfo, IPipelineState** ppPSO) override final;
 
+    virtual void DILIGENT_CALL_TYPE LoadPipelineStates(const LoadPipelineStateInfo* pLoadInfos, Uint32 NumPipelines, IPipelineState** ppPSOs) override final;
+
+    virtual void DILIGENT_CALL_TYPE LoadPipelineStateAsync(const LoadPipelineStateInfo& LoadInfo, IPipelineStateLoadTask** ppTask) override final;
+
     virtual void DILIGENT_CALL_TYPE LoadResourceSignature(const LoadResourceSignatureInfo& LoadInfo, IPipelineResourceSignature** ppSignature) override final;
 
     virtual void DILIGENT_CALL_TYPE LoadRenderPass(const LoadRenderPassInfo& LoadInfo, IRenderPass** ppRenderPass) override final;
@@ -59,6 +126,22 @@ public:
 
     virtual bool DILIGENT_CALL_TYPE Reload() override final;
 
+    virtual bool DILIGENT_CALL_TYPE ReloadIfModified() override final;
+
+    virtual void DILIGENT_CALL_TYPE GetPipelineUsage(IDataBlob** ppUsage) override final;
+
+    virtual Uint32 DILIGENT_CALL_TYPE WarmupPipelineStates(const IDataBlob* pUsage, Uint32 MaxPipelines) override final;
+
+    virtual Uint32 DILIGENT_CALL_TYPE GetNumPendingWarmupPipelines() override final;
+
+    virtual void DILIGENT_CALL_TYPE GetShaderResourceBinding(const ShaderResourceBindingInfo& Info, IShaderResourceBinding** ppSRB) override final;
+
+    virtual void DILIGENT_CALL_TYPE GetShaderResourceBindings(const ShaderResourceBindingInfo* pInfos, Uint32 NumSRBs, IShaderResourceBinding** ppSRBs) override final;
+
+    virtual Uint32 DILIGENT_CALL_TYPE PurgeShaderResourceBindings() override final;
+
+    virtual void DILIGENT_CALL_TYPE SaveStateCache() override final;
+
 private:
     struct PipelineHasher
     {
@@ -74,14 +157,142 @@ private:
     template <typename Type>
     using TNamedPipelineHashMap = std::unordered_map<std::pair<HashMapStringKey, PIPELINE_TYPE>, Type, PipelineHasher>;
 
-    TNamedPipelineHashMap<RefCntAutoPtr<IPipelineState>>           m_PipelineStateCache;
-    TNamedObjectHashMap<RefCntAutoPtr<IPipelineResourceSignature>> m_ResourceSignatureCache;
-    TNamedObjectHashMap<RefCntAutoPtr<IRenderPass>>                m_RenderPassCache;
-    TNamedObjectHashMap<RefCntAutoPtr<IShader>>                    m_ShaderCache;
+    // The cache is split into shards selected by the object name hash, so that threads that
+    // look up or create objects with different names rarely contend for the same mutex.
+    // The locks are only held for hash map operations: objects are created outside of them.
+    template <typename MapType>
+    struct ObjectCache
+    {
+        struct Shard
+        {
+            std::mutex Mtx;
+            // Signaled when an object this shard's PendingNames refers to has been created
+            std::condition_variable PendingCV;
+
+            // Objects that have been added to the cache and the names of the objects
+            // that are currently being created by one of the threads.
+            MapType                              Objects;
+            std::unordered_set<HashMapStringKey> PendingNames;
+        };
+
+        static constexpr size_t NumShards = 16;
+
+        Shard& GetShard(const HashMapStringKey& Name)
+        {
+            return Shards[Name.GetHash() % NumShards];
+        }
+
+        std::array<Shard, NumShards> Shards;
+    };
+
+    // Returns the object found by Find() or, if there is none, creates it with Create(AddToCache).
+    // Only one thread at a time creates an object with the given name; other threads that request the
+    // same name wait until it is done and then look it up again.
+    template <typename ObjectType, typename MapType, typename FindType, typename CreateType>
+    RefCntAutoPtr<ObjectType> FindOrCreateObject(ObjectCache<MapType>& Cache, const Char* Name, const FindType& Find, const CreateType& Create);
+
+    template <typename ModifyType>
+    RefCntAutoPtr<IShader> LoadShader(const Char* Name, bool AddToCache, const ModifyType& Modify);
+
+    template <typename ModifyType>
+    RefCntAutoPtr<IRenderPass> LoadRenderPass(const Char* Name, bool AddToCache, const ModifyType& Modify);
+
+    template <typename ModifyType>
+    RefCntAutoPtr<IPipelineResourceSignature> LoadResourceSignature(const Char* Name, bool AddToCache, const ModifyType& Modify);
+
+    // LoadPipelineState() and LoadPipelineStateAsync() without recording the pipeline usage
+    void LoadPipelineStateImpl(const LoadPipelineStateInfo& LoadInfo, IPipelineState** ppPSO);
+    void LoadPipelineStateAsyncImpl(const LoadPipelineStateInfo& LoadInfo, IPipelineStateLoadTask** ppTask);
+
+    void RunPipelineLoadTask(PipelineStateLoadTaskImpl& Task);
+
+    void RecordPipelineUsage(const LoadPipelineStateInfo& LoadInfo);
+
+    void LoadStateCache(IRenderStateCache* pCache);
+    void WriteStateCache(IRenderStateCache* pCache);
+    void SaveStateCacheThreadFunc();
+
+    // Removes the objects that were affected by the last parser reload from the cache.
+    template <typename MapType>
+    void EvictModifiedObjects(ObjectCache<MapType>& Cache, NOTATION_OBJECT_TYPE ObjectType);
+
+    // Returns the string that identifies the shader by everything that affects its compilation except
+    // the name, or an empty string if the shader must not be shared.
+    static std::string GetShaderContentKey(const ShaderCreateInfo& ShaderCI);
+
+    static RefCntAutoPtr<IPipelineState> FindPipeline(const TNamedPipelineHashMap<RefCntAutoPtr<IPipelineState>>& Pipelines, const Char* Name, PIPELINE_TYPE PipelineType);
+
+    template <typename ObjectType>
+    static RefCntAutoPtr<ObjectType> FindNamedObject(const TNamedObjectHashMap<RefCntAutoPtr<ObjectType>>& Objects, const Char* Name);
+
+    static const HashMapStringKey& GetCacheKeyName(const HashMapStringKey& Key)
+    {
+        return Key;
+    }
+
+    static const HashMapStringKey& GetCacheKeyName(const std::pair<HashMapStringKey, PIPELINE_TYPE>& Key)
+    {
+        return Key.first;
+    }
+
+    static HashMapStringKey GetCacheKey(IDeviceObject* pObject)
+    {
+        return HashMapStringKey{pObject->GetDesc().Name, false};
+    }
+
+    static std::pair<HashMapStringKey, PIPELINE_TYPE> GetCacheKey(IPipelineState* pPSO)
+    {
+        return std::make_pair(HashMapStringKey{pPSO->GetDesc().Name, false}, pPSO->GetDesc().PipelineType);
+    }
+
+    ObjectCache<TNamedPipelineHashMap<RefCntAutoPtr<IPipelineState>>>           m_PipelineStateCache;
+    ObjectCache<TNamedObjectHashMap<RefCntAutoPtr<IPipelineResourceSignature>>> m_ResourceSignatureCache;
+    ObjectCache<TNamedObjectHashMap<RefCntAutoPtr<IRenderPass>>>                m_RenderPassCache;
+    ObjectCache<TNamedObjectHashMap<RefCntAutoPtr<IShader>>>                    m_ShaderCache;
+
+    // Shaders that are added to the cache, indexed by their content key, so that identical shaders
+    // declared under different names are compiled once, see GetShaderContentKey().
+    std::unordered_map<std::string, RefCntAutoPtr<IShader>> m_ShadersByContent;
+    std::mutex                                              m_ShadersByContentMtx;
+
+    // Asynchronous loads of the pipelines that will be added to the cache, indexed by the requested name and type.
+    TNamedPipelineHashMap<RefCntAutoPtr<PipelineStateLoadTaskImpl>> m_PipelineLoadTasks;
+    std::mutex                                                      m_PipelineLoadTasksMtx;
+
+    // Pipelines requested by the application in the order of the first request, see GetPipelineUsage().
+    struct PipelineUsage
+    {
+        std::string   Name;
+        PIPELINE_TYPE PipelineType = PIPELINE_TYPE_INVALID;
+        Uint32        Count        = 0;
+    };
+    const bool                    m_RecordPipelineUsage;
+    std::vector<PipelineUsage>    m_PipelineUsage;
+    TNamedPipelineHashMap<size_t> m_PipelineUsageIndices;
+    std::mutex                    m_PipelineUsageMtx;
+
+    std::vector<RefCntAutoPtr<IPipelineStateLoadTask>> m_WarmupTasks;
+    std::mutex                                         m_WarmupTasksMtx;
+
+    ShaderResourceBindingCache m_SRBCache;
+
+    IMemoryAllocator& m_Allocator;
 
     RenderDeviceWithCache<true>                    m_DeviceWithCache;
     RefCntAutoPtr<IRenderStateNotationParser>      m_pParser;
     RefCntAutoPtr<IShaderSourceInputStreamFactory> m_pStreamFactory;
+    RefCntAutoPtr<IThreadPool>                     m_pThreadPool;
+    std::unique_ptr<FileWatcher>                   m_pFileWatcher;
+
+    // The state cache is written by m_SaveStateCacheThread. Requests that arrive while the thread
+    // is writing the cache make it write the cache once more instead of starting another thread.
+    const std::string m_StateCachePath;
+    std::thread       m_SaveStateCacheThread;
+    std::mutex        m_SaveStateCacheMtx;
+    bool              m_IsSavingStateCache      = false;
+    bool              m_StateCacheSaveRequested = false;
+    // Hash of the cache data that was last loaded from or written to the file
+    Uint64 m_SavedStateCacheHash = 0;
 };
 
 } // namespace Diligent
@@ -28,12 +28,19 @@
 
 #include <functional>
 #include <unordered_set>
+#include <unordered_map>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "json.hpp"
 
 #include "RenderStateNotationParser.h"
 #include "RefCntAutoPtr.hpp"
 #include "ObjectBase.hpp"
 #include "DynamicLinearAllocator.hpp"
 #include "HashUtils.hpp"
+#include "ThreadPool.hpp"
 
 namespace Diligent
 {
@@ -67,6 +74,14 @@ public:
 
     virtual const RenderPassDesc* DILIGENT_CALL_TYPE GetRenderPassByName(const Char* Name) const override final;
 
+    virtual const PipelineStateNotation* DILIGENT_CALL_TYPE GetPipelineStateByHash(Uint64 NameHash, PIPELINE_TYPE PipelineType) const override final;
+
+    virtual const PipelineResourceSignatureDesc* DILIGENT_CALL_TYPE GetResourceSignatureByHash(Uint64 NameHash) const override final;
+
+    virtual const ShaderCreateInfo* DILIGENT_CALL_TYPE GetShaderByHash(Uint64 NameHash) const override final;
+
+    virtual const RenderPassDesc* DILIGENT_CALL_TYPE GetRenderPassByHash(Uint64 NameHash) const override final;
+
     virtual const PipelineStateNotation* DILIGENT_CALL_TYPE GetPipelineStateByIndex(Uint32 Index) const override final;
 
     virtual const PipelineResourceSignatureDesc* DILIGENT_CALL_TYPE GetResourceSignatureByIndex(Uint32 Index) const override final;
@@ -83,6 +98,8 @@ public:
 
     virtual bool DILIGENT_CALL_TYPE Reload() override final;
 
+    virtual Bool DILIGENT_CALL_TYPE IsStateModified(NOTATION_OBJECT_TYPE ObjectType, const Char* Name) const override final;
+
 private:
     Bool ParseFileInternal(const Char*                      FilePath,
                            IShaderSourceInputStreamFactory* pStreamFactory);
@@ -91,6 +108,51 @@ private:
                              Uint32                           Length,
                              IShaderSourceInputStreamFactory* pStreamFactory);
 
+    Bool ParseJSONInternal(nlohmann::json&                  Json,
+                           IShaderSourceInputStreamFactory* pStreamFactory);
+
+    void PrefetchImports(const std::vector<std::string>&  Imports,
+                         IShaderSourceInputStreamFactory* pStreamFactory);
+
+    template <typename KeyType, typename MapType>
+    static void AddNameHash(MapType& Hashes, const KeyType& Key, Uint32 Index, const Char* ObjectType, const Char* Name)
+    {
+        // The names are unique, so a failed insertion means that two different names have the same hash
+        if (!Hashes.emplace(Key, Index).second)
+            LOG_WARNING_MESSAGE("The name hash of ", ObjectType, " '", Name, "' collides with the hash of another ", ObjectType, " name. The ", ObjectType, " can only be found by name.");
+    }
+
+    // Macro values of a permutation, by macro name.
+    using PermutationValues = std::unordered_map<std::string, std::string>;
+
+    struct ShaderPermutationInfo
+    {
+        ShaderCreateInfo ShaderCI;
+
+        // Macro names and their values in declaration order.
+        std::vector<std::pair<std::string, std::vector<std::string>>> Axes;
+
+        // Every rule excludes the permutations that match all of its macro values.
+        std::vector<std::unordered_map<std::string, std::vector<std::string>>> Exclusions;
+
+        // Used to detect redefinitions.
+        nlohmann::json Json;
+
+        bool IsModified = false;
+
+        bool IsExcluded(const PermutationValues& Values) const;
+    };
+
+    void AddShaderPermutations(const nlohmann::json& Json, const ShaderCreateInfo& ShaderCI);
+
+    const Char* GetShaderPermutation(const ShaderPermutationInfo& Info, const PermutationValues& Values);
+
+    bool TrackFile(const Char* FilePath, size_t Hash);
+
+    bool HasModifiedFiles() const;
+
+    void AddDependentModifiedPipelines();
+
 private:
     const RenderStateNotationParserCreateInfo m_CI;
 
@@ -102,6 +164,14 @@ private:
         }
     };
 
+    struct PipelineNameHashHasher
+    {
+        size_t operator()(const std::pair<Uint64, PIPELINE_TYPE>& Key) const
+        {
+            return ComputeHash(Key.first, static_cast<size_t>(Key.second));
+        }
+    };
+
     template <typename Type>
     using TNamedObjectHashMap = std::unordered_map<HashMapStringKey, Type>;
 
@@ -122,6 +192,16 @@ private:
     TNamedObjectHashMap<Uint32>   m_RenderPassNames;
     TNamedPipelineHashMap<Uint32> m_PipelineStateNames;
 
+    // Indices of the objects by their name hashes, see ComputeNotationNameHash().
+    std::unordered_map<Uint64, Uint32>                                                m_ResourceSignatureHashes;
+    std::unordered_map<Uint64, Uint32>                                                m_ShaderHashes;
+    std::unordered_map<Uint64, Uint32>                                                m_RenderPassHashes;
+    std::unordered_map<std::pair<Uint64, PIPELINE_TYPE>, Uint32, PipelineNameHashHasher> m_PipelineStateHashes;
+
+    // Shaders with permutation axes, by the base name. The permutations are added to m_Shaders
+    // when they are referenced by a pipeline, so the excluded permutations are never created.
+    std::unordered_map<std::string, ShaderPermutationInfo> m_ShaderPermutations;
+
     RenderStateNotationParserInfo m_ParseInfo;
 
     struct ReloadInfo
@@ -132,6 +212,34 @@ private:
         RefCntAutoPtr<IShaderSourceInputStreamFactory> pFactory;
     };
     std::vector<ReloadInfo> m_ReloadInfo;
+
+    RefCntAutoPtr<IThreadPool> m_pThreadPool;
+
+    // Import files that have been read and parsed concurrently, but have not been processed yet.
+    struct PrefetchedImport
+    {
+        std::unique_ptr<nlohmann::json> pJson;
+        size_t                          Hash = 0;
+    };
+    std::unordered_map<std::string, PrefetchedImport> m_PrefetchedImports;
+    bool                                              m_IsPrefetchingImports = false;
+
+    // Content hashes of all parsed files, used by Reload() to skip unchanged files.
+    struct TrackedFile
+    {
+        size_t Hash            = 0;
+        size_t ReloadInfoIndex = 0;
+    };
+    std::unordered_map<std::string, TrackedFile>        m_TrackedFiles;
+    const std::unordered_map<std::string, TrackedFile>* m_pPrevTrackedFiles      = nullptr;
+    size_t                                              m_CurrentReloadInfoIndex = 0;
+    bool                                                m_IsCurrentFileModified  = false;
+
+    // Objects affected by the files changed in the last Reload().
+    std::unordered_set<HashMapStringKey> m_ModifiedShaders;
+    std::unordered_set<HashMapStringKey> m_ModifiedRenderPasses;
+    std::unordered_set<HashMapStringKey> m_ModifiedResourceSignatures;
+    std::unordered_set<HashMapStringKey> m_ModifiedPipelineStates;
 };
 
 } // namespace Diligent
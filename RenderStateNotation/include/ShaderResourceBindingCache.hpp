@@ -0,0 +1,121 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "RenderStateNotationLoader.h"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+struct IThreadPool;
+
+/// Caches shader resource bindings by the pipeline state or resource signature and the bound resources.
+
+/// Bindings are created and filled outside of the lock, so threads that request different
+/// bindings do not wait for each other. If several threads create the same binding at the same
+/// time, the first one that finishes is added to the cache and returned to all of them.
+class ShaderResourceBindingCache
+{
+public:
+    /// Returns the cached binding for the info, or creates and caches a new one.
+    /// Returns null if the binding could not be created.
+    RefCntAutoPtr<IShaderResourceBinding> Get(const ShaderResourceBindingInfo& Info);
+
+    /// Returns the bindings for NumSRBs infos. The missing bindings are created by the thread pool, if it is not null.
+    void Get(const ShaderResourceBindingInfo* pInfos, Uint32 NumSRBs, IShaderResourceBinding** ppSRBs, IThreadPool* pThreadPool);
+
+    /// Removes the bindings that are only referenced by the cache and returns their number.
+    Uint32 Purge();
+
+private:
+    struct ResourceKey
+    {
+        SHADER_TYPE    ShaderStages = SHADER_TYPE_UNKNOWN;
+        std::string    Name;
+        IDeviceObject* pObject    = nullptr;
+        Uint32         ArrayIndex = 0;
+
+        bool operator==(const ResourceKey& rhs) const
+        {
+            // clang-format off
+            return ShaderStages == rhs.ShaderStages &&
+                   pObject      == rhs.pObject      &&
+                   ArrayIndex   == rhs.ArrayIndex   &&
+                   Name         == rhs.Name;
+            // clang-format on
+        }
+    };
+
+    // Bound objects are kept alive by the binding, so their addresses can't be reused while
+    // the binding is in the cache. The owner is kept alive by the cache entry.
+    struct BindingKey
+    {
+        IDeviceObject*           pOwner              = nullptr;
+        bool                     InitStaticResources = true;
+        std::vector<ResourceKey> Resources;
+        size_t                   Hash = 0;
+
+        explicit BindingKey(const ShaderResourceBindingInfo& Info);
+
+        bool operator==(const BindingKey& rhs) const
+        {
+            return Hash == rhs.Hash && pOwner == rhs.pOwner && InitStaticResources == rhs.InitStaticResources && Resources == rhs.Resources;
+        }
+
+        struct Hasher
+        {
+            size_t operator()(const BindingKey& Key) const
+            {
+                return Key.Hash;
+            }
+        };
+    };
+
+    struct BindingEntry
+    {
+        RefCntAutoPtr<IDeviceObject>          pOwner;
+        RefCntAutoPtr<IShaderResourceBinding> pSRB;
+    };
+
+    RefCntAutoPtr<IShaderResourceBinding> Find(const BindingKey& Key);
+
+    RefCntAutoPtr<IShaderResourceBinding> Add(BindingKey&& Key, const ShaderResourceBindingInfo& Info, RefCntAutoPtr<IShaderResourceBinding> pSRB);
+
+    static RefCntAutoPtr<IShaderResourceBinding> CreateBinding(const ShaderResourceBindingInfo& Info);
+
+    std::mutex                                                       m_Mtx;
+    std::unordered_map<BindingKey, BindingEntry, BindingKey::Hasher> m_Bindings;
+};
+
+} // namespace Diligent
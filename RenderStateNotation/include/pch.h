@@ -32,6 +32,7 @@
 #include "RenderDevice.h"
 #include "DynamicLinearAllocator.hpp"
 #include "StringTools.hpp"
+#include "RSNJsonReader.hpp"
 
 #include "generated/CommonParser.hpp"
 #include "generated/GraphicsTypesParser.hpp"
@@ -36,6 +36,9 @@
 
 DILIGENT_BEGIN_NAMESPACE(Diligent)
 
+struct IThreadPool;
+struct IMemoryAllocator;
+
 #if DILIGENT_C_INTERFACE
 #    define REF *
 #else
@@ -56,6 +59,40 @@ struct RenderStateNotationLoaderCreateInfo
 
     /// A pointer to an optional render state cache.
     IRenderStateCache*               pStateCache    DEFAULT_INITIALIZER(nullptr);
+
+    /// An optional path of the file that keeps the contents of the render state cache between runs.
+
+    /// \remarks If both the path and pStateCache are not null, the cache is loaded from the file
+    ///          when the loader is created, if the file exists. The cache is written back to the file
+    ///          by IRenderStateNotationLoader::SaveStateCache, after the states are reloaded, and when
+    ///          the loader is destroyed.
+    const Char*                      StateCachePath DEFAULT_INITIALIZER(nullptr);
+
+    /// An optional thread pool that is used by IRenderStateNotationLoader::LoadPipelineStates
+    /// and IRenderStateNotationLoader::LoadPipelineStateAsync to create pipeline states
+    /// and their shaders concurrently.
+    struct IThreadPool*              pThreadPool    DEFAULT_INITIALIZER(nullptr);
+
+    /// An optional semicolon-separated list of directories to watch for changes of
+    /// render state notation and shader files, see IRenderStateNotationLoader::ReloadIfModified.
+
+    /// \remarks The directories are not watched recursively. The parser must be created
+    ///          with the EnableReload member of RenderStateNotationParserCreateInfo set to true.
+    const Char*                      WatchDirectories DEFAULT_INITIALIZER(nullptr);
+
+    /// The time, in milliseconds, that must pass after the last detected file change
+    /// before IRenderStateNotationLoader::ReloadIfModified reloads the states.
+    Uint32                           ReloadDebounceTime DEFAULT_INITIALIZER(200);
+
+    /// Whether the loader records the pipeline states requested by the application,
+    /// see IRenderStateNotationLoader::GetPipelineUsage.
+    bool                             RecordPipelineUsage DEFAULT_INITIALIZER(false);
+
+    /// An optional allocator for the temporary memory used while pipeline states are created.
+
+    /// \remarks If null, the default raw memory allocator is used. The allocator must outlive
+    ///          the loader and must be thread-safe if pThreadPool is not null.
+    struct IMemoryAllocator*         pAllocator     DEFAULT_INITIALIZER(nullptr);
 };
 typedef struct RenderStateNotationLoaderCreateInfo RenderStateNotationLoaderCreateInfo;
 
@@ -195,9 +232,105 @@ struct LoadPipelineStateInfo
 
     /// A pointer to the user data to pass to the ModifyRenderPass function.
     void* pModifyRenderPassData                                                         DEFAULT_INITIALIZER(nullptr);
+
+    /// An optional function to be called by IRenderStateNotationLoader::LoadPipelineStateAsync
+    /// when the pipeline state has been loaded.
+    ///
+    /// \remarks   The first parameter is the loaded pipeline state, or null if loading failed.
+    ///             The function may be called from a worker thread of the loader's thread pool,
+    ///             or from the calling thread if the pipeline is found in the cache.
+    void (*OnPipelineLoaded)(IPipelineState*, void*)                                    DEFAULT_INITIALIZER(nullptr);
+
+    /// A pointer to the user data to pass to the OnPipelineLoaded function.
+    void* pOnPipelineLoadedData                                                         DEFAULT_INITIALIZER(nullptr);
 };
 typedef struct LoadPipelineStateInfo LoadPipelineStateInfo;
 
+/// A resource bound to a shader resource binding, see Diligent::ShaderResourceBindingInfo.
+struct ShaderResourceBindingResource
+{
+    /// Shader stages whose variables with the given name the resource is bound to.
+    SHADER_TYPE    ShaderStages DEFAULT_INITIALIZER(SHADER_TYPE_UNKNOWN);
+
+    /// Name of the shader resource variable.
+    const Char*    Name         DEFAULT_INITIALIZER(nullptr);
+
+    /// The object to bind, e.g. a texture view or a buffer view.
+    IDeviceObject* pObject      DEFAULT_INITIALIZER(nullptr);
+
+    /// Index of the array element to bind the object to.
+    Uint32         ArrayIndex   DEFAULT_INITIALIZER(0);
+};
+typedef struct ShaderResourceBindingResource ShaderResourceBindingResource;
+
+/// Shader resource binding request info.
+struct ShaderResourceBindingInfo
+{
+    /// The pipeline state to create the shader resource binding for.
+    IPipelineState*                      pPSO                DEFAULT_INITIALIZER(nullptr);
+
+    /// The resource signature to create the shader resource binding for, when pPSO is null.
+    IPipelineResourceSignature*          pSignature          DEFAULT_INITIALIZER(nullptr);
+
+    /// An array of NumResources mutable and dynamic resources to bind.
+    const ShaderResourceBindingResource* pResources          DEFAULT_INITIALIZER(nullptr);
+
+    /// The number of elements in pResources.
+    Uint32                               NumResources        DEFAULT_INITIALIZER(0);
+
+    /// Whether to initialize the static resources of the binding.
+    bool                                 InitStaticResources DEFAULT_INITIALIZER(true);
+};
+typedef struct ShaderResourceBindingInfo ShaderResourceBindingInfo;
+
+// clang-format on
+
+// {F61CA282-1311-4AF6-815A-1B26A2A0471C}
+static const INTERFACE_ID IID_PipelineStateLoadTask = {0xF61CA282, 0x1311, 0x4AF6, {0x81, 0x5A, 0x1B, 0x26, 0xA2, 0xA0, 0x47, 0x1C}};
+
+#define DILIGENT_INTERFACE_NAME IPipelineStateLoadTask
+#include "../../../DiligentCore/Primitives/interface/DefineInterfaceHelperMacros.h"
+
+#define IPipelineStateLoadTaskInclusiveMethods \
+    IObjectInclusiveMethods;                   \
+    IPipelineStateLoadTask PipelineStateLoadTask
+
+// clang-format off
+
+/// Pipeline state load task interface.
+
+/// The task is returned by IRenderStateNotationLoader::LoadPipelineStateAsync and
+/// resolves to the pipeline state once it has been loaded.
+DILIGENT_BEGIN_INTERFACE(IPipelineStateLoadTask, IObject)
+{
+    /// Returns true if loading is finished, either successfully or not.
+    VIRTUAL bool METHOD(IsComplete)(THIS) CONST PURE;
+
+    /// Returns the loaded pipeline state.
+
+    /// \return    A pointer to the pipeline state, or null if the pipeline is not
+    ///            loaded yet or if loading failed.
+    ///
+    /// \remarks   The method does not increment the reference counter of the returned object.
+    ///            A renderer that does not want to wait for the pipeline may use a fallback
+    ///            while this method returns null.
+    VIRTUAL IPipelineState* METHOD(GetPipelineState)(THIS) PURE;
+
+    /// Blocks the calling thread until loading is finished.
+    VIRTUAL void METHOD(WaitForCompletion)(THIS) PURE;
+};
+DILIGENT_END_INTERFACE
+
+#include "../../../DiligentCore/Primitives/interface/UndefInterfaceHelperMacros.h"
+
+#if DILIGENT_C_INTERFACE
+
+#    define IPipelineStateLoadTask_IsComplete(This)        CALL_IFACE_METHOD(PipelineStateLoadTask, IsComplete,        This)
+#    define IPipelineStateLoadTask_GetPipelineState(This)  CALL_IFACE_METHOD(PipelineStateLoadTask, GetPipelineState,  This)
+#    define IPipelineStateLoadTask_WaitForCompletion(This) CALL_IFACE_METHOD(PipelineStateLoadTask, WaitForCompletion, This)
+
+#endif
+
 // clang-format on
 
 // {FD9B12C5-3BC5-4729-A2B4-924DF374B3D3}
@@ -220,17 +353,59 @@ DILIGENT_BEGIN_INTERFACE(IRenderStateNotationLoader, IObject)
     /// \param [in]  LoadInfo - Pipeline state load info, see Diligent::LoadPipelineStateInfo.
     /// \param [out] ppPSO    - Address of the memory location where a pointer to the pipeline state object will be stored.
     ///
-    /// \remarks This method must be externally synchronized.
+    /// \remarks This method is thread-safe, but must not be called concurrently with Reload().
     VIRTUAL void METHOD(LoadPipelineState)(THIS_
                                            const LoadPipelineStateInfo REF LoadInfo, 
                                            IPipelineState**                ppPSO) PURE;
 
+    /// Loads multiple pipeline states from the render state notation parser.
+
+    /// \param [in]  pLoadInfos   - An array of NumPipelines pipeline state load infos, see Diligent::LoadPipelineStateInfo.
+    /// \param [in]  NumPipelines - The number of pipeline states to load.
+    /// \param [out] ppPSOs       - An array of NumPipelines memory locations where pointers to the pipeline
+    ///                             state objects will be stored. Pipelines that fail to load are set to null.
+    ///
+    /// \remarks When the loader was created with a thread pool, the pipelines are loaded concurrently
+    ///          on the pool and the method waits for all of them; otherwise they are loaded one by one.
+    ///          Shaders, render passes and resource signatures that are added to the cache are created
+    ///          once even if they are requested by several pipelines at the same time.
+    ///
+    ///          The callbacks of the load infos may be executed concurrently from the worker threads.
+    ///          The render device and the render state cache must support concurrent object creation.
+    ///
+    /// \note    The method must not be called from a worker thread of the loader's thread pool.
+    VIRTUAL void METHOD(LoadPipelineStates)(THIS_
+                                            const LoadPipelineStateInfo* pLoadInfos,
+                                            Uint32                       NumPipelines,
+                                            IPipelineState**             ppPSOs) PURE;
+
+    /// Starts loading a pipeline state without waiting for it.
+
+    /// \param [in]  LoadInfo - Pipeline state load info, see Diligent::LoadPipelineStateInfo.
+    /// \param [out] ppTask   - Address of the memory location where a pointer to the load task will be stored.
+    ///
+    /// \remarks If the pipeline is found in the cache, the returned task is already complete.
+    ///          Otherwise, the pipeline and its shaders are created by a worker thread of the loader's
+    ///          thread pool. If the loader was created without a thread pool, the pipeline is loaded
+    ///          before the method returns.
+    ///
+    ///          While a pipeline that is added to the cache is being loaded, all requests for it
+    ///          return the same task, so that it is compiled only once. The callbacks of the
+    ///          subsequent requests other than LoadInfo.OnPipelineLoaded are not used.
+    ///
+    ///          LoadInfo is copied, but all user data pointers must remain valid until the task is complete.
+    ///
+    /// \remarks This method is thread-safe, but must not be called concurrently with Reload().
+    VIRTUAL void METHOD(LoadPipelineStateAsync)(THIS_
+                                                const LoadPipelineStateInfo REF LoadInfo,
+                                                IPipelineStateLoadTask**        ppTask) PURE;
+
     /// Loads a resource signature from the render state notation parser.
 
     /// \param [in]  LoadInfo    - Render pass load info, see Diligent::LoadResourceSignatureInfo.
     /// \param [out] ppSignature - Address of the memory location where a pointer to the pipeline resource signature object will be stored.
     ///
-    /// \remarks This method must be externally synchronized.
+    /// \remarks This method is thread-safe, but must not be called concurrently with Reload().
     VIRTUAL void METHOD(LoadResourceSignature)(THIS_
                                                const LoadResourceSignatureInfo REF LoadInfo,
                                                IPipelineResourceSignature**        ppSignature) PURE;
@@ -240,7 +415,7 @@ DILIGENT_BEGIN_INTERFACE(IRenderStateNotationLoader, IObject)
     /// \param [in]  LoadInfo     - Render pass load info, see Diligent::LoadRenderPassInfo.
     /// \param [out] ppRenderPass - Address of the memory location where a pointer to the loaded render pass object will be stored.
     ///
-    /// \remarks This method must be externally synchronized.
+    /// \remarks This method is thread-safe, but must not be called concurrently with Reload().
     VIRTUAL void METHOD(LoadRenderPass)(THIS_
                                         const LoadRenderPassInfo REF LoadInfo,
                                         IRenderPass**                ppRenderPass) PURE;
@@ -250,7 +425,7 @@ DILIGENT_BEGIN_INTERFACE(IRenderStateNotationLoader, IObject)
     /// \param [in]  LoadInfo - Shader load info, see Diligent::LoadShaderInfo.
     /// \param [out] ppShader - Address of the memory location where a pointer to the loaded shader object will be stored.
     ///
-    /// \remarks This method must be externally synchronized.
+    /// \remarks This method is thread-safe, but must not be called concurrently with Reload().
     VIRTUAL void METHOD(LoadShader)(THIS_
                                     const LoadShaderInfo REF LoadInfo,
                                     IShader**                ppShader) PURE;
@@ -268,6 +443,104 @@ DILIGENT_BEGIN_INTERFACE(IRenderStateNotationLoader, IObject)
     ///             - Pipeline resource layouts and signatures can't be modified
     ///             - Shaders can be reloaded, but can't be replaced (e.g. a PSO can't use another shader after the reload)
     VIRTUAL bool METHOD(Reload)(THIS) PURE;
+
+    /// Reloads the states if any of the files in the watched directories has changed.
+    ///
+    /// \return true if the files have changed and the states were reloaded successfully, and false otherwise.
+    ///
+    /// \remarks The directories are specified by the WatchDirectories member of RenderStateNotationLoaderCreateInfo
+    ///          and are watched by a background thread, so the method does not access the disk unless
+    ///          the files have changed. It is intended to be called once per frame. The states are reloaded
+    ///          only when no further changes were detected for RenderStateNotationLoaderCreateInfo::ReloadDebounceTime
+    ///          milliseconds. If no directories are watched, the method does nothing and returns false.
+    ///
+    ///          Same as Reload(), this method must not be called concurrently with other methods of the loader.
+    VIRTUAL bool METHOD(ReloadIfModified)(THIS) PURE;
+
+    /// Writes the list of the pipeline states requested by the application.
+
+    /// \param [out] ppUsage - Address of the memory location where a pointer to the usage list will be written.
+    ///
+    /// \remarks The list contains the pipelines requested by LoadPipelineState, LoadPipelineStates and
+    ///          LoadPipelineStateAsync since the loader was created, with the number of requests for every
+    ///          pipeline. It is empty unless RenderStateNotationLoaderCreateInfo::RecordPipelineUsage is true.
+    ///          An application may store the list and pass it to WarmupPipelineStates() on the next run.
+    VIRTUAL void METHOD(GetPipelineUsage)(THIS_
+                                          IDataBlob** ppUsage) PURE;
+
+    /// Starts loading the pipeline states from a usage list in the background.
+
+    /// \param [in] pUsage       - Usage list written by GetPipelineUsage().
+    /// \param [in] MaxPipelines - The maximum number of pipelines to load, or 0 to load all pipelines in the list.
+    /// \return     The number of pipelines that have been scheduled for loading.
+    ///
+    /// \remarks The pipelines that were requested most often are loaded first, and are added to the cache.
+    ///          If the loader was created with a render state cache, the objects are created through the
+    ///          cache, so that the pipelines stored in a loaded cache archive are unpacked without compiling.
+    ///          A later request for a pipeline that is still loading waits for it instead of loading it again.
+    ///          Pipelines in the list that are not found by the parser are skipped.
+    ///
+    ///          The pipelines are loaded by the loader's thread pool, typically while a loading screen is shown.
+    ///          If the loader was created without a thread pool, they are loaded before the method returns.
+    ///          Use GetNumPendingWarmupPipelines() to check the progress.
+    VIRTUAL Uint32 METHOD(WarmupPipelineStates)(THIS_
+                                                const IDataBlob* pUsage,
+                                                Uint32           MaxPipelines) PURE;
+
+    /// Returns the number of pipelines scheduled by WarmupPipelineStates() that are still loading.
+    VIRTUAL Uint32 METHOD(GetNumPendingWarmupPipelines)(THIS) PURE;
+
+    /// Returns a shader resource binding of the pipeline state or resource signature with the given resources bound.
+
+    /// \param [in]  Info  - Shader resource binding info, see Diligent::ShaderResourceBindingInfo.
+    /// \param [out] ppSRB - Address of the memory location where a pointer to the shader resource binding will be stored.
+    ///
+    /// \remarks The bindings are cached by the pipeline state or the resource signature, the static resources
+    ///          flag and the bound resources, so requests with the same info, e.g. for the instances of the same
+    ///          material, return the same binding and the variables are only set once. The resources are
+    ///          compared in the order they are specified. Cached bindings are shared and must not be modified.
+    ///
+    ///          Bindings stay in the cache until PurgeShaderResourceBindings() is called.
+    ///
+    ///          This method is thread-safe.
+    VIRTUAL void METHOD(GetShaderResourceBinding)(THIS_
+                                                  const ShaderResourceBindingInfo REF Info,
+                                                  IShaderResourceBinding**            ppSRB) PURE;
+
+    /// Returns multiple shader resource bindings, see GetShaderResourceBinding().
+
+    /// \param [in]  pInfos  - An array of NumSRBs shader resource binding infos.
+    /// \param [in]  NumSRBs - The number of shader resource bindings.
+    /// \param [out] ppSRBs  - An array of NumSRBs memory locations where pointers to the shader
+    ///                        resource bindings will be stored.
+    ///
+    /// \remarks Bindings that are not in the cache are created and filled concurrently by the loader's
+    ///          thread pool, if there is one. Infos that are equal in the array get the same binding.
+    ///
+    /// \note    The method must not be called from a worker thread of the loader's thread pool.
+    VIRTUAL void METHOD(GetShaderResourceBindings)(THIS_
+                                                   const ShaderResourceBindingInfo* pInfos,
+                                                   Uint32                           NumSRBs,
+                                                   IShaderResourceBinding**         ppSRBs) PURE;
+
+    /// Removes the shader resource bindings that are not referenced outside of the cache.
+
+    /// \return     The number of bindings that have been removed.
+    ///
+    /// \remarks    An application may call this method after unloading materials or after reloading the states,
+    ///             so that the bindings, and the pipelines and resources they keep alive, are released.
+    VIRTUAL Uint32 METHOD(PurgeShaderResourceBindings)(THIS) PURE;
+
+    /// Writes the render state cache to the file specified by RenderStateNotationLoaderCreateInfo::StateCachePath.
+
+    /// \remarks The cache is serialized and written by a background thread, and the method returns
+    ///          immediately. The file is only rewritten if the contents of the cache have changed since
+    ///          they were loaded or last written. If the loader was created without a render state cache
+    ///          or without the cache path, the method does nothing.
+    ///
+    ///          The method is called automatically after the states are reloaded and when the loader is destroyed.
+    ///          An application may call it after loading or warming up the pipelines.
+    VIRTUAL void METHOD(SaveStateCache)(THIS) PURE;
 };
 DILIGENT_END_INTERFACE
 
@@ -276,11 +549,21 @@ DILIGENT_END_INTERFACE
 #if DILIGENT_C_INTERFACE
 
 // clang-format off
-#    define IRenderStateNotationLoader_LoadPipelineState(This, ...)     CALL_IFACE_METHOD(RenderStateNotationLoader, LoadPipelineState,     This, __VA_ARGS__)
-#    define IRenderStateNotationLoader_LoadResourceSignature(This, ...) CALL_IFACE_METHOD(RenderStateNotationLoader, LoadResourceSignature, This, __VA_ARGS__)
-#    define IRenderStateNotationLoader_LoadRenderPass(This, ...)        CALL_IFACE_METHOD(RenderStateNotationLoader, LoadRenderPass,        This, __VA_ARGS__)
-#    define IRenderStateNotationLoader_LoadShader(This, ...)            CALL_IFACE_METHOD(RenderStateNotationLoader, LoadShader,            This, __VA_ARGS__)
-#    define IRenderStateNotationLoader_Reload(This)                     CALL_IFACE_METHOD(RenderStateNotationLoader, Reload,                This)
+#    define IRenderStateNotationLoader_LoadPipelineState(This, ...)         CALL_IFACE_METHOD(RenderStateNotationLoader, LoadPipelineState,            This, __VA_ARGS__)
+#    define IRenderStateNotationLoader_LoadPipelineStates(This, ...)        CALL_IFACE_METHOD(RenderStateNotationLoader, LoadPipelineStates,           This, __VA_ARGS__)
+#    define IRenderStateNotationLoader_LoadPipelineStateAsync(This, ...)    CALL_IFACE_METHOD(RenderStateNotationLoader, LoadPipelineStateAsync,       This, __VA_ARGS__)
+#    define IRenderStateNotationLoader_LoadResourceSignature(This, ...)     CALL_IFACE_METHOD(RenderStateNotationLoader, LoadResourceSignature,        This, __VA_ARGS__)
+#    define IRenderStateNotationLoader_LoadRenderPass(This, ...)            CALL_IFACE_METHOD(RenderStateNotationLoader, LoadRenderPass,               This, __VA_ARGS__)
+#    define IRenderStateNotationLoader_LoadShader(This, ...)                CALL_IFACE_METHOD(RenderStateNotationLoader, LoadShader,                   This, __VA_ARGS__)
+#    define IRenderStateNotationLoader_Reload(This)                         CALL_IFACE_METHOD(RenderStateNotationLoader, Reload,                       This)
+#    define IRenderStateNotationLoader_ReloadIfModified(This)               CALL_IFACE_METHOD(RenderStateNotationLoader, ReloadIfModified,             This)
+#    define IRenderStateNotationLoader_GetPipelineUsage(This, ...)          CALL_IFACE_METHOD(RenderStateNotationLoader, GetPipelineUsage,             This, __VA_ARGS__)
+#    define IRenderStateNotationLoader_WarmupPipelineStates(This, ...)      CALL_IFACE_METHOD(RenderStateNotationLoader, WarmupPipelineStates,         This, __VA_ARGS__)
+#    define IRenderStateNotationLoader_GetNumPendingWarmupPipelines(This)   CALL_IFACE_METHOD(RenderStateNotationLoader, GetNumPendingWarmupPipelines, This)
+#    define IRenderStateNotationLoader_GetShaderResourceBinding(This, ...)  CALL_IFACE_METHOD(RenderStateNotationLoader, GetShaderResourceBinding,     This, __VA_ARGS__)
+#    define IRenderStateNotationLoader_GetShaderResourceBindings(This, ...) CALL_IFACE_METHOD(RenderStateNotationLoader, GetShaderResourceBindings,    This, __VA_ARGS__)
+#    define IRenderStateNotationLoader_PurgeShaderResourceBindings(This)    CALL_IFACE_METHOD(RenderStateNotationLoader, PurgeShaderResourceBindings,  This)
+#    define IRenderStateNotationLoader_SaveStateCache(This)                 CALL_IFACE_METHOD(RenderStateNotationLoader, SaveStateCache,               This)
 // clang-format on
 
 #endif
@@ -290,6 +573,53 @@ DILIGENT_END_INTERFACE
 void DILIGENT_GLOBAL_FUNCTION(CreateRenderStateNotationLoader)(const RenderStateNotationLoaderCreateInfo REF CreateInfo,
                                                                IRenderStateNotationLoader**                  ppLoader);
 
+/// Loads the archive chunks written by the render state packager with the split_by_device
+/// or split_by_input option into the dearchiver.
+
+/// \param [in]  IndexFilePath    - Path to the archive index file written by the packager (<output>.index.json).
+/// \param [in]  DeviceType       - Render device type. Chunks that contain data for other devices are skipped.
+/// \param [in]  Groups           - Optional semicolon-separated list of groups to load. The group of a chunk is the
+///                                 name of its input render state notation file without the extension.
+///                                 If null, chunks of all groups are loaded.
+/// \param [in]  pDearchiver      - Dearchiver to load the chunks into.
+/// \param [out] pNumLoadedChunks - Optional pointer to the variable that receives the number of loaded chunks.
+/// \return      True if all matching chunks were loaded successfully, and false otherwise.
+///
+/// \remarks     Only the chunk files that match the device type and the groups are read.
+///              Chunk paths in the index are relative to the directory of the index file.
+///              Compressed chunks are decompressed when they are loaded, see DecompressRenderStateArchive.
+///              Chunks of content-addressed archives are checked against their hash in the index, and
+///              the function fails if a chunk does not match.
+Bool DILIGENT_GLOBAL_FUNCTION(LoadRenderStateArchiveChunks)(const Char*         IndexFilePath,
+                                                            RENDER_DEVICE_TYPE  DeviceType,
+                                                            const Char*         Groups,
+                                                            struct IDearchiver* pDearchiver,
+                                                            Uint32*             pNumLoadedChunks DEFAULT_VALUE(nullptr));
+
+/// Compresses a render state archive with deflate.
+
+/// \param [in]  pArchive     - Archive data to compress.
+/// \param [in]  pDictionary  - Optional preset dictionary. The same dictionary must be used to decompress the data.
+/// \param [in]  Level        - Compression level, from 1 (fastest) to 9 (smallest). Decompression speed does not depend on the level.
+/// \param [out] ppCompressed - Address of the memory location where a pointer to the compressed data will be written.
+///
+/// \remarks    A dictionary that contains data shared by many archives, such as the chunks of a split archive,
+///             improves compression of small archives. Only the last 32 KB of the dictionary are used.
+void DILIGENT_GLOBAL_FUNCTION(CompressRenderStateArchive)(const IDataBlob* pArchive,
+                                                          const IDataBlob* pDictionary,
+                                                          Uint32           Level,
+                                                          IDataBlob**      ppCompressed);
+
+/// Decompresses a render state archive compressed by CompressRenderStateArchive.
+
+/// \param [in]  pData       - Compressed or uncompressed archive data.
+/// \param [in]  pDictionary - Dictionary that was used to compress the data, or null if no dictionary was used.
+/// \param [out] ppArchive   - Address of the memory location where a pointer to the decompressed archive will be written.
+///                            If pData is not compressed, it is returned as is. If decompression fails, null is written.
+void DILIGENT_GLOBAL_FUNCTION(DecompressRenderStateArchive)(IDataBlob*       pData,
+                                                            const IDataBlob* pDictionary,
+                                                            IDataBlob**      ppArchive);
+
 #include "../../../DiligentCore/Primitives/interface/UndefGlobalFuncHelperMacros.h"
 
 DILIGENT_END_NAMESPACE // namespace Diligent
@@ -34,6 +34,9 @@
 
 DILIGENT_BEGIN_NAMESPACE(Diligent)
 
+struct IThreadPool;
+struct IMemoryAllocator;
+
 /// Pipeline state notation.
 
 /// \note
@@ -378,16 +381,69 @@ struct RenderStateNotationParserInfo
 };
 typedef struct RenderStateNotationParserInfo RenderStateNotationParserInfo;
 
+/// Render state notation object type.
+DILIGENT_TYPED_ENUM(NOTATION_OBJECT_TYPE, Uint8)
+{
+    /// Shader.
+    NOTATION_OBJECT_TYPE_SHADER = 0,
+
+    /// Render pass.
+    NOTATION_OBJECT_TYPE_RENDER_PASS,
+
+    /// Pipeline resource signature.
+    NOTATION_OBJECT_TYPE_RESOURCE_SIGNATURE,
+
+    /// Pipeline state.
+    NOTATION_OBJECT_TYPE_PIPELINE_STATE,
+
+    NOTATION_OBJECT_TYPE_COUNT
+};
+
 /// Render state notation parser initialization information.
 struct RenderStateNotationParserCreateInfo 
 {
     /// Whether to enable state reloading with IRenderStateNotationParser::Reload() method.
-    bool EnableReload DEFAULT_INITIALIZER(false);
+    bool EnableReload               DEFAULT_INITIALIZER(false);
+
+    /// An optional thread pool that is used to read and parse import files concurrently.
+
+    /// \remarks The states are added in the same order as without the thread pool.
+    ///          The stream factories passed to the parser must support concurrent
+    ///          creation of input streams.
+    struct IThreadPool* pThreadPool DEFAULT_INITIALIZER(nullptr);
+
+    /// An optional allocator that backs the memory of the parsed notation objects.
+
+    /// \remarks If null, the default raw memory allocator is used. The allocator
+    ///          must outlive the parser.
+    struct IMemoryAllocator* pAllocator DEFAULT_INITIALIZER(nullptr);
 };
 typedef struct RenderStateNotationParserCreateInfo RenderStateNotationParserCreateInfo;
 
 // clang-format on
 
+#if DILIGENT_CPP_INTERFACE
+
+/// Computes the hash of the render state notation object name that is used by
+/// IRenderStateNotationParser::GetPipelineStateByHash() and similar methods.
+
+/// \remarks The hash is the 64-bit FNV-1a hash of the name characters. The function is constexpr,
+///          so that the hashes of literal names can be computed at compile time:
+///
+///              constexpr auto GeometryOpaqueHash = ComputeNotationNameHash("GeometryOpaque");
+constexpr Uint64 ComputeNotationNameHash(const Char* Name)
+{
+    Uint64 Hash = 14695981039346656037ull;
+    for (; *Name != '\0'; ++Name)
+    {
+        Hash ^= static_cast<Uint8>(*Name);
+        Hash *= 1099511628211ull;
+    }
+    return Hash;
+}
+
+#endif
+
 // {355AC9f7-5D9D-423D-AE35-80E0028DE17E}
 static const INTERFACE_ID IID_RenderStateNotationParser = {0x355AC9F7, 0x5D9D, 0x423D, {0xAE, 0x35, 0x80, 0xE0, 0x02, 0x8D, 0xE1, 0x7E}};
 
@@ -415,6 +471,9 @@ DILIGENT_BEGIN_INTERFACE(IRenderStateNotationParser, IObject)
     /// - True if the file was parsed successfully.
     /// - False otherwise.
     ///
+    /// \remarks The file may also contain the notation precompiled by Diligent::PrecompileRenderStateNotation,
+    ///          in which case no JSON text is parsed and no import files are opened.
+    ///
     /// \remarks This method must be externally synchronized.
     VIRTUAL Bool METHOD(ParseFile)(THIS_
                                    const Char*                      FilePath,
@@ -482,6 +541,45 @@ DILIGENT_BEGIN_INTERFACE(IRenderStateNotationParser, IObject)
     VIRTUAL CONST RenderPassDesc*  METHOD(GetRenderPassByName)(THIS_
                                                                const Char* Name) CONST PURE;
 
+    /// Returns the pipeline state notation by its name hash. If the resource is not found, returns nullptr.
+
+    /// \param [in] NameHash     - Hash of the PSO name computed by ComputeNotationNameHash().
+    /// \param [in] PipelineType - Pipeline state type.
+    /// \return Const pointer to the PipelineStateNotation structure, see Diligent::PipelineStateNotation.
+    ///
+    /// \remarks Unlike GetPipelineStateByName(), this method does not hash or compare the name strings.
+    ///          This method must be externally synchronized.
+    VIRTUAL CONST PipelineStateNotation* METHOD(GetPipelineStateByHash)(THIS_
+                                                                        Uint64        NameHash,
+                                                                        PIPELINE_TYPE PipelineType DEFAULT_VALUE(PIPELINE_TYPE_INVALID)) CONST PURE;
+
+    /// Returns the resource signature notation by its name hash. If the resource is not found, returns nullptr.
+
+    /// \param [in] NameHash - Hash of the resource signature name computed by ComputeNotationNameHash().
+    /// \return Const pointer to the PipelineResourceSignatureDesc structure, see Diligent::PipelineResourceSignatureDesc.
+    ///
+    /// \remarks This method must be externally synchronized.
+    VIRTUAL CONST PipelineResourceSignatureDesc* METHOD(GetResourceSignatureByHash)(THIS_
+                                                                                    Uint64 NameHash) CONST PURE;
+
+    /// Returns the shader create info by its name hash. If the resource is not found, returns nullptr.
+
+    /// \param [in] NameHash - Hash of the shader name computed by ComputeNotationNameHash().
+    /// \return Const pointer to the ShaderCreateInfo structure, see Diligent::ShaderCreateInfo.
+    ///
+    /// \remarks This method must be externally synchronized.
+    VIRTUAL CONST ShaderCreateInfo* METHOD(GetShaderByHash)(THIS_
+                                                            Uint64 NameHash) CONST PURE;
+
+    /// Returns the render pass description by its name hash. If the resource is not found, returns nullptr.
+
+    /// \param [in] NameHash - Hash of the render pass name computed by ComputeNotationNameHash().
+    /// \return Const pointer to the RenderPassDesc structure, see Diligent::RenderPassDesc.
+    ///
+    /// \remarks This method must be externally synchronized.
+    VIRTUAL CONST RenderPassDesc*  METHOD(GetRenderPassByHash)(THIS_
+                                                               Uint64 NameHash) CONST PURE;
+
     /// Returns the pipeline state notation by its index.
 
     /// \param [in] Index - Pipeline state notation index. The index must be between 0 and the total number
@@ -551,7 +649,22 @@ DILIGENT_BEGIN_INTERFACE(IRenderStateNotationParser, IObject)
     ///
     /// \note   This method is only allowed if the EnableReload member of RenderStateNotationParserCreateInfo
     ///         struct was set to true when the parser was created.
+    ///
+    /// \remarks If none of the parsed files has changed, the states are not parsed again.
+    ///          Use IsStateModified() to find out which states were affected by the reload.
     VIRTUAL bool METHOD(Reload)(THIS) PURE;
+
+    /// Checks if the state was affected by the files that changed during the last reload.
+
+    /// \param [in] ObjectType - Type of the object.
+    /// \param [in] Name       - Name of the object.
+    ///
+    /// \return true if the object is defined in a file whose contents changed during the last Reload() call,
+    ///         or, for pipeline states, if the pipeline uses a modified shader, render pass or resource signature.
+    ///         Returns false if Reload() has not been called.
+    VIRTUAL Bool METHOD(IsStateModified)(THIS_
+                                         NOTATION_OBJECT_TYPE ObjectType,
+                                         const Char*          Name) CONST PURE;
 };
 DILIGENT_END_INTERFACE
 
@@ -566,6 +679,10 @@ DILIGENT_END_INTERFACE
 #    define IRenderStateNotationParser_GetResourceSignatureByName(This, ...)  CALL_IFACE_METHOD(RenderStateNotationParser, GetResourceSignatureByName,  This, __VA_ARGS__)
 #    define IRenderStateNotationParser_GetShaderByName(This, ...)             CALL_IFACE_METHOD(RenderStateNotationParser, GetShaderByName,             This, __VA_ARGS__)
 #    define IRenderStateNotationParser_GetRenderPassByName(This, ...)         CALL_IFACE_METHOD(RenderStateNotationParser, GetRenderPassByName,         This, __VA_ARGS__)
+#    define IRenderStateNotationParser_GetPipelineStateByHash(This, ...)      CALL_IFACE_METHOD(RenderStateNotationParser, GetPipelineStateByHash,      This, __VA_ARGS__)
+#    define IRenderStateNotationParser_GetResourceSignatureByHash(This, ...)  CALL_IFACE_METHOD(RenderStateNotationParser, GetResourceSignatureByHash,  This, __VA_ARGS__)
+#    define IRenderStateNotationParser_GetShaderByHash(This, ...)             CALL_IFACE_METHOD(RenderStateNotationParser, GetShaderByHash,             This, __VA_ARGS__)
+#    define IRenderStateNotationParser_GetRenderPassByHash(This, ...)         CALL_IFACE_METHOD(RenderStateNotationParser, GetRenderPassByHash,         This, __VA_ARGS__)
 #    define IRenderStateNotationParser_GetPipelineStateByIndex(This, ...)     CALL_IFACE_METHOD(RenderStateNotationParser, GetPipelineStateByIndex,     This, __VA_ARGS__)
 #    define IRenderStateNotationParser_GetResourceSignatureByIndex(This, ...) CALL_IFACE_METHOD(RenderStateNotationParser, GetResourceSignatureByIndex, This, __VA_ARGS__)
 #    define IRenderStateNotationParser_GetShaderByIndex(This, ...)            CALL_IFACE_METHOD(RenderStateNotationParser, GetShaderByIndex,            This, __VA_ARGS__)
@@ -573,6 +690,7 @@ DILIGENT_END_INTERFACE
 #    define IRenderStateNotationParser_GetInfo(This, ...)                     CALL_IFACE_METHOD(RenderStateNotationParser, GetInfo,                     This)
 #    define IRenderStateNotationParser_Reset(This)                            CALL_IFACE_METHOD(RenderStateNotationParser, Reset,                       This)
 #    define IRenderStateNotationParser_Reload(This)                           CALL_IFACE_METHOD(RenderStateNotationParser, Reload,                      This)
+#    define IRenderStateNotationParser_IsStateModified(This, ...)             CALL_IFACE_METHOD(RenderStateNotationParser, IsStateModified,             This, __VA_ARGS__)
 // clang-format on
 
 #endif
@@ -582,6 +700,23 @@ DILIGENT_END_INTERFACE
 void DILIGENT_GLOBAL_FUNCTION(CreateRenderStateNotationParser)(const RenderStateNotationParserCreateInfo REF CreateInfo,
                                                                IRenderStateNotationParser**                  pParser);
 
+/// Precompiles render state notation files into a binary form.
+
+/// \param [in]  ppFilePaths       - An array of NumFiles render state notation file paths.
+/// \param [in]  NumFiles          - The number of files.
+/// \param [in]  pStreamFactory    - The factory that is used to load the files and their imports.
+/// \param [out] ppPrecompiledData - Address of the memory location where a pointer to the data blob
+///                                  with the precompiled notation will be stored.
+///
+/// \remarks The precompiled data contains the files and all their imports in a compact binary
+///          encoding and can be loaded with IRenderStateNotationParser::ParseFile, or with
+///          IRenderStateNotationParser::ParseString if the data length is specified.
+///          Loading it yields the same states as parsing the files one by one.
+void DILIGENT_GLOBAL_FUNCTION(PrecompileRenderStateNotation)(const Char* const*               ppFilePaths,
+                                                             Uint32                           NumFiles,
+                                                             IShaderSourceInputStreamFactory* pStreamFactory,
+                                                             IDataBlob**                      ppPrecompiledData);
+
 
 #include "../../../DiligentCore/Primitives/interface/UndefGlobalFuncHelperMacros.h"
 
@@ -36,23 +36,69 @@ constexpr Uint32 JsonInvalidEnum = 501;
 // https://json.nlohmann.me/home/exceptions/#jsonexceptionother_error501
 constexpr Uint32 JsonUnexpectedKey = 501;
 
-#define NLOHMANN_JSON_SERIALIZE_ENUM_EX(ENUM_TYPE, ...)                                                                                                                                                      \
-    inline void to_json(nlohmann::json& j, const ENUM_TYPE& e)                                                                                                                                               \
-    {                                                                                                                                                                                                        \
-        static_assert(std::is_enum<ENUM_TYPE>::value, #ENUM_TYPE " must be an enum!");                                                                                                                       \
-        static const std::pair<ENUM_TYPE, nlohmann::json> m[] = __VA_ARGS__;                                                                                                                                 \
-        auto                                              it  = std::find_if(std::begin(m), std::end(m), [e](const std::pair<ENUM_TYPE, nlohmann::json>& ej_pair) -> bool { return ej_pair.first == e; });   \
-        if (it == std::end(m)) throw nlohmann::json::other_error::create(JsonInvalidEnum, std::string("invalid enum value for " #ENUM_TYPE ""), j);                                                          \
-        j = it->second;                                                                                                                                                                                      \
-    }                                                                                                                                                                                                        \
-    inline void from_json(const nlohmann::json& j, ENUM_TYPE& e)                                                                                                                                             \
-    {                                                                                                                                                                                                        \
-        static_assert(std::is_enum<ENUM_TYPE>::value, #ENUM_TYPE " must be an enum!");                                                                                                                       \
-        static const std::pair<ENUM_TYPE, nlohmann::json> m[] = __VA_ARGS__;                                                                                                                                 \
-        auto                                              it  = std::find_if(std::begin(m), std::end(m), [&j](const std::pair<ENUM_TYPE, nlohmann::json>& ej_pair) -> bool { return ej_pair.second == j; }); \
-        if (it == std::end(m)) throw nlohmann::json::other_error::create(JsonInvalidEnum, std::string("invalid enum value for " #ENUM_TYPE ": ") + j.get<std::string>(), j);                                 \
-        e = it->first;                                                                                                                                                                                       \
+template <typename EnumType>
+struct EnumNameMapping
+{
+    EnumType    Value;
+    const char* Name;
+};
+
+inline bool JsonKeyLess(const char* Lhs, const char* Rhs)
+{
+    return std::strcmp(Lhs, Rhs) < 0;
+}
+
+// Items are in the enum declaration order, so that the first name of an aliased value is written
+template <typename EnumType, size_t NumItems>
+inline const char* GetEnumName(const EnumNameMapping<EnumType> (&Items)[NumItems], EnumType Value, const char* EnumName, const nlohmann::json& Json)
+{
+    for (const auto& Item : Items)
+    {
+        if (Item.Value == Value)
+            return Item.Name;
     }
+    throw nlohmann::json::other_error::create(JsonInvalidEnum, std::string("invalid enum value for ") + EnumName, Json);
+}
+
+// Items must be sorted by name, which the code generator does, so that the name can be binary-searched
+template <typename EnumType, size_t NumItems>
+inline bool FindSortedEnumValue(const EnumNameMapping<EnumType> (&Items)[NumItems], const char* Name, EnumType& Value)
+{
+    auto it = std::lower_bound(std::begin(Items), std::end(Items), Name,
+                               [](const EnumNameMapping<EnumType>& Item, const char* Name) { return JsonKeyLess(Item.Name, Name); });
+    if (it == std::end(Items) || std::strcmp(it->Name, Name) != 0)
+        return false;
+
+    Value = it->Value;
+    return true;
+}
+
+// Overloads for the registered enums are generated, other enums can only be read from numbers
+template <typename EnumType>
+inline bool FindEnumValue(const char* Name, EnumType& Value)
+{
+    return false;
+}
+
+// Returns the index of the key in the sorted array, or -1 if the key is not found
+template <size_t NumKeys>
+inline int FindSortedJsonKey(const char* const (&Keys)[NumKeys], const char* Key)
+{
+    auto it = std::lower_bound(std::begin(Keys), std::end(Keys), Key, JsonKeyLess);
+    return it != std::end(Keys) && std::strcmp(*it, Key) == 0 ? static_cast<int>(it - std::begin(Keys)) : -1;
+}
+
+// Keys must be sorted, which the code generator does, so that every key of the object can be binary-searched
+template <size_t NumKeys>
+inline void ValidateSortedJsonKeys(const nlohmann::json& Json, const char* const (&Keys)[NumKeys])
+{
+    VERIFY(std::is_sorted(std::begin(Keys), std::end(Keys), JsonKeyLess), "Keys are not sorted");
+    for (auto it = Json.begin(); it != Json.end(); ++it)
+    {
+        if (!std::binary_search(std::begin(Keys), std::end(Keys), it.key().c_str(), JsonKeyLess))
+            throw nlohmann::json::other_error::create(JsonUnexpectedKey, std::string("unexpected key: ") + it.key(), Json);
+    }
+}
 
 #define NLOHMANN_JSON_VALIDATE_KEYS(JSON, ...)                                                                                                          \
     do                                                                                                                                                  \
@@ -65,6 +111,22 @@ constexpr Uint32 JsonUnexpectedKey = 501;
         }                                                                                                                                               \
     } while (false)
 
+// Returns the reference to the string stored in the JSON value to avoid copying it to a temporary std::string
+inline const std::string& GetJsonString(const nlohmann::json& Json)
+{
+    if (!Json.is_string())
+        throw nlohmann::json::type_error::create(JsonTypeError, std::string("type must be string, but is ") + Json.type_name(), Json);
+    return Json.get_ref<const std::string&>();
+}
+
+// Returns the pointer to the value of the key, or null if the key is not found. Unlike
+// the contains() and operator[] pair, this searches the object only once.
+inline const nlohmann::json* FindJsonKey(const nlohmann::json& Json, const char* Key)
+{
+    auto const Iter = Json.find(Key);
+    return Iter != Json.end() ? &*Iter : nullptr;
+}
+
 void WriteRSN(nlohmann::json& Json, const ShaderMacro& Type, DynamicLinearAllocator& Allocator);
 
 void ParseRSN(const nlohmann::json& Json, ShaderMacro& Type, DynamicLinearAllocator& Allocator);
@@ -154,7 +216,7 @@ inline void WriteRSN(nlohmann::json& Json, const char* const Str, DynamicLinearA
 template <>
 inline void ParseRSN(const nlohmann::json& Json, const char*& Str, DynamicLinearAllocator& Allocator)
 {
-    Str = Allocator.CopyString(Json.get<std::string>());
+    Str = Allocator.CopyString(GetJsonString(Json));
 }
 
 template <>
@@ -185,7 +247,7 @@ inline void ParseRSN(const nlohmann::json& Json, const Char**& pObjects, Uint32&
 {
     auto* pData = Allocator.ConstructArray<const char*>(Json.size());
     for (size_t i = 0; i < Json.size(); i++)
-        pData[i] = Allocator.CopyString(Json[i].get<std::string>());
+        pData[i] = Allocator.CopyString(GetJsonString(Json[i]));
 
     pObjects    = pData;
     NumElements = static_cast<Uint32>(Json.size());
@@ -273,7 +335,7 @@ inline void DeserializeConstArray(const nlohmann::json& Json, Type (&pObjects)[N
 template <size_t NumElements>
 inline void DeserializeConstArray(const nlohmann::json& Json, char (&pData)[NumElements], DynamicLinearAllocator& Allocator)
 {
-    auto Str = Json.get<std::string>();
+    const auto& Str = GetJsonString(Json);
     memcpy(pData, Str.c_str(), Str.size());
 }
 
@@ -286,16 +348,173 @@ inline bool CompareConstArray(const Type (&Lhs)[NumElements], const Type (&Rhs)[
     return true;
 }
 
+
+// The ReadRSN() functions below mirror ParseRSN(), but read the values directly from the JSON text
+// using RSNJsonReader, so that the nlohmann::json document does not need to be built.
+
+void ReadRSN(RSNJsonReader& Reader, ShaderMacro& Type, DynamicLinearAllocator& Allocator);
+
+template <typename Type, std::enable_if_t<std::is_arithmetic<Type>::value, bool> = true>
+inline void ReadRSN(RSNJsonReader& Reader, Type& Value, DynamicLinearAllocator& Allocator)
+{
+    Value = Reader.ReadNumber<Type>();
+}
+
+template <typename Type, std::enable_if_t<std::is_enum<Type>::value, bool> = true>
+inline void ReadRSN(RSNJsonReader& Reader, Type& Value, DynamicLinearAllocator& Allocator)
+{
+    if (!Reader.IsString())
+    {
+        Value = static_cast<Type>(Reader.ReadNumber<std::underlying_type_t<Type>>());
+        return;
+    }
+
+    const auto& Name = Reader.ReadString();
+    if (!FindEnumValue(Name.c_str(), Value))
+        Reader.Error("invalid enum value: ", Name);
+}
+
+inline void ReadRSN(RSNJsonReader& Reader, const char*& Str, DynamicLinearAllocator& Allocator)
+{
+    Str = Reader.ReadString(Allocator);
+}
+
+template <typename Type>
+inline void ReadRSN(RSNJsonReader& Reader, const Type*& pObject, DynamicLinearAllocator& Allocator)
+{
+    auto* pData = Allocator.Construct<Type>();
+    ReadRSN(Reader, *pData, Allocator);
+    pObject = pData;
+}
+
+template <typename Type>
+inline void ReadRSN(RSNJsonReader& Reader, Type*& pObject, DynamicLinearAllocator& Allocator)
+{
+    auto* pData = Allocator.Construct<Type>();
+    ReadRSN(Reader, *pData, Allocator);
+    pObject = pData;
+}
+
+template <typename Type, typename TypeSize>
+inline void ReadRSN(RSNJsonReader& Reader, const Type*& pObjects, TypeSize& NumElements, DynamicLinearAllocator& Allocator)
+{
+    // The array is scanned ahead to allocate the elements at once
+    const auto Count = Reader.CountArrayElements();
+    auto*      pData = Allocator.ConstructArray<Type>(Count);
+
+    Reader.BeginArray();
+    for (size_t i = 0; Reader.NextElement(); i++)
+        ReadRSN(Reader, pData[i], Allocator);
+
+    pObjects    = pData;
+    NumElements = static_cast<TypeSize>(Count);
+}
+
+inline void ReadRSN(RSNJsonReader& Reader, const void*& pObject, size_t& Size, DynamicLinearAllocator& Allocator)
+{
+    Reader.Error("binary data can't be read from JSON text");
+}
+
+inline void ReadRSN(RSNJsonReader& Reader, const ShaderMacro*& pMacros, DynamicLinearAllocator& Allocator)
+{
+    const auto Count = Reader.CountArrayElements();
+    auto*      pData = Allocator.ConstructArray<ShaderMacro>(Count + 1);
+
+    Reader.BeginArray();
+    for (size_t i = 0; Reader.NextElement(); i++)
+        ReadRSN(Reader, pData[i], Allocator);
+
+    pMacros = pData;
+}
+
+template <typename Type>
+inline void ReadBitwiseEnum(RSNJsonReader& Reader, Type& EnumBits, DynamicLinearAllocator& Allocator)
+{
+    if (Reader.IsArray())
+    {
+        EnumBits = {};
+        Reader.BeginArray();
+        while (Reader.NextElement())
+        {
+            Type Bit = {};
+            ReadRSN(Reader, Bit, Allocator);
+            EnumBits |= Bit;
+        }
+    }
+    else if (Reader.IsString())
+    {
+        ReadRSN(Reader, EnumBits, Allocator);
+    }
+    else
+    {
+        Reader.Error("type must be array or string");
+    }
+}
+
+template <typename Type, size_t NumElements, std::enable_if_t<std::is_arithmetic<Type>::value, bool> = true>
+inline void ReadConstArray(RSNJsonReader& Reader, Type (&pObjects)[NumElements], DynamicLinearAllocator& Allocator)
+{
+    Reader.BeginArray();
+    for (size_t i = 0; Reader.NextElement(); i++)
+    {
+        if (i >= NumElements)
+            Reader.Error("array must have at most ", NumElements, " elements");
+        pObjects[i] = Reader.ReadNumber<Type>();
+    }
+}
+
+template <typename Type, size_t NumElements, std::enable_if_t<!std::is_arithmetic<Type>::value, bool> = true>
+inline void ReadConstArray(RSNJsonReader& Reader, Type (&pObjects)[NumElements], DynamicLinearAllocator& Allocator)
+{
+    Reader.BeginObject();
+    while (const char* Key = Reader.NextKey())
+    {
+        char*      pEnd  = nullptr;
+        const auto Index = std::strtoul(Key, &pEnd, 10);
+        if (pEnd == Key || *pEnd != 0 || Index >= NumElements)
+            Reader.Error("invalid array index: ", Key);
+        ReadRSN(Reader, pObjects[Index], Allocator);
+    }
+}
+
+template <size_t NumElements>
+inline void ReadConstArray(RSNJsonReader& Reader, char (&pData)[NumElements], DynamicLinearAllocator& Allocator)
+{
+    const auto& Str = Reader.ReadString();
+    if (Str.size() >= NumElements)
+        Reader.Error("string must be shorter than ", NumElements, " characters");
+    memcpy(pData, Str.c_str(), Str.size() + 1);
+}
 ''')
 
 CXX_ENUM_SERIALIZE_TEMPLATE = Template(''' 
 {%- macro serialize_enum(type, xitems) -%}
-NLOHMANN_JSON_SERIALIZE_ENUM_EX(
-{{type}}, {
+inline void to_json(nlohmann::json& j, const {{type}}& e)
+{
+    static constexpr EnumNameMapping<{{type}}> Items[] = {
 {%- for item in xitems %}
-{ {{ item['value'] }}, "{{ item['name'] }}" },
+        { {{ item['value'] }}, "{{ item['name'] }}" },
+{%- endfor %}
+    };
+    j = GetEnumName(Items, e, "{{type}}", j);
+}
+
+inline bool FindEnumValue(const char* Name, {{type}}& e)
+{
+    static constexpr EnumNameMapping<{{type}}> SortedItems[] = {
+{%- for item in xitems|sort(attribute='name', case_sensitive=True) %}
+        { {{ item['value'] }}, "{{ item['name'] }}" },
 {%- endfor %}
-})
+    };
+    return FindSortedEnumValue(SortedItems, Name, e);
+}
+
+inline void from_json(const nlohmann::json& j, {{type}}& e)
+{
+    const auto& Name = GetJsonString(j);
+    if (!FindEnumValue(Name.c_str(), e))
+        throw nlohmann::json::other_error::create(JsonInvalidEnum, std::string("invalid enum value for {{type}}: ") + Name, j);
+}
 {% endmacro -%}
 {%- for type, xitems in enums %}
 {{serialize_enum(type, xitems)}}
@@ -334,38 +553,83 @@ inline void WriteRSN(nlohmann::json& Json, const {{ type }}& Type, DynamicLinear
 {%- macro ParseRSN(type, fields, inheritance, fields_size, fields_size_inv) -%}
 inline void ParseRSN(const nlohmann::json& Json, {{ type }}& Type, DynamicLinearAllocator& Allocator)
 {
-NLOHMANN_JSON_VALIDATE_KEYS(Json, {
-{%- for field in fields %}
-    "{{ field['name'] }}",
+{%- set keys = fields|map(attribute='name')|list %}
+{%- if type == "GraphicsPipelineDesc" %}
+{%- set keys = keys + ["pRenderPass"] %}
+{%- endif %}
+    static constexpr const char* SortedKeys[] = {
+{%- for key in keys|sort(case_sensitive=True) %}
+        "{{ key }}",
 {%- endfor %}
-{%- if type == "GraphicsPipelineDesc" -%}
-    "pRenderPass",
-{%- endif -%}
-});
+    };
+    ValidateSortedJsonKeys(Json, SortedKeys);
 {%- for field in fields %}
-    {%- if field['name'] in fields_size_inv -%}
-    {% else %}
-    if (Json.contains("{{ field['name'] }}")) 
-    {% endif -%}
-	{%- if field['meta'] == 'const_array' -%}
-		DeserializeConstArray(Json["{{ field['name'] }}"], Type.{{ field['name'] }}, Allocator);
-    {% elif field['meta'] == 'bitwise' -%}
-        DeserializeBitwiseEnum(Json["{{ field['name'] }}"], Type.{{ field['name'] }}, Allocator);
-    {% elif field['name'] in fields_size_inv -%}
-	{% else %}
-		{%- if field['name'] in fields_size -%}
-            ParseRSN(Json["{{ field['name'] }}"], Type.{{ field['name'] }}, Type.{{ fields_size[field['name']] }}, Allocator);
-        {% elif field['name'] in fields_size_inv -%}
-        {% else -%}
-            ParseRSN(Json["{{ field['name'] }}"], Type.{{ field['name'] }}, Allocator);
-        {% endif -%}
-	{% endif -%}
-{% endfor -%}
+    {%- if field['name'] not in fields_size_inv %}
+    if (const auto* pValue = FindJsonKey(Json, "{{ field['name'] }}"))
+        {%- if field['meta'] == 'const_array' %}
+        DeserializeConstArray(*pValue, Type.{{ field['name'] }}, Allocator);
+        {%- elif field['meta'] == 'bitwise' %}
+        DeserializeBitwiseEnum(*pValue, Type.{{ field['name'] }}, Allocator);
+        {%- elif field['name'] in fields_size %}
+        ParseRSN(*pValue, Type.{{ field['name'] }}, Type.{{ fields_size[field['name']] }}, Allocator);
+        {%- else %}
+        ParseRSN(*pValue, Type.{{ field['name'] }}, Allocator);
+        {%- endif %}
+    {%- endif %}
+{%- endfor %}
+}
+{%- endmacro -%}
+
+{%- macro ReadRSN(type, fields, inheritance, fields_size, fields_size_inv) -%}
+inline void ReadRSN(RSNJsonReader& Reader, {{ type }}& Type, DynamicLinearAllocator& Allocator)
+{
+{%- set keys = fields|map(attribute='name')|list %}
+{%- if type == "GraphicsPipelineDesc" %}
+{%- set keys = keys + ["pRenderPass"] %}
+{%- endif %}
+{%- set sorted_keys = keys|sort(case_sensitive=True) %}
+    static constexpr const char* SortedKeys[] = {
+{%- for key in sorted_keys %}
+        "{{ key }}",
+{%- endfor %}
+    };
+
+    Reader.BeginObject();
+    while (const char* Key = Reader.NextKey())
+    {
+        switch (FindSortedJsonKey(SortedKeys, Key))
+        {
+{%- for key in sorted_keys %}
+{%- set field = fields|selectattr('name', 'equalto', key)|first %}
+{%- if field and field['name'] not in fields_size_inv %}
+            case {{ loop.index0 }}:
+                {%- if field['meta'] == 'const_array' %}
+                ReadConstArray(Reader, Type.{{ field['name'] }}, Allocator);
+                {%- elif field['meta'] == 'bitwise' %}
+                ReadBitwiseEnum(Reader, Type.{{ field['name'] }}, Allocator);
+                {%- elif field['name'] in fields_size %}
+                ReadRSN(Reader, Type.{{ field['name'] }}, Type.{{ fields_size[field['name']] }}, Allocator);
+                {%- else %}
+                ReadRSN(Reader, Type.{{ field['name'] }}, Allocator);
+                {%- endif %}
+                break;
+{%- endif %}
+{%- endfor %}
+            case -1:
+                Reader.Error("unexpected key: ", Key);
+
+            default:
+                // The array sizes are set from the number of elements, and the keys that are
+                // handled by the notation parser are skipped
+                Reader.SkipValue();
+        }
+    }
 }
 {%- endmacro -%}
 
 {%- for type, info in structs %}
 {{ WriteRSN(type, info['fields'], info['inheritance'], field_size[type], field_size_inv[type]) }}
 {{ ParseRSN(type, info['fields'], info['inheritance'], field_size[type], field_size_inv[type])}}
+{{ ReadRSN(type, info['fields'], info['inheritance'], field_size[type], field_size_inv[type])}}
 {% endfor %}
 ''')
@@ -0,0 +1,347 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include "FileWatcher.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+#if PLATFORM_WIN32
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <Windows.h>
+#elif PLATFORM_LINUX || PLATFORM_ANDROID
+#    include <poll.h>
+#    include <sys/inotify.h>
+#    include <unistd.h>
+#    define DILIGENT_USE_INOTIFY 1
+#elif PLATFORM_MACOS || PLATFORM_IOS || PLATFORM_TVOS || PLATFORM_EMSCRIPTEN
+#    include <dirent.h>
+#    include <sys/stat.h>
+#    define DILIGENT_USE_STAT_POLLING 1
+#endif
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// How often the watch thread checks whether it should exit
+constexpr int StopCheckIntervalMs = 100;
+
+} // namespace
+
+FileWatcher::FileWatcher(const Char* Directories, Uint32 DebounceTimeMs) :
+    m_DebounceTime{DebounceTimeMs}
+{
+    VERIFY_EXPR(Directories != nullptr);
+
+    const Char* pDir = Directories;
+    while (*pDir != '\0')
+    {
+        const Char* pEnd = pDir;
+        while (*pEnd != '\0' && *pEnd != ';')
+            ++pEnd;
+        if (pEnd != pDir)
+            m_Directories.emplace_back(pDir, pEnd);
+        pDir = *pEnd == ';' ? pEnd + 1 : pEnd;
+    }
+
+    if (!m_Directories.empty())
+        m_Thread = std::thread{&FileWatcher::WatchThreadFunc, this};
+}
+
+FileWatcher::~FileWatcher()
+{
+    m_Stop.store(true);
+    if (m_Thread.joinable())
+        m_Thread.join();
+}
+
+bool FileWatcher::ConsumeChanges()
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    if (!m_HasChanges || std::chrono::steady_clock::now() - m_LastChangeTime < m_DebounceTime)
+        return false;
+
+    m_HasChanges = false;
+    return true;
+}
+
+void FileWatcher::OnFileChanged(const char* FileName)
+{
+    // A null file name indicates that the changes could not be tracked, e.g. due to an event buffer overflow
+    if (FileName != nullptr && !IsWatchedFile(FileName))
+        return;
+
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    m_HasChanges     = true;
+    m_LastChangeTime = std::chrono::steady_clock::now();
+}
+
+bool FileWatcher::IsWatchedFile(const char* FileName)
+{
+    // Render state notation files and the shader sources and includes they may reference
+    static constexpr const char* WatchedExtensions[] = {
+        "json",
+        "drsn",
+        "hlsl",
+        "hlsli",
+        "fx",
+        "fxh",
+        "glsl",
+        "vsh",
+        "psh",
+        "gsh",
+        "csh",
+        "h",
+        "metal",
+    };
+
+    const char* pDot = strrchr(FileName, '.');
+    if (pDot == nullptr)
+        return false;
+
+    std::string Extension{pDot + 1};
+    std::transform(Extension.begin(), Extension.end(), Extension.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+    for (const auto* WatchedExtension : WatchedExtensions)
+    {
+        if (Extension == WatchedExtension)
+            return true;
+    }
+    return false;
+}
+
+#if PLATFORM_WIN32
+
+void FileWatcher::WatchThreadFunc()
+{
+    struct DirectoryWatch
+    {
+        HANDLE     hDir = INVALID_HANDLE_VALUE;
+        OVERLAPPED Overlapped{};
+        DWORD      Buffer[4096];
+    };
+
+    std::vector<std::unique_ptr<DirectoryWatch>> Watches;
+    std::vector<HANDLE>                          Events;
+
+    auto IssueRead = [](DirectoryWatch& Watch) {
+        return ReadDirectoryChangesW(Watch.hDir, Watch.Buffer, sizeof(Watch.Buffer), FALSE,
+                                     FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE,
+                                     nullptr, &Watch.Overlapped, nullptr) != FALSE;
+    };
+
+    for (const auto& Dir : m_Directories)
+    {
+        if (Watches.size() == MAXIMUM_WAIT_OBJECTS)
+        {
+            LOG_WARNING_MESSAGE("Only ", MAXIMUM_WAIT_OBJECTS, " directories can be watched for changes.");
+            break;
+        }
+
+        auto Watch  = std::make_unique<DirectoryWatch>();
+        Watch->hDir = CreateFileA(Dir.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                  nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        if (Watch->hDir == INVALID_HANDLE_VALUE)
+        {
+            LOG_WARNING_MESSAGE("Failed to open directory '", Dir, "' for watching.");
+            continue;
+        }
+
+        Watch->Overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        if (Watch->Overlapped.hEvent == nullptr || !IssueRead(*Watch))
+        {
+            LOG_WARNING_MESSAGE("Failed to watch directory '", Dir, "'.");
+            if (Watch->Overlapped.hEvent != nullptr)
+                CloseHandle(Watch->Overlapped.hEvent);
+            CloseHandle(Watch->hDir);
+            continue;
+        }
+
+        Events.push_back(Watch->Overlapped.hEvent);
+        Watches.emplace_back(std::move(Watch));
+    }
+
+    while (!m_Stop.load() && !Events.empty())
+    {
+        const auto Res = WaitForMultipleObjects(static_cast<DWORD>(Events.size()), Events.data(), FALSE, StopCheckIntervalMs);
+        if (Res < WAIT_OBJECT_0 || Res >= WAIT_OBJECT_0 + Events.size())
+            continue;
+
+        auto& Watch = *Watches[Res - WAIT_OBJECT_0];
+
+        DWORD BytesTransferred = 0;
+        GetOverlappedResult(Watch.hDir, &Watch.Overlapped, &BytesTransferred, FALSE);
+        ResetEvent(Watch.Overlapped.hEvent);
+
+        if (BytesTransferred == 0)
+        {
+            // The buffer has overflowed and the individual changes are lost
+            OnFileChanged(nullptr);
+        }
+        else
+        {
+            const auto* pData = reinterpret_cast<const Uint8*>(Watch.Buffer);
+            while (true)
+            {
+                const auto& Info = *reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(pData);
+
+                // Only the extension is checked, so the name is narrowed character by character
+                std::string FileName(Info.FileNameLength / sizeof(WCHAR), '\0');
+                for (size_t i = 0; i < FileName.size(); ++i)
+                    FileName[i] = Info.FileName[i] < 128 ? static_cast<char>(Info.FileName[i]) : '_';
+                OnFileChanged(FileName.c_str());
+
+                if (Info.NextEntryOffset == 0)
+                    break;
+                pData += Info.NextEntryOffset;
+            }
+        }
+
+        IssueRead(Watch);
+    }
+
+    for (auto& Watch : Watches)
+    {
+        CancelIo(Watch->hDir);
+        CloseHandle(Watch->Overlapped.hEvent);
+        CloseHandle(Watch->hDir);
+    }
+}
+
+#elif DILIGENT_USE_INOTIFY
+
+void FileWatcher::WatchThreadFunc()
+{
+    const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+    {
+        LOG_WARNING_MESSAGE("Failed to initialize inotify: file changes will not be detected.");
+        return;
+    }
+
+    // Editors either write the file in place or write a temporary file and rename it
+    constexpr uint32_t WatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE;
+    for (const auto& Dir : m_Directories)
+    {
+        if (inotify_add_watch(fd, Dir.c_str(), WatchMask) < 0)
+            LOG_WARNING_MESSAGE("Failed to watch directory '", Dir, "'.");
+    }
+
+    alignas(inotify_event) char Buffer[4096];
+    while (!m_Stop.load())
+    {
+        pollfd PollFd{fd, POLLIN, 0};
+        if (poll(&PollFd, 1, StopCheckIntervalMs) <= 0)
+            continue;
+
+        const auto Size = read(fd, Buffer, sizeof(Buffer));
+        if (Size <= 0)
+            continue;
+
+        for (const char* pData = Buffer; pData < Buffer + Size;)
+        {
+            const auto& Event = *reinterpret_cast<const inotify_event*>(pData);
+            if (Event.mask & IN_Q_OVERFLOW)
+                OnFileChanged(nullptr);
+            else if (Event.len > 0)
+                OnFileChanged(Event.name);
+            pData += sizeof(inotify_event) + Event.len;
+        }
+    }
+
+    close(fd);
+}
+
+#elif DILIGENT_USE_STAT_POLLING
+
+void FileWatcher::WatchThreadFunc()
+{
+    // There are no file system notifications that can be used without a run loop on these
+    // platforms, so the modification times are compared on this thread instead.
+    constexpr int PollIntervalMs = 500;
+
+    std::unordered_map<std::string, time_t> ModificationTimes;
+
+    auto Scan = [&](bool ReportChanges) {
+        std::unordered_map<std::string, time_t> CurrTimes;
+        for (const auto& Dir : m_Directories)
+        {
+            DIR* pDir = opendir(Dir.c_str());
+            if (pDir == nullptr)
+                continue;
+
+            while (const dirent* pEntry = readdir(pDir))
+            {
+                if (!IsWatchedFile(pEntry->d_name))
+                    continue;
+
+                const auto  Path = Dir + '/' + pEntry->d_name;
+                struct stat FileStat;
+                if (stat(Path.c_str(), &FileStat) == 0)
+                    CurrTimes.emplace(Path, FileStat.st_mtime);
+            }
+            closedir(pDir);
+        }
+
+        if (ReportChanges && CurrTimes != ModificationTimes)
+            OnFileChanged(nullptr);
+        ModificationTimes = std::move(CurrTimes);
+    };
+
+    Scan(false);
+    while (!m_Stop.load())
+    {
+        for (int Time = 0; Time < PollIntervalMs && !m_Stop.load(); Time += StopCheckIntervalMs)
+            std::this_thread::sleep_for(std::chrono::milliseconds{StopCheckIntervalMs});
+
+        if (!m_Stop.load())
+            Scan(true);
+    }
+}
+
+#else
+
+void FileWatcher::WatchThreadFunc()
+{
+    LOG_WARNING_MESSAGE("File watching is not supported on this platform: file changes will not be detected.");
+}
+
+#endif
+
+} // namespace Diligent
@@ -0,0 +1,424 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "RSNJsonReader.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace Diligent
+{
+
+namespace
+{
+
+bool IsWhitespace(char Symbol)
+{
+    return Symbol == ' ' || Symbol == '\t' || Symbol == '\n' || Symbol == '\r';
+}
+
+void AppendUTF8(std::string& Str, Uint32 CodePoint)
+{
+    if (CodePoint < 0x80)
+    {
+        Str += static_cast<char>(CodePoint);
+    }
+    else if (CodePoint < 0x800)
+    {
+        Str += static_cast<char>(0xC0 | (CodePoint >> 6));
+        Str += static_cast<char>(0x80 | (CodePoint & 0x3F));
+    }
+    else if (CodePoint < 0x10000)
+    {
+        Str += static_cast<char>(0xE0 | (CodePoint >> 12));
+        Str += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+        Str += static_cast<char>(0x80 | (CodePoint & 0x3F));
+    }
+    else
+    {
+        Str += static_cast<char>(0xF0 | (CodePoint >> 18));
+        Str += static_cast<char>(0x80 | ((CodePoint >> 12) & 0x3F));
+        Str += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+        Str += static_cast<char>(0x80 | (CodePoint & 0x3F));
+    }
+}
+
+} // namespace
+
+char RSNJsonReader::Peek()
+{
+    while (m_pCur < m_pEnd && IsWhitespace(*m_pCur))
+        ++m_pCur;
+    return m_pCur < m_pEnd ? *m_pCur : '\0';
+}
+
+void RSNJsonReader::Expect(char Symbol)
+{
+    const char Next = Peek();
+    if (Next != Symbol)
+    {
+        if (Next == '\0')
+            Error("expected '", Symbol, "', but reached the end of the input");
+        else
+            Error("expected '", Symbol, "', but found '", Next, "'");
+    }
+    ++m_pCur;
+}
+
+void RSNJsonReader::BeginObject()
+{
+    Expect('{');
+    m_IsFirstElement = true;
+}
+
+const char* RSNJsonReader::NextKey()
+{
+    const char Next = Peek();
+    if (Next == '}')
+    {
+        ++m_pCur;
+        m_IsFirstElement = false;
+        return nullptr;
+    }
+
+    if (m_IsFirstElement)
+        m_IsFirstElement = false;
+    else
+        Expect(',');
+
+    ReadStringTo(m_Scratch);
+    Expect(':');
+    return m_Scratch.c_str();
+}
+
+void RSNJsonReader::BeginArray()
+{
+    Expect('[');
+    m_IsFirstElement = true;
+}
+
+bool RSNJsonReader::NextElement()
+{
+    const char Next = Peek();
+    if (Next == ']')
+    {
+        ++m_pCur;
+        m_IsFirstElement = false;
+        return false;
+    }
+
+    if (m_IsFirstElement)
+        m_IsFirstElement = false;
+    else
+        Expect(',');
+
+    return true;
+}
+
+size_t RSNJsonReader::CountArrayElements()
+{
+    if (Peek() != '[')
+        Error("type must be array, but is '", Peek(), "'");
+
+    size_t Count    = 0;
+    int    Depth    = 0;
+    bool   IsEmpty  = true;
+    bool   InString = false;
+    for (const char* pChar = m_pCur; pChar < m_pEnd; ++pChar)
+    {
+        const char Symbol = *pChar;
+        if (InString)
+        {
+            if (Symbol == '\\')
+                ++pChar;
+            else if (Symbol == '"')
+                InString = false;
+            continue;
+        }
+
+        switch (Symbol)
+        {
+            case '"':
+                InString = true;
+                IsEmpty  = false;
+                break;
+
+            case '[':
+            case '{':
+                if (Depth > 0)
+                    IsEmpty = false;
+                ++Depth;
+                break;
+
+            case ']':
+            case '}':
+                if (--Depth == 0)
+                    return IsEmpty ? 0 : Count + 1;
+                break;
+
+            case ',':
+                if (Depth == 1)
+                    ++Count;
+                break;
+
+            default:
+                if (!IsWhitespace(Symbol))
+                    IsEmpty = false;
+        }
+    }
+    Error("unterminated array");
+}
+
+void RSNJsonReader::ReadStringTo(std::string& Str)
+{
+    Expect('"');
+
+    Str.clear();
+    while (m_pCur < m_pEnd && *m_pCur != '"')
+    {
+        const char Symbol = *m_pCur++;
+        if (Symbol != '\\')
+        {
+            Str += Symbol;
+            continue;
+        }
+
+        if (m_pCur >= m_pEnd)
+            break;
+
+        const char Escaped = *m_pCur++;
+        switch (Escaped)
+        {
+            // clang-format off
+            case '"':  Str += '"';  break;
+            case '\\': Str += '\\'; break;
+            case '/':  Str += '/';  break;
+            case 'b':  Str += '\b'; break;
+            case 'f':  Str += '\f'; break;
+            case 'n':  Str += '\n'; break;
+            case 'r':  Str += '\r'; break;
+            case 't':  Str += '\t'; break;
+            // clang-format on
+
+            case 'u':
+            {
+                auto ReadCodeUnit = [this]() {
+                    if (m_pEnd - m_pCur < 4)
+                        Error("invalid unicode escape sequence");
+
+                    Uint32 CodeUnit = 0;
+                    for (int i = 0; i < 4; ++i)
+                    {
+                        const char Digit = *m_pCur++;
+                        CodeUnit <<= 4;
+                        if (Digit >= '0' && Digit <= '9')
+                            CodeUnit |= Digit - '0';
+                        else if (Digit >= 'a' && Digit <= 'f')
+                            CodeUnit |= Digit - 'a' + 10;
+                        else if (Digit >= 'A' && Digit <= 'F')
+                            CodeUnit |= Digit - 'A' + 10;
+                        else
+                            Error("invalid unicode escape sequence");
+                    }
+                    return CodeUnit;
+                };
+
+                Uint32 CodePoint = ReadCodeUnit();
+                if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF)
+                {
+                    // Surrogate pair
+                    if (m_pEnd - m_pCur < 2 || m_pCur[0] != '\\' || m_pCur[1] != 'u')
+                        Error("invalid unicode surrogate pair");
+                    m_pCur += 2;
+
+                    const Uint32 LowSurrogate = ReadCodeUnit();
+                    if (LowSurrogate < 0xDC00 || LowSurrogate > 0xDFFF)
+                        Error("invalid unicode surrogate pair");
+                    CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (LowSurrogate - 0xDC00);
+                }
+                AppendUTF8(Str, CodePoint);
+                break;
+            }
+
+            default:
+                Error("invalid escape sequence '\\", Escaped, "'");
+        }
+    }
+
+    if (m_pCur >= m_pEnd)
+        Error("unterminated string");
+    ++m_pCur;
+}
+
+const std::string& RSNJsonReader::ReadString()
+{
+    if (Peek() != '"')
+        Error("type must be string, but is '", Peek(), "'");
+
+    ReadStringTo(m_Scratch);
+    return m_Scratch;
+}
+
+const char* RSNJsonReader::ReadString(DynamicLinearAllocator& Allocator)
+{
+    return Allocator.CopyString(ReadString());
+}
+
+bool RSNJsonReader::ReadBool()
+{
+    const char Next = Peek();
+    if (Next == 't' && m_pEnd - m_pCur >= 4 && std::strncmp(m_pCur, "true", 4) == 0)
+    {
+        m_pCur += 4;
+        return true;
+    }
+    if (Next == 'f' && m_pEnd - m_pCur >= 5 && std::strncmp(m_pCur, "false", 5) == 0)
+    {
+        m_pCur += 5;
+        return false;
+    }
+    Error("type must be boolean");
+}
+
+size_t RSNJsonReader::ReadNumberToken(char (&Token)[64])
+{
+    Peek();
+
+    size_t Length = 0;
+    while (m_pCur < m_pEnd && std::strchr("+-0123456789.eE", *m_pCur) != nullptr)
+    {
+        if (Length + 1 >= sizeof(Token))
+            Error("number is too long");
+        Token[Length++] = *m_pCur++;
+    }
+    Token[Length] = '\0';
+
+    if (Length == 0)
+        Error("type must be number");
+
+    return Length;
+}
+
+double RSNJsonReader::ReadDouble()
+{
+    char Token[64];
+    ReadNumberToken(Token);
+
+    char*        pEnd  = nullptr;
+    const double Value = std::strtod(Token, &pEnd);
+    if (*pEnd != '\0')
+        Error("invalid number '", Token, "'");
+    return Value;
+}
+
+Int64 RSNJsonReader::ReadSignedInteger()
+{
+    char Token[64];
+    ReadNumberToken(Token);
+
+    char* pEnd = nullptr;
+    if (std::strpbrk(Token, ".eE") != nullptr)
+    {
+        const double Value = std::strtod(Token, &pEnd);
+        if (*pEnd != '\0')
+            Error("invalid number '", Token, "'");
+        return static_cast<Int64>(Value);
+    }
+
+    const Int64 Value = std::strtoll(Token, &pEnd, 10);
+    if (*pEnd != '\0')
+        Error("invalid number '", Token, "'");
+    return Value;
+}
+
+Uint64 RSNJsonReader::ReadUnsignedInteger()
+{
+    char Token[64];
+    ReadNumberToken(Token);
+
+    char* pEnd = nullptr;
+    if (Token[0] == '-' || std::strpbrk(Token, ".eE") != nullptr)
+    {
+        const double Value = std::strtod(Token, &pEnd);
+        if (*pEnd != '\0')
+            Error("invalid number '", Token, "'");
+        return static_cast<Uint64>(static_cast<Int64>(Value));
+    }
+
+    const Uint64 Value = std::strtoull(Token, &pEnd, 10);
+    if (*pEnd != '\0')
+        Error("invalid number '", Token, "'");
+    return Value;
+}
+
+void RSNJsonReader::SkipValue()
+{
+    const char Next = Peek();
+    switch (Next)
+    {
+        case '{':
+            BeginObject();
+            while (NextKey() != nullptr)
+                SkipValue();
+            break;
+
+        case '[':
+            BeginArray();
+            while (NextElement())
+                SkipValue();
+            break;
+
+        case '"':
+            ReadStringTo(m_Scratch);
+            break;
+
+        case 't':
+        case 'f':
+            ReadBool();
+            break;
+
+        case 'n':
+            if (m_pEnd - m_pCur < 4 || std::strncmp(m_pCur, "null", 4) != 0)
+                Error("invalid literal");
+            m_pCur += 4;
+            break;
+
+        case '\0':
+            Error("unexpected end of the input");
+
+        default:
+            ReadDouble();
+    }
+}
+
+void RSNJsonReader::Finish()
+{
+    if (Peek() != '\0')
+        Error("unexpected '", *m_pCur, "' after the end of the value");
+}
+
+} // namespace Diligent
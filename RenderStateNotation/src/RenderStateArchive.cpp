@@ -0,0 +1,391 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include "RenderStateNotationLoader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Dearchiver.h"
+#include "DataBlobImpl.hpp"
+#include "FileWrapper.hpp"
+#include "FileSystem.hpp"
+#include "GraphicsAccessories.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "ArchiveChunkHash.hpp"
+
+#include "json.hpp"
+#include "zlib.h"
+
+namespace Diligent
+{
+
+namespace
+{
+
+struct CompressedArchiveHeader
+{
+    static constexpr Uint32 ExpectedMagic  = 0x5A535244; // DRSZ
+    static constexpr Uint32 CurrentVersion = 1;
+
+    Uint32 Magic            = ExpectedMagic;
+    Uint32 Version          = CurrentVersion;
+    Uint64 UncompressedSize = 0;
+    Uint32 DictionaryId     = 0; // Adler-32 of the dictionary, 0 if no dictionary is used
+    Uint32 Reserved         = 0;
+};
+static_assert(sizeof(CompressedArchiveHeader) == 24, "Compressed archive header size must not change");
+
+// zlib processes at most UINT_MAX bytes per call
+constexpr size_t MaxZLibChunkSize = 1u << 30;
+
+ARCHIVE_DEVICE_DATA_FLAGS RenderDeviceTypeToArchiveDeviceDataFlag(RENDER_DEVICE_TYPE DeviceType)
+{
+    switch (DeviceType)
+    {
+        // clang-format off
+        case RENDER_DEVICE_TYPE_D3D11:  return ARCHIVE_DEVICE_DATA_FLAG_D3D11;
+        case RENDER_DEVICE_TYPE_D3D12:  return ARCHIVE_DEVICE_DATA_FLAG_D3D12;
+        case RENDER_DEVICE_TYPE_GL:     return ARCHIVE_DEVICE_DATA_FLAG_GL;
+        case RENDER_DEVICE_TYPE_GLES:   return ARCHIVE_DEVICE_DATA_FLAG_GLES;
+        case RENDER_DEVICE_TYPE_VULKAN: return ARCHIVE_DEVICE_DATA_FLAG_VULKAN;
+#if PLATFORM_IOS || PLATFORM_TVOS
+        case RENDER_DEVICE_TYPE_METAL:  return ARCHIVE_DEVICE_DATA_FLAG_METAL_IOS;
+#else
+        case RENDER_DEVICE_TYPE_METAL:  return ARCHIVE_DEVICE_DATA_FLAG_METAL_MACOS;
+#endif
+        // clang-format on
+        default:
+            UNEXPECTED("Unexpected render device type");
+            return ARCHIVE_DEVICE_DATA_FLAG_NONE;
+    }
+}
+
+std::vector<std::string> SplitGroups(const Char* Groups)
+{
+    std::vector<std::string> Result;
+    if (Groups == nullptr)
+        return Result;
+
+    std::string Group;
+    for (const auto* c = Groups;; ++c)
+    {
+        if (*c == ';' || *c == '\0')
+        {
+            if (!Group.empty())
+                Result.emplace_back(std::move(Group));
+            Group.clear();
+            if (*c == '\0')
+                break;
+        }
+        else
+        {
+            Group += *c;
+        }
+    }
+    return Result;
+}
+
+} // namespace
+
+void CompressRenderStateArchive(const IDataBlob* pArchive,
+                                const IDataBlob* pDictionary,
+                                Uint32           Level,
+                                IDataBlob**      ppCompressed)
+{
+    DEV_CHECK_ERR(pArchive != nullptr, "pArchive must not be null");
+    DEV_CHECK_ERR(ppCompressed != nullptr && *ppCompressed == nullptr, "ppCompressed must not be null and must point to null");
+
+    z_stream Stream{};
+    if (deflateInit(&Stream, static_cast<int>(std::min(std::max(Level, 1u), 9u))) != Z_OK)
+    {
+        LOG_ERROR_MESSAGE("Failed to initialize deflate stream");
+        return;
+    }
+
+    CompressedArchiveHeader Header;
+    Header.UncompressedSize = pArchive->GetSize();
+    if (pDictionary != nullptr && pDictionary->GetSize() > 0)
+    {
+        deflateSetDictionary(&Stream, static_cast<const Bytef*>(pDictionary->GetConstDataPtr()), static_cast<uInt>(pDictionary->GetSize()));
+        Header.DictionaryId = static_cast<Uint32>(Stream.adler);
+    }
+
+    auto pCompressed = DataBlobImpl::Create(sizeof(Header) + deflateBound(&Stream, static_cast<uLong>(pArchive->GetSize())));
+    memcpy(pCompressed->GetDataPtr(), &Header, sizeof(Header));
+
+    const auto* pSrc    = static_cast<const Bytef*>(pArchive->GetConstDataPtr());
+    size_t      SrcLeft = pArchive->GetSize();
+    size_t      DstSize = sizeof(Header);
+
+    int Status = Z_OK;
+    while (Status == Z_OK)
+    {
+        if (Stream.avail_in == 0 && SrcLeft > 0)
+        {
+            Stream.next_in  = const_cast<Bytef*>(pSrc);
+            Stream.avail_in = static_cast<uInt>(std::min(SrcLeft, MaxZLibChunkSize));
+            pSrc += Stream.avail_in;
+            SrcLeft -= Stream.avail_in;
+        }
+
+        if (DstSize == pCompressed->GetSize())
+            pCompressed->Resize(DstSize + DstSize / 2);
+
+        Stream.next_out  = static_cast<Bytef*>(pCompressed->GetDataPtr()) + DstSize;
+        Stream.avail_out = static_cast<uInt>(std::min(pCompressed->GetSize() - DstSize, MaxZLibChunkSize));
+
+        const auto AvailOut = Stream.avail_out;
+        Status              = deflate(&Stream, SrcLeft == 0 ? Z_FINISH : Z_NO_FLUSH);
+        DstSize += AvailOut - Stream.avail_out;
+    }
+    deflateEnd(&Stream);
+
+    if (Status != Z_STREAM_END)
+    {
+        LOG_ERROR_MESSAGE("Failed to compress render state archive");
+        return;
+    }
+
+    pCompressed->Resize(DstSize);
+    *ppCompressed = pCompressed.Detach();
+}
+
+void DecompressRenderStateArchive(IDataBlob*       pData,
+                                  const IDataBlob* pDictionary,
+                                  IDataBlob**      ppArchive)
+{
+    DEV_CHECK_ERR(pData != nullptr, "pData must not be null");
+    DEV_CHECK_ERR(ppArchive != nullptr && *ppArchive == nullptr, "ppArchive must not be null and must point to null");
+
+    CompressedArchiveHeader Header;
+    if (pData->GetSize() < sizeof(Header) ||
+        (memcpy(&Header, pData->GetConstDataPtr(), sizeof(Header)), Header.Magic != CompressedArchiveHeader::ExpectedMagic))
+    {
+        // Not compressed
+        *ppArchive = pData;
+        pData->AddRef();
+        return;
+    }
+
+    if (Header.Version != CompressedArchiveHeader::CurrentVersion)
+    {
+        LOG_ERROR_MESSAGE("Unsupported compressed render state archive version ", Header.Version, ". Expected version: ", Uint32{CompressedArchiveHeader::CurrentVersion}, ".");
+        return;
+    }
+
+    z_stream Stream{};
+    if (inflateInit(&Stream) != Z_OK)
+    {
+        LOG_ERROR_MESSAGE("Failed to initialize inflate stream");
+        return;
+    }
+
+    auto pArchive = DataBlobImpl::Create(static_cast<size_t>(Header.UncompressedSize));
+
+    const auto* pSrc    = static_cast<const Bytef*>(pData->GetConstDataPtr()) + sizeof(Header);
+    size_t      SrcLeft = pData->GetSize() - sizeof(Header);
+    auto*       pDst    = static_cast<Bytef*>(pArchive->GetDataPtr());
+    size_t      DstLeft = pArchive->GetSize();
+
+    int Status = Z_OK;
+    while (Status == Z_OK)
+    {
+        if (Stream.avail_in == 0)
+        {
+            Stream.next_in  = const_cast<Bytef*>(pSrc);
+            Stream.avail_in = static_cast<uInt>(std::min(SrcLeft, MaxZLibChunkSize));
+            pSrc += Stream.avail_in;
+            SrcLeft -= Stream.avail_in;
+        }
+        if (Stream.avail_out == 0)
+        {
+            Stream.next_out  = pDst;
+            Stream.avail_out = static_cast<uInt>(std::min(DstLeft, MaxZLibChunkSize));
+            pDst += Stream.avail_out;
+            DstLeft -= Stream.avail_out;
+        }
+
+        Status = inflate(&Stream, Z_NO_FLUSH);
+        if (Status == Z_NEED_DICT)
+        {
+            if (pDictionary == nullptr || Stream.adler != Header.DictionaryId)
+            {
+                LOG_ERROR_MESSAGE("Render state archive was compressed with a dictionary that was not provided");
+                break;
+            }
+            Status = inflateSetDictionary(&Stream, static_cast<const Bytef*>(pDictionary->GetConstDataPtr()), static_cast<uInt>(pDictionary->GetSize()));
+        }
+        else if (Status == Z_BUF_ERROR)
+        {
+            // No progress is possible if the input is truncated or the output exceeds
+            // the size stored in the header. Otherwise, one of the buffers needs a refill.
+            if ((Stream.avail_in == 0 && SrcLeft == 0) || (Stream.avail_out == 0 && DstLeft == 0))
+                break;
+            Status = Z_OK;
+        }
+    }
+    const auto TotalOut = Stream.total_out;
+    inflateEnd(&Stream);
+
+    if (Status != Z_STREAM_END || TotalOut != Header.UncompressedSize)
+    {
+        LOG_ERROR_MESSAGE("Failed to decompress render state archive");
+        return;
+    }
+
+    *ppArchive = pArchive.Detach();
+}
+
+Bool LoadRenderStateArchiveChunks(const Char*        IndexFilePath,
+                                  RENDER_DEVICE_TYPE DeviceType,
+                                  const Char*        Groups,
+                                  IDearchiver*       pDearchiver,
+                                  Uint32*            pNumLoadedChunks)
+{
+    DEV_CHECK_ERR(IndexFilePath != nullptr, "IndexFilePath must not be null");
+    DEV_CHECK_ERR(pDearchiver != nullptr, "pDearchiver must not be null");
+
+    if (pNumLoadedChunks != nullptr)
+        *pNumLoadedChunks = 0;
+
+    try
+    {
+        FileWrapper IndexFile{IndexFilePath, EFileAccessMode::Read};
+        if (!IndexFile)
+            LOG_ERROR_AND_THROW("Failed to open archive index file '", IndexFilePath, "'.");
+
+        auto pIndexData = DataBlobImpl::Create(0);
+        IndexFile->Read(pIndexData);
+
+        const auto* pIndexString = static_cast<const char*>(pIndexData->GetConstDataPtr());
+        const auto  Index        = nlohmann::json::parse(pIndexString, pIndexString + pIndexData->GetSize());
+
+        std::string IndexDir;
+        FileSystem::GetPathComponents(IndexFilePath, &IndexDir, nullptr);
+
+        RefCntAutoPtr<IDataBlob> pDictionary;
+        if (Index.contains("Dictionary"))
+        {
+            auto DictionaryPath = Index["Dictionary"].get<std::string>();
+            if (!IndexDir.empty())
+                DictionaryPath = IndexDir + FileSystem::SlashSymbol + DictionaryPath;
+
+            FileWrapper DictionaryFile{DictionaryPath.c_str(), EFileAccessMode::Read};
+            if (!DictionaryFile)
+                LOG_ERROR_AND_THROW("Failed to open compression dictionary '", DictionaryPath, "'.");
+
+            pDictionary = DataBlobImpl::Create(0);
+            DictionaryFile->Read(pDictionary);
+        }
+
+        const auto  RequestedGroups = SplitGroups(Groups);
+        const auto* DeviceName      = GetArchiveDeviceDataFlagString(RenderDeviceTypeToArchiveDeviceDataFlag(DeviceType));
+
+        Uint32 NumLoadedChunks = 0;
+        for (const auto& Chunk : Index.at("Chunks"))
+        {
+            // Chunks without device name contain data for all devices
+            const auto& ChunkDevice = Chunk.at("Device").get_ref<const std::string&>();
+            if (!ChunkDevice.empty() && ChunkDevice != DeviceName)
+                continue;
+
+            const auto& ChunkGroup = Chunk.at("Group").get_ref<const std::string&>();
+            if (!RequestedGroups.empty() && std::find(RequestedGroups.begin(), RequestedGroups.end(), ChunkGroup) == RequestedGroups.end())
+                continue;
+
+            auto ChunkPath = Chunk.at("Path").get<std::string>();
+            if (!IndexDir.empty())
+                ChunkPath = IndexDir + FileSystem::SlashSymbol + ChunkPath;
+
+            FileWrapper ChunkFile{ChunkPath.c_str(), EFileAccessMode::Read};
+            if (!ChunkFile)
+                LOG_ERROR_AND_THROW("Failed to open archive chunk '", ChunkPath, "'.");
+
+            auto pChunkData = DataBlobImpl::Create(0);
+            ChunkFile->Read(pChunkData);
+
+            // Chunks of content-addressed archives are validated individually, so that a partially
+            // applied patch is detected without reading the chunks that did not change.
+            if (Chunk.contains("Hash"))
+            {
+                const auto Hash = ArchiveChunkHashToString(ComputeArchiveChunkHash(pChunkData->GetConstDataPtr(), pChunkData->GetSize()));
+                if (Hash != Chunk["Hash"].get_ref<const std::string&>())
+                    LOG_ERROR_AND_THROW("Archive chunk '", ChunkPath, "' does not match the hash in the index. The chunk is corrupted or out of date.");
+            }
+
+            RefCntAutoPtr<IDataBlob> pArchive;
+            DecompressRenderStateArchive(pChunkData, pDictionary, &pArchive);
+            if (!pArchive)
+                LOG_ERROR_AND_THROW("Failed to decompress archive chunk '", ChunkPath, "'.");
+
+            if (!pDearchiver->LoadArchive(pArchive))
+                LOG_ERROR_AND_THROW("Failed to load archive chunk '", ChunkPath, "'.");
+
+            ++NumLoadedChunks;
+        }
+
+        if (pNumLoadedChunks != nullptr)
+            *pNumLoadedChunks = NumLoadedChunks;
+    }
+    catch (...)
+    {
+        return False;
+    }
+    return True;
+}
+
+} // namespace Diligent
+
+extern "C"
+{
+    void Diligent_CompressRenderStateArchive(const Diligent::IDataBlob* pArchive,
+                                             const Diligent::IDataBlob* pDictionary,
+                                             Diligent::Uint32           Level,
+                                             Diligent::IDataBlob**      ppCompressed)
+    {
+        Diligent::CompressRenderStateArchive(pArchive, pDictionary, Level, ppCompressed);
+    }
+
+    void Diligent_DecompressRenderStateArchive(Diligent::IDataBlob*       pData,
+                                               const Diligent::IDataBlob* pDictionary,
+                                               Diligent::IDataBlob**      ppArchive)
+    {
+        Diligent::DecompressRenderStateArchive(pData, pDictionary, ppArchive);
+    }
+
+    Diligent::Bool Diligent_LoadRenderStateArchiveChunks(const Diligent::Char*        IndexFilePath,
+                                                         Diligent::RENDER_DEVICE_TYPE DeviceType,
+                                                         const Diligent::Char*        Groups,
+                                                         Diligent::IDearchiver*       pDearchiver,
+                                                         Diligent::Uint32*            pNumLoadedChunks)
+    {
+        return Diligent::LoadRenderStateArchiveChunks(IndexFilePath, DeviceType, Groups, pDearchiver, pNumLoadedChunks);
+    }
+}
@@ -25,60 +25,216 @@
  */
 
 #include "RenderStateNotationLoaderImpl.hpp"
+
+#include <algorithm>
+#include <cstring>
+
 #include "DefaultRawMemoryAllocator.hpp"
 #include "CallbackWrapper.hpp"
 #include "DynamicLinearAllocator.hpp"
+#include "DataBlobImpl.hpp"
+#include "FileWrapper.hpp"
+#include "FileSystem.hpp"
+#include "json.hpp"
+#include "ToolsTrace.hpp"
 
 namespace Diligent
 {
 
+PipelineStateLoadTaskImpl::PipelineStateLoadTaskImpl(IReferenceCounters* pRefCounters, const LoadPipelineStateInfo& LoadInfo) :
+    TBase{pRefCounters},
+    m_Name{LoadInfo.Name},
+    m_LoadInfo{LoadInfo}
+{
+    m_LoadInfo.Name = m_Name.c_str();
+    // Callbacks are stored separately since several requests may share the task
+    m_LoadInfo.OnPipelineLoaded      = nullptr;
+    m_LoadInfo.pOnPipelineLoadedData = nullptr;
+}
+
+void PipelineStateLoadTaskImpl::WaitForCompletion()
+{
+    std::unique_lock<std::mutex> Lock{m_Mtx};
+    m_CompleteCV.wait(Lock, [this]() { return m_IsComplete.load(); });
+}
+
+void PipelineStateLoadTaskImpl::AddCallback(void (*OnPipelineLoaded)(IPipelineState*, void*), void* pUserData)
+{
+    if (OnPipelineLoaded == nullptr)
+        return;
+
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        if (!m_IsComplete.load())
+        {
+            m_Callbacks.emplace_back(OnPipelineLoaded, pUserData);
+            return;
+        }
+    }
+    OnPipelineLoaded(m_pPSO, pUserData);
+}
+
+void PipelineStateLoadTaskImpl::Complete(IPipelineState* pPSO)
+{
+    std::vector<CallbackType> Callbacks;
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        VERIFY(!m_IsComplete.load(), "The task has already been completed");
+        m_pPSO = pPSO;
+        m_IsComplete.store(true);
+        Callbacks.swap(m_Callbacks);
+    }
+    m_CompleteCV.notify_all();
+
+    for (const auto& Callback : Callbacks)
+        Callback.first(m_pPSO, Callback.second);
+}
+
 RenderStateNotationLoaderImpl::RenderStateNotationLoaderImpl(IReferenceCounters* pRefCounters, const RenderStateNotationLoaderCreateInfo& CreateInfo) :
     TBase{pRefCounters},
+    m_RecordPipelineUsage{CreateInfo.RecordPipelineUsage},
+    m_Allocator{CreateInfo.pAllocator != nullptr ? *CreateInfo.pAllocator : DefaultRawMemoryAllocator::GetAllocator()},
     m_DeviceWithCache{CreateInfo.pDevice, CreateInfo.pStateCache},
     m_pParser{CreateInfo.pParser},
-    m_pStreamFactory{CreateInfo.pStreamFactory}
+    m_pStreamFactory{CreateInfo.pStreamFactory},
+    m_pThreadPool{CreateInfo.pThreadPool},
+    m_StateCachePath{CreateInfo.StateCachePath != nullptr ? CreateInfo.StateCachePath : ""}
 {
     VERIFY_EXPR(CreateInfo.pDevice != nullptr && CreateInfo.pParser != nullptr);
+
+    if (CreateInfo.WatchDirectories != nullptr && CreateInfo.WatchDirectories[0] != '\0')
+        m_pFileWatcher = std::make_unique<FileWatcher>(CreateInfo.WatchDirectories, CreateInfo.ReloadDebounceTime);
+
+    if (CreateInfo.pStateCache != nullptr && !m_StateCachePath.empty())
+        LoadStateCache(CreateInfo.pStateCache);
 }
 
-void RenderStateNotationLoaderImpl::LoadPipelineState(const LoadPipelineStateInfo& LoadInfo, IPipelineState** ppPSO)
+RenderStateNotationLoaderImpl::~RenderStateNotationLoaderImpl()
 {
-    DEV_CHECK_ERR(LoadInfo.Name != nullptr, "LoadInfo.Name  must not be null");
-    DEV_CHECK_ERR(ppPSO != nullptr, "ppPSO must not be null");
-    DEV_CHECK_ERR(*ppPSO == nullptr, "*ppPSO is not null. Make sure you are not overwriting reference to an existing object as this may result in memory leaks.");
+    SaveStateCache();
 
-    try
+    // No other method may run during destruction, so the thread can't be replaced while it is joined
+    if (m_SaveStateCacheThread.joinable())
+        m_SaveStateCacheThread.join();
+}
+
+template <typename ObjectType, typename MapType, typename FindType, typename CreateType>
+RefCntAutoPtr<ObjectType> RenderStateNotationLoaderImpl::FindOrCreateObject(ObjectCache<MapType>& Cache, const Char* Name, const FindType& Find, const CreateType& Create)
+{
+    auto& Shard = Cache.GetShard(Name);
     {
-        auto FindPipeline = [this](const Char* Name, PIPELINE_TYPE PipelineType) -> RefCntAutoPtr<IPipelineState> //
+        std::unique_lock<std::mutex> Lock{Shard.Mtx};
+        while (true)
         {
-            const auto Iter = m_PipelineStateCache.find(std::make_pair(HashMapStringKey{Name, true}, PipelineType));
-            if (Iter != m_PipelineStateCache.end())
-                return Iter->second;
-            return {};
-        };
+            if (RefCntAutoPtr<ObjectType> pObject = Find(Shard.Objects))
+                return pObject;
 
-        RefCntAutoPtr<IPipelineState> pPipeline;
+            // If another thread is creating an object with the same name, wait until it
+            // is done and check the cache again: the object may not have been added to it.
+            if (Shard.PendingNames.find(Name) == Shard.PendingNames.end())
+                break;
 
-        if (LoadInfo.PipelineType != PIPELINE_TYPE_INVALID)
+            Shard.PendingCV.wait(Lock);
+        }
+        Shard.PendingNames.emplace(HashMapStringKey{Name, true});
+    }
+
+    auto OnCreated = [&](ObjectType* pObject, bool AddToCache) {
+        if (pObject != nullptr && AddToCache)
         {
-            pPipeline = FindPipeline(LoadInfo.Name, LoadInfo.PipelineType);
+            // The modify callbacks may have renamed the object, so its shard may differ from
+            // the requested name's one. The object must be added before the pending name is
+            // removed, or a waiting thread could find neither and create the object again.
+            auto  Key      = GetCacheKey(pObject);
+            auto& KeyShard = Cache.GetShard(GetCacheKeyName(Key));
+
+            std::lock_guard<std::mutex> Lock{KeyShard.Mtx};
+            KeyShard.Objects.emplace(std::move(Key), pObject);
         }
-        else
         {
-            PIPELINE_TYPE PipelineTypes[] = {
-                PIPELINE_TYPE_GRAPHICS,
-                PIPELINE_TYPE_MESH,
-                PIPELINE_TYPE_COMPUTE,
-                PIPELINE_TYPE_RAY_TRACING,
-                PIPELINE_TYPE_TILE};
-
-            for (Uint32 i = 0; i < _countof(PipelineTypes) && pPipeline == nullptr; i++)
-                pPipeline = FindPipeline(LoadInfo.Name, PipelineTypes[i]);
+            std::lock_guard<std::mutex> Lock{Shard.Mtx};
+            Shard.PendingNames.erase(Name);
         }
+        Shard.PendingCV.notify_all();
+    };
+
+    RefCntAutoPtr<ObjectType> pObject;
+
+    bool AddToCache = false;
+    try
+    {
+        pObject = Create(AddToCache);
+    }
+    catch (...)
+    {
+        OnCreated(nullptr, false);
+        throw;
+    }
+    OnCreated(pObject, AddToCache);
+
+    return pObject;
+}
+
+RefCntAutoPtr<IPipelineState> RenderStateNotationLoaderImpl::FindPipeline(const TNamedPipelineHashMap<RefCntAutoPtr<IPipelineState>>& Pipelines, const Char* Name, PIPELINE_TYPE PipelineType)
+{
+    auto FindPipelineType = [&](PIPELINE_TYPE Type) -> RefCntAutoPtr<IPipelineState> //
+    {
+        const auto Iter = Pipelines.find(std::make_pair(HashMapStringKey{Name}, Type));
+        if (Iter != Pipelines.end())
+            return Iter->second;
+        return {};
+    };
+
+    if (PipelineType != PIPELINE_TYPE_INVALID)
+        return FindPipelineType(PipelineType);
+
+    PIPELINE_TYPE PipelineTypes[] = {
+        PIPELINE_TYPE_GRAPHICS,
+        PIPELINE_TYPE_MESH,
+        PIPELINE_TYPE_COMPUTE,
+        PIPELINE_TYPE_RAY_TRACING,
+        PIPELINE_TYPE_TILE};
+
+    RefCntAutoPtr<IPipelineState> pPipeline;
+    for (Uint32 i = 0; i < _countof(PipelineTypes) && pPipeline == nullptr; i++)
+        pPipeline = FindPipelineType(PipelineTypes[i]);
+    return pPipeline;
+}
+
+template <typename ObjectType>
+RefCntAutoPtr<ObjectType> RenderStateNotationLoaderImpl::FindNamedObject(const TNamedObjectHashMap<RefCntAutoPtr<ObjectType>>& Objects, const Char* Name)
+{
+    auto Iter = Objects.find(Name);
+    if (Iter != Objects.end())
+        return Iter->second;
+    return {};
+}
 
-        if (pPipeline == nullptr)
+void RenderStateNotationLoaderImpl::LoadPipelineState(const LoadPipelineStateInfo& LoadInfo, IPipelineState** ppPSO)
+{
+    RecordPipelineUsage(LoadInfo);
+    LoadPipelineStateImpl(LoadInfo, ppPSO);
+}
+
+void RenderStateNotationLoaderImpl::LoadPipelineStateImpl(const LoadPipelineStateInfo& LoadInfo, IPipelineState** ppPSO)
+{
+    DEV_CHECK_ERR(LoadInfo.Name != nullptr, "LoadInfo.Name  must not be null");
+    DEV_CHECK_ERR(ppPSO != nullptr, "ppPSO must not be null");
+    DEV_CHECK_ERR(*ppPSO == nullptr, "*ppPSO is not null. Make sure you are not overwriting reference to an existing object as this may result in memory leaks.");
+
+    DILIGENT_TRACE_ZONE("RSN::LoadPipelineState");
+
+    try
+    {
+        auto FindLoadedPipeline = [&LoadInfo](const TNamedPipelineHashMap<RefCntAutoPtr<IPipelineState>>& Pipelines) {
+            return FindPipeline(Pipelines, LoadInfo.Name, LoadInfo.PipelineType);
+        };
+
+        auto CreatePipeline = [&](bool& AddToCache) -> RefCntAutoPtr<IPipelineState> //
         {
-            DynamicLinearAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator()};
+            RefCntAutoPtr<IPipelineState> pPipeline;
+
+            DynamicLinearAllocator Allocator{m_Allocator};
 
             std::vector<RefCntAutoPtr<IShader>>                    PipelineShaders;
             std::vector<RefCntAutoPtr<IPipelineResourceSignature>> PipelineSignatures;
@@ -89,22 +245,15 @@ void RenderStateNotationLoaderImpl::LoadPipelineState(const LoadPipelineStateInf
                 if (Name == nullptr)
                     return nullptr;
 
-                auto AddToCache = LoadInfo.AddToCache;
-                auto Callback   = MakeCallback([&](ShaderCreateInfo& ShaderCI) {
+                auto pShader = LoadShader(Name, LoadInfo.AddToCache, [&](ShaderCreateInfo& ShaderCI, bool& AddShaderToCache) {
                     if (LoadInfo.ModifyShader != nullptr)
-                        LoadInfo.ModifyShader(ShaderCI, ShaderType, AddToCache, LoadInfo.pModifyShaderData);
+                        LoadInfo.ModifyShader(ShaderCI, ShaderType, AddShaderToCache, LoadInfo.pModifyShaderData);
                 });
 
-                RefCntAutoPtr<IShader> pShader;
-                LoadShader({Name, false, Callback, Callback}, &pShader);
-
                 if (!pShader)
                     LOG_ERROR_AND_THROW("Failed to load shader '", Name, "' for pipeline '", LoadInfo.Name, "'.");
 
-                if (AddToCache)
-                    m_ShaderCache.emplace(HashMapStringKey{pShader->GetDesc().Name, false}, pShader);
-                else
-                    PipelineShaders.push_back(pShader);
+                PipelineShaders.push_back(pShader);
 
                 return pShader;
             };
@@ -114,21 +263,15 @@ void RenderStateNotationLoaderImpl::LoadPipelineState(const LoadPipelineStateInf
                 if (Name == nullptr)
                     return nullptr;
 
-                auto AddToCache = LoadInfo.AddToCache;
-                auto Callback   = MakeCallback([&](RenderPassDesc& RenderPassCI) {
+                VERIFY_EXPR(!pRenderPass);
+                pRenderPass = LoadRenderPass(Name, LoadInfo.AddToCache, [&](RenderPassDesc& RenderPassCI, bool& AddRenderPassToCache) {
                     if (LoadInfo.ModifyRenderPass != nullptr)
-                        LoadInfo.ModifyRenderPass(RenderPassCI, AddToCache, LoadInfo.pModifyRenderPassData);
+                        LoadInfo.ModifyRenderPass(RenderPassCI, AddRenderPassToCache, LoadInfo.pModifyRenderPassData);
                 });
 
-                VERIFY_EXPR(!pRenderPass);
-                LoadRenderPass({Name, false, Callback, Callback}, &pRenderPass);
-
                 if (!pRenderPass)
                     LOG_ERROR_AND_THROW("Failed to load render pass '", Name, "' for pipeline '", LoadInfo.Name, "'.");
 
-                if (AddToCache)
-                    m_RenderPassCache.emplace(HashMapStringKey{pRenderPass->GetDesc().Name, false}, pRenderPass);
-
                 return pRenderPass;
             };
 
@@ -137,22 +280,15 @@ void RenderStateNotationLoaderImpl::LoadPipelineState(const LoadPipelineStateInf
                 if (Name == nullptr)
                     return nullptr;
 
-                auto AddToCache = LoadInfo.AddToCache;
-                auto Callback   = MakeCallback([&](PipelineResourceSignatureDesc& ResourceSignatureCI) {
+                auto pResourceSignature = LoadResourceSignature(Name, LoadInfo.AddToCache, [&](PipelineResourceSignatureDesc& ResourceSignatureCI, bool& AddSignatureToCache) {
                     if (LoadInfo.ModifyResourceSignature != nullptr)
-                        LoadInfo.ModifyResourceSignature(ResourceSignatureCI, AddToCache, LoadInfo.pModifyResourceSignatureData);
+                        LoadInfo.ModifyResourceSignature(ResourceSignatureCI, AddSignatureToCache, LoadInfo.pModifyResourceSignatureData);
                 });
 
-                RefCntAutoPtr<IPipelineResourceSignature> pResourceSignature;
-                LoadResourceSignature({Name, false, Callback, Callback}, &pResourceSignature);
-
                 if (!pResourceSignature)
                     LOG_ERROR_AND_THROW("Failed to load resource signature '", Name, "' for pipeline '", LoadInfo.Name, "'.");
 
-                if (AddToCache)
-                    m_ResourceSignatureCache.emplace(HashMapStringKey{pResourceSignature->GetDesc().Name, false}, pResourceSignature);
-                else
-                    PipelineSignatures.push_back(pResourceSignature);
+                PipelineSignatures.push_back(pResourceSignature);
 
                 return pResourceSignature;
             };
@@ -292,11 +428,11 @@ void RenderStateNotationLoaderImpl::LoadPipelineState(const LoadPipelineStateInf
                     break;
             }
 
-            if (LoadInfo.AddToCache)
-                m_PipelineStateCache.emplace(std::make_pair(HashMapStringKey{pPipeline->GetDesc().Name, false}, pPipeline->GetDesc().PipelineType), pPipeline);
-        }
+            AddToCache = LoadInfo.AddToCache;
+            return pPipeline;
+        };
 
-        *ppPSO = pPipeline.Detach();
+        *ppPSO = FindOrCreateObject<IPipelineState>(m_PipelineStateCache, LoadInfo.Name, FindLoadedPipeline, CreatePipeline).Detach();
     }
     catch (...)
     {
@@ -304,75 +440,185 @@ void RenderStateNotationLoaderImpl::LoadPipelineState(const LoadPipelineStateInf
     }
 }
 
-void RenderStateNotationLoaderImpl::LoadResourceSignature(const LoadResourceSignatureInfo& LoadInfo, IPipelineResourceSignature** ppSignature)
+void RenderStateNotationLoaderImpl::LoadPipelineStates(const LoadPipelineStateInfo* pLoadInfos, Uint32 NumPipelines, IPipelineState** ppPSOs)
+{
+    DEV_CHECK_ERR(NumPipelines == 0 || pLoadInfos != nullptr, "pLoadInfos must not be null");
+    DEV_CHECK_ERR(NumPipelines == 0 || ppPSOs != nullptr, "ppPSOs must not be null");
+
+    if (!m_pThreadPool || NumPipelines <= 1)
+    {
+        for (Uint32 i = 0; i < NumPipelines; ++i)
+            LoadPipelineState(pLoadInfos[i], &ppPSOs[i]);
+        return;
+    }
+
+    // Every pipeline is loaded by its own task: shader compilation and pipeline creation dominate
+    // the cost, and shared dependencies are deduplicated through the object caches.
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    Tasks.reserve(NumPipelines);
+    for (Uint32 i = 0; i < NumPipelines; ++i)
+    {
+        const auto& LoadInfo = pLoadInfos[i];
+        auto* const ppPSO    = &ppPSOs[i];
+        Tasks.emplace_back(EnqueueAsyncWork(m_pThreadPool, [this, &LoadInfo, ppPSO](Uint32) {
+            LoadPipelineState(LoadInfo, ppPSO);
+        }));
+    }
+    for (auto& pTask : Tasks)
+        pTask->WaitForCompletion();
+}
+
+void RenderStateNotationLoaderImpl::LoadPipelineStateAsync(const LoadPipelineStateInfo& LoadInfo, IPipelineStateLoadTask** ppTask)
+{
+    RecordPipelineUsage(LoadInfo);
+    LoadPipelineStateAsyncImpl(LoadInfo, ppTask);
+}
+
+void RenderStateNotationLoaderImpl::LoadPipelineStateAsyncImpl(const LoadPipelineStateInfo& LoadInfo, IPipelineStateLoadTask** ppTask)
 {
     DEV_CHECK_ERR(LoadInfo.Name != nullptr, "LoadInfo.Name  must not be null");
-    DEV_CHECK_ERR(ppSignature != nullptr, "ppSignature must not be null");
-    DEV_CHECK_ERR(*ppSignature == nullptr, "*ppSignature is not null. Make sure you are not overwriting reference to an existing object as this may result in memory leaks.");
+    DEV_CHECK_ERR(ppTask != nullptr, "ppTask must not be null");
+    DEV_CHECK_ERR(*ppTask == nullptr, "*ppTask is not null. Make sure you are not overwriting reference to an existing object as this may result in memory leaks.");
 
     try
     {
-        auto Iter = m_ResourceSignatureCache.find(LoadInfo.Name);
-        if (Iter != m_ResourceSignatureCache.end())
+        RefCntAutoPtr<IPipelineState>            pPipeline;
+        RefCntAutoPtr<PipelineStateLoadTaskImpl> pTask;
+
         {
-            *ppSignature = Iter->second;
-            (*ppSignature)->AddRef();
+            auto& Shard = m_PipelineStateCache.GetShard(LoadInfo.Name);
+
+            std::lock_guard<std::mutex> Lock{Shard.Mtx};
+            pPipeline = FindPipeline(Shard.Objects, LoadInfo.Name, LoadInfo.PipelineType);
         }
-        else
-        {
-            const auto* pRSNDesc = m_pParser->GetResourceSignatureByName(LoadInfo.Name);
-            if (!pRSNDesc)
-                LOG_ERROR_AND_THROW("Failed to find resource signature '", LoadInfo.Name, "'.");
 
-            PipelineResourceSignatureDesc RSDesc = *pRSNDesc;
-            if (LoadInfo.Modify != nullptr)
-                LoadInfo.Modify(RSDesc, LoadInfo.pUserData);
+        bool IsNewTask = false;
+        if (!pPipeline)
+        {
+            // A task that completes concurrently removes itself from the list only after its pipeline
+            // has been added to the cache, so at worst a new task finds the pipeline in the cache.
+            std::lock_guard<std::mutex> Lock{m_PipelineLoadTasksMtx};
+            if (LoadInfo.AddToCache)
+            {
+                auto Iter = m_PipelineLoadTasks.find(std::make_pair(HashMapStringKey{LoadInfo.Name}, LoadInfo.PipelineType));
+                if (Iter != m_PipelineLoadTasks.end())
+                    pTask = Iter->second;
+            }
 
-            auto pSignature = m_DeviceWithCache.CreatePipelineResourceSignature(RSDesc);
+            if (!pTask)
+            {
+                pTask     = MakeNewRCObj<PipelineStateLoadTaskImpl>()(LoadInfo);
+                IsNewTask = true;
+                if (LoadInfo.AddToCache)
+                    m_PipelineLoadTasks.emplace(std::make_pair(HashMapStringKey{pTask->GetLoadInfo().Name}, LoadInfo.PipelineType), pTask);
+            }
+        }
 
-            if (LoadInfo.AddToCache)
-                m_ResourceSignatureCache.emplace(HashMapStringKey{RSDesc.Name, false}, pSignature);
+        if (pPipeline)
+        {
+            pTask = MakeNewRCObj<PipelineStateLoadTaskImpl>()(LoadInfo);
+            pTask->Complete(pPipeline);
+        }
+        pTask->AddCallback(LoadInfo.OnPipelineLoaded, LoadInfo.pOnPipelineLoadedData);
 
-            *ppSignature = pSignature.Detach();
+        if (IsNewTask)
+        {
+            if (m_pThreadPool)
+            {
+                // Keep the loader alive until the task is finished
+                RefCntAutoPtr<RenderStateNotationLoaderImpl> pThis{this};
+                EnqueueAsyncWork(m_pThreadPool, [pThis, pTask](Uint32) {
+                    pThis->RunPipelineLoadTask(*pTask);
+                });
+            }
+            else
+            {
+                RunPipelineLoadTask(*pTask);
+            }
         }
+
+        *ppTask = pTask.Detach();
     }
     catch (...)
     {
-        LOG_ERROR_MESSAGE("Failed to load resource signature '", LoadInfo.Name, "'.");
+        LOG_ERROR_MESSAGE("Failed to start loading pipeline state '", LoadInfo.Name, "'.");
     }
 }
 
-void RenderStateNotationLoaderImpl::LoadRenderPass(const LoadRenderPassInfo& LoadInfo, IRenderPass** ppRenderPass)
+void RenderStateNotationLoaderImpl::RunPipelineLoadTask(PipelineStateLoadTaskImpl& Task)
+{
+    const auto& LoadInfo = Task.GetLoadInfo();
+
+    RefCntAutoPtr<IPipelineState> pPipeline;
+    LoadPipelineStateImpl(LoadInfo, &pPipeline);
+
+    if (LoadInfo.AddToCache)
+    {
+        // The pipeline is in the cache now, so new requests will not need the task
+        std::lock_guard<std::mutex> Lock{m_PipelineLoadTasksMtx};
+        m_PipelineLoadTasks.erase(std::make_pair(HashMapStringKey{LoadInfo.Name}, LoadInfo.PipelineType));
+    }
+
+    Task.Complete(pPipeline);
+}
+
+void RenderStateNotationLoaderImpl::LoadResourceSignature(const LoadResourceSignatureInfo& LoadInfo, IPipelineResourceSignature** ppSignature)
 {
     DEV_CHECK_ERR(LoadInfo.Name != nullptr, "LoadInfo.Name  must not be null");
-    DEV_CHECK_ERR(ppRenderPass != nullptr, "ppRenderPass must not be null");
-    DEV_CHECK_ERR(*ppRenderPass == nullptr, "*ppRenderPass is not null. Make sure you are not overwriting reference to an existing object as this may result in memory leaks.");
+    DEV_CHECK_ERR(ppSignature != nullptr, "ppSignature must not be null");
+    DEV_CHECK_ERR(*ppSignature == nullptr, "*ppSignature is not null. Make sure you are not overwriting reference to an existing object as this may result in memory leaks.");
 
     try
     {
-        auto Iter = m_RenderPassCache.find(LoadInfo.Name);
-        if (Iter != m_RenderPassCache.end())
-        {
-            *ppRenderPass = Iter->second;
-            (*ppRenderPass)->AddRef();
-        }
-        else
-        {
-            const auto* pRSNDesc = m_pParser->GetRenderPassByName(LoadInfo.Name);
+        *ppSignature = LoadResourceSignature(LoadInfo.Name, LoadInfo.AddToCache, [&LoadInfo](PipelineResourceSignatureDesc& RSDesc, bool&) {
+                           if (LoadInfo.Modify != nullptr)
+                               LoadInfo.Modify(RSDesc, LoadInfo.pUserData);
+                       })
+                           .Detach();
+    }
+    catch (...)
+    {
+        LOG_ERROR_MESSAGE("Failed to load resource signature '", LoadInfo.Name, "'.");
+    }
+}
+
+template <typename ModifyType>
+RefCntAutoPtr<IPipelineResourceSignature> RenderStateNotationLoaderImpl::LoadResourceSignature(const Char* Name, bool AddToCache, const ModifyType& Modify)
+{
+    DILIGENT_TRACE_ZONE("RSN::LoadResourceSignature");
+
+    return FindOrCreateObject<IPipelineResourceSignature>(
+        m_ResourceSignatureCache, Name,
+        [Name](const TNamedObjectHashMap<RefCntAutoPtr<IPipelineResourceSignature>>& Signatures) {
+            return FindNamedObject(Signatures, Name);
+        },
+        [&](bool& AddSignatureToCache) {
+            const auto* pRSNDesc = m_pParser->GetResourceSignatureByName(Name);
             if (!pRSNDesc)
-                LOG_ERROR_AND_THROW("Failed to find render pass '", LoadInfo.Name, "'.");
+                LOG_ERROR_AND_THROW("Failed to find resource signature '", Name, "'.");
 
-            RenderPassDesc RPDesc = *pRSNDesc;
-            if (LoadInfo.Modify != nullptr)
-                LoadInfo.Modify(RPDesc, LoadInfo.pUserData);
+            PipelineResourceSignatureDesc RSDesc = *pRSNDesc;
 
-            auto pRenderPass = m_DeviceWithCache.CreateRenderPass(RPDesc);
+            AddSignatureToCache = AddToCache;
+            Modify(RSDesc, AddSignatureToCache);
 
-            if (LoadInfo.AddToCache)
-                m_RenderPassCache.emplace(HashMapStringKey{RPDesc.Name, false}, pRenderPass);
+            return m_DeviceWithCache.CreatePipelineResourceSignature(RSDesc);
+        });
+}
 
-            *ppRenderPass = pRenderPass.Detach();
-        }
+void RenderStateNotationLoaderImpl::LoadRenderPass(const LoadRenderPassInfo& LoadInfo, IRenderPass** ppRenderPass)
+{
+    DEV_CHECK_ERR(LoadInfo.Name != nullptr, "LoadInfo.Name  must not be null");
+    DEV_CHECK_ERR(ppRenderPass != nullptr, "ppRenderPass must not be null");
+    DEV_CHECK_ERR(*ppRenderPass == nullptr, "*ppRenderPass is not null. Make sure you are not overwriting reference to an existing object as this may result in memory leaks.");
+
+    try
+    {
+        *ppRenderPass = LoadRenderPass(LoadInfo.Name, LoadInfo.AddToCache, [&LoadInfo](RenderPassDesc& RPDesc, bool&) {
+                            if (LoadInfo.Modify != nullptr)
+                                LoadInfo.Modify(RPDesc, LoadInfo.pUserData);
+                        })
+                            .Detach();
     }
     catch (...)
     {
@@ -380,6 +626,30 @@ void RenderStateNotationLoaderImpl::LoadRenderPass(const LoadRenderPassInfo& Loa
     }
 }
 
+template <typename ModifyType>
+RefCntAutoPtr<IRenderPass> RenderStateNotationLoaderImpl::LoadRenderPass(const Char* Name, bool AddToCache, const ModifyType& Modify)
+{
+    DILIGENT_TRACE_ZONE("RSN::LoadRenderPass");
+
+    return FindOrCreateObject<IRenderPass>(
+        m_RenderPassCache, Name,
+        [Name](const TNamedObjectHashMap<RefCntAutoPtr<IRenderPass>>& RenderPasses) {
+            return FindNamedObject(RenderPasses, Name);
+        },
+        [&](bool& AddRenderPassToCache) {
+            const auto* pRSNDesc = m_pParser->GetRenderPassByName(Name);
+            if (!pRSNDesc)
+                LOG_ERROR_AND_THROW("Failed to find render pass '", Name, "'.");
+
+            RenderPassDesc RPDesc = *pRSNDesc;
+
+            AddRenderPassToCache = AddToCache;
+            Modify(RPDesc, AddRenderPassToCache);
+
+            return m_DeviceWithCache.CreateRenderPass(RPDesc);
+        });
+}
+
 void RenderStateNotationLoaderImpl::LoadShader(const LoadShaderInfo& LoadInfo, IShader** ppShader)
 {
     DEV_CHECK_ERR(LoadInfo.Name != nullptr, "LoadInfo.Name  must not be null");
@@ -388,45 +658,147 @@ void RenderStateNotationLoaderImpl::LoadShader(const LoadShaderInfo& LoadInfo, I
 
     try
     {
-        auto Iter = m_ShaderCache.find(LoadInfo.Name);
-        if (Iter != m_ShaderCache.end())
-        {
-            *ppShader = Iter->second;
-            (*ppShader)->AddRef();
-        }
-        else
-        {
-            const auto* pRSNDesc = m_pParser->GetShaderByName(LoadInfo.Name);
+        *ppShader = LoadShader(LoadInfo.Name, LoadInfo.AddToCache, [&LoadInfo](ShaderCreateInfo& ShaderCI, bool&) {
+                        if (LoadInfo.Modify != nullptr)
+                            LoadInfo.Modify(ShaderCI, LoadInfo.pUserData);
+                    })
+                        .Detach();
+    }
+    catch (...)
+    {
+        LOG_ERROR_MESSAGE("Failed to load shader '", LoadInfo.Name, "'.");
+    }
+}
+
+template <typename ModifyType>
+RefCntAutoPtr<IShader> RenderStateNotationLoaderImpl::LoadShader(const Char* Name, bool AddToCache, const ModifyType& Modify)
+{
+    DILIGENT_TRACE_ZONE("RSN::LoadShader");
+
+    return FindOrCreateObject<IShader>(
+        m_ShaderCache, Name,
+        [Name](const TNamedObjectHashMap<RefCntAutoPtr<IShader>>& Shaders) {
+            return FindNamedObject(Shaders, Name);
+        },
+        [&](bool& AddShaderToCache) -> RefCntAutoPtr<IShader> {
+            const auto* pRSNDesc = m_pParser->GetShaderByName(Name);
             if (!pRSNDesc)
-                LOG_ERROR_AND_THROW("Failed to find shader '", LoadInfo.Name, "'.");
+                LOG_ERROR_AND_THROW("Failed to find shader '", Name, "'.");
 
             ShaderCreateInfo ShaderCI           = *pRSNDesc;
             ShaderCI.pShaderSourceStreamFactory = m_pStreamFactory;
-            if (LoadInfo.Modify != nullptr)
-                LoadInfo.Modify(ShaderCI, LoadInfo.pUserData);
 
-            auto pShader = m_DeviceWithCache.CreateShader(ShaderCI);
+            AddShaderToCache = AddToCache;
+            Modify(ShaderCI, AddShaderToCache);
 
-            if (LoadInfo.AddToCache)
-                m_ShaderCache.emplace(HashMapStringKey{ShaderCI.Desc.Name, false}, pShader);
+            // Shaders that are not added to the cache are always created anew
+            const auto ContentKey = AddShaderToCache ? GetShaderContentKey(ShaderCI) : std::string{};
+            if (!ContentKey.empty())
+            {
+                std::lock_guard<std::mutex> Lock{m_ShadersByContentMtx};
 
-            *ppShader = pShader.Detach();
-        }
+                auto Iter = m_ShadersByContent.find(ContentKey);
+                if (Iter != m_ShadersByContent.end())
+                    return Iter->second;
+            }
+
+            auto pShader = m_DeviceWithCache.CreateShader(ShaderCI);
+            if (pShader && !ContentKey.empty())
+            {
+                // If another thread has created an identical shader in the meantime, use that one
+                std::lock_guard<std::mutex> Lock{m_ShadersByContentMtx};
+                return m_ShadersByContent.emplace(ContentKey, pShader).first->second;
+            }
+            return pShader;
+        });
+}
+
+std::string RenderStateNotationLoaderImpl::GetShaderContentKey(const ShaderCreateInfo& ShaderCI)
+{
+    // Shaders that report compiler output or convert their source can't be shared
+    if (ShaderCI.ppConversionStream != nullptr || ShaderCI.ppCompilerOutput != nullptr)
+        return {};
+
+    std::string Key;
+
+    auto AppendString = [&Key](const char* Str) {
+        if (Str != nullptr)
+            Key.append(Str);
+        Key.push_back('\0');
+    };
+    auto AppendData = [&Key](const void* pData, size_t Size) {
+        Key.append(reinterpret_cast<const char*>(&Size), sizeof(Size));
+        Key.append(static_cast<const char*>(pData), Size);
+    };
+    auto AppendValue = [&AppendData](const auto& Value) {
+        AppendData(&Value, sizeof(Value));
+    };
+
+    // The shader name is intentionally not part of the key
+    AppendValue(ShaderCI.Desc.ShaderType);
+    AppendValue(ShaderCI.Desc.UseCombinedTextureSamplers);
+    AppendString(ShaderCI.Desc.CombinedSamplerSuffix);
+
+    // The same file path refers to the same source only within one stream factory
+    AppendValue(ShaderCI.pShaderSourceStreamFactory);
+    AppendString(ShaderCI.FilePath);
+    if (ShaderCI.Source != nullptr)
+        AppendData(ShaderCI.Source, ShaderCI.SourceLength != 0 ? ShaderCI.SourceLength : strlen(ShaderCI.Source));
+    else
+        AppendData(nullptr, 0);
+    if (ShaderCI.ByteCode != nullptr)
+        AppendData(ShaderCI.ByteCode, ShaderCI.ByteCodeSize);
+    else
+        AppendData(nullptr, 0);
+
+    AppendString(ShaderCI.EntryPoint);
+    for (const auto* pMacro = ShaderCI.Macros; pMacro != nullptr && (pMacro->Name != nullptr || pMacro->Definition != nullptr); ++pMacro)
+    {
+        AppendString(pMacro->Name);
+        AppendString(pMacro->Definition);
     }
-    catch (...)
+    Key.push_back('\0');
+
+    AppendValue(ShaderCI.SourceLanguage);
+    AppendValue(ShaderCI.ShaderCompiler);
+    AppendValue(ShaderCI.HLSLVersion);
+    AppendValue(ShaderCI.GLSLVersion);
+    AppendValue(ShaderCI.GLESSLVersion);
+    AppendValue(ShaderCI.CompileFlags);
+
+    return Key;
+}
+
+template <typename MapType>
+void RenderStateNotationLoaderImpl::EvictModifiedObjects(ObjectCache<MapType>& Cache, NOTATION_OBJECT_TYPE ObjectType)
+{
+    for (auto& Shard : Cache.Shards)
     {
-        LOG_ERROR_MESSAGE("Failed to load shader '", LoadInfo.Name, "'.");
+        std::lock_guard<std::mutex> Lock{Shard.Mtx};
+        for (auto Iter = Shard.Objects.begin(); Iter != Shard.Objects.end();)
+        {
+            if (m_pParser->IsStateModified(ObjectType, GetCacheKeyName(Iter->first).GetStr()))
+                Iter = Shard.Objects.erase(Iter);
+            else
+                ++Iter;
+        }
     }
 }
 
 bool RenderStateNotationLoaderImpl::Reload()
 {
+    DILIGENT_TRACE_ZONE("RSN::Reload");
+
     if (!m_pParser->Reload())
         return false;
     if (auto* pCache = m_DeviceWithCache.GetCache())
     {
         auto Callback = MakeCallback(
             [this](const char* PipelineName, GraphicsPipelineDesc& GraphicsDesc) {
+                // Pipelines that are not affected by the changed files keep their current description
+                if (!m_pParser->IsStateModified(NOTATION_OBJECT_TYPE_PIPELINE_STATE, PipelineName))
+                    return;
+
                 const auto* pPsoNotation = m_pParser->GetPipelineStateByName(PipelineName);
                 if (pPsoNotation == nullptr)
                 {
@@ -441,9 +813,286 @@ bool RenderStateNotationLoaderImpl::Reload()
             });
         pCache->Reload(Callback, Callback);
     }
+    else
+    {
+        // Without the render state cache, the objects can't be reloaded in place, so the modified
+        // objects are removed from the cache and will be created again the next time they are loaded.
+        EvictModifiedObjects(m_PipelineStateCache, NOTATION_OBJECT_TYPE_PIPELINE_STATE);
+        EvictModifiedObjects(m_ResourceSignatureCache, NOTATION_OBJECT_TYPE_RESOURCE_SIGNATURE);
+        EvictModifiedObjects(m_RenderPassCache, NOTATION_OBJECT_TYPE_RENDER_PASS);
+        EvictModifiedObjects(m_ShaderCache, NOTATION_OBJECT_TYPE_SHADER);
+
+        // The keys refer to the shader files by path, so the shaders created from modified files can't be told apart
+        std::lock_guard<std::mutex> Lock{m_ShadersByContentMtx};
+        m_ShadersByContent.clear();
+    }
+
+    // Keep the cache file up to date with the reloaded shaders and pipelines
+    SaveStateCache();
+
     return true;
 }
 
+bool RenderStateNotationLoaderImpl::ReloadIfModified()
+{
+    if (!m_pFileWatcher || !m_pFileWatcher->ConsumeChanges())
+        return false;
+
+    // Only the states defined in the changed files are updated, see IRenderStateNotationParser::IsStateModified
+    return Reload();
+}
+
+namespace
+{
+
+// FNV-1a hash of the data
+Uint64 ComputeDataHash(const IDataBlob& Data)
+{
+    const auto* pBytes = static_cast<const Uint8*>(Data.GetConstDataPtr());
+    const auto  Size   = Data.GetSize();
+
+    Uint64 Hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < Size; ++i)
+    {
+        Hash ^= pBytes[i];
+        Hash *= 0x100000001B3ull;
+    }
+    return Hash;
+}
+
+} // namespace
+
+void RenderStateNotationLoaderImpl::LoadStateCache(IRenderStateCache* pCache)
+{
+    // The cache file does not exist on the first run
+    if (!FileSystem::FileExists(m_StateCachePath.c_str()))
+        return;
+
+    FileWrapper File{m_StateCachePath.c_str(), EFileAccessMode::Read};
+    if (!File)
+    {
+        LOG_WARNING_MESSAGE("Failed to open render state cache file '", m_StateCachePath, "'.");
+        return;
+    }
+
+    auto pData = DataBlobImpl::Create(0);
+    File->Read(pData);
+
+    if (!pCache->Load(pData))
+    {
+        // The file may have been written by another version of the engine, or by a run that was
+        // interrupted while writing it. It will be overwritten by the next save.
+        LOG_WARNING_MESSAGE("Failed to load render state cache from '", m_StateCachePath, "'. The cache will be rebuilt.");
+        return;
+    }
+
+    m_SavedStateCacheHash = ComputeDataHash(*pData);
+}
+
+void RenderStateNotationLoaderImpl::WriteStateCache(IRenderStateCache* pCache)
+{
+    RefCntAutoPtr<IDataBlob> pData;
+    if (!pCache->WriteToBlob(&pData) || !pData)
+    {
+        LOG_ERROR_MESSAGE("Failed to serialize the render state cache.");
+        return;
+    }
+
+    // Nothing has been added to the cache since it was loaded or last written
+    const auto Hash = ComputeDataHash(*pData);
+    if (Hash == m_SavedStateCacheHash)
+        return;
+
+    FileWrapper File{m_StateCachePath.c_str(), EFileAccessMode::Overwrite};
+    if (!File)
+    {
+        LOG_ERROR_MESSAGE("Failed to open render state cache file '", m_StateCachePath, "' for writing.");
+        return;
+    }
+
+    if (!File->Write(pData->GetConstDataPtr(), pData->GetSize()))
+    {
+        LOG_ERROR_MESSAGE("Failed to write render state cache file '", m_StateCachePath, "'.");
+        return;
+    }
+
+    m_SavedStateCacheHash = Hash;
+}
+
+void RenderStateNotationLoaderImpl::SaveStateCacheThreadFunc()
+{
+    auto* pCache = m_DeviceWithCache.GetCache();
+    VERIFY_EXPR(pCache != nullptr);
+
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> Lock{m_SaveStateCacheMtx};
+            if (!m_StateCacheSaveRequested)
+            {
+                m_IsSavingStateCache = false;
+                return;
+            }
+            m_StateCacheSaveRequested = false;
+        }
+
+        WriteStateCache(pCache);
+    }
+}
+
+void RenderStateNotationLoaderImpl::SaveStateCache()
+{
+    if (m_DeviceWithCache.GetCache() == nullptr || m_StateCachePath.empty())
+        return;
+
+    std::lock_guard<std::mutex> Lock{m_SaveStateCacheMtx};
+
+    m_StateCacheSaveRequested = true;
+    if (m_IsSavingStateCache)
+        return;
+
+    // The previous thread has finished writing the cache and is about to exit
+    if (m_SaveStateCacheThread.joinable())
+        m_SaveStateCacheThread.join();
+
+    m_IsSavingStateCache   = true;
+    m_SaveStateCacheThread = std::thread{&RenderStateNotationLoaderImpl::SaveStateCacheThreadFunc, this};
+}
+
+void RenderStateNotationLoaderImpl::RecordPipelineUsage(const LoadPipelineStateInfo& LoadInfo)
+{
+    if (!m_RecordPipelineUsage || LoadInfo.Name == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> Lock{m_PipelineUsageMtx};
+
+    auto Iter = m_PipelineUsageIndices.find(std::make_pair(HashMapStringKey{LoadInfo.Name}, LoadInfo.PipelineType));
+    if (Iter == m_PipelineUsageIndices.end())
+    {
+        PipelineUsage Usage;
+        Usage.Name         = LoadInfo.Name;
+        Usage.PipelineType = LoadInfo.PipelineType;
+        m_PipelineUsage.emplace_back(std::move(Usage));
+        Iter = m_PipelineUsageIndices.emplace(std::make_pair(HashMapStringKey{LoadInfo.Name, true}, LoadInfo.PipelineType), m_PipelineUsage.size() - 1).first;
+    }
+    ++m_PipelineUsage[Iter->second].Count;
+}
+
+void RenderStateNotationLoaderImpl::GetPipelineUsage(IDataBlob** ppUsage)
+{
+    DEV_CHECK_ERR(ppUsage != nullptr, "ppUsage must not be null");
+    DEV_CHECK_ERR(*ppUsage == nullptr, "*ppUsage is not null. Make sure you are not overwriting reference to an existing object as this may result in memory leaks.");
+
+    nlohmann::json Pipelines = nlohmann::json::array();
+    {
+        std::lock_guard<std::mutex> Lock{m_PipelineUsageMtx};
+        for (const auto& Usage : m_PipelineUsage)
+        {
+            nlohmann::json Pipeline;
+            Pipeline["Name"]         = Usage.Name;
+            Pipeline["PipelineType"] = static_cast<Uint32>(Usage.PipelineType);
+            Pipeline["Count"]        = Usage.Count;
+            Pipelines.push_back(std::move(Pipeline));
+        }
+    }
+
+    nlohmann::json Json;
+    Json["Pipelines"] = std::move(Pipelines);
+
+    const auto String = Json.dump();
+    auto       pData  = DataBlobImpl::Create(String.size(), String.data());
+    *ppUsage          = pData.Detach();
+}
+
+Uint32 RenderStateNotationLoaderImpl::WarmupPipelineStates(const IDataBlob* pUsage, Uint32 MaxPipelines)
+{
+    DEV_CHECK_ERR(pUsage != nullptr, "pUsage must not be null");
+
+    DILIGENT_TRACE_ZONE("RSN::WarmupPipelineStates");
+
+    std::vector<PipelineUsage> Pipelines;
+    try
+    {
+        const auto* pData = static_cast<const char*>(pUsage->GetConstDataPtr());
+        const auto  Json  = nlohmann::json::parse(pData, pData + pUsage->GetSize());
+        for (const auto& Pipeline : Json.at("Pipelines"))
+        {
+            PipelineUsage Usage;
+            Usage.Name         = Pipeline.at("Name").get<std::string>();
+            Usage.PipelineType = static_cast<PIPELINE_TYPE>(Pipeline.at("PipelineType").get<Uint32>());
+            Usage.Count        = Pipeline.at("Count").get<Uint32>();
+            Pipelines.emplace_back(std::move(Usage));
+        }
+    }
+    catch (std::exception& e)
+    {
+        LOG_ERROR_MESSAGE("Failed to parse pipeline usage list: ", e.what());
+        return 0;
+    }
+
+    // Pipelines that were requested equally often keep the order of their first request
+    std::stable_sort(Pipelines.begin(), Pipelines.end(), [](const PipelineUsage& LHS, const PipelineUsage& RHS) { return LHS.Count > RHS.Count; });
+
+    std::vector<RefCntAutoPtr<IPipelineStateLoadTask>> Tasks;
+    for (const auto& Usage : Pipelines)
+    {
+        if (MaxPipelines != 0 && Tasks.size() >= MaxPipelines)
+            break;
+
+        // The list may have been recorded with a different version of the states
+        if (m_pParser->GetPipelineStateByName(Usage.Name.c_str(), Usage.PipelineType) == nullptr)
+            continue;
+
+        LoadPipelineStateInfo LoadInfo{};
+        LoadInfo.Name         = Usage.Name.c_str();
+        LoadInfo.PipelineType = Usage.PipelineType;
+        LoadInfo.AddToCache   = true;
+
+        RefCntAutoPtr<IPipelineStateLoadTask> pTask;
+        LoadPipelineStateAsyncImpl(LoadInfo, &pTask);
+        if (pTask)
+            Tasks.emplace_back(std::move(pTask));
+    }
+
+    const auto NumTasks = StaticCast<Uint32>(Tasks.size());
+
+    std::lock_guard<std::mutex> Lock{m_WarmupTasksMtx};
+    for (auto& pTask : Tasks)
+    {
+        if (!pTask->IsComplete())
+            m_WarmupTasks.emplace_back(std::move(pTask));
+    }
+    return NumTasks;
+}
+
+Uint32 RenderStateNotationLoaderImpl::GetNumPendingWarmupPipelines()
+{
+    std::lock_guard<std::mutex> Lock{m_WarmupTasksMtx};
+    m_WarmupTasks.erase(std::remove_if(m_WarmupTasks.begin(), m_WarmupTasks.end(), [](const RefCntAutoPtr<IPipelineStateLoadTask>& pTask) { return pTask->IsComplete(); }),
+                        m_WarmupTasks.end());
+    return StaticCast<Uint32>(m_WarmupTasks.size());
+}
+
+void RenderStateNotationLoaderImpl::GetShaderResourceBinding(const ShaderResourceBindingInfo& Info, IShaderResourceBinding** ppSRB)
+{
+    DEV_CHECK_ERR(ppSRB != nullptr, "ppSRB must not be null");
+    DEV_CHECK_ERR(*ppSRB == nullptr, "*ppSRB is not null. Make sure you are not overwriting reference to an existing object as this may result in memory leaks.");
+
+    *ppSRB = m_SRBCache.Get(Info).Detach();
+}
+
+void RenderStateNotationLoaderImpl::GetShaderResourceBindings(const ShaderResourceBindingInfo* pInfos, Uint32 NumSRBs, IShaderResourceBinding** ppSRBs)
+{
+    DILIGENT_TRACE_ZONE("RSN::GetShaderResourceBindings");
+
+    m_SRBCache.Get(pInfos, NumSRBs, ppSRBs, m_pThreadPool);
+}
+
+Uint32 RenderStateNotationLoaderImpl::PurgeShaderResourceBindings()
+{
+    return m_SRBCache.Purge();
+}
+
 void CreateRenderStateNotationLoader(const RenderStateNotationLoaderCreateInfo& CreateInfo,
                                      IRenderStateNotationLoader**               ppLoader)
 {
@@ -28,14 +28,19 @@
 
 #include "RenderStateNotationParserImpl.hpp"
 
+#include <algorithm>
 #include <unordered_set>
 #include <functional>
 #include <array>
+#include <cstring>
+#include <type_traits>
 
 #include "DataBlobImpl.hpp"
 #include "FileWrapper.hpp"
 #include "DefaultRawMemoryAllocator.hpp"
 #include "GraphicsAccessories.hpp"
+#include "ThreadPool.hpp"
+#include "ToolsTrace.hpp"
 
 namespace Diligent
 {
@@ -66,15 +71,15 @@ void ParseRSN(const nlohmann::json& Json, const Type*& pObjects, TypeSize& NumEl
 
 void ParseRSN(const nlohmann::json& Json, PipelineStateNotation& Type, DynamicLinearAllocator& Allocator, const InlineStructureCallbacks& Callbacks)
 {
-    if (Json.contains("PSODesc"))
-        ParseRSN(Json["PSODesc"], Type.PSODesc, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "PSODesc"))
+        ParseRSN(*pValue, Type.PSODesc, Allocator);
 
-    if (Json.contains("Flags"))
-        DeserializeBitwiseEnum(Json["Flags"], Type.Flags, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "Flags"))
+        DeserializeBitwiseEnum(*pValue, Type.Flags, Allocator);
 
-    if (Json.contains("ppResourceSignatures"))
+    if (const auto* pSignatures = FindJsonKey(Json, "ppResourceSignatures"))
     {
-        auto const& Signatures = Json["ppResourceSignatures"];
+        auto const& Signatures = *pSignatures;
 
         if (!Signatures.is_array())
             throw nlohmann::json::type_error::create(JsonTypeError, std::string("type must be array, but is ") + Signatures.type_name(), Signatures);
@@ -94,13 +99,13 @@ void ParseRSN(const nlohmann::json& Json, GraphicsPipelineNotation& Type, Dynami
 
     ParseRSN(Json, static_cast<PipelineStateNotation&>(Type), Allocator, Callbacks);
 
-    if (Json.contains("GraphicsPipeline"))
+    if (const auto* pGraphicsPipeline = FindJsonKey(Json, "GraphicsPipeline"))
     {
-        auto& GraphicsPipeline = Json["GraphicsPipeline"];
+        auto& GraphicsPipeline = *pGraphicsPipeline;
         ParseRSN(GraphicsPipeline, Type.Desc, Allocator);
 
-        if (GraphicsPipeline.contains("pRenderPass"))
-            Callbacks.RenderPassCallback(GraphicsPipeline["pRenderPass"], &Type.pRenderPassName, Allocator);
+        if (const auto* pRenderPass = FindJsonKey(GraphicsPipeline, "pRenderPass"))
+            Callbacks.RenderPassCallback(*pRenderPass, &Type.pRenderPassName, Allocator);
 
         if (!GraphicsPipeline.contains("NumRenderTargets"))
         {
@@ -110,26 +115,26 @@ void ParseRSN(const nlohmann::json& Json, GraphicsPipelineNotation& Type, Dynami
         }
     }
 
-    if (Json.contains("pVS"))
-        Callbacks.ShaderCallback(Json["pVS"], SHADER_TYPE_VERTEX, &Type.pVSName, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "pVS"))
+        Callbacks.ShaderCallback(*pValue, SHADER_TYPE_VERTEX, &Type.pVSName, Allocator);
 
-    if (Json.contains("pPS"))
-        Callbacks.ShaderCallback(Json["pPS"], SHADER_TYPE_PIXEL, &Type.pPSName, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "pPS"))
+        Callbacks.ShaderCallback(*pValue, SHADER_TYPE_PIXEL, &Type.pPSName, Allocator);
 
-    if (Json.contains("pDS"))
-        Callbacks.ShaderCallback(Json["pDS"], SHADER_TYPE_DOMAIN, &Type.pDSName, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "pDS"))
+        Callbacks.ShaderCallback(*pValue, SHADER_TYPE_DOMAIN, &Type.pDSName, Allocator);
 
-    if (Json.contains("pHS"))
-        Callbacks.ShaderCallback(Json["pHS"], SHADER_TYPE_HULL, &Type.pHSName, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "pHS"))
+        Callbacks.ShaderCallback(*pValue, SHADER_TYPE_HULL, &Type.pHSName, Allocator);
 
-    if (Json.contains("pGS"))
-        Callbacks.ShaderCallback(Json["pGS"], SHADER_TYPE_GEOMETRY, &Type.pGSName, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "pGS"))
+        Callbacks.ShaderCallback(*pValue, SHADER_TYPE_GEOMETRY, &Type.pGSName, Allocator);
 
-    if (Json.contains("pAS"))
-        Callbacks.ShaderCallback(Json["pAS"], SHADER_TYPE_AMPLIFICATION, &Type.pASName, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "pAS"))
+        Callbacks.ShaderCallback(*pValue, SHADER_TYPE_AMPLIFICATION, &Type.pASName, Allocator);
 
-    if (Json.contains("pMS"))
-        Callbacks.ShaderCallback(Json["pMS"], SHADER_TYPE_MESH, &Type.pMSName, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "pMS"))
+        Callbacks.ShaderCallback(*pValue, SHADER_TYPE_MESH, &Type.pMSName, Allocator);
 }
 
 void ParseRSN(const nlohmann::json& Json, ComputePipelineNotation& Type, DynamicLinearAllocator& Allocator, const InlineStructureCallbacks& Callbacks)
@@ -165,11 +170,11 @@ void ParseRSN(const nlohmann::json& Json, RTTriangleHitShaderGroupNotation& Type
 
     ParseRSN(Json.at("Name"), Type.Name, Allocator);
 
-    if (Json.contains("pClosestHitShader"))
-        Callbacks.ShaderCallback(Json["pClosestHitShader"], SHADER_TYPE_RAY_CLOSEST_HIT, &Type.pClosestHitShaderName, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "pClosestHitShader"))
+        Callbacks.ShaderCallback(*pValue, SHADER_TYPE_RAY_CLOSEST_HIT, &Type.pClosestHitShaderName, Allocator);
 
-    if (Json.contains("pAnyHitShader"))
-        Callbacks.ShaderCallback(Json["pAnyHitShader"], SHADER_TYPE_RAY_ANY_HIT, &Type.pAnyHitShaderName, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "pAnyHitShader"))
+        Callbacks.ShaderCallback(*pValue, SHADER_TYPE_RAY_ANY_HIT, &Type.pAnyHitShaderName, Allocator);
 }
 
 void ParseRSN(const nlohmann::json& Json, RTProceduralHitShaderGroupNotation& Type, DynamicLinearAllocator& Allocator, const InlineStructureCallbacks& Callbacks)
@@ -178,14 +183,14 @@ void ParseRSN(const nlohmann::json& Json, RTProceduralHitShaderGroupNotation& Ty
 
     ParseRSN(Json.at("Name"), Type.Name, Allocator);
 
-    if (Json.contains("pIntersectionShader"))
-        Callbacks.ShaderCallback(Json["pIntersectionShader"], SHADER_TYPE_RAY_INTERSECTION, &Type.pIntersectionShaderName, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "pIntersectionShader"))
+        Callbacks.ShaderCallback(*pValue, SHADER_TYPE_RAY_INTERSECTION, &Type.pIntersectionShaderName, Allocator);
 
-    if (Json.contains("pClosestHitShader"))
-        Callbacks.ShaderCallback(Json["pClosestHitShader"], SHADER_TYPE_RAY_CLOSEST_HIT, &Type.pClosestHitShaderName, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "pClosestHitShader"))
+        Callbacks.ShaderCallback(*pValue, SHADER_TYPE_RAY_CLOSEST_HIT, &Type.pClosestHitShaderName, Allocator);
 
-    if (Json.contains("pAnyHitShader"))
-        Callbacks.ShaderCallback(Json["pAnyHitShader"], SHADER_TYPE_RAY_ANY_HIT, &Type.pAnyHitShaderName, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "pAnyHitShader"))
+        Callbacks.ShaderCallback(*pValue, SHADER_TYPE_RAY_ANY_HIT, &Type.pAnyHitShaderName, Allocator);
 }
 
 void ParseRSN(const nlohmann::json& Json, RayTracingPipelineNotation& Type, DynamicLinearAllocator& Allocator, const InlineStructureCallbacks& Callbacks)
@@ -194,26 +199,26 @@ void ParseRSN(const nlohmann::json& Json, RayTracingPipelineNotation& Type, Dyna
 
     ParseRSN(Json, static_cast<PipelineStateNotation&>(Type), Allocator, Callbacks);
 
-    if (Json.contains("RayTracingPipeline"))
-        ParseRSN(Json["RayTracingPipeline"], Type.RayTracingPipeline, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "RayTracingPipeline"))
+        ParseRSN(*pValue, Type.RayTracingPipeline, Allocator);
 
-    if (Json.contains("pGeneralShaders"))
-        ParseRSN(Json["pGeneralShaders"], Type.pGeneralShaders, Type.GeneralShaderCount, Allocator, Callbacks);
+    if (const auto* pValue = FindJsonKey(Json, "pGeneralShaders"))
+        ParseRSN(*pValue, Type.pGeneralShaders, Type.GeneralShaderCount, Allocator, Callbacks);
 
-    if (Json.contains("pTriangleHitShaders"))
-        ParseRSN(Json["pTriangleHitShaders"], Type.pTriangleHitShaders, Type.TriangleHitShaderCount, Allocator, Callbacks);
+    if (const auto* pValue = FindJsonKey(Json, "pTriangleHitShaders"))
+        ParseRSN(*pValue, Type.pTriangleHitShaders, Type.TriangleHitShaderCount, Allocator, Callbacks);
 
-    if (Json.contains("pProceduralHitShaders"))
-        ParseRSN(Json["pProceduralHitShaders"], Type.pProceduralHitShaders, Type.ProceduralHitShaderCount, Allocator, Callbacks);
+    if (const auto* pValue = FindJsonKey(Json, "pProceduralHitShaders"))
+        ParseRSN(*pValue, Type.pProceduralHitShaders, Type.ProceduralHitShaderCount, Allocator, Callbacks);
 
-    if (Json.contains("pShaderRecordName"))
-        ParseRSN(Json["pShaderRecordName"], Type.pShaderRecordName, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "pShaderRecordName"))
+        ParseRSN(*pValue, Type.pShaderRecordName, Allocator);
 
-    if (Json.contains("MaxAttributeSize"))
-        ParseRSN(Json["MaxAttributeSize"], Type.MaxAttributeSize, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "MaxAttributeSize"))
+        ParseRSN(*pValue, Type.MaxAttributeSize, Allocator);
 
-    if (Json.contains("MaxPayloadSize"))
-        ParseRSN(Json["MaxPayloadSize"], Type.MaxPayloadSize, Allocator);
+    if (const auto* pValue = FindJsonKey(Json, "MaxPayloadSize"))
+        ParseRSN(*pValue, Type.MaxPayloadSize, Allocator);
 }
 
 PIPELINE_TYPE GetPipelineType(const nlohmann::json& Json)
@@ -245,20 +250,72 @@ PIPELINE_TYPE GetPipelineType(const nlohmann::json& Json)
     return PIPELINE_TYPE_INVALID;
 }
 
+// Precompiled notation starts with this header followed by the CBOR encoding of a JSON object
+// with two arrays: "Includes" lists all files the notation was compiled from, and "Documents"
+// holds the contents of these files in the order in which they must be parsed, without imports.
+struct PrecompiledRSNHeader
+{
+    char   Magic[8];
+    Uint32 Version;
+    Uint32 Reserved;
+};
+
+constexpr char   PrecompiledRSNMagic[8] = {'D', 'R', 'S', 'N', 'B', 'I', 'N', '\0'};
+constexpr Uint32 PrecompiledRSNVersion  = 1;
+
+size_t ComputeFileHash(const IDataBlob* pFileData)
+{
+    const auto* pData = static_cast<const char*>(pFileData->GetConstDataPtr());
+    return std::hash<std::string>{}(std::string{pData, pData + pFileData->GetSize()});
+}
+
+// Macro values may be given as strings, numbers or booleans, e.g. "HIGH", 2 or true.
+std::string ParsePermutationValue(const nlohmann::json& Json)
+{
+    if (Json.is_string())
+        return Json.get<std::string>();
+    if (Json.is_boolean())
+        return Json.get<bool>() ? "1" : "0";
+    if (Json.is_number())
+        return Json.dump();
+    throw nlohmann::json::type_error::create(JsonTypeError, std::string("type must be string, number or boolean, but is ") + Json.type_name(), Json);
+}
+
+// Returns the name of the permutation, e.g. "Material-PS[NORMAL_MAP=1,QUALITY=HIGH]"
+std::string GetPermutationName(const Char* BaseName, const std::vector<std::string>& Macros, const std::unordered_map<std::string, std::string>& Values)
+{
+    std::string Name{BaseName};
+    Name += '[';
+    for (size_t i = 0; i < Macros.size(); ++i)
+    {
+        if (i > 0)
+            Name += ',';
+        Name += Macros[i];
+        Name += '=';
+        Name += Values.at(Macros[i]);
+    }
+    Name += ']';
+    return Name;
+}
+
 } // namespace
 
 void ParseRSNDeviceCreateInfo(const Char* Data, Uint32 Size, SerializationDeviceCreateInfo& Type, DynamicLinearAllocator& Allocator)
 {
-    nlohmann::json Json = nlohmann::json::parse(Data, Data + Size);
-    ParseRSN(Json, Type, Allocator);
+    // The device create info is a single structure, so it is read directly from the text
+    RSNJsonReader Reader{Data, Data + Size};
+    ReadRSN(Reader, Type, Allocator);
+    Reader.Finish();
 }
 
 RenderStateNotationParserImpl::RenderStateNotationParserImpl(IReferenceCounters*                        pRefCounters,
                                                              const RenderStateNotationParserCreateInfo& CreateInfo) :
     TBase{pRefCounters},
-    m_CI{CreateInfo}
+    m_CI{CreateInfo},
+    m_pThreadPool{CreateInfo.pThreadPool}
 {
-    m_pAllocator = std::make_unique<DynamicLinearAllocator>(DefaultRawMemoryAllocator::GetAllocator());
+    IMemoryAllocator& RawAllocator = CreateInfo.pAllocator != nullptr ? *CreateInfo.pAllocator : DefaultRawMemoryAllocator::GetAllocator();
+    m_pAllocator = std::make_unique<DynamicLinearAllocator>(RawAllocator);
 }
 
 Bool RenderStateNotationParserImpl::ParseFile(const Char*                      FilePath,
@@ -266,12 +323,16 @@ Bool RenderStateNotationParserImpl::ParseFile(const Char*                      F
                                               IShaderSourceInputStreamFactory* pReloadFactory)
 
 {
+    DILIGENT_TRACE_ZONE("RSN::ParseFile");
+
     if (FilePath == nullptr || FilePath[0] == '\0')
     {
         DEV_ERROR("FilePath must not be null or empty");
         return false;
     }
 
+    m_CurrentReloadInfoIndex = m_ReloadInfo.size();
+
     const auto res = ParseFileInternal(FilePath, pStreamFactory);
     if (m_CI.EnableReload && res)
     {
@@ -293,16 +354,42 @@ Bool RenderStateNotationParserImpl::ParseFileInternal(const Char*
         // TODO: use absolute path
         if (m_Includes.insert(FilePath).second)
         {
-            RefCntAutoPtr<IFileStream> pFileStream;
-            pStreamFactory->CreateInputStream(FilePath, &pFileStream);
+            std::unique_ptr<nlohmann::json> pJson;
+            RefCntAutoPtr<DataBlobImpl>     pFileData;
+            size_t                          FileHash = 0;
 
-            if (!pFileStream)
-                LOG_ERROR_AND_THROW("Failed to open file: '", FilePath, "'.");
+            auto PrefetchedIt = m_PrefetchedImports.find(FilePath);
+            if (PrefetchedIt != m_PrefetchedImports.end() && PrefetchedIt->second.pJson)
+            {
+                pJson    = std::move(PrefetchedIt->second.pJson);
+                FileHash = PrefetchedIt->second.Hash;
+                m_PrefetchedImports.erase(PrefetchedIt);
+            }
+            else
+            {
+                // The file has not been prefetched, or prefetching failed: read it here to report errors in order
+                RefCntAutoPtr<IFileStream> pFileStream;
+                pStreamFactory->CreateInputStream(FilePath, &pFileStream);
 
-            auto pFileData = DataBlobImpl::Create();
-            pFileStream->ReadBlob(pFileData);
+                if (!pFileStream)
+                    LOG_ERROR_AND_THROW("Failed to open file: '", FilePath, "'.");
+
+                pFileData = DataBlobImpl::Create();
+                pFileStream->ReadBlob(pFileData);
+                FileHash = ComputeFileHash(pFileData);
+            }
+
+            // Imports restore the flag of the file that imports them
+            const bool IsParentFileModified = m_IsCurrentFileModified;
+            m_IsCurrentFileModified         = TrackFile(FilePath, FileHash);
 
-            if (!ParseStringInternal(static_cast<const char*>(pFileData->GetConstDataPtr()), StaticCast<Uint32>(pFileData->GetSize()), pStreamFactory))
+            const auto Parsed = pJson ?
+                ParseJSONInternal(*pJson, pStreamFactory) :
+                ParseStringInternal(static_cast<const char*>(pFileData->GetConstDataPtr()), StaticCast<Uint32>(pFileData->GetSize()), pStreamFactory);
+
+            m_IsCurrentFileModified = IsParentFileModified;
+
+            if (!Parsed)
                 LOG_ERROR_AND_THROW("Failed to parse file: '", FilePath, "'.");
         }
 
@@ -319,12 +406,16 @@ Bool RenderStateNotationParserImpl::ParseString(const Char*
                                                 IShaderSourceInputStreamFactory* pStreamFactory,
                                                 IShaderSourceInputStreamFactory* pReloadFactory)
 {
+    DILIGENT_TRACE_ZONE("RSN::ParseString");
+
     if (Source == nullptr || Source[0] == '\0')
     {
         DEV_ERROR("Source must not be null or empty");
         return false;
     }
 
+    m_CurrentReloadInfoIndex = m_ReloadInfo.size();
+
     const auto res = ParseStringInternal(Source, Length, pStreamFactory);
     if (m_CI.EnableReload && res)
     {
@@ -336,257 +427,672 @@ Bool RenderStateNotationParserImpl::ParseString(const Char*
     return res;
 }
 
-Bool RenderStateNotationParserImpl::ParseStringInternal(const Char*                      Source,
-                                                        Uint32                           Length,
-                                                        IShaderSourceInputStreamFactory* pStreamFactory)
+void RenderStateNotationParserImpl::PrefetchImports(const std::vector<std::string>& Imports, IShaderSourceInputStreamFactory* pStreamFactory)
 {
-    VERIFY_EXPR(Source != nullptr);
+    VERIFY_EXPR(m_pThreadPool && pStreamFactory != nullptr);
+
+    // The import tree is read and parsed level by level: all files of one level are loaded concurrently,
+    // and their imports form the next level. The results are consumed by ParseFileInternal in the usual
+    // depth-first order, so the parsed states do not depend on the order in which the tasks finish.
+    std::unordered_set<std::string> Visited = m_Includes;
+    std::vector<std::string>        Level;
+    for (const auto& Path : Imports)
+    {
+        if (Visited.insert(Path).second)
+            Level.push_back(Path);
+    }
 
-    auto ParseJSON = [this](const Char* Source, Uint32 Length, IShaderSourceInputStreamFactory* pStreamFactory) -> bool //
+    while (!Level.empty())
     {
-        try
+        std::vector<PrefetchedImport> Files(Level.size());
+
+        std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+        Tasks.reserve(Level.size());
+        for (size_t i = 0; i < Level.size(); ++i)
         {
-            String StrSource;
-            if (Length != 0)
-                StrSource.assign(Source, Length);
-            else
-                StrSource.assign(Source);
+            Tasks.emplace_back(EnqueueAsyncWork(m_pThreadPool, [&, i](Uint32) {
+                try
+                {
+                    RefCntAutoPtr<IFileStream> pFileStream;
+                    pStreamFactory->CreateInputStream(Level[i].c_str(), &pFileStream);
+                    if (!pFileStream)
+                        return;
+
+                    auto pFileData = DataBlobImpl::Create();
+                    pFileStream->ReadBlob(pFileData);
+
+                    const auto* pSource = static_cast<const char*>(pFileData->GetConstDataPtr());
+                    // Precompiled files are left to ParseFileInternal
+                    if (pFileData->GetSize() >= sizeof(PrecompiledRSNMagic) && memcmp(pSource, PrecompiledRSNMagic, sizeof(PrecompiledRSNMagic)) == 0)
+                        return;
 
-            nlohmann::json Json = nlohmann::json::parse(StrSource);
-            NLOHMANN_JSON_VALIDATE_KEYS(Json, {"Imports", "Defaults", "Shaders", "RenderPasses", "ResourceSignatures", "Pipelines", "Ignore"});
+                    Files[i].pJson = std::make_unique<nlohmann::json>(nlohmann::json::parse(pSource, pSource + pFileData->GetSize()));
+                    Files[i].Hash  = ComputeFileHash(pFileData);
+                }
+                catch (...)
+                {
+                    // Errors are reported when the file is parsed by ParseFileInternal
+                    Files[i].pJson.reset();
+                }
+            }));
+        }
+        for (auto& pTask : Tasks)
+            pTask->WaitForCompletion();
+
+        std::vector<std::string> NextLevel;
+        for (size_t i = 0; i < Level.size(); ++i)
+        {
+            if (!Files[i].pJson)
+                continue;
 
-            for (auto const& Import : Json["Imports"])
+            const auto& Json      = *Files[i].pJson;
+            auto        ImportsIt = Json.find("Imports");
+            if (ImportsIt != Json.end() && ImportsIt->is_array())
             {
-                VERIFY_EXPR(pStreamFactory != nullptr);
-                auto Path = Import.get<std::string>();
+                for (const auto& Import : *ImportsIt)
+                {
+                    if (Import.is_string() && Visited.insert(Import.get<std::string>()).second)
+                        NextLevel.emplace_back(Import.get<std::string>());
+                }
+            }
 
-                if (!ParseFileInternal(Path.c_str(), pStreamFactory))
-                    LOG_ERROR_AND_THROW("Failed to import file: '", Path, "'.");
+            m_PrefetchedImports.emplace(std::move(Level[i]), std::move(Files[i]));
+        }
+        Level.swap(NextLevel);
+    }
+}
+
+Bool RenderStateNotationParserImpl::ParseJSONInternal(nlohmann::json& Json, IShaderSourceInputStreamFactory* pStreamFactory)
+{
+    DILIGENT_TRACE_ZONE("RSN::ParseJSON");
+
+    try
+    {
+        NLOHMANN_JSON_VALIDATE_KEYS(Json, {"Imports", "Defaults", "Shaders", "RenderPasses", "ResourceSignatures", "Pipelines", "Ignore"});
+
+        std::vector<std::string> Imports;
+        for (auto const& Import : Json["Imports"])
+            Imports.emplace_back(Import.get<std::string>());
+
+        if (!Imports.empty())
+        {
+            VERIFY_EXPR(pStreamFactory != nullptr);
+
+            // Only the outermost file prefetches the import tree, nested imports use the prefetched data
+            const bool Prefetch = m_pThreadPool && !m_IsPrefetchingImports;
+            if (Prefetch)
+            {
+                m_IsPrefetchingImports = true;
+                PrefetchImports(Imports, pStreamFactory);
             }
 
-            if (Json.contains("Ignore"))
+            const std::string* pFailedImport = nullptr;
+            for (const auto& Path : Imports)
             {
-                const auto& Ignored = Json["Ignore"];
-                NLOHMANN_JSON_VALIDATE_KEYS(Ignored, {"Signatures"});
-                for (auto const& IgnoredSign : Ignored["Signatures"])
+                if (!ParseFileInternal(Path.c_str(), pStreamFactory))
                 {
-                    auto SignName = IgnoredSign.get<std::string>();
-                    m_IgnoredSignatures.emplace(std::move(SignName));
+                    pFailedImport = &Path;
+                    break;
                 }
             }
 
-            ShaderCreateInfo              DefaultShader{};
-            PipelineStateNotation         DefaultPipeline{};
-            RenderPassDesc                DefaultRenderPass{};
-            PipelineResourceSignatureDesc DefaultResourceSignature{};
+            if (Prefetch)
+            {
+                m_PrefetchedImports.clear();
+                m_IsPrefetchingImports = false;
+            }
+
+            if (pFailedImport != nullptr)
+                LOG_ERROR_AND_THROW("Failed to import file: '", *pFailedImport, "'.");
+        }
 
-            InlineStructureCallbacks Callbacks{};
-            Callbacks.ShaderCallback = [this, &DefaultShader](const nlohmann::json& Json, SHADER_TYPE ShaderType, const char** Name, DynamicLinearAllocator& Allocator) //
+        if (Json.contains("Ignore"))
+        {
+            const auto& Ignored = Json["Ignore"];
+            NLOHMANN_JSON_VALIDATE_KEYS(Ignored, {"Signatures"});
+            for (auto const& IgnoredSign : Ignored["Signatures"])
             {
-                if (Json.is_string())
+                auto SignName = IgnoredSign.get<std::string>();
+                m_IgnoredSignatures.emplace(std::move(SignName));
+            }
+        }
+
+        ShaderCreateInfo              DefaultShader{};
+        PipelineStateNotation         DefaultPipeline{};
+        RenderPassDesc                DefaultRenderPass{};
+        PipelineResourceSignatureDesc DefaultResourceSignature{};
+
+        // Permuted shaders referenced by the pipeline that is being parsed. While the permutations of
+        // the pipeline are parsed, the references are resolved with the values in pPipelinePermutation.
+        std::vector<const ShaderPermutationInfo*> ReferencedPermutations;
+        const PermutationValues*                  pPipelinePermutation = nullptr;
+
+        auto ResolveShaderPermutation = [&](const char** Name) //
+        {
+            auto Iter = m_ShaderPermutations.find(*Name);
+            if (Iter == m_ShaderPermutations.end())
+                return;
+
+            if (pPipelinePermutation != nullptr)
+                *Name = GetShaderPermutation(Iter->second, *pPipelinePermutation);
+            else if (std::find(ReferencedPermutations.begin(), ReferencedPermutations.end(), &Iter->second) == ReferencedPermutations.end())
+                ReferencedPermutations.push_back(&Iter->second);
+        };
+
+        InlineStructureCallbacks Callbacks{};
+        Callbacks.ShaderCallback = [&](const nlohmann::json& Json, SHADER_TYPE ShaderType, const char** Name, DynamicLinearAllocator& Allocator) //
+        {
+            if (Json.is_string())
+            {
+                VERIFY_EXPR(Name != nullptr);
+                ParseRSN(Json, *Name, Allocator);
+                ResolveShaderPermutation(Name);
+            }
+            else if (Json.is_object())
+            {
+                ShaderCreateInfo ResourceDesc{DefaultShader};
+                const bool       HasPermutations = Json.contains("Permutations");
+                if (HasPermutations)
                 {
-                    VERIFY_EXPR(Name != nullptr);
-                    ParseRSN(Json, *Name, Allocator);
+                    auto ShaderJson = Json;
+                    ShaderJson.erase("Permutations");
+                    ParseRSN(ShaderJson, ResourceDesc, Allocator);
                 }
-                else if (Json.is_object())
+                else
                 {
-                    ShaderCreateInfo ResourceDesc{DefaultShader};
                     ParseRSN(Json, ResourceDesc, Allocator);
-                    VERIFY_EXPR(ResourceDesc.Desc.Name != nullptr);
+                }
+                VERIFY_EXPR(ResourceDesc.Desc.Name != nullptr);
 
-                    if (ShaderType != SHADER_TYPE_UNKNOWN && ResourceDesc.Desc.ShaderType != SHADER_TYPE_UNKNOWN && ResourceDesc.Desc.ShaderType != ShaderType)
-                        throw nlohmann::json::other_error::create(JsonInvalidEnum, std::string("shader type must be ") + GetShaderTypeLiteralName(ShaderType) + std::string(", but is ") + Json.at("Desc").at("ShaderType").get<std::string>(), Json);
+                if (ShaderType != SHADER_TYPE_UNKNOWN && ResourceDesc.Desc.ShaderType != SHADER_TYPE_UNKNOWN && ResourceDesc.Desc.ShaderType != ShaderType)
+                    throw nlohmann::json::other_error::create(JsonInvalidEnum, std::string("shader type must be ") + GetShaderTypeLiteralName(ShaderType) + std::string(", but is ") + Json.at("Desc").at("ShaderType").get<std::string>(), Json);
 
-                    if (ShaderType != SHADER_TYPE_UNKNOWN)
-                        ResourceDesc.Desc.ShaderType = ShaderType;
+                if (ShaderType != SHADER_TYPE_UNKNOWN)
+                    ResourceDesc.Desc.ShaderType = ShaderType;
 
-                    auto const Iter = m_ShaderNames.emplace(HashMapStringKey{ResourceDesc.Desc.Name, false}, StaticCast<Uint32>(m_Shaders.size()));
-                    if (Iter.second)
-                    {
-                        m_Shaders.push_back(ResourceDesc);
-                    }
-                    else
+                if (HasPermutations)
+                {
+                    AddShaderPermutations(Json, ResourceDesc);
+                    if (Name != nullptr)
                     {
-                        auto CompareMacros = [](const ShaderMacro* pLHS, const ShaderMacro* pRHS) //
-                        {
-                            if ((pLHS == nullptr) != (pRHS == nullptr))
-                                return false;
-                            if (pLHS == pRHS)
-                                return true;
-
-                            VERIFY_EXPR(pLHS != nullptr && pRHS != nullptr);
-                            while (!(*pLHS == ShaderMacro{} || *pRHS == ShaderMacro{}) && *pLHS == *pRHS)
-                            {
-                                ++pLHS;
-                                ++pRHS;
-                            }
-                            return *pLHS == ShaderMacro{} && *pRHS == ShaderMacro{};
-                        };
-
-                        auto CompareShaderCI = [&CompareMacros](const ShaderCreateInfo& LHS, const ShaderCreateInfo& RHS) //
-                        {
-                            return LHS.Desc == RHS.Desc &&
-                                LHS.SourceLanguage == RHS.SourceLanguage &&
-                                LHS.HLSLVersion == RHS.HLSLVersion &&
-                                LHS.GLSLVersion == RHS.GLSLVersion &&
-                                LHS.GLESSLVersion == RHS.GLESSLVersion &&
-                                LHS.CompileFlags == RHS.CompileFlags &&
-                                LHS.ShaderCompiler == RHS.ShaderCompiler &&
-                                SafeStrEqual(LHS.EntryPoint, RHS.EntryPoint) &&
-                                SafeStrEqual(LHS.FilePath, RHS.FilePath) &&
-                                CompareMacros(LHS.Macros, RHS.Macros);
-                        };
-
-                        if (!CompareShaderCI(m_Shaders[Iter.first->second], ResourceDesc))
-                            LOG_ERROR_AND_THROW("Redefinition of shader '", ResourceDesc.Desc.Name, "'.");
+                        *Name = ResourceDesc.Desc.Name;
+                        ResolveShaderPermutation(Name);
                     }
+                    return;
+                }
 
-                    if (Name != nullptr)
-                        *Name = ResourceDesc.Desc.Name;
+                if (m_ShaderPermutations.find(ResourceDesc.Desc.Name) != m_ShaderPermutations.end())
+                    LOG_ERROR_AND_THROW("Redefinition of shader '", ResourceDesc.Desc.Name, "'.");
+
+                auto const Iter = m_ShaderNames.emplace(HashMapStringKey{ResourceDesc.Desc.Name, false}, StaticCast<Uint32>(m_Shaders.size()));
+                if (Iter.second)
+                {
+                    AddNameHash(m_ShaderHashes, ComputeNotationNameHash(ResourceDesc.Desc.Name), Iter.first->second, "shader", ResourceDesc.Desc.Name);
+                    m_Shaders.push_back(ResourceDesc);
+                    if (m_IsCurrentFileModified)
+                        m_ModifiedShaders.emplace(ResourceDesc.Desc.Name);
                 }
                 else
                 {
-                    throw nlohmann::json::type_error::create(JsonTypeError, std::string("type must be object or string, but is ") + Json.type_name(), Json);
+                    auto CompareMacros = [](const ShaderMacro* pLHS, const ShaderMacro* pRHS) //
+                    {
+                        if ((pLHS == nullptr) != (pRHS == nullptr))
+                            return false;
+                        if (pLHS == pRHS)
+                            return true;
+
+                        VERIFY_EXPR(pLHS != nullptr && pRHS != nullptr);
+                        while (!(*pLHS == ShaderMacro{} || *pRHS == ShaderMacro{}) && *pLHS == *pRHS)
+                        {
+                            ++pLHS;
+                            ++pRHS;
+                        }
+                        return *pLHS == ShaderMacro{} && *pRHS == ShaderMacro{};
+                    };
+
+                    auto CompareShaderCI = [&CompareMacros](const ShaderCreateInfo& LHS, const ShaderCreateInfo& RHS) //
+                    {
+                        return LHS.Desc == RHS.Desc &&
+                            LHS.SourceLanguage == RHS.SourceLanguage &&
+                            LHS.HLSLVersion == RHS.HLSLVersion &&
+                            LHS.GLSLVersion == RHS.GLSLVersion &&
+                            LHS.GLESSLVersion == RHS.GLESSLVersion &&
+                            LHS.CompileFlags == RHS.CompileFlags &&
+                            LHS.ShaderCompiler == RHS.ShaderCompiler &&
+                            SafeStrEqual(LHS.EntryPoint, RHS.EntryPoint) &&
+                            SafeStrEqual(LHS.FilePath, RHS.FilePath) &&
+                            CompareMacros(LHS.Macros, RHS.Macros);
+                    };
+
+                    if (!CompareShaderCI(m_Shaders[Iter.first->second], ResourceDesc))
+                        LOG_ERROR_AND_THROW("Redefinition of shader '", ResourceDesc.Desc.Name, "'.");
                 }
-            };
 
-            Callbacks.RenderPassCallback = [this, &DefaultRenderPass](const nlohmann::json& Json, const char** Name, DynamicLinearAllocator& Allocator) //
+                if (Name != nullptr)
+                    *Name = ResourceDesc.Desc.Name;
+            }
+            else
             {
-                if (Json.is_string())
-                {
-                    VERIFY_EXPR(Name != nullptr);
-                    ParseRSN(Json, *Name, Allocator);
-                }
-                else if (Json.is_object())
-                {
-                    RenderPassDesc ResourceDesc{DefaultRenderPass};
-                    ParseRSN(Json, ResourceDesc, Allocator);
-                    VERIFY_EXPR(ResourceDesc.Name != nullptr);
+                throw nlohmann::json::type_error::create(JsonTypeError, std::string("type must be object or string, but is ") + Json.type_name(), Json);
+            }
+        };
 
-                    auto const Iter = m_RenderPassNames.emplace(HashMapStringKey{ResourceDesc.Name, false}, StaticCast<Uint32>(m_RenderPasses.size()));
-                    if (Iter.second)
-                        m_RenderPasses.push_back(ResourceDesc);
-                    else if (!(m_RenderPasses[Iter.first->second] == ResourceDesc))
-                        LOG_ERROR_AND_THROW("Redefinition of render pass '", ResourceDesc.Name, "'.");
+        Callbacks.RenderPassCallback = [this, &DefaultRenderPass](const nlohmann::json& Json, const char** Name, DynamicLinearAllocator& Allocator) //
+        {
+            if (Json.is_string())
+            {
+                VERIFY_EXPR(Name != nullptr);
+                ParseRSN(Json, *Name, Allocator);
+            }
+            else if (Json.is_object())
+            {
+                RenderPassDesc ResourceDesc{DefaultRenderPass};
+                ParseRSN(Json, ResourceDesc, Allocator);
+                VERIFY_EXPR(ResourceDesc.Name != nullptr);
 
-                    if (Name != nullptr)
-                        *Name = ResourceDesc.Name;
-                }
-                else
+                auto const Iter = m_RenderPassNames.emplace(HashMapStringKey{ResourceDesc.Name, false}, StaticCast<Uint32>(m_RenderPasses.size()));
+                if (Iter.second)
                 {
-                    throw nlohmann::json::type_error::create(JsonTypeError, std::string("type must be object or string, but is ") + Json.type_name(), Json);
+                    AddNameHash(m_RenderPassHashes, ComputeNotationNameHash(ResourceDesc.Name), Iter.first->second, "render pass", ResourceDesc.Name);
+                    m_RenderPasses.push_back(ResourceDesc);
+                    if (m_IsCurrentFileModified)
+                        m_ModifiedRenderPasses.emplace(ResourceDesc.Name);
                 }
-            };
+                else if (!(m_RenderPasses[Iter.first->second] == ResourceDesc))
+                    LOG_ERROR_AND_THROW("Redefinition of render pass '", ResourceDesc.Name, "'.");
 
-            Callbacks.ResourceSignatureCallback = [this, &DefaultResourceSignature](const nlohmann::json& Json, const char** Name, DynamicLinearAllocator& Allocator) //
+                if (Name != nullptr)
+                    *Name = ResourceDesc.Name;
+            }
+            else
             {
-                if (Json.is_string())
-                {
-                    VERIFY_EXPR(Name != nullptr);
-                    ParseRSN(Json, *Name, Allocator);
-                }
-                else if (Json.is_object())
-                {
-                    PipelineResourceSignatureDesc ResourceDesc{DefaultResourceSignature};
-                    ParseRSN(Json, ResourceDesc, Allocator);
-                    VERIFY_EXPR(ResourceDesc.Name != nullptr);
+                throw nlohmann::json::type_error::create(JsonTypeError, std::string("type must be object or string, but is ") + Json.type_name(), Json);
+            }
+        };
 
-                    auto const Iter = m_ResourceSignatureNames.emplace(HashMapStringKey{ResourceDesc.Name, false}, StaticCast<Uint32>(m_ResourceSignatures.size()));
-                    if (Iter.second)
-                        m_ResourceSignatures.push_back(ResourceDesc);
-                    else if (!(m_ResourceSignatures[Iter.first->second] == ResourceDesc))
-                        LOG_ERROR_AND_THROW("Redefinition of resource signature '", ResourceDesc.Name, "'.");
+        Callbacks.ResourceSignatureCallback = [this, &DefaultResourceSignature](const nlohmann::json& Json, const char** Name, DynamicLinearAllocator& Allocator) //
+        {
+            if (Json.is_string())
+            {
+                VERIFY_EXPR(Name != nullptr);
+                ParseRSN(Json, *Name, Allocator);
+            }
+            else if (Json.is_object())
+            {
+                PipelineResourceSignatureDesc ResourceDesc{DefaultResourceSignature};
+                ParseRSN(Json, ResourceDesc, Allocator);
+                VERIFY_EXPR(ResourceDesc.Name != nullptr);
 
-                    if (Name != nullptr)
-                        *Name = ResourceDesc.Name;
-                }
-                else
+                auto const Iter = m_ResourceSignatureNames.emplace(HashMapStringKey{ResourceDesc.Name, false}, StaticCast<Uint32>(m_ResourceSignatures.size()));
+                if (Iter.second)
                 {
-                    throw nlohmann::json::type_error::create(JsonTypeError, std::string("type must be object or string, but is ") + Json.type_name(), Json);
+                    AddNameHash(m_ResourceSignatureHashes, ComputeNotationNameHash(ResourceDesc.Name), Iter.first->second, "resource signature", ResourceDesc.Name);
+                    m_ResourceSignatures.push_back(ResourceDesc);
+                    if (m_IsCurrentFileModified)
+                        m_ModifiedResourceSignatures.emplace(ResourceDesc.Name);
                 }
-            };
+                else if (!(m_ResourceSignatures[Iter.first->second] == ResourceDesc))
+                    LOG_ERROR_AND_THROW("Redefinition of resource signature '", ResourceDesc.Name, "'.");
 
-            if (Json.contains("Defaults"))
+                if (Name != nullptr)
+                    *Name = ResourceDesc.Name;
+            }
+            else
             {
-                auto const& Default = Json["Defaults"];
+                throw nlohmann::json::type_error::create(JsonTypeError, std::string("type must be object or string, but is ") + Json.type_name(), Json);
+            }
+        };
 
-                NLOHMANN_JSON_VALIDATE_KEYS(Default, {"Shader", "RenderPass", "ResourceSignature", "Pipeline"});
+        if (Json.contains("Defaults"))
+        {
+            auto const& Default = Json["Defaults"];
 
-                if (Default.contains("Shader"))
-                    ParseRSN(Default["Shader"], DefaultShader, *m_pAllocator);
+            NLOHMANN_JSON_VALIDATE_KEYS(Default, {"Shader", "RenderPass", "ResourceSignature", "Pipeline"});
 
-                if (Default.contains("RenderPass"))
-                    ParseRSN(Default["RenderPass"], DefaultRenderPass, *m_pAllocator);
+            if (Default.contains("Shader"))
+                ParseRSN(Default["Shader"], DefaultShader, *m_pAllocator);
 
-                if (Default.contains("ResourceSignature"))
-                    ParseRSN(Default["ResourceSignature"], DefaultResourceSignature, *m_pAllocator);
+            if (Default.contains("RenderPass"))
+                ParseRSN(Default["RenderPass"], DefaultRenderPass, *m_pAllocator);
 
-                if (Default.contains("Pipeline"))
-                    ParseRSN(Default["Pipeline"], DefaultPipeline, *m_pAllocator, Callbacks);
-            }
+            if (Default.contains("ResourceSignature"))
+                ParseRSN(Default["ResourceSignature"], DefaultResourceSignature, *m_pAllocator);
+
+            if (Default.contains("Pipeline"))
+                ParseRSN(Default["Pipeline"], DefaultPipeline, *m_pAllocator, Callbacks);
+        }
 
-            for (auto const& Shader : Json["Shaders"])
-                Callbacks.ShaderCallback(Shader, SHADER_TYPE_UNKNOWN, nullptr, *m_pAllocator);
+        // The strings are copied to the allocator, so every element is released as soon as it has been
+        // processed. This way the JSON document and the parsed states don't occupy memory at the same time.
+        for (auto& Shader : Json["Shaders"])
+        {
+            Callbacks.ShaderCallback(Shader, SHADER_TYPE_UNKNOWN, nullptr, *m_pAllocator);
+            Shader = nullptr;
+        }
 
-            for (auto const& RenderPass : Json["RenderPasses"])
-                Callbacks.RenderPassCallback(RenderPass, nullptr, *m_pAllocator);
+        for (auto& RenderPass : Json["RenderPasses"])
+        {
+            Callbacks.RenderPassCallback(RenderPass, nullptr, *m_pAllocator);
+            RenderPass = nullptr;
+        }
 
-            for (auto const& Signature : Json["ResourceSignatures"])
-                Callbacks.ResourceSignatureCallback(Signature, nullptr, *m_pAllocator);
+        for (auto& Signature : Json["ResourceSignatures"])
+        {
+            Callbacks.ResourceSignatureCallback(Signature, nullptr, *m_pAllocator);
+            Signature = nullptr;
+        }
 
-            for (auto const& Pipeline : Json["Pipelines"])
+        auto AddPipelineNotation = [&](PIPELINE_TYPE PipelineType, const PipelineStateNotation& PSONotation) //
+        {
+            if (m_PipelineStateNames.emplace(std::make_pair(HashMapStringKey{PSONotation.PSODesc.Name, false}, PipelineType), StaticCast<Uint32>(m_PipelineStates.size())).second)
             {
-                auto AddPipelineState = [&](PIPELINE_TYPE PipelineType, auto& PSONotation) //
+                AddNameHash(m_PipelineStateHashes, std::make_pair(ComputeNotationNameHash(PSONotation.PSODesc.Name), PipelineType), StaticCast<Uint32>(m_PipelineStates.size()), "pipeline", PSONotation.PSODesc.Name);
+                m_PipelineStates.emplace_back(PSONotation);
+                if (m_IsCurrentFileModified)
+                    m_ModifiedPipelineStates.emplace(PSONotation.PSODesc.Name);
+            }
+            else
+                LOG_ERROR_AND_THROW("Redefinition of pipeline '", PSONotation.PSODesc.Name, "'.");
+        };
+
+        for (auto& Pipeline : Json["Pipelines"])
+        {
+            auto AddPipelineState = [&](PIPELINE_TYPE PipelineType, auto* pTypeTag) //
+            {
+                using NotationType = std::remove_pointer_t<decltype(pTypeTag)>;
+
+                auto ParsePipelineState = [&]() -> NotationType& //
                 {
+                    auto& PSONotation = *m_pAllocator->Construct<NotationType>();
+
                     static_cast<PipelineStateNotation&>(PSONotation) = DefaultPipeline;
                     PSONotation.PSODesc.PipelineType                 = PipelineType;
                     ParseRSN(Pipeline, PSONotation, *m_pAllocator, Callbacks);
                     VERIFY_EXPR(PSONotation.PSODesc.Name != nullptr);
-
-                    if (m_PipelineStateNames.emplace(std::make_pair(HashMapStringKey{PSONotation.PSODesc.Name, false}, PipelineType), StaticCast<Uint32>(m_PipelineStates.size())).second)
-                        m_PipelineStates.emplace_back(PSONotation);
-                    else
-                        LOG_ERROR_AND_THROW("Redefinition of pipeline '", PSONotation.PSODesc.Name, "'.");
+                    return PSONotation;
                 };
 
-                static_assert(PIPELINE_TYPE_LAST == 4, "Please handle the new pipeline type below.");
-                const auto PipelineType = GetPipelineType(Pipeline);
-                switch (PipelineType)
+                ReferencedPermutations.clear();
+                auto& PSONotation = ParsePipelineState();
+                if (ReferencedPermutations.empty())
                 {
-                    case PIPELINE_TYPE_GRAPHICS:
-                    case PIPELINE_TYPE_MESH:
-                        AddPipelineState(PipelineType, *m_pAllocator->Construct<GraphicsPipelineNotation>());
-                        break;
+                    AddPipelineNotation(PipelineType, PSONotation);
+                    return;
+                }
 
-                    case PIPELINE_TYPE_COMPUTE:
-                        AddPipelineState(PipelineType, *m_pAllocator->Construct<ComputePipelineNotation>());
-                        break;
+                // The pipeline is created for every combination of the macro values of the permuted
+                // shaders it references. Axes with the same macro name are shared between the shaders.
+                std::vector<std::string>                     Macros;
+                std::vector<const std::vector<std::string>*> MacroValues;
+                for (const auto* pInfo : ReferencedPermutations)
+                {
+                    for (const auto& Axis : pInfo->Axes)
+                    {
+                        const auto MacroIt = std::find(Macros.begin(), Macros.end(), Axis.first);
+                        if (MacroIt == Macros.end())
+                        {
+                            Macros.push_back(Axis.first);
+                            MacroValues.push_back(&Axis.second);
+                        }
+                        else if (*MacroValues[MacroIt - Macros.begin()] != Axis.second)
+                        {
+                            LOG_ERROR_AND_THROW("Permutation macro '", Axis.first, "' has different values in the shaders of pipeline '", PSONotation.PSODesc.Name, "'.");
+                        }
+                    }
+                }
 
-                    case PIPELINE_TYPE_RAY_TRACING:
-                        AddPipelineState(PipelineType, *m_pAllocator->Construct<RayTracingPipelineNotation>());
-                        break;
+                const std::string   BaseName{PSONotation.PSODesc.Name};
+                std::vector<size_t> ValueIndices(Macros.size(), 0);
+                PermutationValues   Values;
+                for (;;)
+                {
+                    for (size_t i = 0; i < Macros.size(); ++i)
+                        Values[Macros[i]] = (*MacroValues[i])[ValueIndices[i]];
 
-                    case PIPELINE_TYPE_TILE:
-                        AddPipelineState(PipelineType, *m_pAllocator->Construct<TilePipelineNotation>());
-                        break;
-                    case PIPELINE_TYPE_INVALID:
-                        LOG_ERROR_AND_THROW("Pipeline type isn't set for '", Json["PSODesc"]["Name"].get<std::string>(), "'.");
+                    bool IsExcluded = false;
+                    for (const auto* pInfo : ReferencedPermutations)
+                        IsExcluded = IsExcluded || pInfo->IsExcluded(Values);
+
+                    if (!IsExcluded)
+                    {
+                        pPipelinePermutation = &Values;
+                        auto& PermutationNotation = ParsePipelineState();
+                        pPipelinePermutation = nullptr;
+
+                        PermutationNotation.PSODesc.Name = m_pAllocator->CopyString(GetPermutationName(BaseName.c_str(), Macros, Values).c_str());
+                        AddPipelineNotation(PipelineType, PermutationNotation);
+                    }
+
+                    size_t Axis = 0;
+                    for (; Axis < Macros.size(); ++Axis)
+                    {
+                        if (++ValueIndices[Axis] < MacroValues[Axis]->size())
+                            break;
+                        ValueIndices[Axis] = 0;
+                    }
+                    if (Axis == Macros.size())
                         break;
-                    default:
-                        UNEXPECTED("Unexpected pipeline type.");
                 }
+            };
+
+            static_assert(PIPELINE_TYPE_LAST == 4, "Please handle the new pipeline type below.");
+            const auto PipelineType = GetPipelineType(Pipeline);
+            switch (PipelineType)
+            {
+                case PIPELINE_TYPE_GRAPHICS:
+                case PIPELINE_TYPE_MESH:
+                    AddPipelineState(PipelineType, static_cast<GraphicsPipelineNotation*>(nullptr));
+                    break;
+
+                case PIPELINE_TYPE_COMPUTE:
+                    AddPipelineState(PipelineType, static_cast<ComputePipelineNotation*>(nullptr));
+                    break;
+
+                case PIPELINE_TYPE_RAY_TRACING:
+                    AddPipelineState(PipelineType, static_cast<RayTracingPipelineNotation*>(nullptr));
+                    break;
+
+                case PIPELINE_TYPE_TILE:
+                    AddPipelineState(PipelineType, static_cast<TilePipelineNotation*>(nullptr));
+                    break;
+                case PIPELINE_TYPE_INVALID:
+                    LOG_ERROR_AND_THROW("Pipeline type isn't set for '", Json["PSODesc"]["Name"].get<std::string>(), "'.");
+                    break;
+                default:
+                    UNEXPECTED("Unexpected pipeline type.");
+            }
+            Pipeline = nullptr;
+        }
+        return true;
+    }
+    catch (std::exception& e)
+    {
+        LOG_ERROR(e.what());
+        return false;
+    }
+}
+
+bool RenderStateNotationParserImpl::ShaderPermutationInfo::IsExcluded(const PermutationValues& Values) const
+{
+    for (const auto& Rule : Exclusions)
+    {
+        bool Matches = true;
+        for (const auto& Macro : Rule)
+        {
+            const auto ValueIt = Values.find(Macro.first);
+            if (ValueIt == Values.end() || std::find(Macro.second.begin(), Macro.second.end(), ValueIt->second) == Macro.second.end())
+            {
+                Matches = false;
+                break;
             }
+        }
+        if (Matches)
             return true;
+    }
+    return false;
+}
+
+void RenderStateNotationParserImpl::AddShaderPermutations(const nlohmann::json& Json, const ShaderCreateInfo& ShaderCI)
+{
+    const auto* Name = ShaderCI.Desc.Name;
+
+    const auto& Permutations = Json.at("Permutations");
+    NLOHMANN_JSON_VALIDATE_KEYS(Permutations, {"Axes", "Exclude"});
+
+    ShaderPermutationInfo Info;
+    Info.ShaderCI   = ShaderCI;
+    Info.Json       = Json;
+    Info.IsModified = m_IsCurrentFileModified;
+
+    for (const auto& Axis : Permutations.at("Axes"))
+    {
+        NLOHMANN_JSON_VALIDATE_KEYS(Axis, {"Macro", "Values"});
+
+        auto Macro = Axis.at("Macro").get<std::string>();
+        for (const auto& OtherAxis : Info.Axes)
+        {
+            if (OtherAxis.first == Macro)
+                LOG_ERROR_AND_THROW("Permutation macro '", Macro, "' of shader '", Name, "' is defined more than once.");
         }
-        catch (std::exception& e)
+
+        std::vector<std::string> Values;
+        for (const auto& Value : Axis.at("Values"))
+            Values.emplace_back(ParsePermutationValue(Value));
+        if (Values.empty())
+            LOG_ERROR_AND_THROW("Permutation macro '", Macro, "' of shader '", Name, "' has no values.");
+
+        Info.Axes.emplace_back(std::move(Macro), std::move(Values));
+    }
+    if (Info.Axes.empty())
+        LOG_ERROR_AND_THROW("Permutations of shader '", Name, "' must define at least one axis.");
+
+    if (const auto* pExclude = FindJsonKey(Permutations, "Exclude"))
+    {
+        for (const auto& Rule : *pExclude)
         {
-            LOG_ERROR(e.what());
-            return false;
+            if (!Rule.is_object())
+                throw nlohmann::json::type_error::create(JsonTypeError, std::string("type must be object, but is ") + Rule.type_name(), Rule);
+
+            std::unordered_map<std::string, std::vector<std::string>> Exclusion;
+            for (auto MacroIt = Rule.begin(); MacroIt != Rule.end(); ++MacroIt)
+            {
+                const auto AxisIt = std::find_if(Info.Axes.begin(), Info.Axes.end(), [&](const auto& Axis) { return Axis.first == MacroIt.key(); });
+                if (AxisIt == Info.Axes.end())
+                    LOG_ERROR_AND_THROW("Exclusion rule of shader '", Name, "' references unknown permutation macro '", MacroIt.key(), "'.");
+
+                std::vector<std::string> Values;
+                if (MacroIt->is_array())
+                {
+                    for (const auto& Value : *MacroIt)
+                        Values.emplace_back(ParsePermutationValue(Value));
+                }
+                else
+                {
+                    Values.emplace_back(ParsePermutationValue(*MacroIt));
+                }
+                Exclusion.emplace(MacroIt.key(), std::move(Values));
+            }
+            Info.Exclusions.emplace_back(std::move(Exclusion));
         }
-    };
+    }
+
+    auto Iter = m_ShaderPermutations.find(Name);
+    if (Iter != m_ShaderPermutations.end())
+    {
+        if (Iter->second.Json != Json)
+            LOG_ERROR_AND_THROW("Redefinition of shader '", Name, "'.");
+        return;
+    }
+
+    if (m_ShaderNames.find(HashMapStringKey{Name, false}) != m_ShaderNames.end())
+        LOG_ERROR_AND_THROW("Redefinition of shader '", Name, "'.");
+
+    m_ShaderPermutations.emplace(Name, std::move(Info));
+}
+
+const Char* RenderStateNotationParserImpl::GetShaderPermutation(const ShaderPermutationInfo& Info, const PermutationValues& Values)
+{
+    std::vector<std::string> Macros;
+    for (const auto& Axis : Info.Axes)
+        Macros.push_back(Axis.first);
+
+    const auto Name = GetPermutationName(Info.ShaderCI.Desc.Name, Macros, Values);
+
+    auto Iter = m_ShaderNames.find(HashMapStringKey{Name.c_str(), false});
+    if (Iter != m_ShaderNames.end())
+        return m_Shaders[Iter->second].Desc.Name;
+
+    ShaderCreateInfo ShaderCI{Info.ShaderCI};
+    ShaderCI.Desc.Name = m_pAllocator->CopyString(Name.c_str());
+
+    size_t MacroCount = 0;
+    if (ShaderCI.Macros != nullptr)
+    {
+        while (!(ShaderCI.Macros[MacroCount] == ShaderMacro{}))
+            ++MacroCount;
+    }
+
+    auto* pMacros = m_pAllocator->ConstructArray<ShaderMacro>(MacroCount + Macros.size() + 1);
+    for (size_t i = 0; i < MacroCount; ++i)
+        pMacros[i] = ShaderCI.Macros[i];
+    for (size_t i = 0; i < Macros.size(); ++i)
+    {
+        pMacros[MacroCount + i].Name       = m_pAllocator->CopyString(Macros[i].c_str());
+        pMacros[MacroCount + i].Definition = m_pAllocator->CopyString(Values.at(Macros[i]).c_str());
+    }
+    ShaderCI.Macros = pMacros;
+
+    const auto Index = StaticCast<Uint32>(m_Shaders.size());
+    m_ShaderNames.emplace(HashMapStringKey{ShaderCI.Desc.Name, false}, Index);
+    AddNameHash(m_ShaderHashes, ComputeNotationNameHash(ShaderCI.Desc.Name), Index, "shader", ShaderCI.Desc.Name);
+    m_Shaders.push_back(ShaderCI);
+    if (Info.IsModified)
+        m_ModifiedShaders.emplace(ShaderCI.Desc.Name);
+
+    return ShaderCI.Desc.Name;
+}
+
+Bool RenderStateNotationParserImpl::ParseStringInternal(const Char*                      Source,
+                                                        Uint32                           Length,
+                                                        IShaderSourceInputStreamFactory* pStreamFactory)
+{
+    VERIFY_EXPR(Source != nullptr);
+
+    try
+    {
+        if (Length >= sizeof(PrecompiledRSNHeader) && memcmp(Source, PrecompiledRSNMagic, sizeof(PrecompiledRSNMagic)) == 0)
+        {
+            PrecompiledRSNHeader Header;
+            memcpy(&Header, Source, sizeof(Header));
+            if (Header.Version != PrecompiledRSNVersion)
+                LOG_ERROR_AND_THROW("Precompiled render state notation version ", Header.Version, " is not supported. Expected version: ", PrecompiledRSNVersion, ".");
 
-    if (!ParseJSON(Source, Length, pStreamFactory))
+            const auto* pData = reinterpret_cast<const Uint8*>(Source) + sizeof(Header);
+
+            nlohmann::json Precompiled = nlohmann::json::from_cbor(pData, pData + (Length - sizeof(Header)));
+
+            // The files have been imported when the notation was precompiled
+            for (auto const& Include : Precompiled.at("Includes"))
+                m_Includes.insert(Include.get<std::string>());
+
+            for (auto& Json : Precompiled.at("Documents"))
+            {
+                if (!ParseJSONInternal(Json, pStreamFactory))
+                    return false;
+            }
+        }
+        else
+        {
+            nlohmann::json Json = Length != 0 ? nlohmann::json::parse(Source, Source + Length) : nlohmann::json::parse(Source);
+            if (!ParseJSONInternal(Json, pStreamFactory))
+                return false;
+        }
+    }
+    catch (std::exception& e)
+    {
+        LOG_ERROR(e.what());
         return false;
+    }
 
     m_ParseInfo.ResourceSignatureCount = StaticCast<Uint32>(m_ResourceSignatures.size());
     m_ParseInfo.ShaderCount            = StaticCast<Uint32>(m_Shaders.size());
@@ -646,6 +1152,56 @@ const RenderPassDesc* RenderStateNotationParserImpl::GetRenderPassByName(const C
     return Iter != m_RenderPassNames.end() ? &m_RenderPasses[Iter->second] : nullptr;
 }
 
+const PipelineStateNotation* RenderStateNotationParserImpl::GetPipelineStateByHash(Uint64 NameHash, PIPELINE_TYPE PipelineType) const
+{
+    auto FindPipeline = [this](Uint64 NameHash, PIPELINE_TYPE PipelineType) -> const PipelineStateNotation* //
+    {
+        const auto Iter = m_PipelineStateHashes.find(std::make_pair(NameHash, PipelineType));
+        if (Iter != m_PipelineStateHashes.end())
+            return &m_PipelineStates[Iter->second].get();
+        return nullptr;
+    };
+
+    if (PipelineType != PIPELINE_TYPE_INVALID)
+    {
+        return FindPipeline(NameHash, PipelineType);
+    }
+    else
+    {
+        constexpr std::array<PIPELINE_TYPE, 5> PipelineTypes = {
+            PIPELINE_TYPE_GRAPHICS,
+            PIPELINE_TYPE_COMPUTE,
+            PIPELINE_TYPE_MESH,
+            PIPELINE_TYPE_RAY_TRACING,
+            PIPELINE_TYPE_TILE};
+
+        for (auto const& Type : PipelineTypes)
+        {
+            if (const auto* pPipeline = FindPipeline(NameHash, Type))
+                return pPipeline;
+        }
+        return nullptr;
+    }
+}
+
+const PipelineResourceSignatureDesc* RenderStateNotationParserImpl::GetResourceSignatureByHash(Uint64 NameHash) const
+{
+    const auto Iter = m_ResourceSignatureHashes.find(NameHash);
+    return Iter != m_ResourceSignatureHashes.end() ? &m_ResourceSignatures[Iter->second] : nullptr;
+}
+
+const ShaderCreateInfo* RenderStateNotationParserImpl::GetShaderByHash(Uint64 NameHash) const
+{
+    const auto Iter = m_ShaderHashes.find(NameHash);
+    return Iter != m_ShaderHashes.end() ? &m_Shaders[Iter->second] : nullptr;
+}
+
+const RenderPassDesc* RenderStateNotationParserImpl::GetRenderPassByHash(Uint64 NameHash) const
+{
+    const auto Iter = m_RenderPassHashes.find(NameHash);
+    return Iter != m_RenderPassHashes.end() ? &m_RenderPasses[Iter->second] : nullptr;
+}
+
 const PipelineStateNotation* RenderStateNotationParserImpl::GetPipelineStateByIndex(Uint32 Index) const
 {
     return Index < m_PipelineStates.size() ? &m_PipelineStates[Index].get() : nullptr;
@@ -691,26 +1247,194 @@ void RenderStateNotationParserImpl::Reset()
     m_RenderPassNames.clear();
     m_PipelineStateNames.clear();
 
+    m_ResourceSignatureHashes.clear();
+    m_ShaderHashes.clear();
+    m_RenderPassHashes.clear();
+    m_PipelineStateHashes.clear();
+
+    m_ShaderPermutations.clear();
+
+    m_TrackedFiles.clear();
+    m_ModifiedShaders.clear();
+    m_ModifiedRenderPasses.clear();
+    m_ModifiedResourceSignatures.clear();
+    m_ModifiedPipelineStates.clear();
+
     m_ParseInfo = {};
 }
 
+bool RenderStateNotationParserImpl::TrackFile(const Char* FilePath, size_t Hash)
+{
+    if (!m_CI.EnableReload)
+        return false;
+
+    m_TrackedFiles[FilePath] = TrackedFile{Hash, m_CurrentReloadInfoIndex};
+
+    // Not reloading: there is nothing to compare with
+    if (m_pPrevTrackedFiles == nullptr)
+        return false;
+
+    const auto Iter = m_pPrevTrackedFiles->find(FilePath);
+    return Iter == m_pPrevTrackedFiles->end() || Iter->second.Hash != Hash;
+}
+
+bool RenderStateNotationParserImpl::HasModifiedFiles() const
+{
+    for (const auto& File : m_TrackedFiles)
+    {
+        VERIFY_EXPR(File.second.ReloadInfoIndex < m_ReloadInfo.size());
+        auto* pFactory = m_ReloadInfo[File.second.ReloadInfoIndex].pFactory.RawPtr<IShaderSourceInputStreamFactory>();
+        if (pFactory == nullptr)
+            return true;
+
+        RefCntAutoPtr<IFileStream> pFileStream;
+        pFactory->CreateInputStream(File.first.c_str(), &pFileStream);
+        if (!pFileStream)
+            return true;
+
+        auto pFileData = DataBlobImpl::Create();
+        pFileStream->ReadBlob(pFileData);
+        if (ComputeFileHash(pFileData) != File.second.Hash)
+            return true;
+    }
+    return false;
+}
+
+void RenderStateNotationParserImpl::AddDependentModifiedPipelines()
+{
+    auto IsModified = [](const std::unordered_set<HashMapStringKey>& Modified, const Char* Name) {
+        return Name != nullptr && Modified.find(Name) != Modified.end();
+    };
+    auto IsShaderModified = [&](const Char* Name) {
+        return IsModified(m_ModifiedShaders, Name);
+    };
+
+    static_assert(PIPELINE_TYPE_LAST == 4, "Please handle the new pipeline type below.");
+    for (const auto& PipelineRef : m_PipelineStates)
+    {
+        const auto& Pipeline = PipelineRef.get();
+        if (IsModified(m_ModifiedPipelineStates, Pipeline.PSODesc.Name))
+            continue;
+
+        bool Modified = false;
+        for (Uint32 i = 0; i < Pipeline.ResourceSignaturesNameCount && !Modified; ++i)
+            Modified = IsModified(m_ModifiedResourceSignatures, Pipeline.ppResourceSignatureNames[i]);
+
+        switch (Pipeline.PSODesc.PipelineType)
+        {
+            case PIPELINE_TYPE_GRAPHICS:
+            case PIPELINE_TYPE_MESH:
+            {
+                const auto& Graphics = static_cast<const GraphicsPipelineNotation&>(Pipeline);
+
+                Modified = Modified ||
+                    IsModified(m_ModifiedRenderPasses, Graphics.pRenderPassName) ||
+                    IsShaderModified(Graphics.pVSName) ||
+                    IsShaderModified(Graphics.pPSName) ||
+                    IsShaderModified(Graphics.pDSName) ||
+                    IsShaderModified(Graphics.pHSName) ||
+                    IsShaderModified(Graphics.pGSName) ||
+                    IsShaderModified(Graphics.pASName) ||
+                    IsShaderModified(Graphics.pMSName);
+                break;
+            }
+
+            case PIPELINE_TYPE_COMPUTE:
+                Modified = Modified || IsShaderModified(static_cast<const ComputePipelineNotation&>(Pipeline).pCSName);
+                break;
+
+            case PIPELINE_TYPE_TILE:
+                Modified = Modified || IsShaderModified(static_cast<const TilePipelineNotation&>(Pipeline).pTSName);
+                break;
+
+            case PIPELINE_TYPE_RAY_TRACING:
+            {
+                const auto& RayTracing = static_cast<const RayTracingPipelineNotation&>(Pipeline);
+                for (Uint32 i = 0; i < RayTracing.GeneralShaderCount && !Modified; ++i)
+                    Modified = IsShaderModified(RayTracing.pGeneralShaders[i].pShaderName);
+                for (Uint32 i = 0; i < RayTracing.TriangleHitShaderCount && !Modified; ++i)
+                {
+                    const auto& Group = RayTracing.pTriangleHitShaders[i];
+                    Modified          = IsShaderModified(Group.pClosestHitShaderName) || IsShaderModified(Group.pAnyHitShaderName);
+                }
+                for (Uint32 i = 0; i < RayTracing.ProceduralHitShaderCount && !Modified; ++i)
+                {
+                    const auto& Group = RayTracing.pProceduralHitShaders[i];
+                    Modified          = IsShaderModified(Group.pIntersectionShaderName) || IsShaderModified(Group.pClosestHitShaderName) || IsShaderModified(Group.pAnyHitShaderName);
+                }
+                break;
+            }
+
+            default:
+                UNEXPECTED("Unexpected pipeline type");
+        }
+
+        if (Modified)
+            m_ModifiedPipelineStates.emplace(Pipeline.PSODesc.Name);
+    }
+}
+
+Bool RenderStateNotationParserImpl::IsStateModified(NOTATION_OBJECT_TYPE ObjectType, const Char* Name) const
+{
+    DEV_CHECK_ERR(Name != nullptr, "Name must not be null");
+
+    static_assert(NOTATION_OBJECT_TYPE_COUNT == 4, "Please handle the new object type below.");
+    switch (ObjectType)
+    {
+        case NOTATION_OBJECT_TYPE_SHADER:
+            return m_ModifiedShaders.find(Name) != m_ModifiedShaders.end();
+
+        case NOTATION_OBJECT_TYPE_RENDER_PASS:
+            return m_ModifiedRenderPasses.find(Name) != m_ModifiedRenderPasses.end();
+
+        case NOTATION_OBJECT_TYPE_RESOURCE_SIGNATURE:
+            return m_ModifiedResourceSignatures.find(Name) != m_ModifiedResourceSignatures.end();
+
+        case NOTATION_OBJECT_TYPE_PIPELINE_STATE:
+            return m_ModifiedPipelineStates.find(Name) != m_ModifiedPipelineStates.end();
+
+        default:
+            UNEXPECTED("Unexpected notation object type");
+            return false;
+    }
+}
+
 bool RenderStateNotationParserImpl::Reload()
 {
+    DILIGENT_TRACE_ZONE("RSN::ReloadParser");
+
     if (!m_CI.EnableReload)
     {
         DEV_ERROR("State reloading is not enabled. Set EnableReload member of RenderStateNotationParserCreateInfo to true when creating the parser.");
         return false;
     }
 
+    // Nothing needs to be parsed again if none of the files has changed
+    if (!HasModifiedFiles())
+    {
+        m_ModifiedShaders.clear();
+        m_ModifiedRenderPasses.clear();
+        m_ModifiedResourceSignatures.clear();
+        m_ModifiedPipelineStates.clear();
+        return true;
+    }
+
+    auto PrevTrackedFiles = std::move(m_TrackedFiles);
     {
         auto ReloadInfo = std::move(m_ReloadInfo);
         Reset();
         m_ReloadInfo = std::move(ReloadInfo);
     }
 
+    // Objects defined in the files whose contents differ from the previous parse are marked as modified
+    m_pPrevTrackedFiles = &PrevTrackedFiles;
+
     bool res = true;
-    for (const auto& Reload : m_ReloadInfo)
+    for (size_t ReloadInfoIndex = 0; ReloadInfoIndex < m_ReloadInfo.size(); ++ReloadInfoIndex)
     {
+        const auto& Reload = m_ReloadInfo[ReloadInfoIndex];
+
+        m_CurrentReloadInfoIndex = ReloadInfoIndex;
         if (!Reload.Path.empty())
         {
             if (!ParseFileInternal(Reload.Path.c_str(), Reload.pFactory.RawPtr<IShaderSourceInputStreamFactory>()))
@@ -726,9 +1450,87 @@ bool RenderStateNotationParserImpl::Reload()
             UNEXPECTED("Either path or source must not be null.");
         }
     }
+
+    m_pPrevTrackedFiles = nullptr;
+
+    // Pipelines that use modified shaders, render passes or signatures are affected too
+    AddDependentModifiedPipelines();
+
     return res;
 }
 
+void PrecompileRenderStateNotation(const Char* const*               ppFilePaths,
+                                   Uint32                           NumFiles,
+                                   IShaderSourceInputStreamFactory* pStreamFactory,
+                                   IDataBlob**                      ppPrecompiledData)
+{
+    DEV_CHECK_ERR(ppFilePaths != nullptr || NumFiles == 0, "ppFilePaths must not be null");
+    DEV_CHECK_ERR(pStreamFactory != nullptr, "pStreamFactory must not be null");
+    DEV_CHECK_ERR(ppPrecompiledData != nullptr, "ppPrecompiledData must not be null");
+    DEV_CHECK_ERR(*ppPrecompiledData == nullptr, "*ppPrecompiledData is not null. Make sure you are not overwriting reference to an existing object as this may result in memory leaks.");
+
+    try
+    {
+        std::unordered_set<std::string> Includes;
+
+        nlohmann::json IncludeList = nlohmann::json::array();
+        nlohmann::json Documents   = nlohmann::json::array();
+
+        // Files are added in the same order in which RenderStateNotationParserImpl parses them:
+        // imports first, each file only once.
+        std::function<void(const std::string&)> AddFile = [&](const std::string& FilePath) {
+            if (!Includes.insert(FilePath).second)
+                return;
+            IncludeList.push_back(FilePath);
+
+            RefCntAutoPtr<IFileStream> pFileStream;
+            pStreamFactory->CreateInputStream(FilePath.c_str(), &pFileStream);
+            if (!pFileStream)
+                LOG_ERROR_AND_THROW("Failed to open file: '", FilePath, "'.");
+
+            auto pFileData = DataBlobImpl::Create();
+            pFileStream->ReadBlob(pFileData);
+
+            const auto*    pSource = static_cast<const char*>(pFileData->GetConstDataPtr());
+            nlohmann::json Json    = nlohmann::json::parse(pSource, pSource + pFileData->GetSize());
+            if (Json.contains("Imports"))
+            {
+                for (auto const& Import : Json["Imports"])
+                    AddFile(Import.get<std::string>());
+                Json.erase("Imports");
+            }
+            Documents.push_back(std::move(Json));
+        };
+
+        for (Uint32 i = 0; i < NumFiles; ++i)
+        {
+            DEV_CHECK_ERR(ppFilePaths[i] != nullptr, "File path ", i, " must not be null");
+            AddFile(ppFilePaths[i]);
+        }
+
+        nlohmann::json Precompiled;
+        Precompiled["Includes"]  = std::move(IncludeList);
+        Precompiled["Documents"] = std::move(Documents);
+
+        const auto CBOR = nlohmann::json::to_cbor(Precompiled);
+
+        PrecompiledRSNHeader Header{};
+        memcpy(Header.Magic, PrecompiledRSNMagic, sizeof(Header.Magic));
+        Header.Version = PrecompiledRSNVersion;
+
+        auto  pData = DataBlobImpl::Create(sizeof(Header) + CBOR.size());
+        auto* pDst  = static_cast<Uint8*>(pData->GetDataPtr());
+        memcpy(pDst, &Header, sizeof(Header));
+        memcpy(pDst + sizeof(Header), CBOR.data(), CBOR.size());
+
+        *ppPrecompiledData = pData.Detach();
+    }
+    catch (std::exception& e)
+    {
+        LOG_ERROR_MESSAGE("Failed to precompile render state notation: ", e.what());
+    }
+}
+
 void CreateRenderStateNotationParser(const RenderStateNotationParserCreateInfo& CreateInfo,
                                      IRenderStateNotationParser**               ppParser)
 {
@@ -753,4 +1555,12 @@ extern "C"
     {
         Diligent::CreateRenderStateNotationParser(CreateInfo, ppLoader);
     }
+
+    void Diligent_PrecompileRenderStateNotation(const Diligent::Char* const*               ppFilePaths,
+                                                Diligent::Uint32                           NumFiles,
+                                                Diligent::IShaderSourceInputStreamFactory* pStreamFactory,
+                                                Diligent::IDataBlob**                      ppPrecompiledData)
+    {
+        Diligent::PrecompileRenderStateNotation(ppFilePaths, NumFiles, pStreamFactory, ppPrecompiledData);
+    }
 }
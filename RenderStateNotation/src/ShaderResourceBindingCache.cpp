@@ -0,0 +1,186 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "ShaderResourceBindingCache.hpp"
+
+#include "PipelineState.h"
+#include "PipelineResourceSignature.h"
+#include "ShaderResourceBinding.h"
+#include "HashUtils.hpp"
+#include "ThreadPool.hpp"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+ShaderResourceBindingCache::BindingKey::BindingKey(const ShaderResourceBindingInfo& Info) :
+    pOwner{Info.pPSO != nullptr ? static_cast<IDeviceObject*>(Info.pPSO) : static_cast<IDeviceObject*>(Info.pSignature)},
+    InitStaticResources{Info.InitStaticResources}
+{
+    Hash = ComputeHash(pOwner, InitStaticResources);
+
+    Resources.reserve(Info.NumResources);
+    for (Uint32 i = 0; i < Info.NumResources; ++i)
+    {
+        const auto& Res = Info.pResources[i];
+
+        ResourceKey ResKey;
+        ResKey.ShaderStages = Res.ShaderStages;
+        ResKey.Name         = Res.Name != nullptr ? Res.Name : "";
+        ResKey.pObject      = Res.pObject;
+        ResKey.ArrayIndex   = Res.ArrayIndex;
+        HashCombine(Hash, static_cast<Uint32>(ResKey.ShaderStages), ResKey.Name, ResKey.pObject, ResKey.ArrayIndex);
+        Resources.emplace_back(std::move(ResKey));
+    }
+}
+
+RefCntAutoPtr<IShaderResourceBinding> ShaderResourceBindingCache::CreateBinding(const ShaderResourceBindingInfo& Info)
+{
+    RefCntAutoPtr<IShaderResourceBinding> pSRB;
+    if (Info.pPSO != nullptr)
+        Info.pPSO->CreateShaderResourceBinding(&pSRB, Info.InitStaticResources);
+    else
+        Info.pSignature->CreateShaderResourceBinding(&pSRB, Info.InitStaticResources);
+    if (!pSRB)
+    {
+        LOG_ERROR_MESSAGE("Failed to create shader resource binding");
+        return {};
+    }
+
+    for (Uint32 i = 0; i < Info.NumResources; ++i)
+    {
+        const auto& Res = Info.pResources[i];
+        if (Res.Name == nullptr || Res.pObject == nullptr)
+            continue;
+
+        bool IsBound = false;
+        for (Uint32 Stages = Res.ShaderStages; Stages != 0; Stages &= Stages - 1)
+        {
+            const auto ShaderType = static_cast<SHADER_TYPE>(Stages & ~(Stages - 1));
+            if (auto* pVar = pSRB->GetVariableByName(ShaderType, Res.Name))
+            {
+                pVar->SetArray(&Res.pObject, Res.ArrayIndex, 1);
+                IsBound = true;
+            }
+        }
+        if (!IsBound)
+            LOG_WARNING_MESSAGE("Variable '", Res.Name, "' is not found in the shader resource binding");
+    }
+
+    return pSRB;
+}
+
+RefCntAutoPtr<IShaderResourceBinding> ShaderResourceBindingCache::Find(const BindingKey& Key)
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+
+    auto Iter = m_Bindings.find(Key);
+    return Iter != m_Bindings.end() ? Iter->second.pSRB : RefCntAutoPtr<IShaderResourceBinding>{};
+}
+
+RefCntAutoPtr<IShaderResourceBinding> ShaderResourceBindingCache::Add(BindingKey&& Key, const ShaderResourceBindingInfo& Info, RefCntAutoPtr<IShaderResourceBinding> pSRB)
+{
+    if (!pSRB)
+        return {};
+
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+
+    // Another thread may have added the same binding in the meantime
+    BindingEntry Entry;
+    Entry.pOwner = Info.pPSO != nullptr ? static_cast<IDeviceObject*>(Info.pPSO) : static_cast<IDeviceObject*>(Info.pSignature);
+    Entry.pSRB   = std::move(pSRB);
+    return m_Bindings.emplace(std::move(Key), std::move(Entry)).first->second.pSRB;
+}
+
+RefCntAutoPtr<IShaderResourceBinding> ShaderResourceBindingCache::Get(const ShaderResourceBindingInfo& Info)
+{
+    DEV_CHECK_ERR(Info.pPSO != nullptr || Info.pSignature != nullptr, "Either pPSO or pSignature must not be null");
+    DEV_CHECK_ERR(Info.NumResources == 0 || Info.pResources != nullptr, "pResources must not be null");
+
+    BindingKey Key{Info};
+    if (auto pSRB = Find(Key))
+        return pSRB;
+
+    return Add(std::move(Key), Info, CreateBinding(Info));
+}
+
+void ShaderResourceBindingCache::Get(const ShaderResourceBindingInfo* pInfos, Uint32 NumSRBs, IShaderResourceBinding** ppSRBs, IThreadPool* pThreadPool)
+{
+    DEV_CHECK_ERR(NumSRBs == 0 || pInfos != nullptr, "pInfos must not be null");
+    DEV_CHECK_ERR(NumSRBs == 0 || ppSRBs != nullptr, "ppSRBs must not be null");
+
+    // Look up all bindings first, so that only the missing ones are sent to the thread pool
+    std::vector<Uint32> Missing;
+    for (Uint32 i = 0; i < NumSRBs; ++i)
+    {
+        DEV_CHECK_ERR(pInfos[i].pPSO != nullptr || pInfos[i].pSignature != nullptr, "Either pPSO or pSignature must not be null");
+        if (auto pSRB = Find(BindingKey{pInfos[i]}))
+            ppSRBs[i] = pSRB.Detach();
+        else
+            Missing.push_back(i);
+    }
+
+    if (pThreadPool == nullptr || Missing.size() <= 1)
+    {
+        for (auto i : Missing)
+            ppSRBs[i] = Get(pInfos[i]).Detach();
+        return;
+    }
+
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    Tasks.reserve(Missing.size());
+    for (auto i : Missing)
+    {
+        Tasks.emplace_back(EnqueueAsyncWork(pThreadPool, [this, pInfos, ppSRBs, i](Uint32) {
+            ppSRBs[i] = Get(pInfos[i]).Detach();
+        }));
+    }
+    for (auto& pTask : Tasks)
+        pTask->WaitForCompletion();
+}
+
+Uint32 ShaderResourceBindingCache::Purge()
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+
+    Uint32 NumPurged = 0;
+    for (auto Iter = m_Bindings.begin(); Iter != m_Bindings.end();)
+    {
+        if (Iter->second.pSRB->GetReferenceCounters()->GetNumStrongRefs() == 1)
+        {
+            Iter = m_Bindings.erase(Iter);
+            ++NumPurged;
+        }
+        else
+        {
+            ++Iter;
+        }
+    }
+    return NumPurged;
+}
+
+} // namespace Diligent
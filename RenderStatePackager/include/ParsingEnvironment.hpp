@@ -44,12 +44,22 @@ struct ParsingEnvironmentCreateInfo
     PSO_ARCHIVE_FLAGS         PSOArchiveFlags      = {};
     Uint32                    ThreadCount          = {};
     bool                      PrintArchiveContents = false;
+    bool                      SplitArchiveByDevice = false;
+    bool                      SplitArchiveByInput  = false;
+    bool                      ContentAddressed     = false;
+    bool                      Watch                = false;
     std::vector<std::string>  ShaderDirs           = {};
     std::vector<std::string>  RenderStateDirs      = {};
     std::vector<std::string>  InputFilePaths       = {};
     std::string               OuputFilePath        = {};
     std::string               ConfigFilePath       = {};
     std::string               DumpBytecodeDir      = {};
+    std::string               PrecompiledFilePath  = {};
+    std::string               BuildCacheDir        = {};
+    Uint32                    ProcessCount         = {};
+    std::vector<std::string>  MergeArchivePaths    = {};
+    std::string               ReportFilePath       = {};
+    Uint32                    CompressionLevel     = {};
 };
 
 class ParsingEnvironment final
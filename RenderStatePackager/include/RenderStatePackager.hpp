@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <string>
 #include <vector>
 #include <unordered_map>
 
@@ -60,13 +61,95 @@ public:
 
     bool Execute(IArchiver* pArchiver, const char* DumpPath = nullptr);
 
+    /// Computes the hash of all inputs that affect the archive produced by Execute().
+
+    /// \param [in]  DRSNPaths - Render state notation files that were passed to ParseFiles().
+    /// \param [out] Hash      - Hash of the render state notation files with their imports,
+    ///                          shader sources with their includes, device and archive flags.
+    /// \return     true if all inputs were read successfully, and false otherwise.
+    ///
+    /// \remarks    ParseFiles() must be called before this method.
+    ///             The hash is used as the key of the persistent build cache.
+    bool ComputeContentHash(std::vector<std::string> const& DRSNPaths, size_t& Hash) const;
+
+    /// Releases the parser and the objects created by the last Execute() call.
+
+    /// \remarks Compiled shaders are kept, and the next Execute() call reuses the shaders whose
+    ///          compile parameters, source and included files have not changed. Call
+    ///          ClearShaderCache() to release them.
     void Reset();
 
+    /// Releases the shaders kept for reuse by the next Execute() call.
+    void ClearShaderCache()
+    {
+        m_CompiledShaders.clear();
+    }
+
+    /// Timing and size statistics collected by the last Execute() call.
+    struct ExecutionStatistics
+    {
+        struct ObjectInfo
+        {
+            std::string Name;
+
+            /// Name of the shader whose compiled data is reused, empty if the object was created.
+            std::string SharedWith;
+
+            /// Whether the shader was compiled by a previous Execute() call.
+            bool IsCached = false;
+
+            /// Creation time for pipelines, compile time for all device backends for shaders.
+            double TimeMs   = 0;
+            Uint32 ThreadId = 0;
+        };
+
+        struct DeviceInfo
+        {
+            ARCHIVE_DEVICE_DATA_FLAGS DeviceFlag     = ARCHIVE_DEVICE_DATA_FLAG_NONE;
+            Uint32                    ShaderCount    = 0;
+            size_t                    ShaderDataSize = 0;
+        };
+
+        double                  TotalTimeMs = 0;
+        std::vector<ObjectInfo> Shaders;
+        std::vector<ObjectInfo> Pipelines;
+        std::vector<DeviceInfo> Devices;
+    };
+
+    const ExecutionStatistics& GetStatistics() const
+    {
+        return m_Statistics;
+    }
+
+    /// Writes the statistics of the last Execute() call to a JSON file.
+
+    /// \param [in] FilePath      - Path to the report file.
+    /// \param [in] ArchiveSize   - Size of the serialized archive, in bytes.
+    /// \param [in] BuildCacheHit - Whether the archive was taken from the build cache.
+    ///                             In this case Execute() is not called and the statistics are empty.
+    bool WriteReport(const char* FilePath, size_t ArchiveSize, bool BuildCacheHit) const;
+
     const IRenderStateNotationParser* GetParser() const
     {
         return m_pRSNParser;
     }
 
+    /// Returns the device flags supported by the serialization device that the packager compiles for.
+    ARCHIVE_DEVICE_DATA_FLAGS GetDeviceFlags() const
+    {
+        return m_DeviceFlags;
+    }
+
+    /// Builds a compression dictionary from the data shared by several archives.
+
+    /// \param [in] Archives - Archives to build the dictionary from, e.g. the chunks of a split archive.
+    /// \param [in] MaxSize  - Maximum dictionary size, in bytes.
+    /// \return    The dictionary, or null if the archives have no data in common.
+    ///
+    /// \remarks   The dictionary consists of the byte sequences that occur most often across the archives,
+    ///            with the most frequent ones at the end, where deflate finds them at the shortest distance.
+    static RefCntAutoPtr<IDataBlob> BuildCompressionDictionary(const std::vector<const IDataBlob*>& Archives, size_t MaxSize = 32768);
+
     static const char* GetShaderFileExtension(ARCHIVE_DEVICE_DATA_FLAGS DeviceFlag, SHADER_SOURCE_LANGUAGE Language, bool UseBytecode);
 
 private:
@@ -83,6 +166,11 @@ private:
     TNamedObjectHashMap<IRenderPass>                m_RenderPasses;
     TNamedObjectHashMap<IPipelineResourceSignature> m_ResourceSignatures;
 
+    ExecutionStatistics m_Statistics;
+
+    // Shaders compiled by the last Execute() call, keyed by the hash of their compile parameters and sources
+    std::unordered_map<size_t, RefCntAutoPtr<IShader>> m_CompiledShaders;
+
     const ARCHIVE_DEVICE_DATA_FLAGS m_DeviceFlags;
     const PSO_ARCHIVE_FLAGS         m_PSOArchiveFlags;
 };
@@ -26,8 +26,13 @@
 
 #include "RenderStatePackager.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <deque>
+#include <functional>
 #include <sstream>
+#include <unordered_set>
 
 #include "GraphicsAccessories.hpp"
 #include "BasicMath.hpp"
@@ -36,6 +41,12 @@
 #include "SerializedPipelineState.h"
 #include "FileSystem.hpp"
 #include "FileWrapper.hpp"
+#include "DataBlobImpl.hpp"
+#include "APIInfo.h"
+#include "Timer.hpp"
+#include "ToolsTrace.hpp"
+
+#include "json.hpp"
 
 namespace Diligent
 {
@@ -102,8 +113,18 @@ struct BytecodeDumper
         WorkingDirectory& m_Directory;
     };
 
-    static bool Execute(const std::vector<RefCntAutoPtr<IPipelineState>>& Pipelines, ARCHIVE_DEVICE_DATA_FLAGS DeviceFlags, const char* Path)
+    // The directories are created and the shader data is collected on the calling thread,
+    // while the files are written by the thread pool.
+    static bool Execute(const std::vector<RefCntAutoPtr<IPipelineState>>& Pipelines, ARCHIVE_DEVICE_DATA_FLAGS DeviceFlags, const char* Path, IThreadPool* pThreadPool)
     {
+        struct DumpFileInfo
+        {
+            String      Path;
+            const void* pData = nullptr;
+            size_t      Size  = 0;
+        };
+        std::vector<DumpFileInfo> Files;
+
         try
         {
             WorkingDirectory RootDirectory{Path};
@@ -124,16 +145,15 @@ struct BytecodeDumper
                     auto pSerializedPSO = pPipeline.Cast<ISerializedPipelineState>(IID_SerializedPipelineState);
                     for (Uint32 ShaderID = 0; ShaderID < pSerializedPSO->GetPatchedShaderCount(DeviceFlag); ++ShaderID)
                     {
+                        // The data is owned by the pipeline, which outlives the tasks
                         const auto ShaderCI    = pSerializedPSO->GetPatchedShaderCreateInfo(DeviceFlag, ShaderID);
                         const auto UseBytecode = (ShaderCI.ByteCode != nullptr);
-                        const auto ShaderPath  = RootDirectory.ComputePathFor(ShaderCI.Desc.Name) + RenderStatePackager::GetShaderFileExtension(DeviceFlag, ShaderCI.SourceLanguage, UseBytecode);
 
-                        FileWrapper File{ShaderPath.c_str(), EFileAccessMode::Overwrite};
-                        if (!File)
-                            LOG_FATAL_ERROR_AND_THROW("Failed to open file: '", ShaderPath, "'.");
-
-                        File->Write(UseBytecode ? ShaderCI.ByteCode : ShaderCI.Source,
-                                    UseBytecode ? ShaderCI.ByteCodeSize : ShaderCI.SourceLength);
+                        DumpFileInfo File;
+                        File.Path  = RootDirectory.ComputePathFor(ShaderCI.Desc.Name) + RenderStatePackager::GetShaderFileExtension(DeviceFlag, ShaderCI.SourceLanguage, UseBytecode);
+                        File.pData = UseBytecode ? ShaderCI.ByteCode : ShaderCI.Source;
+                        File.Size  = UseBytecode ? ShaderCI.ByteCodeSize : ShaderCI.SourceLength;
+                        Files.emplace_back(std::move(File));
                     }
                 }
             }
@@ -143,8 +163,269 @@ struct BytecodeDumper
             return false;
         }
 
+        std::atomic<bool> Result{true};
+
+        auto WriteFile = [&Files, &Result](size_t FileID) {
+            const auto& File = Files[FileID];
+
+            FileWrapper FileStream{File.Path.c_str(), EFileAccessMode::Overwrite};
+            if (!FileStream || !FileStream->Write(File.pData, File.Size))
+            {
+                LOG_ERROR_MESSAGE("Failed to write file: '", File.Path, "'.");
+                Result.store(false);
+            }
+        };
+
+        if (pThreadPool != nullptr)
+        {
+            for (size_t FileID = 0; FileID < Files.size(); ++FileID)
+                EnqueueAsyncWork(pThreadPool, [&WriteFile, FileID](Uint32 ThreadId) { WriteFile(FileID); });
+            pThreadPool->WaitForAllTasks();
+        }
+        else
+        {
+            for (size_t FileID = 0; FileID < Files.size(); ++FileID)
+                WriteFile(FileID);
+        }
+
+        return Result.load();
+    }
+};
+
+// Increment this value whenever the archive layout produced by the packager changes
+// in a way that invalidates previously cached archives.
+constexpr Uint32 BuildCacheVersion = 1;
+
+size_t ComputeBlobHash(const IDataBlob* pData)
+{
+    const auto* pBytes = static_cast<const char*>(pData->GetConstDataPtr());
+    return std::hash<std::string>{}(std::string{pBytes, pBytes + pData->GetSize()});
+}
+
+// Extracts the names of all files referenced by #include directives in the source.
+// Inactive preprocessor branches are not evaluated, so the result may contain
+// files that the compiler never opens. This only makes the cache more conservative.
+std::vector<std::string> FindIncludeDirectives(const char* pSource, size_t Size)
+{
+    std::vector<std::string> Includes;
+
+    const auto* pEnd = pSource + Size;
+    for (const auto* pPos = pSource; pPos < pEnd;)
+    {
+        const auto* pLineEnd = std::find(pPos, pEnd, '\n');
+
+        auto SkipSpaces = [&]() {
+            while (pPos < pLineEnd && (*pPos == ' ' || *pPos == '\t'))
+                ++pPos;
+        };
+
+        SkipSpaces();
+        if (pPos < pLineEnd && *pPos == '#')
+        {
+            ++pPos;
+            SkipSpaces();
+
+            static constexpr char   Directive[]  = "include";
+            static constexpr size_t DirectiveLen = sizeof(Directive) - 1;
+            if (static_cast<size_t>(pLineEnd - pPos) > DirectiveLen && std::equal(Directive, Directive + DirectiveLen, pPos))
+            {
+                pPos += DirectiveLen;
+                SkipSpaces();
+                if (pPos < pLineEnd && (*pPos == '"' || *pPos == '<'))
+                {
+                    const char  ClosingQuote = *pPos == '"' ? '"' : '>';
+                    const auto* pNameStart   = pPos + 1;
+                    const auto* pNameEnd     = std::find(pNameStart, pLineEnd, ClosingQuote);
+                    if (pNameEnd != pLineEnd && pNameEnd != pNameStart)
+                        Includes.emplace_back(pNameStart, pNameEnd);
+                }
+            }
+        }
+
+        pPos = pLineEnd + 1;
+    }
+
+    return Includes;
+}
+
+// Hashes shader compile parameters together with the shader source and all files it includes.
+// File contents and resolved includes are cached, so headers shared by many shaders are read once.
+class ShaderSourceHasher
+{
+public:
+    explicit ShaderSourceHasher(IShaderSourceInputStreamFactory* pStreamFactory) :
+        m_pStreamFactory{pStreamFactory}
+    {}
+
+    // The shader name is not hashed, so shaders that differ only in name produce the same hash.
+    // Macros whose names do not occur in the source or its includes cannot change the preprocessed
+    // source and are not hashed either, so such permutations of a shader share the compiled data.
+    bool ComputeShaderHash(const ShaderCreateInfo& ShaderCI, size_t& Hash)
+    {
+        Hash = ComputeHash(ShaderCI.Desc.ShaderType, ShaderCI.Desc.UseCombinedTextureSamplers, ShaderCI.SourceLanguage, ShaderCI.ShaderCompiler, ShaderCI.CompileFlags);
+        HashCombine(Hash, ShaderCI.HLSLVersion.Major, ShaderCI.HLSLVersion.Minor, ShaderCI.GLSLVersion.Major, ShaderCI.GLSLVersion.Minor, ShaderCI.GLESSLVersion.Major, ShaderCI.GLESSLVersion.Minor);
+        HashCombine(Hash, std::string{ShaderCI.Desc.CombinedSamplerSuffix != nullptr ? ShaderCI.Desc.CombinedSamplerSuffix : ""});
+        HashCombine(Hash, std::string{ShaderCI.EntryPoint != nullptr ? ShaderCI.EntryPoint : ""});
+
+        std::unordered_set<std::string>    VisitedFiles;
+        std::vector<const SourceFileInfo*> Sources;
+        SourceFileInfo                     InlineSourceInfo;
+        if (ShaderCI.Source != nullptr)
+        {
+            const auto SourceLength = ShaderCI.SourceLength != 0 ? ShaderCI.SourceLength : strlen(ShaderCI.Source);
+            InlineSourceInfo        = ParseSource(nullptr, ShaderCI.Source, SourceLength);
+            Sources.push_back(&InlineSourceInfo);
+            HashCombine(Hash, InlineSourceInfo.ContentHash);
+            HashIncludes(InlineSourceInfo, VisitedFiles, Sources, Hash);
+        }
+        else if (ShaderCI.FilePath != nullptr)
+        {
+            const auto* pFileInfo = GetFileInfo(ShaderCI.FilePath);
+            if (pFileInfo == nullptr)
+            {
+                LOG_ERROR_MESSAGE("Failed to open shader source file '", ShaderCI.FilePath, "'.");
+                return false;
+            }
+            VisitedFiles.insert(ShaderCI.FilePath);
+            Sources.push_back(pFileInfo);
+            HashCombine(Hash, pFileInfo->ContentHash);
+            HashIncludes(*pFileInfo, VisitedFiles, Sources, Hash);
+        }
+
+        if (ShaderCI.Macros != nullptr)
+        {
+            // Macros used in the definitions of other macros are treated as used by the source
+            SourceFileInfo Definitions;
+            for (const auto* pMacro = ShaderCI.Macros; pMacro->Name != nullptr || pMacro->Definition != nullptr; ++pMacro)
+            {
+                if (pMacro->Definition != nullptr)
+                    FindIdentifiers(pMacro->Definition, strlen(pMacro->Definition), Definitions.Identifiers);
+            }
+            Sources.push_back(&Definitions);
+
+            for (const auto* pMacro = ShaderCI.Macros; pMacro->Name != nullptr || pMacro->Definition != nullptr; ++pMacro)
+            {
+                const std::string Name{pMacro->Name != nullptr ? pMacro->Name : ""};
+
+                const auto IsUsed = std::any_of(Sources.begin(), Sources.end(), [&Name](const SourceFileInfo* pInfo) { return pInfo->Identifiers.count(Name) != 0; });
+                if (!IsUsed)
+                    continue;
+
+                HashCombine(Hash, Name);
+                HashCombine(Hash, std::string{pMacro->Definition != nullptr ? pMacro->Definition : ""});
+            }
+        }
+
         return true;
     }
+
+private:
+    struct IncludeInfo
+    {
+        std::string Name;
+        std::string Path; // Empty if the include could not be resolved
+    };
+
+    struct SourceFileInfo
+    {
+        size_t                          ContentHash = 0;
+        std::vector<IncludeInfo>        Includes;
+        std::unordered_set<std::string> Identifiers;
+    };
+
+    // Identifiers in comments and inactive branches are included as well, which only
+    // means that a macro is hashed when it could have been skipped.
+    static void FindIdentifiers(const char* pSource, size_t Size, std::unordered_set<std::string>& Identifiers)
+    {
+        const auto IsIdentifierChar = [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_'; };
+        for (size_t Pos = 0; Pos < Size;)
+        {
+            if (!IsIdentifierChar(pSource[Pos]))
+            {
+                ++Pos;
+                continue;
+            }
+
+            const auto Start = Pos;
+            while (Pos < Size && IsIdentifierChar(pSource[Pos]))
+                ++Pos;
+            if (pSource[Start] < '0' || pSource[Start] > '9')
+                Identifiers.emplace(pSource + Start, pSource + Pos);
+        }
+    }
+
+    SourceFileInfo ParseSource(const char* FilePath, const char* pSource, size_t Size) const
+    {
+        SourceFileInfo Info;
+        Info.ContentHash = std::hash<std::string>{}(std::string{pSource, pSource + Size});
+
+        FindIdentifiers(pSource, Size, Info.Identifiers);
+
+        for (auto& Include : FindIncludeDirectives(pSource, Size))
+        {
+            // Try the name as is first, then relative to the including file
+            std::string IncludePath = Include;
+
+            RefCntAutoPtr<IFileStream> pFileStream;
+            m_pStreamFactory->CreateInputStream(IncludePath.c_str(), &pFileStream);
+            if (!pFileStream && FilePath != nullptr)
+            {
+                std::string Dir;
+                FileSystem::GetPathComponents(FilePath, &Dir, nullptr);
+                if (!Dir.empty())
+                {
+                    IncludePath = Dir + FileSystem::SlashSymbol + Include;
+                    m_pStreamFactory->CreateInputStream(IncludePath.c_str(), &pFileStream);
+                }
+            }
+
+            // Unresolved includes are either system headers or belong to inactive branches.
+            // Their names are still part of the hash.
+            if (!pFileStream)
+                IncludePath.clear();
+
+            Info.Includes.push_back({std::move(Include), std::move(IncludePath)});
+        }
+        return Info;
+    }
+
+    const SourceFileInfo* GetFileInfo(const std::string& FilePath)
+    {
+        auto Iter = m_Files.find(FilePath);
+        if (Iter != m_Files.end())
+            return &Iter->second;
+
+        RefCntAutoPtr<IFileStream> pFileStream;
+        m_pStreamFactory->CreateInputStream(FilePath.c_str(), &pFileStream);
+        if (!pFileStream)
+            return nullptr;
+
+        auto pFileData = DataBlobImpl::Create(0);
+        pFileStream->ReadBlob(pFileData);
+
+        auto Info = ParseSource(FilePath.c_str(), static_cast<const char*>(pFileData->GetConstDataPtr()), pFileData->GetSize());
+        return &m_Files.emplace(FilePath, std::move(Info)).first->second;
+    }
+
+    void HashIncludes(const SourceFileInfo& FileInfo, std::unordered_set<std::string>& VisitedFiles, std::vector<const SourceFileInfo*>& Sources, size_t& Hash)
+    {
+        for (const auto& Include : FileInfo.Includes)
+        {
+            HashCombine(Hash, Include.Name);
+            if (Include.Path.empty() || !VisitedFiles.insert(Include.Path).second)
+                continue;
+
+            if (const auto* pIncludeInfo = GetFileInfo(Include.Path))
+            {
+                Sources.push_back(pIncludeInfo);
+                HashCombine(Hash, pIncludeInfo->ContentHash);
+                HashIncludes(*pIncludeInfo, VisitedFiles, Sources, Hash);
+            }
+        }
+    }
+
+    IShaderSourceInputStreamFactory* const          m_pStreamFactory;
+    std::unordered_map<std::string, SourceFileInfo> m_Files;
 };
 
 } // namespace
@@ -208,6 +489,8 @@ RenderStatePackager::RenderStatePackager(RefCntAutoPtr<ISerializationDevice>
 bool RenderStatePackager::ParseFiles(std::vector<std::string> const& DRSNPaths)
 {
     DEV_CHECK_ERR(!DRSNPaths.empty(), "DRSNPaths must not be empty");
+    DILIGENT_TRACE_ZONE("Packager::ParseFiles");
+
     CreateRenderStateNotationParser({}, &m_pRSNParser);
 
     for (auto const& Path : DRSNPaths)
@@ -216,6 +499,48 @@ bool RenderStatePackager::ParseFiles(std::vector<std::string> const& DRSNPaths)
     return true;
 }
 
+bool RenderStatePackager::ComputeContentHash(std::vector<std::string> const& DRSNPaths, size_t& Hash) const
+{
+    DEV_CHECK_ERR(m_pRSNParser != nullptr, "ParseFiles() must be called before ComputeContentHash()");
+
+    Hash = ComputeHash(BuildCacheVersion, DILIGENT_API_VERSION, static_cast<Uint32>(m_DeviceFlags), static_cast<Uint32>(m_PSOArchiveFlags));
+
+    // The precompiled notation contains all render state files together with their imports
+    {
+        std::vector<const Char*> Paths;
+        Paths.reserve(DRSNPaths.size());
+        for (const auto& Path : DRSNPaths)
+            Paths.push_back(Path.c_str());
+
+        RefCntAutoPtr<IDataBlob> pPrecompiledData;
+        PrecompileRenderStateNotation(Paths.data(), static_cast<Uint32>(Paths.size()), m_pRenderStateStreamFactory, &pPrecompiledData);
+        if (!pPrecompiledData)
+        {
+            LOG_ERROR_MESSAGE("Failed to precompile render state notation");
+            return false;
+        }
+        HashCombine(Hash, ComputeBlobHash(pPrecompiledData));
+    }
+
+    // Shader compile parameters and sources with all files they include.
+    // Names are part of the archive, so they are hashed as well.
+    ShaderSourceHasher SourceHasher{m_pShaderStreamFactory};
+
+    const auto& ParserInfo = m_pRSNParser->GetInfo();
+    for (Uint32 ShaderID = 0; ShaderID < ParserInfo.ShaderCount; ++ShaderID)
+    {
+        const auto* pShaderCI = m_pRSNParser->GetShaderByIndex(ShaderID);
+
+        size_t ShaderHash = 0;
+        if (!SourceHasher.ComputeShaderHash(*pShaderCI, ShaderHash))
+            return false;
+
+        HashCombine(Hash, std::string{pShaderCI->Desc.Name}, ShaderHash);
+    }
+
+    return true;
+}
+
 bool RenderStatePackager::Execute(IArchiver* pArchiver, const char* DumpPath)
 {
     DEV_CHECK_ERR(pArchiver != nullptr, "pArchive must not be null");
@@ -223,10 +548,22 @@ bool RenderStatePackager::Execute(IArchiver* pArchiver, const char* DumpPath)
     if (pArchiver == nullptr)
         return false;
 
+    DILIGENT_TRACE_ZONE("Packager::Execute");
+
     try
     {
         auto const& ParserInfo = m_pRSNParser->GetInfo();
 
+        Timer ExecutionTimer;
+
+        m_Statistics = {};
+        m_Statistics.Shaders.resize(ParserInfo.ShaderCount);
+        m_Statistics.Pipelines.resize(ParserInfo.PipelineStateCount);
+        for (Uint32 ShaderID = 0; ShaderID < ParserInfo.ShaderCount; ++ShaderID)
+            m_Statistics.Shaders[ShaderID].Name = m_pRSNParser->GetShaderByIndex(ShaderID)->Desc.Name;
+        for (Uint32 PipelineID = 0; PipelineID < ParserInfo.PipelineStateCount; ++PipelineID)
+            m_Statistics.Pipelines[PipelineID].Name = m_pRSNParser->GetPipelineStateByIndex(PipelineID)->PSODesc.Name;
+
         std::vector<RefCntAutoPtr<IShader>>                    Shaders(ParserInfo.ShaderCount);
         std::vector<RefCntAutoPtr<IRenderPass>>                RenderPasses(ParserInfo.RenderPassCount);
         std::vector<RefCntAutoPtr<IPipelineResourceSignature>> ResourceSignatures(ParserInfo.ResourceSignatureCount);
@@ -234,9 +571,52 @@ bool RenderStatePackager::Execute(IArchiver* pArchiver, const char* DumpPath)
 
         std::atomic<bool> Result{true};
 
+        // Every pipeline waits only for the tasks that create its own shaders, render pass and
+        // resource signatures, so that a slow shader does not stall unrelated pipelines.
+        std::vector<RefCntAutoPtr<IAsyncTask>> ShaderTasks(ParserInfo.ShaderCount);
+        std::vector<RefCntAutoPtr<IAsyncTask>> RenderPassTasks(ParserInfo.RenderPassCount);
+        std::vector<RefCntAutoPtr<IAsyncTask>> ResourceSignatureTasks(ParserInfo.ResourceSignatureCount);
+
+        std::unordered_map<HashMapStringKey, Uint32> ShaderIndices;
+        std::unordered_map<HashMapStringKey, Uint32> RenderPassIndices;
+        std::unordered_map<HashMapStringKey, Uint32> ResourceSignatureIndices;
+
+        // Shaders that differ only in name or have identical sources and compile parameters
+        // are compiled once. All their names refer to the same shader object.
+        ShaderSourceHasher                 SourceHasher{m_pShaderStreamFactory};
+        std::unordered_map<size_t, Uint32> UniqueShaderIndices;
+
         for (Uint32 ShaderID = 0; ShaderID < ParserInfo.ShaderCount; ++ShaderID)
         {
-            EnqueueAsyncWork(m_pThreadPool, [ShaderID, this, &Result, &Shaders](Uint32 ThreadId) {
+            const auto* pShaderCI = m_pRSNParser->GetShaderByIndex(ShaderID);
+
+            size_t ShaderHash = 0;
+            if (SourceHasher.ComputeShaderHash(*pShaderCI, ShaderHash))
+            {
+                auto UniqueIter = UniqueShaderIndices.emplace(ShaderHash, ShaderID);
+                if (!UniqueIter.second)
+                {
+                    ShaderIndices.emplace(HashMapStringKey{pShaderCI->Desc.Name, false}, UniqueIter.first->second);
+                    m_Statistics.Shaders[ShaderID].SharedWith = m_pRSNParser->GetShaderByIndex(UniqueIter.first->second)->Desc.Name;
+                    continue;
+                }
+
+                // Shaders compiled by a previous Execute() call are reused without a task
+                auto CacheIter = m_CompiledShaders.find(ShaderHash);
+                if (CacheIter != m_CompiledShaders.end())
+                {
+                    ShaderIndices.emplace(HashMapStringKey{pShaderCI->Desc.Name, false}, ShaderID);
+                    Shaders[ShaderID]                       = CacheIter->second;
+                    m_Statistics.Shaders[ShaderID].IsCached = true;
+                    continue;
+                }
+            }
+
+            ShaderIndices.emplace(HashMapStringKey{pShaderCI->Desc.Name, false}, ShaderID);
+            ShaderTasks[ShaderID] = EnqueueAsyncWork(m_pThreadPool, [ShaderID, this, &Result, &Shaders](Uint32 ThreadId) {
+                DILIGENT_TRACE_ZONE("Packager::CompileShader");
+                Timer CompileTimer;
+
                 ShaderCreateInfo ShaderCI           = *m_pRSNParser->GetShaderByIndex(ShaderID);
                 ShaderCI.pShaderSourceStreamFactory = m_pShaderStreamFactory;
 
@@ -247,12 +627,18 @@ bool RenderStatePackager::Execute(IArchiver* pArchiver, const char* DumpPath)
                     LOG_ERROR_MESSAGE("Failed to create shader from file '", ShaderCI.FilePath, "'.");
                     Result.store(false);
                 }
+
+                auto& Stats    = m_Statistics.Shaders[ShaderID];
+                Stats.TimeMs   = CompileTimer.GetElapsedTime() * 1000.0;
+                Stats.ThreadId = ThreadId;
             });
         }
 
         for (Uint32 RenderPassID = 0; RenderPassID < ParserInfo.RenderPassCount; ++RenderPassID)
         {
-            EnqueueAsyncWork(m_pThreadPool, [RenderPassID, this, &Result, &RenderPasses](Uint32 ThreadId) {
+            RenderPassIndices.emplace(HashMapStringKey{m_pRSNParser->GetRenderPassByIndex(RenderPassID)->Name, false}, RenderPassID);
+            RenderPassTasks[RenderPassID] = EnqueueAsyncWork(m_pThreadPool, [RenderPassID, this, &Result, &RenderPasses](Uint32 ThreadId) {
+                DILIGENT_TRACE_ZONE("Packager::CreateRenderPass");
                 auto  RPDesc      = *m_pRSNParser->GetRenderPassByIndex(RenderPassID);
                 auto& pRenderPass = RenderPasses[RenderPassID];
                 m_pDevice->CreateRenderPass(RPDesc, &pRenderPass);
@@ -266,7 +652,9 @@ bool RenderStatePackager::Execute(IArchiver* pArchiver, const char* DumpPath)
 
         for (Uint32 SignatureID = 0; SignatureID < ParserInfo.ResourceSignatureCount; ++SignatureID)
         {
-            EnqueueAsyncWork(m_pThreadPool, [&, SignatureID](Uint32 ThreadId) {
+            ResourceSignatureIndices.emplace(HashMapStringKey{m_pRSNParser->GetResourceSignatureByIndex(SignatureID)->Name, false}, SignatureID);
+            ResourceSignatureTasks[SignatureID] = EnqueueAsyncWork(m_pThreadPool, [&, SignatureID](Uint32 ThreadId) {
+                DILIGENT_TRACE_ZONE("Packager::CreateResourceSignature");
                 auto  SignDesc   = *m_pRSNParser->GetResourceSignatureByIndex(SignatureID);
                 auto& pSignature = ResourceSignatures[SignatureID];
                 m_pDevice->CreatePipelineResourceSignature(SignDesc, {m_DeviceFlags}, &pSignature);
@@ -278,31 +666,21 @@ bool RenderStatePackager::Execute(IArchiver* pArchiver, const char* DumpPath)
             });
         }
 
-        m_pThreadPool->WaitForAllTasks();
-
-        if (!Result.load())
-            LOG_ERROR_AND_THROW("Failed to create state objects");
-
-        for (auto& pResource : Shaders)
-            m_Shaders.emplace(HashMapStringKey{pResource->GetDesc().Name, false}, pResource);
-
-        for (auto& pResource : RenderPasses)
-            m_RenderPasses.emplace(HashMapStringKey{pResource->GetDesc().Name, false}, pResource);
-
-        for (auto& pResource : ResourceSignatures)
-            m_ResourceSignatures.emplace(HashMapStringKey{pResource->GetDesc().Name, false}, pResource);
-
         auto FindShader = [&](const char* Name) -> IShader* //
         {
             if (Name == nullptr)
                 return nullptr;
 
-            auto Iter = m_Shaders.find(Name);
-            if (Iter == m_Shaders.end())
+            auto Iter = ShaderIndices.find(Name);
+            if (Iter == ShaderIndices.end())
             {
                 LOG_ERROR_AND_THROW("Unable to find shader '", Name, "'.");
             }
-            return Iter->second;
+
+            auto& pShader = Shaders[Iter->second];
+            if (!pShader)
+                LOG_ERROR_AND_THROW("Shader '", Name, "' failed to compile.");
+            return pShader;
         };
 
         auto FindRenderPass = [&](const char* Name) -> IRenderPass* //
@@ -310,12 +688,16 @@ bool RenderStatePackager::Execute(IArchiver* pArchiver, const char* DumpPath)
             if (Name == nullptr)
                 return nullptr;
 
-            auto Iter = m_RenderPasses.find(Name);
-            if (Iter == m_RenderPasses.end())
+            auto Iter = RenderPassIndices.find(Name);
+            if (Iter == RenderPassIndices.end())
             {
                 LOG_ERROR_AND_THROW("Unable to find render pass '", Name, "'.");
             }
-            return Iter->second;
+
+            auto& pRenderPass = RenderPasses[Iter->second];
+            if (!pRenderPass)
+                LOG_ERROR_AND_THROW("Render pass '", Name, "' failed to be created.");
+            return pRenderPass;
         };
 
         auto FindResourceSignature = [&](const char* Name) -> IPipelineResourceSignature* //
@@ -323,12 +705,80 @@ bool RenderStatePackager::Execute(IArchiver* pArchiver, const char* DumpPath)
             if (Name == nullptr)
                 return nullptr;
 
-            auto Iter = m_ResourceSignatures.find(Name);
-            if (Iter == m_ResourceSignatures.end())
+            auto Iter = ResourceSignatureIndices.find(Name);
+            if (Iter == ResourceSignatureIndices.end())
             {
                 LOG_ERROR_AND_THROW("Unable to find resource signature '", Name, "'.");
             }
-            return Iter->second;
+
+            auto& pSignature = ResourceSignatures[Iter->second];
+            if (!pSignature)
+                LOG_ERROR_AND_THROW("Resource signature '", Name, "' failed to be created.");
+            return pSignature;
+        };
+
+        // Collects the tasks that create the objects referenced by the pipeline.
+        // Unknown names are skipped here and reported by the pipeline task.
+        auto GetPipelineDependencies = [&](const PipelineStateNotation* pDescRSN) //
+        {
+            std::vector<IAsyncTask*> Dependencies;
+
+            auto AddDependency = [&Dependencies](const char* Name, const std::unordered_map<HashMapStringKey, Uint32>& Indices, const std::vector<RefCntAutoPtr<IAsyncTask>>& Tasks) {
+                if (Name == nullptr)
+                    return;
+                auto Iter = Indices.find(Name);
+                if (Iter == Indices.end())
+                    return;
+                IAsyncTask* pTask = Tasks[Iter->second];
+                if (pTask != nullptr && std::find(Dependencies.begin(), Dependencies.end(), pTask) == Dependencies.end())
+                    Dependencies.push_back(pTask);
+            };
+            auto AddShader = [&](const char* Name) { AddDependency(Name, ShaderIndices, ShaderTasks); };
+
+            for (Uint32 SignatureID = 0; SignatureID < pDescRSN->ResourceSignaturesNameCount; ++SignatureID)
+                AddDependency(pDescRSN->ppResourceSignatureNames[SignatureID], ResourceSignatureIndices, ResourceSignatureTasks);
+
+            switch (pDescRSN->PSODesc.PipelineType)
+            {
+                case PIPELINE_TYPE_GRAPHICS:
+                case PIPELINE_TYPE_MESH:
+                {
+                    const auto* pPipelineDescRSN = static_cast<const GraphicsPipelineNotation*>(pDescRSN);
+                    AddDependency(pPipelineDescRSN->pRenderPassName, RenderPassIndices, RenderPassTasks);
+                    for (const auto* Name : {pPipelineDescRSN->pVSName, pPipelineDescRSN->pPSName, pPipelineDescRSN->pDSName, pPipelineDescRSN->pHSName,
+                                             pPipelineDescRSN->pGSName, pPipelineDescRSN->pASName, pPipelineDescRSN->pMSName})
+                        AddShader(Name);
+                    break;
+                }
+                case PIPELINE_TYPE_COMPUTE:
+                    AddShader(static_cast<const ComputePipelineNotation*>(pDescRSN)->pCSName);
+                    break;
+                case PIPELINE_TYPE_TILE:
+                    AddShader(static_cast<const TilePipelineNotation*>(pDescRSN)->pTSName);
+                    break;
+                case PIPELINE_TYPE_RAY_TRACING:
+                {
+                    const auto* pPipelineDescRSN = static_cast<const RayTracingPipelineNotation*>(pDescRSN);
+                    for (Uint32 GroupID = 0; GroupID < pPipelineDescRSN->GeneralShaderCount; ++GroupID)
+                        AddShader(pPipelineDescRSN->pGeneralShaders[GroupID].pShaderName);
+                    for (Uint32 GroupID = 0; GroupID < pPipelineDescRSN->TriangleHitShaderCount; ++GroupID)
+                    {
+                        AddShader(pPipelineDescRSN->pTriangleHitShaders[GroupID].pAnyHitShaderName);
+                        AddShader(pPipelineDescRSN->pTriangleHitShaders[GroupID].pClosestHitShaderName);
+                    }
+                    for (Uint32 GroupID = 0; GroupID < pPipelineDescRSN->ProceduralHitShaderCount; ++GroupID)
+                    {
+                        AddShader(pPipelineDescRSN->pProceduralHitShaders[GroupID].pAnyHitShaderName);
+                        AddShader(pPipelineDescRSN->pProceduralHitShaders[GroupID].pIntersectionShaderName);
+                        AddShader(pPipelineDescRSN->pProceduralHitShaders[GroupID].pClosestHitShaderName);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            return Dependencies;
         };
 
         auto UnpackPipelineStateCreateInfo = [&](DynamicLinearAllocator& Allocator, PipelineStateNotation const& DescRSN, PipelineStateCreateInfo& PipelineCI) //
@@ -343,7 +793,10 @@ bool RenderStatePackager::Execute(IArchiver* pArchiver, const char* DumpPath)
 
         for (Uint32 PipelineID = 0; PipelineID < ParserInfo.PipelineStateCount; ++PipelineID)
         {
-            EnqueueAsyncWork(m_pThreadPool, [&, PipelineID](Uint32 ThreadId) {
+            auto Dependencies = GetPipelineDependencies(m_pRSNParser->GetPipelineStateByIndex(PipelineID));
+            EnqueueAsyncWork(m_pThreadPool, Dependencies.data(), static_cast<Uint32>(Dependencies.size()), [&, PipelineID](Uint32 ThreadId) {
+                DILIGENT_TRACE_ZONE("Packager::CreatePipeline");
+                Timer CreateTimer;
                 try
                 {
                     DynamicLinearAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator()};
@@ -468,6 +921,10 @@ bool RenderStatePackager::Execute(IArchiver* pArchiver, const char* DumpPath)
                 {
                     Result.store(false);
                 }
+
+                auto& Stats    = m_Statistics.Pipelines[PipelineID];
+                Stats.TimeMs   = CreateTimer.GetElapsedTime() * 1000.0;
+                Stats.ThreadId = ThreadId;
             });
         }
 
@@ -475,6 +932,23 @@ bool RenderStatePackager::Execute(IArchiver* pArchiver, const char* DumpPath)
         if (!Result.load())
             LOG_ERROR_AND_THROW("Failed to create state objects");
 
+        for (const auto& ShaderIt : ShaderIndices)
+            m_Shaders.emplace(HashMapStringKey{ShaderIt.first.GetStr(), false}, Shaders[ShaderIt.second]);
+
+        // Keep only the shaders used by this call, so that the cache does not grow over repeated calls
+        m_CompiledShaders.clear();
+        for (const auto& UniqueShader : UniqueShaderIndices)
+        {
+            if (Shaders[UniqueShader.second])
+                m_CompiledShaders.emplace(UniqueShader.first, Shaders[UniqueShader.second]);
+        }
+
+        for (auto& pResource : RenderPasses)
+            m_RenderPasses.emplace(HashMapStringKey{pResource->GetDesc().Name, false}, pResource);
+
+        for (auto& pResource : ResourceSignatures)
+            m_ResourceSignatures.emplace(HashMapStringKey{pResource->GetDesc().Name, false}, pResource);
+
         for (auto& pSignature : ResourceSignatures)
         {
             const auto* SignName = pSignature->GetDesc().Name;
@@ -489,8 +963,38 @@ bool RenderStatePackager::Execute(IArchiver* pArchiver, const char* DumpPath)
             if (!pArchiver->AddPipelineState(pPipeline))
                 LOG_ERROR_AND_THROW("Failed to archive pipeline '", pPipeline->GetDesc().Name, "'.");
 
-        if (DumpPath != nullptr && !BytecodeDumper::Execute(Pipelines, m_DeviceFlags, DumpPath))
+        if (DumpPath != nullptr && !BytecodeDumper::Execute(Pipelines, m_DeviceFlags, DumpPath, m_pThreadPool))
             LOG_ERROR_MESSAGE("Failed to dump shader bytecode");
+
+        // Shaders shared by several pipelines are stored in the archive once, so only unique data is counted
+        for (auto Flags = m_DeviceFlags; Flags != ARCHIVE_DEVICE_DATA_FLAG_NONE;)
+        {
+            const auto DeviceFlag = ExtractLSB(Flags);
+
+            ExecutionStatistics::DeviceInfo DeviceStats;
+            DeviceStats.DeviceFlag = DeviceFlag;
+
+            std::unordered_set<size_t> UniqueShaders;
+            for (auto& pPipeline : Pipelines)
+            {
+                auto pSerializedPSO = pPipeline.Cast<ISerializedPipelineState>(IID_SerializedPipelineState);
+                for (Uint32 ShaderID = 0; ShaderID < pSerializedPSO->GetPatchedShaderCount(DeviceFlag); ++ShaderID)
+                {
+                    const auto  ShaderCI   = pSerializedPSO->GetPatchedShaderCreateInfo(DeviceFlag, ShaderID);
+                    const auto* pData      = ShaderCI.ByteCode != nullptr ? static_cast<const char*>(ShaderCI.ByteCode) : ShaderCI.Source;
+                    const auto  DataSize   = ShaderCI.ByteCode != nullptr ? ShaderCI.ByteCodeSize : ShaderCI.SourceLength;
+                    const auto  ShaderHash = std::hash<std::string>{}(std::string{pData, pData + DataSize});
+                    if (UniqueShaders.insert(ShaderHash).second)
+                    {
+                        ++DeviceStats.ShaderCount;
+                        DeviceStats.ShaderDataSize += DataSize;
+                    }
+                }
+            }
+            m_Statistics.Devices.push_back(DeviceStats);
+        }
+
+        m_Statistics.TotalTimeMs = ExecutionTimer.GetElapsedTime() * 1000.0;
     }
     catch (...)
     {
@@ -499,12 +1003,168 @@ bool RenderStatePackager::Execute(IArchiver* pArchiver, const char* DumpPath)
     return true;
 }
 
+bool RenderStatePackager::WriteReport(const char* FilePath, size_t ArchiveSize, bool BuildCacheHit) const
+{
+    DEV_CHECK_ERR(FilePath != nullptr, "FilePath must not be null");
+
+    try
+    {
+        nlohmann::json Report;
+        Report["ArchiveSize"]       = ArchiveSize;
+        Report["BuildCacheHit"]     = BuildCacheHit;
+        Report["TotalTimeMs"]       = m_Statistics.TotalTimeMs;
+        Report["SharedShaderCount"] = std::count_if(m_Statistics.Shaders.begin(), m_Statistics.Shaders.end(), [](const ExecutionStatistics::ObjectInfo& Shader) { return !Shader.SharedWith.empty(); });
+
+        auto WriteObjects = [](const std::vector<ExecutionStatistics::ObjectInfo>& Objects, const char* TimeKey) {
+            // Slowest objects first
+            std::vector<const ExecutionStatistics::ObjectInfo*> SortedObjects;
+            for (const auto& Object : Objects)
+                SortedObjects.push_back(&Object);
+            std::stable_sort(SortedObjects.begin(), SortedObjects.end(), [](const ExecutionStatistics::ObjectInfo* pLHS, const ExecutionStatistics::ObjectInfo* pRHS) {
+                return pLHS->TimeMs > pRHS->TimeMs;
+            });
+
+            nlohmann::json Json = nlohmann::json::array();
+            for (const auto* pObject : SortedObjects)
+            {
+                nlohmann::json Object;
+                Object["Name"] = pObject->Name;
+                if (!pObject->SharedWith.empty())
+                {
+                    Object["SharedWith"] = pObject->SharedWith;
+                }
+                else if (pObject->IsCached)
+                {
+                    Object["Cached"] = true;
+                }
+                else
+                {
+                    Object[TimeKey]    = pObject->TimeMs;
+                    Object["ThreadId"] = pObject->ThreadId;
+                }
+                Json.push_back(std::move(Object));
+            }
+            return Json;
+        };
+
+        Report["Shaders"]   = WriteObjects(m_Statistics.Shaders, "CompileTimeMs");
+        Report["Pipelines"] = WriteObjects(m_Statistics.Pipelines, "CreateTimeMs");
+
+        // Busy time of every worker thread relative to the total execution time
+        std::vector<double> ThreadBusyTime;
+        for (const auto* pObjects : {&m_Statistics.Shaders, &m_Statistics.Pipelines})
+        {
+            for (const auto& Object : *pObjects)
+            {
+                if (!Object.SharedWith.empty() || Object.IsCached)
+                    continue;
+                if (Object.ThreadId >= ThreadBusyTime.size())
+                    ThreadBusyTime.resize(Object.ThreadId + 1);
+                ThreadBusyTime[Object.ThreadId] += Object.TimeMs;
+            }
+        }
+
+        nlohmann::json Threads = nlohmann::json::array();
+        for (size_t ThreadId = 0; ThreadId < ThreadBusyTime.size(); ++ThreadId)
+        {
+            nlohmann::json Thread;
+            Thread["ThreadId"]    = ThreadId;
+            Thread["BusyTimeMs"]  = ThreadBusyTime[ThreadId];
+            Thread["Utilization"] = m_Statistics.TotalTimeMs > 0 ? ThreadBusyTime[ThreadId] / m_Statistics.TotalTimeMs : 0.0;
+            Threads.push_back(std::move(Thread));
+        }
+        Report["Threads"] = std::move(Threads);
+
+        nlohmann::json Devices = nlohmann::json::array();
+        for (const auto& DeviceStats : m_Statistics.Devices)
+        {
+            nlohmann::json Device;
+            Device["Device"]         = GetArchiveDeviceDataFlagString(DeviceStats.DeviceFlag);
+            Device["ShaderCount"]    = DeviceStats.ShaderCount;
+            Device["ShaderDataSize"] = DeviceStats.ShaderDataSize;
+            Devices.push_back(std::move(Device));
+        }
+        Report["Devices"] = std::move(Devices);
+
+        FileWrapper File{FilePath, EFileAccessMode::Overwrite};
+        if (!File)
+            LOG_ERROR_AND_THROW("Failed to open file: '", FilePath, "'.");
+
+        const auto ReportString = Report.dump(4);
+        File->Write(ReportString.data(), ReportString.size());
+    }
+    catch (...)
+    {
+        return false;
+    }
+    return true;
+}
+
+RefCntAutoPtr<IDataBlob> RenderStatePackager::BuildCompressionDictionary(const std::vector<const IDataBlob*>& Archives, size_t MaxSize)
+{
+    constexpr size_t SegmentSize = 64;
+    constexpr size_t SegmentStep = 16;
+
+    struct SegmentInfo
+    {
+        const char* pData        = nullptr;
+        Uint32      Count        = 0;
+        Uint32      ArchiveCount = 0;
+        size_t      LastArchive  = ~size_t{0};
+    };
+    std::unordered_map<size_t, SegmentInfo> Segments;
+
+    for (size_t ArchiveIdx = 0; ArchiveIdx < Archives.size(); ++ArchiveIdx)
+    {
+        const auto* pData = static_cast<const char*>(Archives[ArchiveIdx]->GetConstDataPtr());
+        const auto  Size  = Archives[ArchiveIdx]->GetSize();
+        for (size_t Offset = 0; Offset + SegmentSize <= Size; Offset += SegmentStep)
+        {
+            auto& Segment = Segments[std::hash<std::string>{}(std::string{pData + Offset, pData + Offset + SegmentSize})];
+            if (Segment.pData == nullptr)
+                Segment.pData = pData + Offset;
+            ++Segment.Count;
+            if (Segment.LastArchive != ArchiveIdx)
+            {
+                Segment.LastArchive = ArchiveIdx;
+                ++Segment.ArchiveCount;
+            }
+        }
+    }
+
+    // Only the data that occurs in more than one archive helps compressing them independently
+    std::vector<const SegmentInfo*> SharedSegments;
+    for (const auto& Segment : Segments)
+    {
+        if (Segment.second.ArchiveCount > 1)
+            SharedSegments.push_back(&Segment.second);
+    }
+    if (SharedSegments.empty())
+        return {};
+
+    std::sort(SharedSegments.begin(), SharedSegments.end(), [](const SegmentInfo* pLHS, const SegmentInfo* pRHS) {
+        return pLHS->Count != pRHS->Count ? pLHS->Count > pRHS->Count : std::less<const char*>{}(pLHS->pData, pRHS->pData);
+    });
+
+    const auto NumSegments = std::min(SharedSegments.size(), MaxSize / SegmentSize);
+    auto       pDictionary = DataBlobImpl::Create(NumSegments * SegmentSize);
+    auto*      pDst        = static_cast<char*>(pDictionary->GetDataPtr());
+    for (size_t i = 0; i < NumSegments; ++i)
+    {
+        // The most frequent segment goes to the end of the dictionary
+        memcpy(pDst + (NumSegments - 1 - i) * SegmentSize, SharedSegments[i]->pData, SegmentSize);
+    }
+
+    return RefCntAutoPtr<IDataBlob>{pDictionary};
+}
+
 void RenderStatePackager::Reset()
 {
     m_pRSNParser.Release();
     m_RenderPasses.clear();
     m_Shaders.clear();
     m_ResourceSignatures.clear();
+    m_Statistics = {};
 }
 
 } // namespace Diligent
@@ -24,13 +24,70 @@
  *  of the possibility of such damages.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <utility>
+
 #include "FileWrapper.hpp"
+#include "FileSystem.hpp"
+#include "DataBlobImpl.hpp"
+#include "HashUtils.hpp"
+#include "PlatformMisc.hpp"
+#include "BasicMath.hpp"
+#include "GraphicsAccessories.hpp"
+#include "Timer.hpp"
+#include "json.hpp"
 #include "RenderStateNotationParser.h"
+#include "RenderStateNotationLoader.h"
 #include "ParsingEnvironment.hpp"
+#include "ArchiveChunkHash.hpp"
+#include "FileWatcher.hpp"
 #include "args.hxx"
 
 using namespace Diligent;
 
+constexpr std::pair<const char*, ARCHIVE_DEVICE_DATA_FLAGS> DeviceFlagNames[] = {
+    {"dx11", ARCHIVE_DEVICE_DATA_FLAG_D3D11},
+    {"dx12", ARCHIVE_DEVICE_DATA_FLAG_D3D12},
+    {"vulkan", ARCHIVE_DEVICE_DATA_FLAG_VULKAN},
+    {"opengl", ARCHIVE_DEVICE_DATA_FLAG_GL},
+    {"opengles", ARCHIVE_DEVICE_DATA_FLAG_GLES},
+    {"metal_macos", ARCHIVE_DEVICE_DATA_FLAG_METAL_MACOS},
+    {"metal_ios", ARCHIVE_DEVICE_DATA_FLAG_METAL_IOS},
+};
+
+// Editors often save a file in several steps, so changes are collected for a while before rebuilding
+constexpr Uint32 WatchDebounceTimeMs = 200;
+constexpr Uint32 WatchPollIntervalMs = 100;
+
+const char* GetDeviceFlagName(ARCHIVE_DEVICE_DATA_FLAGS DeviceFlag)
+{
+    for (const auto& FlagName : DeviceFlagNames)
+    {
+        if (FlagName.second == DeviceFlag)
+            return FlagName.first;
+    }
+    UNEXPECTED("Unexpected device flag");
+    return "";
+}
+
+ARCHIVE_DEVICE_DATA_FLAGS GetDeviceFlagFromName(const std::string& Name)
+{
+    for (const auto& FlagName : DeviceFlagNames)
+    {
+        if (Name == FlagName.first)
+            return FlagName.second;
+    }
+    return ARCHIVE_DEVICE_DATA_FLAG_NONE;
+}
+
 enum class ParseStatus
 {
     Success,
@@ -45,13 +102,19 @@ ParseStatus ParseCommandLine(int argc, char* argv[], ParsingEnvironmentCreateInf
 
     args::ValueFlagList<std::string> ArgumentShaderDirs{Parser, "dir", "Shader directory", {'s', "shader_dir"}, {}};
     args::ValueFlagList<std::string> ArgumentRenderStateDirs{Parser, "dir", "Render state directory", {'r', "render_state_dir"}, {}};
-    args::ValueFlagList<std::string> ArgumentInputs{Parser, "path", "Input render state notation files", {'i', "input"}, {}, args::Options::Required};
+    args::ValueFlagList<std::string> ArgumentInputs{Parser, "path", "Input render state notation files", {'i', "input"}, {}};
     args::ValueFlag<std::string>     ArgumentDeviceConfig{Parser, "path", "Path to the config file", {'c', "config"}, ""};
     args::ValueFlag<std::string>     ArgumentOutput{Parser, "path", "Output binary archive", {'o', "output"}, "Archive.bin"};
     args::ValueFlag<std::string>     ArgumentDumpBytecode{Parser, "dir", "Dump bytecode directory", {'d', "dump_dir"}, ""};
     args::ValueFlag<Uint32>          ArgumentThreadCount{Parser, "count", "Count of threads", {'t', "thread"}, 0};
+    args::ValueFlag<std::string>     ArgumentPrecompiled{Parser, "path", "Output precompiled render state notation", {'p', "precompiled_output"}, ""};
+    args::ValueFlag<std::string>     ArgumentBuildCache{Parser, "dir", "Build cache directory", {'b', "build_cache_dir"}, ""};
+    args::ValueFlag<Uint32>          ArgumentProcessCount{Parser, "count", "Count of worker processes", {'j', "processes"}, 0};
+    args::ValueFlagList<std::string> ArgumentMerge{Parser, "device=path", "Per-device archive to merge", {'m', "merge"}, {}};
+    args::ValueFlag<std::string>     ArgumentReport{Parser, "path", "Output JSON build report", {"report"}, ""};
+    args::ValueFlag<Uint32>          ArgumentCompress{Parser, "level", "Compress the output with the given level (1-9)", {'z', "compress"}, 0};
 
-    args::Group GroupDeviceFlags{Parser, "Device Flags:", args::Group::Validators::AtLeastOne};
+    args::Group GroupDeviceFlags{Parser, "Device Flags:", args::Group::Validators::DontCare};
     args::Flag  ArgumentDeviceFlagDx11{GroupDeviceFlags, "dx11", "D3D11", {"dx11"}};
     args::Flag  ArgumentDeviceFlagDx12{GroupDeviceFlags, "dx12", "D3D12", {"dx12"}};
     args::Flag  ArgumentDeviceFlagVulkan{GroupDeviceFlags, "vulkan", "Vulkan", {"vulkan"}};
@@ -63,6 +126,10 @@ ParseStatus ParseCommandLine(int argc, char* argv[], ParsingEnvironmentCreateInf
     args::Group ArchiveDeviceFlags{Parser, "Archive Flags:", args::Group::Validators::DontCare};
     args::Flag  ArgumentArchiveFlagStrip{ArchiveDeviceFlags, "strip_reflection", "Strip shader reflection", {"strip_reflection"}};
     args::Flag  ArgumentArchiveFlagPrint{ArchiveDeviceFlags, "print_contents", "Print the archive contents", {"print_contents"}};
+    args::Flag  ArgumentArchiveSplitByDevice{ArchiveDeviceFlags, "split_by_device", "Write a separate archive for every device", {"split_by_device"}};
+    args::Flag  ArgumentArchiveSplitByInput{ArchiveDeviceFlags, "split_by_input", "Write a separate archive for every input file", {"split_by_input"}};
+    args::Flag  ArgumentContentAddressed{ArchiveDeviceFlags, "content_addressed", "Name archive chunks by the hash of their contents", {"content_addressed"}};
+    args::Flag  ArgumentWatch{ArchiveDeviceFlags, "watch", "Rebuild the archive when the input files change", {"watch"}};
 
     try
     {
@@ -100,7 +167,39 @@ ParseStatus ParseCommandLine(int argc, char* argv[], ParsingEnvironmentCreateInf
         return DeviceFlags;
     };
 
-    CreateInfo.DeviceFlags = GetDeviceFlagsFromParser();
+    CreateInfo.DeviceFlags       = GetDeviceFlagsFromParser();
+    CreateInfo.MergeArchivePaths = args::get(ArgumentMerge);
+
+    if (CreateInfo.MergeArchivePaths.empty())
+    {
+        if (CreateInfo.DeviceFlags == ARCHIVE_DEVICE_DATA_FLAG_NONE)
+        {
+            LOG_ERROR_MESSAGE("At least one device flag is required");
+            LOG_INFO_MESSAGE(Parser.Help());
+            return ParseStatus::Failed;
+        }
+        if (!ArgumentInputs)
+        {
+            LOG_ERROR_MESSAGE("At least one input file is required");
+            LOG_INFO_MESSAGE(Parser.Help());
+            return ParseStatus::Failed;
+        }
+    }
+    else
+    {
+        // In merge mode, device flags are taken from the merged archives
+        for (const auto& MergeArg : CreateInfo.MergeArchivePaths)
+        {
+            const auto Separator  = MergeArg.find('=');
+            const auto DeviceFlag = Separator != std::string::npos ? GetDeviceFlagFromName(MergeArg.substr(0, Separator)) : ARCHIVE_DEVICE_DATA_FLAG_NONE;
+            if (DeviceFlag == ARCHIVE_DEVICE_DATA_FLAG_NONE)
+            {
+                LOG_ERROR_MESSAGE("Invalid merge argument '", MergeArg, "'. Expected <device>=<path>, for example vulkan=Archive_vk.bin");
+                return ParseStatus::Failed;
+            }
+            CreateInfo.DeviceFlags |= DeviceFlag;
+        }
+    }
     if (ArgumentArchiveFlagStrip)
         CreateInfo.PSOArchiveFlags |= PSO_ARCHIVE_FLAG_STRIP_REFLECTION;
 
@@ -111,6 +210,10 @@ ParseStatus ParseCommandLine(int argc, char* argv[], ParsingEnvironmentCreateInf
     CreateInfo.PSOArchiveFlags |= PSO_ARCHIVE_FLAG_DO_NOT_PACK_SIGNATURES;
 
     CreateInfo.PrintArchiveContents = args::get(ArgumentArchiveFlagPrint);
+    CreateInfo.SplitArchiveByDevice = args::get(ArgumentArchiveSplitByDevice);
+    CreateInfo.SplitArchiveByInput  = args::get(ArgumentArchiveSplitByInput);
+    CreateInfo.ContentAddressed     = args::get(ArgumentContentAddressed);
+    CreateInfo.Watch                = args::get(ArgumentWatch);
     CreateInfo.ShaderDirs           = args::get(ArgumentShaderDirs);
     CreateInfo.RenderStateDirs      = args::get(ArgumentRenderStateDirs);
     CreateInfo.ConfigFilePath       = args::get(ArgumentDeviceConfig);
@@ -118,10 +221,576 @@ ParseStatus ParseCommandLine(int argc, char* argv[], ParsingEnvironmentCreateInf
     CreateInfo.InputFilePaths       = args::get(ArgumentInputs);
     CreateInfo.DumpBytecodeDir      = args::get(ArgumentDumpBytecode);
     CreateInfo.ThreadCount          = args::get(ArgumentThreadCount);
+    CreateInfo.PrecompiledFilePath  = args::get(ArgumentPrecompiled);
+    CreateInfo.BuildCacheDir        = args::get(ArgumentBuildCache);
+    CreateInfo.ProcessCount         = args::get(ArgumentProcessCount);
+    CreateInfo.ReportFilePath       = args::get(ArgumentReport);
+    CreateInfo.CompressionLevel     = args::get(ArgumentCompress);
+
+    // Content-addressed chunks are only useful when they are small, so they are split both ways
+    if (CreateInfo.ContentAddressed)
+    {
+        CreateInfo.SplitArchiveByDevice = true;
+        CreateInfo.SplitArchiveByInput  = true;
+    }
 
     return ParseStatus::Success;
 }
 
+bool WriteFile(const std::string& FilePath, const IDataBlob* pData)
+{
+    FileWrapper File{FilePath.c_str(), EFileAccessMode::Overwrite};
+    if (!File)
+    {
+        LOG_ERROR_MESSAGE("Failed to open file: '", FilePath, "'.");
+        return false;
+    }
+    return File->Write(pData->GetConstDataPtr(), pData->GetSize());
+}
+
+// Returns the path of the cached archive for the current inputs, or an empty string
+// if the hash could not be computed.
+std::string GetCachedArchivePath(const ParsingEnvironmentCreateInfo& EnvironmentCI, const RenderStatePackager& Packager)
+{
+    size_t Hash = 0;
+    if (!Packager.ComputeContentHash(EnvironmentCI.InputFilePaths, Hash))
+        return {};
+
+    // The device configuration affects compiler options for all backends
+    if (!EnvironmentCI.ConfigFilePath.empty())
+    {
+        FileWrapper File{EnvironmentCI.ConfigFilePath.c_str(), EFileAccessMode::Read};
+        if (!File)
+            return {};
+
+        auto pFileData = DataBlobImpl::Create(0);
+        File->Read(pFileData);
+        const auto* pData = static_cast<const char*>(pFileData->GetConstDataPtr());
+        HashCombine(Hash, std::string{pData, pData + pFileData->GetSize()});
+    }
+
+    std::stringstream Stream;
+    Stream << EnvironmentCI.BuildCacheDir << FileSystem::SlashSymbol << "Archive_" << std::hex << std::setw(sizeof(Hash) * 2) << std::setfill('0') << Hash << ".bin";
+    return Stream.str();
+}
+
+RefCntAutoPtr<IDataBlob> ReadFile(const std::string& FilePath)
+{
+    FileWrapper File{FilePath.c_str(), EFileAccessMode::Read};
+    if (!File)
+    {
+        LOG_ERROR_MESSAGE("Failed to open file: '", FilePath, "'.");
+        return {};
+    }
+
+    auto pFileData = DataBlobImpl::Create(0);
+    File->Read(pFileData);
+    return RefCntAutoPtr<IDataBlob>{pFileData};
+}
+
+// Combines archives that each contain the data for a single device into one archive.
+// All archives must be produced from the same render state notation files.
+RefCntAutoPtr<IDataBlob> MergeDeviceArchives(IArchiverFactory* pArchiverFactory, const std::vector<std::pair<ARCHIVE_DEVICE_DATA_FLAGS, std::string>>& DeviceArchives)
+{
+    RefCntAutoPtr<IDataBlob> pMergedData;
+    for (const auto& DeviceArchive : DeviceArchives)
+    {
+        auto pDeviceData = ReadFile(DeviceArchive.second);
+        if (!pDeviceData)
+            return {};
+
+        if (!pMergedData)
+        {
+            pMergedData = std::move(pDeviceData);
+            continue;
+        }
+
+        RefCntAutoPtr<IDataBlob> pDstData;
+        if (!pArchiverFactory->AppendDeviceData(pMergedData, DeviceArchive.first, pDeviceData, &pDstData) || !pDstData)
+        {
+            LOG_ERROR_MESSAGE("Failed to append ", GetDeviceFlagName(DeviceArchive.first), " device data from archive '", DeviceArchive.second, "'.");
+            return {};
+        }
+        pMergedData = std::move(pDstData);
+    }
+    return pMergedData;
+}
+
+std::string QuoteArgument(const std::string& Arg)
+{
+    std::string Quoted = "\"";
+    for (auto c : Arg)
+    {
+        if (c == '"')
+            Quoted += '\\';
+        Quoted += c;
+    }
+    Quoted += '"';
+    return Quoted;
+}
+
+// Packages every device in a separate worker process that runs this executable,
+// and merges the per-device archives. At most ProcessCount workers run at a time.
+RefCntAutoPtr<IDataBlob> PackageInWorkerProcesses(const char*                         ExecutablePath,
+                                                  const ParsingEnvironmentCreateInfo& EnvironmentCI,
+                                                  ARCHIVE_DEVICE_DATA_FLAGS           DeviceFlags,
+                                                  IArchiverFactory*                   pArchiverFactory)
+{
+    std::vector<std::pair<ARCHIVE_DEVICE_DATA_FLAGS, std::string>> DeviceArchives;
+    while (DeviceFlags != ARCHIVE_DEVICE_DATA_FLAG_NONE)
+    {
+        const auto DeviceFlag = ExtractLSB(DeviceFlags);
+        DeviceArchives.emplace_back(DeviceFlag, EnvironmentCI.OuputFilePath + "." + GetDeviceFlagName(DeviceFlag) + ".part");
+    }
+
+    std::vector<std::string> Commands;
+    for (const auto& DeviceArchive : DeviceArchives)
+    {
+        std::stringstream Cmd;
+        Cmd << QuoteArgument(ExecutablePath);
+        for (const auto& Dir : EnvironmentCI.ShaderDirs)
+            Cmd << " -s " << QuoteArgument(Dir);
+        for (const auto& Dir : EnvironmentCI.RenderStateDirs)
+            Cmd << " -r " << QuoteArgument(Dir);
+        for (const auto& Input : EnvironmentCI.InputFilePaths)
+            Cmd << " -i " << QuoteArgument(Input);
+        if (!EnvironmentCI.ConfigFilePath.empty())
+            Cmd << " -c " << QuoteArgument(EnvironmentCI.ConfigFilePath);
+        if (!EnvironmentCI.DumpBytecodeDir.empty())
+            Cmd << " -d " << QuoteArgument(EnvironmentCI.DumpBytecodeDir);
+        if (EnvironmentCI.ThreadCount != 0)
+            Cmd << " -t " << EnvironmentCI.ThreadCount;
+        if (EnvironmentCI.PSOArchiveFlags & PSO_ARCHIVE_FLAG_STRIP_REFLECTION)
+            Cmd << " --strip_reflection";
+        Cmd << " -o " << QuoteArgument(DeviceArchive.second) << " --" << GetDeviceFlagName(DeviceArchive.first);
+
+#if PLATFORM_WIN32
+        // cmd.exe strips the outermost quotes when the command line starts with a quote
+        Commands.emplace_back("\"" + Cmd.str() + "\"");
+#else
+        Commands.emplace_back(Cmd.str());
+#endif
+    }
+
+    std::atomic<size_t> NextCommand{0};
+    std::atomic<bool>   Result{true};
+
+    auto RunCommands = [&]() {
+        for (auto CmdId = NextCommand.fetch_add(1); CmdId < Commands.size(); CmdId = NextCommand.fetch_add(1))
+        {
+            if (std::system(Commands[CmdId].c_str()) != 0)
+            {
+                LOG_ERROR_MESSAGE("Worker process failed to package ", GetDeviceFlagName(DeviceArchives[CmdId].first), " device data");
+                Result.store(false);
+            }
+        }
+    };
+
+    std::vector<std::thread> Workers(std::min<size_t>(EnvironmentCI.ProcessCount, Commands.size()));
+    for (auto& Worker : Workers)
+        Worker = std::thread{RunCommands};
+    for (auto& Worker : Workers)
+        Worker.join();
+
+    RefCntAutoPtr<IDataBlob> pData;
+    if (Result.load())
+        pData = MergeDeviceArchives(pArchiverFactory, DeviceArchives);
+
+    for (const auto& DeviceArchive : DeviceArchives)
+        std::remove(DeviceArchive.second.c_str());
+
+    return pData;
+}
+
+// Parses the inputs of EnvironmentCI and builds the archive, reusing the build cache when possible.
+// The archive is not written to the output file.
+RefCntAutoPtr<IDataBlob> BuildArchive(const ParsingEnvironmentCreateInfo& EnvironmentCI, ParsingEnvironment& Environment, const char* ExecutablePath)
+{
+    auto  pArchiveFactory = Environment.GetArchiverFactory();
+    auto& Packager        = Environment.GetPackager();
+
+    Packager.Reset();
+    if (!Packager.ParseFiles(EnvironmentCI.InputFilePaths))
+    {
+        LOG_ERROR_MESSAGE("Failed to parse files");
+        return {};
+    }
+
+    std::string CachedArchivePath;
+    if (!EnvironmentCI.BuildCacheDir.empty())
+    {
+        CachedArchivePath = GetCachedArchivePath(EnvironmentCI, Packager);
+        if (CachedArchivePath.empty())
+        {
+            LOG_WARNING_MESSAGE("Failed to compute the build cache key. The archive will be rebuilt.");
+        }
+        else if (FileSystem::FileExists(CachedArchivePath.c_str()))
+        {
+            FileWrapper CachedFile{CachedArchivePath.c_str(), EFileAccessMode::Read};
+            if (CachedFile)
+            {
+                auto pCachedData = DataBlobImpl::Create(0);
+                CachedFile->Read(pCachedData);
+                CachedFile.Close();
+
+                if (pCachedData->GetSize() > 0)
+                {
+                    LOG_INFO_MESSAGE("Inputs are unchanged, using cached archive '", CachedArchivePath, "'.");
+
+                    if (!EnvironmentCI.ReportFilePath.empty() && !Packager.WriteReport(EnvironmentCI.ReportFilePath.c_str(), pCachedData->GetSize(), true))
+                        LOG_WARNING_MESSAGE("Failed to write the build report.");
+
+                    return RefCntAutoPtr<IDataBlob>{pCachedData};
+                }
+            }
+            LOG_WARNING_MESSAGE("Failed to read cached archive '", CachedArchivePath, "'. The archive will be rebuilt.");
+        }
+    }
+
+    RefCntAutoPtr<IDataBlob> pData;
+    if (EnvironmentCI.ProcessCount > 1 && PlatformMisc::CountOneBits(static_cast<Uint32>(Packager.GetDeviceFlags())) > 1)
+    {
+        pData = PackageInWorkerProcesses(ExecutablePath, EnvironmentCI, Packager.GetDeviceFlags(), pArchiveFactory);
+        if (!pData)
+        {
+            LOG_ERROR_MESSAGE("Failed to create the archive in worker processes");
+            return {};
+        }
+    }
+    else
+    {
+        RefCntAutoPtr<IArchiver> pArchiver;
+        pArchiveFactory->CreateArchiver(Environment.GetSerializationDevice(), &pArchiver);
+        DEV_CHECK_ERR(pArchiver != nullptr, "pArchive must not be null");
+
+        if (!Packager.Execute(pArchiver, EnvironmentCI.DumpBytecodeDir.empty() ? nullptr : EnvironmentCI.DumpBytecodeDir.c_str()))
+        {
+            LOG_ERROR_MESSAGE("Failed to create the archive");
+            return {};
+        }
+
+        if (!pArchiver->SerializeToBlob(&pData))
+        {
+            LOG_ERROR_MESSAGE("Failed to serialize to Data Blob");
+            return {};
+        }
+    }
+
+    if (!CachedArchivePath.empty())
+    {
+        FileSystem::CreateDirectory(EnvironmentCI.BuildCacheDir.c_str());
+        if (!WriteFile(CachedArchivePath, pData))
+            LOG_WARNING_MESSAGE("Failed to store the archive in the build cache.");
+    }
+
+    if (!EnvironmentCI.ReportFilePath.empty() && !Packager.WriteReport(EnvironmentCI.ReportFilePath.c_str(), pData->GetSize(), false))
+        LOG_WARNING_MESSAGE("Failed to write the build report.");
+
+    return pData;
+}
+
+// Returns the path without the extension of the file name, e.g. "Data/Archive" for "Data/Archive.bin"
+std::string RemoveExtension(const std::string& Path)
+{
+    const auto DotPos   = Path.find_last_of('.');
+    const auto SlashPos = Path.find_last_of("/\\");
+    return DotPos != std::string::npos && (SlashPos == std::string::npos || DotPos > SlashPos) ? Path.substr(0, DotPos) : Path;
+}
+
+// Writes archive chunks split by input file and/or by device and the index that lists them.
+// Chunk paths in the index are relative to the index file.
+// Content-addressed chunks are named by the hash of their data and are listed in the index sorted
+// by group and device, so that an unchanged chunk keeps its file and its place in the index.
+bool WriteSplitArchive(const ParsingEnvironmentCreateInfo& EnvironmentCI, ParsingEnvironment& Environment, const char* ExecutablePath)
+{
+    auto  pArchiveFactory = Environment.GetArchiverFactory();
+    auto& Packager        = Environment.GetPackager();
+
+    const auto OutputStem = RemoveExtension(EnvironmentCI.OuputFilePath);
+
+    std::string OutputDir;
+    FileSystem::GetPathComponents(EnvironmentCI.OuputFilePath, &OutputDir, nullptr);
+
+    // Every input file is a separate group. Without splitting by input, all inputs form a single group.
+    std::vector<std::pair<std::string, std::vector<std::string>>> Groups;
+    if (EnvironmentCI.SplitArchiveByInput)
+    {
+        for (const auto& Input : EnvironmentCI.InputFilePaths)
+        {
+            std::string FileName;
+            FileSystem::GetPathComponents(Input, nullptr, &FileName);
+            Groups.emplace_back(RemoveExtension(FileName), std::vector<std::string>{Input});
+        }
+    }
+    else
+    {
+        Groups.emplace_back("", EnvironmentCI.InputFilePaths);
+    }
+
+    struct ArchiveChunk
+    {
+        RefCntAutoPtr<IDataBlob> pData;
+        std::string              Path;
+        nlohmann::json           Info;
+    };
+    std::vector<ArchiveChunk> Chunks;
+    for (const auto& Group : Groups)
+    {
+        auto GroupCI           = EnvironmentCI;
+        GroupCI.InputFilePaths = Group.second;
+        GroupCI.OuputFilePath  = Group.first.empty() ? OutputStem : OutputStem + "." + Group.first;
+        if (!GroupCI.ReportFilePath.empty() && !Group.first.empty())
+            GroupCI.ReportFilePath = RemoveExtension(EnvironmentCI.ReportFilePath) + "." + Group.first + ".json";
+
+        auto pData = BuildArchive(GroupCI, Environment, ExecutablePath);
+        if (!pData)
+            return false;
+
+        nlohmann::json Pipelines = nlohmann::json::array();
+        const auto*    pParser   = Packager.GetParser();
+        for (Uint32 PipelineID = 0; PipelineID < pParser->GetInfo().PipelineStateCount; ++PipelineID)
+            Pipelines.push_back(pParser->GetPipelineStateByIndex(PipelineID)->PSODesc.Name);
+
+        auto AddChunk = [&](IDataBlob* pChunkData, const std::string& ChunkPath, const char* DeviceName) {
+            std::string ChunkFileName;
+            FileSystem::GetPathComponents(ChunkPath, nullptr, &ChunkFileName);
+
+            nlohmann::json Chunk;
+            Chunk["Path"]      = ChunkFileName;
+            Chunk["Group"]     = Group.first;
+            Chunk["Device"]    = DeviceName;
+            Chunk["Pipelines"] = Pipelines;
+            Chunks.push_back(ArchiveChunk{RefCntAutoPtr<IDataBlob>{pChunkData}, ChunkPath, std::move(Chunk)});
+        };
+
+        if (EnvironmentCI.SplitArchiveByDevice)
+        {
+            const auto AllDeviceFlags = Packager.GetDeviceFlags();
+            for (auto DeviceFlags = AllDeviceFlags; DeviceFlags != ARCHIVE_DEVICE_DATA_FLAG_NONE;)
+            {
+                const auto DeviceFlag = ExtractLSB(DeviceFlags);
+
+                RefCntAutoPtr<IDataBlob> pDeviceData;
+                if (AllDeviceFlags == DeviceFlag)
+                    pDeviceData = pData;
+                else if (!pArchiveFactory->RemoveDeviceData(pData, AllDeviceFlags & ~DeviceFlag, &pDeviceData) || !pDeviceData)
+                {
+                    LOG_ERROR_MESSAGE("Failed to extract ", GetDeviceFlagName(DeviceFlag), " device data");
+                    return false;
+                }
+
+                AddChunk(pDeviceData, GroupCI.OuputFilePath + "." + GetDeviceFlagName(DeviceFlag) + ".bin", GetArchiveDeviceDataFlagString(DeviceFlag));
+            }
+        }
+        else
+        {
+            AddChunk(pData, GroupCI.OuputFilePath + ".bin", "");
+        }
+    }
+
+    if (EnvironmentCI.ContentAddressed)
+    {
+        std::stable_sort(Chunks.begin(), Chunks.end(), [](const ArchiveChunk& lhs, const ArchiveChunk& rhs) {
+            const auto& LhsGroup = lhs.Info["Group"].get_ref<const std::string&>();
+            const auto& RhsGroup = rhs.Info["Group"].get_ref<const std::string&>();
+            if (LhsGroup != RhsGroup)
+                return LhsGroup < RhsGroup;
+            return lhs.Info["Device"].get_ref<const std::string&>() < rhs.Info["Device"].get_ref<const std::string&>();
+        });
+    }
+
+    nlohmann::json Index;
+
+    // A dictionary built from the data the chunks have in common compensates for
+    // compressing every chunk independently. The dictionary depends on all chunks,
+    // so it is not used for content-addressed chunks: a change in one chunk would
+    // change the compressed data of every other chunk.
+    RefCntAutoPtr<IDataBlob> pDictionary;
+    if (EnvironmentCI.CompressionLevel != 0 && Chunks.size() > 1 && !EnvironmentCI.ContentAddressed)
+    {
+        std::vector<const IDataBlob*> ChunkData;
+        for (const auto& Chunk : Chunks)
+            ChunkData.push_back(Chunk.pData);
+
+        pDictionary = RenderStatePackager::BuildCompressionDictionary(ChunkData);
+        if (pDictionary)
+        {
+            const auto DictionaryPath = OutputStem + ".dict";
+            if (!WriteFile(DictionaryPath, pDictionary))
+                return false;
+
+            std::string DictionaryFileName;
+            FileSystem::GetPathComponents(DictionaryPath, nullptr, &DictionaryFileName);
+            Index["Dictionary"] = DictionaryFileName;
+        }
+    }
+
+    nlohmann::json ChunkInfos = nlohmann::json::array();
+    for (auto& Chunk : Chunks)
+    {
+        if (EnvironmentCI.PrintArchiveContents)
+            pArchiveFactory->PrintArchiveContent(Chunk.pData);
+
+        Chunk.Info["UncompressedSize"] = Chunk.pData->GetSize();
+        if (EnvironmentCI.CompressionLevel != 0)
+        {
+            RefCntAutoPtr<IDataBlob> pCompressed;
+            CompressRenderStateArchive(Chunk.pData, pDictionary, EnvironmentCI.CompressionLevel, &pCompressed);
+            if (!pCompressed)
+            {
+                LOG_ERROR_MESSAGE("Failed to compress archive chunk '", Chunk.Path, "'.");
+                return false;
+            }
+            Chunk.pData = std::move(pCompressed);
+        }
+        Chunk.Info["Size"] = Chunk.pData->GetSize();
+
+        if (EnvironmentCI.ContentAddressed)
+        {
+            const auto Hash = ArchiveChunkHashToString(ComputeArchiveChunkHash(Chunk.pData->GetConstDataPtr(), Chunk.pData->GetSize()));
+
+            Chunk.Path = OutputDir.empty() ? Hash + ".bin" : OutputDir + FileSystem::SlashSymbol + Hash + ".bin";
+
+            Chunk.Info["Path"] = Hash + ".bin";
+            Chunk.Info["Hash"] = Hash;
+
+            // The file of a chunk that did not change since the previous build already has the same contents
+            if (FileSystem::FileExists(Chunk.Path.c_str()))
+            {
+                Chunk.pData.Release();
+                ChunkInfos.push_back(std::move(Chunk.Info));
+                continue;
+            }
+        }
+
+        if (!WriteFile(Chunk.Path, Chunk.pData))
+            return false;
+
+        Chunk.pData.Release();
+        ChunkInfos.push_back(std::move(Chunk.Info));
+    }
+    Index["Chunks"] = std::move(ChunkInfos);
+
+    const auto IndexString = Index.dump(4);
+    const auto IndexPath   = OutputStem + ".index.json";
+
+    FileWrapper File{IndexPath.c_str(), EFileAccessMode::Overwrite};
+    if (!File)
+    {
+        LOG_ERROR_MESSAGE("Failed to open file: '", IndexPath, "'.");
+        return false;
+    }
+    File->Write(IndexString.data(), IndexString.size());
+    return true;
+}
+
+// Writes the precompiled render state notation and the archive or archive chunks
+bool PackageArchive(const ParsingEnvironmentCreateInfo& EnvironmentCI, ParsingEnvironment& Environment, const char* ExecutablePath)
+{
+    auto const& InputFilePaths = EnvironmentCI.InputFilePaths;
+
+    if (!EnvironmentCI.PrecompiledFilePath.empty())
+    {
+        std::vector<const Char*> Paths;
+        Paths.reserve(InputFilePaths.size());
+        for (const auto& Path : InputFilePaths)
+            Paths.push_back(Path.c_str());
+
+        RefCntAutoPtr<IDataBlob> pPrecompiledData;
+        PrecompileRenderStateNotation(Paths.data(), static_cast<Uint32>(Paths.size()), Environment.GetParserImportInputStreamFactory(), &pPrecompiledData);
+        if (!pPrecompiledData)
+        {
+            LOG_ERROR_MESSAGE("Failed to precompile render state notation");
+            return false;
+        }
+
+        FileWrapper File{EnvironmentCI.PrecompiledFilePath.c_str(), EFileAccessMode::Overwrite};
+        if (!File)
+        {
+            LOG_ERROR_MESSAGE("Failed to open file: '", EnvironmentCI.PrecompiledFilePath, "'.");
+            return false;
+        }
+        File->Write(pPrecompiledData->GetConstDataPtr(), pPrecompiledData->GetSize());
+    }
+
+    if (EnvironmentCI.SplitArchiveByDevice || EnvironmentCI.SplitArchiveByInput)
+    {
+        if (!WriteSplitArchive(EnvironmentCI, Environment, ExecutablePath))
+        {
+            LOG_ERROR_MESSAGE("Failed to create the split archive");
+            return false;
+        }
+        return true;
+    }
+
+    auto pData = BuildArchive(EnvironmentCI, Environment, ExecutablePath);
+    if (!pData)
+    {
+        LOG_ERROR_MESSAGE("Failed to create the archive");
+        return false;
+    }
+
+    if (EnvironmentCI.PrintArchiveContents)
+    {
+        Environment.GetArchiverFactory()->PrintArchiveContent(pData);
+    }
+
+    if (EnvironmentCI.CompressionLevel != 0)
+    {
+        RefCntAutoPtr<IDataBlob> pCompressed;
+        CompressRenderStateArchive(pData, nullptr, EnvironmentCI.CompressionLevel, &pCompressed);
+        if (!pCompressed)
+        {
+            LOG_ERROR_MESSAGE("Failed to compress the archive");
+            return false;
+        }
+        pData = std::move(pCompressed);
+    }
+
+    if (!WriteFile(EnvironmentCI.OuputFilePath, pData))
+    {
+        LOG_ERROR_MESSAGE("Failed to write the archive");
+        return false;
+    }
+    return true;
+}
+
+// Returns the semicolon-separated list of the directories that contain the packager inputs
+std::string GetWatchedDirectories(const ParsingEnvironmentCreateInfo& EnvironmentCI)
+{
+    std::vector<std::string> Directories;
+
+    const auto AddDirectory = [&](const std::string& Dir) {
+        if (!Dir.empty() && std::find(Directories.begin(), Directories.end(), Dir) == Directories.end())
+            Directories.push_back(Dir);
+    };
+    const auto AddFileDirectory = [&](const std::string& FilePath) {
+        std::string Dir;
+        FileSystem::GetPathComponents(FilePath, &Dir, nullptr);
+        AddDirectory(Dir);
+    };
+
+    for (const auto& Dir : EnvironmentCI.ShaderDirs)
+        AddDirectory(Dir);
+    for (const auto& Dir : EnvironmentCI.RenderStateDirs)
+        AddDirectory(Dir);
+    for (const auto& Path : EnvironmentCI.InputFilePaths)
+        AddFileDirectory(Path);
+    if (!EnvironmentCI.ConfigFilePath.empty())
+        AddFileDirectory(EnvironmentCI.ConfigFilePath);
+    if (Directories.empty())
+        Directories.emplace_back(".");
+
+    std::string Result;
+    for (const auto& Dir : Directories)
+    {
+        if (!Result.empty())
+            Result += ';';
+        Result += Dir;
+    }
+    return Result;
+}
+
 int main(int argc, char* argv[])
 {
     ParsingEnvironmentCreateInfo EnvironmentCI{};
@@ -147,46 +816,83 @@ int main(int argc, char* argv[])
         return EXIT_FAILURE;
     }
 
-    auto  pArchiveFactory = pEnvironment->GetArchiverFactory();
-    auto& Packager        = pEnvironment->GetPackager();
+    auto pArchiveFactory = pEnvironment->GetArchiverFactory();
 
-    RefCntAutoPtr<IArchiver> pArchiver;
-    pArchiveFactory->CreateArchiver(pEnvironment->GetSerializationDevice(), &pArchiver);
-    DEV_CHECK_ERR(pArchiver != nullptr, "pArchive must not be null");
+    if (!EnvironmentCI.MergeArchivePaths.empty())
+    {
+        std::vector<std::pair<ARCHIVE_DEVICE_DATA_FLAGS, std::string>> DeviceArchives;
+        for (const auto& MergeArg : EnvironmentCI.MergeArchivePaths)
+        {
+            const auto Separator = MergeArg.find('=');
+            DeviceArchives.emplace_back(GetDeviceFlagFromName(MergeArg.substr(0, Separator)), MergeArg.substr(Separator + 1));
+        }
 
-    auto const& OutputFilePath = EnvironmentCI.OuputFilePath;
-    auto const& InputFilePaths = EnvironmentCI.InputFilePaths;
+        auto pMergedData = MergeDeviceArchives(pArchiveFactory, DeviceArchives);
+        if (!pMergedData)
+        {
+            LOG_FATAL_ERROR("Failed to merge archives");
+            return EXIT_FAILURE;
+        }
 
-    if (!Packager.ParseFiles(InputFilePaths))
-    {
-        LOG_FATAL_ERROR("Failed to parse files");
-        return EXIT_FAILURE;
-    }
+        if (EnvironmentCI.PrintArchiveContents)
+            pArchiveFactory->PrintArchiveContent(pMergedData);
 
-    if (!Packager.Execute(pArchiver, EnvironmentCI.DumpBytecodeDir.empty() ? nullptr : EnvironmentCI.DumpBytecodeDir.c_str()))
-    {
-        LOG_FATAL_ERROR("Failed to create the archive");
-        return EXIT_FAILURE;
+        return WriteFile(EnvironmentCI.OuputFilePath, pMergedData) ? EXIT_SUCCESS : EXIT_FAILURE;
     }
 
-    RefCntAutoPtr<IDataBlob> pData;
-    if (!pArchiver->SerializeToBlob(&pData))
+    if (!PackageArchive(EnvironmentCI, *pEnvironment, argv[0]))
     {
-        LOG_FATAL_ERROR("Failed to serialize to Data Blob");
-        return EXIT_FAILURE;
+        if (!EnvironmentCI.Watch)
+        {
+            LOG_FATAL_ERROR("Failed to package render states");
+            return EXIT_FAILURE;
+        }
+        LOG_ERROR_MESSAGE("Failed to package render states. Waiting for changes.");
     }
 
-    if (EnvironmentCI.PrintArchiveContents)
-    {
-        pArchiveFactory->PrintArchiveContent(pData);
-    }
+    if (!EnvironmentCI.Watch)
+        return EXIT_SUCCESS;
 
-    FileWrapper File{OutputFilePath.c_str(), EFileAccessMode::Overwrite};
-    if (!File)
+    if (EnvironmentCI.ProcessCount > 1)
+        LOG_WARNING_MESSAGE("Worker processes do not keep compiled shaders between builds. Use --processes 0 for faster rebuilds in watch mode.");
+
+    FileWatcher Watcher{GetWatchedDirectories(EnvironmentCI).c_str(), WatchDebounceTimeMs};
+    LOG_INFO_MESSAGE("Watching for changes. Press Ctrl+C to exit.");
+
+    auto pConfigData = EnvironmentCI.ConfigFilePath.empty() ? RefCntAutoPtr<IDataBlob>{} : ReadFile(EnvironmentCI.ConfigFilePath);
+    for (;;)
     {
-        LOG_FATAL_ERROR("Failed to open file: '", OutputFilePath, "'.");
-        return EXIT_FAILURE;
-    }
+        std::this_thread::sleep_for(std::chrono::milliseconds{WatchPollIntervalMs});
+        if (!Watcher.ConsumeChanges())
+            continue;
 
-    File->Write(pData->GetDataPtr(), pData->GetSize());
+        // The configuration is used to create the serialization device, so the environment
+        // and all compiled shaders have to be recreated when it changes.
+        if (!EnvironmentCI.ConfigFilePath.empty())
+        {
+            auto pNewConfigData = ReadFile(EnvironmentCI.ConfigFilePath);
+            if (!pNewConfigData)
+                continue;
+
+            if (!pConfigData || pConfigData->GetSize() != pNewConfigData->GetSize() ||
+                std::memcmp(pConfigData->GetConstDataPtr(), pNewConfigData->GetConstDataPtr(), pNewConfigData->GetSize()) != 0)
+            {
+                LOG_INFO_MESSAGE("Config file has changed, reinitializing.");
+                pEnvironment.reset();
+                pEnvironment = std::make_unique<ParsingEnvironment>(EnvironmentCI);
+                if (!pEnvironment->Initialize())
+                {
+                    LOG_FATAL_ERROR("Failed to initialize ParsingEnvironment");
+                    return EXIT_FAILURE;
+                }
+                pConfigData = std::move(pNewConfigData);
+            }
+        }
+
+        Timer RebuildTimer;
+        if (PackageArchive(EnvironmentCI, *pEnvironment, argv[0]))
+            LOG_INFO_MESSAGE("Render states repackaged in ", RebuildTimer.GetElapsedTime() * 1000.0, " ms.");
+        else
+            LOG_ERROR_MESSAGE("Failed to package render states. Waiting for changes.");
+    }
 }
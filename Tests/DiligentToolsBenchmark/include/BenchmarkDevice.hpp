@@ -0,0 +1,64 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include "RenderDevice.h"
+#include "DeviceContext.h"
+#include "RefCntAutoPtr.hpp"
+
+namespace Diligent
+{
+
+namespace Benchmark
+{
+
+// Render device without a swap chain that is shared by all benchmarks that need the GPU.
+struct BenchmarkDevice
+{
+    RefCntAutoPtr<IRenderDevice>  pDevice;
+    RefCntAutoPtr<IDeviceContext> pContext;
+
+    // Name of the backend the device was created with, reported as the benchmark label
+    // so that results of different backends are not compared with each other.
+    const char* BackendName = "";
+
+    explicit operator bool() const
+    {
+        return pDevice && pContext;
+    }
+
+    // Submits the recorded commands and releases the resources that are no longer used by the GPU.
+    void FinishFrame() const;
+};
+
+// Returns the shared device, which is created on the first call using the first backend that
+// succeeds in the order D3D12, Vulkan, D3D11. The device is null if none of them is available.
+const BenchmarkDevice& GetBenchmarkDevice();
+
+} // namespace Benchmark
+
+} // namespace Diligent
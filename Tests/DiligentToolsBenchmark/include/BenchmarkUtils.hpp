@@ -0,0 +1,68 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+namespace Benchmark
+{
+
+// Generates tightly packed 8-bit pixels: smooth gradients with a small amount of noise,
+// which compress and filter similarly to real textures.
+inline std::vector<Uint8> GenerateTestPixels(Uint32 Width, Uint32 Height, Uint32 NumComponents)
+{
+    std::vector<Uint8> Pixels(size_t{Width} * Height * NumComponents);
+
+    Uint32 Seed = 0x12345678u;
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            for (Uint32 c = 0; c < NumComponents; ++c)
+            {
+                Seed = Seed * 1664525u + 1013904223u;
+
+                const auto Gradient = (x * (c % 4 + 1) * 255u) / Width + (y * (4 - c % 4) * 255u) / Height;
+                const auto Noise    = (Seed >> 28u);
+
+                Pixels[(size_t{y} * Width + x) * NumComponents + c] = static_cast<Uint8>(Gradient + Noise);
+            }
+        }
+    }
+
+    return Pixels;
+}
+
+} // namespace Benchmark
+
+} // namespace Diligent
@@ -0,0 +1,90 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include "BCTools.h"
+#include "GraphicsAccessories.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+// Measures DecompressBCTexture() throughput in decompressed bytes per second
+void DecompressBC(benchmark::State& State, TEXTURE_FORMAT Format)
+{
+    const auto  Size          = static_cast<Uint32>(State.range(0));
+    const auto  DecompFormat  = GetBCDecompressedFormat(Format);
+    const auto& DecompAttribs = GetTextureFormatAttribs(DecompFormat);
+    const auto& BCAttribs     = GetTextureFormatAttribs(Format);
+    const auto  PixelSize     = Uint32{DecompAttribs.ComponentSize} * DecompAttribs.NumComponents;
+    const auto  Pixels        = GenerateTestPixels(Size, Size, PixelSize);
+
+    const auto BlocksStride = (Size / 4) * BCAttribs.ComponentSize;
+
+    std::vector<Uint8> Blocks(size_t{BlocksStride} * (Size / 4));
+
+    CompressBCTextureAttribs CompressAttribs;
+    CompressAttribs.Format     = Format;
+    CompressAttribs.Width      = Size;
+    CompressAttribs.Height     = Size;
+    CompressAttribs.pSrcPixels = Pixels.data();
+    CompressAttribs.SrcStride  = Size * PixelSize;
+    CompressAttribs.pDstBlocks = Blocks.data();
+    CompressAttribs.DstStride  = BlocksStride;
+    CompressAttribs.Quality    = BC_COMPRESSION_QUALITY_FAST;
+    CompressBCTexture(CompressAttribs);
+
+    std::vector<Uint8> DstPixels(Pixels.size());
+
+    DecompressBCTextureAttribs Attribs;
+    Attribs.Format     = Format;
+    Attribs.Width      = Size;
+    Attribs.Height     = Size;
+    Attribs.pSrcBlocks = Blocks.data();
+    Attribs.SrcStride  = BlocksStride;
+    Attribs.pDstPixels = DstPixels.data();
+    Attribs.DstStride  = Size * PixelSize;
+    for (auto _ : State)
+    {
+        DecompressBCTexture(Attribs);
+        benchmark::ClobberMemory();
+    }
+    State.SetBytesProcessed(static_cast<int64_t>(State.iterations()) * static_cast<int64_t>(DstPixels.size()));
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(DecompressBC, BC1, TEX_FORMAT_BC1_UNORM)->RangeMultiplier(4)->Range(256, 2048);
+BENCHMARK_CAPTURE(DecompressBC, BC3, TEX_FORMAT_BC3_UNORM)->RangeMultiplier(4)->Range(256, 2048);
+BENCHMARK_CAPTURE(DecompressBC, BC4, TEX_FORMAT_BC4_UNORM)->RangeMultiplier(4)->Range(256, 2048);
+BENCHMARK_CAPTURE(DecompressBC, BC5, TEX_FORMAT_BC5_UNORM)->RangeMultiplier(4)->Range(256, 2048);
+BENCHMARK_CAPTURE(DecompressBC, BC7, TEX_FORMAT_BC7_UNORM)->RangeMultiplier(4)->Range(256, 2048);
@@ -0,0 +1,106 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include "BenchmarkDevice.hpp"
+
+#if D3D12_SUPPORTED
+#    include "EngineFactoryD3D12.h"
+#endif
+#if VULKAN_SUPPORTED
+#    include "EngineFactoryVk.h"
+#endif
+#if D3D11_SUPPORTED
+#    include "EngineFactoryD3D11.h"
+#endif
+
+namespace Diligent
+{
+
+namespace Benchmark
+{
+
+namespace
+{
+
+BenchmarkDevice CreateBenchmarkDevice()
+{
+    BenchmarkDevice Device;
+
+#if D3D12_SUPPORTED
+    if (!Device)
+    {
+        EngineD3D12CreateInfo EngineCI;
+        GetEngineFactoryD3D12()->CreateDeviceAndContextsD3D12(EngineCI, &Device.pDevice, &Device.pContext);
+        Device.BackendName = "D3D12";
+    }
+#endif
+
+#if VULKAN_SUPPORTED
+    if (!Device)
+    {
+        EngineVkCreateInfo EngineCI;
+        GetEngineFactoryVk()->CreateDeviceAndContextsVk(EngineCI, &Device.pDevice, &Device.pContext);
+        Device.BackendName = "Vulkan";
+    }
+#endif
+
+#if D3D11_SUPPORTED
+    if (!Device)
+    {
+        EngineD3D11CreateInfo EngineCI;
+        GetEngineFactoryD3D11()->CreateDeviceAndContextsD3D11(EngineCI, &Device.pDevice, &Device.pContext);
+        Device.BackendName = "D3D11";
+    }
+#endif
+
+    if (!Device)
+    {
+        Device.pDevice.Release();
+        Device.pContext.Release();
+        Device.BackendName = "";
+    }
+
+    return Device;
+}
+
+} // namespace
+
+void BenchmarkDevice::FinishFrame() const
+{
+    pContext->Flush();
+    pContext->FinishFrame();
+    pDevice->ReleaseStaleResources();
+}
+
+const BenchmarkDevice& GetBenchmarkDevice()
+{
+    static const BenchmarkDevice Device = CreateBenchmarkDevice();
+    return Device;
+}
+
+} // namespace Benchmark
+
+} // namespace Diligent
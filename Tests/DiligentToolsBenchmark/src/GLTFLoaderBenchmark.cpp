@@ -0,0 +1,410 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "GLTFLoader.hpp"
+#include "Image.h"
+#include "ThreadPool.hpp"
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+
+#include "BenchmarkUtils.hpp"
+#include "BenchmarkDevice.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+constexpr char   ModelDirectory[]  = "GLTFLoaderBenchmark";
+constexpr float  AnimationDuration = 2;
+constexpr Uint32 TextureSize       = 512;
+
+std::string GetModelFilePath(const char* FileName)
+{
+    return std::string{ModelDirectory} + FileSystem::SlashSymbol + FileName;
+}
+
+bool WriteFile(const std::string& Path, const void* pData, size_t Size)
+{
+    FileWrapper File{Path.c_str(), EFileAccessMode::Overwrite};
+    return File && File->Write(pData, Size);
+}
+
+// Synthetic glTF model: NumNodes nodes that form a tree where every node has up to four children.
+// Every node references a cube mesh, and a single animation rotates all nodes using NumKeys key frames.
+// When NumTextures is not zero, the meshes use NumTextures materials with PNG base color textures.
+class SyntheticModel
+{
+public:
+    SyntheticModel(Uint32 NumNodes, Uint32 NumKeys, Uint32 NumTextures)
+    {
+        FileSystem::CreateDirectory(ModelDirectory);
+
+        // Buffer layout: cube positions, cube indices, key frame times, key frame rotations
+        static constexpr float Positions[] =
+            {
+                -0.5f, -0.5f, -0.5f, +0.5f, -0.5f, -0.5f, +0.5f, +0.5f, -0.5f, -0.5f, +0.5f, -0.5f,
+                -0.5f, -0.5f, +0.5f, +0.5f, -0.5f, +0.5f, +0.5f, +0.5f, +0.5f, -0.5f, +0.5f, +0.5f //
+            };
+        static constexpr Uint16 Indices[] =
+            {
+                0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 1, 5, 0, 5, 4,
+                3, 6, 2, 3, 7, 6, 0, 4, 7, 0, 7, 3, 1, 2, 6, 1, 6, 5 //
+            };
+
+        std::vector<Uint8> Data{reinterpret_cast<const Uint8*>(Positions), reinterpret_cast<const Uint8*>(Positions) + sizeof(Positions)};
+        Data.insert(Data.end(), reinterpret_cast<const Uint8*>(Indices), reinterpret_cast<const Uint8*>(Indices) + sizeof(Indices));
+
+        const auto TimesOffset = Data.size();
+        Data.resize(TimesOffset + NumKeys * sizeof(float) * 5);
+        auto* pTimes     = reinterpret_cast<float*>(&Data[TimesOffset]);
+        auto* pRotations = pTimes + NumKeys;
+        for (Uint32 k = 0; k < NumKeys; ++k)
+        {
+            const float t = static_cast<float>(k) / static_cast<float>(std::max(NumKeys - 1, 1u));
+            const float a = t * PI_F;
+
+            pTimes[k] = t * AnimationDuration;
+
+            pRotations[k * 4 + 0] = 0;
+            pRotations[k * 4 + 1] = std::sin(a);
+            pRotations[k * 4 + 2] = 0;
+            pRotations[k * 4 + 3] = std::cos(a);
+        }
+        WriteFile(GetModelFilePath("Model.bin"), Data.data(), Data.size());
+
+        const auto NumMeshes = std::max(NumTextures, 1u);
+
+        std::stringstream ss;
+        ss << "{\n"
+           << "  \"asset\": {\"version\": \"2.0\"},\n"
+           << "  \"scene\": 0,\n"
+           << "  \"scenes\": [{\"nodes\": [0]}],\n";
+
+        ss << "  \"nodes\": [\n";
+        for (Uint32 i = 0; i < NumNodes; ++i)
+        {
+            ss << "    {\"mesh\": " << i % NumMeshes << ", \"translation\": [" << (i % 4) * 1.5f - 2.25f << ", 1.5, 0]";
+            if (i * 4 + 1 < NumNodes)
+            {
+                ss << ", \"children\": [";
+                for (Uint32 c = i * 4 + 1; c < std::min(i * 4 + 5, NumNodes); ++c)
+                    ss << (c > i * 4 + 1 ? ", " : "") << c;
+                ss << "]";
+            }
+            ss << (i + 1 < NumNodes ? "},\n" : "}\n");
+        }
+        ss << "  ],\n";
+
+        ss << "  \"meshes\": [\n";
+        for (Uint32 i = 0; i < NumMeshes; ++i)
+        {
+            ss << "    {\"primitives\": [{\"attributes\": {\"POSITION\": 0}, \"indices\": 1"
+               << (NumTextures > 0 ? ", \"material\": " + std::to_string(i) : std::string{})
+               << (i + 1 < NumMeshes ? "}]},\n" : "}]}\n");
+        }
+        ss << "  ],\n";
+
+        if (NumTextures > 0)
+        {
+            ss << "  \"materials\": [\n";
+            for (Uint32 i = 0; i < NumTextures; ++i)
+                ss << "    {\"pbrMetallicRoughness\": {\"baseColorTexture\": {\"index\": " << i << "}}}" << (i + 1 < NumTextures ? ",\n" : "\n");
+            ss << "  ],\n";
+
+            ss << "  \"textures\": [\n";
+            for (Uint32 i = 0; i < NumTextures; ++i)
+                ss << "    {\"source\": " << i << "}" << (i + 1 < NumTextures ? ",\n" : "\n");
+            ss << "  ],\n";
+
+            ss << "  \"images\": [\n";
+            for (Uint32 i = 0; i < NumTextures; ++i)
+            {
+                const auto ImageName = "Texture" + std::to_string(i) + ".png";
+                WriteTexture(GetModelFilePath(ImageName.c_str()), i);
+                ss << "    {\"uri\": \"" << ImageName << "\"}" << (i + 1 < NumTextures ? ",\n" : "\n");
+            }
+            ss << "  ],\n";
+        }
+
+        ss << "  \"animations\": [{\n"
+           << "    \"channels\": [\n";
+        for (Uint32 i = 0; i < NumNodes; ++i)
+            ss << "      {\"sampler\": " << i << ", \"target\": {\"node\": " << i << ", \"path\": \"rotation\"}}" << (i + 1 < NumNodes ? ",\n" : "\n");
+        ss << "    ],\n"
+           << "    \"samplers\": [\n";
+        for (Uint32 i = 0; i < NumNodes; ++i)
+            ss << "      {\"input\": 2, \"output\": 3}" << (i + 1 < NumNodes ? ",\n" : "\n");
+        ss << "    ]\n"
+           << "  }],\n";
+
+        ss << "  \"accessors\": [\n"
+           << "    {\"bufferView\": 0, \"componentType\": 5126, \"count\": 8, \"type\": \"VEC3\", \"min\": [-0.5, -0.5, -0.5], \"max\": [0.5, 0.5, 0.5]},\n"
+           << "    {\"bufferView\": 1, \"componentType\": 5123, \"count\": 36, \"type\": \"SCALAR\"},\n"
+           << "    {\"bufferView\": 2, \"componentType\": 5126, \"count\": " << NumKeys << ", \"type\": \"SCALAR\", \"min\": [0], \"max\": [" << AnimationDuration << "]},\n"
+           << "    {\"bufferView\": 3, \"componentType\": 5126, \"count\": " << NumKeys << ", \"type\": \"VEC4\"}\n"
+           << "  ],\n";
+
+        ss << "  \"bufferViews\": [\n"
+           << "    {\"buffer\": 0, \"byteOffset\": 0, \"byteLength\": " << sizeof(Positions) << ", \"target\": 34962},\n"
+           << "    {\"buffer\": 0, \"byteOffset\": " << sizeof(Positions) << ", \"byteLength\": " << sizeof(Indices) << ", \"target\": 34963},\n"
+           << "    {\"buffer\": 0, \"byteOffset\": " << TimesOffset << ", \"byteLength\": " << NumKeys * sizeof(float) << "},\n"
+           << "    {\"buffer\": 0, \"byteOffset\": " << TimesOffset + NumKeys * sizeof(float) << ", \"byteLength\": " << NumKeys * sizeof(float) * 4 << "}\n"
+           << "  ],\n";
+
+        ss << "  \"buffers\": [{\"uri\": \"Model.bin\", \"byteLength\": " << Data.size() << "}]\n"
+           << "}\n";
+
+        const auto Json = ss.str();
+        WriteFile(GetModelFilePath("Model.gltf"), Json.data(), Json.size());
+    }
+
+    ~SyntheticModel()
+    {
+        FileSystem::DeleteDirectory(ModelDirectory);
+    }
+
+    static std::string GetFilePath()
+    {
+        return GetModelFilePath("Model.gltf");
+    }
+
+private:
+    static void WriteTexture(const std::string& Path, Uint32 Index)
+    {
+        auto Pixels = GenerateTestPixels(TextureSize, TextureSize, 4);
+        // Make the textures differ, so that the loader does not share them
+        Pixels[0] = static_cast<Uint8>(Index);
+
+        Image::EncodeInfo Info;
+        Info.Width      = TextureSize;
+        Info.Height     = TextureSize;
+        Info.TexFormat  = TEX_FORMAT_RGBA8_UNORM;
+        Info.KeepAlpha  = true;
+        Info.pData      = Pixels.data();
+        Info.Stride     = TextureSize * 4;
+        Info.FileFormat = IMAGE_FILE_FORMAT_PNG;
+
+        RefCntAutoPtr<IDataBlob> pEncodedData;
+        Image::Encode(Info, &pEncodedData);
+        if (pEncodedData)
+            WriteFile(Path, pEncodedData->GetConstDataPtr(), pEncodedData->GetSize());
+    }
+};
+
+std::unique_ptr<GLTF::Model> CreateModel(const BenchmarkDevice& Device, IThreadPool* pThreadPool, GLTF::ModelLoadStats* pLoadStats)
+{
+    const auto FilePath = SyntheticModel::GetFilePath();
+
+    GLTF::ModelCreateInfo ModelCI;
+    ModelCI.FileName    = FilePath.c_str();
+    ModelCI.pThreadPool = pThreadPool;
+    ModelCI.pLoadStats  = pLoadStats;
+    try
+    {
+        return std::make_unique<GLTF::Model>(Device.pDevice, nullptr, ModelCI);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+// Measures the time to load the model into GPU memory without uploading the data.
+// The time of every load stage is reported as a counter.
+void LoadModel(benchmark::State& State)
+{
+    const auto& Device = GetBenchmarkDevice();
+    if (!Device)
+    {
+        State.SkipWithError("Failed to create the render device");
+        return;
+    }
+    State.SetLabel(Device.BackendName);
+
+    SyntheticModel ModelFiles{static_cast<Uint32>(State.range(0)), static_cast<Uint32>(State.range(1)), static_cast<Uint32>(State.range(2))};
+
+    RefCntAutoPtr<IThreadPool> pThreadPool;
+    if (State.range(3) != 0)
+        pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{std::max(std::thread::hardware_concurrency(), 1u)});
+
+    GLTF::ModelLoadStats LoadStats;
+    for (auto _ : State)
+    {
+        auto pModel = CreateModel(Device, pThreadPool, &LoadStats);
+        if (!pModel)
+        {
+            State.SkipWithError("Failed to load the model");
+            break;
+        }
+
+        State.PauseTiming();
+        pModel.reset();
+        Device.FinishFrame();
+        State.ResumeTiming();
+    }
+
+    for (Uint32 Stage = 0; Stage < GLTF::MODEL_LOAD_PROFILE_STAGE_COUNT; ++Stage)
+    {
+        const auto& Stats = LoadStats.Stages[Stage];
+        if (Stats.NumItems > 0 || Stats.Time > 0)
+            State.counters[GLTF::ModelLoadStats::GetStageName(static_cast<GLTF::MODEL_LOAD_PROFILE_STAGE>(Stage))] = benchmark::Counter{Stats.Time, benchmark::Counter::kAvgIterations};
+    }
+}
+
+// Loads the model with NumNodes nodes and 64 key frames for the transform benchmarks
+std::unique_ptr<GLTF::Model> LoadAnimatedModel(benchmark::State& State, Uint32 NumNodes)
+{
+    const auto& Device = GetBenchmarkDevice();
+    if (!Device)
+    {
+        State.SkipWithError("Failed to create the render device");
+        return nullptr;
+    }
+
+    SyntheticModel ModelFiles{NumNodes, 64, 0};
+
+    auto pModel = CreateModel(Device, nullptr, nullptr);
+    if (!pModel)
+        State.SkipWithError("Failed to load the model");
+    return pModel;
+}
+
+// Measures the time to compute the transforms of an animated model, advancing the animation every iteration
+void ComputeTransforms_Animated(benchmark::State& State)
+{
+    const auto NumNodes = static_cast<Uint32>(State.range(0));
+    auto       pModel   = LoadAnimatedModel(State, NumNodes);
+    if (!pModel)
+        return;
+
+    GLTF::ModelTransforms Transforms;
+    float                 Time = 0;
+    for (auto _ : State)
+    {
+        Time = std::fmod(Time + 1.f / 60.f, AnimationDuration);
+        pModel->ComputeTransforms(Transforms, float4x4::Identity(), 0, Time);
+        benchmark::DoNotOptimize(Transforms.NodeGlobalMatrices.data());
+    }
+    State.SetItemsProcessed(static_cast<int64_t>(State.iterations()) * NumNodes);
+}
+
+// Measures the time to compute the transforms of an animated model with the animation evaluated
+// every fourth frame and interpolated in between
+void ComputeTransforms_AnimatedLOD(benchmark::State& State)
+{
+    const auto NumNodes = static_cast<Uint32>(State.range(0));
+    auto       pModel   = LoadAnimatedModel(State, NumNodes);
+    if (!pModel)
+        return;
+
+    GLTF::AnimationLOD LOD;
+    LOD.UpdatePeriod = 4.f / 60.f;
+
+    GLTF::ModelTransforms Transforms;
+    float                 Time = 0;
+    for (auto _ : State)
+    {
+        Time = std::fmod(Time + 1.f / 60.f, AnimationDuration);
+        pModel->ComputeTransforms(Transforms, float4x4::Identity(), 0, Time, LOD);
+        benchmark::DoNotOptimize(Transforms.NodeGlobalMatrices.data());
+    }
+    State.SetItemsProcessed(static_cast<int64_t>(State.iterations()) * NumNodes);
+}
+
+// Measures the time to compute the transforms of a model in the rest pose when nothing has changed
+// since the previous call.
+void ComputeTransforms_Static(benchmark::State& State)
+{
+    const auto NumNodes = static_cast<Uint32>(State.range(0));
+    auto       pModel   = LoadAnimatedModel(State, NumNodes);
+    if (!pModel)
+        return;
+
+    GLTF::ModelTransforms Transforms;
+    for (auto _ : State)
+    {
+        pModel->ComputeTransforms(Transforms);
+        benchmark::DoNotOptimize(Transforms.NodeGlobalMatrices.data());
+    }
+    State.SetItemsProcessed(static_cast<int64_t>(State.iterations()) * NumNodes);
+}
+
+// Measures the time to compute the transforms of many animated instances of the model
+void ComputeTransformsBatch(benchmark::State& State)
+{
+    const auto NumNodes     = static_cast<Uint32>(State.range(0));
+    const auto NumInstances = static_cast<Uint32>(State.range(1));
+    auto       pModel       = LoadAnimatedModel(State, NumNodes);
+    if (!pModel)
+        return;
+
+    RefCntAutoPtr<IThreadPool> pThreadPool;
+    if (State.range(2) != 0)
+        pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{std::max(std::thread::hardware_concurrency(), 1u)});
+
+    std::vector<GLTF::ModelTransforms>     Transforms(NumInstances);
+    std::vector<GLTF::ModelAnimationState> States(NumInstances);
+    for (Uint32 i = 0; i < NumInstances; ++i)
+    {
+        States[i].RootTransform  = float4x4::Translation(static_cast<float>(i % 32) * 8.f, 0, static_cast<float>(i / 32) * 8.f);
+        States[i].AnimationIndex = 0;
+        States[i].Time           = std::fmod(static_cast<float>(i) * 0.01f, AnimationDuration);
+    }
+
+    for (auto _ : State)
+    {
+        for (auto& InstState : States)
+            InstState.Time = std::fmod(InstState.Time + 1.f / 60.f, AnimationDuration);
+
+        pModel->ComputeTransformsBatch(Transforms.data(), States.data(), NumInstances, pThreadPool);
+        benchmark::DoNotOptimize(Transforms.data());
+    }
+    State.SetItemsProcessed(static_cast<int64_t>(State.iterations()) * NumNodes * NumInstances);
+}
+
+} // namespace
+
+// Arguments: number of nodes, number of key frames, number of textures, whether to use a thread pool
+BENCHMARK(LoadModel)->ArgNames({"Nodes", "Keys", "Textures", "MT"})->Args({64, 64, 0, 0})->Args({4096, 64, 0, 0})->Args({256, 1024, 0, 0})->Args({64, 64, 8, 0})->Args({64, 64, 8, 1})->Unit(benchmark::kMillisecond);
+
+BENCHMARK(ComputeTransforms_Animated)->ArgName("Nodes")->RangeMultiplier(8)->Range(64, 4096)->Unit(benchmark::kMicrosecond);
+BENCHMARK(ComputeTransforms_AnimatedLOD)->ArgName("Nodes")->RangeMultiplier(8)->Range(64, 4096)->Unit(benchmark::kMicrosecond);
+BENCHMARK(ComputeTransforms_Static)->ArgName("Nodes")->RangeMultiplier(8)->Range(64, 4096)->Unit(benchmark::kMicrosecond);
+
+// Arguments: number of nodes, number of instances, whether to use a thread pool
+BENCHMARK(ComputeTransformsBatch)->ArgNames({"Nodes", "Instances", "MT"})->Args({64, 256, 0})->Args({64, 256, 1})->Args({64, 4096, 1})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,137 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "imgui.h"
+#include "ImGuiImplDiligent.hpp"
+
+#include "BenchmarkDevice.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+constexpr Uint32 SurfaceWidth  = 1920;
+constexpr Uint32 SurfaceHeight = 1080;
+
+// Builds synthetic draw data: NumWindows windows, each with NumItems text lines and NumItems
+// rectangles that are clipped by separate clip rectangles, so that every item adds a draw command.
+ImDrawData* BuildDrawData(ImGuiImplDiligent& ImGuiImpl, Uint32 NumWindows, Uint32 NumItems)
+{
+    ImGui::GetIO().DisplaySize = ImVec2{static_cast<float>(SurfaceWidth), static_cast<float>(SurfaceHeight)};
+    ImGuiImpl.NewFrame(SurfaceWidth, SurfaceHeight, SURFACE_TRANSFORM_IDENTITY);
+
+    for (Uint32 w = 0; w < NumWindows; ++w)
+    {
+        const auto Pos = ImVec2{static_cast<float>(w % 8) * 220.f, static_cast<float>(w / 8 % 4) * 260.f};
+        ImGui::SetNextWindowPos(Pos);
+        ImGui::SetNextWindowSize(ImVec2{200, 240});
+        ImGui::Begin(("Window " + std::to_string(w)).c_str());
+
+        auto* const pDrawList = ImGui::GetWindowDrawList();
+        for (Uint32 i = 0; i < NumItems; ++i)
+        {
+            ImGui::Text("Item %u: %f", i, static_cast<float>(i) * 0.25f);
+
+            const auto Min = ImVec2{Pos.x + static_cast<float>(i % 16) * 12.f, Pos.y + static_cast<float>(i / 16 % 16) * 14.f};
+            const auto Max = ImVec2{Min.x + 10.f, Min.y + 12.f};
+            pDrawList->PushClipRect(Min, Max, true);
+            pDrawList->AddRectFilled(Min, Max, IM_COL32((i * 16) & 0xFF, (i * 8) & 0xFF, 128, 255), 2.f);
+            pDrawList->AddLine(Min, Max, IM_COL32(255, 255, 255, 255));
+            pDrawList->PopClipRect();
+        }
+        ImGui::End();
+    }
+
+    ImGui::Render();
+    return ImGui::GetDrawData();
+}
+
+// Measures the CPU time to record the draw data into the immediate context.
+// The GPU work is submitted while the timer is paused.
+void RenderDrawData(benchmark::State& State, bool UseCompactVertices)
+{
+    const auto& Device = GetBenchmarkDevice();
+    if (!Device)
+    {
+        State.SkipWithError("Failed to create the render device");
+        return;
+    }
+    State.SetLabel(Device.BackendName);
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "ImGui benchmark render target";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Width     = SurfaceWidth;
+    TexDesc.Height    = SurfaceHeight;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.BindFlags = BIND_RENDER_TARGET;
+
+    RefCntAutoPtr<ITexture> pRenderTarget;
+    Device.pDevice->CreateTexture(TexDesc, nullptr, &pRenderTarget);
+    if (!pRenderTarget)
+    {
+        State.SkipWithError("Failed to create the render target");
+        return;
+    }
+    auto* pRTV = pRenderTarget->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+
+    ImGuiImplDiligent ImGuiImpl{Device.pDevice, TexDesc.Format, TEX_FORMAT_UNKNOWN};
+    ImGuiImpl.SetCompactVertexFormat(UseCompactVertices);
+
+    auto* pDrawData = BuildDrawData(ImGuiImpl, static_cast<Uint32>(State.range(0)), static_cast<Uint32>(State.range(1)));
+
+    Int64 NumCommands = 0;
+    for (int i = 0; i < pDrawData->CmdListsCount; ++i)
+        NumCommands += pDrawData->CmdLists[i]->CmdBuffer.Size;
+
+    auto* pCtx = Device.pContext.RawPtr();
+    for (auto _ : State)
+    {
+        pCtx->SetRenderTargets(1, &pRTV, nullptr, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        ImGuiImpl.RenderDrawData(pCtx, pDrawData);
+
+        State.PauseTiming();
+        Device.FinishFrame();
+        State.ResumeTiming();
+    }
+
+    State.SetItemsProcessed(static_cast<int64_t>(State.iterations()) * pDrawData->TotalVtxCount);
+    State.counters["Vertices"] = static_cast<double>(pDrawData->TotalVtxCount);
+    State.counters["Indices"]  = static_cast<double>(pDrawData->TotalIdxCount);
+    State.counters["Commands"] = static_cast<double>(NumCommands);
+}
+
+} // namespace
+
+// Arguments: number of windows, number of items per window
+BENCHMARK_CAPTURE(RenderDrawData, Default, false)->ArgNames({"Windows", "Items"})->Args({4, 32})->Args({32, 256})->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(RenderDrawData, CompactVertices, true)->ArgNames({"Windows", "Items"})->Args({4, 32})->Args({32, 256})->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,112 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include "Image.h"
+#include "DataBlobImpl.hpp"
+#include "RefCntAutoPtr.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+RefCntAutoPtr<IDataBlob> EncodeTestImage(IMAGE_FILE_FORMAT FileFormat, Uint32 Size, Uint32 NumComponents)
+{
+    // The encoder takes RGBA pixels and drops the alpha channel unless KeepAlpha is true
+    const auto Pixels = GenerateTestPixels(Size, Size, 4);
+
+    Image::EncodeInfo Info;
+    Info.Width      = Size;
+    Info.Height     = Size;
+    Info.TexFormat  = TEX_FORMAT_RGBA8_UNORM;
+    Info.KeepAlpha  = NumComponents == 4;
+    Info.pData      = Pixels.data();
+    Info.Stride     = Size * 4;
+    Info.FileFormat = FileFormat;
+
+    RefCntAutoPtr<IDataBlob> pEncodedData;
+    Image::Encode(Info, &pEncodedData);
+    return pEncodedData;
+}
+
+// Measures the throughput of Image::CreateFromDataBlob() in decoded bytes per second
+void DecodeImage(benchmark::State& State, IMAGE_FILE_FORMAT FileFormat, Uint32 NumComponents)
+{
+    const auto Size         = static_cast<Uint32>(State.range(0));
+    auto       pEncodedData = EncodeTestImage(FileFormat, Size, NumComponents);
+    if (!pEncodedData)
+    {
+        State.SkipWithError("Failed to encode the test image");
+        return;
+    }
+
+    ImageLoadInfo LoadInfo;
+    LoadInfo.Format = FileFormat;
+
+    size_t DecodedSize = 0;
+    for (auto _ : State)
+    {
+        RefCntAutoPtr<Image> pImage;
+        Image::CreateFromDataBlob(pEncodedData, LoadInfo, &pImage);
+        DecodedSize = pImage->GetData()->GetSize();
+        benchmark::DoNotOptimize(pImage->GetData()->GetDataPtr());
+    }
+    State.SetBytesProcessed(static_cast<int64_t>(State.iterations()) * static_cast<int64_t>(DecodedSize));
+    State.counters["EncodedSize"] = static_cast<double>(pEncodedData->GetSize());
+}
+
+// Measures the time to read the image properties from the header
+void ProbeImageHeader(benchmark::State& State, IMAGE_FILE_FORMAT FileFormat)
+{
+    auto pEncodedData = EncodeTestImage(FileFormat, 1024, 4);
+    if (!pEncodedData)
+    {
+        State.SkipWithError("Failed to encode the test image");
+        return;
+    }
+
+    const auto* pData = static_cast<const Uint8*>(pEncodedData->GetConstDataPtr());
+    for (auto _ : State)
+    {
+        ImageProbeInfo Info;
+        benchmark::DoNotOptimize(ProbeImage(pData, pEncodedData->GetSize(), Info));
+    }
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(DecodeImage, PNG_RGBA8, IMAGE_FILE_FORMAT_PNG, 4u)->RangeMultiplier(4)->Range(256, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(DecodeImage, PNG_RGB8, IMAGE_FILE_FORMAT_PNG, 3u)->RangeMultiplier(4)->Range(256, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(DecodeImage, JPEG_RGB8, IMAGE_FILE_FORMAT_JPEG, 3u)->RangeMultiplier(4)->Range(256, 2048)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(ProbeImageHeader, PNG, IMAGE_FILE_FORMAT_PNG);
+BENCHMARK_CAPTURE(ProbeImageHeader, JPEG, IMAGE_FILE_FORMAT_JPEG);
@@ -0,0 +1,83 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include "TextureLoader.h"
+#include "Image.h"
+#include "DataBlobImpl.hpp"
+#include "RefCntAutoPtr.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+// Measures the time to prepare the full mip chain of an RGBA8 texture on the CPU.
+// The throughput is given in bytes of the source level per second.
+void GenerateMips(benchmark::State& State, TEXTURE_LOAD_MIP_FILTER MipFilter, bool IsSRGB, bool PremultiplyAlpha)
+{
+    const auto Size          = static_cast<Uint32>(State.range(0));
+    const auto NumComponents = 4u;
+    const auto Pixels        = GenerateTestPixels(Size, Size, NumComponents);
+
+    auto pPixelsBlob = DataBlobImpl::Create(Pixels.size(), Pixels.data());
+
+    ImageDesc ImgDesc;
+    ImgDesc.Width         = Size;
+    ImgDesc.Height        = Size;
+    ImgDesc.ComponentType = VT_UINT8;
+    ImgDesc.NumComponents = NumComponents;
+    ImgDesc.RowStride     = Size * NumComponents;
+
+    RefCntAutoPtr<Image> pImage;
+    Image::CreateFromMemory(ImgDesc, pPixelsBlob, &pImage);
+
+    TextureLoadInfo LoadInfo;
+    LoadInfo.IsSRGB           = IsSRGB;
+    LoadInfo.MipFilter        = MipFilter;
+    LoadInfo.PremultiplyAlpha = PremultiplyAlpha;
+    for (auto _ : State)
+    {
+        RefCntAutoPtr<ITextureLoader> pLoader;
+        CreateTextureLoaderFromImage(pImage, LoadInfo, &pLoader);
+        benchmark::DoNotOptimize(pLoader.RawPtr());
+    }
+    State.SetBytesProcessed(static_cast<int64_t>(State.iterations()) * static_cast<int64_t>(Pixels.size()));
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(GenerateMips, Box, TEXTURE_LOAD_MIP_FILTER_BOX_AVERAGE, false, false)->RangeMultiplier(4)->Range(256, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(GenerateMips, Box_SRGB, TEXTURE_LOAD_MIP_FILTER_BOX_AVERAGE, true, false)->RangeMultiplier(4)->Range(256, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(GenerateMips, Box_PremultipliedAlpha, TEXTURE_LOAD_MIP_FILTER_BOX_AVERAGE, false, true)->RangeMultiplier(4)->Range(256, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(GenerateMips, MostFrequent, TEXTURE_LOAD_MIP_FILTER_MOST_FREQUENT, false, false)->RangeMultiplier(4)->Range(256, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(GenerateMips, Kaiser, TEXTURE_LOAD_MIP_FILTER_KAISER, false, false)->RangeMultiplier(4)->Range(256, 2048)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(GenerateMips, Kaiser_SRGB, TEXTURE_LOAD_MIP_FILTER_KAISER, true, false)->RangeMultiplier(4)->Range(256, 2048)->Unit(benchmark::kMillisecond);
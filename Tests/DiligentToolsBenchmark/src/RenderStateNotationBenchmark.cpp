@@ -0,0 +1,224 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "RenderStateNotationParser.h"
+#include "DefaultShaderSourceStreamFactory.h"
+#include "RefCntAutoPtr.hpp"
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+
+using namespace Diligent;
+
+namespace
+{
+
+constexpr char NotationDirectory[] = "RenderStateNotationBenchmark";
+
+std::string GetLevelFileName(Uint32 Level)
+{
+    return "Level" + std::to_string(Level) + ".json";
+}
+
+void WriteTextFile(const std::string& Path, const std::string& Text)
+{
+    FileWrapper File{Path.c_str(), EFileAccessMode::Overwrite};
+    if (File)
+        File->Write(Text.data(), Text.size());
+}
+
+// Synthetic render state notation: NumShaders vertex and pixel shaders and NumPipelines graphics pipelines
+// that are evenly distributed over a chain of IncludeDepth + 1 files, where each file imports the next one.
+class NotationSet
+{
+public:
+    NotationSet(Uint32 NumShaders, Uint32 NumPipelines, Uint32 IncludeDepth) :
+        m_NumLevels{IncludeDepth + 1}
+    {
+        FileSystem::CreateDirectory(NotationDirectory);
+
+        const auto NumShaderPairs = std::max(NumShaders / 2, 1u);
+        for (Uint32 Level = 0; Level < m_NumLevels; ++Level)
+        {
+            std::stringstream ss;
+            ss << "{\n";
+            if (Level + 1 < m_NumLevels)
+                ss << "  \"Imports\": [\"" << GetLevelFileName(Level + 1) << "\"],\n";
+
+            ss << "  \"Shaders\": [\n";
+            bool First = true;
+            for (Uint32 i = Level; i < NumShaderPairs; i += m_NumLevels)
+            {
+                ss << (First ? "" : ",\n")
+                   << "    {\"Desc\": {\"Name\": \"VS" << i << "\", \"ShaderType\": \"VERTEX\"}, \"SourceLanguage\": \"HLSL\", \"FilePath\": \"Shader" << i << ".hlsl\", \"EntryPoint\": \"VSMain\"},\n"
+                   << "    {\"Desc\": {\"Name\": \"PS" << i << "\", \"ShaderType\": \"PIXEL\"}, \"SourceLanguage\": \"HLSL\", \"FilePath\": \"Shader" << i << ".hlsl\", \"EntryPoint\": \"PSMain\"}";
+                First = false;
+            }
+            ss << "\n  ],\n";
+
+            ss << "  \"Pipelines\": [\n";
+            First = true;
+            for (Uint32 i = Level; i < NumPipelines; i += m_NumLevels)
+            {
+                ss << (First ? "" : ",\n")
+                   << "    {\"PSODesc\": {\"Name\": \"Pipeline" << i << "\"},"
+                   << " \"GraphicsPipeline\": {\"PrimitiveTopology\": \"TRIANGLE_LIST\", \"RTVFormats\": {\"0\": \"RGBA8_UNORM_SRGB\"}, \"DSVFormat\": \"D32_FLOAT\","
+                   << " \"RasterizerDesc\": {\"CullMode\": \"BACK\"}, \"DepthStencilDesc\": {\"DepthEnable\": true, \"DepthFunc\": \"LESS\"}},"
+                   << " \"pVS\": \"VS" << i % NumShaderPairs << "\", \"pPS\": \"PS" << i % NumShaderPairs << "\"}";
+                First = false;
+            }
+            ss << "\n  ]\n}\n";
+
+            m_Files.emplace_back(ss.str());
+            WriteTextFile(GetFilePath(Level), m_Files.back());
+        }
+
+        CreateDefaultShaderSourceStreamFactory(NotationDirectory, &m_pStreamFactory);
+    }
+
+    ~NotationSet()
+    {
+        FileSystem::DeleteDirectory(NotationDirectory);
+    }
+
+    // Changes the contents of the most deeply imported file without changing its states
+    void TouchDeepestFile()
+    {
+        auto& File = m_Files.back();
+        File.push_back(' ');
+        WriteTextFile(GetFilePath(m_NumLevels - 1), File);
+    }
+
+    IShaderSourceInputStreamFactory* GetStreamFactory() const
+    {
+        return m_pStreamFactory;
+    }
+
+private:
+    static std::string GetFilePath(Uint32 Level)
+    {
+        return std::string{NotationDirectory} + FileSystem::SlashSymbol + GetLevelFileName(Level);
+    }
+
+    const Uint32             m_NumLevels;
+    std::vector<std::string> m_Files;
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> m_pStreamFactory;
+};
+
+RefCntAutoPtr<IRenderStateNotationParser> ParseNotationSet(const NotationSet& Set, bool EnableReload)
+{
+    RenderStateNotationParserCreateInfo ParserCI;
+    ParserCI.EnableReload = EnableReload;
+
+    RefCntAutoPtr<IRenderStateNotationParser> pParser;
+    CreateRenderStateNotationParser(ParserCI, &pParser);
+    if (pParser)
+        pParser->ParseFile(GetLevelFileName(0).c_str(), Set.GetStreamFactory());
+    return pParser;
+}
+
+void SetObjectsProcessed(benchmark::State& State)
+{
+    State.SetItemsProcessed(static_cast<int64_t>(State.iterations()) * (State.range(0) + State.range(1)));
+}
+
+// Measures the time to parse the whole notation set, including reading the files.
+void ParseFile(benchmark::State& State)
+{
+    NotationSet Set{static_cast<Uint32>(State.range(0)), static_cast<Uint32>(State.range(1)), static_cast<Uint32>(State.range(2))};
+    for (auto _ : State)
+    {
+        auto pParser = ParseNotationSet(Set, false);
+        benchmark::DoNotOptimize(pParser.RawPtr());
+    }
+    SetObjectsProcessed(State);
+}
+
+// Measures the time to reload the notation set when none of the files has changed.
+void Reload_Unchanged(benchmark::State& State)
+{
+    NotationSet Set{static_cast<Uint32>(State.range(0)), static_cast<Uint32>(State.range(1)), static_cast<Uint32>(State.range(2))};
+
+    auto pParser = ParseNotationSet(Set, true);
+    if (!pParser)
+    {
+        State.SkipWithError("Failed to parse the notation set");
+        return;
+    }
+
+    for (auto _ : State)
+        benchmark::DoNotOptimize(pParser->Reload());
+    SetObjectsProcessed(State);
+}
+
+// Measures the time to reload the notation set after one of the files has changed.
+void Reload_Modified(benchmark::State& State)
+{
+    NotationSet Set{static_cast<Uint32>(State.range(0)), static_cast<Uint32>(State.range(1)), static_cast<Uint32>(State.range(2))};
+
+    auto pParser = ParseNotationSet(Set, true);
+    if (!pParser)
+    {
+        State.SkipWithError("Failed to parse the notation set");
+        return;
+    }
+
+    for (auto _ : State)
+    {
+        State.PauseTiming();
+        Set.TouchDeepestFile();
+        State.ResumeTiming();
+
+        benchmark::DoNotOptimize(pParser->Reload());
+    }
+    SetObjectsProcessed(State);
+}
+
+// Arguments: number of shaders, number of pipelines, include depth
+void NotationSetArguments(benchmark::internal::Benchmark* pBenchmark)
+{
+    pBenchmark->ArgNames({"Shaders", "Pipelines", "Depth"});
+    pBenchmark->Args({64, 64, 0});
+    pBenchmark->Args({512, 512, 0});
+    pBenchmark->Args({512, 512, 4});
+    pBenchmark->Args({4096, 4096, 0});
+    pBenchmark->Args({4096, 4096, 16});
+    pBenchmark->Unit(benchmark::kMillisecond);
+}
+
+} // namespace
+
+BENCHMARK(ParseFile)->Apply(NotationSetArguments);
+BENCHMARK(Reload_Unchanged)->Apply(NotationSetArguments);
+BENCHMARK(Reload_Modified)->Apply(NotationSetArguments);
@@ -0,0 +1,198 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "RenderStatePackager.hpp"
+#include "ParsingEnvironment.hpp"
+#include "FileSystem.hpp"
+#include "FileWrapper.hpp"
+
+using namespace Diligent;
+
+namespace
+{
+
+constexpr char PackagerDirectory[] = "RenderStatePackagerBenchmark";
+constexpr char PipelinesFileName[] = "Pipelines.json";
+
+ARCHIVE_DEVICE_DATA_FLAGS GetDeviceFlags()
+{
+    ARCHIVE_DEVICE_DATA_FLAGS DeviceFlags = ARCHIVE_DEVICE_DATA_FLAG_NONE;
+#if D3D11_SUPPORTED
+    DeviceFlags = DeviceFlags | ARCHIVE_DEVICE_DATA_FLAG_D3D11;
+#endif
+#if D3D12_SUPPORTED
+    DeviceFlags = DeviceFlags | ARCHIVE_DEVICE_DATA_FLAG_D3D12;
+#endif
+#if VULKAN_SUPPORTED
+    DeviceFlags = DeviceFlags | ARCHIVE_DEVICE_DATA_FLAG_VULKAN;
+#endif
+#if GL_SUPPORTED
+    DeviceFlags = DeviceFlags | ARCHIVE_DEVICE_DATA_FLAG_GL;
+#endif
+#if METAL_SUPPORTED
+    DeviceFlags = DeviceFlags | ARCHIVE_DEVICE_DATA_FLAG_METAL_MACOS;
+#endif
+    return DeviceFlags;
+}
+
+void WriteTextFile(const char* FileName, const std::string& Text)
+{
+    const auto  Path = std::string{PackagerDirectory} + FileSystem::SlashSymbol + FileName;
+    FileWrapper File{Path.c_str(), EFileAccessMode::Overwrite};
+    if (File)
+        File->Write(Text.data(), Text.size());
+}
+
+// Synthetic packager input: NumPipelines graphics pipelines, each with its own vertex and pixel shader
+// that are compiled from a separate source file.
+class PackagerInput
+{
+public:
+    explicit PackagerInput(Uint32 NumPipelines)
+    {
+        FileSystem::CreateDirectory(PackagerDirectory);
+
+        std::stringstream Notation;
+        Notation << "{\n  \"Shaders\": [\n";
+        for (Uint32 i = 0; i < NumPipelines; ++i)
+        {
+            const auto FileName = "Shader" + std::to_string(i) + ".hlsl";
+
+            std::stringstream Source;
+            Source << "struct PSInput\n{\n    float4 Pos : SV_POSITION;\n    float4 Color : COLOR;\n};\n"
+                   << "void VSMain(in uint VertId : SV_VertexID, out PSInput PSIn)\n{\n"
+                   << "    float2 UV = float2(VertId & 1u, VertId >> 1u);\n"
+                   << "    PSIn.Pos   = float4(UV * 2.0 - 1.0, 0.0, 1.0);\n"
+                   << "    PSIn.Color = float4(UV, " << i << ".0 / " << NumPipelines << ".0, 1.0);\n}\n"
+                   << "float4 PSMain(in PSInput PSIn) : SV_Target\n{\n"
+                   << "    return PSIn.Color * " << (i + 1) << ".0;\n}\n";
+            WriteTextFile(FileName.c_str(), Source.str());
+
+            Notation << "    {\"Desc\": {\"Name\": \"VS" << i << "\", \"ShaderType\": \"VERTEX\"}, \"SourceLanguage\": \"HLSL\", \"FilePath\": \"" << FileName << "\", \"EntryPoint\": \"VSMain\"},\n"
+                     << "    {\"Desc\": {\"Name\": \"PS" << i << "\", \"ShaderType\": \"PIXEL\"}, \"SourceLanguage\": \"HLSL\", \"FilePath\": \"" << FileName << "\", \"EntryPoint\": \"PSMain\"}"
+                     << (i + 1 < NumPipelines ? ",\n" : "\n");
+        }
+        Notation << "  ],\n  \"Pipelines\": [\n";
+        for (Uint32 i = 0; i < NumPipelines; ++i)
+        {
+            Notation << "    {\"PSODesc\": {\"Name\": \"Pipeline" << i << "\", \"PipelineType\": \"GRAPHICS\"},"
+                     << " \"GraphicsPipeline\": {\"PrimitiveTopology\": \"TRIANGLE_STRIP\", \"NumRenderTargets\": 1, \"RTVFormats\": {\"0\": \"RGBA8_UNORM\"},"
+                     << " \"DepthStencilDesc\": {\"DepthEnable\": false}, \"RasterizerDesc\": {\"CullMode\": \"NONE\"}},"
+                     << " \"pVS\": \"VS" << i << "\", \"pPS\": \"PS" << i << "\"}"
+                     << (i + 1 < NumPipelines ? ",\n" : "\n");
+        }
+        Notation << "  ]\n}\n";
+        WriteTextFile(PipelinesFileName, Notation.str());
+    }
+
+    ~PackagerInput()
+    {
+        FileSystem::DeleteDirectory(PackagerDirectory);
+    }
+};
+
+std::unique_ptr<ParsingEnvironment> CreateParsingEnvironment()
+{
+    ParsingEnvironmentCreateInfo EnvironmentCI;
+    EnvironmentCI.DeviceFlags     = GetDeviceFlags();
+    EnvironmentCI.RenderStateDirs = {PackagerDirectory};
+    EnvironmentCI.ShaderDirs      = {PackagerDirectory};
+
+    auto pEnvironment = std::make_unique<ParsingEnvironment>(EnvironmentCI);
+    if (!pEnvironment->Initialize())
+        return nullptr;
+    return pEnvironment;
+}
+
+// Measures the time of RenderStatePackager::Execute(). When ReuseShaders is true, the shaders compiled
+// by the previous call are reused, which is the case when the packager watches the input files.
+void PackagerExecute(benchmark::State& State, bool ReuseShaders)
+{
+    const auto NumPipelines = static_cast<Uint32>(State.range(0));
+
+    PackagerInput Input{NumPipelines};
+
+    auto pEnvironment = CreateParsingEnvironment();
+    if (!pEnvironment)
+    {
+        State.SkipWithError("Failed to initialize the parsing environment");
+        return;
+    }
+
+    auto& Packager = pEnvironment->GetPackager();
+
+    const std::vector<std::string> InputFilePaths{PipelinesFileName};
+
+    auto Prepare = [&]() {
+        Packager.Reset();
+        if (!ReuseShaders)
+            Packager.ClearShaderCache();
+
+        RefCntAutoPtr<IArchiver> pArchiver;
+        pEnvironment->GetArchiverFactory()->CreateArchiver(pEnvironment->GetSerializationDevice(), &pArchiver);
+        if (!Packager.ParseFiles(InputFilePaths))
+            pArchiver.Release();
+        return pArchiver;
+    };
+
+    if (ReuseShaders)
+    {
+        // Compile the shaders before the measurement starts
+        auto pArchiver = Prepare();
+        if (!pArchiver || !Packager.Execute(pArchiver))
+        {
+            State.SkipWithError("Failed to execute the packager");
+            return;
+        }
+    }
+
+    for (auto _ : State)
+    {
+        State.PauseTiming();
+        auto pArchiver = Prepare();
+        State.ResumeTiming();
+
+        if (!pArchiver || !Packager.Execute(pArchiver))
+        {
+            State.SkipWithError("Failed to execute the packager");
+            break;
+        }
+    }
+    State.SetItemsProcessed(static_cast<int64_t>(State.iterations()) * NumPipelines);
+}
+
+} // namespace
+
+// Argument: number of pipelines
+BENCHMARK_CAPTURE(PackagerExecute, Compile, false)->ArgName("Pipelines")->Arg(16)->Arg(128)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(PackagerExecute, ReuseShaders, true)->ArgName("Pipelines")->Arg(16)->Arg(128)->Unit(benchmark::kMillisecond);
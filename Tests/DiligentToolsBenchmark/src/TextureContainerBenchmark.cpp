@@ -0,0 +1,167 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include <benchmark/benchmark.h>
+
+#include "TextureLoader.h"
+#include "RefCntAutoPtr.hpp"
+
+#include "BenchmarkUtils.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+void WriteUint32(std::vector<Uint8>& Data, Uint32 Value)
+{
+    const auto Offset = Data.size();
+    Data.resize(Offset + sizeof(Value));
+    memcpy(&Data[Offset], &Value, sizeof(Value));
+}
+
+void WriteUint64(std::vector<Uint8>& Data, Uint64 Value)
+{
+    const auto Offset = Data.size();
+    Data.resize(Offset + sizeof(Value));
+    memcpy(&Data[Offset], &Value, sizeof(Value));
+}
+
+Uint32 GetNumMips(Uint32 Size)
+{
+    Uint32 NumMips = 1;
+    while ((Size >> NumMips) != 0)
+        ++NumMips;
+    return NumMips;
+}
+
+// Creates a legacy DDS file with the full mip chain of an RGBA8 texture
+std::vector<Uint8> CreateDDSFile(Uint32 Size)
+{
+    const auto NumMips = GetNumMips(Size);
+
+    std::vector<Uint8> Data;
+    WriteUint32(Data, 0x20534444); // "DDS "
+    WriteUint32(Data, 124);        // Header size
+    WriteUint32(Data, 0x00021007); // DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT
+    WriteUint32(Data, Size);       // Height
+    WriteUint32(Data, Size);       // Width
+    WriteUint32(Data, Size * 4);   // Pitch
+    WriteUint32(Data, 0);          // Depth
+    WriteUint32(Data, NumMips);
+    for (Uint32 i = 0; i < 11; ++i)
+        WriteUint32(Data, 0); // Reserved
+
+    // Pixel format
+    WriteUint32(Data, 32);         // Size
+    WriteUint32(Data, 0x00000041); // DDPF_RGB | DDPF_ALPHAPIXELS
+    WriteUint32(Data, 0);          // FourCC
+    WriteUint32(Data, 32);         // RGB bit count
+    WriteUint32(Data, 0x000000FF);
+    WriteUint32(Data, 0x0000FF00);
+    WriteUint32(Data, 0x00FF0000);
+    WriteUint32(Data, 0xFF000000);
+
+    WriteUint32(Data, 0x00401008); // DDSCAPS_TEXTURE | DDSCAPS_COMPLEX | DDSCAPS_MIPMAP
+    for (Uint32 i = 0; i < 4; ++i)
+        WriteUint32(Data, 0); // Caps2, caps3, caps4, reserved
+
+    for (Uint32 mip = 0; mip < NumMips; ++mip)
+    {
+        const auto MipSize = std::max(Size >> mip, 1u);
+        Data.resize(Data.size() + size_t{MipSize} * MipSize * 4, static_cast<Uint8>(mip));
+    }
+
+    return Data;
+}
+
+// Creates a KTX2 file with the full mip chain of an RGBA8 texture
+std::vector<Uint8> CreateKTX2File(Uint32 Size)
+{
+    const auto NumMips = GetNumMips(Size);
+
+    static constexpr Uint8 KTX20FileIdentifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+    std::vector<Uint8> Data{std::begin(KTX20FileIdentifier), std::end(KTX20FileIdentifier)};
+    WriteUint32(Data, 37); // VK_FORMAT_R8G8B8A8_UNORM
+    WriteUint32(Data, 1);  // Type size
+    WriteUint32(Data, Size);
+    WriteUint32(Data, Size);
+    WriteUint32(Data, 0); // Depth
+    WriteUint32(Data, 0); // Layer count
+    WriteUint32(Data, 1); // Face count
+    WriteUint32(Data, NumMips);
+    WriteUint32(Data, 0); // Supercompression scheme
+    for (Uint32 i = 0; i < 4; ++i)
+        WriteUint32(Data, 0); // DFD and KVD offsets and sizes
+    WriteUint64(Data, 0);     // Supercompression global data offset
+    WriteUint64(Data, 0);     // Supercompression global data size
+
+    auto LevelDataOffset = Data.size() + size_t{NumMips} * 24;
+    for (Uint32 mip = 0; mip < NumMips; ++mip)
+    {
+        const auto MipSize  = std::max(Size >> mip, 1u);
+        const auto DataSize = Uint64{MipSize} * MipSize * 4;
+        WriteUint64(Data, LevelDataOffset);
+        WriteUint64(Data, DataSize);
+        WriteUint64(Data, DataSize);
+        LevelDataOffset += static_cast<size_t>(DataSize);
+    }
+    Data.resize(LevelDataOffset, 0x80);
+
+    return Data;
+}
+
+// Measures the time to parse the container and set up the subresources without copying the data
+void ParseContainer(benchmark::State& State, IMAGE_FILE_FORMAT FileFormat)
+{
+    const auto Size = static_cast<Uint32>(State.range(0));
+    const auto Data = FileFormat == IMAGE_FILE_FORMAT_DDS ? CreateDDSFile(Size) : CreateKTX2File(Size);
+
+    TextureLoadInfo LoadInfo;
+    for (auto _ : State)
+    {
+        RefCntAutoPtr<ITextureLoader> pLoader;
+        CreateTextureLoaderFromMemory(Data.data(), Data.size(), FileFormat, false, LoadInfo, &pLoader);
+        if (!pLoader)
+        {
+            State.SkipWithError("Failed to create the texture loader");
+            break;
+        }
+        benchmark::DoNotOptimize(pLoader.RawPtr());
+    }
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(ParseContainer, DDS, IMAGE_FILE_FORMAT_DDS)->RangeMultiplier(4)->Range(256, 2048);
+BENCHMARK_CAPTURE(ParseContainer, KTX2, IMAGE_FILE_FORMAT_KTX)->RangeMultiplier(4)->Range(256, 2048);
@@ -0,0 +1,102 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include <benchmark/benchmark.h>
+
+#include "TextureUtilities.h"
+
+#include "BenchmarkUtils.hpp"
+
+using namespace Diligent;
+using namespace Diligent::Benchmark;
+
+namespace
+{
+
+// Measures CopyPixels() throughput in destination bytes per second
+void CopyPixelsBenchmark(benchmark::State& State, Uint32 SrcCompCount, Uint32 DstCompCount)
+{
+    const auto Size      = static_cast<Uint32>(State.range(0));
+    const auto SrcPixels = GenerateTestPixels(Size, Size, SrcCompCount);
+
+    std::vector<Uint8> DstPixels(size_t{Size} * Size * DstCompCount);
+
+    CopyPixelsAttribs Attribs;
+    Attribs.Width         = Size;
+    Attribs.Height        = Size;
+    Attribs.ComponentSize = 1;
+    Attribs.pSrcPixels    = SrcPixels.data();
+    Attribs.SrcStride     = Size * SrcCompCount;
+    Attribs.SrcCompCount  = SrcCompCount;
+    Attribs.pDstPixels    = DstPixels.data();
+    Attribs.DstStride     = Size * DstCompCount;
+    Attribs.DstCompCount  = DstCompCount;
+    for (auto _ : State)
+    {
+        CopyPixels(Attribs);
+        benchmark::ClobberMemory();
+    }
+    State.SetBytesProcessed(static_cast<int64_t>(State.iterations()) * static_cast<int64_t>(DstPixels.size()));
+}
+
+// Measures ExpandPixels() throughput when the image is expanded to the next power of two
+void ExpandPixelsBenchmark(benchmark::State& State)
+{
+    const auto SrcSize       = static_cast<Uint32>(State.range(0));
+    const auto DstSize       = SrcSize * 2;
+    const auto NumComponents = 4u;
+    const auto SrcPixels     = GenerateTestPixels(SrcSize - 1, SrcSize - 1, NumComponents);
+
+    std::vector<Uint8> DstPixels(size_t{DstSize} * DstSize * NumComponents);
+
+    ExpandPixelsAttribs Attribs;
+    Attribs.SrcWidth       = SrcSize - 1;
+    Attribs.SrcHeight      = SrcSize - 1;
+    Attribs.ComponentSize  = 1;
+    Attribs.ComponentCount = NumComponents;
+    Attribs.pSrcPixels     = SrcPixels.data();
+    Attribs.SrcStride      = (SrcSize - 1) * NumComponents;
+    Attribs.DstWidth       = DstSize;
+    Attribs.DstHeight      = DstSize;
+    Attribs.pDstPixels     = DstPixels.data();
+    Attribs.DstStride      = DstSize * NumComponents;
+    for (auto _ : State)
+    {
+        ExpandPixels(Attribs);
+        benchmark::ClobberMemory();
+    }
+    State.SetBytesProcessed(static_cast<int64_t>(State.iterations()) * static_cast<int64_t>(DstPixels.size()));
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(CopyPixelsBenchmark, RGBA8_To_RGBA8, 4u, 4u)->RangeMultiplier(4)->Range(256, 2048);
+BENCHMARK_CAPTURE(CopyPixelsBenchmark, RGB8_To_RGBA8, 3u, 4u)->RangeMultiplier(4)->Range(256, 2048);
+BENCHMARK_CAPTURE(CopyPixelsBenchmark, RGBA8_To_RGB8, 4u, 3u)->RangeMultiplier(4)->Range(256, 2048);
+BENCHMARK_CAPTURE(CopyPixelsBenchmark, RGBA8_To_R8, 4u, 1u)->RangeMultiplier(4)->Range(256, 2048);
+
+BENCHMARK(ExpandPixelsBenchmark)->RangeMultiplier(4)->Range(256, 2048);
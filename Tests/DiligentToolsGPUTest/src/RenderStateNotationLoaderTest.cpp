@@ -24,11 +24,15 @@
  *  of the possibility of such damages.
  */
 
+#include <atomic>
+#include <thread>
+
 #include "gtest/gtest.h"
 #include "RefCntAutoPtr.hpp"
 #include "RenderStateNotationLoader.h"
 #include "DefaultShaderSourceStreamFactory.h"
 #include "RenderStateCache.h"
+#include "ThreadPool.hpp"
 #include "GPUTestingEnvironment.hpp"
 
 using namespace Diligent;
@@ -117,6 +121,199 @@ TEST(Tools_RenderStateNotationLoader, BasicTest)
     EXPECT_EQ(GraphicsDescReference, pPSO->GetGraphicsPipelineDesc());
 }
 
+TEST(Tools_RenderStateNotationLoader, LoadPipelineStates)
+{
+    auto* pEnvironment = GPUTestingEnvironment::GetInstance();
+    ASSERT_NE(pEnvironment, nullptr);
+
+    auto* pDevice        = pEnvironment->GetDevice();
+    auto  pParser        = CreateParser("PSO.json");
+    auto  pStreamFactory = CreateShaderFactory();
+
+    ThreadPoolCreateInfo ThreadPoolCI{4};
+    auto                 pThreadPool = CreateThreadPool(ThreadPoolCI);
+    ASSERT_NE(pThreadPool, nullptr);
+
+    RenderStateNotationLoaderCreateInfo LoaderCI{};
+    LoaderCI.pDevice        = pDevice;
+    LoaderCI.pParser        = pParser;
+    LoaderCI.pStreamFactory = pStreamFactory;
+    LoaderCI.pThreadPool    = pThreadPool;
+
+    RefCntAutoPtr<IRenderStateNotationLoader> pLoader;
+    CreateRenderStateNotationLoader(LoaderCI, &pLoader);
+    ASSERT_NE(pLoader, nullptr);
+
+    constexpr Uint32 NumPipelines = 8;
+
+    LoadPipelineStateInfo PipelineLIs[NumPipelines];
+    for (auto& PipelineLI : PipelineLIs)
+    {
+        PipelineLI.Name         = "GeometryOpaque";
+        PipelineLI.PipelineType = PIPELINE_TYPE_GRAPHICS;
+        PipelineLI.AddToCache   = true;
+    }
+
+    IPipelineState* ppPSOs[NumPipelines] = {};
+    pLoader->LoadPipelineStates(PipelineLIs, NumPipelines, ppPSOs);
+
+    // All requests for the same cached pipeline must resolve to a single object
+    for (Uint32 i = 0; i < NumPipelines; ++i)
+    {
+        EXPECT_NE(ppPSOs[i], nullptr);
+        EXPECT_EQ(ppPSOs[i], ppPSOs[0]);
+    }
+    if (ppPSOs[0] != nullptr)
+    {
+        const auto GraphicsDescReference = GetGraphicsPipelineRefDesc();
+        EXPECT_EQ(GraphicsDescReference, ppPSOs[0]->GetGraphicsPipelineDesc());
+    }
+
+    for (auto* pPSO : ppPSOs)
+    {
+        if (pPSO != nullptr)
+            pPSO->Release();
+    }
+}
+
+
+TEST(Tools_RenderStateNotationLoader, LoadPipelineStateAsync)
+{
+    auto* pEnvironment = GPUTestingEnvironment::GetInstance();
+    ASSERT_NE(pEnvironment, nullptr);
+
+    auto* pDevice        = pEnvironment->GetDevice();
+    auto  pParser        = CreateParser("PSO.json");
+    auto  pStreamFactory = CreateShaderFactory();
+
+    ThreadPoolCreateInfo ThreadPoolCI{2};
+    auto                 pThreadPool = CreateThreadPool(ThreadPoolCI);
+    ASSERT_NE(pThreadPool, nullptr);
+
+    RenderStateNotationLoaderCreateInfo LoaderCI{};
+    LoaderCI.pDevice        = pDevice;
+    LoaderCI.pParser        = pParser;
+    LoaderCI.pStreamFactory = pStreamFactory;
+    LoaderCI.pThreadPool    = pThreadPool;
+
+    RefCntAutoPtr<IRenderStateNotationLoader> pLoader;
+    CreateRenderStateNotationLoader(LoaderCI, &pLoader);
+    ASSERT_NE(pLoader, nullptr);
+
+    std::atomic<Uint32> NumCallbacks{0};
+
+    LoadPipelineStateInfo PipelineLI{};
+    PipelineLI.Name             = "GeometryOpaque";
+    PipelineLI.PipelineType     = PIPELINE_TYPE_GRAPHICS;
+    PipelineLI.AddToCache       = true;
+    PipelineLI.OnPipelineLoaded = [](IPipelineState* pPSO, void* pUserData) {
+        EXPECT_NE(pPSO, nullptr);
+        ++*static_cast<std::atomic<Uint32>*>(pUserData);
+    };
+    PipelineLI.pOnPipelineLoadedData = &NumCallbacks;
+
+    RefCntAutoPtr<IPipelineStateLoadTask> pTask0;
+    pLoader->LoadPipelineStateAsync(PipelineLI, &pTask0);
+    ASSERT_NE(pTask0, nullptr);
+
+    RefCntAutoPtr<IPipelineStateLoadTask> pTask1;
+    pLoader->LoadPipelineStateAsync(PipelineLI, &pTask1);
+    ASSERT_NE(pTask1, nullptr);
+
+    pTask0->WaitForCompletion();
+    pTask1->WaitForCompletion();
+    EXPECT_TRUE(pTask0->IsComplete());
+    EXPECT_TRUE(pTask1->IsComplete());
+
+    auto* pPSO = pTask0->GetPipelineState();
+    ASSERT_NE(pPSO, nullptr);
+    EXPECT_EQ(pTask1->GetPipelineState(), pPSO);
+    EXPECT_EQ(NumCallbacks.load(), 2u);
+
+    const auto GraphicsDescReference = GetGraphicsPipelineRefDesc();
+    EXPECT_EQ(GraphicsDescReference, pPSO->GetGraphicsPipelineDesc());
+
+    // The pipeline is in the cache now, so the task must be complete right away
+    RefCntAutoPtr<IPipelineStateLoadTask> pTask2;
+    pLoader->LoadPipelineStateAsync(PipelineLI, &pTask2);
+    ASSERT_NE(pTask2, nullptr);
+    EXPECT_TRUE(pTask2->IsComplete());
+    EXPECT_EQ(pTask2->GetPipelineState(), pPSO);
+    EXPECT_EQ(NumCallbacks.load(), 3u);
+}
+
+TEST(Tools_RenderStateNotationLoader, WarmupPipelineStates)
+{
+    auto* pEnvironment = GPUTestingEnvironment::GetInstance();
+    ASSERT_NE(pEnvironment, nullptr);
+
+    auto* pDevice        = pEnvironment->GetDevice();
+    auto  pParser        = CreateParser("PSO.json");
+    auto  pStreamFactory = CreateShaderFactory();
+
+    ThreadPoolCreateInfo ThreadPoolCI{2};
+    auto                 pThreadPool = CreateThreadPool(ThreadPoolCI);
+    ASSERT_NE(pThreadPool, nullptr);
+
+    RenderStateNotationLoaderCreateInfo LoaderCI{};
+    LoaderCI.pDevice             = pDevice;
+    LoaderCI.pParser             = pParser;
+    LoaderCI.pStreamFactory      = pStreamFactory;
+    LoaderCI.pThreadPool         = pThreadPool;
+    LoaderCI.RecordPipelineUsage = true;
+
+    // Record the usage list in the first run
+    RefCntAutoPtr<IDataBlob> pUsage;
+    {
+        RefCntAutoPtr<IRenderStateNotationLoader> pLoader;
+        CreateRenderStateNotationLoader(LoaderCI, &pLoader);
+        ASSERT_NE(pLoader, nullptr);
+
+        LoadPipelineStateInfo PipelineLI{};
+        PipelineLI.Name         = "GeometryOpaque";
+        PipelineLI.PipelineType = PIPELINE_TYPE_GRAPHICS;
+        PipelineLI.AddToCache   = true;
+
+        for (Uint32 i = 0; i < 2; ++i)
+        {
+            RefCntAutoPtr<IPipelineState> pPSO;
+            pLoader->LoadPipelineState(PipelineLI, &pPSO);
+            EXPECT_NE(pPSO, nullptr);
+        }
+
+        pLoader->GetPipelineUsage(&pUsage);
+        ASSERT_NE(pUsage, nullptr);
+    }
+
+    // Warm up the cache of a new loader from the list
+    LoaderCI.RecordPipelineUsage = false;
+
+    RefCntAutoPtr<IRenderStateNotationLoader> pLoader;
+    CreateRenderStateNotationLoader(LoaderCI, &pLoader);
+    ASSERT_NE(pLoader, nullptr);
+
+    EXPECT_EQ(pLoader->WarmupPipelineStates(pUsage, 0), 1u);
+    while (pLoader->GetNumPendingWarmupPipelines() != 0)
+        std::this_thread::yield();
+
+    // The pipeline is in the cache now, so the task must be complete right away
+    LoadPipelineStateInfo PipelineLI{};
+    PipelineLI.Name         = "GeometryOpaque";
+    PipelineLI.PipelineType = PIPELINE_TYPE_GRAPHICS;
+    PipelineLI.AddToCache   = true;
+
+    RefCntAutoPtr<IPipelineStateLoadTask> pTask;
+    pLoader->LoadPipelineStateAsync(PipelineLI, &pTask);
+    ASSERT_NE(pTask, nullptr);
+    EXPECT_TRUE(pTask->IsComplete());
+    EXPECT_NE(pTask->GetPipelineState(), nullptr);
+
+    // The loader does not record the usage
+    RefCntAutoPtr<IDataBlob> pEmptyUsage;
+    pLoader->GetPipelineUsage(&pEmptyUsage);
+    ASSERT_NE(pEmptyUsage, nullptr);
+    EXPECT_EQ(pLoader->WarmupPipelineStates(pEmptyUsage, 0), 0u);
+}
 
 TEST(Tools_RenderStateNotationLoader, ResourceSignature)
 {
@@ -276,6 +473,9 @@ TEST(Tools_RenderStateNotationLoader, Reload)
         EXPECT_EQ(GraphicsDescReference, pPSO->GetGraphicsPipelineDesc());
     }
 
+    // No directories are watched
+    EXPECT_FALSE(pLoader->ReloadIfModified());
+
     EXPECT_TRUE(pLoader->Reload());
 
     {
@@ -303,4 +503,104 @@ TEST(Tools_RenderStateNotationLoader, Reload)
     }
 }
 
+TEST(Tools_RenderStateNotationLoader, ShaderResourceBindingCache)
+{
+    auto* pEnvironment = GPUTestingEnvironment::GetInstance();
+    ASSERT_NE(pEnvironment, nullptr);
+
+    auto* pDevice        = pEnvironment->GetDevice();
+    auto  pParser        = CreateParser("PSO.json");
+    auto  pStreamFactory = CreateShaderFactory();
+
+    ThreadPoolCreateInfo ThreadPoolCI{4};
+    auto                 pThreadPool = CreateThreadPool(ThreadPoolCI);
+    ASSERT_NE(pThreadPool, nullptr);
+
+    RenderStateNotationLoaderCreateInfo LoaderCI{};
+    LoaderCI.pDevice        = pDevice;
+    LoaderCI.pParser        = pParser;
+    LoaderCI.pStreamFactory = pStreamFactory;
+    LoaderCI.pThreadPool    = pThreadPool;
+
+    RefCntAutoPtr<IRenderStateNotationLoader> pLoader;
+    CreateRenderStateNotationLoader(LoaderCI, &pLoader);
+    ASSERT_NE(pLoader, nullptr);
+
+    LoadPipelineStateInfo PipelineLI{};
+    PipelineLI.Name           = "GeometryOpaque";
+    PipelineLI.PipelineType   = PIPELINE_TYPE_GRAPHICS;
+    PipelineLI.ModifyPipeline = [](PipelineStateCreateInfo& PipelineCI, void*) {
+        PipelineCI.PSODesc.ResourceLayout.DefaultVariableType = SHADER_RESOURCE_VARIABLE_TYPE_MUTABLE;
+    };
+
+    RefCntAutoPtr<IPipelineState> pPSO;
+    pLoader->LoadPipelineState(PipelineLI, &pPSO);
+    ASSERT_NE(pPSO, nullptr);
+
+    constexpr Uint32 NumTextures = 3;
+
+    RefCntAutoPtr<ITexture>       pTextures[NumTextures];
+    ShaderResourceBindingResource Resources[NumTextures];
+    ShaderResourceBindingInfo     Infos[NumTextures];
+    for (Uint32 i = 0; i < NumTextures; ++i)
+    {
+        TextureDesc TexDesc;
+        TexDesc.Name      = "SRB cache test texture";
+        TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+        TexDesc.Width     = 4;
+        TexDesc.Height    = 4;
+        TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+        TexDesc.BindFlags = BIND_SHADER_RESOURCE;
+        pDevice->CreateTexture(TexDesc, nullptr, &pTextures[i]);
+        ASSERT_NE(pTextures[i], nullptr);
+
+        Resources[i].ShaderStages = SHADER_TYPE_PIXEL;
+        Resources[i].Name         = "g_Tex";
+        Resources[i].pObject      = pTextures[i]->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE);
+
+        Infos[i].pPSO         = pPSO;
+        Infos[i].pResources   = &Resources[i];
+        Infos[i].NumResources = 1;
+    }
+
+    {
+        RefCntAutoPtr<IShaderResourceBinding> pSRB0;
+        pLoader->GetShaderResourceBinding(Infos[0], &pSRB0);
+        ASSERT_NE(pSRB0, nullptr);
+        auto* pVar = pSRB0->GetVariableByName(SHADER_TYPE_PIXEL, "g_Tex");
+        ASSERT_NE(pVar, nullptr);
+        EXPECT_EQ(pVar->Get(), Resources[0].pObject);
+
+        // The same info must return the same binding
+        RefCntAutoPtr<IShaderResourceBinding> pSRB1;
+        pLoader->GetShaderResourceBinding(Infos[0], &pSRB1);
+        EXPECT_EQ(pSRB0, pSRB1);
+
+        // Bulk request: the cached binding is reused, and equal infos get the same new binding
+        const ShaderResourceBindingInfo BulkInfos[] = {Infos[0], Infos[1], Infos[1], Infos[2]};
+
+        IShaderResourceBinding* ppSRBs[_countof(BulkInfos)] = {};
+        pLoader->GetShaderResourceBindings(BulkInfos, _countof(BulkInfos), ppSRBs);
+        EXPECT_EQ(ppSRBs[0], pSRB0);
+        EXPECT_NE(ppSRBs[1], nullptr);
+        EXPECT_EQ(ppSRBs[1], ppSRBs[2]);
+        EXPECT_NE(ppSRBs[3], nullptr);
+        EXPECT_NE(ppSRBs[1], ppSRBs[3]);
+        if (ppSRBs[3] != nullptr)
+            EXPECT_EQ(ppSRBs[3]->GetVariableByName(SHADER_TYPE_PIXEL, "g_Tex")->Get(), Resources[2].pObject);
+
+        // Bindings that are still referenced are not purged
+        EXPECT_EQ(pLoader->PurgeShaderResourceBindings(), 0u);
+
+        for (auto* pSRB : ppSRBs)
+        {
+            if (pSRB != nullptr)
+                pSRB->Release();
+        }
+    }
+
+    EXPECT_EQ(pLoader->PurgeShaderResourceBindings(), 3u);
+    EXPECT_EQ(pLoader->PurgeShaderResourceBindings(), 0u);
+}
+
 } // namespace
@@ -0,0 +1,495 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "json.hpp"
+#include "png.h"
+
+#include "RefCntAutoPtr.hpp"
+#include "DataBlobImpl.hpp"
+#include "GraphicsAccessories.hpp"
+#include "GPUTestingEnvironment.hpp"
+#include "GLTFLoader.hpp"
+#include "ImGuiImplDiligent.hpp"
+#include "imgui.h"
+#include "PNGCodec.h"
+#include "TextureLoader.h"
+#include "RenderStateNotationLoader.h"
+#include "DefaultShaderSourceStreamFactory.h"
+
+using namespace Diligent;
+using namespace Diligent::Testing;
+
+// The tests in this file measure the GPU-side cost of the tools and record the results to a JSON file
+// given by the DILIGENT_TOOLS_PERF_RESULTS environment variable (ToolsGPUPerformance.json by default).
+// Each result is tagged with the device type, so that the files produced by different backends can be
+// compared between runs. The tests only fail if the measured operation fails.
+
+namespace
+{
+
+using Clock = std::chrono::high_resolution_clock;
+
+double SecondsSince(Clock::time_point Start)
+{
+    return std::chrono::duration<double>(Clock::now() - Start).count();
+}
+
+class PerfResults
+{
+public:
+    static PerfResults& Get()
+    {
+        static PerfResults Results;
+        return Results;
+    }
+
+    // Adds the result and rewrites the output file, so that the results of the tests
+    // that completed are kept if a later test crashes.
+    void Add(const char* Test, const std::string& Case, const char* Metric, double Value, const char* Unit)
+    {
+        auto* pDevice = GPUTestingEnvironment::GetInstance()->GetDevice();
+
+        nlohmann::json Result;
+        Result["test"]    = Test;
+        Result["case"]    = Case;
+        Result["metric"]  = Metric;
+        Result["value"]   = Value;
+        Result["unit"]    = Unit;
+        Result["backend"] = GetRenderDeviceTypeString(pDevice->GetDeviceInfo().Type);
+        m_Results.push_back(std::move(Result));
+
+        LOG_INFO_MESSAGE(Test, " (", Case, "): ", Metric, " = ", Value, ' ', Unit);
+
+        const char* Path = std::getenv("DILIGENT_TOOLS_PERF_RESULTS");
+        if (Path == nullptr || *Path == '\0')
+            Path = "ToolsGPUPerformance.json";
+
+        std::ofstream File{Path};
+        if (File)
+            File << nlohmann::json{{"results", m_Results}}.dump(4);
+        else
+            LOG_WARNING_MESSAGE("Failed to write performance results to '", Path, "'");
+    }
+
+private:
+    nlohmann::json::array_t m_Results;
+};
+
+std::vector<Uint8> MakeTestPixels(Uint32 Width, Uint32 Height)
+{
+    std::vector<Uint8> Pixels(size_t{Width} * Height * 4);
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            auto* pPixel = &Pixels[(size_t{y} * Width + x) * 4];
+            pPixel[0]    = static_cast<Uint8>(x);
+            pPixel[1]    = static_cast<Uint8>(y);
+            pPixel[2]    = static_cast<Uint8>(x ^ y);
+            pPixel[3]    = 255;
+        }
+    }
+    return Pixels;
+}
+
+RefCntAutoPtr<DataBlobImpl> MakeTestPng(Uint32 Width, Uint32 Height)
+{
+    const auto Pixels  = MakeTestPixels(Width, Height);
+    auto       pPngData = DataBlobImpl::Create();
+    if (EncodePng(Pixels.data(), Width, Height, Width * 4, PNG_COLOR_TYPE_RGBA, pPngData) != ENCODE_PNG_RESULT_OK)
+        return {};
+    return pPngData;
+}
+
+// Creates a glTF model with a single GridSize x GridSize mesh and a TextureSize x TextureSize base color texture.
+// The files are returned by the read callback, so that nothing is written to disk.
+struct SyntheticModel
+{
+    std::string        Gltf;
+    std::vector<Uint8> Bin;
+    std::vector<Uint8> Png;
+
+    SyntheticModel(Uint32 GridSize, Uint32 TextureSize)
+    {
+        const Uint32 NumVerts   = GridSize * GridSize;
+        const Uint32 NumIndices = (GridSize - 1) * (GridSize - 1) * 6;
+
+        std::vector<float>  Positions;
+        std::vector<float>  Normals;
+        std::vector<float>  UVs;
+        std::vector<Uint32> Indices;
+        Positions.reserve(NumVerts * 3);
+        Normals.reserve(NumVerts * 3);
+        UVs.reserve(NumVerts * 2);
+        Indices.reserve(NumIndices);
+        for (Uint32 y = 0; y < GridSize; ++y)
+        {
+            for (Uint32 x = 0; x < GridSize; ++x)
+            {
+                const float u = static_cast<float>(x) / static_cast<float>(GridSize - 1);
+                const float v = static_cast<float>(y) / static_cast<float>(GridSize - 1);
+                Positions.insert(Positions.end(), {u, 0, v});
+                Normals.insert(Normals.end(), {0, 1, 0});
+                UVs.insert(UVs.end(), {u, v});
+            }
+        }
+        for (Uint32 y = 0; y + 1 < GridSize; ++y)
+        {
+            for (Uint32 x = 0; x + 1 < GridSize; ++x)
+            {
+                const Uint32 i0 = y * GridSize + x;
+                const Uint32 i1 = i0 + GridSize;
+                Indices.insert(Indices.end(), {i0, i1, i0 + 1, i0 + 1, i1, i1 + 1});
+            }
+        }
+
+        auto Append = [this](const void* pData, size_t Size) {
+            const auto Offset = Bin.size();
+            Bin.insert(Bin.end(), static_cast<const Uint8*>(pData), static_cast<const Uint8*>(pData) + Size);
+            return Offset;
+        };
+        const size_t PosSize = Positions.size() * sizeof(float);
+        const size_t NrmSize = Normals.size() * sizeof(float);
+        const size_t UVSize  = UVs.size() * sizeof(float);
+        const size_t IdxSize = Indices.size() * sizeof(Uint32);
+
+        const auto PosOffset = Append(Positions.data(), PosSize);
+        const auto NrmOffset = Append(Normals.data(), NrmSize);
+        const auto UVOffset  = Append(UVs.data(), UVSize);
+        const auto IdxOffset = Append(Indices.data(), IdxSize);
+
+        if (auto pPng = MakeTestPng(TextureSize, TextureSize))
+        {
+            const auto* pData = static_cast<const Uint8*>(pPng->GetConstDataPtr());
+            Png.assign(pData, pData + pPng->GetSize());
+        }
+
+        using json = nlohmann::json;
+
+        json Primitive;
+        Primitive["attributes"] = {{"POSITION", 0}, {"NORMAL", 1}, {"TEXCOORD_0", 2}};
+        Primitive["indices"]    = 3;
+        Primitive["material"]   = 0;
+
+        json Mesh;
+        Mesh["primitives"] = json::array({Primitive});
+
+        json Material;
+        Material["pbrMetallicRoughness"]["baseColorTexture"]["index"] = 0;
+
+        auto MakeBufferView = [](size_t Offset, size_t Size, int Target) {
+            json View;
+            View["buffer"]     = 0;
+            View["byteOffset"] = Offset;
+            View["byteLength"] = Size;
+            View["target"]     = Target;
+            return View;
+        };
+        auto MakeAccessor = [](int View, int ComponentType, Uint32 Count, const char* Type) {
+            json Accessor;
+            Accessor["bufferView"]    = View;
+            Accessor["componentType"] = ComponentType;
+            Accessor["count"]         = Count;
+            Accessor["type"]          = Type;
+            return Accessor;
+        };
+
+        json PosAccessor   = MakeAccessor(0, 5126, NumVerts, "VEC3");
+        PosAccessor["min"] = json::array({0, 0, 0});
+        PosAccessor["max"] = json::array({1, 0, 1});
+
+        json Json;
+        Json["asset"]["version"] = "2.0";
+        Json["scene"]            = 0;
+        Json["scenes"]           = json::array({json::object({{"nodes", json::array({0})}})});
+        Json["nodes"]            = json::array({json::object({{"mesh", 0}})});
+        Json["meshes"]           = json::array({Mesh});
+        Json["materials"]        = json::array({Material});
+        Json["textures"]         = json::array({json::object({{"source", 0}})});
+        Json["images"]           = json::array({json::object({{"uri", "PerfModel.png"}})});
+        Json["buffers"]          = json::array({json::object({{"uri", "PerfModel.bin"}, {"byteLength", Bin.size()}})});
+        Json["bufferViews"]      = json::array({
+            MakeBufferView(PosOffset, PosSize, 34962), // ARRAY_BUFFER
+            MakeBufferView(NrmOffset, NrmSize, 34962),
+            MakeBufferView(UVOffset, UVSize, 34962),
+            MakeBufferView(IdxOffset, IdxSize, 34963), // ELEMENT_ARRAY_BUFFER
+        });
+        Json["accessors"] = json::array({
+            PosAccessor,
+            MakeAccessor(1, 5126, NumVerts, "VEC3"), // FLOAT
+            MakeAccessor(2, 5126, NumVerts, "VEC2"),
+            MakeAccessor(3, 5125, NumIndices, "SCALAR"), // UNSIGNED_INT
+        });
+        Gltf = Json.dump();
+    }
+
+    bool ReadFile(const char* FilePath, std::vector<unsigned char>& Data, std::string& Error) const
+    {
+        const std::string Path{FilePath};
+        auto              EndsWith = [&Path](const char* Suffix) {
+            const size_t Len = strlen(Suffix);
+            return Path.size() >= Len && Path.compare(Path.size() - Len, Len, Suffix) == 0;
+        };
+
+        if (EndsWith("PerfModel.gltf"))
+            Data.assign(Gltf.begin(), Gltf.end());
+        else if (EndsWith("PerfModel.bin"))
+            Data.assign(Bin.begin(), Bin.end());
+        else if (EndsWith("PerfModel.png"))
+            Data.assign(Png.begin(), Png.end());
+        else
+        {
+            Error = "Unknown file " + Path;
+            return false;
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+TEST(Tools_GPUPerformance, ModelUploadThroughput)
+{
+    auto* pEnvironment = GPUTestingEnvironment::GetInstance();
+    ASSERT_NE(pEnvironment, nullptr);
+
+    auto* pDevice  = pEnvironment->GetDevice();
+    auto* pContext = pEnvironment->GetDeviceContext();
+
+    struct
+    {
+        Uint32 GridSize;
+        Uint32 TextureSize;
+    } const Cases[] = {{64, 256}, {256, 1024}, {1024, 2048}};
+
+    for (const auto& Case : Cases)
+    {
+        const SyntheticModel Synthetic{Case.GridSize, Case.TextureSize};
+
+        GLTF::ModelCreateInfo ModelCI;
+        ModelCI.FileName              = "PerfModel.gltf";
+        ModelCI.FileExistsCallback    = [](const char*) { return true; };
+        ModelCI.ReadWholeFileCallback = [&Synthetic](const char* FilePath, std::vector<unsigned char>& Data, std::string& Error) {
+            return Synthetic.ReadFile(FilePath, Data, Error);
+        };
+
+        // Passing null context defers the upload to PrepareGPUResources()
+        GLTF::Model Model{pDevice, nullptr, ModelCI};
+        const auto  UploadSize = Model.GetCPUDataSize();
+        ASSERT_GT(UploadSize, Uint64{0});
+
+        pContext->WaitForIdle();
+        const auto Start = Clock::now();
+        Model.PrepareGPUResources(pDevice, pContext);
+        pContext->Flush();
+        pContext->WaitForIdle();
+        const auto Time = SecondsSince(Start);
+        EXPECT_TRUE(Model.IsGPUDataInitialized());
+
+        const auto CaseName = std::to_string(Case.GridSize) + "x" + std::to_string(Case.GridSize) + " grid, " +
+            std::to_string(Case.TextureSize) + "x" + std::to_string(Case.TextureSize) + " texture";
+        PerfResults::Get().Add("Model::PrepareGPUResources", CaseName, "throughput", static_cast<double>(UploadSize) / (1 << 20) / std::max(Time, 1e-6), "MB/s");
+    }
+}
+
+TEST(Tools_GPUPerformance, ImGuiRenderDrawData)
+{
+    auto* pEnvironment = GPUTestingEnvironment::GetInstance();
+    ASSERT_NE(pEnvironment, nullptr);
+
+    auto* pDevice  = pEnvironment->GetDevice();
+    auto* pContext = pEnvironment->GetDeviceContext();
+
+    constexpr Uint32 Width  = 1280;
+    constexpr Uint32 Height = 1024;
+
+    TextureDesc TexDesc;
+    TexDesc.Name      = "ImGui perf test render target";
+    TexDesc.Type      = RESOURCE_DIM_TEX_2D;
+    TexDesc.Width     = Width;
+    TexDesc.Height    = Height;
+    TexDesc.Format    = TEX_FORMAT_RGBA8_UNORM;
+    TexDesc.BindFlags = BIND_RENDER_TARGET;
+    RefCntAutoPtr<ITexture> pRenderTarget;
+    pDevice->CreateTexture(TexDesc, nullptr, &pRenderTarget);
+    ASSERT_NE(pRenderTarget, nullptr);
+
+    TexDesc.Name      = "ImGui perf test depth buffer";
+    TexDesc.Format    = TEX_FORMAT_D32_FLOAT;
+    TexDesc.BindFlags = BIND_DEPTH_STENCIL;
+    RefCntAutoPtr<ITexture> pDepth;
+    pDevice->CreateTexture(TexDesc, nullptr, &pDepth);
+    ASSERT_NE(pDepth, nullptr);
+
+    ImGuiImplDiligent ImGuiImpl{pDevice, TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_D32_FLOAT, 1024, 2048};
+
+    ImGuiIO& io    = ImGui::GetIO();
+    io.DisplaySize = ImVec2{static_cast<float>(Width), static_cast<float>(Height)};
+    io.DeltaTime   = 1.f / 60.f;
+
+    constexpr Uint32 NumFrames = 32;
+    for (Uint32 NumWindows : {1u, 8u, 32u})
+    {
+        constexpr Uint32 NumLinesPerWindow = 64;
+
+        double TotalTime    = 0;
+        int    TotalVertCnt = 0;
+        for (Uint32 Frame = 0; Frame < NumFrames; ++Frame)
+        {
+            ImGuiImpl.NewFrame(Width, Height, SURFACE_TRANSFORM_IDENTITY);
+            for (Uint32 Wnd = 0; Wnd < NumWindows; ++Wnd)
+            {
+                ImGui::SetNextWindowPos(ImVec2{static_cast<float>(Wnd % 8) * 150.f, static_cast<float>(Wnd / 8) * 250.f});
+                ImGui::SetNextWindowSize(ImVec2{300, 400});
+                ImGui::Begin(("Window " + std::to_string(Wnd)).c_str());
+                for (Uint32 Line = 0; Line < NumLinesPerWindow; ++Line)
+                {
+                    ImGui::Text("Line %u: frame %u", Line, Frame);
+                    if (Line % 8 == 0)
+                        ImGui::Button("Button");
+                }
+                ImGui::End();
+            }
+            ImGui::Render();
+
+            auto* pDrawData = ImGui::GetDrawData();
+            TotalVertCnt    = pDrawData->TotalVtxCount;
+
+            ITextureView* pRTV = pRenderTarget->GetDefaultView(TEXTURE_VIEW_RENDER_TARGET);
+            pContext->SetRenderTargets(1, &pRTV, pDepth->GetDefaultView(TEXTURE_VIEW_DEPTH_STENCIL), RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+
+            // The first frame creates the device objects and is not counted
+            const auto Start = Clock::now();
+            ImGuiImpl.RenderDrawData(pContext, pDrawData);
+            pContext->Flush();
+            if (Frame > 0)
+                TotalTime += SecondsSince(Start);
+        }
+        pContext->WaitForIdle();
+
+        const auto CaseName = std::to_string(NumWindows) + " windows, " + std::to_string(TotalVertCnt) + " vertices";
+        PerfResults::Get().Add("ImGuiDiligentRenderer::RenderDrawData", CaseName, "CPU time", TotalTime / (NumFrames - 1) * 1000, "ms");
+    }
+}
+
+TEST(Tools_GPUPerformance, TextureLoaderCreateTexture)
+{
+    auto* pEnvironment = GPUTestingEnvironment::GetInstance();
+    ASSERT_NE(pEnvironment, nullptr);
+
+    auto* pDevice  = pEnvironment->GetDevice();
+    auto* pContext = pEnvironment->GetDeviceContext();
+
+    for (Uint32 Size : {256u, 1024u, 2048u})
+    {
+        auto pPngData = MakeTestPng(Size, Size);
+        ASSERT_NE(pPngData, nullptr);
+
+        TextureLoadInfo LoadInfo;
+        LoadInfo.Name = "Perf test texture";
+
+        RefCntAutoPtr<ITextureLoader> pLoader;
+        CreateTextureLoaderFromMemory(pPngData->GetConstDataPtr(), pPngData->GetSize(), IMAGE_FILE_FORMAT_PNG, false, LoadInfo, &pLoader);
+        ASSERT_NE(pLoader, nullptr);
+
+        constexpr Uint32 NumIterations = 8;
+
+        double TotalTime = 0;
+        for (Uint32 i = 0; i < NumIterations; ++i)
+        {
+            pContext->WaitForIdle();
+            const auto Start = Clock::now();
+
+            RefCntAutoPtr<ITexture> pTexture;
+            pLoader->CreateTexture(pDevice, &pTexture);
+            ASSERT_NE(pTexture, nullptr);
+            pContext->Flush();
+            pContext->WaitForIdle();
+
+            TotalTime += SecondsSince(Start);
+        }
+
+        const auto CaseName = std::to_string(Size) + "x" + std::to_string(Size) + " RGBA8 with mips";
+        PerfResults::Get().Add("ITextureLoader::CreateTexture", CaseName, "latency", TotalTime / NumIterations * 1000, "ms");
+    }
+}
+
+TEST(Tools_GPUPerformance, RenderStateNotationPSOCreation)
+{
+    auto* pEnvironment = GPUTestingEnvironment::GetInstance();
+    ASSERT_NE(pEnvironment, nullptr);
+
+    auto* pDevice = pEnvironment->GetDevice();
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pRSNStreamFactory;
+    CreateDefaultShaderSourceStreamFactory("RenderStates", &pRSNStreamFactory);
+
+    RefCntAutoPtr<IRenderStateNotationParser> pParser;
+    CreateRenderStateNotationParser({}, &pParser);
+    ASSERT_NE(pParser, nullptr);
+    ASSERT_TRUE(pParser->ParseFile("PSO.json", pRSNStreamFactory));
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pShaderStreamFactory;
+    CreateDefaultShaderSourceStreamFactory("Shaders", &pShaderStreamFactory);
+
+    RenderStateNotationLoaderCreateInfo LoaderCI{};
+    LoaderCI.pDevice        = pDevice;
+    LoaderCI.pParser        = pParser;
+    LoaderCI.pStreamFactory = pShaderStreamFactory;
+
+    RefCntAutoPtr<IRenderStateNotationLoader> pLoader;
+    CreateRenderStateNotationLoader(LoaderCI, &pLoader);
+    ASSERT_NE(pLoader, nullptr);
+
+    LoadPipelineStateInfo PipelineLI{};
+    PipelineLI.Name         = "GeometryOpaque";
+    PipelineLI.PipelineType = PIPELINE_TYPE_GRAPHICS;
+    // Every iteration compiles the shaders and creates a new pipeline
+    PipelineLI.AddToCache = false;
+
+    constexpr Uint32 NumPSOs = 16;
+
+    const auto Start = Clock::now();
+    for (Uint32 i = 0; i < NumPSOs; ++i)
+    {
+        RefCntAutoPtr<IPipelineState> pPSO;
+        pLoader->LoadPipelineState(PipelineLI, &pPSO);
+        ASSERT_NE(pPSO, nullptr);
+    }
+    const auto Time = SecondsSince(Start);
+
+    PerfResults::Get().Add("IRenderStateNotationLoader::LoadPipelineState", PipelineLI.Name, "creation rate", NumPSOs / std::max(Time, 1e-6), "PSO/s");
+}
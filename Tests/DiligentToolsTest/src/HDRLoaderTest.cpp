@@ -0,0 +1,152 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include "../interface/HDRLoader.h"
+#include "../interface/Image.h"
+
+#include "gtest/gtest.h"
+
+#include "DataBlobImpl.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+using namespace Diligent;
+
+namespace
+{
+
+// Creates a Radiance HDR file with run-length encoded scanlines where every
+// pixel of row y has the mantissas (128, 64, 32) and exponent 128 + y % 4.
+RefCntAutoPtr<DataBlobImpl> CreateTestHDRFile(Uint32 Width, Uint32 Height, const char* Orientation = "-Y")
+{
+    const std::string Header = std::string{"#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n"} +
+        Orientation + " " + std::to_string(Height) + " +X " + std::to_string(Width) + "\n";
+
+    std::vector<Uint8> Data{Header.begin(), Header.end()};
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        Data.insert(Data.end(), {2, 2, static_cast<Uint8>(Width >> 8), static_cast<Uint8>(Width & 0xFF)});
+
+        const Uint8 Values[] = {128, 64, 32, static_cast<Uint8>(128 + y % 4)};
+        for (const auto Value : Values)
+        {
+            for (Uint32 x = 0; x < Width; x += 127)
+            {
+                const auto Count = std::min(Width - x, 127u);
+                Data.push_back(static_cast<Uint8>(128 + Count));
+                Data.push_back(Value);
+            }
+        }
+    }
+
+    return DataBlobImpl::Create(Data.size(), Data.data());
+}
+
+float HalfToFloat(Uint16 Half)
+{
+    const Uint32 Exp      = (Half >> 10) & 0x1Fu;
+    const Uint32 Mantissa = Half & 0x3FFu;
+    // Test values are normalized halves
+    const auto Value = std::ldexp(1.f + static_cast<float>(Mantissa) / 1024.f, static_cast<int>(Exp) - 15);
+    return (Half & 0x8000u) ? -Value : Value;
+}
+
+TEST(Tools_TextureLoader, HDRLoader)
+{
+    constexpr Uint32 TestImgWidth  = 300;
+    constexpr Uint32 TestImgHeight = 7;
+
+    for (const char* Orientation : {"-Y", "+Y"})
+    {
+        auto pHDRData = CreateTestHDRFile(TestImgWidth, TestImgHeight, Orientation);
+        auto pPixels  = DataBlobImpl::Create();
+
+        ImageDesc Desc;
+        ASSERT_TRUE(LoadHDR(pHDRData, pPixels, &Desc));
+        EXPECT_EQ(Desc.Width, TestImgWidth);
+        EXPECT_EQ(Desc.Height, TestImgHeight);
+        EXPECT_EQ(Desc.ComponentType, VT_FLOAT16);
+        EXPECT_EQ(Desc.NumComponents, 4u);
+        EXPECT_EQ(Desc.RowStride, TestImgWidth * 4 * sizeof(Uint16));
+        ASSERT_EQ(pPixels->GetSize(), size_t{Desc.RowStride} * TestImgHeight);
+
+        const auto BottomUp = Orientation[0] == '+';
+        for (Uint32 y = 0; y < TestImgHeight; ++y)
+        {
+            const auto  SrcRow = BottomUp ? TestImgHeight - 1 - y : y;
+            const auto  Scale  = std::ldexp(1.f, static_cast<int>(SrcRow % 4) - 8);
+            const auto* pRow   = reinterpret_cast<const Uint16*>(static_cast<const Uint8*>(pPixels->GetConstDataPtr()) + y * Desc.RowStride);
+            for (Uint32 x = 0; x < TestImgWidth; ++x)
+            {
+                EXPECT_EQ(HalfToFloat(pRow[x * 4 + 0]), 128.f * Scale);
+                EXPECT_EQ(HalfToFloat(pRow[x * 4 + 1]), 64.f * Scale);
+                EXPECT_EQ(HalfToFloat(pRow[x * 4 + 2]), 32.f * Scale);
+                EXPECT_EQ(HalfToFloat(pRow[x * 4 + 3]), 1.f);
+            }
+        }
+    }
+}
+
+TEST(Tools_TextureLoader, HDRLoaderCorruptedData)
+{
+    auto pHDRData = CreateTestHDRFile(64, 4);
+    auto pPixels  = DataBlobImpl::Create();
+
+    // Truncated scanline data
+    auto pTruncated = DataBlobImpl::Create(pHDRData->GetSize() - 3, pHDRData->GetConstDataPtr());
+
+    ImageDesc Desc;
+    EXPECT_FALSE(LoadHDR(pTruncated, pPixels, &Desc));
+
+    // Unsupported pixel format
+    const std::string XYZE{"#?RADIANCE\nFORMAT=32-bit_rle_xyze\n\n-Y 1 +X 1\n\x80\x80\x80\x80"};
+    auto              pXYZEData = DataBlobImpl::Create(XYZE.size(), XYZE.data());
+    EXPECT_FALSE(LoadHDR(pXYZEData, pPixels, &Desc));
+}
+
+TEST(Tools_TextureLoader, HDRProbe)
+{
+    auto pHDRData = CreateTestHDRFile(40, 24);
+
+    const auto* pData = static_cast<const Uint8*>(pHDRData->GetConstDataPtr());
+    EXPECT_EQ(Image::GetFileFormat(pData, pHDRData->GetSize()), IMAGE_FILE_FORMAT_HDR);
+
+    ImageProbeInfo Info;
+    ASSERT_TRUE(ProbeImage(pData, pHDRData->GetSize(), Info));
+    EXPECT_EQ(Info.FileFormat, IMAGE_FILE_FORMAT_HDR);
+    EXPECT_EQ(Info.Width, 40u);
+    EXPECT_EQ(Info.Height, 24u);
+    EXPECT_EQ(Info.NumComponents, 4u);
+    EXPECT_EQ(Info.ComponentType, VT_FLOAT16);
+
+    // The resolution string is missing
+    EXPECT_FALSE(ProbeImage(pData, 36, Info));
+}
+
+} // namespace
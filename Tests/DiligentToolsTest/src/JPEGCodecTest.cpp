@@ -26,6 +26,7 @@
  */
 
 #include "../interface/JPEGCodec.h"
+#include "../interface/Image.h"
 
 #include "gtest/gtest.h"
 
@@ -88,4 +89,98 @@ TEST(Tools_TextureLoader, JPEGCodec)
     }
 }
 
+TEST(Tools_TextureLoader, JPEGCodecScaledDecode)
+{
+    constexpr Uint32 TestImgWidth  = 250;
+    constexpr Uint32 TestImgHeight = 130;
+    constexpr Uint32 NumComponents = 3;
+
+    // Smooth gradient so that the downscaled image can be compared with the box-filtered reference
+    std::vector<Uint8> RefPixels(TestImgWidth * TestImgHeight * NumComponents);
+    for (Uint32 y = 0; y < TestImgHeight; ++y)
+    {
+        for (Uint32 x = 0; x < TestImgWidth; ++x)
+        {
+            auto idx = x + y * TestImgWidth;
+
+            RefPixels[idx * NumComponents + 0] = static_cast<Uint8>(x);
+            RefPixels[idx * NumComponents + 1] = static_cast<Uint8>(y);
+            RefPixels[idx * NumComponents + 2] = static_cast<Uint8>(128);
+        }
+    }
+
+    auto pJpgData = DataBlobImpl::Create();
+
+    auto Res = EncodeJpeg(RefPixels.data(), TestImgWidth, TestImgHeight, 100, pJpgData);
+    ASSERT_EQ(Res, ENCODE_JPEG_RESULT_OK);
+
+    for (Uint32 ScaleDenom : {2u, 4u, 8u})
+    {
+        auto pDecodedPixelsBlob = DataBlobImpl::Create();
+
+        ImageDesc DecodedImgDesc;
+        Res = DecodeJpeg(pJpgData, pDecodedPixelsBlob, &DecodedImgDesc, ScaleDenom);
+        ASSERT_EQ(Res, DECODE_JPEG_RESULT_OK);
+
+        ASSERT_EQ(DecodedImgDesc.Width, (TestImgWidth + ScaleDenom - 1) / ScaleDenom);
+        ASSERT_EQ(DecodedImgDesc.Height, (TestImgHeight + ScaleDenom - 1) / ScaleDenom);
+        ASSERT_EQ(DecodedImgDesc.NumComponents, NumComponents);
+
+        const Uint8* pTestPixels = reinterpret_cast<const Uint8*>(pDecodedPixelsBlob->GetDataPtr());
+        // Only check texels whose footprint is fully inside the image
+        for (Uint32 y = 0; y < TestImgHeight / ScaleDenom; ++y)
+        {
+            for (Uint32 x = 0; x < TestImgWidth / ScaleDenom; ++x)
+            {
+                for (Uint32 c = 0; c < NumComponents; ++c)
+                {
+                    float RefVal = 0;
+                    for (Uint32 j = 0; j < ScaleDenom; ++j)
+                    {
+                        for (Uint32 i = 0; i < ScaleDenom; ++i)
+                            RefVal += RefPixels[((x * ScaleDenom + i) + (y * ScaleDenom + j) * TestImgWidth) * NumComponents + c];
+                    }
+                    RefVal /= static_cast<float>(ScaleDenom * ScaleDenom);
+
+                    auto TestVal = pTestPixels[x * DecodedImgDesc.NumComponents + c + y * DecodedImgDesc.RowStride];
+                    EXPECT_LE(std::abs(RefVal - static_cast<float>(TestVal)), 3.f) << "1/" << ScaleDenom << " [" << x << "," << y << "][" << c << "]";
+                }
+            }
+        }
+    }
+
+    // Unsupported scale
+    auto pDecodedPixelsBlob = DataBlobImpl::Create();
+
+    ImageDesc DecodedImgDesc;
+    EXPECT_EQ(DecodeJpeg(pJpgData, pDecodedPixelsBlob, &DecodedImgDesc, 3), DECODE_JPEG_RESULT_INVALID_ARGUMENTS);
+}
+
+TEST(Tools_TextureLoader, JPEGCodecProbe)
+{
+    constexpr Uint32 TestImgWidth  = 75;
+    constexpr Uint32 TestImgHeight = 41;
+    constexpr Uint32 NumComponents = 3;
+
+    std::vector<Uint8> RefPixels(TestImgWidth * TestImgHeight * NumComponents, 128);
+
+    auto pJpgData = DataBlobImpl::Create();
+
+    auto Res = EncodeJpeg(RefPixels.data(), TestImgWidth, TestImgHeight, 90, pJpgData);
+    ASSERT_EQ(Res, ENCODE_JPEG_RESULT_OK);
+
+    const auto* pData = static_cast<const Uint8*>(pJpgData->GetConstDataPtr());
+
+    ImageProbeInfo Info;
+    ASSERT_TRUE(ProbeImage(pData, pJpgData->GetSize(), Info));
+    EXPECT_EQ(Info.FileFormat, IMAGE_FILE_FORMAT_JPEG);
+    EXPECT_EQ(Info.Width, TestImgWidth);
+    EXPECT_EQ(Info.Height, TestImgHeight);
+    EXPECT_EQ(Info.NumComponents, NumComponents);
+    EXPECT_EQ(Info.ComponentType, VT_UINT8);
+
+    // SOI marker only
+    EXPECT_FALSE(ProbeImage(pData, 4, Info));
+}
+
 } // namespace
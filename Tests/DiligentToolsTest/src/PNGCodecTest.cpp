@@ -26,11 +26,14 @@
  */
 
 #include "../interface/PNGCodec.h"
+#include "../interface/Image.h"
 #include "png.h"
 
 #include "gtest/gtest.h"
 
 #include <vector>
+#include <cstring>
+#include <algorithm>
 
 #include "DataBlobImpl.hpp"
 
@@ -96,4 +99,142 @@ TEST(Tools_TextureLoader, PNGCodec)
     }
 }
 
+TEST(Tools_TextureLoader, PNGCodecDecodeIntoMemory)
+{
+    constexpr Uint32 TestImgWidth  = 67;
+    constexpr Uint32 TestImgHeight = 33;
+    constexpr Uint32 NumComponents = 3;
+
+    std::vector<Uint8> RefPixels(TestImgWidth * TestImgHeight * NumComponents);
+    for (size_t i = 0; i < RefPixels.size(); ++i)
+        RefPixels[i] = static_cast<Uint8>(i * 7 + 3);
+
+    auto pPngData = DataBlobImpl::Create();
+
+    auto Res = EncodePng(RefPixels.data(), TestImgWidth, TestImgHeight, TestImgWidth * NumComponents, PNG_COLOR_TYPE_RGB, pPngData);
+    ASSERT_EQ(Res, ENCODE_PNG_RESULT_OK);
+
+    // Read the header only
+    ImageDesc DecodedImgDesc;
+    Res = DecodePngIntoMemory(pPngData, nullptr, 0, 0, &DecodedImgDesc);
+    ASSERT_EQ(Res, DECODE_PNG_RESULT_OK);
+    ASSERT_EQ(DecodedImgDesc.Width, TestImgWidth);
+    ASSERT_EQ(DecodedImgDesc.Height, TestImgHeight);
+    ASSERT_EQ(DecodedImgDesc.NumComponents, NumComponents);
+
+    for (Uint32 DstCompCount = 1; DstCompCount <= 4; ++DstCompCount)
+    {
+        // Use padded stride to make sure the function respects it
+        const Uint32       DstStride = TestImgWidth * DstCompCount + 13;
+        std::vector<Uint8> DstPixels(size_t{DstStride} * TestImgHeight, 0xCD);
+
+        Res = DecodePngIntoMemory(pPngData, DstPixels.data(), DstStride, DstCompCount, &DecodedImgDesc);
+        ASSERT_EQ(Res, DECODE_PNG_RESULT_OK);
+        EXPECT_EQ(DecodedImgDesc.NumComponents, DstCompCount);
+        EXPECT_EQ(DecodedImgDesc.RowStride, DstStride);
+
+        for (Uint32 y = 0; y < TestImgHeight; ++y)
+        {
+            for (Uint32 x = 0; x < TestImgWidth; ++x)
+            {
+                for (Uint32 c = 0; c < DstCompCount; ++c)
+                {
+                    const Uint32 RefVal  = c < NumComponents ? RefPixels[(x + y * TestImgWidth) * NumComponents + c] : 255u;
+                    const Uint32 TestVal = DstPixels[x * DstCompCount + c + y * DstStride];
+                    EXPECT_EQ(RefVal, TestVal) << DstCompCount << " [" << x << "," << y << "][" << c << "]";
+                }
+            }
+            // Padding must not be touched
+            EXPECT_EQ(DstPixels[y * DstStride + TestImgWidth * DstCompCount], 0xCD);
+        }
+    }
+
+    // Stride is too small
+    std::vector<Uint8> DstPixels(TestImgWidth * 4 * TestImgHeight);
+    EXPECT_EQ(DecodePngIntoMemory(pPngData, DstPixels.data(), TestImgWidth * 3, 4, &DecodedImgDesc), DECODE_PNG_RESULT_INVALID_ARGUMENTS);
+}
+
+
+TEST(Tools_TextureLoader, PNGCodecEncodeOptions)
+{
+    constexpr Uint32 TestImgWidth  = 45;
+    constexpr Uint32 TestImgHeight = 29;
+    constexpr Uint32 NumComponents = 4;
+
+    std::vector<Uint8> RefPixels(TestImgWidth * TestImgHeight * NumComponents);
+    for (size_t i = 0; i < RefPixels.size(); ++i)
+        RefPixels[i] = static_cast<Uint8>((i * 5) / 3);
+
+    for (Uint8 Filter = PNG_ENCODE_FILTER_ADAPTIVE; Filter <= PNG_ENCODE_FILTER_PAETH; ++Filter)
+    {
+        for (Uint8 Strategy = PNG_ENCODE_STRATEGY_DEFAULT; Strategy <= PNG_ENCODE_STRATEGY_RLE; ++Strategy)
+        {
+            PngEncodeOptions Options;
+            Options.CompressionLevel = 1;
+            Options.Filter           = static_cast<PNG_ENCODE_FILTER>(Filter);
+            Options.Strategy         = static_cast<PNG_ENCODE_STRATEGY>(Strategy);
+
+            auto pPngData = DataBlobImpl::Create();
+
+            auto Res = EncodePng(RefPixels.data(), TestImgWidth, TestImgHeight, TestImgWidth * NumComponents, PNG_COLOR_TYPE_RGBA, pPngData, &Options);
+            ASSERT_EQ(Res, ENCODE_PNG_RESULT_OK);
+
+            auto pDecodedPixelsBlob = DataBlobImpl::Create();
+
+            ImageDesc DecodedImgDesc;
+            ASSERT_EQ(DecodePng(pPngData, pDecodedPixelsBlob, &DecodedImgDesc), DECODE_PNG_RESULT_OK);
+            ASSERT_EQ(DecodedImgDesc.Width, TestImgWidth);
+            ASSERT_EQ(DecodedImgDesc.Height, TestImgHeight);
+            ASSERT_EQ(DecodedImgDesc.NumComponents, NumComponents);
+
+            const Uint8* pTestPixels = reinterpret_cast<const Uint8*>(pDecodedPixelsBlob->GetDataPtr());
+            for (Uint32 y = 0; y < TestImgHeight; ++y)
+            {
+                EXPECT_EQ(memcmp(pTestPixels + y * DecodedImgDesc.RowStride, &RefPixels[y * TestImgWidth * NumComponents], TestImgWidth * NumComponents), 0)
+                    << "Filter " << Uint32{Filter} << ", strategy " << Uint32{Strategy} << ", row " << y;
+            }
+        }
+    }
+
+    PngEncodeOptions Options;
+    Options.CompressionLevel = 10;
+    auto pPngData            = DataBlobImpl::Create();
+    EXPECT_EQ(EncodePng(RefPixels.data(), TestImgWidth, TestImgHeight, TestImgWidth * NumComponents, PNG_COLOR_TYPE_RGBA, pPngData, &Options), ENCODE_PNG_RESULT_INVALID_ARGUMENTS);
+}
+
+TEST(Tools_TextureLoader, PNGCodecProbe)
+{
+    constexpr Uint32 TestImgWidth  = 45;
+    constexpr Uint32 TestImgHeight = 31;
+
+    for (Uint32 NumComponents = 3; NumComponents <= 4; ++NumComponents)
+    {
+        std::vector<Uint8> RefPixels(TestImgWidth * TestImgHeight * NumComponents);
+        for (size_t i = 0; i < RefPixels.size(); ++i)
+            RefPixels[i] = static_cast<Uint8>(i * 5 + 1);
+
+        auto pPngData = DataBlobImpl::Create();
+        auto Res      = EncodePng(RefPixels.data(), TestImgWidth, TestImgHeight, TestImgWidth * NumComponents,
+                             NumComponents == 4 ? PNG_COLOR_TYPE_RGBA : PNG_COLOR_TYPE_RGB, pPngData);
+        ASSERT_EQ(Res, ENCODE_PNG_RESULT_OK);
+
+        // The header fits into the first 64 bytes
+        ImageProbeInfo Info;
+        ASSERT_TRUE(ProbeImage(static_cast<const Uint8*>(pPngData->GetConstDataPtr()), std::min(pPngData->GetSize(), size_t{64}), Info));
+        EXPECT_EQ(Info.FileFormat, IMAGE_FILE_FORMAT_PNG);
+        EXPECT_EQ(Info.Type, RESOURCE_DIM_TEX_2D);
+        EXPECT_EQ(Info.Width, TestImgWidth);
+        EXPECT_EQ(Info.Height, TestImgHeight);
+        EXPECT_EQ(Info.MipLevels, 1u);
+        EXPECT_EQ(Info.NumComponents, NumComponents);
+        EXPECT_EQ(Info.ComponentType, VT_UINT8);
+    }
+
+    // Truncated header
+    const Uint8    Signature[8] = {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A};
+    ImageProbeInfo Info;
+    EXPECT_FALSE(ProbeImage(Signature, sizeof(Signature), Info));
+    EXPECT_EQ(Info.FileFormat, IMAGE_FILE_FORMAT_UNKNOWN);
+}
+
 } // namespace
@@ -28,6 +28,7 @@
 #include "RefCntAutoPtr.hpp"
 #include "RenderStateNotationParser.h"
 #include "DefaultShaderSourceStreamFactory.h"
+#include "ThreadPool.hpp"
 #include "TestingEnvironment.hpp"
 #include "GraphicsTypesOutputInserters.hpp"
 
@@ -567,6 +568,7 @@ TEST(Tools_RenderStateNotationParser, RenderStateNotationParserTest)
 
         auto pResourceDst = pParser->GetShaderByName(pResourceSrc->Desc.Name);
         EXPECT_EQ(pResourceSrc, pResourceDst);
+        EXPECT_EQ(pResourceSrc, pParser->GetShaderByHash(ComputeNotationNameHash(pResourceSrc->Desc.Name)));
     });
 
     Iterate(ParserInfo.ResourceSignatureCount, [&](Uint32 Index) {
@@ -575,6 +577,7 @@ TEST(Tools_RenderStateNotationParser, RenderStateNotationParserTest)
 
         auto pResourceDst = pParser->GetResourceSignatureByName(pResourceSrc->Name);
         EXPECT_EQ(pResourceSrc, pResourceDst);
+        EXPECT_EQ(pResourceSrc, pParser->GetResourceSignatureByHash(ComputeNotationNameHash(pResourceSrc->Name)));
     });
 
     Iterate(ParserInfo.RenderPassCount, [&](Uint32 Index) {
@@ -583,6 +586,7 @@ TEST(Tools_RenderStateNotationParser, RenderStateNotationParserTest)
 
         auto pResourceDst = pParser->GetRenderPassByName(pResourceSrc->Name);
         EXPECT_EQ(pResourceSrc, pResourceDst);
+        EXPECT_EQ(pResourceSrc, pParser->GetRenderPassByHash(ComputeNotationNameHash(pResourceSrc->Name)));
     });
 
     Iterate(ParserInfo.PipelineStateCount, [&](Uint32 Index) {
@@ -591,7 +595,182 @@ TEST(Tools_RenderStateNotationParser, RenderStateNotationParserTest)
 
         auto pResourceDst = pParser->GetPipelineStateByName(pResourceSrc->PSODesc.Name);
         EXPECT_EQ(pResourceSrc, pResourceDst);
+        EXPECT_EQ(pResourceSrc, pParser->GetPipelineStateByHash(ComputeNotationNameHash(pResourceSrc->PSODesc.Name)));
+        EXPECT_EQ(pResourceSrc, pParser->GetPipelineStateByHash(ComputeNotationNameHash(pResourceSrc->PSODesc.Name), pResourceSrc->PSODesc.PipelineType));
     });
+
+    // The hashes of literal names are computed at compile time
+    constexpr auto UnknownNameHash = ComputeNotationNameHash("UnknownName");
+    EXPECT_EQ(pParser->GetPipelineStateByHash(UnknownNameHash), nullptr);
+    EXPECT_EQ(pParser->GetShaderByHash(UnknownNameHash), nullptr);
+}
+
+TEST(Tools_RenderStateNotationParser, PrecompiledNotationTest)
+{
+    RefCntAutoPtr<IRenderStateNotationParser> pRefParser = LoadFromFile("RenderStatesLibrary.json");
+    ASSERT_NE(pRefParser, nullptr);
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pStreamFactory;
+    CreateDefaultShaderSourceStreamFactory("RenderStates/RenderStateNotationParser", &pStreamFactory);
+    ASSERT_NE(pStreamFactory, nullptr);
+
+    const Char*              FilePath = "RenderStatesLibrary.json";
+    RefCntAutoPtr<IDataBlob> pPrecompiledData;
+    PrecompileRenderStateNotation(&FilePath, 1, pStreamFactory, &pPrecompiledData);
+    ASSERT_NE(pPrecompiledData, nullptr);
+
+    RefCntAutoPtr<IRenderStateNotationParser> pParser;
+    CreateRenderStateNotationParser({}, &pParser);
+    ASSERT_NE(pParser, nullptr);
+
+    // Imports are embedded, so no stream factory is needed
+    EXPECT_TRUE(pParser->ParseString(static_cast<const Char*>(pPrecompiledData->GetConstDataPtr()), static_cast<Uint32>(pPrecompiledData->GetSize()), nullptr));
+
+    const auto& RefInfo    = pRefParser->GetInfo();
+    const auto& ParserInfo = pParser->GetInfo();
+    EXPECT_EQ(ParserInfo.ShaderCount, RefInfo.ShaderCount);
+    EXPECT_EQ(ParserInfo.RenderPassCount, RefInfo.RenderPassCount);
+    EXPECT_EQ(ParserInfo.ResourceSignatureCount, RefInfo.ResourceSignatureCount);
+    EXPECT_EQ(ParserInfo.PipelineStateCount, RefInfo.PipelineStateCount);
+
+    for (Uint32 i = 0; i < RefInfo.ShaderCount; ++i)
+    {
+        const auto* pRef = pRefParser->GetShaderByIndex(i);
+        const auto* pDst = pParser->GetShaderByIndex(i);
+        ASSERT_NE(pDst, nullptr);
+        EXPECT_EQ(pRef->Desc, pDst->Desc);
+        EXPECT_STREQ(pRef->FilePath, pDst->FilePath);
+        EXPECT_STREQ(pRef->EntryPoint, pDst->EntryPoint);
+    }
+
+    for (Uint32 i = 0; i < RefInfo.RenderPassCount; ++i)
+    {
+        const auto* pDst = pParser->GetRenderPassByIndex(i);
+        ASSERT_NE(pDst, nullptr);
+        EXPECT_EQ(*pRefParser->GetRenderPassByIndex(i), *pDst);
+    }
+
+    for (Uint32 i = 0; i < RefInfo.ResourceSignatureCount; ++i)
+    {
+        const auto* pDst = pParser->GetResourceSignatureByIndex(i);
+        ASSERT_NE(pDst, nullptr);
+        EXPECT_EQ(*pRefParser->GetResourceSignatureByIndex(i), *pDst);
+    }
+
+    for (Uint32 i = 0; i < RefInfo.PipelineStateCount; ++i)
+    {
+        const auto* pRef = pRefParser->GetPipelineStateByIndex(i);
+        const auto* pDst = pParser->GetPipelineStateByIndex(i);
+        ASSERT_NE(pDst, nullptr);
+        EXPECT_EQ(pRef->PSODesc, pDst->PSODesc);
+        EXPECT_EQ(pParser->GetPipelineStateByName(pRef->PSODesc.Name), pDst);
+    }
+
+    // A precompiled notation with an unknown version must be rejected
+    {
+        std::vector<Uint8> Data(pPrecompiledData->GetSize());
+        memcpy(Data.data(), pPrecompiledData->GetConstDataPtr(), Data.size());
+        Data[8] = 0xFF;
+
+        RefCntAutoPtr<IRenderStateNotationParser> pInvalidParser;
+        CreateRenderStateNotationParser({}, &pInvalidParser);
+        ASSERT_NE(pInvalidParser, nullptr);
+
+        TestingEnvironment::ErrorScope TestScope{
+            "Precompiled render state notation version 255 is not supported. Expected version: 1.",
+            "Precompiled render state notation version 255 is not supported. Expected version: 1."};
+        EXPECT_FALSE(pInvalidParser->ParseString(reinterpret_cast<const Char*>(Data.data()), static_cast<Uint32>(Data.size()), nullptr));
+    }
+}
+
+TEST(Tools_RenderStateNotationParser, ParallelImportsTest)
+{
+    RefCntAutoPtr<IRenderStateNotationParser> pRefParser = LoadFromFile("RenderStatesLibrary.json");
+    ASSERT_NE(pRefParser, nullptr);
+
+    RefCntAutoPtr<IShaderSourceInputStreamFactory> pStreamFactory;
+    CreateDefaultShaderSourceStreamFactory("RenderStates/RenderStateNotationParser", &pStreamFactory);
+    ASSERT_NE(pStreamFactory, nullptr);
+
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    ASSERT_NE(pThreadPool, nullptr);
+
+    RenderStateNotationParserCreateInfo ParserCI;
+    ParserCI.pThreadPool = pThreadPool;
+
+    RefCntAutoPtr<IRenderStateNotationParser> pParser;
+    CreateRenderStateNotationParser(ParserCI, &pParser);
+    ASSERT_NE(pParser, nullptr);
+    EXPECT_TRUE(pParser->ParseFile("RenderStatesLibrary.json", pStreamFactory));
+
+    const auto& RefInfo    = pRefParser->GetInfo();
+    const auto& ParserInfo = pParser->GetInfo();
+    EXPECT_EQ(ParserInfo.ShaderCount, RefInfo.ShaderCount);
+    EXPECT_EQ(ParserInfo.RenderPassCount, RefInfo.RenderPassCount);
+    EXPECT_EQ(ParserInfo.ResourceSignatureCount, RefInfo.ResourceSignatureCount);
+    EXPECT_EQ(ParserInfo.PipelineStateCount, RefInfo.PipelineStateCount);
+
+    // The states must be added in the same order as by the serial parser
+    for (Uint32 i = 0; i < RefInfo.ShaderCount; ++i)
+    {
+        const auto* pDst = pParser->GetShaderByIndex(i);
+        ASSERT_NE(pDst, nullptr);
+        EXPECT_EQ(pRefParser->GetShaderByIndex(i)->Desc, pDst->Desc);
+    }
+
+    for (Uint32 i = 0; i < RefInfo.RenderPassCount; ++i)
+    {
+        const auto* pDst = pParser->GetRenderPassByIndex(i);
+        ASSERT_NE(pDst, nullptr);
+        EXPECT_EQ(*pRefParser->GetRenderPassByIndex(i), *pDst);
+    }
+
+    for (Uint32 i = 0; i < RefInfo.ResourceSignatureCount; ++i)
+    {
+        const auto* pDst = pParser->GetResourceSignatureByIndex(i);
+        ASSERT_NE(pDst, nullptr);
+        EXPECT_EQ(*pRefParser->GetResourceSignatureByIndex(i), *pDst);
+    }
+
+    for (Uint32 i = 0; i < RefInfo.PipelineStateCount; ++i)
+    {
+        const auto* pDst = pParser->GetPipelineStateByIndex(i);
+        ASSERT_NE(pDst, nullptr);
+        EXPECT_EQ(pRefParser->GetPipelineStateByIndex(i)->PSODesc, pDst->PSODesc);
+    }
+}
+
+TEST(Tools_RenderStateNotationParser, ShaderPermutationsTest)
+{
+    RefCntAutoPtr<IRenderStateNotationParser> pParser = LoadFromFile("ShaderPermutations.json");
+    ASSERT_NE(pParser, nullptr);
+
+    // All permutations except SKINNED=1, QUALITY=HIGH, which is excluded by the pixel shader
+    const auto& ParserInfo = pParser->GetInfo();
+    EXPECT_EQ(ParserInfo.ShaderCount, 5u);
+    EXPECT_EQ(ParserInfo.PipelineStateCount, 3u);
+
+    EXPECT_EQ(pParser->GetShaderByName("Material-PS"), nullptr);
+    EXPECT_EQ(pParser->GetPipelineStateByName("Material"), nullptr);
+    EXPECT_EQ(pParser->GetPipelineStateByName("Material[SKINNED=1,QUALITY=HIGH]"), nullptr);
+    EXPECT_NE(pParser->GetPipelineStateByName("Material[SKINNED=0,QUALITY=LOW]"), nullptr);
+    EXPECT_NE(pParser->GetPipelineStateByName("Material[SKINNED=0,QUALITY=HIGH]"), nullptr);
+
+    const auto* pPipeline = static_cast<const GraphicsPipelineNotation*>(pParser->GetPipelineStateByName("Material[SKINNED=1,QUALITY=LOW]"));
+    ASSERT_NE(pPipeline, nullptr);
+    EXPECT_STREQ(pPipeline->pVSName, "Material-VS[SKINNED=1]");
+    EXPECT_STREQ(pPipeline->pPSName, "Material-PS[SKINNED=1,QUALITY=LOW]");
+
+    const auto* pShader = pParser->GetShaderByName(pPipeline->pPSName);
+    ASSERT_NE(pShader, nullptr);
+    EXPECT_EQ(pShader->Desc.ShaderType, SHADER_TYPE_PIXEL);
+    EXPECT_STREQ(pShader->EntryPoint, "PSMain");
+    ASSERT_NE(pShader->Macros, nullptr);
+    EXPECT_STREQ(pShader->Macros[0].Name, "SKINNED");
+    EXPECT_STREQ(pShader->Macros[0].Definition, "1");
+    EXPECT_STREQ(pShader->Macros[1].Name, "QUALITY");
+    EXPECT_STREQ(pShader->Macros[1].Definition, "LOW");
+    EXPECT_TRUE(pShader->Macros[2] == ShaderMacro{});
 }
 
 TEST(Tools_RenderStateNotationParser, DuplicationResorcesTest)
@@ -762,6 +941,13 @@ TEST(Tools_RenderStateNotationParser, Reload)
         ASSERT_NE(pDesc, nullptr);
         EXPECT_EQ(*pDesc, DescReference);
     }
+
+    EXPECT_TRUE(pParser->IsStateModified(NOTATION_OBJECT_TYPE_PIPELINE_STATE, "TestName"));
+
+    // The reload file has not changed since the last reload
+    EXPECT_TRUE(pParser->Reload());
+    EXPECT_FALSE(pParser->IsStateModified(NOTATION_OBJECT_TYPE_PIPELINE_STATE, "TestName"));
+    EXPECT_NE(pParser->GetPipelineStateByName("TestName"), nullptr);
 }
 
 } // namespace
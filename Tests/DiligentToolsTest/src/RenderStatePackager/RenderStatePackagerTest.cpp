@@ -24,17 +24,20 @@
  *  of the possibility of such damages.
  */
 
+#include <cstring>
 #include <memory>
 #include <vector>
 #include <string>
 
 #include "gtest/gtest.h"
 #include "RenderStatePackager.hpp"
+#include "RenderStateNotationLoader.h"
 #include "ParsingEnvironment.hpp"
 #include "TestingEnvironment.hpp"
 #include "FileSystem.hpp"
 #include "BasicMath.hpp"
 #include "GraphicsAccessories.hpp"
+#include "PlatformMisc.hpp"
 
 using namespace Diligent;
 using namespace Diligent::Testing;
@@ -385,4 +388,222 @@ TEST(Tools_RenderStatePackager, IgnoredSignatures)
     ASSERT_TRUE(pArchiver->SerializeToBlob(&pData));
 }
 
+TEST(Tools_RenderStatePackager, ContentHash)
+{
+    auto ComputeContentHash = [](ARCHIVE_DEVICE_DATA_FLAGS DeviceFlags, std::vector<std::string> const& InputFilePaths) {
+        ParsingEnvironmentCreateInfo EnvironmentCI{};
+        EnvironmentCI.DeviceFlags     = DeviceFlags;
+        EnvironmentCI.RenderStateDirs = {"RenderStates/RenderStatePackager"};
+        EnvironmentCI.ShaderDirs      = {"Shaders"};
+
+        auto pEnvironment = std::make_unique<ParsingEnvironment>(EnvironmentCI);
+        EXPECT_TRUE(pEnvironment->Initialize());
+
+        auto& Packager = pEnvironment->GetPackager();
+        EXPECT_TRUE(Packager.ParseFiles(InputFilePaths));
+
+        size_t Hash = 0;
+        EXPECT_TRUE(Packager.ComputeContentHash(InputFilePaths, Hash));
+        return Hash;
+    };
+
+    const auto DeviceFlags = GetDeviceFlags();
+
+    const auto Hash0 = ComputeContentHash(DeviceFlags, {"ResourceSignature.json"});
+    EXPECT_EQ(Hash0, ComputeContentHash(DeviceFlags, {"ResourceSignature.json"}));
+    EXPECT_NE(Hash0, ComputeContentHash(DeviceFlags, {"ResourceSignature.json", "Import0.json", "Import1.json"}));
+
+    auto       RemainingFlags   = DeviceFlags;
+    const auto LowestDeviceFlag = ExtractLSB(RemainingFlags);
+    if (RemainingFlags != ARCHIVE_DEVICE_DATA_FLAG_NONE)
+        EXPECT_NE(Hash0, ComputeContentHash(LowestDeviceFlag, {"ResourceSignature.json"}));
+}
+
+TEST(Tools_RenderStatePackager, ExecutionStatistics)
+{
+    ParsingEnvironmentCreateInfo EnvironmentCI{};
+    EnvironmentCI.DeviceFlags     = GetDeviceFlags();
+    EnvironmentCI.RenderStateDirs = {"RenderStates/RenderStatePackager"};
+    EnvironmentCI.ShaderDirs      = {"Shaders"};
+
+    auto pEnvironment = std::make_unique<ParsingEnvironment>(EnvironmentCI);
+    ASSERT_TRUE(pEnvironment->Initialize());
+
+    auto  pArchiverFactory = pEnvironment->GetArchiverFactory();
+    auto& Packager         = pEnvironment->GetPackager();
+
+    std::vector<std::string> InputFilePaths{"ResourceSignature.json"};
+    ASSERT_TRUE(Packager.ParseFiles(InputFilePaths));
+
+    RefCntAutoPtr<IArchiver> pArchiver;
+    pArchiverFactory->CreateArchiver(pEnvironment->GetSerializationDevice(), &pArchiver);
+    ASSERT_TRUE(Packager.Execute(pArchiver));
+
+    RefCntAutoPtr<IDataBlob> pData;
+    ASSERT_TRUE(pArchiver->SerializeToBlob(&pData));
+
+    const auto& ParserInfo = Packager.GetParser()->GetInfo();
+    const auto& Stats      = Packager.GetStatistics();
+    EXPECT_EQ(Stats.Shaders.size(), ParserInfo.ShaderCount);
+    EXPECT_EQ(Stats.Pipelines.size(), ParserInfo.PipelineStateCount);
+    EXPECT_EQ(Stats.Devices.size(), static_cast<size_t>(PlatformMisc::CountOneBits(static_cast<Uint32>(Packager.GetDeviceFlags()))));
+    EXPECT_GT(Stats.TotalTimeMs, 0.0);
+
+    const std::string ReportPath = "RenderStatePackagerReport.json";
+    EXPECT_TRUE(Packager.WriteReport(ReportPath.c_str(), pData->GetSize(), false));
+    EXPECT_TRUE(FileSystem::FileExists(ReportPath.c_str()));
+}
+
+TEST(Tools_RenderStatePackager, CompiledShaderCache)
+{
+    ParsingEnvironmentCreateInfo EnvironmentCI{};
+    EnvironmentCI.DeviceFlags     = GetDeviceFlags();
+    EnvironmentCI.RenderStateDirs = {"RenderStates/RenderStatePackager"};
+    EnvironmentCI.ShaderDirs      = {"Shaders"};
+
+    auto pEnvironment = std::make_unique<ParsingEnvironment>(EnvironmentCI);
+    ASSERT_TRUE(pEnvironment->Initialize());
+
+    auto  pArchiverFactory = pEnvironment->GetArchiverFactory();
+    auto& Packager         = pEnvironment->GetPackager();
+
+    auto Build = [&]() {
+        Packager.Reset();
+        EXPECT_TRUE(Packager.ParseFiles({"ResourceSignature.json"}));
+
+        RefCntAutoPtr<IArchiver> pArchiver;
+        pArchiverFactory->CreateArchiver(pEnvironment->GetSerializationDevice(), &pArchiver);
+        EXPECT_TRUE(Packager.Execute(pArchiver));
+
+        RefCntAutoPtr<IDataBlob> pData;
+        EXPECT_TRUE(pArchiver->SerializeToBlob(&pData));
+        return pData;
+    };
+    auto CountCachedShaders = [&]() {
+        size_t Count = 0;
+        for (const auto& Shader : Packager.GetStatistics().Shaders)
+        {
+            if (Shader.IsCached)
+                ++Count;
+        }
+        return Count;
+    };
+
+    auto pData0 = Build();
+    ASSERT_NE(pData0, nullptr);
+    EXPECT_EQ(CountCachedShaders(), 0u);
+
+    // Unchanged shaders are not recompiled by the second build
+    auto pData1 = Build();
+    ASSERT_NE(pData1, nullptr);
+    EXPECT_GT(CountCachedShaders(), 0u);
+    ASSERT_EQ(pData0->GetSize(), pData1->GetSize());
+    EXPECT_EQ(std::memcmp(pData0->GetConstDataPtr(), pData1->GetConstDataPtr(), pData0->GetSize()), 0);
+
+    Packager.ClearShaderCache();
+    auto pData2 = Build();
+    ASSERT_NE(pData2, nullptr);
+    EXPECT_EQ(CountCachedShaders(), 0u);
+}
+
+TEST(Tools_RenderStatePackager, ShaderPermutations)
+{
+    ParsingEnvironmentCreateInfo EnvironmentCI{};
+    EnvironmentCI.DeviceFlags     = GetDeviceFlags();
+    EnvironmentCI.RenderStateDirs = {"RenderStates/RenderStatePackager"};
+    EnvironmentCI.ShaderDirs      = {"Shaders"};
+
+    auto pEnvironment = std::make_unique<ParsingEnvironment>(EnvironmentCI);
+    ASSERT_TRUE(pEnvironment->Initialize());
+
+    auto  pArchiverFactory = pEnvironment->GetArchiverFactory();
+    auto& Packager         = pEnvironment->GetPackager();
+
+    ASSERT_TRUE(Packager.ParseFiles({"ShaderPermutations.json"}));
+
+    RefCntAutoPtr<IArchiver> pArchiver;
+    pArchiverFactory->CreateArchiver(pEnvironment->GetSerializationDevice(), &pArchiver);
+    ASSERT_TRUE(Packager.Execute(pArchiver));
+
+    EXPECT_EQ(Packager.GetStatistics().Pipelines.size(), 3u);
+
+    // The permutation macro is not used by the shader source, so all permutations share one compiled shader
+    size_t SharedShaderCount = 0;
+    for (const auto& Shader : Packager.GetStatistics().Shaders)
+    {
+        if (!Shader.SharedWith.empty())
+        {
+            EXPECT_EQ(Shader.SharedWith, "BlitTexture-PS[UNUSED_MACRO=0]");
+            ++SharedShaderCount;
+        }
+    }
+    EXPECT_EQ(SharedShaderCount, 2u);
+}
+
+TEST(Tools_RenderStatePackager, ArchiveCompression)
+{
+    ParsingEnvironmentCreateInfo EnvironmentCI{};
+    EnvironmentCI.DeviceFlags     = GetDeviceFlags();
+    EnvironmentCI.RenderStateDirs = {"RenderStates/RenderStatePackager"};
+    EnvironmentCI.ShaderDirs      = {"Shaders"};
+
+    auto pEnvironment = std::make_unique<ParsingEnvironment>(EnvironmentCI);
+    ASSERT_TRUE(pEnvironment->Initialize());
+
+    auto  pArchiverFactory = pEnvironment->GetArchiverFactory();
+    auto& Packager         = pEnvironment->GetPackager();
+
+    auto CreateArchive = [&](const char* FilePath) {
+        Packager.Reset();
+        EXPECT_TRUE(Packager.ParseFiles({FilePath}));
+
+        RefCntAutoPtr<IArchiver> pArchiver;
+        pArchiverFactory->CreateArchiver(pEnvironment->GetSerializationDevice(), &pArchiver);
+        EXPECT_TRUE(Packager.Execute(pArchiver));
+
+        RefCntAutoPtr<IDataBlob> pData;
+        EXPECT_TRUE(pArchiver->SerializeToBlob(&pData));
+        return pData;
+    };
+
+    auto pArchive0 = CreateArchive("ResourceSignature.json");
+    auto pArchive1 = CreateArchive("Import0.json");
+    ASSERT_NE(pArchive0, nullptr);
+    ASSERT_NE(pArchive1, nullptr);
+
+    auto pDictionary = RenderStatePackager::BuildCompressionDictionary({pArchive0, pArchive1});
+
+    auto TestRoundTrip = [](IDataBlob* pArchive, const IDataBlob* pDictionary) {
+        RefCntAutoPtr<IDataBlob> pCompressed;
+        CompressRenderStateArchive(pArchive, pDictionary, 9, &pCompressed);
+        ASSERT_NE(pCompressed, nullptr);
+
+        RefCntAutoPtr<IDataBlob> pDecompressed;
+        DecompressRenderStateArchive(pCompressed, pDictionary, &pDecompressed);
+        ASSERT_NE(pDecompressed, nullptr);
+        ASSERT_EQ(pDecompressed->GetSize(), pArchive->GetSize());
+        EXPECT_EQ(memcmp(pDecompressed->GetConstDataPtr(), pArchive->GetConstDataPtr(), pArchive->GetSize()), 0);
+    };
+
+    TestRoundTrip(pArchive0, nullptr);
+    TestRoundTrip(pArchive1, pDictionary);
+
+    // Uncompressed data is returned as is
+    RefCntAutoPtr<IDataBlob> pUncompressed;
+    DecompressRenderStateArchive(pArchive0, nullptr, &pUncompressed);
+    EXPECT_EQ(pUncompressed, pArchive0);
+
+    // Data compressed with a dictionary can not be decompressed without it
+    if (pDictionary)
+    {
+        RefCntAutoPtr<IDataBlob> pCompressed;
+        CompressRenderStateArchive(pArchive1, pDictionary, 6, &pCompressed);
+        ASSERT_NE(pCompressed, nullptr);
+
+        RefCntAutoPtr<IDataBlob> pDecompressed;
+        DecompressRenderStateArchive(pCompressed, nullptr, &pDecompressed);
+        EXPECT_EQ(pDecompressed, nullptr);
+    }
+}
+
 } // namespace
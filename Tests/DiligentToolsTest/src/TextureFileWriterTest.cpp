@@ -0,0 +1,156 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "../interface/TextureFileWriter.hpp"
+#include "../interface/TextureLoader.h"
+
+#include "gtest/gtest.h"
+
+#include "FileSystem.hpp"
+#include "GraphicsAccessories.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace Diligent;
+
+namespace
+{
+
+// Writes every array slice of an RGBA8 texture from its own thread with padded rows,
+// reads the file back with the texture loader and compares the data.
+void TestTextureFileWriter(const char* FilePath, const TextureFileWriter::CreateInfo& WriterCI)
+{
+    TextureDesc Desc;
+    Desc.Type      = RESOURCE_DIM_TEX_2D_ARRAY;
+    Desc.Width     = 600;
+    Desc.Height    = 300;
+    Desc.ArraySize = 3;
+    Desc.MipLevels = 4;
+    Desc.Format    = TEX_FORMAT_RGBA8_UNORM;
+
+    constexpr Uint32 RowPadding = 12;
+
+    std::vector<std::vector<Uint8>> SubresData(size_t{Desc.ArraySize} * Desc.MipLevels);
+    for (Uint32 Slice = 0; Slice < Desc.ArraySize; ++Slice)
+    {
+        for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+        {
+            const auto MipProps = GetMipLevelProperties(Desc, Mip);
+            auto&      Data     = SubresData[Slice * Desc.MipLevels + Mip];
+            Data.resize((MipProps.RowSize + RowPadding) * MipProps.LogicalHeight);
+            for (size_t i = 0; i < Data.size(); ++i)
+                Data[i] = static_cast<Uint8>((i * 7 + Slice * 31 + Mip * 101) & 0xFF);
+        }
+    }
+
+    {
+        TextureFileWriter Writer{FilePath, Desc, WriterCI};
+
+        std::vector<std::thread> Threads;
+        for (Uint32 Slice = 0; Slice < Desc.ArraySize; ++Slice)
+        {
+            Threads.emplace_back([&, Slice]() {
+                // Smallest levels first, like a mip generator that reads back finished levels out of order
+                for (Uint32 Mip = Desc.MipLevels; Mip-- > 0;)
+                {
+                    TextureSubResData SubRes;
+                    SubRes.pData  = SubresData[Slice * Desc.MipLevels + Mip].data();
+                    SubRes.Stride = GetMipLevelProperties(Desc, Mip).RowSize + RowPadding;
+                    Writer.WriteSubresource(Mip, Slice, SubRes);
+                }
+            });
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        ASSERT_TRUE(Writer.Finish());
+    }
+
+    RefCntAutoPtr<ITextureLoader> pLoader;
+    CreateTextureLoaderFromFile(FilePath, IMAGE_FILE_FORMAT_UNKNOWN, TextureLoadInfo{}, &pLoader);
+    ASSERT_NE(pLoader, nullptr);
+
+    const auto& LoadedDesc = pLoader->GetTextureDesc();
+    EXPECT_EQ(LoadedDesc.Type, Desc.Type);
+    EXPECT_EQ(LoadedDesc.Width, Desc.Width);
+    EXPECT_EQ(LoadedDesc.Height, Desc.Height);
+    EXPECT_EQ(LoadedDesc.ArraySize, Desc.ArraySize);
+    EXPECT_EQ(LoadedDesc.MipLevels, Desc.MipLevels);
+    EXPECT_EQ(LoadedDesc.Format, Desc.Format);
+
+    for (Uint32 Slice = 0; Slice < Desc.ArraySize; ++Slice)
+    {
+        for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+        {
+            const auto  MipProps = GetMipLevelProperties(Desc, Mip);
+            const auto& SubRes   = pLoader->GetSubresourceData(Mip, Slice);
+            const auto& RefData  = SubresData[Slice * Desc.MipLevels + Mip];
+            ASSERT_NE(SubRes.pData, nullptr);
+            for (Uint32 row = 0; row < MipProps.LogicalHeight; ++row)
+            {
+                const auto* pRow    = static_cast<const Uint8*>(SubRes.pData) + SubRes.Stride * row;
+                const auto* pRefRow = RefData.data() + (MipProps.RowSize + RowPadding) * row;
+                ASSERT_EQ(memcmp(pRow, pRefRow, static_cast<size_t>(MipProps.RowSize)), 0) << "Mip " << Mip << ", slice " << Slice << ", row " << row;
+            }
+        }
+    }
+
+    pLoader.Release();
+    FileSystem::DeleteFile(FilePath);
+}
+
+} // namespace
+
+TEST(Tools_TextureLoader, TextureFileWriterDDS)
+{
+    TextureFileWriter::CreateInfo WriterCI;
+    WriterCI.FileFormat = IMAGE_FILE_FORMAT_DDS;
+    TestTextureFileWriter("TextureFileWriterTest.dds", WriterCI);
+}
+
+TEST(Tools_TextureLoader, TextureFileWriterKTX2)
+{
+    TextureFileWriter::CreateInfo WriterCI;
+    WriterCI.FileFormat = IMAGE_FILE_FORMAT_KTX;
+    TestTextureFileWriter("TextureFileWriterTest.ktx2", WriterCI);
+}
+
+TEST(Tools_TextureLoader, TextureFileWriterKTX2Zlib)
+{
+    TextureFileWriter::CreateInfo WriterCI;
+    WriterCI.FileFormat       = IMAGE_FILE_FORMAT_KTX;
+    WriterCI.CompressionLevel = 6;
+    TestTextureFileWriter("TextureFileWriterTestZlib.ktx2", WriterCI);
+
+    // The largest level is split into several chunks that are compressed by the thread pool
+    auto pThreadPool     = CreateThreadPool(ThreadPoolCreateInfo{4});
+    WriterCI.pThreadPool = pThreadPool;
+    TestTextureFileWriter("TextureFileWriterTestZlibMT.ktx2", WriterCI);
+}
@@ -27,9 +27,12 @@
 #include "../interface/TextureUtilities.h"
 
 #include <limits>
+#include <vector>
 
 #include "gtest/gtest.h"
 
+#include "ThreadPool.hpp"
+
 using namespace Diligent;
 
 namespace
@@ -256,6 +259,61 @@ TEST(Tools_TextureUtilities, CopyPixels32)
 }
 
 
+// Wide rows go through the specialized and vectorized code paths, including the scalar tail
+template <typename DataType>
+void TestCopyPixelsWideRows(Uint32 SrcCompCount, Uint32 DstCompCount)
+{
+    constexpr Uint32 Width  = 37;
+    constexpr Uint32 Height = 3;
+
+    std::vector<DataType> SrcData(size_t{Width} * Height * SrcCompCount);
+    for (size_t i = 0; i < SrcData.size(); ++i)
+        SrcData[i] = static_cast<DataType>(i * 7 + 1);
+
+    std::vector<DataType> RefData(size_t{Width} * Height * DstCompCount);
+    for (size_t i = 0; i < size_t{Width} * Height; ++i)
+    {
+        for (Uint32 c = 0; c < DstCompCount; ++c)
+        {
+            if (c < SrcCompCount)
+                RefData[i * DstCompCount + c] = SrcData[i * SrcCompCount + c];
+            else if (c < 3)
+                RefData[i * DstCompCount + c] = SrcCompCount == 1 ? SrcData[i] : 0;
+            else
+                RefData[i * DstCompCount + c] = std::numeric_limits<DataType>::max();
+        }
+    }
+
+    std::vector<DataType> TestData(RefData.size());
+
+    CopyPixelsAttribs CopyAttribs;
+    CopyAttribs.Width         = Width;
+    CopyAttribs.Height        = Height;
+    CopyAttribs.ComponentSize = sizeof(DataType);
+    CopyAttribs.pSrcPixels    = SrcData.data();
+    CopyAttribs.SrcStride     = Width * SrcCompCount * sizeof(DataType);
+    CopyAttribs.SrcCompCount  = SrcCompCount;
+    CopyAttribs.pDstPixels    = TestData.data();
+    CopyAttribs.DstStride     = Width * DstCompCount * sizeof(DataType);
+    CopyAttribs.DstCompCount  = DstCompCount;
+    CopyPixels(CopyAttribs);
+
+    VerifyCopyPixelsData(CopyAttribs, TestData, RefData);
+}
+
+TEST(Tools_TextureUtilities, CopyPixelsWideRows)
+{
+    for (Uint32 SrcCompCount = 1; SrcCompCount <= 4; ++SrcCompCount)
+    {
+        for (Uint32 DstCompCount = 1; DstCompCount <= 4; ++DstCompCount)
+        {
+            TestCopyPixelsWideRows<Uint8>(SrcCompCount, DstCompCount);
+            TestCopyPixelsWideRows<Uint16>(SrcCompCount, DstCompCount);
+        }
+    }
+}
+
+
 
 template <typename DataType>
 void VerifyExpandPixelsData(const ExpandPixelsAttribs& Attribs, const DataType& TestData, const DataType& RefData)
@@ -423,4 +481,118 @@ TEST(Tools_TextureUtilities, ExpandPixels32)
     TestExpandPixels<Uint32>();
 }
 
+void TestComputeImageDifference(IThreadPool* pThreadPool)
+{
+    constexpr Uint32 Width  = 37;
+    constexpr Uint32 Height = 150;
+
+    std::vector<Uint8> Image1(size_t{Width} * Height * 4);
+    for (size_t i = 0; i < Image1.size(); ++i)
+        Image1[i] = static_cast<Uint8>(i * 7 + 3);
+
+    // Pixel (x, y) differs by (x + y) % 5 in the component (x % 4)
+    auto Image2 = Image1;
+
+    Uint32 RefNumDiffPixels         = 0;
+    Uint32 RefNumNonIdenticalPixels = 0;
+    Uint32 RefMaxDiff               = 0;
+    Uint64 RefTotalDiff             = 0;
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        for (Uint32 x = 0; x < Width; ++x)
+        {
+            const Uint32 Diff = (x + y) % 5;
+            auto&        Comp = Image2[(size_t{y} * Width + x) * 4 + x % 4];
+            Comp              = static_cast<Uint8>(Comp >= 128 ? Comp - Diff : Comp + Diff);
+
+            RefNumDiffPixels += Diff > 2 ? 1 : 0;
+            RefNumNonIdenticalPixels += Diff != 0 ? 1 : 0;
+            RefMaxDiff = std::max(RefMaxDiff, Diff);
+            RefTotalDiff += Diff;
+        }
+    }
+    const float RefAvgDiff = static_cast<float>(static_cast<double>(RefTotalDiff) / (Width * Height));
+
+    ComputeImageDifferenceAttribs Attribs;
+    Attribs.Width          = Width;
+    Attribs.Height         = Height;
+    Attribs.pImage1        = Image1.data();
+    Attribs.Stride1        = Width * 4;
+    Attribs.NumComponents1 = 4;
+    Attribs.pImage2        = Image2.data();
+    Attribs.Stride2        = Width * 4;
+    Attribs.NumComponents2 = 4;
+    Attribs.Threshold      = 2;
+    Attribs.pThreadPool    = pThreadPool;
+
+    auto VerifyDiff = [&](const ImageDiffInfo& Diff) {
+        EXPECT_EQ(Diff.NumDiffPixels, RefNumDiffPixels);
+        EXPECT_EQ(Diff.NumNonIdenticalPixels, RefNumNonIdenticalPixels);
+        EXPECT_EQ(Diff.MaxDiff, RefMaxDiff);
+        EXPECT_FLOAT_EQ(Diff.AvgDiff, RefAvgDiff);
+    };
+
+    {
+        ImageDiffInfo Diff;
+        ComputeImageDifference(Attribs, Diff);
+        VerifyDiff(Diff);
+    }
+
+    {
+        std::vector<Uint8> DiffImage(size_t{Width} * Height * 4);
+        Attribs.pDiffImage        = DiffImage.data();
+        Attribs.DiffStride        = Width * 4;
+        Attribs.NumDiffComponents = 4;
+        Attribs.Scale             = 10;
+
+        ImageDiffInfo Diff;
+        ComputeImageDifference(Attribs, Diff);
+        VerifyDiff(Diff);
+
+        for (Uint32 y = 0; y < Height; ++y)
+        {
+            for (Uint32 x = 0; x < Width; ++x)
+            {
+                const auto* pPixel = &DiffImage[(size_t{y} * Width + x) * 4];
+                const auto  Val    = static_cast<Uint8>((x + y) % 5 * 10);
+                EXPECT_EQ(pPixel[0], Val);
+                EXPECT_EQ(pPixel[1], Val);
+                EXPECT_EQ(pPixel[2], Val);
+                EXPECT_EQ(pPixel[3], 255);
+            }
+        }
+        Attribs.pDiffImage = nullptr;
+    }
+
+    {
+        // Alpha is not compared with an RGB image
+        std::vector<Uint8> Image1RGB(size_t{Width} * Height * 3);
+        for (size_t i = 0; i < size_t{Width} * Height; ++i)
+        {
+            for (size_t c = 0; c < 3; ++c)
+                Image1RGB[i * 3 + c] = Image1[i * 4 + c];
+        }
+        Attribs.pImage1        = Image1RGB.data();
+        Attribs.Stride1        = Width * 3;
+        Attribs.NumComponents1 = 3;
+
+        ImageDiffInfo Diff;
+        ComputeImageDifference(Attribs, Diff);
+        EXPECT_EQ(Diff.MaxDiff, RefMaxDiff);
+        EXPECT_LT(Diff.NumNonIdenticalPixels, RefNumNonIdenticalPixels);
+        EXPECT_LT(Diff.NumDiffPixels, RefNumDiffPixels);
+    }
+}
+
+TEST(Tools_TextureUtilities, ComputeImageDifference)
+{
+    TestComputeImageDifference(nullptr);
+}
+
+TEST(Tools_TextureUtilities, ComputeImageDifferenceParallel)
+{
+    auto pThreadPool = CreateThreadPool(ThreadPoolCreateInfo{4});
+    TestComputeImageDifference(pThreadPool);
+}
+
 } // namespace
@@ -0,0 +1,118 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#pragma once
+
+#include <cstring>
+
+#include "BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Converts a 32-bit float to a 16-bit float with round-to-nearest-even.
+/// Values that are too large become infinity, NaNs are converted to quiet NaNs.
+
+/// \remarks The function has no data-dependent branches (both paths are computed and one of them
+///          is selected), so that loops over arrays of values are vectorized by the compiler.
+inline Uint16 FloatToHalf(float Value)
+{
+    Uint32 Bits = 0;
+    memcpy(&Bits, &Value, sizeof(Bits));
+
+    const Uint32 Sign = Bits & 0x80000000u;
+    Bits ^= Sign;
+
+    constexpr Uint32 F32Infinity = 255u << 23;
+    constexpr Uint32 F16Max      = (127u + 16u) << 23;
+    constexpr Uint32 DenormMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+    // Subnormal halves: the float addition aligns the mantissa and rounds it to nearest-even
+    float DenormValue = 0;
+    memcpy(&DenormValue, &Bits, sizeof(DenormValue));
+    float DenormMagicValue = 0;
+    memcpy(&DenormMagicValue, &DenormMagic, sizeof(DenormMagicValue));
+    DenormValue += DenormMagicValue;
+    Uint32 DenormBits = 0;
+    memcpy(&DenormBits, &DenormValue, sizeof(DenormBits));
+    const Uint32 DenormHalf = DenormBits - DenormMagic;
+
+    // Normalized halves: rebias the exponent and round the mantissa to nearest-even
+    const Uint32 MantissaOdd = (Bits >> 13) & 1u;
+    const Uint32 NormalHalf  = (Bits + ((15u - 127u) << 23) + 0xFFFu + MantissaOdd) >> 13;
+
+    const Uint32 InfNaNHalf = Bits > F32Infinity ? 0x7E00u : 0x7C00u;
+
+    Uint32 Half = Bits < (113u << 23) ? DenormHalf : NormalHalf;
+    Half        = Bits >= F16Max ? InfNaNHalf : Half;
+    return static_cast<Uint16>(Half | (Sign >> 16));
+}
+
+/// Converts a 16-bit float to a 32-bit float. The conversion is exact.
+inline float HalfToFloat(Uint16 Half)
+{
+    constexpr Uint32 ShiftedExp = 0x7C00u << 13;
+
+    Uint32       Bits = (Uint32{Half} & 0x7FFFu) << 13;
+    const Uint32 Exp  = Bits & ShiftedExp;
+    Bits += (127u - 15u) << 23;
+
+    float Value = 0;
+    if (Exp == ShiftedExp)
+    {
+        // Inf or NaN
+        Bits += (128u - 16u) << 23;
+        memcpy(&Value, &Bits, sizeof(Value));
+    }
+    else if (Exp == 0)
+    {
+        // Zero or subnormal: renormalize with a float subtraction
+        constexpr Uint32 Magic = 113u << 23;
+        Bits += 1u << 23;
+        float MagicValue = 0;
+        memcpy(&Value, &Bits, sizeof(Value));
+        memcpy(&MagicValue, &Magic, sizeof(MagicValue));
+        Value -= MagicValue;
+    }
+    else
+    {
+        memcpy(&Value, &Bits, sizeof(Value));
+    }
+
+    if (Half & 0x8000u)
+        Value = -Value;
+    return Value;
+}
+
+/// Converts an array of 32-bit floats to 16-bit floats, see FloatToHalf().
+inline void FloatToHalfArray(const float* pSrc, Uint16* pDst, size_t Count)
+{
+    for (size_t i = 0; i < Count; ++i)
+        pDst[i] = FloatToHalf(pSrc[i]);
+}
+
+} // namespace Diligent
@@ -24,11 +24,15 @@
  *  of the possibility of such damages.
  */
 
+#include <string>
 #include <vector>
 
 #include "TextureLoader.h"
 #include "RefCntAutoPtr.hpp"
 #include "ObjectBase.hpp"
+#include "HashUtils.hpp"
+#include "STDAllocator.hpp"
+#include "ToolsTrace.hpp"
 
 namespace Diligent
 {
@@ -39,6 +43,9 @@ class TextureLoaderImpl final : public ObjectBase<ITextureLoader>
 public:
     using TBase = ObjectBase<ITextureLoader>;
 
+    // CPU copy of a mip level created by the loader, allocated from TextureLoadInfo::pAllocator
+    using MipData = std::vector<Uint8, STDAllocatorRawMem<Uint8>>;
+
     TextureLoaderImpl(IReferenceCounters*        pRefCounters,
                       const TextureLoadInfo&     TexLoadInfo,
                       const Uint8*               pData,
@@ -49,6 +56,12 @@ public:
                       const TextureLoadInfo& TexLoadInfo,
                       Image*                 pImage);
 
+    // Assembles a texture array or a cubemap from 2D texture loaders, one for every slice
+    TextureLoaderImpl(IReferenceCounters*                          pRefCounters,
+                      const TextureLoadInfo&                       TexLoadInfo,
+                      RESOURCE_DIMENSION                           Type,
+                      std::vector<RefCntAutoPtr<ITextureLoader>>&& SliceLoaders);
+
     IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_TextureLoader, TBase);
 
     virtual void DILIGENT_CALL_TYPE CreateTexture(IRenderDevice* pDevice,
@@ -67,20 +80,116 @@ public:
         return m_SubResources[Subres];
     }
 
+    virtual void DILIGENT_CALL_TYPE CreateStreamingTexture(IRenderDevice*  pDevice,
+                                                           IDeviceContext* pContext,
+                                                           Uint32          NumResidentMips,
+                                                           ITexture**      ppTexture) override final;
+
+    virtual Uint32 DILIGENT_CALL_TYPE StreamMipLevels(IDeviceContext* pContext,
+                                                      ITexture*       pTexture,
+                                                      Uint64          ByteBudget) override final;
+
+    virtual Uint32 DILIGENT_CALL_TYPE GetResidentMipLevel() const override final
+    {
+        return m_ResidentMip;
+    }
+
+    virtual size_t DILIGENT_CALL_TYPE GetCPUDataSize() const override final;
+
+    virtual void DILIGENT_CALL_TYPE GetMemoryStats(TextureLoaderMemoryStats& Stats) const override final;
+
+    virtual void DILIGENT_CALL_TYPE ReleaseCPUData() override final;
+
 private:
     void LoadFromImage(const TextureLoadInfo& TexLoadInfo);
     void LoadFromKTX(const TextureLoadInfo& TexLoadInfo, const Uint8* pData, size_t DataSize);
+    void LoadFromKTX2(const TextureLoadInfo& TexLoadInfo, const Uint8* pData, size_t DataSize);
     void LoadFromDDS(const TextureLoadInfo& TexLoadInfo, const Uint8* pData, size_t DataSize);
 
+    void UploadSubresource(IDeviceContext* pContext, ITexture* pTexture, Uint32 MipLevel, Uint32 ArraySlice);
+
+    void CompressMipLevels(TEXTURE_FORMAT CompressedFormat, BC_COMPRESSION_QUALITY Quality, IThreadPool* pThreadPool);
+
+    // Removes the given number of the most detailed levels of DDS and KTX textures, see TextureLoadInfo::MaxDimension
+    void SkipTopMipLevels(Uint32 NumLevels);
+
+    std::vector<MipData> CreateMips(size_t NumMips) const;
+
 private:
     RefCntAutoPtr<IDataBlob> m_pDataBlob;
     RefCntAutoPtr<Image>     m_pImage;
 
     const std::string m_Name;
     TextureDesc       m_TexDesc;
+    IMemoryAllocator& m_Allocator;
+
+    std::vector<TextureSubResData> m_SubResources;
+    std::vector<MipData>           m_Mips;
 
-    std::vector<TextureSubResData>  m_SubResources;
-    std::vector<std::vector<Uint8>> m_Mips;
+    // Loaders that own the data of the array slices
+    std::vector<RefCntAutoPtr<ITextureLoader>> m_SliceLoaders;
+
+    // Streaming state: the most detailed fully resident mip level and
+    // the next array slice of the mip level (m_ResidentMip - 1) to upload.
+    Uint32 m_ResidentMip     = 0;
+    Uint32 m_NextStreamSlice = 0;
+
+    // Only the top mip level is prepared; the rest is generated by the GPU
+    bool m_GenerateMipsOnGPU = false;
+
+    // CPU data has been released by ReleaseCPUData()
+    bool m_CPUDataReleased = false;
+};
+
+// Read the texture properties from DDS and KTX headers without touching the texture data.
+// The functions return false if the header is invalid or truncated.
+bool ReadDDSHeader(const Uint8* pData, size_t DataSize, ImageProbeInfo& Info);
+bool ReadKTXHeader(const Uint8* pData, size_t DataSize, ImageProbeInfo& Info);
+
+// Create the headers of the files written by TextureFileWriter. The functions return false if the texture
+// can't be stored in the file format. The size of the KTX2 header does not depend on the level offsets and sizes,
+// which are given for every mip level. The uncompressed size of every level is computed from the texture description.
+bool CreateDDSFileHeader(const TextureDesc& Desc, std::vector<Uint8>& Header);
+bool CreateKTX2FileHeader(const TextureDesc& Desc, bool IsZlibCompressed, const Uint64* pLevelOffsets, const Uint64* pLevelSizes, std::vector<Uint8>& Header);
+
+// Returns the alignment of the levels of a KTX2 file that is not supercompressed
+Uint32 GetKTX2LevelAlignment(TEXTURE_FORMAT Format);
+
+// Unique file path and load parameters. The name is ignored as it does not affect the texture data.
+struct TextureLoadKey
+{
+    std::string     Path;
+    TextureLoadInfo LoadInfo;
+
+    bool operator==(const TextureLoadKey& RHS) const
+    {
+        const auto& L = LoadInfo;
+        const auto& R = RHS.LoadInfo;
+        // clang-format off
+        return Path                   == RHS.Path               &&
+               L.Usage                == R.Usage                &&
+               L.BindFlags            == R.BindFlags            &&
+               L.MipLevels            == R.MipLevels            &&
+               L.CPUAccessFlags       == R.CPUAccessFlags       &&
+               L.IsSRGB               == R.IsSRGB               &&
+               L.GenerateMips         == R.GenerateMips         &&
+               L.Format               == R.Format               &&
+               L.AlphaCutoff          == R.AlphaCutoff          &&
+               L.MipFilter            == R.MipFilter            &&
+               L.CompressQuality      == R.CompressQuality      &&
+               L.GenerateMipsOnGPU    == R.GenerateMipsOnGPU    &&
+               L.PremultiplyAlpha     == R.PremultiplyAlpha     &&
+               L.ImmediateContextMask == R.ImmediateContextMask;
+        // clang-format on
+    }
+
+    struct Hasher
+    {
+        size_t operator()(const TextureLoadKey& Key) const
+        {
+            return ComputeHash(Key.Path, Key.LoadInfo.Format, Key.LoadInfo.IsSRGB, Key.LoadInfo.MipLevels);
+        }
+    };
 };
 
 } // namespace Diligent
@@ -0,0 +1,130 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+/// Reads files asynchronously on dedicated I/O threads.
+
+/// Every file is split into chunks that are read with positional reads (pread on POSIX
+/// platforms, ReadFile with an explicit offset on Windows) by several threads at once,
+/// which keeps many requests in flight and lets SSDs reach their full throughput.
+/// Every read request is completed by a callback that is called as soon as the whole file
+/// has been read, so that the caller can start processing the data while other files are
+/// still being read.
+///
+/// \note   The methods are thread-safe, but must not be called from completion callbacks,
+///         with the exception of Read().
+class AsyncFileReader
+{
+public:
+    struct CreateInfo
+    {
+        /// The number of I/O threads. Every thread keeps one read request in flight.
+        Uint32 NumThreads = 8;
+
+        /// The size of the chunks that files are split into.
+        size_t ChunkSize = size_t{1} << 20;
+    };
+
+    /// Completion callback.
+
+    /// \param [in] FilePath - Path to the file, as given to Read().
+    /// \param [in] Data     - File data. The callback may take ownership of the data.
+    /// \param [in] Error    - Error message. Empty if the file has been read successfully.
+    ///
+    /// \remarks    The callback is called from one of the I/O threads and should return quickly,
+    ///             e.g. by enqueueing the processing of the data into a thread pool.
+    ///             The callback must not throw.
+    using CompletionCallbackType = std::function<void(const char* FilePath, std::vector<unsigned char>& Data, const std::string& Error)>;
+
+    explicit AsyncFileReader(const CreateInfo& CI = CreateInfo{});
+
+    /// Waits for all pending reads and stops the I/O threads.
+    ~AsyncFileReader();
+
+    // clang-format off
+    AsyncFileReader           (const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+    // clang-format on
+
+    /// Enqueues the read of the whole file.
+    void Read(const char* FilePath, CompletionCallbackType Callback);
+
+    /// Reads the whole file using the I/O threads and waits for the data.
+    bool ReadWholeFile(const char* FilePath, std::vector<unsigned char>& Data, std::string& Error);
+
+    /// Waits until all enqueued reads have been completed, including the reads
+    /// enqueued by completion callbacks.
+    void WaitForIdle();
+
+private:
+    struct FileRequest;
+
+    struct Job
+    {
+        std::shared_ptr<FileRequest> pRequest;
+
+        // The chunk to read. The first job of every request opens the file and enqueues the chunks.
+        size_t Offset = 0;
+        size_t Size   = 0;
+        bool   Open   = false;
+    };
+
+    void WorkerThreadProc();
+
+    void OpenFile(const std::shared_ptr<FileRequest>& pRequest, std::vector<Job>& Chunks);
+    void ReadChunk(FileRequest& Request, size_t Offset, size_t Size);
+    void FinishRequest(FileRequest& Request);
+
+private:
+    const size_t m_ChunkSize;
+
+    std::mutex              m_Mtx;
+    std::condition_variable m_JobCV;
+    std::condition_variable m_IdleCV;
+    std::deque<Job>         m_Jobs;
+    size_t                  m_NumPendingRequests = 0;
+    bool                    m_Stop               = false;
+
+    std::vector<std::thread> m_Threads;
+};
+
+} // namespace Diligent
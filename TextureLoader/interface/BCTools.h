@@ -27,11 +27,28 @@
 #pragma once
 
 #include "../../../DiligentCore/Primitives/interface/BasicTypes.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/GraphicsTypes.h"
 
 DILIGENT_BEGIN_NAMESPACE(Diligent)
 
+struct IThreadPool;
+
 // clang-format off
 
+/// Block compression quality
+DILIGENT_TYPED_ENUM(BC_COMPRESSION_QUALITY, Uint8)
+{
+    /// Fastest compression with the lowest quality.
+    BC_COMPRESSION_QUALITY_FAST = 0,
+
+    /// Balanced speed and quality.
+    BC_COMPRESSION_QUALITY_NORMAL,
+
+    /// Highest quality with the slowest compression.
+    BC_COMPRESSION_QUALITY_HIGH
+};
+
+
 /// Decompresses BC1 block (4x4 RGB).
 
 /// \param[in]  Bits        - Compressed block bits.
@@ -43,6 +60,14 @@ void DecompressBC1Block(const Uint8* Bits,
                         Uint32       DstChannels DEFAULT_VALUE(4));
 
 
+/// Decompresses BC2 block (4x4 RGB+A with explicit 4-bit alpha).
+
+/// \param[in]  Bits      - Compressed block bits.
+/// \param[out] DstBuffer - Pointer to the output 4x4 RGBA buffer.
+void DecompressBC2Block(const Uint8* Bits,
+                        Uint8*       DstBuffer);
+
+
 /// Decompresses BC3 block (4x4 RGB+A).
 
 /// \param[in]  Bits      - Compressed block bits.
@@ -71,6 +96,173 @@ void DecompressBC5Block(const Uint8* Bits,
                         Uint8*       DstBuffer,
                         Uint32       DstChannels DEFAULT_VALUE(2));
 
+
+/// Decompresses BC6H block (4x4 half-precision float RGB).
+
+/// \param[in]  Bits        - Compressed block bits.
+/// \param[out] DstBuffer   - Pointer to the output 4x4 buffer of 16-bit float values.
+/// \param[in]  IsSigned    - Whether the block is in signed (SF16) or unsigned (UF16) format.
+/// \param[in]  DstChannels - The number of components in the output buffer.
+///                           Must be 3 (RGB) or 4 (RGBA). Alpha is set to 1.0.
+void DecompressBC6HBlock(const Uint8* Bits,
+                         Uint16*      DstBuffer,
+                         bool         IsSigned,
+                         Uint32       DstChannels DEFAULT_VALUE(3));
+
+
+/// Decompresses BC7 block (4x4 RGBA).
+
+/// \param[in]  Bits      - Compressed block bits.
+/// \param[out] DstBuffer - Pointer to the output 4x4 RGBA buffer.
+void DecompressBC7Block(const Uint8* Bits,
+                        Uint8*       DstBuffer);
+
+
+/// Compresses 4x4 RGB block into BC1 format.
+
+/// \param[in]  SrcBuffer - Pointer to the 4x4 RGBA source pixels. Alpha is ignored.
+/// \param[out] Bits      - Pointer to the 8-byte output block.
+void CompressBC1Block(const Uint8* SrcBuffer,
+                      Uint8*       Bits);
+
+
+/// Compresses 4x4 RGB+A block into BC2 format.
+
+/// \param[in]  SrcBuffer - Pointer to the 4x4 RGBA source pixels.
+/// \param[out] Bits      - Pointer to the 16-byte output block.
+void CompressBC2Block(const Uint8* SrcBuffer,
+                      Uint8*       Bits);
+
+
+/// Compresses 4x4 RGB+A block into BC3 format.
+
+/// \param[in]  SrcBuffer - Pointer to the 4x4 RGBA source pixels.
+/// \param[out] Bits      - Pointer to the 16-byte output block.
+void CompressBC3Block(const Uint8* SrcBuffer,
+                      Uint8*       Bits);
+
+
+/// Compresses 4x4 R block into BC4 format.
+
+/// \param[in]  SrcBuffer   - Pointer to the 4x4 source pixels.
+/// \param[out] Bits        - Pointer to the 8-byte output block.
+/// \param[in]  SrcChannels - The number of components in the source buffer.
+///                           Only the first component is compressed.
+void CompressBC4Block(const Uint8* SrcBuffer,
+                      Uint8*       Bits,
+                      Uint32       SrcChannels DEFAULT_VALUE(1));
+
+
+/// Compresses 4x4 R+G block into BC5 format.
+
+/// \param[in]  SrcBuffer   - Pointer to the 4x4 source pixels.
+/// \param[out] Bits        - Pointer to the 16-byte output block.
+/// \param[in]  SrcChannels - The number of components in the source buffer.
+///                           Must be at least 2. Only the first two components are compressed.
+void CompressBC5Block(const Uint8* SrcBuffer,
+                      Uint8*       Bits,
+                      Uint32       SrcChannels DEFAULT_VALUE(2));
+
+
+/// Compresses 4x4 RGBA block into BC7 format.
+
+/// \param[in]  SrcBuffer - Pointer to the 4x4 RGBA source pixels.
+/// \param[out] Bits      - Pointer to the 16-byte output block.
+/// \param[in]  Quality   - Compression quality.
+void CompressBC7Block(const Uint8*           SrcBuffer,
+                      Uint8*                 Bits,
+                      BC_COMPRESSION_QUALITY Quality DEFAULT_VALUE(BC_COMPRESSION_QUALITY_NORMAL));
+
 // clang-format on
 
+
+/// DecompressBCTexture function attributes
+struct DecompressBCTextureAttribs
+{
+    /// Compressed texture format. Must be one of the BC1-BC7 formats.
+    TEXTURE_FORMAT Format DEFAULT_INITIALIZER(TEX_FORMAT_UNKNOWN);
+
+    /// Texture width, in pixels. Does not need to be a multiple of 4.
+    Uint32 Width DEFAULT_INITIALIZER(0);
+
+    /// Texture height, in pixels. Does not need to be a multiple of 4.
+    Uint32 Height DEFAULT_INITIALIZER(0);
+
+    /// A pointer to the compressed blocks.
+    const void* pSrcBlocks DEFAULT_INITIALIZER(nullptr);
+
+    /// Stride between rows of 4x4 blocks, in bytes.
+    Uint32 SrcStride DEFAULT_INITIALIZER(0);
+
+    /// A pointer to the destination pixels in the format returned by GetBCDecompressedFormat().
+    void* pDstPixels DEFAULT_INITIALIZER(nullptr);
+
+    /// Destination row stride, in bytes.
+    Uint32 DstStride DEFAULT_INITIALIZER(0);
+
+    /// An optional thread pool. When not null, rows of blocks are decompressed in parallel.
+    ///
+    /// \note  The function waits for the tasks to complete, so it must not be called
+    ///        from a worker thread of the same pool.
+    struct IThreadPool* pThreadPool DEFAULT_INITIALIZER(nullptr);
+};
+typedef struct DecompressBCTextureAttribs DecompressBCTextureAttribs;
+
+
+/// Returns the uncompressed format that DecompressBCTexture() produces for the given BC format:
+///  - BC1, BC2, BC3, BC7 -> RGBA8_UNORM or RGBA8_UNORM_SRGB
+///  - BC4                -> R8_UNORM or R8_SNORM
+///  - BC5                -> RG8_UNORM or RG8_SNORM
+///  - BC6H               -> RGBA16_FLOAT
+///
+/// If the format is not a BC format, returns TEX_FORMAT_UNKNOWN.
+TEXTURE_FORMAT GetBCDecompressedFormat(TEXTURE_FORMAT BCFormat);
+
+
+/// Decompresses the whole BC-compressed texture level.
+void DecompressBCTexture(const DecompressBCTextureAttribs REF Attribs);
+
+
+/// CompressBCTexture function attributes
+struct CompressBCTextureAttribs
+{
+    /// Compressed texture format. Must be one of the BC1-BC5 or BC7 formats.
+    TEXTURE_FORMAT Format DEFAULT_INITIALIZER(TEX_FORMAT_UNKNOWN);
+
+    /// Texture width, in pixels. Does not need to be a multiple of 4.
+    Uint32 Width DEFAULT_INITIALIZER(0);
+
+    /// Texture height, in pixels. Does not need to be a multiple of 4.
+    Uint32 Height DEFAULT_INITIALIZER(0);
+
+    /// A pointer to the source pixels in the format returned by GetBCDecompressedFormat().
+    /// Partial blocks at the right and bottom edges are padded by repeating the edge pixels.
+    const void* pSrcPixels DEFAULT_INITIALIZER(nullptr);
+
+    /// Source row stride, in bytes.
+    Uint32 SrcStride DEFAULT_INITIALIZER(0);
+
+    /// A pointer to the destination blocks.
+    void* pDstBlocks DEFAULT_INITIALIZER(nullptr);
+
+    /// Stride between rows of 4x4 blocks, in bytes.
+    Uint32 DstStride DEFAULT_INITIALIZER(0);
+
+    /// Compression quality.
+    BC_COMPRESSION_QUALITY Quality DEFAULT_INITIALIZER(BC_COMPRESSION_QUALITY_NORMAL);
+
+    /// An optional thread pool. When not null, rows of blocks are compressed in parallel.
+    ///
+    /// \note  The function waits for the tasks to complete, so it must not be called
+    ///        from a worker thread of the same pool.
+    struct IThreadPool* pThreadPool DEFAULT_INITIALIZER(nullptr);
+};
+typedef struct CompressBCTextureAttribs CompressBCTextureAttribs;
+
+
+/// Compresses the whole texture level into the BC format.
+///
+/// \remarks   BC6H compression is not supported.
+void CompressBCTexture(const CompressBCTextureAttribs REF Attribs);
+
 DILIGENT_END_NAMESPACE // namespace Diligent
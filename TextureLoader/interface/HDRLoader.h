@@ -0,0 +1,59 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include "Image.h"
+
+DILIGENT_BEGIN_NAMESPACE(Diligent)
+
+/// Loads a Radiance HDR (RGBE) image.
+
+/// \param [in]  pHDRData    - Radiance HDR image data.
+/// \param [out] pDstPixels  - Destination pixels data blob. The pixels are written as tightly packed
+///                            four-component 16-bit floats (|r|g|b|a|r|g|b|a|...), alpha is always 1.
+/// \param [out] pDstImgDesc - Image description.
+/// \param [in]  pThreadPool - An optional thread pool. When not null, bands of rows
+///                            are converted to half floats in parallel.
+/// \return                    true if the image has been loaded successfully, and false otherwise.
+///
+/// \remarks  Both run-length encoded and flat scanlines are supported.
+///           Only the 32-bit_rle_rgbe pixel format is supported; XYZE images are rejected.
+bool DILIGENT_GLOBAL_FUNCTION(LoadHDR)(IDataBlob*          pHDRData,
+                                       IDataBlob*          pDstPixels,
+                                       ImageDesc*          pDstImgDesc,
+                                       struct IThreadPool* pThreadPool DEFAULT_VALUE(nullptr));
+
+/// Reads the description of a Radiance HDR image from its header without decoding the image.
+
+/// \param [in]  pHDRData    - Radiance HDR image data. Only the text header and the resolution string are read.
+/// \param [in]  DataSize    - Data size in bytes.
+/// \param [out] pDstImgDesc - Image description of the decoded image.
+/// \return                    true if the header is valid, and false otherwise.
+bool DILIGENT_GLOBAL_FUNCTION(ReadHDRHeader)(const void* pHDRData,
+                                             size_t      DataSize,
+                                             ImageDesc*  pDstImgDesc);
+
+DILIGENT_END_NAMESPACE // namespace Diligent
@@ -32,6 +32,7 @@
 #include "../../../DiligentCore/Primitives/interface/DataBlob.h"
 
 #if DILIGENT_CPP_INTERFACE
+#    include <future>
 #    include <vector>
 
 #    include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
@@ -40,6 +41,8 @@
 
 DILIGENT_BEGIN_NAMESPACE(Diligent)
 
+struct IThreadPool;
+
 /// Image file format
 DILIGENT_TYPED_ENUM(IMAGE_FILE_FORMAT, Uint8){
     /// Unknown format
@@ -57,18 +60,95 @@ DILIGENT_TYPED_ENUM(IMAGE_FILE_FORMAT, Uint8){
     /// DDS file
     IMAGE_FILE_FORMAT_DDS,
 
-    /// KTX file
+    /// KTX file (KTX 1.0 or KTX 2.0)
     IMAGE_FILE_FORMAT_KTX,
 
     /// Silicon Graphics Image aka RGB file
     /// https://en.wikipedia.org/wiki/Silicon_Graphics_Image
-    IMAGE_FILE_FORMAT_SGI};
+    IMAGE_FILE_FORMAT_SGI,
+
+    /// Radiance HDR (RGBE) file. The image is decoded as four-component 16-bit floats.
+    /// https://en.wikipedia.org/wiki/RGBE_image_format
+    IMAGE_FILE_FORMAT_HDR};
+
+/// Row filter used by the PNG encoder
+DILIGENT_TYPED_ENUM(PNG_ENCODE_FILTER, Uint8)
+{
+    /// The filter is selected for every row individually, which typically
+    /// gives the best compression ratio.
+    PNG_ENCODE_FILTER_ADAPTIVE = 0,
+
+    /// Rows are not filtered. This is the fastest option that works well
+    /// for images with large flat areas.
+    PNG_ENCODE_FILTER_NONE,
+
+    /// Sub filter
+    PNG_ENCODE_FILTER_SUB,
+
+    /// Up filter
+    PNG_ENCODE_FILTER_UP,
+
+    /// Average filter
+    PNG_ENCODE_FILTER_AVERAGE,
+
+    /// Paeth filter
+    PNG_ENCODE_FILTER_PAETH
+};
+
+/// Deflate strategy used by the PNG encoder, see zlib documentation for details.
+DILIGENT_TYPED_ENUM(PNG_ENCODE_STRATEGY, Uint8)
+{
+    /// Default strategy (Z_DEFAULT_STRATEGY)
+    PNG_ENCODE_STRATEGY_DEFAULT = 0,
+
+    /// Strategy tuned for filtered data (Z_FILTERED)
+    PNG_ENCODE_STRATEGY_FILTERED,
+
+    /// Huffman coding only, no string matching (Z_HUFFMAN_ONLY)
+    PNG_ENCODE_STRATEGY_HUFFMAN_ONLY,
+
+    /// Run-length encoding (Z_RLE)
+    PNG_ENCODE_STRATEGY_RLE
+};
+
+/// PNG encoding options
+struct PngEncodeOptions
+{
+    /// Deflate compression level from 0 (no compression) to 9 (best compression),
+    /// or -1 to use the zlib default level. Levels 1 to 3 are considerably faster
+    /// than the default level at the cost of slightly larger files.
+    Int32 CompressionLevel DEFAULT_INITIALIZER(-1);
+
+    /// Deflate strategy
+    PNG_ENCODE_STRATEGY Strategy DEFAULT_INITIALIZER(PNG_ENCODE_STRATEGY_DEFAULT);
+
+    /// Row filter
+    PNG_ENCODE_FILTER Filter DEFAULT_INITIALIZER(PNG_ENCODE_FILTER_ADAPTIVE);
+};
+typedef struct PngEncodeOptions PngEncodeOptions;
 
 /// Image loading information
 struct ImageLoadInfo
 {
     /// Image file format
     IMAGE_FILE_FORMAT Format DEFAULT_INITIALIZER(IMAGE_FILE_FORMAT_UNKNOWN);
+
+    /// Decoding scale denominator: 1, 2, 4 or 8. The image is decoded at 1/ScaleDenom
+    /// of its original size (rounded up). Only JPEG images can be decoded at reduced
+    /// size; the value is ignored for other formats.
+    Uint32 ScaleDenom DEFAULT_INITIALIZER(1);
+
+    /// The number of components (1 to 4) that PNG and JPEG decoders write to the image,
+    /// or 0 to keep the number of components of the file. Components are added or removed
+    /// while decoding, the same way as by Diligent::CopyPixels, which avoids a separate copy.
+    Uint32 NumComponents DEFAULT_INITIALIZER(0);
+
+    /// An optional thread pool. When not null, strips or tiles of TIFF images
+    /// are decoded in parallel, each task using its own TIFF handle.
+    ///
+    /// \note  Image creation waits for the tasks to complete, so it must not be
+    ///        performed from a worker thread of the same pool.
+    struct IThreadPool* pThreadPool DEFAULT_INITIALIZER(nullptr);
 };
 typedef struct ImageLoadInfo ImageLoadInfo;
 
@@ -92,6 +172,43 @@ struct ImageDesc
 };
 typedef struct ImageDesc ImageDesc;
 
+/// Image properties that are read from the file header without decoding the image
+struct ImageProbeInfo
+{
+    /// Image file format
+    IMAGE_FILE_FORMAT FileFormat DEFAULT_INITIALIZER(IMAGE_FILE_FORMAT_UNKNOWN);
+
+    /// Resource dimension. DDS and KTX files may contain texture arrays, cube maps and 3D textures;
+    /// other formats always contain a single 2D image.
+    RESOURCE_DIMENSION Type DEFAULT_INITIALIZER(RESOURCE_DIM_TEX_2D);
+
+    /// Width in pixels
+    Uint32 Width DEFAULT_INITIALIZER(0);
+
+    /// Height in pixels
+    Uint32 Height DEFAULT_INITIALIZER(0);
+
+    /// Depth of a 3D texture, 1 for other dimensions
+    Uint32 Depth DEFAULT_INITIALIZER(1);
+
+    /// The number of array slices, including cube map faces
+    Uint32 ArraySize DEFAULT_INITIALIZER(1);
+
+    /// The number of mip levels stored in the file
+    Uint32 MipLevels DEFAULT_INITIALIZER(1);
+
+    /// Texture format of DDS and KTX files. TEX_FORMAT_UNKNOWN for other file formats
+    /// and for texture formats that are not supported by the texture loader.
+    TEXTURE_FORMAT Format DEFAULT_INITIALIZER(TEX_FORMAT_UNKNOWN);
+
+    /// Component type of a PNG, JPEG, TIFF, SGI or HDR image as it will be decoded, VT_UNDEFINED for DDS and KTX files
+    VALUE_TYPE ComponentType DEFAULT_INITIALIZER(VT_UNDEFINED);
+
+    /// Number of components of a PNG, JPEG, TIFF, SGI or HDR image as it will be decoded, 0 for DDS and KTX files
+    Uint32 NumComponents DEFAULT_INITIALIZER(0);
+};
+typedef struct ImageProbeInfo ImageProbeInfo;
+
 
 
 #if DILIGENT_CPP_INTERFACE
@@ -126,6 +243,13 @@ struct Image : public ObjectBase<IObject>
         Uint32            Stride      = 0;
         IMAGE_FILE_FORMAT FileFormat  = IMAGE_FILE_FORMAT_JPEG;
         int               JpegQuality = 95;
+
+        /// PNG encoding options
+        PngEncodeOptions PngOptions;
+
+        /// An optional thread pool. When not null, large PNG images are split into row
+        /// bands that are deflated in parallel and written as separate IDAT chunks.
+        IThreadPool* pThreadPool = nullptr;
     };
     static void Encode(const EncodeInfo& Info, IDataBlob** ppEncodedData);
 
@@ -161,6 +285,10 @@ private:
 
     void LoadTiffFile(IDataBlob* pFileData, const ImageLoadInfo& LoadInfo);
 
+    // Allocates the data for the image described by m_Desc with the given number of components
+    // and returns the row stride.
+    Uint32 AllocateImageData(Uint32 NumComponents);
+
     ImageDesc                m_Desc;
     RefCntAutoPtr<IDataBlob> m_pData;
 };
@@ -176,6 +304,43 @@ IMAGE_FILE_FORMAT CreateImageFromFile(const Char* FilePath,
                                       Image**     ppImage,
                                       IDataBlob** ppRawData = nullptr);
 
+/// Starts loading an image from file on a separate thread
+
+/// \param [in] FilePath - Source file path.
+/// \param [in] LoadInfo - Image loading information. The file format is derived from the file,
+///                        and LoadInfo.Format is ignored.
+/// \return                A future that receives the image, or null if the image could not be loaded.
+///
+/// \remarks  The function returns immediately, so that the file is read and decoded while the caller
+///           does other work, e.g. a golden image is decoded while the frame it is compared with
+///           is rendered (see Diligent::ComputeImageDifference). Only PNG, JPEG, TIFF and SGI files
+///           are decoded.
+std::future<RefCntAutoPtr<Image>> CreateImageFromFileAsync(const Char* FilePath, const ImageLoadInfo& LoadInfo = ImageLoadInfo{});
+
+/// Reads image properties from the file header without decoding the image
+
+/// \param [in]  pData    - Image file data. This may be only a prefix of the file
+///                         that contains the header.
+/// \param [in]  DataSize - Data size in bytes.
+/// \param [out] Info     - Image properties.
+/// \return                 true if the header has been recognized and read successfully, and false otherwise.
+///
+/// \remarks  PNG IHDR, JPEG SOF, DDS and KTX headers, TIFF IFD and SGI header are read.
+///           A PNG prefix that ends before the first IDAT chunk may miss the tRNS chunk,
+///           in which case the number of components does not account for the alpha channel.
+bool ProbeImage(const Uint8* pData, size_t DataSize, ImageProbeInfo& Info);
+
+/// Reads image properties from the header of an image file without decoding the image
+
+/// \param [in]  FilePath - Image file path.
+/// \param [out] Info     - Image properties.
+/// \return                 true if the header has been recognized and read successfully, and false otherwise.
+///
+/// \remarks  Only the beginning of the file is read. If the header does not fit into it
+///           (e.g. for TIFF files whose IFD is at the end of the file, or JPEG files with large
+///           metadata segments), the whole file is read, but the image is still not decoded.
+bool ProbeImageFile(const Char* FilePath, ImageProbeInfo& Info);
+
 #endif
 
 DILIGENT_END_NAMESPACE // namespace Diligent
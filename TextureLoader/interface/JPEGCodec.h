@@ -68,10 +68,37 @@ DILIGENT_TYPED_ENUM(ENCODE_JPEG_RESULT, Uint32)
 /// \param [out] pDstPixels   - Decoded pixels data blob. The pixels are always tightly packed
 ///                             (for instance, components of 3-channel image will be written as |r|g|b|r|g|b|r|g|b|...).
 /// \param [out] pDstImgDesc  - Decoded image description.
+/// \param [in]  ScaleDenom   - Scale denominator: 1, 2, 4 or 8. When greater than 1, the image is
+///                             decoded directly at 1/ScaleDenom of its size using the scaled IDCT,
+///                             which is considerably faster than decoding the full image and
+///                             downsampling it. The output size is rounded up.
 /// \return                     Decoding result, see Diligent::DECODE_JPEG_RESULT.
 DECODE_JPEG_RESULT DILIGENT_GLOBAL_FUNCTION(DecodeJpeg)(IDataBlob* pSrcJpegBits,
                                                         IDataBlob* pDstPixels,
-                                                        ImageDesc* pDstImgDesc);
+                                                        ImageDesc* pDstImgDesc,
+                                                        Uint32     ScaleDenom DEFAULT_VALUE(1));
+
+
+/// Decodes jpeg image directly into the caller-provided memory.
+
+/// \param [in]  pSrcJpegBits - JPEG image encoded bits.
+/// \param [out] pDstPixels   - Destination memory that must be large enough to hold Height * DstStride bytes.
+///                             If null, the function only reads the image header and populates pDstImgDesc,
+///                             which can be used to allocate the destination.
+/// \param [in]  DstStride    - Destination row stride, in bytes.
+/// \param [in]  DstCompCount - The number of components to write to the destination (1 to 4), or 0 to
+///                             keep the number of components of the image. Missing components are
+///                             set the same way as by Diligent::CopyPixels.
+/// \param [out] pDstImgDesc  - Image description. After successful decoding, NumComponents and RowStride
+///                             describe the destination data.
+/// \param [in]  ScaleDenom   - Scale denominator: 1, 2, 4 or 8, see Diligent::DecodeJpeg.
+/// \return                     Decoding result, see Diligent::DECODE_JPEG_RESULT.
+DECODE_JPEG_RESULT DILIGENT_GLOBAL_FUNCTION(DecodeJpegIntoMemory)(IDataBlob* pSrcJpegBits,
+                                                                  void*      pDstPixels,
+                                                                  Uint32     DstStride,
+                                                                  Uint32     DstCompCount,
+                                                                  ImageDesc* pDstImgDesc,
+                                                                  Uint32     ScaleDenom DEFAULT_VALUE(1));
 
 
 /// Encodes an image jpeg PNG format.
@@ -0,0 +1,83 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#pragma once
+
+#include "../../../DiligentCore/Primitives/interface/DataBlob.h"
+#include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
+#include "../../../DiligentCore/Common/interface/ObjectBase.hpp"
+
+namespace Diligent
+{
+
+/// Read-only data blob that exposes the contents of a memory-mapped file.
+
+/// The mapping is private (copy-on-write): pages are loaded on demand and shared with
+/// the OS file cache, so no copy of the file is made unless the data is modified.
+/// \note  The file must not be modified while the blob is alive.
+class MappedFileDataBlob final : public ObjectBase<IDataBlob>
+{
+public:
+    using TBase = ObjectBase<IDataBlob>;
+
+    /// Maps the file into memory.
+
+    /// \param [in] FilePath - Path to the file.
+    /// \return     The blob, or null if the file could not be mapped (e.g. the file
+    ///             is empty or memory mapping is not supported on this platform).
+    static RefCntAutoPtr<IDataBlob> Create(const char* FilePath);
+
+    MappedFileDataBlob(IReferenceCounters* pRefCounters, void* pData, size_t Size, void* hMapping);
+    ~MappedFileDataBlob();
+
+    IMPLEMENT_QUERY_INTERFACE_IN_PLACE(IID_DataBlob, TBase)
+
+    /// Mapped file blobs can't be resized.
+    virtual void DILIGENT_CALL_TYPE Resize(size_t NewSize) override final;
+
+    virtual size_t DILIGENT_CALL_TYPE GetSize() const override final
+    {
+        return m_Size;
+    }
+
+    virtual void* DILIGENT_CALL_TYPE GetDataPtr() override final
+    {
+        return m_pData;
+    }
+
+    virtual const void* DILIGENT_CALL_TYPE GetConstDataPtr() const override final
+    {
+        return m_pData;
+    }
+
+private:
+    void* const  m_pData;
+    const size_t m_Size;
+    void* const  m_hMapping; // File mapping object handle (Windows only)
+};
+
+} // namespace Diligent
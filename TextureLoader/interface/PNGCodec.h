@@ -79,6 +79,25 @@ DECODE_PNG_RESULT DILIGENT_GLOBAL_FUNCTION(DecodePng)(IDataBlob* pSrcPngBits,
                                                       IDataBlob* pDstPixels,
                                                       ImageDesc* pDstImgDesc);
 
+/// Decodes png image directly into the caller-provided memory.
+
+/// \param [in]  pSrcPngBits  - PNG image encoded bits.
+/// \param [out] pDstPixels   - Destination memory that must be large enough to hold Height * DstStride bytes.
+///                             If null, the function only reads the image header and populates pDstImgDesc,
+///                             which can be used to allocate the destination.
+/// \param [in]  DstStride    - Destination row stride, in bytes.
+/// \param [in]  DstCompCount - The number of components to write to the destination (1 to 4), or 0 to
+///                             keep the number of components of the image. Missing components are
+///                             set the same way as by Diligent::CopyPixels.
+/// \param [out] pDstImgDesc  - Image description. After successful decoding, NumComponents and RowStride
+///                             describe the destination data.
+/// \return                     Decoding result, see Diligent::DECODE_PNG_RESULT.
+DECODE_PNG_RESULT DILIGENT_GLOBAL_FUNCTION(DecodePngIntoMemory)(IDataBlob* pSrcPngBits,
+                                                                void*      pDstPixels,
+                                                                Uint32     DstStride,
+                                                                Uint32     DstCompCount,
+                                                                ImageDesc* pDstImgDesc);
+
 /// Encodes an image into PNG format.
 
 /// \param [in] pSrcPixels    - Source pixels. The pixels must be tightly packed
@@ -91,12 +110,14 @@ DECODE_PNG_RESULT DILIGENT_GLOBAL_FUNCTION(DecodePng)(IDataBlob* pSrcPngBits,
 ///                             The color type defines the number of color components, which must be
 ///                             tightly packed.
 /// \param [out] pDstPngBits  - Encoded PNG image bits.
+/// \param [in] pOptions      - Optional encoding options. If null, default options are used.
 /// \return                     Encoding result, see Diligent::ENCODE_PNG_RESULT.
-ENCODE_PNG_RESULT DILIGENT_GLOBAL_FUNCTION(EncodePng)(const Uint8* pSrcPixels,
-                                                      Uint32       Width,
-                                                      Uint32       Height,
-                                                      Uint32       StrideInBytes,
-                                                      int          PngColorType,
-                                                      IDataBlob*   pDstPngBits);
+ENCODE_PNG_RESULT DILIGENT_GLOBAL_FUNCTION(EncodePng)(const Uint8*            pSrcPixels,
+                                                      Uint32                  Width,
+                                                      Uint32                  Height,
+                                                      Uint32                  StrideInBytes,
+                                                      int                     PngColorType,
+                                                      IDataBlob*              pDstPngBits,
+                                                      const PngEncodeOptions* pOptions DEFAULT_VALUE(nullptr));
 
 DILIGENT_END_NAMESPACE // namespace Diligent
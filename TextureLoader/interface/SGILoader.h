@@ -34,9 +34,24 @@ DILIGENT_BEGIN_NAMESPACE(Diligent)
 /// \param [out] pDstPixels  - Destination pixels data blob. The pixels are always tightly packed
 ///                            (for instance, components of a 3-channel image will be written as |r|g|b|r|g|b|r|g|b|...).
 /// \param [out] pDstImgDesc - Image description.
+/// \param [in]  pThreadPool - An optional thread pool. When not null, bands of
+///                            rows of RLE-compressed images are decoded in parallel.
 /// \return                    true if the image has been loaded successfully, and false otherwise.
-bool DILIGENT_GLOBAL_FUNCTION(LoadSGI)(IDataBlob* pSGIData,
-                                       IDataBlob* pDstPixels,
-                                       ImageDesc* pDstImgDesc);
+///
+/// \remarks  Both RLE-compressed and uncompressed (verbatim) 8-bit images are supported.
+bool DILIGENT_GLOBAL_FUNCTION(LoadSGI)(IDataBlob*          pSGIData,
+                                       IDataBlob*          pDstPixels,
+                                       ImageDesc*          pDstImgDesc,
+                                       struct IThreadPool* pThreadPool DEFAULT_VALUE(nullptr));
+
+/// Reads the description of an SGI image from its header without decoding the image.
+
+/// \param [in]  pSGIData    - SGI image data. Only the 512-byte header is read.
+/// \param [in]  DataSize    - Data size in bytes.
+/// \param [out] pDstImgDesc - Image description. RowStride is the stride of tightly-packed rows.
+/// \return                    true if the header is valid, and false otherwise.
+bool DILIGENT_GLOBAL_FUNCTION(ReadSGIHeader)(const void* pSGIData,
+                                             size_t      DataSize,
+                                             ImageDesc*  pDstImgDesc);
 
 DILIGENT_END_NAMESPACE // namespace Diligent
@@ -0,0 +1,207 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/RenderDevice.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/DeviceContext.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/DeviceMemory.h"
+#include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
+#include "TextureLoader.h"
+
+namespace Diligent
+{
+
+/// Sparse texture create info.
+struct SparseTextureCreateInfo
+{
+    /// The maximum number of tiles, not counting the mip tail, that can be resident at the same time.
+    /// The device memory of the texture is allocated for this number of tiles up front.
+    Uint32 MaxResidentTiles = 1024;
+
+    /// The number of CommitTiles() calls after the last use of a tile before it may be evicted.
+    /// This should be at least the number of frames in flight, so that the tiles the GPU
+    /// may still be reading are not unbound.
+    Uint32 MinEvictionAge = 3;
+
+    /// Immediate context mask of the texture and its memory.
+    Uint64 ImmediateContextMask = 1;
+};
+
+/// Coordinates of a sparse texture tile.
+struct SparseTileCoord
+{
+    Uint32 MipLevel   = 0;
+    Uint32 ArraySlice = 0;
+
+    /// Tile position, in tiles, see SparseTexture::GetTileSize().
+    Uint32 X = 0;
+    Uint32 Y = 0;
+};
+
+/// A sparse (tiled) texture whose tiles are made resident on demand.
+
+/// The texture is created from a texture loader that provides the data of all mip levels.
+/// The mip tail is resident at all times. Other tiles are committed by CommitTiles(),
+/// which binds them to a fixed pool of device memory and uploads their data, evicting
+/// the least recently used tiles when the pool is full. The memory use is thus proportional
+/// to the number of tiles that are visible rather than to the size of the texture.
+///
+/// \remarks    The tile data is copied from the subresource data of the loader. When the loader
+///             was created from a DDS or KTX file, the data references the memory-mapped file,
+///             and only the pages that contain the rows of the committed tiles are read.
+///             The loader is kept alive by the texture and must not release its CPU data.
+///
+///             Only 2D textures and 2D texture arrays are supported. Tiles that are not resident
+///             read as zero when the device reports SPARSE_RESOURCE_CAP_FLAG_NON_RESIDENT_STRICT,
+///             and are undefined otherwise. The application should only sample resident tiles,
+///             e.g. by clamping the LOD using a residency map built from IsTileResident().
+class SparseTexture
+{
+public:
+    /// Returns true if the device supports sparse textures with the given description.
+    static bool IsSupported(IRenderDevice* pDevice, const TextureDesc& Desc);
+
+    /// Creates the sparse texture and makes its mip tail resident.
+
+    /// \param [in] pDevice  - Render device.
+    /// \param [in] pContext - Immediate context that is used to bind the memory and upload the mip tail.
+    ///                        The context's queue must support sparse binding.
+    /// \param [in] pLoader  - Texture loader that provides the texture data.
+    /// \param [in] CI       - Create info.
+    ///
+    /// \return     The sparse texture, or null if the device does not support sparse
+    ///             textures with the loader's description or the texture could not be created.
+    static std::unique_ptr<SparseTexture> Create(IRenderDevice*                 pDevice,
+                                                 IDeviceContext*                pContext,
+                                                 ITextureLoader*                pLoader,
+                                                 const SparseTextureCreateInfo& CI = SparseTextureCreateInfo{});
+
+    /// Makes the tiles resident.
+
+    /// \param [in] pContext    - Immediate context that is used to bind the memory and upload the data.
+    ///                           The context's queue must support sparse binding.
+    /// \param [in] pTiles      - Tiles that are needed for the current frame. Tiles of the mip tail are ignored.
+    /// \param [in] NumTiles    - The number of tiles in pTiles.
+    /// \param [in] MaxNewTiles - The maximum number of tiles to upload in this call.
+    ///
+    /// \return     The number of tiles that have been made resident.
+    ///
+    /// \remarks    The method should be called once per frame. All requested tiles that are already
+    ///             resident are marked as used, and are the last to be evicted. Tiles that are not resident
+    ///             are committed in the order of pTiles, so coarse tiles should come first.
+    ///             If the pool is full and no tile is old enough to be evicted (see
+    ///             SparseTextureCreateInfo::MinEvictionAge), the remaining tiles are not committed.
+    Uint32 CommitTiles(IDeviceContext* pContext, const SparseTileCoord* pTiles, Uint32 NumTiles, Uint32 MaxNewTiles);
+
+    /// Returns true if the tile is resident. Tiles of the mip tail are always resident.
+    bool IsTileResident(const SparseTileCoord& Tile) const;
+
+    /// Returns the texture.
+    ITexture* GetTexture() const { return m_pTexture; }
+
+    /// Returns the tile size, in texels.
+    const Uint32* GetTileSize() const { return m_TileSize; }
+
+    /// Returns the first mip level of the mip tail.
+    Uint32 GetFirstMipInTail() const { return m_FirstMipInTail; }
+
+    /// Returns the number of tiles in the given mip level along X and Y.
+    void GetNumTiles(Uint32 MipLevel, Uint32& NumTilesX, Uint32& NumTilesY) const;
+
+    /// Returns the number of resident tiles, not counting the mip tail.
+    Uint32 GetNumResidentTiles() const { return static_cast<Uint32>(m_ResidentTiles.size()); }
+
+    /// Returns the size, in bytes, of the device memory of the texture, including the mip tail.
+    Uint64 GetMemorySize() const;
+
+    SparseTexture(RefCntAutoPtr<ITexture>        pTexture,
+                  RefCntAutoPtr<IDeviceMemory>   pMemory,
+                  RefCntAutoPtr<IFence>          pFence,
+                  bool                           NativeFence,
+                  RefCntAutoPtr<ITextureLoader>  pLoader,
+                  const SparseTextureCreateInfo& CI);
+
+    // clang-format off
+    SparseTexture           (const SparseTexture&) = delete;
+    SparseTexture& operator=(const SparseTexture&) = delete;
+    // clang-format on
+
+private:
+    static Uint64 GetTileKey(const SparseTileCoord& Tile);
+
+    bool IsTileValid(const SparseTileCoord& Tile) const;
+
+    // Binds the mip tail and uploads its data
+    void InitMipTail(IDeviceContext* pContext);
+
+    // Binds the memory ranges and makes the following commands of the context wait for the binding
+    void BindMemory(IDeviceContext* pContext, const std::vector<SparseTextureMemoryBindRange>& Ranges);
+
+    void UploadTile(IDeviceContext* pContext, const SparseTileCoord& Tile);
+
+    Box GetTileRegion(const SparseTileCoord& Tile) const;
+
+private:
+    RefCntAutoPtr<ITexture>       m_pTexture;
+    RefCntAutoPtr<IDeviceMemory>  m_pMemory;
+    RefCntAutoPtr<IFence>         m_pFence;
+    RefCntAutoPtr<ITextureLoader> m_pLoader;
+
+    // Sparse binding is not ordered with the other commands of the queue, so the commands
+    // that follow the binding wait for the fence on the GPU, or on the CPU if native fences are not supported.
+    const bool m_NativeFence;
+    Uint64     m_FenceValue = 0;
+
+    Uint32 m_TileSize[3]    = {};
+    Uint32 m_FirstMipInTail = 0;
+    Uint64 m_BlockSize      = 0;
+    Uint64 m_MipTailSize    = 0; // The size of one mip tail
+    Uint32 m_NumMipTails    = 0; // One per array slice, or one for all slices with SPARSE_TEXTURE_FLAG_SINGLE_MIPTAIL
+
+    const Uint32 m_MaxResidentTiles;
+    const Uint32 m_MinEvictionAge;
+    Uint64       m_CommitIndex = 0;
+
+    struct ResidentTile
+    {
+        SparseTileCoord Coord;
+        Uint32          Slot     = 0; // Index of the memory block the tile is bound to
+        Uint64          LastUsed = 0; // Index of the CommitTiles() call that last used the tile
+    };
+    // Most recently used tiles are at the front
+    std::list<ResidentTile>                                       m_LRU;
+    std::unordered_map<Uint64, std::list<ResidentTile>::iterator> m_ResidentTiles;
+    std::vector<Uint32>                                           m_FreeSlots;
+};
+
+} // namespace Diligent
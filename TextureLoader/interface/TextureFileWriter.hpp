@@ -0,0 +1,146 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/Texture.h"
+#include "../../../DiligentCore/Common/interface/RefCntAutoPtr.hpp"
+#include "Image.h"
+
+namespace Diligent
+{
+
+struct IThreadPool;
+struct IAsyncTask;
+
+/// Writes a DDS or KTX2 file whose subresources are provided one by one, in any order and from any thread.
+
+/// The file layout is computed up front, so every subresource is written to its place in the file with a positional
+/// write (pwrite on POSIX platforms, WriteFile with an explicit offset on Windows) as soon as it is provided.
+/// Subresources produced in parallel, e.g. by mip generation or BC compression, are thus written in parallel
+/// without ever being assembled in memory. The file header is written by Finish().
+///
+/// KTX2 files may be supercompressed with zlib. A mip level is compressed as soon as all of its array slices
+/// have been provided. Levels are split into chunks that are compressed in parallel by the thread pool and joined
+/// into a single zlib stream, and the compressed levels are written by Finish() in the order required by KTX2.
+///
+/// \note   WriteSubresource() is thread-safe. Finish() must be called after all subresources have been written,
+///         and must not be called from a thread of the thread pool.
+class TextureFileWriter
+{
+public:
+    struct CreateInfo
+    {
+        /// File format: IMAGE_FILE_FORMAT_DDS or IMAGE_FILE_FORMAT_KTX (KTX 2.0).
+        IMAGE_FILE_FORMAT FileFormat = IMAGE_FILE_FORMAT_DDS;
+
+        /// KTX2 zlib supercompression level, from 1 (fastest) to 9 (smallest).
+        /// Zero disables supercompression. Ignored for DDS files.
+        Uint32 CompressionLevel = 0;
+
+        /// An optional thread pool that compresses KTX2 levels. If null, a level is compressed
+        /// by the thread that provides its last array slice.
+        IThreadPool* pThreadPool = nullptr;
+    };
+
+    /// Creates the file.
+
+    /// \param [in] FilePath - Path to the file.
+    /// \param [in] Desc     - Texture description. Only the type, size, format, and the number
+    ///                        of mip levels and array slices are used.
+    /// \param [in] CI       - Writer create info.
+    ///
+    /// \remarks    The constructor throws an exception if the file can't be created or the texture
+    ///             can't be stored in the file format.
+    TextureFileWriter(const char* FilePath, const TextureDesc& Desc, const CreateInfo& CI = CreateInfo{});
+
+    /// Waits for pending compression tasks and closes the file. If Finish() has not been called, the file is incomplete.
+    ~TextureFileWriter();
+
+    // clang-format off
+    TextureFileWriter           (const TextureFileWriter&) = delete;
+    TextureFileWriter& operator=(const TextureFileWriter&) = delete;
+    // clang-format on
+
+    /// Writes the data of one subresource. Every subresource must be written exactly once.
+
+    /// \param [in] MipLevel   - Mip level.
+    /// \param [in] ArraySlice - Array slice. For cubemaps, slice = 6 * cube + face.
+    /// \param [in] SubResData - Subresource data in CPU memory. Rows may have any stride.
+    ///                          The data may be released as soon as the method returns.
+    void WriteSubresource(Uint32 MipLevel, Uint32 ArraySlice, const TextureSubResData& SubResData);
+
+    /// Waits until all levels have been compressed, writes the file header and closes the file.
+
+    /// \return true if the file has been written successfully, and false otherwise.
+    bool Finish();
+
+private:
+    struct FileHandle;
+    struct CompressedLevel;
+
+    void CompressLevel(Uint32 MipLevel);
+    void CompressChunk(Uint32 MipLevel, size_t Chunk);
+    void AssembleLevel(Uint32 MipLevel);
+    void WaitForTasks();
+
+    bool CreateHeader(std::vector<Uint8>& Header) const;
+
+    void SetError(std::string Msg);
+
+private:
+    const std::string       m_FilePath;
+    const TextureDesc       m_Desc;
+    const IMAGE_FILE_FORMAT m_FileFormat;
+    const Uint32            m_CompressionLevel;
+    IThreadPool* const      m_pThreadPool;
+
+    std::unique_ptr<FileHandle> m_pFile;
+
+    // File offsets of the subresources, indexed by ArraySlice * MipLevels + MipLevel.
+    // Not used when the levels are compressed.
+    std::vector<Uint64> m_SubresOffsets;
+
+    // KTX2 level offsets and sizes in the file, indexed by mip level
+    std::vector<Uint64> m_LevelOffsets;
+    std::vector<Uint64> m_LevelSizes;
+
+    std::vector<std::unique_ptr<CompressedLevel>> m_CompressedLevels;
+
+    std::mutex                             m_Mtx;
+    std::vector<bool>                      m_SubresWritten;
+    std::vector<RefCntAutoPtr<IAsyncTask>> m_Tasks;
+    std::string                            m_Error;
+    bool                                   m_Finished = false;
+};
+
+} // namespace Diligent
@@ -29,12 +29,16 @@
 
 #include "../../../DiligentCore/Primitives/interface/FileStream.h"
 #include "../../../DiligentCore/Graphics/GraphicsEngine/interface/RenderDevice.h"
+#include "../../../DiligentCore/Graphics/GraphicsEngine/interface/DeviceContext.h"
 #include "../../../DiligentCore/Graphics/GraphicsEngine/interface/Texture.h"
 #include "Image.h"
+#include "BCTools.h"
 
 DILIGENT_BEGIN_NAMESPACE(Diligent)
 
 struct Image;
+struct IThreadPool;
+struct IMemoryAllocator;
 
 // clang-format off
 
@@ -51,7 +55,13 @@ DILIGENT_TYPED_ENUM(TEXTURE_LOAD_MIP_FILTER, Uint8)
     /// Use the most frequent element from the 2x2 box.
     /// This filter does not introduce new values and should be used
     /// for integer textures that contain non-filterable data (e.g. indices).
-    TEXTURE_LOAD_MIP_FILTER_MOST_FREQUENT
+    TEXTURE_LOAD_MIP_FILTER_MOST_FREQUENT,
+
+    /// Kaiser-windowed sinc filter with 6x6 footprint.
+    /// This filter produces sharper mip levels than the box average and is
+    /// supported for 8-bit UNORM and 32-bit float formats. Other formats as
+    /// well as textures that use alpha cutoff fall back to the default filter.
+    TEXTURE_LOAD_MIP_FILTER_KAISER
 };
 
 
@@ -79,7 +89,11 @@ struct TextureLoadInfo
     /// Flag indicating that the procedure should generate lower mip levels
     Bool GenerateMips                   DEFAULT_VALUE(True);
 
-    /// Texture format
+    /// Texture format.
+    ///
+    /// \remarks  When a BC1-BC5 or BC7 format is requested for an image source (e.g. PNG or JPEG),
+    ///           the mip chain is generated in the matching uncompressed format (see
+    ///           Diligent::GetBCDecompressedFormat) and every level is then block-compressed.
     TEXTURE_FORMAT Format               DEFAULT_VALUE(TEX_FORMAT_UNKNOWN);
 
     /// Alpha cut-off value used to remap alpha channel when generating mip
@@ -94,6 +108,70 @@ struct TextureLoadInfo
     /// Coarse mip filter type, see Diligent::TEXTURE_LOAD_MIP_FILTER.
     TEXTURE_LOAD_MIP_FILTER MipFilter   DEFAULT_VALUE(TEXTURE_LOAD_MIP_FILTER_DEFAULT);
 
+    /// Flag indicating that mip levels of 4-channel textures should be filtered with premultiplied
+    /// alpha: colors are weighted by alpha, so that transparent texels do not bleed into visible ones.
+    /// Texels are stored with straight alpha.
+    ///
+    /// \note This flag is ignored when AlphaCutoff is not zero and for the most-frequent filter.
+    Bool           PremultiplyAlpha     DEFAULT_VALUE(False);
+
+    /// An optional thread pool that is used to generate mip levels.
+    /// When not null, every mip level is split into row bands that are
+    /// processed in parallel. The pool is also used to decode TIFF images.
+    ///
+    /// \note  The loader waits for the tasks to complete, so it must not be
+    ///        created from a worker thread of the same pool.
+    struct IThreadPool* pThreadPool     DEFAULT_VALUE(nullptr);
+
+    /// Block compression quality that is used when Format is a BC format and
+    /// the source is an uncompressed image. Compression uses pThreadPool, when provided.
+    BC_COMPRESSION_QUALITY CompressQuality DEFAULT_VALUE(BC_COMPRESSION_QUALITY_NORMAL);
+
+    /// Flag indicating that lower mip levels of image sources should be generated by the GPU
+    /// rather than by the loader. Only the top mip level is kept in memory, and the texture
+    /// is created with MISC_TEXTURE_FLAG_GENERATE_MIPS and BIND_RENDER_TARGET.
+    ///
+    /// \remarks  This flag is only used when GenerateMips is true. The mip levels are generated
+    ///           by ITextureLoader::CreateStreamingTexture() with IDeviceContext::GenerateMips,
+    ///           so CreateTexture() cannot be used. GPU mip generation ignores AlphaCutoff and MipFilter.
+    ///           The flag is ignored when the texture is block-compressed.
+    Bool GenerateMipsOnGPU              DEFAULT_VALUE(False);
+
+    /// An optional directory where fully processed image sources (PNG, JPEG, TIFF, SGI and HDR)
+    /// are cached as DDS files. The files are named after the hash of the source data and the load
+    /// parameters that affect the texture data. When the cache file exists, it is memory-mapped and
+    /// used instead of decoding the image, generating the mip levels and compressing them.
+    ///
+    /// \remarks  The directory is created if it does not exist. Textures whose mip levels are
+    ///           generated on the GPU are not cached. Stale files are never removed by the loader.
+    const Char* CacheDirectory          DEFAULT_VALUE(nullptr);
+
+    /// An optional allocator for the texture data that the loader creates: mip levels generated
+    /// from image sources, converted legacy DDS formats, decompressed KTX2 levels and block-compressed
+    /// levels. The allocations are tagged with the "Texture loader mip data" description.
+    /// If null, the default raw memory allocator is used.
+    ///
+    /// \note  The allocator must outlive the loader and must be thread-safe if loaders
+    ///        are created or released from multiple threads.
+    struct IMemoryAllocator* pAllocator DEFAULT_VALUE(nullptr);
+
+    /// Mask of the immediate contexts that use the texture, see Diligent::TextureDesc::ImmediateContextMask.
+    ///
+    /// \remarks  To upload the texture on a transfer queue with CreateStreamingTexture() and StreamMipLevels(),
+    ///           the mask must contain the bits of both the transfer context and the contexts that will use the texture.
+    Uint64 ImmediateContextMask         DEFAULT_VALUE(1);
+
+    /// The maximum texture width, height and depth. Larger textures are loaded starting from the first
+    /// mip level that fits, so that the levels above it are neither uploaded nor kept in memory.
+    /// Zero means no limit.
+    ///
+    /// \remarks  DDS and KTX files drop the subresources of the larger levels without reading them,
+    ///           so files without a mip chain are loaded at full size. For these files, MipLevels limits
+    ///           the levels of the file before the larger ones are dropped.
+    ///           JPEG images are decoded at 1/2, 1/4 or 1/8 scale where possible, and other image sources
+    ///           are downsampled with the mip filter before the mip chain is generated.
+    Uint32 MaxDimension                 DEFAULT_VALUE(0);
+
 #if DILIGENT_CPP_INTERFACE
     explicit TextureLoadInfo(const Char*         _Name,
                              USAGE               _Usage             = TextureLoadInfo{}.Usage,
@@ -120,6 +198,26 @@ typedef struct TextureLoadInfo TextureLoadInfo;
 // clang-format on
 
 
+/// Memory used by a texture loader, in bytes, see ITextureLoader::GetMemoryStats().
+struct TextureLoaderMemoryStats
+{
+    /// The retained source file data. This may be a memory-mapped file
+    /// that DDS and KTX subresources reference directly.
+    size_t SourceDataSize DEFAULT_INITIALIZER(0);
+
+    /// The decoded image that the mip levels are generated from.
+    size_t ImageDataSize DEFAULT_INITIALIZER(0);
+
+    /// Mip levels prepared by the loader: converted, generated, decompressed or block-compressed levels.
+    size_t MipDataSize DEFAULT_INITIALIZER(0);
+
+    /// The size of all subresources of a texture created by the loader. This is the GPU memory
+    /// the texture requires, not including alignment or padding added by the driver.
+    Uint64 TextureSize DEFAULT_INITIALIZER(0);
+};
+typedef struct TextureLoaderMemoryStats TextureLoaderMemoryStats;
+
+
 // {E04FE6D5-8665-4183-A872-852E0F7CE242}
 static const struct INTERFACE_ID IID_TextureLoader =
     {0xe04fe6d5, 0x8665, 0x4183, {0xa8, 0x72, 0x85, 0x2e, 0xf, 0x7c, 0xe2, 0x42}};
@@ -137,6 +235,9 @@ static const struct INTERFACE_ID IID_TextureLoader =
 DILIGENT_BEGIN_INTERFACE(ITextureLoader, IObject)
 {
     /// Creates a texture using the prepared subresource data.
+
+    /// \note  This method cannot be used when the loader was created with
+    ///        TextureLoadInfo::GenerateMipsOnGPU, use CreateStreamingTexture() instead.
     VIRTUAL void METHOD(CreateTexture)(THIS_
                                        IRenderDevice* pDevice,
                                        ITexture**     ppTexture) PURE;
@@ -148,6 +249,81 @@ DILIGENT_BEGIN_INTERFACE(ITextureLoader, IObject)
     VIRTUAL const TextureSubResData REF METHOD(GetSubresourceData)(THIS_
                                                                    Uint32 MipLevel,
                                                                    Uint32 ArraySlice DEFAULT_VALUE(0)) CONST PURE;
+
+    /// Creates a texture for streaming and uploads its coarsest mip levels.
+
+    /// \param [in]  pDevice         - Render device that is used to create the texture.
+    /// \param [in]  pContext        - Device context that is used to upload the resident mip levels.
+    /// \param [in]  NumResidentMips - The number of the coarsest mip levels to upload immediately.
+    ///                                The value is clamped to [1, MipLevels].
+    /// \param [out] ppTexture       - Memory location where pointer to the created texture will be written.
+    ///
+    /// \remarks  The texture is created with USAGE_DEFAULT and without initial data.
+    ///           Remaining mip levels are uploaded by StreamMipLevels().
+    ///           Only one streaming texture per loader can be in flight, and the
+    ///           loader must be kept alive until all mip levels have been streamed.
+    ///           When the loader was created from a DDS or KTX file, the subresource data
+    ///           references the memory-mapped file, so the file is only read when the data is uploaded.
+    ///           When the loader was created with TextureLoadInfo::GenerateMipsOnGPU, the top mip level
+    ///           is uploaded, the remaining levels are generated by IDeviceContext::GenerateMips,
+    ///           and NumResidentMips is ignored.
+    ///
+    ///           pContext may be a transfer (copy) queue context, which keeps the upload off the graphics
+    ///           queue. In this case, the texture must have been loaded with TextureLoadInfo::ImmediateContextMask
+    ///           that includes the transfer context, and can't use TextureLoadInfo::GenerateMipsOnGPU.
+    ///           The uploaded mip levels are left in RESOURCE_STATE_COMMON, which releases the texture
+    ///           to the other queues. The application signals a fence from the transfer context after the upload
+    ///           (IDeviceContext::EnqueueSignal() followed by IDeviceContext::Flush()), and waits for it on the graphics
+    ///           queue (IDeviceContext::DeviceWaitForFence()) before the texture is used.
+    VIRTUAL void METHOD(CreateStreamingTexture)(THIS_
+                                                IRenderDevice*  pDevice,
+                                                IDeviceContext* pContext,
+                                                Uint32          NumResidentMips,
+                                                ITexture**      ppTexture) PURE;
+
+    /// Uploads the next mip levels of the texture created by CreateStreamingTexture().
+
+    /// \param [in]  pContext    - Device context that is used to upload the data. This may be
+    ///                            a transfer queue context, see CreateStreamingTexture().
+    /// \param [in]  pTexture    - Texture created by CreateStreamingTexture().
+    /// \param [in]  ByteBudget  - The maximum number of bytes to upload. Subresources are uploaded
+    ///                            from coarse to fine mips, and at least one subresource is
+    ///                            always uploaded if any is left.
+    /// \return     The most detailed mip level whose array slices are all resident,
+    ///             see GetResidentMipLevel().
+    VIRTUAL Uint32 METHOD(StreamMipLevels)(THIS_
+                                           IDeviceContext* pContext,
+                                           ITexture*       pTexture,
+                                           Uint64          ByteBudget) PURE;
+
+    /// Returns the most detailed mip level of the streaming texture that is fully resident.
+
+    /// \remarks  Mip levels finer than the returned one contain undefined data. The application
+    ///           should clamp the sampled LOD (e.g. by creating a texture view with MostDetailedMip
+    ///           set to this value) until the function returns 0.
+    VIRTUAL Uint32 METHOD(GetResidentMipLevel)(THIS) CONST PURE;
+
+    /// Returns the size, in bytes, of the CPU-side data held by the loader:
+    /// the source file data, the decoded image and the generated mip levels.
+    VIRTUAL size_t METHOD(GetCPUDataSize)(THIS) CONST PURE;
+
+    /// Returns the memory used by the loader broken down by category.
+
+    /// \param [out] Stats - Memory statistics, see Diligent::TextureLoaderMemoryStats.
+    ///
+    /// \remarks  The CPU sizes add up to GetCPUDataSize(). For a texture array or a cubemap
+    ///           assembled from slice loaders, the sizes of all slices are included.
+    ///           After ReleaseCPUData() is called, only TextureSize is not zero.
+    VIRTUAL void METHOD(GetMemoryStats)(THIS_
+                                        TextureLoaderMemoryStats REF Stats) CONST PURE;
+
+    /// Releases the CPU-side data held by the loader.
+
+    /// \remarks  Call this method after the texture has been created (or all mip levels have been
+    ///           streamed) to avoid keeping two copies of the texture data alive. The texture
+    ///           description remains valid, but the subresource data is reset, and the loader
+    ///           can't be used to create textures anymore.
+    VIRTUAL void METHOD(ReleaseCPUData)(THIS) PURE;
 };
 DILIGENT_END_INTERFACE
 // clang-format on
@@ -157,9 +333,15 @@ DILIGENT_END_INTERFACE
 #if DILIGENT_C_INTERFACE
 
 // clang-format off
-#    define ITextureLoader_CreateTexture(This, ...)      CALL_IFACE_METHOD(TextureLoader_CreateTexture,       CreateTexture,       This, __VA_ARGS__)
-#    define ITextureLoader_GetTextureDesc(This)          CALL_IFACE_METHOD(TextureLoader_GetTextureDesc,      GetTextureDesc,      This)
-#    define ITextureLoader_GetSubresourceData(This, ...) CALL_IFACE_METHOD(TextureLoader_GetSubresourceData,  GetSubresourceData,  This, __VA_ARGS__)
+#    define ITextureLoader_CreateTexture(This, ...)          CALL_IFACE_METHOD(TextureLoader_CreateTexture,          CreateTexture,          This, __VA_ARGS__)
+#    define ITextureLoader_GetTextureDesc(This)              CALL_IFACE_METHOD(TextureLoader_GetTextureDesc,         GetTextureDesc,         This)
+#    define ITextureLoader_GetSubresourceData(This, ...)     CALL_IFACE_METHOD(TextureLoader_GetSubresourceData,     GetSubresourceData,     This, __VA_ARGS__)
+#    define ITextureLoader_CreateStreamingTexture(This, ...) CALL_IFACE_METHOD(TextureLoader_CreateStreamingTexture, CreateStreamingTexture, This, __VA_ARGS__)
+#    define ITextureLoader_StreamMipLevels(This, ...)        CALL_IFACE_METHOD(TextureLoader_StreamMipLevels,        StreamMipLevels,        This, __VA_ARGS__)
+#    define ITextureLoader_GetResidentMipLevel(This)         CALL_IFACE_METHOD(TextureLoader_GetResidentMipLevel,    GetResidentMipLevel,    This)
+#    define ITextureLoader_GetCPUDataSize(This)              CALL_IFACE_METHOD(TextureLoader_GetCPUDataSize,         GetCPUDataSize,         This)
+#    define ITextureLoader_GetMemoryStats(This, ...)         CALL_IFACE_METHOD(TextureLoader_GetMemoryStats,         GetMemoryStats,         This, __VA_ARGS__)
+#    define ITextureLoader_ReleaseCPUData(This)              CALL_IFACE_METHOD(TextureLoader_ReleaseCPUData,         ReleaseCPUData,         This)
 // clang-format on
 
 #endif
@@ -206,6 +388,27 @@ void DILIGENT_GLOBAL_FUNCTION(CreateTextureLoaderFromMemory)(const void*
                                                              const TextureLoadInfo REF TexLoadInfo,
                                                              ITextureLoader**          ppLoader);
 
+/// Creates a texture loader that assembles a texture array or a cubemap from multiple files.
+
+/// \param [in]  ppFilePaths - Array of NumFiles file paths, one for every array slice.
+///                            Cubemap faces must be given in +X, -X, +Y, -Y, +Z, -Z order.
+/// \param [in]  NumFiles    - The number of files.
+/// \param [in]  Type        - Texture type: RESOURCE_DIM_TEX_2D_ARRAY, RESOURCE_DIM_TEX_CUBE
+///                            (NumFiles must be 6) or RESOURCE_DIM_TEX_CUBE_ARRAY (NumFiles must
+///                            be a multiple of 6).
+/// \param [in]  TexLoadInfo - Texture loading information that is applied to every slice,
+///                            see Diligent::TextureLoadInfo.
+/// \param [out] ppLoader    - Memory location where pointer to the created texture loader will be written.
+///
+/// \remarks    Every file must contain a 2D texture, and all slices must have the same size, format and
+///             number of mip levels. When TexLoadInfo.pThreadPool is not null, the files are decoded
+///             and their mip levels are generated in parallel, one task per file.
+void DILIGENT_GLOBAL_FUNCTION(CreateTextureArrayLoaderFromFiles)(const char* const*        ppFilePaths,
+                                                                 Uint32                    NumFiles,
+                                                                 RESOURCE_DIMENSION        Type,
+                                                                 const TextureLoadInfo REF TexLoadInfo,
+                                                                 ITextureLoader**          ppLoader);
+
 
 /// Writes texture data as DDS file.
 
@@ -213,10 +416,32 @@ void DILIGENT_GLOBAL_FUNCTION(CreateTextureLoaderFromMemory)(const void*
 /// \param [in]  Desc     - Texture description.
 /// \param [in]  TexData  - Texture subresource data.
 /// \return     true if the file has been written successfully, and false otherwise.
+///
+/// \remarks    To write subresources as they are produced, or to write KTX2 files, use Diligent::TextureFileWriter.
 bool DILIGENT_GLOBAL_FUNCTION(SaveTextureAsDDS)(const char*           FilePath,
                                                 const TextureDesc REF Desc,
                                                 const TextureData REF TexData);
 
+
+/// Block-compresses texture data and writes it as DDS file.
+
+/// \param [in]  FilePath         - DDS file path.
+/// \param [in]  Desc             - Uncompressed texture description. The format must match the
+///                                 format returned by Diligent::GetBCDecompressedFormat for CompressedFormat.
+/// \param [in]  TexData          - Uncompressed texture subresource data.
+/// \param [in]  CompressedFormat - BC1-BC5 or BC7 format to compress the texture to.
+/// \param [in]  Quality          - Compression quality.
+/// \param [in]  pThreadPool      - An optional thread pool that is used to compress the texture.
+/// \return     true if the file has been written successfully, and false otherwise.
+///
+/// \remarks   3D textures are not supported.
+bool DILIGENT_GLOBAL_FUNCTION(SaveTextureAsCompressedDDS)(const char*            FilePath,
+                                                          const TextureDesc REF  Desc,
+                                                          const TextureData REF  TexData,
+                                                          TEXTURE_FORMAT         CompressedFormat,
+                                                          BC_COMPRESSION_QUALITY Quality     DEFAULT_VALUE(BC_COMPRESSION_QUALITY_NORMAL),
+                                                          struct IThreadPool*    pThreadPool DEFAULT_VALUE(nullptr));
+
 #include "../../../DiligentCore/Primitives/interface/UndefGlobalFuncHelperMacros.h"
 
 DILIGENT_END_NAMESPACE // namespace Diligent
@@ -115,6 +115,83 @@ typedef struct ExpandPixelsAttribs ExpandPixelsAttribs;
 void DILIGENT_GLOBAL_FUNCTION(ExpandPixels)(const ExpandPixelsAttribs REF Attribs);
 
 
+/// Parameters of the ComputeImageDifference function.
+struct ComputeImageDifferenceAttribs
+{
+    /// Image width.
+    Uint32 Width DEFAULT_INITIALIZER(0);
+
+    /// Image height.
+    Uint32 Height DEFAULT_INITIALIZER(0);
+
+    /// A pointer to the pixels of the first image. Components must be 8-bit.
+    const void* pImage1 DEFAULT_INITIALIZER(nullptr);
+
+    /// Row stride of the first image in bytes.
+    Uint32 Stride1 DEFAULT_INITIALIZER(0);
+
+    /// Component count of the first image.
+    Uint32 NumComponents1 DEFAULT_INITIALIZER(0);
+
+    /// A pointer to the pixels of the second image. Components must be 8-bit.
+    const void* pImage2 DEFAULT_INITIALIZER(nullptr);
+
+    /// Row stride of the second image in bytes.
+    Uint32 Stride2 DEFAULT_INITIALIZER(0);
+
+    /// Component count of the second image.
+    Uint32 NumComponents2 DEFAULT_INITIALIZER(0);
+
+    /// The pixel difference is the maximum absolute difference of its components.
+    /// Pixels whose difference is greater than the threshold are counted as different.
+    Uint32 Threshold DEFAULT_INITIALIZER(0);
+
+    /// An optional pointer to the diff image, which receives the difference of every pixel
+    /// multiplied by Scale and clamped to 255 in the RGB components, and 255 in alpha.
+    void* pDiffImage DEFAULT_INITIALIZER(nullptr);
+
+    /// Diff image row stride in bytes.
+    Uint32 DiffStride DEFAULT_INITIALIZER(0);
+
+    /// Diff image component count.
+    Uint32 NumDiffComponents DEFAULT_INITIALIZER(0);
+
+    /// Scale applied to the difference written to the diff image.
+    float Scale DEFAULT_INITIALIZER(1.f);
+
+    /// An optional thread pool. When not null, bands of rows are compared in parallel.
+    ///
+    /// \note  The function waits for the tasks to complete, so it must not be called
+    ///        from a worker thread of the same pool.
+    struct IThreadPool* pThreadPool DEFAULT_INITIALIZER(nullptr);
+};
+typedef struct ComputeImageDifferenceAttribs ComputeImageDifferenceAttribs;
+
+/// Image difference, see ComputeImageDifference.
+struct ImageDiffInfo
+{
+    /// The number of pixels whose difference is greater than the threshold.
+    Uint32 NumDiffPixels DEFAULT_INITIALIZER(0);
+
+    /// The number of pixels that are not identical, regardless of the threshold.
+    Uint32 NumNonIdenticalPixels DEFAULT_INITIALIZER(0);
+
+    /// The maximum pixel difference.
+    Uint32 MaxDiff DEFAULT_INITIALIZER(0);
+
+    /// The average pixel difference over all pixels.
+    float AvgDiff DEFAULT_INITIALIZER(0);
+};
+typedef struct ImageDiffInfo ImageDiffInfo;
+
+/// Computes the difference between two 8-bit images, e.g. a rendered frame and a golden image.
+
+/// Only the components present in both images are compared. When both images are RGBA,
+/// rows are compared with SIMD instructions, unless a diff image is requested.
+void DILIGENT_GLOBAL_FUNCTION(ComputeImageDifference)(const ComputeImageDifferenceAttribs REF Attribs,
+                                                      ImageDiffInfo REF                       ImageDiff);
+
+
 /// Creates a texture from file.
 
 /// \param [in] FilePath    - Source file path.
@@ -126,6 +203,100 @@ void DILIGENT_GLOBAL_FUNCTION(CreateTextureFromFile)(const Char*               F
                                                      IRenderDevice*            pDevice,
                                                      ITexture**                ppTexture);
 
+
+/// Parameters of the CreateTexturesFromFiles function.
+struct CreateTexturesFromFilesAttribs
+{
+    /// The number of textures to load.
+    Uint32 NumTextures DEFAULT_INITIALIZER(0);
+
+    /// An array of NumTextures source file paths.
+    const Char* const* ppFilePaths DEFAULT_INITIALIZER(nullptr);
+
+    /// An array of NumTextures texture loading infos.
+    ///
+    /// \note  The pThreadPool member of each info is ignored: files are
+    ///        loaded in parallel on CreateTexturesFromFilesAttribs::pThreadPool.
+    const TextureLoadInfo* pLoadInfos DEFAULT_INITIALIZER(nullptr);
+
+    /// Render device that will be used to create the textures.
+    /// If null, only the texture loaders are created.
+    IRenderDevice* pDevice DEFAULT_INITIALIZER(nullptr);
+
+    /// An optional device context. When not null, textures are created without initial
+    /// data and all subresources are uploaded through this context, which is flushed once
+    /// at the end. Immutable textures are created with USAGE_DEFAULT in this case.
+    IDeviceContext* pContext DEFAULT_INITIALIZER(nullptr);
+
+    /// An optional thread pool that is used to decode the files and generate mip levels.
+    ///
+    /// \note  The function waits for the tasks to complete, so it must not be called
+    ///        from a worker thread of the same pool.
+    struct IThreadPool* pThreadPool DEFAULT_INITIALIZER(nullptr);
+
+    /// An optional array of NumTextures locations where the texture loaders will be written.
+    ITextureLoader** ppLoaders DEFAULT_INITIALIZER(nullptr);
+
+    /// An optional array of NumTextures locations where the textures will be written.
+    ITexture** ppTextures DEFAULT_INITIALIZER(nullptr);
+};
+typedef struct CreateTexturesFromFilesAttribs CreateTexturesFromFilesAttribs;
+
+/// Creates multiple textures from files.
+
+/// Entries with identical paths and load parameters are loaded once, and the same
+/// loader and texture objects are returned for all of them. Outputs are written
+/// in the order of the inputs; entries that fail to load are set to null.
+void DILIGENT_GLOBAL_FUNCTION(CreateTexturesFromFiles)(const CreateTexturesFromFilesAttribs REF Attribs);
+
+
+/// Statistics of the process-wide texture file cache, see CreateTextureFromFileCached.
+struct TextureFileCacheStats
+{
+    /// The number of requests that returned an existing texture.
+    Uint64 NumHits DEFAULT_INITIALIZER(0);
+
+    /// The number of requests that loaded the texture from file.
+    Uint64 NumMisses DEFAULT_INITIALIZER(0);
+
+    /// The number of hits that waited for a concurrent request to finish loading the texture.
+    Uint64 NumWaits DEFAULT_INITIALIZER(0);
+
+    /// The number of cache entries, including entries of textures that have been released.
+    Uint32 NumEntries DEFAULT_INITIALIZER(0);
+};
+typedef struct TextureFileCacheStats TextureFileCacheStats;
+
+/// Creates a texture from file or returns the texture previously created from the same file
+/// through the process-wide texture file cache.
+
+/// \param [in]  FilePath    - Source file path.
+/// \param [in]  TexLoadInfo - Texture loading information.
+/// \param [in]  pDevice     - Render device that will be used to create the texture.
+/// \param [out] ppTexture   - Memory location where pointer to the texture will be written.
+///
+/// \remarks  Textures are identified by the file path, the file modification time and size,
+///           the render device and the load parameters (except for the name and the thread pool).
+///           Modifying the file invalidates the cached texture.
+///
+///           Concurrent requests for the same texture wait for a single load to complete and
+///           return the same texture object. The cache does not keep textures alive: a texture
+///           is loaded again after all references to it have been released.
+///
+/// \note     Cached textures are shared by all callers and must not be modified.
+///           The function must not be called from a worker thread of TexLoadInfo.pThreadPool.
+void DILIGENT_GLOBAL_FUNCTION(CreateTextureFromFileCached)(const Char*               FilePath,
+                                                           const TextureLoadInfo REF TexLoadInfo,
+                                                           IRenderDevice*            pDevice,
+                                                           ITexture**                ppTexture);
+
+/// Removes all entries from the process-wide texture file cache.
+/// Textures that are being loaded are not affected.
+void DILIGENT_GLOBAL_FUNCTION(ClearTextureFileCache)();
+
+/// Returns the statistics of the process-wide texture file cache.
+TextureFileCacheStats DILIGENT_GLOBAL_FUNCTION(GetTextureFileCacheStats)();
+
 #include "../../../DiligentCore/Primitives/interface/UndefGlobalFuncHelperMacros.h"
 
 DILIGENT_END_NAMESPACE // namespace Diligent
@@ -0,0 +1,359 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "AsyncFileReader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+
+#if PLATFORM_WIN32
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <Windows.h>
+#elif PLATFORM_LINUX || PLATFORM_MACOS || PLATFORM_ANDROID || PLATFORM_IOS || PLATFORM_TVOS
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    define DILIGENT_USE_POSIX_PREAD 1
+#endif
+
+#include "FileWrapper.hpp"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+struct AsyncFileReader::FileRequest
+{
+    const std::string            Path;
+    const CompletionCallbackType Callback;
+
+    std::vector<unsigned char> Data;
+    std::atomic<size_t>        NumPendingChunks{0};
+
+    std::mutex  ErrorMtx;
+    std::string Error;
+
+#if PLATFORM_WIN32
+    HANDLE hFile = INVALID_HANDLE_VALUE;
+#elif DILIGENT_USE_POSIX_PREAD
+    int fd = -1;
+#endif
+
+    FileRequest(const char* _Path, CompletionCallbackType _Callback) :
+        Path{_Path},
+        Callback{std::move(_Callback)}
+    {}
+
+    ~FileRequest()
+    {
+        Close();
+    }
+
+    void Close()
+    {
+#if PLATFORM_WIN32
+        if (hFile != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(hFile);
+            hFile = INVALID_HANDLE_VALUE;
+        }
+#elif DILIGENT_USE_POSIX_PREAD
+        if (fd >= 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+#endif
+    }
+
+    void SetError(std::string Msg)
+    {
+        // Only the first error is reported
+        std::lock_guard<std::mutex> Lock{ErrorMtx};
+        if (Error.empty())
+            Error = std::move(Msg);
+    }
+};
+
+AsyncFileReader::AsyncFileReader(const CreateInfo& CI) :
+    m_ChunkSize{std::max(CI.ChunkSize, size_t{4096})}
+{
+    const auto NumThreads = std::max(CI.NumThreads, 1u);
+    m_Threads.reserve(NumThreads);
+    for (Uint32 i = 0; i < NumThreads; ++i)
+        m_Threads.emplace_back(&AsyncFileReader::WorkerThreadProc, this);
+}
+
+AsyncFileReader::~AsyncFileReader()
+{
+    WaitForIdle();
+
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_Stop = true;
+    }
+    m_JobCV.notify_all();
+
+    for (auto& Thread : m_Threads)
+        Thread.join();
+}
+
+void AsyncFileReader::Read(const char* FilePath, CompletionCallbackType Callback)
+{
+    VERIFY_EXPR(FilePath != nullptr && Callback);
+
+    Job OpenJob;
+    OpenJob.pRequest = std::make_shared<FileRequest>(FilePath, std::move(Callback));
+    OpenJob.Open     = true;
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_Jobs.emplace_back(std::move(OpenJob));
+        ++m_NumPendingRequests;
+    }
+    m_JobCV.notify_one();
+}
+
+bool AsyncFileReader::ReadWholeFile(const char* FilePath, std::vector<unsigned char>& Data, std::string& Error)
+{
+    std::mutex              Mtx;
+    std::condition_variable CV;
+    bool                    Done      = false;
+    bool                    Succeeded = false;
+
+    Read(FilePath, [&](const char*, std::vector<unsigned char>& FileData, const std::string& FileError) {
+        // Notify while holding the lock, as the waiting thread destroys the condition variable once it is woken
+        std::lock_guard<std::mutex> Lock{Mtx};
+        if (FileError.empty())
+        {
+            Data      = std::move(FileData);
+            Succeeded = true;
+        }
+        else
+        {
+            Error += FileError;
+        }
+        Done = true;
+        CV.notify_one();
+    });
+
+    std::unique_lock<std::mutex> Lock{Mtx};
+    CV.wait(Lock, [&Done]() { return Done; });
+    return Succeeded;
+}
+
+void AsyncFileReader::WaitForIdle()
+{
+    std::unique_lock<std::mutex> Lock{m_Mtx};
+    m_IdleCV.wait(Lock, [this]() { return m_NumPendingRequests == 0; });
+}
+
+void AsyncFileReader::WorkerThreadProc()
+{
+    for (;;)
+    {
+        Job CurrJob;
+        {
+            std::unique_lock<std::mutex> Lock{m_Mtx};
+            m_JobCV.wait(Lock, [this]() { return m_Stop || !m_Jobs.empty(); });
+            if (m_Jobs.empty())
+                return;
+
+            CurrJob = std::move(m_Jobs.front());
+            m_Jobs.pop_front();
+        }
+
+        if (CurrJob.Open)
+        {
+            std::vector<Job> Chunks;
+            OpenFile(CurrJob.pRequest, Chunks);
+            if (Chunks.size() > 1)
+            {
+                {
+                    // Chunks are put in front of the queue so that files are completed in the order
+                    // they were requested, which lets the processing of the first files start early.
+                    std::lock_guard<std::mutex> Lock{m_Mtx};
+                    m_Jobs.insert(m_Jobs.begin(), std::make_move_iterator(Chunks.begin() + 1), std::make_move_iterator(Chunks.end()));
+                }
+                m_JobCV.notify_all();
+            }
+
+            if (Chunks.empty())
+            {
+                // The file is empty, could not be opened or has been read by the fallback path
+                FinishRequest(*CurrJob.pRequest);
+                continue;
+            }
+
+            // Read the first chunk on this thread
+            CurrJob = std::move(Chunks.front());
+        }
+
+        ReadChunk(*CurrJob.pRequest, CurrJob.Offset, CurrJob.Size);
+        if (CurrJob.pRequest->NumPendingChunks.fetch_sub(1) == 1)
+            FinishRequest(*CurrJob.pRequest);
+    }
+}
+
+void AsyncFileReader::OpenFile(const std::shared_ptr<FileRequest>& pRequest, std::vector<Job>& Chunks)
+{
+    auto&       Request  = *pRequest;
+    const char* Path     = Request.Path.c_str();
+    size_t      FileSize = 0;
+    bool        Opened   = false;
+
+#if PLATFORM_WIN32
+    Request.hFile = CreateFileA(Path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (Request.hFile != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER Size{};
+        if (GetFileSizeEx(Request.hFile, &Size) && static_cast<Uint64>(Size.QuadPart) <= SIZE_MAX)
+        {
+            FileSize = static_cast<size_t>(Size.QuadPart);
+            Opened   = true;
+        }
+    }
+#elif DILIGENT_USE_POSIX_PREAD
+    Request.fd = open(Path, O_RDONLY);
+    if (Request.fd >= 0)
+    {
+        struct stat FileStat;
+        if (fstat(Request.fd, &FileStat) == 0 && FileStat.st_size >= 0 && static_cast<Uint64>(FileStat.st_size) <= SIZE_MAX)
+        {
+            FileSize = static_cast<size_t>(FileStat.st_size);
+            Opened   = true;
+        }
+    }
+#endif
+
+    if (!Opened)
+    {
+        Request.Close();
+
+        // Fall back to the file system of the platform, e.g. to read Android assets
+        FileWrapper pFile{Path, EFileAccessMode::Read};
+        if (!pFile)
+        {
+            Request.SetError(FormatString("Unable to open file ", Path, "\n"));
+            return;
+        }
+
+        Request.Data.resize(pFile->GetSize());
+        if (!Request.Data.empty())
+            pFile->Read(Request.Data.data(), Request.Data.size());
+        return;
+    }
+
+    if (FileSize == 0)
+        return;
+
+    Request.Data.resize(FileSize);
+
+    Chunks.reserve((FileSize + m_ChunkSize - 1) / m_ChunkSize);
+    for (size_t Offset = 0; Offset < FileSize; Offset += m_ChunkSize)
+    {
+        Job Chunk;
+        Chunk.pRequest = pRequest;
+        Chunk.Offset   = Offset;
+        Chunk.Size     = std::min(m_ChunkSize, FileSize - Offset);
+        Chunks.emplace_back(std::move(Chunk));
+    }
+    Request.NumPendingChunks.store(Chunks.size());
+}
+
+void AsyncFileReader::ReadChunk(FileRequest& Request, size_t Offset, size_t Size)
+{
+    auto* pDst = Request.Data.data() + Offset;
+
+#if PLATFORM_WIN32
+    while (Size > 0)
+    {
+        // The handle is not opened for overlapped I/O, so the offset in the OVERLAPPED
+        // structure makes ReadFile a synchronous positional read that is safe to use from several threads.
+        OVERLAPPED Overlapped{};
+        Overlapped.Offset     = static_cast<DWORD>(static_cast<Uint64>(Offset) & 0xFFFFFFFFu);
+        Overlapped.OffsetHigh = static_cast<DWORD>(static_cast<Uint64>(Offset) >> 32u);
+
+        const auto NumBytesToRead = static_cast<DWORD>(std::min(Size, size_t{1} << 30u));
+        DWORD      NumBytesRead   = 0;
+        if (!::ReadFile(Request.hFile, pDst, NumBytesToRead, &NumBytesRead, &Overlapped) || NumBytesRead == 0)
+        {
+            Request.SetError(FormatString("Failed to read file ", Request.Path, "\n"));
+            return;
+        }
+
+        pDst += NumBytesRead;
+        Offset += NumBytesRead;
+        Size -= NumBytesRead;
+    }
+#elif DILIGENT_USE_POSIX_PREAD
+    while (Size > 0)
+    {
+        const auto NumBytesRead = pread(Request.fd, pDst, Size, static_cast<off_t>(Offset));
+        if (NumBytesRead < 0 && errno == EINTR)
+            continue;
+
+        if (NumBytesRead <= 0)
+        {
+            Request.SetError(FormatString("Failed to read file ", Request.Path, "\n"));
+            return;
+        }
+
+        pDst += NumBytesRead;
+        Offset += static_cast<size_t>(NumBytesRead);
+        Size -= static_cast<size_t>(NumBytesRead);
+    }
+#else
+    UNEXPECTED("Chunks are only read on platforms that support positional reads");
+#endif
+}
+
+void AsyncFileReader::FinishRequest(FileRequest& Request)
+{
+    Request.Close();
+    if (!Request.Error.empty())
+        Request.Data.clear();
+
+    Request.Callback(Request.Path.c_str(), Request.Data, Request.Error);
+
+    bool Idle = false;
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        VERIFY_EXPR(m_NumPendingRequests > 0);
+        Idle = --m_NumPendingRequests == 0;
+    }
+    if (Idle)
+        m_IdleCV.notify_all();
+}
+
+} // namespace Diligent
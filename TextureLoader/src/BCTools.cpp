@@ -25,82 +25,147 @@
  */
 
 #include "BCTools.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
 #include "DebugUtilities.hpp"
+#include "GraphicsAccessories.hpp"
+#include "ThreadPool.hpp"
+
+#include "../../ThirdParty/stb/stb_dxt.h"
 
 namespace Diligent
 {
 
-inline void DecompressColorBlock(const Uint8* Bits,
-                                 Uint8*       DstBuffer,
-                                 Uint32       DstChannels)
+namespace
 {
-    VERIFY_EXPR(DstChannels >= 3);
+
+// Reads the bits of a 128-bit block starting from the least significant bit of the first byte
+class BlockBitReader
+{
+public:
+    explicit BlockBitReader(const Uint8* Bits)
+    {
+        for (Uint32 i = 0; i < 8; ++i)
+        {
+            m_Lo |= Uint64{Bits[i]} << (i * 8);
+            m_Hi |= Uint64{Bits[i + 8]} << (i * 8);
+        }
+    }
+
+    Uint32 Read(Uint32 NumBits)
+    {
+        VERIFY_EXPR(NumBits <= 32 && m_Pos + NumBits <= 128);
+        if (NumBits == 0)
+            return 0;
+
+        Uint64 Bits = 0;
+        if (m_Pos >= 64)
+            Bits = m_Hi >> (m_Pos - 64);
+        else if (m_Pos + NumBits <= 64)
+            Bits = m_Lo >> m_Pos;
+        else
+            Bits = (m_Lo >> m_Pos) | (m_Hi << (64 - m_Pos));
+        m_Pos += NumBits;
+
+        return static_cast<Uint32>(Bits & ((Uint64{1} << NumBits) - 1));
+    }
+
+private:
+    Uint64 m_Lo  = 0;
+    Uint64 m_Hi  = 0;
+    Uint32 m_Pos = 0;
+};
+
+inline Uint8 Expand565Component(Uint32 Value, Uint32 NumBits)
+{
+    return static_cast<Uint8>((Value << (8 - NumBits)) | (Value >> (2 * NumBits - 8)));
+}
+
+// BC2 and BC3 color blocks always use the four-color mode, while BC1 blocks
+// switch to the three-color mode with transparent black when Color0 <= Color1.
+void DecompressColorBlock(const Uint8* Bits,
+                          Uint8*       DstBuffer,
+                          Uint32       DstChannels,
+                          bool         AllowPunchThrough)
+{
+    VERIFY_EXPR(DstChannels == 3 || DstChannels == 4);
     const Uint32 RGB[2] =
         {
             Uint32{Bits[0]} | ((Uint32{Bits[1]}) << 8),
             Uint32{Bits[2]} | ((Uint32{Bits[3]}) << 8) //
         };
 
-    static constexpr Uint32 ROffset = 11;
-    static constexpr Uint32 GOffset = 5;
-    static constexpr Uint32 BOffset = 0;
-
-    static constexpr Uint32 RMask = (1 << 5) - 1;
-    static constexpr Uint32 GMask = (1 << 6) - 1;
-    static constexpr Uint32 BMask = (1 << 5) - 1;
-
-    Uint32 R[4] = {(RGB[0] >> ROffset) & RMask, (RGB[1] >> ROffset) & RMask, 0, 0};
-    Uint32 G[4] = {(RGB[0] >> GOffset) & GMask, (RGB[1] >> GOffset) & GMask, 0, 0};
-    Uint32 B[4] = {(RGB[0] >> BOffset) & BMask, (RGB[1] >> BOffset) & BMask, 0, 0};
-
-    if (RGB[0] > RGB[1])
+    Uint8 Palette[4][4];
+    for (Uint32 i = 0; i < 2; ++i)
     {
-        R[2] = (2 * R[0] + 1 * R[1]) / 3;
-        G[2] = (2 * G[0] + 1 * G[1]) / 3;
-        B[2] = (2 * B[0] + 1 * B[1]) / 3;
+        Palette[i][0] = Expand565Component((RGB[i] >> 11) & 0x1F, 5);
+        Palette[i][1] = Expand565Component((RGB[i] >> 5) & 0x3F, 6);
+        Palette[i][2] = Expand565Component(RGB[i] & 0x1F, 5);
+        Palette[i][3] = 255;
+    }
 
-        R[3] = (1 * R[0] + 2 * R[1]) / 3;
-        G[3] = (1 * G[0] + 2 * G[1]) / 3;
-        B[3] = (1 * B[0] + 2 * B[1]) / 3;
+    if (RGB[0] > RGB[1] || !AllowPunchThrough)
+    {
+        for (Uint32 c = 0; c < 3; ++c)
+        {
+            Palette[2][c] = static_cast<Uint8>((2 * Palette[0][c] + 1 * Palette[1][c] + 1) / 3);
+            Palette[3][c] = static_cast<Uint8>((1 * Palette[0][c] + 2 * Palette[1][c] + 1) / 3);
+        }
+        Palette[2][3] = 255;
+        Palette[3][3] = 255;
     }
     else
     {
-        R[2] = (2 * R[0] + 1 * R[1]) / 2;
-        G[2] = (2 * G[0] + 1 * G[1]) / 2;
-        B[2] = (2 * B[0] + 1 * B[1]) / 2;
+        for (Uint32 c = 0; c < 3; ++c)
+            Palette[2][c] = static_cast<Uint8>((Palette[0][c] + Palette[1][c] + 1) / 2);
+        Palette[2][3] = 255;
+        memset(Palette[3], 0, sizeof(Palette[3]));
     }
 
-    const Uint8* Palette = Bits + 4;
+    const Uint32 Indices = Uint32{Bits[4]} | (Uint32{Bits[5]} << 8) | (Uint32{Bits[6]} << 16) | (Uint32{Bits[7]} << 24);
     for (Uint32 i = 0; i < 16; ++i)
     {
-        const auto Idx = (Palette[i / 4] >> ((i % 4) * 2)) & 0x03;
-
-        DstBuffer[i * DstChannels + 0] = (R[Idx] << 3u) & 0xFFu;
-        DstBuffer[i * DstChannels + 1] = (G[Idx] << 2u) & 0xFFu;
-        DstBuffer[i * DstChannels + 2] = (B[Idx] << 3u) & 0xFFu;
+        const auto Idx = (Indices >> (i * 2)) & 0x03;
+        memcpy(DstBuffer + i * DstChannels, Palette[Idx], DstChannels);
     }
 }
 
-inline void DecompressAlphaBlock(const Uint8* Bits,
-                                 Uint8*       DstBuffer,
-                                 Uint32       DstChannels)
+// Decompresses BC3 alpha or BC4/BC5 channel block. For signed blocks, endpoints are
+// two's complement values and -128 is treated as -127.
+template <typename ValueType>
+void DecompressAlphaBlock(const Uint8* Bits,
+                          ValueType*   DstBuffer,
+                          Uint32       DstChannels)
 {
-    Uint32 Alpha[8] = {Bits[0], Bits[1]};
+    constexpr bool IsSigned = std::is_signed<ValueType>::value;
+    constexpr int  MinValue = IsSigned ? -127 : 0;
+    constexpr int  MaxValue = IsSigned ? 127 : 255;
+
+    int Alpha[8] =
+        {
+            std::max(int{static_cast<ValueType>(Bits[0])}, MinValue),
+            std::max(int{static_cast<ValueType>(Bits[1])}, MinValue) //
+        };
     if (Alpha[0] > Alpha[1])
     {
-        for (Uint32 i = 2; i < 8; ++i)
+        for (int i = 2; i < 8; ++i)
         {
             Alpha[i] = ((8 - i) * Alpha[0] + (i - 1) * Alpha[1]) / 7;
         }
     }
     else
     {
-        for (Uint32 i = 2; i < 6; ++i)
+        for (int i = 2; i < 6; ++i)
         {
             Alpha[i] = ((6 - i) * Alpha[0] + (i - 1) * Alpha[1]) / 5;
         }
-        Alpha[6] = 0;
-        Alpha[7] = 255;
+        Alpha[6] = MinValue;
+        Alpha[7] = MaxValue;
     }
 
     for (size_t p = 0; p < 2; ++p)
@@ -111,23 +176,351 @@ inline void DecompressAlphaBlock(const Uint8* Bits,
         {
             Uint32 Idx = (Palette0 >> (i * 3)) & 0x07;
 
-            DstBuffer[(p * 8 + i) * DstChannels] = Alpha[Idx] & 0xFFu;
+            DstBuffer[(p * 8 + i) * DstChannels] = static_cast<ValueType>(Alpha[Idx]);
         }
     }
 }
 
+
+// BC6H and BC7 share the partition tables for two subsets.
+// Bit i of the mask is set if texel i belongs to the second subset.
+static const Uint16 BC7Partitions2[64] =
+    {
+        0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+        0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+        0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+        0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+        0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+        0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+        0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+        0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+    };
+
+static const Uint8 BC7Partitions3[64][16] =
+    {
+        {0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2},
+        {0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1},
+        {0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1},
+        {0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1},
+        {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2},
+        {0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2},
+        {0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1},
+        {0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1},
+        {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2},
+        {0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2},
+        {0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2},
+        {0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2},
+        {0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2},
+        {0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2},
+        {0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2},
+        {0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0},
+        {0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2},
+        {0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0},
+        {0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2},
+        {0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1},
+        {0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2},
+        {0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1},
+        {0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2},
+        {0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0},
+        {0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0},
+        {0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2},
+        {0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0},
+        {0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1},
+        {0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2},
+        {0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2},
+        {0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1},
+        {0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1},
+        {0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2},
+        {0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1},
+        {0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2},
+        {0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0},
+        {0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0},
+        {0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0},
+        {0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0},
+        {0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1},
+        {0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1},
+        {0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2},
+        {0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1},
+        {0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2},
+        {0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1},
+        {0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1},
+        {0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1},
+        {0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1},
+        {0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2},
+        {0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1},
+        {0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2},
+        {0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2},
+        {0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2},
+        {0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2},
+        {0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2},
+        {0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2},
+        {0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2},
+        {0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2},
+        {0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2},
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2},
+        {0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1},
+        {0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2},
+        {0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2},
+        {0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0},
+    };
+
+// Anchor texel of the second subset in two-subset partitions
+static const Uint8 BC7Anchors2[64] =
+    {
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 15, 15, 15, 15, 15, 15, 15,
+        15, 2, 8, 2, 2, 8, 8, 15,
+        2, 8, 2, 2, 8, 8, 2, 2,
+        15, 15, 6, 8, 2, 8, 15, 15,
+        2, 8, 2, 2, 2, 15, 15, 6,
+        6, 2, 6, 8, 15, 15, 2, 2,
+        15, 15, 15, 15, 15, 2, 2, 15,
+    };
+
+// Anchor texels of the second and third subsets in three-subset partitions
+static const Uint8 BC7Anchors3[2][64] =
+    {
+        {
+            3, 3, 15, 15, 8, 3, 15, 15,
+            8, 8, 6, 6, 6, 5, 3, 3,
+            3, 3, 8, 15, 3, 3, 6, 10,
+            5, 8, 8, 6, 8, 5, 15, 15,
+            8, 15, 3, 5, 6, 10, 8, 15,
+            15, 3, 15, 5, 15, 15, 15, 15,
+            3, 15, 5, 5, 5, 8, 5, 10,
+            5, 10, 8, 13, 15, 12, 3, 3,
+        },
+        {
+            15, 8, 8, 3, 15, 15, 3, 8,
+            15, 15, 15, 15, 15, 15, 15, 8,
+            15, 8, 15, 3, 15, 8, 15, 8,
+            3, 15, 6, 10, 15, 15, 10, 8,
+            15, 3, 15, 10, 10, 8, 9, 10,
+            6, 15, 8, 15, 3, 6, 6, 8,
+            15, 3, 15, 15, 15, 15, 15, 15,
+            15, 15, 15, 15, 3, 15, 15, 8,
+        },
+    };
+
+static const Uint8 BC7Weights2[4]  = {0, 21, 43, 64};
+static const Uint8 BC7Weights3[8]  = {0, 9, 18, 27, 37, 46, 55, 64};
+static const Uint8 BC7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+inline Uint32 GetBC7Weight(Uint32 IndexBits, Uint32 Index)
+{
+    switch (IndexBits)
+    {
+        case 2: return BC7Weights2[Index];
+        case 3: return BC7Weights3[Index];
+        case 4: return BC7Weights4[Index];
+        default:
+            UNEXPECTED("Unexpected number of index bits");
+            return 0;
+    }
+}
+
+inline Uint32 GetSubsetAnchor(Uint32 NumSubsets, Uint32 Partition, Uint32 Subset)
+{
+    if (Subset == 0)
+        return 0;
+    return NumSubsets == 2 ? BC7Anchors2[Partition] : BC7Anchors3[Subset - 1][Partition];
+}
+
+inline Uint32 GetTexelSubset(Uint32 NumSubsets, Uint32 Partition, Uint32 Texel)
+{
+    switch (NumSubsets)
+    {
+        case 1: return 0;
+        case 2: return (BC7Partitions2[Partition] >> Texel) & 0x01;
+        case 3: return BC7Partitions3[Partition][Texel];
+        default:
+            UNEXPECTED("Unexpected number of subsets");
+            return 0;
+    }
+}
+
+struct BC7ModeInfo
+{
+    Uint8 NumSubsets;
+    Uint8 PartitionBits;
+    Uint8 RotationBits;
+    Uint8 IndexSelectionBits;
+    Uint8 ColorBits;
+    Uint8 AlphaBits;
+    Uint8 EndpointPBits;
+    Uint8 SharedPBits;
+    Uint8 IndexBits;
+    Uint8 Index2Bits;
+};
+
+// clang-format off
+static const BC7ModeInfo BC7Modes[8] =
+{
+    // NS  PB  RB  ISB  CB  AB  EPB  SPB  IB  IB2
+    {  3,  4,  0,  0,   4,  0,  1,   0,   3,  0},
+    {  2,  6,  0,  0,   6,  0,  0,   1,   3,  0},
+    {  3,  6,  0,  0,   5,  0,  0,   0,   2,  0},
+    {  2,  6,  0,  0,   7,  0,  1,   0,   2,  0},
+    {  1,  0,  2,  1,   5,  6,  0,   0,   2,  3},
+    {  1,  0,  2,  0,   7,  8,  0,   0,   2,  2},
+    {  1,  0,  0,  0,   7,  7,  1,   0,   4,  0},
+    {  2,  6,  0,  0,   5,  5,  1,   0,   2,  0},
+};
+// clang-format on
+
+inline int InterpolateBC67(int E0, int E1, Uint32 Weight)
+{
+    return ((64 - static_cast<int>(Weight)) * E0 + static_cast<int>(Weight) * E1 + 32) >> 6;
+}
+
+
+// BC6H endpoint fields. W and X are the endpoints of the first region, Y and Z are the endpoints of the second one.
+enum BC6H_FIELD : Uint8
+{
+    // clang-format off
+    RW, GW, BW,
+    RX, GX, BX,
+    RY, GY, BY,
+    RZ, GZ, BZ,
+    // clang-format on
+    D // Partition
+};
+
+struct BC6HBitField
+{
+    BC6H_FIELD Field;
+    Uint8      Shift;
+    Uint8      NumBits;
+};
+
+struct BC6HModeInfo
+{
+    Uint8               ModeBits;
+    bool                Transformed;
+    Uint8               NumRegions;
+    Uint8               EndpointBits;
+    Uint8               DeltaBits[3];
+    const BC6HBitField* Fields;
+    size_t              NumFields;
+};
+
+// Bit layouts of the BC6H modes following the mode bits
+// clang-format off
+static const BC6HBitField BC6HMode1Fields[] = {{GY,4,1},{BY,4,1},{BZ,4,1},{RW,0,10},{GW,0,10},{BW,0,10},{RX,0,5},{GZ,4,1},{GY,0,4},{GX,0,5},{BZ,0,1},{GZ,0,4},{BX,0,5},{BZ,1,1},{BY,0,4},{RY,0,5},{BZ,2,1},{RZ,0,5},{BZ,3,1},{D,0,5}};
+static const BC6HBitField BC6HMode2Fields[] = {{GY,5,1},{GZ,4,1},{GZ,5,1},{RW,0,7},{BZ,0,1},{BZ,1,1},{BY,4,1},{GW,0,7},{BY,5,1},{BZ,2,1},{GY,4,1},{BW,0,7},{BZ,3,1},{BZ,5,1},{BZ,4,1},{RX,0,6},{GY,0,4},{GX,0,6},{GZ,0,4},{BX,0,6},{BY,0,4},{RY,0,6},{RZ,0,6},{D,0,5}};
+static const BC6HBitField BC6HMode3Fields[] = {{RW,0,10},{GW,0,10},{BW,0,10},{RX,0,5},{RW,10,1},{GY,0,4},{GX,0,4},{GW,10,1},{BZ,0,1},{GZ,0,4},{BX,0,4},{BW,10,1},{BZ,1,1},{BY,0,4},{RY,0,5},{BZ,2,1},{RZ,0,5},{BZ,3,1},{D,0,5}};
+static const BC6HBitField BC6HMode4Fields[] = {{RW,0,10},{GW,0,10},{BW,0,10},{RX,0,4},{RW,10,1},{GZ,4,1},{GY,0,4},{GX,0,5},{GW,10,1},{GZ,0,4},{BX,0,4},{BW,10,1},{BZ,1,1},{BY,0,4},{RY,0,4},{BZ,0,1},{BZ,2,1},{RZ,0,4},{GY,4,1},{BZ,3,1},{D,0,5}};
+static const BC6HBitField BC6HMode5Fields[] = {{RW,0,10},{GW,0,10},{BW,0,10},{RX,0,4},{RW,10,1},{BY,4,1},{GY,0,4},{GX,0,4},{GW,10,1},{BZ,0,1},{GZ,0,4},{BX,0,5},{BW,10,1},{BY,0,4},{RY,0,4},{BZ,1,1},{BZ,2,1},{RZ,0,4},{BZ,4,1},{BZ,3,1},{D,0,5}};
+static const BC6HBitField BC6HMode6Fields[] = {{RW,0,9},{BY,4,1},{GW,0,9},{GY,4,1},{BW,0,9},{BZ,4,1},{RX,0,5},{GZ,4,1},{GY,0,4},{GX,0,5},{BZ,0,1},{GZ,0,4},{BX,0,5},{BZ,1,1},{BY,0,4},{RY,0,5},{BZ,2,1},{RZ,0,5},{BZ,3,1},{D,0,5}};
+static const BC6HBitField BC6HMode7Fields[] = {{RW,0,8},{GZ,4,1},{BY,4,1},{GW,0,8},{BZ,2,1},{GY,4,1},{BW,0,8},{BZ,3,1},{BZ,4,1},{RX,0,6},{GY,0,4},{GX,0,5},{BZ,0,1},{GZ,0,4},{BX,0,5},{BZ,1,1},{BY,0,4},{RY,0,6},{RZ,0,6},{D,0,5}};
+static const BC6HBitField BC6HMode8Fields[] = {{RW,0,8},{BZ,0,1},{BY,4,1},{GW,0,8},{GY,5,1},{GY,4,1},{BW,0,8},{GZ,5,1},{BZ,4,1},{RX,0,5},{GZ,4,1},{GY,0,4},{GX,0,6},{GZ,0,4},{BX,0,5},{BZ,1,1},{BY,0,4},{RY,0,5},{BZ,2,1},{RZ,0,5},{BZ,3,1},{D,0,5}};
+static const BC6HBitField BC6HMode9Fields[] = {{RW,0,8},{BZ,1,1},{BY,4,1},{GW,0,8},{BY,5,1},{GY,4,1},{BW,0,8},{BZ,5,1},{BZ,4,1},{RX,0,5},{GZ,4,1},{GY,0,4},{GX,0,5},{BZ,0,1},{GZ,0,4},{BX,0,6},{BY,0,4},{RY,0,5},{BZ,2,1},{RZ,0,5},{BZ,3,1},{D,0,5}};
+static const BC6HBitField BC6HMode10Fields[] = {{RW,0,6},{GZ,4,1},{BZ,0,1},{BZ,1,1},{BY,4,1},{GW,0,6},{GY,5,1},{BY,5,1},{BZ,2,1},{GY,4,1},{BW,0,6},{GZ,5,1},{BZ,3,1},{BZ,5,1},{BZ,4,1},{RX,0,6},{GY,0,4},{GX,0,6},{GZ,0,4},{BX,0,6},{BY,0,4},{RY,0,6},{RZ,0,6},{D,0,5}};
+static const BC6HBitField BC6HMode11Fields[] = {{RW,0,10},{GW,0,10},{BW,0,10},{RX,0,10},{GX,0,10},{BX,0,10}};
+static const BC6HBitField BC6HMode12Fields[] = {{RW,0,10},{GW,0,10},{BW,0,10},{RX,0,9},{RW,10,1},{GX,0,9},{GW,10,1},{BX,0,9},{BW,10,1}};
+// The high bits of the base endpoint in modes 13 and 14 are stored in reverse order
+static const BC6HBitField BC6HMode13Fields[] = {{RW,0,10},{GW,0,10},{BW,0,10},{RX,0,8},{RW,11,1},{RW,10,1},{GX,0,8},{GW,11,1},{GW,10,1},{BX,0,8},{BW,11,1},{BW,10,1}};
+static const BC6HBitField BC6HMode14Fields[] = {{RW,0,10},{GW,0,10},{BW,0,10},
+                                                {RX,0,4},{RW,15,1},{RW,14,1},{RW,13,1},{RW,12,1},{RW,11,1},{RW,10,1},
+                                                {GX,0,4},{GW,15,1},{GW,14,1},{GW,13,1},{GW,12,1},{GW,11,1},{GW,10,1},
+                                                {BX,0,4},{BW,15,1},{BW,14,1},{BW,13,1},{BW,12,1},{BW,11,1},{BW,10,1}};
+
+#define BC6H_FIELDS(Fields) Fields, _countof(Fields)
+static const BC6HModeInfo BC6HModes[] =
+{
+    // Mode bits  Transformed  Regions  EP  Delta bits
+    {0x00,        true,        2,       10, {5, 5, 5},    BC6H_FIELDS(BC6HMode1Fields)},
+    {0x01,        true,        2,       7,  {6, 6, 6},    BC6H_FIELDS(BC6HMode2Fields)},
+    {0x02,        true,        2,       11, {5, 4, 4},    BC6H_FIELDS(BC6HMode3Fields)},
+    {0x06,        true,        2,       11, {4, 5, 4},    BC6H_FIELDS(BC6HMode4Fields)},
+    {0x0A,        true,        2,       11, {4, 4, 5},    BC6H_FIELDS(BC6HMode5Fields)},
+    {0x0E,        true,        2,       9,  {5, 5, 5},    BC6H_FIELDS(BC6HMode6Fields)},
+    {0x12,        true,        2,       8,  {6, 5, 5},    BC6H_FIELDS(BC6HMode7Fields)},
+    {0x16,        true,        2,       8,  {5, 6, 5},    BC6H_FIELDS(BC6HMode8Fields)},
+    {0x1A,        true,        2,       8,  {5, 5, 6},    BC6H_FIELDS(BC6HMode9Fields)},
+    {0x1E,        false,       2,       6,  {6, 6, 6},    BC6H_FIELDS(BC6HMode10Fields)},
+    {0x03,        false,       1,       10, {10, 10, 10}, BC6H_FIELDS(BC6HMode11Fields)},
+    {0x07,        true,        1,       11, {9, 9, 9},    BC6H_FIELDS(BC6HMode12Fields)},
+    {0x0B,        true,        1,       12, {8, 8, 8},    BC6H_FIELDS(BC6HMode13Fields)},
+    {0x0F,        true,        1,       16, {4, 4, 4},    BC6H_FIELDS(BC6HMode14Fields)},
+};
+#undef BC6H_FIELDS
+// clang-format on
+
+inline int SignExtend(int Value, Uint32 NumBits)
+{
+    const int SignBit = 1 << (NumBits - 1);
+    return (Value & (SignBit - 1)) - (Value & SignBit);
+}
+
+inline int UnquantizeBC6H(int Value, Uint32 NumBits, bool IsSigned)
+{
+    if (!IsSigned)
+    {
+        if (NumBits >= 15)
+            return Value;
+        if (Value == 0)
+            return 0;
+        if (Value == (1 << NumBits) - 1)
+            return 0xFFFF;
+        return ((Value << 16) + 0x8000) >> NumBits;
+    }
+    else
+    {
+        if (NumBits >= 16)
+            return Value;
+
+        const bool IsNegative = Value < 0;
+        if (IsNegative)
+            Value = -Value;
+
+        int Unquantized = 0;
+        if (Value == 0)
+            Unquantized = 0;
+        else if (Value >= (1 << (NumBits - 1)) - 1)
+            Unquantized = 0x7FFF;
+        else
+            Unquantized = ((Value << 15) + 0x4000) >> (NumBits - 1);
+
+        return IsNegative ? -Unquantized : Unquantized;
+    }
+}
+
+// Scales the interpolated value to the half-float bit pattern
+inline Uint16 FinishUnquantizeBC6H(int Value, bool IsSigned)
+{
+    if (!IsSigned)
+        return static_cast<Uint16>((Value * 31) >> 6);
+    else
+        return static_cast<Uint16>(Value < 0 ? (0x8000 | ((-Value * 31) >> 5)) : ((Value * 31) >> 5));
+}
+
+} // namespace
+
 void DecompressBC1Block(const Uint8* Bits,
                         Uint8*       DstBuffer,
                         Uint32       DstChannels)
 {
     VERIFY_EXPR(DstChannels >= 3);
-    DecompressColorBlock(Bits, DstBuffer, DstChannels);
+    DecompressColorBlock(Bits, DstBuffer, DstChannels, true);
+}
+
+void DecompressBC2Block(const Uint8* Bits,
+                        Uint8*       DstBuffer)
+{
+    DecompressColorBlock(Bits + 8, DstBuffer, 4, false);
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        const Uint32 Alpha = (Bits[i / 2] >> ((i % 2) * 4)) & 0x0F;
+
+        DstBuffer[i * 4 + 3] = static_cast<Uint8>(Alpha * 17);
+    }
 }
 
 void DecompressBC3Block(const Uint8* Bits,
                         Uint8*       DstBuffer)
 {
-    DecompressColorBlock(Bits + 8, DstBuffer, 4);
+    DecompressColorBlock(Bits + 8, DstBuffer, 4, false);
     DecompressAlphaBlock(Bits, DstBuffer + 3, 4);
 }
 
@@ -139,13 +532,850 @@ void DecompressBC4Block(const Uint8* Bits,
     DecompressAlphaBlock(Bits, DstBuffer, DstChannels);
 }
 
-void DecompressBC5lock(const Uint8* Bits,
-                       Uint8*       DstBuffer,
-                       Uint32       DstChannels)
+void DecompressBC5Block(const Uint8* Bits,
+                        Uint8*       DstBuffer,
+                        Uint32       DstChannels)
 {
     VERIFY_EXPR(DstChannels >= 2);
     DecompressAlphaBlock(Bits, DstBuffer, DstChannels);
     DecompressAlphaBlock(Bits + 8, DstBuffer + 1, DstChannels);
 }
 
+void DecompressBC6HBlock(const Uint8* Bits,
+                         Uint16*      DstBuffer,
+                         bool         IsSigned,
+                         Uint32       DstChannels)
+{
+    VERIFY_EXPR(DstChannels == 3 || DstChannels == 4);
+
+    BlockBitReader Reader{Bits};
+
+    Uint32 ModeBits = Reader.Read(2);
+    if (ModeBits > 1)
+        ModeBits |= Reader.Read(3) << 2;
+
+    const BC6HModeInfo* pMode = nullptr;
+    for (const auto& Mode : BC6HModes)
+    {
+        if (Mode.ModeBits == ModeBits)
+        {
+            pMode = &Mode;
+            break;
+        }
+    }
+
+    if (pMode == nullptr)
+    {
+        // Reserved modes decode to black
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            for (Uint32 c = 0; c < DstChannels; ++c)
+                DstBuffer[i * DstChannels + c] = c < 3 ? 0 : 0x3C00;
+        }
+        return;
+    }
+
+    int    Endpoints[4][3] = {};
+    Uint32 Partition       = 0;
+    for (size_t f = 0; f < pMode->NumFields; ++f)
+    {
+        const auto&  Field = pMode->Fields[f];
+        const Uint32 Value = Reader.Read(Field.NumBits);
+        if (Field.Field == D)
+            Partition |= Value << Field.Shift;
+        else
+            Endpoints[Field.Field / 3][Field.Field % 3] |= static_cast<int>(Value << Field.Shift);
+    }
+
+    const Uint32 NumEndpoints = pMode->NumRegions * 2u;
+    const Uint32 EPBits       = pMode->EndpointBits;
+    const int    EPMask       = (1 << EPBits) - 1;
+    for (Uint32 c = 0; c < 3; ++c)
+    {
+        if (IsSigned)
+            Endpoints[0][c] = SignExtend(Endpoints[0][c], EPBits);
+
+        for (Uint32 e = 1; e < NumEndpoints; ++e)
+        {
+            auto& EP = Endpoints[e][c];
+            if (pMode->Transformed)
+            {
+                // Endpoints are stored as signed deltas from the base endpoint
+                EP = (Endpoints[0][c] + SignExtend(EP, pMode->DeltaBits[c])) & EPMask;
+            }
+            if (IsSigned)
+                EP = SignExtend(EP, EPBits);
+        }
+
+        for (Uint32 e = 0; e < NumEndpoints; ++e)
+            Endpoints[e][c] = UnquantizeBC6H(Endpoints[e][c], EPBits, IsSigned);
+    }
+
+    const Uint32 IndexBits = pMode->NumRegions == 2 ? 3 : 4;
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        const Uint32 Region  = GetTexelSubset(pMode->NumRegions, Partition, i);
+        const bool   Anchor  = i == GetSubsetAnchor(pMode->NumRegions, Partition, Region);
+        const Uint32 Index   = Reader.Read(Anchor ? IndexBits - 1 : IndexBits);
+        const Uint32 Weight  = GetBC7Weight(IndexBits, Index);
+        const auto*  E0      = Endpoints[Region * 2 + 0];
+        const auto*  E1      = Endpoints[Region * 2 + 1];
+        auto*        pTexel  = DstBuffer + i * DstChannels;
+        for (Uint32 c = 0; c < 3; ++c)
+            pTexel[c] = FinishUnquantizeBC6H(InterpolateBC67(E0[c], E1[c], Weight), IsSigned);
+        if (DstChannels == 4)
+            pTexel[3] = 0x3C00; // 1.0
+    }
+}
+
+void DecompressBC7Block(const Uint8* Bits,
+                        Uint8*       DstBuffer)
+{
+    Uint32 Mode = 0;
+    while (Mode < 8 && (Bits[0] & (1u << Mode)) == 0)
+        ++Mode;
+
+    if (Mode == 8)
+    {
+        // Invalid block decodes to transparent black
+        memset(DstBuffer, 0, 16 * 4);
+        return;
+    }
+
+    const auto& Info = BC7Modes[Mode];
+
+    BlockBitReader Reader{Bits};
+    Reader.Read(Mode + 1);
+
+    const Uint32 Partition      = Reader.Read(Info.PartitionBits);
+    const Uint32 Rotation       = Reader.Read(Info.RotationBits);
+    const Uint32 IndexSelection = Reader.Read(Info.IndexSelectionBits);
+
+    // Endpoint components are stored channel by channel: all red values go first, then all green values, etc.
+    const Uint32 NumEndpoints  = Info.NumSubsets * 2u;
+    int          Endpoints[6][4] = {};
+    for (Uint32 c = 0; c < 4; ++c)
+    {
+        const Uint32 NumBits = c < 3 ? Info.ColorBits : Info.AlphaBits;
+        for (Uint32 e = 0; e < NumEndpoints; ++e)
+            Endpoints[e][c] = static_cast<int>(Reader.Read(NumBits));
+    }
+
+    Uint32 PBits[6] = {};
+    if (Info.EndpointPBits != 0)
+    {
+        for (Uint32 e = 0; e < NumEndpoints; ++e)
+            PBits[e] = Reader.Read(1);
+    }
+    else if (Info.SharedPBits != 0)
+    {
+        for (Uint32 s = 0; s < Info.NumSubsets; ++s)
+            PBits[s * 2 + 0] = PBits[s * 2 + 1] = Reader.Read(1);
+    }
+    const bool HasPBits = Info.EndpointPBits != 0 || Info.SharedPBits != 0;
+
+    for (Uint32 e = 0; e < NumEndpoints; ++e)
+    {
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            Uint32 NumBits = c < 3 ? Info.ColorBits : Info.AlphaBits;
+            if (NumBits == 0)
+            {
+                Endpoints[e][c] = 255;
+                continue;
+            }
+
+            int Value = Endpoints[e][c];
+            if (HasPBits)
+            {
+                Value = (Value << 1) | static_cast<int>(PBits[e]);
+                ++NumBits;
+            }
+            // Replicate the high bits into the low bits
+            Value <<= 8 - NumBits;
+            Value |= Value >> NumBits;
+
+            Endpoints[e][c] = Value;
+        }
+    }
+
+    Uint32 Indices[16]  = {};
+    Uint32 Indices2[16] = {};
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        const Uint32 Subset = GetTexelSubset(Info.NumSubsets, Partition, i);
+        const bool   Anchor = i == GetSubsetAnchor(Info.NumSubsets, Partition, Subset);
+        Indices[i]          = Reader.Read(Anchor ? Info.IndexBits - 1u : Info.IndexBits);
+    }
+    if (Info.Index2Bits != 0)
+    {
+        for (Uint32 i = 0; i < 16; ++i)
+            Indices2[i] = Reader.Read(i == 0 ? Info.Index2Bits - 1u : Info.Index2Bits);
+    }
+
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        const Uint32 Subset = GetTexelSubset(Info.NumSubsets, Partition, i);
+        const auto*  E0     = Endpoints[Subset * 2 + 0];
+        const auto*  E1     = Endpoints[Subset * 2 + 1];
+
+        Uint32 ColorWeight = GetBC7Weight(Info.IndexBits, Indices[i]);
+        Uint32 AlphaWeight = ColorWeight;
+        if (Info.Index2Bits != 0)
+        {
+            // The index selection bit swaps primary and secondary indices
+            const Uint32 Weight2 = GetBC7Weight(Info.Index2Bits, Indices2[i]);
+            if (IndexSelection == 0)
+                AlphaWeight = Weight2;
+            else
+                ColorWeight = Weight2;
+        }
+
+        Uint8 Texel[4];
+        for (Uint32 c = 0; c < 3; ++c)
+            Texel[c] = static_cast<Uint8>(InterpolateBC67(E0[c], E1[c], ColorWeight));
+        Texel[3] = static_cast<Uint8>(InterpolateBC67(E0[3], E1[3], AlphaWeight));
+
+        if (Rotation != 0)
+            std::swap(Texel[3], Texel[Rotation - 1]);
+
+        memcpy(DstBuffer + i * 4, Texel, 4);
+    }
+}
+
+TEXTURE_FORMAT GetBCDecompressedFormat(TEXTURE_FORMAT BCFormat)
+{
+    switch (BCFormat)
+    {
+        case TEX_FORMAT_BC1_TYPELESS:
+        case TEX_FORMAT_BC1_UNORM:
+        case TEX_FORMAT_BC2_TYPELESS:
+        case TEX_FORMAT_BC2_UNORM:
+        case TEX_FORMAT_BC3_TYPELESS:
+        case TEX_FORMAT_BC3_UNORM:
+        case TEX_FORMAT_BC7_TYPELESS:
+        case TEX_FORMAT_BC7_UNORM:
+            return TEX_FORMAT_RGBA8_UNORM;
+
+        case TEX_FORMAT_BC1_UNORM_SRGB:
+        case TEX_FORMAT_BC2_UNORM_SRGB:
+        case TEX_FORMAT_BC3_UNORM_SRGB:
+        case TEX_FORMAT_BC7_UNORM_SRGB:
+            return TEX_FORMAT_RGBA8_UNORM_SRGB;
+
+        case TEX_FORMAT_BC4_TYPELESS:
+        case TEX_FORMAT_BC4_UNORM:
+            return TEX_FORMAT_R8_UNORM;
+
+        case TEX_FORMAT_BC4_SNORM:
+            return TEX_FORMAT_R8_SNORM;
+
+        case TEX_FORMAT_BC5_TYPELESS:
+        case TEX_FORMAT_BC5_UNORM:
+            return TEX_FORMAT_RG8_UNORM;
+
+        case TEX_FORMAT_BC5_SNORM:
+            return TEX_FORMAT_RG8_SNORM;
+
+        case TEX_FORMAT_BC6H_TYPELESS:
+        case TEX_FORMAT_BC6H_UF16:
+        case TEX_FORMAT_BC6H_SF16:
+            return TEX_FORMAT_RGBA16_FLOAT;
+
+        default:
+            return TEX_FORMAT_UNKNOWN;
+    }
+}
+
+namespace
+{
+
+// Decompresses a single block into the tightly packed 4x4 texel buffer
+using DecompressBlockFuncType = void (*)(const Uint8* Bits, void* pDstTexels);
+
+DecompressBlockFuncType GetDecompressBlockFunc(TEXTURE_FORMAT BCFormat)
+{
+    // clang-format off
+    switch (BCFormat)
+    {
+        case TEX_FORMAT_BC1_TYPELESS:
+        case TEX_FORMAT_BC1_UNORM:
+        case TEX_FORMAT_BC1_UNORM_SRGB:
+            return [](const Uint8* Bits, void* pDst) { DecompressBC1Block(Bits, static_cast<Uint8*>(pDst), 4); };
+
+        case TEX_FORMAT_BC2_TYPELESS:
+        case TEX_FORMAT_BC2_UNORM:
+        case TEX_FORMAT_BC2_UNORM_SRGB:
+            return [](const Uint8* Bits, void* pDst) { DecompressBC2Block(Bits, static_cast<Uint8*>(pDst)); };
+
+        case TEX_FORMAT_BC3_TYPELESS:
+        case TEX_FORMAT_BC3_UNORM:
+        case TEX_FORMAT_BC3_UNORM_SRGB:
+            return [](const Uint8* Bits, void* pDst) { DecompressBC3Block(Bits, static_cast<Uint8*>(pDst)); };
+
+        case TEX_FORMAT_BC4_TYPELESS:
+        case TEX_FORMAT_BC4_UNORM:
+            return [](const Uint8* Bits, void* pDst) { DecompressBC4Block(Bits, static_cast<Uint8*>(pDst), 1); };
+
+        case TEX_FORMAT_BC4_SNORM:
+            return [](const Uint8* Bits, void* pDst) { DecompressAlphaBlock(Bits, static_cast<Int8*>(pDst), 1); };
+
+        case TEX_FORMAT_BC5_TYPELESS:
+        case TEX_FORMAT_BC5_UNORM:
+            return [](const Uint8* Bits, void* pDst) { DecompressBC5Block(Bits, static_cast<Uint8*>(pDst), 2); };
+
+        case TEX_FORMAT_BC5_SNORM:
+            return [](const Uint8* Bits, void* pDst) {
+                DecompressAlphaBlock(Bits, static_cast<Int8*>(pDst), 2);
+                DecompressAlphaBlock(Bits + 8, static_cast<Int8*>(pDst) + 1, 2);
+            };
+
+        case TEX_FORMAT_BC6H_TYPELESS:
+        case TEX_FORMAT_BC6H_UF16:
+            return [](const Uint8* Bits, void* pDst) { DecompressBC6HBlock(Bits, static_cast<Uint16*>(pDst), false, 4); };
+
+        case TEX_FORMAT_BC6H_SF16:
+            return [](const Uint8* Bits, void* pDst) { DecompressBC6HBlock(Bits, static_cast<Uint16*>(pDst), true, 4); };
+
+        case TEX_FORMAT_BC7_TYPELESS:
+        case TEX_FORMAT_BC7_UNORM:
+        case TEX_FORMAT_BC7_UNORM_SRGB:
+            return [](const Uint8* Bits, void* pDst) { DecompressBC7Block(Bits, static_cast<Uint8*>(pDst)); };
+
+        default:
+            return nullptr;
+    }
+    // clang-format on
+}
+
+// Number of block rows processed by a single thread pool task
+static constexpr Uint32 BlockRowsPerTask = 16;
+
+// Calls Handler(FirstRow, EndRow) for bands of block rows. If the thread pool is given,
+// bands are processed in parallel.
+template <typename HandlerType>
+void ProcessBlockRows(Uint32 NumBlockRows, IThreadPool* pThreadPool, const HandlerType& Handler)
+{
+    if (pThreadPool == nullptr || NumBlockRows <= BlockRowsPerTask)
+    {
+        Handler(0u, NumBlockRows);
+        return;
+    }
+
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    for (Uint32 FirstRow = 0; FirstRow < NumBlockRows; FirstRow += BlockRowsPerTask)
+    {
+        const auto EndRow = std::min(FirstRow + BlockRowsPerTask, NumBlockRows);
+        Tasks.emplace_back(EnqueueAsyncWork(pThreadPool, [&Handler, FirstRow, EndRow](Uint32 ThreadId) {
+            Handler(FirstRow, EndRow);
+        }));
+    }
+
+    for (auto& pTask : Tasks)
+        pTask->WaitForCompletion();
+}
+
+} // namespace
+
+void DecompressBCTexture(const DecompressBCTextureAttribs& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.Width > 0, "Width must not be zero");
+    DEV_CHECK_ERR(Attribs.Height > 0, "Height must not be zero");
+    DEV_CHECK_ERR(Attribs.pSrcBlocks != nullptr, "Source blocks pointer must not be null");
+    DEV_CHECK_ERR(Attribs.pDstPixels != nullptr, "Destination pixels pointer must not be null");
+
+    const auto DecompressBlock = GetDecompressBlockFunc(Attribs.Format);
+    if (DecompressBlock == nullptr)
+    {
+        UNSUPPORTED("Format ", GetTextureFormatAttribs(Attribs.Format).Name, " is not a BC format");
+        return;
+    }
+
+    const auto& SrcFmtAttribs = GetTextureFormatAttribs(Attribs.Format);
+    const auto& DstFmtAttribs = GetTextureFormatAttribs(GetBCDecompressedFormat(Attribs.Format));
+
+    // For compressed formats, the component size is the size of the block
+    const Uint32 BlockSize    = SrcFmtAttribs.ComponentSize;
+    const Uint32 TexelSize    = Uint32{DstFmtAttribs.ComponentSize} * Uint32{DstFmtAttribs.NumComponents};
+    const Uint32 NumBlocksX   = (Attribs.Width + 3) / 4;
+    const Uint32 NumBlockRows = (Attribs.Height + 3) / 4;
+    DEV_CHECK_ERR(Attribs.SrcStride >= NumBlocksX * BlockSize || NumBlockRows == 1, "Source stride is too small");
+    DEV_CHECK_ERR(Attribs.DstStride >= Attribs.Width * TexelSize || Attribs.Height == 1, "Destination stride is too small");
+
+    auto DecompressBlockRows = [&](Uint32 FirstRow, Uint32 EndRow) {
+        // Large enough for 16 RGBA16F texels
+        Uint64 Block[16];
+        for (Uint32 by = FirstRow; by < EndRow; ++by)
+        {
+            const auto* pSrcRow = static_cast<const Uint8*>(Attribs.pSrcBlocks) + size_t{by} * Attribs.SrcStride;
+            const auto  NumRows = std::min(4u, Attribs.Height - by * 4);
+            for (Uint32 bx = 0; bx < NumBlocksX; ++bx)
+            {
+                DecompressBlock(pSrcRow + size_t{bx} * BlockSize, Block);
+
+                const auto NumCols = std::min(4u, Attribs.Width - bx * 4);
+                for (Uint32 y = 0; y < NumRows; ++y)
+                {
+                    auto* pDst = static_cast<Uint8*>(Attribs.pDstPixels) + size_t{by * 4 + y} * Attribs.DstStride + size_t{bx} * 4 * TexelSize;
+                    memcpy(pDst, reinterpret_cast<const Uint8*>(Block) + y * 4 * TexelSize, NumCols * TexelSize);
+                }
+            }
+        }
+    };
+
+    ProcessBlockRows(NumBlockRows, Attribs.pThreadPool, DecompressBlockRows);
+}
+
+void CompressBC1Block(const Uint8* SrcBuffer,
+                      Uint8*       Bits)
+{
+    stb_compress_dxt_block(Bits, SrcBuffer, 0, STB_DXT_HIGHQUAL);
+}
+
+void CompressBC3Block(const Uint8* SrcBuffer,
+                      Uint8*       Bits)
+{
+    stb_compress_dxt_block(Bits, SrcBuffer, 1, STB_DXT_HIGHQUAL);
+}
+
+void CompressBC4Block(const Uint8* SrcBuffer,
+                      Uint8*       Bits,
+                      Uint32       SrcChannels)
+{
+    VERIFY_EXPR(SrcChannels >= 1);
+    Uint8 R[16];
+    for (Uint32 i = 0; i < 16; ++i)
+        R[i] = SrcBuffer[i * SrcChannels];
+    stb_compress_bc4_block(Bits, R);
+}
+
+void CompressBC5Block(const Uint8* SrcBuffer,
+                      Uint8*       Bits,
+                      Uint32       SrcChannels)
+{
+    VERIFY_EXPR(SrcChannels >= 2);
+    Uint8 RG[16 * 2];
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        RG[i * 2 + 0] = SrcBuffer[i * SrcChannels + 0];
+        RG[i * 2 + 1] = SrcBuffer[i * SrcChannels + 1];
+    }
+    stb_compress_bc5_block(Bits, RG);
+}
+
+void CompressBC2Block(const Uint8* SrcBuffer,
+                      Uint8*       Bits)
+{
+    // Explicit 4-bit alpha
+    memset(Bits, 0, 8);
+    for (Uint32 i = 0; i < 16; ++i)
+    {
+        const Uint32 Alpha = (Uint32{SrcBuffer[i * 4 + 3]} * 15 + 127) / 255;
+        Bits[i / 2] |= static_cast<Uint8>(Alpha << ((i % 2) * 4));
+    }
+    // stb_dxt always produces four-color blocks that BC2 requires
+    stb_compress_dxt_block(Bits + 8, SrcBuffer, 0, STB_DXT_HIGHQUAL);
+}
+
+namespace
+{
+
+// Writes the bits of a 128-bit block starting from the least significant bit of the first byte
+class BlockBitWriter
+{
+public:
+    explicit BlockBitWriter(Uint8* Bits) :
+        m_Bits{Bits}
+    {
+        memset(m_Bits, 0, 16);
+    }
+
+    void Write(Uint32 Value, Uint32 NumBits)
+    {
+        VERIFY_EXPR(m_Pos + NumBits <= 128);
+        for (Uint32 i = 0; i < NumBits; ++i, ++m_Pos)
+        {
+            if ((Value >> i) & 0x01)
+                m_Bits[m_Pos / 8] |= static_cast<Uint8>(1u << (m_Pos % 8));
+        }
+    }
+
+private:
+    Uint8* const m_Bits;
+    Uint32       m_Pos = 0;
+};
+
+// BC7 encoder that only uses mode 6: a single subset with 7.7.7.7 RGBA endpoints,
+// a unique P-bit per endpoint and 4-bit indices. The mode handles both opaque and
+// transparent blocks and is the most versatile single mode.
+class BC7Mode6Encoder
+{
+public:
+    explicit BC7Mode6Encoder(const Uint8* SrcBuffer)
+    {
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            for (Uint32 c = 0; c < 4; ++c)
+                m_Texels[i][c] = SrcBuffer[i * 4 + c];
+        }
+    }
+
+    void Encode(BC_COMPRESSION_QUALITY Quality, Uint8* Bits)
+    {
+        float Endpoints[2][4];
+        ComputePrincipalAxisEndpoints(Endpoints);
+        TryEndpoints(Endpoints, Quality != BC_COMPRESSION_QUALITY_FAST);
+
+        if (Quality == BC_COMPRESSION_QUALITY_HIGH)
+        {
+            // Bounding box diagonal sometimes fits better than the principal axis
+            // (e.g. for blocks with two dominant colors)
+            ComputeBoundingBoxEndpoints(Endpoints);
+            TryEndpoints(Endpoints, true);
+        }
+
+        // Refine the endpoints using the least squares fit to the selected indices
+        const Uint32 NumRefineSteps = Quality == BC_COMPRESSION_QUALITY_FAST ? 0 : (Quality == BC_COMPRESSION_QUALITY_NORMAL ? 1 : 3);
+        for (Uint32 Step = 0; Step < NumRefineSteps && m_Best.Error > 0; ++Step)
+        {
+            if (!ComputeLeastSquaresEndpoints(m_Best.Indices, Endpoints))
+                break;
+            TryEndpoints(Endpoints, true);
+        }
+
+        WriteBlock(Bits);
+    }
+
+private:
+    struct Encoding
+    {
+        int    Endpoints[2][4] = {}; // 7-bit quantized values
+        Uint32 PBits[2]        = {};
+        Uint32 Indices[16]     = {};
+        Uint32 Error           = ~0u;
+    };
+
+    static int Dequantize(int Value, Uint32 PBit)
+    {
+        return (Value << 1) | static_cast<int>(PBit);
+    }
+
+    void ComputePrincipalAxisEndpoints(float Endpoints[2][4]) const
+    {
+        float Mean[4] = {};
+        for (const auto& Texel : m_Texels)
+        {
+            for (Uint32 c = 0; c < 4; ++c)
+                Mean[c] += static_cast<float>(Texel[c]) / 16.f;
+        }
+
+        float Cov[4][4] = {};
+        for (const auto& Texel : m_Texels)
+        {
+            for (Uint32 i = 0; i < 4; ++i)
+            {
+                for (Uint32 j = 0; j < 4; ++j)
+                    Cov[i][j] += (static_cast<float>(Texel[i]) - Mean[i]) * (static_cast<float>(Texel[j]) - Mean[j]);
+            }
+        }
+
+        // Power iteration
+        float Axis[4] = {1, 1, 1, 1};
+        for (Uint32 Iter = 0; Iter < 8; ++Iter)
+        {
+            float NewAxis[4] = {};
+            float MaxComp    = 0;
+            for (Uint32 i = 0; i < 4; ++i)
+            {
+                for (Uint32 j = 0; j < 4; ++j)
+                    NewAxis[i] += Cov[i][j] * Axis[j];
+                MaxComp = std::max(MaxComp, std::abs(NewAxis[i]));
+            }
+            if (MaxComp == 0)
+                break;
+            for (Uint32 i = 0; i < 4; ++i)
+                Axis[i] = NewAxis[i] / MaxComp;
+        }
+
+        float MinT = 0;
+        float MaxT = 0;
+        for (const auto& Texel : m_Texels)
+        {
+            float t = 0;
+            for (Uint32 c = 0; c < 4; ++c)
+                t += (static_cast<float>(Texel[c]) - Mean[c]) * Axis[c];
+            MinT = std::min(MinT, t);
+            MaxT = std::max(MaxT, t);
+        }
+
+        float AxisLenSq = 0;
+        for (Uint32 c = 0; c < 4; ++c)
+            AxisLenSq += Axis[c] * Axis[c];
+        if (AxisLenSq > 0)
+        {
+            MinT /= AxisLenSq;
+            MaxT /= AxisLenSq;
+        }
+
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            Endpoints[0][c] = Mean[c] + Axis[c] * MinT;
+            Endpoints[1][c] = Mean[c] + Axis[c] * MaxT;
+        }
+    }
+
+    void ComputeBoundingBoxEndpoints(float Endpoints[2][4]) const
+    {
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            Endpoints[0][c] = 255;
+            Endpoints[1][c] = 0;
+        }
+        for (const auto& Texel : m_Texels)
+        {
+            for (Uint32 c = 0; c < 4; ++c)
+            {
+                Endpoints[0][c] = std::min(Endpoints[0][c], static_cast<float>(Texel[c]));
+                Endpoints[1][c] = std::max(Endpoints[1][c], static_cast<float>(Texel[c]));
+            }
+        }
+    }
+
+    bool ComputeLeastSquaresEndpoints(const Uint32 Indices[16], float Endpoints[2][4]) const
+    {
+        float A = 0, B = 0, C = 0;
+        float Rhs0[4] = {};
+        float Rhs1[4] = {};
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            const float t = static_cast<float>(BC7Weights4[Indices[i]]) / 64.f;
+            const float s = 1.f - t;
+
+            A += s * s;
+            B += s * t;
+            C += t * t;
+            for (Uint32 c = 0; c < 4; ++c)
+            {
+                Rhs0[c] += s * static_cast<float>(m_Texels[i][c]);
+                Rhs1[c] += t * static_cast<float>(m_Texels[i][c]);
+            }
+        }
+
+        const float Det = A * C - B * B;
+        if (std::abs(Det) < 1e-6f)
+            return false;
+
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            Endpoints[0][c] = std::min(std::max((C * Rhs0[c] - B * Rhs1[c]) / Det, 0.f), 255.f);
+            Endpoints[1][c] = std::min(std::max((A * Rhs1[c] - B * Rhs0[c]) / Det, 0.f), 255.f);
+        }
+        return true;
+    }
+
+    // Finds the best palette entry for every texel and returns the total squared error
+    Uint32 ComputeIndices(const int Endpoints[2][4], const Uint32 PBits[2], Uint32 Indices[16]) const
+    {
+        int E[2][4];
+        for (Uint32 e = 0; e < 2; ++e)
+        {
+            for (Uint32 c = 0; c < 4; ++c)
+                E[e][c] = Dequantize(Endpoints[e][c], PBits[e]);
+        }
+
+        int Palette[16][4];
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            for (Uint32 c = 0; c < 4; ++c)
+                Palette[i][c] = InterpolateBC67(E[0][c], E[1][c], BC7Weights4[i]);
+        }
+
+        Uint32 TotalError = 0;
+        for (Uint32 i = 0; i < 16; ++i)
+        {
+            Uint32 BestError = ~0u;
+            for (Uint32 p = 0; p < 16; ++p)
+            {
+                Uint32 Error = 0;
+                for (Uint32 c = 0; c < 4; ++c)
+                {
+                    const int Diff = Palette[p][c] - m_Texels[i][c];
+                    Error += static_cast<Uint32>(Diff * Diff);
+                }
+                if (Error < BestError)
+                {
+                    BestError  = Error;
+                    Indices[i] = p;
+                }
+            }
+            TotalError += BestError;
+        }
+        return TotalError;
+    }
+
+    // Quantizes the endpoints and keeps the encoding if it is better than the current one
+    void TryEndpoints(const float Endpoints[2][4], bool SearchAllPBits)
+    {
+        for (Uint32 PBitCombination = 0; PBitCombination < 4; ++PBitCombination)
+        {
+            Encoding Enc;
+            Enc.PBits[0] = PBitCombination & 0x01;
+            Enc.PBits[1] = (PBitCombination >> 1) & 0x01;
+            if (!SearchAllPBits && Enc.PBits[0] != Enc.PBits[1])
+                continue;
+
+            for (Uint32 e = 0; e < 2; ++e)
+            {
+                for (Uint32 c = 0; c < 4; ++c)
+                {
+                    const int Quantized = static_cast<int>((Endpoints[e][c] - static_cast<float>(Enc.PBits[e])) / 2.f + 0.5f);
+
+                    Enc.Endpoints[e][c] = std::min(std::max(Quantized, 0), 127);
+                }
+            }
+
+            Enc.Error = ComputeIndices(Enc.Endpoints, Enc.PBits, Enc.Indices);
+            if (Enc.Error < m_Best.Error)
+                m_Best = Enc;
+        }
+    }
+
+    void WriteBlock(Uint8* Bits)
+    {
+        auto& Enc = m_Best;
+        // The most significant bit of the anchor index is implicitly zero
+        if (Enc.Indices[0] >= 8)
+        {
+            for (Uint32 c = 0; c < 4; ++c)
+                std::swap(Enc.Endpoints[0][c], Enc.Endpoints[1][c]);
+            std::swap(Enc.PBits[0], Enc.PBits[1]);
+            for (auto& Idx : Enc.Indices)
+                Idx = 15 - Idx;
+        }
+
+        BlockBitWriter Writer{Bits};
+        Writer.Write(1u << 6, 7);
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            Writer.Write(static_cast<Uint32>(Enc.Endpoints[0][c]), 7);
+            Writer.Write(static_cast<Uint32>(Enc.Endpoints[1][c]), 7);
+        }
+        Writer.Write(Enc.PBits[0], 1);
+        Writer.Write(Enc.PBits[1], 1);
+        for (Uint32 i = 0; i < 16; ++i)
+            Writer.Write(Enc.Indices[i], i == 0 ? 3 : 4);
+    }
+
+    int      m_Texels[16][4];
+    Encoding m_Best;
+};
+
+// Compresses a single block from the tightly packed 4x4 texel buffer
+using CompressBlockFuncType = void (*)(const Uint8* pSrcTexels, Uint8* Bits, BC_COMPRESSION_QUALITY Quality);
+
+CompressBlockFuncType GetCompressBlockFunc(TEXTURE_FORMAT BCFormat)
+{
+    // clang-format off
+    switch (BCFormat)
+    {
+        case TEX_FORMAT_BC1_TYPELESS:
+        case TEX_FORMAT_BC1_UNORM:
+        case TEX_FORMAT_BC1_UNORM_SRGB:
+            return [](const Uint8* pSrc, Uint8* Bits, BC_COMPRESSION_QUALITY Quality) {
+                stb_compress_dxt_block(Bits, pSrc, 0, Quality == BC_COMPRESSION_QUALITY_FAST ? STB_DXT_NORMAL : STB_DXT_HIGHQUAL);
+            };
+
+        case TEX_FORMAT_BC2_TYPELESS:
+        case TEX_FORMAT_BC2_UNORM:
+        case TEX_FORMAT_BC2_UNORM_SRGB:
+            return [](const Uint8* pSrc, Uint8* Bits, BC_COMPRESSION_QUALITY) { CompressBC2Block(pSrc, Bits); };
+
+        case TEX_FORMAT_BC3_TYPELESS:
+        case TEX_FORMAT_BC3_UNORM:
+        case TEX_FORMAT_BC3_UNORM_SRGB:
+            return [](const Uint8* pSrc, Uint8* Bits, BC_COMPRESSION_QUALITY Quality) {
+                stb_compress_dxt_block(Bits, pSrc, 1, Quality == BC_COMPRESSION_QUALITY_FAST ? STB_DXT_NORMAL : STB_DXT_HIGHQUAL);
+            };
+
+        case TEX_FORMAT_BC4_TYPELESS:
+        case TEX_FORMAT_BC4_UNORM:
+            return [](const Uint8* pSrc, Uint8* Bits, BC_COMPRESSION_QUALITY) { CompressBC4Block(pSrc, Bits, 1); };
+
+        case TEX_FORMAT_BC5_TYPELESS:
+        case TEX_FORMAT_BC5_UNORM:
+            return [](const Uint8* pSrc, Uint8* Bits, BC_COMPRESSION_QUALITY) { CompressBC5Block(pSrc, Bits, 2); };
+
+        case TEX_FORMAT_BC7_TYPELESS:
+        case TEX_FORMAT_BC7_UNORM:
+        case TEX_FORMAT_BC7_UNORM_SRGB:
+            return [](const Uint8* pSrc, Uint8* Bits, BC_COMPRESSION_QUALITY Quality) { CompressBC7Block(pSrc, Bits, Quality); };
+
+        default:
+            return nullptr;
+    }
+    // clang-format on
+}
+
+} // namespace
+
+void CompressBC7Block(const Uint8*           SrcBuffer,
+                      Uint8*                 Bits,
+                      BC_COMPRESSION_QUALITY Quality)
+{
+    BC7Mode6Encoder Encoder{SrcBuffer};
+    Encoder.Encode(Quality, Bits);
+}
+
+void CompressBCTexture(const CompressBCTextureAttribs& Attribs)
+{
+    DEV_CHECK_ERR(Attribs.Width > 0, "Width must not be zero");
+    DEV_CHECK_ERR(Attribs.Height > 0, "Height must not be zero");
+    DEV_CHECK_ERR(Attribs.pSrcPixels != nullptr, "Source pixels pointer must not be null");
+    DEV_CHECK_ERR(Attribs.pDstBlocks != nullptr, "Destination blocks pointer must not be null");
+
+    const auto CompressBlock = GetCompressBlockFunc(Attribs.Format);
+    if (CompressBlock == nullptr)
+    {
+        UNSUPPORTED("Compression to format ", GetTextureFormatAttribs(Attribs.Format).Name, " is not supported");
+        return;
+    }
+
+    const auto& DstFmtAttribs = GetTextureFormatAttribs(Attribs.Format);
+    const auto& SrcFmtAttribs = GetTextureFormatAttribs(GetBCDecompressedFormat(Attribs.Format));
+    VERIFY_EXPR(SrcFmtAttribs.ComponentSize == 1);
+
+    const Uint32 BlockSize    = DstFmtAttribs.ComponentSize;
+    const Uint32 TexelSize    = SrcFmtAttribs.NumComponents;
+    const Uint32 NumBlocksX   = (Attribs.Width + 3) / 4;
+    const Uint32 NumBlockRows = (Attribs.Height + 3) / 4;
+    DEV_CHECK_ERR(Attribs.SrcStride >= Attribs.Width * TexelSize || Attribs.Height == 1, "Source stride is too small");
+    DEV_CHECK_ERR(Attribs.DstStride >= NumBlocksX * BlockSize || NumBlockRows == 1, "Destination stride is too small");
+
+    auto CompressBlockRows = [&](Uint32 FirstRow, Uint32 EndRow) {
+        Uint8 Texels[16 * 4];
+        for (Uint32 by = FirstRow; by < EndRow; ++by)
+        {
+            auto* pDstRow = static_cast<Uint8*>(Attribs.pDstBlocks) + size_t{by} * Attribs.DstStride;
+            for (Uint32 bx = 0; bx < NumBlocksX; ++bx)
+            {
+                // Pad partial blocks by repeating the edge pixels
+                for (Uint32 y = 0; y < 4; ++y)
+                {
+                    const auto  SrcY    = std::min(by * 4 + y, Attribs.Height - 1);
+                    const auto* pSrcRow = static_cast<const Uint8*>(Attribs.pSrcPixels) + size_t{SrcY} * Attribs.SrcStride;
+                    for (Uint32 x = 0; x < 4; ++x)
+                    {
+                        const auto SrcX = std::min(bx * 4 + x, Attribs.Width - 1);
+                        memcpy(&Texels[(y * 4 + x) * TexelSize], pSrcRow + size_t{SrcX} * TexelSize, TexelSize);
+                    }
+                }
+
+                CompressBlock(Texels, pDstRow + size_t{bx} * BlockSize, Attribs.Quality);
+            }
+        }
+    };
+
+    ProcessBlockRows(NumBlockRows, Attribs.pThreadPool, CompressBlockRows);
+}
+
 } // namespace Diligent
@@ -50,12 +50,17 @@
 #include "TextureLoaderImpl.hpp"
 #include "FileWrapper.hpp"
 #include "GraphicsAccessories.hpp"
+#include "BCTools.h"
+#include "TextureFileWriter.hpp"
+
+#include "ThreadPool.hpp"
 
 #include "dxgiformat.h"
 
 #include <memory>
 #include <algorithm>
 #include <array>
+#include <vector>
 
 #ifndef _In_
 #   define _In_
@@ -829,6 +834,224 @@ static DXGI_FORMAT GetDXGIFormat(const DDS_PIXELFORMAT& ddpf)
 
 // clang-format on
 
+//--------------------------------------------------------------------------------------
+// Legacy uncompressed D3D9 format that has no DXGI equivalent (e.g. D3DFMT_R8G8B8,
+// D3DFMT_A4R4G4B4, D3DFMT_X1R5G5B5, D3DFMT_A4L4) and is converted to RGBA8 when loaded.
+struct DDSLegacyFormat
+{
+    struct Channel
+    {
+        Uint32 Mask  = 0;
+        Uint32 Shift = 0;
+        // Expands the channel value to 8 bits
+        std::array<Uint8, 256> Expand = {};
+    };
+
+    Uint32 BytesPerPixel = 0;
+
+    // R, G, B and A channels. Luminance is replicated to R, G and B.
+    // Channels with zero mask are set to 0, except for alpha which is set to 255.
+    std::array<Channel, 4> Channels;
+
+    // True if all present channels are byte-aligned 8-bit values. In this case, ByteOffsets
+    // contains the offsets of the channel bytes in the pixel, or -1 for channels that are not present.
+    bool               IsByteAligned = false;
+    std::array<int, 4> ByteOffsets   = {};
+};
+
+static bool InitLegacyChannel(Uint32 Mask, DDSLegacyFormat::Channel& Ch)
+{
+    Ch.Mask = Mask;
+    if (Mask == 0)
+        return true;
+
+    Ch.Shift = 0;
+    while (((Mask >> Ch.Shift) & 1u) == 0)
+        ++Ch.Shift;
+
+    const auto MaxValue = Mask >> Ch.Shift;
+    // Only contiguous masks of up to 8 bits are supported
+    if (MaxValue > 0xFFu || (MaxValue & (MaxValue + 1u)) != 0)
+        return false;
+
+    for (Uint32 v = 0; v <= MaxValue; ++v)
+        Ch.Expand[v] = static_cast<Uint8>((v * 255u + MaxValue / 2u) / MaxValue);
+
+    return true;
+}
+
+static bool GetDDSLegacyFormat(const DDS_PIXELFORMAT& ddpf, DDSLegacyFormat& Fmt)
+{
+    if ((ddpf.flags & (DDS_RGB | DDS_LUMINANCE)) == 0 || (ddpf.flags & DDS_FOURCC) != 0)
+        return false;
+    if (ddpf.RGBBitCount != 8 && ddpf.RGBBitCount != 16 && ddpf.RGBBitCount != 24 && ddpf.RGBBitCount != 32)
+        return false;
+
+    const bool IsLuminance = (ddpf.flags & DDS_LUMINANCE) != 0;
+    if (ddpf.RBitMask == 0)
+        return false;
+
+    const Uint32 Masks[] = {
+        ddpf.RBitMask,
+        IsLuminance ? ddpf.RBitMask : ddpf.GBitMask,
+        IsLuminance ? ddpf.RBitMask : ddpf.BBitMask,
+        ddpf.ABitMask,
+    };
+
+    Fmt.BytesPerPixel = ddpf.RGBBitCount / 8;
+    Fmt.IsByteAligned = true;
+    for (Uint32 c = 0; c < 4; ++c)
+    {
+        if (!InitLegacyChannel(Masks[c], Fmt.Channels[c]))
+            return false;
+
+        const auto& Ch = Fmt.Channels[c];
+        if (Ch.Mask == 0)
+            Fmt.ByteOffsets[c] = -1;
+        else if ((Ch.Shift % 8) == 0 && (Ch.Mask >> Ch.Shift) == 0xFFu)
+            Fmt.ByteOffsets[c] = static_cast<int>(Ch.Shift / 8);
+        else
+            Fmt.IsByteAligned = false;
+    }
+
+    return true;
+}
+
+// Converts rows of legacy pixels to RGBA8
+static void ConvertLegacyPixels(const DDSLegacyFormat& Fmt,
+                                const Uint8*           pSrc,
+                                size_t                 SrcStride,
+                                Uint8*                 pDst,
+                                size_t                 DstStride,
+                                Uint32                 Width,
+                                Uint32                 NumRows)
+{
+    const auto  Bpp = Fmt.BytesPerPixel;
+    const auto& Off = Fmt.ByteOffsets;
+    for (Uint32 row = 0; row < NumRows; ++row, pSrc += SrcStride, pDst += DstStride)
+    {
+        const auto* pSrcPixel = pSrc;
+        auto*       pDstPixel = pDst;
+        if (Fmt.IsByteAligned)
+        {
+            // Byte shuffle, e.g. for D3DFMT_R8G8B8 and D3DFMT_X8B8G8R8
+            for (Uint32 x = 0; x < Width; ++x, pSrcPixel += Bpp, pDstPixel += 4)
+            {
+                pDstPixel[0] = Off[0] >= 0 ? pSrcPixel[Off[0]] : Uint8{0};
+                pDstPixel[1] = Off[1] >= 0 ? pSrcPixel[Off[1]] : Uint8{0};
+                pDstPixel[2] = Off[2] >= 0 ? pSrcPixel[Off[2]] : Uint8{0};
+                pDstPixel[3] = Off[3] >= 0 ? pSrcPixel[Off[3]] : Uint8{255};
+            }
+        }
+        else
+        {
+            for (Uint32 x = 0; x < Width; ++x, pSrcPixel += Bpp, pDstPixel += 4)
+            {
+                Uint32 Pixel = 0;
+                for (Uint32 b = 0; b < Bpp; ++b)
+                    Pixel |= Uint32{pSrcPixel[b]} << (b * 8u);
+
+                for (Uint32 c = 0; c < 4; ++c)
+                {
+                    const auto& Ch = Fmt.Channels[c];
+                    pDstPixel[c]   = Ch.Mask != 0 ? Ch.Expand[(Pixel & Ch.Mask) >> Ch.Shift] : (c == 3 ? Uint8{255} : Uint8{0});
+                }
+            }
+        }
+    }
+}
+
+// Number of rows converted by a single thread pool task
+static constexpr Uint32 LegacyConversionRowsPerTask = 64;
+
+// Converts all subresources of a legacy-format texture to RGBA8
+// Mips must contain dstMipCount * arraySize elements.
+static void ConvertLegacyInitData(const DDSLegacyFormat&                   Fmt,
+                                  Uint32                                   width,
+                                  Uint32                                   height,
+                                  Uint32                                   depth,
+                                  Uint32                                   srcMipCount,
+                                  Uint32                                   dstMipCount,
+                                  Uint32                                   arraySize,
+                                  size_t                                   bitSize,
+                                  const Uint8*                             bitData,
+                                  std::vector<TextureLoaderImpl::MipData>& Mips,
+                                  TextureSubResData*                       initData,
+                                  IThreadPool*                             pThreadPool)
+{
+    struct RowBand
+    {
+        const Uint8* pSrc;
+        Uint8*       pDst;
+        Uint32       Width;
+        Uint32       NumRows;
+    };
+    std::vector<RowBand> Bands;
+
+    VERIFY_EXPR(Mips.size() == size_t{dstMipCount} * arraySize);
+
+    const Uint8* pSrcBits = bitData;
+    const Uint8* pEndBits = bitData + bitSize;
+
+    size_t index = 0;
+    for (Uint32 slice = 0; slice < arraySize; ++slice)
+    {
+        for (Uint32 mip = 0; mip < srcMipCount; ++mip)
+        {
+            const auto w = std::max(width >> mip, 1u);
+            const auto h = std::max(height >> mip, 1u);
+            const auto d = std::max(depth >> mip, 1u);
+
+            const auto SrcRowBytes = size_t{w} * Fmt.BytesPerPixel;
+            const auto NumBytes    = SrcRowBytes * h * d;
+            if (NumBytes > static_cast<size_t>(pEndBits - pSrcBits))
+                LOG_ERROR_AND_THROW("Out of bounds");
+
+            if (mip < dstMipCount)
+            {
+                auto& Mip = Mips[index];
+                Mip.resize(size_t{w} * 4 * h * d);
+
+                initData[index].pData       = Mip.data();
+                initData[index].Stride      = w * 4;
+                initData[index].DepthStride = w * 4 * h;
+                ++index;
+
+                const auto TotalRows = h * d;
+                for (Uint32 FirstRow = 0; FirstRow < TotalRows; FirstRow += LegacyConversionRowsPerTask)
+                {
+                    const auto NumRows = std::min(LegacyConversionRowsPerTask, TotalRows - FirstRow);
+                    Bands.push_back({pSrcBits + FirstRow * SrcRowBytes, Mip.data() + size_t{FirstRow} * w * 4, w, NumRows});
+                }
+            }
+
+            pSrcBits += NumBytes;
+        }
+    }
+
+    auto ConvertBand = [&Fmt](const RowBand& Band) {
+        ConvertLegacyPixels(Fmt, Band.pSrc, size_t{Band.Width} * Fmt.BytesPerPixel, Band.pDst, size_t{Band.Width} * 4, Band.Width, Band.NumRows);
+    };
+
+    if (pThreadPool == nullptr || Bands.size() <= 1)
+    {
+        for (const auto& Band : Bands)
+            ConvertBand(Band);
+        return;
+    }
+
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    Tasks.reserve(Bands.size());
+    for (const auto& Band : Bands)
+    {
+        Tasks.emplace_back(EnqueueAsyncWork(pThreadPool, [&ConvertBand, &Band](Uint32) {
+            ConvertBand(Band);
+        }));
+    }
+    for (auto& pTask : Tasks)
+        pTask->WaitForCompletion();
+}
+
 //--------------------------------------------------------------------------------------
 static void FillInitData(
     _In_ Uint32      width,
@@ -928,6 +1151,8 @@ namespace Diligent
 
 void TextureLoaderImpl::LoadFromDDS(const TextureLoadInfo& TexLoadInfo, const Uint8* pData, size_t DataSize)
 {
+    DILIGENT_TRACE_ZONE("TextureLoader::LoadFromDDS");
+
     // Validate DDS file in memory
     if (DataSize < (sizeof(Uint32) + sizeof(DDS_HEADER)))
     {
@@ -974,6 +1199,8 @@ void TextureLoaderImpl::LoadFromDDS(const TextureLoadInfo& TexLoadInfo, const Ui
     Uint32      d3d11ResDim = D3D11_RESOURCE_DIMENSION_UNKNOWN;
     DXGI_FORMAT dxgiFormat  = DXGI_FORMAT_UNKNOWN;
 
+    std::unique_ptr<DDSLegacyFormat> pLegacyFmt;
+
     const auto SrcMipCount = std::max(header->mipMapCount, 1u);
     m_TexDesc.MipLevels    = SrcMipCount;
     if (TexLoadInfo.MipLevels > 0)
@@ -1037,9 +1264,15 @@ void TextureLoaderImpl::LoadFromDDS(const TextureLoadInfo& TexLoadInfo, const Ui
     else
     {
         dxgiFormat = GetDXGIFormat(header->ddspf);
-        if (dxgiFormat == DXGI_FORMAT_UNKNOWN)
+        if (dxgiFormat == DXGI_FORMAT_UNKNOWN || DXGIFormatToTexFormat(dxgiFormat) == TEX_FORMAT_UNKNOWN)
         {
-            LOG_ERROR_AND_THROW("Unknown DXGIF format");
+            // Legacy formats without a DXGI or Diligent equivalent are converted to RGBA8
+            pLegacyFmt.reset(new DDSLegacyFormat{});
+            if (!GetDDSLegacyFormat(header->ddspf, *pLegacyFmt))
+            {
+                LOG_ERROR_AND_THROW("Unknown DXGIF format");
+            }
+            dxgiFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
         }
 
         if (header->flags & DDS_HEADER_FLAGS_VOLUME)
@@ -1121,34 +1354,130 @@ void TextureLoaderImpl::LoadFromDDS(const TextureLoadInfo& TexLoadInfo, const Ui
     m_TexDesc.Format = DXGIFormatToTexFormat(dxgiFormat);
 
     m_SubResources.resize(size_t{ArraySize} * size_t{m_TexDesc.MipLevels});
-    FillInitData(m_TexDesc.Width, m_TexDesc.Height, Depth, SrcMipCount, m_TexDesc.MipLevels, ArraySize, dxgiFormat,
-                 DataSize - SubResDataOffset, pData + SubResDataOffset, m_SubResources.data());
+    if (pLegacyFmt)
+    {
+        m_Mips = CreateMips(m_SubResources.size());
+        ConvertLegacyInitData(*pLegacyFmt, m_TexDesc.Width, m_TexDesc.Height, Depth, SrcMipCount, m_TexDesc.MipLevels, ArraySize,
+                              DataSize - SubResDataOffset, pData + SubResDataOffset, m_Mips, m_SubResources.data(), TexLoadInfo.pThreadPool);
+        // The subresources reference the converted data only
+        m_pDataBlob.Release();
+    }
+    else
+    {
+        FillInitData(m_TexDesc.Width, m_TexDesc.Height, Depth, SrcMipCount, m_TexDesc.MipLevels, ArraySize, dxgiFormat,
+                     DataSize - SubResDataOffset, pData + SubResDataOffset, m_SubResources.data());
+    }
 }
 
 
-bool SaveTextureAsDDS(const char*        FilePath,
-                      const TextureDesc& Desc,
-                      const TextureData& TexData)
+bool ReadDDSHeader(const Uint8* pData, size_t DataSize, ImageProbeInfo& Info)
 {
-    const auto ArraySize = Desc.GetArraySize();
-    VERIFY(TexData.NumSubresources == Desc.MipLevels * ArraySize, "Incorrect number of subresources");
-    VERIFY_EXPR(TexData.pSubResources != nullptr);
+    if (DataSize < sizeof(Uint32) + sizeof(DDS_HEADER))
+        return false;
+
+    // The data may not be aligned, so copy the headers
+    Uint32 dwMagicNumber = 0;
+    memcpy(&dwMagicNumber, pData, sizeof(dwMagicNumber));
+    DDS_HEADER header;
+    memcpy(&header, pData + sizeof(Uint32), sizeof(header));
+    if (dwMagicNumber != DDS_MAGIC || header.size != sizeof(DDS_HEADER) || header.ddspf.size != sizeof(DDS_PIXELFORMAT))
+        return false;
+
+    Info.FileFormat = IMAGE_FILE_FORMAT_DDS;
+    Info.Width      = header.width;
+    Info.Height     = header.height;
+    Info.Depth      = 1;
+    Info.ArraySize  = 1;
+    Info.MipLevels  = std::max(header.mipMapCount, 1u);
+
+    if ((header.ddspf.flags & DDS_FOURCC) &&
+        (MAKEFOURCC('D', 'X', '1', '0') == header.ddspf.fourCC))
+    {
+        if (DataSize < sizeof(Uint32) + sizeof(DDS_HEADER) + sizeof(DDS_HEADER_DXT10))
+            return false;
+
+        DDS_HEADER_DXT10 d3d10ext;
+        memcpy(&d3d10ext, pData + sizeof(Uint32) + sizeof(DDS_HEADER), sizeof(d3d10ext));
+
+        Info.Format    = DXGIFormatToTexFormat(d3d10ext.dxgiFormat);
+        Info.ArraySize = std::max(d3d10ext.arraySize, 1u);
+        switch (d3d10ext.resourceDimension)
+        {
+            case D3D11_RESOURCE_DIMENSION_TEXTURE1D:
+                Info.Height = 1;
+                Info.Type   = Info.ArraySize > 1 ? RESOURCE_DIM_TEX_1D_ARRAY : RESOURCE_DIM_TEX_1D;
+                break;
 
+            case D3D11_RESOURCE_DIMENSION_TEXTURE2D:
+                if ((d3d10ext.miscFlag & D3D11_RESOURCE_MISC_TEXTURECUBE) != 0)
+                {
+                    Info.ArraySize *= 6;
+                    Info.Type = Info.ArraySize > 6 ? RESOURCE_DIM_TEX_CUBE_ARRAY : RESOURCE_DIM_TEX_CUBE;
+                }
+                else
+                {
+                    Info.Type = Info.ArraySize > 1 ? RESOURCE_DIM_TEX_2D_ARRAY : RESOURCE_DIM_TEX_2D;
+                }
+                break;
+
+            case D3D11_RESOURCE_DIMENSION_TEXTURE3D:
+                Info.Depth     = std::max(header.depth, 1u);
+                Info.ArraySize = 1;
+                Info.Type      = RESOURCE_DIM_TEX_3D;
+                break;
+
+            default:
+                return false;
+        }
+    }
+    else
+    {
+        Info.Format = DXGIFormatToTexFormat(GetDXGIFormat(header.ddspf));
+        DDSLegacyFormat LegacyFmt;
+        if (Info.Format == TEX_FORMAT_UNKNOWN && GetDDSLegacyFormat(header.ddspf, LegacyFmt))
+            Info.Format = TEX_FORMAT_RGBA8_UNORM;
+        if (header.flags & DDS_HEADER_FLAGS_VOLUME)
+        {
+            Info.Depth = std::max(header.depth, 1u);
+            Info.Type  = RESOURCE_DIM_TEX_3D;
+        }
+        else if (header.caps2 & DDS_CUBEMAP)
+        {
+            Info.ArraySize = 6;
+            Info.Type      = RESOURCE_DIM_TEX_CUBE;
+        }
+        else
+        {
+            Info.Type = RESOURCE_DIM_TEX_2D;
+        }
+    }
+
+    return true;
+}
+
+bool CreateDDSFileHeader(const TextureDesc& Desc, std::vector<Uint8>& Header)
+{
     Uint32 Magic = MAKEFOURCC('D', 'D', 'S', ' ');
 
-    DDS_HEADER Header{};
-    Header.size         = sizeof(Header);
-    Header.flags        = DDS_HEADER_FLAGS_TEXTURE | DDS_HEADER_FLAGS_MIPMAP;
-    Header.ddspf.size   = sizeof(Header.ddspf);
-    Header.ddspf.fourCC = MAKEFOURCC('D', 'X', '1', '0');
-    Header.ddspf.flags  = DDS_FOURCC;
-    Header.width        = Desc.Width;
-    Header.height       = Desc.Height;
-    Header.mipMapCount  = Desc.MipLevels;
+    DDS_HEADER DDSHeader{};
+    DDSHeader.size         = sizeof(DDSHeader);
+    DDSHeader.flags        = DDS_HEADER_FLAGS_TEXTURE | DDS_HEADER_FLAGS_MIPMAP;
+    DDSHeader.ddspf.size   = sizeof(DDSHeader.ddspf);
+    DDSHeader.ddspf.fourCC = MAKEFOURCC('D', 'X', '1', '0');
+    DDSHeader.ddspf.flags  = DDS_FOURCC;
+    DDSHeader.width        = Desc.Width;
+    DDSHeader.height       = Desc.Height;
+    DDSHeader.mipMapCount  = Desc.MipLevels;
 
     DDS_HEADER_DXT10 Header10{};
     Header10.dxgiFormat = TexFormatToDXGIFormat(Desc.Format);
-    Header10.arraySize  = ArraySize;
+    Header10.arraySize  = Desc.GetArraySize();
+    if (Header10.dxgiFormat == DXGI_FORMAT_UNKNOWN)
+    {
+        LOG_ERROR_MESSAGE("Texture format ", GetTextureFormatAttribs(Desc.Format).Name, " can't be stored in a DDS file");
+        return false;
+    }
+
     switch (Desc.Type)
     {
         case RESOURCE_DIM_TEX_1D:
@@ -1172,43 +1501,106 @@ bool SaveTextureAsDDS(const char*        FilePath,
             return false;
     }
 
-    FileWrapper File{FilePath, EFileAccessMode::Overwrite};
-    if (!File)
+    Header.resize(sizeof(Magic) + sizeof(DDSHeader) + sizeof(Header10));
+    memcpy(Header.data(), &Magic, sizeof(Magic));
+    memcpy(Header.data() + sizeof(Magic), &DDSHeader, sizeof(DDSHeader));
+    memcpy(Header.data() + sizeof(Magic) + sizeof(DDSHeader), &Header10, sizeof(Header10));
+    return true;
+}
+
+bool SaveTextureAsDDS(const char*        FilePath,
+                      const TextureDesc& Desc,
+                      const TextureData& TexData)
+{
+    const auto ArraySize = Desc.GetArraySize();
+    VERIFY(TexData.NumSubresources == Desc.MipLevels * ArraySize, "Incorrect number of subresources");
+    VERIFY_EXPR(TexData.pSubResources != nullptr);
+
+    try
+    {
+        TextureFileWriter Writer{FilePath, Desc};
+        for (Uint32 Slice = 0; Slice < ArraySize; ++Slice)
+        {
+            for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+                Writer.WriteSubresource(Mip, Slice, TexData.pSubResources[Slice * Desc.MipLevels + Mip]);
+        }
+        return Writer.Finish();
+    }
+    catch (...)
     {
-        LOG_ERROR_MESSAGE("Failed to open file '", FilePath, "'.");
         return false;
     }
+}
 
-    if (!File->Write(&Magic, sizeof(Magic)))
+bool SaveTextureAsCompressedDDS(const char*            FilePath,
+                                const TextureDesc&     Desc,
+                                const TextureData&     TexData,
+                                TEXTURE_FORMAT         CompressedFormat,
+                                BC_COMPRESSION_QUALITY Quality,
+                                IThreadPool*           pThreadPool)
+{
+    const auto ArraySize = Desc.GetArraySize();
+    VERIFY(TexData.NumSubresources == Desc.MipLevels * ArraySize, "Incorrect number of subresources");
+    VERIFY_EXPR(TexData.pSubResources != nullptr);
+
+    const auto UncompressedFormat = GetBCDecompressedFormat(CompressedFormat);
+    if (UncompressedFormat == TEX_FORMAT_UNKNOWN || GetTextureFormatAttribs(UncompressedFormat).ComponentSize != 1)
+    {
+        LOG_ERROR_MESSAGE("Compressing textures to ", GetTextureFormatAttribs(CompressedFormat).Name, " is not supported");
         return false;
+    }
 
-    if (!File->Write(&Header, sizeof(Header)))
+    const auto& SrcFmtAttribs = GetTextureFormatAttribs(Desc.Format);
+    const auto& ReqFmtAttribs = GetTextureFormatAttribs(UncompressedFormat);
+    if (SrcFmtAttribs.ComponentSize != ReqFmtAttribs.ComponentSize || SrcFmtAttribs.NumComponents != ReqFmtAttribs.NumComponents)
+    {
+        LOG_ERROR_MESSAGE("Texture format ", SrcFmtAttribs.Name, " is not compatible with ", ReqFmtAttribs.Name,
+                          " that is required to compress the texture to ", GetTextureFormatAttribs(CompressedFormat).Name);
         return false;
+    }
 
-    if (!File->Write(&Header10, sizeof(Header10)))
+    if (Desc.Type == RESOURCE_DIM_TEX_3D)
+    {
+        LOG_ERROR_MESSAGE("Compressing 3D textures is not supported");
         return false;
+    }
 
-    const auto& FmtAttribs = GetTextureFormatAttribs(Desc.Format);
+    auto CompressedDesc   = Desc;
+    CompressedDesc.Format = CompressedFormat;
+
+    std::vector<std::vector<Uint8>> CompressedData(TexData.NumSubresources);
+    std::vector<TextureSubResData>  CompressedSubResources(TexData.NumSubresources);
     for (Uint32 Slice = 0; Slice < ArraySize; ++Slice)
     {
         for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
         {
-            const auto& MipProps = GetMipLevelProperties(Desc, Mip);
-            const auto& SubRes   = TexData.pSubResources[Slice * Desc.MipLevels + Mip];
-            VERIFY_EXPR(SubRes.pData != nullptr);
-            const auto* pData  = reinterpret_cast<const Uint8*>(SubRes.pData);
-            const auto  Stride = SubRes.Stride;
-            VERIFY(Stride >= MipProps.RowSize, "Row stride is too small");
-            for (Uint32 row = 0; row < MipProps.StorageHeight / FmtAttribs.BlockHeight; ++row)
-            {
-                const auto* pRowData = pData + Stride * row;
-                if (!File->Write(pRowData, StaticCast<size_t>(MipProps.RowSize)))
-                    return false;
-            }
+            const auto  Subres      = Slice * Desc.MipLevels + Mip;
+            const auto& SrcSubRes   = TexData.pSubResources[Subres];
+            const auto  SrcMipProps = GetMipLevelProperties(Desc, Mip);
+            const auto  DstMipProps = GetMipLevelProperties(CompressedDesc, Mip);
+            VERIFY_EXPR(SrcSubRes.pData != nullptr);
+
+            CompressedData[Subres].resize(StaticCast<size_t>(DstMipProps.MipSize));
+
+            CompressBCTextureAttribs Attribs;
+            Attribs.Format      = CompressedFormat;
+            Attribs.Width       = SrcMipProps.LogicalWidth;
+            Attribs.Height      = SrcMipProps.LogicalHeight;
+            Attribs.pSrcPixels  = SrcSubRes.pData;
+            Attribs.SrcStride   = StaticCast<Uint32>(SrcSubRes.Stride);
+            Attribs.pDstBlocks  = CompressedData[Subres].data();
+            Attribs.DstStride   = StaticCast<Uint32>(DstMipProps.RowSize);
+            Attribs.Quality     = Quality;
+            Attribs.pThreadPool = pThreadPool;
+            CompressBCTexture(Attribs);
+
+            CompressedSubResources[Subres].pData  = CompressedData[Subres].data();
+            CompressedSubResources[Subres].Stride = DstMipProps.RowSize;
         }
     }
 
-    return true;
+    TextureData CompressedTexData{CompressedSubResources.data(), TexData.NumSubresources};
+    return SaveTextureAsDDS(FilePath, CompressedDesc, CompressedTexData);
 }
 
 } // namespace Diligent
@@ -1221,4 +1613,14 @@ extern "C"
     {
         Diligent::SaveTextureAsDDS(FilePath, Desc, TexData);
     }
+
+    bool Diligent_SaveTextureAsCompressedDDS(const char*                      FilePath,
+                                             const Diligent::TextureDesc&     Desc,
+                                             const Diligent::TextureData&     TexData,
+                                             Diligent::TEXTURE_FORMAT         CompressedFormat,
+                                             Diligent::BC_COMPRESSION_QUALITY Quality,
+                                             Diligent::IThreadPool*           pThreadPool)
+    {
+        return Diligent::SaveTextureAsCompressedDDS(FilePath, Desc, TexData, CompressedFormat, Quality, pThreadPool);
+    }
 }
@@ -0,0 +1,377 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include "HDRLoader.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DataBlob.h"
+#include "Errors.hpp"
+#include "ThreadPool.hpp"
+#include "HalfFloat.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+struct HDRHeaderInfo
+{
+    Uint32 Width  = 0;
+    Uint32 Height = 0;
+    // True if the first scanline is the bottom row of the image (+Y resolution string)
+    bool BottomUp = false;
+    // Offset of the first scanline from the start of the file
+    size_t PixelDataOffset = 0;
+};
+
+// Reads a line terminated by '\n' starting at Pos. Returns false if there is no terminator
+// within the data.
+bool ReadHeaderLine(const char* pData, size_t DataSize, size_t& Pos, std::string& Line)
+{
+    const auto* pLineStart = pData + Pos;
+    const auto* pLineEnd   = static_cast<const char*>(memchr(pLineStart, '\n', DataSize - Pos));
+    if (pLineEnd == nullptr)
+        return false;
+
+    Line.assign(pLineStart, pLineEnd);
+    Pos = static_cast<size_t>(pLineEnd - pData) + 1;
+    return true;
+}
+
+// https://radsite.lbl.gov/radiance/refer/filefmts.pdf
+bool ParseHDRHeader(const void* pHDRData, size_t DataSize, HDRHeaderInfo& Info)
+{
+    const auto* pData = static_cast<const char*>(pHDRData);
+
+    size_t      Pos = 0;
+    std::string Line;
+    if (!ReadHeaderLine(pData, DataSize, Pos, Line) || (Line.compare(0, 10, "#?RADIANCE") != 0 && Line.compare(0, 6, "#?RGBE") != 0))
+    {
+        LOG_ERROR_MESSAGE("The data is not a Radiance HDR file: the file must start with '#?RADIANCE' or '#?RGBE'.");
+        return false;
+    }
+
+    // The header is a list of variable assignments terminated by an empty line
+    while (true)
+    {
+        if (!ReadHeaderLine(pData, DataSize, Pos, Line))
+        {
+            LOG_ERROR_MESSAGE("Unexpected end of the Radiance HDR header.");
+            return false;
+        }
+        if (Line.empty())
+            break;
+
+        if (Line.compare(0, 7, "FORMAT=") == 0 && Line.compare(7, std::string::npos, "32-bit_rle_rgbe") != 0)
+        {
+            LOG_ERROR_MESSAGE("Radiance HDR pixel format '", Line.substr(7), "' is not supported. Only 32-bit_rle_rgbe format is supported.");
+            return false;
+        }
+    }
+
+    // The resolution string, e.g. "-Y 512 +X 1024"
+    if (!ReadHeaderLine(pData, DataSize, Pos, Line))
+    {
+        LOG_ERROR_MESSAGE("Radiance HDR resolution string is missing.");
+        return false;
+    }
+
+    char     YSign     = 0;
+    unsigned Height    = 0;
+    unsigned Width     = 0;
+    int      CharsRead = 0;
+    if (sscanf(Line.c_str(), "%cY %u +X %u%n", &YSign, &Height, &Width, &CharsRead) != 3 ||
+        (YSign != '-' && YSign != '+') || static_cast<size_t>(CharsRead) != Line.length())
+    {
+        LOG_ERROR_MESSAGE("Radiance HDR resolution string '", Line, "' is invalid or not supported. Only '-Y H +X W' and '+Y H +X W' orientations are supported.");
+        return false;
+    }
+
+    if (Width == 0 || Height == 0)
+    {
+        LOG_ERROR_MESSAGE("Radiance HDR image is empty (", Width, "x", Height, ").");
+        return false;
+    }
+
+    // Every pixel takes at least one byte in an RLE scanline, which bounds the dimensions for valid files
+    if (size_t{Width} * size_t{Height} > DataSize * 128)
+    {
+        LOG_ERROR_MESSAGE("Radiance HDR image dimensions (", Width, "x", Height, ") are inconsistent with the data size (", DataSize, ").");
+        return false;
+    }
+
+    Info.Width           = Width;
+    Info.Height          = Height;
+    Info.BottomUp        = YSign == '+';
+    Info.PixelDataOffset = Pos;
+    return true;
+}
+
+// Decodes a single scanline into Width RGBE pixels. Returns the pointer to the next scanline,
+// or nullptr if the data is corrupted.
+const Uint8* DecodeScanline(const Uint8* pSrc, const Uint8* pSrcEnd, Uint8* pDst, Uint32 Width)
+{
+    const auto IsNewRLE =
+        Width >= 8 && Width <= 0x7FFF &&
+        pSrcEnd - pSrc >= 4 && pSrc[0] == 2 && pSrc[1] == 2 && (pSrc[2] & 0x80) == 0;
+
+    if (IsNewRLE)
+    {
+        // Every component is run-length encoded separately
+        if (((Uint32{pSrc[2]} << 8) | Uint32{pSrc[3]}) != Width)
+            return nullptr;
+        pSrc += 4;
+
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            Uint32 x = 0;
+            while (x < Width)
+            {
+                if (pSrc >= pSrcEnd)
+                    return nullptr;
+
+                Uint32 Count = *pSrc++;
+                if (Count > 128)
+                {
+                    // A run of identical values
+                    Count -= 128;
+                    if (Count > Width - x || pSrc >= pSrcEnd)
+                        return nullptr;
+
+                    const auto Value = *pSrc++;
+                    for (Uint32 i = 0; i < Count; ++i)
+                        pDst[size_t{x + i} * 4 + c] = Value;
+                }
+                else
+                {
+                    // A literal sequence of distinct values
+                    if (Count == 0 || Count > Width - x || Count > static_cast<size_t>(pSrcEnd - pSrc))
+                        return nullptr;
+
+                    for (Uint32 i = 0; i < Count; ++i)
+                        pDst[size_t{x + i} * 4 + c] = pSrc[i];
+                    pSrc += Count;
+                }
+                x += Count;
+            }
+        }
+        return pSrc;
+    }
+
+    // Flat scanline, possibly with old-style (1, 1, 1, count) run markers that repeat the previous pixel
+    Uint32 x     = 0;
+    Uint32 Shift = 0;
+    while (x < Width)
+    {
+        if (pSrcEnd - pSrc < 4)
+            return nullptr;
+
+        if (pSrc[0] == 1 && pSrc[1] == 1 && pSrc[2] == 1)
+        {
+            if (x == 0 || Shift > 24)
+                return nullptr;
+
+            const auto Count = Uint32{pSrc[3]} << Shift;
+            if (Count > Width - x)
+                return nullptr;
+
+            for (Uint32 i = 0; i < Count; ++i, ++x)
+                memcpy(pDst + size_t{x} * 4, pDst + size_t{x - 1} * 4, 4);
+            Shift += 8;
+        }
+        else
+        {
+            memcpy(pDst + size_t{x} * 4, pSrc, 4);
+            ++x;
+            Shift = 0;
+        }
+        pSrc += 4;
+    }
+    return pSrc;
+}
+
+// Conversion from the shared RGBE exponent to the scale of the 8-bit mantissas
+struct RGBEExponentScale
+{
+    std::array<float, 256> Scale;
+
+    RGBEExponentScale()
+    {
+        // Zero exponent encodes black
+        Scale[0] = 0;
+        for (int e = 1; e < 256; ++e)
+            Scale[e] = std::ldexp(1.f, e - (128 + 8));
+    }
+
+    static const RGBEExponentScale& Get()
+    {
+        static const RGBEExponentScale Instance;
+        return Instance;
+    }
+};
+
+// Converts a row of RGBE pixels to four-component half floats
+void ConvertRGBERow(const Uint8* pRGBE, Uint16* pDst, Uint32 Width)
+{
+    // The largest finite half. Brighter values are clamped to prevent infinities in filtering.
+    constexpr float  MaxHalf = 65504.f;
+    constexpr Uint16 HalfOne = 0x3C00u;
+
+    const auto& Scale = RGBEExponentScale::Get().Scale;
+    for (Uint32 x = 0; x < Width; ++x, pRGBE += 4, pDst += 4)
+    {
+        const auto ExpScale = Scale[pRGBE[3]];
+        pDst[0]             = FloatToHalf(std::min(static_cast<float>(pRGBE[0]) * ExpScale, MaxHalf));
+        pDst[1]             = FloatToHalf(std::min(static_cast<float>(pRGBE[1]) * ExpScale, MaxHalf));
+        pDst[2]             = FloatToHalf(std::min(static_cast<float>(pRGBE[2]) * ExpScale, MaxHalf));
+        pDst[3]             = HalfOne;
+    }
+}
+
+void InitImageDesc(const HDRHeaderInfo& Info, ImageDesc& Desc)
+{
+    Desc.Width         = Info.Width;
+    Desc.Height        = Info.Height;
+    Desc.ComponentType = VT_FLOAT16;
+    Desc.NumComponents = 4;
+    Desc.RowStride     = Info.Width * 4 * sizeof(Uint16);
+}
+
+// Number of rows converted by a single thread pool task
+constexpr Uint32 HDRRowsPerTask = 64;
+
+} // namespace
+
+bool ReadHDRHeader(const void* pHDRData,
+                   size_t      DataSize,
+                   ImageDesc*  pDstImgDesc)
+{
+    VERIFY_EXPR(pHDRData != nullptr && pDstImgDesc != nullptr);
+
+    HDRHeaderInfo Info;
+    if (!ParseHDRHeader(pHDRData, DataSize, Info))
+        return false;
+
+    InitImageDesc(Info, *pDstImgDesc);
+    return true;
+}
+
+bool LoadHDR(IDataBlob*   pHDRData,
+             IDataBlob*   pDstPixels,
+             ImageDesc*   pDstImgDesc,
+             IThreadPool* pThreadPool)
+{
+    VERIFY_EXPR(pHDRData != nullptr && pDstPixels != nullptr && pDstImgDesc != nullptr);
+    const auto* pDataStart = static_cast<const Uint8*>(pHDRData->GetConstDataPtr());
+    const auto  Size       = pHDRData->GetSize();
+
+    HDRHeaderInfo Info;
+    if (!ParseHDRHeader(pDataStart, Size, Info))
+        return false;
+
+    InitImageDesc(Info, *pDstImgDesc);
+
+    const auto Width     = Info.Width;
+    const auto Height    = Info.Height;
+    const auto RowStride = size_t{pDstImgDesc->RowStride};
+
+    pDstPixels->Resize(RowStride * Height);
+    auto* pDstPtr = static_cast<Uint8*>(pDstPixels->GetDataPtr());
+
+    auto GetDstRow = [&](Uint32 Row) {
+        const auto DstRow = Info.BottomUp ? Height - 1 - Row : Row;
+        return reinterpret_cast<Uint16*>(pDstPtr + DstRow * RowStride);
+    };
+
+    // Scanlines have variable size and must be decoded sequentially. Without a thread pool, every
+    // scanline is converted right away; otherwise the whole image is decoded first, and bands of
+    // rows are then converted in parallel.
+    const auto         ParallelConversion = pThreadPool != nullptr && Height > HDRRowsPerTask;
+    std::vector<Uint8> RGBEData(size_t{Width} * 4 * (ParallelConversion ? Height : 1));
+
+    const auto* pSrc    = pDataStart + Info.PixelDataOffset;
+    const auto* pSrcEnd = pDataStart + Size;
+    for (Uint32 y = 0; y < Height; ++y)
+    {
+        auto* pRGBERow = RGBEData.data() + (ParallelConversion ? size_t{y} * Width * 4 : 0);
+
+        pSrc = DecodeScanline(pSrc, pSrcEnd, pRGBERow, Width);
+        if (pSrc == nullptr)
+        {
+            LOG_ERROR_MESSAGE("Radiance HDR scanline ", y, " is corrupted or truncated.");
+            return false;
+        }
+
+        if (!ParallelConversion)
+            ConvertRGBERow(pRGBERow, GetDstRow(y), Width);
+    }
+
+    if (ParallelConversion)
+    {
+        std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+        for (Uint32 FirstRow = 0; FirstRow < Height; FirstRow += HDRRowsPerTask)
+        {
+            const auto EndRow = std::min(FirstRow + HDRRowsPerTask, Height);
+            Tasks.emplace_back(EnqueueAsyncWork(pThreadPool, [&, FirstRow, EndRow](Uint32) {
+                for (Uint32 y = FirstRow; y < EndRow; ++y)
+                    ConvertRGBERow(RGBEData.data() + size_t{y} * Width * 4, GetDstRow(y), Width);
+            }));
+        }
+        for (auto& pTask : Tasks)
+            pTask->WaitForCompletion();
+    }
+
+    return true;
+}
+
+} // namespace Diligent
+
+extern "C"
+{
+    bool Diligent_LoadHDR(Diligent::IDataBlob*   pHDRData,
+                          Diligent::IDataBlob*   pDstPixels,
+                          Diligent::ImageDesc*   pDstImgDesc,
+                          Diligent::IThreadPool* pThreadPool)
+    {
+        return Diligent::LoadHDR(pHDRData, pDstPixels, pDstImgDesc, pThreadPool);
+    }
+
+    bool Diligent_ReadHDRHeader(const void*          pHDRData,
+                                size_t               DataSize,
+                                Diligent::ImageDesc* pDstImgDesc)
+    {
+        return Diligent::ReadHDRHeader(pHDRData, DataSize, pDstImgDesc);
+    }
+}
@@ -29,15 +29,19 @@
 
 #include <algorithm>
 #include <array>
+#include <initializer_list>
+#include <utility>
 
 #include "Image.h"
 #include "Errors.hpp"
 
 #include "tiffio.h"
 #include "png.h"
+#include "zlib.h"
 #include "PNGCodec.h"
 #include "JPEGCodec.h"
 #include "SGILoader.h"
+#include "HDRLoader.h"
 
 #include "DataBlobImpl.hpp"
 #include "DebugUtilities.hpp"
@@ -46,6 +50,8 @@
 #include "GraphicsAccessories.hpp"
 #include "BasicFileStream.hpp"
 #include "StringTools.hpp"
+#include "ThreadPool.hpp"
+#include "TextureLoaderImpl.hpp"
 
 namespace Diligent
 {
@@ -60,10 +66,23 @@ public:
     {
     }
 
+    // Read-only wrapper that does not own the data
+    TIFFClientOpenWrapper(const void* pData, size_t Size) noexcept :
+        m_Offset{0},
+        m_Size{Size},
+        m_pConstData{static_cast<const Uint8*>(pData)}
+    {
+    }
+
     static tmsize_t TIFFReadProc(thandle_t pClientData, void* pBuffer, tmsize_t Size)
     {
-        auto* pThis   = reinterpret_cast<TIFFClientOpenWrapper*>(pClientData);
-        auto* pSrcPtr = reinterpret_cast<Uint8*>(pThis->m_pData->GetDataPtr()) + pThis->m_Offset;
+        auto* pThis = reinterpret_cast<TIFFClientOpenWrapper*>(pClientData);
+        if (pThis->m_Offset >= pThis->m_Size)
+            return 0;
+        // Do not read past the end of the data
+        Size          = std::min(Size, static_cast<tmsize_t>(pThis->m_Size - pThis->m_Offset));
+        auto* pSrcData = pThis->m_pData ? reinterpret_cast<const Uint8*>(pThis->m_pData->GetConstDataPtr()) : pThis->m_pConstData;
+        auto* pSrcPtr  = pSrcData + pThis->m_Offset;
         memcpy(pBuffer, pSrcPtr, Size);
         pThis->m_Offset += Size;
         return Size;
@@ -72,6 +91,7 @@ public:
     static tmsize_t TIFFWriteProc(thandle_t pClientData, void* pBuffer, tmsize_t Size)
     {
         auto* pThis = reinterpret_cast<TIFFClientOpenWrapper*>(pClientData);
+        VERIFY(pThis->m_pData, "Writing to read-only data");
         if (pThis->m_Offset + Size > pThis->m_Size)
         {
             pThis->m_Size = pThis->m_Offset + Size;
@@ -127,20 +147,106 @@ private:
     size_t                   m_Offset;
     size_t                   m_Size;
     RefCntAutoPtr<IDataBlob> m_pData;
+    const Uint8*             m_pConstData = nullptr;
 };
 
+static TIFF* OpenTiffFromMemory(TIFFClientOpenWrapper& Wrapper)
+{
+    return TIFFClientOpen("", "rm", &Wrapper,
+                          TIFFClientOpenWrapper::TIFFReadProc,
+                          TIFFClientOpenWrapper::TIFFWriteProc,
+                          TIFFClientOpenWrapper::TIFFSeekProc,
+                          TIFFClientOpenWrapper::TIFFCloseProc,
+                          TIFFClientOpenWrapper::TIFFSizeProc,
+                          TIFFClientOpenWrapper::TIFFMapFileProc,
+                          TIFFClientOpenWrapper::TIFFUnmapFileProc);
+}
+
+// Decodes strips or tiles [FirstChunk, EndChunk) of a TIFF image with contiguous
+// planar configuration into the destination image. Returns false if any chunk failed to decode.
+static bool DecodeTiffChunks(TIFF* TiffFile, Uint32 FirstChunk, Uint32 EndChunk, const ImageDesc& Desc, Uint8* pDstData)
+{
+    const auto ScanlineSize = static_cast<size_t>(TIFFScanlineSize(TiffFile));
+    const auto TexelSize    = ScanlineSize / Desc.Width;
+
+    bool               Result = true;
+    std::vector<Uint8> TmpBuffer;
+    if (TIFFIsTiled(TiffFile))
+    {
+        Uint32 TileWidth  = 0;
+        Uint32 TileHeight = 0;
+        TIFFGetField(TiffFile, TIFFTAG_TILEWIDTH, &TileWidth);
+        TIFFGetField(TiffFile, TIFFTAG_TILELENGTH, &TileHeight);
+
+        if (TileWidth == 0 || TileHeight == 0)
+            return false;
+
+        const auto TilesAcross = (Desc.Width + TileWidth - 1) / TileWidth;
+        const auto TileRowSize = static_cast<size_t>(TIFFTileRowSize(TiffFile));
+        TmpBuffer.resize(static_cast<size_t>(TIFFTileSize(TiffFile)));
+        for (Uint32 Tile = FirstChunk; Tile < EndChunk; ++Tile)
+        {
+            const auto x = (Tile % TilesAcross) * TileWidth;
+            const auto y = (Tile / TilesAcross) * TileHeight;
+            if (y >= Desc.Height)
+                continue;
+
+            if (TIFFReadEncodedTile(TiffFile, Tile, TmpBuffer.data(), static_cast<tmsize_t>(TmpBuffer.size())) < 0)
+            {
+                Result = false;
+                continue;
+            }
+
+            const auto NumRows  = std::min(TileHeight, Desc.Height - y);
+            const auto CopySize = std::min(TileWidth, Desc.Width - x) * TexelSize;
+            for (Uint32 row = 0; row < NumRows; ++row)
+                memcpy(pDstData + size_t{y + row} * Desc.RowStride + x * TexelSize, TmpBuffer.data() + row * TileRowSize, CopySize);
+        }
+    }
+    else
+    {
+        Uint32 RowsPerStrip = 0;
+        TIFFGetFieldDefaulted(TiffFile, TIFFTAG_ROWSPERSTRIP, &RowsPerStrip);
+        RowsPerStrip = std::min(std::max(RowsPerStrip, 1u), Desc.Height);
+
+        // When rows are tightly packed, strips are decoded directly into the image
+        const bool DecodeInPlace = ScanlineSize == Desc.RowStride;
+        if (!DecodeInPlace)
+            TmpBuffer.resize(ScanlineSize * RowsPerStrip);
+
+        for (Uint32 Strip = FirstChunk; Strip < EndChunk; ++Strip)
+        {
+            const auto FirstRow = Strip * RowsPerStrip;
+            if (FirstRow >= Desc.Height)
+                continue;
+
+            const auto NumRows   = std::min(RowsPerStrip, Desc.Height - FirstRow);
+            auto*      pDstStrip = pDstData + size_t{FirstRow} * Desc.RowStride;
+            auto*      pBuffer   = DecodeInPlace ? pDstStrip : TmpBuffer.data();
+            if (TIFFReadEncodedStrip(TiffFile, Strip, pBuffer, static_cast<tmsize_t>(ScanlineSize * NumRows)) < 0)
+            {
+                Result = false;
+                continue;
+            }
+
+            if (!DecodeInPlace)
+            {
+                for (Uint32 row = 0; row < NumRows; ++row)
+                    memcpy(pDstStrip + size_t{row} * Desc.RowStride, TmpBuffer.data() + row * ScanlineSize, ScanlineSize);
+            }
+        }
+    }
+
+    return Result;
+}
+
 void Image::LoadTiffFile(IDataBlob* pFileData, const ImageLoadInfo& LoadInfo)
 {
     TIFFClientOpenWrapper TiffClientOpenWrpr(pFileData);
 
-    auto TiffFile = TIFFClientOpen("", "rm", &TiffClientOpenWrpr,
-                                   TIFFClientOpenWrapper::TIFFReadProc,
-                                   TIFFClientOpenWrapper::TIFFWriteProc,
-                                   TIFFClientOpenWrapper::TIFFSeekProc,
-                                   TIFFClientOpenWrapper::TIFFCloseProc,
-                                   TIFFClientOpenWrapper::TIFFSizeProc,
-                                   TIFFClientOpenWrapper::TIFFMapFileProc,
-                                   TIFFClientOpenWrapper::TIFFUnmapFileProc);
+    auto TiffFile = OpenTiffFromMemory(TiffClientOpenWrpr);
+    if (TiffFile == nullptr)
+        LOG_ERROR_AND_THROW("Failed to open tiff file");
 
     TIFFGetField(TiffFile, TIFFTAG_IMAGEWIDTH, &m_Desc.Width);
     TIFFGetField(TiffFile, TIFFTAG_IMAGELENGTH, &m_Desc.Height);
@@ -211,14 +317,71 @@ void Image::LoadTiffFile(IDataBlob* pFileData, const ImageLoadInfo& LoadInfo)
     m_Desc.RowStride  = AlignUp(static_cast<Uint32>(ScanlineSize), 4u);
     m_pData->Resize(size_t{m_Desc.Height} * size_t{m_Desc.RowStride});
     auto* pDataPtr = reinterpret_cast<Uint8*>(m_pData->GetDataPtr());
-    for (Uint32 row = 0; row < m_Desc.Height; row++, pDataPtr += m_Desc.RowStride)
+
+    Uint16 PlanarConfig = PLANARCONFIG_CONTIG;
+    TIFFGetFieldDefaulted(TiffFile, TIFFTAG_PLANARCONFIG, &PlanarConfig);
+    if (PlanarConfig != PLANARCONFIG_CONTIG || m_Desc.Width == 0)
+    {
+        // Fall back to reading scanlines one by one
+        for (Uint32 row = 0; row < m_Desc.Height; row++, pDataPtr += m_Desc.RowStride)
+        {
+            TIFFReadScanline(TiffFile, pDataPtr, row);
+        }
+        TIFFClose(TiffFile);
+        return;
+    }
+
+    const auto NumChunks = static_cast<Uint32>(TIFFIsTiled(TiffFile) ? TIFFNumberOfTiles(TiffFile) : TIFFNumberOfStrips(TiffFile));
+    // Every task opens its own handle, so do not split the image into too many tasks
+    constexpr Uint32 MaxTasks = 32;
+    const auto       NumTasks = LoadInfo.pThreadPool != nullptr ? std::min(NumChunks, MaxTasks) : 1u;
+
+    bool Result = true;
+    if (NumTasks <= 1)
+    {
+        Result = DecodeTiffChunks(TiffFile, 0, NumChunks, m_Desc, pDataPtr);
+    }
+    else
     {
-        TIFFReadScanline(TiffFile, pDataPtr, row);
+        std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+        std::vector<Uint8>                     TaskResults(NumTasks, 1);
+        for (Uint32 Task = 0; Task < NumTasks; ++Task)
+        {
+            const auto FirstChunk = static_cast<Uint32>(Uint64{NumChunks} * Task / NumTasks);
+            const auto EndChunk   = static_cast<Uint32>(Uint64{NumChunks} * (Task + 1) / NumTasks);
+            Tasks.emplace_back(EnqueueAsyncWork(LoadInfo.pThreadPool, [pFileData, FirstChunk, EndChunk, Task, &TaskResults, this, pDataPtr](Uint32) {
+                // libtiff handles are not thread-safe, so every task decodes through its own handle
+                TIFFClientOpenWrapper Wrapper{pFileData};
+
+                auto TaskTiffFile = OpenTiffFromMemory(Wrapper);
+                if (TaskTiffFile == nullptr)
+                {
+                    TaskResults[Task] = 0;
+                    return;
+                }
+                TaskResults[Task] = DecodeTiffChunks(TaskTiffFile, FirstChunk, EndChunk, m_Desc, pDataPtr) ? 1 : 0;
+                TIFFClose(TaskTiffFile);
+            }));
+        }
+        for (auto& pTask : Tasks)
+            pTask->WaitForCompletion();
+
+        Result = std::find(TaskResults.begin(), TaskResults.end(), Uint8{0}) == TaskResults.end();
     }
     TIFFClose(TiffFile);
+
+    if (!Result)
+        LOG_ERROR_MESSAGE("Failed to decode some of the strips or tiles of the tiff image");
 }
 
 
+Uint32 Image::AllocateImageData(Uint32 NumComponents)
+{
+    const auto Stride = AlignUp(m_Desc.Width * NumComponents * GetValueSize(m_Desc.ComponentType), 4u);
+    m_pData->Resize(size_t{Stride} * size_t{m_Desc.Height});
+    return Stride;
+}
+
 Image::Image(IReferenceCounters*  pRefCounters,
              IDataBlob*           pFileData,
              const ImageLoadInfo& LoadInfo) :
@@ -231,22 +394,55 @@ Image::Image(IReferenceCounters*  pRefCounters,
     }
     else if (LoadInfo.Format == IMAGE_FILE_FORMAT_PNG)
     {
-        auto Res = DecodePng(pFileData, m_pData.RawPtr(), &m_Desc);
+        auto Res = DECODE_PNG_RESULT_OK;
+        if (LoadInfo.NumComponents == 0)
+        {
+            Res = DecodePng(pFileData, m_pData.RawPtr(), &m_Desc);
+        }
+        else
+        {
+            // Read the header first to allocate the data, then decode directly into it
+            Res = DecodePngIntoMemory(pFileData, nullptr, 0, 0, &m_Desc);
+            if (Res == DECODE_PNG_RESULT_OK)
+            {
+                const auto Stride = AllocateImageData(LoadInfo.NumComponents);
+                Res               = DecodePngIntoMemory(pFileData, m_pData->GetDataPtr(), Stride, LoadInfo.NumComponents, &m_Desc);
+            }
+        }
         if (Res != DECODE_PNG_RESULT_OK)
             LOG_ERROR_MESSAGE("Failed to decode png image");
     }
     else if (LoadInfo.Format == IMAGE_FILE_FORMAT_JPEG)
     {
-        auto Res = DecodeJpeg(pFileData, m_pData.RawPtr(), &m_Desc);
+        auto Res = DECODE_JPEG_RESULT_OK;
+        if (LoadInfo.NumComponents == 0)
+        {
+            Res = DecodeJpeg(pFileData, m_pData.RawPtr(), &m_Desc, LoadInfo.ScaleDenom);
+        }
+        else
+        {
+            Res = DecodeJpegIntoMemory(pFileData, nullptr, 0, 0, &m_Desc, LoadInfo.ScaleDenom);
+            if (Res == DECODE_JPEG_RESULT_OK)
+            {
+                const auto Stride = AllocateImageData(LoadInfo.NumComponents);
+                Res               = DecodeJpegIntoMemory(pFileData, m_pData->GetDataPtr(), Stride, LoadInfo.NumComponents, &m_Desc, LoadInfo.ScaleDenom);
+            }
+        }
         if (Res != DECODE_JPEG_RESULT_OK)
             LOG_ERROR_MESSAGE("Failed to decode jpeg image");
     }
     else if (LoadInfo.Format == IMAGE_FILE_FORMAT_SGI)
     {
-        auto Res = LoadSGI(pFileData, m_pData.RawPtr(), &m_Desc);
+        auto Res = LoadSGI(pFileData, m_pData.RawPtr(), &m_Desc, LoadInfo.pThreadPool);
         if (!Res)
             LOG_ERROR_MESSAGE("Failed to load SGI image");
     }
+    else if (LoadInfo.Format == IMAGE_FILE_FORMAT_HDR)
+    {
+        auto Res = LoadHDR(pFileData, m_pData.RawPtr(), &m_Desc, LoadInfo.pThreadPool);
+        if (!Res)
+            LOG_ERROR_MESSAGE("Failed to load HDR image");
+    }
     else if (LoadInfo.Format == IMAGE_FILE_FORMAT_DDS)
     {
         LOG_ERROR_MESSAGE("An image can't be created from DDS file. Use CreateTextureFromFile() or CreateTextureFromDDS() functions.");
@@ -265,6 +461,8 @@ void Image::CreateFromDataBlob(IDataBlob*           pFileData,
                                const ImageLoadInfo& LoadInfo,
                                Image**              ppImage)
 {
+    DILIGENT_TRACE_ZONE("Image::Decode");
+
     *ppImage = MakeNewRCObj<Image>()(pFileData, LoadInfo);
     (*ppImage)->AddRef();
 }
@@ -339,6 +537,265 @@ std::vector<Uint8> Image::ConvertImageData(Uint32         Width,
 }
 
 
+// Filters a PNG row. pPrevRow is null for the first row of the image.
+static void FilterPngRow(Uint8 FilterType, const Uint8* pRow, const Uint8* pPrevRow, size_t RowSize, size_t Bpp, Uint8* pDst)
+{
+    *(pDst++) = FilterType;
+    for (size_t i = 0; i < RowSize; ++i)
+    {
+        const int a = i >= Bpp ? pRow[i - Bpp] : 0;
+        const int b = pPrevRow != nullptr ? pPrevRow[i] : 0;
+        const int c = (i >= Bpp && pPrevRow != nullptr) ? pPrevRow[i - Bpp] : 0;
+
+        int Predictor = 0;
+        switch (FilterType)
+        {
+            case 0: Predictor = 0; break;
+            case 1: Predictor = a; break;
+            case 2: Predictor = b; break;
+            case 3: Predictor = (a + b) / 2; break;
+            case 4:
+            {
+                const int p  = a + b - c;
+                const int pa = std::abs(p - a);
+                const int pb = std::abs(p - b);
+                const int pc = std::abs(p - c);
+                Predictor    = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+                break;
+            }
+            default:
+                UNEXPECTED("Unexpected filter type");
+        }
+        pDst[i] = static_cast<Uint8>(pRow[i] - Predictor);
+    }
+}
+
+// Filters rows [FirstRow, EndRow) of the image. Every filtered row is prefixed with the filter type byte.
+static void FilterPngRows(const Uint8*       pPixels,
+                          size_t             Stride,
+                          size_t             RowSize,
+                          size_t             Bpp,
+                          Uint32             FirstRow,
+                          Uint32             EndRow,
+                          PNG_ENCODE_FILTER  Filter,
+                          std::vector<Uint8>& Filtered)
+{
+    Filtered.resize((RowSize + 1) * (EndRow - FirstRow));
+
+    std::vector<Uint8> Candidate;
+    if (Filter == PNG_ENCODE_FILTER_ADAPTIVE)
+        Candidate.resize(RowSize + 1);
+
+    for (Uint32 row = FirstRow; row < EndRow; ++row)
+    {
+        const auto* pRow     = pPixels + row * Stride;
+        const auto* pPrevRow = row > 0 ? pRow - Stride : nullptr;
+        auto*       pDst     = &Filtered[(row - FirstRow) * (RowSize + 1)];
+        if (Filter != PNG_ENCODE_FILTER_ADAPTIVE)
+        {
+            FilterPngRow(static_cast<Uint8>(Filter - PNG_ENCODE_FILTER_NONE), pRow, pPrevRow, RowSize, Bpp, pDst);
+            continue;
+        }
+
+        // Select the filter that minimizes the sum of absolute values of the
+        // filtered bytes treated as signed, like libpng does.
+        size_t BestCost = ~size_t{0};
+        for (Uint8 FilterType = 0; FilterType <= 4; ++FilterType)
+        {
+            FilterPngRow(FilterType, pRow, pPrevRow, RowSize, Bpp, Candidate.data());
+            size_t Cost = 0;
+            for (size_t i = 1; i <= RowSize; ++i)
+                Cost += std::abs(static_cast<int>(static_cast<Int8>(Candidate[i])));
+            if (Cost < BestCost)
+            {
+                BestCost = Cost;
+                std::copy(Candidate.begin(), Candidate.end(), pDst);
+            }
+        }
+    }
+}
+
+// Deflates a band of filtered rows into a raw deflate stream. Every band except for the last one
+// ends with a sync flush, so that the bands can be concatenated into a single stream.
+static bool DeflatePngBand(const Uint8*            pDictionary,
+                           size_t                  DictionarySize,
+                           const Uint8*            pData,
+                           size_t                  DataSize,
+                           const PngEncodeOptions& Options,
+                           bool                    IsLastBand,
+                           std::vector<Uint8>&     Compressed)
+{
+    z_stream Stream = {};
+    if (deflateInit2(&Stream, Options.CompressionLevel, Z_DEFLATED, -MAX_WBITS, 8, static_cast<int>(Options.Strategy)) != Z_OK)
+        return false;
+
+    // Prime the stream with the tail of the previous band to retain most of the compression ratio
+    if (DictionarySize > 0)
+        deflateSetDictionary(&Stream, pDictionary, static_cast<uInt>(DictionarySize));
+
+    Compressed.resize(deflateBound(&Stream, static_cast<uLong>(DataSize)) + 16);
+
+    Stream.next_in   = const_cast<Bytef*>(pData);
+    Stream.avail_in  = static_cast<uInt>(DataSize);
+    Stream.next_out  = Compressed.data();
+    Stream.avail_out = static_cast<uInt>(Compressed.size());
+
+    const int Flush = IsLastBand ? Z_FINISH : Z_SYNC_FLUSH;
+    bool      Done  = false;
+    while (!Done)
+    {
+        const auto Res = deflate(&Stream, Flush);
+        if (Res != Z_OK && Res != Z_STREAM_END && Res != Z_BUF_ERROR)
+            break;
+
+        Done = IsLastBand ? (Res == Z_STREAM_END) : (Stream.avail_in == 0 && Stream.avail_out != 0);
+        if (!Done && Stream.avail_out == 0)
+        {
+            const auto Offset = Compressed.size();
+            Compressed.resize(Offset * 2);
+            Stream.next_out  = Compressed.data() + Offset;
+            Stream.avail_out = static_cast<uInt>(Compressed.size() - Offset);
+        }
+    }
+    Compressed.resize(Compressed.size() - Stream.avail_out);
+    deflateEnd(&Stream);
+
+    return Done;
+}
+
+// Encodes a PNG image splitting it into row bands that are filtered and deflated in parallel.
+// Every band is written into its own IDAT chunk.
+static bool EncodePngParallel(const Uint8*            pPixels,
+                              Uint32                  Width,
+                              Uint32                  Height,
+                              Uint32                  Stride,
+                              Uint32                  NumComponents,
+                              Uint32                  RowsPerBand,
+                              const PngEncodeOptions& Options,
+                              IThreadPool*            pThreadPool,
+                              IDataBlob*              pEncodedData)
+{
+    // Deflate window size
+    constexpr size_t DictionarySize = 32768;
+
+    const size_t RowSize  = size_t{Width} * NumComponents;
+    const auto   NumBands = (Height + RowsPerBand - 1) / RowsPerBand;
+
+    std::vector<std::vector<Uint8>> Compressed(NumBands);
+    std::vector<uLong>              Adlers(NumBands);
+    std::vector<size_t>             FilteredSizes(NumBands);
+    std::vector<Uint8>              BandResults(NumBands, 0);
+
+    auto EncodeBand = [&](Uint32 Band) {
+        const auto FirstRow = Band * RowsPerBand;
+        const auto EndRow   = std::min(FirstRow + RowsPerBand, Height);
+
+        // Also filter enough previous rows to fill the dictionary
+        const auto NumDictRows = static_cast<Uint32>(std::min<size_t>(FirstRow, (DictionarySize + RowSize) / (RowSize + 1)));
+        const auto DictRowsSize = size_t{NumDictRows} * (RowSize + 1);
+        const auto BandDictSize = std::min(DictRowsSize, DictionarySize);
+
+        std::vector<Uint8> Filtered;
+        FilterPngRows(pPixels, Stride, RowSize, NumComponents, FirstRow - NumDictRows, EndRow, Options.Filter, Filtered);
+
+        const auto* pBandData = Filtered.data() + DictRowsSize;
+        FilteredSizes[Band]   = Filtered.size() - DictRowsSize;
+        Adlers[Band]          = adler32(adler32(0, nullptr, 0), pBandData, static_cast<uInt>(FilteredSizes[Band]));
+
+        const bool IsLastBand = Band == NumBands - 1;
+        const bool Res        = DeflatePngBand(pBandData - BandDictSize, BandDictSize, pBandData, FilteredSizes[Band], Options, IsLastBand, Compressed[Band]);
+        BandResults[Band]     = Res ? 1 : 0;
+    };
+
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    Tasks.reserve(NumBands);
+    for (Uint32 Band = 0; Band < NumBands; ++Band)
+    {
+        Tasks.emplace_back(EnqueueAsyncWork(pThreadPool, [&EncodeBand, Band](Uint32) {
+            EncodeBand(Band);
+        }));
+    }
+    for (auto& pTask : Tasks)
+        pTask->WaitForCompletion();
+
+    if (std::find(BandResults.begin(), BandResults.end(), Uint8{0}) != BandResults.end())
+        return false;
+
+    uLong Adler = adler32(0, nullptr, 0);
+    for (Uint32 Band = 0; Band < NumBands; ++Band)
+        Adler = adler32_combine(Adler, Adlers[Band], static_cast<z_off_t>(FilteredSizes[Band]));
+
+    // zlib stream header: deflate with 32K window, compression level hint and check bits
+    const int   Level      = Options.CompressionLevel < 0 ? 6 : Options.CompressionLevel;
+    const Uint8 CMF        = 0x78;
+    const int   FLevel     = Level < 2 ? 0 : (Level < 6 ? 1 : (Level == 6 ? 2 : 3));
+    const Uint8 FLG        = static_cast<Uint8>((FLevel << 6) + 31 - ((CMF * 256 + (FLevel << 6)) % 31));
+    const Uint8 ZlibHeader[] = {CMF, FLG};
+    // zlib stream trailer: Adler-32 checksum of the uncompressed data
+    const Uint8 ZlibTrailer[] = {static_cast<Uint8>(Adler >> 24), static_cast<Uint8>(Adler >> 16), static_cast<Uint8>(Adler >> 8), static_cast<Uint8>(Adler)};
+
+    static constexpr Uint8  PngSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    static constexpr size_t ChunkOverhead  = 12; // Length, type and CRC
+
+    size_t TotalSize = sizeof(PngSignature) + (ChunkOverhead + 13) + ChunkOverhead;
+    for (const auto& Band : Compressed)
+        TotalSize += ChunkOverhead + Band.size();
+    TotalSize += sizeof(ZlibHeader) + sizeof(ZlibTrailer);
+
+    pEncodedData->Resize(TotalSize);
+    auto* pDst = reinterpret_cast<Uint8*>(pEncodedData->GetDataPtr());
+
+    auto WriteUint32 = [&pDst](Uint32 Value) {
+        *(pDst++) = static_cast<Uint8>(Value >> 24);
+        *(pDst++) = static_cast<Uint8>(Value >> 16);
+        *(pDst++) = static_cast<Uint8>(Value >> 8);
+        *(pDst++) = static_cast<Uint8>(Value);
+    };
+    // Writes a chunk whose data is the concatenation of the given parts
+    auto WriteChunk = [&](const char* Type, std::initializer_list<std::pair<const Uint8*, size_t>> Parts) {
+        size_t Size = 0;
+        for (const auto& Part : Parts)
+            Size += Part.second;
+        WriteUint32(static_cast<Uint32>(Size));
+
+        auto* pCRCStart = pDst;
+        memcpy(pDst, Type, 4);
+        pDst += 4;
+        for (const auto& Part : Parts)
+        {
+            if (Part.second > 0)
+                memcpy(pDst, Part.first, Part.second);
+            pDst += Part.second;
+        }
+        WriteUint32(static_cast<Uint32>(crc32(crc32(0, nullptr, 0), pCRCStart, static_cast<uInt>(pDst - pCRCStart))));
+    };
+
+    memcpy(pDst, PngSignature, sizeof(PngSignature));
+    pDst += sizeof(PngSignature);
+
+    const Uint8 HeaderData[] = {
+        static_cast<Uint8>(Width >> 24), static_cast<Uint8>(Width >> 16), static_cast<Uint8>(Width >> 8), static_cast<Uint8>(Width),
+        static_cast<Uint8>(Height >> 24), static_cast<Uint8>(Height >> 16), static_cast<Uint8>(Height >> 8), static_cast<Uint8>(Height),
+        8,                                                                                 // Bit depth
+        static_cast<Uint8>(NumComponents == 4 ? PNG_COLOR_TYPE_RGBA : PNG_COLOR_TYPE_RGB), // Color type
+        0,                                                                                 // Compression method
+        0,                                                                                 // Filter method
+        0                                                                                  // Interlace method
+    };
+    WriteChunk("IHDR", {{HeaderData, sizeof(HeaderData)}});
+
+    for (Uint32 Band = 0; Band < NumBands; ++Band)
+    {
+        WriteChunk("IDAT", {{ZlibHeader, Band == 0 ? sizeof(ZlibHeader) : 0},
+                            {Compressed[Band].data(), Compressed[Band].size()},
+                            {ZlibTrailer, Band == NumBands - 1 ? sizeof(ZlibTrailer) : 0}});
+    }
+    WriteChunk("IEND", {});
+    VERIFY_EXPR(pDst == reinterpret_cast<Uint8*>(pEncodedData->GetDataPtr()) + TotalSize);
+
+    return true;
+}
+
 void Image::Encode(const EncodeInfo& Info, IDataBlob** ppEncodedData)
 {
     auto pEncodedData = DataBlobImpl::Create();
@@ -362,9 +819,22 @@ void Image::Encode(const EncodeInfo& Info, IDataBlob** ppEncodedData)
             Stride        = Info.Width * (Info.KeepAlpha ? 4 : 3);
         }
 
-        auto Res = EncodePng(pData, Info.Width, Info.Height, Stride, Info.KeepAlpha ? PNG_COLOR_TYPE_RGBA : PNG_COLOR_TYPE_RGB, pEncodedData.RawPtr());
-        if (Res != ENCODE_PNG_RESULT_OK)
-            LOG_ERROR_MESSAGE("Failed to encode png file");
+        // Target size of the raw data in a row band that is deflated by a single task
+        constexpr size_t BandSize = 256 << 10;
+
+        const Uint32 NumComponents = Info.KeepAlpha ? 4 : 3;
+        const auto   RowsPerBand   = static_cast<Uint32>(std::max(BandSize / (size_t{Info.Width} * NumComponents), size_t{1}));
+        if (Info.pThreadPool != nullptr && Info.Width > 0 && Info.Height > RowsPerBand)
+        {
+            if (!EncodePngParallel(pData, Info.Width, Info.Height, Stride, NumComponents, RowsPerBand, Info.PngOptions, Info.pThreadPool, pEncodedData.RawPtr()))
+                LOG_ERROR_MESSAGE("Failed to encode png file");
+        }
+        else
+        {
+            auto Res = EncodePng(pData, Info.Width, Info.Height, Stride, Info.KeepAlpha ? PNG_COLOR_TYPE_RGBA : PNG_COLOR_TYPE_RGB, pEncodedData.RawPtr(), &Info.PngOptions);
+            if (Res != ENCODE_PNG_RESULT_OK)
+                LOG_ERROR_MESSAGE("Failed to encode png file");
+        }
     }
     else
     {
@@ -404,6 +874,10 @@ IMAGE_FILE_FORMAT Image::GetFileFormat(const Uint8* pData, size_t Size, const ch
 
         if (Size >= 2 && pData[0] == 0x01 && pData[1] == 0xDA)
             return IMAGE_FILE_FORMAT_SGI;
+
+        if ((Size >= 10 && memcmp(pData, "#?RADIANCE", 10) == 0) ||
+            (Size >= 6 && memcmp(pData, "#?RGBE", 6) == 0))
+            return IMAGE_FILE_FORMAT_HDR;
     }
 
     if (FilePath != nullptr)
@@ -436,6 +910,8 @@ IMAGE_FILE_FORMAT Image::GetFileFormat(const Uint8* pData, size_t Size, const ch
             return IMAGE_FILE_FORMAT_KTX;
         else if (Extension == "sgi" || Extension == "rgb" || Extension == "rgba" || Extension == "bw" || Extension == "int" || Extension == "inta")
             return IMAGE_FILE_FORMAT_SGI;
+        else if (Extension == "hdr")
+            return IMAGE_FILE_FORMAT_HDR;
         else
             LOG_ERROR_MESSAGE("Unrecognized image file extension", Extension);
     }
@@ -444,9 +920,262 @@ IMAGE_FILE_FORMAT Image::GetFileFormat(const Uint8* pData, size_t Size, const ch
 }
 
 
-IMAGE_FILE_FORMAT CreateImageFromFile(const Char* FilePath,
-                                      Image**     ppImage,
-                                      IDataBlob** ppRawData)
+static Uint32 ReadBE32(const Uint8* pData)
+{
+    return (Uint32{pData[0]} << 24u) | (Uint32{pData[1]} << 16u) | (Uint32{pData[2]} << 8u) | Uint32{pData[3]};
+}
+
+static Uint16 ReadBE16(const Uint8* pData)
+{
+    return static_cast<Uint16>((Uint32{pData[0]} << 8u) | Uint32{pData[1]});
+}
+
+// Reads the IHDR chunk and looks for the tRNS chunk that precedes the image data.
+// The number of components matches the output of DecodePng().
+static bool ProbePng(const Uint8* pData, size_t DataSize, ImageProbeInfo& Info)
+{
+    // Signature, IHDR chunk length and type, and 13 bytes of IHDR data
+    if (DataSize < 33 || memcmp(pData + 12, "IHDR", 4) != 0)
+        return false;
+
+    Info.Width  = ReadBE32(pData + 16);
+    Info.Height = ReadBE32(pData + 20);
+
+    const auto BitDepth  = pData[24];
+    const auto ColorType = pData[25];
+
+    bool HasTransparency = false;
+    for (size_t Offset = 8; Offset + 8 <= DataSize;)
+    {
+        const auto* pChunkType = pData + Offset + 4;
+        if (memcmp(pChunkType, "IDAT", 4) == 0 || memcmp(pChunkType, "IEND", 4) == 0)
+            break;
+        if (memcmp(pChunkType, "tRNS", 4) == 0)
+        {
+            HasTransparency = true;
+            break;
+        }
+        // Chunk length, type, data and CRC
+        Offset += size_t{ReadBE32(pData + Offset)} + 12;
+    }
+
+    switch (ColorType)
+    {
+        case PNG_COLOR_TYPE_GRAY: Info.NumComponents = HasTransparency ? 2 : 1; break;
+        case PNG_COLOR_TYPE_GRAY_ALPHA: Info.NumComponents = 2; break;
+        case PNG_COLOR_TYPE_RGB: Info.NumComponents = HasTransparency ? 4 : 3; break;
+        // Paletted images are expanded to RGBA
+        case PNG_COLOR_TYPE_PALETTE: Info.NumComponents = 4; break;
+        case PNG_COLOR_TYPE_RGB_ALPHA: Info.NumComponents = 4; break;
+        default: return false;
+    }
+    // Smaller bit depths are expanded to 8 bits
+    Info.ComponentType = BitDepth == 16 ? VT_UINT16 : VT_UINT8;
+
+    return true;
+}
+
+// Scans JPEG markers for the start-of-frame segment
+static bool ProbeJpeg(const Uint8* pData, size_t DataSize, ImageProbeInfo& Info)
+{
+    for (size_t Offset = 2; Offset + 4 <= DataSize;)
+    {
+        if (pData[Offset] != 0xFF)
+            return false;
+
+        const auto Marker = pData[Offset + 1];
+        if (Marker == 0xFF)
+        {
+            // Fill byte
+            ++Offset;
+            continue;
+        }
+        if (Marker == 0x01 || (Marker >= 0xD0 && Marker <= 0xD7))
+        {
+            // TEM and RSTn markers have no payload
+            Offset += 2;
+            continue;
+        }
+        if (Marker == 0xD9 || Marker == 0xDA)
+        {
+            // EOI or SOS before the frame header
+            return false;
+        }
+
+        // SOF0-SOF15 markers, except for DHT (0xC4), JPG (0xC8) and DAC (0xCC)
+        if (Marker >= 0xC0 && Marker <= 0xCF && Marker != 0xC4 && Marker != 0xC8 && Marker != 0xCC)
+        {
+            // Segment length, sample precision, height, width and the number of components
+            if (Offset + 10 > DataSize)
+                return false;
+
+            Info.Height        = ReadBE16(pData + Offset + 5);
+            Info.Width         = ReadBE16(pData + Offset + 7);
+            Info.NumComponents = pData[Offset + 9];
+            Info.ComponentType = VT_UINT8;
+            return true;
+        }
+
+        Offset += 2 + size_t{ReadBE16(pData + Offset + 2)};
+    }
+
+    return false;
+}
+
+// Reads the first image file directory
+static bool ProbeTiff(const Uint8* pData, size_t DataSize, ImageProbeInfo& Info)
+{
+    TIFFClientOpenWrapper TiffClientOpenWrpr{pData, DataSize};
+
+    auto TiffFile = OpenTiffFromMemory(TiffClientOpenWrpr);
+    if (TiffFile == nullptr)
+        return false;
+
+    Uint32 Width           = 0;
+    Uint32 Height          = 0;
+    Uint16 SamplesPerPixel = 0;
+    Uint16 BitsPerSample   = 0;
+    Uint16 SampleFormat    = 0;
+    TIFFGetField(TiffFile, TIFFTAG_IMAGEWIDTH, &Width);
+    TIFFGetField(TiffFile, TIFFTAG_IMAGELENGTH, &Height);
+    TIFFGetFieldDefaulted(TiffFile, TIFFTAG_SAMPLESPERPIXEL, &SamplesPerPixel);
+    TIFFGetFieldDefaulted(TiffFile, TIFFTAG_BITSPERSAMPLE, &BitsPerSample);
+    TIFFGetFieldDefaulted(TiffFile, TIFFTAG_SAMPLEFORMAT, &SampleFormat);
+    TIFFClose(TiffFile);
+
+    // Same component types as in Image::LoadTiffFile()
+    VALUE_TYPE ComponentType = VT_UNDEFINED;
+    switch (SampleFormat)
+    {
+        case SAMPLEFORMAT_UINT:
+            ComponentType = BitsPerSample == 8 ? VT_UINT8 : (BitsPerSample == 16 ? VT_UINT16 : (BitsPerSample == 32 ? VT_UINT32 : VT_UNDEFINED));
+            break;
+
+        case SAMPLEFORMAT_INT:
+            ComponentType = BitsPerSample == 8 ? VT_INT8 : (BitsPerSample == 16 ? VT_INT16 : (BitsPerSample == 32 ? VT_INT32 : VT_UNDEFINED));
+            break;
+
+        case SAMPLEFORMAT_IEEEFP:
+            ComponentType = BitsPerSample == 16 ? VT_FLOAT16 : (BitsPerSample == 32 ? VT_FLOAT32 : VT_UNDEFINED);
+            break;
+    }
+    if (ComponentType == VT_UNDEFINED)
+        return false;
+
+    Info.Width         = Width;
+    Info.Height        = Height;
+    Info.NumComponents = SamplesPerPixel;
+    Info.ComponentType = ComponentType;
+    return true;
+}
+
+bool ProbeImage(const Uint8* pData, size_t DataSize, ImageProbeInfo& Info)
+{
+    Info = ImageProbeInfo{};
+    if (pData == nullptr)
+        return false;
+
+    const auto FileFormat = Image::GetFileFormat(pData, DataSize);
+
+    bool Result = false;
+    switch (FileFormat)
+    {
+        case IMAGE_FILE_FORMAT_PNG:
+            Result = ProbePng(pData, DataSize, Info);
+            break;
+
+        case IMAGE_FILE_FORMAT_JPEG:
+            Result = ProbeJpeg(pData, DataSize, Info);
+            break;
+
+        case IMAGE_FILE_FORMAT_TIFF:
+            Result = ProbeTiff(pData, DataSize, Info);
+            break;
+
+        case IMAGE_FILE_FORMAT_DDS:
+            Result = ReadDDSHeader(pData, DataSize, Info);
+            break;
+
+        case IMAGE_FILE_FORMAT_KTX:
+            Result = ReadKTXHeader(pData, DataSize, Info);
+            break;
+
+        case IMAGE_FILE_FORMAT_SGI:
+        case IMAGE_FILE_FORMAT_HDR:
+        {
+            ImageDesc Desc;
+            Result = FileFormat == IMAGE_FILE_FORMAT_SGI ?
+                ReadSGIHeader(pData, DataSize, &Desc) :
+                ReadHDRHeader(pData, DataSize, &Desc);
+            if (Result)
+            {
+                Info.Width         = Desc.Width;
+                Info.Height        = Desc.Height;
+                Info.NumComponents = Desc.NumComponents;
+                Info.ComponentType = Desc.ComponentType;
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    if (!Result)
+    {
+        Info = ImageProbeInfo{};
+        return false;
+    }
+
+    Info.FileFormat = FileFormat;
+    return true;
+}
+
+bool ProbeImageFile(const Char* FilePath, ImageProbeInfo& Info)
+{
+    Info = ImageProbeInfo{};
+
+    // Large enough for the headers of most files
+    constexpr size_t PrefixSize = size_t{64} << 10u;
+
+    RefCntAutoPtr<BasicFileStream> pFileStream{MakeNewRCObj<BasicFileStream>()(FilePath, EFileAccessMode::Read)};
+    if (!pFileStream->IsValid())
+    {
+        LOG_ERROR_MESSAGE("Failed to open image file \"", FilePath, '\"');
+        return false;
+    }
+
+    const size_t       FileSize = pFileStream->GetSize();
+    std::vector<Uint8> FileData(std::min(FileSize, PrefixSize));
+    if (!FileData.empty() && !pFileStream->Read(FileData.data(), FileData.size()))
+    {
+        LOG_ERROR_MESSAGE("Failed to read image file \"", FilePath, '\"');
+        return false;
+    }
+
+    if (ProbeImage(FileData.data(), FileData.size(), Info))
+        return true;
+
+    if (FileSize <= FileData.size() || Image::GetFileFormat(FileData.data(), FileData.size()) == IMAGE_FILE_FORMAT_UNKNOWN)
+        return false;
+
+    // The header does not fit into the prefix, so read the rest of the file
+    const auto ReadSize = FileData.size();
+    FileData.resize(FileSize);
+    if (!pFileStream->Read(FileData.data() + ReadSize, FileSize - ReadSize))
+    {
+        LOG_ERROR_MESSAGE("Failed to read image file \"", FilePath, '\"');
+        return false;
+    }
+
+    return ProbeImage(FileData.data(), FileData.size(), Info);
+}
+
+
+static IMAGE_FILE_FORMAT LoadImageFromFile(const Char*          FilePath,
+                                           const ImageLoadInfo& LoadInfo,
+                                           Image**              ppImage,
+                                           IDataBlob**          ppRawData)
 {
     auto ImgFileFormat = IMAGE_FILE_FORMAT_UNKNOWN;
     try
@@ -469,7 +1198,7 @@ IMAGE_FILE_FORMAT CreateImageFromFile(const Char* FilePath,
             ImgFileFormat == IMAGE_FILE_FORMAT_TIFF ||
             ImgFileFormat == IMAGE_FILE_FORMAT_SGI)
         {
-            ImageLoadInfo ImgLoadInfo;
+            ImageLoadInfo ImgLoadInfo{LoadInfo};
             ImgLoadInfo.Format = ImgFileFormat;
             Image::CreateFromDataBlob(pFileData, ImgLoadInfo, ppImage);
         }
@@ -486,4 +1215,20 @@ IMAGE_FILE_FORMAT CreateImageFromFile(const Char* FilePath,
     return ImgFileFormat;
 }
 
+IMAGE_FILE_FORMAT CreateImageFromFile(const Char* FilePath,
+                                      Image**     ppImage,
+                                      IDataBlob** ppRawData)
+{
+    return LoadImageFromFile(FilePath, ImageLoadInfo{}, ppImage, ppRawData);
+}
+
+std::future<RefCntAutoPtr<Image>> CreateImageFromFileAsync(const Char* FilePath, const ImageLoadInfo& LoadInfo)
+{
+    return std::async(std::launch::async, [Path = String{FilePath != nullptr ? FilePath : ""}, LoadInfo]() {
+        RefCntAutoPtr<Image> pImage;
+        LoadImageFromFile(Path.c_str(), LoadInfo, &pImage, nullptr);
+        return pImage;
+    });
+}
+
 } // namespace Diligent
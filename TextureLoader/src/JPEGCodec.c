@@ -58,11 +58,38 @@ my_error_exit(j_common_ptr cinfo)
     longjmp(myerr->setjmp_buffer, 1);
 }
 
-DECODE_JPEG_RESULT Diligent_DecodeJpeg(IDataBlob* pSrcJpegBits,
-                                       IDataBlob* pDstPixels,
-                                       ImageDesc* pDstImgDesc)
+// Copies the row changing the number of components the same way as CopyPixels does:
+// for single-channel sources r is propagated to g and b, and missing alpha is set to 255.
+static void JpegConvertRow(const JSAMPLE* pSrc, Uint8* pDst, Uint32 Width, Uint32 SrcCompCount, Uint32 DstCompCount)
 {
-    if (!pSrcJpegBits || !pDstPixels || !pDstImgDesc)
+    Uint32 x, c;
+    for (x = 0; x < Width; ++x)
+    {
+        const JSAMPLE* pSrcTexel = pSrc + (size_t)x * SrcCompCount;
+        Uint8*         pDstTexel = pDst + (size_t)x * DstCompCount;
+        for (c = 0; c < DstCompCount; ++c)
+        {
+            if (c < SrcCompCount)
+                pDstTexel[c] = (Uint8)pSrcTexel[c];
+            else if (c < 3)
+                pDstTexel[c] = SrcCompCount == 1 ? (Uint8)pSrcTexel[0] : 0;
+            else
+                pDstTexel[c] = 255;
+        }
+    }
+}
+
+// Decodes the image either into the data blob (pDstBlob != NULL) or into the caller-provided memory.
+// If both are null, only the image description is read.
+static DECODE_JPEG_RESULT DecodeJpegImpl(IDataBlob* pSrcJpegBits,
+                                         IDataBlob* pDstBlob,
+                                         void*      pDstPixels,
+                                         Uint32     DstStride,
+                                         Uint32     DstCompCount,
+                                         ImageDesc* pDstImgDesc,
+                                         Uint32     ScaleDenom)
+{
+    if (ScaleDenom != 1 && ScaleDenom != 2 && ScaleDenom != 4 && ScaleDenom != 8)
         return DECODE_JPEG_RESULT_INVALID_ARGUMENTS;
 
     // https://github.com/LuaDist/libjpeg/blob/master/example.c
@@ -76,6 +103,9 @@ DECODE_JPEG_RESULT Diligent_DecodeJpeg(IDataBlob* pSrcJpegBits,
     // struct, to avoid dangling-pointer problems.
     my_jpeg_error_mgr jerr;
 
+    // Temporary scanline used when the number of components is changed
+    JSAMPLE* pTmpRow = NULL;
+
     // Step 1: allocate and initialize JPEG decompression object
 
     // We set up the normal JPEG error routines, then override error_exit.
@@ -86,6 +116,8 @@ DECODE_JPEG_RESULT Diligent_DecodeJpeg(IDataBlob* pSrcJpegBits,
     {
         // If we get here, the JPEG code has signaled an error.
         // We need to clean up the JPEG object, close the input file, and return.
+        if (pTmpRow)
+            free(pTmpRow);
         jpeg_destroy_decompress(&cinfo);
         return DECODE_JPEG_RESULT_INITIALIZATION_FAILED;
     }
@@ -108,20 +140,13 @@ DECODE_JPEG_RESULT Diligent_DecodeJpeg(IDataBlob* pSrcJpegBits,
 
     // Step 4: set parameters for decompression
 
-    // In this example, we don't need to change any of the defaults set by
-    // jpeg_read_header(), so we do nothing here.
-
+    // Scaled decoding is performed by the reduced-size IDCT and is much
+    // faster than decoding the full image.
+    cinfo.scale_num   = 1;
+    cinfo.scale_denom = ScaleDenom;
 
-    // Step 5: Start decompressor
-
-    jpeg_start_decompress(&cinfo);
-    // We can ignore the return value since suspension is not possible
-    // with the stdio data source.
-
-    // We may need to do some setup of our own at this point before reading
-    // the data.  After jpeg_start_decompress() we have the correct scaled
-    // output image dimensions available, as well as the output colormap
-    // if we asked for color quantization.
+    // Compute the output dimensions without starting the decompressor
+    jpeg_calc_output_dimensions(&cinfo);
 
     pDstImgDesc->Width         = cinfo.output_width;
     pDstImgDesc->Height        = cinfo.output_height;
@@ -130,7 +155,38 @@ DECODE_JPEG_RESULT Diligent_DecodeJpeg(IDataBlob* pSrcJpegBits,
     pDstImgDesc->RowStride     = pDstImgDesc->Width * pDstImgDesc->NumComponents;
     pDstImgDesc->RowStride     = (pDstImgDesc->RowStride + 3u) & ~3u;
 
-    IDataBlob_Resize(pDstPixels, (size_t)pDstImgDesc->RowStride * pDstImgDesc->Height);
+    const Uint32 SrcCompCount = pDstImgDesc->NumComponents;
+    if (pDstBlob != NULL)
+    {
+        IDataBlob_Resize(pDstBlob, (size_t)pDstImgDesc->RowStride * pDstImgDesc->Height);
+        pDstPixels   = IDataBlob_GetDataPtr(pDstBlob);
+        DstStride    = pDstImgDesc->RowStride;
+        DstCompCount = SrcCompCount;
+    }
+    else if (pDstPixels == NULL)
+    {
+        // Only the image description was requested
+        jpeg_destroy_decompress(&cinfo);
+        return DECODE_JPEG_RESULT_OK;
+    }
+
+    if (DstCompCount == 0)
+        DstCompCount = SrcCompCount;
+    if (DstCompCount > 4 || DstStride < pDstImgDesc->Width * DstCompCount)
+    {
+        jpeg_destroy_decompress(&cinfo);
+        return DECODE_JPEG_RESULT_INVALID_ARGUMENTS;
+    }
+
+    // Step 5: Start decompressor
+
+    jpeg_start_decompress(&cinfo);
+    // We can ignore the return value since suspension is not possible
+    // with the stdio data source.
+
+    if (DstCompCount != SrcCompCount)
+        pTmpRow = malloc((size_t)cinfo.output_width * SrcCompCount);
+
     // Step 6: while (scan lines remain to be read)
     //           jpeg_read_scanlines(...);
 
@@ -138,17 +194,39 @@ DECODE_JPEG_RESULT Diligent_DecodeJpeg(IDataBlob* pSrcJpegBits,
     // loop counter, so that we don't have to keep track ourselves.
     while (cinfo.output_scanline < cinfo.output_height)
     {
-        // jpeg_read_scanlines expects an array of pointers to scanlines.
-        // Here the array is only one element long, but you could ask for
-        // more than one scanline at a time if that's more convenient.
-
-        Uint8*   pScanline0   = IDataBlob_GetDataPtr(pDstPixels);
-        Uint8*   pDstScanline = pScanline0 + cinfo.output_scanline * (size_t)pDstImgDesc->RowStride;
-        JSAMPROW RowPtrs[1];
-        RowPtrs[0] = (JSAMPROW)pDstScanline;
-        jpeg_read_scanlines(&cinfo, RowPtrs, 1);
+        Uint8* pDstScanline = (Uint8*)pDstPixels + cinfo.output_scanline * (size_t)DstStride;
+        if (pTmpRow == NULL)
+        {
+            // jpeg_read_scanlines expects an array of pointers to scanlines.
+            // Request up to rec_outbuf_height lines at a time, which lets the
+            // decoder emit a whole row group without intermediate buffering.
+            JSAMPROW   RowPtrs[4];
+            JDIMENSION NumRows = cinfo.output_height - cinfo.output_scanline;
+            JDIMENSION row     = 0;
+            if (NumRows > (JDIMENSION)cinfo.rec_outbuf_height)
+                NumRows = (JDIMENSION)cinfo.rec_outbuf_height;
+            if (NumRows > 4)
+                NumRows = 4;
+            for (row = 0; row < NumRows; ++row)
+                RowPtrs[row] = (JSAMPROW)(pDstScanline + row * (size_t)DstStride);
+            jpeg_read_scanlines(&cinfo, RowPtrs, NumRows);
+        }
+        else
+        {
+            // Decode the scanline into the temporary row and convert it into the destination
+            JSAMPROW RowPtrs[1];
+            RowPtrs[0] = pTmpRow;
+            jpeg_read_scanlines(&cinfo, RowPtrs, 1);
+            JpegConvertRow(pTmpRow, pDstScanline, cinfo.output_width, SrcCompCount, DstCompCount);
+        }
     }
 
+    if (pTmpRow)
+        free(pTmpRow);
+
+    pDstImgDesc->NumComponents = DstCompCount;
+    pDstImgDesc->RowStride     = DstStride;
+
     // Step 7: Finish decompression
 
     jpeg_finish_decompress(&cinfo);
@@ -166,6 +244,30 @@ DECODE_JPEG_RESULT Diligent_DecodeJpeg(IDataBlob* pSrcJpegBits,
     return DECODE_JPEG_RESULT_OK;
 }
 
+DECODE_JPEG_RESULT Diligent_DecodeJpeg(IDataBlob* pSrcJpegBits,
+                                       IDataBlob* pDstPixels,
+                                       ImageDesc* pDstImgDesc,
+                                       Uint32     ScaleDenom)
+{
+    if (!pSrcJpegBits || !pDstPixels || !pDstImgDesc)
+        return DECODE_JPEG_RESULT_INVALID_ARGUMENTS;
+
+    return DecodeJpegImpl(pSrcJpegBits, pDstPixels, NULL, 0, 0, pDstImgDesc, ScaleDenom);
+}
+
+DECODE_JPEG_RESULT Diligent_DecodeJpegIntoMemory(IDataBlob* pSrcJpegBits,
+                                                 void*      pDstPixels,
+                                                 Uint32     DstStride,
+                                                 Uint32     DstCompCount,
+                                                 ImageDesc* pDstImgDesc,
+                                                 Uint32     ScaleDenom)
+{
+    if (!pSrcJpegBits || !pDstImgDesc)
+        return DECODE_JPEG_RESULT_INVALID_ARGUMENTS;
+
+    return DecodeJpegImpl(pSrcJpegBits, NULL, pDstPixels, DstStride, DstCompCount, pDstImgDesc, ScaleDenom);
+}
+
 
 
 ENCODE_JPEG_RESULT Diligent_EncodeJpeg(Uint8*     pSrcRGBPixels,
@@ -27,11 +27,14 @@
 
 #include <algorithm>
 #include <vector>
+#include <cstring>
 
 #include "TextureLoaderImpl.hpp"
 #include "GraphicsAccessories.hpp"
 #include "Align.hpp"
 
+#include "zlib.h"
+
 #define GL_RGBA32F            0x8814
 #define GL_RGBA32UI           0x8D70
 #define GL_RGBA32I            0x8D82
@@ -192,6 +195,168 @@ TEXTURE_FORMAT FindDiligentTextureFormat(std::uint32_t GLInternalFormat)
     }
 }
 
+// Vulkan formats used by KTX2 files
+enum VK_FORMAT : std::uint32_t
+{
+    VK_FORMAT_UNDEFINED                = 0,
+    VK_FORMAT_R8_UNORM                 = 9,
+    VK_FORMAT_R8_SNORM                 = 10,
+    VK_FORMAT_R8_UINT                  = 13,
+    VK_FORMAT_R8_SINT                  = 14,
+    VK_FORMAT_R8G8_UNORM               = 16,
+    VK_FORMAT_R8G8_SNORM               = 17,
+    VK_FORMAT_R8G8_UINT                = 20,
+    VK_FORMAT_R8G8_SINT                = 21,
+    VK_FORMAT_R8G8B8A8_UNORM           = 37,
+    VK_FORMAT_R8G8B8A8_SNORM           = 38,
+    VK_FORMAT_R8G8B8A8_UINT            = 41,
+    VK_FORMAT_R8G8B8A8_SINT            = 42,
+    VK_FORMAT_R8G8B8A8_SRGB            = 43,
+    VK_FORMAT_B8G8R8A8_UNORM           = 44,
+    VK_FORMAT_B8G8R8A8_SRGB            = 50,
+    VK_FORMAT_A2B10G10R10_UNORM_PACK32 = 64,
+    VK_FORMAT_A2B10G10R10_UINT_PACK32  = 68,
+    VK_FORMAT_R16_UNORM                = 70,
+    VK_FORMAT_R16_SNORM                = 71,
+    VK_FORMAT_R16_UINT                 = 74,
+    VK_FORMAT_R16_SINT                 = 75,
+    VK_FORMAT_R16_SFLOAT               = 76,
+    VK_FORMAT_R16G16_UNORM             = 77,
+    VK_FORMAT_R16G16_SNORM             = 78,
+    VK_FORMAT_R16G16_UINT              = 81,
+    VK_FORMAT_R16G16_SINT              = 82,
+    VK_FORMAT_R16G16_SFLOAT            = 83,
+    VK_FORMAT_R16G16B16A16_UNORM       = 91,
+    VK_FORMAT_R16G16B16A16_SNORM       = 92,
+    VK_FORMAT_R16G16B16A16_UINT        = 95,
+    VK_FORMAT_R16G16B16A16_SINT        = 96,
+    VK_FORMAT_R16G16B16A16_SFLOAT      = 97,
+    VK_FORMAT_R32_UINT                 = 98,
+    VK_FORMAT_R32_SINT                 = 99,
+    VK_FORMAT_R32_SFLOAT               = 100,
+    VK_FORMAT_R32G32_UINT              = 101,
+    VK_FORMAT_R32G32_SINT              = 102,
+    VK_FORMAT_R32G32_SFLOAT            = 103,
+    VK_FORMAT_R32G32B32_UINT           = 104,
+    VK_FORMAT_R32G32B32_SINT           = 105,
+    VK_FORMAT_R32G32B32_SFLOAT         = 106,
+    VK_FORMAT_R32G32B32A32_UINT        = 107,
+    VK_FORMAT_R32G32B32A32_SINT        = 108,
+    VK_FORMAT_R32G32B32A32_SFLOAT      = 109,
+    VK_FORMAT_B10G11R11_UFLOAT_PACK32  = 122,
+    VK_FORMAT_E5B9G9R9_UFLOAT_PACK32   = 123,
+    VK_FORMAT_D16_UNORM                = 124,
+    VK_FORMAT_D32_SFLOAT               = 126,
+    VK_FORMAT_D24_UNORM_S8_UINT        = 129,
+    VK_FORMAT_D32_SFLOAT_S8_UINT       = 130,
+    VK_FORMAT_BC1_RGB_UNORM_BLOCK      = 131,
+    VK_FORMAT_BC1_RGB_SRGB_BLOCK       = 132,
+    VK_FORMAT_BC1_RGBA_UNORM_BLOCK     = 133,
+    VK_FORMAT_BC1_RGBA_SRGB_BLOCK      = 134,
+    VK_FORMAT_BC2_UNORM_BLOCK          = 135,
+    VK_FORMAT_BC2_SRGB_BLOCK           = 136,
+    VK_FORMAT_BC3_UNORM_BLOCK          = 137,
+    VK_FORMAT_BC3_SRGB_BLOCK           = 138,
+    VK_FORMAT_BC4_UNORM_BLOCK          = 139,
+    VK_FORMAT_BC4_SNORM_BLOCK          = 140,
+    VK_FORMAT_BC5_UNORM_BLOCK          = 141,
+    VK_FORMAT_BC5_SNORM_BLOCK          = 142,
+    VK_FORMAT_BC6H_UFLOAT_BLOCK        = 143,
+    VK_FORMAT_BC6H_SFLOAT_BLOCK        = 144,
+    VK_FORMAT_BC7_UNORM_BLOCK          = 145,
+    VK_FORMAT_BC7_SRGB_BLOCK           = 146
+};
+
+TEXTURE_FORMAT VkFormatToDiligentTextureFormat(std::uint32_t VkFormat)
+{
+    switch (VkFormat)
+    {
+        // clang-format off
+        case VK_FORMAT_R8_UNORM:                 return TEX_FORMAT_R8_UNORM;
+        case VK_FORMAT_R8_SNORM:                 return TEX_FORMAT_R8_SNORM;
+        case VK_FORMAT_R8_UINT:                  return TEX_FORMAT_R8_UINT;
+        case VK_FORMAT_R8_SINT:                  return TEX_FORMAT_R8_SINT;
+
+        case VK_FORMAT_R8G8_UNORM:               return TEX_FORMAT_RG8_UNORM;
+        case VK_FORMAT_R8G8_SNORM:               return TEX_FORMAT_RG8_SNORM;
+        case VK_FORMAT_R8G8_UINT:                return TEX_FORMAT_RG8_UINT;
+        case VK_FORMAT_R8G8_SINT:                return TEX_FORMAT_RG8_SINT;
+
+        case VK_FORMAT_R8G8B8A8_UNORM:           return TEX_FORMAT_RGBA8_UNORM;
+        case VK_FORMAT_R8G8B8A8_SNORM:           return TEX_FORMAT_RGBA8_SNORM;
+        case VK_FORMAT_R8G8B8A8_UINT:            return TEX_FORMAT_RGBA8_UINT;
+        case VK_FORMAT_R8G8B8A8_SINT:            return TEX_FORMAT_RGBA8_SINT;
+        case VK_FORMAT_R8G8B8A8_SRGB:            return TEX_FORMAT_RGBA8_UNORM_SRGB;
+        case VK_FORMAT_B8G8R8A8_UNORM:           return TEX_FORMAT_BGRA8_UNORM;
+        case VK_FORMAT_B8G8R8A8_SRGB:            return TEX_FORMAT_BGRA8_UNORM_SRGB;
+
+        case VK_FORMAT_A2B10G10R10_UNORM_PACK32: return TEX_FORMAT_RGB10A2_UNORM;
+        case VK_FORMAT_A2B10G10R10_UINT_PACK32:  return TEX_FORMAT_RGB10A2_UINT;
+
+        case VK_FORMAT_R16_UNORM:                return TEX_FORMAT_R16_UNORM;
+        case VK_FORMAT_R16_SNORM:                return TEX_FORMAT_R16_SNORM;
+        case VK_FORMAT_R16_UINT:                 return TEX_FORMAT_R16_UINT;
+        case VK_FORMAT_R16_SINT:                 return TEX_FORMAT_R16_SINT;
+        case VK_FORMAT_R16_SFLOAT:               return TEX_FORMAT_R16_FLOAT;
+
+        case VK_FORMAT_R16G16_UNORM:             return TEX_FORMAT_RG16_UNORM;
+        case VK_FORMAT_R16G16_SNORM:             return TEX_FORMAT_RG16_SNORM;
+        case VK_FORMAT_R16G16_UINT:              return TEX_FORMAT_RG16_UINT;
+        case VK_FORMAT_R16G16_SINT:              return TEX_FORMAT_RG16_SINT;
+        case VK_FORMAT_R16G16_SFLOAT:            return TEX_FORMAT_RG16_FLOAT;
+
+        case VK_FORMAT_R16G16B16A16_UNORM:       return TEX_FORMAT_RGBA16_UNORM;
+        case VK_FORMAT_R16G16B16A16_SNORM:       return TEX_FORMAT_RGBA16_SNORM;
+        case VK_FORMAT_R16G16B16A16_UINT:        return TEX_FORMAT_RGBA16_UINT;
+        case VK_FORMAT_R16G16B16A16_SINT:        return TEX_FORMAT_RGBA16_SINT;
+        case VK_FORMAT_R16G16B16A16_SFLOAT:      return TEX_FORMAT_RGBA16_FLOAT;
+
+        case VK_FORMAT_R32_UINT:                 return TEX_FORMAT_R32_UINT;
+        case VK_FORMAT_R32_SINT:                 return TEX_FORMAT_R32_SINT;
+        case VK_FORMAT_R32_SFLOAT:               return TEX_FORMAT_R32_FLOAT;
+
+        case VK_FORMAT_R32G32_UINT:              return TEX_FORMAT_RG32_UINT;
+        case VK_FORMAT_R32G32_SINT:              return TEX_FORMAT_RG32_SINT;
+        case VK_FORMAT_R32G32_SFLOAT:            return TEX_FORMAT_RG32_FLOAT;
+
+        case VK_FORMAT_R32G32B32_UINT:           return TEX_FORMAT_RGB32_UINT;
+        case VK_FORMAT_R32G32B32_SINT:           return TEX_FORMAT_RGB32_SINT;
+        case VK_FORMAT_R32G32B32_SFLOAT:         return TEX_FORMAT_RGB32_FLOAT;
+
+        case VK_FORMAT_R32G32B32A32_UINT:        return TEX_FORMAT_RGBA32_UINT;
+        case VK_FORMAT_R32G32B32A32_SINT:        return TEX_FORMAT_RGBA32_SINT;
+        case VK_FORMAT_R32G32B32A32_SFLOAT:      return TEX_FORMAT_RGBA32_FLOAT;
+
+        case VK_FORMAT_B10G11R11_UFLOAT_PACK32:  return TEX_FORMAT_R11G11B10_FLOAT;
+        case VK_FORMAT_E5B9G9R9_UFLOAT_PACK32:   return TEX_FORMAT_RGB9E5_SHAREDEXP;
+
+        case VK_FORMAT_D16_UNORM:                return TEX_FORMAT_D16_UNORM;
+        case VK_FORMAT_D32_SFLOAT:               return TEX_FORMAT_D32_FLOAT;
+        case VK_FORMAT_D24_UNORM_S8_UINT:        return TEX_FORMAT_D24_UNORM_S8_UINT;
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:       return TEX_FORMAT_D32_FLOAT_S8X24_UINT;
+
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:     return TEX_FORMAT_BC1_UNORM;
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:      return TEX_FORMAT_BC1_UNORM_SRGB;
+        case VK_FORMAT_BC2_UNORM_BLOCK:          return TEX_FORMAT_BC2_UNORM;
+        case VK_FORMAT_BC2_SRGB_BLOCK:           return TEX_FORMAT_BC2_UNORM_SRGB;
+        case VK_FORMAT_BC3_UNORM_BLOCK:          return TEX_FORMAT_BC3_UNORM;
+        case VK_FORMAT_BC3_SRGB_BLOCK:           return TEX_FORMAT_BC3_UNORM_SRGB;
+        case VK_FORMAT_BC4_UNORM_BLOCK:          return TEX_FORMAT_BC4_UNORM;
+        case VK_FORMAT_BC4_SNORM_BLOCK:          return TEX_FORMAT_BC4_SNORM;
+        case VK_FORMAT_BC5_UNORM_BLOCK:          return TEX_FORMAT_BC5_UNORM;
+        case VK_FORMAT_BC5_SNORM_BLOCK:          return TEX_FORMAT_BC5_SNORM;
+        case VK_FORMAT_BC6H_UFLOAT_BLOCK:        return TEX_FORMAT_BC6H_UF16;
+        case VK_FORMAT_BC6H_SFLOAT_BLOCK:        return TEX_FORMAT_BC6H_SF16;
+        case VK_FORMAT_BC7_UNORM_BLOCK:          return TEX_FORMAT_BC7_UNORM;
+        case VK_FORMAT_BC7_SRGB_BLOCK:           return TEX_FORMAT_BC7_UNORM_SRGB;
+        // clang-format on
+        default:
+            return TEX_FORMAT_UNKNOWN;
+    }
+}
+
 } // namespace
 
 
@@ -214,6 +379,8 @@ struct KTX10Header
 
 void TextureLoaderImpl::LoadFromKTX(const TextureLoadInfo& TexLoadInfo, const Uint8* pData, size_t DataSize)
 {
+    DILIGENT_TRACE_ZONE("TextureLoader::LoadFromKTX");
+
 #ifdef DILIGENT_DEBUG
     const auto* pOrigDataPtr = pData;
 #endif
@@ -288,8 +455,494 @@ void TextureLoaderImpl::LoadFromKTX(const TextureLoadInfo& TexLoadInfo, const Ui
     }
     else
     {
-        LOG_ERROR_AND_THROW("ktx2.0 is not currently supported");
+        LoadFromKTX2(TexLoadInfo, pData, DataSize);
+    }
+}
+
+
+// KTX 2.0 header that follows the file identifier.
+// The 64-bit supercompression global data offset and size are not used.
+struct KTX20Header
+{
+    std::uint32_t VkFormat;
+    std::uint32_t TypeSize;
+    std::uint32_t PixelWidth;
+    std::uint32_t PixelHeight;
+    std::uint32_t PixelDepth;
+    std::uint32_t LayerCount;
+    std::uint32_t FaceCount;
+    std::uint32_t LevelCount;
+    std::uint32_t SupercompressionScheme;
+
+    std::uint32_t DFDByteOffset;
+    std::uint32_t DFDByteLength;
+    std::uint32_t KVDByteOffset;
+    std::uint32_t KVDByteLength;
+};
+static_assert(sizeof(KTX20Header) == 52, "Unexpected KTX20Header size");
+
+struct KTX20LevelIndex
+{
+    std::uint64_t ByteOffset;
+    std::uint64_t ByteLength;
+    std::uint64_t UncompressedByteLength;
+};
+static_assert(sizeof(KTX20LevelIndex) == 24, "Unexpected KTX20LevelIndex size");
+
+enum KTX2_SUPERCOMPRESSION : std::uint32_t
+{
+    KTX2_SUPERCOMPRESSION_NONE    = 0,
+    KTX2_SUPERCOMPRESSION_BASISLZ = 1,
+    KTX2_SUPERCOMPRESSION_ZSTD    = 2,
+    KTX2_SUPERCOMPRESSION_ZLIB    = 3
+};
+
+void TextureLoaderImpl::LoadFromKTX2(const TextureLoadInfo& TexLoadInfo, const Uint8* pData, size_t DataSize)
+{
+    DILIGENT_TRACE_ZONE("TextureLoader::LoadFromKTX2");
+
+    static constexpr Uint8 KTX20FileIdentifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+    // Identifier, header, supercompression global data offset and size
+    static constexpr size_t LevelIndexOffset = sizeof(KTX20FileIdentifier) + sizeof(KTX20Header) + sizeof(std::uint64_t) * 2;
+    if (DataSize < LevelIndexOffset || memcmp(pData, KTX20FileIdentifier, sizeof(KTX20FileIdentifier)) != 0)
+        LOG_ERROR_AND_THROW("The data is not a valid KTX file");
+
+    // The data may not be aligned, so copy the header
+    KTX20Header Header;
+    memcpy(&Header, pData + sizeof(KTX20FileIdentifier), sizeof(Header));
+
+    if (Header.SupercompressionScheme == KTX2_SUPERCOMPRESSION_BASISLZ || Header.VkFormat == VK_FORMAT_UNDEFINED)
+    {
+        // BasisLZ and UASTC textures use the undefined format and must be transcoded to a GPU-native format
+        LOG_ERROR_AND_THROW("Basis Universal KTX2 textures are not supported as the Basis transcoder is not available");
+    }
+    if (Header.SupercompressionScheme == KTX2_SUPERCOMPRESSION_ZSTD)
+        LOG_ERROR_AND_THROW("Zstandard supercompression of KTX2 textures is not supported");
+    if (Header.SupercompressionScheme != KTX2_SUPERCOMPRESSION_NONE && Header.SupercompressionScheme != KTX2_SUPERCOMPRESSION_ZLIB)
+        LOG_ERROR_AND_THROW("Unknown KTX2 supercompression scheme (", Header.SupercompressionScheme, ")");
+
+    m_TexDesc.Format = VkFormatToDiligentTextureFormat(Header.VkFormat);
+    if (m_TexDesc.Format == TEX_FORMAT_UNKNOWN)
+        LOG_ERROR_AND_THROW("Failed to find appropriate Diligent format for Vulkan format ", Header.VkFormat);
+
+    m_TexDesc.Width = Header.PixelWidth;
+    if (m_TexDesc.Width == 0)
+        LOG_ERROR_AND_THROW("Texture width is zero");
+
+    m_TexDesc.Height = std::max(Header.PixelHeight, 1u);
+
+    // Zero level count means that the mip levels should be generated by the application
+    const auto SrcMipLevels = std::max(Header.LevelCount, 1u);
+    m_TexDesc.MipLevels     = SrcMipLevels;
+    if (TexLoadInfo.MipLevels > 0)
+        m_TexDesc.MipLevels = std::min(m_TexDesc.MipLevels, TexLoadInfo.MipLevels);
+
+    const auto NumFaces  = std::max(Header.FaceCount, 1u);
+    const auto ArraySize = std::max(Header.LayerCount, 1u) * NumFaces;
+    if (NumFaces == 1)
+    {
+        if (Header.PixelDepth > 1)
+        {
+            if (Header.LayerCount > 1)
+                LOG_ERROR_AND_THROW("3D texture arrays are not supported");
+
+            m_TexDesc.Type  = RESOURCE_DIM_TEX_3D;
+            m_TexDesc.Depth = Header.PixelDepth;
+        }
+        else
+        {
+            m_TexDesc.Type      = ArraySize > 1 ? RESOURCE_DIM_TEX_2D_ARRAY : RESOURCE_DIM_TEX_2D;
+            m_TexDesc.ArraySize = ArraySize;
+        }
+    }
+    else if (NumFaces == 6)
+    {
+        m_TexDesc.Type      = ArraySize > 6 ? RESOURCE_DIM_TEX_CUBE_ARRAY : RESOURCE_DIM_TEX_CUBE;
+        m_TexDesc.ArraySize = ArraySize;
+    }
+    else
+    {
+        LOG_ERROR_AND_THROW("Unsupported number of faces (", NumFaces, ")");
+    }
+
+    if (LevelIndexOffset + size_t{SrcMipLevels} * sizeof(KTX20LevelIndex) > DataSize)
+        LOG_ERROR_AND_THROW("KTX2 level index is out of bounds");
+
+    const bool IsZlibCompressed = Header.SupercompressionScheme == KTX2_SUPERCOMPRESSION_ZLIB;
+    if (IsZlibCompressed)
+        m_Mips = CreateMips(m_TexDesc.MipLevels);
+
+    m_SubResources.resize(size_t{m_TexDesc.MipLevels} * size_t{ArraySize});
+
+    // Unlike KTX1, rows and images are tightly packed, and the level index starts with the most detailed level.
+    // Within a level, images are arranged by layers, then by faces, then by depth slices.
+    for (Uint32 mip = 0; mip < m_TexDesc.MipLevels; ++mip)
+    {
+        KTX20LevelIndex Level;
+        memcpy(&Level, pData + LevelIndexOffset + mip * sizeof(KTX20LevelIndex), sizeof(Level));
+        if (Level.ByteOffset > DataSize || Level.ByteLength > DataSize - Level.ByteOffset)
+            LOG_ERROR_AND_THROW("Data of mip level ", mip, " is out of bounds");
+
+        const Uint8* pLevelData = pData + Level.ByteOffset;
+        Uint64       LevelSize  = Level.ByteLength;
+        if (IsZlibCompressed)
+        {
+            auto& Mip = m_Mips[mip];
+            Mip.resize(StaticCast<size_t>(Level.UncompressedByteLength));
+
+            uLongf DstSize = static_cast<uLongf>(Mip.size());
+            if (uncompress(Mip.data(), &DstSize, pLevelData, static_cast<uLong>(Level.ByteLength)) != Z_OK || DstSize != Mip.size())
+                LOG_ERROR_AND_THROW("Failed to decompress mip level ", mip);
+
+            pLevelData = Mip.data();
+            LevelSize  = Mip.size();
+        }
+
+        const auto MipInfo = GetMipLevelProperties(m_TexDesc, mip);
+        if (MipInfo.MipSize * ArraySize > LevelSize)
+            LOG_ERROR_AND_THROW("Data of mip level ", mip, " is too small");
+
+        for (Uint32 slice = 0; slice < ArraySize; ++slice)
+        {
+            m_SubResources[mip + size_t{slice} * size_t{m_TexDesc.MipLevels}] =
+                TextureSubResData{pLevelData + MipInfo.MipSize * slice, MipInfo.RowSize, MipInfo.DepthSliceSize};
+        }
+    }
+}
+
+namespace
+{
+
+std::uint32_t DiligentTextureFormatToVkFormat(TEXTURE_FORMAT Format)
+{
+    static const auto FmtMap = []() {
+        std::vector<std::uint32_t> Map(TEX_FORMAT_NUM_FORMATS, VK_FORMAT_UNDEFINED);
+        for (std::uint32_t VkFmt = VK_FORMAT_UNDEFINED + 1; VkFmt <= VK_FORMAT_BC7_SRGB_BLOCK; ++VkFmt)
+        {
+            const auto TexFmt = VkFormatToDiligentTextureFormat(VkFmt);
+            if (TexFmt != TEX_FORMAT_UNKNOWN)
+                Map[TexFmt] = VkFmt;
+        }
+        return Map;
+    }();
+    return Format < FmtMap.size() ? FmtMap[Format] : VK_FORMAT_UNDEFINED;
+}
+
+// Khronos Data Format Specification values used by the basic data format descriptor
+enum KHR_DF : std::uint32_t
+{
+    KHR_DF_VERSIONNUMBER_1_3 = 2,
+
+    KHR_DF_MODEL_RGBSDA = 1,
+    KHR_DF_MODEL_BC1A   = 128,
+    KHR_DF_MODEL_BC2    = 129,
+    KHR_DF_MODEL_BC3    = 130,
+    KHR_DF_MODEL_BC4    = 131,
+    KHR_DF_MODEL_BC5    = 132,
+    KHR_DF_MODEL_BC6H   = 133,
+    KHR_DF_MODEL_BC7    = 134,
+
+    KHR_DF_PRIMARIES_BT709 = 1,
+
+    KHR_DF_TRANSFER_LINEAR = 1,
+    KHR_DF_TRANSFER_SRGB   = 2,
+
+    KHR_DF_CHANNEL_RED   = 0,
+    KHR_DF_CHANNEL_GREEN = 1,
+    KHR_DF_CHANNEL_BLUE  = 2,
+    KHR_DF_CHANNEL_ALPHA = 15,
+
+    KHR_DF_SAMPLE_LINEAR = 0x10,
+    KHR_DF_SAMPLE_SIGNED = 0x40,
+    KHR_DF_SAMPLE_FLOAT  = 0x80,
+};
+
+struct KTX2DFDSample
+{
+    std::uint32_t BitOffset;
+    std::uint32_t BitLength;
+    std::uint32_t ChannelType; // Channel and qualifiers
+    std::uint32_t Lower;
+    std::uint32_t Upper;
+};
+
+// Writes the basic data format descriptor block (KDFS 1.3, section 5) that every KTX2 file must contain.
+// Returns false for packed, depth-stencil and other formats that the descriptor is not generated for.
+bool CreateKTX2DataFormatDescriptor(TEXTURE_FORMAT Format, std::vector<std::uint32_t>& DFD)
+{
+    const auto& FmtAttribs = GetTextureFormatAttribs(Format);
+
+    std::uint32_t              ColorModel = KHR_DF_MODEL_RGBSDA;
+    std::uint32_t              BlockDim   = 0;
+    std::uint32_t              BytesPlane = 0;
+    std::vector<KTX2DFDSample> Samples;
+    if (FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED)
+    {
+        // For compressed formats, the component size is the size of the block
+        const std::uint32_t BlockBits = FmtAttribs.ComponentSize * 8u;
+
+        std::uint32_t Qualifiers = 0;
+        std::uint32_t Lower      = 0;
+        std::uint32_t Upper      = 0xFFFFFFFFu;
+        switch (Format)
+        {
+            // clang-format off
+            case TEX_FORMAT_BC1_UNORM: case TEX_FORMAT_BC1_UNORM_SRGB: ColorModel = KHR_DF_MODEL_BC1A; break;
+            case TEX_FORMAT_BC2_UNORM: case TEX_FORMAT_BC2_UNORM_SRGB: ColorModel = KHR_DF_MODEL_BC2;  break;
+            case TEX_FORMAT_BC3_UNORM: case TEX_FORMAT_BC3_UNORM_SRGB: ColorModel = KHR_DF_MODEL_BC3;  break;
+            case TEX_FORMAT_BC4_UNORM: case TEX_FORMAT_BC4_SNORM:      ColorModel = KHR_DF_MODEL_BC4;  break;
+            case TEX_FORMAT_BC5_UNORM: case TEX_FORMAT_BC5_SNORM:      ColorModel = KHR_DF_MODEL_BC5;  break;
+            case TEX_FORMAT_BC6H_UF16: case TEX_FORMAT_BC6H_SF16:      ColorModel = KHR_DF_MODEL_BC6H; break;
+            case TEX_FORMAT_BC7_UNORM: case TEX_FORMAT_BC7_UNORM_SRGB: ColorModel = KHR_DF_MODEL_BC7;  break;
+            // clang-format on
+            default:
+                return false;
+        }
+        if (Format == TEX_FORMAT_BC4_SNORM || Format == TEX_FORMAT_BC5_SNORM)
+        {
+            Qualifiers = KHR_DF_SAMPLE_SIGNED;
+            Lower      = 0x80000000u;
+            Upper      = 0x7FFFFFFFu;
+        }
+        else if (ColorModel == KHR_DF_MODEL_BC6H)
+        {
+            Qualifiers = KHR_DF_SAMPLE_FLOAT | (Format == TEX_FORMAT_BC6H_SF16 ? KHR_DF_SAMPLE_SIGNED : 0u);
+            Lower      = Format == TEX_FORMAT_BC6H_SF16 ? 0xBF800000u : 0u; // -1.0f
+            Upper      = 0x3F800000u;                                        // 1.0f
+        }
+
+        BlockDim   = (FmtAttribs.BlockWidth - 1u) | ((FmtAttribs.BlockHeight - 1u) << 8u);
+        BytesPlane = FmtAttribs.ComponentSize;
+        if (ColorModel == KHR_DF_MODEL_BC2 || ColorModel == KHR_DF_MODEL_BC3)
+        {
+            Samples.push_back({0, 64, KHR_DF_CHANNEL_ALPHA, Lower, Upper});
+            Samples.push_back({64, 64, KHR_DF_CHANNEL_RED, Lower, Upper});
+        }
+        else if (ColorModel == KHR_DF_MODEL_BC5)
+        {
+            Samples.push_back({0, 64, KHR_DF_CHANNEL_RED | Qualifiers, Lower, Upper});
+            Samples.push_back({64, 64, KHR_DF_CHANNEL_GREEN | Qualifiers, Lower, Upper});
+        }
+        else
+        {
+            Samples.push_back({0, BlockBits, KHR_DF_CHANNEL_RED | Qualifiers, Lower, Upper});
+        }
+    }
+    else
+    {
+        const std::uint32_t ComponentBits = FmtAttribs.ComponentSize * 8u;
+
+        std::uint32_t Qualifiers = 0;
+        std::uint32_t Lower      = 0;
+        std::uint32_t Upper      = 0;
+        switch (FmtAttribs.ComponentType)
+        {
+            case COMPONENT_TYPE_UNORM:
+            case COMPONENT_TYPE_UNORM_SRGB:
+                Upper = ComponentBits < 32 ? (1u << ComponentBits) - 1u : 0xFFFFFFFFu;
+                break;
+
+            case COMPONENT_TYPE_SNORM:
+                Qualifiers = KHR_DF_SAMPLE_SIGNED;
+                Upper      = (1u << (ComponentBits - 1u)) - 1u;
+                Lower      = ~Upper + 1u; // -Upper
+                break;
+
+            case COMPONENT_TYPE_UINT:
+                Upper = 1;
+                break;
+
+            case COMPONENT_TYPE_SINT:
+                Qualifiers = KHR_DF_SAMPLE_SIGNED;
+                Lower      = 0xFFFFFFFFu; // -1
+                Upper      = 1;
+                break;
+
+            case COMPONENT_TYPE_FLOAT:
+                Qualifiers = KHR_DF_SAMPLE_FLOAT | KHR_DF_SAMPLE_SIGNED;
+                Lower      = 0xBF800000u; // -1.0f
+                Upper      = 0x3F800000u; // 1.0f
+                break;
+
+            default:
+                return false;
+        }
+
+        const bool IsBGRA = Format == TEX_FORMAT_BGRA8_UNORM || Format == TEX_FORMAT_BGRA8_UNORM_SRGB;
+
+        static constexpr std::uint32_t RGBAChannels[] = {KHR_DF_CHANNEL_RED, KHR_DF_CHANNEL_GREEN, KHR_DF_CHANNEL_BLUE, KHR_DF_CHANNEL_ALPHA};
+        static constexpr std::uint32_t BGRAChannels[] = {KHR_DF_CHANNEL_BLUE, KHR_DF_CHANNEL_GREEN, KHR_DF_CHANNEL_RED, KHR_DF_CHANNEL_ALPHA};
+        for (std::uint32_t c = 0; c < FmtAttribs.NumComponents; ++c)
+        {
+            auto Channel = (IsBGRA ? BGRAChannels : RGBAChannels)[c] | Qualifiers;
+            // Alpha of sRGB formats is linear
+            if (FmtAttribs.ComponentType == COMPONENT_TYPE_UNORM_SRGB && c == 3)
+                Channel |= KHR_DF_SAMPLE_LINEAR;
+            Samples.push_back({c * ComponentBits, ComponentBits, Channel, Lower, Upper});
+        }
+        BytesPlane = std::uint32_t{FmtAttribs.ComponentSize} * std::uint32_t{FmtAttribs.NumComponents};
+    }
+
+    const bool IsSRGB = (FmtAttribs.ComponentType == COMPONENT_TYPE_UNORM_SRGB ||
+                         Format == TEX_FORMAT_BC1_UNORM_SRGB || Format == TEX_FORMAT_BC2_UNORM_SRGB ||
+                         Format == TEX_FORMAT_BC3_UNORM_SRGB || Format == TEX_FORMAT_BC7_UNORM_SRGB);
+
+    const std::uint32_t Transfer  = IsSRGB ? KHR_DF_TRANSFER_SRGB : KHR_DF_TRANSFER_LINEAR;
+    const std::uint32_t BlockSize = 24 + 16 * static_cast<std::uint32_t>(Samples.size());
+
+    DFD.clear();
+    DFD.push_back(4 + BlockSize); // dfdTotalSize
+    DFD.push_back(0);             // vendorId = KHRONOS, descriptorType = BASICFORMAT
+    DFD.push_back(KHR_DF_VERSIONNUMBER_1_3 | (BlockSize << 16u));
+    DFD.push_back(ColorModel | (KHR_DF_PRIMARIES_BT709 << 8u) | (Transfer << 16u));
+    DFD.push_back(BlockDim);
+    DFD.push_back(BytesPlane);
+    DFD.push_back(0);
+    for (const auto& Sample : Samples)
+    {
+        DFD.push_back(Sample.BitOffset | ((Sample.BitLength - 1u) << 16u) | (Sample.ChannelType << 24u));
+        DFD.push_back(0); // Sample position
+        DFD.push_back(Sample.Lower);
+        DFD.push_back(Sample.Upper);
     }
+    return true;
+}
+
+} // namespace
+
+Uint32 GetKTX2LevelAlignment(TEXTURE_FORMAT Format)
+{
+    const auto& FmtAttribs = GetTextureFormatAttribs(Format);
+
+    // Least common multiple of the texel block size and 4
+    Uint32 BlockSize = FmtAttribs.ComponentSize;
+    if (FmtAttribs.ComponentType != COMPONENT_TYPE_COMPRESSED)
+        BlockSize *= FmtAttribs.NumComponents;
+    return BlockSize % 4 == 0 ? BlockSize : (BlockSize % 2 == 0 ? BlockSize * 2 : BlockSize * 4);
+}
+
+bool CreateKTX2FileHeader(const TextureDesc& Desc, bool IsZlibCompressed, const Uint64* pLevelOffsets, const Uint64* pLevelSizes, std::vector<Uint8>& Header)
+{
+    static constexpr Uint8 KTX20FileIdentifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+    const auto& FmtAttribs = GetTextureFormatAttribs(Desc.Format);
+    const auto  VkFormat   = DiligentTextureFormatToVkFormat(Desc.Format);
+
+    std::vector<std::uint32_t> DFD;
+    if (VkFormat == VK_FORMAT_UNDEFINED || !CreateKTX2DataFormatDescriptor(Desc.Format, DFD))
+    {
+        LOG_ERROR_MESSAGE("Texture format ", FmtAttribs.Name, " can't be stored in a KTX2 file");
+        return false;
+    }
+
+    KTX20Header KTXHeader{};
+    KTXHeader.VkFormat    = VkFormat;
+    KTXHeader.TypeSize    = FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED ? 1 : FmtAttribs.ComponentSize;
+    KTXHeader.PixelWidth  = Desc.Width;
+    KTXHeader.PixelHeight = Desc.Is1D() ? 0 : Desc.Height;
+    KTXHeader.PixelDepth  = Desc.Is3D() ? Desc.Depth : 0;
+    KTXHeader.FaceCount   = Desc.IsCube() ? 6 : 1;
+    KTXHeader.LayerCount  = Desc.IsArray() ? Desc.ArraySize / KTXHeader.FaceCount : 0;
+    KTXHeader.LevelCount  = Desc.MipLevels;
+
+    KTXHeader.SupercompressionScheme = IsZlibCompressed ? KTX2_SUPERCOMPRESSION_ZLIB : KTX2_SUPERCOMPRESSION_NONE;
+
+    // Identifier, header, supercompression global data offset and size, level index
+    const size_t LevelIndexOffset = sizeof(KTX20FileIdentifier) + sizeof(KTX20Header) + sizeof(std::uint64_t) * 2;
+    const size_t DFDOffset        = LevelIndexOffset + size_t{Desc.MipLevels} * sizeof(KTX20LevelIndex);
+
+    KTXHeader.DFDByteOffset = static_cast<std::uint32_t>(DFDOffset);
+    KTXHeader.DFDByteLength = static_cast<std::uint32_t>(DFD.size() * sizeof(std::uint32_t));
+
+    Header.assign(DFDOffset + KTXHeader.DFDByteLength, 0);
+    memcpy(Header.data(), KTX20FileIdentifier, sizeof(KTX20FileIdentifier));
+    memcpy(Header.data() + sizeof(KTX20FileIdentifier), &KTXHeader, sizeof(KTXHeader));
+    for (Uint32 mip = 0; mip < Desc.MipLevels; ++mip)
+    {
+        KTX20LevelIndex Level{};
+        Level.ByteOffset             = pLevelOffsets[mip];
+        Level.ByteLength             = pLevelSizes[mip];
+        Level.UncompressedByteLength = GetMipLevelProperties(Desc, mip).MipSize * Desc.GetArraySize();
+        memcpy(Header.data() + LevelIndexOffset + mip * sizeof(KTX20LevelIndex), &Level, sizeof(Level));
+    }
+    memcpy(Header.data() + DFDOffset, DFD.data(), KTXHeader.DFDByteLength);
+
+    return true;
+}
+
+bool ReadKTXHeader(const Uint8* pData, size_t DataSize, ImageProbeInfo& Info)
+{
+    static constexpr Uint8 KTX10FileIdentifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+    static constexpr Uint8 KTX20FileIdentifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+    Uint32 Width     = 0;
+    Uint32 Height    = 0;
+    Uint32 Depth     = 0;
+    Uint32 NumLayers = 0;
+    Uint32 NumFaces  = 0;
+    Uint32 NumMips   = 0;
+    if (DataSize >= sizeof(KTX10FileIdentifier) + sizeof(KTX10Header) &&
+        memcmp(pData, KTX10FileIdentifier, sizeof(KTX10FileIdentifier)) == 0)
+    {
+        // The data may not be aligned, so copy the header
+        KTX10Header Header;
+        memcpy(&Header, pData + sizeof(KTX10FileIdentifier), sizeof(Header));
+
+        Info.Format = FindDiligentTextureFormat(Header.GLInternalFormat);
+        Width       = Header.Width;
+        Height      = Header.Height;
+        Depth       = Header.Depth;
+        NumLayers   = Header.NumberOfArrayElements;
+        NumFaces    = Header.NumberOfFaces;
+        NumMips     = Header.NumberOfMipmapLevels;
+    }
+    else if (DataSize >= sizeof(KTX20FileIdentifier) + sizeof(KTX20Header) &&
+             memcmp(pData, KTX20FileIdentifier, sizeof(KTX20FileIdentifier)) == 0)
+    {
+        KTX20Header Header;
+        memcpy(&Header, pData + sizeof(KTX20FileIdentifier), sizeof(Header));
+
+        // Basis Universal textures use the undefined format, which results in TEX_FORMAT_UNKNOWN
+        Info.Format = VkFormatToDiligentTextureFormat(Header.VkFormat);
+        Width       = Header.PixelWidth;
+        Height      = Header.PixelHeight;
+        Depth       = Header.PixelDepth;
+        NumLayers   = Header.LayerCount;
+        NumFaces    = Header.FaceCount;
+        NumMips     = Header.LevelCount;
+    }
+    else
+    {
+        return false;
+    }
+
+    NumFaces = std::max(NumFaces, 1u);
+    if (Width == 0 || (NumFaces != 1 && NumFaces != 6))
+        return false;
+
+    Info.FileFormat = IMAGE_FILE_FORMAT_KTX;
+    Info.Width      = Width;
+    Info.Height     = std::max(Height, 1u);
+    Info.MipLevels  = std::max(NumMips, 1u);
+    Info.Depth      = 1;
+    Info.ArraySize  = std::max(NumLayers, 1u) * NumFaces;
+    if (NumFaces == 6)
+    {
+        Info.Type = Info.ArraySize > 6 ? RESOURCE_DIM_TEX_CUBE_ARRAY : RESOURCE_DIM_TEX_CUBE;
+    }
+    else if (Depth > 1)
+    {
+        Info.Type      = RESOURCE_DIM_TEX_3D;
+        Info.Depth     = Depth;
+        Info.ArraySize = 1;
+    }
+    else
+    {
+        Info.Type = Info.ArraySize > 1 ? RESOURCE_DIM_TEX_2D_ARRAY : RESOURCE_DIM_TEX_2D;
+    }
+
+    return true;
 }
 
 } // namespace Diligent
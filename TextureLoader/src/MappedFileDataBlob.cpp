@@ -0,0 +1,132 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include "MappedFileDataBlob.hpp"
+
+#if PLATFORM_WIN32
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <Windows.h>
+#elif PLATFORM_LINUX || PLATFORM_MACOS || PLATFORM_ANDROID || PLATFORM_IOS || PLATFORM_TVOS
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    define DILIGENT_USE_POSIX_MMAP 1
+#endif
+
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+RefCntAutoPtr<IDataBlob> MappedFileDataBlob::Create(const char* FilePath)
+{
+    VERIFY_EXPR(FilePath != nullptr);
+
+#if PLATFORM_WIN32
+    HANDLE hFile = CreateFileA(FilePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE)
+        return {};
+
+    LARGE_INTEGER FileSize{};
+    if (!GetFileSizeEx(hFile, &FileSize) || FileSize.QuadPart == 0 || static_cast<Uint64>(FileSize.QuadPart) > SIZE_MAX)
+    {
+        CloseHandle(hFile);
+        return {};
+    }
+
+    // The mapping object keeps a reference to the file, so the file handle can be closed right away
+    HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(hFile);
+    if (hMapping == nullptr)
+        return {};
+
+    void* pData = MapViewOfFile(hMapping, FILE_MAP_COPY, 0, 0, 0);
+    if (pData == nullptr)
+    {
+        CloseHandle(hMapping);
+        return {};
+    }
+
+    return RefCntAutoPtr<IDataBlob>{MakeNewRCObj<MappedFileDataBlob>()(pData, static_cast<size_t>(FileSize.QuadPart), hMapping)};
+#elif DILIGENT_USE_POSIX_MMAP
+    const int fd = open(FilePath, O_RDONLY);
+    if (fd < 0)
+        return {};
+
+    struct stat FileStat;
+    if (fstat(fd, &FileStat) != 0 || FileStat.st_size <= 0)
+    {
+        close(fd);
+        return {};
+    }
+
+    const auto Size  = static_cast<size_t>(FileStat.st_size);
+    void*      pData = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // The mapping keeps a reference to the file, so the descriptor can be closed right away
+    close(fd);
+    if (pData == MAP_FAILED)
+        return {};
+
+    // Texture data is typically read once front to back when it is uploaded to the GPU
+    madvise(pData, Size, MADV_SEQUENTIAL);
+
+    return RefCntAutoPtr<IDataBlob>{MakeNewRCObj<MappedFileDataBlob>()(pData, Size, nullptr)};
+#else
+    return {};
+#endif
+}
+
+MappedFileDataBlob::MappedFileDataBlob(IReferenceCounters* pRefCounters, void* pData, size_t Size, void* hMapping) :
+    TBase{pRefCounters},
+    m_pData{pData},
+    m_Size{Size},
+    m_hMapping{hMapping}
+{
+}
+
+MappedFileDataBlob::~MappedFileDataBlob()
+{
+#if PLATFORM_WIN32
+    UnmapViewOfFile(m_pData);
+    CloseHandle(m_hMapping);
+#elif DILIGENT_USE_POSIX_MMAP
+    munmap(m_pData, m_Size);
+#endif
+}
+
+void MappedFileDataBlob::Resize(size_t NewSize)
+{
+    UNSUPPORTED("Memory-mapped file blobs can't be resized");
+}
+
+} // namespace Diligent
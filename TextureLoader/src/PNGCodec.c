@@ -48,13 +48,42 @@ static void PngReadCallback(png_structp pngPtr, png_bytep data, png_size_t lengt
     pState->Offset += length;
 }
 
-DECODE_PNG_RESULT Diligent_DecodePng(IDataBlob* pSrcPngBits,
-                                     IDataBlob* pDstPixels,
-                                     ImageDesc* pDstImgDesc)
+// Copies the row changing the number of components the same way as CopyPixels does:
+// for single-channel sources r is propagated to g and b, and missing alpha is set to 1.0.
+static void PngConvertRow(const png_byte* pSrc, png_byte* pDst, Uint32 Width, Uint32 SrcCompCount, Uint32 DstCompCount, Uint32 CompSize)
 {
-    if (!pSrcPngBits || !pDstPixels || !pDstImgDesc)
-        return DECODE_PNG_RESULT_INVALID_ARGUMENTS;
+    Uint32 x, c;
+    for (x = 0; x < Width; ++x)
+    {
+        const png_byte* pSrcTexel = pSrc + (size_t)x * SrcCompCount * CompSize;
+        png_byte*       pDstTexel = pDst + (size_t)x * DstCompCount * CompSize;
+        for (c = 0; c < DstCompCount; ++c)
+        {
+            png_byte* pDstComp = pDstTexel + c * CompSize;
+            if (c < SrcCompCount)
+                memcpy(pDstComp, pSrcTexel + c * CompSize, CompSize);
+            else if (c < 3)
+            {
+                if (SrcCompCount == 1)
+                    memcpy(pDstComp, pSrcTexel, CompSize);
+                else
+                    memset(pDstComp, 0, CompSize);
+            }
+            else
+                memset(pDstComp, 0xFF, CompSize);
+        }
+    }
+}
 
+// Decodes the image either into the data blob (pDstBlob != NULL) or into the caller-provided memory.
+// If both are null, only the image description is read.
+static DECODE_PNG_RESULT DecodePngImpl(IDataBlob* pSrcPngBits,
+                                       IDataBlob* pDstBlob,
+                                       void*      pDstPixels,
+                                       Uint32     DstStride,
+                                       Uint32     DstCompCount,
+                                       ImageDesc* pDstImgDesc)
+{
     // http://www.piko3d.net/tutorials/libpng-tutorial-loading-png-files-from-streams/
     // http://www.libpng.org/pub/png/book/chapter13.html#png.ch13.div.10
     // https://gist.github.com/niw/5963798
@@ -80,11 +109,14 @@ DECODE_PNG_RESULT Diligent_DecodePng(IDataBlob* pSrcPngBits,
         return DECODE_PNG_RESULT_INITIALIZATION_FAILED;
     }
 
-    png_bytep* rowPtrs = NULL;
+    png_bytep* rowPtrs   = NULL;
+    png_bytep  pTmpImage = NULL;
     if (setjmp(png_jmpbuf(png)))
     {
         if (rowPtrs)
             free(rowPtrs);
+        if (pTmpImage)
+            free(pTmpImage);
         // When an error occurs during parsing, libPNG will jump to here
         png_destroy_read_struct(&png, &info, (png_infopp)0);
         return DECODE_PNG_RESULT_DECODING_ERROR;
@@ -138,6 +170,8 @@ DECODE_PNG_RESULT Diligent_DecodePng(IDataBlob* pSrcPngBits,
         png_set_gray_to_rgb( png );
 #endif
 
+    const int NumPasses = png_set_interlace_handling(png);
+
     png_read_update_info(png, info);
 
     bit_depth                  = png_get_bit_depth(png, info);
@@ -156,29 +190,105 @@ DECODE_PNG_RESULT Diligent_DecodePng(IDataBlob* pSrcPngBits,
         }
     }
 
-    //Array of row pointers. One for every row.
-    rowPtrs = malloc(sizeof(png_bytep) * pDstImgDesc->Height);
-
-    //Allocate a buffer with enough space.
-    pDstImgDesc->RowStride = pDstImgDesc->Width * (Uint32)bit_depth * pDstImgDesc->NumComponents / 8u;
+    const Uint32 CompSize     = (Uint32)bit_depth / 8u;
+    const Uint32 SrcCompCount = pDstImgDesc->NumComponents;
+    const Uint32 SrcRowSize   = pDstImgDesc->Width * CompSize * SrcCompCount;
     // Align stride to 4 bytes
-    pDstImgDesc->RowStride = (pDstImgDesc->RowStride + 3u) & ~3u;
+    pDstImgDesc->RowStride = (SrcRowSize + 3u) & ~3u;
 
-    IDataBlob_Resize(pDstPixels, pDstImgDesc->Height * (size_t)pDstImgDesc->RowStride);
-    png_bytep pRow0 = IDataBlob_GetDataPtr(pDstPixels);
-    for (size_t i = 0; i < pDstImgDesc->Height; i++)
-        rowPtrs[i] = pRow0 + i * pDstImgDesc->RowStride;
+    if (pDstBlob != NULL)
+    {
+        //Allocate a buffer with enough space.
+        IDataBlob_Resize(pDstBlob, pDstImgDesc->Height * (size_t)pDstImgDesc->RowStride);
+        pDstPixels   = IDataBlob_GetDataPtr(pDstBlob);
+        DstStride    = pDstImgDesc->RowStride;
+        DstCompCount = SrcCompCount;
+    }
+    else if (pDstPixels == NULL)
+    {
+        // Only the image description was requested
+        png_destroy_read_struct(&png, &info, (png_infopp)0);
+        return DECODE_PNG_RESULT_OK;
+    }
 
-    //Read the imagedata and write it to the addresses pointed to
-    //by rowptrs (in other words: our image databuffer)
-    png_read_image(png, rowPtrs);
+    if (DstCompCount == 0)
+        DstCompCount = SrcCompCount;
+    if (DstCompCount > 4 || DstStride < pDstImgDesc->Width * CompSize * DstCompCount)
+    {
+        png_destroy_read_struct(&png, &info, (png_infopp)0);
+        return DECODE_PNG_RESULT_INVALID_ARGUMENTS;
+    }
 
-    free(rowPtrs);
+    if (DstCompCount == SrcCompCount)
+    {
+        //Array of row pointers. One for every row.
+        size_t i;
+        rowPtrs = malloc(sizeof(png_bytep) * pDstImgDesc->Height);
+        for (i = 0; i < pDstImgDesc->Height; i++)
+            rowPtrs[i] = (png_bytep)pDstPixels + i * DstStride;
+
+        //Read the imagedata and write it to the addresses pointed to
+        //by rowptrs (in other words: our image databuffer)
+        png_read_image(png, rowPtrs);
+    }
+    else if (NumPasses == 1)
+    {
+        // Decode rows one by one into the temporary row and convert them into the destination
+        Uint32 row;
+        pTmpImage = malloc(SrcRowSize);
+        for (row = 0; row < pDstImgDesc->Height; ++row)
+        {
+            png_read_row(png, pTmpImage, NULL);
+            PngConvertRow(pTmpImage, (png_bytep)pDstPixels + (size_t)row * DstStride, pDstImgDesc->Width, SrcCompCount, DstCompCount, CompSize);
+        }
+    }
+    else
+    {
+        // Interlaced images need the whole image to be decoded before the rows can be converted
+        size_t i;
+        pTmpImage = malloc((size_t)SrcRowSize * pDstImgDesc->Height);
+        rowPtrs   = malloc(sizeof(png_bytep) * pDstImgDesc->Height);
+        for (i = 0; i < pDstImgDesc->Height; i++)
+            rowPtrs[i] = pTmpImage + i * SrcRowSize;
+        png_read_image(png, rowPtrs);
+        for (i = 0; i < pDstImgDesc->Height; i++)
+            PngConvertRow(rowPtrs[i], (png_bytep)pDstPixels + i * DstStride, pDstImgDesc->Width, SrcCompCount, DstCompCount, CompSize);
+    }
+
+    pDstImgDesc->NumComponents = DstCompCount;
+    pDstImgDesc->RowStride     = DstStride;
+
+    if (rowPtrs)
+        free(rowPtrs);
+    if (pTmpImage)
+        free(pTmpImage);
     png_destroy_read_struct(&png, &info, (png_infopp)0);
 
     return DECODE_PNG_RESULT_OK;
 }
 
+DECODE_PNG_RESULT Diligent_DecodePng(IDataBlob* pSrcPngBits,
+                                     IDataBlob* pDstPixels,
+                                     ImageDesc* pDstImgDesc)
+{
+    if (!pSrcPngBits || !pDstPixels || !pDstImgDesc)
+        return DECODE_PNG_RESULT_INVALID_ARGUMENTS;
+
+    return DecodePngImpl(pSrcPngBits, pDstPixels, NULL, 0, 0, pDstImgDesc);
+}
+
+DECODE_PNG_RESULT Diligent_DecodePngIntoMemory(IDataBlob* pSrcPngBits,
+                                               void*      pDstPixels,
+                                               Uint32     DstStride,
+                                               Uint32     DstCompCount,
+                                               ImageDesc* pDstImgDesc)
+{
+    if (!pSrcPngBits || !pDstImgDesc)
+        return DECODE_PNG_RESULT_INVALID_ARGUMENTS;
+
+    return DecodePngImpl(pSrcPngBits, NULL, pDstPixels, DstStride, DstCompCount, pDstImgDesc);
+}
+
 static void PngWriteCallback(png_structp png_ptr, png_bytep data, png_size_t length)
 {
     IDataBlob* pEncodedData = (IDataBlob*)png_get_io_ptr(png_ptr);
@@ -188,16 +298,21 @@ static void PngWriteCallback(png_structp png_ptr, png_bytep data, png_size_t len
     memcpy(pBytes + PrevSize, data, length);
 }
 
-ENCODE_PNG_RESULT Diligent_EncodePng(const Uint8* pSrcPixels,
-                                     Uint32       Width,
-                                     Uint32       Height,
-                                     Uint32       StrideInBytes,
-                                     int          PngColorType,
-                                     IDataBlob*   pDstPngBits)
+ENCODE_PNG_RESULT Diligent_EncodePng(const Uint8*            pSrcPixels,
+                                     Uint32                  Width,
+                                     Uint32                  Height,
+                                     Uint32                  StrideInBytes,
+                                     int                     PngColorType,
+                                     IDataBlob*              pDstPngBits,
+                                     const PngEncodeOptions* pOptions)
 {
     if (!pSrcPixels || !pDstPngBits || Width == 0 || Height == 0 || StrideInBytes == 0)
         return ENCODE_PNG_RESULT_INVALID_ARGUMENTS;
 
+    if (pOptions != NULL && (pOptions->CompressionLevel < -1 || pOptions->CompressionLevel > 9 ||
+                             pOptions->Strategy > PNG_ENCODE_STRATEGY_RLE || pOptions->Filter > PNG_ENCODE_FILTER_PAETH))
+        return ENCODE_PNG_RESULT_INVALID_ARGUMENTS;
+
     png_struct* strct = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
     if (!strct)
     {
@@ -226,7 +341,23 @@ ENCODE_PNG_RESULT Diligent_EncodePng(const Uint8* pSrcPixels,
                  PNG_COMPRESSION_TYPE_DEFAULT,
                  PNG_FILTER_TYPE_DEFAULT);
 
-    //png_set_compression_level(p, 1);
+    if (pOptions != NULL)
+    {
+        static const int Filters[] = {
+            PNG_ALL_FILTERS, // PNG_ENCODE_FILTER_ADAPTIVE
+            PNG_FILTER_NONE, // PNG_ENCODE_FILTER_NONE
+            PNG_FILTER_SUB,  // PNG_ENCODE_FILTER_SUB
+            PNG_FILTER_UP,   // PNG_ENCODE_FILTER_UP
+            PNG_FILTER_AVG,  // PNG_ENCODE_FILTER_AVERAGE
+            PNG_FILTER_PAETH // PNG_ENCODE_FILTER_PAETH
+        };
+        if (pOptions->CompressionLevel >= 0)
+            png_set_compression_level(strct, pOptions->CompressionLevel);
+        // PNG_ENCODE_STRATEGY values match zlib strategies
+        png_set_compression_strategy(strct, (int)pOptions->Strategy);
+        png_set_filter(strct, PNG_FILTER_TYPE_BASE, Filters[pOptions->Filter]);
+    }
+
     rowPtrs = malloc(sizeof(png_bytep) * Height);
     for (size_t y = 0; y < Height; ++y)
         rowPtrs[y] = (Uint8*)pSrcPixels + y * StrideInBytes;
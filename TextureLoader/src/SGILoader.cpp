@@ -26,9 +26,14 @@
 
 #include "SGILoader.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include "DataBlob.h"
 #include "PlatformMisc.hpp"
 #include "Errors.hpp"
+#include "ThreadPool.hpp"
 
 namespace Diligent
 {
@@ -56,24 +61,18 @@ static_assert(sizeof(SGIHeader) == 512, "must be 512 bytes");
 } // namespace
 
 // http://paulbourke.net/dataformats/sgirgb/sgiversion.html
-bool LoadSGI(IDataBlob* pSGIData,
-             IDataBlob* pDstPixels,
-             ImageDesc* pDstImgDesc)
+bool ReadSGIHeader(const void* pSGIData,
+                   size_t      DataSize,
+                   ImageDesc*  pDstImgDesc)
 {
-    VERIFY_EXPR(pSGIData != nullptr && pDstPixels != nullptr && pDstImgDesc != nullptr);
-    const auto* pDataStart = reinterpret_cast<const Uint8*>(pSGIData->GetConstDataPtr());
-    const auto  Size       = pSGIData->GetSize();
-    const auto* pDataEnd   = pDataStart + Size;
-    const auto* pSrcPtr    = pDataStart;
-
-    if (Size < sizeof(SGIHeader))
+    VERIFY_EXPR(pSGIData != nullptr && pDstImgDesc != nullptr);
+    if (DataSize < sizeof(SGIHeader))
     {
-        LOG_ERROR_MESSAGE("The SGI data size (", Size, ") is smaller than the size of required SGI header (", sizeof(SGIHeader), ").");
+        LOG_ERROR_MESSAGE("The SGI data size (", DataSize, ") is smaller than the size of required SGI header (", sizeof(SGIHeader), ").");
         return false;
     }
 
-    const auto& Header = reinterpret_cast<const SGIHeader&>(*pSrcPtr);
-    pSrcPtr += sizeof(SGIHeader);
+    const auto& Header = *reinterpret_cast<const SGIHeader*>(pSGIData);
 
     constexpr Uint16 SGIMagic = 0xda01u;
     if (Header.Magic != 0xda01)
@@ -110,87 +109,189 @@ bool LoadSGI(IDataBlob* pSGIData,
     }
 
     pDstImgDesc->RowStride = Width * NumChannels * BytesPerChannel;
-    pDstPixels->Resize(size_t{Height} * pDstImgDesc->RowStride);
-    auto* pDstPtr = reinterpret_cast<Uint8*>(pDstPixels->GetDataPtr());
+    return true;
+}
 
-    // Offsets table starts at byte 512 and is Height * NumChannels * 4 bytes long.
-    const auto  TableSize     = sizeof(Uint32) * Height * NumChannels;
-    const auto* OffsetTableBE = reinterpret_cast<const Uint32*>(pSrcPtr);
-    pSrcPtr += TableSize;
-    if (pSrcPtr > pDataEnd)
-        return false;
+// Decodes an RLE-compressed scanline of an 8-bit channel into every NumChannels-th byte of pDst.
+static bool DecodeRLEScanline(const Uint8* pSrc, const Uint8* pSrcEnd, Uint8* pDst, Uint32 Width, Uint32 NumChannels)
+{
+    Uint32 x = 0;
+    while (x < Width && pSrc < pSrcEnd)
+    {
+        // The lowest 7 bits is the counter. Zero counter marks the end of the scanline.
+        const Uint32 Count = *pSrc & 0x7Fu;
+        if (Count == 0 || Count > Width - x)
+            break;
 
-    // Length table follows the offsets table and is the same size.
-    const auto* LengthTableBE = reinterpret_cast<const Uint32*>(pSrcPtr);
-    pSrcPtr += TableSize;
-    if (pSrcPtr > pDataEnd)
+        // If the high order bit of the first byte is 1, then the count is used to specify how many values to copy
+        // from the RLE data buffer.
+        // If the high order bit of the first byte is 0, then the count is used to specify how many times to repeat
+        // the value following the counter.
+        const auto DistinctValues = (*pSrc & 0x80u) != 0;
+        ++pSrc;
+
+        if (DistinctValues)
+        {
+            if (Count > static_cast<size_t>(pSrcEnd - pSrc))
+                return false;
+
+            if (NumChannels == 1)
+            {
+                memcpy(pDst, pSrc, Count);
+            }
+            else
+            {
+                for (Uint32 i = 0; i < Count; ++i)
+                    pDst[size_t{i} * NumChannels] = pSrc[i];
+            }
+            pSrc += Count;
+        }
+        else
+        {
+            if (pSrc >= pSrcEnd)
+                return false;
+
+            const auto Value = *pSrc++;
+            if (NumChannels == 1)
+            {
+                memset(pDst, Value, Count);
+            }
+            else
+            {
+                for (Uint32 i = 0; i < Count; ++i)
+                    pDst[size_t{i} * NumChannels] = Value;
+            }
+        }
+
+        pDst += size_t{Count} * NumChannels;
+        x += Count;
+    }
+    return x == Width;
+}
+
+// Number of rows decoded by a single thread pool task
+static constexpr Uint32 SGIRowsPerTask = 64;
+
+bool LoadSGI(IDataBlob*   pSGIData,
+             IDataBlob*   pDstPixels,
+             ImageDesc*   pDstImgDesc,
+             IThreadPool* pThreadPool)
+{
+    VERIFY_EXPR(pSGIData != nullptr && pDstPixels != nullptr && pDstImgDesc != nullptr);
+    const auto* pDataStart = reinterpret_cast<const Uint8*>(pSGIData->GetConstDataPtr());
+    const auto  Size       = pSGIData->GetSize();
+    const auto* pSrcPtr    = pDataStart;
+
+    if (!ReadSGIHeader(pDataStart, Size, pDstImgDesc))
         return false;
 
-    VERIFY(Header.Compression, "Only RLE compressed files are currently supported");
-    VERIFY(BytesPerChannel == 1, "Only 8-bit images are currently supported");
+    const auto& Header = reinterpret_cast<const SGIHeader&>(*pSrcPtr);
+    pSrcPtr += sizeof(SGIHeader);
 
-    const auto ReadLine = [Width, BytesPerChannel, NumChannels](auto* pDst, const auto* pLineDataStart, const auto* pLineDataEnd) //
+    const auto Width           = pDstImgDesc->Width;
+    const auto Height          = pDstImgDesc->Height;
+    const auto NumChannels     = pDstImgDesc->NumComponents;
+    const auto BytesPerChannel = Header.BytePerPixelChannel;
+    const auto RowStride       = size_t{pDstImgDesc->RowStride};
+
+    if (BytesPerChannel != 1)
     {
-        VERIFY_EXPR(sizeof(*pDst) == BytesPerChannel);
-        VERIFY_EXPR(sizeof(*pLineDataStart) == BytesPerChannel);
-        (void)BytesPerChannel;
+        LOG_ERROR_MESSAGE("Only 8-bit SGI images are currently supported");
+        return false;
+    }
 
-        const auto* pSrc = pLineDataStart;
+    pDstPixels->Resize(size_t{Height} * RowStride);
+    auto* pDstPtr = reinterpret_cast<Uint8*>(pDstPixels->GetDataPtr());
 
-        Uint32 x = 0;
-        while (x < Width && pSrc < pLineDataEnd)
+    if (!Header.Compression)
+    {
+        // Uncompressed images store channels one after another, each as Height scanlines
+        const auto ChannelSize = size_t{Width} * Height;
+        if (ChannelSize * NumChannels > Size - sizeof(SGIHeader))
+            return false;
+
+        for (Uint32 c = 0; c < NumChannels; ++c)
         {
-            // The lowest 7 bits is the counter
-            int Count = *pSrc & 0x7F;
+            for (Uint32 y = 0; y < Height; ++y)
+            {
+                const auto* pSrcLine = pSrcPtr + c * ChannelSize + size_t{y} * Width;
+                auto*       pDstLine = pDstPtr + y * RowStride + c;
+                for (Uint32 x = 0; x < Width; ++x)
+                    pDstLine[size_t{x} * NumChannels] = pSrcLine[x];
+            }
+        }
+        return true;
+    }
 
-            // If the high order bit of the first byte is 1, then the count is used to specify how many values to copy
-            // from the RLE data buffer.
-            // If the high order bit of the first byte is 0, then the count is used to specify how many times to repeat
-            // the value following the counter.
-            auto DistinctValues = (*pSrc & 0x80) != 0;
+    // Offsets table starts at byte 512 and is Height * NumChannels * 4 bytes long.
+    // Length table follows the offsets table and is the same size.
+    const auto TableSize = sizeof(Uint32) * Height * NumChannels;
+    if (sizeof(SGIHeader) + TableSize * 2 > Size)
+        return false;
+
+    const auto* OffsetTableBE = reinterpret_cast<const Uint32*>(pSrcPtr);
+    const auto* LengthTableBE = reinterpret_cast<const Uint32*>(pSrcPtr + TableSize);
 
-            ++pSrc;
-            while (Count > 0 && pSrc < pLineDataEnd)
+    // Every scanline of every channel is compressed independently, so rows can be decoded in parallel
+    auto DecodeRows = [&](Uint32 FirstRow, Uint32 EndRow) {
+        for (Uint32 y = FirstRow; y < EndRow; ++y)
+        {
+            for (Uint32 c = 0; c < NumChannels; ++c)
             {
-                *pDst = *pSrc;
-                if (DistinctValues || Count == 1) // Always move the pointer for the last value
-                    ++pSrc;
+                // Each unsigned int in the offset table is the offset (from the file start) to the
+                // start of the compressed data of each scanline for each channel.
+                const size_t RleOff = PlatformMisc::SwapBytes(OffsetTableBE[y + c * Height]);
+                // The size table tells the size of the compressed data (unsigned int) of each scanline.
+                const size_t RleLen = PlatformMisc::SwapBytes(LengthTableBE[y + c * Height]);
+                if (RleOff > Size || RleLen > Size - RleOff)
+                    return false;
 
-                pDst += NumChannels;
-                --Count;
-                ++x;
+                auto* DstLine = pDstPtr + y * RowStride + c;
+                if (!DecodeRLEScanline(pDataStart + RleOff, pDataStart + RleOff + RleLen, DstLine, Width, NumChannels))
+                    return false;
             }
         }
-        return x == Width;
+        return true;
     };
 
-    for (Uint32 c = 0; c < NumChannels; ++c)
+    if (pThreadPool == nullptr || Height <= SGIRowsPerTask)
+        return DecodeRows(0, Height);
+
+    const auto NumTasks = (Height + SGIRowsPerTask - 1) / SGIRowsPerTask;
+
+    std::vector<Uint8>                     TaskResults(NumTasks, 0);
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    Tasks.reserve(NumTasks);
+    for (Uint32 Task = 0; Task < NumTasks; ++Task)
     {
-        for (Uint32 y = 0; y < Height; ++y)
-        {
-            // Each unsigned int in the offset table is the offset (from the file start) to the
-            // start of the compressed data of each scanline for each channel.
-            const auto RleOff = PlatformMisc::SwapBytes(OffsetTableBE[y + c * Height]);
-            // The size table tells the size of the compressed data (unsigned int) of each scanline.
-            const auto RleLen = PlatformMisc::SwapBytes(LengthTableBE[y + c * Height]);
-
-            auto* DstLine = pDstPtr + y * size_t{pDstImgDesc->RowStride} + c;
-            if (!ReadLine(DstLine, pDataStart + RleOff, pSrcPtr + RleOff + RleLen))
-                return false;
-        }
+        Tasks.emplace_back(EnqueueAsyncWork(pThreadPool, [&DecodeRows, &TaskResults, Task, Height](Uint32) {
+            const auto FirstRow = Task * SGIRowsPerTask;
+            const auto EndRow   = std::min(FirstRow + SGIRowsPerTask, Height);
+            TaskResults[Task]   = DecodeRows(FirstRow, EndRow) ? 1 : 0;
+        }));
     }
+    for (auto& pTask : Tasks)
+        pTask->WaitForCompletion();
 
-    return true;
+    return std::find(TaskResults.begin(), TaskResults.end(), Uint8{0}) == TaskResults.end();
 }
 
 } // namespace Diligent
 
 extern "C"
 {
-    void Diligent_LoadSGI(Diligent::IDataBlob* pSGIData,
-                          Diligent::IDataBlob* pDstPixels,
-                          Diligent::ImageDesc* pDstImgDesc)
+    void Diligent_LoadSGI(Diligent::IDataBlob*   pSGIData,
+                          Diligent::IDataBlob*   pDstPixels,
+                          Diligent::ImageDesc*   pDstImgDesc,
+                          Diligent::IThreadPool* pThreadPool)
+    {
+        Diligent::LoadSGI(pSGIData, pDstPixels, pDstImgDesc, pThreadPool);
+    }
+
+    bool Diligent_ReadSGIHeader(const void*          pSGIData,
+                                size_t               DataSize,
+                                Diligent::ImageDesc* pDstImgDesc)
     {
-        Diligent::LoadSGI(pSGIData, pDstPixels, pDstImgDesc);
+        return Diligent::ReadSGIHeader(pSGIData, DataSize, pDstImgDesc);
     }
 }
@@ -0,0 +1,404 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "SparseTexture.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "GraphicsAccessories.hpp"
+#include "DebugUtilities.hpp"
+#include "ToolsTrace.hpp"
+
+namespace Diligent
+{
+
+bool SparseTexture::IsSupported(IRenderDevice* pDevice, const TextureDesc& Desc)
+{
+    VERIFY_EXPR(pDevice != nullptr);
+
+    if (pDevice->GetDeviceInfo().Features.SparseResources != DEVICE_FEATURE_STATE_ENABLED)
+        return false;
+
+    if (Desc.Type != RESOURCE_DIM_TEX_2D && Desc.Type != RESOURCE_DIM_TEX_2D_ARRAY)
+        return false;
+
+    const auto CapFlags = pDevice->GetAdapterInfo().SparseResources.CapFlags;
+    if ((CapFlags & SPARSE_RESOURCE_CAP_FLAG_TEXTURE_2D) == 0)
+        return false;
+    if (Desc.ArraySize > 1 && (CapFlags & SPARSE_RESOURCE_CAP_FLAG_TEXTURE_2D_ARRAY_MIP_TAIL) == 0)
+        return false;
+
+    const auto FmtInfo = pDevice->GetSparseTextureFormatInfo(Desc.Format, Desc.Type, Desc.SampleCount);
+    return (FmtInfo.BindFlags & Desc.BindFlags) == Desc.BindFlags;
+}
+
+std::unique_ptr<SparseTexture> SparseTexture::Create(IRenderDevice*                 pDevice,
+                                                     IDeviceContext*                pContext,
+                                                     ITextureLoader*                pLoader,
+                                                     const SparseTextureCreateInfo& CI)
+{
+    DEV_CHECK_ERR(pDevice != nullptr, "Render device must not be null");
+    DEV_CHECK_ERR(pContext != nullptr, "Device context must not be null");
+    DEV_CHECK_ERR(pLoader != nullptr, "Texture loader must not be null");
+    DEV_CHECK_ERR(CI.MaxResidentTiles > 0, "The maximum number of resident tiles must not be zero");
+
+    DILIGENT_TRACE_ZONE("SparseTexture::Create");
+
+    auto Desc                 = pLoader->GetTextureDesc();
+    Desc.Usage                = USAGE_SPARSE;
+    Desc.CPUAccessFlags       = CPU_ACCESS_NONE;
+    Desc.ImmediateContextMask = CI.ImmediateContextMask;
+    if (!IsSupported(pDevice, Desc))
+    {
+        LOG_WARNING_MESSAGE("The device does not support sparse textures of format ", GetTextureFormatAttribs(Desc.Format).Name, " and type ", GetResourceDimString(Desc.Type));
+        return {};
+    }
+
+    for (Uint32 Slice = 0; Slice < Desc.ArraySize; ++Slice)
+    {
+        for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+        {
+            if (pLoader->GetSubresourceData(Mip, Slice).pData == nullptr)
+            {
+                LOG_ERROR_MESSAGE("Texture loader '", (Desc.Name != nullptr ? Desc.Name : ""), "' has no data for mip level ", Mip, " of slice ", Slice,
+                                  ". Sparse textures can't be created from loaders that generate mips on the GPU or whose CPU data has been released.");
+                return {};
+            }
+        }
+    }
+
+    RefCntAutoPtr<ITexture> pTexture;
+    pDevice->CreateTexture(Desc, nullptr, &pTexture);
+    if (!pTexture)
+    {
+        LOG_ERROR_MESSAGE("Failed to create sparse texture '", (Desc.Name != nullptr ? Desc.Name : ""), "'");
+        return {};
+    }
+
+    const auto& Props         = pTexture->GetSparseProperties();
+    const auto  NumMipTails   = Props.FirstMipInTail < Desc.MipLevels ? ((Props.Flags & SPARSE_TEXTURE_FLAG_SINGLE_MIPTAIL) != 0 ? 1 : Desc.ArraySize) : 0;
+    const bool  NativeFence   = pDevice->GetDeviceInfo().Features.NativeFence == DEVICE_FEATURE_STATE_ENABLED;
+    const auto  MaxTiles      = CI.MaxResidentTiles;
+    const auto  NumMipTailMem = Props.MipTailSize * NumMipTails;
+
+    DeviceMemoryCreateInfo MemCI;
+    MemCI.Desc.Name                 = Desc.Name;
+    MemCI.Desc.Type                 = DEVICE_MEMORY_TYPE_SPARSE;
+    MemCI.Desc.PageSize             = Props.BlockSize;
+    MemCI.Desc.ImmediateContextMask = CI.ImmediateContextMask;
+    MemCI.InitialSize               = Uint64{MaxTiles} * Props.BlockSize + NumMipTailMem;
+
+    IDeviceObject* pCompatibleRes[] = {pTexture};
+    MemCI.ppCompatibleResources     = pCompatibleRes;
+    MemCI.NumResources              = 1;
+
+    RefCntAutoPtr<IDeviceMemory> pMemory;
+    pDevice->CreateDeviceMemory(MemCI, &pMemory);
+    if (!pMemory)
+    {
+        LOG_ERROR_MESSAGE("Failed to create the memory of sparse texture '", (Desc.Name != nullptr ? Desc.Name : ""), "'");
+        return {};
+    }
+
+    FenceDesc FenceCI;
+    FenceCI.Name = "Sparse texture binding fence";
+    FenceCI.Type = NativeFence ? FENCE_TYPE_GENERAL : FENCE_TYPE_CPU_WAIT_ONLY;
+    RefCntAutoPtr<IFence> pFence;
+    pDevice->CreateFence(FenceCI, &pFence);
+    if (!pFence)
+        return {};
+
+    auto pSparseTex = std::make_unique<SparseTexture>(std::move(pTexture), std::move(pMemory), std::move(pFence), NativeFence, RefCntAutoPtr<ITextureLoader>{pLoader}, CI);
+    pSparseTex->InitMipTail(pContext);
+    return pSparseTex;
+}
+
+SparseTexture::SparseTexture(RefCntAutoPtr<ITexture>        pTexture,
+                             RefCntAutoPtr<IDeviceMemory>   pMemory,
+                             RefCntAutoPtr<IFence>          pFence,
+                             bool                           NativeFence,
+                             RefCntAutoPtr<ITextureLoader>  pLoader,
+                             const SparseTextureCreateInfo& CI) :
+    // clang-format off
+    m_pTexture        {std::move(pTexture)},
+    m_pMemory         {std::move(pMemory)},
+    m_pFence          {std::move(pFence)},
+    m_pLoader         {std::move(pLoader)},
+    m_NativeFence     {NativeFence},
+    m_MaxResidentTiles{CI.MaxResidentTiles},
+    m_MinEvictionAge  {std::max(CI.MinEvictionAge, 1u)}
+// clang-format on
+{
+    const auto& Desc  = m_pTexture->GetDesc();
+    const auto& Props = m_pTexture->GetSparseProperties();
+
+    for (size_t i = 0; i < _countof(m_TileSize); ++i)
+        m_TileSize[i] = Props.TileSize[i];
+    m_FirstMipInTail = std::min(Props.FirstMipInTail, Desc.MipLevels);
+    m_BlockSize      = Props.BlockSize;
+    m_MipTailSize    = Props.MipTailSize;
+    m_NumMipTails    = m_FirstMipInTail < Desc.MipLevels ? ((Props.Flags & SPARSE_TEXTURE_FLAG_SINGLE_MIPTAIL) != 0 ? 1 : Desc.ArraySize) : 0;
+
+    // Slot 0 is used first
+    m_FreeSlots.resize(m_MaxResidentTiles);
+    for (Uint32 i = 0; i < m_MaxResidentTiles; ++i)
+        m_FreeSlots[i] = m_MaxResidentTiles - 1 - i;
+}
+
+Uint64 SparseTexture::GetTileKey(const SparseTileCoord& Tile)
+{
+    return (Uint64{Tile.MipLevel} << 56u) | (Uint64{Tile.ArraySlice & 0xFFFFu} << 40u) | (Uint64{Tile.X & 0xFFFFFu} << 20u) | Uint64{Tile.Y & 0xFFFFFu};
+}
+
+void SparseTexture::GetNumTiles(Uint32 MipLevel, Uint32& NumTilesX, Uint32& NumTilesY) const
+{
+    const auto MipProps = GetMipLevelProperties(m_pTexture->GetDesc(), MipLevel);
+
+    NumTilesX = (MipProps.LogicalWidth + m_TileSize[0] - 1) / m_TileSize[0];
+    NumTilesY = (MipProps.LogicalHeight + m_TileSize[1] - 1) / m_TileSize[1];
+}
+
+bool SparseTexture::IsTileValid(const SparseTileCoord& Tile) const
+{
+    const auto& Desc = m_pTexture->GetDesc();
+    if (Tile.MipLevel >= Desc.MipLevels || Tile.ArraySlice >= Desc.ArraySize)
+        return false;
+
+    Uint32 NumTilesX = 0;
+    Uint32 NumTilesY = 0;
+    GetNumTiles(Tile.MipLevel, NumTilesX, NumTilesY);
+    return Tile.X < NumTilesX && Tile.Y < NumTilesY;
+}
+
+bool SparseTexture::IsTileResident(const SparseTileCoord& Tile) const
+{
+    if (Tile.MipLevel >= m_FirstMipInTail)
+        return true;
+
+    return m_ResidentTiles.find(GetTileKey(Tile)) != m_ResidentTiles.end();
+}
+
+Uint64 SparseTexture::GetMemorySize() const
+{
+    return Uint64{m_MaxResidentTiles} * m_BlockSize + m_MipTailSize * m_NumMipTails;
+}
+
+Box SparseTexture::GetTileRegion(const SparseTileCoord& Tile) const
+{
+    const auto MipProps = GetMipLevelProperties(m_pTexture->GetDesc(), Tile.MipLevel);
+
+    Box Region;
+    Region.MinX = Tile.X * m_TileSize[0];
+    Region.MaxX = std::min(Region.MinX + m_TileSize[0], MipProps.LogicalWidth);
+    Region.MinY = Tile.Y * m_TileSize[1];
+    Region.MaxY = std::min(Region.MinY + m_TileSize[1], MipProps.LogicalHeight);
+    Region.MinZ = 0;
+    Region.MaxZ = 1;
+    return Region;
+}
+
+void SparseTexture::BindMemory(IDeviceContext* pContext, const std::vector<SparseTextureMemoryBindRange>& Ranges)
+{
+    SparseTextureMemoryBindInfo TexBind;
+    TexBind.pTexture  = m_pTexture;
+    TexBind.pRanges   = Ranges.data();
+    TexBind.NumRanges = static_cast<Uint32>(Ranges.size());
+
+    ++m_FenceValue;
+    IFence* pSignalFence = m_pFence;
+
+    BindSparseResourceMemoryAttribs Attribs;
+    Attribs.pTextureBinds      = &TexBind;
+    Attribs.NumTextureBinds    = 1;
+    Attribs.ppSignalFences     = &pSignalFence;
+    Attribs.pSignalFenceValues = &m_FenceValue;
+    Attribs.NumSignalFences    = 1;
+    pContext->BindSparseResourceMemory(Attribs);
+
+    if (m_NativeFence)
+        pContext->DeviceWaitForFence(m_pFence, m_FenceValue);
+    else
+        m_pFence->Wait(m_FenceValue);
+}
+
+void SparseTexture::InitMipTail(IDeviceContext* pContext)
+{
+    const auto& Desc = m_pTexture->GetDesc();
+    if (m_NumMipTails == 0)
+        return;
+
+    // The mip tails are placed after the tile slots
+    std::vector<SparseTextureMemoryBindRange> Ranges(m_NumMipTails);
+    for (Uint32 i = 0; i < m_NumMipTails; ++i)
+    {
+        auto& Range           = Ranges[i];
+        Range.MipLevel        = m_FirstMipInTail;
+        Range.ArraySlice      = i;
+        Range.OffsetInMipTail = 0;
+        Range.MemorySize      = m_MipTailSize;
+        Range.pMemory         = m_pMemory;
+        Range.MemoryOffset    = Uint64{m_MaxResidentTiles} * m_BlockSize + Uint64{i} * m_MipTailSize;
+    }
+    BindMemory(pContext, Ranges);
+
+    for (Uint32 Slice = 0; Slice < Desc.ArraySize; ++Slice)
+    {
+        for (Uint32 Mip = m_FirstMipInTail; Mip < Desc.MipLevels; ++Mip)
+        {
+            const auto MipProps = GetMipLevelProperties(Desc, Mip);
+
+            Box Region;
+            Region.MaxX = MipProps.LogicalWidth;
+            Region.MaxY = MipProps.LogicalHeight;
+            pContext->UpdateTexture(m_pTexture, Mip, Slice, Region, m_pLoader->GetSubresourceData(Mip, Slice),
+                                    RESOURCE_STATE_TRANSITION_MODE_TRANSITION, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+        }
+    }
+}
+
+void SparseTexture::UploadTile(IDeviceContext* pContext, const SparseTileCoord& Tile)
+{
+    const auto& Desc       = m_pTexture->GetDesc();
+    const auto& FmtAttribs = GetTextureFormatAttribs(Desc.Format);
+    const auto& SubRes     = m_pLoader->GetSubresourceData(Tile.MipLevel, Tile.ArraySlice);
+    const auto  Region     = GetTileRegion(Tile);
+
+    // Tiles are aligned to the compressed block size
+    const Uint32 ElementSize = FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED ?
+        Uint32{FmtAttribs.ComponentSize} :
+        Uint32{FmtAttribs.ComponentSize} * Uint32{FmtAttribs.NumComponents};
+
+    TextureSubResData TileData;
+    TileData.pData = static_cast<const Uint8*>(SubRes.pData) +
+        Uint64{Region.MinY / FmtAttribs.BlockHeight} * SubRes.Stride +
+        Uint64{Region.MinX / FmtAttribs.BlockWidth} * ElementSize;
+    TileData.Stride = SubRes.Stride;
+
+    pContext->UpdateTexture(m_pTexture, Tile.MipLevel, Tile.ArraySlice, Region, TileData,
+                            RESOURCE_STATE_TRANSITION_MODE_TRANSITION, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+}
+
+Uint32 SparseTexture::CommitTiles(IDeviceContext* pContext, const SparseTileCoord* pTiles, Uint32 NumTiles, Uint32 MaxNewTiles)
+{
+    DEV_CHECK_ERR(pContext != nullptr, "Device context must not be null");
+    DEV_CHECK_ERR(pTiles != nullptr || NumTiles == 0, "Tiles must not be null");
+
+    DILIGENT_TRACE_ZONE("SparseTexture::CommitTiles");
+
+    ++m_CommitIndex;
+
+    // Mark all resident tiles as used first, so that they are not evicted in favor of the new tiles
+    std::vector<SparseTileCoord> NewTiles;
+    std::unordered_set<Uint64>   NewTileKeys;
+    for (Uint32 i = 0; i < NumTiles; ++i)
+    {
+        const auto& Tile = pTiles[i];
+        if (!IsTileValid(Tile))
+        {
+            DEV_ERROR("Tile (", Tile.X, ", ", Tile.Y, ") of mip level ", Tile.MipLevel, " and slice ", Tile.ArraySlice, " is out of range");
+            continue;
+        }
+        if (Tile.MipLevel >= m_FirstMipInTail)
+            continue;
+
+        const auto Key = GetTileKey(Tile);
+        const auto it  = m_ResidentTiles.find(Key);
+        if (it != m_ResidentTiles.end())
+        {
+            it->second->LastUsed = m_CommitIndex;
+            m_LRU.splice(m_LRU.begin(), m_LRU, it->second);
+        }
+        else if (NewTiles.size() < MaxNewTiles && NewTileKeys.insert(Key).second)
+        {
+            NewTiles.push_back(Tile);
+        }
+    }
+
+    std::vector<SparseTextureMemoryBindRange> Ranges;
+    size_t                                    NumCommitted = 0;
+    for (; NumCommitted < NewTiles.size(); ++NumCommitted)
+    {
+        const auto& Tile = NewTiles[NumCommitted];
+
+        Uint32 Slot = 0;
+        if (!m_FreeSlots.empty())
+        {
+            Slot = m_FreeSlots.back();
+            m_FreeSlots.pop_back();
+        }
+        else
+        {
+            // Evict the least recently used tile if the GPU is no longer using it
+            if (m_LRU.empty() || m_LRU.back().LastUsed + m_MinEvictionAge > m_CommitIndex)
+                break;
+
+            const auto& Evicted = m_LRU.back();
+            Slot                = Evicted.Slot;
+
+            SparseTextureMemoryBindRange Unbind;
+            Unbind.MipLevel   = Evicted.Coord.MipLevel;
+            Unbind.ArraySlice = Evicted.Coord.ArraySlice;
+            Unbind.Region     = GetTileRegion(Evicted.Coord);
+            Unbind.MemorySize = m_BlockSize;
+            Unbind.pMemory    = nullptr;
+            Ranges.push_back(Unbind);
+
+            m_ResidentTiles.erase(GetTileKey(Evicted.Coord));
+            m_LRU.pop_back();
+        }
+
+        SparseTextureMemoryBindRange Bind;
+        Bind.MipLevel     = Tile.MipLevel;
+        Bind.ArraySlice   = Tile.ArraySlice;
+        Bind.Region       = GetTileRegion(Tile);
+        Bind.MemorySize   = m_BlockSize;
+        Bind.pMemory      = m_pMemory;
+        Bind.MemoryOffset = Uint64{Slot} * m_BlockSize;
+        Ranges.push_back(Bind);
+
+        ResidentTile NewTile;
+        NewTile.Coord    = Tile;
+        NewTile.Slot     = Slot;
+        NewTile.LastUsed = m_CommitIndex;
+        m_LRU.push_front(NewTile);
+        m_ResidentTiles.emplace(GetTileKey(Tile), m_LRU.begin());
+    }
+
+    if (NumCommitted == 0)
+        return 0;
+
+    BindMemory(pContext, Ranges);
+    for (size_t i = 0; i < NumCommitted; ++i)
+        UploadTile(pContext, NewTiles[i]);
+
+    DILIGENT_TRACE_COUNTER("SparseTexture::CommittedTiles", NumCommitted);
+
+    return static_cast<Uint32>(NumCommitted);
+}
+
+} // namespace Diligent
@@ -0,0 +1,298 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence),
+ *  contract, or otherwise, unless required by applicable law (such as deliberate
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental,
+ *  or consequential damages of any character arising as a result of this License or
+ *  out of the use or inability to use the software (including but not limited to damages
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and
+ *  all other commercial damages or losses), even if such Contributor has been advised
+ *  of the possibility of such damages.
+ */
+
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+
+#include "TextureUtilities.h"
+#include "TextureLoaderImpl.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "DebugUtilities.hpp"
+
+#if PLATFORM_WIN32
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <Windows.h>
+#elif PLATFORM_LINUX || PLATFORM_MACOS || PLATFORM_ANDROID || PLATFORM_IOS || PLATFORM_TVOS
+#    include <sys/stat.h>
+#    define DILIGENT_USE_POSIX_STAT 1
+#endif
+
+namespace Diligent
+{
+
+namespace
+{
+
+// File modification time and size that identify the version of the file
+struct FileStamp
+{
+    Uint64 ModificationTime = 0;
+    Uint64 Size             = 0;
+
+    bool operator==(const FileStamp& RHS) const
+    {
+        return ModificationTime == RHS.ModificationTime && Size == RHS.Size;
+    }
+};
+
+// Returns an empty stamp if the file properties can't be queried, in which case
+// the file is identified by its path only.
+FileStamp GetFileStamp(const Char* FilePath)
+{
+    FileStamp Stamp;
+#if PLATFORM_WIN32
+    WIN32_FILE_ATTRIBUTE_DATA FileAttribs{};
+    if (GetFileAttributesExA(FilePath, GetFileExInfoStandard, &FileAttribs))
+    {
+        Stamp.ModificationTime = (Uint64{FileAttribs.ftLastWriteTime.dwHighDateTime} << 32u) | Uint64{FileAttribs.ftLastWriteTime.dwLowDateTime};
+        Stamp.Size             = (Uint64{FileAttribs.nFileSizeHigh} << 32u) | Uint64{FileAttribs.nFileSizeLow};
+    }
+#elif DILIGENT_USE_POSIX_STAT
+    struct stat FileStat;
+    if (stat(FilePath, &FileStat) == 0)
+    {
+        Stamp.ModificationTime = static_cast<Uint64>(FileStat.st_mtime);
+        Stamp.Size             = static_cast<Uint64>(FileStat.st_size);
+    }
+#endif
+    return Stamp;
+}
+
+struct TextureFileCacheKey
+{
+    TextureLoadKey       LoadKey;
+    FileStamp            Stamp;
+    const IRenderDevice* pDevice = nullptr;
+
+    bool operator==(const TextureFileCacheKey& RHS) const
+    {
+        return pDevice == RHS.pDevice && Stamp == RHS.Stamp && LoadKey == RHS.LoadKey;
+    }
+
+    struct Hasher
+    {
+        size_t operator()(const TextureFileCacheKey& Key) const
+        {
+            auto Hash = TextureLoadKey::Hasher{}(Key.LoadKey);
+            HashCombine(Hash, Key.Stamp.ModificationTime, Key.Stamp.Size, Key.pDevice);
+            return Hash;
+        }
+    };
+};
+
+class TextureFileCache
+{
+public:
+    static TextureFileCache& GetInstance()
+    {
+        static TextureFileCache Cache;
+        return Cache;
+    }
+
+    RefCntAutoPtr<ITexture> GetTexture(const Char* FilePath, const TextureLoadInfo& TexLoadInfo, IRenderDevice* pDevice)
+    {
+        const TextureFileCacheKey Key{{FilePath, TexLoadInfo}, GetFileStamp(FilePath), pDevice};
+
+        std::unique_lock<std::mutex> Lock{m_Mtx};
+
+        bool Waited = false;
+        auto it     = m_Entries.find(Key);
+        while (it != m_Entries.end() && it->second.IsLoading)
+        {
+            // Another thread is loading the same texture
+            Waited = true;
+            m_LoadCompleteCV.wait(Lock);
+            // Iterators are invalidated if the map is rehashed while waiting
+            it = m_Entries.find(Key);
+        }
+
+        if (it != m_Entries.end())
+        {
+            if (auto pTexture = it->second.pTexture.Lock())
+            {
+                ++m_Stats.NumHits;
+                if (Waited)
+                    ++m_Stats.NumWaits;
+                return pTexture;
+            }
+        }
+        else
+        {
+            PruneExpiredEntries();
+            it = m_Entries.emplace(Key, Entry{}).first;
+        }
+
+        ++m_Stats.NumMisses;
+        it->second.IsLoading = true;
+        Lock.unlock();
+
+        RefCntAutoPtr<ITexture> pTexture;
+        try
+        {
+            CreateTextureFromFile(FilePath, TexLoadInfo, pDevice, &pTexture);
+        }
+        catch (...)
+        {
+            FinishLoading(Key, nullptr);
+            throw;
+        }
+        FinishLoading(Key, pTexture);
+
+        return pTexture;
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        for (auto it = m_Entries.begin(); it != m_Entries.end();)
+        {
+            if (!it->second.IsLoading)
+                it = m_Entries.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    TextureFileCacheStats GetStats()
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+
+        auto Stats       = m_Stats;
+        Stats.NumEntries = static_cast<Uint32>(m_Entries.size());
+        return Stats;
+    }
+
+private:
+    struct Entry
+    {
+        // The cache does not keep the textures alive
+        RefCntWeakPtr<ITexture> pTexture;
+
+        // The texture is being loaded by one of the threads
+        bool IsLoading = false;
+    };
+
+    void FinishLoading(const TextureFileCacheKey& Key, ITexture* pTexture)
+    {
+        {
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+
+            auto it = m_Entries.find(Key);
+            VERIFY_EXPR(it != m_Entries.end() && it->second.IsLoading);
+            if (pTexture != nullptr)
+            {
+                it->second.pTexture  = RefCntWeakPtr<ITexture>{pTexture};
+                it->second.IsLoading = false;
+            }
+            else
+            {
+                // Failed loads are not cached: waiting threads will try to load the texture again
+                m_Entries.erase(it);
+            }
+        }
+        m_LoadCompleteCV.notify_all();
+    }
+
+    // Removes the entries of released textures. The cost is amortized by
+    // doubling the threshold when most entries are alive.
+    void PruneExpiredEntries()
+    {
+        if (m_Entries.size() < m_PruneThreshold)
+            return;
+
+        for (auto it = m_Entries.begin(); it != m_Entries.end();)
+        {
+            if (!it->second.IsLoading && !it->second.pTexture.IsValid())
+                it = m_Entries.erase(it);
+            else
+                ++it;
+        }
+        m_PruneThreshold = std::max(m_Entries.size() * 2, size_t{64});
+    }
+
+    std::mutex              m_Mtx;
+    std::condition_variable m_LoadCompleteCV;
+
+    std::unordered_map<TextureFileCacheKey, Entry, TextureFileCacheKey::Hasher> m_Entries;
+
+    TextureFileCacheStats m_Stats;
+    size_t                m_PruneThreshold = 64;
+};
+
+} // namespace
+
+void CreateTextureFromFileCached(const Char*            FilePath,
+                                 const TextureLoadInfo& TexLoadInfo,
+                                 IRenderDevice*         pDevice,
+                                 ITexture**             ppTexture)
+{
+    DEV_CHECK_ERR(FilePath != nullptr, "File path must not be null");
+    DEV_CHECK_ERR(ppTexture != nullptr && *ppTexture == nullptr, "Texture pointer must not be null and must point to null");
+
+    auto pTexture = TextureFileCache::GetInstance().GetTexture(FilePath, TexLoadInfo, pDevice);
+    *ppTexture    = pTexture.Detach();
+}
+
+void ClearTextureFileCache()
+{
+    TextureFileCache::GetInstance().Clear();
+}
+
+TextureFileCacheStats GetTextureFileCacheStats()
+{
+    return TextureFileCache::GetInstance().GetStats();
+}
+
+} // namespace Diligent
+
+extern "C"
+{
+    void Diligent_CreateTextureFromFileCached(const Diligent::Char*            FilePath,
+                                              const Diligent::TextureLoadInfo& TexLoadInfo,
+                                              Diligent::IRenderDevice*         pDevice,
+                                              Diligent::ITexture**             ppTexture)
+    {
+        Diligent::CreateTextureFromFileCached(FilePath, TexLoadInfo, pDevice, ppTexture);
+    }
+
+    void Diligent_ClearTextureFileCache()
+    {
+        Diligent::ClearTextureFileCache();
+    }
+
+    Diligent::TextureFileCacheStats Diligent_GetTextureFileCacheStats()
+    {
+        return Diligent::GetTextureFileCacheStats();
+    }
+}
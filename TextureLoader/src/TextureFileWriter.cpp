@@ -0,0 +1,552 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "TextureFileWriter.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iterator>
+
+#if PLATFORM_WIN32
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    ifndef WIN32_LEAN_AND_MEAN
+#        define WIN32_LEAN_AND_MEAN
+#    endif
+#    include <Windows.h>
+#elif PLATFORM_LINUX || PLATFORM_MACOS || PLATFORM_ANDROID || PLATFORM_IOS || PLATFORM_TVOS
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#    define DILIGENT_USE_POSIX_PWRITE 1
+#endif
+
+#include "TextureLoaderImpl.hpp"
+#include "FileWrapper.hpp"
+#include "DebugUtilities.hpp"
+#include "GraphicsAccessories.hpp"
+#include "ThreadPool.hpp"
+
+#include "zlib.h"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Levels are split into chunks of this size that are compressed independently
+constexpr size_t CompressionChunkSize = size_t{1} << 20;
+
+// Every chunk is compressed with the last window of the previous chunk as the dictionary,
+// so that splitting the level into chunks does not hurt the compression ratio.
+constexpr size_t DeflateWindowSize = size_t{1} << 15;
+
+// Compresses a part of a zlib stream as raw deflate data that ends on a byte boundary,
+// so that the compressed parts can be concatenated.
+bool DeflateChunk(const Uint8* pSrc, size_t Size, const Uint8* pDictionary, size_t DictionarySize, bool IsLast, int Level, std::vector<Uint8>& Dst)
+{
+    z_stream Stream{};
+    if (deflateInit2(&Stream, Level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+
+    if (DictionarySize > 0)
+        deflateSetDictionary(&Stream, pDictionary, static_cast<uInt>(DictionarySize));
+
+    // Sync flush appends an empty stored block
+    Dst.resize(deflateBound(&Stream, static_cast<uLong>(Size)) + 16);
+
+    Stream.next_in   = const_cast<Bytef*>(pSrc);
+    Stream.avail_in  = static_cast<uInt>(Size);
+    Stream.next_out  = Dst.data();
+    Stream.avail_out = static_cast<uInt>(Dst.size());
+
+    const auto Status = deflate(&Stream, IsLast ? Z_FINISH : Z_SYNC_FLUSH);
+    const bool Result = IsLast ? Status == Z_STREAM_END : (Status == Z_OK && Stream.avail_in == 0 && Stream.avail_out > 0);
+    Dst.resize(Stream.total_out);
+    deflateEnd(&Stream);
+    return Result;
+}
+
+} // namespace
+
+struct TextureFileWriter::FileHandle
+{
+#if PLATFORM_WIN32
+    HANDLE hFile = INVALID_HANDLE_VALUE;
+#elif DILIGENT_USE_POSIX_PWRITE
+    int fd = -1;
+#else
+    // Positional writes are not available, so the file is assembled in memory and written by Close()
+    std::string        Path;
+    std::mutex         DataMtx;
+    std::vector<Uint8> Data;
+#endif
+
+    ~FileHandle()
+    {
+        Close();
+    }
+
+    bool Open(const char* Path)
+    {
+#if PLATFORM_WIN32
+        hFile = CreateFileA(Path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        return hFile != INVALID_HANDLE_VALUE;
+#elif DILIGENT_USE_POSIX_PWRITE
+        fd = open(Path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        return fd >= 0;
+#else
+        this->Path = Path;
+
+        FileWrapper File{Path, EFileAccessMode::Overwrite};
+        return !!File;
+#endif
+    }
+
+    bool Write(const void* pData, size_t Size, Uint64 Offset)
+    {
+        const auto* pSrc = static_cast<const Uint8*>(pData);
+#if PLATFORM_WIN32
+        while (Size > 0)
+        {
+            // The handle is not opened for overlapped I/O, so the offset in the OVERLAPPED
+            // structure makes WriteFile a synchronous positional write that is safe to use from several threads.
+            OVERLAPPED Overlapped{};
+            Overlapped.Offset     = static_cast<DWORD>(Offset & 0xFFFFFFFFu);
+            Overlapped.OffsetHigh = static_cast<DWORD>(Offset >> 32u);
+
+            const auto NumBytesToWrite = static_cast<DWORD>(std::min(Size, size_t{1} << 30u));
+            DWORD      NumBytesWritten = 0;
+            if (!::WriteFile(hFile, pSrc, NumBytesToWrite, &NumBytesWritten, &Overlapped) || NumBytesWritten == 0)
+                return false;
+
+            pSrc += NumBytesWritten;
+            Offset += NumBytesWritten;
+            Size -= NumBytesWritten;
+        }
+        return true;
+#elif DILIGENT_USE_POSIX_PWRITE
+        while (Size > 0)
+        {
+            const auto NumBytesWritten = pwrite(fd, pSrc, Size, static_cast<off_t>(Offset));
+            if (NumBytesWritten < 0 && errno == EINTR)
+                continue;
+
+            if (NumBytesWritten <= 0)
+                return false;
+
+            pSrc += NumBytesWritten;
+            Offset += static_cast<Uint64>(NumBytesWritten);
+            Size -= static_cast<size_t>(NumBytesWritten);
+        }
+        return true;
+#else
+        std::lock_guard<std::mutex> Lock{DataMtx};
+        if (Data.size() < Offset + Size)
+            Data.resize(StaticCast<size_t>(Offset + Size));
+        memcpy(Data.data() + Offset, pSrc, Size);
+        return true;
+#endif
+    }
+
+    bool Close()
+    {
+        bool Result = true;
+#if PLATFORM_WIN32
+        if (hFile != INVALID_HANDLE_VALUE)
+        {
+            Result = CloseHandle(hFile) != FALSE;
+            hFile  = INVALID_HANDLE_VALUE;
+        }
+#elif DILIGENT_USE_POSIX_PWRITE
+        if (fd >= 0)
+        {
+            Result = close(fd) == 0;
+            fd     = -1;
+        }
+#else
+        if (!Path.empty())
+        {
+            FileWrapper File{Path.c_str(), EFileAccessMode::Overwrite};
+            Result = !!File && File->Write(Data.data(), Data.size());
+            Path.clear();
+            Data.clear();
+        }
+#endif
+        return Result;
+    }
+};
+
+struct TextureFileWriter::CompressedLevel
+{
+    // Uncompressed level data. Released when the level has been compressed.
+    std::vector<Uint8>  Data;
+    std::atomic<Uint32> NumPendingSlices{0};
+
+    std::vector<std::vector<Uint8>> Chunks;
+    std::vector<Uint32>             ChunkAdlers;
+    std::atomic<size_t>             NumPendingChunks{0};
+
+    // Complete zlib stream
+    std::vector<Uint8> Compressed;
+};
+
+TextureFileWriter::TextureFileWriter(const char* FilePath, const TextureDesc& Desc, const CreateInfo& CI) :
+    // clang-format off
+    m_FilePath        {FilePath},
+    m_Desc            {Desc},
+    m_FileFormat      {CI.FileFormat},
+    m_CompressionLevel{CI.FileFormat == IMAGE_FILE_FORMAT_KTX ? std::min(CI.CompressionLevel, 9u) : 0u},
+    m_pThreadPool     {CI.pThreadPool},
+    m_pFile           {new FileHandle}
+// clang-format on
+{
+    DEV_CHECK_ERR(FilePath != nullptr, "File path must not be null");
+
+    if (m_FileFormat != IMAGE_FILE_FORMAT_DDS && m_FileFormat != IMAGE_FILE_FORMAT_KTX)
+        LOG_ERROR_AND_THROW("Only DDS and KTX2 files are supported");
+    if (m_Desc.MipLevels == 0)
+        LOG_ERROR_AND_THROW("The number of mip levels must not be zero");
+
+    std::vector<Uint8> Header;
+    if (!CreateHeader(Header))
+        LOG_ERROR_AND_THROW("Failed to create the header of file '", FilePath, "'.");
+
+    const auto ArraySize = m_Desc.GetArraySize();
+    m_SubresWritten.resize(size_t{m_Desc.MipLevels} * size_t{ArraySize});
+
+    if (m_FileFormat == IMAGE_FILE_FORMAT_DDS)
+    {
+        // Subresources are arranged by array slices first
+        m_SubresOffsets.resize(m_SubresWritten.size());
+
+        Uint64 Offset = Header.size();
+        for (Uint32 Slice = 0; Slice < ArraySize; ++Slice)
+        {
+            for (Uint32 Mip = 0; Mip < m_Desc.MipLevels; ++Mip)
+            {
+                m_SubresOffsets[size_t{Slice} * m_Desc.MipLevels + Mip] = Offset;
+                Offset += GetMipLevelProperties(m_Desc, Mip).MipSize;
+            }
+        }
+    }
+    else
+    {
+        m_LevelOffsets.resize(m_Desc.MipLevels);
+        m_LevelSizes.resize(m_Desc.MipLevels);
+        if (m_CompressionLevel == 0)
+        {
+            // Levels are arranged from the smallest to the largest, and slices are tightly packed within a level
+            m_SubresOffsets.resize(m_SubresWritten.size());
+
+            const auto Alignment = GetKTX2LevelAlignment(m_Desc.Format);
+
+            Uint64 Offset = Header.size();
+            for (Uint32 Mip = m_Desc.MipLevels; Mip-- > 0;)
+            {
+                const auto MipSize = GetMipLevelProperties(m_Desc, Mip).MipSize;
+
+                Offset              = (Offset + Alignment - 1) / Alignment * Alignment;
+                m_LevelOffsets[Mip] = Offset;
+                m_LevelSizes[Mip]   = MipSize * ArraySize;
+                for (Uint32 Slice = 0; Slice < ArraySize; ++Slice)
+                    m_SubresOffsets[size_t{Slice} * m_Desc.MipLevels + Mip] = Offset + MipSize * Slice;
+                Offset += m_LevelSizes[Mip];
+            }
+        }
+        else
+        {
+            m_CompressedLevels.resize(m_Desc.MipLevels);
+            for (auto& pLevel : m_CompressedLevels)
+            {
+                pLevel.reset(new CompressedLevel);
+                pLevel->NumPendingSlices.store(ArraySize);
+            }
+        }
+    }
+
+    if (!m_pFile->Open(FilePath))
+        LOG_ERROR_AND_THROW("Failed to create file '", FilePath, "'.");
+}
+
+TextureFileWriter::~TextureFileWriter()
+{
+    WaitForTasks();
+}
+
+bool TextureFileWriter::CreateHeader(std::vector<Uint8>& Header) const
+{
+    if (m_FileFormat == IMAGE_FILE_FORMAT_DDS)
+        return CreateDDSFileHeader(m_Desc, Header);
+
+    if (m_LevelOffsets.empty())
+    {
+        // The header size does not depend on the level offsets and sizes
+        std::vector<Uint64> Zeros(m_Desc.MipLevels);
+        return CreateKTX2FileHeader(m_Desc, m_CompressionLevel != 0, Zeros.data(), Zeros.data(), Header);
+    }
+    return CreateKTX2FileHeader(m_Desc, m_CompressionLevel != 0, m_LevelOffsets.data(), m_LevelSizes.data(), Header);
+}
+
+void TextureFileWriter::SetError(std::string Msg)
+{
+    // Only the first error is reported
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    if (m_Error.empty())
+        m_Error = std::move(Msg);
+}
+
+void TextureFileWriter::WriteSubresource(Uint32 MipLevel, Uint32 ArraySlice, const TextureSubResData& SubResData)
+{
+    DEV_CHECK_ERR(MipLevel < m_Desc.MipLevels, "Mip level (", MipLevel, ") is out of range");
+    DEV_CHECK_ERR(ArraySlice < m_Desc.GetArraySize(), "Array slice (", ArraySlice, ") is out of range");
+    DEV_CHECK_ERR(SubResData.pData != nullptr, "Subresource data must be in CPU memory");
+
+    const auto Subres = size_t{ArraySlice} * m_Desc.MipLevels + MipLevel;
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        DEV_CHECK_ERR(!m_Finished, "The file has already been finished");
+        if (m_SubresWritten[Subres])
+        {
+            DEV_ERROR("Subresource (mip ", MipLevel, ", slice ", ArraySlice, ") has already been written");
+            return;
+        }
+        m_SubresWritten[Subres] = true;
+    }
+
+    const auto& FmtAttribs  = GetTextureFormatAttribs(m_Desc.Format);
+    const auto  MipProps    = GetMipLevelProperties(m_Desc, MipLevel);
+    const auto  RowSize     = StaticCast<size_t>(MipProps.RowSize);
+    const auto  SliceSize   = StaticCast<size_t>(MipProps.DepthSliceSize);
+    const auto  MipSize     = StaticCast<size_t>(MipProps.MipSize);
+    const auto  NumRows     = MipProps.StorageHeight / FmtAttribs.BlockHeight;
+    const auto  Stride      = StaticCast<size_t>(SubResData.Stride);
+    const auto  DepthStride = StaticCast<size_t>(SubResData.DepthStride);
+    const auto* pSrc        = static_cast<const Uint8*>(SubResData.pData);
+    VERIFY(Stride >= RowSize, "Row stride is too small");
+
+    // Tightly packed data is written without a copy
+    const bool IsPacked = Stride == RowSize && (MipProps.Depth == 1 || DepthStride == SliceSize);
+
+    CompressedLevel*   pLevel = !m_CompressedLevels.empty() ? m_CompressedLevels[MipLevel].get() : nullptr;
+    std::vector<Uint8> PackedData;
+    Uint8*             pDst = nullptr;
+    if (pLevel != nullptr)
+    {
+        {
+            // The first slice to arrive allocates the level
+            std::lock_guard<std::mutex> Lock{m_Mtx};
+            if (pLevel->Data.empty())
+                pLevel->Data.resize(MipSize * m_Desc.GetArraySize());
+        }
+        pDst = pLevel->Data.data() + MipSize * ArraySlice;
+    }
+    else if (!IsPacked)
+    {
+        PackedData.resize(MipSize);
+        pDst = PackedData.data();
+    }
+
+    if (pDst != nullptr)
+    {
+        for (Uint32 z = 0; z < MipProps.Depth; ++z)
+        {
+            const auto* pSrcSlice = pSrc + DepthStride * z;
+            auto*       pDstSlice = pDst + SliceSize * z;
+            if (Stride == RowSize)
+            {
+                memcpy(pDstSlice, pSrcSlice, RowSize * NumRows);
+            }
+            else
+            {
+                for (Uint32 row = 0; row < NumRows; ++row)
+                    memcpy(pDstSlice + RowSize * row, pSrcSlice + Stride * row, RowSize);
+            }
+        }
+    }
+
+    if (pLevel != nullptr)
+    {
+        if (pLevel->NumPendingSlices.fetch_sub(1) == 1)
+            CompressLevel(MipLevel);
+        return;
+    }
+
+    if (!m_pFile->Write(IsPacked ? pSrc : PackedData.data(), MipSize, m_SubresOffsets[Subres]))
+        SetError(FormatString("Failed to write subresource (mip ", MipLevel, ", slice ", ArraySlice, ") to file '", m_FilePath, "'."));
+}
+
+void TextureFileWriter::CompressLevel(Uint32 MipLevel)
+{
+    auto& Level = *m_CompressedLevels[MipLevel];
+
+    const auto NumChunks = std::max((Level.Data.size() + CompressionChunkSize - 1) / CompressionChunkSize, size_t{1});
+    Level.Chunks.resize(NumChunks);
+    Level.ChunkAdlers.resize(NumChunks);
+    Level.NumPendingChunks.store(NumChunks);
+
+    if (m_pThreadPool == nullptr || NumChunks == 1)
+    {
+        for (size_t Chunk = 0; Chunk < NumChunks; ++Chunk)
+            CompressChunk(MipLevel, Chunk);
+        return;
+    }
+
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    Tasks.reserve(NumChunks);
+    for (size_t Chunk = 0; Chunk < NumChunks; ++Chunk)
+    {
+        Tasks.emplace_back(EnqueueAsyncWork(m_pThreadPool, [this, MipLevel, Chunk](Uint32) {
+            CompressChunk(MipLevel, Chunk);
+        }));
+    }
+
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    m_Tasks.insert(m_Tasks.end(), std::make_move_iterator(Tasks.begin()), std::make_move_iterator(Tasks.end()));
+}
+
+void TextureFileWriter::CompressChunk(Uint32 MipLevel, size_t Chunk)
+{
+    auto& Level = *m_CompressedLevels[MipLevel];
+
+    const auto  Offset         = Chunk * CompressionChunkSize;
+    const auto  Size           = std::min(CompressionChunkSize, Level.Data.size() - Offset);
+    const auto  DictionarySize = std::min(Offset, DeflateWindowSize);
+    const auto* pSrc           = Level.Data.data() + Offset;
+    const bool  IsLast         = Chunk + 1 == Level.Chunks.size();
+
+    if (!DeflateChunk(pSrc, Size, pSrc - DictionarySize, DictionarySize, IsLast, static_cast<int>(m_CompressionLevel), Level.Chunks[Chunk]))
+        SetError(FormatString("Failed to compress mip level ", MipLevel, " of file '", m_FilePath, "'."));
+    Level.ChunkAdlers[Chunk] = static_cast<Uint32>(adler32(adler32(0L, Z_NULL, 0), pSrc, static_cast<uInt>(Size)));
+
+    // The thread that compresses the last chunk joins the chunks
+    if (Level.NumPendingChunks.fetch_sub(1) == 1)
+        AssembleLevel(MipLevel);
+}
+
+void TextureFileWriter::AssembleLevel(Uint32 MipLevel)
+{
+    auto& Level = *m_CompressedLevels[MipLevel];
+
+    size_t CompressedSize = 2 + 4; // zlib header and Adler-32 checksum
+    for (const auto& Chunk : Level.Chunks)
+        CompressedSize += Chunk.size();
+
+    auto& Compressed = Level.Compressed;
+    Compressed.reserve(CompressedSize);
+
+    // Deflate with 32K window, no preset dictionary, (CMF * 256 + FLG) % 31 == 0
+    Compressed.push_back(0x78);
+    Compressed.push_back(0x01);
+
+    uLong Adler = adler32(0L, Z_NULL, 0);
+    for (size_t Chunk = 0; Chunk < Level.Chunks.size(); ++Chunk)
+    {
+        const auto ChunkSize = std::min(CompressionChunkSize, Level.Data.size() - Chunk * CompressionChunkSize);
+        Adler                = adler32_combine(Adler, Level.ChunkAdlers[Chunk], static_cast<z_off_t>(ChunkSize));
+        Compressed.insert(Compressed.end(), Level.Chunks[Chunk].begin(), Level.Chunks[Chunk].end());
+    }
+    for (int Shift = 24; Shift >= 0; Shift -= 8)
+        Compressed.push_back(static_cast<Uint8>((Adler >> Shift) & 0xFFu));
+
+    Level.Chunks = {};
+    Level.Data   = {};
+}
+
+void TextureFileWriter::WaitForTasks()
+{
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        Tasks.swap(m_Tasks);
+    }
+    for (auto& pTask : Tasks)
+        pTask->WaitForCompletion();
+}
+
+bool TextureFileWriter::Finish()
+{
+    DEV_CHECK_ERR(!m_Finished, "The file has already been finished");
+
+    WaitForTasks();
+
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+        m_Finished = true;
+
+        const auto Missing = std::find(m_SubresWritten.begin(), m_SubresWritten.end(), false);
+        if (Missing != m_SubresWritten.end() && m_Error.empty())
+        {
+            const auto Subres = static_cast<Uint32>(Missing - m_SubresWritten.begin());
+            m_Error           = FormatString("Subresource (mip ", Subres % m_Desc.MipLevels, ", slice ", Subres / m_Desc.MipLevels, ") of file '", m_FilePath, "' has not been written.");
+        }
+    }
+
+    std::vector<Uint8> Header;
+    if (m_Error.empty() && !m_CompressedLevels.empty())
+    {
+        if (!CreateHeader(Header))
+            m_Error = "Failed to create the file header";
+
+        // Compressed levels are arranged from the smallest to the largest
+        Uint64 Offset = Header.size();
+        for (Uint32 Mip = m_Desc.MipLevels; Mip-- > 0 && m_Error.empty();)
+        {
+            auto& Compressed    = m_CompressedLevels[Mip]->Compressed;
+            m_LevelOffsets[Mip] = Offset;
+            m_LevelSizes[Mip]   = Compressed.size();
+            if (!m_pFile->Write(Compressed.data(), Compressed.size(), Offset))
+                m_Error = FormatString("Failed to write mip level ", Mip, " to file '", m_FilePath, "'.");
+            Offset += Compressed.size();
+            Compressed = {};
+        }
+    }
+
+    if (m_Error.empty())
+    {
+        if (!CreateHeader(Header))
+            m_Error = "Failed to create the file header";
+        else if (!m_pFile->Write(Header.data(), Header.size(), 0))
+            m_Error = FormatString("Failed to write the header of file '", m_FilePath, "'.");
+    }
+
+    if (!m_pFile->Close() && m_Error.empty())
+        m_Error = FormatString("Failed to close file '", m_FilePath, "'.");
+
+    if (!m_Error.empty())
+    {
+        LOG_ERROR_MESSAGE(m_Error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace Diligent
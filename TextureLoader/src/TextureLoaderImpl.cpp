@@ -27,8 +27,14 @@
 
 #include "pch.h"
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
 #include <limits>
 #include <math.h>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "TextureLoaderImpl.hpp"
@@ -40,8 +46,14 @@
 #include "ColorConversion.h"
 #include "Image.h"
 #include "FileWrapper.hpp"
+#include "FileSystem.hpp"
 #include "DataBlobImpl.hpp"
+#include "MappedFileDataBlob.hpp"
 #include "Align.hpp"
+#include "BCTools.h"
+#include "ThreadPool.hpp"
+#include "HalfFloat.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
 
 extern "C"
 {
@@ -49,16 +61,31 @@ extern "C"
                                                    Diligent::IDataBlob* pDstPixels,
                                                    Diligent::ImageDesc* pDstImgDesc);
 
-    Diligent::ENCODE_PNG_RESULT Diligent_EncodePng(const Diligent::Uint8* pSrcPixels,
-                                                   Diligent::Uint32       Width,
-                                                   Diligent::Uint32       Height,
-                                                   Diligent::Uint32       StrideInBytes,
-                                                   int                    PngColorType,
-                                                   Diligent::IDataBlob*   pDstPngBits);
+    Diligent::DECODE_PNG_RESULT Diligent_DecodePngIntoMemory(Diligent::IDataBlob* pSrcPngBits,
+                                                             void*                pDstPixels,
+                                                             Diligent::Uint32     DstStride,
+                                                             Diligent::Uint32     DstCompCount,
+                                                             Diligent::ImageDesc* pDstImgDesc);
+
+    Diligent::ENCODE_PNG_RESULT Diligent_EncodePng(const Diligent::Uint8*            pSrcPixels,
+                                                   Diligent::Uint32                  Width,
+                                                   Diligent::Uint32                  Height,
+                                                   Diligent::Uint32                  StrideInBytes,
+                                                   int                               PngColorType,
+                                                   Diligent::IDataBlob*              pDstPngBits,
+                                                   const Diligent::PngEncodeOptions* pOptions);
 
     Diligent::DECODE_JPEG_RESULT Diligent_DecodeJpeg(Diligent::IDataBlob* pSrcJpegBits,
                                                      Diligent::IDataBlob* pDstPixels,
-                                                     Diligent::ImageDesc* pDstImgDesc);
+                                                     Diligent::ImageDesc* pDstImgDesc,
+                                                     Diligent::Uint32     ScaleDenom);
+
+    Diligent::DECODE_JPEG_RESULT Diligent_DecodeJpegIntoMemory(Diligent::IDataBlob* pSrcJpegBits,
+                                                               void*                pDstPixels,
+                                                               Diligent::Uint32     DstStride,
+                                                               Diligent::Uint32     DstCompCount,
+                                                               Diligent::ImageDesc* pDstImgDesc,
+                                                               Diligent::Uint32     ScaleDenom);
 
     Diligent::ENCODE_JPEG_RESULT Diligent_EncodeJpeg(Diligent::Uint8*     pSrcRGBData,
                                                      Diligent::Uint32     Width,
@@ -66,9 +93,10 @@ extern "C"
                                                      int                  quality,
                                                      Diligent::IDataBlob* pDstJpegBits);
 
-    Diligent::DECODE_JPEG_RESULT Diligent_LoadSGI(Diligent::IDataBlob* pSrcJpegBits,
-                                                  Diligent::IDataBlob* pDstPixels,
-                                                  Diligent::ImageDesc* pDstImgDesc);
+    bool Diligent_LoadSGI(Diligent::IDataBlob*   pSGIData,
+                          Diligent::IDataBlob*   pDstPixels,
+                          Diligent::ImageDesc*   pDstImgDesc,
+                          Diligent::IThreadPool* pThreadPool);
 }
 
 namespace Diligent
@@ -81,22 +109,43 @@ DECODE_PNG_RESULT DecodePng(IDataBlob* pSrcPngBits,
     return Diligent_DecodePng(pSrcPngBits, pDstPixels, pDstImgDesc);
 }
 
-ENCODE_PNG_RESULT EncodePng(const Uint8* pSrcPixels,
-                            Uint32       Width,
-                            Uint32       Height,
-                            Uint32       StrideInBytes,
-                            int          PngColorType,
-                            IDataBlob*   pDstPngBits)
+DECODE_PNG_RESULT DecodePngIntoMemory(IDataBlob* pSrcPngBits,
+                                      void*      pDstPixels,
+                                      Uint32     DstStride,
+                                      Uint32     DstCompCount,
+                                      ImageDesc* pDstImgDesc)
 {
-    return Diligent_EncodePng(pSrcPixels, Width, Height, StrideInBytes, PngColorType, pDstPngBits);
+    return Diligent_DecodePngIntoMemory(pSrcPngBits, pDstPixels, DstStride, DstCompCount, pDstImgDesc);
+}
+
+ENCODE_PNG_RESULT EncodePng(const Uint8*            pSrcPixels,
+                            Uint32                  Width,
+                            Uint32                  Height,
+                            Uint32                  StrideInBytes,
+                            int                     PngColorType,
+                            IDataBlob*              pDstPngBits,
+                            const PngEncodeOptions* pOptions)
+{
+    return Diligent_EncodePng(pSrcPixels, Width, Height, StrideInBytes, PngColorType, pDstPngBits, pOptions);
 }
 
 
 DECODE_JPEG_RESULT DecodeJpeg(IDataBlob* pSrcJpegBits,
                               IDataBlob* pDstPixels,
-                              ImageDesc* pDstImgDesc)
+                              ImageDesc* pDstImgDesc,
+                              Uint32     ScaleDenom)
 {
-    return Diligent_DecodeJpeg(pSrcJpegBits, pDstPixels, pDstImgDesc);
+    return Diligent_DecodeJpeg(pSrcJpegBits, pDstPixels, pDstImgDesc, ScaleDenom);
+}
+
+DECODE_JPEG_RESULT DecodeJpegIntoMemory(IDataBlob* pSrcJpegBits,
+                                        void*      pDstPixels,
+                                        Uint32     DstStride,
+                                        Uint32     DstCompCount,
+                                        ImageDesc* pDstImgDesc,
+                                        Uint32     ScaleDenom)
+{
+    return Diligent_DecodeJpegIntoMemory(pSrcJpegBits, pDstPixels, DstStride, DstCompCount, pDstImgDesc, ScaleDenom);
 }
 
 ENCODE_JPEG_RESULT EncodeJpeg(Uint8*     pSrcRGBPixels,
@@ -116,9 +165,68 @@ static TextureDesc TexDescFromTexLoadInfo(const TextureLoadInfo& TexLoadInfo, co
     TexDesc.Usage          = TexLoadInfo.Usage;
     TexDesc.BindFlags      = TexLoadInfo.BindFlags;
     TexDesc.CPUAccessFlags = TexLoadInfo.CPUAccessFlags;
+
+    TexDesc.ImmediateContextMask = TexLoadInfo.ImmediateContextMask;
     return TexDesc;
 }
 
+static IMemoryAllocator& GetLoaderAllocator(const TextureLoadInfo& TexLoadInfo)
+{
+    return TexLoadInfo.pAllocator != nullptr ? *TexLoadInfo.pAllocator : DefaultRawMemoryAllocator::GetAllocator();
+}
+
+// Returns the number of components the decoded image will be converted to by LoadFromImage(),
+// or 0 if the image components are used as is. PNG and JPEG decoders use this value to write
+// the components directly instead of decoding the image and copying it again.
+static Uint32 GetImageComponentCountForTexture(const TextureLoadInfo& TexLoadInfo, IMAGE_FILE_FORMAT FileFormat, IDataBlob* pFileData)
+{
+    if (TexLoadInfo.Format != TEX_FORMAT_UNKNOWN)
+    {
+        const auto& FmtAttribs  = GetTextureFormatAttribs(TexLoadInfo.Format);
+        const auto  ImageFormat = FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED ? GetBCDecompressedFormat(TexLoadInfo.Format) : TexLoadInfo.Format;
+        return ImageFormat != TEX_FORMAT_UNKNOWN ? GetTextureFormatAttribs(ImageFormat).NumComponents : 0;
+    }
+
+    // There are no 3-component formats, so RGB images are expanded to RGBA
+    ImageDesc Desc;
+    if (FileFormat == IMAGE_FILE_FORMAT_PNG && DecodePngIntoMemory(pFileData, nullptr, 0, 0, &Desc) != DECODE_PNG_RESULT_OK)
+        return 0;
+    if (FileFormat == IMAGE_FILE_FORMAT_JPEG && DecodeJpegIntoMemory(pFileData, nullptr, 0, 0, &Desc) != DECODE_JPEG_RESULT_OK)
+        return 0;
+    return Desc.NumComponents == 3 ? 4 : 0;
+}
+
+// Returns the number of top mip levels to skip, so that no dimension of the remaining levels exceeds MaxDimension
+static Uint32 ComputeNumSkippedMipLevels(Uint32 Width, Uint32 Height, Uint32 Depth, Uint32 MaxDimension)
+{
+    if (MaxDimension == 0)
+        return 0;
+
+    Uint32 NumLevels = 0;
+    while (std::max(std::max(Width, Height), Depth) > MaxDimension)
+    {
+        Width  = std::max(Width / 2u, 1u);
+        Height = std::max(Height / 2u, 1u);
+        Depth  = std::max(Depth / 2u, 1u);
+        ++NumLevels;
+    }
+    return NumLevels;
+}
+
+// Returns the JPEG scale denominator that reduces the image as much as MaxDimension allows, up to 1/8
+static Uint32 GetJpegScaleDenom(const TextureLoadInfo& TexLoadInfo, IDataBlob* pFileData)
+{
+    if (TexLoadInfo.MaxDimension == 0)
+        return 1;
+
+    ImageDesc Desc;
+    if (DecodeJpegIntoMemory(pFileData, nullptr, 0, 0, &Desc) != DECODE_JPEG_RESULT_OK)
+        return 1;
+
+    const auto NumSkippedLevels = ComputeNumSkippedMipLevels(Desc.Width, Desc.Height, 1, TexLoadInfo.MaxDimension);
+    return 1u << std::min(NumSkippedLevels, 3u);
+}
+
 TextureLoaderImpl::TextureLoaderImpl(IReferenceCounters*        pRefCounters,
                                      const TextureLoadInfo&     TexLoadInfo,
                                      const Uint8*               pData,
@@ -127,7 +235,8 @@ TextureLoaderImpl::TextureLoaderImpl(IReferenceCounters*        pRefCounters,
     TBase{pRefCounters},
     m_pDataBlob{std::move(pDataBlob)},
     m_Name{TexLoadInfo.Name != nullptr ? TexLoadInfo.Name : ""},
-    m_TexDesc{TexDescFromTexLoadInfo(TexLoadInfo, m_Name)}
+    m_TexDesc{TexDescFromTexLoadInfo(TexLoadInfo, m_Name)},
+    m_Allocator{GetLoaderAllocator(TexLoadInfo)}
 {
     const auto ImgFileFormat = Image::GetFileFormat(pData, DataSize);
     if (ImgFileFormat == IMAGE_FILE_FORMAT_UNKNOWN)
@@ -138,14 +247,20 @@ TextureLoaderImpl::TextureLoaderImpl(IReferenceCounters*        pRefCounters,
     if (ImgFileFormat == IMAGE_FILE_FORMAT_PNG ||
         ImgFileFormat == IMAGE_FILE_FORMAT_JPEG ||
         ImgFileFormat == IMAGE_FILE_FORMAT_TIFF ||
-        ImgFileFormat == IMAGE_FILE_FORMAT_SGI)
+        ImgFileFormat == IMAGE_FILE_FORMAT_SGI ||
+        ImgFileFormat == IMAGE_FILE_FORMAT_HDR)
     {
         ImageLoadInfo ImgLoadInfo;
-        ImgLoadInfo.Format = ImgFileFormat;
+        ImgLoadInfo.Format      = ImgFileFormat;
+        ImgLoadInfo.pThreadPool = TexLoadInfo.pThreadPool;
         if (!m_pDataBlob)
         {
             m_pDataBlob = DataBlobImpl::Create(DataSize, pData);
         }
+        if (ImgFileFormat == IMAGE_FILE_FORMAT_PNG || ImgFileFormat == IMAGE_FILE_FORMAT_JPEG)
+            ImgLoadInfo.NumComponents = GetImageComponentCountForTexture(TexLoadInfo, ImgFileFormat, m_pDataBlob);
+        if (ImgFileFormat == IMAGE_FILE_FORMAT_JPEG)
+            ImgLoadInfo.ScaleDenom = GetJpegScaleDenom(TexLoadInfo, m_pDataBlob);
         Image::CreateFromDataBlob(m_pDataBlob, ImgLoadInfo, &m_pImage);
         LoadFromImage(TexLoadInfo);
         m_pDataBlob.Release();
@@ -160,6 +275,15 @@ TextureLoaderImpl::TextureLoaderImpl(IReferenceCounters*        pRefCounters,
         {
             LoadFromKTX(TexLoadInfo, pData, DataSize);
         }
+
+        if (TexLoadInfo.MaxDimension != 0)
+        {
+            const auto Depth            = m_TexDesc.Type == RESOURCE_DIM_TEX_3D ? m_TexDesc.Depth : 1u;
+            const auto NumSkippedLevels = ComputeNumSkippedMipLevels(m_TexDesc.Width, m_TexDesc.Height, Depth, TexLoadInfo.MaxDimension);
+            // At least one level must remain
+            if (NumSkippedLevels > 0 && m_TexDesc.MipLevels > 1)
+                SkipTopMipLevels(std::min(NumSkippedLevels, m_TexDesc.MipLevels - 1));
+        }
     }
 
     if (TexLoadInfo.IsSRGB)
@@ -174,33 +298,689 @@ TextureLoaderImpl::TextureLoaderImpl(IReferenceCounters*    pRefCounters,
     TBase{pRefCounters},
     m_pImage{pImage},
     m_Name{TexLoadInfo.Name != nullptr ? TexLoadInfo.Name : ""},
-    m_TexDesc{TexDescFromTexLoadInfo(TexLoadInfo, m_Name)}
+    m_TexDesc{TexDescFromTexLoadInfo(TexLoadInfo, m_Name)},
+    m_Allocator{GetLoaderAllocator(TexLoadInfo)}
 {
     LoadFromImage(TexLoadInfo);
 }
 
+TextureLoaderImpl::TextureLoaderImpl(IReferenceCounters*                          pRefCounters,
+                                     const TextureLoadInfo&                       TexLoadInfo,
+                                     RESOURCE_DIMENSION                           Type,
+                                     std::vector<RefCntAutoPtr<ITextureLoader>>&& SliceLoaders) :
+    TBase{pRefCounters},
+    m_Name{TexLoadInfo.Name != nullptr ? TexLoadInfo.Name : ""},
+    m_TexDesc{TexDescFromTexLoadInfo(TexLoadInfo, m_Name)},
+    m_Allocator{GetLoaderAllocator(TexLoadInfo)},
+    m_SliceLoaders{std::move(SliceLoaders)}
+{
+    VERIFY_EXPR(!m_SliceLoaders.empty());
+
+    const auto& SliceDesc = m_SliceLoaders[0]->GetTextureDesc();
+    for (Uint32 i = 0; i < m_SliceLoaders.size(); ++i)
+    {
+        const auto& Desc = m_SliceLoaders[i]->GetTextureDesc();
+        if (Desc.Type != RESOURCE_DIM_TEX_2D)
+            LOG_ERROR_AND_THROW("Slice ", i, " is not a 2D texture");
+        if (Desc.Width != SliceDesc.Width || Desc.Height != SliceDesc.Height)
+        {
+            LOG_ERROR_AND_THROW("Size of slice ", i, " (", Desc.Width, "x", Desc.Height, ") does not match the size of slice 0 (",
+                                SliceDesc.Width, "x", SliceDesc.Height, ")");
+        }
+        if (Desc.Format != SliceDesc.Format)
+        {
+            LOG_ERROR_AND_THROW("Format of slice ", i, " (", GetTextureFormatAttribs(Desc.Format).Name, ") does not match the format of slice 0 (",
+                                GetTextureFormatAttribs(SliceDesc.Format).Name, ")");
+        }
+        if (Desc.MipLevels != SliceDesc.MipLevels)
+        {
+            LOG_ERROR_AND_THROW("The number of mip levels of slice ", i, " (", Desc.MipLevels, ") does not match the number of mip levels of slice 0 (",
+                                SliceDesc.MipLevels, ")");
+        }
+    }
+    if ((Type == RESOURCE_DIM_TEX_CUBE || Type == RESOURCE_DIM_TEX_CUBE_ARRAY) && SliceDesc.Width != SliceDesc.Height)
+        LOG_ERROR_AND_THROW("Cubemap faces must be square, but the slice size is ", SliceDesc.Width, "x", SliceDesc.Height);
+
+    m_TexDesc.Type      = Type;
+    m_TexDesc.Width     = SliceDesc.Width;
+    m_TexDesc.Height    = SliceDesc.Height;
+    m_TexDesc.ArraySize = static_cast<Uint32>(m_SliceLoaders.size());
+    m_TexDesc.Format    = SliceDesc.Format;
+    m_TexDesc.MipLevels = SliceDesc.MipLevels;
+    m_TexDesc.BindFlags = SliceDesc.BindFlags;
+    m_TexDesc.MiscFlags = SliceDesc.MiscFlags;
+
+    m_GenerateMipsOnGPU = ClassPtrCast<TextureLoaderImpl>(m_SliceLoaders[0].RawPtr())->m_GenerateMipsOnGPU;
+
+    // Subresources reference the data owned by the slice loaders
+    m_SubResources.resize(size_t{m_TexDesc.ArraySize} * m_TexDesc.MipLevels);
+    for (Uint32 Slice = 0; Slice < m_TexDesc.ArraySize; ++Slice)
+    {
+        for (Uint32 Mip = 0; Mip < m_TexDesc.MipLevels; ++Mip)
+            m_SubResources[Slice * m_TexDesc.MipLevels + Mip] = m_SliceLoaders[Slice]->GetSubresourceData(Mip, 0);
+    }
+}
+
 void TextureLoaderImpl::CreateTexture(IRenderDevice* pDevice,
                                       ITexture**     ppTexture)
 {
+    DILIGENT_TRACE_ZONE("TextureLoader::CreateTexture");
+
+    if (m_CPUDataReleased)
+    {
+        LOG_ERROR_MESSAGE("Texture '", m_Name, "' can't be created because the loader's CPU data has been released");
+        return;
+    }
+    if (m_GenerateMipsOnGPU)
+    {
+        LOG_ERROR_MESSAGE("Texture '", m_Name, "' was loaded with GenerateMipsOnGPU flag and must be created with CreateStreamingTexture()");
+        return;
+    }
+
     TextureData InitData{m_SubResources.data(), static_cast<Uint32>(m_SubResources.size())};
     pDevice->CreateTexture(m_TexDesc, &InitData, ppTexture);
 }
 
+// Returns true if the context can't execute graphics commands, e.g. the context of a transfer queue.
+// Uploads recorded by such a context release the texture to other queues by transitioning it to the common state.
+static bool IsTransferContext(IDeviceContext* pContext)
+{
+    const auto QueueType = pContext->GetDesc().QueueType;
+    return QueueType != COMMAND_QUEUE_TYPE_UNKNOWN && (QueueType & COMMAND_QUEUE_TYPE_GRAPHICS) != COMMAND_QUEUE_TYPE_GRAPHICS;
+}
+
+static void ReleaseToOtherQueues(IDeviceContext* pContext, ITexture* pTexture)
+{
+    StateTransitionDesc Barrier{pTexture, RESOURCE_STATE_UNKNOWN, RESOURCE_STATE_COMMON, STATE_TRANSITION_FLAG_UPDATE_STATE};
+    pContext->TransitionResourceStates(1, &Barrier);
+}
+
+void TextureLoaderImpl::UploadSubresource(IDeviceContext* pContext, ITexture* pTexture, Uint32 MipLevel, Uint32 ArraySlice)
+{
+    const auto MipProps = GetMipLevelProperties(m_TexDesc, MipLevel);
+
+    Box DstBox;
+    DstBox.MaxX = MipProps.LogicalWidth;
+    DstBox.MaxY = MipProps.LogicalHeight;
+    DstBox.MaxZ = MipProps.Depth;
+    // Slices of 3D textures are addressed by the box, array slices - by the slice index
+    const auto Slice = m_TexDesc.Type == RESOURCE_DIM_TEX_3D ? 0 : ArraySlice;
+    pContext->UpdateTexture(pTexture, MipLevel, Slice, DstBox, GetSubresourceData(MipLevel, ArraySlice),
+                            RESOURCE_STATE_TRANSITION_MODE_TRANSITION, RESOURCE_STATE_TRANSITION_MODE_TRANSITION);
+}
+
+void TextureLoaderImpl::CreateStreamingTexture(IRenderDevice*  pDevice,
+                                               IDeviceContext* pContext,
+                                               Uint32          NumResidentMips,
+                                               ITexture**      ppTexture)
+{
+    DEV_CHECK_ERR(pDevice != nullptr && pContext != nullptr, "Device and context must not be null");
+    DEV_CHECK_ERR(ppTexture != nullptr && *ppTexture == nullptr, "Texture pointer must not be null and must not contain an object");
+    if (m_CPUDataReleased)
+    {
+        LOG_ERROR_MESSAGE("Texture '", m_Name, "' can't be created because the loader's CPU data has been released");
+        return;
+    }
+    const auto IsTransferUpload = IsTransferContext(pContext);
+    if (m_GenerateMipsOnGPU && IsTransferUpload)
+    {
+        LOG_ERROR_MESSAGE("Texture '", m_Name, "' was loaded with GenerateMipsOnGPU flag and can't be uploaded by a transfer queue context");
+        return;
+    }
+
+    auto Desc  = m_TexDesc;
+    Desc.Usage = USAGE_DEFAULT;
+    pDevice->CreateTexture(Desc, nullptr, ppTexture);
+    if (*ppTexture == nullptr)
+        return;
+
+    if (m_GenerateMipsOnGPU)
+    {
+        for (Uint32 Slice = 0; Slice < m_TexDesc.ArraySize; ++Slice)
+            UploadSubresource(pContext, *ppTexture, 0, Slice);
+        pContext->GenerateMips((*ppTexture)->GetDefaultView(TEXTURE_VIEW_SHADER_RESOURCE));
+        m_ResidentMip     = 0;
+        m_NextStreamSlice = 0;
+        return;
+    }
+
+    NumResidentMips   = std::max(std::min(NumResidentMips, m_TexDesc.MipLevels), Uint32{1});
+    m_ResidentMip     = m_TexDesc.MipLevels;
+    m_NextStreamSlice = 0;
+
+    const auto NumSlices = m_TexDesc.Type == RESOURCE_DIM_TEX_3D ? 1 : m_TexDesc.ArraySize;
+    while (m_ResidentMip > m_TexDesc.MipLevels - NumResidentMips)
+    {
+        --m_ResidentMip;
+        for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+            UploadSubresource(pContext, *ppTexture, m_ResidentMip, Slice);
+    }
+
+    if (IsTransferUpload)
+        ReleaseToOtherQueues(pContext, *ppTexture);
+}
+
+Uint32 TextureLoaderImpl::StreamMipLevels(IDeviceContext* pContext,
+                                          ITexture*       pTexture,
+                                          Uint64          ByteBudget)
+{
+    DEV_CHECK_ERR(pContext != nullptr && pTexture != nullptr, "Context and texture must not be null");
+
+    DILIGENT_TRACE_ZONE("TextureLoader::StreamMipLevels");
+
+    const auto NumSlices    = m_TexDesc.Type == RESOURCE_DIM_TEX_3D ? 1 : m_TexDesc.ArraySize;
+    Uint64     UploadedSize = 0;
+    while (m_ResidentMip > 0)
+    {
+        const auto Mip     = m_ResidentMip - 1;
+        const auto SubSize = GetMipLevelProperties(m_TexDesc, Mip).MipSize;
+        // Always upload at least one subresource to guarantee progress
+        if (UploadedSize > 0 && UploadedSize + SubSize > ByteBudget)
+            break;
+
+        UploadSubresource(pContext, pTexture, Mip, m_NextStreamSlice);
+        UploadedSize += SubSize;
+
+        if (++m_NextStreamSlice == NumSlices)
+        {
+            m_NextStreamSlice = 0;
+            m_ResidentMip     = Mip;
+        }
+    }
+
+    if (UploadedSize > 0 && IsTransferContext(pContext))
+        ReleaseToOtherQueues(pContext, pTexture);
+
+    DILIGENT_TRACE_COUNTER("TextureLoader::StreamedBytes", UploadedSize);
+
+    return m_ResidentMip;
+}
+
+size_t TextureLoaderImpl::GetCPUDataSize() const
+{
+    TextureLoaderMemoryStats Stats;
+    GetMemoryStats(Stats);
+    return Stats.SourceDataSize + Stats.ImageDataSize + Stats.MipDataSize;
+}
+
+void TextureLoaderImpl::GetMemoryStats(TextureLoaderMemoryStats& Stats) const
+{
+    Stats = {};
+    if (m_pDataBlob)
+        Stats.SourceDataSize += m_pDataBlob->GetSize();
+    if (m_pImage)
+        Stats.ImageDataSize += m_pImage->GetData()->GetSize();
+    for (const auto& Mip : m_Mips)
+        Stats.MipDataSize += Mip.size();
+    for (const auto& pSliceLoader : m_SliceLoaders)
+    {
+        TextureLoaderMemoryStats SliceStats;
+        pSliceLoader->GetMemoryStats(SliceStats);
+        Stats.SourceDataSize += SliceStats.SourceDataSize;
+        Stats.ImageDataSize += SliceStats.ImageDataSize;
+        Stats.MipDataSize += SliceStats.MipDataSize;
+    }
+
+    for (Uint32 mip = 0; mip < m_TexDesc.MipLevels; ++mip)
+        Stats.TextureSize += GetMipLevelProperties(m_TexDesc, mip).MipSize;
+    Stats.TextureSize *= m_TexDesc.Type == RESOURCE_DIM_TEX_3D ? 1 : m_TexDesc.ArraySize;
+}
+
+void TextureLoaderImpl::ReleaseCPUData()
+{
+    if (m_ResidentMip > 0)
+        LOG_WARNING_MESSAGE("Releasing CPU data of texture '", m_Name, "' that has not been fully streamed");
+
+    m_pDataBlob.Release();
+    m_pImage.Release();
+    std::vector<MipData>{}.swap(m_Mips);
+    m_SliceLoaders.clear();
+    // Keep the subresource array so that GetSubresourceData() remains valid
+    for (auto& SubRes : m_SubResources)
+        SubRes = TextureSubResData{};
+    m_ResidentMip     = 0;
+    m_NextStreamSlice = 0;
+    m_CPUDataReleased = true;
+}
+
+// Number of coarse mip rows processed by a single thread pool task
+static constexpr Uint32 MipGenerationBandRows = 64;
+
+// Power series of the zeroth-order modified Bessel function of the first kind
+static float BesselI0(float x)
+{
+    float Sum  = 1;
+    float Term = 1;
+    for (int k = 1; k < 16; ++k)
+    {
+        const float t = x / (2.f * static_cast<float>(k));
+        Term *= t * t;
+        Sum += Term;
+    }
+    return Sum;
+}
+
+// Kaiser-windowed sinc filter for 2x downsampling.
+// Tap k of coarse texel i samples fine texel 2 * i - 2 + k.
+struct KaiserMipFilter
+{
+    static constexpr int NumTaps = 6;
+
+    float Weights[NumTaps] = {};
+
+    KaiserMipFilter()
+    {
+        constexpr float Alpha  = 4;
+        constexpr float Radius = NumTaps / 2;
+        constexpr float Pi     = 3.14159265358979f;
+
+        float Sum = 0;
+        for (int k = 0; k < NumTaps; ++k)
+        {
+            // Distance from the fine texel center to the coarse texel center, in fine texels
+            const float d = static_cast<float>(k) - static_cast<float>(NumTaps - 1) * 0.5f;
+            // Sinc is stretched by the downsampling factor
+            const float x      = d * 0.5f;
+            const float Sinc   = x != 0 ? std::sin(Pi * x) / (Pi * x) : 1.f;
+            const float t      = d / Radius;
+            const float Window = BesselI0(Alpha * std::sqrt(std::max(1.f - t * t, 0.f))) / BesselI0(Alpha);
+
+            Weights[k] = Sinc * Window;
+            Sum += Weights[k];
+        }
+
+        for (auto& w : Weights)
+            w /= Sum;
+    }
+
+    static Uint32 ClampTap(int Idx, Uint32 Size)
+    {
+        return static_cast<Uint32>(std::min(std::max(Idx, 0), static_cast<int>(Size) - 1));
+    }
+};
+
+// Lookup tables that convert 8-bit values to floats and back without calling pow().
+struct UnormConversionLUT
+{
+    // The size of the linear-to-sRGB table. The step of 1/16383 keeps the error
+    // below 0.25 of the 8-bit sRGB quantization step even in the steepest region.
+    static constexpr Uint32 LinearToSRGBSize = 16384;
+
+    float UnormToFloat[256];
+    float SRGBToLinear[256];
+    Uint8 LinearToSRGB[LinearToSRGBSize];
+
+    UnormConversionLUT()
+    {
+        for (Uint32 i = 0; i < 256; ++i)
+        {
+            UnormToFloat[i] = static_cast<float>(i) / 255.f;
+            SRGBToLinear[i] = Diligent::SRGBToLinear(UnormToFloat[i]);
+        }
+        for (Uint32 i = 0; i < LinearToSRGBSize; ++i)
+        {
+            const auto SRGB = Diligent::LinearToSRGB(static_cast<float>(i) / static_cast<float>(LinearToSRGBSize - 1));
+            LinearToSRGB[i] = static_cast<Uint8>(std::min(SRGB, 1.f) * 255.f + 0.5f);
+        }
+    }
+
+    Uint8 FloatToUnorm8(float Val, bool IsSRGB) const
+    {
+        Val = std::min(std::max(Val, 0.f), 1.f);
+        return IsSRGB ?
+            LinearToSRGB[static_cast<Uint32>(Val * static_cast<float>(LinearToSRGBSize - 1) + 0.5f)] :
+            static_cast<Uint8>(Val * 255.f + 0.5f);
+    }
+
+    static const UnormConversionLUT& Get()
+    {
+        static const UnormConversionLUT LUT;
+        return LUT;
+    }
+};
+
+// Converts the filtered color of a premultiplied-alpha texel back to straight alpha
+inline void UnpremultiplyTexel(float* pTexel, Uint32 NumComponents)
+{
+    VERIFY_EXPR(NumComponents == 4);
+    const auto Alpha = pTexel[3];
+    if (Alpha > 1.f / 1024.f)
+    {
+        for (Uint32 c = 0; c < 3; ++c)
+            pTexel[c] /= Alpha;
+    }
+}
+
+template <typename ComponentType>
+struct KaiserTexelConverter;
+
+template <>
+struct KaiserTexelConverter<Uint8>
+{
+    KaiserTexelConverter(Uint32 _NumComponents, bool _IsSRGB, bool _PremultiplyAlpha) :
+        NumComponents{_NumComponents},
+        IsSRGB{_IsSRGB},
+        PremultiplyAlpha{_PremultiplyAlpha && _NumComponents == 4},
+        LUT{UnormConversionLUT::Get()}
+    {}
+
+    void ToFloat(const Uint8* pSrc, float* pDst, Uint32 Width) const
+    {
+        const float* ColorLUT = IsSRGB ? LUT.SRGBToLinear : LUT.UnormToFloat;
+        for (Uint32 x = 0; x < Width; ++x, pSrc += NumComponents, pDst += NumComponents)
+        {
+            for (Uint32 c = 0; c < NumComponents; ++c)
+                pDst[c] = (IsAlpha(c) ? LUT.UnormToFloat : ColorLUT)[pSrc[c]];
+            if (PremultiplyAlpha)
+            {
+                for (Uint32 c = 0; c < 3; ++c)
+                    pDst[c] *= pDst[3];
+            }
+        }
+    }
+
+    void FromFloat(float* pTexel, Uint8* pDst) const
+    {
+        if (PremultiplyAlpha)
+            UnpremultiplyTexel(pTexel, NumComponents);
+        for (Uint32 c = 0; c < NumComponents; ++c)
+            pDst[c] = LUT.FloatToUnorm8(pTexel[c], IsSRGB && !IsAlpha(c));
+    }
+
+private:
+    bool IsAlpha(Uint32 c) const
+    {
+        return NumComponents == 4 && c == 3;
+    }
+
+    const Uint32 NumComponents;
+    const bool   IsSRGB;
+    const bool   PremultiplyAlpha;
+
+    const UnormConversionLUT& LUT;
+};
+
+template <>
+struct KaiserTexelConverter<float>
+{
+    KaiserTexelConverter(Uint32 _NumComponents, bool, bool _PremultiplyAlpha) :
+        NumComponents{_NumComponents},
+        PremultiplyAlpha{_PremultiplyAlpha && _NumComponents == 4}
+    {}
+
+    void ToFloat(const float* pSrc, float* pDst, Uint32 Width) const
+    {
+        memcpy(pDst, pSrc, sizeof(float) * Width * NumComponents);
+        if (PremultiplyAlpha)
+        {
+            for (Uint32 x = 0; x < Width; ++x, pDst += 4)
+            {
+                for (Uint32 c = 0; c < 3; ++c)
+                    pDst[c] *= pDst[3];
+            }
+        }
+    }
+
+    void FromFloat(float* pTexel, float* pDst) const
+    {
+        if (PremultiplyAlpha)
+            UnpremultiplyTexel(pTexel, NumComponents);
+        memcpy(pDst, pTexel, sizeof(float) * NumComponents);
+    }
+
+private:
+    const Uint32 NumComponents;
+    const bool   PremultiplyAlpha;
+};
+
+// Computes rows [FirstRow, EndRow) of the coarse mip level using the Kaiser filter.
+// The filter is separable: fine rows are first filtered vertically into a single
+// row, which is then filtered horizontally.
+template <typename ComponentType>
+static void ComputeKaiserMipRows(const ComputeMipLevelAttribs& Attribs,
+                                 Uint32                        NumComponents,
+                                 bool                          IsSRGB,
+                                 bool                          PremultiplyAlpha,
+                                 Uint32                        FirstRow,
+                                 Uint32                        EndRow)
+{
+    static const KaiserMipFilter Filter;
+
+    const KaiserTexelConverter<ComponentType> Converter{NumComponents, IsSRGB, PremultiplyAlpha};
+
+    const auto FineWidth   = Attribs.FineMipWidth;
+    const auto FineHeight  = Attribs.FineMipHeight;
+    const auto CoarseWidth = std::max(FineWidth / 2u, 1u);
+    const auto RowSize     = size_t{FineWidth} * NumComponents;
+
+    std::vector<float> FineRow(RowSize);
+    std::vector<float> FilteredRow(RowSize);
+    for (Uint32 row = FirstRow; row < EndRow; ++row)
+    {
+        std::fill(FilteredRow.begin(), FilteredRow.end(), 0.f);
+        for (int k = 0; k < KaiserMipFilter::NumTaps; ++k)
+        {
+            const auto  FineRowIdx = KaiserMipFilter::ClampTap(static_cast<int>(row * 2) - 2 + k, FineHeight);
+            const auto* pSrcRow    = reinterpret_cast<const ComponentType*>(static_cast<const Uint8*>(Attribs.pFineMipData) + FineRowIdx * Attribs.FineMipStride);
+            Converter.ToFloat(pSrcRow, FineRow.data(), FineWidth);
+
+            const auto w = Filter.Weights[k];
+            for (size_t i = 0; i < RowSize; ++i)
+                FilteredRow[i] += w * FineRow[i];
+        }
+
+        auto* pDstRow = reinterpret_cast<ComponentType*>(static_cast<Uint8*>(Attribs.pCoarseMipData) + row * Attribs.CoarseMipStride);
+        for (Uint32 col = 0; col < CoarseWidth; ++col)
+        {
+            float Texel[4] = {};
+            for (int k = 0; k < KaiserMipFilter::NumTaps; ++k)
+            {
+                const auto FineCol = KaiserMipFilter::ClampTap(static_cast<int>(col * 2) - 2 + k, FineWidth);
+                for (Uint32 c = 0; c < NumComponents; ++c)
+                    Texel[c] += Filter.Weights[k] * FilteredRow[size_t{FineCol} * NumComponents + c];
+            }
+            Converter.FromFloat(Texel, pDstRow + size_t{col} * NumComponents);
+        }
+    }
+}
+
+// Computes rows [FirstRow, EndRow) of the coarse mip level of an 8-bit texture using the 2x2 box filter.
+// sRGB colors are averaged in linear space, and the conversions use lookup tables rather than pow().
+// When PremultiplyAlpha is true, colors are weighted by alpha.
+static void ComputeBoxMipRowsUnorm8(const ComputeMipLevelAttribs& Attribs,
+                                    Uint32                        NumComponents,
+                                    bool                          IsSRGB,
+                                    bool                          PremultiplyAlpha,
+                                    Uint32                        FirstRow,
+                                    Uint32                        EndRow)
+{
+    const auto& LUT = UnormConversionLUT::Get();
+
+    const float* ColorLUT    = IsSRGB ? LUT.SRGBToLinear : LUT.UnormToFloat;
+    const auto   HasAlpha    = NumComponents == 4;
+    const auto   NumColors   = HasAlpha ? 3u : NumComponents;
+    const auto   FineWidth   = Attribs.FineMipWidth;
+    const auto   FineHeight  = Attribs.FineMipHeight;
+    const auto   CoarseWidth = std::max(FineWidth / 2u, 1u);
+
+    for (Uint32 row = FirstRow; row < EndRow; ++row)
+    {
+        const auto* pFineData = static_cast<const Uint8*>(Attribs.pFineMipData);
+        const auto* pRow0     = pFineData + std::min(row * 2, FineHeight - 1) * Attribs.FineMipStride;
+        const auto* pRow1     = pFineData + std::min(row * 2 + 1, FineHeight - 1) * Attribs.FineMipStride;
+        auto*       pDstRow   = static_cast<Uint8*>(Attribs.pCoarseMipData) + row * Attribs.CoarseMipStride;
+        for (Uint32 col = 0; col < CoarseWidth; ++col, pDstRow += NumComponents)
+        {
+            const auto   x0         = std::min(col * 2, FineWidth - 1) * NumComponents;
+            const auto   x1         = std::min(col * 2 + 1, FineWidth - 1) * NumComponents;
+            const Uint8* pTexels[4] = {pRow0 + x0, pRow0 + x1, pRow1 + x0, pRow1 + x1};
+
+            float Weights[4] = {0.25f, 0.25f, 0.25f, 0.25f};
+            if (HasAlpha)
+            {
+                const Uint32 AlphaSum = Uint32{pTexels[0][3]} + pTexels[1][3] + pTexels[2][3] + pTexels[3][3];
+                // Fully transparent footprints keep the plain average so that the color is not lost
+                if (PremultiplyAlpha && AlphaSum > 0)
+                {
+                    for (Uint32 t = 0; t < 4; ++t)
+                        Weights[t] = static_cast<float>(pTexels[t][3]) / static_cast<float>(AlphaSum);
+                }
+                pDstRow[3] = static_cast<Uint8>((AlphaSum + 2) / 4);
+            }
+
+            for (Uint32 c = 0; c < NumColors; ++c)
+            {
+                float Color = 0;
+                for (Uint32 t = 0; t < 4; ++t)
+                    Color += Weights[t] * ColorLUT[pTexels[t][c]];
+                pDstRow[c] = LUT.FloatToUnorm8(Color, IsSRGB);
+            }
+        }
+    }
+}
+
+// Computes rows [FirstRow, EndRow) of the coarse mip level of a 16-bit float texture using the 2x2 box filter.
+static void ComputeBoxMipRowsFloat16(const ComputeMipLevelAttribs& Attribs,
+                                     Uint32                        NumComponents,
+                                     Uint32                        FirstRow,
+                                     Uint32                        EndRow)
+{
+    const auto FineWidth   = Attribs.FineMipWidth;
+    const auto FineHeight  = Attribs.FineMipHeight;
+    const auto CoarseWidth = std::max(FineWidth / 2u, 1u);
+
+    for (Uint32 row = FirstRow; row < EndRow; ++row)
+    {
+        const auto* pFineData = static_cast<const Uint8*>(Attribs.pFineMipData);
+        const auto* pRow0     = reinterpret_cast<const Uint16*>(pFineData + std::min(row * 2, FineHeight - 1) * Attribs.FineMipStride);
+        const auto* pRow1     = reinterpret_cast<const Uint16*>(pFineData + std::min(row * 2 + 1, FineHeight - 1) * Attribs.FineMipStride);
+        auto*       pDstRow   = reinterpret_cast<Uint16*>(static_cast<Uint8*>(Attribs.pCoarseMipData) + row * Attribs.CoarseMipStride);
+        for (Uint32 col = 0; col < CoarseWidth; ++col, pDstRow += NumComponents)
+        {
+            const auto x0 = std::min(col * 2, FineWidth - 1) * NumComponents;
+            const auto x1 = std::min(col * 2 + 1, FineWidth - 1) * NumComponents;
+            for (Uint32 c = 0; c < NumComponents; ++c)
+            {
+                const auto Sum = HalfToFloat(pRow0[x0 + c]) + HalfToFloat(pRow0[x1 + c]) +
+                    HalfToFloat(pRow1[x0 + c]) + HalfToFloat(pRow1[x1 + c]);
+                pDstRow[c] = FloatToHalf(Sum * 0.25f);
+            }
+        }
+    }
+}
+
+// Computes the coarse mip level. If the thread pool is provided, the level is split into
+// bands of MipGenerationBandRows rows that are processed in parallel.
+static void GenerateMipLevel(const ComputeMipLevelAttribs& Attribs,
+                             TEXTURE_LOAD_MIP_FILTER       MipFilter,
+                             bool                          PremultiplyAlpha,
+                             IThreadPool*                  pThreadPool)
+{
+    const auto& FmtAttribs = GetTextureFormatAttribs(Attribs.Format);
+
+    const auto IsSRGB    = FmtAttribs.ComponentType == COMPONENT_TYPE_UNORM_SRGB;
+    const auto IsUnorm8  = (FmtAttribs.ComponentType == COMPONENT_TYPE_UNORM || IsSRGB) && FmtAttribs.ComponentSize == 1;
+    const auto IsFloat32 = FmtAttribs.ComponentType == COMPONENT_TYPE_FLOAT && FmtAttribs.ComponentSize == 4;
+    // Half-float textures always use the loader's box filter
+    const auto IsFloat16 = FmtAttribs.ComponentType == COMPONENT_TYPE_FLOAT && FmtAttribs.ComponentSize == 2;
+    const auto UseKaiser = !IsFloat16 && MipFilter == TEXTURE_LOAD_MIP_FILTER_KAISER && Attribs.AlphaCutoff == 0 && (IsUnorm8 || IsFloat32);
+    // The loader's box filter handles sRGB and premultiplied alpha. Other cases, as well as
+    // the most-frequent filter and alpha cutoff, are handled by ComputeMipLevel().
+    const auto UseUnorm8Box = !UseKaiser && IsUnorm8 && Attribs.AlphaCutoff == 0 &&
+        MipFilter != TEXTURE_LOAD_MIP_FILTER_MOST_FREQUENT && (IsSRGB || (PremultiplyAlpha && FmtAttribs.NumComponents == 4));
+
+    const auto CoarseHeight = std::max(Attribs.FineMipHeight / 2u, 1u);
+
+    auto ComputeRows = [&](Uint32 FirstRow, Uint32 EndRow) {
+        if (UseKaiser)
+        {
+            // Kaiser filter reads fine rows outside of the band, which is safe as the fine level is not modified
+            if (IsUnorm8)
+                ComputeKaiserMipRows<Uint8>(Attribs, FmtAttribs.NumComponents, IsSRGB, PremultiplyAlpha, FirstRow, EndRow);
+            else
+                ComputeKaiserMipRows<float>(Attribs, FmtAttribs.NumComponents, IsSRGB, PremultiplyAlpha, FirstRow, EndRow);
+        }
+        else if (UseUnorm8Box)
+        {
+            ComputeBoxMipRowsUnorm8(Attribs, FmtAttribs.NumComponents, IsSRGB, PremultiplyAlpha, FirstRow, EndRow);
+        }
+        else if (IsFloat16)
+        {
+            ComputeBoxMipRowsFloat16(Attribs, FmtAttribs.NumComponents, FirstRow, EndRow);
+        }
+        else
+        {
+            // Box and most-frequent filters only read the 2x2 footprint, so every band is
+            // processed as a separate image. The last band also takes the odd fine row, if any.
+            ComputeMipLevelAttribs BandAttribs = Attribs;
+
+            BandAttribs.pFineMipData   = static_cast<const Uint8*>(Attribs.pFineMipData) + size_t{FirstRow} * 2 * Attribs.FineMipStride;
+            BandAttribs.FineMipHeight  = EndRow < CoarseHeight ? (EndRow - FirstRow) * 2 : Attribs.FineMipHeight - FirstRow * 2;
+            BandAttribs.pCoarseMipData = static_cast<Uint8*>(Attribs.pCoarseMipData) + size_t{FirstRow} * Attribs.CoarseMipStride;
+            ComputeMipLevel(BandAttribs);
+        }
+    };
+
+    if (pThreadPool == nullptr || CoarseHeight <= MipGenerationBandRows)
+    {
+        ComputeRows(0, CoarseHeight);
+        return;
+    }
+
+    std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+    for (Uint32 FirstRow = 0; FirstRow < CoarseHeight; FirstRow += MipGenerationBandRows)
+    {
+        const auto EndRow = std::min(FirstRow + MipGenerationBandRows, CoarseHeight);
+        Tasks.emplace_back(EnqueueAsyncWork(pThreadPool, [&ComputeRows, FirstRow, EndRow](Uint32 ThreadId) {
+            ComputeRows(FirstRow, EndRow);
+        }));
+    }
+
+    for (auto& pTask : Tasks)
+        pTask->WaitForCompletion();
+}
+
 
 void TextureLoaderImpl::LoadFromImage(const TextureLoadInfo& TexLoadInfo)
 {
+    DILIGENT_TRACE_ZONE("TextureLoader::LoadFromImage");
+
     VERIFY_EXPR(m_pImage);
 
-    const auto& ImgDesc      = m_pImage->GetDesc();
+    const auto  ImgDesc      = m_pImage->GetDesc();
     const auto  ChannelDepth = GetValueSize(ImgDesc.ComponentType) * 8;
 
+    // Levels above MaxDimension are computed from the image and discarded before the mip chain is generated
+    const auto NumSkippedLevels = ComputeNumSkippedMipLevels(ImgDesc.Width, ImgDesc.Height, 1, TexLoadInfo.MaxDimension);
+
     m_TexDesc.Type      = RESOURCE_DIM_TEX_2D;
-    m_TexDesc.Width     = ImgDesc.Width;
-    m_TexDesc.Height    = ImgDesc.Height;
+    m_TexDesc.Width     = std::max(ImgDesc.Width >> NumSkippedLevels, 1u);
+    m_TexDesc.Height    = std::max(ImgDesc.Height >> NumSkippedLevels, 1u);
     m_TexDesc.MipLevels = ComputeMipLevelsCount(m_TexDesc.Width, m_TexDesc.Height);
     if (TexLoadInfo.MipLevels > 0)
         m_TexDesc.MipLevels = std::min(m_TexDesc.MipLevels, TexLoadInfo.MipLevels);
 
+    // When a BC format is requested, the mip chain is generated in the matching
+    // uncompressed format and every level is compressed at the end.
+    TEXTURE_FORMAT CompressedFormat = TEX_FORMAT_UNKNOWN;
+    if (m_TexDesc.Format != TEX_FORMAT_UNKNOWN && GetTextureFormatAttribs(m_TexDesc.Format).ComponentType == COMPONENT_TYPE_COMPRESSED)
+    {
+        CompressedFormat = m_TexDesc.Format;
+
+        const auto UncompressedFormat = GetBCDecompressedFormat(CompressedFormat);
+        if (UncompressedFormat == TEX_FORMAT_UNKNOWN || GetTextureFormatAttribs(UncompressedFormat).ComponentSize != 1)
+            LOG_ERROR_AND_THROW("Compressing images to ", GetTextureFormatAttribs(CompressedFormat).Name, " is not supported");
+        if (ChannelDepth != 8)
+            LOG_ERROR_AND_THROW("Only 8-bit images can be compressed to ", GetTextureFormatAttribs(CompressedFormat).Name);
+        if ((m_TexDesc.Width % 4) != 0 || (m_TexDesc.Height % 4) != 0)
+        {
+            LOG_WARNING_MESSAGE("Image '", m_Name, "' (", m_TexDesc.Width, "x", m_TexDesc.Height,
+                                ") is compressed to a BC format, but its dimensions are not multiples of 4. Edge blocks will be padded.");
+        }
+
+        m_TexDesc.Format = TexLoadInfo.IsSRGB ? TexFormatToSRGB(UncompressedFormat) : UncompressedFormat;
+    }
+
     Uint32 NumComponents = 0;
     if (m_TexDesc.Format == TEX_FORMAT_UNKNOWN)
     {
@@ -215,6 +995,16 @@ void TextureLoaderImpl::LoadFromImage(const TextureLoadInfo& TexLoadInfo)
                 default: LOG_ERROR_AND_THROW("Unexpected number of color channels (", ImgDesc.NumComponents, ")");
             }
         }
+        else if (ChannelDepth == 16 && ImgDesc.ComponentType == VT_FLOAT16)
+        {
+            switch (NumComponents)
+            {
+                case 1: m_TexDesc.Format = TEX_FORMAT_R16_FLOAT; break;
+                case 2: m_TexDesc.Format = TEX_FORMAT_RG16_FLOAT; break;
+                case 4: m_TexDesc.Format = TEX_FORMAT_RGBA16_FLOAT; break;
+                default: LOG_ERROR_AND_THROW("Unexpected number of color channels (", ImgDesc.NumComponents, ")");
+            }
+        }
         else if (ChannelDepth == 16)
         {
             switch (NumComponents)
@@ -235,10 +1025,24 @@ void TextureLoaderImpl::LoadFromImage(const TextureLoadInfo& TexLoadInfo)
         NumComponents = TexFmtDesc.NumComponents;
         if (TexFmtDesc.ComponentSize != ChannelDepth / 8)
             LOG_ERROR_AND_THROW("Image channel size ", ChannelDepth, " is not compatible with texture format ", TexFmtDesc.Name);
+        if ((ImgDesc.ComponentType == VT_FLOAT16) != (TexFmtDesc.ComponentType == COMPONENT_TYPE_FLOAT))
+            LOG_ERROR_AND_THROW("Image component type ", GetValueTypeString(ImgDesc.ComponentType), " is not compatible with texture format ", TexFmtDesc.Name);
+    }
+
+    m_GenerateMipsOnGPU = TexLoadInfo.GenerateMips && TexLoadInfo.GenerateMipsOnGPU && m_TexDesc.MipLevels > 1;
+    if (m_GenerateMipsOnGPU && CompressedFormat != TEX_FORMAT_UNKNOWN)
+    {
+        LOG_WARNING_MESSAGE("Mip levels of block-compressed texture '", m_Name, "' can't be generated on the GPU and will be computed by the loader");
+        m_GenerateMipsOnGPU = false;
+    }
+    if (m_GenerateMipsOnGPU)
+    {
+        m_TexDesc.BindFlags |= BIND_SHADER_RESOURCE | BIND_RENDER_TARGET;
+        m_TexDesc.MiscFlags |= MISC_TEXTURE_FLAG_GENERATE_MIPS;
     }
 
     m_SubResources.resize(m_TexDesc.MipLevels);
-    m_Mips.resize(m_TexDesc.MipLevels);
+    m_Mips = CreateMips(m_TexDesc.MipLevels);
 
     if (ImgDesc.NumComponents != NumComponents)
     {
@@ -259,6 +1063,9 @@ void TextureLoaderImpl::LoadFromImage(const TextureLoadInfo& TexLoadInfo)
         CopyAttribs.DstStride     = DstStride;
         CopyAttribs.DstCompCount  = NumComponents;
         CopyPixels(CopyAttribs);
+
+        // The top mip level has been copied, so the image is not needed anymore
+        m_pImage.Release();
     }
     else
     {
@@ -266,7 +1073,64 @@ void TextureLoaderImpl::LoadFromImage(const TextureLoadInfo& TexLoadInfo)
         m_SubResources[0].Stride = ImgDesc.RowStride;
     }
 
-    for (Uint32 m = 1; m < m_TexDesc.MipLevels; ++m)
+    // Computes the coarse level from the fine level of the given size
+    auto ComputeCoarseLevel = [&](Uint32 FineWidth, Uint32 FineHeight, const void* pFineData, Uint64 FineStride, void* pCoarseData, Uint64 CoarseStride) {
+        DILIGENT_TRACE_ZONE("TextureLoader::GenerateMipLevel");
+
+        ComputeMipLevelAttribs Attribs;
+        Attribs.Format          = m_TexDesc.Format;
+        Attribs.FineMipWidth    = FineWidth;
+        Attribs.FineMipHeight   = FineHeight;
+        Attribs.pFineMipData    = pFineData;
+        Attribs.FineMipStride   = StaticCast<size_t>(FineStride);
+        Attribs.pCoarseMipData  = pCoarseData;
+        Attribs.CoarseMipStride = StaticCast<size_t>(CoarseStride);
+        Attribs.AlphaCutoff     = TexLoadInfo.AlphaCutoff;
+        static_assert(MIP_FILTER_TYPE_DEFAULT == static_cast<MIP_FILTER_TYPE>(TEXTURE_LOAD_MIP_FILTER_DEFAULT), "Inconsistent enum values");
+        static_assert(MIP_FILTER_TYPE_BOX_AVERAGE == static_cast<MIP_FILTER_TYPE>(TEXTURE_LOAD_MIP_FILTER_BOX_AVERAGE), "Inconsistent enum values");
+        static_assert(MIP_FILTER_TYPE_MOST_FREQUENT == static_cast<MIP_FILTER_TYPE>(TEXTURE_LOAD_MIP_FILTER_MOST_FREQUENT), "Inconsistent enum values");
+        // Kaiser filter is implemented by the loader; the default filter is used as a fallback
+        Attribs.FilterType = TexLoadInfo.MipFilter != TEXTURE_LOAD_MIP_FILTER_KAISER ?
+            static_cast<MIP_FILTER_TYPE>(TexLoadInfo.MipFilter) :
+            MIP_FILTER_TYPE_DEFAULT;
+        GenerateMipLevel(Attribs, TexLoadInfo.MipFilter, TexLoadInfo.PremultiplyAlpha, TexLoadInfo.pThreadPool);
+    };
+
+    if (NumSkippedLevels > 0)
+    {
+        DILIGENT_TRACE_ZONE("TextureLoader::DownsampleImage");
+
+        // Description of the full-size image, whose level NumSkippedLevels is the top level of the texture
+        auto SrcDesc      = m_TexDesc;
+        SrcDesc.Width     = ImgDesc.Width;
+        SrcDesc.Height    = ImgDesc.Height;
+        SrcDesc.MipLevels = NumSkippedLevels + 1;
+
+        // The levels are computed in two alternating scratch buffers
+        auto Scratch = CreateMips(2);
+        for (Uint32 m = 1; m <= NumSkippedLevels; ++m)
+        {
+            const auto FineProps   = GetMipLevelProperties(SrcDesc, m - 1);
+            const auto CoarseProps = GetMipLevelProperties(SrcDesc, m);
+
+            auto& CoarseMip = Scratch[m & 1];
+            CoarseMip.resize(StaticCast<size_t>(CoarseProps.MipSize));
+            ComputeCoarseLevel(FineProps.LogicalWidth, FineProps.LogicalHeight, m_SubResources[0].pData, m_SubResources[0].Stride,
+                               CoarseMip.data(), CoarseProps.RowSize);
+
+            m_SubResources[0].pData  = CoarseMip.data();
+            m_SubResources[0].Stride = CoarseProps.RowSize;
+        }
+        m_Mips[0] = std::move(Scratch[NumSkippedLevels & 1]);
+        VERIFY_EXPR(m_SubResources[0].pData == m_Mips[0].data());
+
+        // The full-size image is not needed anymore
+        m_pImage.Release();
+    }
+
+    // When mip levels are generated on the GPU, only the top level is kept
+    const auto NumCPUMips = m_GenerateMipsOnGPU ? 1 : m_TexDesc.MipLevels;
+    for (Uint32 m = 1; m < NumCPUMips; ++m)
     {
         auto MipLevelProps = GetMipLevelProperties(m_TexDesc, m);
         m_Mips[m].resize(StaticCast<size_t>(MipLevelProps.MipSize));
@@ -276,45 +1140,273 @@ void TextureLoaderImpl::LoadFromImage(const TextureLoadInfo& TexLoadInfo)
         if (TexLoadInfo.GenerateMips)
         {
             auto FinerMipProps = GetMipLevelProperties(m_TexDesc, m - 1);
-            if (TexLoadInfo.GenerateMips)
-            {
-                ComputeMipLevelAttribs Attribs;
-                Attribs.Format          = m_TexDesc.Format;
-                Attribs.FineMipWidth    = FinerMipProps.LogicalWidth;
-                Attribs.FineMipHeight   = FinerMipProps.LogicalHeight;
-                Attribs.pFineMipData    = m_SubResources[m - 1].pData;
-                Attribs.FineMipStride   = StaticCast<size_t>(m_SubResources[m - 1].Stride);
-                Attribs.pCoarseMipData  = m_Mips[m].data();
-                Attribs.CoarseMipStride = StaticCast<size_t>(m_SubResources[m].Stride);
-                Attribs.AlphaCutoff     = TexLoadInfo.AlphaCutoff;
-                static_assert(MIP_FILTER_TYPE_DEFAULT == static_cast<MIP_FILTER_TYPE>(TEXTURE_LOAD_MIP_FILTER_DEFAULT), "Inconsistent enum values");
-                static_assert(MIP_FILTER_TYPE_BOX_AVERAGE == static_cast<MIP_FILTER_TYPE>(TEXTURE_LOAD_MIP_FILTER_BOX_AVERAGE), "Inconsistent enum values");
-                static_assert(MIP_FILTER_TYPE_MOST_FREQUENT == static_cast<MIP_FILTER_TYPE>(TEXTURE_LOAD_MIP_FILTER_MOST_FREQUENT), "Inconsistent enum values");
-                Attribs.FilterType = static_cast<MIP_FILTER_TYPE>(TexLoadInfo.MipFilter);
-                ComputeMipLevel(Attribs);
-            }
+            ComputeCoarseLevel(FinerMipProps.LogicalWidth, FinerMipProps.LogicalHeight, m_SubResources[m - 1].pData, m_SubResources[m - 1].Stride,
+                               m_Mips[m].data(), m_SubResources[m].Stride);
         }
     }
+
+    if (CompressedFormat != TEX_FORMAT_UNKNOWN)
+        CompressMipLevels(CompressedFormat, TexLoadInfo.CompressQuality, TexLoadInfo.pThreadPool);
 }
 
+void TextureLoaderImpl::CompressMipLevels(TEXTURE_FORMAT CompressedFormat, BC_COMPRESSION_QUALITY Quality, IThreadPool* pThreadPool)
+{
+    DILIGENT_TRACE_ZONE("TextureLoader::CompressMipLevels");
 
-void CreateTextureLoaderFromFile(const char*            FilePath,
-                                 IMAGE_FILE_FORMAT      FileFormat,
-                                 const TextureLoadInfo& TexLoadInfo,
-                                 ITextureLoader**       ppLoader)
+    const auto UncompressedDesc = m_TexDesc;
+    m_TexDesc.Format            = CompressedFormat;
+
+    auto CompressedMips = CreateMips(m_TexDesc.MipLevels);
+    for (Uint32 m = 0; m < m_TexDesc.MipLevels; ++m)
+    {
+        const auto SrcMipProps = GetMipLevelProperties(UncompressedDesc, m);
+        const auto DstMipProps = GetMipLevelProperties(m_TexDesc, m);
+        CompressedMips[m].resize(StaticCast<size_t>(DstMipProps.MipSize));
+
+        CompressBCTextureAttribs Attribs;
+        Attribs.Format      = CompressedFormat;
+        Attribs.Width       = SrcMipProps.LogicalWidth;
+        Attribs.Height      = SrcMipProps.LogicalHeight;
+        Attribs.pSrcPixels  = m_SubResources[m].pData;
+        Attribs.SrcStride   = StaticCast<Uint32>(m_SubResources[m].Stride);
+        Attribs.pDstBlocks  = CompressedMips[m].data();
+        Attribs.DstStride   = StaticCast<Uint32>(DstMipProps.RowSize);
+        Attribs.Quality     = Quality;
+        Attribs.pThreadPool = pThreadPool;
+        CompressBCTexture(Attribs);
+
+        m_SubResources[m].pData  = CompressedMips[m].data();
+        m_SubResources[m].Stride = DstMipProps.RowSize;
+    }
+
+    // The top level may reference the image data that is no longer needed
+    m_Mips = std::move(CompressedMips);
+}
+
+void TextureLoaderImpl::SkipTopMipLevels(Uint32 NumLevels)
 {
-    try
+    VERIFY_EXPR(NumLevels > 0 && NumLevels < m_TexDesc.MipLevels);
+
+    const auto NumSlices    = m_TexDesc.Type == RESOURCE_DIM_TEX_3D ? 1u : m_TexDesc.ArraySize;
+    const auto NewMipLevels = m_TexDesc.MipLevels - NumLevels;
+
+    // Subresources are arranged by slices, then by mip levels
+    std::vector<TextureSubResData> SubResources(size_t{NumSlices} * NewMipLevels);
+    for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+    {
+        for (Uint32 Mip = 0; Mip < NewMipLevels; ++Mip)
+            SubResources[size_t{Slice} * NewMipLevels + Mip] = m_SubResources[size_t{Slice} * m_TexDesc.MipLevels + NumLevels + Mip];
+    }
+
+    const auto TopLevelProps = GetMipLevelProperties(m_TexDesc, NumLevels);
+    m_TexDesc.Width          = TopLevelProps.LogicalWidth;
+    m_TexDesc.Height         = TopLevelProps.LogicalHeight;
+    if (m_TexDesc.Type == RESOURCE_DIM_TEX_3D)
+        m_TexDesc.Depth = TopLevelProps.Depth;
+    m_TexDesc.MipLevels = NewMipLevels;
+    m_SubResources      = std::move(SubResources);
+
+    // Release the data that was only referenced by the skipped levels, e.g. converted or decompressed levels
+    for (auto& Mip : m_Mips)
+    {
+        const auto* pMipStart = Mip.data();
+        const auto* pMipEnd   = pMipStart + Mip.size();
+
+        const auto IsReferenced = std::any_of(m_SubResources.begin(), m_SubResources.end(), [&](const TextureSubResData& SubRes) {
+            const auto* pData = static_cast<const Uint8*>(SubRes.pData);
+            return pData >= pMipStart && pData < pMipEnd;
+        });
+        if (!IsReferenced)
+            MipData{Mip.get_allocator()}.swap(Mip);
+    }
+}
+
+std::vector<TextureLoaderImpl::MipData> TextureLoaderImpl::CreateMips(size_t NumMips) const
+{
+    return std::vector<MipData>(NumMips, MipData{STD_ALLOCATOR_RAW_MEM(Uint8, m_Allocator, "Texture loader mip data")});
+}
+
+
+// Maps the file into memory so that DDS and KTX subresources point directly
+// into the mapping, and falls back to reading the file if mapping fails.
+static RefCntAutoPtr<IDataBlob> ReadTextureFile(const char* FilePath)
+{
+    auto pFileData = MappedFileDataBlob::Create(FilePath);
+    if (!pFileData)
     {
         FileWrapper File{FilePath, EFileAccessMode::Read};
         if (!File)
             LOG_ERROR_AND_THROW("Failed to open file '", FilePath, "'.");
 
-        auto pFileData = DataBlobImpl::Create();
+        pFileData = DataBlobImpl::Create();
         File->Read(pFileData);
+    }
+    return pFileData;
+}
+
+// Version of the processed texture cache. Must be incremented whenever the processing
+// of image sources changes so that the files produced by older versions are not used.
+static constexpr Uint64 ProcessedTextureCacheVersion = 1;
+
+// Computes a 128-bit hash of the data. The hash only identifies cache files and is not cryptographic.
+static void HashData(const void* pData, size_t Size, Uint64 (&Hash)[2])
+{
+    constexpr Uint64 Prime0 = 0x9E3779B185EBCA87ull;
+    constexpr Uint64 Prime1 = 0xC2B2AE3D27D4EB4Full;
+
+    auto Rotl = [](Uint64 x, int r) { return (x << r) | (x >> (64 - r)); };
+    auto Mix  = [&](Uint64 Word) {
+        Hash[0] = Rotl(Hash[0] ^ (Word * Prime1), 31) * Prime0;
+        Hash[1] = Rotl(Hash[1] + (Word * Prime0), 27) * Prime1 + Hash[0];
+    };
+
+    const auto* pBytes = static_cast<const Uint8*>(pData);
+
+    size_t i = 0;
+    for (; i + sizeof(Uint64) <= Size; i += sizeof(Uint64))
+    {
+        Uint64 Word = 0;
+        memcpy(&Word, pBytes + i, sizeof(Word));
+        Mix(Word);
+    }
+    Uint64 Tail = 0;
+    memcpy(&Tail, pBytes + i, Size - i);
+    Mix(Tail ^ (Uint64{Size} << 56u));
+}
+
+// Returns the path of the processed texture cache file for the given image source and load parameters.
+static std::string GetProcessedTextureCachePath(const Char* CacheDirectory, const Uint8* pData, size_t DataSize, const TextureLoadInfo& TexLoadInfo)
+{
+    Uint32 AlphaCutoffBits = 0;
+    memcpy(&AlphaCutoffBits, &TexLoadInfo.AlphaCutoff, sizeof(AlphaCutoffBits));
+
+    // Only the parameters that affect the texture data are hashed
+    const Uint64 Params[] = {
+        ProcessedTextureCacheVersion,
+        DataSize,
+        TexLoadInfo.Format,
+        TexLoadInfo.IsSRGB,
+        TexLoadInfo.MipLevels,
+        TexLoadInfo.GenerateMips,
+        AlphaCutoffBits,
+        TexLoadInfo.MipFilter,
+        TexLoadInfo.PremultiplyAlpha,
+        TexLoadInfo.CompressQuality,
+        TexLoadInfo.MaxDimension,
+    };
+
+    Uint64 Hash[2] = {0x243F6A8885A308D3ull, 0x13198A2E03707344ull};
+    HashData(Params, sizeof(Params), Hash);
+    HashData(pData, DataSize, Hash);
+
+    char FileName[40] = {};
+    snprintf(FileName, sizeof(FileName), "%016llx%016llx.dds", static_cast<unsigned long long>(Hash[0]), static_cast<unsigned long long>(Hash[1]));
+
+    std::string Path{CacheDirectory};
+    if (!FileSystem::IsSlash(Path.back()))
+        Path.push_back(FileSystem::SlashSymbol);
+    Path += FileName;
+    return Path;
+}
+
+// Writes the processed texture to the cache. The file is written under a temporary name and then
+// renamed so that other loaders never see a partially written file.
+static void WriteProcessedTextureCache(const std::string& CachePath, const Char* CacheDirectory, ITextureLoader* pLoader)
+{
+    const auto& TexDesc = pLoader->GetTextureDesc();
+    if ((TexDesc.MiscFlags & MISC_TEXTURE_FLAG_GENERATE_MIPS) != 0)
+    {
+        // Only the top mip level is available
+        return;
+    }
+
+    if (!FileSystem::PathExists(CacheDirectory) && !FileSystem::CreateDirectory(CacheDirectory))
+    {
+        LOG_WARNING_MESSAGE("Failed to create texture cache directory '", CacheDirectory, "'.");
+        return;
+    }
+
+    const auto ArraySize = TexDesc.GetArraySize();
+
+    std::vector<TextureSubResData> SubResources;
+    SubResources.reserve(size_t{ArraySize} * TexDesc.MipLevels);
+    for (Uint32 Slice = 0; Slice < ArraySize; ++Slice)
+    {
+        for (Uint32 Mip = 0; Mip < TexDesc.MipLevels; ++Mip)
+            SubResources.push_back(pLoader->GetSubresourceData(Mip, Slice));
+    }
+    const TextureData TexData{SubResources.data(), static_cast<Uint32>(SubResources.size())};
+
+    const auto TempPath = CachePath + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+    if (!SaveTextureAsDDS(TempPath.c_str(), TexDesc, TexData))
+    {
+        LOG_WARNING_MESSAGE("Failed to write texture cache file '", TempPath, "'.");
+        FileSystem::DeleteFile(TempPath.c_str());
+        return;
+    }
+
+    // Another loader may have written the same file in the meantime, in which case renaming fails on some platforms
+    if (std::rename(TempPath.c_str(), CachePath.c_str()) != 0)
+        FileSystem::DeleteFile(TempPath.c_str());
+}
 
-        RefCntAutoPtr<ITextureLoader> pTexLoader{
-            MakeNewRCObj<TextureLoaderImpl>()(TexLoadInfo, reinterpret_cast<const Uint8*>(pFileData->GetConstDataPtr()), pFileData->GetSize(), std::move(pFileData)) //
-        };
+// Creates the texture loader for the source data. When a cache directory is specified and the source is
+// an image, the processed texture is loaded from the cache, or is written to the cache after it is processed.
+static RefCntAutoPtr<ITextureLoader> CreateTextureLoader(const TextureLoadInfo&     TexLoadInfo,
+                                                         const Uint8*               pData,
+                                                         size_t                     DataSize,
+                                                         RefCntAutoPtr<IDataBlob>&& pDataBlob)
+{
+    DILIGENT_TRACE_ZONE("TextureLoader::CreateTextureLoader");
+
+    const auto FileFormat = Image::GetFileFormat(pData, DataSize);
+    const auto UseCache =
+        TexLoadInfo.CacheDirectory != nullptr && TexLoadInfo.CacheDirectory[0] != '\0' &&
+        FileFormat != IMAGE_FILE_FORMAT_UNKNOWN && FileFormat != IMAGE_FILE_FORMAT_DDS && FileFormat != IMAGE_FILE_FORMAT_KTX;
+    if (!UseCache)
+        return RefCntAutoPtr<ITextureLoader>{MakeNewRCObj<TextureLoaderImpl>()(TexLoadInfo, pData, DataSize, std::move(pDataBlob))};
+
+    const auto CachePath = GetProcessedTextureCachePath(TexLoadInfo.CacheDirectory, pData, DataSize, TexLoadInfo);
+    if (FileSystem::FileExists(CachePath.c_str()))
+    {
+        try
+        {
+            auto pCachedData = ReadTextureFile(CachePath.c_str());
+
+            // The cached texture is fully processed: formats and mip levels are taken from the file
+            TextureLoadInfo CachedLoadInfo{TexLoadInfo};
+            CachedLoadInfo.Format         = TEX_FORMAT_UNKNOWN;
+            CachedLoadInfo.MipLevels      = 0;
+            CachedLoadInfo.GenerateMips   = False;
+            CachedLoadInfo.CacheDirectory = nullptr;
+
+            const auto* pCachedBytes = static_cast<const Uint8*>(pCachedData->GetConstDataPtr());
+            const auto  CachedSize   = pCachedData->GetSize();
+            return RefCntAutoPtr<ITextureLoader>{MakeNewRCObj<TextureLoaderImpl>()(CachedLoadInfo, pCachedBytes, CachedSize, std::move(pCachedData))};
+        }
+        catch (std::runtime_error&)
+        {
+            LOG_WARNING_MESSAGE("Failed to load texture cache file '", CachePath, "'. The texture will be processed again.");
+        }
+    }
+
+    RefCntAutoPtr<ITextureLoader> pLoader{MakeNewRCObj<TextureLoaderImpl>()(TexLoadInfo, pData, DataSize, std::move(pDataBlob))};
+    WriteProcessedTextureCache(CachePath, TexLoadInfo.CacheDirectory, pLoader);
+    return pLoader;
+}
+
+void CreateTextureLoaderFromFile(const char*            FilePath,
+                                 IMAGE_FILE_FORMAT      FileFormat,
+                                 const TextureLoadInfo& TexLoadInfo,
+                                 ITextureLoader**       ppLoader)
+{
+    try
+    {
+        auto pFileData = ReadTextureFile(FilePath);
+
+        const auto* pBytes     = reinterpret_cast<const Uint8*>(pFileData->GetConstDataPtr());
+        const auto  Size       = pFileData->GetSize();
+        auto        pTexLoader = CreateTextureLoader(TexLoadInfo, pBytes, Size, std::move(pFileData));
         if (pTexLoader)
             pTexLoader->QueryInterface(IID_TextureLoader, reinterpret_cast<IObject**>(ppLoader));
     }
@@ -340,7 +1432,7 @@ void CreateTextureLoaderFromMemory(const void*            pData,
             pDataCopy = DataBlobImpl::Create(Size, pData);
             pData     = pDataCopy->GetConstDataPtr();
         }
-        RefCntAutoPtr<ITextureLoader> pTexLoader{MakeNewRCObj<TextureLoaderImpl>()(TexLoadInfo, reinterpret_cast<const Uint8*>(pData), Size, std::move(pDataCopy))};
+        auto pTexLoader = CreateTextureLoader(TexLoadInfo, reinterpret_cast<const Uint8*>(pData), Size, std::move(pDataCopy));
         if (pTexLoader)
             pTexLoader->QueryInterface(IID_TextureLoader, reinterpret_cast<IObject**>(ppLoader));
     }
@@ -367,6 +1459,62 @@ void CreateTextureLoaderFromImage(Image*                 pSrcImage,
     }
 }
 
+void CreateTextureArrayLoaderFromFiles(const char* const*     ppFilePaths,
+                                       Uint32                 NumFiles,
+                                       RESOURCE_DIMENSION     Type,
+                                       const TextureLoadInfo& TexLoadInfo,
+                                       ITextureLoader**       ppLoader)
+{
+    DEV_CHECK_ERR(ppFilePaths != nullptr && NumFiles > 0, "At least one file path must be provided");
+    try
+    {
+        if (Type != RESOURCE_DIM_TEX_2D_ARRAY && Type != RESOURCE_DIM_TEX_CUBE && Type != RESOURCE_DIM_TEX_CUBE_ARRAY)
+            LOG_ERROR_AND_THROW("Only 2D texture arrays, cubemaps and cubemap arrays can be assembled from multiple files");
+        if (Type == RESOURCE_DIM_TEX_CUBE && NumFiles != 6)
+            LOG_ERROR_AND_THROW("A cubemap requires 6 files, but ", NumFiles, " are provided");
+        if (Type == RESOURCE_DIM_TEX_CUBE_ARRAY && (NumFiles % 6) != 0)
+            LOG_ERROR_AND_THROW("The number of cubemap array files (", NumFiles, ") must be a multiple of 6");
+
+        // Every slice is processed by a single task
+        auto SliceLoadInfo        = TexLoadInfo;
+        SliceLoadInfo.pThreadPool = nullptr;
+
+        std::vector<RefCntAutoPtr<ITextureLoader>> SliceLoaders(NumFiles);
+        if (TexLoadInfo.pThreadPool != nullptr)
+        {
+            std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+            Tasks.reserve(NumFiles);
+            for (Uint32 i = 0; i < NumFiles; ++i)
+            {
+                Tasks.emplace_back(EnqueueAsyncWork(TexLoadInfo.pThreadPool, [&, i](Uint32) {
+                    CreateTextureLoaderFromFile(ppFilePaths[i], IMAGE_FILE_FORMAT_UNKNOWN, SliceLoadInfo, &SliceLoaders[i]);
+                }));
+            }
+            for (auto& pTask : Tasks)
+                pTask->WaitForCompletion();
+        }
+        else
+        {
+            for (Uint32 i = 0; i < NumFiles; ++i)
+                CreateTextureLoaderFromFile(ppFilePaths[i], IMAGE_FILE_FORMAT_UNKNOWN, SliceLoadInfo, &SliceLoaders[i]);
+        }
+
+        for (Uint32 i = 0; i < NumFiles; ++i)
+        {
+            if (!SliceLoaders[i])
+                LOG_ERROR_AND_THROW("Failed to load slice ", i, " from file '", ppFilePaths[i], "'");
+        }
+
+        RefCntAutoPtr<ITextureLoader> pTexLoader{MakeNewRCObj<TextureLoaderImpl>()(TexLoadInfo, Type, std::move(SliceLoaders))};
+        if (pTexLoader)
+            pTexLoader->QueryInterface(IID_TextureLoader, reinterpret_cast<IObject**>(ppLoader));
+    }
+    catch (std::runtime_error& err)
+    {
+        LOG_ERROR("Failed to create texture array loader: ", err.what());
+    }
+}
+
 } // namespace Diligent
 
 extern "C"
@@ -395,4 +1543,13 @@ extern "C"
     {
         Diligent::CreateTextureLoaderFromImage(pSrcImage, TexLoadInfo, ppLoader);
     }
+
+    void Diligent_CreateTextureArrayLoaderFromFiles(const char* const*               ppFilePaths,
+                                                    Diligent::Uint32                 NumFiles,
+                                                    Diligent::RESOURCE_DIMENSION     Type,
+                                                    const Diligent::TextureLoadInfo& TexLoadInfo,
+                                                    Diligent::ITextureLoader**       ppLoader)
+    {
+        Diligent::CreateTextureArrayLoaderFromFiles(ppFilePaths, NumFiles, Type, TexLoadInfo, ppLoader);
+    }
 }
@@ -25,13 +25,198 @@
  *  of the possibility of such damages.
  */
 
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "TextureUtilities.h"
 #include "TextureLoader.h"
 #include "RefCntAutoPtr.hpp"
+#include "ThreadPool.hpp"
+#include "TextureLoaderImpl.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define TEXTURE_UTILITIES_USE_SSE2 1
+#    if defined(__SSSE3__) || defined(__AVX__)
+#        include <tmmintrin.h>
+#        define TEXTURE_UTILITIES_USE_SSSE3 1
+#    endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#    include <arm_neon.h>
+#    define TEXTURE_UTILITIES_USE_NEON 1
+#endif
 
 namespace Diligent
 {
 
+namespace
+{
+
+// Returns the value of the destination component that is not present in the source
+template <typename ChannelType>
+ChannelType GetDefaultComponentValue(const ChannelType* pSrc, Uint32 SrcCompCount, size_t c)
+{
+    return c < 3 ?
+        (SrcCompCount == 1 ? pSrc[0] : 0) : // For single-channel source textures, propagate r to other channels
+        std::numeric_limits<ChannelType>::max();    // Use 1.0 as default value for alpha
+}
+
+// Copies the row when component counts are only known at run time
+template <typename ChannelType>
+void CopyRowGeneric(const ChannelType* pSrcRow, ChannelType* pDstRow, size_t Width, Uint32 SrcCompCount, Uint32 DstCompCount)
+{
+    const auto NumCompsToCopy = std::min(SrcCompCount, DstCompCount);
+    for (size_t col = 0; col < Width; ++col)
+    {
+        auto*       pDst = pDstRow + col * DstCompCount;
+        const auto* pSrc = pSrcRow + col * SrcCompCount;
+
+        for (size_t c = 0; c < NumCompsToCopy; ++c)
+            pDst[c] = pSrc[c];
+
+        for (size_t c = NumCompsToCopy; c < DstCompCount; ++c)
+            pDst[c] = GetDefaultComponentValue(pSrc, SrcCompCount, c);
+    }
+}
+
+// Compile-time specialized row copy. With constant component counts the compiler
+// fully unrolls the inner loops and is able to vectorize the outer one.
+template <typename ChannelType, Uint32 SrcCompCount, Uint32 DstCompCount>
+struct CopyRowKernel
+{
+    // Processes a prefix of the row using SIMD instructions and returns the number of processed pixels
+    static size_t RunSIMD(const ChannelType*, ChannelType*, size_t)
+    {
+        return 0;
+    }
+
+    static void Run(const ChannelType* pSrcRow, ChannelType* pDstRow, size_t Width)
+    {
+        const auto FirstCol = RunSIMD(pSrcRow, pDstRow, Width);
+        for (size_t col = FirstCol; col < Width; ++col)
+        {
+            auto*       pDst = pDstRow + col * DstCompCount;
+            const auto* pSrc = pSrcRow + col * SrcCompCount;
+
+            for (size_t c = 0; c < std::min(SrcCompCount, DstCompCount); ++c)
+                pDst[c] = pSrc[c];
+
+            for (size_t c = SrcCompCount; c < DstCompCount; ++c)
+                pDst[c] = GetDefaultComponentValue(pSrc, SrcCompCount, c);
+        }
+    }
+};
+
+#if TEXTURE_UTILITIES_USE_SSSE3
+// RGB8 -> RGBA8: 4 pixels per iteration
+template <>
+size_t CopyRowKernel<Uint8, 3, 4>::RunSIMD(const Uint8* pSrcRow, Uint8* pDstRow, size_t Width)
+{
+    const __m128i Shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i Alpha   = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+
+    // Every iteration reads 16 source bytes, but only uses 12 of them
+    size_t col = 0;
+    for (; col * 3 + 16 <= Width * 3; col += 4)
+    {
+        const __m128i RGB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrcRow + col * 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDstRow + col * 4), _mm_or_si128(_mm_shuffle_epi8(RGB, Shuffle), Alpha));
+    }
+    return col;
+}
+#elif TEXTURE_UTILITIES_USE_NEON
+// RGB8 -> RGBA8: 16 pixels per iteration
+template <>
+size_t CopyRowKernel<Uint8, 3, 4>::RunSIMD(const Uint8* pSrcRow, Uint8* pDstRow, size_t Width)
+{
+    size_t col = 0;
+    for (; col + 16 <= Width; col += 16)
+    {
+        const uint8x16x3_t RGB = vld3q_u8(pSrcRow + col * 3);
+
+        uint8x16x4_t RGBA;
+        RGBA.val[0] = RGB.val[0];
+        RGBA.val[1] = RGB.val[1];
+        RGBA.val[2] = RGB.val[2];
+        RGBA.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8(pDstRow + col * 4, RGBA);
+    }
+    return col;
+}
+#endif
+
+#if TEXTURE_UTILITIES_USE_SSE2
+// R8 -> RGBA8 (r, r, r, 1): 16 pixels per iteration
+template <>
+size_t CopyRowKernel<Uint8, 1, 4>::RunSIMD(const Uint8* pSrcRow, Uint8* pDstRow, size_t Width)
+{
+    const __m128i Alpha = _mm_set1_epi8(-1);
+
+    size_t col = 0;
+    for (; col + 16 <= Width; col += 16)
+    {
+        const __m128i R    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrcRow + col));
+        const __m128i RRLo = _mm_unpacklo_epi8(R, R);
+        const __m128i RALo = _mm_unpacklo_epi8(R, Alpha);
+        const __m128i RRHi = _mm_unpackhi_epi8(R, R);
+        const __m128i RAHi = _mm_unpackhi_epi8(R, Alpha);
+
+        // (r, r) and (r, a) pairs are interleaved into (r, r, r, a) texels
+        auto* pDst = reinterpret_cast<__m128i*>(pDstRow + col * 4);
+        _mm_storeu_si128(pDst + 0, _mm_unpacklo_epi16(RRLo, RALo));
+        _mm_storeu_si128(pDst + 1, _mm_unpackhi_epi16(RRLo, RALo));
+        _mm_storeu_si128(pDst + 2, _mm_unpacklo_epi16(RRHi, RAHi));
+        _mm_storeu_si128(pDst + 3, _mm_unpackhi_epi16(RRHi, RAHi));
+    }
+    return col;
+}
+#elif TEXTURE_UTILITIES_USE_NEON
+// R8 -> RGBA8 (r, r, r, 1): 16 pixels per iteration
+template <>
+size_t CopyRowKernel<Uint8, 1, 4>::RunSIMD(const Uint8* pSrcRow, Uint8* pDstRow, size_t Width)
+{
+    size_t col = 0;
+    for (; col + 16 <= Width; col += 16)
+    {
+        const uint8x16_t R = vld1q_u8(pSrcRow + col);
+
+        uint8x16x4_t RGBA;
+        RGBA.val[0] = R;
+        RGBA.val[1] = R;
+        RGBA.val[2] = R;
+        RGBA.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8(pDstRow + col * 4, RGBA);
+    }
+    return col;
+}
+#endif
+
+template <typename ChannelType>
+using CopyRowFuncType = void (*)(const ChannelType* pSrcRow, ChannelType* pDstRow, size_t Width);
+
+// Returns the specialized row copy function for the most common component count
+// combinations, or null if there is none.
+template <typename ChannelType>
+CopyRowFuncType<ChannelType> GetCopyRowFunc(Uint32 SrcCompCount, Uint32 DstCompCount)
+{
+    switch (SrcCompCount * 10 + DstCompCount)
+    {
+        // clang-format off
+        case 12: return CopyRowKernel<ChannelType, 1, 2>::Run;
+        case 14: return CopyRowKernel<ChannelType, 1, 4>::Run;
+        case 24: return CopyRowKernel<ChannelType, 2, 4>::Run;
+        case 34: return CopyRowKernel<ChannelType, 3, 4>::Run;
+        case 41: return CopyRowKernel<ChannelType, 4, 1>::Run;
+        case 43: return CopyRowKernel<ChannelType, 4, 3>::Run;
+        // clang-format on
+        default: return nullptr;
+    }
+}
+
+} // namespace
+
 template <typename ChannelType>
 void CopyPixelsImpl(const CopyPixelsAttribs& Attribs)
 {
@@ -63,36 +248,16 @@ void CopyPixelsImpl(const CopyPixelsAttribs& Attribs)
             });
         }
     }
-    else if (Attribs.DstCompCount < Attribs.SrcCompCount)
+    else if (auto CopyRow = GetCopyRowFunc<ChannelType>(Attribs.SrcCompCount, Attribs.DstCompCount))
     {
-        ProcessRows([&Attribs](auto* pSrcRow, auto* pDstRow) {
-            for (size_t col = 0; col < size_t{Attribs.Width}; ++col)
-            {
-                auto*       pDst = pDstRow + col * Attribs.DstCompCount;
-                const auto* pSrc = pSrcRow + col * Attribs.SrcCompCount;
-                for (size_t c = 0; c < Attribs.DstCompCount; ++c)
-                    pDst[c] = pSrc[c];
-            }
+        ProcessRows([&Attribs, CopyRow](auto* pSrcRow, auto* pDstRow) {
+            CopyRow(pSrcRow, pDstRow, Attribs.Width);
         });
     }
     else
     {
         ProcessRows([&Attribs](auto* pSrcRow, auto* pDstRow) {
-            for (size_t col = 0; col < size_t{Attribs.Width}; ++col)
-            {
-                auto*       pDst = pDstRow + col * Attribs.DstCompCount;
-                const auto* pSrc = pSrcRow + col * Attribs.SrcCompCount;
-
-                for (size_t c = 0; c < Attribs.SrcCompCount; ++c)
-                    pDst[c] = pSrc[c];
-
-                for (size_t c = Attribs.SrcCompCount; c < Attribs.DstCompCount; ++c)
-                {
-                    pDst[c] = c < 3 ?
-                        (Attribs.SrcCompCount == 1 ? pSrc[0] : 0) : // For single-channel source textures, propagate r to other channels
-                        std::numeric_limits<ChannelType>::max();    // Use 1.0 as default value for alpha
-                }
-            }
+            CopyRowGeneric(pSrcRow, pDstRow, Attribs.Width, Attribs.SrcCompCount, Attribs.DstCompCount);
         });
     }
 }
@@ -144,11 +309,21 @@ void ExpandPixels(const ExpandPixelsAttribs& Attribs)
         const auto* pSrcRow = reinterpret_cast<const Uint8*>(Attribs.pSrcPixels) + row * Attribs.SrcStride;
         memcpy(pDstRow, pSrcRow, NumColsToCopy * Attribs.ComponentSize * Attribs.ComponentCount);
 
-        // Expand the row by repeating the last pixel
-        const auto* pLastPixel = pSrcRow + (NumColsToCopy - 1) * Attribs.ComponentSize * Attribs.ComponentCount;
-        for (Uint32 col = NumColsToCopy; col < Attribs.DstWidth; ++col)
+        // Expand the row by repeating the last pixel. The filled part is doubled
+        // on every iteration, so only a logarithmic number of copies is needed.
+        const auto  PixelSize   = size_t{Attribs.ComponentSize} * Attribs.ComponentCount;
+        const auto* pLastPixel  = pSrcRow + (NumColsToCopy - 1) * PixelSize;
+        auto*       pExpandData = pDstRow + NumColsToCopy * PixelSize;
+        const auto  ExpandSize  = (Attribs.DstWidth - NumColsToCopy) * PixelSize;
+        if (ExpandSize > 0)
         {
-            memcpy(pDstRow + col * Attribs.ComponentSize * Attribs.ComponentCount, pLastPixel, Attribs.ComponentSize * Attribs.ComponentCount);
+            memcpy(pExpandData, pLastPixel, PixelSize);
+            for (size_t FilledSize = PixelSize; FilledSize < ExpandSize;)
+            {
+                const auto CopySize = std::min(FilledSize, ExpandSize - FilledSize);
+                memcpy(pExpandData + FilledSize, pExpandData, CopySize);
+                FilledSize += CopySize;
+            }
         }
     };
 
@@ -170,6 +345,207 @@ void ExpandPixels(const ExpandPixelsAttribs& Attribs)
     }
 }
 
+namespace
+{
+
+// Partial image difference of a band of rows
+struct ImageDiffStats
+{
+    Uint32 NumDiffPixels         = 0;
+    Uint32 NumNonIdenticalPixels = 0;
+    Uint32 MaxDiff               = 0;
+    Uint64 TotalDiff             = 0;
+
+    void AddPixel(Uint32 PixDiff, Uint32 Threshold)
+    {
+        NumDiffPixels += PixDiff > Threshold ? 1 : 0;
+        NumNonIdenticalPixels += PixDiff != 0 ? 1 : 0;
+        MaxDiff = std::max(MaxDiff, PixDiff);
+        TotalDiff += PixDiff;
+    }
+
+    void Merge(const ImageDiffStats& Stats)
+    {
+        NumDiffPixels += Stats.NumDiffPixels;
+        NumNonIdenticalPixels += Stats.NumNonIdenticalPixels;
+        MaxDiff = std::max(MaxDiff, Stats.MaxDiff);
+        TotalDiff += Stats.TotalDiff;
+    }
+};
+
+// The number of rows compared by one thread pool task
+constexpr Uint32 ImageDiffRowsPerTask = 64;
+
+#if TEXTURE_UTILITIES_USE_SSE2 || TEXTURE_UTILITIES_USE_NEON
+// Adds the per-lane sums accumulated by the SIMD loop to the stats
+void AddSIMDImageDiffStats(const Uint32 Sum[4], const Uint32 Max[4], const Uint32 NumDiff[4], const Uint32 NumNonIdentical[4], ImageDiffStats& Stats)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        Stats.NumDiffPixels += NumDiff[i];
+        Stats.NumNonIdenticalPixels += NumNonIdentical[i];
+        Stats.MaxDiff = std::max(Stats.MaxDiff, Max[i]);
+        Stats.TotalDiff += Sum[i];
+    }
+}
+#endif
+
+// Compares a prefix of the row of RGBA8 pixels using SIMD instructions and returns the number of processed pixels.
+// The difference of every pixel is computed in the low byte of its 32-bit lane.
+size_t DiffRowRGBA8SIMD(const Uint8* pRow1, const Uint8* pRow2, size_t Width, Uint32 Threshold, ImageDiffStats& Stats)
+{
+    size_t col = 0;
+#if TEXTURE_UTILITIES_USE_SSE2
+    const __m128i ThresholdVec = _mm_set1_epi32(static_cast<int>(Threshold));
+    const __m128i LowByteMask  = _mm_set1_epi32(0xFF);
+    const __m128i Zero         = _mm_setzero_si128();
+
+    __m128i Sum             = Zero;
+    __m128i Max             = Zero;
+    __m128i NumDiff         = Zero;
+    __m128i NumNonIdentical = Zero;
+    for (; col + 4 <= Width; col += 4)
+    {
+        const __m128i Pix1    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow1 + col * 4));
+        const __m128i Pix2    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pRow2 + col * 4));
+        const __m128i AbsDiff = _mm_or_si128(_mm_subs_epu8(Pix1, Pix2), _mm_subs_epu8(Pix2, Pix1));
+
+        __m128i PixDiff = _mm_max_epu8(AbsDiff, _mm_srli_epi32(AbsDiff, 8));
+        PixDiff         = _mm_max_epu8(PixDiff, _mm_srli_epi32(PixDiff, 16));
+        PixDiff         = _mm_and_si128(PixDiff, LowByteMask);
+
+        Sum = _mm_add_epi32(Sum, PixDiff);
+        // Lanes are in [0, 255], so the 16-bit maximum is exact
+        Max = _mm_max_epi16(Max, PixDiff);
+        // Comparison results are -1 in the lanes that pass
+        NumDiff         = _mm_sub_epi32(NumDiff, _mm_cmpgt_epi32(PixDiff, ThresholdVec));
+        NumNonIdentical = _mm_sub_epi32(NumNonIdentical, _mm_cmpgt_epi32(PixDiff, Zero));
+    }
+
+    alignas(16) Uint32 Lanes[4][4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(Lanes[0]), Sum);
+    _mm_store_si128(reinterpret_cast<__m128i*>(Lanes[1]), Max);
+    _mm_store_si128(reinterpret_cast<__m128i*>(Lanes[2]), NumDiff);
+    _mm_store_si128(reinterpret_cast<__m128i*>(Lanes[3]), NumNonIdentical);
+    AddSIMDImageDiffStats(Lanes[0], Lanes[1], Lanes[2], Lanes[3], Stats);
+#elif TEXTURE_UTILITIES_USE_NEON
+    const uint32x4_t ThresholdVec = vdupq_n_u32(Threshold);
+    const uint32x4_t LowByteMask  = vdupq_n_u32(0xFF);
+
+    uint32x4_t Sum             = vdupq_n_u32(0);
+    uint32x4_t Max             = vdupq_n_u32(0);
+    uint32x4_t NumDiff         = vdupq_n_u32(0);
+    uint32x4_t NumNonIdentical = vdupq_n_u32(0);
+    for (; col + 4 <= Width; col += 4)
+    {
+        const uint8x16_t AbsDiff = vabdq_u8(vld1q_u8(pRow1 + col * 4), vld1q_u8(pRow2 + col * 4));
+
+        uint8x16_t PixDiff = vmaxq_u8(AbsDiff, vreinterpretq_u8_u32(vshrq_n_u32(vreinterpretq_u32_u8(AbsDiff), 8)));
+        PixDiff            = vmaxq_u8(PixDiff, vreinterpretq_u8_u32(vshrq_n_u32(vreinterpretq_u32_u8(PixDiff), 16)));
+
+        const uint32x4_t PixDiff32 = vandq_u32(vreinterpretq_u32_u8(PixDiff), LowByteMask);
+
+        Sum = vaddq_u32(Sum, PixDiff32);
+        Max = vmaxq_u32(Max, PixDiff32);
+        // Comparison results are all ones in the lanes that pass
+        NumDiff         = vsubq_u32(NumDiff, vcgtq_u32(PixDiff32, ThresholdVec));
+        NumNonIdentical = vsubq_u32(NumNonIdentical, vtstq_u32(PixDiff32, PixDiff32));
+    }
+
+    Uint32 Lanes[4][4];
+    vst1q_u32(Lanes[0], Sum);
+    vst1q_u32(Lanes[1], Max);
+    vst1q_u32(Lanes[2], NumDiff);
+    vst1q_u32(Lanes[3], NumNonIdentical);
+    AddSIMDImageDiffStats(Lanes[0], Lanes[1], Lanes[2], Lanes[3], Stats);
+#endif
+    return col;
+}
+
+} // namespace
+
+void ComputeImageDifference(const ComputeImageDifferenceAttribs& Attribs, ImageDiffInfo& ImageDiff)
+{
+    DEV_CHECK_ERR(Attribs.Width > 0, "Width must not be zero");
+    DEV_CHECK_ERR(Attribs.Height > 0, "Height must not be zero");
+    DEV_CHECK_ERR(Attribs.pImage1 != nullptr, "Pointer to the first image must not be null");
+    DEV_CHECK_ERR(Attribs.NumComponents1 != 0, "Component count of the first image must not be zero");
+    DEV_CHECK_ERR(Attribs.Stride1 >= Attribs.Width * Attribs.NumComponents1 || Attribs.Height == 1, "Stride of the first image is too small");
+    DEV_CHECK_ERR(Attribs.pImage2 != nullptr, "Pointer to the second image must not be null");
+    DEV_CHECK_ERR(Attribs.NumComponents2 != 0, "Component count of the second image must not be zero");
+    DEV_CHECK_ERR(Attribs.Stride2 >= Attribs.Width * Attribs.NumComponents2 || Attribs.Height == 1, "Stride of the second image is too small");
+    DEV_CHECK_ERR(Attribs.pDiffImage == nullptr || Attribs.NumDiffComponents != 0, "Diff image component count must not be zero");
+    DEV_CHECK_ERR(Attribs.pDiffImage == nullptr || Attribs.DiffStride >= Attribs.Width * Attribs.NumDiffComponents || Attribs.Height == 1, "Diff image stride is too small");
+
+    ImageDiff = ImageDiffInfo{};
+
+    const auto NumComponents = std::min(Attribs.NumComponents1, Attribs.NumComponents2);
+    const bool UseSIMD       = Attribs.NumComponents1 == 4 && Attribs.NumComponents2 == 4 && Attribs.pDiffImage == nullptr;
+    // Pixel differences never exceed 255
+    const auto Threshold = std::min(Attribs.Threshold, 255u);
+
+    auto DiffRows = [&](Uint32 FirstRow, Uint32 EndRow, ImageDiffStats& Stats) {
+        for (size_t row = FirstRow; row < EndRow; ++row)
+        {
+            const auto* pRow1    = static_cast<const Uint8*>(Attribs.pImage1) + size_t{Attribs.Stride1} * row;
+            const auto* pRow2    = static_cast<const Uint8*>(Attribs.pImage2) + size_t{Attribs.Stride2} * row;
+            auto*       pDiffRow = Attribs.pDiffImage != nullptr ? static_cast<Uint8*>(Attribs.pDiffImage) + size_t{Attribs.DiffStride} * row : nullptr;
+
+            const auto FirstCol = UseSIMD ? DiffRowRGBA8SIMD(pRow1, pRow2, Attribs.Width, Threshold, Stats) : 0;
+            for (size_t col = FirstCol; col < Attribs.Width; ++col)
+            {
+                const auto* pPix1   = pRow1 + col * Attribs.NumComponents1;
+                const auto* pPix2   = pRow2 + col * Attribs.NumComponents2;
+                Uint32      PixDiff = 0;
+                for (size_t c = 0; c < NumComponents; ++c)
+                    PixDiff = std::max(PixDiff, static_cast<Uint32>(pPix1[c] > pPix2[c] ? pPix1[c] - pPix2[c] : pPix2[c] - pPix1[c]));
+                Stats.AddPixel(PixDiff, Threshold);
+
+                if (pDiffRow != nullptr)
+                {
+                    const auto DiffVal = static_cast<Uint8>(std::min(std::max(static_cast<float>(PixDiff) * Attribs.Scale, 0.f), 255.f));
+
+                    auto* pDst = pDiffRow + col * Attribs.NumDiffComponents;
+                    for (size_t c = 0; c < Attribs.NumDiffComponents; ++c)
+                        pDst[c] = c < 3 ? DiffVal : 255;
+                }
+            }
+        }
+    };
+
+    ImageDiffStats Stats;
+    if (Attribs.pThreadPool == nullptr || Attribs.Height <= ImageDiffRowsPerTask)
+    {
+        DiffRows(0, Attribs.Height, Stats);
+    }
+    else
+    {
+        const auto NumTasks = (Attribs.Height + ImageDiffRowsPerTask - 1) / ImageDiffRowsPerTask;
+
+        std::vector<ImageDiffStats>            TaskStats(NumTasks);
+        std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+        Tasks.reserve(NumTasks);
+        for (Uint32 Task = 0; Task < NumTasks; ++Task)
+        {
+            const auto FirstRow = Task * ImageDiffRowsPerTask;
+            const auto EndRow   = std::min(FirstRow + ImageDiffRowsPerTask, Attribs.Height);
+            Tasks.emplace_back(EnqueueAsyncWork(Attribs.pThreadPool, [&DiffRows, &TaskStats, Task, FirstRow, EndRow](Uint32) {
+                DiffRows(FirstRow, EndRow, TaskStats[Task]);
+            }));
+        }
+        for (auto& pTask : Tasks)
+            pTask->WaitForCompletion();
+
+        for (const auto& BandStats : TaskStats)
+            Stats.Merge(BandStats);
+    }
+
+    ImageDiff.NumDiffPixels         = Stats.NumDiffPixels;
+    ImageDiff.NumNonIdenticalPixels = Stats.NumNonIdenticalPixels;
+    ImageDiff.MaxDiff               = Stats.MaxDiff;
+    ImageDiff.AvgDiff               = static_cast<float>(static_cast<double>(Stats.TotalDiff) / (static_cast<double>(Attribs.Width) * static_cast<double>(Attribs.Height)));
+}
+
 void CreateTextureFromFile(const Char*            FilePath,
                            const TextureLoadInfo& TexLoadInfo,
                            IRenderDevice*         pDevice,
@@ -183,6 +559,96 @@ void CreateTextureFromFile(const Char*            FilePath,
     pTexLoader->CreateTexture(pDevice, ppTexture);
 }
 
+void CreateTexturesFromFiles(const CreateTexturesFromFilesAttribs& Attribs)
+{
+    if (Attribs.NumTextures == 0)
+        return;
+
+    DEV_CHECK_ERR(Attribs.ppFilePaths != nullptr, "File paths must not be null");
+    DEV_CHECK_ERR(Attribs.pLoadInfos != nullptr, "Load infos must not be null");
+
+    // Map every input entry to a unique load request
+    std::unordered_map<TextureLoadKey, Uint32, TextureLoadKey::Hasher> UniqueIds;
+    std::vector<Uint32>                                                 EntryToUnique(Attribs.NumTextures);
+    std::vector<Uint32>                                                 UniqueToEntry;
+    for (Uint32 i = 0; i < Attribs.NumTextures; ++i)
+    {
+        DEV_CHECK_ERR(Attribs.ppFilePaths[i] != nullptr, "File path ", i, " is null");
+        TextureLoadKey Key{Attribs.ppFilePaths[i], Attribs.pLoadInfos[i]};
+
+        auto it = UniqueIds.emplace(std::move(Key), static_cast<Uint32>(UniqueToEntry.size())).first;
+        if (it->second == UniqueToEntry.size())
+            UniqueToEntry.push_back(i);
+        EntryToUnique[i] = it->second;
+    }
+
+    std::vector<RefCntAutoPtr<ITextureLoader>> Loaders(UniqueToEntry.size());
+
+    auto LoadTexture = [&](Uint32 UniqueId) {
+        const auto Entry = UniqueToEntry[UniqueId];
+
+        auto LoadInfo = Attribs.pLoadInfos[Entry];
+        // Files are already loaded in parallel. Waiting for nested tasks from a worker thread may deadlock.
+        LoadInfo.pThreadPool = nullptr;
+        CreateTextureLoaderFromFile(Attribs.ppFilePaths[Entry], IMAGE_FILE_FORMAT_UNKNOWN, LoadInfo, &Loaders[UniqueId]);
+    };
+
+    if (Attribs.pThreadPool != nullptr && UniqueToEntry.size() > 1)
+    {
+        std::vector<RefCntAutoPtr<IAsyncTask>> Tasks;
+        Tasks.reserve(UniqueToEntry.size());
+        for (Uint32 UniqueId = 0; UniqueId < UniqueToEntry.size(); ++UniqueId)
+        {
+            Tasks.emplace_back(EnqueueAsyncWork(Attribs.pThreadPool, [&LoadTexture, UniqueId](Uint32 ThreadId) {
+                LoadTexture(UniqueId);
+            }));
+        }
+        for (auto& pTask : Tasks)
+            pTask->WaitForCompletion();
+    }
+    else
+    {
+        for (Uint32 UniqueId = 0; UniqueId < UniqueToEntry.size(); ++UniqueId)
+            LoadTexture(UniqueId);
+    }
+
+    std::vector<RefCntAutoPtr<ITexture>> Textures(UniqueToEntry.size());
+    if (Attribs.pDevice != nullptr)
+    {
+        for (Uint32 UniqueId = 0; UniqueId < UniqueToEntry.size(); ++UniqueId)
+        {
+            auto& pLoader = Loaders[UniqueId];
+            if (!pLoader)
+                continue;
+
+            if (Attribs.pContext != nullptr)
+                pLoader->CreateStreamingTexture(Attribs.pDevice, Attribs.pContext, pLoader->GetTextureDesc().MipLevels, &Textures[UniqueId]);
+            else
+                pLoader->CreateTexture(Attribs.pDevice, &Textures[UniqueId]);
+        }
+
+        if (Attribs.pContext != nullptr)
+            Attribs.pContext->Flush();
+    }
+
+    for (Uint32 i = 0; i < Attribs.NumTextures; ++i)
+    {
+        const auto UniqueId = EntryToUnique[i];
+        if (Attribs.ppLoaders != nullptr)
+        {
+            DEV_CHECK_ERR(Attribs.ppLoaders[i] == nullptr, "Loader pointer ", i, " must be null");
+            if (Loaders[UniqueId])
+                Loaders[UniqueId]->QueryInterface(IID_TextureLoader, reinterpret_cast<IObject**>(&Attribs.ppLoaders[i]));
+        }
+        if (Attribs.ppTextures != nullptr)
+        {
+            DEV_CHECK_ERR(Attribs.ppTextures[i] == nullptr, "Texture pointer ", i, " must be null");
+            if (Textures[UniqueId])
+                Textures[UniqueId]->QueryInterface(IID_Texture, reinterpret_cast<IObject**>(&Attribs.ppTextures[i]));
+        }
+    }
+}
+
 } // namespace Diligent
 
 extern "C"
@@ -194,4 +660,9 @@ extern "C"
     {
         Diligent::CreateTextureFromFile(FilePath, TexLoadInfo, pDevice, ppTexture);
     }
+
+    void Diligent_CreateTexturesFromFiles(const Diligent::CreateTexturesFromFilesAttribs& Attribs)
+    {
+        Diligent::CreateTexturesFromFiles(Attribs);
+    }
 }
@@ -1079,6 +1079,12 @@ struct Buffer {
   Value extras;
   ExtensionMap extensions;
 
+  // Filled when FsCallbacks::ReadFileRange is set. The external file is not
+  // read, `data` is left empty, and the application reads the byte ranges
+  // it needs from `deferred_path`.
+  std::string deferred_path;
+  size_t deferred_size = 0;
+
   // Filled when SetStoreOriginalJSONForExtrasAndExtensions is enabled.
   std::string extras_json_string;
   std::string extensions_json_string;
@@ -1250,6 +1256,13 @@ typedef bool (*ReadWholeFileFunction)(std::vector<unsigned char> *,
                                       std::string *, const std::string &,
                                       void *);
 
+///
+/// ReadFileRangeFunction type. Reads `size` bytes at `offset` of the file.
+///
+typedef bool (*ReadFileRangeFunction)(std::vector<unsigned char> *,
+                                      std::string *, const std::string &,
+                                      size_t offset, size_t size, void *);
+
 ///
 /// WriteWholeFileFunction type. Signature for custom filesystem callbacks.
 ///
@@ -1268,6 +1281,10 @@ struct FsCallbacks {
   WriteWholeFileFunction WriteWholeFile;
 
   void *user_data;  // An argument that is passed to all fs callbacks
+
+  // Optional. When set, external buffers are not loaded; see
+  // Buffer::deferred_path.
+  ReadFileRangeFunction ReadFileRange;
 };
 
 #ifndef TINYGLTF_NO_FS
@@ -4061,6 +4078,30 @@ static bool ParseOcclusionTextureInfo(
   return true;
 }
 
+// Resolves the path of an external buffer without reading it. The data is
+// read later in ranges through FsCallbacks::ReadFileRange.
+static bool DeferExternalBuffer(Buffer *buffer, std::string *err,
+                                const std::string &filename,
+                                const std::string &basedir, size_t byteLength,
+                                FsCallbacks *fs) {
+  std::vector<std::string> paths;
+  paths.push_back(basedir);
+  paths.push_back(".");
+
+  std::string filepath = FindFile(paths, filename, fs);
+  if (filepath.empty() || filename.empty()) {
+    if (err) {
+      (*err) += "File not found : " + filename + "\n";
+    }
+    return false;
+  }
+
+  buffer->data.clear();
+  buffer->deferred_path = filepath;
+  buffer->deferred_size = byteLength;
+  return true;
+}
+
 static bool ParseBuffer(Buffer *buffer, std::string *err, const json &o,
                         bool store_original_json_for_extras_and_extensions,
                         FsCallbacks *fs, const std::string &basedir,
@@ -4077,6 +4118,24 @@ static bool ParseBuffer(Buffer *buffer, std::string *err, const json &o,
   buffer->uri.clear();
   ParseStringProperty(&buffer->uri, err, o, "uri", false, "Buffer");
 
+  // Fallback buffers of EXT_meshopt_compression may have no data. The buffer
+  // views that reference them are decoded by the application, so the buffer
+  // is only allocated.
+  if (buffer->uri.empty()) {
+    ExtensionMap extensions;
+    ParseExtensionsProperty(&extensions, err, o);
+    auto ext_it = extensions.find("EXT_meshopt_compression");
+    if (ext_it != extensions.end() && ext_it->second.Has("fallback") &&
+        ext_it->second.Get("fallback").IsBool() &&
+        ext_it->second.Get("fallback").Get<bool>()) {
+      buffer->data.resize(byteLength);
+      ParseStringProperty(&buffer->name, err, o, "name", false);
+      buffer->extensions = std::move(extensions);
+      ParseExtrasProperty(&buffer->extras, o);
+      return true;
+    }
+  }
+
   // having an empty uri for a non embedded image should not be valid
   if (!is_binary && buffer->uri.empty()) {
     if (err) {
@@ -4111,9 +4170,14 @@ static bool ParseBuffer(Buffer *buffer, std::string *err, const json &o,
       } else {
         // External .bin file.
         std::string decoded_uri = dlib::urldecode(buffer->uri);
-        if (!LoadExternalFile(&buffer->data, err, /* warn */ nullptr,
-                              decoded_uri, basedir, /* required */ true,
-                              byteLength, /* checkSize */ true, fs)) {
+        if (fs != nullptr && fs->ReadFileRange != nullptr) {
+          if (!DeferExternalBuffer(buffer, err, decoded_uri, basedir,
+                                   byteLength, fs)) {
+            return false;
+          }
+        } else if (!LoadExternalFile(&buffer->data, err, /* warn */ nullptr,
+                                     decoded_uri, basedir, /* required */ true,
+                                     byteLength, /* checkSize */ true, fs)) {
           return false;
         }
       }
@@ -4156,9 +4220,14 @@ static bool ParseBuffer(Buffer *buffer, std::string *err, const json &o,
     } else {
       // Assume external .bin file.
       std::string decoded_uri = dlib::urldecode(buffer->uri);
-      if (!LoadExternalFile(&buffer->data, err, /* warn */ nullptr, decoded_uri,
-                            basedir, /* required */ true, byteLength,
-                            /* checkSize */ true, fs)) {
+      if (fs != nullptr && fs->ReadFileRange != nullptr) {
+        if (!DeferExternalBuffer(buffer, err, decoded_uri, basedir, byteLength,
+                                 fs)) {
+          return false;
+        }
+      } else if (!LoadExternalFile(&buffer->data, err, /* warn */ nullptr,
+                                   decoded_uri, basedir, /* required */ true,
+                                   byteLength, /* checkSize */ true, fs)) {
         return false;
       }
     }
@@ -4518,6 +4587,7 @@ static bool GetAttributeForAllPoints(uint32_t componentType, draco::Mesh *mesh,
   return decodeResult;
 }
 
+#ifndef TINYGLTF_DEFER_DRACO_DECODE
 static bool ParseDracoExtension(Primitive *primitive, Model *model,
                                 std::string *err,
                                 const Value &dracoExtensionValue) {
@@ -4615,6 +4685,7 @@ static bool ParseDracoExtension(Primitive *primitive, Model *model,
 
   return true;
 }
+#endif  // TINYGLTF_DEFER_DRACO_DECODE
 #endif
 
 static bool ParsePrimitive(Primitive *primitive, Model *model, std::string *err,
@@ -4678,7 +4749,9 @@ static bool ParsePrimitive(Primitive *primitive, Model *model, std::string *err,
     }
   }
 
-#ifdef TINYGLTF_ENABLE_DRACO
+  // When TINYGLTF_DEFER_DRACO_DECODE is defined, the application decodes
+  // the compressed primitives itself after the model has been parsed.
+#if defined(TINYGLTF_ENABLE_DRACO) && !defined(TINYGLTF_DEFER_DRACO_DECODE)
   auto dracoExtension =
       primitive->extensions.find("KHR_draco_mesh_compression");
   if (dracoExtension != primitive->extensions.end()) {
@@ -6004,9 +6077,31 @@ bool TinyGLTF::LoadFromString(Model *model, std::string *err, std::string *warn,
           }
           return false;
         }
+        const unsigned char *image_data = nullptr;
+        std::vector<unsigned char> deferred_data;
+        if (!buffer.deferred_path.empty()) {
+          // The buffer is not loaded; read only the range of the view.
+          std::string read_err;
+          if (fs.ReadFileRange == nullptr ||
+              bufferView.byteOffset + bufferView.byteLength >
+                  buffer.deferred_size ||
+              !fs.ReadFileRange(&deferred_data, &read_err,
+                                buffer.deferred_path, bufferView.byteOffset,
+                                bufferView.byteLength, fs.user_data) ||
+              deferred_data.size() != bufferView.byteLength) {
+            if (err) {
+              (*err) += "Failed to read image[" + std::to_string(idx) +
+                        "] data from " + buffer.deferred_path + " : " +
+                        read_err + "\n";
+            }
+            return false;
+          }
+          image_data = deferred_data.data();
+        } else {
+          image_data = &buffer.data[bufferView.byteOffset];
+        }
         bool ret = LoadImageData(
-            &image, idx, err, warn, image.width, image.height,
-            &buffer.data[bufferView.byteOffset],
+            &image, idx, err, warn, image.width, image.height, image_data,
             static_cast<int>(bufferView.byteLength), load_image_user_data);
         if (!ret) {
           return false;
@@ -0,0 +1,142 @@
+/*
+ *  Copyright 2019-2022 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Trace zones and counters of the tools libraries.
+///
+/// The libraries mark their expensive stages (texture decoding and mip generation, render state
+/// notation parsing, render state packaging, ImGui rendering, NativeApp frame stages) with
+/// DILIGENT_TRACE_ZONE and report values with DILIGENT_TRACE_COUNTER. The macros compile to nothing
+/// unless DILIGENT_TOOLS_TRACE is defined to 1 (see the DILIGENT_TOOLS_TRACE CMake option).
+/// When it is defined, the zones are forwarded to the callbacks set by SetToolsTraceCallbacks(),
+/// which makes it easy to map them onto the markers of an external profiler (Tracy, Superluminal, PIX, etc.).
+
+#include <atomic>
+
+namespace Diligent
+{
+
+/// Callbacks that receive the trace zones and counters of the tools libraries.
+
+/// \remarks   Zone and counter names are string literals that stay valid for the lifetime of the
+///            process, so their pointers may be used as keys, e.g. to cache the static zone
+///            descriptions that some profilers require. Zones are properly nested within a thread,
+///            and every zone ends on the thread it began on. The callbacks are called from any
+///            thread that runs the tools code and must be thread-safe.
+struct ToolsTraceCallbacks
+{
+    /// Called when a zone begins.
+    void (*BeginZone)(const char* Name, void* pUserData) = nullptr;
+
+    /// Called when a zone ends.
+    void (*EndZone)(const char* Name, void* pUserData) = nullptr;
+
+    /// Called when a counter value is reported.
+    void (*Counter)(const char* Name, double Value, void* pUserData) = nullptr;
+
+    /// User data passed to all callbacks.
+    void* pUserData = nullptr;
+};
+
+inline std::atomic<const ToolsTraceCallbacks*>& GetToolsTraceCallbacksPtr()
+{
+    static std::atomic<const ToolsTraceCallbacks*> pCallbacks{nullptr};
+    return pCallbacks;
+}
+
+/// Sets the trace callbacks of the tools libraries.
+
+/// \param [in] pCallbacks - Pointer to the callbacks, or null to disable tracing.
+///                          The structure is not copied and must stay alive until
+///                          the callbacks are reset and all zones have ended.
+///
+/// \remarks   The callbacks should be set before the tools libraries are used. Zones that are
+///            open when the callbacks change are ended by the callbacks they began with.
+inline void SetToolsTraceCallbacks(const ToolsTraceCallbacks* pCallbacks)
+{
+    GetToolsTraceCallbacksPtr().store(pCallbacks, std::memory_order_release);
+}
+
+inline const ToolsTraceCallbacks* GetToolsTraceCallbacks()
+{
+    return GetToolsTraceCallbacksPtr().load(std::memory_order_acquire);
+}
+
+/// Begins a trace zone in the constructor and ends it in the destructor, see DILIGENT_TRACE_ZONE.
+class ToolsTraceZone
+{
+public:
+    explicit ToolsTraceZone(const char* Name) :
+        m_Name{Name},
+        m_pCallbacks{GetToolsTraceCallbacks()}
+    {
+        if (m_pCallbacks != nullptr && m_pCallbacks->BeginZone != nullptr)
+            m_pCallbacks->BeginZone(m_Name, m_pCallbacks->pUserData);
+    }
+
+    ~ToolsTraceZone()
+    {
+        if (m_pCallbacks != nullptr && m_pCallbacks->EndZone != nullptr)
+            m_pCallbacks->EndZone(m_Name, m_pCallbacks->pUserData);
+    }
+
+    // clang-format off
+    ToolsTraceZone           (const ToolsTraceZone&) = delete;
+    ToolsTraceZone           (ToolsTraceZone&&)      = delete;
+    ToolsTraceZone& operator=(const ToolsTraceZone&) = delete;
+    ToolsTraceZone& operator=(ToolsTraceZone&&)      = delete;
+    // clang-format on
+
+private:
+    const char* const                m_Name;
+    const ToolsTraceCallbacks* const m_pCallbacks;
+};
+
+inline void ToolsTraceCounter(const char* Name, double Value)
+{
+    const auto* pCallbacks = GetToolsTraceCallbacks();
+    if (pCallbacks != nullptr && pCallbacks->Counter != nullptr)
+        pCallbacks->Counter(Name, Value, pCallbacks->pUserData);
+}
+
+} // namespace Diligent
+
+#define DILIGENT_TOOLS_TRACE_CONCAT_IMPL(A, B) A##B
+#define DILIGENT_TOOLS_TRACE_CONCAT(A, B)      DILIGENT_TOOLS_TRACE_CONCAT_IMPL(A, B)
+
+#if defined(DILIGENT_TOOLS_TRACE) && DILIGENT_TOOLS_TRACE
+/// Traces the rest of the enclosing scope as a zone. Name must be a string literal.
+#    define DILIGENT_TRACE_ZONE(Name) ::Diligent::ToolsTraceZone DILIGENT_TOOLS_TRACE_CONCAT(_ToolsTraceZone, __LINE__){"" Name}
+/// Reports the value of a counter. Name must be a string literal.
+#    define DILIGENT_TRACE_COUNTER(Name, Value) ::Diligent::ToolsTraceCounter("" Name, static_cast<double>(Value))
+#else
+// The arguments are not evaluated when tracing is disabled
+#    define DILIGENT_TRACE_ZONE(Name)
+#    define DILIGENT_TRACE_COUNTER(Name, Value)
+#endif